@@ -318,6 +318,7 @@ def xls_dslx_cpp_type_library(
             "@com_google_absl//absl/status:status",
             "@com_google_absl//absl/status:statusor",
             "@com_google_absl//absl/types:span",
+            "//xls/ir:value_view",
             "//xls/public:value",
         ],
     )
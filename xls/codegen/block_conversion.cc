@@ -14,6 +14,7 @@
 
 #include "xls/codegen/block_conversion.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
@@ -25,6 +26,7 @@
 #include "xls/codegen/register_legalization_pass.h"
 #include "xls/codegen/vast.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/tracing.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/function_builder.h"
 #include "xls/ir/node.h"
@@ -356,6 +358,178 @@ struct BubbleFlowControl {
   std::vector<Node*> next_stage_open;
 };
 
+// Adds a skid buffer at the boundary between pipeline stage 'stage' and
+// 'stage + 1' so that the backpressure signal produced by the boundary comes
+// directly from a register rather than chaining combinationally through the
+// downstream stages.
+//
+// The existing pipeline valid/data registers at the boundary serve as the
+// primary buffer entry. A parallel set of skid registers catches the element
+// displaced from the pipeline registers when a new element enters while
+// downstream is stalled. This mirrors AddSkidBufferToRDVNodes() which
+// performs the same transform on a data/valid/ready triple at the block
+// boundary.
+//
+// 'to_is_ready' must be asserted exactly when the element presented by the
+// boundary is consumed by the downstream stage. 'pipeline_valid_node' must be
+// the RegisterRead of the boundary's valid register and is updated to the
+// presented (buffered-or-skid) valid.
+//
+// Returns the boundary's upstream-facing enable -- the inverse of the
+// skid-valid register -- which also gates loading of the boundary's pipeline
+// registers.
+static absl::StatusOr<Node*> AddSkidBufferAtStageBoundary(
+    int64_t stage, Node* to_is_ready, Node*& pipeline_valid_node,
+    PipelineStageRegisters& data_registers, const ResetInfo& reset_info,
+    Block* block) {
+  Type* u1 = block->package()->GetBitsType(1);
+
+  RegisterRead* valid_reg_read = pipeline_valid_node->As<RegisterRead>();
+  XLS_RET_CHECK(valid_reg_read != nullptr);
+  Register* valid_reg = valid_reg_read->GetRegister();
+  XLS_ASSIGN_OR_RETURN(RegisterWrite * valid_reg_write,
+                       block->GetRegisterWrite(valid_reg));
+  // The data written to the valid register is stage_done of the upstream
+  // stage, i.e. an element being offered into the boundary.
+  Node* stage_done = valid_reg_write->data();
+
+  // Valid bit for the skid registers.
+  XLS_ASSIGN_OR_RETURN(
+      Register * skid_valid_reg,
+      block->AddRegister(PipelineSignalName("skid_valid", stage), u1,
+                         reset_info.behavior));
+  XLS_ASSIGN_OR_RETURN(
+      RegisterRead * skid_valid,
+      block->MakeNode<RegisterRead>(/*loc=*/SourceInfo(), skid_valid_reg));
+
+  // The boundary presents an element if either the pipeline registers or the
+  // skid registers hold one.
+  XLS_ASSIGN_OR_RETURN(
+      Node * presented_valid,
+      block->MakeNodeWithName<NaryOp>(
+          /*loc=*/SourceInfo(), std::vector<Node*>{valid_reg_read, skid_valid},
+          Op::kOr, PipelineSignalName("valid_or_skid", stage)));
+  XLS_RETURN_IF_ERROR(valid_reg_read->ReplaceUsesWith(presented_valid));
+  // ReplaceUsesWith() also rewired the OR itself; restore its operand.
+  XLS_RETURN_IF_ERROR(presented_valid->ReplaceOperandNumber(0, valid_reg_read));
+  pipeline_valid_node = presented_valid;
+
+  // Skid copies of each datapath register at the boundary, muxed into the
+  // downstream stage when the skid holds the older element.
+  std::vector<Register*> skid_data_regs;
+  skid_data_regs.reserve(data_registers.size());
+  for (PipelineRegister& pipeline_reg : data_registers) {
+    XLS_ASSIGN_OR_RETURN(
+        Register * skid_reg,
+        block->AddRegister(absl::StrCat(pipeline_reg.reg->name(), "_skid"),
+                           pipeline_reg.reg->type()));
+    XLS_ASSIGN_OR_RETURN(
+        RegisterRead * skid_read,
+        block->MakeNode<RegisterRead>(/*loc=*/SourceInfo(), skid_reg));
+    XLS_ASSIGN_OR_RETURN(
+        Node * presented_data,
+        block->MakeNodeWithName<Select>(
+            /*loc=*/SourceInfo(), /*selector=*/skid_valid,
+            /*cases=*/std::vector<Node*>{pipeline_reg.reg_read, skid_read},
+            /*default_value=*/absl::nullopt,
+            absl::StrCat(pipeline_reg.reg->name(), "_skid_select")));
+    XLS_RETURN_IF_ERROR(pipeline_reg.reg_read->ReplaceUsesWith(presented_data));
+    XLS_RETURN_IF_ERROR(
+        presented_data->ReplaceOperandNumber(1, pipeline_reg.reg_read));
+    skid_data_regs.push_back(skid_reg);
+  }
+
+  // The boundary accepts a new element whenever the skid registers are empty.
+  // This is the registered upstream-facing ready signal.
+  XLS_ASSIGN_OR_RETURN(
+      Node * from_skid_rdy,
+      block->MakeNodeWithName<UnOp>(/*loc=*/SourceInfo(), skid_valid, Op::kNot,
+                                    PipelineSignalName("skid_rdy", stage)));
+
+  // An element enters the pipeline registers when the upstream stage offers
+  // one and the skid is empty.
+  XLS_ASSIGN_OR_RETURN(
+      Node * input_ready_and_valid,
+      block->MakeNodeWithName<NaryOp>(
+          /*loc=*/SourceInfo(), std::vector<Node*>{stage_done, from_skid_rdy},
+          Op::kAnd, PipelineSignalName("skid_input_load", stage)));
+
+  // The pipeline-register element leaves when downstream consumes it
+  // directly, which requires the skid to be empty.
+  XLS_ASSIGN_OR_RETURN(
+      Node * data_is_sent_to,
+      block->MakeNodeWithName<NaryOp>(
+          /*loc=*/SourceInfo(),
+          std::vector<Node*>{valid_reg_read, to_is_ready, from_skid_rdy},
+          Op::kAnd, PipelineSignalName("skid_sent", stage)));
+
+  XLS_ASSIGN_OR_RETURN(
+      Node * valid_load_en,
+      block->MakeNodeWithName<NaryOp>(
+          /*loc=*/SourceInfo(),
+          std::vector<Node*>{data_is_sent_to, input_ready_and_valid}, Op::kOr,
+          PipelineSignalName("valid_load_en", stage)));
+
+  // Replace the valid register write with one gated by the new load enable.
+  XLS_RETURN_IF_ERROR(block
+                          ->MakeNode<RegisterWrite>(
+                              /*loc=*/SourceInfo(), valid_reg_write->data(),
+                              /*load_enable=*/valid_load_en,
+                              /*reset=*/valid_reg_write->reset(), valid_reg)
+                          .status());
+  XLS_RETURN_IF_ERROR(block->RemoveNode(valid_reg_write));
+
+  // The skid registers catch the element displaced from the pipeline
+  // registers when a new element enters while downstream is stalled.
+  XLS_ASSIGN_OR_RETURN(
+      Node * to_is_not_rdy,
+      block->MakeNodeWithName<UnOp>(/*loc=*/SourceInfo(), to_is_ready, Op::kNot,
+                                    PipelineSignalName("to_not_rdy", stage)));
+
+  XLS_ASSIGN_OR_RETURN(
+      Node * skid_data_load_en,
+      block->MakeNodeWithName<NaryOp>(
+          /*loc=*/SourceInfo(),
+          std::vector<Node*>{valid_reg_read, input_ready_and_valid,
+                             to_is_not_rdy},
+          Op::kAnd, PipelineSignalName("skid_data_load_en", stage)));
+
+  // Skid is emptied (valid set to zero) when it holds an element and
+  // downstream consumes it.
+  XLS_ASSIGN_OR_RETURN(
+      Node * skid_valid_set_zero,
+      block->MakeNodeWithName<NaryOp>(
+          /*loc=*/SourceInfo(), std::vector<Node*>{skid_valid, to_is_ready},
+          Op::kAnd, PipelineSignalName("skid_valid_set_zero", stage)));
+
+  // Skid valid changes from 0 to 1 (load), or 1 to 0 (set zero), so its next
+  // value on load is its inverse.
+  XLS_ASSIGN_OR_RETURN(
+      Node * skid_valid_load_en,
+      block->MakeNodeWithName<NaryOp>(
+          /*loc=*/SourceInfo(),
+          std::vector<Node*>{skid_data_load_en, skid_valid_set_zero}, Op::kOr,
+          PipelineSignalName("skid_valid_load_en", stage)));
+  XLS_RETURN_IF_ERROR(block
+                          ->MakeNode<RegisterWrite>(
+                              /*loc=*/SourceInfo(), from_skid_rdy,
+                              /*load_enable=*/skid_valid_load_en,
+                              /*reset=*/reset_info.input_port, skid_valid_reg)
+                          .status());
+
+  for (int64_t i = 0; i < data_registers.size(); ++i) {
+    XLS_RETURN_IF_ERROR(block
+                            ->MakeNode<RegisterWrite>(
+                                /*loc=*/SourceInfo(),
+                                /*data=*/data_registers[i].reg_read,
+                                /*load_enable=*/skid_data_load_en,
+                                /*reset=*/absl::nullopt, skid_data_regs[i])
+                            .status());
+  }
+
+  return from_skid_rdy;
+}
+
 // Adds bubble flow control to the pipeline.
 //
 // - With bubble flow control, a pipeline stage is not stalled if
@@ -366,8 +540,8 @@ struct BubbleFlowControl {
 // Returns the ready signal output by the earliest pipeline stage.
 //
 static absl::StatusOr<BubbleFlowControl> UpdatePipelineWithBubbleFlowControl(
-    absl::Span<Node* const> output_ready_nodes, const ResetInfo& reset_info,
-    absl::Span<Node* const> pipeline_valid_nodes,
+    absl::Span<Node* const> output_ready_nodes, const CodegenOptions& options,
+    const ResetInfo& reset_info, absl::Span<Node*> pipeline_valid_nodes,
     absl::Span<Node* const> pipeline_done_nodes,
     absl::Span<PipelineStageRegisters> pipeline_data_registers,
     absl::Span<std::optional<StateRegister>> state_registers, Block* block) {
@@ -409,43 +583,65 @@ static absl::StatusOr<BubbleFlowControl> UpdatePipelineWithBubbleFlowControl(
 
   std::vector<Node*>& enable_n = result.next_stage_open;
 
+  // The signal asserted when the element offered into each stage is consumed
+  // (the data-register load enable before reset is folded in). Used as the
+  // downstream-ready signal for skid buffers at stage boundaries.
+  std::vector<Node*> stage_consume(stage_count);
+
   XLS_ASSIGN_OR_RETURN(
       enable_n.at(stage_count - 1),
       block->MakeNode<xls::Literal>(SourceInfo(), Value(UBits(1, 1))));
   result.data_load_enable.at(stage_count - 1) =
       pipeline_done_nodes.at(stage_count - 1);
+  stage_consume.at(stage_count - 1) = pipeline_done_nodes.at(stage_count - 1);
 
   for (int64_t stage = stage_count - 2; stage >= 0; --stage) {
-    // Create load enables for valid registers.
-    XLS_ASSIGN_OR_RETURN(
-        Node * not_valid_np1,
-        block->MakeNodeWithName<UnOp>(
-            /*loc=*/SourceInfo(), pipeline_valid_nodes.at(stage + 1), Op::kNot,
-            PipelineSignalName("not_valid", stage + 1)));
+    Node* enable;
+    if (options.flop_stage_ready()) {
+      // Insert a skid buffer at the stage boundary so the enable
+      // (backpressure) signal below comes from a register rather than
+      // chaining combinationally through the downstream stages. The skid
+      // buffer takes over the valid register's load enable; the datapath
+      // registers are handled below, sharing the load enable computation
+      // with the unbuffered case.
+      XLS_ASSIGN_OR_RETURN(
+          enable, AddSkidBufferAtStageBoundary(
+                      stage, stage_consume.at(stage + 1),
+                      pipeline_valid_nodes.at(stage + 1),
+                      pipeline_data_registers.at(stage), reset_info, block));
+      enable_n.at(stage) = enable;
+    } else {
+      // Create load enables for valid registers.
+      XLS_ASSIGN_OR_RETURN(
+          Node * not_valid_np1,
+          block->MakeNodeWithName<UnOp>(
+              /*loc=*/SourceInfo(), pipeline_valid_nodes.at(stage + 1),
+              Op::kNot, PipelineSignalName("not_valid", stage + 1)));
 
-    XLS_ASSIGN_OR_RETURN(
-        Node * enable,
-        block->MakeNodeWithName<NaryOp>(
-            SourceInfo(),
-            std::vector<Node*>{result.data_load_enable.at(stage + 1),
-                               not_valid_np1},
-            Op::kOr, PipelineSignalName("enable", stage)));
-    enable_n.at(stage) = enable;
-
-    // Update valid registers with load enables.
-    RegisterRead* valid_reg_read =
-        pipeline_valid_nodes.at(stage + 1)->As<RegisterRead>();
-    XLS_RET_CHECK(valid_reg_read != nullptr);
-    Register* valid_reg = valid_reg_read->GetRegister();
-    XLS_ASSIGN_OR_RETURN(RegisterWrite * valid_reg_write,
-                         block->GetRegisterWrite(valid_reg));
-    XLS_RETURN_IF_ERROR(block
-                            ->MakeNode<RegisterWrite>(
-                                /*loc=*/SourceInfo(), valid_reg_write->data(),
-                                /*load_enable=*/enable,
-                                /*reset=*/valid_reg_write->reset(), valid_reg)
-                            .status());
-    XLS_RETURN_IF_ERROR(block->RemoveNode(valid_reg_write));
+      XLS_ASSIGN_OR_RETURN(
+          enable,
+          block->MakeNodeWithName<NaryOp>(
+              SourceInfo(),
+              std::vector<Node*>{result.data_load_enable.at(stage + 1),
+                                 not_valid_np1},
+              Op::kOr, PipelineSignalName("enable", stage)));
+      enable_n.at(stage) = enable;
+
+      // Update valid registers with load enables.
+      RegisterRead* valid_reg_read =
+          pipeline_valid_nodes.at(stage + 1)->As<RegisterRead>();
+      XLS_RET_CHECK(valid_reg_read != nullptr);
+      Register* valid_reg = valid_reg_read->GetRegister();
+      XLS_ASSIGN_OR_RETURN(RegisterWrite * valid_reg_write,
+                           block->GetRegisterWrite(valid_reg));
+      XLS_RETURN_IF_ERROR(block
+                              ->MakeNode<RegisterWrite>(
+                                  /*loc=*/SourceInfo(), valid_reg_write->data(),
+                                  /*load_enable=*/enable,
+                                  /*reset=*/valid_reg_write->reset(), valid_reg)
+                              .status());
+      XLS_RETURN_IF_ERROR(block->RemoveNode(valid_reg_write));
+    }
 
     // Create load enables for datapath registers.
     std::vector<Node*> data_en_operands = {enable,
@@ -454,6 +650,7 @@ static absl::StatusOr<BubbleFlowControl> UpdatePipelineWithBubbleFlowControl(
                          block->MakeNodeWithName<NaryOp>(
                              SourceInfo(), data_en_operands, Op::kAnd,
                              PipelineSignalName("data_enable", stage)));
+    stage_consume.at(stage) = data_enable;
 
     // If datapath registers are reset, then adding reset to the
     // load enable is redundant.
@@ -1787,7 +1984,7 @@ static absl::StatusOr<std::vector<Node*>> AddBubbleFlowControl(
   XLS_ASSIGN_OR_RETURN(
       BubbleFlowControl bubble_flow_control,
       UpdatePipelineWithBubbleFlowControl(
-          absl::MakeSpan(all_active_outputs_ready), reset_info,
+          absl::MakeSpan(all_active_outputs_ready), options, reset_info,
           absl::MakeSpan(stage_valid), absl::MakeSpan(stage_done),
           absl::MakeSpan(streaming_io.pipeline_registers),
           absl::MakeSpan(streaming_io.state_registers), block));
@@ -2024,38 +2221,23 @@ class CloneNodesIntoBlockHandler {
   // scheduled at or before this cycle and has a use after this cycle.
   absl::Status AddNextPipelineStage(const PipelineSchedule& schedule,
                                     int64_t stage) {
-    Function* as_func = dynamic_cast<Function*>(function_base_);
-
-    for (Node* function_base_node : function_base_->nodes()) {
-      if (schedule.cycle(function_base_node) > stage) {
-        continue;
-      }
-      auto is_live_out_of_stage = [&](Node* n) {
-        if (stage == schedule.length() - 1) {
-          return false;
-        }
-        if (as_func && (n == as_func->return_value())) {
-          return true;
-        }
-        for (Node* user : n->users()) {
-          if (schedule.cycle(user) > stage) {
-            return true;
-          }
-        }
-        return false;
-      };
-
-      if (is_live_out_of_stage(function_base_node)) {
-        Node* node = node_map_.at(function_base_node);
+    if (live_out_of_stage_.empty()) {
+      BuildLiveOutOfStageLists(schedule);
+    }
+    if (!live_out_of_stage_.at(stage).empty()) {
+      result_.pipeline_registers.at(stage).reserve(
+          live_out_of_stage_.at(stage).size());
+    }
+    for (Node* function_base_node : live_out_of_stage_.at(stage)) {
+      Node* node = node_map_.at(function_base_node);
 
-        XLS_ASSIGN_OR_RETURN(
-            Node * node_after_stage,
-            CreatePipelineRegistersForNode(
-                PipelineSignalName(node->GetName(), stage), node,
-                result_.pipeline_registers.at(stage), block_));
+      XLS_ASSIGN_OR_RETURN(
+          Node * node_after_stage,
+          CreatePipelineRegistersForNode(
+              PipelineSignalName(node->GetName(), stage), node,
+              result_.pipeline_registers.at(stage), block_));
 
-        node_map_[function_base_node] = node_after_stage;
-      }
+      node_map_[function_base_node] = node_after_stage;
     }
 
     return absl::OkStatus();
@@ -2078,6 +2260,30 @@ class CloneNodesIntoBlockHandler {
   StreamingIoPipeline GetResult() { return result_; }
 
  private:
+  // Computes, in a single pass over the nodes, which nodes need a pipeline
+  // register at each stage boundary: those scheduled at or before the
+  // boundary with a use after it (the function return value is carried
+  // through every boundary). Scanning the whole graph once per stage instead
+  // is quadratic for deep pipelines.
+  void BuildLiveOutOfStageLists(const PipelineSchedule& schedule) {
+    Function* as_func = dynamic_cast<Function*>(function_base_);
+    live_out_of_stage_.resize(schedule.length());
+    for (Node* node : function_base_->nodes()) {
+      int64_t last_use_cycle = schedule.cycle(node);
+      if (as_func && node == as_func->return_value()) {
+        last_use_cycle = schedule.length() - 1;
+      } else {
+        for (Node* user : node->users()) {
+          last_use_cycle = std::max(last_use_cycle, schedule.cycle(user));
+        }
+      }
+      for (int64_t stage = schedule.cycle(node);
+           stage < std::min(last_use_cycle, schedule.length() - 1); ++stage) {
+        live_out_of_stage_[stage].push_back(node);
+      }
+    }
+  }
+
   // Replace token parameter with zero operand AfterAll.
   absl::StatusOr<Node*> HandleTokenParam(Node* node) {
     return block_->MakeNode<AfterAll>(node->loc(), std::vector<Node*>());
@@ -2421,6 +2627,11 @@ class CloneNodesIntoBlockHandler {
   Block* block_;
   StreamingIoPipeline result_;
   absl::flat_hash_map<Node*, Node*> node_map_;
+
+  // For each stage boundary, the nodes (in node list order) which need a
+  // pipeline register at that boundary. Built on the first call to
+  // AddNextPipelineStage().
+  std::vector<std::vector<Node*>> live_out_of_stage_;
 };
 
 // Adds the nodes in the given schedule to the block. Pipeline registers are
@@ -2467,6 +2678,7 @@ std::string PipelineSignalName(absl::string_view root, int64_t stage) {
 absl::StatusOr<Block*> FunctionToPipelinedBlock(
     const PipelineSchedule& schedule, const CodegenOptions& options,
     Function* f) {
+  ScopedTraceEvent trace_event("FunctionToPipelinedBlock");
   if (options.manual_control().has_value()) {
     return absl::UnimplementedError("Manual pipeline control not implemented");
   }
@@ -2544,6 +2756,7 @@ absl::StatusOr<Block*> FunctionToPipelinedBlock(
 absl::StatusOr<Block*> ProcToPipelinedBlock(const PipelineSchedule& schedule,
                                             const CodegenOptions& options,
                                             Proc* proc) {
+  ScopedTraceEvent trace_event("ProcToPipelinedBlock");
   XLS_VLOG(3) << "Converting proc to pipelined block:";
   XLS_VLOG_LINES(3, proc->DumpIr());
 
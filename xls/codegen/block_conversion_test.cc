@@ -1554,6 +1554,125 @@ INSTANTIATE_TEST_SUITE_P(
                         CodegenOptions::IOKind::kZeroLatencyBuffer)),
     SimplePipelinedProcTestSweepFixture::PrintToStringParamName);
 
+// Fixture to sweep SimplePipelinedProcTest with skid buffers at the internal
+// stage boundaries (flop_stage_ready).
+class SimplePipelinedProcStageReadySweepFixture
+    : public SimplePipelinedProcTest,
+      public testing::WithParamInterface<int64_t> {
+ public:
+  static std::string PrintToStringParamName(
+      const testing::TestParamInfo<ParamType>& info) {
+    return absl::StrFormat("stage_count_%d", info.param);
+  }
+};
+
+TEST_P(SimplePipelinedProcStageReadySweepFixture, RandomStalling) {
+  int64_t stage_count = GetParam();
+
+  CodegenOptions options;
+  options.flop_inputs(false).flop_outputs(false).clock_name("clk");
+  options.flop_stage_ready(true);
+  options.valid_control("input_valid", "output_valid");
+  options.reset("rst", false, false, false);
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<Package> package,
+      BuildBlockInPackage(/*stage_count=*/stage_count, options));
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block, package->GetBlock(kBlockName));
+
+  XLS_VLOG(2) << "Simple streaming pipelined block with stage skid buffers";
+  XLS_VLOG_LINES(2, block->DumpIr());
+
+  // The input stimulus to this test are
+  //  1. 10 cycles of reset
+  //  2. Randomly varying in_vld and out_rdy.
+  //  3. in_vld = 0 and out_rdy = 1 for 10 cycles to drain the pipeline
+  int64_t simulation_cycle_count = 10000;
+  int64_t max_random_cycle = simulation_cycle_count - 10 - 1;
+
+  std::vector<absl::flat_hash_map<std::string, uint64_t>> inputs;
+  XLS_ASSERT_OK(SetSignalsOverCycles(0, 9, {{"rst", 1}}, inputs));
+  XLS_ASSERT_OK(SetSignalsOverCycles(10, simulation_cycle_count - 1,
+                                     {{"rst", 0}}, inputs));
+
+  XLS_ASSERT_OK(SetIncrementingSignalOverCycles(0, simulation_cycle_count - 1,
+                                                "in", 1, inputs));
+
+  std::minstd_rand rng_engine;
+  XLS_ASSERT_OK(SetRandomSignalOverCycles(0, max_random_cycle, "in_vld", 0, 1,
+                                          rng_engine, inputs));
+  XLS_ASSERT_OK(SetRandomSignalOverCycles(0, max_random_cycle, "out_rdy", 0, 1,
+                                          rng_engine, inputs));
+
+  XLS_ASSERT_OK(SetSignalsOverCycles(max_random_cycle + 1,
+                                     simulation_cycle_count - 1,
+                                     {{"in_vld", 0}, {"out_rdy", 1}}, inputs));
+
+  std::vector<absl::flat_hash_map<std::string, uint64_t>> outputs;
+  XLS_ASSERT_OK_AND_ASSIGN(outputs, InterpretSequentialBlock(block, inputs));
+
+  // Check the following property
+  // 1. The sequence of inputs where (in_vld && in_rdy && !rst) is true
+  //    is strictly monotone increasing with no duplicates.
+  // 2. The sequence of outputs where out_vld && out_rdy is true
+  //    is strictly monotone increasing with no duplicates.
+  // 3. Both sequences in #1 and #2 are identical.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<CycleAndValue> input_sequence,
+      GetChannelSequenceFromIO({"in", SignalType::kInput},
+                               {"in_vld", SignalType::kInput},
+                               {"in_rdy", SignalType::kOutput},
+                               {"rst", SignalType::kInput}, inputs, outputs));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<CycleAndValue> output_sequence,
+      GetChannelSequenceFromIO({"out", SignalType::kOutput},
+                               {"out_vld", SignalType::kOutput},
+                               {"out_rdy", SignalType::kInput},
+                               {"rst", SignalType::kInput}, inputs, outputs));
+
+  std::vector<uint64_t> input_value_sequence;
+  std::vector<uint64_t> output_value_sequence;
+
+  for (int64_t i = 0; i < input_sequence.size(); ++i) {
+    uint64_t curr_value = input_sequence[i].value;
+
+    if (i >= 1) {
+      int64_t curr_cycle = input_sequence[i].cycle;
+      uint64_t prior_value = input_sequence[i - 1].value;
+
+      EXPECT_LT(prior_value, curr_value) << absl::StreamFormat(
+          "Input not strictly monotone cycle %d "
+          "got %d prior %d",
+          curr_cycle, curr_value, prior_value);
+    }
+
+    input_value_sequence.push_back(curr_value);
+  }
+
+  for (int64_t i = 0; i < output_sequence.size(); ++i) {
+    uint64_t curr_value = output_sequence[i].value;
+    if (i >= 1) {
+      int64_t curr_cycle = output_sequence[i].cycle;
+      uint64_t prior_value = output_sequence[i - 1].value;
+
+      EXPECT_LT(prior_value, curr_value) << absl::StreamFormat(
+          "Output not strictly monotone cycle %d "
+          "got %d prior %d",
+          curr_cycle, curr_value, prior_value);
+    }
+
+    output_value_sequence.push_back(curr_value);
+  }
+
+  EXPECT_EQ(input_value_sequence, output_value_sequence);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    SimplePipelinedProcStageReadySweep,
+    SimplePipelinedProcStageReadySweepFixture, testing::Values(1, 2, 3, 4),
+    SimplePipelinedProcStageReadySweepFixture::PrintToStringParamName);
+
 // Fixture used to test pipelined BlockConversion on a simple
 // block with a running counter
 class SimpleRunningCounterProcTestSweepFixture
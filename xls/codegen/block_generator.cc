@@ -14,7 +14,11 @@
 
 #include "xls/codegen/block_generator.h"
 
+#include <algorithm>
+#include <atomic>
 #include <deque>
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
 
 #include "absl/status/status.h"
 #include "xls/codegen/block_conversion.h"
@@ -341,6 +345,10 @@ class BlockGenerator {
 
     XLS_RETURN_IF_ERROR(EmitOutputPorts());
 
+    XLS_VLOG(1) << absl::StreamFormat(
+        "Deduplicated %d expression(s) in block `%s`",
+        mb_.deduplicated_expression_count(), block_->name());
+
     return absl::OkStatus();
   }
 
@@ -759,6 +767,63 @@ absl::StatusOr<std::vector<Block*>> GatherInstantiatedBlocks(Block* top) {
   return blocks;
 }
 
+// Holds the independently generated and emitted Verilog for a single block.
+// The VerilogFile must be kept alive as long as `line_info` is used because
+// the line info refers to VAST nodes owned by the file.
+struct EmittedBlock {
+  std::unique_ptr<VerilogFile> file;
+  LineInfo line_info;
+  std::string text;
+};
+
+// Generates and emits the Verilog module for `block` into a freshly created
+// VerilogFile. Each invocation touches only its own VerilogFile and reads
+// (but does not mutate) the IR, so distinct blocks may be processed
+// concurrently. Line tracking is skipped entirely unless `track_line_info`
+// is set.
+absl::StatusOr<EmittedBlock> GenerateAndEmitBlock(
+    Block* block, const CodegenOptions& options, bool track_line_info) {
+  EmittedBlock emitted;
+  emitted.file = std::make_unique<VerilogFile>(options.use_system_verilog());
+  XLS_RETURN_IF_ERROR(
+      BlockGenerator::Generate(block, emitted.file.get(), options));
+  emitted.text =
+      emitted.file->Emit(track_line_info ? &emitted.line_info : nullptr);
+  return emitted;
+}
+
+// Adds entries to `verilog_line_map` mapping the source locations of the VAST
+// nodes recorded in `line_info` to the lines they occupy in the emitted
+// Verilog. `line_offset` is the line at which the emitted text of the
+// corresponding block begins in the concatenated output.
+absl::Status AppendVerilogLineMappings(const LineInfo& line_info,
+                                       Package* package, int64_t line_offset,
+                                       VerilogLineMap* verilog_line_map) {
+  for (const auto& [vast_node, partial_spans] : line_info.Spans()) {
+    std::optional<std::vector<LineSpan>> spans = line_info.LookupNode(vast_node);
+    if (!spans.has_value()) {
+      return absl::InternalError("Unbalanced calls to LineInfo::{Start, End}");
+    }
+    for (const LineSpan& span : spans.value()) {
+      SourceInfo info = vast_node->loc();
+      for (const SourceLocation& loc : info.locations) {
+        int64_t line = static_cast<int32_t>(loc.lineno());
+        VerilogLineMapping* mapping = verilog_line_map->add_mapping();
+        mapping->set_source_file(
+            package->GetFilename(loc.fileno()).value_or(""));
+        mapping->mutable_source_span()->set_line_start(line);
+        mapping->mutable_source_span()->set_line_end(line);
+        mapping->set_verilog_file("");  // to be updated later on
+        mapping->mutable_verilog_span()->set_line_start(span.StartLine() +
+                                                        line_offset);
+        mapping->mutable_verilog_span()->set_line_end(span.EndLine() +
+                                                      line_offset);
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 absl::StatusOr<std::string> GenerateVerilog(Block* top,
@@ -771,39 +836,52 @@ absl::StatusOr<std::string> GenerateVerilog(Block* top,
 
   XLS_ASSIGN_OR_RETURN(std::vector<Block*> blocks,
                        GatherInstantiatedBlocks(top));
-  VerilogFile file(options.use_system_verilog());
-  for (Block* block : blocks) {
-    XLS_RETURN_IF_ERROR(BlockGenerator::Generate(block, &file, options));
-    if (block != blocks.back()) {
-      file.Add(file.Make<BlankLine>(SourceInfo()));
-      file.Add(file.Make<BlankLine>(SourceInfo()));
+
+  // Generate and emit each block into its own VerilogFile so the bulk of the
+  // work can proceed in parallel across blocks. The per-block texts are then
+  // concatenated in the deterministic DFS post-order returned by
+  // GatherInstantiatedBlocks (with two blank lines between modules), so the
+  // output is identical to generating all blocks into a single file.
+  std::vector<absl::StatusOr<EmittedBlock>> emitted_blocks(blocks.size());
+  const int64_t worker_count =
+      std::min<int64_t>(blocks.size(), std::thread::hardware_concurrency());
+  if (worker_count <= 1) {
+    for (int64_t i = 0; i < static_cast<int64_t>(blocks.size()); ++i) {
+      emitted_blocks[i] = GenerateAndEmitBlock(blocks[i], options,
+                                               verilog_line_map != nullptr);
+    }
+  } else {
+    std::atomic<int64_t> next_block{0};
+    std::vector<std::thread> workers;
+    workers.reserve(worker_count);
+    for (int64_t i = 0; i < worker_count; ++i) {
+      workers.push_back(std::thread([&]() {
+        int64_t block_index;
+        while ((block_index = next_block.fetch_add(1)) <
+               static_cast<int64_t>(blocks.size())) {
+          emitted_blocks[block_index] = GenerateAndEmitBlock(
+              blocks[block_index], options, verilog_line_map != nullptr);
+        }
+      }));
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
     }
   }
 
-  LineInfo line_info;
-  std::string text = file.Emit(&line_info);
-  if (verilog_line_map != nullptr) {
-    for (const auto& [vast_node, partial_spans] : line_info.Spans()) {
-      std::optional<std::vector<LineSpan>> spans =
-          line_info.LookupNode(vast_node);
-      if (!spans.has_value()) {
-        return absl::InternalError(
-            "Unbalanced calls to LineInfo::{Start, End}");
-      }
-      for (const LineSpan& span : spans.value()) {
-        SourceInfo info = vast_node->loc();
-        for (const SourceLocation& loc : info.locations) {
-          int64_t line = static_cast<int32_t>(loc.lineno());
-          VerilogLineMapping* mapping = verilog_line_map->add_mapping();
-          mapping->set_source_file(
-              top->package()->GetFilename(loc.fileno()).value_or(""));
-          mapping->mutable_source_span()->set_line_start(line);
-          mapping->mutable_source_span()->set_line_end(line);
-          mapping->set_verilog_file("");  // to be updated later on
-          mapping->mutable_verilog_span()->set_line_start(span.StartLine());
-          mapping->mutable_verilog_span()->set_line_end(span.EndLine());
-        }
-      }
+  std::string text;
+  int64_t line_offset = 0;
+  for (int64_t i = 0; i < static_cast<int64_t>(blocks.size()); ++i) {
+    XLS_ASSIGN_OR_RETURN(EmittedBlock emitted, std::move(emitted_blocks[i]));
+    if (verilog_line_map != nullptr) {
+      XLS_RETURN_IF_ERROR(AppendVerilogLineMappings(
+          emitted.line_info, top->package(), line_offset, verilog_line_map));
+    }
+    line_offset += std::count(emitted.text.begin(), emitted.text.end(), '\n');
+    text += emitted.text;
+    if (i + 1 != static_cast<int64_t>(blocks.size())) {
+      text += "\n\n";
+      line_offset += 2;
     }
   }
 
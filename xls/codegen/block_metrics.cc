@@ -16,9 +16,12 @@
 
 #include "absl/strings/str_format.h"
 #include "xls/codegen/xls_metrics.pb.h"
+#include "xls/common/math_util.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/block.h"
 #include "xls/ir/node_iterator.h"
+#include "xls/netlist/cell_library.h"
+#include "xls/netlist/logical_effort.h"
 
 namespace xls::verilog {
 namespace {
@@ -292,6 +295,150 @@ BomKindProto OpToBomKind(Op op) {
   XLS_LOG(FATAL) << "OpToBomKind: unsupported op: " << OpToString(op);
 }
 
+// Ceiling of log2 clamped below at one; used by the synthesis estimates for
+// tree-shaped structures (mux trees, reduction trees, carry lookahead).
+int64_t EstimateTreeDepth(int64_t value) {
+  return CeilOfLog2(static_cast<uint64_t>(std::max<int64_t>(value, 2)));
+}
+
+// Returns a rough estimate of the mapped area of `node` in two-input
+// NAND-equivalent gates. The coefficients approximate typical mapped
+// implementations (full-adder cells, array multipliers, mux trees); they are
+// meant to rank design points rather than predict absolute area.
+int64_t EstimateNodeArea(Node* node) {
+  int64_t output_width = node->GetType()->GetFlatBitCount();
+  int64_t input_width = 0;
+  for (Node* operand : node->operands()) {
+    input_width =
+        std::max(input_width, operand->GetType()->GetFlatBitCount());
+  }
+  int64_t arity = node->operands().size();
+  switch (OpToBomKind(node->op())) {
+    case BOM_KIND_ADDER:
+      // A full adder is roughly nine NAND2 gates per bit.
+      return 9 * output_width;
+    case BOM_KIND_MULTIPLIER:
+      // Array multiplier: one full adder per partial product bit.
+      return 9 * input_width * input_width;
+    case BOM_KIND_DIVIDER:
+      // Restoring divider: a subtract-and-select row per quotient bit.
+      return 18 * input_width * input_width;
+    case BOM_KIND_COMPARISON:
+      return 3 * input_width;
+    case BOM_KIND_BITWISE:
+      return std::max<int64_t>(arity - 1, 1) * output_width;
+    case BOM_KIND_BITWISE_REDUCTION:
+      return std::max<int64_t>(input_width - 1, 0);
+    case BOM_KIND_SLICE:
+      // A 2:1 mux per tree level and output bit, four gates per mux.
+      return 4 * output_width * EstimateTreeDepth(input_width);
+    case BOM_KIND_SELECT:
+      return 4 * output_width * std::max<int64_t>(arity - 2, 1);
+    case BOM_KIND_ONE_HOT_SELECT:
+      return 2 * output_width * std::max<int64_t>(arity - 1, 1);
+    case BOM_KIND_PRIORITY_SELECT:
+      return 3 * output_width * std::max<int64_t>(arity - 1, 1);
+    case BOM_KIND_DECODE:
+      return 2 * output_width;
+    case BOM_KIND_ENCODE:
+    case BOM_KIND_ONE_HOT:
+      return 2 * input_width;
+    case BOM_KIND_INSIGNIFICANT:
+    case BOM_KIND_MISC:
+    case BOM_KIND_INVALID:
+      return 0;
+  }
+  return 0;
+}
+
+// Returns a rough estimate of the depth of `node` in levels of two-input
+// NAND-equivalent gates, assuming tree-shaped (carry-lookahead, Wallace,
+// mux-tree) implementations of the wide operations.
+int64_t EstimateNodeLogicLevels(Node* node) {
+  int64_t output_width = node->GetType()->GetFlatBitCount();
+  int64_t input_width = 0;
+  for (Node* operand : node->operands()) {
+    input_width =
+        std::max(input_width, operand->GetType()->GetFlatBitCount());
+  }
+  int64_t arity = node->operands().size();
+  switch (OpToBomKind(node->op())) {
+    case BOM_KIND_ADDER:
+      return EstimateTreeDepth(output_width) + 2;
+    case BOM_KIND_MULTIPLIER:
+      return 3 * EstimateTreeDepth(input_width) + 2;
+    case BOM_KIND_DIVIDER:
+      // Iterative subtraction: a linear chain of rows.
+      return 2 * input_width;
+    case BOM_KIND_COMPARISON:
+      return EstimateTreeDepth(input_width) + 2;
+    case BOM_KIND_BITWISE:
+      return EstimateTreeDepth(arity);
+    case BOM_KIND_BITWISE_REDUCTION:
+      return EstimateTreeDepth(input_width);
+    case BOM_KIND_SLICE:
+      return 2 * EstimateTreeDepth(input_width);
+    case BOM_KIND_SELECT:
+      return 2 * EstimateTreeDepth(arity - 1);
+    case BOM_KIND_ONE_HOT_SELECT:
+      return EstimateTreeDepth(arity) + 2;
+    case BOM_KIND_PRIORITY_SELECT:
+      // Priority chain through the selector bits.
+      return std::max<int64_t>(arity - 1, 1);
+    case BOM_KIND_DECODE:
+    case BOM_KIND_ENCODE:
+      return EstimateTreeDepth(input_width);
+    case BOM_KIND_ONE_HOT:
+      return EstimateTreeDepth(input_width) + 1;
+    case BOM_KIND_INSIGNIFICANT:
+    case BOM_KIND_MISC:
+    case BOM_KIND_INVALID:
+      return 0;
+  }
+  return 0;
+}
+
+// Sets the estimated-area and estimated-critical-path fields of `proto`.
+absl::Status SetSynthesisEstimates(Block* block, BlockMetricsProto* proto) {
+  int64_t total_area = 0;
+  // Estimated logic levels from any register read or input port to each node.
+  absl::flat_hash_map<Node*, int64_t> levels_map;
+  int64_t critical_path_levels = 0;
+  for (Node* node : TopoSort(block)) {
+    total_area += EstimateNodeArea(node);
+    if (node->Is<InputPort>() || node->Is<RegisterRead>()) {
+      levels_map[node] = 0;
+      continue;
+    }
+    int64_t operand_levels = 0;
+    for (Node* operand : node->operands()) {
+      auto it = levels_map.find(operand);
+      if (it != levels_map.end()) {
+        operand_levels = std::max(operand_levels, it->second);
+      }
+    }
+    int64_t levels = operand_levels + EstimateNodeLogicLevels(node);
+    levels_map[node] = levels;
+    critical_path_levels = std::max(critical_path_levels, levels);
+  }
+
+  proto->set_estimated_area_nand2_gates(total_area);
+  proto->set_estimated_critical_path_logic_levels(critical_path_levels);
+
+  // Convert levels to delay with the method of logical effort: each level is
+  // a two-input NAND driving a same-sized load (unit electrical effort), so
+  // the per-level delay is g + p.
+  XLS_ASSIGN_OR_RETURN(double effort,
+                       netlist::logical_effort::GetLogicalEffort(
+                           netlist::CellKind::kNand, /*input_count=*/2));
+  XLS_ASSIGN_OR_RETURN(double parasitic,
+                       netlist::logical_effort::GetParasiticDelay(
+                           netlist::CellKind::kNand, /*input_count=*/2));
+  proto->set_estimated_critical_path_delay_tau(critical_path_levels *
+                                               (effort + parasitic));
+  return absl::OkStatus();
+}
+
 // Generate a BOM entry for a single node.
 absl::Status GenerateBomEntry(Node* node, BomEntryProto* proto) {
   int64_t maximum_input_width = 0;
@@ -343,6 +490,7 @@ absl::StatusOr<BlockMetricsProto> GenerateBlockMetrics(
   }
 
   XLS_RETURN_IF_ERROR(GenerateBom(block, &proto));
+  XLS_RETURN_IF_ERROR(SetSynthesisEstimates(block, &proto));
 
   return proto;
 }
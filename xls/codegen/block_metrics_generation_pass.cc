@@ -32,6 +32,9 @@ absl::StatusOr<bool> BlockMetricsGenerationPass::RunInternal(
 
   XLS_ASSIGN_OR_RETURN(BlockMetricsProto block_metrics,
                        GenerateBlockMetrics(unit->block));
+  if (unit->conversion_time_us.has_value()) {
+    block_metrics.set_block_conversion_time_us(*unit->conversion_time_us);
+  }
   XLS_RETURN_IF_ERROR(unit->signature->ReplaceBlockMetrics(block_metrics));
 
   return true;
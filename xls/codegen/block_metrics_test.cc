@@ -424,6 +424,29 @@ TEST(BlockMetricsGeneratorTest, DelayMetrics) {
   }
 }
 
+TEST(BlockMetricsGeneratorTest, SynthesisEstimates) {
+  Package package("test");
+  Type* u32 = package.GetBitsType(32);
+  BlockBuilder bb("test_block", &package);
+  BValue a = bb.InputPort("a", u32);
+  BValue b = bb.InputPort("b", u32);
+  bb.OutputPort("z", bb.UMul(bb.Add(a, b), b));
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block, bb.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(BlockMetricsProto proto,
+                           GenerateBlockMetrics(block));
+
+  // A 32-bit adder (9 gates/bit) plus a 32x32 array multiplier (9 gates per
+  // partial product bit).
+  EXPECT_EQ(proto.estimated_area_nand2_gates(), 9 * 32 + 9 * 32 * 32);
+  // The critical path runs through the adder (log2(32) + 2 levels) and the
+  // multiplier (3 * log2(32) + 2 levels).
+  EXPECT_EQ(proto.estimated_critical_path_logic_levels(), (5 + 2) + (15 + 2));
+  // Each level is a unit-effort NAND2: delay g + p = 4/3 + 2 tau.
+  EXPECT_DOUBLE_EQ(proto.estimated_critical_path_delay_tau(),
+                   24 * (4.0 / 3.0 + 2.0));
+}
+
 }  // namespace
 }  // namespace verilog
 }  // namespace xls
@@ -33,7 +33,9 @@ CodegenOptions::CodegenOptions(const CodegenOptions& options)
       split_outputs_(options.split_outputs_),
       add_idle_output_(options.add_idle_output_),
       flop_single_value_channels_(options.flop_single_value_channels_),
+      flop_stage_ready_(options.flop_stage_ready_),
       emit_as_pipeline_(options.emit_as_pipeline_),
+      emit_line_maps_(options.emit_line_maps_),
       streaming_channel_data_suffix_(options.streaming_channel_data_suffix_),
       streaming_channel_ready_suffix_(options.streaming_channel_ready_suffix_),
       streaming_channel_valid_suffix_(options.streaming_channel_valid_suffix_),
@@ -58,7 +60,9 @@ CodegenOptions& CodegenOptions::operator=(const CodegenOptions& options) {
   split_outputs_ = options.split_outputs_;
   add_idle_output_ = options.add_idle_output_;
   flop_single_value_channels_ = options.flop_single_value_channels_;
+  flop_stage_ready_ = options.flop_stage_ready_;
   emit_as_pipeline_ = options.emit_as_pipeline_;
+  emit_line_maps_ = options.emit_line_maps_;
   streaming_channel_data_suffix_ = options.streaming_channel_data_suffix_;
   streaming_channel_ready_suffix_ = options.streaming_channel_ready_suffix_;
   streaming_channel_valid_suffix_ = options.streaming_channel_valid_suffix_;
@@ -166,6 +170,11 @@ CodegenOptions& CodegenOptions::flop_single_value_channels(bool value) {
   return *this;
 }
 
+CodegenOptions& CodegenOptions::flop_stage_ready(bool value) {
+  flop_stage_ready_ = value;
+  return *this;
+}
+
 CodegenOptions& CodegenOptions::split_outputs(bool value) {
   split_outputs_ = value;
   return *this;
@@ -187,6 +196,11 @@ CodegenOptions& CodegenOptions::emit_as_pipeline(bool value) {
   return *this;
 }
 
+CodegenOptions& CodegenOptions::emit_line_maps(bool value) {
+  emit_line_maps_ = value;
+  return *this;
+}
+
 CodegenOptions& CodegenOptions::streaming_channel_data_suffix(
     absl::string_view value) {
   streaming_channel_data_suffix_ = value;
@@ -149,6 +149,17 @@ class CodegenOptions {
     return flop_single_value_channels_;
   }
 
+  // Whether to insert a skid buffer at each internal pipeline stage boundary.
+  // By default the backpressure (ready) signal of each stage chains
+  // combinationally through every downstream stage which limits the
+  // achievable clock rate of deep pipelines. With this option the
+  // backpressure signal produced at each boundary comes directly from a
+  // register, at the cost of a second (skid) copy of each stage's pipeline
+  // registers. Throughput and latency are unchanged. Only meaningful for
+  // pipelines with ready/valid flow control (procs with streaming channels).
+  CodegenOptions& flop_stage_ready(bool value);
+  bool flop_stage_ready() const { return flop_stage_ready_; }
+
   // If the output is tuple-typed, generate an output port for each element of
   // the output tuple.
   CodegenOptions& split_outputs(bool value);
@@ -178,6 +189,13 @@ class CodegenOptions {
   CodegenOptions& emit_as_pipeline(bool value);
   bool emit_as_pipeline() const { return emit_as_pipeline_; }
 
+  // Whether to populate the Verilog line map which relates emitted lines to
+  // positions in the XLS source. Line tracking is interleaved with emission,
+  // so the map is only constructed when requested (e.g., for debug triage)
+  // and emission skips all tracking otherwise.
+  CodegenOptions& emit_line_maps(bool value);
+  bool emit_line_maps() const { return emit_line_maps_; }
+
   // For ready_valid channels append value to the channel's name for the
   // signals corresponding to data.
   //
@@ -230,8 +248,10 @@ class CodegenOptions {
   bool split_outputs_ = false;
   bool add_idle_output_ = false;
   bool flop_single_value_channels_ = false;
+  bool flop_stage_ready_ = false;
   absl::flat_hash_map<Op, std::unique_ptr<OpOverride>> op_overrides_;
   bool emit_as_pipeline_ = false;
+  bool emit_line_maps_ = false;
   std::string streaming_channel_data_suffix_ = "";
   std::string streaming_channel_ready_suffix_ = "_rdy";
   std::string streaming_channel_valid_suffix_ = "_vld";
@@ -57,9 +57,21 @@ struct CodegenPassUnit {
   // out-of-sync with the IR.
   std::optional<ModuleSignature> signature;
 
+  // Wall time spent converting the IR into `block`, in microseconds, if
+  // known. Reported in the block metrics.
+  std::optional<int64_t> conversion_time_us;
+
   // These methods are required by CompoundPassBase.
   std::string DumpIr() const;
   const std::string& name() const { return block->name(); }
+  int64_t GetNodeCount() const { return package->GetNodeCount(); }
+  int64_t GetTransformCount() const { return package->GetTransformCount(); }
+  Package::MemoryUsage EstimateMemoryUsage() const {
+    return package->EstimateMemoryUsage();
+  }
+  std::vector<FunctionBase*> GetFunctionBases() const {
+    return package->GetFunctionBases();
+  }
 };
 
 using CodegenPass = PassBase<CodegenPassUnit, CodegenPassOptions, PassResults>;
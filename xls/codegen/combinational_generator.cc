@@ -71,8 +71,10 @@ absl::StatusOr<ModuleGeneratorResult> GenerateCombinationalModule(
                           .status());
   XLS_RET_CHECK(unit.signature.has_value());
   VerilogLineMap verilog_line_map;
-  XLS_ASSIGN_OR_RETURN(std::string verilog,
-                       GenerateVerilog(block, options, &verilog_line_map));
+  XLS_ASSIGN_OR_RETURN(
+      std::string verilog,
+      GenerateVerilog(block, options,
+                      options.emit_line_maps() ? &verilog_line_map : nullptr));
 
   return ModuleGeneratorResult{verilog, verilog_line_map,
                                unit.signature.value()};
@@ -142,6 +142,26 @@ bool ConditionalFsmBlock::HasAssignmentToOutput(const FsmOutput& output) const {
           final_alternate_->HasAssignmentToOutput(output));
 }
 
+int64_t FsmBlockBase::LogicDepth() const {
+  int64_t depth = 0;
+  for (const ConditionalFsmBlock& cond_block : conditional_blocks_) {
+    depth = std::max(depth, cond_block.LogicDepth());
+  }
+  return depth;
+}
+
+int64_t ConditionalFsmBlock::LogicDepth() const {
+  int64_t depth = 1 + FsmBlock<ConditionalFsmBlock>::LogicDepth();
+  if (next_alternate_ != nullptr) {
+    // Alternates ("else if") sit at the same nesting level as this block.
+    depth = std::max(depth, next_alternate_->LogicDepth());
+  }
+  if (final_alternate_ != nullptr) {
+    depth = std::max(depth, 1 + final_alternate_->LogicDepth());
+  }
+  return depth;
+}
+
 LogicRef* FsmBuilder::AddRegDef(absl::string_view name, DataType* data_type,
                                 Expression* init) {
   defs_.push_back(
@@ -199,6 +219,29 @@ FsmRegister* FsmBuilder::AddExistingRegister(LogicRef* reg) {
   return &registers_.back();
 }
 
+int64_t FsmBuilder::EncodedStateValue(int64_t index) const {
+  switch (state_encoding_) {
+    case FsmStateEncoding::kBinary:
+      return index;
+    case FsmStateEncoding::kGray:
+      return index ^ (index >> 1);
+    case FsmStateEncoding::kOneHot:
+      // State values are emitted as plain (32-bit) literals so the one-hot
+      // vector must fit in 31 bits.
+      XLS_CHECK_LT(index, 31) << "Too many states for one-hot encoding.";
+      return int64_t{1} << index;
+  }
+  XLS_LOG(FATAL) << "Invalid state encoding: "
+                 << static_cast<int64_t>(state_encoding_);
+}
+
+bool FsmBuilder::StateSpaceIsExhaustive() const {
+  // One-hot encoding uses only n of the 2^n possible state register values.
+  return state_encoding_ != FsmStateEncoding::kOneHot &&
+         static_cast<int64_t>(states_.size()) ==
+             int64_t{1} << StateRegisterWidth();
+}
+
 FsmState* FsmBuilder::AddState(absl::string_view name) {
   if (state_local_param_ == nullptr) {
     state_local_param_ = file_->Make<LocalParam>(SourceInfo());
@@ -208,7 +251,8 @@ FsmState* FsmBuilder::AddState(absl::string_view name) {
   })) << absl::StrFormat("State with name \"%s\" already exists.", name);
   Expression* state_value = state_local_param_->AddItem(
       absl::StrCat("State", name),
-      file_->PlainLiteral(states_.size(), SourceInfo()), SourceInfo());
+      file_->PlainLiteral(EncodedStateValue(states_.size()), SourceInfo()),
+      SourceInfo());
   states_.emplace_back(name, file_, state_value);
   return &states_.back();
 }
@@ -235,10 +279,10 @@ absl::Status FsmBuilder::BuildStateTransitionLogic(LogicRef* state,
     fsm_state.EmitStateTransitions(
         case_statement->AddCaseArm(fsm_state.state_value()), state_next);
   }
-  // If the number of states is not a power of two then add an unreachable
-  // default case which sets the next state to X. This ensures all values of
-  // the case are covered.
-  if (states_.size() != 1 << StateRegisterWidth()) {
+  // If not every value of the state register encodes a state then add an
+  // unreachable default case which sets the next state to X. This ensures all
+  // values of the case are covered.
+  if (!StateSpaceIsExhaustive()) {
     StatementBlock* statements = case_statement->AddCaseArm(DefaultSentinel());
     statements->Add<BlockingAssignment>(
         SourceInfo(), state_next,
@@ -475,7 +519,7 @@ absl::Status FsmBuilder::BuildOutputLogic(LogicRef* state) {
 
   // If the state vector is wide enough to allow values not encoded in the state
   // enum add a default case and assign outputs to the default value.
-  if (states_.size() != 1 << StateRegisterWidth()) {
+  if (!StateSpaceIsExhaustive()) {
     StatementBlock* statements = case_statement->AddCaseArm(DefaultSentinel());
     for (const FsmOutput& output : outputs_) {
       statements->Add<BlockingAssignment>(SourceInfo(), output.logic_ref,
@@ -519,6 +563,18 @@ absl::Status FsmBuilder::Build() {
   XLS_RETURN_IF_ERROR(BuildStateTransitionLogic(state, state_next));
   XLS_RETURN_IF_ERROR(BuildOutputLogic(state));
 
+  // Report the shape of the FSM. The conditional nesting depth bounds the
+  // depth of the generated next-state and output logic and is the usual
+  // culprit when a wide sequential design synthesizes or simulates slowly.
+  int64_t logic_depth = 0;
+  for (const FsmState& fsm_state : states_) {
+    logic_depth = std::max(logic_depth, fsm_state.LogicDepth());
+  }
+  XLS_VLOG(1) << absl::StreamFormat(
+      "FSM \"%s\": %d states, %d-bit state register, conditional logic depth "
+      "%d",
+      name_, states_.size(), StateRegisterWidth(), logic_depth);
+
   AlwaysFlop* af =
       reset_.has_value()
           ? module_->Add<AlwaysFlop>(SourceInfo(), clk_, reset_.value())
@@ -28,6 +28,20 @@
 namespace xls {
 namespace verilog {
 
+// Encoding used for the FSM state register.
+enum class FsmStateEncoding {
+  // States are numbered consecutively starting at zero.
+  kBinary,
+  // Successive state numbers differ in exactly one bit. Reduces state
+  // register switching activity for FSMs which mostly step through their
+  // states in order.
+  kGray,
+  // One bit per state, exactly one of which is set. Next-state and output
+  // logic decode a single bit rather than the full state vector which
+  // shortens the logic depth of FSMs with many states.
+  kOneHot,
+};
+
 // Encapsulates an output signal driven by finite state machine logic.
 struct FsmOutput {
   LogicRef* logic_ref;
@@ -86,6 +100,11 @@ class FsmBlockBase {
   // includes any assignments in nested conditional blocks.
   virtual bool HasAssignmentToOutput(const FsmOutput& output) const;
 
+  // Returns the depth of the conditional logic in the block: the maximum
+  // number of nested conditional levels beneath it, or zero if the block
+  // holds only unconditional assignments.
+  virtual int64_t LogicDepth() const;
+
   // Emits the output assignments contained in this block as blocking
   // assignments in the given VAST StatementBlock including any nested
   // conditional assignments.
@@ -259,6 +278,7 @@ class ConditionalFsmBlock : public FsmBlock<ConditionalFsmBlock> {
   bool HasAssignments() const override;
   bool HasStateTransitions() const override;
   bool HasAssignmentToOutput(const FsmOutput& output) const override;
+  int64_t LogicDepth() const override;
 
  protected:
   friend class FsmBlockBase;
@@ -332,13 +352,15 @@ class FsmBuilder {
  public:
   FsmBuilder(absl::string_view name, Module* module, LogicRef* clk,
              bool use_system_verilog,
-             std::optional<Reset> reset = absl::nullopt)
+             std::optional<Reset> reset = absl::nullopt,
+             FsmStateEncoding state_encoding = FsmStateEncoding::kBinary)
       : name_(name),
         module_(module),
         file_(module->file()),
         clk_(clk),
         use_system_verilog_(use_system_verilog),
-        reset_(reset) {}
+        reset_(reset),
+        state_encoding_(state_encoding) {}
 
   // Adds an FSM-controled signal to the FSM with the given name. A RegDef named
   // 'name' is added to the module.
@@ -400,15 +422,27 @@ class FsmBuilder {
 
   // Returns the state register width.
   int64_t StateRegisterWidth() const {
+    if (state_encoding_ == FsmStateEncoding::kOneHot) {
+      return std::max(int64_t{1}, static_cast<int64_t>(states_.size()));
+    }
     return std::max(int64_t{1}, Bits::MinBitCountUnsigned(states_.size() - 1));
   }
 
+  // Returns the numeric encoding of the state with the given index.
+  int64_t EncodedStateValue(int64_t index) const;
+
+  // Returns true if every possible value of the state register corresponds to
+  // a defined state, in which case the case statements dispatching on the
+  // state need no default arm.
+  bool StateSpaceIsExhaustive() const;
+
   std::string name_;
   Module* module_;
   VerilogFile* file_;
   LogicRef* clk_;
   bool use_system_verilog_;
   std::optional<Reset> reset_;
+  FsmStateEncoding state_encoding_;
 
   // Output and registers defined by the FSM prior to called Build (such as
   // AddOutput and AddRegister). These are added to the module when Build is
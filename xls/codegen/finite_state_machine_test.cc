@@ -360,6 +360,62 @@ TEST_P(FiniteStateMachineTest, MultipleConditionalAssignments) {
                HasSubstr("Output \"out\" may be assigned more than once")));
 }
 
+TEST_P(FiniteStateMachineTest, GrayEncodedFsm) {
+  VerilogFile f(UseSystemVerilog());
+  Module* module = f.Add(f.Make<Module>(SourceInfo(), TestBaseName()));
+
+  LogicRef* clk =
+      module->AddInput("clk", f.ScalarType(SourceInfo()), SourceInfo());
+  FsmBuilder fsm("GrayFsm", module, clk, UseSystemVerilog(),
+                 /*reset=*/absl::nullopt, FsmStateEncoding::kGray);
+  auto a = fsm.AddState("A");
+  auto b = fsm.AddState("B");
+  auto c = fsm.AddState("C");
+  auto d = fsm.AddState("D");
+  a->NextState(b);
+  b->NextState(c);
+  c->NextState(d);
+  d->NextState(a);
+
+  XLS_ASSERT_OK(fsm.Build());
+  std::string verilog = f.Emit();
+  XLS_VLOG(1) << verilog;
+  // Successive states differ in exactly one bit.
+  EXPECT_THAT(verilog, HasSubstr("StateA = 0"));
+  EXPECT_THAT(verilog, HasSubstr("StateB = 1"));
+  EXPECT_THAT(verilog, HasSubstr("StateC = 3"));
+  EXPECT_THAT(verilog, HasSubstr("StateD = 2"));
+  EXPECT_THAT(verilog, HasSubstr("StateBits = 2"));
+}
+
+TEST_P(FiniteStateMachineTest, OneHotEncodedFsm) {
+  VerilogFile f(UseSystemVerilog());
+  Module* module = f.Add(f.Make<Module>(SourceInfo(), TestBaseName()));
+
+  LogicRef* clk =
+      module->AddInput("clk", f.ScalarType(SourceInfo()), SourceInfo());
+  FsmBuilder fsm("OneHotFsm", module, clk, UseSystemVerilog(),
+                 /*reset=*/absl::nullopt, FsmStateEncoding::kOneHot);
+  auto a = fsm.AddState("A");
+  auto b = fsm.AddState("B");
+  auto c = fsm.AddState("C");
+  a->NextState(b);
+  b->NextState(c);
+  c->NextState(a);
+
+  XLS_ASSERT_OK(fsm.Build());
+  std::string verilog = f.Emit();
+  XLS_VLOG(1) << verilog;
+  // One state register bit per state, exactly one of which is set.
+  EXPECT_THAT(verilog, HasSubstr("StateBits = 3"));
+  EXPECT_THAT(verilog, HasSubstr("StateA = 1"));
+  EXPECT_THAT(verilog, HasSubstr("StateB = 2"));
+  EXPECT_THAT(verilog, HasSubstr("StateC = 4"));
+  // Not every value of the state register encodes a state, so the case
+  // statement dispatching on the state needs a default arm.
+  EXPECT_THAT(verilog, HasSubstr("default:"));
+}
+
 INSTANTIATE_TEST_SUITE_P(FiniteStateMachineTestInstantiation,
                          FiniteStateMachineTest,
                          testing::ValuesIn(kDefaultSimulationTargets),
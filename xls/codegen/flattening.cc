@@ -19,7 +19,6 @@
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
-#include "xls/ir/bits_ops.h"
 #include "xls/ir/package.h"
 
 namespace xls {
@@ -48,7 +47,16 @@ static void GatherValueLeaves(const Value& value, std::vector<Bits>* leaves) {
 Bits FlattenValueToBits(const Value& value) {
   std::vector<Bits> leaves;
   GatherValueLeaves(value, &leaves);
-  return bits_ops::Concat(leaves);
+  int64_t total_bits = 0;
+  for (const Bits& leaf : leaves) {
+    total_bits += leaf.bit_count();
+  }
+  // The first leaf is the most significant, so append in reverse.
+  BitsBuilder builder(total_bits);
+  for (int64_t i = leaves.size() - 1; i >= 0; --i) {
+    builder.AppendBits(leaves[i]);
+  }
+  return builder.Build();
 }
 
 absl::StatusOr<Value> UnflattenBitsToValue(const Bits& bits, const Type* type) {
@@ -226,6 +226,9 @@ void ModuleBuilder::NewDeclarationAndAssignmentSections() {
       declaration_and_assignment_section_->Add<ModuleSection>(SourceInfo()));
   assignment_subsections_.push_back(
       declaration_and_assignment_section_->Add<ModuleSection>(SourceInfo()));
+  // Cached expressions may refer to wires declared in the previous sections;
+  // don't reuse them across the section boundary.
+  expression_cache_.clear();
 }
 
 absl::Status ModuleBuilder::AssignFromSlice(
@@ -408,7 +411,37 @@ absl::StatusOr<Expression*> ModuleBuilder::EmitAsInlineExpression(
     XLS_ASSIGN_OR_RETURN(VerilogFunction * func, DefineFunction(node));
     return file_->Make<VerilogFunctionCall>(node->loc(), func, inputs);
   }
-  return NodeToExpression(node, inputs, file_, options_);
+
+  // Look for a structurally identical expression emitted earlier into the
+  // current declaration/assignment sections. Matching operand expressions
+  // together with IsDefinitelyEqualTo (same op, attributes and types)
+  // guarantee an identical result. On the first reuse the cached expression
+  // is promoted to a named wire so every reuse references the wire instead of
+  // duplicating the expression tree.
+  std::vector<ExpressionCacheEntry>& entries = expression_cache_[node->op()];
+  for (ExpressionCacheEntry& entry : entries) {
+    if (std::equal(entry.inputs.begin(), entry.inputs.end(), inputs.begin(),
+                   inputs.end()) &&
+        entry.node->IsDefinitelyEqualTo(node)) {
+      ++deduplicated_expression_count_;
+      if (dynamic_cast<LogicRef*>(entry.expression) == nullptr &&
+          dynamic_cast<Literal*>(entry.expression) == nullptr &&
+          !node->GetType()->IsArray()) {
+        LogicRef* wire = DeclareVariable(
+            absl::StrCat(entry.node->GetName(), "_shared"), node->GetType());
+        XLS_RETURN_IF_ERROR(Assign(wire, entry.expression, node->GetType()));
+        entry.expression = wire;
+      }
+      return entry.expression;
+    }
+  }
+
+  XLS_ASSIGN_OR_RETURN(Expression * expression,
+                       NodeToExpression(node, inputs, file_, options_));
+  entries.push_back(ExpressionCacheEntry{
+      node, std::vector<Expression*>(inputs.begin(), inputs.end()),
+      expression});
+  return expression;
 }
 
 // Emits a copy and update of an array as a sequence of assignments.
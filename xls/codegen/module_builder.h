@@ -81,10 +81,20 @@ class ModuleBuilder {
                                      users_of_expression = absl::nullopt);
 
   // Returns the given node as a Verilog expression. 'inputs' contains the
-  // operand expressions for the node.
+  // operand expressions for the node. Structurally identical expressions
+  // emitted into the current declaration/assignment sections are deduplicated:
+  // when a node computes the same expression over the same inputs as an
+  // earlier node, the earlier result is promoted to a named wire which is
+  // reused rather than duplicating the expression tree.
   absl::StatusOr<Expression*> EmitAsInlineExpression(
       Node* node, absl::Span<Expression* const> inputs);
 
+  // Returns the number of times an expression was reused from the structural
+  // expression cache rather than emitted anew.
+  int64_t deduplicated_expression_count() const {
+    return deduplicated_expression_count_;
+  }
+
   // Emits the node as one or more assignments to a newly declared variable with
   // the given name. 'inputs' contains the operand expressions for the
   // node. Returns a reference to the declared variable.
@@ -342,6 +352,25 @@ class ModuleBuilder {
   // name.
   absl::flat_hash_map<std::string, VerilogFunction*> node_functions_;
 
+  // Entry in the structural expression cache. `node` is the node whose
+  // emission produced `expression` from the operand expressions `inputs`.
+  struct ExpressionCacheEntry {
+    Node* node;
+    std::vector<Expression*> inputs;
+    Expression* expression;
+  };
+
+  // Cache of inline expressions emitted into the current
+  // declaration/assignment sections, indexed by op. A later node matches an
+  // entry if it has the same operand expressions and is definitely equal to
+  // the entry's node (same op, attributes and types). The cache is cleared
+  // when new declaration/assignment sections are created so cached
+  // expressions never cross pipeline stage boundaries.
+  absl::flat_hash_map<Op, std::vector<ExpressionCacheEntry>> expression_cache_;
+
+  // Number of cache hits in `expression_cache_`.
+  int64_t deduplicated_expression_count_ = 0;
+
   std::optional<BddQueryEngine> query_engine_;
 };
 
@@ -18,6 +18,8 @@
 
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "xls/codegen/block_conversion.h"
 #include "xls/codegen/block_generator.h"
 #include "xls/codegen/codegen_options.h"
@@ -53,6 +55,7 @@ absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
 
   XLS_RET_CHECK(module->IsProc() || module->IsFunction());
   // Convert to block and add in pipe stages according to schedule.
+  const absl::Time conversion_start = absl::Now();
   if (module->IsFunction()) {
     Function* func = module->AsFunctionOrDie();
     XLS_ASSIGN_OR_RETURN(block,
@@ -66,8 +69,11 @@ absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
     //  blocks with flow control.
     pass_options.codegen_options.emit_as_pipeline(false);
   }
+  const absl::Duration conversion_time = absl::Now() - conversion_start;
+  XLS_VLOG(1) << "Block conversion took " << conversion_time;
 
   CodegenPassUnit unit(module->package(), block);
+  unit.conversion_time_us = conversion_time / absl::Microseconds(1);
   PassResults results;
   XLS_RETURN_IF_ERROR(
       CreateCodegenPassPipeline()->Run(&unit, pass_options, &results).status());
@@ -75,7 +81,10 @@ absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
   VerilogLineMap verilog_line_map;
   XLS_ASSIGN_OR_RETURN(
       std::string verilog,
-      GenerateVerilog(block, pass_options.codegen_options, &verilog_line_map));
+      GenerateVerilog(block, pass_options.codegen_options,
+                      pass_options.codegen_options.emit_line_maps()
+                          ? &verilog_line_map
+                          : nullptr));
 
   return ModuleGeneratorResult{verilog, verilog_line_map,
                                unit.signature.value()};
@@ -66,7 +66,8 @@ absl::Status SequentialModuleBuilder::AddFsm(
 
   // Create states.
   FsmBuilder fsm("sequential_fsm", module(), port_references_.clk,
-                 sequential_options_.use_system_verilog(), reset);
+                 sequential_options_.use_system_verilog(), reset,
+                 sequential_options_.fsm_state_encoding());
   // Null state is used as the initial state to force a state transition to
   // Ready state when the FSM is reset. Without this, FSM outputs may not
   // simulate correctly in the ready state (b/159519643). The null state is not
@@ -24,6 +24,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
+#include "xls/codegen/finite_state_machine.h"
 #include "xls/codegen/module_builder.h"
 #include "xls/codegen/module_signature.h"
 #include "xls/codegen/pipeline_generator.h"
@@ -83,12 +84,21 @@ class SequentialOptions {
   }
   bool use_system_verilog() const { return use_system_verilog_; }
 
+  // Encoding to use for the state register of the FSM which orchestrates the
+  // sequential module's execution.
+  SequentialOptions& fsm_state_encoding(FsmStateEncoding encoding) {
+    fsm_state_encoding_ = encoding;
+    return *this;
+  }
+  FsmStateEncoding fsm_state_encoding() const { return fsm_state_encoding_; }
+
  private:
   const DelayEstimator* delay_estimator_ = &GetStandardDelayEstimator();
   std::optional<std::string> module_name_;
   std::optional<ResetProto> reset_proto_;
   SchedulingOptions pipeline_scheduling_options_;
   bool use_system_verilog_ = true;
+  FsmStateEncoding fsm_state_encoding_ = FsmStateEncoding::kBinary;
   // TODO(jbaileyhandle): Interface options.
 };
 
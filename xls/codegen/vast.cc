@@ -14,6 +14,8 @@
 
 #include "xls/codegen/vast.h"
 
+#include <thread>
+
 #include "absl/flags/flag.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/ascii.h"
@@ -21,10 +23,12 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_replace.h"
+#include "absl/strings/str_split.h"
 #include "absl/strings/strip.h"
 #include "xls/common/indent.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread_pool.h"
 #include "xls/common/visitor.h"
 #include "re2/re2.h"
 
@@ -33,6 +37,43 @@ namespace verilog {
 
 namespace {
 
+// Appends 'text' to 'out' with every line indented by kDefaultIndentSpaces,
+// producing the same output as Indent() without materializing an indented
+// copy of 'text'. Emission of a large module funnels the (potentially very
+// large) body text through an indentation step at every nesting level, so
+// the avoided copies add up.
+void AppendIndented(absl::string_view text, std::string* out) {
+  out->reserve(out->size() + text.size() + kDefaultIndentSpaces);
+  // As in Indent(), empty lines are not indented (to avoid trailing
+  // whitespace) and do not count as output for separator purposes.
+  bool empty_so_far = true;
+  for (absl::string_view line : absl::StrSplit(text, '\n')) {
+    if (!empty_so_far) {
+      out->push_back('\n');
+    }
+    if (!line.empty()) {
+      out->append(kDefaultIndentSpaces, ' ');
+      out->append(line.data(), line.size());
+      empty_so_far = false;
+    }
+  }
+}
+
+// Minimum number of members a ModuleSection must have before its members are
+// emitted concurrently. Small sections are emitted inline; scheduling
+// overhead would dominate the few microseconds their emission takes.
+constexpr int64_t kParallelEmitMinMembers = 64;
+
+// Shared pool used to emit the subtrees of large modules concurrently.
+// Created on first use so tools which never emit a large module do not pay
+// for the worker threads. Intentionally leaked: worker threads must not be
+// joined during static destruction.
+ThreadPool& EmissionThreadPool() {
+  static ThreadPool* pool = new ThreadPool(
+      static_cast<int64_t>(std::thread::hardware_concurrency()));
+  return *pool;
+}
+
 int64_t NumberOfNewlines(absl::string_view string) {
   int64_t number_of_newlines = 0;
   for (char c : string) {
@@ -219,7 +260,15 @@ std::string VerilogFile::Emit(LineInfo* line_info) const {
 
   std::string out;
   for (const FileMember& member : members_) {
-    absl::StrAppend(&out, file_member_str(member), "\n");
+    // A file is typically dominated by a single large module; move the first
+    // member's text rather than copying it into the output buffer.
+    std::string member_str = file_member_str(member);
+    if (out.empty()) {
+      out = std::move(member_str);
+      absl::StrAppend(&out, "\n");
+    } else {
+      absl::StrAppend(&out, member_str, "\n");
+    }
     LineInfoIncrease(line_info, 1);
   }
   return out;
@@ -257,12 +306,18 @@ std::string StatementBlock::Emit(LineInfo* line_info) const {
   }
   std::string result = "begin\n";
   LineInfoIncrease(line_info, 1);
-  std::vector<std::string> lines;
+  // Append each statement with indentation rather than collecting, joining
+  // and indenting the statement strings; blocks nest so the intermediate
+  // copies would be made once per nesting level.
+  const size_t body_start = result.size();
   for (const auto& statement : statements_) {
-    lines.push_back(statement->Emit(line_info));
+    if (result.size() > body_start) {
+      result.push_back('\n');
+    }
+    AppendIndented(statement->Emit(line_info), &result);
     LineInfoIncrease(line_info, 1);
   }
-  absl::StrAppend(&result, Indent(absl::StrJoin(lines, "\n")), "\nend");
+  absl::StrAppend(&result, "\nend");
   LineInfoEnd(line_info, this);
   return result;
 }
@@ -317,17 +372,24 @@ std::string VerilogFunction::Emit(LineInfo* line_info) const {
         absl::StrAppend(out, "input ", d->EmitNoSemi(line_info));
       });
   LineInfoIncrease(line_info, 1);
-  std::vector<std::string> lines;
+  std::string result =
+      absl::StrFormat("function automatic%s (%s);\n", return_type, parameters);
+  const size_t body_start = result.size();
+  auto append_body_line = [&](absl::string_view line) {
+    if (result.size() > body_start) {
+      result.push_back('\n');
+    }
+    AppendIndented(line, &result);
+  };
   for (RegDef* reg_def : block_reg_defs_) {
-    lines.push_back(reg_def->Emit(line_info));
+    append_body_line(reg_def->Emit(line_info));
     LineInfoIncrease(line_info, 1);
   }
-  lines.push_back(statement_block_->Emit(line_info));
+  append_body_line(statement_block_->Emit(line_info));
   LineInfoIncrease(line_info, 1);
   LineInfoEnd(line_info, this);
-  return absl::StrCat(
-      absl::StrFormat("function automatic%s (%s);\n", return_type, parameters),
-      Indent(absl::StrJoin(lines, "\n")), "\nendfunction");
+  absl::StrAppend(&result, "\nendfunction");
+  return result;
 }
 
 std::string VerilogFunctionCall::Emit(LineInfo* line_info) const {
@@ -568,21 +630,67 @@ std::string EmitModuleMember(LineInfo* line_info, const ModuleMember& member) {
 
 std::string ModuleSection::Emit(LineInfo* line_info) const {
   LineInfoStart(line_info, this);
-  std::vector<std::string> elements;
+  // Nested sections with no members produce no text; skip them up front so
+  // they do not contribute separator newlines.
+  std::vector<const ModuleMember*> members;
+  members.reserve(members_.size());
+  bool has_nested_section = false;
   for (const ModuleMember& member : members_) {
     if (absl::holds_alternative<ModuleSection*>(member)) {
       if (absl::get<ModuleSection*>(member)->members_.empty()) {
         continue;
       }
+      has_nested_section = true;
     }
-    elements.push_back(EmitModuleMember(line_info, member));
-    LineInfoIncrease(line_info, 1);
+    members.push_back(&member);
   }
-  if (!elements.empty()) {
-    LineInfoIncrease(line_info, -1);
+
+  std::string result;
+  if (line_info == nullptr &&
+      (has_nested_section ||
+       static_cast<int64_t>(members.size()) >= kParallelEmitMinMembers)) {
+    // Members are independent subtrees, so when no line map is being built
+    // they can be emitted in any order. Emit large sections -- and sections
+    // built of nested sections, which is how a module's regions and pipeline
+    // stages are laid out -- concurrently into per-member buffers, then
+    // stitch the buffers in member order. The result is byte-identical to
+    // sequential emission. Line tracking interleaves mutable state with
+    // emission and so forces the sequential path below.
+    std::vector<std::string> member_strs(members.size());
+    EmissionThreadPool().ParallelFor(
+        0, static_cast<int64_t>(members.size()), [&](int64_t i) {
+          member_strs[i] = EmitModuleMember(/*line_info=*/nullptr, *members[i]);
+        });
+    for (int64_t i = 0; i < static_cast<int64_t>(member_strs.size()); ++i) {
+      if (i == 0) {
+        result = std::move(member_strs[i]);
+      } else {
+        absl::StrAppend(&result, "\n", member_strs[i]);
+      }
+    }
+  } else {
+    bool any_members = false;
+    for (const ModuleMember* member : members) {
+      if (any_members) {
+        result.push_back('\n');
+      }
+      // Sections can hold large nested sections; move the first member's text
+      // rather than copying it into the result buffer.
+      std::string member_str = EmitModuleMember(line_info, *member);
+      if (result.empty()) {
+        result = std::move(member_str);
+      } else {
+        absl::StrAppend(&result, member_str);
+      }
+      any_members = true;
+      LineInfoIncrease(line_info, 1);
+    }
+    if (any_members) {
+      LineInfoIncrease(line_info, -1);
+    }
   }
   LineInfoEnd(line_info, this);
-  return absl::StrJoin(elements, "\n");
+  return result;
 }
 
 std::string ContinuousAssignment::Emit(LineInfo* line_info) const {
@@ -695,7 +803,8 @@ std::string Module::Emit(LineInfo* line_info) const {
     absl::StrAppend(&result, "\n);\n");
     LineInfoIncrease(line_info, 1);
   }
-  absl::StrAppend(&result, Indent(top_.Emit(line_info)), "\n");
+  AppendIndented(top_.Emit(line_info), &result);
+  absl::StrAppend(&result, "\n");
   LineInfoIncrease(line_info, 1);
   absl::StrAppend(&result, "endmodule");
   LineInfoEnd(line_info, this);
@@ -970,9 +1079,9 @@ std::string Case::Emit(LineInfo* line_info) const {
   for (auto& arm : arms_) {
     std::string arm_string = arm->Emit(line_info);
     std::string stmts_string = arm->statements()->Emit(line_info);
-    absl::StrAppend(&result,
-                    Indent(absl::StrFormat("%s: %s", arm_string, stmts_string)),
-                    "\n");
+    AppendIndented(absl::StrFormat("%s: %s", arm_string, stmts_string),
+                   &result);
+    absl::StrAppend(&result, "\n");
     LineInfoIncrease(line_info, 1);
   }
   absl::StrAppend(&result, "endcase");
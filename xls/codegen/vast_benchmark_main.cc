@@ -0,0 +1,107 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Microbenchmark for VAST emission. Builds synthetic pipelined modules of
+// various sizes, shaped like generated XLS pipelines (per-stage always
+// blocks of flopped assignments over nested expressions), and reports the
+// emission throughput in MB/sec:
+//
+//   bazel run -c opt //xls/codegen:vast_benchmark_main
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "xls/codegen/vast.h"
+#include "xls/common/init_xls.h"
+
+namespace xls {
+namespace verilog {
+namespace {
+
+// Builds a module with the given number of pipeline stages, each flopping
+// the given number of registers fed by small expression trees.
+Module* MakePipelinedModule(VerilogFile* f, int64_t stage_count,
+                            int64_t regs_per_stage) {
+  const SourceInfo loc;
+  Module* m = f->AddModule("pipelined_module", loc);
+  LogicRef* clk = m->AddInput("clk", f->ScalarType(loc), loc);
+  LogicRef* in = m->AddInput("in", f->BitVectorType(32, loc), loc);
+
+  std::vector<LogicRef*> previous(regs_per_stage, in);
+  for (int64_t stage = 0; stage < stage_count; ++stage) {
+    AlwaysFlop* af = m->Add<AlwaysFlop>(loc, clk);
+    std::vector<LogicRef*> current;
+    for (int64_t i = 0; i < regs_per_stage; ++i) {
+      LogicRef* reg = m->AddReg(absl::StrFormat("p%d_%d", stage, i),
+                                f->BitVectorType(32, loc), loc);
+      Expression* next = f->Add(
+          f->BitwiseXor(previous[i], previous[(i + 1) % regs_per_stage], loc),
+          f->Shll(previous[(i + 2) % regs_per_stage], f->PlainLiteral(1, loc),
+                  loc),
+          loc);
+      af->AddRegister(reg, next, loc);
+      current.push_back(reg);
+    }
+    previous = std::move(current);
+  }
+  LogicRef* out = m->AddOutput("out", f->BitVectorType(32, loc), loc);
+  m->Add<ContinuousAssignment>(loc, out, previous[0]);
+  return m;
+}
+
+void RunBenchmark(int64_t stage_count, int64_t regs_per_stage) {
+  VerilogFile f(/*use_system_verilog=*/false);
+  MakePipelinedModule(&f, stage_count, regs_per_stage);
+
+  // One warmup pass, then time a handful of emissions.
+  int64_t emitted_bytes = f.Emit().size();
+  constexpr int64_t kIterations = 5;
+  absl::Time start = absl::Now();
+  for (int64_t i = 0; i < kIterations; ++i) {
+    std::string text = f.Emit();
+    if (static_cast<int64_t>(text.size()) != emitted_bytes) {
+      std::cerr << "Unexpected emission size\n";
+      return;
+    }
+  }
+  absl::Duration elapsed = absl::Now() - start;
+  double mb_per_sec = static_cast<double>(emitted_bytes) * kIterations /
+                      (1024.0 * 1024.0) / absl::ToDoubleSeconds(elapsed);
+  std::cout << absl::StreamFormat(
+      "stages=%-5d regs/stage=%-5d size=%9d bytes %10.1f MB/sec\n",
+      stage_count, regs_per_stage, emitted_bytes, mb_per_sec);
+}
+
+void RealMain() {
+  RunBenchmark(/*stage_count=*/10, /*regs_per_stage=*/100);
+  RunBenchmark(/*stage_count=*/100, /*regs_per_stage=*/100);
+  RunBenchmark(/*stage_count=*/100, /*regs_per_stage=*/1000);
+  RunBenchmark(/*stage_count=*/1000, /*regs_per_stage=*/1000);
+}
+
+}  // namespace
+}  // namespace verilog
+}  // namespace xls
+
+int main(int argc, char** argv) {
+  xls::InitXls(argv[0], argc, argv);
+  xls::verilog::RealMain();
+  return 0;
+}
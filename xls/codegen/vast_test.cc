@@ -1181,6 +1181,21 @@ endmodule)");
             std::vector<LineSpan>{LineSpan(7, 7)});
 }
 
+TEST_P(VastTest, LargeSectionEmitsMembersInOrder) {
+  // A section with this many members is emitted concurrently (when no line
+  // map is requested); the stitched output must be identical to the
+  // sequential, line-tracking emission.
+  VerilogFile f(UseSystemVerilog());
+  Module* module = f.Make<Module>(SourceInfo(), "big_module");
+  for (int64_t i = 0; i < 1000; ++i) {
+    module->AddReg(absl::StrCat("reg_", i), f.BitVectorType(8, SourceInfo()),
+                   SourceInfo());
+  }
+  LineInfo line_info;
+  EXPECT_EQ(module->Emit(nullptr), module->Emit(&line_info));
+  EXPECT_THAT(module->Emit(nullptr), HasSubstr("reg [7:0] reg_999;"));
+}
+
 TEST_P(VastTest, VerilogFunction) {
   VerilogFile f(UseSystemVerilog());
   Module* m = f.AddModule("top", SourceInfo());
@@ -0,0 +1,84 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/allocation_accounting.h"
+
+#include <atomic>
+
+namespace xls {
+namespace {
+
+// Counters are hot on every accounted construction, so they are plain
+// process-wide atomics updated with relaxed ordering; reports only need
+// eventually-consistent totals.
+struct AtomicCounters {
+  std::atomic<int64_t> count{0};
+  std::atomic<int64_t> bytes{0};
+};
+
+AtomicCounters counters[kNumAllocationCategories];
+
+}  // namespace
+
+absl::string_view AllocationCategoryName(AllocationCategory category) {
+  switch (category) {
+    case AllocationCategory::kNode:
+      return "node";
+    case AllocationCategory::kValue:
+      return "value";
+    case AllocationCategory::kBits:
+      return "bits";
+    case AllocationCategory::kBdd:
+      return "bdd";
+  }
+  return "unknown";
+}
+
+void RecordAllocation(AllocationCategory category, int64_t bytes) {
+  AtomicCounters& c = counters[static_cast<int>(category)];
+  c.count.fetch_add(1, std::memory_order_relaxed);
+  c.bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+AllocationSnapshot SnapshotAllocationCounters() {
+  AllocationSnapshot snapshot;
+  for (int64_t i = 0; i < kNumAllocationCategories; ++i) {
+    snapshot.categories[i].count =
+        counters[i].count.load(std::memory_order_relaxed);
+    snapshot.categories[i].bytes =
+        counters[i].bytes.load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+AllocationSnapshot AllocationDelta(const AllocationSnapshot& before,
+                                   const AllocationSnapshot& after) {
+  AllocationSnapshot delta;
+  for (int64_t i = 0; i < kNumAllocationCategories; ++i) {
+    delta.categories[i].count =
+        after.categories[i].count - before.categories[i].count;
+    delta.categories[i].bytes =
+        after.categories[i].bytes - before.categories[i].bytes;
+  }
+  return delta;
+}
+
+void ResetAllocationCounters() {
+  for (int64_t i = 0; i < kNumAllocationCategories; ++i) {
+    counters[i].count.store(0, std::memory_order_relaxed);
+    counters[i].bytes.store(0, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace xls
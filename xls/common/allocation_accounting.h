@@ -0,0 +1,98 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Opt-in allocation accounting.
+//
+// Attributes allocator traffic to compiler subsystems without an external
+// profiler: the construction sites of the high-volume objects (IR nodes,
+// Values, Bits bitmaps, BDD nodes) record a count and a byte estimate against
+// a category through XLS_RECORD_ALLOCATION. The macro compiles to nothing
+// unless the accounting build configuration is enabled with
+//
+//   bazel build --define=xls_allocation_accounting=true ...
+//
+// so ordinary builds pay nothing for the instrumentation. When enabled, the
+// per-pass counter deltas appear in the `opt_main --pass_profile` output and
+// the process totals are reported at the end of benchmark_main runs.
+
+#ifndef XLS_COMMON_ALLOCATION_ACCOUNTING_H_
+#define XLS_COMMON_ALLOCATION_ACCOUNTING_H_
+
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
+
+namespace xls {
+
+// The subsystems whose allocations are accounted.
+enum class AllocationCategory : int {
+  kNode = 0,
+  kValue = 1,
+  kBits = 2,
+  kBdd = 3,
+};
+
+inline constexpr int64_t kNumAllocationCategories = 4;
+
+// Short lower-case name of the category, used as a key in reports.
+absl::string_view AllocationCategoryName(AllocationCategory category);
+
+// Totals recorded against one category. The byte figures are estimates
+// computed at the recording sites (payload sizes as known at construction),
+// not allocator measurements.
+struct AllocationCounters {
+  int64_t count = 0;
+  int64_t bytes = 0;
+};
+
+// A point-in-time copy of every category's counters.
+struct AllocationSnapshot {
+  AllocationCounters categories[kNumAllocationCategories];
+};
+
+// Returns true if this binary was built with allocation accounting enabled.
+constexpr bool AllocationAccountingEnabled() {
+#ifdef XLS_ALLOCATION_ACCOUNTING
+  return true;
+#else
+  return false;
+#endif
+}
+
+// Adds one allocation of `bytes` bytes to the counters of `category`.
+// Thread-safe. Prefer the XLS_RECORD_ALLOCATION macro at instrumentation
+// sites, which compiles out of disabled builds.
+void RecordAllocation(AllocationCategory category, int64_t bytes);
+
+// Returns a copy of all counters accumulated since process start (or the last
+// ResetAllocationCounters call). All zero in disabled builds.
+AllocationSnapshot SnapshotAllocationCounters();
+
+// Returns the per-category difference `after - before`.
+AllocationSnapshot AllocationDelta(const AllocationSnapshot& before,
+                                   const AllocationSnapshot& after);
+
+// Resets all counters to zero. Intended for test isolation.
+void ResetAllocationCounters();
+
+}  // namespace xls
+
+#ifdef XLS_ALLOCATION_ACCOUNTING
+#define XLS_RECORD_ALLOCATION(category, bytes) \
+  ::xls::RecordAllocation((category), (bytes))
+#else
+#define XLS_RECORD_ALLOCATION(category, bytes)
+#endif
+
+#endif  // XLS_COMMON_ALLOCATION_ACCOUNTING_H_
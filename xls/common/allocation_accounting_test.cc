@@ -0,0 +1,85 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/allocation_accounting.h"
+
+#include "gtest/gtest.h"
+
+namespace xls {
+namespace {
+
+// The tests call RecordAllocation directly rather than through
+// XLS_RECORD_ALLOCATION so they exercise the counters regardless of whether
+// the instrumentation build configuration is enabled.
+
+class AllocationAccountingTest : public ::testing::Test {
+ protected:
+  void SetUp() override { ResetAllocationCounters(); }
+};
+
+TEST_F(AllocationAccountingTest, CountersAccumulatePerCategory) {
+  RecordAllocation(AllocationCategory::kNode, 100);
+  RecordAllocation(AllocationCategory::kNode, 50);
+  RecordAllocation(AllocationCategory::kBits, 8);
+
+  AllocationSnapshot snapshot = SnapshotAllocationCounters();
+  EXPECT_EQ(
+      snapshot.categories[static_cast<int>(AllocationCategory::kNode)].count,
+      2);
+  EXPECT_EQ(
+      snapshot.categories[static_cast<int>(AllocationCategory::kNode)].bytes,
+      150);
+  EXPECT_EQ(
+      snapshot.categories[static_cast<int>(AllocationCategory::kBits)].count,
+      1);
+  EXPECT_EQ(
+      snapshot.categories[static_cast<int>(AllocationCategory::kValue)].count,
+      0);
+}
+
+TEST_F(AllocationAccountingTest, DeltaSubtractsSnapshots) {
+  RecordAllocation(AllocationCategory::kBdd, 24);
+  AllocationSnapshot before = SnapshotAllocationCounters();
+  RecordAllocation(AllocationCategory::kBdd, 24);
+  RecordAllocation(AllocationCategory::kBdd, 24);
+  AllocationSnapshot after = SnapshotAllocationCounters();
+
+  AllocationSnapshot delta = AllocationDelta(before, after);
+  EXPECT_EQ(
+      delta.categories[static_cast<int>(AllocationCategory::kBdd)].count, 2);
+  EXPECT_EQ(
+      delta.categories[static_cast<int>(AllocationCategory::kBdd)].bytes, 48);
+  EXPECT_EQ(
+      delta.categories[static_cast<int>(AllocationCategory::kNode)].count, 0);
+}
+
+TEST_F(AllocationAccountingTest, ResetClearsAllCategories) {
+  RecordAllocation(AllocationCategory::kValue, 16);
+  ResetAllocationCounters();
+  AllocationSnapshot snapshot = SnapshotAllocationCounters();
+  for (int64_t i = 0; i < kNumAllocationCategories; ++i) {
+    EXPECT_EQ(snapshot.categories[i].count, 0);
+    EXPECT_EQ(snapshot.categories[i].bytes, 0);
+  }
+}
+
+TEST_F(AllocationAccountingTest, CategoryNames) {
+  EXPECT_EQ(AllocationCategoryName(AllocationCategory::kNode), "node");
+  EXPECT_EQ(AllocationCategoryName(AllocationCategory::kValue), "value");
+  EXPECT_EQ(AllocationCategoryName(AllocationCategory::kBits), "bits");
+  EXPECT_EQ(AllocationCategoryName(AllocationCategory::kBdd), "bdd");
+}
+
+}  // namespace
+}  // namespace xls
@@ -0,0 +1,42 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_COMMON_CANCELLATION_H_
+#define XLS_COMMON_CANCELLATION_H_
+
+#include <atomic>
+
+namespace xls {
+
+// Token used to cooperatively cancel long-running work. The scope outlives
+// the work it guards; work checks `cancelled()` at convenient points (pass
+// boundaries, scheduler iterations, ThreadPool::ParallelFor chunks) and stops
+// early once the scope is cancelled.
+class CancellationScope {
+ public:
+  // Requests cancellation. Work already in flight runs to its next
+  // cancellation check; work which has not started is skipped.
+  void Cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+
+  bool cancelled() const {
+    return cancelled_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<bool> cancelled_{false};
+};
+
+}  // namespace xls
+
+#endif  // XLS_COMMON_CANCELLATION_H_
@@ -19,7 +19,7 @@
 
 namespace xls {
 
-// Returns the XLS root directory. See xls::dslx::FindExistingPath for use case.
+// Returns the XLS root directory. See xls::dslx::FindImportPath for use case.
 std::string_view GetXLSRootDir();
 
 }  // namespace xls
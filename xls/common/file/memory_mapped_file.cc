@@ -0,0 +1,79 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/file/memory_mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "xls/common/file/file_descriptor.h"
+#include "xls/common/status/error_code_to_status.h"
+
+namespace xls {
+
+/* static */ absl::StatusOr<MemoryMappedFile> MemoryMappedFile::Open(
+    const std::filesystem::path& file_name) {
+  FileDescriptor fd(open(file_name.c_str(), O_RDONLY));
+  if (fd.get() < 0) {
+    return ErrnoToStatus(errno).SetPrepend()
+           << absl::StrCat("Failed to open ", file_name.string(), ": ");
+  }
+  struct stat stat_result;
+  if (fstat(fd.get(), &stat_result) != 0) {
+    return ErrnoToStatus(errno).SetPrepend()
+           << absl::StrCat("Failed to stat ", file_name.string(), ": ");
+  }
+  size_t size = stat_result.st_size;
+  if (size == 0) {
+    // mmap rejects zero-length mappings; represent an empty file without one.
+    return MemoryMappedFile(nullptr, 0);
+  }
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+  if (data == MAP_FAILED) {
+    return ErrnoToStatus(errno).SetPrepend()
+           << absl::StrCat("Failed to mmap ", file_name.string(), ": ");
+  }
+  // The mapping remains valid after the descriptor is closed.
+  return MemoryMappedFile(data, size);
+}
+
+MemoryMappedFile::~MemoryMappedFile() { Unmap(); }
+
+MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other)
+    : data_(other.data_), size_(other.size_) {
+  other.data_ = nullptr;
+  other.size_ = 0;
+}
+
+MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& other) {
+  Unmap();
+  data_ = other.data_;
+  size_ = other.size_;
+  other.data_ = nullptr;
+  other.size_ = 0;
+  return *this;
+}
+
+void MemoryMappedFile::Unmap() {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+    data_ = nullptr;
+    size_ = 0;
+  }
+}
+
+}  // namespace xls
@@ -0,0 +1,59 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_COMMON_FILE_MEMORY_MAPPED_FILE_H_
+#define XLS_COMMON_FILE_MEMORY_MAPPED_FILE_H_
+
+#include <filesystem>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+
+namespace xls {
+
+// A read-only memory mapping of a file. Unlike GetFileContents this does not
+// copy the file into heap memory; pages are faulted in by the OS as they are
+// read, which keeps peak memory at the working-set size when scanning files
+// much larger than RAM.
+class MemoryMappedFile {
+ public:
+  // Maps the file at the given path read-only.
+  static absl::StatusOr<MemoryMappedFile> Open(
+      const std::filesystem::path& file_name);
+
+  ~MemoryMappedFile();
+
+  MemoryMappedFile(const MemoryMappedFile&) = delete;
+  MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+  MemoryMappedFile(MemoryMappedFile&& other);
+  MemoryMappedFile& operator=(MemoryMappedFile&& other);
+
+  // Returns the contents of the file. The view is valid for the lifetime of
+  // this object.
+  absl::string_view data() const {
+    return absl::string_view(static_cast<const char*>(data_), size_);
+  }
+
+ private:
+  MemoryMappedFile(void* data, size_t size) : data_(data), size_(size) {}
+
+  void Unmap();
+
+  void* data_;
+  size_t size_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_COMMON_FILE_MEMORY_MAPPED_FILE_H_
@@ -14,9 +14,14 @@
 
 #include "xls/common/golden_files.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "absl/flags/flag.h"
+#include "absl/strings/str_format.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/file/get_runfile_path.h"
+#include "xls/common/file/memory_mapped_file.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/matchers.h"
 #include "xls/common/update_golden_files_flag.inc"
@@ -26,6 +31,74 @@ ABSL_FLAG(std::string, xls_source_dir, "",
           "when --test_update_golden_files is given.");
 
 namespace xls {
+namespace {
+
+// Returns the line of `text` containing the character at `offset`, without
+// the trailing newline and truncated to a width suitable for a test log.
+absl::string_view LineAround(absl::string_view text, size_t offset) {
+  constexpr size_t kMaxLineLength = 200;
+  size_t begin =
+      offset == 0 ? absl::string_view::npos : text.rfind('\n', offset - 1);
+  begin = (begin == absl::string_view::npos) ? 0 : begin + 1;
+  size_t end = text.find('\n', offset);
+  end = (end == absl::string_view::npos) ? text.size() : end;
+  return text.substr(begin, std::min(end - begin, kMaxLineLength));
+}
+
+// Reports the first point at which `text` diverges from `golden` as a
+// nonfatal test failure with a caret diagnostic, in the style of
+// xls/ir/caret.h (which cannot be used here as xls/common does not depend on
+// xls/ir). Unlike EXPECT_EQ on the full strings, this never copies or prints
+// the bodies of the two inputs, which for multi-hundred-megabyte golden
+// Verilog outputs would multiply peak test memory.
+void ReportDivergence(absl::string_view text, absl::string_view golden,
+                      const std::filesystem::path& golden_file_path) {
+  // Scan for the first divergent byte in chunks so each mapped page of the
+  // golden file is touched once and can be evicted behind the scan.
+  constexpr size_t kChunkSize = 64 * 1024;
+  size_t limit = std::min(text.size(), golden.size());
+  size_t offset = 0;
+  while (offset < limit) {
+    size_t chunk = std::min(kChunkSize, limit - offset);
+    if (memcmp(text.data() + offset, golden.data() + offset, chunk) != 0) {
+      break;
+    }
+    offset += chunk;
+  }
+  while (offset < limit && text[offset] == golden[offset]) {
+    ++offset;
+  }
+
+  int64_t line_number = 1 + std::count(golden.begin(), golden.begin() + offset,
+                                       '\n');
+  size_t line_begin =
+      offset == 0 ? absl::string_view::npos : golden.rfind('\n', offset - 1);
+  line_begin = (line_begin == absl::string_view::npos) ? 0 : line_begin + 1;
+  int64_t column = offset - line_begin + 1;
+
+  absl::string_view golden_line = LineAround(golden, offset);
+  absl::string_view actual_line = LineAround(text, offset);
+  std::string caret_padding(std::min<int64_t>(column - 1, golden_line.size()),
+                            ' ');
+  if (offset == limit && text.size() != golden.size()) {
+    ADD_FAILURE() << absl::StreamFormat(
+        "Text differs from golden file in length (%d vs %d bytes); contents "
+        "agree up to the end of the shorter input.\n  --> %s:%d:%d",
+        text.size(), golden.size(), golden_file_path.string(), line_number,
+        column);
+    return;
+  }
+  ADD_FAILURE() << absl::StreamFormat(
+      "Text differs from golden file; first divergence:\n"
+      "  --> %s:%d:%d\n"
+      "   | %s\n"
+      "   | %s^\n"
+      "   | %s(actual): %s",
+      golden_file_path.string(), line_number, column, golden_line,
+      caret_padding, caret_padding, actual_line);
+}
+
+}  // namespace
 
 void ExpectEqualToGoldenFile(const std::filesystem::path& golden_file_path,
                              absl::string_view text,
@@ -45,10 +118,17 @@ void ExpectEqualToGoldenFile(const std::filesystem::path& golden_file_path,
   } else {
     XLS_ASSERT_OK_AND_ASSIGN(std::filesystem::path abs_path,
                              GetXlsRunfilePath(golden_file_path));
-    std::string golden = GetFileContents(abs_path).value();
+    // Map the golden file rather than reading it onto the heap; the
+    // comparison below streams through the mapping without ever holding a
+    // second copy of the expected contents.
+    XLS_ASSERT_OK_AND_ASSIGN(MemoryMappedFile golden_file,
+                             MemoryMappedFile::Open(abs_path));
+    absl::string_view golden = golden_file.data();
     testing::ScopedTrace trace(loc.file_name(), loc.line(),
                                "ExpectEqualToGoldenFile failed");
-    EXPECT_EQ(text, golden);
+    if (text != golden) {
+      ReportDivergence(text, golden, golden_file_path);
+    }
   }
 }
 
@@ -53,5 +53,17 @@ TEST_F(GoldenFilesTest, Miscomparison) {
   EXPECT_NONFATAL_FAILURE(ExpectEqualToGoldenFile(GoldenFilePath(), text), "");
 }
 
+TEST_F(GoldenFilesTest, MiscomparisonReportsFirstDivergence) {
+  // The golden file holds "golden" on line 4; the divergent 'X' is at column
+  // 3 of that line.
+  std::string text = R"(this
+is
+a
+goXden
+file)";
+  EXPECT_NONFATAL_FAILURE(ExpectEqualToGoldenFile(GoldenFilePath(), text),
+                          ":4:3");
+}
+
 }  // namespace
 }  // namespace xls
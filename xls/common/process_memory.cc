@@ -0,0 +1,35 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/process_memory.h"
+
+#include <sys/resource.h>
+
+namespace xls {
+
+int64_t GetPeakResidentSetSizeBytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#if defined(__APPLE__)
+  // On macOS ru_maxrss is reported in bytes.
+  return usage.ru_maxrss;
+#else
+  // On Linux ru_maxrss is reported in kilobytes.
+  return usage.ru_maxrss * 1024;
+#endif
+}
+
+}  // namespace xls
@@ -0,0 +1,31 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_COMMON_PROCESS_MEMORY_H_
+#define XLS_COMMON_PROCESS_MEMORY_H_
+
+#include <cstdint>
+
+namespace xls {
+
+// Returns the peak resident set size (memory high-water mark) of the calling
+// process in bytes, or zero if the value cannot be determined on this
+// platform. The value is monotonically nondecreasing over the lifetime of the
+// process so the difference between two calls measures how much a region of
+// code grew the high-water mark.
+int64_t GetPeakResidentSetSizeBytes();
+
+}  // namespace xls
+
+#endif  // XLS_COMMON_PROCESS_MEMORY_H_
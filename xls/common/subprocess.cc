@@ -17,12 +17,18 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <poll.h>
+#include <signal.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <deque>
 #include <filesystem>
+#include <memory>
+#include <optional>
+#include <thread>  // NOLINT(build/c++11)
 #include <utility>
 
 #include "absl/container/fixed_array.h"
@@ -33,6 +39,7 @@
 #include "xls/common/file/file_descriptor.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/common/strerror.h"
 
@@ -63,7 +70,8 @@ struct Pipe {
 void PrepareAndExecInChildProcess(const std::vector<const char*>& argv_pointers,
                                   const std::filesystem::path& cwd,
                                   const Pipe& stdout_pipe,
-                                  const Pipe& stderr_pipe) {
+                                  const Pipe& stderr_pipe,
+                                  const Pipe* stdin_pipe) {
   if (!cwd.empty()) {
     if (chdir(cwd.c_str()) != 0) {
       XLS_LOG(ERROR) << "chdir failed: " << Strerror(errno);
@@ -71,6 +79,11 @@ void PrepareAndExecInChildProcess(const std::vector<const char*>& argv_pointers,
     }
   }
 
+  if (stdin_pipe != nullptr) {
+    while ((dup2(stdin_pipe->exit.get(), STDIN_FILENO) == -1) &&
+           (errno == EINTR)) {
+    }
+  }
   while ((dup2(stdout_pipe.entrance.get(), STDOUT_FILENO) == -1) &&
          (errno == EINTR)) {
   }
@@ -160,6 +173,14 @@ absl::StatusOr<int> WaitForPid(pid_t pid) {
 
 absl::StatusOr<std::pair<std::string, std::string>> InvokeSubprocess(
     absl::Span<const std::string> argv, const std::filesystem::path& cwd) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<AsyncSubprocess> subprocess,
+                       AsyncSubprocess::Start(argv, cwd));
+  return subprocess->Wait();
+}
+
+/* static */ absl::StatusOr<std::unique_ptr<AsyncSubprocess>>
+AsyncSubprocess::Start(absl::Span<const std::string> argv,
+                       const std::filesystem::path& cwd, bool pipe_stdin) {
   if (argv.empty()) {
     return absl::InvalidArgumentError("Cannot invoke empty argv list.");
   }
@@ -179,37 +200,142 @@ absl::StatusOr<std::pair<std::string, std::string>> InvokeSubprocess(
 
   XLS_ASSIGN_OR_RETURN(auto stdout_pipe, Pipe::Open());
   XLS_ASSIGN_OR_RETURN(auto stderr_pipe, Pipe::Open());
+  std::optional<Pipe> stdin_pipe;
+  if (pipe_stdin) {
+    XLS_ASSIGN_OR_RETURN(stdin_pipe, Pipe::Open());
+  }
 
   pid_t pid = fork();
   if (pid == -1) {
     return absl::InternalError(
         absl::StrCat("Failed to fork: ", Strerror(errno)));
   } else if (pid == 0) {
-    PrepareAndExecInChildProcess(argv_pointers, cwd, stdout_pipe, stderr_pipe);
+    PrepareAndExecInChildProcess(argv_pointers, cwd, stdout_pipe, stderr_pipe,
+                                 stdin_pipe.has_value() ? &*stdin_pipe
+                                                        : nullptr);
   }
   // This is the parent process.
   stdout_pipe.entrance.Close();
   stderr_pipe.entrance.Close();
 
-  // Read from the output streams of the subprocess.
-  FileDescriptor* fds[] = {&stdout_pipe.exit, &stderr_pipe.exit};
-  XLS_ASSIGN_OR_RETURN(auto output_strings, ReadFileDescriptors(fds));
-  const auto& stdout_output = output_strings[0];
-  const auto& stderr_output = output_strings[1];
+  auto subprocess = std::unique_ptr<AsyncSubprocess>(new AsyncSubprocess());
+  subprocess->bin_name_ = std::move(bin_name);
+  subprocess->pid_ = pid;
+  if (stdin_pipe.has_value()) {
+    stdin_pipe->exit.Close();
+    subprocess->stdin_entrance_ = std::move(stdin_pipe->entrance);
+  }
+  subprocess->stdout_exit_ = std::move(stdout_pipe.exit);
+  subprocess->stderr_exit_ = std::move(stderr_pipe.exit);
+
+  // Drain the output streams on a background thread so the child never
+  // blocks on a full pipe regardless of what the caller does in the
+  // meantime.
+  AsyncSubprocess* raw = subprocess.get();
+  subprocess->io_thread_ = std::make_unique<Thread>([raw]() {
+    FileDescriptor* fds[] = {&raw->stdout_exit_, &raw->stderr_exit_};
+    raw->outputs_ = ReadFileDescriptors(fds);
+  });
+  return subprocess;
+}
+
+AsyncSubprocess::~AsyncSubprocess() {
+  if (waited_) {
+    return;
+  }
+  // The subprocess was abandoned: kill it and reap it so the background
+  // thread sees its pipes close and terminates.
+  CloseStdin();
+  kill(pid_, SIGKILL);
+  if (io_thread_ != nullptr) {
+    io_thread_->Join();
+  }
+  WaitForPid(pid_).status().IgnoreError();
+}
+
+absl::Status AsyncSubprocess::WriteStdin(absl::string_view data) {
+  XLS_RET_CHECK_NE(stdin_entrance_.get(), -1)
+      << "WriteStdin requires a subprocess started with pipe_stdin.";
+  // Writes to a pipe whose read end has closed raise SIGPIPE which would
+  // kill the process; suppress it once so such writes fail with EPIPE
+  // instead.
+  static const bool sigpipe_ignored = []() {
+    signal(SIGPIPE, SIG_IGN);
+    return true;
+  }();
+  (void)sigpipe_ignored;
+  while (!data.empty()) {
+    ssize_t written = write(stdin_entrance_.get(), data.data(), data.size());
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return absl::InternalError(absl::StrCat(
+          "Failed to write to stdin of ", bin_name_, ": ", Strerror(errno)));
+    }
+    data.remove_prefix(written);
+  }
+  return absl::OkStatus();
+}
+
+void AsyncSubprocess::CloseStdin() { stdin_entrance_.Close(); }
+
+absl::StatusOr<std::pair<std::string, std::string>> AsyncSubprocess::Wait() {
+  XLS_RET_CHECK(!waited_) << "Wait() may be called at most once.";
+  waited_ = true;
+  CloseStdin();
+  io_thread_->Join();
+  XLS_RETURN_IF_ERROR(outputs_.status());
+  const std::string& stdout_output = outputs_->at(0);
+  const std::string& stderr_output = outputs_->at(1);
 
-  XLS_VLOG_LINES(2, absl::StrCat(bin_name, " stdout:\n ", stdout_output));
-  XLS_VLOG_LINES(2, absl::StrCat(bin_name, " stderr:\n ", stderr_output));
+  XLS_VLOG_LINES(2, absl::StrCat(bin_name_, " stdout:\n ", stdout_output));
+  XLS_VLOG_LINES(2, absl::StrCat(bin_name_, " stderr:\n ", stderr_output));
 
-  // Wait for the subprocess to finish.
-  XLS_ASSIGN_OR_RETURN(int exit_status, WaitForPid(pid));
+  XLS_ASSIGN_OR_RETURN(int exit_status, WaitForPid(pid_));
   if (exit_status != 0) {
     return absl::InternalError(
         absl::StrFormat("Failed to execute %s; stdout: \"\"\"%s\"\"\"; "
                         "stderr: \"\"\"%s\"\"\"; exit code: %d",
-                        bin_name, stdout_output, stderr_output, exit_status));
+                        bin_name_, stdout_output, stderr_output, exit_status));
   }
 
   return std::make_pair(stdout_output, stderr_output);
 }
 
+std::vector<absl::StatusOr<std::pair<std::string, std::string>>>
+InvokeSubprocessesConcurrently(absl::Span<const std::vector<std::string>> argvs,
+                               int64_t max_concurrency) {
+  if (max_concurrency <= 0) {
+    max_concurrency =
+        std::max<int64_t>(1, std::thread::hardware_concurrency());
+  }
+  std::vector<absl::StatusOr<std::pair<std::string, std::string>>> results(
+      argvs.size(), absl::InternalError("Subprocess not run"));
+  // Sliding window: at most 'max_concurrency' subprocesses in flight,
+  // finished in input order.
+  std::deque<std::pair<int64_t, std::unique_ptr<AsyncSubprocess>>> in_flight;
+  auto finish_oldest = [&]() {
+    auto& [index, subprocess] = in_flight.front();
+    results[index] = subprocess->Wait();
+    in_flight.pop_front();
+  };
+  for (int64_t i = 0; i < static_cast<int64_t>(argvs.size()); ++i) {
+    if (static_cast<int64_t>(in_flight.size()) == max_concurrency) {
+      finish_oldest();
+    }
+    absl::StatusOr<std::unique_ptr<AsyncSubprocess>> subprocess =
+        AsyncSubprocess::Start(argvs[i]);
+    if (!subprocess.ok()) {
+      results[i] = subprocess.status();
+      continue;
+    }
+    in_flight.emplace_back(i, std::move(subprocess).value());
+  }
+  while (!in_flight.empty()) {
+    finish_oldest();
+  }
+  return results;
+}
+
 }  // namespace xls
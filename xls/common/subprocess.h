@@ -15,11 +15,21 @@
 #ifndef XLS_COMMON_SUBPROCESS_H_
 #define XLS_COMMON_SUBPROCESS_H_
 
+#include <sys/types.h>
+
+#include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
+#include "xls/common/file/file_descriptor.h"
+#include "xls/common/thread.h"
 
 namespace xls {
 
@@ -28,6 +38,64 @@ namespace xls {
 // stdout/stderr as a string pair.
 absl::StatusOr<std::pair<std::string, std::string>> InvokeSubprocess(
     absl::Span<const std::string> argv, const std::filesystem::path& cwd = "");
-}
+
+// A subprocess started asynchronously. The child's stdout and stderr are
+// drained by a background thread from the moment the process starts, so the
+// caller can overlap its own work -- generating stimulus to stream to the
+// child's stdin, parsing earlier responses, or running other subprocesses --
+// with the child's execution.
+class AsyncSubprocess {
+ public:
+  // Starts a subprocess with the given argv. If 'cwd' is not empty the
+  // subprocess is invoked in the given directory. When 'pipe_stdin' is true
+  // the child's stdin is connected to a pipe fed by WriteStdin/CloseStdin;
+  // otherwise the child inherits the parent's stdin.
+  static absl::StatusOr<std::unique_ptr<AsyncSubprocess>> Start(
+      absl::Span<const std::string> argv, const std::filesystem::path& cwd = "",
+      bool pipe_stdin = false);
+
+  // Kills and reaps the subprocess if Wait() has not completed.
+  ~AsyncSubprocess();
+
+  AsyncSubprocess(const AsyncSubprocess&) = delete;
+  AsyncSubprocess& operator=(const AsyncSubprocess&) = delete;
+
+  // Streams data to the child's stdin (requires 'pipe_stdin'). May block
+  // while the pipe is full; the output streams are drained concurrently so
+  // this cannot deadlock against the child's output.
+  absl::Status WriteStdin(absl::string_view data);
+
+  // Closes the child's stdin, signalling end of input. Called implicitly by
+  // Wait().
+  void CloseStdin();
+
+  // Blocks until the subprocess exits and all of its output has been drained.
+  // Returns the stdout/stderr pair, or an error including the captured output
+  // when the exit code is nonzero. May be called at most once.
+  absl::StatusOr<std::pair<std::string, std::string>> Wait();
+
+ private:
+  AsyncSubprocess() = default;
+
+  std::string bin_name_;
+  pid_t pid_ = -1;
+  bool waited_ = false;
+  FileDescriptor stdin_entrance_;
+  FileDescriptor stdout_exit_;
+  FileDescriptor stderr_exit_;
+  // Thread draining stdout/stderr into 'outputs_'. 'outputs_' may only be
+  // read after the thread is joined.
+  std::unique_ptr<Thread> io_thread_;
+  absl::StatusOr<std::vector<std::string>> outputs_;
+};
+
+// Invokes each argv list as a subprocess, running up to 'max_concurrency' of
+// them at a time (non-positive means one per hardware thread). Results are
+// returned in input order; a failing invocation does not cancel the others.
+std::vector<absl::StatusOr<std::pair<std::string, std::string>>>
+InvokeSubprocessesConcurrently(absl::Span<const std::vector<std::string>> argvs,
+                               int64_t max_concurrency = 0);
+
+}  // namespace xls
 
 #endif  // XLS_COMMON_SUBPROCESS_H_
@@ -14,8 +14,13 @@
 
 #include "xls/common/subprocess.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
 #include "xls/common/status/matchers.h"
 
 namespace xls {
@@ -57,6 +62,66 @@ TEST(SubprocessTest, LargeOutputToStdoutFirstWorks) {
   EXPECT_EQ(result->second, "hello\n");
 }
 
+TEST(SubprocessTest, AsyncSubprocessStreamsStdin) {
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<AsyncSubprocess> subprocess,
+      AsyncSubprocess::Start({"/bin/cat"}, /*cwd=*/"", /*pipe_stdin=*/true));
+  // Stream the input in pieces, as a caller overlapping stimulus generation
+  // with execution would.
+  XLS_ASSERT_OK(subprocess->WriteStdin("hello "));
+  XLS_ASSERT_OK(subprocess->WriteStdin("world\n"));
+  XLS_ASSERT_OK_AND_ASSIGN(auto result, subprocess->Wait());
+  EXPECT_EQ(result.first, "hello world\n");
+  EXPECT_EQ(result.second, "");
+}
+
+TEST(SubprocessTest, AsyncSubprocessLargeStdinDoesNotDeadlock) {
+  // Writes more data than fits in a pipe while the child echoes it back;
+  // this deadlocks unless output draining is concurrent with stdin writes.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<AsyncSubprocess> subprocess,
+      AsyncSubprocess::Start({"/bin/cat"}, /*cwd=*/"", /*pipe_stdin=*/true));
+  std::string line(1023, 'x');
+  line.push_back('\n');
+  for (int64_t i = 0; i < 1024; ++i) {
+    XLS_ASSERT_OK(subprocess->WriteStdin(line));
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(auto result, subprocess->Wait());
+  EXPECT_EQ(result.first.size(), 1024 * 1024);
+}
+
+TEST(SubprocessTest, AsyncSubprocessFailingCommandFails) {
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<AsyncSubprocess> subprocess,
+      AsyncSubprocess::Start({"/bin/sh", "-c", "/bin/echo boom >&2; exit 3"}));
+  auto result = subprocess->Wait();
+  ASSERT_THAT(result, StatusIs(absl::StatusCode::kInternal));
+  EXPECT_THAT(result.status().ToString(), HasSubstr("boom"));
+  EXPECT_THAT(result.status().ToString(), HasSubstr("exit code: 3"));
+}
+
+TEST(SubprocessTest, AbandonedAsyncSubprocessIsKilled) {
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<AsyncSubprocess> subprocess,
+      AsyncSubprocess::Start({"/bin/sleep", "1000"}));
+  // Destroying the handle without calling Wait() must not hang.
+  subprocess.reset();
+}
+
+TEST(SubprocessTest, ConcurrentInvocationsReturnResultsInOrder) {
+  std::vector<std::vector<std::string>> argvs;
+  for (int64_t i = 0; i < 8; ++i) {
+    argvs.push_back({"/bin/sh", "-c", absl::StrCat("/bin/echo ", i)});
+  }
+  std::vector<absl::StatusOr<std::pair<std::string, std::string>>> results =
+      InvokeSubprocessesConcurrently(argvs, /*max_concurrency=*/3);
+  ASSERT_EQ(results.size(), 8);
+  for (int64_t i = 0; i < 8; ++i) {
+    XLS_ASSERT_OK(results[i]);
+    EXPECT_EQ(results[i]->first, absl::StrCat(i, "\n"));
+  }
+}
+
 TEST(SubprocessTest, LargeOutputToStderrFirstWorks) {
   auto result = InvokeSubprocess(
       {"/bin/sh", "-c", "/usr/bin/env seq 10000 >&2 && /bin/echo hello"});
@@ -0,0 +1,228 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/thread_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "xls/common/logging/logging.h"
+#include "xls/common/math_util.h"
+
+namespace xls {
+namespace {
+
+// Identity of the current thread within a pool. Used to route tasks
+// scheduled from a worker onto that worker's own deque.
+thread_local ThreadPool* tls_pool = nullptr;
+thread_local int64_t tls_worker_index = -1;
+
+}  // namespace
+
+ThreadPool::ThreadPool(int64_t worker_count, uint64_t seed) {
+  XLS_CHECK_GE(worker_count, 0);
+  worker_states_.reserve(worker_count);
+  for (int64_t i = 0; i < worker_count; ++i) {
+    worker_states_.push_back(std::make_unique<WorkerState>());
+  }
+  workers_.reserve(worker_count);
+  for (int64_t i = 0; i < worker_count; ++i) {
+    workers_.push_back(std::make_unique<Thread>(
+        [this, i, seed]() { WorkerLoop(i, seed + static_cast<uint64_t>(i)); }));
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    absl::MutexLock lock(&mu_);
+    shutdown_ = true;
+    wake_.SignalAll();
+  }
+  for (std::unique_ptr<Thread>& worker : workers_) {
+    worker->Join();
+  }
+}
+
+void ThreadPool::ScheduleClosure(std::function<void()> fn) {
+  if (workers_.empty()) {
+    fn();
+    return;
+  }
+  if (tls_pool == this) {
+    WorkerState& self = *worker_states_[tls_worker_index];
+    absl::MutexLock lock(&self.mu);
+    self.tasks.push_back(std::move(fn));
+  } else {
+    absl::MutexLock lock(&mu_);
+    shared_queue_.push_back(std::move(fn));
+    ++queued_task_count_;
+    wake_.Signal();
+    return;
+  }
+  absl::MutexLock lock(&mu_);
+  ++queued_task_count_;
+  wake_.Signal();
+}
+
+void ThreadPool::DecrementQueued() {
+  absl::MutexLock lock(&mu_);
+  --queued_task_count_;
+}
+
+bool ThreadPool::TryGetTask(int64_t worker_index, std::mt19937_64& rng,
+                            std::function<void()>* task) {
+  // Own deque, newest first for locality.
+  {
+    WorkerState& self = *worker_states_[worker_index];
+    absl::MutexLock lock(&self.mu);
+    if (!self.tasks.empty()) {
+      *task = std::move(self.tasks.back());
+      self.tasks.pop_back();
+      DecrementQueued();
+      return true;
+    }
+  }
+  // Shared queue, oldest first.
+  {
+    absl::MutexLock lock(&mu_);
+    if (!shared_queue_.empty()) {
+      *task = std::move(shared_queue_.front());
+      shared_queue_.pop_front();
+      --queued_task_count_;
+      return true;
+    }
+  }
+  // Steal from random victims, oldest first.
+  for (int64_t attempt = 0; attempt < worker_count(); ++attempt) {
+    int64_t victim = static_cast<int64_t>(rng() % worker_count());
+    if (victim == worker_index) {
+      continue;
+    }
+    WorkerState& other = *worker_states_[victim];
+    absl::MutexLock lock(&other.mu);
+    if (!other.tasks.empty()) {
+      *task = std::move(other.tasks.front());
+      other.tasks.pop_front();
+      DecrementQueued();
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::WorkerLoop(int64_t worker_index, uint64_t seed) {
+  tls_pool = this;
+  tls_worker_index = worker_index;
+  std::mt19937_64 rng(seed);
+  while (true) {
+    std::function<void()> task;
+    if (TryGetTask(worker_index, rng, &task)) {
+      task();
+      continue;
+    }
+    absl::MutexLock lock(&mu_);
+    if (queued_task_count_ == 0) {
+      if (shutdown_) {
+        return;
+      }
+      wake_.Wait(&mu_);
+    }
+    // A nonzero count with no task found means another worker dequeued the
+    // task between the count check and our scan; retry.
+  }
+}
+
+void ThreadPool::ParallelFor(int64_t begin, int64_t end,
+                             const std::function<void(int64_t)>& fn,
+                             CancellationScope* scope) {
+  XLS_CHECK_LE(begin, end);
+  if (begin == end) {
+    return;
+  }
+  if (workers_.empty()) {
+    for (int64_t i = begin; i < end; ++i) {
+      if (scope != nullptr && scope->cancelled()) {
+        return;
+      }
+      fn(i);
+    }
+    return;
+  }
+
+  // State shared between the caller and the helper tasks. Heap-allocated
+  // because helper tasks which lose the race for a chunk may outlive this
+  // call; such stragglers touch nothing but the atomic chunk counter. `fn`
+  // and `scope` are only dereferenced while a chunk executes, which always
+  // happens before the caller returns.
+  struct SharedState {
+    int64_t begin;
+    int64_t end;
+    int64_t chunk_size;
+    int64_t chunk_count;
+    const std::function<void(int64_t)>* fn;
+    CancellationScope* scope;
+    std::atomic<int64_t> next_chunk{0};
+    absl::Mutex mu;
+    int64_t chunks_done ABSL_GUARDED_BY(mu) = 0;
+  };
+  auto state = std::make_shared<SharedState>();
+  const int64_t total = end - begin;
+  state->begin = begin;
+  state->end = end;
+  state->chunk_count = std::min(total, worker_count() * 4);
+  state->chunk_size = CeilOfRatio(total, state->chunk_count);
+  state->chunk_count = CeilOfRatio(total, state->chunk_size);
+  state->fn = &fn;
+  state->scope = scope;
+
+  // Claims one chunk and runs it. Returns false when no chunks remain.
+  auto run_one_chunk = [](SharedState* s) {
+    int64_t chunk = s->next_chunk.fetch_add(1, std::memory_order_relaxed);
+    if (chunk >= s->chunk_count) {
+      return false;
+    }
+    if (s->scope == nullptr || !s->scope->cancelled()) {
+      int64_t chunk_begin = s->begin + chunk * s->chunk_size;
+      int64_t chunk_end = std::min(s->end, chunk_begin + s->chunk_size);
+      for (int64_t i = chunk_begin; i < chunk_end; ++i) {
+        if (s->scope != nullptr && s->scope->cancelled()) {
+          break;
+        }
+        (*s->fn)(i);
+      }
+    }
+    absl::MutexLock lock(&s->mu);
+    ++s->chunks_done;
+    return true;
+  };
+
+  for (int64_t i = 1; i < state->chunk_count; ++i) {
+    ScheduleClosure([state, run_one_chunk]() { run_one_chunk(state.get()); });
+  }
+  // The calling thread claims chunks too, so every chunk is executed even if
+  // no worker ever picks up a helper task. This makes ParallelFor safe to
+  // call from within a pool task.
+  while (run_one_chunk(state.get())) {
+  }
+
+  absl::MutexLock lock(&state->mu);
+  state->mu.Await(absl::Condition(
+      +[](SharedState* s) {
+        s->mu.AssertHeld();
+        return s->chunks_done == s->chunk_count;
+      },
+      state.get()));
+}
+
+}  // namespace xls
@@ -0,0 +1,115 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_COMMON_THREAD_POOL_H_
+#define XLS_COMMON_THREAD_POOL_H_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "xls/common/cancellation.h"
+#include "xls/common/thread.h"
+
+namespace xls {
+
+// A work-stealing thread pool. Each worker thread owns a deque of tasks;
+// tasks scheduled from a worker are pushed onto that worker's deque and
+// executed LIFO for locality, while idle workers steal FIFO from the other
+// end of a randomly chosen victim's deque. Tasks scheduled from outside the
+// pool land in a shared queue serviced by all workers.
+//
+// The victim-selection RNG of each worker is seeded from the pool seed, so a
+// fixed seed makes stealing decisions reproducible from run to run (useful
+// for tests chasing scheduling-dependent failures). A pool with zero workers
+// executes every task inline on the calling thread, which provides a fully
+// deterministic mode for tests.
+//
+// The destructor drains all scheduled work before joining the workers.
+class ThreadPool {
+ public:
+  // Creates a pool with `worker_count` worker threads (zero means inline
+  // execution). `seed` seeds the per-worker steal RNGs.
+  explicit ThreadPool(int64_t worker_count, uint64_t seed = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Schedules `fn` for execution and returns a future holding its result.
+  template <typename F, typename R = std::invoke_result_t<F>>
+  std::future<R> Schedule(F&& fn) {
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+    std::future<R> future = task->get_future();
+    ScheduleClosure([task]() { (*task)(); });
+    return future;
+  }
+
+  // Runs `fn(i)` for every i in [begin, end), distributing contiguous chunks
+  // of the range across the pool. Blocks until all iterations have run or
+  // `scope` (which may be null) has been cancelled; after cancellation the
+  // remaining iterations are skipped. The calling thread participates in
+  // executing chunks, so this is safe to call from within a pool task.
+  void ParallelFor(int64_t begin, int64_t end,
+                   const std::function<void(int64_t)>& fn,
+                   CancellationScope* scope = nullptr);
+
+  int64_t worker_count() const { return workers_.size(); }
+
+ private:
+  // Per-worker task deque. The owning worker pushes and pops at the back;
+  // thieves steal from the front.
+  struct WorkerState {
+    absl::Mutex mu;
+    std::deque<std::function<void()>> tasks ABSL_GUARDED_BY(mu);
+  };
+
+  // Enqueues the closure on the current worker's deque if called from within
+  // the pool, otherwise on the shared queue. Runs it inline if the pool has
+  // no workers.
+  void ScheduleClosure(std::function<void()> fn);
+
+  // Body of each worker thread.
+  void WorkerLoop(int64_t worker_index, uint64_t seed);
+
+  // Attempts to dequeue a task: first the worker's own deque, then the
+  // shared queue, then stealing from random victims. Returns false if no
+  // task was found.
+  bool TryGetTask(int64_t worker_index, std::mt19937_64& rng,
+                  std::function<void()>* task);
+
+  // Decrements the count of queued tasks after a successful dequeue.
+  void DecrementQueued();
+
+  std::vector<std::unique_ptr<WorkerState>> worker_states_;
+  std::vector<std::unique_ptr<Thread>> workers_;
+
+  absl::Mutex mu_;
+  std::deque<std::function<void()>> shared_queue_ ABSL_GUARDED_BY(mu_);
+  // Number of tasks sitting in any queue (shared or per-worker). Workers
+  // sleep only when this is zero.
+  int64_t queued_task_count_ ABSL_GUARDED_BY(mu_) = 0;
+  bool shutdown_ ABSL_GUARDED_BY(mu_) = false;
+  absl::CondVar wake_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_COMMON_THREAD_POOL_H_
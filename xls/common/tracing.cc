@@ -0,0 +1,170 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/tracing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "xls/common/file/filesystem.h"
+
+namespace xls {
+namespace {
+
+// Number of events retained per thread before the oldest are overwritten.
+constexpr int64_t kRingCapacity = 1 << 14;
+
+std::atomic<bool> tracing_enabled{false};
+
+struct TraceEvent {
+  char name[ScopedTraceEvent::kMaxNameSize];
+  int64_t start_ns;
+  int64_t duration_ns;
+};
+
+// Ring buffer of events recorded by a single thread. Guarded by a mutex so
+// the exporter can read buffers of live threads; the lock is uncontended on
+// the hot path.
+struct ThreadTraceBuffer {
+  explicit ThreadTraceBuffer(int64_t tid) : tid(tid) {
+    events.resize(kRingCapacity);
+  }
+
+  void Record(const char* name, int64_t start_ns, int64_t duration_ns) {
+    absl::MutexLock lock(&mu);
+    TraceEvent& event = events[next];
+    std::memcpy(event.name, name, ScopedTraceEvent::kMaxNameSize);
+    event.start_ns = start_ns;
+    event.duration_ns = duration_ns;
+    next = (next + 1) % kRingCapacity;
+    wrapped = wrapped || next == 0;
+  }
+
+  const int64_t tid;
+  absl::Mutex mu;
+  std::vector<TraceEvent> events ABSL_GUARDED_BY(mu);
+  int64_t next ABSL_GUARDED_BY(mu) = 0;
+  bool wrapped ABSL_GUARDED_BY(mu) = false;
+};
+
+// Registry of all per-thread buffers. Buffers are kept alive by the registry
+// after their thread exits so late exports still see their events.
+struct BufferRegistry {
+  absl::Mutex mu;
+  std::vector<std::shared_ptr<ThreadTraceBuffer>> buffers ABSL_GUARDED_BY(mu);
+};
+
+BufferRegistry& GetRegistry() {
+  static BufferRegistry* registry = new BufferRegistry;
+  return *registry;
+}
+
+ThreadTraceBuffer& GetThreadBuffer() {
+  thread_local std::shared_ptr<ThreadTraceBuffer> buffer = []() {
+    BufferRegistry& registry = GetRegistry();
+    absl::MutexLock lock(&registry.mu);
+    auto new_buffer = std::make_shared<ThreadTraceBuffer>(
+        static_cast<int64_t>(registry.buffers.size()));
+    registry.buffers.push_back(new_buffer);
+    return new_buffer;
+  }();
+  return *buffer;
+}
+
+}  // namespace
+
+void EnableTracing() {
+  tracing_enabled.store(true, std::memory_order_relaxed);
+}
+
+void DisableTracing() {
+  tracing_enabled.store(false, std::memory_order_relaxed);
+}
+
+bool TracingEnabled() {
+  return tracing_enabled.load(std::memory_order_relaxed);
+}
+
+void ClearTraceEvents() {
+  BufferRegistry& registry = GetRegistry();
+  absl::MutexLock lock(&registry.mu);
+  for (const std::shared_ptr<ThreadTraceBuffer>& buffer : registry.buffers) {
+    absl::MutexLock buffer_lock(&buffer->mu);
+    buffer->next = 0;
+    buffer->wrapped = false;
+  }
+}
+
+std::string TraceEventsToJson() {
+  std::string json = "{\"traceEvents\":[";
+  bool first = true;
+  auto append_event = [&](int64_t tid, const TraceEvent& event) {
+    absl::StrAppendFormat(
+        &json,
+        "%s\n{\"name\":\"%s\",\"cat\":\"xls\",\"ph\":\"X\",\"pid\":0,"
+        "\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+        first ? "" : ",", event.name, tid,
+        static_cast<double>(event.start_ns) / 1000.0,
+        static_cast<double>(event.duration_ns) / 1000.0);
+    first = false;
+  };
+  BufferRegistry& registry = GetRegistry();
+  absl::MutexLock lock(&registry.mu);
+  for (const std::shared_ptr<ThreadTraceBuffer>& buffer : registry.buffers) {
+    absl::MutexLock buffer_lock(&buffer->mu);
+    if (buffer->wrapped) {
+      for (int64_t i = buffer->next; i < kRingCapacity; ++i) {
+        append_event(buffer->tid, buffer->events[i]);
+      }
+    }
+    for (int64_t i = 0; i < buffer->next; ++i) {
+      append_event(buffer->tid, buffer->events[i]);
+    }
+  }
+  absl::StrAppend(&json, "\n]}\n");
+  return json;
+}
+
+absl::Status WriteTraceEventsToFile(const std::filesystem::path& path) {
+  return SetFileContents(path, TraceEventsToJson());
+}
+
+ScopedTraceEvent::ScopedTraceEvent(absl::string_view name) {
+  if (!TracingEnabled()) {
+    start_ns_ = -1;
+    return;
+  }
+  int64_t size = std::min<int64_t>(name.size(), kMaxNameSize - 1);
+  std::memcpy(name_, name.data(), size);
+  std::memset(name_ + size, 0, kMaxNameSize - size);
+  start_ns_ = absl::GetCurrentTimeNanos();
+}
+
+ScopedTraceEvent::~ScopedTraceEvent() {
+  if (start_ns_ < 0) {
+    return;
+  }
+  GetThreadBuffer().Record(name_, start_ns_,
+                           absl::GetCurrentTimeNanos() - start_ns_);
+}
+
+}  // namespace xls
@@ -0,0 +1,86 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/tracing.h"
+
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/thread.h"
+
+namespace xls {
+namespace {
+
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+TEST(TracingTest, DisabledByDefaultRecordsNothing) {
+  ClearTraceEvents();
+  { ScopedTraceEvent event("should_not_appear"); }
+  EXPECT_THAT(TraceEventsToJson(), Not(HasSubstr("should_not_appear")));
+}
+
+TEST(TracingTest, ScopedEventsAreRecordedWhenEnabled) {
+  ClearTraceEvents();
+  EnableTracing();
+  {
+    ScopedTraceEvent outer("outer_event");
+    ScopedTraceEvent inner("inner_event");
+  }
+  DisableTracing();
+  std::string json = TraceEventsToJson();
+  EXPECT_THAT(json, HasSubstr("\"name\":\"outer_event\""));
+  EXPECT_THAT(json, HasSubstr("\"name\":\"inner_event\""));
+  EXPECT_THAT(json, HasSubstr("\"ph\":\"X\""));
+  EXPECT_THAT(json, HasSubstr("\"traceEvents\""));
+}
+
+TEST(TracingTest, LongNamesAreTruncated) {
+  ClearTraceEvents();
+  EnableTracing();
+  std::string long_name(1000, 'x');
+  { ScopedTraceEvent event(long_name); }
+  DisableTracing();
+  std::string json = TraceEventsToJson();
+  EXPECT_THAT(json,
+              HasSubstr(std::string(ScopedTraceEvent::kMaxNameSize - 1, 'x')));
+  EXPECT_THAT(json, Not(HasSubstr(std::string(100, 'x'))));
+}
+
+TEST(TracingTest, EventsFromMultipleThreads) {
+  ClearTraceEvents();
+  EnableTracing();
+  {
+    Thread thread([]() { ScopedTraceEvent event("worker_event"); });
+    ScopedTraceEvent event("main_event");
+    thread.Join();
+  }
+  DisableTracing();
+  std::string json = TraceEventsToJson();
+  EXPECT_THAT(json, HasSubstr("\"name\":\"worker_event\""));
+  EXPECT_THAT(json, HasSubstr("\"name\":\"main_event\""));
+}
+
+TEST(TracingTest, ClearDiscardsEvents) {
+  ClearTraceEvents();
+  EnableTracing();
+  { ScopedTraceEvent event("cleared_event"); }
+  DisableTracing();
+  ClearTraceEvents();
+  EXPECT_THAT(TraceEventsToJson(), Not(HasSubstr("cleared_event")));
+}
+
+}  // namespace
+}  // namespace xls
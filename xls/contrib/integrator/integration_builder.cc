@@ -14,6 +14,11 @@
 
 #include "xls/contrib/integrator/integration_builder.h"
 
+#include <optional>
+
+#include "absl/strings/str_format.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/thread_pool.h"
 #include "xls/contrib/integrator/integration_algorithms/basic_integration_algorithm.h"
 
 namespace xls {
@@ -91,4 +96,61 @@ absl::StatusOr<std::unique_ptr<IntegrationBuilder>> IntegrationBuilder::Build(
   return std::move(builder);
 }
 
+// Returns the summed per-node area estimate of the integrated function.
+static absl::StatusOr<int64_t> EstimateIntegratedArea(
+    IntegrationBuilder& builder, const AreaEstimator& area_estimator) {
+  int64_t area = 0;
+  for (Node* node : builder.integrated_function()->function()->nodes()) {
+    XLS_ASSIGN_OR_RETURN(int64_t node_area,
+                         area_estimator.GetOperationArea(node));
+    area += node_area;
+  }
+  return area;
+}
+
+absl::StatusOr<std::unique_ptr<IntegrationBuilder>>
+IntegrationBuilder::BuildParallel(
+    absl::Span<const Function* const> input_functions,
+    absl::Span<const IntegrationOptions> candidate_options,
+    const AreaEstimator& area_estimator, int64_t worker_count) {
+  XLS_RET_CHECK(!candidate_options.empty());
+
+  // Each candidate builds into its own IntegrationBuilder (and thus its own
+  // package populated from clones of the source functions), so workers never
+  // share mutable IR; the original packages are only read.
+  int64_t num_candidates = candidate_options.size();
+  std::vector<absl::StatusOr<std::unique_ptr<IntegrationBuilder>>> results(
+      num_candidates);
+  std::vector<absl::StatusOr<int64_t>> areas(num_candidates);
+  ThreadPool pool(worker_count);
+  pool.ParallelFor(0, num_candidates, [&](int64_t i) {
+    results[i] = Build(input_functions, candidate_options[i]);
+    if (results[i].ok()) {
+      areas[i] = EstimateIntegratedArea(**results[i], area_estimator);
+    }
+  });
+
+  // Pick the smallest estimated area; ties go to the earlier candidate so the
+  // choice is independent of scheduling. Failures are only an error if no
+  // candidate succeeded.
+  std::optional<int64_t> best_index;
+  for (int64_t i = 0; i < num_candidates; ++i) {
+    if (!results[i].ok() || !areas[i].ok()) {
+      continue;
+    }
+    if (!best_index.has_value() ||
+        areas[i].value() < areas[*best_index].value()) {
+      best_index = i;
+    }
+  }
+  if (!best_index.has_value()) {
+    absl::Status status = results[0].status();
+    return results[0].ok() ? areas[0].status() : status;
+  }
+  XLS_VLOG(2) << absl::StreamFormat(
+      "Selected integration candidate %d of %d with estimated area %d",
+      *best_index, num_candidates, areas[*best_index].value());
+  return std::move(results[*best_index]);
+}
+
 }  // namespace xls
@@ -16,6 +16,7 @@
 #define XLS_INTEGRATOR_INTEGRATION_BUILDER_H_
 
 #include "absl/status/statusor.h"
+#include "xls/contrib/integrator/area_model/area_estimator.h"
 #include "xls/contrib/integrator/integration_options.h"
 #include "xls/contrib/integrator/ir_integrator.h"
 #include "xls/ir/function.h"
@@ -42,6 +43,18 @@ class IntegrationBuilder {
       absl::Span<const Function* const> input_functions,
       const IntegrationOptions& options = IntegrationOptions());
 
+  // Runs Build for every candidate in `candidate_options` concurrently on
+  // `worker_count` threads (zero means build serially on the calling thread)
+  // and returns the builder whose integrated function has the smallest
+  // estimated area under `area_estimator`. Each worker clones the source
+  // functions into its own package, so candidates do not share mutable IR.
+  // Ties are broken in favor of the earlier candidate so results do not
+  // depend on scheduling.
+  static absl::StatusOr<std::unique_ptr<IntegrationBuilder>> BuildParallel(
+      absl::Span<const Function* const> input_functions,
+      absl::Span<const IntegrationOptions> candidate_options,
+      const AreaEstimator& area_estimator, int64_t worker_count);
+
   // Return functions to be integrated, in the integration package.
   absl::Span<Function*> source_functions() {
     return absl::Span<Function*>(source_functions_);
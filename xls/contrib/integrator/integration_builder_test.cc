@@ -14,6 +14,8 @@
 
 #include "xls/contrib/integrator/integration_builder.h"
 
+#include <limits>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "xls/common/status/matchers.h"
@@ -149,5 +151,55 @@ TEST_F(IntegrationBuilderTest,
               m::Identity(m::Param("in")));
 }
 
+TEST_F(IntegrationBuilderTest, BuildParallelPicksLowestAreaCandidate) {
+  auto p = CreatePackage();
+  FunctionBuilder fb_a("func_a", p.get());
+  fb_a.Add(fb_a.Param("a", p->GetBitsType(32)),
+           fb_a.Param("b", p->GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * func_a, fb_a.Build());
+  FunctionBuilder fb_b("func_b", p.get());
+  fb_b.Add(fb_b.Param("c", p->GetBitsType(32)),
+           fb_b.Param("d", p->GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * func_b, fb_b.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<AreaEstimator> area_estimator,
+      GetAreaEstimatorByName("area_model_testing_2_point_5_mux_per_node"));
+  std::vector<IntegrationOptions> candidates = {
+      IntegrationOptions().unique_select_signal_per_mux(false),
+      IntegrationOptions().unique_select_signal_per_mux(true)};
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<IntegrationBuilder> builder,
+      IntegrationBuilder::BuildParallel(
+          std::vector<const Function*>({func_a, func_b}), candidates,
+          *area_estimator, /*worker_count=*/2));
+  ASSERT_NE(builder->integrated_function(), nullptr);
+  XLS_ASSERT_OK(VerifyFunction(builder->integrated_function()->function()));
+
+  // The result must match one of the serially built candidates, and must not
+  // have larger area than either of them.
+  int64_t best_area = std::numeric_limits<int64_t>::max();
+  for (const IntegrationOptions& options : candidates) {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<IntegrationBuilder> serial,
+        IntegrationBuilder::Build(
+            std::vector<const Function*>({func_a, func_b}), options));
+    int64_t area = 0;
+    for (Node* node : serial->integrated_function()->function()->nodes()) {
+      XLS_ASSERT_OK_AND_ASSIGN(int64_t node_area,
+                               area_estimator->GetOperationArea(node));
+      area += node_area;
+    }
+    best_area = std::min(best_area, area);
+  }
+  int64_t selected_area = 0;
+  for (Node* node : builder->integrated_function()->function()->nodes()) {
+    XLS_ASSERT_OK_AND_ASSIGN(int64_t node_area,
+                             area_estimator->GetOperationArea(node));
+    selected_area += node_area;
+  }
+  EXPECT_EQ(selected_area, best_area);
+}
+
 }  // namespace
 }  // namespace xls
@@ -1140,6 +1140,19 @@ absl::StatusOr<GeneratedFunction*> Translator::GenerateIR_Function(
 
   xls_names_for_functions_generated_[funcdecl] = xls_name;
 
+  // Re-use the translation of another decl which mangles to the same symbol,
+  // e.g. a template instantiation already translated through a different
+  // redeclaration. The body is identical, so re-walking the clang AST would
+  // rebuild the same XLS function under the same name.
+  if (name_override.empty() && !force_static) {
+    auto cache_found = functions_by_mangled_name_.find(xls_name);
+    if (cache_found != functions_by_mangled_name_.end()) {
+      inst_function_aliases_[absl::implicit_cast<const clang::NamedDecl*>(
+          funcdecl)] = cache_found->second;
+      return cache_found->second;
+    }
+  }
+
   xls::FunctionBuilder builder(xls_name, package_);
 
   PushContextGuard context_guard(*this, GetLoc(*funcdecl));
@@ -1368,6 +1381,9 @@ absl::StatusOr<GeneratedFunction*> Translator::GenerateIR_Function(
   sf.return_value_count = return_bvals.size();
 
   if (return_bvals.empty()) {
+    if (name_override.empty() && !force_static) {
+      functions_by_mangled_name_[xls_name] = &sf;
+    }
     return &sf;
   }
 
@@ -1387,6 +1403,12 @@ absl::StatusOr<GeneratedFunction*> Translator::GenerateIR_Function(
   XLS_ASSIGN_OR_RETURN(sf.xls_func,
                        builder.BuildWithReturnValue(context().return_val));
 
+  // Only completed translations are cached; recursion within one decl is
+  // already handled by inst_functions_.
+  if (name_override.empty() && !force_static) {
+    functions_by_mangled_name_[xls_name] = &sf;
+  }
+
   return &sf;
 }
 
@@ -2533,9 +2555,13 @@ absl::StatusOr<GeneratedFunction*> Translator::TranslateFunctionToXLS(
       inst_functions_.find(absl::implicit_cast<const clang::NamedDecl*>(decl));
   if (found != inst_functions_.end()) {
     return found->second.get();
-  } else {
-    return GenerateIR_Function(decl);
   }
+  auto alias_found = inst_function_aliases_.find(
+      absl::implicit_cast<const clang::NamedDecl*>(decl));
+  if (alias_found != inst_function_aliases_.end()) {
+    return alias_found->second;
+  }
+  return GenerateIR_Function(decl);
 }
 
 absl::StatusOr<CValue> Translator::GenerateIR_Call(const clang::CallExpr* call,
@@ -871,6 +871,20 @@ class Translator {
                       std::unique_ptr<GeneratedFunction>>
       inst_functions_;
 
+  // Cache of completed translations keyed by mangled name. Distinct
+  // NamedDecls which mangle to the same symbol (e.g. a template
+  // instantiation reached through different redeclarations) share one
+  // GeneratedFunction instead of re-walking the clang AST. Values are owned
+  // by inst_functions_.
+  absl::flat_hash_map<std::string, GeneratedFunction*>
+      functions_by_mangled_name_;
+
+  // Decls whose translation was satisfied from functions_by_mangled_name_,
+  // pointing at the GeneratedFunction of the decl which was actually
+  // translated (and which owns the entry via inst_functions_).
+  absl::flat_hash_map<const clang::NamedDecl*, GeneratedFunction*>
+      inst_function_aliases_;
+
   void print_types() {
     std::cerr << "Types {" << std::endl;
     for (const auto& var : inst_types_) {
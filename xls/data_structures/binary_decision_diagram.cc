@@ -22,16 +22,15 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "xls/common/allocation_accounting.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/logging/vlog_is_on.h"
 
 namespace xls {
 
 BinaryDecisionDiagram::BinaryDecisionDiagram() {
-  // Leaf node 0.
-  nodes_.push_back(BddNode(BddVariable(-1), BddNodeIndex(-1), BddNodeIndex(-1),
-                           /*p=*/1));
-  // Leaf node 1.
+  // The single terminal node. Its regular handle is one(), its complemented
+  // handle is zero().
   nodes_.push_back(BddNode(BddVariable(-1), BddNodeIndex(-1), BddNodeIndex(-1),
                            /*p=*/1));
 }
@@ -39,13 +38,21 @@ BinaryDecisionDiagram::BinaryDecisionDiagram() {
 BddNodeIndex BinaryDecisionDiagram::GetOrCreateNode(BddVariable var,
                                                     BddNodeIndex high,
                                                     BddNodeIndex low) {
+  if (low == high) {
+    return low;
+  }
+  // Canonical form: the high child is never complemented. If it is, store the
+  // node with both children complemented and complement the returned
+  // expression instead.
+  bool complement = IsComplemented(high);
+  if (complement) {
+    high = Not(high);
+    low = Not(low);
+  }
   NodeKey key = std::make_tuple(var, high, low);
   auto it = node_map_.find(key);
   if (it != node_map_.end()) {
-    return it->second;
-  }
-  if (low == high) {
-    return low;
+    return complement ? Not(it->second) : it->second;
   }
   // Compute the number of paths that the new node will have to the terminal
   // nodes 0 and 1. Use int64s to avoid overflowing and saturate at INT32_MAX.
@@ -53,21 +60,24 @@ BddNodeIndex BinaryDecisionDiagram::GetOrCreateNode(BddVariable var,
       static_cast<int64_t>(GetNode(low).path_count) + GetNode(high).path_count,
       static_cast<int64_t>(std::numeric_limits<int32_t>::max()));
   nodes_.emplace_back(var, high, low, paths);
-  BddNodeIndex node_index = BddNodeIndex(nodes_.size() - 1);
-  node_map_[key] = node_index;
-  return node_index;
+  XLS_RECORD_ALLOCATION(AllocationCategory::kBdd,
+                        static_cast<int64_t>(sizeof(BddNode)));
+  BddNodeIndex expr = ToExpr(nodes_.size() - 1);
+  node_map_[key] = expr;
+  return complement ? Not(expr) : expr;
 }
 
 BddNodeIndex BinaryDecisionDiagram::Restrict(BddNodeIndex expr, BddVariable var,
                                              bool value) {
-  if (expr == zero() || expr == one()) {
+  if (IsTerminal(expr)) {
     return expr;
   }
 
   const BddNode& node = GetNode(expr);
   XLS_CHECK_LE(var, node.variable);
   if (node.variable == var) {
-    return value ? node.high : node.low;
+    BddNodeIndex child = value ? node.high : node.low;
+    return IsComplemented(expr) ? Not(child) : child;
   }
   return expr;
 }
@@ -84,9 +94,22 @@ BddNodeIndex BinaryDecisionDiagram::IfThenElse(BddNodeIndex cond,
   if (if_true == one() && if_false == zero()) {
     return cond;
   }
+  if (if_true == zero() && if_false == one()) {
+    return Not(cond);
+  }
   if (if_true == if_false) {
     return if_true;
   }
+  // Normalize so the cache exploits complement symmetry:
+  //   ite(!c, t, e) == ite(c, e, t)
+  //   ite(c, !t, !e) == !ite(c, t, e)
+  if (IsComplemented(cond)) {
+    cond = Not(cond);
+    std::swap(if_true, if_false);
+  }
+  if (IsComplemented(if_true)) {
+    return Not(IfThenElse(cond, Not(if_true), Not(if_false)));
+  }
   auto key = std::make_tuple(cond, if_true, if_false);
   auto it = ite_map_.find(key);
   if (it != ite_map_.end()) {
@@ -100,11 +123,11 @@ BddNodeIndex BinaryDecisionDiagram::IfThenElse(BddNodeIndex cond,
   // First, find the lowest-index variable amongst all expressions. In all paths
   // through the BDD the variable indices are strictly increasing.
   BddVariable min_var = GetNode(cond).variable;
-  // Only non-leaf nodes (not zero or one) have associated variables.
-  if (if_true != zero() && if_true != one()) {
+  // Only the terminal node (zero or one) has no associated variable.
+  if (!IsTerminal(if_true)) {
     min_var = std::min(min_var, GetNode(if_true).variable);
   }
-  if (if_false != zero() && if_false != one()) {
+  if (!IsTerminal(if_false)) {
     min_var = std::min(min_var, GetNode(if_false).variable);
   }
 
@@ -135,10 +158,6 @@ BddNodeIndex BinaryDecisionDiagram::NewVariable() {
   return GetOrCreateNode(var, one(), zero());
 }
 
-BddNodeIndex BinaryDecisionDiagram::Not(BddNodeIndex expr) {
-  return IfThenElse(expr, zero(), one());
-}
-
 BddNodeIndex BinaryDecisionDiagram::Or(BddNodeIndex a, BddNodeIndex b) {
   return IfThenElse(a, one(), b);
 }
@@ -166,19 +185,116 @@ absl::StatusOr<bool> BinaryDecisionDiagram::Evaluate(
     }
   }
   while (result != zero() && result != one()) {
-    BddNodeIndex var_node = GetVariableBaseNode(GetNode(result).variable);
+    const BddNode& node = GetNode(result);
+    BddNodeIndex var_node = GetVariableBaseNode(node.variable);
     if (!variable_values.contains(var_node)) {
       return absl::InvalidArgumentError(
           absl::StrFormat("Missing value for BDD variable %d (node index %d)",
-                          GetNode(result).variable.value(), var_node.value()));
+                          node.variable.value(), var_node.value()));
     }
-    result = variable_values.at(var_node) ? GetNode(result).high
-                                          : GetNode(result).low;
+    BddNodeIndex child = variable_values.at(var_node) ? node.high : node.low;
+    // Propagate the complement attribute of the expression to the child.
+    result = IsComplemented(result) ? Not(child) : child;
   }
   XLS_VLOG(2) << "  result = " << (result == one() ? true : false);
   return result == one();
 }
 
+int64_t BinaryDecisionDiagram::max_path_count() const {
+  int64_t max_paths = 0;
+  for (const BddNode& node : nodes_) {
+    max_paths = std::max(max_paths, static_cast<int64_t>(node.path_count));
+  }
+  return max_paths;
+}
+
+int64_t BinaryDecisionDiagram::ReservedBytes() const {
+  return nodes_.capacity() * sizeof(BddNode) +
+         node_map_.capacity() * (sizeof(NodeKey) + sizeof(BddNodeIndex)) +
+         ite_map_.capacity() * (sizeof(IteKey) + sizeof(BddNodeIndex));
+}
+
+std::vector<BddNodeIndex> BinaryDecisionDiagram::GarbageCollect(
+    absl::Span<const BddNodeIndex> roots) {
+  ++gc_run_count_;
+
+  // Mark phase. The terminal node and the base node of every variable are
+  // unconditionally live: Evaluate() and future operations look variables up
+  // by their base node.
+  std::vector<bool> live(nodes_.size(), false);
+  live[0] = true;
+  std::vector<int32_t> stack;
+  auto mark = [&](BddNodeIndex expr) {
+    int32_t index = ExprToNodeIndex(expr);
+    if (!live[index]) {
+      live[index] = true;
+      stack.push_back(index);
+    }
+  };
+  for (int32_t i = 0; i < next_var_.value(); ++i) {
+    mark(GetVariableBaseNode(BddVariable(i)));
+  }
+  for (BddNodeIndex root : roots) {
+    mark(root);
+  }
+  while (!stack.empty()) {
+    int32_t index = stack.back();
+    stack.pop_back();
+    mark(nodes_[index].high);
+    mark(nodes_[index].low);
+  }
+
+  // Sweep phase: compact the node table in index order (so the surviving
+  // layout is deterministic) and rebuild the unique table.
+  std::vector<int32_t> remap(nodes_.size());
+  int32_t live_count = 0;
+  for (int64_t i = 0; i < static_cast<int64_t>(nodes_.size()); ++i) {
+    if (live[i]) {
+      remap[i] = live_count++;
+    }
+  }
+  int64_t collected = static_cast<int64_t>(nodes_.size()) - live_count;
+  XLS_VLOG(2) << absl::StreamFormat("BDD GC: %d of %d nodes collected",
+                                    collected, nodes_.size());
+  auto remap_expr = [&](BddNodeIndex expr) {
+    return BddNodeIndex(2 * remap[ExprToNodeIndex(expr)] +
+                        (IsComplemented(expr) ? 1 : 0));
+  };
+  if (collected > 0) {
+    collected_node_count_ += collected;
+    for (int64_t i = 1; i < static_cast<int64_t>(nodes_.size()); ++i) {
+      if (live[i]) {
+        BddNode node = nodes_[i];
+        node.high = remap_expr(node.high);
+        node.low = remap_expr(node.low);
+        nodes_[remap[i]] = node;
+      }
+    }
+    nodes_.resize(live_count);
+    nodes_.shrink_to_fit();
+
+    absl::flat_hash_map<NodeKey, BddNodeIndex> new_node_map;
+    new_node_map.reserve(nodes_.size());
+    for (int64_t i = 1; i < static_cast<int64_t>(nodes_.size()); ++i) {
+      const BddNode& node = nodes_[i];
+      new_node_map[std::make_tuple(node.variable, node.high, node.low)] =
+          ToExpr(i);
+    }
+    node_map_ = std::move(new_node_map);
+
+    // The ITE cache is keyed by stale handles; dropping it entirely only
+    // costs recomputation.
+    ite_map_ = absl::flat_hash_map<IteKey, BddNodeIndex>();
+  }
+
+  std::vector<BddNodeIndex> remapped_roots;
+  remapped_roots.reserve(roots.size());
+  for (BddNodeIndex root : roots) {
+    remapped_roots.push_back(remap_expr(root));
+  }
+  return remapped_roots;
+}
+
 void BinaryDecisionDiagram::ToStringDnfHelper(BddNodeIndex expr,
                                               int64_t* minterms_to_emit,
                                               std::vector<std::string>* terms,
@@ -205,10 +321,13 @@ void BinaryDecisionDiagram::ToStringDnfHelper(BddNodeIndex expr,
   }
 
   const BddNode& node = GetNode(expr);
+  // Propagate any complement attribute to the children.
+  BddNodeIndex high = IsComplemented(expr) ? Not(node.high) : node.high;
+  BddNodeIndex low = IsComplemented(expr) ? Not(node.low) : node.low;
   terms->push_back(absl::StrCat("x", node.variable.value()));
-  ToStringDnfHelper(node.high, minterms_to_emit, terms, str);
+  ToStringDnfHelper(high, minterms_to_emit, terms, str);
   terms->back() = absl::StrCat("!x", node.variable.value());
-  ToStringDnfHelper(node.low, minterms_to_emit, terms, str);
+  ToStringDnfHelper(low, minterms_to_emit, terms, str);
   terms->pop_back();
 }
 
@@ -19,6 +19,7 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "xls/common/strong_int.h"
 
 namespace xls {
@@ -31,10 +32,22 @@ namespace xls {
 //   K.S. Brace, R.L. Rudell, and R.E. Bryant,
 //   "Efficient Implementation of a BDD package"
 //   https://ieeexplore.ieee.org/document/114826
+//
+// The implementation uses the complement edges described in the paper: an
+// expression handle is a node index plus a complement attribute, so an
+// expression and its negation share the same node and negation is a
+// constant-time operation. For canonicity the high (variable true) child of a
+// node is never complemented; only low children and external handles carry the
+// attribute. There is a single terminal node whose regular handle is one() and
+// whose complemented handle is zero().
 
 // For efficiency variables and nodes are referred to by indices into vector
 // data members in the BDD.
 DEFINE_STRONG_INT_TYPE(BddVariable, int32_t);
+
+// An expression handle. The least-significant bit of the value holds the
+// complement attribute, the remaining bits hold the index of the node in the
+// BDD's node table.
 DEFINE_STRONG_INT_TYPE(BddNodeIndex, int32_t);
 
 // A node in the BDD. The node is associated with a single variable and has
@@ -57,24 +70,27 @@ struct BddNode {
 
 class BinaryDecisionDiagram {
  public:
-  // Creates an empty BDD. Initialize the BDD contains only the nodes
-  // corresponding to zero and one.
+  // Creates an empty BDD containing only the terminal node.
   BinaryDecisionDiagram();
 
   // Adds a new variable to the BDD and returns the node corresponding the
   // variable's value.
   BddNodeIndex NewVariable();
 
-  // Returns the inverse of the given expression.
-  BddNodeIndex Not(BddNodeIndex expr);
+  // Returns the inverse of the given expression. With complement edges this
+  // is a constant-time operation which creates no new nodes.
+  BddNodeIndex Not(BddNodeIndex expr) const {
+    return BddNodeIndex(expr.value() ^ 1);
+  }
 
   // Returns the OR/AND of the given expressions.
   BddNodeIndex And(BddNodeIndex a, BddNodeIndex b);
   BddNodeIndex Or(BddNodeIndex a, BddNodeIndex b);
 
-  // Returns the leaf node corresponding to zero or one.
-  BddNodeIndex zero() const { return BddNodeIndex(0); }
-  BddNodeIndex one() const { return BddNodeIndex(1); }
+  // Returns the expression corresponding to zero or one. These are the
+  // complemented and regular handles of the single terminal node.
+  BddNodeIndex zero() const { return BddNodeIndex(1); }
+  BddNodeIndex one() const { return BddNodeIndex(0); }
 
   // Evaluates the given expression with the given variable values. The keys in
   // the map are the *node* indices of the respective variable (value returned
@@ -84,9 +100,10 @@ class BinaryDecisionDiagram {
       BddNodeIndex expr,
       const absl::flat_hash_map<BddNodeIndex, bool>& variable_values) const;
 
-  // Returns the BDD node with the given index.
-  const BddNode& GetNode(BddNodeIndex node_index) const {
-    return nodes_.at(node_index.value());
+  // Returns the BDD node underlying the given expression. The complement
+  // attribute of the expression is ignored.
+  const BddNode& GetNode(BddNodeIndex expr) const {
+    return nodes_.at(ExprToNodeIndex(expr));
   }
 
   // Returns the number of nodes in the graph.
@@ -100,6 +117,9 @@ class BinaryDecisionDiagram {
     return GetNode(expr).path_count;
   }
 
+  // Returns the maximum path count of any node in the BDD.
+  int64_t max_path_count() const;
+
   // Returns the given expression in disjunctive normal form (sum of products).
   // The expression is not minimal. 'minterm_limit' is the maximum number of
   // minterms to emit before truncating the output.
@@ -109,17 +129,53 @@ class BinaryDecisionDiagram {
   // variable. The expression of a base node is exactly equal to the value of
   // the variable.
   bool IsVariableBaseNode(BddNodeIndex expr) const {
-    return GetNode(expr).high == one() && GetNode(expr).low == zero();
+    return !IsComplemented(expr) && GetNode(expr).high == one() &&
+           GetNode(expr).low == zero();
   }
 
+  // Reclaims nodes which are not reachable from `roots`, the variable base
+  // nodes or the terminal node, compacting the node table and dropping the
+  // unique/ITE tables' dead entries. Node indices are invalidated; the
+  // returned vector holds the new handle for each root (in the same order).
+  // Any other outstanding BddNodeIndex values must not be used afterwards.
+  std::vector<BddNodeIndex> GarbageCollect(
+      absl::Span<const BddNodeIndex> roots);
+
+  // Returns an estimate of the heap memory reserved by the node table and the
+  // unique/ITE tables.
+  int64_t ReservedBytes() const;
+
+  // Telemetry: number of GarbageCollect() calls and total nodes reclaimed.
+  int64_t gc_run_count() const { return gc_run_count_; }
+  int64_t collected_node_count() const { return collected_node_count_; }
+
  private:
+  // Returns true if the expression carries the complement attribute.
+  static bool IsComplemented(BddNodeIndex expr) {
+    return (expr.value() & 1) != 0;
+  }
+
+  // Conversions between node-table indices and (regular) expression handles.
+  static int32_t ExprToNodeIndex(BddNodeIndex expr) { return expr.value() >> 1; }
+  static BddNodeIndex ToExpr(int64_t node_index) {
+    return BddNodeIndex(2 * node_index);
+  }
+
+  // Returns true if the expression is a handle of the terminal node (zero()
+  // or one()).
+  static bool IsTerminal(BddNodeIndex expr) {
+    return ExprToNodeIndex(expr) == 0;
+  }
+
   // Helper for constructing a DNF string respresentation.
   void ToStringDnfHelper(BddNodeIndex expr, int64_t* minterms_to_emit,
                          std::vector<std::string>* terms,
                          std::string* str) const;
 
   // Get the node corresponding to the given variable with the given low/high
-  // children. Creates it if it does not exist.
+  // children. Creates it if it does not exist. If `high` is complemented the
+  // node is stored in canonical form (both children complemented) and a
+  // complemented expression is returned.
   BddNodeIndex GetOrCreateNode(BddVariable var, BddNodeIndex high,
                                BddNodeIndex low);
 
@@ -154,6 +210,10 @@ class BinaryDecisionDiagram {
   // enables fast lookup for expressions.
   using IteKey = std::tuple<BddNodeIndex, BddNodeIndex, BddNodeIndex>;
   absl::flat_hash_map<IteKey, BddNodeIndex> ite_map_;
+
+  // Telemetry; see the accessors above.
+  int64_t gc_run_count_ = 0;
+  int64_t collected_node_count_ = 0;
 };
 
 }  // namespace xls
@@ -251,6 +251,65 @@ TEST(BinaryDecisionDiagramTest, Parity) {
               IsOkAndHolds(false));
 }
 
+TEST(BinaryDecisionDiagramTest, ComplementEdgesShareNodes) {
+  BinaryDecisionDiagram bdd;
+  BddNodeIndex var1 = bdd.NewVariable();
+  BddNodeIndex var2 = bdd.NewVariable();
+  BddNodeIndex var1_and_var2 = bdd.And(var1, var2);
+
+  // Negation is represented with a complement attribute on the handle, so it
+  // creates no new nodes and double negation is the identity.
+  int64_t before_size = bdd.size();
+  BddNodeIndex not_and = bdd.Not(var1_and_var2);
+  EXPECT_EQ(bdd.size(), before_size);
+  EXPECT_NE(not_and, var1_and_var2);
+  EXPECT_EQ(bdd.Not(not_and), var1_and_var2);
+  EXPECT_EQ(bdd.Not(bdd.zero()), bdd.one());
+  EXPECT_EQ(bdd.Not(bdd.one()), bdd.zero());
+
+  // A NAND built from scratch resolves to the same handle.
+  EXPECT_EQ(bdd.Not(bdd.And(var1, var2)), not_and);
+  EXPECT_THAT(bdd.Evaluate(not_and, {{var1, true}, {var2, true}}),
+              IsOkAndHolds(false));
+  EXPECT_THAT(bdd.Evaluate(not_and, {{var1, true}, {var2, false}}),
+              IsOkAndHolds(true));
+}
+
+TEST(BinaryDecisionDiagramTest, GarbageCollection) {
+  BinaryDecisionDiagram bdd;
+  BddNodeIndex var1 = bdd.NewVariable();
+  BddNodeIndex var2 = bdd.NewVariable();
+  BddNodeIndex var3 = bdd.NewVariable();
+
+  // Expression to keep across collection.
+  BddNodeIndex keep = bdd.And(var1, bdd.Or(var2, var3));
+  // Garbage only reachable from its own root.
+  bdd.And(bdd.Or(var1, var3), var2);
+  int64_t size_before = bdd.size();
+
+  std::vector<BddNodeIndex> remapped =
+      bdd.GarbageCollect({keep, var1, var2, var3});
+  ASSERT_EQ(remapped.size(), 4);
+  keep = remapped[0];
+  var1 = remapped[1];
+  var2 = remapped[2];
+  var3 = remapped[3];
+
+  EXPECT_LT(bdd.size(), size_before);
+  EXPECT_EQ(bdd.gc_run_count(), 1);
+  EXPECT_GT(bdd.collected_node_count(), 0);
+  EXPECT_GT(bdd.ReservedBytes(), 0);
+
+  // The kept expression, the variables and the terminals are still usable.
+  EXPECT_THAT(bdd.Evaluate(keep, {{var1, true}, {var2, false}, {var3, true}}),
+              IsOkAndHolds(true));
+  EXPECT_THAT(bdd.Evaluate(keep, {{var1, false}, {var2, true}, {var3, true}}),
+              IsOkAndHolds(false));
+  // Rebuilding the collected expression works and reuses the live subgraph.
+  BddNodeIndex rebuilt = bdd.And(var1, bdd.Or(var2, var3));
+  EXPECT_EQ(rebuilt, keep);
+}
+
 TEST(BinaryDecisionDiagramTest, ThreeVariableExhaustive) {
   // Generate all three-variable boolean functions and test each with all
   // possible inputs.
@@ -0,0 +1,104 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_DATA_STRUCTURES_CONCURRENT_UNION_FIND_H_
+#define XLS_DATA_STRUCTURES_CONCURRENT_UNION_FIND_H_
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "xls/common/logging/logging.h"
+
+namespace xls {
+
+// A union-find over the dense index range [0, size) whose Union and Find
+// may be called concurrently from many threads without external locking:
+// finds shorten paths with atomic path splitting and unions link roots with a
+// compare-and-swap.
+//
+// An equivalence class is always represented by its smallest member index,
+// regardless of how Union calls interleave, so concurrent construction yields
+// deterministic results. Union by rank is deliberately traded away for this
+// property; path splitting keeps chains short in practice.
+//
+// Unlike UnionFind this is not templated over an element type; callers map
+// their elements to dense indices, which is also what makes the parent array
+// contiguous and cache-friendly.
+class ConcurrentUnionFind {
+ public:
+  explicit ConcurrentUnionFind(int64_t size) : parent_(size) {
+    for (int64_t i = 0; i < size; ++i) {
+      parent_[i].store(i, std::memory_order_relaxed);
+    }
+  }
+
+  // Returns the representative (smallest) element of x's equivalence class.
+  // Note that a concurrent Union can merge the class while this runs; as with
+  // any concurrent container, such a race means the result may be stale by the
+  // time the caller looks at it.
+  int64_t Find(int64_t x) {
+    XLS_DCHECK_GE(x, 0);
+    XLS_DCHECK_LT(x, size());
+    while (true) {
+      int64_t parent = parent_[x].load(std::memory_order_acquire);
+      if (parent == x) {
+        return x;
+      }
+      int64_t grandparent = parent_[parent].load(std::memory_order_acquire);
+      if (grandparent == parent) {
+        return parent;
+      }
+      // Path splitting: retarget x at its grandparent. A failed exchange just
+      // means another thread already shortened this link.
+      parent_[x].compare_exchange_weak(parent, grandparent,
+                                       std::memory_order_release,
+                                       std::memory_order_relaxed);
+      x = parent;
+    }
+  }
+
+  // Unions the equivalence classes of x and y.
+  void Union(int64_t x, int64_t y) {
+    while (true) {
+      x = Find(x);
+      y = Find(y);
+      if (x == y) {
+        return;
+      }
+      // Link the larger root under the smaller so the smallest index wins.
+      if (x < y) {
+        std::swap(x, y);
+      }
+      int64_t expected = x;
+      if (parent_[x].compare_exchange_strong(expected, y,
+                                             std::memory_order_acq_rel)) {
+        return;
+      }
+      // Lost a race: x was linked elsewhere in the meantime. Retry with the
+      // updated roots.
+    }
+  }
+
+  // Returns the number of elements in the data structure.
+  int64_t size() const { return parent_.size(); }
+
+ private:
+  std::vector<std::atomic<int64_t>> parent_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_DATA_STRUCTURES_CONCURRENT_UNION_FIND_H_
@@ -0,0 +1,78 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/data_structures/concurrent_union_find.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/thread.h"
+
+namespace xls {
+namespace {
+
+TEST(ConcurrentUnionFindTest, SingletonClasses) {
+  ConcurrentUnionFind uf(4);
+  EXPECT_EQ(uf.size(), 4);
+  for (int64_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(uf.Find(i), i);
+  }
+}
+
+TEST(ConcurrentUnionFindTest, SmallestIndexRepresents) {
+  ConcurrentUnionFind uf(6);
+  uf.Union(5, 3);
+  uf.Union(3, 4);
+  EXPECT_EQ(uf.Find(5), 3);
+  EXPECT_EQ(uf.Find(4), 3);
+  EXPECT_EQ(uf.Find(3), 3);
+  // Merging the class containing 3 with the one containing 0 re-roots it.
+  uf.Union(4, 0);
+  EXPECT_EQ(uf.Find(5), 0);
+  EXPECT_EQ(uf.Find(1), 1);
+}
+
+// Many threads racing to union interleaved chains must converge on the same
+// classes (rooted at the smallest member) as a serial construction.
+TEST(ConcurrentUnionFindTest, ConcurrentChainConstruction) {
+  constexpr int64_t kNumThreads = 8;
+  constexpr int64_t kElements = 1 << 14;
+  ConcurrentUnionFind uf(kElements);
+  std::vector<std::unique_ptr<Thread>> threads;
+  for (int64_t t = 0; t < kNumThreads; ++t) {
+    threads.push_back(std::make_unique<Thread>([&uf, t] {
+      // Thread t links i -> i + kNumThreads for i = t mod kNumThreads; the
+      // union of all threads' work chains every element with parity of
+      // (i mod 2) together, since stride-8 links preserve index parity.
+      for (int64_t i = t; i + kNumThreads < kElements; i += kNumThreads) {
+        uf.Union(i, i + kNumThreads);
+      }
+      // Also fold the strided chains of the same parity together.
+      uf.Union(t, t % 2);
+    }));
+  }
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+
+  for (int64_t i = 0; i < kElements; ++i) {
+    EXPECT_EQ(uf.Find(i), i % 2) << "element " << i;
+  }
+}
+
+}  // namespace
+}  // namespace xls
@@ -15,7 +15,13 @@
 #ifndef XLS_DATA_STRUCTURES_GRAPH_COLORING_H_
 #define XLS_DATA_STRUCTURES_GRAPH_COLORING_H_
 
+#include <algorithm>
+#include <cstdint>
 #include <optional>
+#include <random>
+#include <thread>  // NOLINT(build/c++11)
+#include <tuple>
+#include <vector>
 
 #include "absl/container/btree_set.h"
 #include "absl/container/flat_hash_map.h"
@@ -23,6 +29,7 @@
 #include "absl/strings/str_format.h"
 #include "xls/common/logging/log_message.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/thread_pool.h"
 #include "../z3/src/api/c++/z3++.h"
 
 namespace xls {
@@ -150,6 +157,149 @@ std::vector<absl::flat_hash_set<V>> RecursiveLargestFirstColoring(
   return result;
 }
 
+// Knobs trading coloring quality against running time for
+// JonesPlassmannColoring.
+struct JonesPlassmannOptions {
+  // Number of worker threads coloring vertices within a round. Negative means
+  // one per hardware thread; zero runs everything on the calling thread. The
+  // result is the same for any worker count.
+  int64_t worker_count = -1;
+
+  // Number of independent colorings to compute (with different random
+  // priorities); the one using the fewest colors is returned. Each attempt
+  // costs a full pass over the graph.
+  int64_t attempt_count = 1;
+
+  // When true, higher-degree vertices get higher priority and are colored
+  // first (the same intuition as RLF's largest-first ordering), which
+  // typically uses fewer colors; when false priorities are purely random,
+  // which finishes in fewer rounds on regular graphs.
+  bool degree_priorities = true;
+
+  // Seed for the random priority tie-break.
+  uint64_t seed = 0;
+};
+
+// Color the given graph with the Jones-Plassmann parallel coloring algorithm.
+//
+// Each vertex gets a priority; in each round every uncolored vertex whose
+// priority is a local maximum among its uncolored neighbors takes the smallest
+// color unused by its colored neighbors. Vertices colored in the same round
+// form an independent set, so rounds parallelize over vertices with no
+// conflict resolution needed. This does not match RLF's quality on hard
+// graphs, but each round is linear in the number of edges, so it scales to
+// conflict graphs where RLF's quadratic independent-set searches are
+// intractable.
+//
+// The result is deterministic given the options, independent of worker count.
+template <typename V>
+std::vector<absl::flat_hash_set<V>> JonesPlassmannColoring(
+    const absl::flat_hash_set<V>& vertices,
+    std::function<absl::flat_hash_set<V>(const V&)> neighborhood,
+    const JonesPlassmannOptions& options = JonesPlassmannOptions()) {
+  static_assert(!std::is_pointer<V>::value,
+                "To avoid nondetermistic behavior V cannot be a pointer type");
+  if (vertices.empty()) {
+    return {};
+  }
+
+  // Build a dense index space with vertex-order-independent indices.
+  std::vector<V> ordered_vertices(vertices.begin(), vertices.end());
+  std::sort(ordered_vertices.begin(), ordered_vertices.end());
+  const int64_t n = ordered_vertices.size();
+  absl::flat_hash_map<V, int64_t> vertex_to_index;
+  for (int64_t i = 0; i < n; ++i) {
+    vertex_to_index[ordered_vertices[i]] = i;
+  }
+  std::vector<std::vector<int64_t>> neighbors(n);
+  for (int64_t i = 0; i < n; ++i) {
+    for (const V& neighbor : neighborhood(ordered_vertices[i])) {
+      auto it = vertex_to_index.find(neighbor);
+      if (it != vertex_to_index.end() && it->second != i) {
+        neighbors[i].push_back(it->second);
+      }
+    }
+  }
+
+  int64_t worker_count = options.worker_count;
+  if (worker_count < 0) {
+    worker_count = std::thread::hardware_concurrency();
+  }
+  ThreadPool pool(std::min<int64_t>(worker_count, n), options.seed);
+
+  std::vector<int64_t> best_colors;
+  int64_t best_color_count = n + 1;
+  for (int64_t attempt = 0; attempt < std::max<int64_t>(
+                                           options.attempt_count, int64_t{1});
+       ++attempt) {
+    // Priorities are compared as (degree or 0, random tie-break, index); the
+    // index makes the ordering a total order even on tie-break collisions.
+    std::vector<uint64_t> tie_breaks(n);
+    std::mt19937_64 rng(options.seed + attempt);
+    for (int64_t i = 0; i < n; ++i) {
+      tie_breaks[i] = rng();
+    }
+    auto priority = [&](int64_t i) {
+      return std::make_tuple(
+          options.degree_priorities ? static_cast<int64_t>(neighbors[i].size())
+                                    : int64_t{0},
+          tie_breaks[i], i);
+    };
+
+    std::vector<int64_t> colors(n, -1);
+    std::vector<int64_t> next_colors(n, -1);
+    int64_t uncolored_count = n;
+    while (uncolored_count > 0) {
+      // Each round reads `colors` and writes `next_colors` so that vertices
+      // colored in the same round see a consistent snapshot.
+      pool.ParallelFor(0, n, [&](int64_t i) {
+        next_colors[i] = colors[i];
+        if (colors[i] != -1) {
+          return;
+        }
+        absl::flat_hash_set<int64_t> used_colors;
+        for (int64_t neighbor : neighbors[i]) {
+          if (colors[neighbor] == -1) {
+            if (priority(neighbor) > priority(i)) {
+              // An uncolored neighbor outranks us; wait for the next round.
+              return;
+            }
+          } else {
+            used_colors.insert(colors[neighbor]);
+          }
+        }
+        int64_t color = 0;
+        while (used_colors.contains(color)) {
+          ++color;
+        }
+        next_colors[i] = color;
+      });
+      int64_t newly_colored = 0;
+      for (int64_t i = 0; i < n; ++i) {
+        if (colors[i] == -1 && next_colors[i] != -1) {
+          ++newly_colored;
+        }
+      }
+      XLS_CHECK_GT(newly_colored, 0);
+      uncolored_count -= newly_colored;
+      std::swap(colors, next_colors);
+    }
+
+    int64_t color_count =
+        *std::max_element(colors.begin(), colors.end()) + 1;
+    if (color_count < best_color_count) {
+      best_color_count = color_count;
+      best_colors = std::move(colors);
+    }
+  }
+
+  std::vector<absl::flat_hash_set<V>> result(best_color_count);
+  for (int64_t i = 0; i < n; ++i) {
+    result[best_colors[i]].insert(ordered_vertices[i]);
+  }
+  return result;
+}
+
 inline std::optional<int64_t> LookupIntegerInZ3Model(z3::model model,
                                                      absl::string_view name) {
   for (int32_t i = 0; i < model.size(); i++) {
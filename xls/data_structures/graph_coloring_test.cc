@@ -14,10 +14,14 @@
 
 #include "xls/data_structures/graph_coloring.h"
 
+#include <cstdint>
+#include <random>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
 
 namespace xls {
 namespace {
@@ -61,6 +65,28 @@ std::vector<absl::flat_hash_set<V>> Z3FromMap(
   });
 }
 
+std::vector<absl::flat_hash_set<V>> JPFromMap(
+    const absl::flat_hash_map<V, absl::flat_hash_set<V>>& neighborhood,
+    const JonesPlassmannOptions& options = JonesPlassmannOptions()) {
+  absl::flat_hash_map<V, absl::flat_hash_set<V>> symmetric_neighborhood;
+  absl::flat_hash_set<V> nodes;
+  for (const auto& [node, neighbors] : neighborhood) {
+    for (const auto& neighbor : neighbors) {
+      nodes.insert(node);
+      nodes.insert(neighbor);
+      symmetric_neighborhood[node].insert(neighbor);
+      symmetric_neighborhood[neighbor].insert(node);
+    }
+  }
+
+  return JonesPlassmannColoring<V>(
+      nodes,
+      [&](const V& node) -> absl::flat_hash_set<V> {
+        return symmetric_neighborhood.at(node);
+      },
+      options);
+}
+
 bool IsValidColoring(
     const absl::flat_hash_map<V, absl::flat_hash_set<V>>& neighborhood,
     const std::vector<absl::flat_hash_set<V>>& coloring) {
@@ -141,5 +167,64 @@ TEST(GraphColoringTest, Wheel) {
   EXPECT_TRUE(IsValidColoring(graph, Z3FromMap(graph)));
 }
 
+TEST(GraphColoringTest, JonesPlassmannSmallGraphs) {
+  absl::flat_hash_map<V, absl::flat_hash_set<V>> bipartite;
+  bipartite["a"].insert("x");
+  bipartite["a"].insert("y");
+  bipartite["a"].insert("z");
+  bipartite["b"].insert("x");
+  bipartite["c"].insert("w");
+  EXPECT_LE(JPFromMap(bipartite).size(), 2);
+  EXPECT_TRUE(IsValidColoring(bipartite, JPFromMap(bipartite)));
+
+  absl::flat_hash_map<V, absl::flat_hash_set<V>> cycle;
+  cycle["a"].insert("b");
+  cycle["b"].insert("c");
+  cycle["c"].insert("d");
+  cycle["d"].insert("e");
+  cycle["e"].insert("a");
+  EXPECT_LE(JPFromMap(cycle).size(), 3);
+  EXPECT_TRUE(IsValidColoring(cycle, JPFromMap(cycle)));
+}
+
+TEST(GraphColoringTest, JonesPlassmannIsDeterministicAcrossWorkerCounts) {
+  absl::flat_hash_map<V, absl::flat_hash_set<V>> graph;
+  std::minstd_rand rng;
+  std::uniform_int_distribution<int64_t> node_dis(0, 99);
+  for (int64_t i = 0; i < 300; ++i) {
+    int64_t a = node_dis(rng);
+    int64_t b = node_dis(rng);
+    if (a != b) {
+      graph[absl::StrCat("n", a)].insert(absl::StrCat("n", b));
+    }
+  }
+  JonesPlassmannOptions serial;
+  serial.worker_count = 0;
+  JonesPlassmannOptions parallel;
+  parallel.worker_count = 4;
+  EXPECT_TRUE(IsValidColoring(graph, JPFromMap(graph, serial)));
+  EXPECT_EQ(JPFromMap(graph, serial), JPFromMap(graph, parallel));
+}
+
+TEST(GraphColoringTest, JonesPlassmannMultipleAttemptsDoNotHurtQuality) {
+  absl::flat_hash_map<V, absl::flat_hash_set<V>> graph;
+  std::minstd_rand rng;
+  std::uniform_int_distribution<int64_t> node_dis(0, 49);
+  for (int64_t i = 0; i < 200; ++i) {
+    int64_t a = node_dis(rng);
+    int64_t b = node_dis(rng);
+    if (a != b) {
+      graph[absl::StrCat("n", a)].insert(absl::StrCat("n", b));
+    }
+  }
+  JonesPlassmannOptions one_attempt;
+  one_attempt.attempt_count = 1;
+  JonesPlassmannOptions many_attempts;
+  many_attempts.attempt_count = 8;
+  EXPECT_TRUE(IsValidColoring(graph, JPFromMap(graph, many_attempts)));
+  EXPECT_LE(JPFromMap(graph, many_attempts).size(),
+            JPFromMap(graph, one_attempt).size());
+}
+
 }  // namespace
 }  // namespace xls
@@ -19,6 +19,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/types/optional.h"
+#include "absl/types/span.h"
 #include "xls/common/logging/log_message.h"
 #include "xls/common/logging/logging.h"
 #include "xls/data_structures/union_find_map.h"
@@ -53,6 +54,14 @@ class GraphContraction {
     }
   }
 
+  // Pre-sizes the vertex and adjacency tables to hold `num_vertices` vertices;
+  // useful before bulk-loading a graph of known size.
+  void ReserveVertices(int64_t num_vertices) {
+    vertex_weights_.Reserve(num_vertices);
+    out_edges_.Reserve(num_vertices);
+    in_edges_.Reserve(num_vertices);
+  }
+
   // Adds an edge from the given `source` to the given `target` with the given
   // `weight` associated to it. If an edge with that source and target already
   // exists, the given `weight` replaces the previous weight. Returns false if
@@ -65,10 +74,9 @@ class GraphContraction {
     }
     auto merge_map = [](absl::flat_hash_map<V, EW> a,
                         absl::flat_hash_map<V, EW> b) {
-      absl::flat_hash_map<V, EW> result;
-      result.merge(a);
-      result.merge(b);
-      return result;
+      a.reserve(a.size() + b.size());
+      a.merge(b);
+      return a;
     };
     out_edges_.Insert(source, {{target, weight}}, merge_map);
     in_edges_.Insert(target, {{source, weight}}, merge_map);
@@ -99,6 +107,7 @@ class GraphContraction {
     auto merge_map = [&](const absl::flat_hash_map<V, EW>& a,
                          const absl::flat_hash_map<V, EW>& b) {
       absl::flat_hash_map<V, EW> result;
+      result.reserve(a.size() + b.size());
       for (const auto& [vertex, edge_weight] : a) {
         V key = ((vertex == x) || (vertex == y)) ? rep : vertex;
         result.insert_or_assign(key, result.contains(key)
@@ -166,6 +175,136 @@ class GraphContraction {
     return true;
   }
 
+  // Identifies all of the given vertices with each other, like calling
+  // `IdentifyVertices` on each consecutive pair but with the combined
+  // adjacency built in a single pass: the region's adjacency is gathered into
+  // contiguous scratch storage, the destination maps are pre-sized from the
+  // summed cardinalities, and neighboring vertices are patched up once rather
+  // than once per pairwise merge. Returns false (and leaves the graph in an
+  // unmodified state) iff one of the given vertices is nonexistent.
+  //
+  // `vw_merge` and `ew_merge` are as in `IdentifyVertices`; `ew_merge` should
+  // be associative and commutative, since the order in which parallel edge
+  // weights are combined is unspecified.
+  template <typename FV, typename FE>
+  bool IdentifyVertexRegion(absl::Span<const V> vertices, FV vw_merge,
+                            FE ew_merge) {
+    for (const V& vertex : vertices) {
+      if (!vertex_weights_.Contains(vertex)) {
+        return false;
+      }
+    }
+
+    // The distinct equivalence classes making up the region, keyed by their
+    // current representatives. The adjacency maps are keyed by
+    // representatives as well, so this doubles as the set of adjacency keys
+    // that must be rewritten to the merged representative.
+    absl::flat_hash_set<V> old_reps;
+    old_reps.reserve(vertices.size());
+    for (const V& vertex : vertices) {
+      old_reps.insert(vertex_weights_.Find(vertex)->first);
+    }
+    if (old_reps.size() <= 1) {
+      return true;
+    }
+
+    // Gather the adjacency of every class in the region into contiguous
+    // scratch storage before any maps are merged.
+    int64_t out_total = 0;
+    int64_t in_total = 0;
+    for (const V& old_rep : old_reps) {
+      out_total += out_edges_.Find(old_rep)->second.size();
+      in_total += in_edges_.Find(old_rep)->second.size();
+    }
+    std::vector<std::pair<V, EW>> out_scratch;
+    std::vector<std::pair<V, EW>> in_scratch;
+    out_scratch.reserve(out_total);
+    in_scratch.reserve(in_total);
+    for (const V& old_rep : old_reps) {
+      for (const auto& [target, weight] : out_edges_.Find(old_rep)->second) {
+        out_scratch.push_back({target, weight});
+      }
+      for (const auto& [source, weight] : in_edges_.Find(old_rep)->second) {
+        in_scratch.push_back({source, weight});
+      }
+    }
+
+    // Union the vertex weights; this fixes the representative of the merged
+    // region.
+    const V& first = vertices.front();
+    for (const V& vertex : vertices) {
+      vertex_weights_.Union(first, vertex, vw_merge);
+    }
+    V rep = vertex_weights_.Find(first)->first;
+
+    // Rebuild each adjacency map in one pass with a single pre-sized table;
+    // edges to/from vertices inside the region collapse into a self edge on
+    // `rep`.
+    auto rebuild = [&](const std::vector<std::pair<V, EW>>& scratch) {
+      absl::flat_hash_map<V, EW> result;
+      result.reserve(scratch.size());
+      for (const auto& [vertex, weight] : scratch) {
+        const V& key = old_reps.contains(vertex) ? rep : vertex;
+        auto [it, inserted] = result.try_emplace(key, weight);
+        if (!inserted) {
+          it->second = ew_merge(it->second, weight);
+        }
+      }
+      return result;
+    };
+    absl::flat_hash_map<V, EW> new_out = rebuild(out_scratch);
+    absl::flat_hash_map<V, EW> new_in = rebuild(in_scratch);
+
+    // Union the adjacency maps structurally only; the merged value is about
+    // to be overwritten with the rebuilt map, so the merge function returns
+    // an empty map rather than copying either side.
+    auto drop_both = [](const absl::flat_hash_map<V, EW>& a,
+                        const absl::flat_hash_map<V, EW>& b) {
+      return absl::flat_hash_map<V, EW>();
+    };
+    for (const V& vertex : vertices) {
+      out_edges_.Union(first, vertex, drop_both);
+      in_edges_.Union(first, vertex, drop_both);
+    }
+    out_edges_.Find(first)->second = std::move(new_out);
+    in_edges_.Find(first)->second = std::move(new_in);
+
+    // Patch up each neighboring vertex of the region once: any adjacency keys
+    // naming a class inside the region are replaced by a single entry on
+    // `rep`, combining weights with `ew_merge`.
+    auto patch_up_region_edges =
+        [&](const V& vertex, UnionFindMap<V, absl::flat_hash_map<V, EW>>* map) {
+          XLS_CHECK(map->Find(vertex).has_value())
+              << "Inconsistency between in_edges_ and out_edges_ detected";
+          absl::flat_hash_map<V, EW>& edges = map->Find(vertex)->second;
+          std::optional<EW> merged;
+          for (const V& old_rep : old_reps) {
+            auto it = edges.find(old_rep);
+            if (it == edges.end()) {
+              continue;
+            }
+            merged =
+                merged.has_value() ? ew_merge(*merged, it->second) : it->second;
+            edges.erase(it);
+          }
+          XLS_CHECK(merged.has_value())
+              << "Inconsistency between in_edges_ and out_edges_ detected";
+          edges.insert_or_assign(rep, *merged);
+        };
+    for (const auto& [source, weight] : in_edges_.Find(first)->second) {
+      if (source != rep) {
+        patch_up_region_edges(source, &out_edges_);
+      }
+    }
+    for (const auto& [target, weight] : out_edges_.Find(first)->second) {
+      if (target != rep) {
+        patch_up_region_edges(target, &in_edges_);
+      }
+    }
+
+    return true;
+  }
+
   // Returns true iff the given vertex has previously been added to the graph
   // using `AddVertex`.
   bool Contains(const V& vertex) { return vertex_weights_.Contains(vertex); }
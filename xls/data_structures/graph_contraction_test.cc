@@ -151,6 +151,61 @@ TEST(GraphContractionTest, Diamond) {
   EXPECT_THAT(gc.EdgesInto('d'), UnorderedElementsAre(std::pair('a', 70)));
 }
 
+TEST(GraphContractionTest, RegionMatchesPairwiseIdentification) {
+  // Test that identifying {a, b} as a region gives the same graph as the
+  // pairwise merge in the Diamond test above, including the self-loop from
+  // the region-internal edge.
+  GraphContraction<char, absl::monostate, int32_t> gc;
+  gc.AddVertex('a', absl::monostate());
+  gc.AddVertex('b', absl::monostate());
+  gc.AddVertex('c', absl::monostate());
+  gc.AddVertex('d', absl::monostate());
+  EXPECT_TRUE(gc.AddEdge('c', 'a', 10));
+  EXPECT_TRUE(gc.AddEdge('c', 'b', 20));
+  EXPECT_TRUE(gc.AddEdge('a', 'd', 30));
+  EXPECT_TRUE(gc.AddEdge('b', 'd', 40));
+  EXPECT_TRUE(gc.AddEdge('a', 'b', 5));
+  EXPECT_TRUE(gc.IdentifyVertexRegion({'a', 'b'}, MergeMonostate, Sum));
+  EXPECT_THAT(gc.Vertices(), UnorderedElementsAre('c', 'a', 'd'));
+  EXPECT_THAT(gc.EdgesOutOf('c'), UnorderedElementsAre(std::pair('a', 30)));
+  EXPECT_THAT(gc.EdgesOutOf('a'),
+              UnorderedElementsAre(std::pair('d', 70), std::pair('a', 5)));
+  EXPECT_THAT(gc.EdgesInto('a'),
+              UnorderedElementsAre(std::pair('c', 30), std::pair('a', 5)));
+  EXPECT_THAT(gc.EdgesInto('d'), UnorderedElementsAre(std::pair('a', 70)));
+}
+
+TEST(GraphContractionTest, RegionOfThreeCollapsesInternalEdges) {
+  // Test that merging the chain {a -> b -> d} (with a side input from c into
+  // b) leaves a single vertex with a self-loop summing the internal edge
+  // weights.
+  GraphContraction<char, int32_t, int32_t> gc;
+  gc.AddVertex('a', 1);
+  gc.AddVertex('b', 2);
+  gc.AddVertex('d', 4);
+  gc.AddVertex('c', 8);
+  EXPECT_TRUE(gc.AddEdge('a', 'b', 3));
+  EXPECT_TRUE(gc.AddEdge('b', 'd', 5));
+  EXPECT_TRUE(gc.AddEdge('c', 'b', 7));
+  EXPECT_TRUE(gc.IdentifyVertexRegion({'a', 'b', 'd'}, Sum, Sum));
+  EXPECT_THAT(gc.Vertices(), UnorderedElementsAre('a', 'c'));
+  EXPECT_EQ(gc.WeightOf('a'), 7);
+  EXPECT_THAT(gc.EdgesOutOf('a'), UnorderedElementsAre(std::pair('a', 8)));
+  EXPECT_THAT(gc.EdgesOutOf('c'), UnorderedElementsAre(std::pair('a', 7)));
+  EXPECT_THAT(gc.EdgesInto('a'),
+              UnorderedElementsAre(std::pair('a', 8), std::pair('c', 7)));
+}
+
+TEST(GraphContractionTest, RegionWithNonexistentVertex) {
+  // Test that a region containing a vertex that was not previously inserted
+  // returns `false` and leaves the graph unchanged.
+  GraphContraction<char, absl::monostate, absl::monostate> gc;
+  gc.AddVertex('a', absl::monostate());
+  EXPECT_FALSE(
+      gc.IdentifyVertexRegion({'a', 'b'}, MergeMonostate, MergeMonostate));
+  EXPECT_THAT(gc.Vertices(), UnorderedElementsAre('a'));
+}
+
 TEST(GraphContractionTest, WeightOfWorks) {
   // Test that `WeightOf` works properly.
   GraphContraction<char, int32_t, int32_t> gc;
@@ -16,8 +16,10 @@
 #define XLS_DATA_STRUCTURES_INLINE_BITMAP_H_
 
 #include <cstdint>
+#include <optional>
 
 #include "absl/base/casts.h"
+#include "absl/numeric/bits.h"
 #include "absl/container/inlined_vector.h"
 #include "xls/common/bits_util.h"
 #include "xls/common/logging/logging.h"
@@ -37,6 +39,22 @@ class InlineBitmap {
     return result;
   }
 
+  // Constructs a bitmap of `bit_count` bits taking ownership of `words`
+  // (little-endian word order, as observed via GetWord). `words` may have
+  // excess capacity or too few words; the storage is resized to fit and any
+  // bits beyond `bit_count` in the last word are cleared.
+  static InlineBitmap FromWords(absl::InlinedVector<uint64_t, 1> words,
+                                int64_t bit_count) {
+    InlineBitmap result(0);
+    result.bit_count_ = bit_count;
+    result.data_ = std::move(words);
+    result.data_.resize(CeilOfRatio(bit_count, kWordBits), 0);
+    if (result.word_count() > 0) {
+      result.MaskLastWord();
+    }
+    return result;
+  }
+
   explicit InlineBitmap(int64_t bit_count, bool fill = false)
       : bit_count_(bit_count),
         data_(CeilOfRatio(bit_count, kWordBits), fill ? -1ULL : 0ULL) {
@@ -60,6 +78,7 @@ class InlineBitmap {
   bool operator!=(const InlineBitmap& other) const { return !(*this == other); }
 
   int64_t bit_count() const { return bit_count_; }
+  int64_t word_count() const { return data_.size(); }
   bool IsAllOnes() const {
     for (int64_t wordno = 0; wordno < word_count(); ++wordno) {
       uint64_t mask = MaskForWord(wordno);
@@ -107,6 +126,13 @@ class InlineBitmap {
     return data_[wordno];
   }
 
+  // Fast path for mutating the 64-bit word that backs a group of 64 bits.
+  // Bits of `value` beyond bit_count() are masked off.
+  void SetWord(int64_t wordno, uint64_t value) {
+    XLS_DCHECK_LT(wordno, word_count());
+    data_[wordno] = value & MaskForWord(wordno);
+  }
+
   // Sets a byte in the data underlying the bitmap.
   //
   // Setting byte i as {b_7, b_6, b_5, ..., b_0} sets the bit at i*8 to b_0, the
@@ -136,40 +162,17 @@ class InlineBitmap {
   // two's complement integers. If equal, returns 0. If this is greater than
   // other, returns 1. If this is less than other, returns -1.
   int64_t UCmp(const InlineBitmap& other) const {
-    int64_t bit_diff = bit_count_ - other.bit_count_;
-    int64_t bit_min = std::min(bit_count_, other.bit_count_);
-
-    int64_t my_idx = bit_count_ - 1;
-    int64_t other_idx = other.bit_count_ - 1;
-
-    while (bit_diff > 0) {
-      if (Get(my_idx)) {
-        return 1;
-      }
-      my_idx--;
-      bit_diff--;
-    }
-    while (bit_diff < 0) {
-      if (other.Get(other_idx)) {
-        return -1;
+    // Compare word-wise from the most significant end; a word which is only
+    // present in the wider bitmap compares against zero.
+    int64_t max_words = std::max(word_count(), other.word_count());
+    for (int64_t wordno = max_words - 1; wordno >= 0; --wordno) {
+      uint64_t my_word = wordno < word_count() ? MaskedWord(wordno) : 0;
+      uint64_t other_word =
+          wordno < other.word_count() ? other.MaskedWord(wordno) : 0;
+      if (my_word != other_word) {
+        return my_word < other_word ? -1 : 1;
       }
-      other_idx--;
-      bit_diff++;
     }
-
-    for (int64_t i = 0; i < bit_min; i++) {
-      bool my_word = Get(my_idx);
-      bool other_word = other.Get(other_idx);
-      if (my_word && !other_word) {
-        return 1;
-      }
-      if (!my_word && other_word) {
-        return -1;
-      }
-      my_idx--;
-      other_idx--;
-    }
-
     return 0;
   }
 
@@ -181,6 +184,60 @@ class InlineBitmap {
     }
   }
 
+  // Sets this bitmap to the intersection of this bitmap and `other`.
+  void Intersect(const InlineBitmap& other) {
+    XLS_CHECK_EQ(bit_count(), other.bit_count());
+    for (int64_t i = 0; i < data_.size(); ++i) {
+      data_[i] &= other.data_[i];
+    }
+  }
+
+  // Sets this bitmap to the symmetric difference of this bitmap and `other`.
+  void Xor(const InlineBitmap& other) {
+    XLS_CHECK_EQ(bit_count(), other.bit_count());
+    for (int64_t i = 0; i < data_.size(); ++i) {
+      data_[i] ^= other.data_[i];
+    }
+  }
+
+  // Clears every bit of this bitmap which is set in `other` (this &= ~other).
+  void AndNot(const InlineBitmap& other) {
+    XLS_CHECK_EQ(bit_count(), other.bit_count());
+    for (int64_t i = 0; i < data_.size(); ++i) {
+      data_[i] &= ~other.data_[i];
+    }
+  }
+
+  // Returns the number of set bits.
+  int64_t PopCount() const {
+    int64_t count = 0;
+    for (int64_t wordno = 0; wordno < word_count(); ++wordno) {
+      count += absl::popcount(MaskedWord(wordno));
+    }
+    return count;
+  }
+
+  // Returns the index of the first set bit at or after `start`, or
+  // absl::nullopt if no such bit exists.
+  std::optional<int64_t> FindNextSetBit(int64_t start) const {
+    XLS_DCHECK_GE(start, 0);
+    for (int64_t wordno = start / kWordBits; wordno < word_count(); ++wordno) {
+      uint64_t word = MaskedWord(wordno);
+      if (wordno == start / kWordBits) {
+        // Clear bits below `start` within its word.
+        word &= ~uint64_t{0} << (start % kWordBits);
+      }
+      if (word != 0) {
+        return wordno * kWordBits + absl::countr_zero(word);
+      }
+    }
+    return std::nullopt;
+  }
+
+  // Returns the index of the lowest set bit, or std::nullopt if no bit is
+  // set.
+  std::optional<int64_t> FindFirstSetBit() const { return FindNextSetBit(0); }
+
   int64_t byte_count() const { return CeilOfRatio(bit_count_, int64_t{8}); }
 
   template <typename H>
@@ -191,7 +248,13 @@ class InlineBitmap {
  private:
   static constexpr int64_t kWordBits = 64;
   static constexpr int64_t kWordBytes = 8;
-  int64_t word_count() const { return data_.size(); }
+
+  // Returns word `wordno` with any bits beyond bit_count() cleared. The
+  // stored word may carry junk in those positions (e.g. after fill
+  // construction).
+  uint64_t MaskedWord(int64_t wordno) const {
+    return data_[wordno] & MaskForWord(wordno);
+  }
 
   void MaskLastWord() {
     int64_t last_wordno = word_count() - 1;
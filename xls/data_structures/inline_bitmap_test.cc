@@ -294,5 +294,68 @@ TEST(InlineBitmapTest, Union) {
   }
 }
 
+TEST(InlineBitmapTest, IntersectXorAndNot) {
+  InlineBitmap a(128);
+  InlineBitmap b(128);
+  a.SetWord(0, 0xff00ff00ff00ff00ULL);
+  a.SetWord(1, 0x0123456789abcdefULL);
+  b.SetWord(0, 0xffff0000ffff0000ULL);
+  b.SetWord(1, 0xfedcba9876543210ULL);
+
+  InlineBitmap intersect = a;
+  intersect.Intersect(b);
+  EXPECT_EQ(intersect.GetWord(0), 0xff00ff00ff00ff00ULL & 0xffff0000ffff0000ULL);
+  EXPECT_EQ(intersect.GetWord(1), 0x0123456789abcdefULL & 0xfedcba9876543210ULL);
+
+  InlineBitmap x = a;
+  x.Xor(b);
+  EXPECT_EQ(x.GetWord(0), 0xff00ff00ff00ff00ULL ^ 0xffff0000ffff0000ULL);
+
+  InlineBitmap andnot = a;
+  andnot.AndNot(b);
+  EXPECT_EQ(andnot.GetWord(0), 0xff00ff00ff00ff00ULL & ~0xffff0000ffff0000ULL);
+}
+
+TEST(InlineBitmapTest, PopCount) {
+  EXPECT_EQ(InlineBitmap(0).PopCount(), 0);
+  EXPECT_EQ(InlineBitmap(1024).PopCount(), 0);
+  EXPECT_EQ(InlineBitmap(1024, /*fill=*/true).PopCount(), 1024);
+  InlineBitmap b(130);
+  b.Set(0, true);
+  b.Set(64, true);
+  b.Set(129, true);
+  EXPECT_EQ(b.PopCount(), 3);
+}
+
+TEST(InlineBitmapTest, FindFirstAndNextSetBit) {
+  InlineBitmap b(200);
+  EXPECT_EQ(b.FindFirstSetBit(), absl::nullopt);
+  b.Set(3, true);
+  b.Set(100, true);
+  b.Set(199, true);
+  EXPECT_EQ(b.FindFirstSetBit(), 3);
+  EXPECT_EQ(b.FindNextSetBit(3), 3);
+  EXPECT_EQ(b.FindNextSetBit(4), 100);
+  EXPECT_EQ(b.FindNextSetBit(101), 199);
+  EXPECT_EQ(b.FindNextSetBit(200 - 0), absl::nullopt);
+}
+
+TEST(InlineBitmapTest, FromWords) {
+  InlineBitmap b = InlineBitmap::FromWords(
+      {0xffffffffffffffffULL, 0x1ffULL}, /*bit_count=*/70);
+  EXPECT_EQ(b.bit_count(), 70);
+  EXPECT_EQ(b.GetWord(0), 0xffffffffffffffffULL);
+  // Bits beyond the bit count are masked off.
+  EXPECT_EQ(b.GetWord(1), 0x3fULL);
+
+  // Words beyond those given are zero-filled.
+  InlineBitmap c = InlineBitmap::FromWords({0x42ULL}, /*bit_count=*/130);
+  EXPECT_EQ(c.GetWord(0), 0x42ULL);
+  EXPECT_EQ(c.GetWord(1), 0);
+  EXPECT_EQ(c.GetWord(2), 0);
+
+  EXPECT_EQ(InlineBitmap::FromWords({}, /*bit_count=*/0).bit_count(), 0);
+}
+
 }  // namespace
 }  // namespace xls
@@ -15,6 +15,7 @@
 #ifndef XLS_DATA_STRUCTURES_LEAF_TYPE_TREE_H_
 #define XLS_DATA_STRUCTURES_LEAF_TYPE_TREE_H_
 
+#include <memory>
 #include <vector>
 
 #include "absl/container/inlined_vector.h"
@@ -27,6 +28,105 @@
 
 namespace xls {
 
+// Precomputed structural index of a Type as used by LeafTypeTree: the
+// flattened leaf types plus a node table mapping any type index path to the
+// offset and count of its leaves in the flat element vector. Computing a
+// shape walks the type once; all trees derived from an existing tree
+// (copies, Map, Zip) share the shape via shared_ptr instead of re-walking
+// the type, and subtree offset lookup is O(path length) rather than a sum
+// over sibling leaf counts. A shape is immutable after creation and
+// therefore safe to share across threads.
+class TypeShape {
+ public:
+  // Information about a subtree of the type: the subtree's type and the
+  // position of its leaves within the flattened element vector.
+  struct SubtreeInfo {
+    Type* type;
+    int64_t leaf_offset;
+    int64_t leaf_count;
+  };
+
+  static std::shared_ptr<const TypeShape> Create(Type* type) {
+    auto shape = std::shared_ptr<TypeShape>(new TypeShape(type));
+    return shape;
+  }
+
+  static bool IsLeafType(Type* t) { return t->IsBits() || t->IsToken(); }
+
+  Type* type() const { return nodes_.front().type; }
+
+  // Returns the types of each leaf in flattened (lexicographic type index)
+  // order.
+  absl::Span<Type* const> leaf_types() const { return leaf_types_; }
+
+  int64_t leaf_count() const { return leaf_types_.size(); }
+
+  // Returns information about the subtree at the given type index path. The
+  // path must be valid for the type (CHECK fails otherwise).
+  SubtreeInfo GetSubtreeInfo(absl::Span<const int64_t> index) const {
+    int64_t node = 0;
+    for (int64_t i : index) {
+      XLS_CHECK_GE(i, 0);
+      XLS_CHECK_LT(i, nodes_[node].child_count);
+      node = nodes_[node].first_child + i;
+    }
+    return SubtreeInfo{nodes_[node].type, nodes_[node].leaf_offset,
+                       nodes_[node].leaf_count};
+  }
+
+ private:
+  // A node of the type tree. Children of a node are stored contiguously in
+  // nodes_ starting at first_child.
+  struct ShapeNode {
+    Type* type;
+    int64_t leaf_offset;
+    int64_t leaf_count;
+    int64_t first_child;
+    int64_t child_count;
+  };
+
+  explicit TypeShape(Type* type) {
+    nodes_.push_back(ShapeNode{type, 0, 0, 0, 0});
+    Expand(0);
+  }
+
+  // Fills in the subtree rooted at nodes_[node_index], appending child nodes
+  // and leaf types.
+  void Expand(int64_t node_index) {
+    nodes_[node_index].leaf_offset = leaf_types_.size();
+    Type* t = nodes_[node_index].type;
+    if (IsLeafType(t)) {
+      leaf_types_.push_back(t);
+      nodes_[node_index].leaf_count = 1;
+      return;
+    }
+    const int64_t first_child = nodes_.size();
+    nodes_[node_index].first_child = first_child;
+    if (t->IsArray()) {
+      ArrayType* array_type = t->AsArrayOrDie();
+      nodes_[node_index].child_count = array_type->size();
+      for (int64_t i = 0; i < array_type->size(); ++i) {
+        nodes_.push_back(ShapeNode{array_type->element_type(), 0, 0, 0, 0});
+      }
+    } else {
+      XLS_CHECK(t->IsTuple());
+      TupleType* tuple_type = t->AsTupleOrDie();
+      nodes_[node_index].child_count = tuple_type->size();
+      for (int64_t i = 0; i < tuple_type->size(); ++i) {
+        nodes_.push_back(ShapeNode{tuple_type->element_type(i), 0, 0, 0, 0});
+      }
+    }
+    for (int64_t i = 0; i < nodes_[node_index].child_count; ++i) {
+      Expand(first_child + i);
+    }
+    nodes_[node_index].leaf_count =
+        leaf_types_.size() - nodes_[node_index].leaf_offset;
+  }
+
+  std::vector<ShapeNode> nodes_;
+  std::vector<Type*> leaf_types_;
+};
+
 // A container which stores values of an arbitrary type T, one value for each
 // leaf element (Bits value) of a potentially-recursive XLS type. Values are
 // stored in a flat vector which provides fast iteration, but indexing through
@@ -62,13 +162,13 @@ class LeafTypeTree {
   LeafTypeTree& operator=(const LeafTypeTree<T>& other) = default;
 
   explicit LeafTypeTree(Type* type)
-      : type_(type), elements_(type->leaf_count()) {
-    MakeLeafTypes(type);
-  }
+      : type_(type),
+        shape_(TypeShape::Create(type)),
+        elements_(shape_->leaf_count()) {}
   LeafTypeTree(Type* type, const T& init_value)
-      : type_(type), elements_(type->leaf_count(), init_value) {
-    MakeLeafTypes(type);
-  }
+      : type_(type),
+        shape_(TypeShape::Create(type)),
+        elements_(shape_->leaf_count(), init_value) {}
 
   // Constructor for tuples/arrays where members are provided as a span.
   LeafTypeTree(Type* type, absl::Span<LeafTypeTree<T> const> init_values)
@@ -89,7 +189,8 @@ class LeafTypeTree {
       XLS_LOG(FATAL) << "Invalid constructor for bits types";
     }
 
-    MakeLeafTypes(type);
+    shape_ = TypeShape::Create(type);
+    elements_.reserve(shape_->leaf_count());
     for (int64_t i = 0; i < init_values.size(); ++i) {
       for (int64_t j = 0; j < init_values[i].size(); ++j) {
         const T& leaf = init_values[i].elements()[j];
@@ -99,15 +200,16 @@ class LeafTypeTree {
   }
 
   LeafTypeTree(Type* type, absl::Span<const T> elements)
-      : type_(type), elements_(elements.begin(), elements.end()) {
-    MakeLeafTypes(type_);
-    XLS_CHECK_EQ(leaf_types_.size(), elements_.size());
+      : type_(type),
+        shape_(TypeShape::Create(type)),
+        elements_(elements.begin(), elements.end()) {
+    XLS_CHECK_EQ(shape_->leaf_count(), elements_.size());
   }
 
   // Constructor which avoids copying by moving elements one-by-one.
-  LeafTypeTree(Type* type, absl::Span<T> elements) : type_(type) {
-    MakeLeafTypes(type_);
-    XLS_CHECK_EQ(leaf_types_.size(), elements.size());
+  LeafTypeTree(Type* type, absl::Span<T> elements)
+      : type_(type), shape_(TypeShape::Create(type)) {
+    XLS_CHECK_EQ(shape_->leaf_count(), elements.size());
     elements_.reserve(elements.size());
     for (T& element : elements) {
       elements_.push_back(std::move(element));
@@ -124,10 +226,10 @@ class LeafTypeTree {
   // recursive traversal through the object's XLS type. The Type index must
   // correspond to a leaf Bits-type element in the object's XLS type.
   T& Get(absl::Span<int64_t const> index) {
-    std::pair<Type*, int64_t> type_offset = GetSubtypeAndOffset(type_, index);
+    TypeShape::SubtreeInfo info = shape_->GetSubtreeInfo(index);
     // The index must refer to a leaf node (bits or token type).
-    XLS_CHECK(IsLeafType(type_offset.first));
-    return elements_[type_offset.second];
+    XLS_CHECK(IsLeafType(info.type));
+    return elements_[info.leaf_offset];
   }
   const T& Get(absl::Span<int64_t const> index) const {
     return const_cast<LeafTypeTree*>(this)->Get(index);
@@ -135,10 +237,10 @@ class LeafTypeTree {
 
   // Sets the element at the given Type index to the given value.
   void Set(absl::Span<int64_t const> index, const T& value) {
-    std::pair<Type*, int64_t> type_offset = GetSubtypeAndOffset(type_, index);
+    TypeShape::SubtreeInfo info = shape_->GetSubtreeInfo(index);
     // The index must refer to a leaf node (bits or token type).
-    XLS_CHECK(IsLeafType(type_offset.first));
-    elements_[type_offset.second] = value;
+    XLS_CHECK(IsLeafType(info.type));
+    elements_[info.leaf_offset] = value;
   }
 
   // Returns the values stored in this container.
@@ -149,36 +251,37 @@ class LeafTypeTree {
 
   // Returns the values corresponding to the subtree rooted at the given index.
   absl::Span<T> GetSubelements(absl::Span<const int64_t> index) {
-    std::pair<Type*, int64_t> type_offset = GetSubtypeAndOffset(type_, index);
-    return type_offset.first->leaf_count() == 0
+    TypeShape::SubtreeInfo info = shape_->GetSubtreeInfo(index);
+    return info.leaf_count == 0
                ? absl::Span<T>()
-               : absl::Span<T>(&elements_[type_offset.second],
-                               type_offset.first->leaf_count());
+               : absl::Span<T>(&elements_[info.leaf_offset], info.leaf_count);
   }
   absl::Span<T const> GetSubelements(absl::Span<const int64_t> index) const {
-    std::pair<Type*, int64_t> type_offset = GetSubtypeAndOffset(type_, index);
-    return type_offset.first->leaf_count() == 0
+    TypeShape::SubtreeInfo info = shape_->GetSubtreeInfo(index);
+    return info.leaf_count == 0
                ? absl::Span<const T>()
-               : absl::Span<const T>(&elements_[type_offset.second],
-                                     type_offset.first->leaf_count());
+               : absl::Span<const T>(&elements_[info.leaf_offset],
+                                     info.leaf_count);
   }
 
   // Returns the types of each leaf in the XLS type of this object. The order of
   // these types corresponds to the order of elements().
-  absl::Span<Type* const> leaf_types() const { return leaf_types_; }
+  absl::Span<Type* const> leaf_types() const { return shape_->leaf_types(); }
+
+  // Returns the shape shared by all trees derived from this one.
+  const std::shared_ptr<const TypeShape>& shape() const { return shape_; }
 
   // Copies and returns the subtree rooted at the given type index as a
   // LeafTypeTree.
   LeafTypeTree<T> CopySubtree(absl::Span<const int64_t> index) const {
-    std::pair<Type*, int64_t> type_offset = GetSubtypeAndOffset(type_, index);
+    TypeShape::SubtreeInfo info = shape_->GetSubtreeInfo(index);
     // To avoid indexing into an empty vector, handle the empty elements()
     // case specially.
     return LeafTypeTree<T>(
-        type_offset.first,
-        type_offset.first->leaf_count() == 0
-            ? absl::Span<const T>()
-            : absl::Span<const T>(&elements_[type_offset.second],
-                                  type_offset.first->leaf_count()));
+        info.type, info.leaf_count == 0
+                       ? absl::Span<const T>()
+                       : absl::Span<const T>(&elements_[info.leaf_offset],
+                                             info.leaf_count));
   }
 
   // Produce a new `LeafTypeTree` from this one `LeafTypeTree` with a different
@@ -190,7 +293,7 @@ class LeafTypeTree {
     for (int32_t i = 0; i < size(); ++i) {
       new_elements.push_back(function(elements()[i]));
     }
-    return LeafTypeTree<R>(type(), new_elements);
+    return LeafTypeTree<R>(type_, shape_, std::move(new_elements));
   }
 
   // Use the given function to combine each corresponding leaf element in the
@@ -209,7 +312,7 @@ class LeafTypeTree {
       new_elements.push_back(function(lhs.elements()[i], rhs.elements()[i]));
     }
 
-    return LeafTypeTree<T>(lhs.type(), new_elements);
+    return LeafTypeTree<T>(lhs.type_, lhs.shape_, std::move(new_elements));
   }
 
   friend bool operator==(const LeafTypeTree<T>& lhs,
@@ -217,9 +320,9 @@ class LeafTypeTree {
     if (!lhs.type_->IsEqualTo(rhs.type_)) {
       return false;
     }
-    XLS_CHECK_EQ(lhs.leaf_types_.size(), rhs.leaf_types_.size());
-    for (int64_t i = 0; i < lhs.leaf_types_.size(); ++i) {
-      XLS_CHECK(lhs.leaf_types_[i]->IsEqualTo(rhs.leaf_types_[i]));
+    XLS_CHECK_EQ(lhs.leaf_types().size(), rhs.leaf_types().size());
+    for (int64_t i = 0; i < lhs.leaf_types().size(); ++i) {
+      XLS_CHECK(lhs.leaf_types()[i]->IsEqualTo(rhs.leaf_types()[i]));
     }
     return lhs.elements_ == rhs.elements_;
   }
@@ -288,7 +391,20 @@ class LeafTypeTree {
   }
 
  private:
-  static bool IsLeafType(Type* t) { return t->IsBits() || t->IsToken(); }
+  // All instantiations are friends so trees of a different leaf type can be
+  // constructed sharing the same shape (see Map and Zip).
+  template <typename U>
+  friend class LeafTypeTree;
+
+  // Constructor used by Map/Zip which adopts an existing shape rather than
+  // re-walking the type.
+  LeafTypeTree(Type* type, std::shared_ptr<const TypeShape> shape,
+               absl::InlinedVector<T, 1> elements)
+      : type_(type), shape_(std::move(shape)), elements_(std::move(elements)) {
+    XLS_CHECK_EQ(shape_->leaf_count(), elements_.size());
+  }
+
+  static bool IsLeafType(Type* t) { return TypeShape::IsLeafType(t); }
 
   std::string ToStringHelper(const std::function<std::string(const T&)>& f,
                              Type* subtype, bool multiline, int64_t indent,
@@ -333,51 +449,6 @@ class LeafTypeTree {
     return f(elements().at(linear_index++));
   }
 
-  // Creates the vector of leaf types.
-  void MakeLeafTypes(Type* t) {
-    if (IsLeafType(t)) {
-      leaf_types_.push_back(t);
-      return;
-    }
-    if (t->IsArray()) {
-      for (int64_t i = 0; i < t->AsArrayOrDie()->size(); ++i) {
-        MakeLeafTypes(t->AsArrayOrDie()->element_type());
-      }
-      return;
-    }
-    XLS_CHECK(t->IsTuple());
-    for (int64_t i = 0; i < t->AsTupleOrDie()->size(); ++i) {
-      MakeLeafTypes(t->AsTupleOrDie()->element_type(i));
-    }
-  }
-
-  // Returns a pair containing the Type and element offset for the given type
-  // index.
-  std::pair<Type*, int64_t> GetSubtypeAndOffset(Type* t,
-                                                absl::Span<int64_t const> index,
-                                                int64_t offset = 0) const {
-    if (index.empty()) {
-      return {t, offset};
-    }
-    if (t->IsArray()) {
-      XLS_CHECK(!index.empty());
-      XLS_CHECK_LT(index[0], t->AsArrayOrDie()->size());
-      Type* element_type = t->AsArrayOrDie()->element_type();
-      return GetSubtypeAndOffset(
-          element_type, index.subspan(1),
-          offset + index[0] * element_type->leaf_count());
-    }
-    XLS_CHECK(t->IsTuple());
-    TupleType* tuple_type = t->AsTupleOrDie();
-    XLS_CHECK_LT(index[0], tuple_type->size());
-    int64_t element_offset = 0;
-    for (int64_t i = 0; i < index[0]; ++i) {
-      element_offset += tuple_type->element_type(i)->leaf_count();
-    }
-    return GetSubtypeAndOffset(tuple_type->element_type(index[0]),
-                               index.subspan(1), offset + element_offset);
-  }
-
   absl::Status ForEachHelper(
       Type* subtype,
       const std::function<absl::Status(Type*, T&, absl::Span<const int64_t>)>&
@@ -407,8 +478,12 @@ class LeafTypeTree {
   }
 
   Type* type_;
+
+  // Shared, immutable shape of type_; null only for default-constructed
+  // (typeless) trees.
+  std::shared_ptr<const TypeShape> shape_;
+
   absl::InlinedVector<T, 1> elements_;
-  absl::InlinedVector<Type*, 1> leaf_types_;
 };
 
 }  // namespace xls
@@ -16,6 +16,7 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "xls/common/status/matchers.h"
@@ -248,6 +249,30 @@ TEST_F(LeafTypeTreeTest, NestedArrayType) {
   EXPECT_THAT(subtree.elements(), ElementsAre(42, 0));
 }
 
+TEST_F(LeafTypeTreeTest, ShapeIsSharedAcrossDerivedTrees) {
+  Type* type = AsType("(bits[37][3], (bits[22], (bits[1], bits[1][2])))");
+  LeafTypeTree<int64_t> tree(type);
+
+  // Copies and Map/Zip results reuse the precomputed shape instead of
+  // re-walking the type.
+  LeafTypeTree<int64_t> copy = tree;
+  EXPECT_EQ(copy.shape().get(), tree.shape().get());
+
+  LeafTypeTree<std::string> mapped =
+      tree.Map<std::string>([](const int64_t& v) { return absl::StrCat(v); });
+  EXPECT_EQ(mapped.shape().get(), tree.shape().get());
+
+  LeafTypeTree<int64_t> zipped = LeafTypeTree<int64_t>::Zip<int64_t, int64_t>(
+      [](const int64_t& a, const int64_t& b) { return a + b; }, tree, copy);
+  EXPECT_EQ(zipped.shape().get(), tree.shape().get());
+
+  // Subtree info reflects flattened leaf layout.
+  TypeShape::SubtreeInfo info = tree.shape()->GetSubtreeInfo({1, 1});
+  EXPECT_EQ(info.leaf_offset, 4);
+  EXPECT_EQ(info.leaf_count, 3);
+  EXPECT_EQ(info.type->ToString(), "(bits[1], bits[1][2])");
+}
+
 TEST_F(LeafTypeTreeTest, EmptyTuple) {
   LeafTypeTree<int64_t> tree(AsType("()"));
   EXPECT_EQ(tree.size(), 0);
@@ -23,7 +23,6 @@
 #include "absl/strings/str_join.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/logging/logging.h"
-#include "xls/common/logging/vlog_is_on.h"
 
 namespace xls {
 namespace min_cut {
@@ -114,15 +113,24 @@ class ResidualGraph {
     // EdgeId as its corresponding edge in the original graph.
     edges_.resize(graph.edge_count() * 2);
     successors_.resize(graph.node_count());
+    // Edge weights are clamped such that the sum of all capacities in the
+    // graph cannot overflow int64_t; push-relabel accumulates capacities of
+    // multiple edges into per-node excesses. Weights this large (e.g.,
+    // std::numeric_limits<int64_t>::max() used to mean "uncuttable") are far
+    // beyond any feasible cut weight so clamping does not change which cuts
+    // are minimal.
+    int64_t max_capacity =
+        std::numeric_limits<int64_t>::max() / (2 * graph.edge_count() + 2);
     for (EdgeId edge_id = EdgeId{0}; edge_id <= graph.max_edge_id();
          edge_id += EdgeId{1}) {
       const Edge& edge = graph.edge(edge_id);
       EdgeId backward_edge_id{int64_t{edge_id} + graph.edge_count()};
 
       // Add the forward edge to the residual graph. It has an inital capacity
-      // equal to the weight of the edge in the original graph.
+      // equal to the (clamped) weight of the edge in the original graph.
       edges_[int64_t{edge_id}] =
-          ResidualEdge{edge.from, edge.to, edge.weight, backward_edge_id};
+          ResidualEdge{edge.from, edge.to, std::min(edge.weight, max_capacity),
+                       backward_edge_id};
       successors_[int64_t{edge.from}].push_back(edge_id);
 
       // Add the backward edge to the residual graph. It has an inital capacity
@@ -176,139 +184,153 @@ std::string GraphWithFlowToString(const Graph& graph,
   return out;
 }
 
-// Finds an augmenting path from source to sink in the graph (path of edges with
-// non-zero residual capacity) and increases the flow along each edge in the
-// path. The amount of flow increase is equal to the minimum residual capacity
-// of any edge in the path. The augmenting path is found via Dinic's algorithm
-// which finds a shortest augmenting path via BFS search. Returns the amount of
-// augmented flow. If no augmenting path is found then zero is returned.
-int64_t AugmentFlow(const Graph& graph, NodeId source, NodeId sink,
-                    ResidualGraph* residual_graph) {
-  XLS_VLOG_LINES(4, GraphWithFlowToString(graph, *residual_graph));
-
-  // Perform a BFS search from flow to find the shortest augmenting path (by
-  // edge count) from source to sink. For each edge traversed in the BFS search,
-  // 'path_back' holds the previous edge in the path from the source along with
-  // the residual capacity of that path..
-  absl::flat_hash_map<NodeId, std::pair<ResidualEdge*, int64_t>> path_back;
-  std::vector<NodeId> frontier = {source};
-  while (!frontier.empty()) {
-    std::vector<NodeId> next_frontier;
-    // Try to add extend the BFS-constructed paths from the source with the
-    // given edge.
-    auto maybe_extend_frontier = [&](ResidualEdge* e) {
-      if (path_back.contains(e->to)) {
-        return;
-      }
-      int64_t path_capacity = path_back.contains(e->from)
-                                  ? path_back.at(e->from).second
-                                  : std::numeric_limits<int64_t>::max();
-      // The residual capacity of a path is the minimum residual capacity of any
-      // edge in the path.
-      path_capacity = std::min(path_capacity, e->capacity);
-      path_back[e->to] = {e, path_capacity};
-      next_frontier.push_back(e->to);
-      XLS_VLOG(5) << "  Added " << graph.name(e->to) << " to the frontier";
-    };
-
-    for (NodeId node : frontier) {
-      XLS_VLOG(5) << "Visiting " << graph.name(node);
-      for (EdgeId edge_id : residual_graph->successors(node)) {
-        ResidualEdge& edge = residual_graph->edge(edge_id);
-        XLS_VLOG(5) << absl::StreamFormat(
-            "  Traversing %s->%s", graph.name(edge.from), graph.name(edge.to));
-        XLS_CHECK_GE(edge.capacity, 0);
-        if (edge.capacity > 0) {
-          maybe_extend_frontier(&edge);
-          if (edge.to == sink) {
-            // Found augmenting path. As this is the first path we've found in a
-            // BFS search it is necessarily a shortest path. Walk back along
-            // path and augment the flow.
-            int64_t augmented_flow_amount = path_back.at(sink).second;
-            XLS_CHECK_GT(augmented_flow_amount, 0);
-            NodeId n = sink;
-            while (n != source) {
-              ResidualEdge* e = path_back.at(n).first;
-              residual_graph->PushFlow(augmented_flow_amount, e);
-              XLS_CHECK_GE(e->capacity, 0);
-              n = e->from;
-            }
-            if (XLS_VLOG_IS_ON(4)) {
-              XLS_VLOG(4) << "Augmented flow: " << augmented_flow_amount;
-              std::vector<const ResidualEdge*> augmented_path;
-              NodeId n = sink;
-              while (n != source) {
-                const ResidualEdge* e = path_back.at(n).first;
-                augmented_path.push_back(e);
-                n = e->from;
-              }
-              std::reverse(augmented_path.begin(), augmented_path.end());
-              XLS_VLOG(4) << "Augmented path: "
-                          << absl::StrJoin(
-                                 augmented_path, ", ",
-                                 [&](std::string* out, const ResidualEdge* e) {
-                                   absl::StrAppendFormat(
-                                       out, "%s->%s [new capacity %d]",
-                                       graph.name(e->from), graph.name(e->to),
-                                       e->capacity);
-                                 });
+// Maximizes the flow from source to sink in the residual graph using the
+// push-relabel method with FIFO selection of active nodes and the gap
+// relabeling heuristic. Only the first phase of the algorithm is run: any
+// excess stranded at interior nodes when the phase completes is *not* routed
+// back to the source. This maximizes the flow arriving at the sink, which is
+// all that is needed to recover a min cut, but it means flow conservation may
+// be violated at nodes on the source side of the cut.
+void PushRelabelMaxFlow(const Graph& graph, NodeId source, NodeId sink,
+                        ResidualGraph* residual_graph) {
+  const int64_t node_count = graph.node_count();
+
+  // Height (distance label) of each node. The labeling is maintained such
+  // that height(u) <= height(v) + 1 for every residual edge u->v with
+  // positive capacity; a node at height >= node_count therefore cannot reach
+  // the sink and takes no further part in phase one.
+  std::vector<int64_t> height(node_count, 0);
+
+  // Flow pushed into each node which has not yet been pushed onward.
+  std::vector<int64_t> excess(node_count, 0);
+
+  // Number of nodes at each height below node_count, used to detect gaps in
+  // the labeling.
+  std::vector<int64_t> height_count(node_count, 0);
+
+  // Index into successors() of the next edge to consider when pushing from
+  // each node (the "current arc"); edges before it are known inadmissible.
+  std::vector<int64_t> current_arc(node_count, 0);
+
+  height[int64_t{source}] = node_count;
+  height_count[0] = node_count - 1;
+
+  // FIFO queue of nodes with positive excess.
+  std::deque<NodeId> active;
+  auto push = [&](ResidualEdge* e, int64_t amount) {
+    residual_graph->PushFlow(amount, e);
+    excess[int64_t{e->from}] -= amount;
+    bool was_idle = excess[int64_t{e->to}] == 0;
+    excess[int64_t{e->to}] += amount;
+    if (was_idle && e->to != source && e->to != sink) {
+      active.push_back(e->to);
+    }
+  };
+
+  // Saturate every edge out of the source.
+  for (EdgeId edge_id : residual_graph->successors(source)) {
+    ResidualEdge& edge = residual_graph->edge(edge_id);
+    if (edge.capacity > 0) {
+      push(&edge, edge.capacity);
+    }
+  }
+
+  while (!active.empty()) {
+    NodeId node = active.front();
+    active.pop_front();
+    int64_t n = int64_t{node};
+    // Discharge the node: push its excess towards the sink along admissible
+    // edges (residual edges descending exactly one height), lifting the node
+    // when no admissible edge remains.
+    while (excess[n] > 0 && height[n] < node_count) {
+      absl::Span<const EdgeId> out = residual_graph->successors(node);
+      if (current_arc[n] == static_cast<int64_t>(out.size())) {
+        // Relabel: lift the node just above its lowest neighbor reachable
+        // via an edge with residual capacity.
+        int64_t min_height = 2 * node_count;
+        for (EdgeId edge_id : out) {
+          const ResidualEdge& edge = residual_graph->edge(edge_id);
+          if (edge.capacity > 0) {
+            min_height = std::min(min_height, height[int64_t{edge.to}] + 1);
+          }
+        }
+        int64_t old_height = height[n];
+        --height_count[old_height];
+        height[n] = min_height;
+        current_arc[n] = 0;
+        XLS_VLOG(5) << absl::StreamFormat("Relabeled %s: %d -> %d",
+                                          graph.name(node), old_height,
+                                          min_height);
+        if (height[n] < node_count) {
+          ++height_count[height[n]];
+        }
+        // Gap heuristic: if no node remains at the old height then no node
+        // above it can reach the sink anymore; lift them all out of play at
+        // once.
+        if (height_count[old_height] == 0) {
+          XLS_VLOG(4) << "Gap at height " << old_height;
+          for (int64_t i = 0; i < node_count; ++i) {
+            if (old_height < height[i] && height[i] < node_count) {
+              --height_count[height[i]];
+              height[i] = node_count;
             }
-            return augmented_flow_amount;
           }
         }
+        continue;
+      }
+      ResidualEdge& edge = residual_graph->edge(out[current_arc[n]]);
+      if (edge.capacity > 0 && height[n] == height[int64_t{edge.to}] + 1) {
+        push(&edge, std::min(excess[n], edge.capacity));
+      } else {
+        ++current_arc[n];
       }
     }
-
-    frontier = std::move(next_frontier);
-    next_frontier.clear();
   }
-
-  XLS_VLOG(4) << "No augmenting path found";
-  return 0;
 }
 
 }  // namespace
 
 GraphCut MinCutBetweenNodes(const Graph& graph, NodeId source, NodeId sink) {
-  // This loop is the core of the Ford-Fulkerson method. Starting with zero flow
-  // on all edges, flow is increased along a path from source to sink with
-  // residual capacity (called an augmenting path). When no further augmenting
-  // paths exist, flow has been maximized. 'flow' is the flow of each edge in
-  // the graph indexed by EdgeId.
   ResidualGraph residual_graph(graph);
-  while (AugmentFlow(graph, source, sink, &residual_graph) > 0) {
-  }
-
-  // Once a maximum flow is found, walk the residual graph from the source. All
-  // reachable nodes form one partition.
-  absl::flat_hash_set<NodeId> reachable_from_source;
-  std::deque<NodeId> frontier = {source};
-  reachable_from_source.insert(source);
+  PushRelabelMaxFlow(graph, source, sink, &residual_graph);
+  XLS_VLOG_LINES(4, GraphWithFlowToString(graph, residual_graph));
+
+  // Because only the first phase of push-relabel is run, flow conservation
+  // may be violated on the source side of the cut, so the partition is
+  // derived by walking the residual graph *backwards* from the sink. The
+  // nodes which can reach the sink form one partition; stranded excess always
+  // lies on the other side.
+  absl::flat_hash_set<NodeId> reaches_sink;
+  std::deque<NodeId> frontier = {sink};
+  reaches_sink.insert(sink);
   while (!frontier.empty()) {
     NodeId node = frontier.front();
     frontier.pop_front();
     for (EdgeId successor_edge_id : residual_graph.successors(node)) {
-      const ResidualEdge& edge = residual_graph.edge(successor_edge_id);
-      if (edge.capacity > 0 && !reachable_from_source.contains(edge.to)) {
-        reachable_from_source.insert(edge.to);
-        frontier.push_back(edge.to);
+      // The dual of each edge out of 'node' is an edge into 'node'; if it has
+      // residual capacity then its source can reach the sink through 'node'.
+      const ResidualEdge& into_node = residual_graph.edge(
+          residual_graph.edge(successor_edge_id).dual_edge);
+      if (into_node.capacity > 0 && !reaches_sink.contains(into_node.from)) {
+        reaches_sink.insert(into_node.from);
+        frontier.push_back(into_node.from);
       }
     }
   }
-  XLS_CHECK(!reachable_from_source.contains(sink));
+  XLS_CHECK(!reaches_sink.contains(source));
 
   GraphCut min_cut;
   min_cut.weight = 0;
   for (NodeId node_id = NodeId(0); node_id <= graph.max_node_id(); ++node_id) {
-    if (reachable_from_source.contains(node_id)) {
-      min_cut.source_partition.push_back(node_id);
-    } else {
+    if (reaches_sink.contains(node_id)) {
       min_cut.sink_partition.push_back(node_id);
+    } else {
+      min_cut.source_partition.push_back(node_id);
     }
     for (EdgeId edge_id : graph.successors(node_id)) {
       const Edge& edge = graph.edge(edge_id);
-      if (reachable_from_source.contains(edge.from) &&
-          !reachable_from_source.contains(edge.to)) {
+      if (!reaches_sink.contains(edge.from) &&
+          reaches_sink.contains(edge.to)) {
         min_cut.weight += edge.weight;
       }
     }
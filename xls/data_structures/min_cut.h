@@ -97,8 +97,11 @@ struct GraphCut {
 // Computes a minimum cut of the given graph where source and sink are in
 // different partitions. The cut is returned as a partitioning of the nodes of
 // the graph into two sets of nodes on either side of the cut. The min cut is
-// found via the Ford-Fulkerson method using Dinic's algorithm. This results in
-// a worst case run time of O(V^2 * E).
+// found via a maximum flow computed with the push-relabel method using FIFO
+// selection of active nodes and the gap relabeling heuristic. This results in
+// a worst case run time of O(V^3), and is much faster in practice than
+// augmenting-path methods on the wide, shallow graphs produced by min-cut
+// scheduling.
 GraphCut MinCutBetweenNodes(const Graph& graph, NodeId source, NodeId sink);
 
 }  // namespace min_cut
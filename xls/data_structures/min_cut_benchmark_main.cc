@@ -0,0 +1,132 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmark for the max-flow engine underlying MinCutBetweenNodes. Times
+// min-cut computation on randomly generated layered graphs shaped like the
+// graphs min-cut scheduling builds (wide layers of nodes between a source and
+// sink attached with uncuttable edges) across a range of sizes:
+//
+//   bazel run -c opt //xls/data_structures:min_cut_benchmark_main
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "xls/common/init_xls.h"
+#include "xls/data_structures/min_cut.h"
+
+namespace xls {
+namespace min_cut {
+namespace {
+
+// Constructs a random layered digraph with the given number of layers and
+// nodes per layer. All nodes in the first (last) layer are connected to a
+// source (sink) node with maximum-weight edges, mirroring the graphs built by
+// min-cut scheduling where nodes already scheduled before (after) the cut are
+// merged into the source (sink).
+Graph MakeLayeredGraph(int64_t layer_count, int64_t nodes_in_layer,
+                       int64_t max_fanout, NodeId* source, NodeId* sink,
+                       std::minstd_rand* rng) {
+  Graph graph;
+  *source = graph.AddNode();
+  std::vector<std::vector<NodeId>> layers(layer_count);
+  for (std::vector<NodeId>& layer : layers) {
+    for (int64_t i = 0; i < nodes_in_layer; ++i) {
+      layer.push_back(graph.AddNode());
+    }
+  }
+  *sink = graph.AddNode();
+
+  for (NodeId node : layers.front()) {
+    graph.AddEdge(*source, node, std::numeric_limits<int64_t>::max());
+  }
+  std::uniform_int_distribution<int64_t> fanout_dis(1, max_fanout);
+  std::uniform_int_distribution<int64_t> to_node_dis(0, nodes_in_layer - 1);
+  std::uniform_int_distribution<int64_t> weight_dis(1, 1000);
+  for (int64_t i = 0; i < layer_count - 1; ++i) {
+    std::uniform_int_distribution<int64_t> to_layer_dis(i + 1, layer_count - 1);
+    for (NodeId from : layers[i]) {
+      int64_t fanout = fanout_dis(*rng);
+      for (int64_t j = 0; j < fanout; ++j) {
+        graph.AddEdge(from, layers[to_layer_dis(*rng)][to_node_dis(*rng)],
+                      weight_dis(*rng));
+      }
+    }
+  }
+  for (NodeId node : layers.back()) {
+    graph.AddEdge(node, *sink, std::numeric_limits<int64_t>::max());
+  }
+  return graph;
+}
+
+void RunBenchmark(int64_t layer_count, int64_t nodes_in_layer,
+                  int64_t max_fanout) {
+  std::minstd_rand rng;
+  NodeId source;
+  NodeId sink;
+  Graph graph = MakeLayeredGraph(layer_count, nodes_in_layer, max_fanout,
+                                 &source, &sink, &rng);
+
+  // Calibration pass to pick an iteration count of roughly 100ms.
+  int64_t iterations = 1;
+  absl::Time start = absl::Now();
+  for (int64_t i = 0; i < iterations; ++i) {
+    GraphCut cut = MinCutBetweenNodes(graph, source, sink);
+    if (cut.weight < 0) {
+      std::cerr << "Unexpected cut weight\n";
+      return;
+    }
+  }
+  absl::Duration calibration = absl::Now() - start;
+  iterations = std::max(
+      int64_t{1}, static_cast<int64_t>(absl::Milliseconds(100) / calibration));
+
+  start = absl::Now();
+  for (int64_t i = 0; i < iterations; ++i) {
+    GraphCut cut = MinCutBetweenNodes(graph, source, sink);
+    if (cut.weight < 0) {
+      std::cerr << "Unexpected cut weight\n";
+      return;
+    }
+  }
+  absl::Duration elapsed = absl::Now() - start;
+  std::cout << absl::StreamFormat(
+      "%5d layers x %5d nodes (%8d edges): %s/cut\n", layer_count,
+      nodes_in_layer, graph.edge_count(),
+      absl::FormatDuration(elapsed / iterations));
+}
+
+void RealMain() {
+  for (int64_t layer_count : {4, 16, 64}) {
+    for (int64_t nodes_in_layer : {16, 256, 1024}) {
+      RunBenchmark(layer_count, nodes_in_layer, /*max_fanout=*/4);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace min_cut
+}  // namespace xls
+
+int main(int argc, char** argv) {
+  xls::InitXls(argv[0], argc, argv);
+  xls::min_cut::RealMain();
+  return 0;
+}
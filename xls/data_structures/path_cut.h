@@ -17,14 +17,13 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
-#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
-#include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
@@ -183,8 +182,53 @@ class PathGraph {
   //
   // The algorithm is based on https://cs.stackexchange.com/a/138417
   std::optional<PathCut> ComputePathCut(NW maximum_weight) {
-    // Set up a cache for prefix sums of the node weight list.
-    absl::flat_hash_map<PathNodeId, NW> prefix_sums = ComputePrefixSums();
+    std::vector<CacheItem> scratch;
+    return ComputePathCutInternal(maximum_weight, &scratch);
+  }
+
+  // Computes the optimal `PathCut` for each of the given maximum weights;
+  // element i of the result corresponds to `maximum_weights[i]`. Equivalent
+  // to calling `ComputePathCut` once per weight, but the budget-independent
+  // state (node weight prefix sums, dynamic programming scratch storage) is
+  // shared across the sweep, and a budget no larger than a known-infeasible
+  // budget is rejected without re-running the dynamic program (feasibility is
+  // monotone in the budget). Intended for callers sweeping stage counts over
+  // the same path.
+  std::vector<std::optional<PathCut>> ComputePathCuts(
+      absl::Span<const NW> maximum_weights) {
+    std::vector<std::optional<PathCut>> results;
+    results.reserve(maximum_weights.size());
+    std::vector<CacheItem> scratch;
+    std::optional<NW> infeasible_weight;
+    for (const NW& maximum_weight : maximum_weights) {
+      if (infeasible_weight.has_value() &&
+          node_weight_total_order_.less_than_or_eq(maximum_weight,
+                                                   *infeasible_weight)) {
+        results.push_back(absl::nullopt);
+        continue;
+      }
+      results.push_back(ComputePathCutInternal(maximum_weight, &scratch));
+      if (!results.back().has_value()) {
+        infeasible_weight = maximum_weight;
+      }
+    }
+    return results;
+  }
+
+ private:
+  // Dynamic programming cache entry; see ComputePathCutInternal. `previous`
+  // is the index of the cache entry the minimum was taken from, or -1 for
+  // the base case entry.
+  struct CacheItem {
+    EW cost;
+    int32_t previous;
+  };
+
+  std::optional<PathCut> ComputePathCutInternal(
+      NW maximum_weight, std::vector<CacheItem>* cache_storage) {
+    // Prefix sums of the node weight list do not depend on the maximum
+    // weight, so they are computed once per path and reused across calls.
+    const std::vector<NW>& prefix_sums = ComputePrefixSums();
 
     // Elements of this cache represent the optimal solution to the problem,
     // assuming that the solution contains a cut edge immediately after a
@@ -216,63 +260,76 @@ class PathGraph {
     // Note that when k = n, there is no "cut edge"; this is by design, so that
     // we don't need to duplicate the inner loop logic to find the optimal
     // "leftover" non-prefix piece at the end.
-    absl::flat_hash_map<CacheKey, CacheItem> cache;
-
-    // Initialize the base case of the recurrence.
-    cache[absl::nullopt] = {edge_weight_pdm_.zero(), {}};
+    //
+    // The cache is a flat array indexed by 1 + the node number (index 0 is
+    // the ø base case), and each entry records which predecessor entry its
+    // minimum was taken from rather than materializing a cut edge list; the
+    // optimal cut is reconstructed by walking the predecessor links once at
+    // the end.
+    std::vector<CacheItem>& cache = *cache_storage;
+    cache.clear();
+    cache.reserve(NumNodes() + 1);
+    cache.push_back(CacheItem{edge_weight_pdm_.zero(), -1});
 
     for (PathNodeId k(0); static_cast<int32_t>(k) < NumNodes(); k++) {
-      std::optional<CacheItem> best;
-
-      {
-        // The body of the dynamic programming inner loop; corresponds to the
-        // min{A[t] | …} in the recurrence above.
-        auto loop_body = [&](CacheKey t) {
-          std::optional<NW> prefix_sum_diff_maybe =
-              t.has_value()
-                  ? node_weight_pdm_.difference(prefix_sums[k], prefix_sums[*t])
-                  : prefix_sums[k];
-          XLS_CHECK(prefix_sum_diff_maybe.has_value())
-              << "The given PartialDifferenceMonoid for node weights failed";
-          NW prefix_sum_diff = *prefix_sum_diff_maybe;
-          if (node_weight_total_order_.less_than_or_eq(prefix_sum_diff,
-                                                       maximum_weight) &&
-              (!best.has_value() ||
-               edge_weight_total_order_.less_than(cache[t].cost, best->cost))) {
-            best = cache[t];
-          }
-        };
-
-        // Actually run the dynamic programming inner loop.
-        loop_body(absl::nullopt);
-        for (PathNodeId t(0); t < k; t++) {
-          loop_body(t);
+      int32_t best = -1;
+
+      // The body of the dynamic programming inner loop; corresponds to the
+      // min{A[t] | …} in the recurrence above. `t_index` 0 is ø and
+      // `t_index` t + 1 is node t.
+      auto loop_body = [&](int32_t t_index) {
+        std::optional<NW> prefix_sum_diff_maybe =
+            t_index > 0
+                ? node_weight_pdm_.difference(
+                      prefix_sums[static_cast<int32_t>(k)],
+                      prefix_sums[t_index - 1])
+                : prefix_sums[static_cast<int32_t>(k)];
+        XLS_CHECK(prefix_sum_diff_maybe.has_value())
+            << "The given PartialDifferenceMonoid for node weights failed";
+        NW prefix_sum_diff = *prefix_sum_diff_maybe;
+        if (node_weight_total_order_.less_than_or_eq(prefix_sum_diff,
+                                                     maximum_weight) &&
+            (best < 0 || edge_weight_total_order_.less_than(
+                             cache[t_index].cost, cache[best].cost))) {
+          best = t_index;
         }
+      };
+
+      // Actually run the dynamic programming inner loop.
+      for (int32_t t_index = 0; t_index <= static_cast<int32_t>(k);
+           t_index++) {
+        loop_body(t_index);
       }
 
       // This means there was a node that was too big for the given value of
       // `maximum_weight`.
-      if (!best.has_value()) {
+      if (best < 0) {
         return absl::nullopt;
       }
 
+      CacheItem item{cache[best].cost, best};
       // Corresponds to the … + wₑ(k, k + 1) part of the recurrence.
       if (std::optional<PathEdgeId> e = NodeSuccessorEdge(k)) {
-        best->cost += WeightOfEdge(*e);
-        best->cut_edges.push_back(*e);
+        item.cost += WeightOfEdge(*e);
       }
 
-      cache[k] = *best;
+      cache.push_back(item);
     }
 
-    XLS_VLOG(3) << "cache = " << CacheToString(cache) << "\n";
-
-    CacheItem optimal = cache[PathNodeId(NumNodes() - 1)];
-    std::sort(optimal.cut_edges.begin(), optimal.cut_edges.end());
-
-    return CutEdgesToPathCut(optimal.cut_edges);
+    // Reconstruct the cut edge list by walking the predecessor links from
+    // the entry of the last node; every predecessor entry other than the
+    // base case cut the edge after its node. The links run right to left, so
+    // the edges come out in decreasing order and are reversed.
+    std::vector<PathEdgeId> cut_edges;
+    for (int32_t index = cache[NumNodes()].previous; index > 0;
+         index = cache[index].previous) {
+      cut_edges.push_back(*NodeSuccessorEdge(PathNodeId(index - 1)));
+    }
+    std::reverse(cut_edges.begin(), cut_edges.end());
+    return CutEdgesToPathCut(cut_edges);
   }
 
+ public:
   // Convert a list of "cut edges" into a `PathCut`, i.e.: if the given `Path`
   // has six edges, and the given list of cut edges is `[2, 4]`, then the
   // returned partition will be `[[0, 1, 2], [3, 4], [5]]`.
@@ -303,44 +360,25 @@ class PathGraph {
   TotalOrder<NW> node_weight_total_order_;
   TotalOrder<EW> edge_weight_total_order_;
 
-  using CacheKey = std::optional<PathNodeId>;
-
-  struct CacheItem {
-    EW cost;
-    std::vector<PathEdgeId> cut_edges;
-  };
-
-  // Display the value of the dynamic programming cache as a string.
-  std::string CacheToString(
-      absl::flat_hash_map<CacheKey, CacheItem>& cache) const {
-    std::vector<std::string> items;
-    for (PathNodeId n(0); static_cast<int32_t>(n) < NumNodes(); n++) {
-      std::stringstream ss;
-      ss << cache[n].cost;
-      items.push_back(
-          absl::StrFormat("(%s, [%s])", ss.str(),
-                          absl::StrJoin(cache[n].cut_edges, ", ",
-                                        [](std::string* out, PathEdgeId edge) {
-                                          absl::StrAppend(out, edge.value());
-                                        })));
+  // Prefix sums of the node weight list, indexed by node and built on first
+  // use. The sums depend only on the path, not on any maximum weight, so they
+  // are shared by all `ComputePathCut` calls on this graph.
+  const std::vector<NW>& ComputePrefixSums() {
+    if (prefix_sums_.empty()) {
+      prefix_sums_.reserve(NumNodes());
+      prefix_sums_.push_back(WeightOfNode(PathNodeId(0)));
+      for (PathNodeId n(1); static_cast<int32_t>(n) < NumNodes(); n++) {
+        auto sum_maybe = node_weight_pdm_.sum(
+            prefix_sums_[static_cast<int32_t>(n) - 1], WeightOfNode(n));
+        XLS_CHECK(sum_maybe)
+            << "The given PartialDifferenceMonoid for node weights failed";
+        prefix_sums_.push_back(*sum_maybe);
+      }
     }
-    return absl::StrJoin(items, ", ");
+    return prefix_sums_;
   }
 
-  absl::flat_hash_map<PathNodeId, NW> ComputePrefixSums() {
-    absl::flat_hash_map<PathNodeId, NW> result;
-
-    result[PathNodeId(0)] = WeightOfNode(PathNodeId(0));
-    for (PathNodeId n(1); static_cast<int32_t>(n) < NumNodes(); n++) {
-      auto sum_maybe =
-          node_weight_pdm_.sum(result[n - PathNodeId(1)], WeightOfNode(n));
-      XLS_CHECK(sum_maybe)
-          << "The given PartialDifferenceMonoid for node weights failed";
-      result[n] = *sum_maybe;
-    }
-
-    return result;
-  }
+  std::vector<NW> prefix_sums_;
 };
 
 }  // namespace xls
@@ -176,6 +176,23 @@ TEST(PathCutTest, ComplexTest) {
   }
 }
 
+TEST(PathCutTest, SweepMatchesIndividualCuts) {
+  PG path = CreatePathGraph({17, 16, 18, 93, 55, 75, 51, 63},
+                            {23, 34, 61, 22, 76, 54, 77});
+  // Decreasing budgets exercise the infeasible-budget short-circuit in the
+  // sweep; the results must nonetheless agree with individual calls.
+  std::vector<int32_t> budgets;
+  for (int32_t i = 300; i >= 0; i -= 7) {
+    budgets.push_back(i);
+  }
+  std::vector<std::optional<PathCut>> swept = path.ComputePathCuts(budgets);
+  ASSERT_EQ(swept.size(), budgets.size());
+  for (int32_t i = 0; i < budgets.size(); i++) {
+    EXPECT_EQ(swept[i], path.ComputePathCut(budgets[i]))
+        << "budget = " << budgets[i];
+  }
+}
+
 struct ColoredNodeWeight {
   std::optional<std::pair<PathNodeId, PathNodeId>> interval;
   int32_t weight;
@@ -166,9 +166,23 @@ class SubmodularFunction {
       x_old = x;
       // By Lemma 5.4, the body of the loop is equivalent to
       // `X_{t + 1} = X_t ∪ {j | f(j | X_t) < 0}`
+      //
+      // `f(X_t)` is shared by every marginal in the sweep, so it is evaluated
+      // once; each candidate marginal then costs one evaluation on a scratch
+      // set mutated in place rather than two evaluations on freshly copied
+      // sets. Elements already in `X_t` have a marginal of zero and are
+      // skipped outright.
       absl::btree_set<T, C> x_new = x;
+      absl::btree_set<T, C> scratch = x;
+      const double base_value = function_(x);
       for (const T& j : universe_) {
-        if (IncrementalValue(x, j) < 0) {
+        if (x.contains(j)) {
+          continue;
+        }
+        scratch.insert(j);
+        const double marginal = function_(scratch) - base_value;
+        scratch.erase(j);
+        if (marginal < 0) {
           x_new.insert(j);
         }
       }
@@ -185,9 +199,18 @@ class SubmodularFunction {
       x_old = x;
       // By Lemma 5.4, the body of the loop is equivalent to
       // `X_{t + 1} = X_t \ {j | f(j | X_t \ {j}) > 0}`
+      //
+      // As in MMinI, `f(X_t)` is hoisted out of the sweep and the marginals
+      // are evaluated against an in-place-mutated scratch set; elements
+      // outside `X_t` have a marginal of zero and are skipped.
       absl::btree_set<T, C> x_new = x;
-      for (const T& j : universe_) {
-        if (DecrementalValue(x, j) > 0) {
+      absl::btree_set<T, C> scratch = x;
+      const double base_value = function_(x);
+      for (const T& j : x) {
+        scratch.erase(j);
+        const double marginal = base_value - function_(scratch);
+        scratch.insert(j);
+        if (marginal > 0) {
           x_new.erase(j);
         }
       }
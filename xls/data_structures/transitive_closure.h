@@ -15,18 +15,117 @@
 #ifndef XLS_DATA_STRUCTURES_TRANSITIVE_CLOSURE_H_
 #define XLS_DATA_STRUCTURES_TRANSITIVE_CLOSURE_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/numeric/bits.h"
 #include "absl/strings/str_format.h"
 #include "xls/common/logging/log_message.h"
 #include "xls/common/logging/logging.h"
+#include "xls/data_structures/inline_bitmap.h"
 
 namespace xls {
 
 template <typename V>
 using HashRelation = absl::flat_hash_map<V, absl::flat_hash_set<V>>;
 
-// Compute the transitive closure of a relation.
+// A relation over the dense node set {0, ..., n-1}: element i of the vector is
+// the adjacency row of node i, and bit j of that row indicates whether (i, j)
+// is in the relation. Every row must have n bits.
+using DenseRelation = std::vector<InlineBitmap>;
+
+// Computes the transitive closure of a dense relation in place. This is
+// Warshall's algorithm reorganized to work on whole 64-bit row words: pivots
+// are processed one word-of-columns at a time, so each non-pivot row makes a
+// single pass over its pivot word instead of n single-bit probes, and the
+// pivot rows stay hot in cache while every other row is combined with them.
+inline void TransitiveClosure(DenseRelation* relation) {
+  DenseRelation& rows = *relation;
+  const int64_t n = rows.size();
+  for (int64_t i = 0; i < n; ++i) {
+    XLS_DCHECK_EQ(rows[i].bit_count(), n);
+  }
+  constexpr int64_t kWordBits = 64;
+  for (int64_t block_begin = 0; block_begin < n; block_begin += kWordBits) {
+    const int64_t wordno = block_begin / kWordBits;
+    const int64_t block_end = std::min(n, block_begin + kWordBits);
+    // Close the pivot rows with respect to the pivots in this block. This is
+    // plain Warshall restricted to the block; afterwards each pivot row k
+    // contains everything reachable from k through pivots in the block, so a
+    // single union with row k suffices for any row that can reach k.
+    for (int64_t k = block_begin; k < block_end; ++k) {
+      for (int64_t i = block_begin; i < block_end; ++i) {
+        if (i != k && rows[i].Get(k)) {
+          rows[i].Union(rows[k]);
+        }
+      }
+    }
+    // Fold the closed pivot rows into every other row, word at a time.
+    for (int64_t i = 0; i < n; ++i) {
+      if (i >= block_begin && i < block_end) {
+        continue;
+      }
+      uint64_t pivots = rows[i].GetWord(wordno);
+      while (pivots != 0) {
+        const int64_t k = block_begin + absl::countr_zero(pivots);
+        pivots &= pivots - 1;
+        rows[i].Union(rows[k]);
+      }
+    }
+  }
+}
+
+namespace internal {
+
+// Relations with at least this many nodes are routed through the dense bitmap
+// representation; below it the hash representation's conversion overhead is
+// not worth paying.
+constexpr int64_t kDenseClosureThreshold = 16;
+
+// Warshall's algorithm directly on the hash representation;
+// https://cs.winona.edu/lin/cs440/ch08-2.pdf
+template <typename V>
+HashRelation<V> HashTransitiveClosure(const HashRelation<V>& relation) {
+  auto contains = [](const HashRelation<V>& rel, const V& i,
+                     const V& j) -> bool {
+    return rel.contains(i) && rel.at(i).contains(j);
+  };
+
+  absl::flat_hash_set<V> unordered_nodes;
+  for (const auto& [node, children] : relation) {
+    unordered_nodes.insert(node);
+    for (const auto& child : children) {
+      unordered_nodes.insert(child);
+    }
+  }
+
+  HashRelation<V> closure = relation;
+  for (const V& k : unordered_nodes) {
+    if (!closure.contains(k)) {
+      continue;
+    }
+    for (const V& i : unordered_nodes) {
+      if (i != k && contains(closure, i, k)) {
+        // 'i' is guaranteed to be a key of 'closure' here, so this insertion
+        // does not invalidate the reference into closure[k].
+        const absl::flat_hash_set<V>& from_k = closure.at(k);
+        closure[i].insert(from_k.begin(), from_k.end());
+      }
+    }
+  }
+  return closure;
+}
+
+}  // namespace internal
+
+// Compute the transitive closure of a relation. Large relations are
+// transparently converted to a dense bitmap matrix, closed with the
+// bit-parallel routine above, and converted back; this turns the inner loop of
+// Warshall's algorithm from per-element hash probes into 64-way word ORs.
 template <typename V>
 HashRelation<V> TransitiveClosure(const HashRelation<V>& relation) {
   using Rel = HashRelation<V>;
@@ -42,53 +141,40 @@ HashRelation<V> TransitiveClosure(const HashRelation<V>& relation) {
       unordered_nodes.insert(child);
     }
   }
+  const int64_t n = unordered_nodes.size();
+
+  if (n < internal::kDenseClosureThreshold) {
+    return internal::HashTransitiveClosure(relation);
+  }
 
   std::vector<V> ordered_nodes(unordered_nodes.begin(), unordered_nodes.end());
   std::sort(ordered_nodes.begin(), ordered_nodes.end());
 
-  const int64_t n = ordered_nodes.size();
-
   absl::flat_hash_map<V, int64_t> node_to_index;
   for (int64_t i = 0; i < n; ++i) {
     node_to_index[ordered_nodes[i]] = i;
   }
 
-  // Warshall's algorithm; https://cs.winona.edu/lin/cs440/ch08-2.pdf
-
-  auto get = [&](const HashRelation<int64_t>& rel, int64_t i,
-                 int64_t j) -> bool {
-    return rel.contains(i) && rel.at(i).contains(j);
-  };
-
-  auto set = [&](HashRelation<int64_t>* rel, int64_t i, int64_t j, bool value) {
-    if (value) {
-      (*rel)[i].insert(j);
-    } else {
-      (*rel)[i].erase(j);
-    }
-  };
-
-  HashRelation<int64_t> lag;
+  DenseRelation dense(n, InlineBitmap(n));
   for (const auto& [node, children] : relation) {
+    InlineBitmap& row = dense[node_to_index.at(node)];
     for (const auto& child : children) {
-      set(&lag, node_to_index.at(node), node_to_index.at(child), true);
-    }
-  }
-  HashRelation<int64_t> closure = lag;
-  for (int64_t k = 0; k < n; ++k) {
-    for (int64_t i = 0; i < n; ++i) {
-      for (int64_t j = 0; j < n; ++j) {
-        set(&closure, i, j,
-            get(lag, i, j) || (get(lag, i, k) && get(lag, k, j)));
-      }
+      row.Set(node_to_index.at(child), true);
     }
-    lag = closure;
   }
 
+  TransitiveClosure(&dense);
+
   Rel result;
-  for (const auto& [node_index, children_indices] : closure) {
-    for (const auto& child_index : children_indices) {
-      result[ordered_nodes[node_index]].insert(ordered_nodes[child_index]);
+  for (int64_t i = 0; i < n; ++i) {
+    const InlineBitmap& row = dense[i];
+    if (row.IsAllZeroes()) {
+      continue;
+    }
+    absl::flat_hash_set<V>& children = result[ordered_nodes[i]];
+    for (std::optional<int64_t> j = row.FindFirstSetBit(); j.has_value();
+         j = row.FindNextSetBit(*j + 1)) {
+      children.insert(ordered_nodes[*j]);
     }
   }
 
@@ -0,0 +1,117 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmark comparing the hash-based and dense-bitmap transitive closure
+// representations on randomly generated sparse relations like the mutual
+// exclusion and token dependency relations the passes build:
+//
+//   bazel run -c opt //xls/data_structures:transitive_closure_benchmark_main
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "xls/common/init_xls.h"
+#include "xls/data_structures/inline_bitmap.h"
+#include "xls/data_structures/transitive_closure.h"
+
+namespace xls {
+namespace {
+
+// Constructs a random relation over n nodes where each node relates to
+// `edges_per_node` random nodes with larger indices (so the relation is
+// acyclic, matching how the passes use it).
+HashRelation<int64_t> MakeRandomRelation(int64_t n, int64_t edges_per_node,
+                                         std::minstd_rand* rng) {
+  HashRelation<int64_t> relation;
+  for (int64_t i = 0; i + 1 < n; ++i) {
+    std::uniform_int_distribution<int64_t> child_dis(i + 1, n - 1);
+    for (int64_t j = 0; j < edges_per_node; ++j) {
+      relation[i].insert(child_dis(*rng));
+    }
+  }
+  return relation;
+}
+
+DenseRelation ToDense(const HashRelation<int64_t>& relation, int64_t n) {
+  DenseRelation dense(n, InlineBitmap(n));
+  for (const auto& [node, children] : relation) {
+    for (int64_t child : children) {
+      dense[node].Set(child, true);
+    }
+  }
+  return dense;
+}
+
+template <typename F>
+absl::Duration TimeIterations(const F& f) {
+  // Calibration pass to pick an iteration count of roughly 100ms.
+  int64_t iterations = 1;
+  absl::Time start = absl::Now();
+  f();
+  absl::Duration calibration = absl::Now() - start;
+  iterations = std::max(
+      int64_t{1}, static_cast<int64_t>(absl::Milliseconds(100) / calibration));
+
+  start = absl::Now();
+  for (int64_t i = 0; i < iterations; ++i) {
+    f();
+  }
+  return (absl::Now() - start) / iterations;
+}
+
+void RunBenchmark(int64_t n, int64_t edges_per_node) {
+  std::minstd_rand rng;
+  HashRelation<int64_t> relation = MakeRandomRelation(n, edges_per_node, &rng);
+  DenseRelation dense = ToDense(relation, n);
+
+  absl::Duration dense_time = TimeIterations([&]() {
+    DenseRelation copy = dense;
+    TransitiveClosure(&copy);
+  });
+  std::cout << absl::StreamFormat("%6d nodes x %2d edges: dense  %s/closure\n",
+                                  n, edges_per_node,
+                                  absl::FormatDuration(dense_time));
+
+  // The hash representation is impractical above a few thousand nodes.
+  if (n <= 2048) {
+    absl::Duration hash_time = TimeIterations(
+        [&]() { internal::HashTransitiveClosure(relation); });
+    std::cout << absl::StreamFormat(
+        "%6d nodes x %2d edges: hashed %s/closure\n", n, edges_per_node,
+        absl::FormatDuration(hash_time));
+  }
+}
+
+void RealMain() {
+  for (int64_t n : {256, 1024, 2048, 8192, 32768}) {
+    for (int64_t edges_per_node : {2, 8}) {
+      RunBenchmark(n, edges_per_node);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace xls
+
+int main(int argc, char** argv) {
+  xls::InitXls(argv[0], argc, argv);
+  xls::RealMain();
+  return 0;
+}
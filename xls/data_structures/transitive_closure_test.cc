@@ -14,10 +14,14 @@
 
 #include "xls/data_structures/transitive_closure.h"
 
+#include <cstdint>
+#include <random>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "xls/data_structures/inline_bitmap.h"
 
 namespace xls {
 namespace {
@@ -41,5 +45,44 @@ TEST(TransitiveClosureTest, Simple) {
   EXPECT_FALSE(tc.contains("qux"));
 }
 
+TEST(TransitiveClosureTest, DenseSimple) {
+  DenseRelation rel(5, InlineBitmap(5));
+  rel[0].Set(1, true);  // foo -> bar
+  rel[1].Set(2, true);  // bar -> baz
+  rel[1].Set(3, true);  // bar -> qux
+  rel[2].Set(3, true);  // baz -> qux
+  rel[4].Set(2, true);  // foo2 -> baz
+  TransitiveClosure(&rel);
+  EXPECT_EQ(rel[0], InlineBitmap::FromWord(0b01110, 5));
+  EXPECT_EQ(rel[1], InlineBitmap::FromWord(0b01100, 5));
+  EXPECT_EQ(rel[2], InlineBitmap::FromWord(0b01000, 5));
+  EXPECT_TRUE(rel[3].IsAllZeroes());
+  EXPECT_EQ(rel[4], InlineBitmap::FromWord(0b01100, 5));
+}
+
+// Checks that the dense path (chosen automatically above the size threshold)
+// computes the same closure as the hash-based reference on a random relation
+// spanning several 64-bit pivot blocks.
+TEST(TransitiveClosureTest, DenseMatchesHashedOnRandomRelation) {
+  std::minstd_rand rng;
+  std::uniform_int_distribution<int64_t> node_dis(0, 199);
+  HashRelation<int64_t> rel;
+  for (int64_t i = 0; i < 500; ++i) {
+    rel[node_dis(rng)].insert(node_dis(rng));
+  }
+  EXPECT_EQ(TransitiveClosure(rel), internal::HashTransitiveClosure(rel));
+}
+
+TEST(TransitiveClosureTest, DenseCycle) {
+  DenseRelation rel(70, InlineBitmap(70));
+  for (int64_t i = 0; i < 70; ++i) {
+    rel[i].Set((i + 1) % 70, true);
+  }
+  TransitiveClosure(&rel);
+  for (int64_t i = 0; i < 70; ++i) {
+    EXPECT_TRUE(rel[i].IsAllOnes());
+  }
+}
+
 }  // namespace
 }  // namespace xls
@@ -115,6 +115,15 @@ class UnionFindMap {
     return true;
   }
 
+  // Pre-sizes the internal tables to hold `capacity` keys, so that a bulk
+  // load of known size does not trigger incremental rehashing.
+  void Reserve(int64_t capacity) {
+    key_to_index_.reserve(capacity);
+    keys_.reserve(capacity);
+    values_.reserve(capacity);
+    nodes_.reserve(capacity);
+  }
+
   // Returns true if the given key was ever inserted.
   bool Contains(const K& key) const { return key_to_index_.contains(key); }
 
@@ -14,83 +14,192 @@
 
 #include "xls/delay_model/analyze_critical_path.h"
 
+#include <algorithm>
+#include <deque>
+#include <memory>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/memory/memory.h"
 #include "absl/status/statusor.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/delay_model/delay_estimator.h"
 #include "xls/ir/function.h"
 #include "xls/ir/node_iterator.h"
 #include "xls/ir/proc.h"
 
 namespace xls {
+namespace {
+
+// Minimum number of nodes in a level of the graph for which path delays are
+// computed with worker threads rather than inline. Below this the work per
+// node is too small to cover the cost of spawning threads.
+constexpr int64_t kMinNodesPerWorker = 64;
+
+}  // namespace
 
 absl::StatusOr<std::vector<CriticalPathEntry>> AnalyzeCriticalPath(
     FunctionBase* f, std::optional<int64_t> clock_period_ps,
     const DelayEstimator& delay_estimator) {
-  struct NodeEntry {
-    Node* node;
-
-    // Delay of the node.
-    int64_t node_delay;
-
-    // The delay of the critical path in the graph up to and including this node
-    // (includes this node's delay).
-    int64_t critical_path_delay;
-
-    // The predecessor on the critical path through this node.
-    std::optional<Node*> critical_path_predecessor;
-
-    // Whether this node was delayed by a cycle boundary.
-    bool delayed_by_cycle_boundary;
-  };
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<CriticalPathAnalysis> analysis,
+      CriticalPathAnalysis::Run(f, clock_period_ps, delay_estimator));
+  return analysis->CriticalPath();
+}
 
-  // Map from each node to it's corresponding entry.
-  absl::flat_hash_map<Node*, NodeEntry> node_entries;
+void CriticalPathAnalysis::ComputePathDelay(Node* node) {
+  NodeEntry& entry = node_entries_.at(node);
+
+  // The maximum delay from any path up to but not including `node`.
+  int64_t max_path_delay = 0;
+  entry.critical_path_predecessor = std::nullopt;
+  for (Node* operand : node->operands()) {
+    int64_t operand_path_delay =
+        node_entries_.at(operand).critical_path_delay;
+    if (operand_path_delay >= max_path_delay) {
+      max_path_delay = operand_path_delay;
+      entry.critical_path_predecessor = operand;
+    }
+  }
 
-  // The node with the greatest critical path delay.
-  std::optional<NodeEntry> latest_entry;
+  // If the dependency straddles a clock boundary we have to make our delay
+  // start from the clock time.
+  entry.delayed_by_cycle_boundary = false;
+  if (clock_period_ps_.has_value() &&
+      (((max_path_delay + entry.node_delay) / clock_period_ps_.value()) >
+       (max_path_delay / clock_period_ps_.value()))) {
+    int64_t new_max_path_delay = RoundDownToNearest(
+        max_path_delay + entry.node_delay, clock_period_ps_.value());
+    XLS_CHECK_GT(new_max_path_delay, max_path_delay);
+    max_path_delay = new_max_path_delay;
+    entry.delayed_by_cycle_boundary = true;
+  }
+  entry.critical_path_delay = max_path_delay + entry.node_delay;
+}
 
-  for (Node* node : TopoSort(f)) {
-    NodeEntry& entry = node_entries[node];
+/* static */ absl::StatusOr<std::unique_ptr<CriticalPathAnalysis>>
+CriticalPathAnalysis::Run(FunctionBase* f,
+                          std::optional<int64_t> clock_period_ps,
+                          const DelayEstimator& delay_estimator,
+                          int64_t worker_count) {
+  XLS_RET_CHECK_GE(worker_count, 1);
+  auto analysis = absl::WrapUnique(
+      new CriticalPathAnalysis(clock_period_ps, delay_estimator));
+  analysis->topo_sort_ = TopoSort(f).AsVector();
+
+  // Query all node delays in one batch so the estimator can amortize model
+  // evaluation across the whole function.
+  XLS_ASSIGN_OR_RETURN(
+      std::vector<int64_t> node_delays,
+      delay_estimator.GetOperationDelaysInPs(analysis->topo_sort_));
+
+  // Populate all entries up front and group the nodes by depth. Nodes at the
+  // same depth cannot depend on each other so their path delays can be
+  // computed in any order (or concurrently) once all shallower levels are
+  // done. Creating the entries here also means the worker threads below
+  // never mutate the map itself, only values within it.
+  absl::flat_hash_map<Node*, int64_t> level;
+  std::vector<std::vector<Node*>> levels;
+  for (int64_t i = 0; i < static_cast<int64_t>(analysis->topo_sort_.size());
+       ++i) {
+    Node* node = analysis->topo_sort_[i];
+    NodeEntry& entry = analysis->node_entries_[node];
     entry.node = node;
-
-    // The maximum delay from any path up to but not including `node`.
-    int64_t max_path_delay = 0;
+    entry.node_delay = node_delays[i];
+    int64_t node_level = 0;
     for (Node* operand : node->operands()) {
-      int64_t operand_path_delay = node_entries.at(operand).critical_path_delay;
-      if (operand_path_delay >= max_path_delay) {
-        max_path_delay = node_entries.at(operand).critical_path_delay;
-        entry.critical_path_predecessor = operand;
+      node_level = std::max(node_level, level.at(operand) + 1);
+    }
+    level[node] = node_level;
+    if (node_level == static_cast<int64_t>(levels.size())) {
+      levels.push_back({});
+    }
+    levels[node_level].push_back(node);
+  }
+
+  for (const std::vector<Node*>& level_nodes : levels) {
+    int64_t workers_this_level =
+        std::min(worker_count,
+                 static_cast<int64_t>(level_nodes.size()) / kMinNodesPerWorker);
+    if (workers_this_level < 2) {
+      for (Node* node : level_nodes) {
+        analysis->ComputePathDelay(node);
       }
+      continue;
+    }
+    // Statically partition the level into contiguous chunks, one per worker.
+    std::vector<std::unique_ptr<Thread>> workers;
+    for (int64_t w = 0; w < workers_this_level; ++w) {
+      int64_t begin = level_nodes.size() * w / workers_this_level;
+      int64_t end = level_nodes.size() * (w + 1) / workers_this_level;
+      workers.push_back(std::make_unique<Thread>([&, begin, end]() {
+        for (int64_t i = begin; i < end; ++i) {
+          analysis->ComputePathDelay(level_nodes[i]);
+        }
+      }));
     }
-    XLS_ASSIGN_OR_RETURN(entry.node_delay,
-                         delay_estimator.GetOperationDelayInPs(node));
-
-    // If the dependency straddles a clock boundary we have to make our delay
-    // start from the clock time.
-    entry.delayed_by_cycle_boundary = false;
-    if (clock_period_ps.has_value() &&
-        (((max_path_delay + entry.node_delay) / clock_period_ps.value()) >
-         (max_path_delay / clock_period_ps.value()))) {
-      int64_t new_max_path_delay = RoundDownToNearest(
-          max_path_delay + entry.node_delay, clock_period_ps.value());
-      XLS_CHECK_GT(new_max_path_delay, max_path_delay);
-      max_path_delay = new_max_path_delay;
-      entry.delayed_by_cycle_boundary = true;
+    for (std::unique_ptr<Thread>& worker : workers) {
+      worker->Join();
     }
-    entry.critical_path_delay = max_path_delay + entry.node_delay;
+  }
+
+  return std::move(analysis);
+}
 
-    if (!latest_entry.has_value() ||
+absl::Status CriticalPathAnalysis::UpdateAfterChange(Node* node) {
+  if (!node_entries_.contains(node)) {
+    // A newly created node. Its operands must already be part of the
+    // analysis; appending it keeps topo_sort_ topologically ordered.
+    topo_sort_.push_back(node);
+    node_entries_[node].node = node;
+  }
+  // The delay of the node itself may have changed (e.g. if its operands were
+  // replaced with ones of different widths); delays of downstream nodes are
+  // unaffected by construction of the delay models.
+  XLS_ASSIGN_OR_RETURN(node_entries_.at(node).node_delay,
+                       delay_estimator_.GetOperationDelayInPs(node));
+
+  // Propagate path delays through the cone rooted at the node, stopping
+  // wherever the path delay is unchanged.
+  std::deque<Node*> worklist = {node};
+  absl::flat_hash_set<Node*> in_worklist = {node};
+  while (!worklist.empty()) {
+    Node* n = worklist.front();
+    worklist.pop_front();
+    in_worklist.erase(n);
+    int64_t orig_path_delay = node_entries_.at(n).critical_path_delay;
+    ComputePathDelay(n);
+    if (n != node &&
+        node_entries_.at(n).critical_path_delay == orig_path_delay) {
+      continue;
+    }
+    for (Node* user : n->users()) {
+      if (in_worklist.insert(user).second) {
+        worklist.push_back(user);
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::vector<CriticalPathEntry>>
+CriticalPathAnalysis::CriticalPath() const {
+  // The node with the greatest critical path delay.
+  const NodeEntry* latest_entry = nullptr;
+  for (Node* node : topo_sort_) {
+    const NodeEntry& entry = node_entries_.at(node);
+    if (latest_entry == nullptr ||
         latest_entry->critical_path_delay <= entry.critical_path_delay) {
-      latest_entry = entry;
+      latest_entry = &entry;
     }
   }
 
-  // Starting with the operation with the longest pat hdelay, walk back up its
+  // Starting with the operation with the longest path delay, walk back up its
   // critical path constructing CriticalPathEntry's as we go.
   std::vector<CriticalPathEntry> critical_path;
-  XLS_RET_CHECK(latest_entry.has_value());
-  NodeEntry* entry = &(latest_entry.value());
+  XLS_RET_CHECK(latest_entry != nullptr);
+  const NodeEntry* entry = latest_entry;
   while (true) {
     critical_path.push_back(CriticalPathEntry{
         .node = entry->node,
@@ -100,7 +209,7 @@ absl::StatusOr<std::vector<CriticalPathEntry>> AnalyzeCriticalPath(
     if (!entry->critical_path_predecessor.has_value()) {
       break;
     }
-    entry = &node_entries.at(entry->critical_path_predecessor.value());
+    entry = &node_entries_.at(entry->critical_path_predecessor.value());
   }
 
   return std::move(critical_path);
@@ -16,8 +16,10 @@
 #define XLS_DELAY_MODEL_ANALYZE_CRITICAL_PATH_H_
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
 #include "xls/delay_model/delay_estimator.h"
 #include "xls/ir/function_base.h"
@@ -57,6 +59,72 @@ absl::StatusOr<std::vector<CriticalPathEntry>> AnalyzeCriticalPath(
     FunctionBase* f, std::optional<int64_t> clock_period_ps,
     const DelayEstimator& delay_estimator);
 
+// A critical-path analysis which can be kept alive across IR edits and
+// re-queried without paying for a full longest-path computation each time.
+// AnalyzeCriticalPath() is a thin wrapper around this class.
+class CriticalPathAnalysis {
+ public:
+  // Runs the analysis over `f`. With `worker_count` greater than one, nodes
+  // at the same depth in the graph (which cannot depend on each other) have
+  // their path delays computed in parallel; this pays off on functions with
+  // wide levels and is a wash on narrow ones. `f`, `delay_estimator` and the
+  // nodes of `f` must outlive the returned object.
+  static absl::StatusOr<std::unique_ptr<CriticalPathAnalysis>> Run(
+      FunctionBase* f, std::optional<int64_t> clock_period_ps,
+      const DelayEstimator& delay_estimator, int64_t worker_count = 1);
+
+  // Updates the analysis after a localized edit to the IR. Re-queries the
+  // delay of `node` (which may be a newly added node) and propagates updated
+  // path delays through the nodes downstream of it; nodes outside that cone
+  // are not touched.
+  absl::Status UpdateAfterChange(Node* node);
+
+  // Returns the critical path in the same form as AnalyzeCriticalPath().
+  absl::StatusOr<std::vector<CriticalPathEntry>> CriticalPath() const;
+
+  // Returns the delay of the critical path through `node`, including the
+  // delay of `node` itself.
+  int64_t PathDelayThrough(Node* node) const {
+    return node_entries_.at(node).critical_path_delay;
+  }
+
+ private:
+  // Per-node analysis state.
+  struct NodeEntry {
+    Node* node;
+
+    // Delay of the node.
+    int64_t node_delay;
+
+    // The delay of the critical path in the graph up to and including this
+    // node (includes this node's delay).
+    int64_t critical_path_delay;
+
+    // The predecessor on the critical path through this node.
+    std::optional<Node*> critical_path_predecessor;
+
+    // Whether this node was delayed by a cycle boundary.
+    bool delayed_by_cycle_boundary;
+  };
+
+  CriticalPathAnalysis(std::optional<int64_t> clock_period_ps,
+                       const DelayEstimator& delay_estimator)
+      : clock_period_ps_(clock_period_ps), delay_estimator_(delay_estimator) {}
+
+  // Recomputes the path delay of the given node from the entries of its
+  // operands. The node delay of the entry must already be set.
+  void ComputePathDelay(Node* node);
+
+  std::optional<int64_t> clock_period_ps_;
+  const DelayEstimator& delay_estimator_;
+
+  // Nodes in the topological order used by the initial computation. Nodes
+  // added later by UpdateAfterChange are appended.
+  std::vector<Node*> topo_sort_;
+
+  absl::flat_hash_map<Node*, NodeEntry> node_entries_;
+};
+
 // Returns a string representation of the critical-path. Includes delay
 // information for each node as well as cumulative delay. Example output:
 //
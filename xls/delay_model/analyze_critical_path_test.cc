@@ -14,6 +14,9 @@
 
 #include "xls/delay_model/analyze_critical_path.h"
 
+#include <memory>
+#include <vector>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
@@ -25,7 +28,9 @@
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_test_base.h"
 #include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
 #include "xls/ir/package.h"
+#include "xls/ir/source_location.h"
 #include "xls/ir/type.h"
 
 namespace xls {
@@ -123,6 +128,98 @@ TEST_F(AnalyzeCriticalPathTest, ProcWithState) {
   EXPECT_EQ(cp[2].path_delay_ps, 0);
 }
 
+TEST_F(AnalyzeCriticalPathTest, IncrementalUpdateMatchesFreshAnalysis) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  auto x = fb.Param("x", p->GetBitsType(32));
+  auto y = fb.Param("y", p->GetBitsType(32));
+  auto neg_x = fb.Negate(x);
+  auto rev_neg_x = fb.Reverse(neg_x);
+  auto neg_y = fb.Negate(y);
+  auto sum = fb.Add(rev_neg_x, neg_y);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CriticalPathAnalysis> analysis,
+      CriticalPathAnalysis::Run(f, /*clock_period_ps=*/absl::nullopt,
+                                *delay_estimator_));
+  EXPECT_EQ(analysis->PathDelayThrough(sum.node()), 3);
+
+  // Shorten the critical path by making the sum read neg_x directly instead
+  // of through the reverse, then propagate the change from the sum.
+  XLS_ASSERT_OK(sum.node()->ReplaceOperandNumber(0, neg_x.node()));
+  XLS_ASSERT_OK(analysis->UpdateAfterChange(sum.node()));
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<CriticalPathEntry> cp,
+                           analysis->CriticalPath());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<CriticalPathEntry> fresh_cp,
+      AnalyzeCriticalPath(f, /*clock_period_ps=*/absl::nullopt,
+                          *delay_estimator_));
+  ASSERT_EQ(cp.size(), fresh_cp.size());
+  for (int64_t i = 0; i < static_cast<int64_t>(cp.size()); ++i) {
+    EXPECT_EQ(cp[i].node, fresh_cp[i].node);
+    EXPECT_EQ(cp[i].path_delay_ps, fresh_cp[i].path_delay_ps);
+  }
+  EXPECT_EQ(analysis->PathDelayThrough(sum.node()), 2);
+}
+
+TEST_F(AnalyzeCriticalPathTest, IncrementalUpdateWithNewNode) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  auto x = fb.Param("x", p->GetBitsType(32));
+  auto neg = fb.Negate(x);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CriticalPathAnalysis> analysis,
+      CriticalPathAnalysis::Run(f, /*clock_period_ps=*/absl::nullopt,
+                                *delay_estimator_));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Node * rev, f->MakeNode<UnOp>(SourceInfo(), neg.node(), Op::kReverse));
+  XLS_ASSERT_OK(analysis->UpdateAfterChange(rev));
+  EXPECT_EQ(analysis->PathDelayThrough(rev), 2);
+}
+
+TEST_F(AnalyzeCriticalPathTest, ParallelAnalysisMatchesSerial) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  auto x = fb.Param("x", p->GetBitsType(32));
+  // A wide level of independent negates followed by a reduction tree so
+  // multiple workers are actually used.
+  std::vector<BValue> layer;
+  for (int64_t i = 0; i < 256; ++i) {
+    layer.push_back(fb.Negate(x));
+  }
+  while (layer.size() > 1) {
+    std::vector<BValue> next_layer;
+    for (int64_t i = 0; i < static_cast<int64_t>(layer.size()); i += 2) {
+      next_layer.push_back(fb.Add(layer[i], layer[i + 1]));
+    }
+    layer = std::move(next_layer);
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f,
+                           fb.BuildWithReturnValue(layer.front()));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<CriticalPathEntry> serial_cp,
+      AnalyzeCriticalPath(f, /*clock_period_ps=*/absl::nullopt,
+                          *delay_estimator_));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CriticalPathAnalysis> analysis,
+      CriticalPathAnalysis::Run(f, /*clock_period_ps=*/absl::nullopt,
+                                *delay_estimator_, /*worker_count=*/4));
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<CriticalPathEntry> parallel_cp,
+                           analysis->CriticalPath());
+
+  ASSERT_EQ(serial_cp.size(), parallel_cp.size());
+  for (int64_t i = 0; i < static_cast<int64_t>(serial_cp.size()); ++i) {
+    EXPECT_EQ(serial_cp[i].node, parallel_cp[i].node);
+    EXPECT_EQ(serial_cp[i].path_delay_ps, parallel_cp[i].path_delay_ps);
+  }
+}
+
 TEST_F(AnalyzeCriticalPathTest, ProcWithSendReceive) {
   auto p = CreatePackage();
   Type* u32 = p->GetBitsType(32);
@@ -24,6 +24,55 @@
 
 namespace xls {
 
+absl::StatusOr<std::vector<int64_t>> DelayEstimator::GetOperationDelaysInPs(
+    absl::Span<Node* const> nodes) const {
+  std::vector<int64_t> delays;
+  delays.reserve(nodes.size());
+  for (Node* node : nodes) {
+    XLS_ASSIGN_OR_RETURN(int64_t delay, GetOperationDelayInPs(node));
+    delays.push_back(delay);
+  }
+  return delays;
+}
+
+absl::StatusOr<int64_t> CachingDelayEstimator::GetOperationDelayInPs(
+    Node* node) const {
+  auto it = cache_.find(node);
+  if (it != cache_.end()) {
+    return it->second;
+  }
+  XLS_ASSIGN_OR_RETURN(int64_t delay, wrapped_.GetOperationDelayInPs(node));
+  cache_[node] = delay;
+  return delay;
+}
+
+absl::StatusOr<std::vector<int64_t>>
+CachingDelayEstimator::GetOperationDelaysInPs(
+    absl::Span<Node* const> nodes) const {
+  // Batch-query the wrapped estimator for the nodes missing from the cache so
+  // it can amortize model evaluation over them, then serve everything from
+  // the cache.
+  std::vector<Node*> misses;
+  for (Node* node : nodes) {
+    if (!cache_.contains(node)) {
+      misses.push_back(node);
+    }
+  }
+  if (!misses.empty()) {
+    XLS_ASSIGN_OR_RETURN(std::vector<int64_t> delays,
+                         wrapped_.GetOperationDelaysInPs(misses));
+    for (int64_t i = 0; i < static_cast<int64_t>(misses.size()); ++i) {
+      cache_[misses[i]] = delays[i];
+    }
+  }
+  std::vector<int64_t> result;
+  result.reserve(nodes.size());
+  for (Node* node : nodes) {
+    result.push_back(cache_.at(node));
+  }
+  return result;
+}
+
 DelayEstimatorManager& GetDelayEstimatorManagerSingleton() {
   static DelayEstimatorManager* manager = new DelayEstimatorManager;
   return *manager;
@@ -36,6 +36,13 @@ class DelayEstimator {
   // Returns the estimated delay of the given node in picoseconds.
   virtual absl::StatusOr<int64_t> GetOperationDelayInPs(Node* node) const = 0;
 
+  // Returns the estimated delays of the given nodes in picoseconds, in the
+  // same order as `nodes`. The default implementation simply queries each
+  // node individually; estimators whose models have per-query overhead can
+  // override this to amortize evaluation over the whole batch.
+  virtual absl::StatusOr<std::vector<int64_t>> GetOperationDelaysInPs(
+      absl::Span<Node* const> nodes) const;
+
   // Compute the delay of the given node using logical effort estimation. Only
   // relatively simple operations (kAnd, kOr, etc) are supported using this
   // method.
@@ -46,6 +53,31 @@ class DelayEstimator {
   std::string name_;
 };
 
+// A delay estimator which wraps another estimator and caches its results by
+// node. Scheduling and critical path analysis query the same nodes many times
+// and the underlying models can be expensive (virtual dispatch plus
+// regression math per query). Use one cache per FunctionBase. Entries are
+// keyed by node pointer, so a cached node must be forgotten if its operands
+// change (delay estimates depend on operand widths) or if it is deleted.
+class CachingDelayEstimator : public DelayEstimator {
+ public:
+  // `wrapped` must outlive this object.
+  CachingDelayEstimator(absl::string_view name, const DelayEstimator& wrapped)
+      : DelayEstimator(name), wrapped_(wrapped) {}
+
+  absl::StatusOr<int64_t> GetOperationDelayInPs(Node* node) const override;
+  absl::StatusOr<std::vector<int64_t>> GetOperationDelaysInPs(
+      absl::Span<Node* const> nodes) const override;
+
+  // Removes any cached delay for the given node. Must be called when the
+  // operands of the node change or before the node is deleted.
+  void ForgetNode(Node* node) { cache_.erase(node); }
+
+ private:
+  const DelayEstimator& wrapped_;
+  mutable absl::flat_hash_map<Node*, int64_t> cache_;
+};
+
 enum class DelayEstimatorPrecedence {
   kLow = 1,
   kMedium = 2,
@@ -104,5 +104,60 @@ TEST_F(DelayEstimatorTest, LogicalEffortForXors) {
   }
 }
 
+// A test delay estimator which counts how many times it is queried.
+class CountingDelayEstimator : public DelayEstimator {
+ public:
+  CountingDelayEstimator() : DelayEstimator("counting") {}
+
+  absl::StatusOr<int64_t> GetOperationDelayInPs(Node* node) const override {
+    ++query_count_;
+    return 1;
+  }
+
+  int64_t query_count() const { return query_count_; }
+
+ private:
+  mutable int64_t query_count_ = 0;
+};
+
+TEST_F(DelayEstimatorTest, BatchedDelayQuery) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(8));
+  BValue not_x = fb.Not(x);
+  XLS_ASSERT_OK(fb.BuildWithReturnValue(not_x).status());
+
+  TestDelayEstimator estimator(42, "forty_two");
+  EXPECT_THAT(estimator.GetOperationDelaysInPs({x.node(), not_x.node()}),
+              IsOkAndHolds(ElementsAre(42, 42)));
+}
+
+TEST_F(DelayEstimatorTest, CachingDelayEstimator) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(8));
+  BValue not_x = fb.Not(x);
+  XLS_ASSERT_OK(fb.BuildWithReturnValue(not_x).status());
+
+  CountingDelayEstimator counting;
+  CachingDelayEstimator caching("counting_cached", counting);
+
+  // Repeated queries of the same node should only hit the wrapped estimator
+  // once.
+  EXPECT_THAT(caching.GetOperationDelayInPs(x.node()), IsOkAndHolds(1));
+  EXPECT_THAT(caching.GetOperationDelayInPs(x.node()), IsOkAndHolds(1));
+  EXPECT_EQ(counting.query_count(), 1);
+
+  // A batched query should only query the wrapped estimator for cache misses.
+  EXPECT_THAT(caching.GetOperationDelaysInPs({x.node(), not_x.node()}),
+              IsOkAndHolds(ElementsAre(1, 1)));
+  EXPECT_EQ(counting.query_count(), 2);
+
+  // Forgetting a node causes it to be re-queried.
+  caching.ForgetNode(x.node());
+  EXPECT_THAT(caching.GetOperationDelayInPs(x.node()), IsOkAndHolds(1));
+  EXPECT_EQ(counting.query_count(), 3);
+}
+
 }  // namespace
 }  // namespace xls
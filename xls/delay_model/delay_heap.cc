@@ -37,7 +37,9 @@ DelayHeap::PathLength DelayHeap::MaxAmongPredecessors(Node* node) const {
 }
 
 absl::Status DelayHeap::Add(Node* node) {
-  XLS_CHECK(!contains(node));
+  // A lazily removed node may not be re-added until it has been compacted
+  // away, so check against the underlying map rather than contains().
+  XLS_CHECK(!path_lengths_.contains(node));
   XLS_DCHECK(!std::any_of(successors(node).begin(), successors(node).end(),
                           [&](Node* n) { return contains(n); }));
   XLS_ASSIGN_OR_RETURN(int64_t node_delay,
@@ -60,7 +62,81 @@ absl::Status DelayHeap::Add(Node* node) {
   return absl::OkStatus();
 }
 
+absl::Status DelayHeap::AddNodes(absl::Span<Node* const> nodes) {
+  // First pass: compute path lengths for every node. Because the nodes are in
+  // topological order each node's predecessors within the span have already
+  // been entered by the time the node is processed.
+  for (Node* node : nodes) {
+    XLS_CHECK(!path_lengths_.contains(node));
+    XLS_ASSIGN_OR_RETURN(int64_t node_delay,
+                         delay_estimator_.GetOperationDelayInPs(node));
+    PathLength path = MaxAmongPredecessors(node);
+    path_lengths_[node] = {path.critical_path_delay + node_delay,
+                           path.longest_path + 1};
+  }
+
+  // Second pass: rebuild the frontier. Unlike repeated calls to Add, a node
+  // covered by a later node in the span is never inserted into the frontier
+  // set in the first place.
+  for (Node* node : nodes) {
+    for (Node* p : predecessors(node)) {
+      if (contains(p)) {
+        auto it = frontier_.find(p);
+        if (it != frontier_.end()) {
+          frontier_.erase(it);
+        }
+      }
+    }
+    if (!std::any_of(successors(node).begin(), successors(node).end(),
+                     [&](Node* n) { return contains(n); })) {
+      frontier_.insert(node);
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status DelayHeap::RemoveLazily(Node* node) {
+  XLS_CHECK(contains(node));
+  XLS_DCHECK(!std::any_of(successors(node).begin(), successors(node).end(),
+                          [&](Node* n) { return contains(n); }));
+  tombstones_.insert(node);
+  // Compact when the tombstones reach half the heap so stale path lengths and
+  // frontier entries do not accumulate without bound.
+  if (tombstones_.size() * 2 >= path_lengths_.size()) {
+    return Compact();
+  }
+  return absl::OkStatus();
+}
+
+absl::Status DelayHeap::Compact() {
+  if (tombstones_.empty()) {
+    return absl::OkStatus();
+  }
+  std::vector<Node*> survivors;
+  survivors.reserve(path_lengths_.size() - tombstones_.size());
+  for (const auto& pair : path_lengths_) {
+    if (!tombstones_.contains(pair.first)) {
+      survivors.push_back(pair.first);
+    }
+  }
+  // Path lengths never change after insertion, so each surviving node's
+  // longest_path is strictly greater than that of any of its surviving
+  // predecessors. Sorting by longest_path therefore restores a valid
+  // insertion (topological) order. Node id breaks ties for determinism.
+  std::sort(survivors.begin(), survivors.end(), [&](Node* a, Node* b) {
+    const PathLength& pa = path_lengths_.at(a);
+    const PathLength& pb = path_lengths_.at(b);
+    return pa.longest_path < pb.longest_path ||
+           (pa.longest_path == pb.longest_path && a->id() < b->id());
+  });
+  frontier_.clear();
+  path_lengths_.clear();
+  tombstones_.clear();
+  return AddNodes(survivors);
+}
+
 DelayHeap::FrontierSet::iterator DelayHeap::Remove(Node* node) {
+  XLS_CHECK(contains(node));
   XLS_DCHECK(!std::any_of(successors(node).begin(), successors(node).end(),
                           [&](Node* n) { return contains(n); }));
   // Node must be on the frontier to be erased.
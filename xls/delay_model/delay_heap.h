@@ -18,6 +18,7 @@
 #include <set>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
@@ -100,6 +101,34 @@ class DelayHeap {
   // the heap.
   absl::Status Add(Node* node);
 
+  // Adds all of the given nodes to the data structure. The nodes must be in
+  // topological order (reverse topological order if the heap grows toward
+  // operands). Equivalent to calling Add on each node in turn but cheaper for
+  // large spans: path lengths are computed in a single pass and nodes which
+  // are covered by later nodes in the span are never inserted into the
+  // frontier set at all.
+  absl::Status AddNodes(absl::Span<Node* const> nodes);
+
+  // Lazily removes the given node from the data structure. Like Remove, the
+  // node must have no successors in the heap; unlike Remove, no frontier
+  // maintenance is performed. The node is marked as a tombstone: contains()
+  // and size() reflect the removal immediately, but frontier() and
+  // CriticalPathDelay() may conservatively include the removed node's
+  // contribution (an upper bound) until the tombstones are compacted.
+  // Compaction happens automatically when tombstones reach half the heap, or
+  // eagerly via Compact(). This makes large removal storms cheap: each lazy
+  // removal is constant time rather than logarithmic with frontier churn.
+  absl::Status RemoveLazily(Node* node);
+
+  // Compacts away any lazily removed nodes, rebuilding the path lengths and
+  // frontier set of the surviving nodes. After compaction frontier() and
+  // CriticalPathDelay() are exact again. A no-op if there are no outstanding
+  // lazy removals.
+  absl::Status Compact();
+
+  // Returns the number of lazily removed nodes awaiting compaction.
+  int64_t lazily_removed_count() const { return tombstones_.size(); }
+
   // Removes the given node to the data structure. Necessarily this node must be
   // in the frontier set of the heap. Updates the frontier set and critical-path
   // delay of the heap. Returns the iterator to the next node on the frontier.
@@ -115,8 +144,10 @@ class DelayHeap {
   //   }
   FrontierSet::iterator Remove(Node* node);
 
-  // Returns the number of nodes in the heap.
-  int64_t size() const { return path_lengths_.size(); }
+  // Returns the number of nodes in the heap. Excludes lazily removed nodes.
+  int64_t size() const {
+    return path_lengths_.size() - static_cast<int64_t>(tombstones_.size());
+  }
 
   // Returns the delay of the critical-path through the heap.
   int64_t CriticalPathDelay() const {
@@ -129,8 +160,11 @@ class DelayHeap {
     return path_lengths_.at(node).critical_path_delay;
   }
 
-  // Returns true if the given node is contained in the heap.
-  bool contains(Node* node) const { return path_lengths_.contains(node); }
+  // Returns true if the given node is contained in the heap. Lazily removed
+  // nodes are not considered contained.
+  bool contains(Node* node) const {
+    return path_lengths_.contains(node) && !tombstones_.contains(node);
+  }
 
   // Returns the critical path delay through the heap after adding the given
   // node.
@@ -210,6 +244,10 @@ class DelayHeap {
   // A map from node in the heap to the longest path length value for the node.
   absl::flat_hash_map<Node*, PathLength> path_lengths_;
 
+  // Lazily removed nodes awaiting compaction. These nodes still have entries
+  // in path_lengths_ (and possibly frontier_) until Compact() runs.
+  absl::flat_hash_set<Node*> tombstones_;
+
   // A cache containing vectors with the users of each node.
   mutable absl::flat_hash_map<Node*, std::vector<Node*>> users_vectors_;
 };
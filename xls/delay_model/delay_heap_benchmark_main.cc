@@ -0,0 +1,171 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmark for DelayHeap exercising the access patterns of the integrator's
+// area/timing-driven merging (xls/contrib/integrator/integration_algorithms):
+// building a heap over a large node set and then performing add/remove storms
+// as candidate merges are evaluated and committed. Times per-node addition
+// against bulk construction (AddNodes) and eager removal against lazy removal
+// with tombstone compaction on randomly generated layered functions:
+//
+//   bazel run -c opt //xls/delay_model:delay_heap_benchmark_main
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "xls/common/init_xls.h"
+#include "xls/common/logging/logging.h"
+#include "xls/delay_model/delay_estimator.h"
+#include "xls/delay_model/delay_estimators.h"
+#include "xls/delay_model/delay_heap.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/node_iterator.h"
+#include "xls/ir/package.h"
+
+namespace xls {
+namespace sched {
+namespace {
+
+// Builds a layered function of single-bit ands where each node in a layer
+// consumes two random nodes of the previous layer. This mirrors the wide,
+// moderately deep dataflow graphs the integrator merges.
+absl::StatusOr<Function*> MakeLayeredFunction(Package* package,
+                                              int64_t layer_count,
+                                              int64_t nodes_in_layer,
+                                              std::minstd_rand* rng) {
+  FunctionBuilder fb(
+      absl::StrFormat("layered_%d_x_%d", layer_count, nodes_in_layer), package);
+  std::uniform_int_distribution<int64_t> operand_dis(0, nodes_in_layer - 1);
+  std::vector<BValue> previous_layer;
+  for (int64_t i = 0; i < nodes_in_layer; ++i) {
+    previous_layer.push_back(fb.Param(absl::StrFormat("p%d", i),
+                                      package->GetBitsType(1)));
+  }
+  for (int64_t layer = 1; layer < layer_count; ++layer) {
+    std::vector<BValue> this_layer;
+    for (int64_t i = 0; i < nodes_in_layer; ++i) {
+      this_layer.push_back(fb.And(previous_layer[operand_dis(*rng)],
+                                  previous_layer[operand_dis(*rng)]));
+    }
+    previous_layer = std::move(this_layer);
+  }
+  return fb.Build();
+}
+
+// Adds every node of 'f' to a fresh heap one at a time.
+absl::Duration TimeSequentialAdd(FunctionBase* f,
+                                 const DelayEstimator& delay_estimator) {
+  DelayHeap heap(Direction::kGrowsTowardUsers, delay_estimator);
+  absl::Time start = absl::Now();
+  for (Node* node : TopoSort(f)) {
+    XLS_CHECK_OK(heap.Add(node));
+  }
+  return absl::Now() - start;
+}
+
+// Adds every node of 'f' to a fresh heap with a single bulk construction.
+absl::Duration TimeBulkAdd(FunctionBase* f,
+                           const DelayEstimator& delay_estimator) {
+  DelayHeap heap(Direction::kGrowsTowardUsers, delay_estimator);
+  std::vector<Node*> nodes;
+  for (Node* node : TopoSort(f)) {
+    nodes.push_back(node);
+  }
+  absl::Time start = absl::Now();
+  XLS_CHECK_OK(heap.AddNodes(nodes));
+  return absl::Now() - start;
+}
+
+// Empties a full heap by repeatedly removing the frontier eagerly.
+absl::Duration TimeEagerRemoval(FunctionBase* f,
+                                const DelayEstimator& delay_estimator) {
+  DelayHeap heap(Direction::kGrowsTowardUsers, delay_estimator);
+  std::vector<Node*> nodes;
+  for (Node* node : TopoSort(f)) {
+    nodes.push_back(node);
+  }
+  XLS_CHECK_OK(heap.AddNodes(nodes));
+  absl::Time start = absl::Now();
+  auto it = heap.frontier().begin();
+  while (it != heap.frontier().end()) {
+    it = heap.Remove(*it);
+  }
+  return absl::Now() - start;
+}
+
+// Empties a full heap via lazy removal storms: each pass tombstones a
+// snapshot of the frontier, letting automatic compaction rebuild the
+// structure once enough nodes are gone.
+absl::Duration TimeLazyRemoval(FunctionBase* f,
+                               const DelayEstimator& delay_estimator) {
+  DelayHeap heap(Direction::kGrowsTowardUsers, delay_estimator);
+  std::vector<Node*> nodes;
+  for (Node* node : TopoSort(f)) {
+    nodes.push_back(node);
+  }
+  XLS_CHECK_OK(heap.AddNodes(nodes));
+  absl::Time start = absl::Now();
+  while (heap.size() > 0) {
+    std::vector<Node*> frontier_snapshot(heap.frontier().begin(),
+                                         heap.frontier().end());
+    for (Node* node : frontier_snapshot) {
+      if (heap.contains(node)) {
+        XLS_CHECK_OK(heap.RemoveLazily(node));
+      }
+    }
+    XLS_CHECK_OK(heap.Compact());
+  }
+  return absl::Now() - start;
+}
+
+void RunBenchmark(int64_t layer_count, int64_t nodes_in_layer,
+                  const DelayEstimator& delay_estimator) {
+  std::minstd_rand rng;
+  Package package("delay_heap_benchmark");
+  Function* f =
+      MakeLayeredFunction(&package, layer_count, nodes_in_layer, &rng).value();
+  std::cout << absl::StreamFormat(
+      "%5d layers x %5d nodes: add %s, bulk add %s, remove %s, lazy remove "
+      "%s\n",
+      layer_count, nodes_in_layer,
+      absl::FormatDuration(TimeSequentialAdd(f, delay_estimator)),
+      absl::FormatDuration(TimeBulkAdd(f, delay_estimator)),
+      absl::FormatDuration(TimeEagerRemoval(f, delay_estimator)),
+      absl::FormatDuration(TimeLazyRemoval(f, delay_estimator)));
+}
+
+void RealMain() {
+  const DelayEstimator* delay_estimator = GetDelayEstimator("unit").value();
+  for (int64_t layer_count : {4, 16, 64}) {
+    for (int64_t nodes_in_layer : {16, 256, 1024}) {
+      RunBenchmark(layer_count, nodes_in_layer, *delay_estimator);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace sched
+}  // namespace xls
+
+int main(int argc, char** argv) {
+  xls::InitXls(argv[0], argc, argv);
+  xls::sched::RealMain();
+  return 0;
+}
@@ -185,6 +185,86 @@ TEST_F(DelayHeapTest, BenchmarkTest) {
     EXPECT_EQ(heap.CriticalPathDelay(), 0);
   }
 }
+TEST_F(DelayHeapTest, BulkAddMatchesSequentialAdd) {
+  // Bulk construction over the full node set of a benchmark should produce
+  // exactly the same heap state as adding the nodes one at a time.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<Package> p,
+      sample_packages::GetBenchmark("examples/sha256", /*optimized=*/true));
+  std::optional<xls::FunctionBase*> top = p->GetTop();
+  ASSERT_TRUE(top.has_value());
+  xls::FunctionBase* f = top.value();
+  for (Direction direction :
+       {Direction::kGrowsTowardUsers, Direction::kGrowsTowardOperands}) {
+    std::vector<Node*> nodes;
+    for (Node* node : direction == Direction::kGrowsTowardUsers
+                          ? TopoSort(f)
+                          : ReverseTopoSort(f)) {
+      nodes.push_back(node);
+    }
+
+    DelayHeap sequential_heap(direction, *delay_estimator_);
+    for (Node* node : nodes) {
+      XLS_ASSERT_OK(sequential_heap.Add(node));
+    }
+
+    DelayHeap bulk_heap(direction, *delay_estimator_);
+    XLS_ASSERT_OK(bulk_heap.AddNodes(nodes));
+
+    XLS_ASSERT_OK(VerifyFrontier(bulk_heap));
+    EXPECT_EQ(bulk_heap.size(), sequential_heap.size());
+    EXPECT_EQ(bulk_heap.CriticalPathDelay(),
+              sequential_heap.CriticalPathDelay());
+    EXPECT_THAT(std::vector<Node*>(bulk_heap.frontier().begin(),
+                                   bulk_heap.frontier().end()),
+                ::testing::ElementsAreArray(sequential_heap.frontier().begin(),
+                                            sequential_heap.frontier().end()));
+  }
+}
+
+TEST_F(DelayHeapTest, LazyRemovalWithCompaction) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  auto x = fb.Param("x", p->GetBitsType(32));
+  auto neg = fb.Negate(x);
+  auto rev = fb.Reverse(neg);
+  XLS_ASSERT_OK(fb.Build().status());
+
+  DelayHeap heap(Direction::kGrowsTowardUsers, *delay_estimator_);
+  XLS_ASSERT_OK(heap.AddNodes({x.node(), neg.node(), rev.node()}));
+  EXPECT_EQ(heap.size(), 3);
+  EXPECT_EQ(heap.CriticalPathDelay(), 2);
+  EXPECT_THAT(heap.frontier(), ElementsAre(rev.node()));
+
+  // Lazily removing the frontier node updates contains() and size()
+  // immediately, but the critical-path delay remains a (stale) upper bound
+  // until compaction.
+  XLS_ASSERT_OK(heap.RemoveLazily(rev.node()));
+  EXPECT_FALSE(heap.contains(rev.node()));
+  EXPECT_EQ(heap.size(), 2);
+  EXPECT_EQ(heap.lazily_removed_count(), 1);
+  EXPECT_EQ(heap.CriticalPathDelay(), 2);
+
+  XLS_ASSERT_OK(heap.Compact());
+  EXPECT_EQ(heap.lazily_removed_count(), 0);
+  EXPECT_EQ(heap.size(), 2);
+  EXPECT_EQ(heap.CriticalPathDelay(), 1);
+  EXPECT_THAT(heap.frontier(), ElementsAre(neg.node()));
+
+  // One tombstone in a two-node heap reaches the automatic compaction
+  // threshold, so the removal compacts immediately.
+  XLS_ASSERT_OK(heap.RemoveLazily(neg.node()));
+  EXPECT_EQ(heap.lazily_removed_count(), 0);
+  EXPECT_EQ(heap.size(), 1);
+  EXPECT_EQ(heap.CriticalPathDelay(), 0);
+  EXPECT_THAT(heap.frontier(), ElementsAre(x.node()));
+
+  // A compacted node may be re-added.
+  XLS_ASSERT_OK(heap.Add(neg.node()));
+  EXPECT_EQ(heap.size(), 2);
+  EXPECT_EQ(heap.CriticalPathDelay(), 1);
+}
+
 }  // namespace
 }  // namespace sched
 }  // namespace xls
@@ -475,6 +475,48 @@ class RegressionEstimator(Estimator):
       terms.append('{} * std::log2({})'.format(self.params[2 * i + 2], e_str))
     return 'return std::round({});'.format(' + '.join(terms))
 
+  # Number of entries in the lookup table emitted by cpp_delay_table_code.
+  DELAY_TABLE_SIZE = 256
+
+  def cpp_delay_table_code(self, node_identifier: Text) -> Text:
+    """Returns C++ statements which serve delays from a precomputed table.
+
+    For estimators with a single delay expression the fitted curve is
+    flattened at generation time into a constexpr table indexed by the value
+    of the expression, so the common case of an estimate is an array load
+    rather than floating-point curve evaluation. Expression values outside
+    the table (or non-integral values produced by DIVIDE or POWER
+    expressions) fall through to the statements emitted by cpp_delay_code.
+    Returns the empty string for estimators with multiple delay expressions.
+
+    Args:
+      node_identifier: The string identifier of the Node* value whose delay
+        is being estimated.
+    """
+    if len(self.delay_expressions) != 1:
+      return ''
+    # std::round rounds half away from zero while Python's round() rounds
+    # half to even; use floor(x + 0.5) so the table entries match the
+    # fallback statements exactly.
+    entries = ', '.join(
+        str(int(np.floor(self.raw_delay((x,)) + 0.5)))
+        for x in range(1, RegressionEstimator.DELAY_TABLE_SIZE + 1))
+    e_str = _delay_expression_cpp_expression(self.delay_expressions[0],
+                                             node_identifier)
+    lines = [
+        'static constexpr int64_t kDelayTable[{}] = {{{}}};'.format(
+            RegressionEstimator.DELAY_TABLE_SIZE, entries),
+        'const float expression_value = {};'.format(e_str),
+        'const int64_t table_index = '
+        'static_cast<int64_t>(expression_value);',
+        'if (static_cast<float>(table_index) == expression_value &&',
+        '    table_index >= 1 && table_index <= {}) {{'.format(
+            RegressionEstimator.DELAY_TABLE_SIZE),
+        '  return kDelayTable[table_index - 1];',
+        '}',
+    ]
+    return '\n'.join(lines)
+
 
 class BoundingBoxEstimator(Estimator):
   """Bounding box estimator."""
@@ -622,6 +664,13 @@ class OpModel:
       lines.append('if (%s) {' % cond)
       lines.append(estimator.cpp_delay_code('node'))
       lines.append('}')
+    # Single-expression regression estimators are served from a table
+    # precomputed at generation time; the curve evaluation below it only
+    # handles expression values outside the table.
+    if isinstance(self.estimator, RegressionEstimator):
+      table_code = self.estimator.cpp_delay_table_code('node')
+      if table_code:
+        lines.append(table_code)
     lines.append(self.estimator.cpp_delay_code('node'))
     lines.append('}')
     return '\n'.join(lines)
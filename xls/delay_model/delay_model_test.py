@@ -18,6 +18,8 @@
 import re
 from typing import Text
 
+import numpy as np
+
 from google.protobuf import text_format
 from xls.delay_model import delay_model
 from xls.delay_model import delay_model_pb2
@@ -174,6 +176,41 @@ class DelayModelTest(absltest.TestCase):
               0.0 * std::log2(static_cast<float>(node->GetType()->GetFlatBitCount())));
         """)
 
+  def test_one_factor_regression_estimator_delay_table(self):
+    data_points_str = [
+        'operation { op: "kFoo" bit_count: 2 } delay: 210 delay_offset: 10',
+        'operation { op: "kFoo" bit_count: 4 } delay: 410 delay_offset: 10',
+        'operation { op: "kFoo" bit_count: 6 } delay: 610 delay_offset: 10',
+        'operation { op: "kFoo" bit_count: 8 } delay: 810 delay_offset: 10',
+        'operation { op: "kFoo" bit_count: 10 } delay: 1010 delay_offset: 10',
+    ]
+    result_bit_count = delay_model_pb2.DelayExpression()
+    result_bit_count.factor.source = delay_model_pb2.DelayFactor.Source.RESULT_BIT_COUNT
+    foo = delay_model.RegressionEstimator(
+        'kFoo', (result_bit_count,),
+        tuple(_parse_data_point(s) for s in data_points_str))
+    table_code = foo.cpp_delay_table_code('node')
+    match = re.search(
+        r'static constexpr int64_t kDelayTable\[256\] = \{(.*)\};', table_code)
+    self.assertIsNotNone(match)
+    entries = [int(e) for e in match.group(1).split(',')]
+    self.assertLen(entries, 256)
+    # Each table entry is the fitted curve evaluated at the expression value,
+    # rounded as std::round would round it.
+    for x in (1, 2, 5, 100, 256):
+      self.assertEqual(entries[x - 1], int(np.floor(foo.raw_delay((x,)) + 0.5)))
+    self.assertIn('return kDelayTable[table_index - 1];', table_code)
+    # The table and its guard precede the curve evaluation in the generated
+    # delay function for the op.
+    op_model = delay_model.OpModel(
+        text_format.Parse(
+            'op: "kFoo" estimator { regression { expressions { factor '
+            '{ source: RESULT_BIT_COUNT } } } }', delay_model_pb2.OpModel()),
+        tuple(_parse_data_point(s) for s in data_points_str))
+    function = op_model.cpp_delay_function()
+    self.assertLess(
+        function.find('kDelayTable'), function.find('std::round'))
+
   def test_one_regression_estimator_operand_count(self):
 
     def gen_operation(operand_count):
@@ -247,6 +284,8 @@ class DelayModelTest(absltest.TestCase):
               0.0 * static_cast<float>(node->operand(1)->GetType()->GetFlatBitCount()) +
               0.0 * std::log2(static_cast<float>(node->operand(1)->GetType()->GetFlatBitCount())));
         """)
+    # Multi-expression estimators are not flattened into a lookup table.
+    self.assertEqual(foo.cpp_delay_table_code('node'), '')
 
   def test_fixed_op_model(self):
     op_model = delay_model.OpModel(
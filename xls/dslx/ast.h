@@ -15,6 +15,8 @@
 #ifndef XLS_DSLX_AST_H_
 #define XLS_DSLX_AST_H_
 
+#include <cstddef>
+
 #include "absl/container/btree_set.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
@@ -28,6 +30,7 @@
 #include "xls/common/casts.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/dslx/ast_arena.h"
 #include "xls/dslx/pos.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/format_strings.h"
@@ -271,6 +274,18 @@ class AstNode {
   explicit AstNode(Module* owner) : owner_(owner) {}
   virtual ~AstNode() = default;
 
+  // AST nodes are created via Module::Make and placed in the arena owned by
+  // their module; their storage is reclaimed wholesale when the module is
+  // destroyed, so the non-placement operator delete is only invoked for nodes
+  // allocated with the plain operator new (notably Module itself, which is
+  // heap-allocated normally) and forwards to the global one.
+  void* operator new(std::size_t size) { return ::operator new(size); }
+  void* operator new(std::size_t size, AstArena& arena) {
+    return arena.Allocate(static_cast<int64_t>(size));
+  }
+  void operator delete(void* ptr) { ::operator delete(ptr); }
+  void operator delete(void*, AstArena&) {}
+
   virtual AstNodeKind kind() const = 0;
 
   // Retrieves the name of the leafmost-derived class, suitable for debugging;
@@ -2812,6 +2827,12 @@ class Module : public AstNode {
 
   ~Module() {
     XLS_VLOG(3) << "Destroying module \"" << name_ << "\" @ " << this;
+    // Arena-allocated nodes are destroyed explicitly (they own out-of-arena
+    // state such as strings and vectors); their storage is reclaimed en masse
+    // when `arena_` is destroyed.
+    for (auto it = nodes_.rbegin(); it != nodes_.rend(); ++it) {
+      (*it)->~AstNode();
+    }
   }
 
   AstNodeKind kind() const override { return AstNodeKind::kModule; }
@@ -2847,11 +2868,9 @@ class Module : public AstNode {
 
   template <typename T, typename... Args>
   T* Make(Args&&... args) {
-    std::unique_ptr<T> node =
-        std::make_unique<T>(this, std::forward<Args>(args)...);
-    T* ptr = node.get();
+    T* ptr = new (arena_) T(this, std::forward<Args>(args)...);
     ptr->SetParentage();
-    nodes_.push_back(std::move(node));
+    nodes_.push_back(ptr);
     return ptr;
   }
 
@@ -2952,10 +2971,10 @@ class Module : public AstNode {
   const std::string& name() const { return name_; }
 
   const AstNode* FindNode(AstNodeKind kind, const Span& span) const {
-    for (const auto& node : nodes_) {
+    for (AstNode* node : nodes_) {
       if (node->kind() == kind && node->GetSpan().has_value() &&
           node->GetSpan().value() == span) {
-        return node.get();
+        return node;
       }
     }
     return nullptr;
@@ -2990,7 +3009,10 @@ class Module : public AstNode {
 
   std::string name_;               // Name of this module.
   std::vector<ModuleMember> top_;  // Top-level members of this module.
-  std::vector<std::unique_ptr<AstNode>> nodes_;  // Lifetime-owned AST nodes.
+  // Storage for all AST nodes created via Make; must outlive `nodes_` (the
+  // destructor destroys the nodes before members are torn down).
+  AstArena arena_;
+  std::vector<AstNode*> nodes_;  // Lifetime-owned AST nodes (in `arena_`).
 
   // Map of top-level module member name to the member itself.
   absl::flat_hash_map<std::string, ModuleMember> top_by_name_;
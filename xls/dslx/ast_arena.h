@@ -0,0 +1,73 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_DSLX_AST_ARENA_H_
+#define XLS_DSLX_AST_ARENA_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace xls::dslx {
+
+// A simple bump-pointer arena out of which all AST nodes of a module are
+// allocated (see Module::Make). Parsing creates nodes back-to-back, so nodes
+// end up contiguous in memory, which avoids a heap round trip per node and
+// improves traversal locality for large (e.g. proto-derived) modules.
+//
+// The arena only ever grows; storage is reclaimed en masse when the arena (and
+// hence the owning module) is destroyed. Node destructors are still run
+// individually by ~Module, since AST nodes own out-of-arena state such as
+// strings and vectors, but the corresponding operator delete is a no-op.
+//
+// Unlike xls::NodeArena this is not thread-safe: a module is only ever built
+// up from a single thread, even when multiple modules are parsed in parallel.
+class AstArena {
+ public:
+  AstArena() = default;
+
+  // The arena hands out interior pointers, so it must not be copied or moved.
+  AstArena(const AstArena&) = delete;
+  AstArena& operator=(const AstArena&) = delete;
+
+  // Returns a pointer to `size` bytes of uninitialized storage aligned for any
+  // AstNode subclass. The storage remains valid until the arena is destroyed.
+  void* Allocate(int64_t size);
+
+  // Returns the total number of bytes reserved by the arena (including slack
+  // at the end of blocks).
+  int64_t ReservedBytes() const {
+    return static_cast<int64_t>(blocks_.size()) * kBlockSize +
+           oversized_bytes_;
+  }
+
+ private:
+  // Default size of each allocation block. Large enough that the allocation
+  // amortizes well, small enough to not waste much on tiny modules.
+  static constexpr int64_t kBlockSize = 64 * 1024;
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  // Blocks allocated for requests larger than kBlockSize. Kept separate so
+  // normal bump allocation never has to consider them.
+  std::vector<std::unique_ptr<char[]>> oversized_blocks_;
+  int64_t oversized_bytes_ = 0;
+
+  // Bump pointer and remaining capacity within the last element of `blocks_`.
+  char* next_ = nullptr;
+  int64_t remaining_ = 0;
+};
+
+}  // namespace xls::dslx
+
+#endif  // XLS_DSLX_AST_ARENA_H_
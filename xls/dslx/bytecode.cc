@@ -509,6 +509,16 @@ absl::StatusOr<InterpValue> Bytecode::value_data() const {
   return absl::get<InterpValue>(data_.value());
 }
 
+absl::StatusOr<const InterpValue*> Bytecode::value_data_ptr() const {
+  if (!data_.has_value()) {
+    return absl::InvalidArgumentError("Bytecode does not hold data.");
+  }
+  if (!absl::holds_alternative<InterpValue>(data_.value())) {
+    return absl::InvalidArgumentError("Bytecode data is not an InterpValue.");
+  }
+  return &absl::get<InterpValue>(data_.value());
+}
+
 absl::StatusOr<const ConcreteType*> Bytecode::type_data() const {
   if (!data_.has_value()) {
     return absl::InvalidArgumentError("Bytecode does not hold data.");
@@ -662,7 +672,22 @@ absl::StatusOr<std::vector<Bytecode>> BytecodesFromString(
           return absl::InvalidArgumentError(absl::StrFormat(
               "Could not parse data payload in line: `%s`", line));
         }
-        data = Bytecode::JumpTarget(integer_data);
+        // Integer payloads print identically for the strong-int data kinds, so
+        // the op determines which kind to materialize; the accessors (e.g.
+        // slot_index()) check the held alternative.
+        switch (op) {
+          case Bytecode::Op::kLoad:
+          case Bytecode::Op::kStore:
+            data = Bytecode::SlotIndex(integer_data);
+            break;
+          case Bytecode::Op::kCreateArray:
+          case Bytecode::Op::kCreateTuple:
+            data = Bytecode::NumElements(integer_data);
+            break;
+          default:
+            data = Bytecode::JumpTarget(integer_data);
+            break;
+        }
       }
     }
     result.push_back(Bytecode(Span::Fake(), op, std::move(data)));
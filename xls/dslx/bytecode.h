@@ -297,6 +297,10 @@ class Bytecode {
   absl::StatusOr<const TraceData*> trace_data() const;
   absl::StatusOr<const ConcreteType*> type_data() const;
   absl::StatusOr<InterpValue> value_data() const;
+  // As value_data(), but returns a pointer to the value held in the bytecode
+  // instead of a copy; used on the interpreter's hot path, where the copy of
+  // a large literal (wide Bits, aggregate) would dominate the dispatch cost.
+  absl::StatusOr<const InterpValue*> value_data_ptr() const;
 
   std::string ToString(bool source_locs = true) const;
 
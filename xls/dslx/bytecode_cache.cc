@@ -13,21 +13,121 @@
 // limitations under the License.
 #include "xls/dslx/bytecode_cache.h"
 
+#include "absl/strings/str_format.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/logging/logging.h"
 #include "xls/dslx/bytecode_emitter.h"
 
 namespace xls::dslx {
+namespace {
 
-BytecodeCache::BytecodeCache(ImportData* import_data)
-    : import_data_(import_data) {}
+// Stable 64-bit FNV-1a over the given bytes, chained through "state".
+// absl::Hash is randomized per process, so it cannot name files that are
+// shared across runs.
+uint64_t Fnv1a64(absl::string_view bytes,
+                 uint64_t state = uint64_t{0xcbf29ce484222325}) {
+  for (char c : bytes) {
+    state ^= static_cast<uint8_t>(c);
+    state *= uint64_t{0x00000100000001b3};
+  }
+  return state;
+}
+
+}  // namespace
+
+BytecodeCache::BytecodeCache(ImportData* import_data,
+                             std::optional<std::filesystem::path> cache_dir)
+    : import_data_(import_data), cache_dir_(std::move(cache_dir)) {}
+
+uint64_t BytecodeCache::ModuleFingerprint(const Module* module) {
+  auto it = module_fingerprint_memo_.find(module);
+  if (it != module_fingerprint_memo_.end()) {
+    return it->second;
+  }
+  // Insert a placeholder first so (pathological) import cycles terminate.
+  module_fingerprint_memo_.emplace(module, 0);
+  uint64_t fp = Fnv1a64(module->ToString());
+  for (const auto& [name, import] : module->GetImportByName()) {
+    absl::StatusOr<ModuleInfo*> imported =
+        import_data_->Get(ImportTokens(import->subject()));
+    if (imported.ok()) {
+      uint64_t imported_fp = ModuleFingerprint(&imported.value()->module());
+      fp = Fnv1a64(absl::StrFormat("%s=%016x", name, imported_fp), fp);
+    }
+  }
+  module_fingerprint_memo_[module] = fp;
+  return fp;
+}
+
+std::optional<std::filesystem::path> BytecodeCache::DiskPath(
+    const Function* f, const std::optional<SymbolicBindings>& caller_bindings) {
+  if (!cache_dir_.has_value()) {
+    return std::nullopt;
+  }
+  uint64_t fp = ModuleFingerprint(f->owner());
+  fp = Fnv1a64(f->identifier(), fp);
+  if (caller_bindings.has_value()) {
+    fp = Fnv1a64(caller_bindings->ToString(), fp);
+  }
+  return cache_dir_.value() / absl::StrFormat("%016x.bcode", fp);
+}
+
+absl::StatusOr<std::unique_ptr<BytecodeFunction>> BytecodeCache::LoadFunction(
+    const Function* f, const TypeInfo* type_info, absl::string_view text) {
+  XLS_ASSIGN_OR_RETURN(std::vector<Bytecode> bytecodes,
+                       BytecodesFromString(text));
+  return BytecodeFunction::Create(f->owner(), f, type_info,
+                                  std::move(bytecodes));
+}
+
+void BytecodeCache::MaybeStore(const std::filesystem::path& path,
+                               absl::Span<const Bytecode> bytecodes) {
+  std::string text = BytecodesToString(bytecodes, /*source_locs=*/false);
+  // Only persist bytecode that demonstrably survives the textual round trip;
+  // functions with payloads the parser can't reconstitute (invocations,
+  // casts, match arms, spawns, traces) are simply kept in memory.
+  absl::StatusOr<std::vector<Bytecode>> reparsed = BytecodesFromString(text);
+  if (!reparsed.ok() ||
+      BytecodesToString(reparsed.value(), /*source_locs=*/false) != text) {
+    return;
+  }
+  absl::Status status = RecursivelyCreateDir(cache_dir_.value());
+  if (status.ok()) {
+    status = SetFileContents(path, text);
+  }
+  if (!status.ok()) {
+    XLS_VLOG(3) << "Could not persist bytecode cache entry " << path << ": "
+                << status;
+  }
+}
 
 absl::StatusOr<BytecodeFunction*> BytecodeCache::GetOrCreateBytecodeFunction(
     const Function* f, const TypeInfo* type_info,
     const std::optional<SymbolicBindings>& caller_bindings) {
   Key key = std::make_tuple(f, type_info, caller_bindings);
   if (!cache_.contains(key)) {
+    std::optional<std::filesystem::path> disk_path =
+        DiskPath(f, caller_bindings);
+    if (disk_path.has_value()) {
+      absl::StatusOr<std::string> text = GetFileContents(disk_path.value());
+      if (text.ok()) {
+        absl::StatusOr<std::unique_ptr<BytecodeFunction>> loaded =
+            LoadFunction(f, type_info, text.value());
+        if (loaded.ok()) {
+          cache_.emplace(key, std::move(loaded.value()));
+          return cache_.at(key).get();
+        }
+        XLS_VLOG(3) << "Ignoring unloadable bytecode cache entry "
+                    << disk_path.value() << ": " << loaded.status();
+      }
+    }
+
     XLS_ASSIGN_OR_RETURN(
         std::unique_ptr<BytecodeFunction> bf,
         BytecodeEmitter::Emit(import_data_, type_info, f, caller_bindings));
+    if (disk_path.has_value()) {
+      MaybeStore(disk_path.value(), bf->bytecodes());
+    }
     cache_.emplace(key, std::move(bf));
   }
 
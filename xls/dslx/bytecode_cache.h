@@ -14,7 +14,9 @@
 #ifndef XLS_DSLX_BYTECODE_CACHE_H_
 #define XLS_DSLX_BYTECODE_CACHE_H_
 
+#include <filesystem>
 #include <memory>
+#include <optional>
 
 #include "absl/container/flat_hash_map.h"
 #include "xls/dslx/ast.h"
@@ -27,7 +29,21 @@ namespace xls::dslx {
 
 class BytecodeCache : public BytecodeCacheInterface {
  public:
-  BytecodeCache(ImportData* import_data);
+  // When `cache_dir` is provided, emitted bytecode is additionally persisted
+  // there (keyed by a stable fingerprint of the module text, its transitive
+  // imports, the function identifier and the caller bindings) and reloaded by
+  // later processes, so repeated runs over unchanged sources skip bytecode
+  // emission for previously-seen functions.
+  //
+  // Only functions whose bytecode survives the textual round trip through
+  // BytecodesToString()/BytecodesFromString() are persisted; functions with
+  // richer payloads (invocations, casts, match arms, spawns, traces) simply
+  // fall back to normal emission, as do entries that fail to load for any
+  // reason.
+  explicit BytecodeCache(
+      ImportData* import_data,
+      std::optional<std::filesystem::path> cache_dir = std::nullopt);
+
   absl::StatusOr<BytecodeFunction*> GetOrCreateBytecodeFunction(
       const Function* f, const TypeInfo* type_info,
       const std::optional<SymbolicBindings>& caller_bindings) override;
@@ -36,8 +52,31 @@ class BytecodeCache : public BytecodeCacheInterface {
   using Key = std::tuple<const Function*, const TypeInfo*,
                          std::optional<SymbolicBindings>>;
 
+  // Returns the on-disk entry path for the given function/bindings, or nullopt
+  // if disk caching is disabled.
+  std::optional<std::filesystem::path> DiskPath(
+      const Function* f,
+      const std::optional<SymbolicBindings>& caller_bindings);
+
+  // Returns a stable fingerprint over the given module's text and that of its
+  // transitive imports (memoized per module).
+  uint64_t ModuleFingerprint(const Module* module);
+
+  // Attempts to reconstitute a BytecodeFunction for "f" from the serialized
+  // "text"; any failure is treated by the caller as a cache miss.
+  absl::StatusOr<std::unique_ptr<BytecodeFunction>> LoadFunction(
+      const Function* f, const TypeInfo* type_info, absl::string_view text);
+
+  // Persists the given bytecodes to "path" if they survive the textual round
+  // trip; failures are logged and otherwise ignored (the in-memory cache is
+  // unaffected).
+  void MaybeStore(const std::filesystem::path& path,
+                  absl::Span<const Bytecode> bytecodes);
+
   ImportData* import_data_;
+  std::optional<std::filesystem::path> cache_dir_;
   absl::flat_hash_map<Key, std::unique_ptr<BytecodeFunction>> cache_;
+  absl::flat_hash_map<const Module*, uint64_t> module_fingerprint_memo_;
 };
 
 }  // namespace xls::dslx
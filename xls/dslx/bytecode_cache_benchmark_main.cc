@@ -0,0 +1,121 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Startup benchmark for the DSLX bytecode interpreter: measures
+// time-to-first-instruction (parse + typecheck + bytecode availability for
+// every function) over a synthetic module, with and without a warm on-disk
+// bytecode cache:
+//
+//   bazel run -c opt //xls/dslx:bytecode_cache_benchmark_main
+
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "xls/common/init_xls.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/logging/logging.h"
+#include "xls/dslx/bytecode_cache.h"
+#include "xls/dslx/create_import_data.h"
+#include "xls/dslx/parse_and_typecheck.h"
+
+namespace xls::dslx {
+namespace {
+
+constexpr int64_t kFunctionCount = 512;
+
+// Builds a module with many simple leaf functions, approximating the shape of
+// a test-heavy module where each test body is emitted independently.
+std::string BuildModuleText() {
+  std::string text;
+  for (int64_t i = 0; i < kFunctionCount; ++i) {
+    absl::StrAppendFormat(&text,
+                          "fn f_%d() -> u32 {\n"
+                          "  let a = u32:%d;\n"
+                          "  let b = a + u32:1;\n"
+                          "  let c = b * u32:3;\n"
+                          "  c - a\n"
+                          "}\n\n",
+                          i, i);
+  }
+  return text;
+}
+
+struct RunTimes {
+  absl::Duration typecheck;
+  absl::Duration bytecode;
+};
+
+// Parses/typechecks the module and obtains bytecode for every function
+// through a cache rooted at "cache_dir"; returns the elapsed time of each
+// phase. The sum is the time until the interpreter could execute the first
+// instruction of any function in the module.
+RunTimes RunOnce(const std::string& program,
+                 const std::filesystem::path& cache_dir) {
+  RunTimes times;
+  ImportData import_data(CreateImportDataForTest());
+
+  absl::Time start = absl::Now();
+  absl::StatusOr<TypecheckedModule> tm =
+      ParseAndTypecheck(program, "benchmark.x", "benchmark", &import_data);
+  XLS_QCHECK_OK(tm.status());
+  times.typecheck = absl::Now() - start;
+
+  start = absl::Now();
+  BytecodeCache cache(&import_data, cache_dir);
+  for (int64_t i = 0; i < kFunctionCount; ++i) {
+    absl::StatusOr<Function*> f =
+        tm->module->GetMemberOrError<Function>(absl::StrFormat("f_%d", i));
+    XLS_QCHECK_OK(f.status());
+    XLS_QCHECK_OK(
+        cache.GetOrCreateBytecodeFunction(*f, tm->type_info, absl::nullopt)
+            .status());
+  }
+  times.bytecode = absl::Now() - start;
+  return times;
+}
+
+void RealMain() {
+  std::string program = BuildModuleText();
+  absl::StatusOr<TempDirectory> tempdir = TempDirectory::Create();
+  XLS_QCHECK_OK(tempdir.status());
+  std::filesystem::path cache_dir = tempdir->path() / "bytecode";
+
+  RunTimes cold = RunOnce(program, cache_dir);
+  RunTimes warm = RunOnce(program, cache_dir);
+
+  auto print = [](absl::string_view label, const RunTimes& times) {
+    std::cout << absl::StreamFormat(
+        "%-6s typecheck: %10.3fms  bytecode: %10.3fms  "
+        "time-to-first-instruction: %10.3fms\n",
+        label, absl::ToDoubleMilliseconds(times.typecheck),
+        absl::ToDoubleMilliseconds(times.bytecode),
+        absl::ToDoubleMilliseconds(times.typecheck + times.bytecode));
+  };
+  print("cold", cold);
+  print("warm", warm);
+}
+
+}  // namespace
+}  // namespace xls::dslx
+
+int main(int argc, char* argv[]) {
+  xls::InitXls(argv[0], argc, argv);
+  xls::dslx::RealMain();
+  return 0;
+}
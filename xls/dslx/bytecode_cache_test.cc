@@ -0,0 +1,90 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "xls/dslx/bytecode_cache.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/str_replace.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+#include "xls/dslx/bytecode_interpreter.h"
+#include "xls/dslx/create_import_data.h"
+#include "xls/dslx/parse_and_typecheck.h"
+
+namespace xls::dslx {
+namespace {
+
+constexpr absl::string_view kProgram = R"(
+fn main() -> u32 {
+  let x = u32:5;
+  x + u32:7
+}
+)";
+
+absl::StatusOr<InterpValue> RunMainWithCache(
+    const std::filesystem::path& cache_dir) {
+  ImportData import_data(CreateImportDataForTest());
+  XLS_ASSIGN_OR_RETURN(
+      TypecheckedModule tm,
+      ParseAndTypecheck(kProgram, "test.x", "test", &import_data));
+  XLS_ASSIGN_OR_RETURN(Function * f,
+                       tm.module->GetMemberOrError<Function>("main"));
+  BytecodeCache cache(&import_data, cache_dir);
+  XLS_ASSIGN_OR_RETURN(
+      BytecodeFunction * bf,
+      cache.GetOrCreateBytecodeFunction(f, tm.type_info, absl::nullopt));
+  return BytecodeInterpreter::Interpret(&import_data, bf, /*args=*/{});
+}
+
+TEST(BytecodeCacheTest, PersistsAndReloadsAcrossCacheObjects) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory tempdir, TempDirectory::Create());
+  std::filesystem::path cache_dir = tempdir.path() / "bytecode";
+
+  // Cold run: emits, executes and persists an entry.
+  XLS_ASSERT_OK_AND_ASSIGN(InterpValue cold, RunMainWithCache(cache_dir));
+  EXPECT_EQ(cold.GetBitValueInt64().value(), 12);
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<std::filesystem::path> entries,
+                           GetDirectoryEntries(cache_dir));
+  ASSERT_EQ(entries.size(), 1);
+
+  // Edit the serialized literal in place; if the warm run observes the edit,
+  // it provably executed the on-disk bytecode rather than re-emitting.
+  XLS_ASSERT_OK_AND_ASSIGN(std::string text, GetFileContents(entries[0]));
+  ASSERT_THAT(text, testing::HasSubstr("literal u32:7"));
+  XLS_ASSERT_OK(SetFileContents(
+      entries[0], absl::StrReplaceAll(text, {{"literal u32:7",
+                                              "literal u32:9"}})));
+
+  XLS_ASSERT_OK_AND_ASSIGN(InterpValue warm, RunMainWithCache(cache_dir));
+  EXPECT_EQ(warm.GetBitValueInt64().value(), 14);
+}
+
+TEST(BytecodeCacheTest, CorruptEntryFallsBackToEmission) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory tempdir, TempDirectory::Create());
+  std::filesystem::path cache_dir = tempdir.path() / "bytecode";
+
+  XLS_ASSERT_OK(RunMainWithCache(cache_dir).status());
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<std::filesystem::path> entries,
+                           GetDirectoryEntries(cache_dir));
+  ASSERT_EQ(entries.size(), 1);
+  XLS_ASSERT_OK(SetFileContents(entries[0], "not bytecode"));
+
+  XLS_ASSERT_OK_AND_ASSIGN(InterpValue result, RunMainWithCache(cache_dir));
+  EXPECT_EQ(result.GetBitValueInt64().value(), 12);
+}
+
+}  // namespace
+}  // namespace xls::dslx
@@ -49,7 +49,7 @@ void Frame::StoreSlot(Bytecode::SlotIndex slot, InterpValue value) {
     slots_.push_back(InterpValue::MakeToken());
   }
 
-  slots_.at(slot.value()) = value;
+  slots_.at(slot.value()) = std::move(value);
 }
 
 /* static */ absl::StatusOr<InterpValue> BytecodeInterpreter::Interpret(
@@ -88,12 +88,47 @@ BytecodeInterpreter::CreateUnique(ImportData* import_data, BytecodeFunction* bf,
   return interp;
 }
 
+absl::StatusOr<InterpValue> InterpreterContext::Interpret(
+    BytecodeFunction* bf, const std::vector<InterpValue>& args,
+    BytecodeInterpreter::PostFnEvalHook post_fn_eval_hook) {
+  if (interpreter_ == nullptr) {
+    interpreter_ =
+        absl::WrapUnique(new BytecodeInterpreter(import_data_, bf));
+  } else {
+    interpreter_->Reset();
+  }
+  XLS_RETURN_IF_ERROR(interpreter_->InitFrame(bf, args));
+  XLS_RETURN_IF_ERROR(interpreter_->Run(post_fn_eval_hook));
+  return interpreter_->stack_.back();
+}
+
+absl::StatusOr<std::vector<InterpValue>> QuickCheckBatch(
+    ImportData* import_data, BytecodeFunction* bf,
+    absl::Span<const std::vector<InterpValue>> arg_sets,
+    BytecodeInterpreter::PostFnEvalHook post_fn_eval_hook) {
+  InterpreterContext context(import_data);
+  std::vector<InterpValue> results;
+  results.reserve(arg_sets.size());
+  for (const std::vector<InterpValue>& args : arg_sets) {
+    XLS_ASSIGN_OR_RETURN(InterpValue result,
+                         context.Interpret(bf, args, post_fn_eval_hook));
+    results.push_back(result);
+    if (result.IsFalse()) {
+      // Falsifying example found; present the evidence without burning the
+      // rest of the sample set.
+      break;
+    }
+  }
+  return results;
+}
+
 absl::Status BytecodeInterpreter::Run(PostFnEvalHook post_fn_eval_hook) {
   while (!frames_.empty()) {
     Frame* frame = &frames_.back();
     while (frame->pc() < frame->bf()->bytecodes().size()) {
       const std::vector<Bytecode>& bytecodes = frame->bf()->bytecodes();
-      const Bytecode& bytecode = bytecodes.at(frame->pc());
+      // The PC is bounds-checked by the loop condition.
+      const Bytecode& bytecode = bytecodes[frame->pc()];
       XLS_VLOG(2) << std::hex << "PC: " << frame->pc() << " : "
                   << bytecode.ToString();
       XLS_VLOG(3) << " - TOS pre: "
@@ -149,7 +184,8 @@ absl::Status BytecodeInterpreter::EvalNextInstruction() {
         absl::StrFormat("Frame PC exceeds bytecode length: %d vs %d.",
                         frame->pc(), bytecodes.size()));
   }
-  const Bytecode& bytecode = bytecodes.at(frame->pc());
+  // The PC is bounds-checked above.
+  const Bytecode& bytecode = bytecodes[frame->pc()];
   XLS_VLOG(10) << "Running bytecode: " << bytecode.ToString()
                << " depth before: " << stack_.size();
   switch (bytecode.op()) {
@@ -476,7 +512,7 @@ absl::Status BytecodeInterpreter::EvalCast(const Bytecode& bytecode) {
           "Array types can only be cast to bits.");
     }
     XLS_ASSIGN_OR_RETURN(InterpValue converted, from.Flatten());
-    stack_.push_back(converted);
+    stack_.push_back(std::move(converted));
     return absl::OkStatus();
   }
 
@@ -508,14 +544,14 @@ absl::Status BytecodeInterpreter::EvalCast(const Bytecode& bytecode) {
           from_bit_count, to_bit_count));
     }
     XLS_ASSIGN_OR_RETURN(InterpValue casted, CastBitsToArray(from, *to_array));
-    stack_.push_back(casted);
+    stack_.push_back(std::move(casted));
     return absl::OkStatus();
   }
 
   // From bits to enum.
   if (EnumType* to_enum = dynamic_cast<EnumType*>(to); to_enum != nullptr) {
     XLS_ASSIGN_OR_RETURN(InterpValue converted, CastBitsToEnum(from, *to_enum));
-    stack_.push_back(converted);
+    stack_.push_back(std::move(converted));
     return absl::OkStatus();
   }
 
@@ -544,7 +580,7 @@ absl::Status BytecodeInterpreter::EvalCast(const Bytecode& bytecode) {
   }
   InterpValue result = InterpValue::MakeBits(to_bits->is_signed(), result_bits);
 
-  stack_.push_back(result);
+  stack_.push_back(std::move(result));
 
   return absl::OkStatus();
 }
@@ -564,12 +600,13 @@ absl::Status BytecodeInterpreter::EvalCreateArray(const Bytecode& bytecode) {
   elements.reserve(array_size.value());
   for (int64_t i = 0; i < array_size.value(); i++) {
     XLS_ASSIGN_OR_RETURN(InterpValue value, Pop());
-    elements.push_back(value);
+    elements.push_back(std::move(value));
   }
 
   std::reverse(elements.begin(), elements.end());
-  XLS_ASSIGN_OR_RETURN(InterpValue array, InterpValue::MakeArray(elements));
-  stack_.push_back(array);
+  XLS_ASSIGN_OR_RETURN(InterpValue array,
+                       InterpValue::MakeArray(std::move(elements)));
+  stack_.push_back(std::move(array));
   return absl::OkStatus();
 }
 
@@ -582,12 +619,12 @@ absl::Status BytecodeInterpreter::EvalCreateTuple(const Bytecode& bytecode) {
   elements.reserve(tuple_size.value());
   for (int64_t i = 0; i < tuple_size.value(); i++) {
     XLS_ASSIGN_OR_RETURN(InterpValue value, Pop());
-    elements.push_back(value);
+    elements.push_back(std::move(value));
   }
 
   std::reverse(elements.begin(), elements.end());
 
-  stack_.push_back(InterpValue::MakeTuple(elements));
+  stack_.push_back(InterpValue::MakeTuple(std::move(elements)));
   return absl::OkStatus();
 }
 
@@ -625,7 +662,7 @@ absl::Status BytecodeInterpreter::EvalExpandTuple(const Bytecode& bytecode) {
   for (int64_t i = tuple_size - 1; i >= 0; i--) {
     XLS_ASSIGN_OR_RETURN(InterpValue element,
                          tuple.Index(InterpValue::MakeUBits(64, i)));
-    stack_.push_back(element);
+    stack_.push_back(std::move(element));
   }
 
   return absl::OkStatus();
@@ -662,14 +699,14 @@ absl::Status BytecodeInterpreter::EvalIndex(const Bytecode& bytecode) {
 
   XLS_ASSIGN_OR_RETURN(InterpValue result, basis.Index(index),
                        _ << " while processing " << bytecode.ToString());
-  stack_.push_back(result);
+  stack_.push_back(std::move(result));
   return absl::OkStatus();
 }
 
 absl::Status BytecodeInterpreter::EvalInvert(const Bytecode& bytecode) {
   XLS_ASSIGN_OR_RETURN(InterpValue operand, Pop());
   XLS_ASSIGN_OR_RETURN(InterpValue result, operand.BitwiseNegate());
-  stack_.push_back(result);
+  stack_.push_back(std::move(result));
   return absl::OkStatus();
 }
 
@@ -680,8 +717,8 @@ absl::Status BytecodeInterpreter::EvalLe(const Bytecode& bytecode) {
 }
 
 absl::Status BytecodeInterpreter::EvalLiteral(const Bytecode& bytecode) {
-  XLS_ASSIGN_OR_RETURN(InterpValue value, bytecode.value_data());
-  stack_.push_back(value);
+  XLS_ASSIGN_OR_RETURN(const InterpValue* value, bytecode.value_data_ptr());
+  stack_.push_back(*value);
   return absl::OkStatus();
 }
 
@@ -713,7 +750,7 @@ absl::Status BytecodeInterpreter::EvalLogicalAnd(const Bytecode& bytecode) {
   }
 
   XLS_ASSIGN_OR_RETURN(InterpValue result, lhs.BitwiseAnd(rhs));
-  stack_.push_back(result);
+  stack_.push_back(std::move(result));
   return absl::OkStatus();
 }
 
@@ -734,7 +771,7 @@ absl::Status BytecodeInterpreter::EvalLogicalOr(const Bytecode& bytecode) {
   }
 
   XLS_ASSIGN_OR_RETURN(InterpValue result, lhs.BitwiseOr(rhs));
-  stack_.push_back(result);
+  stack_.push_back(std::move(result));
   return absl::OkStatus();
 }
 
@@ -822,7 +859,7 @@ absl::Status BytecodeInterpreter::EvalNe(const Bytecode& bytecode) {
 absl::Status BytecodeInterpreter::EvalNegate(const Bytecode& bytecode) {
   XLS_ASSIGN_OR_RETURN(InterpValue operand, Pop());
   XLS_ASSIGN_OR_RETURN(InterpValue result, operand.ArithmeticNegate());
-  stack_.push_back(result);
+  stack_.push_back(std::move(result));
   return absl::OkStatus();
 }
 
@@ -874,7 +911,7 @@ absl::Status BytecodeInterpreter::EvalRecv(const Bytecode& bytecode) {
   XLS_ASSIGN_OR_RETURN(auto channel, channel_value.GetChannel());
   if (channel->empty()) {
     // Restore the stack!
-    stack_.push_back(channel_value);
+    stack_.push_back(std::move(channel_value));
     return absl::UnavailableError("Channel is empty.");
   }
 
@@ -889,8 +926,8 @@ absl::Status BytecodeInterpreter::EvalSend(const Bytecode& bytecode) {
   XLS_ASSIGN_OR_RETURN(InterpValue channel_value, Pop());
   XLS_ASSIGN_OR_RETURN(auto channel, channel_value.GetChannel());
   XLS_ASSIGN_OR_RETURN(InterpValue token, Pop());
-  channel->push_back(payload);
-  stack_.push_back(token);
+  channel->push_back(std::move(payload));
+  stack_.push_back(std::move(token));
   return absl::OkStatus();
 }
 
@@ -959,7 +996,7 @@ absl::Status BytecodeInterpreter::EvalSlice(const Bytecode& bytecode) {
   start = InterpValue::MakeBits(/*is_signed=*/false, start.GetBitsOrDie());
   length = InterpValue::MakeBits(/*is_signed=*/false, length.GetBitsOrDie());
   XLS_ASSIGN_OR_RETURN(InterpValue result, basis.Slice(start, length));
-  stack_.push_back(result);
+  stack_.push_back(std::move(result));
   return absl::OkStatus();
 }
 
@@ -971,7 +1008,7 @@ absl::Status BytecodeInterpreter::EvalStore(const Bytecode& bytecode) {
   }
 
   XLS_ASSIGN_OR_RETURN(InterpValue value, Pop());
-  frames_.back().StoreSlot(slot, value);
+  frames_.back().StoreSlot(slot, std::move(value));
   return absl::OkStatus();
 }
 
@@ -996,8 +1033,8 @@ absl::Status BytecodeInterpreter::EvalSwap(const Bytecode& bytecode) {
   XLS_RET_CHECK_GE(stack_.size(), 2);
   XLS_ASSIGN_OR_RETURN(InterpValue tos0, Pop());
   XLS_ASSIGN_OR_RETURN(InterpValue tos1, Pop());
-  stack_.push_back(tos0);
-  stack_.push_back(tos1);
+  stack_.push_back(std::move(tos0));
+  stack_.push_back(std::move(tos1));
   return absl::OkStatus();
 }
 
@@ -1041,7 +1078,7 @@ absl::Status BytecodeInterpreter::EvalWidthSlice(const Bytecode& bytecode) {
   XLS_ASSIGN_OR_RETURN(InterpValue start, Pop());
   if (!start.FitsInUint64()) {
     XLS_RETURN_IF_ERROR(Pop().status());
-    stack_.push_back(oob_value);
+    stack_.push_back(std::move(oob_value));
     return absl::OkStatus();
   }
   XLS_ASSIGN_OR_RETURN(uint64_t start_index, start.GetBitValueUint64());
@@ -1052,7 +1089,7 @@ absl::Status BytecodeInterpreter::EvalWidthSlice(const Bytecode& bytecode) {
   InterpValue width = InterpValue::MakeUBits(64, width_value);
 
   if (start_index >= basis_width) {
-    stack_.push_back(oob_value);
+    stack_.push_back(std::move(oob_value));
     return absl::OkStatus();
   }
 
@@ -1065,7 +1102,7 @@ absl::Status BytecodeInterpreter::EvalWidthSlice(const Bytecode& bytecode) {
       bits_type->is_signed() ? InterpValueTag::kSBits : InterpValueTag::kUBits;
   XLS_ASSIGN_OR_RETURN(InterpValue result,
                        InterpValue::MakeBits(tag, result_bits));
-  stack_.push_back(result);
+  stack_.push_back(std::move(result));
   return absl::OkStatus();
 }
 
@@ -1148,7 +1185,7 @@ absl::Status BytecodeInterpreter::RunBuiltinAddWithCarry(
   XLS_ASSIGN_OR_RETURN(InterpValue lhs, Pop());
   XLS_ASSIGN_OR_RETURN(InterpValue rhs, Pop());
   XLS_ASSIGN_OR_RETURN(InterpValue result, lhs.AddWithCarry(rhs));
-  stack_.push_back(result);
+  stack_.push_back(std::move(result));
   return absl::OkStatus();
 }
 
@@ -1293,7 +1330,7 @@ absl::Status BytecodeInterpreter::RunBuiltinEnumerate(
         InterpValue::MakeTuple({InterpValue::MakeU32(i), values->at(i)}));
   }
   XLS_ASSIGN_OR_RETURN(InterpValue result, InterpValue::MakeArray(elements));
-  stack_.push_back(result);
+  stack_.push_back(std::move(result));
   return absl::OkStatus();
 }
 
@@ -1558,7 +1595,7 @@ absl::Status BytecodeInterpreter::RunBinaryBuiltin(
   XLS_ASSIGN_OR_RETURN(InterpValue b, Pop());
   XLS_ASSIGN_OR_RETURN(InterpValue a, Pop());
   XLS_ASSIGN_OR_RETURN(InterpValue result, fn(a, b));
-  stack_.push_back(result);
+  stack_.push_back(std::move(result));
   return absl::OkStatus();
 }
 
@@ -1571,7 +1608,7 @@ absl::Status BytecodeInterpreter::RunTernaryBuiltin(
   XLS_ASSIGN_OR_RETURN(InterpValue b, Pop());
   XLS_ASSIGN_OR_RETURN(InterpValue a, Pop());
   XLS_ASSIGN_OR_RETURN(InterpValue result, fn(a, b, c));
-  stack_.push_back(result);
+  stack_.push_back(std::move(result));
   return absl::OkStatus();
 }
 
@@ -105,8 +105,17 @@ class BytecodeInterpreter {
   absl::Status Run(PostFnEvalHook post_fn_eval_hook = nullptr);
 
  private:
+  friend class InterpreterContext;
   friend class ProcInstance;
 
+  // Clears the interpreter's value stack and frame stack so it can run
+  // another function, keeping the underlying storage allocated. Used by
+  // InterpreterContext to reuse one interpreter across many invocations.
+  void Reset() {
+    stack_.clear();
+    frames_.clear();
+  }
+
   // Runs the next instruction in the current frame. Returns an error if called
   // when the PC is already pointing to the end of the bytecode.
   absl::Status EvalNextInstruction();
@@ -223,6 +232,39 @@ class BytecodeInterpreter {
   std::vector<Frame> frames_;
 };
 
+// A reusable evaluation context for the bytecode interpreter.
+// BytecodeInterpreter::Interpret constructs a fresh interpreter -- value
+// stack, frame stack and all -- per call, which is pure overhead for callers
+// such as quickcheck suites that evaluate the same function many thousands of
+// times. A context keeps one interpreter alive and only resets its stacks
+// between invocations, so the storage they grew on earlier samples is reused.
+class InterpreterContext {
+ public:
+  explicit InterpreterContext(ImportData* import_data)
+      : import_data_(import_data) {}
+
+  // Evaluates `bf` with `args`, equivalent to (and interchangeable with)
+  // BytecodeInterpreter::Interpret but reusing this context's interpreter.
+  absl::StatusOr<InterpValue> Interpret(
+      BytecodeFunction* bf, const std::vector<InterpValue>& args,
+      BytecodeInterpreter::PostFnEvalHook post_fn_eval_hook = nullptr);
+
+ private:
+  ImportData* import_data_;
+  std::unique_ptr<BytecodeInterpreter> interpreter_;
+};
+
+// Batched quickcheck driver: evaluates `bf` (a quickcheck predicate returning
+// bool) on every arg set in `arg_sets` using a single InterpreterContext, and
+// stops at the first falsified sample. Returns one result per sample run, so
+// the result vector is shorter than `arg_sets` iff a falsifying example was
+// found, in which case it is the last entry and its arg set has the same
+// index.
+absl::StatusOr<std::vector<InterpValue>> QuickCheckBatch(
+    ImportData* import_data, BytecodeFunction* bf,
+    absl::Span<const std::vector<InterpValue>> arg_sets,
+    BytecodeInterpreter::PostFnEvalHook post_fn_eval_hook = nullptr);
+
 // Specialization of BytecodeInterpreter for executing Proc `config` functions.
 // These are special b/c they define a tree of ProcInstances that we need to
 // collect at the end so we can "tick" them. Only this class, unlike
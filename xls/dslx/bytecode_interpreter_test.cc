@@ -1346,5 +1346,64 @@ fn main() -> u32[8] {
   }
 }
 
+TEST(BytecodeInterpreterTest, InterpreterContextReusableAcrossInvocations) {
+  constexpr absl::string_view kProgram = R"(
+fn add_one(x: u32) -> u32 {
+  x + u32:1
+}
+)";
+
+  ImportData import_data(CreateImportDataForTest());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypecheckedModule tm,
+      ParseAndTypecheck(kProgram, "test.x", "test", &import_data));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f,
+                           tm.module->GetMemberOrError<Function>("add_one"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<BytecodeFunction> bf,
+      BytecodeEmitter::Emit(&import_data, tm.type_info, f,
+                            SymbolicBindings()));
+
+  InterpreterContext context(&import_data);
+  for (uint64_t i = 0; i < 10; ++i) {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        InterpValue result,
+        context.Interpret(bf.get(), {InterpValue::MakeU32(i)}));
+    EXPECT_EQ(result, InterpValue::MakeU32(i + 1));
+  }
+}
+
+TEST(BytecodeInterpreterTest, QuickCheckBatchStopsAtFalsifyingSample) {
+  constexpr absl::string_view kProgram = R"(
+fn is_small(x: u32) -> bool {
+  x < u32:3
+}
+)";
+
+  ImportData import_data(CreateImportDataForTest());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypecheckedModule tm,
+      ParseAndTypecheck(kProgram, "test.x", "test", &import_data));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f,
+                           tm.module->GetMemberOrError<Function>("is_small"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<BytecodeFunction> bf,
+      BytecodeEmitter::Emit(&import_data, tm.type_info, f,
+                            SymbolicBindings()));
+
+  std::vector<std::vector<InterpValue>> arg_sets;
+  for (uint64_t i = 0; i < 8; ++i) {
+    arg_sets.push_back({InterpValue::MakeU32(i)});
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<InterpValue> results,
+      QuickCheckBatch(&import_data, bf.get(), arg_sets));
+  // Samples 0..2 pass; sample 3 falsifies the predicate and the batch stops.
+  ASSERT_EQ(results.size(), 4);
+  EXPECT_TRUE(results[0].IsTrue());
+  EXPECT_TRUE(results[2].IsTrue());
+  EXPECT_TRUE(results[3].IsFalse());
+}
+
 }  // namespace
 }  // namespace xls::dslx
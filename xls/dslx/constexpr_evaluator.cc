@@ -13,10 +13,14 @@
 // limitations under the License.
 #include "xls/dslx/constexpr_evaluator.h"
 
+#include <algorithm>
+#include <optional>
 #include <variant>
 
 #include "absl/status/status.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "absl/types/variant.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/dslx/ast_utils.h"
@@ -24,6 +28,7 @@
 #include "xls/dslx/bytecode_emitter.h"
 #include "xls/dslx/bytecode_interpreter.h"
 #include "xls/dslx/errors.h"
+#include "xls/dslx/import_data.h"
 #include "xls/dslx/interp_value.h"
 
 namespace xls::dslx {
@@ -708,12 +713,47 @@ absl::Status ConstexprEvaluator::HandleXlsTuple(const XlsTuple* expr) {
   return absl::OkStatus();
 }
 
+// Builds a stable textual fingerprint of the constexpr environment "env" and
+// the parametric "bindings" an expression is being evaluated under, for use as
+// a ConstexprCache key. Returns std::nullopt if any environment value is not
+// cacheable (contains a channel or token), in which case memoization must be
+// skipped entirely: such values have per-instantiation identity that their
+// textual form does not capture.
+static std::optional<std::string> MakeEnvFingerprint(
+    const absl::flat_hash_map<std::string, InterpValue>& env,
+    const SymbolicBindings& bindings) {
+  std::vector<std::string> entries;
+  entries.reserve(env.size());
+  for (const auto& [name, value] : env) {
+    if (!ConstexprCache::IsCacheable(value)) {
+      return std::nullopt;
+    }
+    entries.push_back(absl::StrCat(name, "=", value.ToString()));
+  }
+  std::sort(entries.begin(), entries.end());
+  return absl::StrCat(bindings.ToString(), ";", absl::StrJoin(entries, ","));
+}
+
 absl::Status ConstexprEvaluator::InterpretExpr(
     const Expr* expr, absl::flat_hash_set<const NameDef*> bypass_env) {
   absl::flat_hash_map<std::string, InterpValue> env;
   XLS_ASSIGN_OR_RETURN(env, MakeConstexprEnv(import_data_, type_info_, expr,
                                              bindings_, bypass_env));
 
+  // Parametric instantiations re-evaluate the same expression nodes under
+  // identical environments; consult the package-wide memo table before firing
+  // up the bytecode machinery.
+  std::optional<std::string> env_fingerprint =
+      MakeEnvFingerprint(env, bindings_);
+  ConstexprCache& cache = import_data_->constexpr_cache();
+  if (env_fingerprint.has_value()) {
+    if (std::optional<InterpValue> cached =
+            cache.Lookup(expr, *env_fingerprint)) {
+      type_info_->NoteConstExpr(expr, std::move(*cached));
+      return absl::OkStatus();
+    }
+  }
+
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<BytecodeFunction> bf,
                        BytecodeEmitter::EmitExpression(import_data_, type_info_,
                                                        expr, env, bindings_));
@@ -722,6 +762,10 @@ absl::Status ConstexprEvaluator::InterpretExpr(
                        BytecodeInterpreter::Interpret(import_data_, bf.get(),
                                                       /*args=*/{}));
   type_info_->NoteConstExpr(expr, constexpr_value);
+  if (env_fingerprint.has_value()) {
+    cache.Insert(expr, *std::move(env_fingerprint),
+                 std::move(constexpr_value));
+  }
 
   return absl::OkStatus();
 }
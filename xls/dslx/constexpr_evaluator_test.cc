@@ -608,5 +608,57 @@ fn main() -> u32 {
   EXPECT_EQ(value.GetBitValueInt64().value(), 32);
 }
 
+TEST(ConstexprEvaluatorTest, ConstexprCacheBasics) {
+  Module module("test");
+  Span fake_span(Pos("test.x", 0, 0), Pos("test.x", 0, 0));
+  Number* expr = module.Make<Number>(fake_span, "7", NumberKind::kOther,
+                                     /*type_annotation=*/nullptr);
+
+  ConstexprCache cache;
+  EXPECT_FALSE(cache.Lookup(expr, "env").has_value());
+  EXPECT_EQ(cache.misses(), 1);
+
+  cache.Insert(expr, "env", InterpValue::MakeU32(7));
+  std::optional<InterpValue> cached = cache.Lookup(expr, "env");
+  ASSERT_TRUE(cached.has_value());
+  EXPECT_EQ(cached->GetBitValueInt64().value(), 7);
+  EXPECT_EQ(cache.hits(), 1);
+
+  // A different environment fingerprint is a distinct key.
+  EXPECT_FALSE(cache.Lookup(expr, "other_env").has_value());
+  EXPECT_EQ(cache.misses(), 2);
+
+  // Identity-carrying values are never memoized.
+  EXPECT_FALSE(ConstexprCache::IsCacheable(InterpValue::MakeChannel()));
+  EXPECT_FALSE(ConstexprCache::IsCacheable(
+      InterpValue::MakeTuple({InterpValue::MakeU32(0),
+                              InterpValue::MakeToken()})));
+  cache.Insert(expr, "channel_env", InterpValue::MakeChannel());
+  EXPECT_FALSE(cache.Lookup(expr, "channel_env").has_value());
+}
+
+TEST(ConstexprEvaluatorTest, CacheHitsAcrossParametricInstantiations) {
+  // Each call site of a parametric function gets its own derived TypeInfo, so
+  // the `let` RHS below is constexpr-evaluated once per instantiation; the
+  // second instantiation with identical bindings should hit the memo table.
+  constexpr absl::string_view kProgram = R"(
+fn p<N: u32>(x: uN[N]) -> u32 {
+  let y = N + u32:1;
+  y
+}
+
+fn main() -> u32 { p(u32:0) }
+fn other() -> u32 { p(u32:1) }
+)";
+
+  ImportData import_data(CreateImportDataForTest());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypecheckedModule tm,
+      ParseAndTypecheck(kProgram, "test.x", "test", &import_data));
+
+  EXPECT_GT(import_data.constexpr_cache().hits(), 0);
+  EXPECT_GT(import_data.constexpr_cache().misses(), 0);
+}
+
 }  // namespace
 }  // namespace xls::dslx
@@ -79,6 +79,9 @@ std::string CheckedCamelize(absl::string_view input) {
 absl::StatusOr<Sources> TranspileSingleToCpp(
     const TranspileData& xpile_data, const TypeDefinition& type_definition);
 
+absl::StatusOr<std::string> TypeAnnotationToViewString(
+    const TranspileData& xpile_data, const TypeAnnotation* annot);
+
 absl::StatusOr<Sources> TranspileColonRef(const TranspileData& xpile_data,
                                           const ColonRef* colon_ref) {
   return absl::UnimplementedError("TranspileColonRef not yet implemented.");
@@ -87,7 +90,8 @@ absl::StatusOr<Sources> TranspileColonRef(const TranspileData& xpile_data,
 absl::StatusOr<Sources> TranspileEnumDef(const TranspileData& xpile_data,
                                          const EnumDef* enum_def) {
   constexpr absl::string_view kTemplate =
-      "enum class %s {\n%s\n};\nconstexpr int64_t k%sNumElements = %d;";
+      "enum class %s {\n%s\n};\nconstexpr int64_t k%sNumElements = %d;\n"
+      "using %sView = %s;";
   constexpr absl::string_view kMemberTemplate = "  %s = %s,";
 
   std::vector<std::string> members;
@@ -125,10 +129,13 @@ absl::StatusOr<Sources> TranspileEnumDef(const TranspileData& xpile_data,
     members.push_back(absl::StrFormat(kMemberTemplate, identifier, val_str));
   }
 
+  XLS_ASSIGN_OR_RETURN(
+      std::string view_str,
+      TypeAnnotationToViewString(xpile_data, enum_def->type_annotation()));
   std::string camelized_id = CheckedCamelize(enum_def->identifier());
   return Sources{
       absl::StrFormat(kTemplate, camelized_id, absl::StrJoin(members, "\n"),
-                      camelized_id, members.size()),
+                      camelized_id, members.size(), camelized_id, view_str),
       ""};
 }
 
@@ -231,14 +238,76 @@ absl::StatusOr<std::string> TypeAnnotationToString(
       absl::StrCat("Unknown TypeAnnotation kind: ", annot->ToString()));
 }
 
+// Returns the packed-view type (see xls/ir/value_view.h) describing the flat
+// bit layout of the type "annot" denotes. Mirrors TypeAnnotationToString,
+// except that the result captures the exact DSLX bit widths rather than
+// rounding up to a host integral type, so the view composes with
+// FunctionJit::RunWithPackedViews() without any per-call Value conversion.
+absl::StatusOr<std::string> TypeAnnotationToViewString(
+    const TranspileData& xpile_data, const TypeAnnotation* annot) {
+  XLS_ASSIGN_OR_RETURN(std::optional<BuiltinType> as_builtin_type,
+                       GetAsBuiltinType(xpile_data.module, xpile_data.type_info,
+                                        xpile_data.import_data, annot));
+  if (as_builtin_type.has_value()) {
+    XLS_ASSIGN_OR_RETURN(int64_t bit_count,
+                         GetBuiltinTypeBitCount(as_builtin_type.value()));
+    return absl::StrFormat("xls::PackedBitsView<%d>", bit_count);
+  }
+  if (auto* array = dynamic_cast<const ArrayTypeAnnotation*>(annot)) {
+    // GetAsBuiltinType covers the bits-type (e.g. uN[32]) case above, so this
+    // is a true array.
+    XLS_ASSIGN_OR_RETURN(
+        std::string element_view,
+        TypeAnnotationToViewString(xpile_data, array->element_type()));
+    uint64_t dim_int;
+    if (auto* number = dynamic_cast<Number*>(array->dim())) {
+      XLS_ASSIGN_OR_RETURN(dim_int, number->GetAsUint64());
+    } else {
+      XLS_ASSIGN_OR_RETURN(
+          InterpValue dim_value,
+          InterpretExpr(xpile_data.import_data, xpile_data.type_info,
+                        array->dim(), /*env=*/{}));
+      if (!dim_value.IsBits()) {
+        return absl::UnimplementedError(
+            "Multidimensional arrays aren't yet supported.");
+      }
+      XLS_ASSIGN_OR_RETURN(dim_int, dim_value.GetBitValueUint64());
+    }
+    return absl::StrFormat("xls::PackedArrayView<%s, %d>", element_view,
+                           dim_int);
+  }
+  if (auto* tuple = dynamic_cast<const TupleTypeAnnotation*>(annot)) {
+    std::vector<std::string> elements;
+    for (const auto& member : tuple->members()) {
+      XLS_ASSIGN_OR_RETURN(std::string element,
+                           TypeAnnotationToViewString(xpile_data, member));
+      elements.push_back(element);
+    }
+    return absl::StrCat("xls::PackedTupleView<", absl::StrJoin(elements, ", "),
+                        ">");
+  }
+  if (dynamic_cast<const TypeRefTypeAnnotation*>(annot) != nullptr) {
+    // Referenced definitions precede us in decl order, so their "<Name>View"
+    // aliases have already been emitted.
+    return CheckedCamelize(annot->ToString()) + "View";
+  }
+
+  return absl::InvalidArgumentError(
+      absl::StrCat("Unknown TypeAnnotation kind: ", annot->ToString()));
+}
+
 absl::StatusOr<Sources> TranspileTypeDef(const TranspileData& xpile_data,
                                          const TypeDef* type_def) {
   XLS_ASSIGN_OR_RETURN(
       std::string annot_str,
       TypeAnnotationToString(xpile_data, type_def->type_annotation()));
+  XLS_ASSIGN_OR_RETURN(
+      std::string view_str,
+      TypeAnnotationToViewString(xpile_data, type_def->type_annotation()));
+  std::string camelized_id = CheckedCamelize(type_def->identifier());
   return Sources{
-      absl::StrFormat("using %s = %s;", CheckedCamelize(type_def->identifier()),
-                      CheckedCamelize(annot_str)),
+      absl::StrFormat("using %s = %s;\nusing %sView = %s;", camelized_id,
+                      CheckedCamelize(annot_str), camelized_id, view_str),
       ""};
 }
 
@@ -547,15 +616,20 @@ absl::StatusOr<std::string> TranspileStructDefHeader(
   friend std::ostream& operator<<(std::ostream& os, const $0& data);
 
 $1$2
-};)";
+};$3)";
 
   std::string struct_body;
   std::vector<std::string> member_decls;
   std::vector<std::string> scalar_widths;
+  std::vector<std::string> member_views;
   for (int i = 0; i < struct_def->members().size(); i++) {
     std::string member_name = struct_def->members()[i].first->identifier();
     TypeAnnotation* type = struct_def->members()[i].second;
 
+    XLS_ASSIGN_OR_RETURN(std::string member_view,
+                         TypeAnnotationToViewString(xpile_data, type));
+    member_views.push_back(member_view);
+
     XLS_ASSIGN_OR_RETURN(std::string type_str,
                          TypeAnnotationToString(xpile_data, type));
     // We need to split on any brackets and add them to the end of the member
@@ -581,9 +655,20 @@ $1$2
   if (!width_block.empty()) {
     width_block = "\n\n" + width_block;
   }
-  return absl::Substitute(kStructTemplate,
-                          CheckedCamelize(struct_def->identifier()),
-                          absl::StrJoin(member_decls, "\n"), width_block);
+  std::string view_block;
+  if (!member_views.empty()) {
+    view_block = absl::Substitute(
+        "\n\n"
+        "// Zero-copy view of $0 over a packed buffer "
+        "(see xls/ir/value_view.h);\n"
+        "// tuple element indexes match member declaration order.\n"
+        "using $0View = xls::PackedTupleView<$1>;",
+        CheckedCamelize(struct_def->identifier()),
+        absl::StrJoin(member_views, ", "));
+  }
+  return absl::Substitute(
+      kStructTemplate, CheckedCamelize(struct_def->identifier()),
+      absl::StrJoin(member_decls, "\n"), width_block, view_block);
 }
 
 absl::StatusOr<std::string> TranspileStructDefBody(
@@ -683,6 +768,7 @@ absl::StatusOr<Sources> TranspileToCpp(Module* module, ImportData* import_data,
 #include <ostream>
 
 #include "absl/status/statusor.h"
+#include "xls/ir/value_view.h"
 #include "xls/public/value.h"
 
 $2$1$3
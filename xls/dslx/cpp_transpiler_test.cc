@@ -43,6 +43,7 @@ pub enum MyEnum : u32 {
 #include <ostream>
 
 #include "absl/status/statusor.h"
+#include "xls/ir/value_view.h"
 #include "xls/public/value.h"
 
 enum class MyEnum {
@@ -52,6 +53,7 @@ enum class MyEnum {
   kE = 4294967295,
 };
 constexpr int64_t kMyEnumNumElements = 4;
+using MyEnumView = xls::PackedBitsView<32>;
 
 #endif  // FAKE_PATH_H_
 )";
@@ -88,6 +90,7 @@ pub enum MyEnum : u32 {
 #include <ostream>
 
 #include "absl/status/statusor.h"
+#include "xls/ir/value_view.h"
 #include "xls/public/value.h"
 
 enum class MyEnum {
@@ -96,6 +99,7 @@ enum class MyEnum {
   kC = 289,
 };
 constexpr int64_t kMyEnumNumElements = 3;
+using MyEnumView = xls::PackedBitsView<32>;
 
 #endif  // FAKE_PATH_H_
 )";
@@ -133,25 +137,34 @@ type MyFirstTuple = (u7, s8, MyType, MySignedType, MyArrayType1, MyArrayType2);
 #include <ostream>
 
 #include "absl/status/statusor.h"
+#include "xls/ir/value_view.h"
 #include "xls/public/value.h"
 
 namespace robs::secret::space {
 
 using MyType = uint8_t;
+using MyTypeView = xls::PackedBitsView<6>;
 
 using MySignedType = int8_t;
+using MySignedTypeView = xls::PackedBitsView<8>;
 
 using MyThirdType = int16_t;
+using MyThirdTypeView = xls::PackedBitsView<9>;
 
 using MyArrayType1 = uint32_t[8];
+using MyArrayType1View = xls::PackedArrayView<xls::PackedBitsView<31>, 8>;
 
 using MyArrayType2 = uint32_t[4];
+using MyArrayType2View = xls::PackedArrayView<xls::PackedBitsView<31>, 4>;
 
 using MyArrayType3 = MySignedType[4];
+using MyArrayType3View = xls::PackedArrayView<MySignedTypeView, 4>;
 
 using MyArrayType4 = int8_t[4];
+using MyArrayType4View = xls::PackedArrayView<xls::PackedBitsView<8>, 4>;
 
 using MyFirstTuple = std::tuple<uint8_t, int8_t, MyType, MySignedType, MyArrayType1, MyArrayType2>;
+using MyFirstTupleView = xls::PackedTupleView<xls::PackedBitsView<7>, xls::PackedBitsView<8>, MyTypeView, MySignedTypeView, MyArrayType1View, MyArrayType2View>;
 
 }  // namespace robs::secret::space
 
@@ -184,6 +197,7 @@ struct MyStruct {
 #include <ostream>
 
 #include "absl/status/statusor.h"
+#include "xls/ir/value_view.h"
 #include "xls/public/value.h"
 
 struct MyStruct {
@@ -204,6 +218,10 @@ struct MyStruct {
   static constexpr int64_t kWWidth = 63;
 };
 
+// Zero-copy view of MyStruct over a packed buffer (see xls/ir/value_view.h);
+// tuple element indexes match member declaration order.
+using MyStructView = xls::PackedTupleView<xls::PackedBitsView<32>, xls::PackedBitsView<15>, xls::PackedBitsView<8>, xls::PackedBitsView<63>>;
+
 #endif  // FAKE_PATH_H_
 )";
 
@@ -283,6 +301,7 @@ struct MyStruct {
 #include <ostream>
 
 #include "absl/status/statusor.h"
+#include "xls/ir/value_view.h"
 #include "xls/public/value.h"
 
 struct MyStruct {
@@ -297,6 +316,10 @@ struct MyStruct {
   uint8_t z[7];
 };
 
+// Zero-copy view of MyStruct over a packed buffer (see xls/ir/value_view.h);
+// tuple element indexes match member declaration order.
+using MyStructView = xls::PackedTupleView<xls::PackedArrayView<xls::PackedBitsView<32>, 32>, xls::PackedArrayView<xls::PackedBitsView<7>, 8>, xls::PackedArrayView<xls::PackedBitsView<8>, 7>>;
+
 #endif  // FAKE_PATH_H_
 )";
 
@@ -398,6 +421,7 @@ struct OuterStruct {
 #include <ostream>
 
 #include "absl/status/statusor.h"
+#include "xls/ir/value_view.h"
 #include "xls/public/value.h"
 
 struct InnerStruct {
@@ -414,6 +438,10 @@ struct InnerStruct {
   static constexpr int64_t kYWidth = 16;
 };
 
+// Zero-copy view of InnerStruct over a packed buffer (see xls/ir/value_view.h);
+// tuple element indexes match member declaration order.
+using InnerStructView = xls::PackedTupleView<xls::PackedBitsView<32>, xls::PackedBitsView<16>>;
+
 struct OuterStruct {
   static absl::StatusOr<OuterStruct> FromValue(const xls::Value& value);
 
@@ -428,6 +456,10 @@ struct OuterStruct {
   static constexpr int64_t kXWidth = 32;
 };
 
+// Zero-copy view of OuterStruct over a packed buffer (see xls/ir/value_view.h);
+// tuple element indexes match member declaration order.
+using OuterStructView = xls::PackedTupleView<xls::PackedBitsView<32>, InnerStructView, InnerStructView>;
+
 #endif  // FAKE_PATH_H_
 )";
   constexpr absl::string_view kExpectedBody =
@@ -558,6 +590,7 @@ struct OuterStruct {
 #include <ostream>
 
 #include "absl/status/statusor.h"
+#include "xls/ir/value_view.h"
 #include "xls/public/value.h"
 
 struct InnerStruct {
@@ -574,6 +607,10 @@ struct InnerStruct {
   static constexpr int64_t kYWidth = 16;
 };
 
+// Zero-copy view of InnerStruct over a packed buffer (see xls/ir/value_view.h);
+// tuple element indexes match member declaration order.
+using InnerStructView = xls::PackedTupleView<xls::PackedBitsView<32>, xls::PackedBitsView<16>>;
+
 struct MiddleStruct {
   static absl::StatusOr<MiddleStruct> FromValue(const xls::Value& value);
 
@@ -587,6 +624,10 @@ struct MiddleStruct {
   static constexpr int64_t kZWidth = 48;
 };
 
+// Zero-copy view of MiddleStruct over a packed buffer (see xls/ir/value_view.h);
+// tuple element indexes match member declaration order.
+using MiddleStructView = xls::PackedTupleView<xls::PackedBitsView<48>, InnerStructView>;
+
 struct OtherMiddleStruct {
   static absl::StatusOr<OtherMiddleStruct> FromValue(const xls::Value& value);
 
@@ -600,6 +641,10 @@ struct OtherMiddleStruct {
   static constexpr int64_t kWWidth = 64;
 };
 
+// Zero-copy view of OtherMiddleStruct over a packed buffer (see xls/ir/value_view.h);
+// tuple element indexes match member declaration order.
+using OtherMiddleStructView = xls::PackedTupleView<InnerStructView, xls::PackedBitsView<64>>;
+
 struct OuterStruct {
   static absl::StatusOr<OuterStruct> FromValue(const xls::Value& value);
 
@@ -615,6 +660,10 @@ struct OuterStruct {
   static constexpr int64_t kVWidth = 8;
 };
 
+// Zero-copy view of OuterStruct over a packed buffer (see xls/ir/value_view.h);
+// tuple element indexes match member declaration order.
+using OuterStructView = xls::PackedTupleView<InnerStructView, MiddleStructView, OtherMiddleStructView, xls::PackedBitsView<8>>;
+
 #endif  // FAKE_PATH_H_
 )";
 
@@ -813,6 +862,7 @@ pub enum MyEnum : u32 {
 #include <ostream>
 
 #include "absl/status/statusor.h"
+#include "xls/ir/value_view.h"
 #include "xls/public/value.h"
 
 enum class MyEnum {
@@ -822,6 +872,7 @@ enum class MyEnum {
   kE = 4294967295,
 };
 constexpr int64_t kMyEnumNumElements = 4;
+using MyEnumView = xls::PackedBitsView<32>;
 
 #endif  // TMP_FAKE_PATH_H_
 )";
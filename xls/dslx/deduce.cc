@@ -1007,6 +1007,7 @@ absl::StatusOr<std::unique_ptr<ConcreteType>> DeduceConstantArray(
   }
 
   const ConcreteType& element_type = array_type->element_type();
+  bool all_members_are_numbers = !node->members().empty();
   for (Expr* member : node->members()) {
     XLS_RET_CHECK(IsConstant(member));
     if (Number* number = dynamic_cast<Number*>(member);
@@ -1015,7 +1016,30 @@ absl::StatusOr<std::unique_ptr<ConcreteType>> DeduceConstantArray(
       const BitsType* bits_type = dynamic_cast<const BitsType*>(&element_type);
       XLS_RET_CHECK_NE(bits_type, nullptr);
       XLS_RETURN_IF_ERROR(TryEnsureFitsInType(*number, *bits_type));
+    } else {
+      all_members_are_numbers = false;
+    }
+  }
+
+  // Fast path for data-table style literals, e.g. as generated by
+  // proto_to_dslx: when every member is an unannotated Number the loop above
+  // has already given each member the annotated element type and checked that
+  // its value fits, so only the array size remains to be verified. The
+  // general DeduceArray path below additionally clones and compares one
+  // ConcreteType per element, which dominates typechecking of multi-MB data
+  // tables.
+  if (all_members_are_numbers && !node->has_ellipsis()) {
+    auto dim = ConcreteTypeDim::CreateU32(node->members().size());
+    if (array_type->size() != dim) {
+      ArrayType inferred(element_type.CloneToUnique(), dim);
+      return XlsTypeErrorStatus(
+          node->span(), *array_type, inferred,
+          absl::StrFormat("Annotated array size %s does not match "
+                          "inferred array size %d.",
+                          array_type->size().ToString(),
+                          node->members().size()));
     }
+    return type;
   }
 
   XLS_RETURN_IF_ERROR(DeduceArray(node, ctx).status());
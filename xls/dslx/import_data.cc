@@ -24,7 +24,60 @@ namespace xls::dslx {
   return ImportTokens(absl::StrSplit(module_name, '.'));
 }
 
+/* static */ bool ConstexprCache::IsCacheable(const InterpValue& value) {
+  if (value.IsChannel() || value.IsToken()) {
+    return false;
+  }
+  if (value.IsTuple() || value.IsArray()) {
+    for (const InterpValue& element : value.GetValuesOrDie()) {
+      if (!IsCacheable(element)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+std::optional<InterpValue> ConstexprCache::Lookup(
+    const Expr* expr, absl::string_view env_fingerprint) {
+  auto it =
+      cache_.find(std::make_pair(expr, std::string(env_fingerprint)));
+  if (it == cache_.end()) {
+    misses_ += 1;
+    return std::nullopt;
+  }
+  hits_ += 1;
+  return it->second;
+}
+
+void ConstexprCache::Insert(const Expr* expr, std::string env_fingerprint,
+                            InterpValue value) {
+  if (!IsCacheable(value)) {
+    return;
+  }
+  cache_.insert(
+      {std::make_pair(expr, std::move(env_fingerprint)), std::move(value)});
+}
+
+void ConstexprCache::ForgetModule(const Module* module) {
+  std::vector<std::pair<const Expr*, std::string>> to_erase;
+  for (const auto& pair : cache_) {
+    if (pair.first.first->owner() == module) {
+      to_erase.push_back(pair.first);
+    }
+  }
+  for (const auto& key : to_erase) {
+    cache_.erase(key);
+  }
+}
+
+bool ImportData::Contains(const ImportTokens& target) const {
+  absl::MutexLock lock(modules_mutex_.get());
+  return modules_.find(target) != modules_.end();
+}
+
 absl::StatusOr<ModuleInfo*> ImportData::Get(const ImportTokens& subject) {
+  absl::MutexLock lock(modules_mutex_.get());
   auto it = modules_.find(subject);
   if (it == modules_.end()) {
     return absl::NotFoundError("Module information was not found for import " +
@@ -35,6 +88,7 @@ absl::StatusOr<ModuleInfo*> ImportData::Get(const ImportTokens& subject) {
 
 absl::StatusOr<ModuleInfo*> ImportData::Put(
     const ImportTokens& subject, std::unique_ptr<ModuleInfo> module_info) {
+  absl::MutexLock lock(modules_mutex_.get());
   auto* pmodule_info = module_info.get();
   auto [it, inserted] = modules_.emplace(subject, std::move(module_info));
   if (!inserted) {
@@ -45,6 +99,95 @@ absl::StatusOr<ModuleInfo*> ImportData::Put(
   return pmodule_info;
 }
 
+bool ImportData::PutParsedModule(const ImportTokens& subject,
+                                 std::unique_ptr<Module> module,
+                                 std::filesystem::path path) {
+  absl::MutexLock lock(modules_mutex_.get());
+  if (modules_.contains(subject) || parsed_modules_.contains(subject)) {
+    return false;
+  }
+  parsed_modules_.emplace(subject,
+                          ParsedModule{std::move(module), std::move(path)});
+  return true;
+}
+
+std::optional<ParsedModule> ImportData::TakeParsedModule(
+    const ImportTokens& subject) {
+  absl::MutexLock lock(modules_mutex_.get());
+  auto it = parsed_modules_.find(subject);
+  if (it == parsed_modules_.end()) {
+    return std::nullopt;
+  }
+  ParsedModule result = std::move(it->second);
+  parsed_modules_.erase(it);
+  return result;
+}
+
+std::vector<std::string> ImportData::GetModuleFilePaths() const {
+  absl::MutexLock lock(modules_mutex_.get());
+  std::vector<std::string> paths;
+  paths.reserve(path_to_module_info_.size());
+  for (const auto& pair : path_to_module_info_) {
+    paths.push_back(pair.first);
+  }
+  return paths;
+}
+
+int64_t ImportData::InvalidateModulesForPaths(
+    const absl::flat_hash_set<std::string>& paths) {
+  absl::MutexLock lock(modules_mutex_.get());
+
+  // Seed with the modules loaded from the given files, then grow the set to
+  // fixpoint with their transitive importers: imports form a DAG, so once all
+  // importers of an invalid module are invalid, no retained module can
+  // reference a removed AST.
+  absl::flat_hash_set<std::string> invalid_paths(paths.begin(), paths.end());
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (const auto& pair : modules_) {
+      const ModuleInfo& info = *pair.second;
+      if (invalid_paths.contains(info.path().string())) {
+        continue;
+      }
+      for (const auto& name_and_import : info.module().GetImportByName()) {
+        auto it =
+            modules_.find(ImportTokens(name_and_import.second->subject()));
+        if (it != modules_.end() &&
+            invalid_paths.contains(it->second->path().string())) {
+          invalid_paths.insert(info.path().string());
+          changed = true;
+          break;
+        }
+      }
+    }
+  }
+
+  // Drop all per-module side state before destroying the module ASTs, since
+  // some of it (e.g. the constexpr cache) must inspect the AST to find its
+  // entries.
+  std::vector<ImportTokens> to_erase;
+  for (auto& pair : modules_) {
+    ModuleInfo& info = *pair.second;
+    if (!invalid_paths.contains(info.path().string())) {
+      continue;
+    }
+    Module* module = &info.module();
+    constexpr_cache_.ForgetModule(module);
+    top_level_bindings_.erase(module);
+    top_level_bindings_done_.erase(module);
+    typecheck_wip_.erase(module);
+    type_info_owner_.ForgetRootTypeInfo(module);
+    path_to_module_info_.erase(info.path().string());
+    to_erase.push_back(pair.first);
+  }
+  for (const ImportTokens& subject : to_erase) {
+    modules_.erase(subject);
+    parsed_modules_.erase(subject);
+  }
+  return to_erase.size();
+}
+
 absl::StatusOr<TypeInfo*> ImportData::GetRootTypeInfoForNode(
     const AstNode* node) {
   XLS_RET_CHECK(node != nullptr);
@@ -106,6 +249,7 @@ absl::StatusOr<const StructDef*> ImportData::FindStructDef(
 }
 
 absl::StatusOr<const Module*> ImportData::FindModule(const Span& span) const {
+  absl::MutexLock lock(modules_mutex_.get());
   auto it = path_to_module_info_.find(span.filename());
   if (it == path_to_module_info_.end()) {
     std::vector<std::string> paths;
@@ -17,7 +17,11 @@
 
 #include <filesystem>
 #include <memory>
+#include <optional>
+#include <utility>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
 #include "xls/dslx/ast.h"
 #include "xls/dslx/bytecode_cache_interface.h"
 #include "xls/dslx/default_dslx_stdlib_path.h"
@@ -90,23 +94,88 @@ class ImportTokens {
   std::vector<std::string> pieces_;
 };
 
+// A module that has been parsed but not yet typechecked; produced by the
+// parallel parse pass (see ParseAndTypecheckParallel) and consumed by
+// DoImport when typechecking reaches the corresponding import statement.
+struct ParsedModule {
+  std::unique_ptr<Module> module;
+  std::filesystem::path path;
+};
+
+// Memo table for constexpr evaluation results, shared across all modules
+// imported into one ImportData.
+//
+// Heavily-parameterized code re-evaluates the same constant expressions once
+// per parametric instantiation; since the result is fully determined by the
+// expression node and the constexpr environment it is evaluated under, repeat
+// instantiations can reuse the value computed the first time. Keys combine AST
+// node identity with a textual fingerprint of the environment (see
+// ConstexprEvaluator::InterpretExpr for how the fingerprint is built).
+//
+// Values that carry per-evaluation identity -- channels and tokens -- are
+// never cached; each instantiation must observe distinct objects for those.
+class ConstexprCache {
+ public:
+  // Returns true if "value" may be memoized, i.e. it contains no channels or
+  // tokens (including transitively inside aggregates).
+  static bool IsCacheable(const InterpValue& value);
+
+  // Returns the memoized result of evaluating "expr" under the environment
+  // with the given fingerprint, if present. Updates the hit/miss counters.
+  std::optional<InterpValue> Lookup(const Expr* expr,
+                                    absl::string_view env_fingerprint);
+
+  // Records the result of evaluating "expr" under the given environment.
+  // Non-cacheable values are silently dropped (see class comment).
+  void Insert(const Expr* expr, std::string env_fingerprint,
+              InterpValue value);
+
+  // Drops all entries whose expression belongs to the given module. Must be
+  // called before the module's AST is destroyed, since a later allocation
+  // could otherwise alias a cached node's address.
+  void ForgetModule(const Module* module);
+
+  // Counters for tuning cache effectiveness; every Lookup() call increments
+  // exactly one of them.
+  int64_t hits() const { return hits_; }
+  int64_t misses() const { return misses_; }
+
+ private:
+  absl::flat_hash_map<std::pair<const Expr*, std::string>, InterpValue> cache_;
+  int64_t hits_ = 0;
+  int64_t misses_ = 0;
+};
+
 // Wrapper around a {subject: module_info} mapping that modules can be imported
 // into.
 // Use the routines in create_import_data.h to instantiate an object.
+//
+// Module registration (Contains/Get/Put and the parsed-module methods below)
+// is safe to call from multiple threads; the rest of the object is not
+// thread-safe and typechecking remains single-threaded.
 class ImportData {
  public:
   // All instantiations of ImportData should pass a stdlib_path as below.
   ImportData() = delete;
 
-  bool Contains(const ImportTokens& target) const {
-    return modules_.find(target) != modules_.end();
-  }
+  bool Contains(const ImportTokens& target) const;
 
   absl::StatusOr<ModuleInfo*> Get(const ImportTokens& subject);
 
   absl::StatusOr<ModuleInfo*> Put(const ImportTokens& subject,
                                   std::unique_ptr<ModuleInfo> module_info);
 
+  // Registers a parsed-but-not-yet-typechecked module for the given import
+  // subject. Returns false (dropping the module) if the subject already has a
+  // parsed or typechecked module registered.
+  bool PutParsedModule(const ImportTokens& subject,
+                       std::unique_ptr<Module> module,
+                       std::filesystem::path path);
+
+  // Removes and returns the parsed module for the given subject, if one was
+  // registered via PutParsedModule; the caller takes ownership.
+  std::optional<ParsedModule> TakeParsedModule(const ImportTokens& subject);
+
   TypeInfoOwner& type_info_owner() { return type_info_owner_; }
 
   // Helper that gets the "root" type information for the module of the given
@@ -159,6 +228,26 @@ class ImportData {
   void SetBytecodeCache(std::unique_ptr<BytecodeCacheInterface> bytecode_cache);
   BytecodeCacheInterface* bytecode_cache();
 
+  // Returns the file paths of all modules registered via Put(); i.e. the set
+  // of files whose contents this object's state depends on.
+  std::vector<std::string> GetModuleFilePaths() const;
+
+  // Removes the modules loaded from the given files and, transitively,
+  // every module that imports one of them (importers hold references into
+  // their importees' ASTs, so they must be reloaded together). Associated
+  // per-module state (top-level bindings, constexpr cache entries, root type
+  // information) is dropped as well, so the next import of an affected module
+  // re-parses and re-typechecks it from the file. Returns the number of
+  // modules removed.
+  //
+  // This is the invalidation step of the interpreter's watch mode; modules
+  // not reachable from the given paths keep their typechecked state.
+  int64_t InvalidateModulesForPaths(
+      const absl::flat_hash_set<std::string>& paths);
+
+  // Memo table for constexpr evaluation results; see ConstexprCache above.
+  ConstexprCache& constexpr_cache() { return constexpr_cache_; }
+
   // Helpers for finding nodes in the cluster of modules managed by this object.
   //
   // These return a NotFound error if _either_ the module (implicitly
@@ -188,13 +277,23 @@ class ImportData {
   // module is not available.
   absl::StatusOr<const Module*> FindModule(const Span& span) const;
 
-  absl::flat_hash_map<ImportTokens, std::unique_ptr<ModuleInfo>> modules_;
-  absl::flat_hash_map<std::string, ModuleInfo*> path_to_module_info_;
+  // Guards the typechecked- and parsed-module registries so the parallel
+  // parse pass can register modules from worker threads. Heap-allocated to
+  // keep ImportData movable (see the factories in create_import_data.h).
+  std::unique_ptr<absl::Mutex> modules_mutex_ =
+      std::make_unique<absl::Mutex>();
+  absl::flat_hash_map<ImportTokens, std::unique_ptr<ModuleInfo>> modules_
+      ABSL_GUARDED_BY(modules_mutex_);
+  absl::flat_hash_map<std::string, ModuleInfo*> path_to_module_info_
+      ABSL_GUARDED_BY(modules_mutex_);
+  absl::flat_hash_map<ImportTokens, ParsedModule> parsed_modules_
+      ABSL_GUARDED_BY(modules_mutex_);
   absl::flat_hash_map<Module*, std::unique_ptr<InterpBindings>>
       top_level_bindings_;
   absl::flat_hash_set<Module*> top_level_bindings_done_;
   absl::flat_hash_map<Module*, AstNode*> typecheck_wip_;
   TypeInfoOwner type_info_owner_;
+  ConstexprCache constexpr_cache_;
   std::string stdlib_path_;
   absl::Span<const std::filesystem::path> additional_search_paths_;
   std::unique_ptr<BytecodeCacheInterface> bytecode_cache_;
@@ -25,7 +25,7 @@
 
 namespace xls::dslx {
 
-static absl::StatusOr<std::filesystem::path> FindExistingPath(
+absl::StatusOr<std::filesystem::path> FindImportPath(
     const ImportTokens& subject, absl::string_view stdlib_path,
     absl::Span<const std::filesystem::path> additional_search_paths,
     const Span& import_span) {
@@ -131,10 +131,23 @@ absl::StatusOr<ModuleInfo*> DoImport(const TypecheckModuleFn& ftypecheck,
 
   XLS_VLOG(3) << "DoImport (uncached) subject: " << subject.ToString();
 
+  // The parallel parse pass (see ParseAndTypecheckParallel) may have already
+  // parsed this module; if so, consume the parsed module instead of re-reading
+  // and re-parsing the file.
+  if (std::optional<ParsedModule> parsed =
+          import_data->TakeParsedModule(subject)) {
+    XLS_ASSIGN_OR_RETURN(TypeInfo * type_info,
+                         ftypecheck(parsed->module.get()));
+    return import_data->Put(
+        subject, std::make_unique<ModuleInfo>(std::move(parsed->module),
+                                              type_info,
+                                              std::move(parsed->path)));
+  }
+
   XLS_ASSIGN_OR_RETURN(
       std::filesystem::path found_path,
-      FindExistingPath(subject, import_data->stdlib_path(),
-                       import_data->additional_search_paths(), import_span));
+      FindImportPath(subject, import_data->stdlib_path(),
+                     import_data->additional_search_paths(), import_span));
   XLS_ASSIGN_OR_RETURN(std::string contents, GetFileContents(found_path));
 
   absl::Span<std::string const> pieces = subject.pieces();
@@ -49,6 +49,16 @@ absl::StatusOr<ModuleInfo*> DoImport(const TypecheckModuleFn& ftypecheck,
                                      ImportData* import_data,
                                      const Span& import_span);
 
+// Resolves 'subject' to a DSLX file on disk by probing the standard library,
+// the working directory, runfiles, and the additional search paths, in the
+// same order DoImport does. Does not read or parse the file; exposed so the
+// parallel parse pass (see ParseAndTypecheckParallel) can resolve imports
+// without importing them. "import_span" is used for error reporting.
+absl::StatusOr<std::filesystem::path> FindImportPath(
+    const ImportTokens& subject, absl::string_view stdlib_path,
+    absl::Span<const std::filesystem::path> additional_search_paths,
+    const Span& import_span);
+
 }  // namespace xls::dslx
 
 #endif  // XLS_DSLX_IMPORT_ROUTINES_H_
@@ -15,13 +15,24 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <filesystem>
+#include <iostream>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/flags/flag.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/init_xls.h"
 #include "xls/dslx/command_line_utils.h"
+#include "xls/dslx/create_import_data.h"
 #include "xls/dslx/error_printer.h"
+#include "xls/dslx/import_data.h"
 #include "xls/dslx/run_routines.h"
 
 // LINT.IfChange
@@ -40,6 +51,15 @@ ABSL_FLAG(
 // TODO(leary): 2021-01-19 allow filters with wildcards.
 ABSL_FLAG(std::string, test_filter, "",
           "Target (currently *single*) test name to run.");
+ABSL_FLAG(std::string, bytecode_cache_dir, "",
+          "When set, persists emitted interpreter bytecode in this directory"
+          " so repeated runs over unchanged modules skip bytecode emission;"
+          " empty disables the on-disk cache.");
+ABSL_FLAG(bool, watch, false,
+          "Stay resident after the run and watch the entry module and"
+          " everything it transitively imports; when a file changes, only the"
+          " invalidated modules are re-typechecked (in dependency order) and"
+          " the tests are re-run. Exit with Ctrl-C.");
 // LINT.ThenChange(//xls/build_rules/xls_dslx_rules.bzl)
 
 namespace xls::dslx {
@@ -60,7 +80,9 @@ absl::Status RealMain(absl::string_view entry_module_path,
                       std::optional<std::string> test_filter,
                       FormatPreference trace_format_preference,
                       CompareFlag compare_flag, bool execute,
-                      std::optional<int64_t> seed, bool* printed_error) {
+                      std::optional<int64_t> seed,
+                      std::optional<std::filesystem::path> bytecode_cache_dir,
+                      ImportData* import_data, bool* printed_error) {
   XLS_ASSIGN_OR_RETURN(std::string program, GetFileContents(entry_module_path));
   XLS_ASSIGN_OR_RETURN(std::string module_name, PathToName(entry_module_path));
   std::optional<RunComparator> run_comparator;
@@ -81,6 +103,8 @@ absl::Status RealMain(absl::string_view entry_module_path,
       .run_comparator = run_comparator ? &run_comparator.value() : nullptr,
       .execute = execute,
       .seed = seed,
+      .bytecode_cache_dir = bytecode_cache_dir,
+      .import_data = import_data,
   };
   XLS_ASSIGN_OR_RETURN(
       TestResult test_result,
@@ -89,6 +113,81 @@ absl::Status RealMain(absl::string_view entry_module_path,
   return absl::OkStatus();
 }
 
+// Runs the tests, then blocks until a file in the import DAG changes, evicts
+// the modules invalidated by the change, and runs again. Modules untouched by
+// an edit keep their typechecked state in "import_data" across iterations, so
+// an inner-loop iteration only pays for the modules it dirtied.
+absl::Status WatchMain(
+    absl::string_view entry_module_path,
+    absl::Span<const std::filesystem::path> dslx_paths,
+    std::optional<std::string> test_filter,
+    FormatPreference trace_format_preference, CompareFlag compare_flag,
+    bool execute, std::optional<int64_t> seed,
+    std::optional<std::filesystem::path> bytecode_cache_dir) {
+  constexpr absl::Duration kPollInterval = absl::Milliseconds(50);
+
+  ImportData import_data(
+      CreateImportData(xls::kDefaultDslxStdlibPath, dslx_paths));
+  while (true) {
+    bool printed_error = false;
+    absl::Status status =
+        RealMain(entry_module_path, dslx_paths, test_filter,
+                 trace_format_preference, compare_flag, execute, seed,
+                 bytecode_cache_dir, &import_data, &printed_error);
+    if (!status.ok()) {
+      // In watch mode errors (e.g. a syntax error mid-edit) are part of the
+      // loop, not a reason to exit.
+      std::cerr << status << std::endl;
+    }
+
+    // Snapshot mtimes and contents of everything the run depended on. The
+    // mtime is a cheap change detector; contents decide (editors commonly
+    // rewrite files without changing them).
+    std::vector<std::string> watched = import_data.GetModuleFilePaths();
+    watched.push_back(std::string(entry_module_path));
+    absl::flat_hash_map<std::string, std::filesystem::file_time_type> mtimes;
+    absl::flat_hash_map<std::string, std::string> contents;
+    for (const std::string& path : watched) {
+      std::error_code ec;
+      mtimes[path] = std::filesystem::last_write_time(path, ec);
+      absl::StatusOr<std::string> text = GetFileContents(path);
+      contents[path] = text.ok() ? std::move(text).value() : std::string();
+    }
+    std::cerr << absl::StreamFormat(
+                     "[===============] watching %d file(s) for changes...",
+                     contents.size())
+              << std::endl;
+
+    absl::flat_hash_set<std::string> changed;
+    while (changed.empty()) {
+      absl::SleepFor(kPollInterval);
+      for (auto& pair : mtimes) {
+        const std::string& path = pair.first;
+        std::error_code ec;
+        std::filesystem::file_time_type mtime =
+            std::filesystem::last_write_time(path, ec);
+        if (ec || mtime == pair.second) {
+          // Unreadable typically means mid-save; we'll see it next poll.
+          continue;
+        }
+        pair.second = mtime;
+        absl::StatusOr<std::string> text = GetFileContents(path);
+        if (!text.ok() || text.value() == contents[path]) {
+          continue;
+        }
+        contents[path] = std::move(text).value();
+        changed.insert(path);
+      }
+    }
+
+    int64_t invalidated = import_data.InvalidateModulesForPaths(changed);
+    std::cerr << absl::StreamFormat(
+                     "[===============] %s changed; re-checking %d module(s).",
+                     absl::StrJoin(changed, ", "), invalidated)
+              << std::endl;
+  }
+}
+
 }  // namespace
 }  // namespace xls::dslx
 
@@ -142,10 +241,25 @@ int main(int argc, char* argv[]) {
   XLS_QCHECK_OK(preference.status())
       << "-trace_format_preference accepts default|binary|hex|decimal";
 
+  std::optional<std::filesystem::path> bytecode_cache_dir;
+  if (std::string flag = absl::GetFlag(FLAGS_bytecode_cache_dir);
+      !flag.empty()) {
+    bytecode_cache_dir = std::filesystem::path(std::move(flag));
+  }
+
+  if (absl::GetFlag(FLAGS_watch)) {
+    // Only returns on error; the loop itself is exited with Ctrl-C.
+    XLS_QCHECK_OK(xls::dslx::WatchMain(args[0], dslx_paths, test_filter,
+                                       preference.value(), compare_flag,
+                                       execute, seed, bytecode_cache_dir));
+    return EXIT_SUCCESS;
+  }
+
   bool printed_error = false;
   absl::Status status = xls::dslx::RealMain(
-      args[0], dslx_paths, test_filter, preference.value(),
-      compare_flag, execute, seed, &printed_error);
+      args[0], dslx_paths, test_filter, preference.value(), compare_flag,
+      execute, seed, bytecode_cache_dir, /*import_data=*/nullptr,
+      &printed_error);
   if (printed_error) {
     return EXIT_FAILURE;
   }
@@ -46,12 +46,52 @@
 namespace xls::dslx {
 namespace {
 
+// Dense identifier assigned to a mangled function name; see
+// PackageData::InternMangledName().
+using SymbolId = int64_t;
+
 // Bundles together a package pointer with a supplementary map we keep that
 // shows the DSLX function that led to IR functions in the package.
+//
+// Also keeps an interned-symbol index over mangled function names: a mangled
+// name is hashed once (when interned) to get a dense SymbolId, and converted
+// functions are recorded under their id, so callee resolution during
+// conversion is a vector index instead of a linear scan of the package's
+// functions with string comparisons for every invocation.
 struct PackageData {
   Package* package;
   absl::flat_hash_map<xls::FunctionBase*, dslx::Function*> ir_to_dslx;
   absl::flat_hash_set<xls::Function*> wrappers;
+
+  // Interns "mangled_name", assigning the next dense SymbolId on first use.
+  // On first use the package is also consulted (once), so functions already
+  // present in a caller-provided package resolve via the index as well.
+  SymbolId InternMangledName(absl::string_view mangled_name) {
+    auto [it, inserted] = symbol_ids.try_emplace(
+        std::string(mangled_name),
+        static_cast<SymbolId>(id_to_function.size()));
+    if (inserted) {
+      xls::Function* f = nullptr;
+      if (package->HasFunctionWithName(mangled_name)) {
+        f = package->GetFunction(mangled_name).value();
+      }
+      id_to_function.push_back(f);
+    }
+    return it->second;
+  }
+
+  // Records "f" as the IR function built for the (previously interned) "id".
+  void NoteFunctionForSymbol(SymbolId id, xls::Function* f) {
+    id_to_function[id] = f;
+  }
+
+  // Returns the IR function converted under "id", or nullptr if no function
+  // with that mangled name has been built (yet).
+  xls::Function* FindFunction(SymbolId id) const { return id_to_function[id]; }
+
+  // Mangled name -> dense symbol id; ids index into id_to_function.
+  absl::flat_hash_map<std::string, SymbolId> symbol_ids;
+  std::vector<xls::Function*> id_to_function;
 };
 
 // Returns a status that indicates an error in the IR conversion process.
@@ -804,6 +844,11 @@ FunctionConverter::FunctionConverter(PackageData& package_data, Module* module,
 void FunctionConverter::SetFunctionBuilder(
     std::unique_ptr<BuilderBase> builder) {
   XLS_CHECK(function_builder_ == nullptr);
+  // The converter emits nodes from typechecked DSLX so per-node verification
+  // during construction is redundant with the whole-function verification done
+  // at Build() time. Deferring it measurably speeds conversion of large
+  // (e.g. unrolled-loop) function bodies.
+  builder->SetDeferNodeVerification(true);
   function_builder_ = std::move(builder);
 }
 
@@ -1753,11 +1798,12 @@ absl::StatusOr<BValue> FunctionConverter::DefMapWithBuiltin(
                        MangleDslxName(module_->name(), node->identifier(),
                                       CallingConvention::kTypical,
                                       /*free_keys=*/{}, &symbolic_bindings));
+  const SymbolId symbol_id = package_data_.InternMangledName(mangled_name);
   XLS_ASSIGN_OR_RETURN(BValue arg_value, Use(arg));
   XLS_VLOG(5) << "Mapping with builtin; arg: "
               << arg_value.GetType()->ToString();
   auto* array_type = arg_value.GetType()->AsArrayOrDie();
-  if (!package()->HasFunctionWithName(mangled_name)) {
+  if (package_data_.FindFunction(symbol_id) == nullptr) {
     FunctionBuilder fb(mangled_name, package());
     BValue param = fb.Param("arg", array_type->element_type());
     const std::string& builtin_name = node->identifier();
@@ -1770,10 +1816,11 @@ absl::StatusOr<BValue> FunctionConverter::DefMapWithBuiltin(
       return absl::InternalError("Invalid builtin name for map: " +
                                  builtin_name);
     }
-    XLS_RETURN_IF_ERROR(fb.Build().status());
+    XLS_ASSIGN_OR_RETURN(xls::Function * built, fb.Build());
+    package_data_.NoteFunctionForSymbol(symbol_id, built);
   }
 
-  XLS_ASSIGN_OR_RETURN(xls::Function * f, package()->GetFunction(mangled_name));
+  xls::Function* f = package_data_.FindFunction(symbol_id);
   return Def(parent_node, [&](const SourceInfo& loc) {
     return function_builder_->Map(arg_value, f);
   });
@@ -1821,7 +1868,12 @@ absl::StatusOr<BValue> FunctionConverter::HandleMap(const Invocation* node) {
                      free_set, node_sym_bindings.value()));
   XLS_VLOG(5) << "Getting function with mangled name: " << mangled_name
               << " from package: " << package()->name();
-  XLS_ASSIGN_OR_RETURN(xls::Function * f, package()->GetFunction(mangled_name));
+  xls::Function* f =
+      package_data_.FindFunction(package_data_.InternMangledName(mangled_name));
+  if (f == nullptr) {
+    return absl::NotFoundError(absl::StrFormat(
+        "Package does not have a function with name: \"%s\"", mangled_name));
+  }
   return Def(node, [&](const SourceInfo& loc) -> BValue {
     return function_builder_->Map(arg, f, loc);
   });
@@ -2036,9 +2088,9 @@ absl::Status FunctionConverter::HandleInvocation(const Invocation* node) {
     return values;
   };
 
-  if (package()->HasFunctionWithName(called_name)) {
-    XLS_ASSIGN_OR_RETURN(xls::Function * f,
-                         package()->GetFunction(called_name));
+  if (xls::Function* f = package_data_.FindFunction(
+          package_data_.InternMangledName(called_name));
+      f != nullptr) {
     XLS_ASSIGN_OR_RETURN(std::vector<BValue> args, accept_args());
     return HandleUdfInvocation(node, f, std::move(args));
   }
@@ -2450,6 +2502,7 @@ absl::StatusOr<xls::Function*> FunctionConverter::HandleFunction(
                      requires_implicit_token ? CallingConvention::kImplicitToken
                                              : CallingConvention::kTypical,
                      node->GetFreeParametricKeySet(), symbolic_bindings));
+  const SymbolId symbol_id = package_data_.InternMangledName(mangled_name);
   auto builder = std::make_unique<FunctionBuilder>(mangled_name, package());
   auto* builder_ptr = builder.get();
   SetFunctionBuilder(std::move(builder));
@@ -2527,8 +2580,11 @@ absl::StatusOr<xls::Function*> FunctionConverter::HandleFunction(
     XLS_ASSIGN_OR_RETURN(xls::Function * wrapper,
                          EmitImplicitTokenEntryWrapper(f, node, is_top_));
     package_data_.wrappers.insert(wrapper);
+    package_data_.NoteFunctionForSymbol(
+        package_data_.InternMangledName(wrapper->name()), wrapper);
   }
 
+  package_data_.NoteFunctionForSymbol(symbol_id, f);
   package_data_.ir_to_dslx[f] = node;
   return f;
 }
@@ -3504,11 +3560,29 @@ static absl::Status ConvertCallGraph(
         first_proc_config->type_info(), package_data, &proc_data));
   }
 
+  // Identical (function, parametric env) instantiations can appear multiple
+  // times in the order; e.g. when two procs invoke the same function, each
+  // proc's call graph contributes its own record. Converting each occurrence
+  // would emit a duplicate function body into the package, so we convert each
+  // instantiation once -- later callers resolve the already-emitted function
+  // by its mangled name. Procs are excluded since each instance carries its
+  // own member/channel state.
+  absl::flat_hash_set<std::pair<Function*, SymbolicBindings>> converted;
+  int64_t conversions_avoided = 0;
   for (const ConversionRecord& record : order) {
+    if (record.f()->tag() == Function::Tag::kNormal && !record.HasProcId() &&
+        !converted.insert({record.f(), record.symbolic_bindings()}).second) {
+      conversions_avoided += 1;
+      XLS_VLOG(3) << "Skipping duplicate conversion: " << record.ToString();
+      continue;
+    }
     XLS_VLOG(3) << "Converting to IR: " << record.ToString();
     XLS_RETURN_IF_ERROR(ConvertOneFunctionInternal(
         package_data, record, import_data, &proc_data, options));
   }
+  XLS_VLOG(3) << "Avoided " << conversions_avoided
+              << " duplicate function conversion(s) out of " << order.size()
+              << " conversion record(s).";
 
   XLS_VLOG(3) << "Verifying converted package";
   if (options.verify_ir) {
@@ -1684,6 +1684,43 @@ TEST(IrConverterTest, TopProcWithState) {
   ExpectIr(converted, TestName());
 }
 
+TEST(IrConverterTest, DuplicateParametricInstantiationConvertedOnce) {
+  // The parametric instantiation below is reachable both from a module-level
+  // function and from a proc, so the conversion order contains it twice; only
+  // one IR function body should be emitted for it.
+  constexpr absl::string_view kProgram = R"(
+fn parametric_id<N: u32>(x: bits[N]) -> bits[N] { x }
+
+fn main(x: u32) -> u32 { parametric_id(x) }
+
+proc p {
+  c: chan out u32;
+  config(input_c: chan out u32) {
+    (input_c,)
+  }
+  next(tok: token) {
+    let tok = send(tok, c, parametric_id(u32:7));
+    ()
+  }
+}
+)";
+
+  ConvertOptions options;
+  options.emit_fail_as_assert = false;
+  options.emit_positions = false;
+  options.verify_ir = false;
+  XLS_ASSERT_OK_AND_ASSIGN(std::string converted,
+                           ConvertModuleForTest(kProgram, options));
+
+  constexpr absl::string_view kNeedle = "fn __test_module__parametric_id__32(";
+  int64_t occurrences = 0;
+  for (std::string::size_type pos = converted.find(kNeedle);
+       pos != std::string::npos; pos = converted.find(kNeedle, pos + 1)) {
+    occurrences += 1;
+  }
+  EXPECT_EQ(occurrences, 1) << converted;
+}
+
 }  // namespace
 }  // namespace xls::dslx
 
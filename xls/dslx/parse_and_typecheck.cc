@@ -14,15 +14,148 @@
 
 #include "xls/dslx/parse_and_typecheck.h"
 
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <thread>  // NOLINT(build/c++11)
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_join.h"
+#include "absl/synchronization/mutex.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/file/get_runfile_path.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/dslx/parser.h"
 #include "xls/dslx/scanner.h"
 #include "xls/dslx/typecheck.h"
 
 namespace xls::dslx {
+namespace {
+
+// Parses the transitive import DAG of a root module across a pool of worker
+// threads, registering each parsed module with the ImportData (see
+// ImportData::PutParsedModule). Workers pull import subjects from a shared
+// work list and push the imports of each module they parse, so independent
+// subtrees of the DAG are parsed concurrently; the scheduled set ensures each
+// subject is parsed at most once.
+class ParallelImportParser {
+ public:
+  explicit ParallelImportParser(ImportData* import_data)
+      : import_data_(import_data) {}
+
+  // Parses the transitive imports of "root". Returns the first error
+  // encountered (resolution, I/O, or parse); on error pending work is
+  // abandoned and the workers drain and exit.
+  absl::Status ParseDag(Module* root) {
+    ScheduleImports(root);
+    int64_t num_workers;
+    {
+      absl::MutexLock lock(&mutex_);
+      if (outstanding_ == 0) {
+        return absl::OkStatus();
+      }
+      num_workers = std::min(
+          outstanding_,
+          std::max(int64_t{1},
+                   static_cast<int64_t>(std::thread::hardware_concurrency())));
+    }
+    std::vector<std::unique_ptr<Thread>> workers;
+    for (int64_t i = 0; i < num_workers; ++i) {
+      workers.push_back(std::make_unique<Thread>([this] { WorkerFn(); }));
+    }
+    for (std::unique_ptr<Thread>& worker : workers) {
+      worker->Join();
+    }
+    absl::MutexLock lock(&mutex_);
+    return first_error_;
+  }
+
+ private:
+  // An import subject paired with the span of an import statement naming it
+  // (used for error reporting during path resolution).
+  struct WorkItem {
+    ImportTokens subject;
+    Span import_span;
+  };
+
+  // Schedules the (not-yet-scheduled, not-yet-imported) imports of "module".
+  void ScheduleImports(Module* module) {
+    absl::MutexLock lock(&mutex_);
+    for (const auto& [name, import] : module->GetImportByName()) {
+      ImportTokens subject(import->subject());
+      if (scheduled_.contains(subject) || import_data_->Contains(subject)) {
+        continue;
+      }
+      scheduled_.insert(subject);
+      work_.push_back(WorkItem{std::move(subject), import->span()});
+      ++outstanding_;
+    }
+  }
+
+  bool WorkAvailableOrDone() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return !work_.empty() || outstanding_ == 0;
+  }
+
+  void WorkerFn() {
+    while (true) {
+      std::optional<WorkItem> item;
+      {
+        absl::MutexLock lock(&mutex_);
+        mutex_.Await(
+            absl::Condition(this, &ParallelImportParser::WorkAvailableOrDone));
+        if (work_.empty()) {
+          return;
+        }
+        item = std::move(work_.front());
+        work_.pop_front();
+      }
+      absl::Status status = ParseSubject(*item);
+      absl::MutexLock lock(&mutex_);
+      if (!status.ok() && first_error_.ok()) {
+        first_error_ = status;
+        outstanding_ -= static_cast<int64_t>(work_.size());
+        work_.clear();
+      }
+      --outstanding_;
+    }
+  }
+
+  // Resolves, reads, and parses the module for one import subject, then
+  // schedules the imports of the parsed module.
+  absl::Status ParseSubject(const WorkItem& item) {
+    XLS_ASSIGN_OR_RETURN(
+        std::filesystem::path found_path,
+        FindImportPath(item.subject, import_data_->stdlib_path(),
+                       import_data_->additional_search_paths(),
+                       item.import_span));
+    XLS_ASSIGN_OR_RETURN(std::string contents, GetFileContents(found_path));
+    std::string fully_qualified_name =
+        absl::StrJoin(item.subject.pieces(), ".");
+    Scanner scanner(found_path, contents);
+    Parser parser(/*module_name=*/fully_qualified_name, &scanner);
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<Module> module, parser.ParseModule());
+    // Schedule this module's own imports before publishing it so the frontier
+    // keeps growing while other workers are busy.
+    ScheduleImports(module.get());
+    import_data_->PutParsedModule(item.subject, std::move(module),
+                                  std::move(found_path));
+    return absl::OkStatus();
+  }
+
+  ImportData* import_data_;
+  absl::Mutex mutex_;
+  std::deque<WorkItem> work_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_set<ImportTokens> scheduled_ ABSL_GUARDED_BY(mutex_);
+  // Number of scheduled subjects not yet fully processed (queued or being
+  // parsed by a worker); workers exit when this reaches zero.
+  int64_t outstanding_ ABSL_GUARDED_BY(mutex_) = 0;
+  absl::Status first_error_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace
 
 absl::StatusOr<TypecheckedModule> ParseAndTypecheck(
     absl::string_view text, absl::string_view path,
@@ -34,6 +167,18 @@ absl::StatusOr<TypecheckedModule> ParseAndTypecheck(
   return TypecheckModule(std::move(module), path, import_data);
 }
 
+absl::StatusOr<TypecheckedModule> ParseAndTypecheckParallel(
+    absl::string_view text, absl::string_view path,
+    absl::string_view module_name, ImportData* import_data) {
+  XLS_RET_CHECK(import_data != nullptr);
+
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Module> module,
+                       ParseModule(text, path, module_name));
+  XLS_RETURN_IF_ERROR(
+      ParallelImportParser(import_data).ParseDag(module.get()));
+  return TypecheckModule(std::move(module), path, import_data);
+}
+
 absl::StatusOr<std::unique_ptr<Module>> ParseModule(
     absl::string_view text, absl::string_view path,
     absl::string_view module_name) {
@@ -39,6 +39,17 @@ absl::StatusOr<TypecheckedModule> ParseAndTypecheck(
     absl::string_view text, absl::string_view path,
     absl::string_view module_name, ImportData* import_data);
 
+// As ParseAndTypecheck, but pre-parses the transitive import DAG of the module
+// across a pool of worker threads before typechecking: file resolution,
+// reading, and parsing of independent imports proceed concurrently, so the
+// parse phase takes time proportional to the critical path of the import DAG
+// rather than its total size. Typechecking itself builds shared type
+// information and remains serial; it consumes the pre-parsed modules via
+// DoImport instead of parsing at each import site.
+absl::StatusOr<TypecheckedModule> ParseAndTypecheckParallel(
+    absl::string_view text, absl::string_view path,
+    absl::string_view module_name, ImportData* import_data);
+
 // Helper that parses and creates a new module from the given "text".
 //
 // "path" is used for error reporting (`Span`s) and module_name is the name
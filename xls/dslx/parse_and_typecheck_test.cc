@@ -0,0 +1,117 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/parse_and_typecheck.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+#include "xls/dslx/create_import_data.h"
+#include "xls/dslx/default_dslx_stdlib_path.h"
+#include "xls/dslx/import_data.h"
+
+namespace xls::dslx {
+namespace {
+
+using status_testing::StatusIs;
+using ::testing::HasSubstr;
+
+TEST(ParseAndTypecheckParallelTest, NoImports) {
+  ImportData import_data = CreateImportDataForTest();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypecheckedModule tm,
+      ParseAndTypecheckParallel("fn main() -> u32 { u32:42 }", "test.x", "test",
+                                &import_data));
+  EXPECT_EQ(tm.module->name(), "test");
+}
+
+TEST(ParseAndTypecheckParallelTest, ImportDag) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory tempdir, TempDirectory::Create());
+  XLS_ASSERT_OK(SetFileContents(tempdir.path() / "dep_a.x",
+                                "pub fn a() -> u32 { u32:1 }"));
+  XLS_ASSERT_OK(SetFileContents(tempdir.path() / "dep_b.x",
+                                R"(import dep_a
+pub fn b() -> u32 { dep_a::a() + u32:1 })"));
+  std::vector<std::filesystem::path> additional_search_paths = {
+      tempdir.path()};
+  ImportData import_data =
+      CreateImportData(kDefaultDslxStdlibPath, additional_search_paths);
+
+  // Both a direct and a transitive import (a diamond: the root and dep_b both
+  // import dep_a) should resolve against the parsed modules from the parallel
+  // pass.
+  constexpr absl::string_view kProgram = R"(import dep_a
+import dep_b
+fn main() -> u32 { dep_a::a() + dep_b::b() })";
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypecheckedModule tm,
+      ParseAndTypecheckParallel(kProgram, "test.x", "test", &import_data));
+  EXPECT_EQ(tm.module->name(), "test");
+  EXPECT_TRUE(import_data.Contains(ImportTokens({"dep_a"})));
+  EXPECT_TRUE(import_data.Contains(ImportTokens({"dep_b"})));
+  // All parsed modules were consumed by typechecking.
+  EXPECT_FALSE(
+      import_data.TakeParsedModule(ImportTokens({"dep_a"})).has_value());
+}
+
+TEST(ImportDataInvalidationTest, InvalidationRemovesDependentsOnly) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory tempdir, TempDirectory::Create());
+  XLS_ASSERT_OK(SetFileContents(tempdir.path() / "dep_a.x",
+                                "pub fn a() -> u32 { u32:1 }"));
+  XLS_ASSERT_OK(SetFileContents(tempdir.path() / "dep_b.x",
+                                R"(import dep_a
+pub fn b() -> u32 { dep_a::a() + u32:1 })"));
+  std::vector<std::filesystem::path> additional_search_paths = {
+      tempdir.path()};
+  ImportData import_data =
+      CreateImportData(kDefaultDslxStdlibPath, additional_search_paths);
+
+  constexpr absl::string_view kProgram = R"(import dep_a
+import dep_b
+fn main() -> u32 { dep_a::a() + dep_b::b() })";
+  XLS_ASSERT_OK(
+      ParseAndTypecheck(kProgram, "test.x", "test", &import_data).status());
+  EXPECT_EQ(import_data.GetModuleFilePaths().size(), 3);
+
+  // Editing the entry module alone leaves the imported modules loaded.
+  EXPECT_EQ(import_data.InvalidateModulesForPaths({"test.x"}), 1);
+  EXPECT_FALSE(import_data.Contains(ImportTokens({"test"})));
+  EXPECT_TRUE(import_data.Contains(ImportTokens({"dep_a"})));
+  EXPECT_TRUE(import_data.Contains(ImportTokens({"dep_b"})));
+  XLS_ASSERT_OK(
+      ParseAndTypecheck(kProgram, "test.x", "test", &import_data).status());
+
+  // Editing dep_a invalidates its transitive importers (dep_b and the entry)
+  // as well.
+  std::string dep_a_path = std::string(tempdir.path() / "dep_a.x");
+  EXPECT_EQ(import_data.InvalidateModulesForPaths({dep_a_path}), 3);
+  EXPECT_FALSE(import_data.Contains(ImportTokens({"dep_a"})));
+  EXPECT_FALSE(import_data.Contains(ImportTokens({"dep_b"})));
+  XLS_ASSERT_OK(
+      ParseAndTypecheck(kProgram, "test.x", "test", &import_data).status());
+}
+
+TEST(ParseAndTypecheckParallelTest, MissingImportIsAnError) {
+  ImportData import_data = CreateImportDataForTest();
+  EXPECT_THAT(
+      ParseAndTypecheckParallel("import does_not_exist_anywhere", "test.x",
+                                "test", &import_data),
+      StatusIs(absl::StatusCode::kNotFound,
+               HasSubstr("Could not find DSLX file for import")));
+}
+
+}  // namespace
+}  // namespace xls::dslx
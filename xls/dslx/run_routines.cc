@@ -14,6 +14,7 @@
 
 #include "xls/dslx/run_routines.h"
 
+#include <optional>
 #include <random>
 
 #include "xls/dslx/bindings.h"
@@ -41,8 +42,9 @@ constexpr int kQuickcheckSpaces = 15;
 
 absl::Status RunTestFunction(
     ImportData* import_data, TypeInfo* type_info, Module* module,
-    TestFunction* tf, BytecodeInterpreter::PostFnEvalHook post_fn_eval_hook) {
-  auto cache = std::make_unique<BytecodeCache>(import_data);
+    TestFunction* tf, BytecodeInterpreter::PostFnEvalHook post_fn_eval_hook,
+    const std::optional<std::filesystem::path>& bytecode_cache_dir) {
+  auto cache = std::make_unique<BytecodeCache>(import_data, bytecode_cache_dir);
   import_data->SetBytecodeCache(std::move(cache));
   XLS_ASSIGN_OR_RETURN(
       std::unique_ptr<BytecodeFunction> bf,
@@ -52,9 +54,10 @@ absl::Status RunTestFunction(
       .status();
 }
 
-absl::Status RunTestProc(ImportData* import_data, TypeInfo* type_info,
-                         Module* module, TestProc* tp) {
-  auto cache = std::make_unique<BytecodeCache>(import_data);
+absl::Status RunTestProc(
+    ImportData* import_data, TypeInfo* type_info, Module* module, TestProc* tp,
+    const std::optional<std::filesystem::path>& bytecode_cache_dir) {
+  auto cache = std::make_unique<BytecodeCache>(import_data, bytecode_cache_dir);
   import_data->SetBytecodeCache(std::move(cache));
 
   XLS_ASSIGN_OR_RETURN(TypeInfo * ti,
@@ -339,10 +342,15 @@ absl::StatusOr<TestResult> ParseAndTest(absl::string_view program,
     failed += 1;
   };
 
-  ImportData import_data(
-      CreateImportData(options.stdlib_path, options.dslx_paths));
+  std::optional<ImportData> owned_import_data;
+  ImportData* import_data = options.import_data;
+  if (import_data == nullptr) {
+    owned_import_data.emplace(
+        CreateImportData(options.stdlib_path, options.dslx_paths));
+    import_data = &owned_import_data.value();
+  }
   absl::StatusOr<TypecheckedModule> tm_or =
-      ParseAndTypecheck(program, filename, module_name, &import_data);
+      ParseAndTypecheck(program, filename, module_name, import_data);
   if (!tm_or.ok()) {
     if (TryPrintError(tm_or.status())) {
       return TestResult::kSomeFailed;
@@ -363,7 +371,7 @@ absl::StatusOr<TestResult> ParseAndTest(absl::string_view program,
   BytecodeInterpreter::PostFnEvalHook post_fn_eval_hook;
   if (options.run_comparator != nullptr) {
     absl::StatusOr<std::unique_ptr<Package>> ir_package_or =
-        ConvertModuleToPackage(entry_module, &import_data,
+        ConvertModuleToPackage(entry_module, import_data,
                                options.convert_options,
                                /*traverse_tests=*/true);
     if (!ir_package_or.ok()) {
@@ -373,13 +381,13 @@ absl::StatusOr<TestResult> ParseAndTest(absl::string_view program,
       return ir_package_or.status();
     }
     ir_package = std::move(ir_package_or).value();
-    post_fn_eval_hook = [&ir_package, &import_data, &options](
+    post_fn_eval_hook = [&ir_package, import_data, &options](
                             const Function* f,
                             absl::Span<const InterpValue> args,
                             const SymbolicBindings* symbolic_bindings,
                             const InterpValue& got) -> absl::Status {
       std::optional<bool> requires_implicit_token =
-          import_data.GetRootTypeInfoForNode(f)
+          import_data->GetRootTypeInfoForNode(f)
               .value()
               ->GetRequiresImplicitToken(f);
       XLS_RET_CHECK(requires_implicit_token.has_value());
@@ -402,12 +410,13 @@ absl::StatusOr<TestResult> ParseAndTest(absl::string_view program,
     ModuleMember* member = entry_module->FindMemberWithName(test_name).value();
     if (absl::holds_alternative<TestFunction*>(*member)) {
       XLS_ASSIGN_OR_RETURN(TestFunction * tf, entry_module->GetTest(test_name));
-      status = RunTestFunction(&import_data, tm_or.value().type_info,
-                               entry_module, tf, post_fn_eval_hook);
+      status = RunTestFunction(import_data, tm_or.value().type_info,
+                               entry_module, tf, post_fn_eval_hook,
+                               options.bytecode_cache_dir);
     } else {
       XLS_ASSIGN_OR_RETURN(TestProc * tp, entry_module->GetTestProc(test_name));
-      status =
-          RunTestProc(&import_data, tm_or.value().type_info, entry_module, tp);
+      status = RunTestProc(import_data, tm_or.value().type_info, entry_module,
+                           tp, options.bytecode_cache_dir);
     }
 
     if (status.ok()) {
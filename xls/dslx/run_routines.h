@@ -19,6 +19,7 @@
 #define XLS_DSLX_RUN_ROUTINES_H_
 
 #include "xls/dslx/default_dslx_stdlib_path.h"
+#include "xls/dslx/import_data.h"
 #include "xls/dslx/interp_value.h"
 #include "xls/dslx/ir_converter.h"
 #include "xls/dslx/symbolic_bindings.h"
@@ -90,6 +91,15 @@ struct ParseAndTestOptions {
   bool execute = true;
   std::optional<int64_t> seed = absl::nullopt;
   ConvertOptions convert_options;
+  // When set, emitted bytecode is persisted here across processes; see
+  // BytecodeCache.
+  std::optional<std::filesystem::path> bytecode_cache_dir = absl::nullopt;
+  // When set, modules are imported into (and reused from) this caller-owned
+  // object instead of an ImportData created per call. Callers repeating runs
+  // (e.g. the interpreter's watch mode) evict stale modules between runs via
+  // ImportData::InvalidateModulesForPaths, so unchanged imports keep their
+  // typechecked state.
+  ImportData* import_data = nullptr;
 };
 
 enum class TestResult {
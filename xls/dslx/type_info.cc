@@ -215,6 +215,27 @@ void TypeInfo::SetInvocationTypeInfo(const Invocation* invocation,
   data.instantiations[caller] = type_info;
 }
 
+void TypeInfo::NoteInstantiationTypeInfo(const Function* f,
+                                         const SymbolicBindings& bindings,
+                                         TypeInfo* type_info) {
+  XLS_CHECK_EQ(f->owner(), module_);
+  TypeInfo* top = GetRoot();
+  XLS_VLOG(5) << "Type info " << top << " noting instantiation type info for "
+              << f->identifier() << " with bindings: " << bindings.ToString();
+  top->instantiation_type_info_[std::make_pair(f, bindings)] = type_info;
+}
+
+std::optional<TypeInfo*> TypeInfo::GetInstantiationTypeInfo(
+    const Function* f, const SymbolicBindings& bindings) const {
+  XLS_CHECK_EQ(f->owner(), module_);
+  const TypeInfo* top = GetRoot();
+  auto it = top->instantiation_type_info_.find(std::make_pair(f, bindings));
+  if (it == top->instantiation_type_info_.end()) {
+    return absl::nullopt;
+  }
+  return it->second;
+}
+
 absl::Status TypeInfo::SetTopLevelProcTypeInfo(const Proc* p, TypeInfo* ti) {
   if (parent_ != nullptr) {
     return absl::InvalidArgumentError(
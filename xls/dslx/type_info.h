@@ -79,6 +79,14 @@ class TypeInfoOwner {
   // status error if it is not present.
   absl::StatusOr<TypeInfo*> GetRootTypeInfo(const Module* module);
 
+  // Forgets the root type information for the given module so a reloaded
+  // module can register a fresh root (see ImportData module invalidation).
+  // The previously created TypeInfo objects remain owned -- but inert -- until
+  // this owner is destroyed.
+  void ForgetRootTypeInfo(const Module* module) {
+    module_to_root_.erase(module);
+  }
+
  private:
   // Mapping from module to the "root" (or "parentmost") type info -- these have
   // nullptr as their parent. There should only be one of these for any given
@@ -146,6 +154,21 @@ class TypeInfo {
   std::optional<TypeInfo*> GetInvocationTypeInfo(
       const Invocation* invocation, const SymbolicBindings& caller) const;
 
+  // Notes that function "f" has been fully typechecked as instantiated with
+  // "bindings" and that "type_info" holds the resulting derived type
+  // information. Stashed on the root TypeInfo of f's module so that any later
+  // invocation of the same instantiation -- from any caller -- can reuse the
+  // type information instead of re-deducing the function body.
+  void NoteInstantiationTypeInfo(const Function* f,
+                                 const SymbolicBindings& bindings,
+                                 TypeInfo* type_info);
+
+  // Retrieves type information previously noted via
+  // NoteInstantiationTypeInfo, or nullopt if the (function, bindings)
+  // instantiation has not been typechecked yet.
+  std::optional<TypeInfo*> GetInstantiationTypeInfo(
+      const Function* f, const SymbolicBindings& bindings) const;
+
   // Sets the type info for the given proc when typechecked at top-level (i.e.,
   // not via an instantiation). Can only be called on the module root TypeInfo.
   absl::Status SetTopLevelProcTypeInfo(const Proc* p, TypeInfo* ti);
@@ -278,6 +301,12 @@ class TypeInfo {
 
   // Maps a Proc to the TypeInfo used for its top-level typechecking.
   absl::flat_hash_map<const Proc*, TypeInfo*> top_level_proc_type_info_;
+
+  // Maps a fully-typechecked (function, callee bindings) instantiation to its
+  // derived type information so repeated invocations of the same
+  // instantiation skip body re-deduction; only populated on root TypeInfos.
+  absl::flat_hash_map<std::pair<const Function*, SymbolicBindings>, TypeInfo*>
+      instantiation_type_info_;
   TypeInfo* parent_;  // Note: may be nullptr.
 };
 
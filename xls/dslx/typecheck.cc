@@ -714,6 +714,28 @@ absl::StatusOr<TypeAndBindings> CheckInvocation(
     fn_stack.pop_back();
   }
 
+  // If the callee has already been typechecked as instantiated with these
+  // bindings (via some other invocation), reuse the resulting type
+  // information rather than re-deducing the whole function body. Procs (and
+  // invocations carrying a constexpr env, i.e. proc config/next calls) are
+  // excluded: each of those instantiations needs its own constexpr data, as
+  // described below.
+  if (!callee_fn->proc().has_value() && constexpr_env.empty()) {
+    if (std::optional<TypeInfo*> derived_ti =
+            ctx->type_info()->GetInstantiationTypeInfo(
+                callee_fn, tab.symbolic_bindings)) {
+      parent_ctx->type_info()->AddInvocationCallBindings(
+          invocation, caller_symbolic_bindings, tab.symbolic_bindings);
+      FunctionType instantiated_ft{std::move(arg_types),
+                                   tab.type->CloneToUnique()};
+      parent_ctx->type_info()->SetItem(invocation->callee(), instantiated_ft);
+      ctx->type_info()->SetItem(callee_fn->name_def(), instantiated_ft);
+      parent_ctx->type_info()->SetInvocationTypeInfo(
+          invocation, tab.symbolic_bindings, derived_ti.value());
+      return tab;
+    }
+  }
+
   // We execute this function if we're parametric or a proc. In either case, we
   // want to create a new TypeInfo. The reason for the former is obvious. The
   // reason for the latter is that we need separate constexpr data for every
@@ -784,6 +806,10 @@ absl::StatusOr<TypeAndBindings> CheckInvocation(
 
   original_ti->SetInvocationTypeInfo(invocation, tab.symbolic_bindings,
                                         ctx->type_info());
+  if (!callee_fn->proc().has_value() && constexpr_env.empty()) {
+    ctx->type_info()->NoteInstantiationTypeInfo(
+        callee_fn, tab.symbolic_bindings, ctx->type_info());
+  }
 
   XLS_RETURN_IF_ERROR(ctx->PopDerivedTypeInfo());
   ctx->PopFnStackEntry();
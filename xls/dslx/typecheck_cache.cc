@@ -0,0 +1,183 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/typecheck_cache.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "absl/numeric/int128.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/dslx/import_routines.h"
+#include "xls/dslx/type_info_to_proto.h"
+
+namespace xls::dslx {
+namespace {
+
+// 128-bit FNV-1a; unlike absl::Hash the result does not vary from process to
+// process, which is required for keying on-disk entries. The 128-bit width
+// makes accidental collisions across a large cache a non-concern.
+class Fnv128 {
+ public:
+  // Frames the chunk with its length so concatenations of different chunk
+  // boundaries hash differently.
+  void Update(absl::string_view bytes) {
+    UpdateRaw(absl::StrFormat("%d:", bytes.size()));
+    UpdateRaw(bytes);
+  }
+
+  std::string Digest() const {
+    return absl::StrFormat("%016x%016x", absl::Uint128High64(state_),
+                           absl::Uint128Low64(state_));
+  }
+
+ private:
+  void UpdateRaw(absl::string_view bytes) {
+    for (char c : bytes) {
+      state_ ^= static_cast<uint8_t>(c);
+      state_ *= kPrime;
+    }
+  }
+
+  static constexpr absl::uint128 kPrime =
+      absl::MakeUint128(0x0000000001000000ULL, 0x000000000000013bULL);
+  static constexpr absl::uint128 kOffsetBasis =
+      absl::MakeUint128(0x6c62272e07bb0142ULL, 0x62b821756295c58dULL);
+
+  absl::uint128 state_ = kOffsetBasis;
+};
+
+}  // namespace
+
+/* static */ std::string TypecheckCache::CombineFingerprints(
+    absl::string_view module_text,
+    absl::Span<const std::string> dependency_fingerprints) {
+  Fnv128 hasher;
+  hasher.Update(module_text);
+  // Sort the dependency fingerprints so the result does not depend on import
+  // enumeration order.
+  std::vector<std::string> sorted_deps(dependency_fingerprints.begin(),
+                                       dependency_fingerprints.end());
+  std::sort(sorted_deps.begin(), sorted_deps.end());
+  for (const std::string& dep : sorted_deps) {
+    hasher.Update(dep);
+  }
+  return hasher.Digest();
+}
+
+absl::StatusOr<std::string> TypecheckCache::FingerprintModuleText(
+    absl::string_view text, absl::string_view path,
+    absl::string_view stdlib_path,
+    absl::Span<const std::filesystem::path> additional_search_paths) {
+  // Parse to discover the imports; the module name is irrelevant for
+  // fingerprinting purposes.
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Module> module,
+                       ParseModule(text, path, /*module_name=*/"fingerprint"));
+  std::vector<std::string> dep_fingerprints;
+  for (const auto& [name, import] : module->GetImportByName()) {
+    XLS_ASSIGN_OR_RETURN(
+        std::filesystem::path dep_path,
+        FindImportPath(ImportTokens(import->subject()), stdlib_path,
+                       additional_search_paths, import->span()));
+    XLS_ASSIGN_OR_RETURN(
+        std::string dep_fingerprint,
+        FingerprintModuleFile(dep_path, stdlib_path, additional_search_paths));
+    dep_fingerprints.push_back(std::move(dep_fingerprint));
+  }
+  return CombineFingerprints(text, dep_fingerprints);
+}
+
+absl::StatusOr<std::string> TypecheckCache::FingerprintModuleFile(
+    const std::filesystem::path& path, absl::string_view stdlib_path,
+    absl::Span<const std::filesystem::path> additional_search_paths) {
+  std::string key(path);
+  auto it = fingerprint_memo_.find(key);
+  if (it != fingerprint_memo_.end()) {
+    if (it->second.empty()) {
+      return absl::InvalidArgumentError(
+          "Cycle detected in import DAG at module: " + key);
+    }
+    return it->second;
+  }
+  fingerprint_memo_.emplace(key, "");
+  XLS_ASSIGN_OR_RETURN(std::string text, GetFileContents(path));
+  absl::StatusOr<std::string> fingerprint = FingerprintModuleText(
+      text, key, stdlib_path, additional_search_paths);
+  if (!fingerprint.ok()) {
+    fingerprint_memo_.erase(key);
+    return fingerprint;
+  }
+  fingerprint_memo_[key] = *fingerprint;
+  return fingerprint;
+}
+
+bool TypecheckCache::Contains(absl::string_view fingerprint) const {
+  return FileExists(EntryPath(fingerprint)).ok();
+}
+
+absl::StatusOr<TypeInfoProto> TypecheckCache::Lookup(
+    absl::string_view fingerprint) const {
+  std::filesystem::path entry_path = EntryPath(fingerprint);
+  if (!FileExists(entry_path).ok()) {
+    return absl::NotFoundError(absl::StrFormat(
+        "No typecheck cache entry for fingerprint %s", fingerprint));
+  }
+  TypeInfoProto proto;
+  XLS_RETURN_IF_ERROR(ParseProtobinFile(entry_path, &proto));
+  return proto;
+}
+
+absl::Status TypecheckCache::Store(absl::string_view fingerprint,
+                                   const TypeInfoProto& proto) {
+  XLS_RETURN_IF_ERROR(RecursivelyCreateDir(cache_dir_));
+  return SetProtobinFile(EntryPath(fingerprint), proto);
+}
+
+std::filesystem::path TypecheckCache::EntryPath(
+    absl::string_view fingerprint) const {
+  return cache_dir_ / absl::StrFormat("%s.typeinfo.pb", fingerprint);
+}
+
+absl::StatusOr<TypeInfoProto> ParseAndTypecheckWithCache(
+    absl::string_view text, absl::string_view path,
+    absl::string_view module_name, ImportData* import_data,
+    TypecheckCache* cache, std::optional<TypecheckedModule>* typechecked) {
+  XLS_RET_CHECK(import_data != nullptr);
+  XLS_RET_CHECK(cache != nullptr);
+
+  XLS_ASSIGN_OR_RETURN(
+      std::string fingerprint,
+      cache->FingerprintModuleText(text, path, import_data->stdlib_path(),
+                                   import_data->additional_search_paths()));
+  // A corrupt or unreadable entry is treated the same as a miss; typechecking
+  // below rewrites it.
+  absl::StatusOr<TypeInfoProto> cached = cache->Lookup(fingerprint);
+  if (cached.ok()) {
+    return cached;
+  }
+
+  XLS_ASSIGN_OR_RETURN(TypecheckedModule tm,
+                       ParseAndTypecheck(text, path, module_name, import_data));
+  XLS_ASSIGN_OR_RETURN(TypeInfoProto proto, TypeInfoToProto(*tm.type_info));
+  XLS_RETURN_IF_ERROR(cache->Store(fingerprint, proto));
+  if (typechecked != nullptr) {
+    *typechecked = tm;
+  }
+  return proto;
+}
+
+}  // namespace xls::dslx
@@ -0,0 +1,112 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_DSLX_TYPECHECK_CACHE_H_
+#define XLS_DSLX_TYPECHECK_CACHE_H_
+
+#include <filesystem>
+#include <optional>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/dslx/import_data.h"
+#include "xls/dslx/parse_and_typecheck.h"
+#include "xls/dslx/type_info.pb.h"
+
+namespace xls::dslx {
+
+// On-disk cache of DSLX typechecking results keyed by content fingerprints.
+//
+// A module's fingerprint covers its own text and, transitively, the text of
+// every module it imports, so an edit anywhere in the import DAG invalidates
+// the entries of all dependents while leaving unrelated entries valid. Each
+// entry holds the TypeInfoProto recorded when a module with that fingerprint
+// last typechecked successfully.
+//
+// Warm-start runs that only need typechecking results in serialized form
+// (validation/diagnostics tooling and other TypeInfoProto consumers) hit the
+// cache after a -- cheap, relative to type deduction -- parse of the import
+// DAG and skip deduction entirely; see ParseAndTypecheckWithCache.
+// Reconstructing a live TypeInfo from an entry would additionally require a
+// proto-to-TypeInfo deserializer (TypeInfoToProto is currently one-way), so
+// full compiles still typecheck on a hit and refresh the entry.
+class TypecheckCache {
+ public:
+  // Entries are stored as files under "cache_dir", which is created on first
+  // Store() if it does not exist.
+  explicit TypecheckCache(std::filesystem::path cache_dir)
+      : cache_dir_(std::move(cache_dir)) {}
+
+  // Combines module text with the fingerprints of the modules it imports into
+  // a fingerprint that is stable across processes (unlike absl::Hash), so it
+  // can key on-disk entries. The dependency fingerprints are order-insensitive.
+  static std::string CombineFingerprints(
+      absl::string_view module_text,
+      absl::Span<const std::string> dependency_fingerprints);
+
+  // Computes the transitive fingerprint of the module text at "path": parses
+  // it, resolves its imports the same way DoImport does, and recurses through
+  // the import DAG. File fingerprints are memoized per path for the lifetime
+  // of this object.
+  absl::StatusOr<std::string> FingerprintModuleText(
+      absl::string_view text, absl::string_view path,
+      absl::string_view stdlib_path,
+      absl::Span<const std::filesystem::path> additional_search_paths);
+
+  // As above for a module file on disk.
+  absl::StatusOr<std::string> FingerprintModuleFile(
+      const std::filesystem::path& path, absl::string_view stdlib_path,
+      absl::Span<const std::filesystem::path> additional_search_paths);
+
+  // Returns whether an entry exists for the given fingerprint.
+  bool Contains(absl::string_view fingerprint) const;
+
+  // Returns the serialized type information recorded for the fingerprint, or
+  // NotFoundError if no entry exists.
+  absl::StatusOr<TypeInfoProto> Lookup(absl::string_view fingerprint) const;
+
+  // Records the serialized type information for the fingerprint, overwriting
+  // any existing entry.
+  absl::Status Store(absl::string_view fingerprint,
+                     const TypeInfoProto& proto);
+
+ private:
+  std::filesystem::path EntryPath(absl::string_view fingerprint) const;
+
+  std::filesystem::path cache_dir_;
+  // Memoized path-to-fingerprint results for FingerprintModuleFile; an empty
+  // fingerprint marks a file whose fingerprint is being computed (used to
+  // detect import cycles).
+  absl::flat_hash_map<std::string, std::string> fingerprint_memo_;
+};
+
+// As ParseAndTypecheck, but consults and updates the given cache. On a hit
+// the recorded serialization is returned without running type deduction and
+// "typechecked" (if non-null) is left unset -- callers that need a live
+// TypeInfo must typecheck regardless (see the class comment). On a miss the
+// module is typechecked, the serialization of its type information is stored
+// under the module's transitive fingerprint, and "typechecked" (if non-null)
+// receives the live result.
+absl::StatusOr<TypeInfoProto> ParseAndTypecheckWithCache(
+    absl::string_view text, absl::string_view path,
+    absl::string_view module_name, ImportData* import_data,
+    TypecheckCache* cache,
+    std::optional<TypecheckedModule>* typechecked = nullptr);
+
+}  // namespace xls::dslx
+
+#endif  // XLS_DSLX_TYPECHECK_CACHE_H_
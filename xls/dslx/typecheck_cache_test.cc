@@ -0,0 +1,133 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/typecheck_cache.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+#include "xls/dslx/create_import_data.h"
+#include "xls/dslx/default_dslx_stdlib_path.h"
+#include "xls/dslx/import_data.h"
+
+namespace xls::dslx {
+namespace {
+
+using status_testing::StatusIs;
+using ::testing::HasSubstr;
+
+TEST(TypecheckCacheTest, CombineFingerprints) {
+  std::string fp = TypecheckCache::CombineFingerprints("fn f() {}", {});
+  // Stable and text-sensitive.
+  EXPECT_EQ(fp, TypecheckCache::CombineFingerprints("fn f() {}", {}));
+  EXPECT_NE(fp, TypecheckCache::CombineFingerprints("fn g() {}", {}));
+
+  // Dependency fingerprints contribute but their order does not.
+  std::vector<std::string> deps = {"aaaa", "bbbb"};
+  std::vector<std::string> deps_reversed = {"bbbb", "aaaa"};
+  EXPECT_EQ(TypecheckCache::CombineFingerprints("fn f() {}", deps),
+            TypecheckCache::CombineFingerprints("fn f() {}", deps_reversed));
+  EXPECT_NE(TypecheckCache::CombineFingerprints("fn f() {}", deps), fp);
+}
+
+TEST(TypecheckCacheTest, WarmStartHitsAcrossCacheObjects) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory tempdir, TempDirectory::Create());
+  std::filesystem::path module_dir = tempdir.path() / "modules";
+  std::filesystem::path cache_dir = tempdir.path() / "cache";
+  XLS_ASSERT_OK(RecursivelyCreateDir(module_dir));
+  XLS_ASSERT_OK(SetFileContents(module_dir / "dep.x",
+                                "pub fn one() -> u32 { u32:1 }"));
+  std::vector<std::filesystem::path> additional_search_paths = {module_dir};
+  constexpr absl::string_view kProgram = R"(import dep
+fn main() -> u32 { dep::one() })";
+
+  // Cold run: misses the cache and typechecks.
+  {
+    ImportData import_data =
+        CreateImportData(kDefaultDslxStdlibPath, additional_search_paths);
+    TypecheckCache cache(cache_dir);
+    std::optional<TypecheckedModule> typechecked;
+    XLS_ASSERT_OK_AND_ASSIGN(
+        TypeInfoProto proto,
+        ParseAndTypecheckWithCache(kProgram, "test.x", "test", &import_data,
+                                   &cache, &typechecked));
+    EXPECT_TRUE(typechecked.has_value());
+    EXPECT_GT(proto.nodes_size(), 0);
+  }
+
+  // Warm run with a fresh cache object over the same directory: hits without
+  // typechecking (no live TypecheckedModule is produced).
+  {
+    ImportData import_data =
+        CreateImportData(kDefaultDslxStdlibPath, additional_search_paths);
+    TypecheckCache cache(cache_dir);
+    std::optional<TypecheckedModule> typechecked;
+    XLS_ASSERT_OK_AND_ASSIGN(
+        TypeInfoProto proto,
+        ParseAndTypecheckWithCache(kProgram, "test.x", "test", &import_data,
+                                   &cache, &typechecked));
+    EXPECT_FALSE(typechecked.has_value());
+    EXPECT_GT(proto.nodes_size(), 0);
+  }
+}
+
+TEST(TypecheckCacheTest, EditingDependencyChangesFingerprint) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory tempdir, TempDirectory::Create());
+  XLS_ASSERT_OK(SetFileContents(tempdir.path() / "dep.x",
+                                "pub fn one() -> u32 { u32:1 }"));
+  std::vector<std::filesystem::path> additional_search_paths = {
+      tempdir.path()};
+  constexpr absl::string_view kProgram = R"(import dep
+fn main() -> u32 { dep::one() })";
+
+  std::string before;
+  {
+    TypecheckCache cache(tempdir.path() / "cache");
+    XLS_ASSERT_OK_AND_ASSIGN(
+        before, cache.FingerprintModuleText(kProgram, "test.x",
+                                            kDefaultDslxStdlibPath,
+                                            additional_search_paths));
+    // The per-path memo makes repeated fingerprinting cheap and stable.
+    XLS_ASSERT_OK_AND_ASSIGN(
+        std::string again,
+        cache.FingerprintModuleText(kProgram, "test.x", kDefaultDslxStdlibPath,
+                                    additional_search_paths));
+    EXPECT_EQ(before, again);
+  }
+
+  // An edit to the imported file changes the root fingerprint even though the
+  // root text is unchanged.
+  XLS_ASSERT_OK(SetFileContents(tempdir.path() / "dep.x",
+                                "pub fn one() -> u32 { u32:2 }"));
+  TypecheckCache cache(tempdir.path() / "cache");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::string after,
+      cache.FingerprintModuleText(kProgram, "test.x", kDefaultDslxStdlibPath,
+                                  additional_search_paths));
+  EXPECT_NE(before, after);
+}
+
+TEST(TypecheckCacheTest, LookupOfUnknownFingerprintIsNotFound) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory tempdir, TempDirectory::Create());
+  TypecheckCache cache(tempdir.path() / "cache");
+  EXPECT_FALSE(cache.Contains("deadbeef"));
+  EXPECT_THAT(cache.Lookup("deadbeef"),
+              StatusIs(absl::StatusCode::kNotFound,
+                       HasSubstr("No typecheck cache entry")));
+}
+
+}  // namespace
+}  // namespace xls::dslx
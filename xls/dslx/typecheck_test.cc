@@ -39,6 +39,32 @@ absl::Status Typecheck(absl::string_view text) {
   return absl::Status();
 }
 
+TEST(TypecheckTest, ParametricInstantiationTypeInfoIsMemoized) {
+  absl::string_view program = R"(
+fn id<N: u32>(x: bits[N]) -> bits[N] { x }
+fn f() -> u32 { id(u32:1) }
+fn g() -> u32 { id(u32:2) }
+)";
+  auto import_data = CreateImportDataForTest();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypecheckedModule tm,
+      ParseAndTypecheck(program, "fake.x", "fake", &import_data));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * id,
+                           tm.module->GetMemberOrError<Function>("id"));
+  SymbolicBindings bindings(
+      absl::Span<std::pair<std::string, InterpValue> const>{
+          {"N", InterpValue::MakeU32(32)}});
+  std::optional<TypeInfo*> instantiation_ti =
+      tm.type_info->GetInstantiationTypeInfo(id, bindings);
+  ASSERT_TRUE(instantiation_ti.has_value());
+  // Both invocations of id<32> map to the single memoized derived TypeInfo.
+  for (const auto& [invocation, data] : tm.type_info->invocations()) {
+    for (const auto& [callee_bindings, ti] : data.instantiations) {
+      EXPECT_EQ(ti, instantiation_ti.value());
+    }
+  }
+}
+
 TEST(TypecheckTest, ParametricWrongArgCount) {
   absl::string_view text = R"(
 fn id<N: u32>(x: bits[N]) -> bits[N] { x }
@@ -688,6 +714,13 @@ TEST(TypecheckTest, OutOfRangeNumberInConstantArray) {
           HasSubstr("Value '256' does not fit in the bitwidth of a uN[8]")));
 }
 
+TEST(TypecheckTest, ConstantArraySizeMismatch) {
+  EXPECT_THAT(
+      Typecheck("fn f() -> u8[2] { u8[2]:[1, 2, 3] }"),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("does not match inferred array size 3")));
+}
+
 TEST(TypecheckTest, MatchNoArms) {
   EXPECT_THAT(Typecheck("fn f(x: u8) -> u8 { let _ = match x {}; x }"),
               StatusIs(absl::StatusCode::kInvalidArgument,
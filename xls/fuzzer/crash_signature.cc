@@ -0,0 +1,149 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/fuzzer/crash_signature.h"
+
+#include "absl/memory/memory.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/status/status_macros.h"
+
+namespace xls {
+namespace {
+
+// Substrings identifying frames from the abort/logging/symbolization
+// machinery. These frames appear in every crash and carry no bucketing
+// information.
+constexpr absl::string_view kBoilerplateFrames[] = {
+    "GetSymbolizedStackTrace", "absl::log_internal", "logging_internal",
+    "LogMessage",              "FailureSignalHandler", "abort",
+    "raise",                   "gsignal",              "__assert",
+    "[unknown]",
+};
+
+bool IsBoilerplateFrame(absl::string_view frame) {
+  for (absl::string_view needle : kBoilerplateFrames) {
+    if (absl::StrContains(frame, needle)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Strips the "0x...: " address prefix which GetSymbolizedStackTraceAsString
+// puts before each symbol. Addresses differ from run to run (ASLR) and must
+// not reach the signature.
+absl::string_view StripAddress(absl::string_view frame) {
+  if (absl::StartsWith(frame, "0x")) {
+    auto pos = frame.find(": ");
+    if (pos != absl::string_view::npos) {
+      frame.remove_prefix(pos + 2);
+    }
+  }
+  return frame;
+}
+
+// FNV-1a. Stable across processes and builds, unlike absl::Hash which is
+// seeded per-process.
+uint64_t StableHash(absl::string_view s) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (char c : s) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+// Name of the marker file for a signature within a dedup index directory.
+std::string MarkerFileName(const CrashSignature& signature) {
+  return absl::StrFormat("sig_%016x", signature.Hash());
+}
+
+}  // namespace
+
+std::string CrashSignature::ToString() const {
+  return absl::StrCat(failing_pass, "|", absl::StrJoin(frames, ";"));
+}
+
+uint64_t CrashSignature::Hash() const { return StableHash(ToString()); }
+
+std::vector<std::string> NormalizeStackTrace(absl::string_view stack_trace,
+                                             int64_t max_frames) {
+  std::vector<std::string> frames;
+  for (absl::string_view line : absl::StrSplit(stack_trace, '\n')) {
+    line = absl::StripAsciiWhitespace(line);
+    if (line.empty()) {
+      continue;
+    }
+    absl::string_view frame = StripAddress(line);
+    if (IsBoilerplateFrame(frame)) {
+      continue;
+    }
+    frames.push_back(std::string(frame));
+    if (static_cast<int64_t>(frames.size()) == max_frames) {
+      break;
+    }
+  }
+  return frames;
+}
+
+CrashSignature ExtractCrashSignature(absl::string_view crash_text,
+                                     const PassResults* results) {
+  CrashSignature signature;
+  signature.frames = NormalizeStackTrace(crash_text);
+  if (results != nullptr && !results->invocations.empty()) {
+    signature.failing_pass = results->invocations.back().pass_name;
+  }
+  return signature;
+}
+
+/* static */ absl::StatusOr<std::unique_ptr<CrashDedupIndex>>
+CrashDedupIndex::Create(std::optional<std::filesystem::path> index_dir) {
+  auto index = absl::WrapUnique(new CrashDedupIndex(std::move(index_dir)));
+  if (index->index_dir_.has_value()) {
+    XLS_RETURN_IF_ERROR(RecursivelyCreateDir(*index->index_dir_));
+    XLS_ASSIGN_OR_RETURN(std::vector<std::filesystem::path> entries,
+                         GetDirectoryEntries(*index->index_dir_));
+    for (const std::filesystem::path& entry : entries) {
+      uint64_t hash;
+      std::string filename = entry.filename().string();
+      if (absl::StartsWith(filename, "sig_") &&
+          absl::SimpleHexAtoi(absl::string_view(filename).substr(4), &hash)) {
+        index->seen_.insert(hash);
+      }
+    }
+  }
+  return index;
+}
+
+absl::StatusOr<bool> CrashDedupIndex::RecordSignature(
+    const CrashSignature& signature) {
+  uint64_t hash = signature.Hash();
+  if (!seen_.insert(hash).second) {
+    return false;
+  }
+  if (index_dir_.has_value()) {
+    XLS_RETURN_IF_ERROR(SetFileContents(*index_dir_ / MarkerFileName(signature),
+                                        signature.ToString()));
+  }
+  return true;
+}
+
+}  // namespace xls
@@ -0,0 +1,108 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_FUZZER_CRASH_SIGNATURE_H_
+#define XLS_FUZZER_CRASH_SIGNATURE_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xls/passes/pass_base.h"
+
+namespace xls {
+
+// Bucketing signature for a fuzzer finding. One toolchain bug typically
+// produces many samples which all crash the same way; bucketing by signature
+// lets the collection side keep one representative per bug instead of
+// flooding the crashers directory and the triage queue.
+struct CrashSignature {
+  // The normalized innermost frames of the crash (see NormalizeStackTrace),
+  // or the normalized error message for failures without a stack trace.
+  std::vector<std::string> frames;
+
+  // The name of the pass which was running when the failure occurred, taken
+  // from the last PassResults invocation. Empty when unknown. Distinguishes
+  // crashes with identical stacks in shared infrastructure (e.g. a CHECK in
+  // the IR verifier) triggered by different passes.
+  std::string failing_pass;
+
+  // Canonical single-line form: "<failing_pass>|<frame>;<frame>;...".
+  std::string ToString() const;
+
+  // Stable 64-bit hash of ToString(). Deliberately not absl::Hash, which is
+  // seeded per-process: the hash names entries in an on-disk index shared
+  // across fuzz worker processes.
+  uint64_t Hash() const;
+
+  bool operator==(const CrashSignature& other) const {
+    return frames == other.frames && failing_pass == other.failing_pass;
+  }
+};
+
+// Normalizes a symbolized stack trace (as produced by
+// GetSymbolizedStackTraceAsString) into at most `max_frames` innermost
+// meaningful frames: addresses and offsets are stripped and frames from the
+// abort/logging machinery (which are common to every crash) are skipped.
+std::vector<std::string> NormalizeStackTrace(absl::string_view stack_trace,
+                                             int64_t max_frames = 5);
+
+// Builds the signature for a failure. `crash_text` is the symbolized stack
+// trace of the crash, or the error message for non-crash failures (e.g. a
+// mismatch status); `results` carries the pass invocations recorded up to the
+// failure and may be null when no pass pipeline was involved.
+CrashSignature ExtractCrashSignature(absl::string_view crash_text,
+                                     const PassResults* results = nullptr);
+
+// Index of crash signatures already collected, used to suppress duplicates at
+// collection time. Optionally backed by a directory holding one marker file
+// per signature so that the index is shared by all worker processes of a
+// shard and survives restarts.
+class CrashDedupIndex {
+ public:
+  // Creates an index backed by `index_dir`, creating the directory and
+  // loading any markers already present. Pass nullopt for a purely in-memory
+  // index.
+  static absl::StatusOr<std::unique_ptr<CrashDedupIndex>> Create(
+      std::optional<std::filesystem::path> index_dir);
+
+  // Records the signature. Returns true if the signature was not already in
+  // the index (i.e. the finding is new and worth keeping), false for a
+  // duplicate. When directory-backed, a new signature writes a marker file
+  // named after the signature hash whose contents are ToString().
+  absl::StatusOr<bool> RecordSignature(const CrashSignature& signature);
+
+  // Whether the signature is already in the index.
+  bool Contains(const CrashSignature& signature) const {
+    return seen_.contains(signature.Hash());
+  }
+
+ private:
+  explicit CrashDedupIndex(std::optional<std::filesystem::path> index_dir)
+      : index_dir_(std::move(index_dir)) {}
+
+  std::optional<std::filesystem::path> index_dir_;
+  absl::flat_hash_set<uint64_t> seen_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_FUZZER_CRASH_SIGNATURE_H_
@@ -0,0 +1,103 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/fuzzer/crash_signature.h"
+
+#include <memory>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+
+namespace xls {
+namespace {
+
+using ::testing::ElementsAre;
+
+constexpr absl::string_view kStackTrace =
+    "0x55c0deadbeef: xls::FailureSignalHandler()\n"
+    "0x55c0deadbef0: absl::log_internal::LogMessage::Fail()\n"
+    "0x55c0deadbef1: xls::BitSlice::InferType()\n"
+    "0x55c0deadbef2: xls::VerifyNode()\n"
+    "0x55c0deadbef3: xls::VerifyPackage()\n";
+
+TEST(CrashSignatureTest, NormalizeStripsAddressesAndBoilerplate) {
+  EXPECT_THAT(NormalizeStackTrace(kStackTrace),
+              ElementsAre("xls::BitSlice::InferType()", "xls::VerifyNode()",
+                          "xls::VerifyPackage()"));
+}
+
+TEST(CrashSignatureTest, NormalizeRespectsMaxFrames) {
+  EXPECT_THAT(NormalizeStackTrace(kStackTrace, /*max_frames=*/1),
+              ElementsAre("xls::BitSlice::InferType()"));
+}
+
+TEST(CrashSignatureTest, FailingPassFromResults) {
+  PassResults results;
+  results.invocations.push_back(PassInvocation{.pass_name = "dce"});
+  results.invocations.push_back(PassInvocation{.pass_name = "arith_simp"});
+  CrashSignature signature = ExtractCrashSignature(kStackTrace, &results);
+  EXPECT_EQ(signature.failing_pass, "arith_simp");
+  EXPECT_EQ(signature.ToString(),
+            "arith_simp|xls::BitSlice::InferType();xls::VerifyNode();"
+            "xls::VerifyPackage()");
+}
+
+TEST(CrashSignatureTest, HashIsStableAndSensitiveToPass) {
+  CrashSignature a = ExtractCrashSignature(kStackTrace);
+  CrashSignature b = ExtractCrashSignature(kStackTrace);
+  EXPECT_EQ(a.Hash(), b.Hash());
+
+  PassResults results;
+  results.invocations.push_back(PassInvocation{.pass_name = "dce"});
+  CrashSignature c = ExtractCrashSignature(kStackTrace, &results);
+  EXPECT_NE(a.Hash(), c.Hash());
+}
+
+TEST(CrashDedupIndexTest, InMemoryDedup) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<CrashDedupIndex> index,
+                           CrashDedupIndex::Create(std::nullopt));
+  CrashSignature signature = ExtractCrashSignature(kStackTrace);
+  EXPECT_FALSE(index->Contains(signature));
+  XLS_ASSERT_OK_AND_ASSIGN(bool is_new, index->RecordSignature(signature));
+  EXPECT_TRUE(is_new);
+  EXPECT_TRUE(index->Contains(signature));
+  XLS_ASSERT_OK_AND_ASSIGN(is_new, index->RecordSignature(signature));
+  EXPECT_FALSE(is_new);
+}
+
+TEST(CrashDedupIndexTest, DirectoryBackedIndexSurvivesReload) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  CrashSignature signature = ExtractCrashSignature(kStackTrace);
+  {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<CrashDedupIndex> index,
+        CrashDedupIndex::Create(temp_dir.path() / "index"));
+    XLS_ASSERT_OK_AND_ASSIGN(bool is_new, index->RecordSignature(signature));
+    EXPECT_TRUE(is_new);
+  }
+  // A second index over the same directory (e.g. another worker process, or
+  // the same shard after a restart) sees the recorded signature.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CrashDedupIndex> index,
+      CrashDedupIndex::Create(temp_dir.path() / "index"));
+  EXPECT_TRUE(index->Contains(signature));
+  XLS_ASSERT_OK_AND_ASSIGN(bool is_new, index->RecordSignature(signature));
+  EXPECT_FALSE(is_new);
+}
+
+}  // namespace
+}  // namespace xls
@@ -0,0 +1,198 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
+#include "xls/common/init_xls.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/fuzzer/crash_signature.h"
+#include "xls/interpreter/function_interpreter.h"
+#include "xls/ir/function.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value.h"
+#include "xls/ir/value_helpers.h"
+#include "xls/jit/function_jit.h"
+
+const char kUsage[] = R"(
+Long-lived fuzzing worker which evaluates IR samples sent over stdin.
+
+Starting a fresh process for every fuzz sample pays process startup and LLVM
+initialization over and over. This worker amortizes those costs: a driver (e.g.
+run_fuzz) starts it once, then streams samples over a pipe. Samples compiled in
+the same process also share the JIT's persistent object cache (enabled via the
+XLS_JIT_OBJECT_CACHE_DIR environment variable), so resubmitted or duplicated
+samples skip LLVM optimization and code generation entirely.
+
+Protocol (line-oriented, one request per sample):
+
+    sample <NUM_IR_LINES> <NUM_INPUT_LINES>
+    <IR text, exactly NUM_IR_LINES lines>
+    <input lines, exactly NUM_INPUT_LINES lines>
+
+Each input line is a semicolon-separated set of typed values, as accepted by
+find_failing_input_main. The worker replies on stdout with one line per input:
+
+    result <VALUE>
+
+followed by a single terminator line, either `ok` or `error <MESSAGE>`, and
+flushes. With --crash_index_dir, each `error` terminator is preceded by a
+`signature <HASH> <new|duplicate>` line identifying the crash bucket. The
+worker exits cleanly at EOF on stdin. Usage:
+
+    fuzz_worker_main < requests
+)";
+
+ABSL_FLAG(bool, compare_to_interpreter, false,
+          "If true, also evaluate each input with the IR interpreter and "
+          "report an error on any mismatch with the JIT result.");
+ABSL_FLAG(std::string, crash_index_dir, "",
+          "If nonempty, bucket failing samples by crash signature using an "
+          "index in this directory (shared with other workers of the shard) "
+          "and tag each error reply with a `signature <HASH> <new|duplicate>` "
+          "line so the driver can discard duplicates at collection time.");
+
+namespace xls {
+namespace {
+
+// A single parsed request from the driver.
+struct SampleRequest {
+  std::string ir_text;
+  std::vector<std::string> input_lines;
+};
+
+// Reads the next request from `in`. Returns a request without a value at EOF.
+absl::StatusOr<std::optional<SampleRequest>> ReadSampleRequest(
+    std::istream& in) {
+  std::string header;
+  if (!std::getline(in, header)) {
+    return std::nullopt;
+  }
+  std::vector<absl::string_view> fields =
+      absl::StrSplit(header, ' ', absl::SkipEmpty());
+  int64_t num_ir_lines;
+  int64_t num_input_lines;
+  if (fields.size() != 3 || fields[0] != "sample" ||
+      !absl::SimpleAtoi(fields[1], &num_ir_lines) ||
+      !absl::SimpleAtoi(fields[2], &num_input_lines)) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Malformed header line, expected `sample <num-ir-lines> "
+        "<num-input-lines>`: \"%s\"",
+        header));
+  }
+  SampleRequest request;
+  std::string line;
+  for (int64_t i = 0; i < num_ir_lines; ++i) {
+    if (!std::getline(in, line)) {
+      return absl::InvalidArgumentError("Unexpected EOF while reading IR text");
+    }
+    absl::StrAppend(&request.ir_text, line, "\n");
+  }
+  for (int64_t i = 0; i < num_input_lines; ++i) {
+    if (!std::getline(in, line)) {
+      return absl::InvalidArgumentError("Unexpected EOF while reading inputs");
+    }
+    request.input_lines.push_back(line);
+  }
+  return request;
+}
+
+// Evaluates one sample, writing a `result` line per input to stdout. The
+// package and JIT are scoped to the call; only the process-wide LLVM state and
+// the on-disk object cache persist across samples.
+absl::Status EvaluateSample(const SampleRequest& request) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                       Parser::ParsePackage(request.ir_text, "<sample>"));
+  XLS_ASSIGN_OR_RETURN(Function * f, package->GetTopAsFunction());
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<FunctionJit> jit,
+                       FunctionJit::Create(f));
+  for (const std::string& args_line : request.input_lines) {
+    std::vector<Value> args;
+    for (const absl::string_view& value_string :
+         absl::StrSplit(args_line, ';')) {
+      XLS_ASSIGN_OR_RETURN(Value arg, Parser::ParseTypedValue(value_string));
+      args.push_back(arg);
+    }
+    XLS_ASSIGN_OR_RETURN(InterpreterResult<Value> jit_result, jit->Run(args));
+    if (absl::GetFlag(FLAGS_compare_to_interpreter)) {
+      XLS_ASSIGN_OR_RETURN(InterpreterResult<Value> interpreter_result,
+                           InterpretFunction(f, args));
+      if (jit_result.value != interpreter_result.value) {
+        return absl::InternalError(absl::StrFormat(
+            "JIT/interpreter mismatch on input `%s`: jit=%s interpreter=%s",
+            args_line, jit_result.value.ToString(ValueFormatterHex),
+            interpreter_result.value.ToString(ValueFormatterHex)));
+      }
+    }
+    std::cout << "result " << jit_result.value.ToString(ValueFormatterHex)
+              << "\n";
+  }
+  return absl::OkStatus();
+}
+
+absl::Status RealMain() {
+  std::unique_ptr<CrashDedupIndex> dedup_index;
+  std::string index_dir = absl::GetFlag(FLAGS_crash_index_dir);
+  if (!index_dir.empty()) {
+    XLS_ASSIGN_OR_RETURN(
+        dedup_index,
+        CrashDedupIndex::Create(std::filesystem::path(index_dir)));
+  }
+  while (true) {
+    XLS_ASSIGN_OR_RETURN(std::optional<SampleRequest> request,
+                         ReadSampleRequest(std::cin));
+    if (!request.has_value()) {
+      return absl::OkStatus();
+    }
+    absl::Status status = EvaluateSample(*request);
+    if (status.ok()) {
+      std::cout << "ok\n";
+    } else {
+      // Sample-level failures are reported to the driver rather than taking
+      // down the worker; the whole point is to stay resident.
+      if (dedup_index != nullptr) {
+        CrashSignature signature = ExtractCrashSignature(status.message());
+        XLS_ASSIGN_OR_RETURN(bool is_new,
+                             dedup_index->RecordSignature(signature));
+        std::cout << absl::StreamFormat("signature %016x %s\n",
+                                        signature.Hash(),
+                                        is_new ? "new" : "duplicate");
+      }
+      std::cout << "error " << status.ToString() << "\n";
+    }
+    std::cout.flush();
+  }
+}
+
+}  // namespace
+}  // namespace xls
+
+int main(int argc, char** argv) {
+  xls::InitXls(kUsage, argc, argv);
+  XLS_QCHECK_OK(xls::RealMain());
+  return 0;
+}
@@ -0,0 +1,94 @@
+#
+# Copyright 2022 The XLS Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Tests for fuzz_worker_main binary."""
+
+import subprocess
+
+from xls.common import runfiles
+from xls.common import test_base
+
+FUZZ_WORKER_MAIN = runfiles.get_path('xls/fuzzer/fuzz_worker_main')
+
+ADD_IR = """package foo
+
+top fn foo(x: bits[32], y: bits[32]) -> bits[32] {
+  ret add.1: bits[32] = add(x, y)
+}
+"""
+
+NEG_IR = """package bar
+
+top fn bar(x: bits[8]) -> bits[8] {
+  ret neg.1: bits[8] = neg(x)
+}
+"""
+
+
+def make_request(ir_text: str, input_lines) -> str:
+  ir_lines = ir_text.split('\n')
+  # Trailing newline in the IR text yields an empty final element; the
+  # protocol counts physical lines.
+  if ir_lines and not ir_lines[-1]:
+    ir_lines = ir_lines[:-1]
+  return 'sample %d %d\n%s%s' % (len(ir_lines), len(
+      input_lines), '\n'.join(ir_lines) + '\n', ''.join(
+          line + '\n' for line in input_lines))
+
+
+class FuzzWorkerMainTest(test_base.TestCase):
+
+  def _run_worker(self, request: str, extra_args=()) -> str:
+    comp = subprocess.run(
+        [FUZZ_WORKER_MAIN] + list(extra_args),
+        input=request.encode('utf-8'),
+        stdout=subprocess.PIPE,
+        stderr=subprocess.PIPE,
+        check=True)
+    return comp.stdout.decode('utf-8')
+
+  def test_single_sample(self):
+    output = self._run_worker(
+        make_request(ADD_IR, ['bits[32]:0x42; bits[32]:0x123']))
+    self.assertEqual(output, 'result bits[32]:0x165\nok\n')
+
+  def test_multiple_samples_one_process(self):
+    request = make_request(
+        ADD_IR,
+        ['bits[32]:0x1; bits[32]:0x2', 'bits[32]:0x10; bits[32]:0xf0f'
+        ]) + make_request(NEG_IR, ['bits[8]:0x1'])
+    output = self._run_worker(request)
+    self.assertEqual(
+        output, 'result bits[32]:0x3\nresult bits[32]:0xf1f\nok\n'
+        'result bits[8]:0xff\nok\n')
+
+  def test_bad_sample_does_not_kill_worker(self):
+    request = make_request('not an ir package',
+                           []) + make_request(ADD_IR,
+                                              ['bits[32]:0x0; bits[32]:0x1'])
+    output = self._run_worker(request)
+    lines = output.splitlines()
+    self.assertTrue(lines[0].startswith('error '))
+    self.assertEqual(lines[1:], ['result bits[32]:0x1', 'ok'])
+
+  def test_compare_to_interpreter(self):
+    output = self._run_worker(
+        make_request(ADD_IR, ['bits[32]:0x2; bits[32]:0x3']),
+        extra_args=['--compare_to_interpreter'])
+    self.assertEqual(output, 'result bits[32]:0x5\nok\n')
+
+
+if __name__ == '__main__':
+  test_base.main()
@@ -12,7 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <thread>  // NOLINT(build/c++11)
+
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/flags/flag.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
@@ -21,6 +25,7 @@
 #include "xls/common/init_xls.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread_pool.h"
 #include "xls/fuzzer/sample_summary.pb.h"
 #include "xls/ir/op.h"
 
@@ -29,7 +34,8 @@ Reads Protobuf summary files emitted by the fuzzer and presents the data in
 tabular form. The summary information includes information about each IR sample
 generated by the fuzzer including op types, widths, etc. This information gives
 an indication of what kind of IR operations are being covered by the
-fuzzer. Usage:
+fuzzer. The summary files are read in parallel, one shard per file; the output
+is independent of the number of workers. Usage:
 
   read_summary_main  [SUMMARY_FILE...]
 
@@ -38,8 +44,22 @@ Example invocations:
 Show summary of a set of files emitted by the fuzzer:
 
   read_summary_main /tmp/summaries/summary_*.binarypb
+
+List the ops which appear in no sample of the corpus:
+
+  read_summary_main --coverage_gaps /tmp/summaries/summary_*.binarypb
 )";
 
+ABSL_FLAG(int64_t, worker_count, 0,
+          "Number of worker threads used to read summary files. Zero means "
+          "one worker per file, up to the hardware concurrency.");
+ABSL_FLAG(std::vector<std::string>, ops, {},
+          "If nonempty, restrict the op tables to this comma-separated list "
+          "of ops (e.g. 'smul,array_index').");
+ABSL_FLAG(bool, coverage_gaps, false,
+          "Instead of the tables, print only the ops which appear in no "
+          "sample, before and after optimizations.");
+
 namespace xls {
 namespace {
 
@@ -82,15 +102,44 @@ struct SummaryInfo {
   fuzzer::SampleTimingProto max_timing;
 };
 
+// Aggregates a histogram built when the summary was written (see
+// summarize_ir_main) into 'info'. Equivalent to walking the per-node protos
+// but touches one entry per (op, type) pair instead of one per node.
+void AggregateHistogram(
+    const google::protobuf::RepeatedPtrField<fuzzer::OpHistogramProto>&
+        histogram,
+    SampleInfo* info) {
+  for (const fuzzer::OpHistogramProto& entry : histogram) {
+    info->node_count += entry.count();
+    OpInfo& op_info = info->per_op_info[entry.op()];
+    op_info.samples += entry.count();
+    op_info.by_type[entry.type()] += entry.count();
+    op_info.wider_than_64bits += entry.wider_than_64bits();
+    op_info.mixed_width += entry.mixed_width();
+    op_info.nullary += entry.nullary();
+    op_info.unary += entry.unary();
+    op_info.binary += entry.binary();
+    op_info.manyary += entry.manyary();
+  }
+}
+
 // Aggregates the summary data in 'summary' into 'info'.
 void AggregateSummary(const fuzzer::SampleSummaryProto& summary,
                       SummaryInfo* info) {
   for (bool optimized : {false, true}) {
     SampleInfo& sample_info =
         optimized ? info->optimized_info : info->unoptimized_info;
+    sample_info.samples++;
+    // Prefer the histogram built at write time; older summaries predate it
+    // and require walking the nodes.
+    const auto& histogram = optimized ? summary.optimized_op_histogram()
+                                      : summary.unoptimized_op_histogram();
+    if (!histogram.empty()) {
+      AggregateHistogram(histogram, &sample_info);
+      continue;
+    }
     const auto& nodes =
         optimized ? summary.optimized_nodes() : summary.unoptimized_nodes();
-    sample_info.samples++;
     for (const fuzzer::NodeProto& node_proto : nodes) {
       sample_info.node_count++;
       OpInfo& op_info = sample_info.per_op_info[node_proto.op()];
@@ -143,6 +192,51 @@ void AggregateSummary(const fuzzer::SampleSummaryProto& summary,
 #undef AGGREGATE_FIELD
 }
 
+// Merges the aggregate data in 'from' into 'to'. Used to combine the
+// per-file results of the parallel readers; merging the files in path order
+// keeps the output independent of how the reads were scheduled.
+void MergeSummaryInfo(const SummaryInfo& from, SummaryInfo* to) {
+  auto merge_sample_info = [](const SampleInfo& from_info,
+                              SampleInfo* to_info) {
+    to_info->samples += from_info.samples;
+    to_info->node_count += from_info.node_count;
+    for (const auto& [op, from_op_info] : from_info.per_op_info) {
+      OpInfo& to_op_info = to_info->per_op_info[op];
+      to_op_info.samples += from_op_info.samples;
+      for (const auto& [type, count] : from_op_info.by_type) {
+        to_op_info.by_type[type] += count;
+      }
+      to_op_info.wider_than_64bits += from_op_info.wider_than_64bits;
+      to_op_info.mixed_width += from_op_info.mixed_width;
+      to_op_info.nullary += from_op_info.nullary;
+      to_op_info.unary += from_op_info.unary;
+      to_op_info.binary += from_op_info.binary;
+      to_op_info.manyary += from_op_info.manyary;
+    }
+  };
+  merge_sample_info(from.unoptimized_info, &to->unoptimized_info);
+  merge_sample_info(from.optimized_info, &to->optimized_info);
+
+#define MERGE_FIELD(F)                                                    \
+  {                                                                       \
+    to->total_timing.set_##F(to->total_timing.F() +                       \
+                             from.total_timing.F());                      \
+    to->max_timing.set_##F(std::max(to->max_timing.F(), from.max_timing.F())); \
+  }
+  MERGE_FIELD(total_ns);
+  MERGE_FIELD(generate_sample_ns);
+  MERGE_FIELD(interpret_dslx_ns);
+  MERGE_FIELD(convert_ir_ns);
+  MERGE_FIELD(unoptimized_interpret_ir_ns);
+  MERGE_FIELD(unoptimized_jit_ns);
+  MERGE_FIELD(optimize_ns);
+  MERGE_FIELD(optimized_interpret_ir_ns);
+  MERGE_FIELD(optimized_jit_ns);
+  MERGE_FIELD(codegen_ns);
+  MERGE_FIELD(simulate_ns);
+#undef MERGE_FIELD
+}
+
 // Print the timing info contained in 'info' to stdout.
 void DumpTimingInfo(const SummaryInfo& info) {
   // Converts nanoseconds to seconds.
@@ -201,8 +295,9 @@ void DumpTimingInfo(const SummaryInfo& info) {
 }
 
 // Dumps aggregate information about the generated samples described in 'info'
-// to stdout.
-void DumpSampleInfo(const SampleInfo& info) {
+// to stdout. If 'op_filter' is nonempty only the listed ops are shown.
+void DumpSampleInfo(const SampleInfo& info,
+                    const absl::flat_hash_set<std::string>& op_filter) {
   auto fmt = [&](const std::string& s, bool first_col = false) {
     if (first_col) {
       return absl::StrFormat("%-20s", s);
@@ -221,6 +316,9 @@ void DumpSampleInfo(const SampleInfo& info) {
   std::cout << "\n" << std::string(20 + 13 * (fields.size() - 1), '-') << "\n";
   for (Op op : AllOps()) {
     std::string op_str = OpToString(op);
+    if (!op_filter.empty() && !op_filter.contains(op_str)) {
+      continue;
+    }
     OpInfo op_info = info.per_op_info.contains(op_str)
                          ? info.per_op_info.at(op_str)
                          : OpInfo{0};
@@ -239,27 +337,75 @@ void DumpSampleInfo(const SampleInfo& info) {
   }
 }
 
+// Prints the ops which appear in no sample of 'info', before and after
+// optimizations. Useful for finding coverage gaps in a large corpus.
+void DumpCoverageGaps(const SummaryInfo& info) {
+  auto dump = [](absl::string_view banner, const SampleInfo& sample_info) {
+    std::cout << banner << "\n";
+    for (Op op : AllOps()) {
+      std::string op_str = OpToString(op);
+      if (!sample_info.per_op_info.contains(op_str) ||
+          sample_info.per_op_info.at(op_str).samples == 0) {
+        std::cout << "  " << op_str << "\n";
+      }
+    }
+  };
+  dump("Ops not covered before optimizations:", info.unoptimized_info);
+  dump("\nOps not covered after optimizations:", info.optimized_info);
+}
+
+// Reads and aggregates the single summary file at 'input_path' into 'info'.
+absl::Status AggregateFile(absl::string_view input_path, SummaryInfo* info) {
+  XLS_ASSIGN_OR_RETURN(std::string summary_data, GetFileContents(input_path));
+  fuzzer::SampleSummariesProto summaries;
+  if (!summaries.ParseFromString(summary_data)) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Failed to parse summary protobuf file: ", input_path));
+  }
+  for (const fuzzer::SampleSummaryProto& summary : summaries.samples()) {
+    AggregateSummary(summary, info);
+  }
+  return absl::OkStatus();
+}
+
 absl::Status RealMain(absl::Span<const absl::string_view> input_paths) {
+  int64_t worker_count = absl::GetFlag(FLAGS_worker_count);
+  if (worker_count == 0) {
+    worker_count =
+        std::min(static_cast<int64_t>(input_paths.size()),
+                 static_cast<int64_t>(std::thread::hardware_concurrency()));
+  }
+
+  // Each file is a shard aggregated independently; the shards are then merged
+  // in path order so the result is deterministic regardless of scheduling.
+  std::vector<SummaryInfo> per_file_info(input_paths.size());
+  std::vector<absl::Status> per_file_status(input_paths.size());
+  ThreadPool pool(worker_count);
+  pool.ParallelFor(0, input_paths.size(), [&](int64_t i) {
+    per_file_status[i] = AggregateFile(input_paths[i], &per_file_info[i]);
+  });
+
   SummaryInfo summary_info;
-  for (const absl::string_view input_path : input_paths) {
-    XLS_ASSIGN_OR_RETURN(std::string summary_data, GetFileContents(input_path));
-    fuzzer::SampleSummariesProto summaries;
-    if (!summaries.ParseFromString(summary_data)) {
-      return absl::InvalidArgumentError(
-          "Failed to parse summary protobuf file.");
-    }
-    for (const fuzzer::SampleSummaryProto& summary : summaries.samples()) {
-      AggregateSummary(summary, &summary_info);
-    }
+  for (int64_t i = 0; i < input_paths.size(); ++i) {
+    XLS_RETURN_IF_ERROR(per_file_status[i]);
+    MergeSummaryInfo(per_file_info[i], &summary_info);
+  }
+
+  if (absl::GetFlag(FLAGS_coverage_gaps)) {
+    DumpCoverageGaps(summary_info);
+    return absl::OkStatus();
   }
 
+  std::vector<std::string> ops_flag = absl::GetFlag(FLAGS_ops);
+  absl::flat_hash_set<std::string> op_filter(ops_flag.begin(), ops_flag.end());
+
   std::cout << "Before optimizations:\n";
   std::cout << "--------------------\n";
-  DumpSampleInfo(summary_info.unoptimized_info);
+  DumpSampleInfo(summary_info.unoptimized_info, op_filter);
 
   std::cout << "\nAfter optimizations\n";
   std::cout << "-------------------\n";
-  DumpSampleInfo(summary_info.optimized_info);
+  DumpSampleInfo(summary_info.optimized_info, op_filter);
 
   std::cout << "\nTiming\n";
   std::cout << "------\n";
@@ -16,6 +16,7 @@
 
 #include "absl/strings/match.h"
 #include "xls/common/status/ret_check.h"
+#include "xls/common/thread_pool.h"
 #include "xls/dslx/create_import_data.h"
 #include "xls/dslx/import_data.h"
 #include "xls/dslx/parse_and_typecheck.h"
@@ -253,4 +254,31 @@ absl::StatusOr<Sample> GenerateSample(const AstGeneratorOptions& options,
                 std::move(args_batch));
 }
 
+absl::StatusOr<std::vector<std::string>> GenerateSampleBatch(
+    const AstGeneratorOptions& options, int64_t calls_per_sample,
+    const SampleOptions& default_options, uint64_t seed, int64_t sample_count,
+    int64_t worker_count) {
+  std::vector<std::string> serialized(sample_count);
+  std::vector<absl::Status> statuses(sample_count);
+  ThreadPool pool(worker_count);
+  pool.ParallelFor(0, sample_count, [&](int64_t i) {
+    // Each sample gets a generator seeded by (seed, i) rather than a slice of
+    // one shared stream: the streams are decorrelated and sample i is
+    // reproducible in isolation without generating its predecessors.
+    std::seed_seq seq{seed, static_cast<uint64_t>(i)};
+    RngState rng{std::mt19937(seq)};
+    absl::StatusOr<Sample> sample =
+        GenerateSample(options, calls_per_sample, default_options, &rng);
+    if (!sample.ok()) {
+      statuses[i] = sample.status();
+      return;
+    }
+    serialized[i] = sample->Serialize();
+  });
+  for (const absl::Status& status : statuses) {
+    XLS_RETURN_IF_ERROR(status);
+  }
+  return serialized;
+}
+
 }  // namespace xls
@@ -55,6 +55,17 @@ absl::StatusOr<Sample> GenerateSample(const dslx::AstGeneratorOptions& options,
                                       const SampleOptions& default_options,
                                       RngState* rng);
 
+// Generates `sample_count` independent samples on a pool of `worker_count`
+// threads (zero means generate on the calling thread) and returns them in
+// serialized form (Sample::Serialize), ready to hand to run_fuzz workers.
+// Sample i is drawn from its own RNG stream seeded by (seed, i), so the
+// returned batch is deterministic for a given seed regardless of how samples
+// are scheduled across workers.
+absl::StatusOr<std::vector<std::string>> GenerateSampleBatch(
+    const dslx::AstGeneratorOptions& options, int64_t calls_per_sample,
+    const SampleOptions& default_options, uint64_t seed, int64_t sample_count,
+    int64_t worker_count);
+
 }  // namespace xls
 
 #endif  // XLS_FUZZER_SAMPLE_GENERATOR_H_
@@ -197,5 +197,29 @@ TEST(SampleGeneratorTest, GenerateCodegenSample) {
   EXPECT_TRUE(sample.args_batch().empty());
 }
 
+TEST(SampleGeneratorTest, GenerateSampleBatchIsDeterministic) {
+  SampleOptions sample_options;
+  constexpr int64_t kSampleCount = 8;
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::string> parallel,
+      GenerateSampleBatch(dslx::AstGeneratorOptions{}, /*calls_per_sample=*/2,
+                          sample_options, /*seed=*/42, kSampleCount,
+                          /*worker_count=*/4));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::string> serial,
+      GenerateSampleBatch(dslx::AstGeneratorOptions{}, /*calls_per_sample=*/2,
+                          sample_options, /*seed=*/42, kSampleCount,
+                          /*worker_count=*/0));
+  ASSERT_EQ(parallel.size(), kSampleCount);
+  // The batch is keyed only by (seed, index), so scheduling across workers
+  // must not change the result.
+  EXPECT_EQ(parallel, serial);
+  for (const std::string& text : parallel) {
+    XLS_ASSERT_OK_AND_ASSIGN(Sample sample, Sample::Deserialize(text));
+    EXPECT_EQ(sample.args_batch().size(), 2);
+    EXPECT_THAT(sample.input_text(), testing::HasSubstr("fn main"));
+  }
+}
+
 }  // namespace
 }  // namespace xls
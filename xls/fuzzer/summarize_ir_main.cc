@@ -12,6 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <map>
+#include <string>
+#include <utility>
+
 #include "google/protobuf/text_format.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/init_xls.h"
@@ -74,6 +78,52 @@ void SummarizePackage(Package* package,
     }
   }
 }
+
+// Builds the per-(op, type) histogram over 'nodes'. The histogram carries the
+// same counts the summary reader derives from the node list, so readers of
+// large corpora can aggregate the handful of histogram entries per sample
+// instead of walking every node.
+void BuildOpHistogram(
+    const google::protobuf::RepeatedPtrField<fuzzer::NodeProto>& nodes,
+    google::protobuf::RepeatedPtrField<fuzzer::OpHistogramProto>* histogram) {
+  // An ordered map keeps the emitted entries deterministic.
+  std::map<std::pair<std::string, std::string>, fuzzer::OpHistogramProto>
+      entries;
+  for (const fuzzer::NodeProto& node_proto : nodes) {
+    fuzzer::OpHistogramProto& entry =
+        entries[{node_proto.op(), node_proto.type()}];
+    entry.set_count(entry.count() + 1);
+    if (node_proto.width() > 64) {
+      entry.set_wider_than_64bits(entry.wider_than_64bits() + 1);
+    }
+    switch (node_proto.operands_size()) {
+      case 0:
+        entry.set_nullary(entry.nullary() + 1);
+        break;
+      case 1:
+        entry.set_unary(entry.unary() + 1);
+        break;
+      case 2:
+        entry.set_binary(entry.binary() + 1);
+        break;
+      default:
+        entry.set_manyary(entry.manyary() + 1);
+        break;
+    }
+    for (const fuzzer::NodeProto& operand : node_proto.operands()) {
+      if (operand.width() != node_proto.operands(0).width()) {
+        entry.set_mixed_width(entry.mixed_width() + 1);
+        break;
+      }
+    }
+  }
+  for (auto& [key, entry] : entries) {
+    entry.set_op(key.first);
+    entry.set_type(key.second);
+    *histogram->Add() = entry;
+  }
+}
+
 absl::StatusOr<std::unique_ptr<Package>> ParseFile(absl::string_view path) {
   XLS_ASSIGN_OR_RETURN(std::string contents, GetFileContents(path));
   return Parser::ParsePackage(contents, path);
@@ -101,11 +151,15 @@ absl::Status RealMain(absl::string_view unoptimized_path,
     XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
                          ParseFile(unoptimized_path));
     SummarizePackage(package.get(), summary_proto->mutable_unoptimized_nodes());
+    BuildOpHistogram(summary_proto->unoptimized_nodes(),
+                     summary_proto->mutable_unoptimized_op_histogram());
   }
   if (!optimized_path.empty()) {
     XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
                          ParseFile(optimized_path));
     SummarizePackage(package.get(), summary_proto->mutable_optimized_nodes());
+    BuildOpHistogram(summary_proto->optimized_nodes(),
+                     summary_proto->mutable_optimized_op_histogram());
   }
 
   XLS_QCHECK(!absl::GetFlag(FLAGS_summary_file).empty())
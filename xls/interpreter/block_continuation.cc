@@ -0,0 +1,209 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/interpreter/block_continuation.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/interpreter/evaluation_plan.h"
+#include "xls/ir/node_iterator.h"
+#include "xls/ir/value_helpers.h"
+
+namespace xls {
+namespace {
+
+// A DenseStorageInterpreter with the block-specific node handlers of
+// BlockRun's interpreter, except that input ports, register reads and
+// register writes resolve their values by dense index rather than by name in
+// a hash map.
+class DenseBlockInterpreter : public DenseStorageInterpreter {
+ public:
+  DenseBlockInterpreter(absl::Span<const int64_t> slot_of_node_id,
+                        absl::Span<Value> slots,
+                        absl::Span<int64_t> slot_epochs, int64_t epoch,
+                        absl::Span<const int64_t> index_of_node_id,
+                        absl::Span<const Value> inputs,
+                        absl::Span<const Value> reg_state,
+                        absl::Span<Value> next_reg_state)
+      : DenseStorageInterpreter(slot_of_node_id, slots, slot_epochs, epoch),
+        index_of_node_id_(index_of_node_id),
+        inputs_(inputs),
+        reg_state_(reg_state),
+        next_reg_state_(next_reg_state) {}
+
+  absl::Status HandleInputPort(InputPort* input_port) override {
+    return SetValueResult(input_port,
+                          inputs_[index_of_node_id_[input_port->id()]]);
+  }
+
+  absl::Status HandleOutputPort(OutputPort* output_port) override {
+    // Output ports have empty tuple types.
+    return SetValueResult(output_port, Value::Tuple({}));
+  }
+
+  absl::Status HandleRegisterRead(RegisterRead* reg_read) override {
+    return SetValueResult(reg_read,
+                          reg_state_[index_of_node_id_[reg_read->id()]]);
+  }
+
+  absl::Status HandleRegisterWrite(RegisterWrite* reg_write) override {
+    int64_t index = index_of_node_id_[reg_write->id()];
+    auto get_next_reg_state = [&]() -> Value {
+      if (reg_write->reset().has_value()) {
+        bool reset_signal = ResolveAsBool(reg_write->reset().value());
+        const Reset& reset = reg_write->GetRegister()->reset().value();
+        if ((reset_signal && !reset.active_low) ||
+            (!reset_signal && reset.active_low)) {
+          // Reset is activated. Next register state is the reset value.
+          return reset.reset_value;
+        }
+      }
+      if (reg_write->load_enable().has_value() &&
+          !ResolveAsBool(reg_write->load_enable().value())) {
+        // Load enable is not activated. Next register state is the previous
+        // register value.
+        return reg_state_[index];
+      }
+
+      // Next register state is the input data value.
+      return ResolveAsValue(reg_write->data());
+    };
+
+    next_reg_state_[index] = get_next_reg_state();
+
+    // Register writes have empty tuple types.
+    return SetValueResult(reg_write, Value::Tuple({}));
+  }
+
+ private:
+  absl::Span<const int64_t> index_of_node_id_;
+  absl::Span<const Value> inputs_;
+  absl::Span<const Value> reg_state_;
+  absl::Span<Value> next_reg_state_;
+};
+
+}  // namespace
+
+/* static */ absl::StatusOr<std::unique_ptr<BlockContinuation>>
+BlockContinuation::Create(Block* block) {
+  auto continuation = absl::WrapUnique(new BlockContinuation(block));
+
+  continuation->input_ports_.assign(block->GetInputPorts().begin(),
+                                    block->GetInputPorts().end());
+  continuation->output_ports_.assign(block->GetOutputPorts().begin(),
+                                     block->GetOutputPorts().end());
+  continuation->registers_.assign(block->GetRegisters().begin(),
+                                  block->GetRegisters().end());
+
+  int64_t max_id = 0;
+  for (Node* node : block->nodes()) {
+    max_id = std::max(max_id, node->id());
+  }
+  continuation->slot_of_node_id_.resize(max_id + 1, -1);
+  continuation->index_of_node_id_.resize(max_id + 1, -1);
+
+  int64_t slot = 0;
+  for (Node* node : TopoSort(block)) {
+    continuation->steps_.push_back(node);
+    continuation->slot_of_node_id_[node->id()] = slot++;
+  }
+  continuation->slots_.resize(slot);
+  continuation->slot_epochs_.resize(slot, 0);
+
+  // Bind the port and register nodes to the dense index of their port or
+  // register.
+  for (int64_t i = 0; i < continuation->input_ports_.size(); ++i) {
+    continuation->index_of_node_id_[continuation->input_ports_[i]->id()] = i;
+  }
+  for (int64_t i = 0; i < continuation->output_ports_.size(); ++i) {
+    continuation->index_of_node_id_[continuation->output_ports_[i]->id()] = i;
+  }
+  absl::flat_hash_map<Register*, int64_t> register_index;
+  for (int64_t i = 0; i < continuation->registers_.size(); ++i) {
+    register_index[continuation->registers_[i]] = i;
+  }
+  for (Node* node : block->nodes()) {
+    if (node->Is<RegisterRead>()) {
+      continuation->index_of_node_id_[node->id()] =
+          register_index.at(node->As<RegisterRead>()->GetRegister());
+    } else if (node->Is<RegisterWrite>()) {
+      continuation->index_of_node_id_[node->id()] =
+          register_index.at(node->As<RegisterWrite>()->GetRegister());
+    }
+  }
+
+  continuation->outputs_.resize(continuation->output_ports_.size());
+  continuation->ResetState();
+  return std::move(continuation);
+}
+
+absl::Status BlockContinuation::RunCycles(
+    absl::Span<const std::vector<Value>> inputs) {
+  // Resizing the columns retains their capacity so repeated calls with the
+  // same cycle count do not reallocate.
+  for (std::vector<Value>& column : outputs_) {
+    column.resize(inputs.size());
+  }
+
+  for (int64_t cycle = 0; cycle < inputs.size(); ++cycle) {
+    const std::vector<Value>& row = inputs[cycle];
+    if (row.size() != input_ports_.size()) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Block %s has %d input ports, got %d input values "
+                          "for cycle %d",
+                          block_->name(), input_ports_.size(), row.size(),
+                          cycle));
+    }
+    for (int64_t i = 0; i < row.size(); ++i) {
+      if (!ValueConformsToType(row[i], input_ports_[i]->GetType())) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "Got value %s for input port '%s' which is not of type %s",
+            row[i].ToString(), input_ports_[i]->GetName(),
+            input_ports_[i]->GetType()->ToString()));
+      }
+    }
+
+    ++current_epoch_;
+    DenseBlockInterpreter visitor(
+        slot_of_node_id_, absl::MakeSpan(slots_), absl::MakeSpan(slot_epochs_),
+        current_epoch_, index_of_node_id_, row, reg_state_,
+        absl::MakeSpan(next_reg_state_));
+    for (Node* node : steps_) {
+      XLS_RETURN_IF_ERROR(node->VisitSingleNode(&visitor));
+    }
+
+    for (int64_t i = 0; i < output_ports_.size(); ++i) {
+      outputs_[i][cycle] = visitor.ResolveAsValue(output_ports_[i]->operand(0));
+    }
+
+    // Clock the registers. Every register write stored a next state above, so
+    // swapping makes it current and recycles the old buffer as scratch.
+    std::swap(reg_state_, next_reg_state_);
+  }
+  return absl::OkStatus();
+}
+
+void BlockContinuation::ResetState() {
+  reg_state_.clear();
+  next_reg_state_.clear();
+  for (Register* reg : registers_) {
+    reg_state_.push_back(ZeroOfType(reg->type()));
+    next_reg_state_.push_back(ZeroOfType(reg->type()));
+  }
+}
+
+}  // namespace xls
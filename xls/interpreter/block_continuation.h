@@ -0,0 +1,108 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_INTERPRETER_BLOCK_CONTINUATION_H_
+#define XLS_INTERPRETER_BLOCK_CONTINUATION_H_
+
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/ir/block.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+
+// A stateful cycle-by-cycle evaluator for a single block. In contrast to
+// InterpretSequentialBlock which rebuilds name-keyed port and register maps
+// for every cycle of stimulus, a BlockContinuation binds the block's ports and
+// registers to dense indices once at creation time and carries the register
+// state across calls. Inputs are given positionally (one Value per input port
+// per cycle) and the outputs of a run land in a preallocated columnar buffer
+// (one vector of values per output port) which is reused across calls, making
+// long cycle-accurate runs from testbench-style drivers cheap.
+// BlockContinuations are thread-compatible, but not thread-safe.
+class BlockContinuation {
+ public:
+  // Creates a continuation for the given block. Registers start with zero
+  // values.
+  static absl::StatusOr<std::unique_ptr<BlockContinuation>> Create(
+      Block* block);
+
+  Block* block() const { return block_; }
+
+  // The orderings which give input rows, output columns and the register
+  // state their positional meaning. Fixed at creation time.
+  absl::Span<InputPort* const> input_ports() const { return input_ports_; }
+  absl::Span<OutputPort* const> output_ports() const { return output_ports_; }
+  absl::Span<Register* const> registers() const { return registers_; }
+
+  // Runs the block for inputs.size() cycles. inputs[cycle] must contain one
+  // value for each input port in input_ports() order. Registers are clocked
+  // between cycles and carry over to the next call.
+  absl::Status RunCycles(absl::Span<const std::vector<Value>> inputs);
+
+  // Returns the values produced on the index'th output port (output_ports()
+  // order), one per cycle of the most recent RunCycles call. The underlying
+  // buffer is overwritten by the next RunCycles call.
+  absl::Span<const Value> output_column(int64_t index) const {
+    return outputs_[index];
+  }
+
+  // Returns the current register state in registers() order.
+  absl::Span<const Value> register_state() const { return reg_state_; }
+
+  // Resets all registers to zero values, the state a newly created
+  // continuation starts in.
+  void ResetState();
+
+ private:
+  explicit BlockContinuation(Block* block) : block_(block) {}
+
+  Block* block_;
+
+  std::vector<InputPort*> input_ports_;
+  std::vector<OutputPort*> output_ports_;
+  std::vector<Register*> registers_;
+
+  // The block's nodes in topological (evaluation) order.
+  std::vector<Node*> steps_;
+
+  // Dense value storage as in EvaluationPlan: a node's result lives in
+  // slots_[slot_of_node_id_[node->id()]] and is valid for the current cycle
+  // iff its epoch tag equals current_epoch_.
+  std::vector<int64_t> slot_of_node_id_;
+  std::vector<Value> slots_;
+  std::vector<int64_t> slot_epochs_;
+  int64_t current_epoch_ = 0;
+
+  // Maps the id of an input port, output port, register read or register
+  // write node to the dense index of its port or register; -1 for all other
+  // nodes.
+  std::vector<int64_t> index_of_node_id_;
+
+  // Register state carried between cycles (registers() order) and the scratch
+  // buffer the next state is gathered into before the registers are clocked.
+  std::vector<Value> reg_state_;
+  std::vector<Value> next_reg_state_;
+
+  // Columnar output buffer: outputs_[port][cycle].
+  std::vector<std::vector<Value>> outputs_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_INTERPRETER_BLOCK_CONTINUATION_H_
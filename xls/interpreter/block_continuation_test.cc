@@ -0,0 +1,152 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/interpreter/block_continuation.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/interpreter/block_interpreter.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+namespace {
+
+using status_testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+class BlockContinuationTest : public IrTestBase {};
+
+TEST_F(BlockContinuationTest, CombinationalSumBlock) {
+  auto package = CreatePackage();
+  BlockBuilder b(TestName(), package.get());
+  BValue x = b.InputPort("x", package->GetBitsType(32));
+  BValue y = b.InputPort("y", package->GetBitsType(32));
+  b.OutputPort("sum", b.Add(x, y));
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block, b.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BlockContinuation> continuation,
+                           BlockContinuation::Create(block));
+  ASSERT_EQ(continuation->input_ports().size(), 2);
+  ASSERT_EQ(continuation->output_ports().size(), 1);
+
+  std::vector<std::vector<Value>> inputs = {
+      {Value(UBits(1, 32)), Value(UBits(2, 32))},
+      {Value(UBits(10, 32)), Value(UBits(20, 32))},
+      {Value(UBits(7, 32)), Value(UBits(8, 32))}};
+  XLS_ASSERT_OK(continuation->RunCycles(inputs));
+  EXPECT_THAT(continuation->output_column(0),
+              ElementsAre(Value(UBits(3, 32)), Value(UBits(30, 32)),
+                          Value(UBits(15, 32))));
+}
+
+TEST_F(BlockContinuationTest, AccumulatorCarriesStateAcrossCalls) {
+  auto package = CreatePackage();
+  BlockBuilder b(TestName(), package.get());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Register * reg, b.block()->AddRegister("accum", package->GetBitsType(32)));
+  XLS_ASSERT_OK(b.block()->AddClockPort("clk"));
+  BValue in = b.InputPort("in", package->GetBitsType(32));
+  BValue accum = b.RegisterRead(reg);
+  BValue next = b.Add(accum, in);
+  b.RegisterWrite(reg, next);
+  b.OutputPort("out", next);
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block, b.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BlockContinuation> continuation,
+                           BlockContinuation::Create(block));
+  ASSERT_EQ(continuation->registers().size(), 1);
+
+  std::vector<std::vector<Value>> inputs = {{Value(UBits(1, 32))},
+                                            {Value(UBits(2, 32))},
+                                            {Value(UBits(3, 32))}};
+  XLS_ASSERT_OK(continuation->RunCycles(inputs));
+  EXPECT_THAT(continuation->output_column(0),
+              ElementsAre(Value(UBits(1, 32)), Value(UBits(3, 32)),
+                          Value(UBits(6, 32))));
+  EXPECT_THAT(continuation->register_state(),
+              ElementsAre(Value(UBits(6, 32))));
+
+  // Register state carries over to the next call.
+  std::vector<std::vector<Value>> more_inputs = {{Value(UBits(10, 32))}};
+  XLS_ASSERT_OK(continuation->RunCycles(more_inputs));
+  EXPECT_THAT(continuation->output_column(0),
+              ElementsAre(Value(UBits(16, 32))));
+
+  // ResetState zeroes the registers again.
+  continuation->ResetState();
+  std::vector<std::vector<Value>> post_reset_inputs = {{Value(UBits(5, 32))}};
+  XLS_ASSERT_OK(continuation->RunCycles(post_reset_inputs));
+  EXPECT_THAT(continuation->output_column(0),
+              ElementsAre(Value(UBits(5, 32))));
+}
+
+TEST_F(BlockContinuationTest, MatchesInterpretSequentialBlock) {
+  auto package = CreatePackage();
+  BlockBuilder b(TestName(), package.get());
+  XLS_ASSERT_OK(b.block()->AddClockPort("clk"));
+  BValue in = b.InputPort("in", package->GetBitsType(32));
+  BValue delayed = b.InsertRegister("delay", in);
+  b.OutputPort("out", delayed);
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block, b.Build());
+
+  std::vector<absl::flat_hash_map<std::string, Value>> map_inputs;
+  std::vector<std::vector<Value>> row_inputs;
+  for (int64_t i = 0; i < 4; ++i) {
+    map_inputs.push_back({{"in", Value(UBits(100 + i, 32))}});
+    row_inputs.push_back({Value(UBits(100 + i, 32))});
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<absl::flat_hash_map<std::string, Value>> map_outputs,
+      InterpretSequentialBlock(block, map_inputs));
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BlockContinuation> continuation,
+                           BlockContinuation::Create(block));
+  XLS_ASSERT_OK(continuation->RunCycles(row_inputs));
+
+  for (int64_t cycle = 0; cycle < 4; ++cycle) {
+    EXPECT_EQ(continuation->output_column(0)[cycle],
+              map_outputs[cycle].at("out"));
+  }
+}
+
+TEST_F(BlockContinuationTest, InputErrors) {
+  auto package = CreatePackage();
+  BlockBuilder b(TestName(), package.get());
+  BValue x = b.InputPort("x", package->GetBitsType(32));
+  BValue y = b.InputPort("y", package->GetBitsType(32));
+  b.OutputPort("sum", b.Add(x, y));
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block, b.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BlockContinuation> continuation,
+                           BlockContinuation::Create(block));
+
+  std::vector<std::vector<Value>> short_row = {{Value(UBits(1, 32))}};
+  EXPECT_THAT(continuation->RunCycles(short_row),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("has 2 input ports, got 1 input values")));
+
+  std::vector<std::vector<Value>> bad_type = {
+      {Value(UBits(1, 32)), Value(UBits(1, 8))}};
+  EXPECT_THAT(continuation->RunCycles(bad_type),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("which is not of type bits[32]")));
+}
+
+}  // namespace
+}  // namespace xls
@@ -14,16 +14,39 @@
 
 #include "xls/interpreter/channel_queue.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_join.h"
+#include "xls/common/math_util.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/strerror.h"
+#include "xls/ir/packed_value.h"
 #include "xls/ir/type.h"
 #include "xls/ir/value_helpers.h"
 
 namespace xls {
 
+absl::Status ChannelQueue::EnqueueAll(absl::Span<const Value> values) {
+  for (const Value& value : values) {
+    XLS_RETURN_IF_ERROR(Enqueue(value));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ChannelQueue::DequeueAll(absl::Span<Value> values) {
+  for (Value& value : values) {
+    XLS_ASSIGN_OR_RETURN(value, Dequeue());
+  }
+  return absl::OkStatus();
+}
+
 absl::Status FifoChannelQueue::Enqueue(const Value& value) {
   XLS_VLOG(4) << absl::StreamFormat("Enqueuing value on channel %s: { %s }",
                                     channel_->name(), value.ToString());
@@ -97,6 +120,213 @@ absl::StatusOr<Value> SingleValueChannelQueue::Dequeue() {
   return value_.value();
 }
 
+absl::Status SpscChannelQueue::Enqueue(const Value& value) {
+  XLS_VLOG(4) << absl::StreamFormat("Enqueuing value on channel %s: { %s }",
+                                    channel_->name(), value.ToString());
+  if (!ValueConformsToType(value, channel_->type())) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Channel %s expects values to have type %s, got: %s", channel_->name(),
+        channel_->type()->ToString(), value.ToString()));
+  }
+  XLS_ASSIGN_OR_RETURN(PackedValue packed,
+                       PackedValue::FromValue(value, channel_->type()));
+
+  uint64_t enqueue_index = enqueue_index_.load(std::memory_order_relaxed);
+  // Spin until the consumer has drained a slot.
+  while (enqueue_index - dequeue_index_.load(std::memory_order_acquire) >=
+         kCapacity) {
+  }
+  memcpy(SlotAt(enqueue_index), packed.buffer(), element_size_);
+  enqueue_index_.store(enqueue_index + 1, std::memory_order_release);
+  return absl::OkStatus();
+}
+
+absl::StatusOr<Value> SpscChannelQueue::Dequeue() {
+  uint64_t dequeue_index = dequeue_index_.load(std::memory_order_relaxed);
+  if (dequeue_index == enqueue_index_.load(std::memory_order_acquire)) {
+    return absl::NotFoundError(
+        absl::StrFormat("Attempting to dequeue data from empty channel %s (%d)",
+                        channel_->name(), channel_->id()));
+  }
+  // The bytes are copied out of the slot before the dequeue index is
+  // published; after the store the producer may overwrite the slot.
+  XLS_ASSIGN_OR_RETURN(
+      PackedValue packed,
+      PackedValue::FromBuffer(
+          absl::MakeConstSpan(SlotAt(dequeue_index), element_size_),
+          channel_->type()));
+  dequeue_index_.store(dequeue_index + 1, std::memory_order_release);
+  return packed.ToValue();
+}
+
+absl::Status SpscChannelQueue::EnqueueAll(absl::Span<const Value> values) {
+  for (const Value& value : values) {
+    if (!ValueConformsToType(value, channel_->type())) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Channel %s expects values to have type %s, got: %s",
+          channel_->name(), channel_->type()->ToString(), value.ToString()));
+    }
+  }
+
+  uint64_t enqueue_index = enqueue_index_.load(std::memory_order_relaxed);
+  int64_t enqueued = 0;
+  while (enqueued < values.size()) {
+    // Wait for free slots, then fill as many as are available and publish the
+    // whole run with one release store.
+    uint64_t free_slots;
+    while ((free_slots =
+                kCapacity - (enqueue_index -
+                             dequeue_index_.load(std::memory_order_acquire))) ==
+           0) {
+    }
+    int64_t chunk = std::min(static_cast<int64_t>(free_slots),
+                             static_cast<int64_t>(values.size()) - enqueued);
+    for (int64_t i = 0; i < chunk; ++i) {
+      XLS_ASSIGN_OR_RETURN(
+          PackedValue packed,
+          PackedValue::FromValue(values[enqueued + i], channel_->type()));
+      memcpy(SlotAt(enqueue_index + i), packed.buffer(), element_size_);
+    }
+    enqueue_index += chunk;
+    enqueue_index_.store(enqueue_index, std::memory_order_release);
+    enqueued += chunk;
+  }
+  return absl::OkStatus();
+}
+
+absl::Status SpscChannelQueue::DequeueAll(absl::Span<Value> values) {
+  uint64_t dequeue_index = dequeue_index_.load(std::memory_order_relaxed);
+  int64_t dequeued = 0;
+  while (dequeued < values.size()) {
+    uint64_t available =
+        enqueue_index_.load(std::memory_order_acquire) - dequeue_index;
+    if (available == 0) {
+      return absl::NotFoundError(absl::StrFormat(
+          "Attempting to dequeue data from empty channel %s (%d)",
+          channel_->name(), channel_->id()));
+    }
+    int64_t chunk = std::min(static_cast<int64_t>(available),
+                             static_cast<int64_t>(values.size()) - dequeued);
+    for (int64_t i = 0; i < chunk; ++i) {
+      XLS_ASSIGN_OR_RETURN(
+          PackedValue packed,
+          PackedValue::FromBuffer(
+              absl::MakeConstSpan(SlotAt(dequeue_index + i), element_size_),
+              channel_->type()));
+      values[dequeued + i] = packed.ToValue();
+    }
+    dequeue_index += chunk;
+    dequeue_index_.store(dequeue_index, std::memory_order_release);
+    dequeued += chunk;
+  }
+  return absl::OkStatus();
+}
+
+/* static */ absl::StatusOr<std::unique_ptr<SpillingChannelQueue>>
+SpillingChannelQueue::Create(
+    Channel* channel, int64_t max_memory_elements,
+    std::optional<std::filesystem::path> spill_directory) {
+  XLS_RET_CHECK_GT(max_memory_elements, 0);
+  XLS_ASSIGN_OR_RETURN(TempFile spill_file,
+                       spill_directory.has_value()
+                           ? TempFile::CreateInDirectory(*spill_directory,
+                                                         /*suffix=*/".spill")
+                           : TempFile::Create(/*suffix=*/".spill"));
+  FileDescriptor fd(open(spill_file.path().c_str(), O_RDWR));
+  if (fd.get() < 0) {
+    return absl::InternalError(absl::StrFormat(
+        "Failed to open spill file %s for channel %s: %s",
+        spill_file.path().string(), channel->name(), Strerror(errno)));
+  }
+  return absl::WrapUnique(new SpillingChannelQueue(
+      channel, max_memory_elements, std::move(spill_file), std::move(fd)));
+}
+
+SpillingChannelQueue::SpillingChannelQueue(Channel* channel,
+                                           int64_t max_memory_elements,
+                                           TempFile spill_file,
+                                           FileDescriptor fd)
+    : ChannelQueue(channel),
+      record_size_(
+          CeilOfRatio(channel->type()->GetFlatBitCount(), int64_t{8})),
+      max_memory_elements_(max_memory_elements),
+      spill_file_(std::move(spill_file)),
+      fd_(std::move(fd)) {}
+
+absl::Status SpillingChannelQueue::Enqueue(const Value& value) {
+  if (!ValueConformsToType(value, channel_->type())) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Channel %s expects values to have type %s, got: %s", channel_->name(),
+        channel_->type()->ToString(), value.ToString()));
+  }
+  absl::MutexLock lock(&mutex_);
+  // Once anything has spilled, later values must spill as well or they would
+  // overtake the spilled region (see the invariant on memory_queue_).
+  if (spill_read_index_ < spill_write_index_ ||
+      static_cast<int64_t>(memory_queue_.size()) >= max_memory_elements_) {
+    return SpillValue(value);
+  }
+  memory_queue_.push_back(value);
+  return absl::OkStatus();
+}
+
+absl::StatusOr<Value> SpillingChannelQueue::Dequeue() {
+  absl::MutexLock lock(&mutex_);
+  // The in-memory window is refilled before the spill region, so an empty
+  // window means an empty queue.
+  if (memory_queue_.empty()) {
+    return absl::NotFoundError(
+        absl::StrFormat("Attempting to dequeue data from empty channel %s (%d)",
+                        channel_->name(), channel_->id()));
+  }
+  Value value = std::move(memory_queue_.front());
+  memory_queue_.pop_front();
+  XLS_RETURN_IF_ERROR(RefillFromSpill());
+  return value;
+}
+
+absl::Status SpillingChannelQueue::SpillValue(const Value& value) {
+  XLS_ASSIGN_OR_RETURN(PackedValue packed,
+                       PackedValue::FromValue(value, channel_->type()));
+  XLS_RET_CHECK_EQ(packed.size_in_bytes(), record_size_);
+  if (pwrite(fd_.get(), packed.buffer(), record_size_,
+             spill_write_index_ * record_size_) != record_size_) {
+    return absl::InternalError(absl::StrFormat(
+        "Failed to spill value on channel %s to %s: %s", channel_->name(),
+        spill_file_.path().string(), Strerror(errno)));
+  }
+  ++spill_write_index_;
+  return absl::OkStatus();
+}
+
+absl::Status SpillingChannelQueue::RefillFromSpill() {
+  std::vector<uint8_t> buffer(record_size_);
+  while (static_cast<int64_t>(memory_queue_.size()) < max_memory_elements_ &&
+         spill_read_index_ < spill_write_index_) {
+    if (pread(fd_.get(), buffer.data(), record_size_,
+              spill_read_index_ * record_size_) != record_size_) {
+      return absl::InternalError(absl::StrFormat(
+          "Failed to reload spilled value on channel %s from %s: %s",
+          channel_->name(), spill_file_.path().string(), Strerror(errno)));
+    }
+    XLS_ASSIGN_OR_RETURN(PackedValue packed,
+                         PackedValue::FromBuffer(buffer, channel_->type()));
+    memory_queue_.push_back(packed.ToValue());
+    ++spill_read_index_;
+  }
+  // Reclaim the file once every spilled element has been reloaded.
+  if (spill_read_index_ == spill_write_index_ && spill_write_index_ > 0) {
+    spill_read_index_ = 0;
+    spill_write_index_ = 0;
+    if (ftruncate(fd_.get(), 0) != 0) {
+      return absl::InternalError(absl::StrFormat(
+          "Failed to truncate spill file %s of channel %s: %s",
+          spill_file_.path().string(), channel_->name(), Strerror(errno)));
+    }
+  }
+  return absl::OkStatus();
+}
+
 static bool IsSingleValueChannelQueue(ChannelQueue* queue) {
   return dynamic_cast<SingleValueChannelQueue*>(queue) != nullptr;
 }
@@ -106,6 +336,24 @@ absl::StatusOr<std::unique_ptr<ChannelQueueManager>>
 ChannelQueueManager::Create(
     std::vector<std::unique_ptr<ChannelQueue>>&& user_defined_queues,
     Package* package) {
+  return CreateInternal(std::move(user_defined_queues), package,
+                        /*use_spsc_queues=*/false);
+}
+
+/* static */
+absl::StatusOr<std::unique_ptr<ChannelQueueManager>>
+ChannelQueueManager::CreateSingleProducerSingleConsumer(
+    std::vector<std::unique_ptr<ChannelQueue>>&& user_defined_queues,
+    Package* package) {
+  return CreateInternal(std::move(user_defined_queues), package,
+                        /*use_spsc_queues=*/true);
+}
+
+/* static */
+absl::StatusOr<std::unique_ptr<ChannelQueueManager>>
+ChannelQueueManager::CreateInternal(
+    std::vector<std::unique_ptr<ChannelQueue>>&& user_defined_queues,
+    Package* package, bool use_spsc_queues) {
   auto manager = absl::WrapUnique(new ChannelQueueManager(package));
 
   // Verify there is an receive-only queue for every ReceiveOnly channel in the
@@ -156,6 +404,8 @@ ChannelQueueManager::Create(
     if (channel->kind() == ChannelKind::kSingleValue) {
       manager->queues_[channel] =
           std::make_unique<SingleValueChannelQueue>(channel);
+    } else if (use_spsc_queues) {
+      manager->queues_[channel] = std::make_unique<SpscChannelQueue>(channel);
     } else {
       manager->queues_[channel] = std::make_unique<FifoChannelQueue>(channel);
     }
@@ -185,4 +435,35 @@ absl::StatusOr<ChannelQueue*> ChannelQueueManager::GetQueueByName(
   return queues_.at(channel).get();
 }
 
+absl::Status ChannelQueueManager::UseSpillingQueue(
+    Channel* channel, int64_t max_memory_elements,
+    std::optional<std::filesystem::path> spill_directory) {
+  auto it = queues_.find(channel);
+  if (it == queues_.end()) {
+    return absl::NotFoundError(absl::StrFormat(
+        "No queue exists for channel %s", channel->name()));
+  }
+  if (channel->kind() != ChannelKind::kStreaming) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Spilling queues are only supported for streaming channels; channel "
+        "%s has kind %s",
+        channel->name(), ChannelKindToString(channel->kind())));
+  }
+  if (!it->second->empty()) {
+    return absl::FailedPreconditionError(absl::StrFormat(
+        "Cannot replace non-empty queue of channel %s with a spilling queue",
+        channel->name()));
+  }
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<SpillingChannelQueue> queue,
+      SpillingChannelQueue::Create(channel, max_memory_elements,
+                                   std::move(spill_directory)));
+  auto vec_it = std::find(queue_vec_.begin(), queue_vec_.end(),
+                          it->second.get());
+  XLS_RET_CHECK(vec_it != queue_vec_.end());
+  *vec_it = queue.get();
+  it->second = std::move(queue);
+  return absl::OkStatus();
+}
+
 }  // namespace xls
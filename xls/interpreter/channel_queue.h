@@ -15,12 +15,18 @@
 #ifndef XLS_INTERPRETER_CHANNEL_QUEUE_H_
 #define XLS_INTERPRETER_CHANNEL_QUEUE_H_
 
+#include <atomic>
 #include <deque>
+#include <filesystem>
 #include <functional>
+#include <optional>
 #include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "xls/common/file/file_descriptor.h"
+#include "xls/common/file/temp_file.h"
+#include "xls/common/math_util.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/package.h"
 #include "xls/ir/value.h"
@@ -60,6 +66,16 @@ class ChannelQueue {
   // channel is empty.
   virtual absl::StatusOr<Value> Dequeue() = 0;
 
+  // Enqueues each value in 'values' in order. The default implementation
+  // simply loops over Enqueue; queue implementations may override this to
+  // amortize synchronization over the whole batch.
+  virtual absl::Status EnqueueAll(absl::Span<const Value> values);
+
+  // Dequeues values.size() values into 'values', front of the queue first.
+  // Returns an error if the queue runs out of elements; values dequeued
+  // before the error remain in 'values'.
+  virtual absl::Status DequeueAll(absl::Span<Value> values);
+
  protected:
   Channel* channel_;
 };
@@ -176,6 +192,131 @@ class SingleValueChannelQueue : public ChannelQueue {
   mutable absl::Mutex mutex_;
 };
 
+// A queue for streaming channels with exactly one producer thread and one
+// consumer thread, which matches how XLS channels are used: each channel is
+// sent on by a single proc and received on by a single proc. Values are
+// stored as flattened bytes (the packed layout of xls/ir/packed_value.h, the
+// same layout the JIT's packed views use) in a preallocated lock-free ring
+// buffer: the enqueue index is written only by the producer and the dequeue
+// index only by the consumer, and the two indices are padded onto separate
+// cache lines to avoid false sharing. This mirrors the design of
+// SpscJitChannelQueue in xls/jit/jit_channel_queue.h. Unlike FifoChannelQueue
+// the ring has a fixed capacity: when the queue is full Enqueue spins until
+// the consumer drains a slot, so the consumer must be running concurrently
+// with the producer.
+class SpscChannelQueue : public ChannelQueue {
+ public:
+  explicit SpscChannelQueue(Channel* channel)
+      : ChannelQueue(channel),
+        element_size_(
+            CeilOfRatio(channel->type()->GetFlatBitCount(), int64_t{8})),
+        allocated_element_size_(RoundUpToNearest(
+            std::max(element_size_, int64_t{1}),
+            static_cast<int64_t>(alignof(std::max_align_t)))),
+        circular_buffer_(kCapacity * allocated_element_size_) {}
+
+  int64_t size() const override {
+    return static_cast<int64_t>(enqueue_index_.load(std::memory_order_acquire) -
+                                dequeue_index_.load(std::memory_order_acquire));
+  }
+
+  bool empty() const override { return size() == 0; }
+
+  absl::Status Enqueue(const Value& value) override;
+  absl::StatusOr<Value> Dequeue() override;
+
+  // Batched variants which publish each contiguous run of slots with a single
+  // atomic store rather than one per element.
+  absl::Status EnqueueAll(absl::Span<const Value> values) override;
+  absl::Status DequeueAll(absl::Span<Value> values) override;
+
+ protected:
+  // Number of preallocated element slots in the ring buffer.
+  static constexpr uint64_t kCapacity = 1024;
+  // Typical cache line size used to pad the indices.
+  static constexpr size_t kCacheLineBytes = 64;
+
+  // Returns a pointer to the slot holding the element with the given
+  // monotonically increasing index.
+  uint8_t* SlotAt(uint64_t index) {
+    return circular_buffer_.data() + (index % kCapacity) * allocated_element_size_;
+  }
+
+  // Size of a flattened channel element in bytes.
+  int64_t element_size_;
+  // Allocated size of an element slot; elements are aligned to the largest
+  // scalar type.
+  int64_t allocated_element_size_;
+  // Preallocated storage for kCapacity element slots.
+  std::vector<uint8_t> circular_buffer_;
+  // Monotonically increasing count of dequeued elements; written only by the
+  // consumer. The slot index is the count modulo kCapacity.
+  alignas(kCacheLineBytes) std::atomic<uint64_t> dequeue_index_{0};
+  // Monotonically increasing count of enqueued elements; written only by the
+  // producer.
+  alignas(kCacheLineBytes) std::atomic<uint64_t> enqueue_index_{0};
+};
+
+// A FIFO queue which bounds its in-memory footprint. Up to
+// `max_memory_elements` values are held in memory; overflow is spilled to a
+// temporary file as fixed-size records in the packed byte layout of
+// xls/ir/packed_value.h and transparently reloaded as the in-memory window
+// drains, so externally the queue behaves exactly like a FifoChannelQueue.
+// Intended for long-running simulations which buffer full channel traces
+// (e.g. eval_proc_main soak runs) where a channel can accumulate far more
+// data than fits in RAM. SpillingChannelQueues are thread-safe. The spill
+// file is truncated whenever every spilled element has been reloaded and is
+// deleted when the queue is destroyed.
+class SpillingChannelQueue : public ChannelQueue {
+ public:
+  // Creates a queue for `channel` holding at most `max_memory_elements`
+  // values in memory (must be positive). The spill file is created in
+  // `spill_directory` if given, otherwise in the system temporary directory.
+  static absl::StatusOr<std::unique_ptr<SpillingChannelQueue>> Create(
+      Channel* channel, int64_t max_memory_elements,
+      std::optional<std::filesystem::path> spill_directory = std::nullopt);
+
+  int64_t size() const override {
+    absl::MutexLock lock(&mutex_);
+    return static_cast<int64_t>(memory_queue_.size()) +
+           (spill_write_index_ - spill_read_index_);
+  }
+
+  bool empty() const override { return size() == 0; }
+
+  absl::Status Enqueue(const Value& value) override;
+  absl::StatusOr<Value> Dequeue() override;
+
+ protected:
+  SpillingChannelQueue(Channel* channel, int64_t max_memory_elements,
+                       TempFile spill_file, FileDescriptor fd);
+
+  // Appends `value` in packed format at the tail of the spill region.
+  absl::Status SpillValue(const Value& value)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Reloads spilled records into the in-memory window until it is full or
+  // the spill region is drained, truncating the file in the latter case.
+  absl::Status RefillFromSpill() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Size in bytes of one packed spill record.
+  int64_t record_size_;
+  int64_t max_memory_elements_;
+  // Owns (and on destruction deletes) the spill file.
+  TempFile spill_file_;
+  FileDescriptor fd_;
+
+  // In-memory window holding the front of the queue. Invariant: whenever the
+  // spill region is nonempty the window is full, so FIFO order is preserved
+  // by spilling every enqueue until the region drains.
+  std::deque<Value> memory_queue_ ABSL_GUARDED_BY(mutex_);
+  // Half-open range of record indices currently spilled to the file.
+  int64_t spill_read_index_ ABSL_GUARDED_BY(mutex_) = 0;
+  int64_t spill_write_index_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  mutable absl::Mutex mutex_;
+};
+
 // An abstraction holding a collection of channel queues for interpreting the
 // procs within a single package. Essentially a map of channel queues with some
 // convenience methods.
@@ -190,6 +331,16 @@ class ChannelQueueManager {
       std::vector<std::unique_ptr<ChannelQueue>>&& user_defined_queues,
       Package* package);
 
+  // Like Create(), but maps each streaming channel without a user-defined
+  // queue to a lock-free SpscChannelQueue storing flattened bytes. Intended
+  // for runtimes where each channel is accessed by exactly one concurrently
+  // running producer thread and one consumer thread; the counterpart of
+  // JitChannelQueueManager::CreateSingleProducerSingleConsumer.
+  static absl::StatusOr<std::unique_ptr<ChannelQueueManager>>
+  CreateSingleProducerSingleConsumer(
+      std::vector<std::unique_ptr<ChannelQueue>>&& user_defined_queues,
+      Package* package);
+
   // Get the channel queue associated with the channel with the given id/name.
   ChannelQueue& GetQueue(Channel* channel) { return *queues_.at(channel); }
 
@@ -201,9 +352,26 @@ class ChannelQueueManager {
   absl::StatusOr<ChannelQueue*> GetQueueById(int64_t channel_id);
   absl::StatusOr<ChannelQueue*> GetQueueByName(absl::string_view name);
 
+  // Replaces the queue backing `channel` with a SpillingChannelQueue holding
+  // at most `max_memory_elements` values in memory (see
+  // SpillingChannelQueue). The channel must be a streaming channel and its
+  // current queue must be empty. This selects spilling per channel, so a few
+  // high-volume trace channels can run with bounded memory while the rest
+  // keep their ordinary in-memory queues.
+  absl::Status UseSpillingQueue(
+      Channel* channel, int64_t max_memory_elements,
+      std::optional<std::filesystem::path> spill_directory = std::nullopt);
+
  protected:
   explicit ChannelQueueManager(Package* package) : package_(package) {}
 
+  // Shared implementation of the Create methods. When 'use_spsc_queues' is
+  // true streaming channels without user-defined queues are backed by
+  // SpscChannelQueues rather than FifoChannelQueues.
+  static absl::StatusOr<std::unique_ptr<ChannelQueueManager>> CreateInternal(
+      std::vector<std::unique_ptr<ChannelQueue>>&& user_defined_queues,
+      Package* package, bool use_spsc_queues);
+
   Package* package_;
 
   // Channel queues indexed by the associated channel pointer.
@@ -17,7 +17,9 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/statusor.h"
+#include "xls/common/logging/logging.h"
 #include "xls/common/status/matchers.h"
+#include "xls/common/thread.h"
 #include "xls/interpreter/ir_interpreter.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/channel.pb.h"
@@ -132,6 +134,247 @@ TEST_F(ChannelQueueTest, EmptyFixedInputQueue) {
   EXPECT_TRUE(queue.empty());
 }
 
+TEST_F(ChannelQueueTest, SpscChannelQueueTest) {
+  Package package(TestName());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package.CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                     package.GetBitsType(32)));
+  SpscChannelQueue queue(channel);
+  EXPECT_EQ(queue.channel(), channel);
+  EXPECT_EQ(queue.size(), 0);
+  EXPECT_TRUE(queue.empty());
+
+  XLS_ASSERT_OK(queue.Enqueue(Value(UBits(42, 32))));
+  EXPECT_EQ(queue.size(), 1);
+  EXPECT_FALSE(queue.empty());
+
+  XLS_ASSERT_OK(queue.Enqueue(Value(UBits(123, 32))));
+  EXPECT_EQ(queue.size(), 2);
+
+  EXPECT_THAT(queue.Dequeue(), IsOkAndHolds(Value(UBits(42, 32))));
+  EXPECT_THAT(queue.Dequeue(), IsOkAndHolds(Value(UBits(123, 32))));
+  EXPECT_TRUE(queue.empty());
+
+  EXPECT_THAT(
+      queue.Dequeue(),
+      StatusIs(
+          absl::StatusCode::kNotFound,
+          HasSubstr(
+              "Attempting to dequeue data from empty channel my_channel")));
+  EXPECT_THAT(queue.Enqueue(Value(UBits(44, 123))),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Channel my_channel expects values to have "
+                                 "type bits[32]")));
+}
+
+TEST_F(ChannelQueueTest, SpscChannelQueueCompoundType) {
+  Package package(TestName());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package.CreateStreamingChannel(
+          "my_channel", ChannelOps::kSendReceive,
+          package.GetTupleType(
+              {package.GetBitsType(12), package.GetBitsType(3)})));
+  SpscChannelQueue queue(channel);
+
+  Value value =
+      Value::Tuple({Value(UBits(0xabc, 12)), Value(UBits(0x5, 3))});
+  XLS_ASSERT_OK(queue.Enqueue(value));
+  EXPECT_THAT(queue.Dequeue(), IsOkAndHolds(value));
+}
+
+TEST_F(ChannelQueueTest, SpscChannelQueueBatchedOperations) {
+  Package package(TestName());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package.CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                     package.GetBitsType(32)));
+  SpscChannelQueue queue(channel);
+
+  std::vector<Value> inputs;
+  for (int64_t i = 0; i < 100; ++i) {
+    inputs.push_back(Value(UBits(i, 32)));
+  }
+  XLS_ASSERT_OK(queue.EnqueueAll(inputs));
+  EXPECT_EQ(queue.size(), 100);
+
+  std::vector<Value> outputs(100);
+  XLS_ASSERT_OK(queue.DequeueAll(absl::MakeSpan(outputs)));
+  EXPECT_EQ(outputs, inputs);
+  EXPECT_TRUE(queue.empty());
+
+  EXPECT_THAT(queue.DequeueAll(absl::MakeSpan(outputs)),
+              StatusIs(absl::StatusCode::kNotFound,
+                       HasSubstr("Attempting to dequeue data from empty "
+                                 "channel my_channel")));
+}
+
+TEST_F(ChannelQueueTest, SpscChannelQueueThreadedProducerConsumer) {
+  Package package(TestName());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package.CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                     package.GetBitsType(64)));
+  SpscChannelQueue queue(channel);
+
+  // More elements than the ring has slots, so the producer must wait for the
+  // consumer at some point.
+  constexpr int64_t kNumElements = 10000;
+  Thread producer([&]() {
+    for (int64_t i = 0; i < kNumElements; ++i) {
+      XLS_CHECK_OK(queue.Enqueue(Value(UBits(i, 64))));
+    }
+  });
+  for (int64_t i = 0; i < kNumElements; ++i) {
+    absl::StatusOr<Value> value = queue.Dequeue();
+    while (!value.ok()) {
+      value = queue.Dequeue();
+    }
+    EXPECT_EQ(*value, Value(UBits(i, 64)));
+  }
+  producer.Join();
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(ChannelQueueTest, SpillingChannelQueueTest) {
+  Package package(TestName());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package.CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                     package.GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<SpillingChannelQueue> queue,
+      SpillingChannelQueue::Create(channel, /*max_memory_elements=*/4));
+  EXPECT_EQ(queue->channel(), channel);
+  EXPECT_EQ(queue->size(), 0);
+  EXPECT_TRUE(queue->empty());
+
+  // Well beyond the in-memory window so most elements spill to disk.
+  constexpr int64_t kNumElements = 100;
+  for (int64_t i = 0; i < kNumElements; ++i) {
+    XLS_ASSERT_OK(queue->Enqueue(Value(UBits(i, 32))));
+  }
+  EXPECT_EQ(queue->size(), kNumElements);
+
+  for (int64_t i = 0; i < kNumElements; ++i) {
+    EXPECT_THAT(queue->Dequeue(), IsOkAndHolds(Value(UBits(i, 32))));
+  }
+  EXPECT_TRUE(queue->empty());
+
+  EXPECT_THAT(
+      queue->Dequeue(),
+      StatusIs(
+          absl::StatusCode::kNotFound,
+          HasSubstr(
+              "Attempting to dequeue data from empty channel my_channel")));
+  EXPECT_THAT(queue->Enqueue(Value(UBits(44, 123))),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Channel my_channel expects values to have "
+                                 "type bits[32]")));
+}
+
+TEST_F(ChannelQueueTest, SpillingChannelQueueInterleavedOperations) {
+  Package package(TestName());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package.CreateStreamingChannel(
+          "my_channel", ChannelOps::kSendReceive,
+          package.GetTupleType(
+              {package.GetBitsType(12), package.GetBitsType(3)})));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<SpillingChannelQueue> queue,
+      SpillingChannelQueue::Create(channel, /*max_memory_elements=*/2));
+
+  auto make_value = [](int64_t i) {
+    return Value::Tuple({Value(UBits(i % 4096, 12)), Value(UBits(i % 8, 3))});
+  };
+  // Interleave enqueues and dequeues so the queue repeatedly spills and
+  // drains (including truncating the spill file) while preserving order.
+  int64_t next_enqueue = 0;
+  int64_t next_dequeue = 0;
+  for (int64_t round = 0; round < 10; ++round) {
+    for (int64_t i = 0; i < 7; ++i) {
+      XLS_ASSERT_OK(queue->Enqueue(make_value(next_enqueue++)));
+    }
+    while (next_dequeue + 2 < next_enqueue) {
+      EXPECT_THAT(queue->Dequeue(), IsOkAndHolds(make_value(next_dequeue++)));
+    }
+  }
+  while (next_dequeue < next_enqueue) {
+    EXPECT_THAT(queue->Dequeue(), IsOkAndHolds(make_value(next_dequeue++)));
+  }
+  EXPECT_TRUE(queue->empty());
+}
+
+TEST_F(ChannelQueueTest, SpillingQueueManagerSelection) {
+  Package package(TestName());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel_a,
+      package.CreateStreamingChannel("a", ChannelOps::kSendReceive,
+                                     package.GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel_b,
+      package.CreateSingleValueChannel("b", ChannelOps::kSendReceive,
+                                       package.GetBitsType(32)));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ChannelQueueManager> manager,
+      ChannelQueueManager::Create(/*user_defined_queues=*/{}, &package));
+
+  // Single-value channels cannot use a spilling queue.
+  EXPECT_THAT(
+      manager->UseSpillingQueue(channel_b, /*max_memory_elements=*/4),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("only supported for streaming channels")));
+
+  // A non-empty queue cannot be replaced.
+  XLS_ASSERT_OK(manager->GetQueue(channel_a).Enqueue(Value(UBits(1, 32))));
+  EXPECT_THAT(manager->UseSpillingQueue(channel_a, /*max_memory_elements=*/4),
+              StatusIs(absl::StatusCode::kFailedPrecondition,
+                       HasSubstr("non-empty queue")));
+  XLS_ASSERT_OK(manager->GetQueue(channel_a).Dequeue().status());
+
+  XLS_ASSERT_OK(manager->UseSpillingQueue(channel_a,
+                                          /*max_memory_elements=*/4));
+  EXPECT_NE(dynamic_cast<SpillingChannelQueue*>(&manager->GetQueue(channel_a)),
+            nullptr);
+  for (int64_t i = 0; i < 20; ++i) {
+    XLS_ASSERT_OK(manager->GetQueue(channel_a).Enqueue(Value(UBits(i, 32))));
+  }
+  for (int64_t i = 0; i < 20; ++i) {
+    EXPECT_THAT(manager->GetQueue(channel_a).Dequeue(),
+                IsOkAndHolds(Value(UBits(i, 32))));
+  }
+}
+
+TEST_F(ChannelQueueTest, SingleProducerSingleConsumerManager) {
+  Package package(TestName());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel_a,
+      package.CreateStreamingChannel("a", ChannelOps::kReceiveOnly,
+                                     package.GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel_b,
+      package.CreateSingleValueChannel("b", ChannelOps::kSendReceive,
+                                       package.GetBitsType(32)));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ChannelQueueManager> manager,
+      ChannelQueueManager::CreateSingleProducerSingleConsumer(
+          /*user_defined_queues=*/{}, &package));
+  EXPECT_EQ(manager->queues().size(), 2);
+  EXPECT_NE(dynamic_cast<SpscChannelQueue*>(&manager->GetQueue(channel_a)),
+            nullptr);
+  EXPECT_NE(
+      dynamic_cast<SingleValueChannelQueue*>(&manager->GetQueue(channel_b)),
+      nullptr);
+
+  XLS_ASSERT_OK(manager->GetQueue(channel_a).Enqueue(Value(UBits(7, 32))));
+  EXPECT_THAT(manager->GetQueue(channel_a).Dequeue(),
+              IsOkAndHolds(Value(UBits(7, 32))));
+}
+
 TEST_F(ChannelQueueTest, SimpleChannelQueueManager) {
   Package package(TestName());
   XLS_ASSERT_OK_AND_ASSIGN(
@@ -0,0 +1,480 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/interpreter/evaluation_plan.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/bits_util.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/interpreter/ir_interpreter.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/node_iterator.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/value_helpers.h"
+
+namespace xls {
+namespace {
+
+using KernelStep = EvaluationPlan::KernelStep;
+
+// Sign-extends the low 'width' bits of 'value' to a full-width
+// int64_t. Requires 1 <= width <= 64.
+int64_t ToSigned(uint64_t value, int64_t width) {
+  uint64_t sign = uint64_t{1} << (width - 1);
+  return static_cast<int64_t>((value ^ sign) - sign);
+}
+
+// The uint64 kernels below implement the op semantics of the corresponding
+// IrInterpreter handlers for bits-typed nodes of width 1 to 64. Values are
+// stored in the word array zero-extended, so every kernel masks its result
+// down to the result width.
+
+void LiteralKernel(const KernelStep& s, uint64_t* words) {
+  words[s.result_slot] = s.immediate;
+}
+
+void IdentityKernel(const KernelStep& s, uint64_t* words) {
+  words[s.result_slot] = words[s.operand_slots[0]];
+}
+
+void NotKernel(const KernelStep& s, uint64_t* words) {
+  words[s.result_slot] = ~words[s.operand_slots[0]] & Mask(s.result_width);
+}
+
+void NegKernel(const KernelStep& s, uint64_t* words) {
+  words[s.result_slot] = -words[s.operand_slots[0]] & Mask(s.result_width);
+}
+
+void SignExtendKernel(const KernelStep& s, uint64_t* words) {
+  words[s.result_slot] =
+      static_cast<uint64_t>(
+          ToSigned(words[s.operand_slots[0]], s.operand_widths[0])) &
+      Mask(s.result_width);
+}
+
+template <Op kOp>
+void NaryBitwiseKernel(const KernelStep& s, uint64_t* words) {
+  uint64_t accum = words[s.operand_slots[0]];
+  for (int64_t i = 1; i < s.operand_count; ++i) {
+    uint64_t word = words[s.operand_slots[i]];
+    if constexpr (kOp == Op::kAnd || kOp == Op::kNand) {
+      accum &= word;
+    } else if constexpr (kOp == Op::kOr || kOp == Op::kNor) {
+      accum |= word;
+    } else {
+      accum ^= word;
+    }
+  }
+  if constexpr (kOp == Op::kNand || kOp == Op::kNor) {
+    accum = ~accum & Mask(s.result_width);
+  }
+  words[s.result_slot] = accum;
+}
+
+template <Op kOp>
+void ArithKernel(const KernelStep& s, uint64_t* words) {
+  uint64_t a = words[s.operand_slots[0]];
+  uint64_t b = words[s.operand_slots[1]];
+  uint64_t result;
+  if constexpr (kOp == Op::kAdd) {
+    result = a + b;
+  } else if constexpr (kOp == Op::kSub) {
+    result = a - b;
+  } else if constexpr (kOp == Op::kUMul) {
+    result = a * b;
+  } else {  // Op::kSMul. Multiply as uint64 to avoid signed overflow; the low
+            // 64 bits of the product are the same either way.
+    result = static_cast<uint64_t>(ToSigned(a, s.operand_widths[0])) *
+             static_cast<uint64_t>(ToSigned(b, s.operand_widths[1]));
+  }
+  words[s.result_slot] = result & Mask(s.result_width);
+}
+
+template <Op kOp>
+void CompareKernel(const KernelStep& s, uint64_t* words) {
+  bool result;
+  if constexpr (kOp == Op::kSLt || kOp == Op::kSLe || kOp == Op::kSGt ||
+                kOp == Op::kSGe) {
+    int64_t a = ToSigned(words[s.operand_slots[0]], s.operand_widths[0]);
+    int64_t b = ToSigned(words[s.operand_slots[1]], s.operand_widths[1]);
+    if constexpr (kOp == Op::kSLt) {
+      result = a < b;
+    } else if constexpr (kOp == Op::kSLe) {
+      result = a <= b;
+    } else if constexpr (kOp == Op::kSGt) {
+      result = a > b;
+    } else {
+      result = a >= b;
+    }
+  } else {
+    uint64_t a = words[s.operand_slots[0]];
+    uint64_t b = words[s.operand_slots[1]];
+    if constexpr (kOp == Op::kEq) {
+      result = a == b;
+    } else if constexpr (kOp == Op::kNe) {
+      result = a != b;
+    } else if constexpr (kOp == Op::kULt) {
+      result = a < b;
+    } else if constexpr (kOp == Op::kULe) {
+      result = a <= b;
+    } else if constexpr (kOp == Op::kUGt) {
+      result = a > b;
+    } else {
+      result = a >= b;
+    }
+  }
+  words[s.result_slot] = result ? 1 : 0;
+}
+
+template <Op kOp>
+void ShiftKernel(const KernelStep& s, uint64_t* words) {
+  uint64_t input = words[s.operand_slots[0]];
+  uint64_t amount = words[s.operand_slots[1]];
+  // The result width of a shift equals the width of its first operand.
+  uint64_t width = static_cast<uint64_t>(s.result_width);
+  uint64_t result;
+  if constexpr (kOp == Op::kShra) {
+    int64_t signed_input = ToSigned(input, s.result_width);
+    if (amount >= width) {
+      result = signed_input < 0 ? Mask(s.result_width) : 0;
+    } else {
+      result = static_cast<uint64_t>(signed_input >> amount) &
+               Mask(s.result_width);
+    }
+  } else if constexpr (kOp == Op::kShll) {
+    result = amount >= width ? 0 : (input << amount) & Mask(s.result_width);
+  } else {  // Op::kShrl
+    result = amount >= width ? 0 : input >> amount;
+  }
+  words[s.result_slot] = result;
+}
+
+void BitSliceKernel(const KernelStep& s, uint64_t* words) {
+  words[s.result_slot] =
+      (words[s.operand_slots[0]] >> s.immediate) & Mask(s.result_width);
+}
+
+void ConcatKernel(const KernelStep& s, uint64_t* words) {
+  // Operands are ordered most-significant first. A 64-bit operand can only be
+  // the sole operand (the result fits in 64 bits), so the shift below is
+  // always by less than 64.
+  uint64_t accum = 0;
+  for (int64_t i = 0; i < s.operand_count; ++i) {
+    int64_t width = s.operand_widths[i];
+    uint64_t word = words[s.operand_slots[i]];
+    accum = width == 64 ? word : (accum << width) | word;
+  }
+  words[s.result_slot] = accum;
+}
+
+void AndReduceKernel(const KernelStep& s, uint64_t* words) {
+  words[s.result_slot] =
+      words[s.operand_slots[0]] == Mask(s.operand_widths[0]) ? 1 : 0;
+}
+
+void OrReduceKernel(const KernelStep& s, uint64_t* words) {
+  words[s.result_slot] = words[s.operand_slots[0]] != 0 ? 1 : 0;
+}
+
+void XorReduceKernel(const KernelStep& s, uint64_t* words) {
+  uint64_t x = words[s.operand_slots[0]];
+  x ^= x >> 32;
+  x ^= x >> 16;
+  x ^= x >> 8;
+  x ^= x >> 4;
+  x ^= x >> 2;
+  x ^= x >> 1;
+  words[s.result_slot] = x & 1;
+}
+
+// Returns the uint64 kernel for the given node's op, or nullptr if the op has
+// no specialized kernel.
+EvaluationPlan::KernelFn SelectKernel(Node* node) {
+  switch (node->op()) {
+    case Op::kLiteral:
+      return LiteralKernel;
+    case Op::kIdentity:
+      return IdentityKernel;
+    // Values are stored zero-extended in the word array, so zero_ext is a
+    // copy.
+    case Op::kZeroExt:
+      return IdentityKernel;
+    case Op::kSignExt:
+      return SignExtendKernel;
+    case Op::kNot:
+      return NotKernel;
+    case Op::kNeg:
+      return NegKernel;
+    case Op::kAnd:
+      return NaryBitwiseKernel<Op::kAnd>;
+    case Op::kOr:
+      return NaryBitwiseKernel<Op::kOr>;
+    case Op::kXor:
+      return NaryBitwiseKernel<Op::kXor>;
+    case Op::kNand:
+      return NaryBitwiseKernel<Op::kNand>;
+    case Op::kNor:
+      return NaryBitwiseKernel<Op::kNor>;
+    case Op::kAdd:
+      return ArithKernel<Op::kAdd>;
+    case Op::kSub:
+      return ArithKernel<Op::kSub>;
+    case Op::kUMul:
+      return ArithKernel<Op::kUMul>;
+    case Op::kSMul:
+      return ArithKernel<Op::kSMul>;
+    case Op::kEq:
+      return CompareKernel<Op::kEq>;
+    case Op::kNe:
+      return CompareKernel<Op::kNe>;
+    case Op::kULt:
+      return CompareKernel<Op::kULt>;
+    case Op::kULe:
+      return CompareKernel<Op::kULe>;
+    case Op::kUGt:
+      return CompareKernel<Op::kUGt>;
+    case Op::kUGe:
+      return CompareKernel<Op::kUGe>;
+    case Op::kSLt:
+      return CompareKernel<Op::kSLt>;
+    case Op::kSLe:
+      return CompareKernel<Op::kSLe>;
+    case Op::kSGt:
+      return CompareKernel<Op::kSGt>;
+    case Op::kSGe:
+      return CompareKernel<Op::kSGe>;
+    case Op::kShll:
+      return ShiftKernel<Op::kShll>;
+    case Op::kShrl:
+      return ShiftKernel<Op::kShrl>;
+    case Op::kShra:
+      return ShiftKernel<Op::kShra>;
+    case Op::kBitSlice:
+      return BitSliceKernel;
+    case Op::kConcat:
+      return ConcatKernel;
+    case Op::kAndReduce:
+      return AndReduceKernel;
+    case Op::kOrReduce:
+      return OrReduceKernel;
+    case Op::kXorReduce:
+      return XorReduceKernel;
+    default:
+      return nullptr;
+  }
+}
+
+// Returns whether the node's result and operand types permit uint64 kernel
+// evaluation, filling in the slots, widths and immediate of 'step' if so.
+bool FillKernelStep(Node* node, absl::Span<const int64_t> slot_of_node_id,
+                    KernelStep* step) {
+  if (!node->GetType()->IsBits() || node->BitCountOrDie() < 1 ||
+      node->BitCountOrDie() > 64 ||
+      node->operand_count() > KernelStep::kMaxOperands) {
+    return false;
+  }
+  for (int64_t i = 0; i < node->operand_count(); ++i) {
+    Node* operand = node->operand(i);
+    if (!operand->GetType()->IsBits() || operand->BitCountOrDie() < 1 ||
+        operand->BitCountOrDie() > 64) {
+      return false;
+    }
+    step->operand_slots[i] = slot_of_node_id[operand->id()];
+    step->operand_widths[i] = operand->BitCountOrDie();
+  }
+  step->operand_count = node->operand_count();
+  step->result_slot = slot_of_node_id[node->id()];
+  step->result_width = node->BitCountOrDie();
+  if (node->Is<Literal>()) {
+    step->immediate = node->As<Literal>()->value().bits().ToUint64().value();
+  } else if (node->Is<BitSlice>()) {
+    step->immediate = node->As<BitSlice>()->start();
+  }
+  return true;
+}
+
+}  // namespace
+
+absl::Status DenseStorageInterpreter::SetValueResult(Node* node, Value result) {
+  if (!ValueConformsToType(result, node->GetType())) {
+    return absl::InternalError(absl::StrFormat(
+        "Expected value %s to match type %s of node %s", result.ToString(),
+        node->GetType()->ToString(), node->GetName()));
+  }
+  int64_t slot = slot_of_node_id_[node->id()];
+  XLS_RET_CHECK_NE(slot_epochs_[slot], epoch_)
+      << "Node evaluated twice in one run: " << node->GetName();
+  slots_[slot] = std::move(result);
+  slot_epochs_[slot] = epoch_;
+  return absl::OkStatus();
+}
+
+/* static */ absl::StatusOr<std::unique_ptr<EvaluationPlan>>
+EvaluationPlan::Create(Function* function) {
+  auto plan = absl::WrapUnique(new EvaluationPlan(function));
+
+  int64_t max_id = 0;
+  for (Node* node : function->nodes()) {
+    max_id = std::max(max_id, node->id());
+  }
+  plan->slot_of_node_id_.resize(max_id + 1, -1);
+
+  int64_t slot = 0;
+  for (Node* node : TopoSort(function)) {
+    Step step;
+    step.node = node;
+    plan->steps_.push_back(step);
+    plan->slot_of_node_id_[node->id()] = slot++;
+  }
+  plan->slots_.resize(slot);
+  plan->slot_epochs_.resize(slot, 0);
+  plan->word_slots_.resize(slot, 0);
+
+  // Choose kernels once all slots are assigned so that operand slots can be
+  // recorded in the kernel steps. Params are never evaluated by the step loop
+  // (Run() binds them directly), so they get no kernel.
+  for (Step& step : plan->steps_) {
+    if (step.node->Is<Param>()) {
+      continue;
+    }
+    KernelFn kernel = SelectKernel(step.node);
+    if (kernel != nullptr &&
+        FillKernelStep(step.node, plan->slot_of_node_id_, &step.kernel_step)) {
+      step.kernel = kernel;
+    }
+  }
+
+  // Mark the boundaries between the two evaluation domains: a kernel result
+  // consumed outside the kernel domain must be materialized as a Value, and a
+  // narrow generic result consumed by a kernel must be copied into the word
+  // array. A node's step index equals its slot.
+  auto has_kernel = [&](Node* node) {
+    return plan->steps_[plan->slot_of_node_id_[node->id()]].kernel != nullptr;
+  };
+  for (Step& step : plan->steps_) {
+    Node* node = step.node;
+    if (step.kernel != nullptr) {
+      step.materialize_value = node == function->return_value();
+      for (Node* user : node->users()) {
+        if (!has_kernel(user)) {
+          step.materialize_value = true;
+          break;
+        }
+      }
+    } else if (node->GetType()->IsBits() && node->BitCountOrDie() <= 64) {
+      for (Node* user : node->users()) {
+        if (has_kernel(user)) {
+          step.extract_word = true;
+          break;
+        }
+      }
+    }
+  }
+
+  // Evaluate literals once here rather than on every run. The slot references
+  // the Literal node's immutable Value storage (Value aggregates are shared,
+  // not deep-copied), and the constant epoch tag keeps the slot valid across
+  // runs, so a large lookup table is never copied per evaluation.
+  for (Step& step : plan->steps_) {
+    Node* node = step.node;
+    if (!node->Is<Literal>()) {
+      continue;
+    }
+    int64_t node_slot = plan->slot_of_node_id_[node->id()];
+    if (step.kernel != nullptr) {
+      step.kernel(step.kernel_step, plan->word_slots_.data());
+      if (step.materialize_value) {
+        plan->slots_[node_slot] = Value(
+            UBits(plan->word_slots_[node_slot], step.kernel_step.result_width));
+        plan->slot_epochs_[node_slot] = DenseStorageInterpreter::kConstantEpoch;
+      }
+    } else {
+      plan->slots_[node_slot] = node->As<Literal>()->value();
+      plan->slot_epochs_[node_slot] = DenseStorageInterpreter::kConstantEpoch;
+      if (step.extract_word) {
+        plan->word_slots_[node_slot] =
+            plan->slots_[node_slot].bits().ToUint64().value();
+      }
+    }
+  }
+  plan->steps_.erase(
+      std::remove_if(plan->steps_.begin(), plan->steps_.end(),
+                     [](const Step& step) { return step.node->Is<Literal>(); }),
+      plan->steps_.end());
+  return plan;
+}
+
+absl::StatusOr<InterpreterResult<Value>> EvaluationPlan::Run(
+    absl::Span<const Value> args) {
+  if (args.size() != function_->params().size()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Function %s wants %d arguments, got %d.", function_->name(),
+        function_->params().size(), args.size()));
+  }
+  for (int64_t argno = 0; argno < args.size(); ++argno) {
+    Param* param = function_->param(argno);
+    if (!ValueConformsToType(args[argno], param->GetType())) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Got argument %s for parameter %d which is not of type %s",
+          args[argno].ToString(), argno, param->GetType()->ToString()));
+    }
+  }
+
+  ++current_epoch_;
+  DenseStorageInterpreter visitor(slot_of_node_id_, absl::MakeSpan(slots_),
+                                  absl::MakeSpan(slot_epochs_),
+                                  current_epoch_);
+  for (int64_t argno = 0; argno < args.size(); ++argno) {
+    Param* param = function_->param(argno);
+    XLS_RETURN_IF_ERROR(visitor.SetValueResult(param, args[argno]));
+    if (param->GetType()->IsBits() && param->BitCountOrDie() <= 64) {
+      word_slots_[slot_of_node_id_[param->id()]] =
+          args[argno].bits().ToUint64().value();
+    }
+  }
+
+  for (const Step& step : steps_) {
+    Node* node = step.node;
+    if (node->Is<Param>()) {
+      continue;
+    }
+    if (step.kernel != nullptr) {
+      step.kernel(step.kernel_step, word_slots_.data());
+      if (step.materialize_value) {
+        int64_t slot = step.kernel_step.result_slot;
+        slots_[slot] =
+            Value(UBits(word_slots_[slot], step.kernel_step.result_width));
+        slot_epochs_[slot] = current_epoch_;
+      }
+      continue;
+    }
+    XLS_RETURN_IF_ERROR(node->VisitSingleNode(&visitor));
+    if (step.extract_word) {
+      int64_t slot = slot_of_node_id_[node->id()];
+      word_slots_[slot] = slots_[slot].bits().ToUint64().value();
+    }
+  }
+
+  Value result = visitor.ResolveAsValue(function_->return_value());
+  InterpreterEvents events = visitor.GetInterpreterEvents();
+  return InterpreterResult<Value>{std::move(result), std::move(events)};
+}
+
+}  // namespace xls
@@ -0,0 +1,169 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_INTERPRETER_EVALUATION_PLAN_H_
+#define XLS_INTERPRETER_EVALUATION_PLAN_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/interpreter/ir_interpreter.h"
+#include "xls/ir/events.h"
+#include "xls/ir/function.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+
+// An IrInterpreter whose value storage is a dense slot array rather than a
+// node-keyed hash map. Operand resolution and result storage are plain array
+// indexing; the epoch tags track which slots belong to the current run so the
+// storage can be reused across runs without clearing. Used by EvaluationPlan
+// and BlockContinuation, which own the storage and assign the slots.
+class DenseStorageInterpreter : public IrInterpreter {
+ public:
+  // Epoch tag of a slot whose value is valid in every run. Used for slots the
+  // storage owner fills once at build time (e.g. literals); run epochs count
+  // up from zero so this value is never produced by an actual run.
+  static constexpr int64_t kConstantEpoch = -1;
+
+  DenseStorageInterpreter(absl::Span<const int64_t> slot_of_node_id,
+                          absl::Span<Value> slots,
+                          absl::Span<int64_t> slot_epochs, int64_t epoch)
+      : slot_of_node_id_(slot_of_node_id),
+        slots_(slots),
+        slot_epochs_(slot_epochs),
+        epoch_(epoch) {}
+
+  const Value& ResolveAsValue(Node* node) const override {
+    return slots_[slot_of_node_id_[node->id()]];
+  }
+
+  bool HasResult(Node* node) const override {
+    int64_t tag = slot_epochs_[slot_of_node_id_[node->id()]];
+    return tag == epoch_ || tag == kConstantEpoch;
+  }
+
+  absl::Status SetValueResult(Node* node, Value result) override;
+
+ private:
+  absl::Span<const int64_t> slot_of_node_id_;
+  absl::Span<Value> slots_;
+  absl::Span<int64_t> slot_epochs_;
+  int64_t epoch_;
+};
+
+// A compiled-once evaluation plan for a Function. Creating the plan pays the
+// per-run pre-pass costs of interpretation a single time: the nodes are
+// topologically ordered into a flat array and each node is assigned a dense
+// slot in preallocated value storage. Repeated invocations then execute as a
+// tight loop over the node array, resolving operands and storing results by
+// array index instead of hashing node pointers in a flat_hash_map and
+// re-walking the graph. This pays off in workloads which evaluate the same
+// function many times, such as fuzzing and eval_ir_main input batches.
+//
+// The op semantics are those of IrInterpreter; only the traversal and value
+// storage differ. A plan owns reusable value storage, so Run() is not
+// thread-safe; use one plan per thread.
+//
+// Literals are evaluated once at plan build time into permanently valid
+// slots and dropped from the evaluation loop. A slot holding an aggregate
+// literal shares the storage of the Literal node's own Value, so a large
+// constant array (e.g. a lookup table produced by TableSwitchPass) is stored
+// once in the package and never copied per run.
+//
+// As a further specialization, nodes whose result and operands are all
+// bits-typed and at most 64 bits wide -- the overwhelming majority of nodes in
+// real designs -- are evaluated by op-specialized kernels which operate
+// directly on uint64_t words, bypassing Bits/Value construction entirely. The
+// kernel for each node is chosen once at plan build time and recorded as a
+// function pointer in the node's step; nodes with wide or compound types (or
+// ops without a kernel) fall back to the generic Bits-based interpreter.
+class EvaluationPlan {
+ public:
+  // Precomputed inputs of a uint64 kernel: the word slots and bit widths of
+  // the node's operands and result. Public only so that the file-local kernel
+  // functions in evaluation_plan.cc can operate on it.
+  struct KernelStep {
+    // Nodes with more than this many operands fall back to generic
+    // evaluation; covers all but degenerate nary ops and concats.
+    static constexpr int64_t kMaxOperands = 4;
+
+    int64_t operand_slots[kMaxOperands];
+    int64_t operand_widths[kMaxOperands];
+    int64_t operand_count = 0;
+    int64_t result_slot;
+    int64_t result_width;
+    // Op-specific constant folded in at build time: the value of a literal,
+    // or the start of a bit_slice.
+    uint64_t immediate = 0;
+  };
+  using KernelFn = void (*)(const KernelStep&, uint64_t* words);
+
+  // Compiles a plan for the given function.
+  static absl::StatusOr<std::unique_ptr<EvaluationPlan>> Create(
+      Function* function);
+
+  // Evaluates the function with the given arguments.
+  absl::StatusOr<InterpreterResult<Value>> Run(absl::Span<const Value> args);
+
+  Function* function() const { return function_; }
+
+ private:
+  // One entry of the evaluation loop: a node plus the kernel chosen for it at
+  // build time (nullptr to use the generic interpreter). The boundary flags
+  // keep the uint64 word array and the Value slots coherent where the two
+  // evaluation domains meet.
+  struct Step {
+    Node* node;
+    KernelFn kernel = nullptr;
+    KernelStep kernel_step;
+    // For kernel steps: the node's result is also needed as a Value (it is
+    // the return value or feeds a generic step), so store it in slots_.
+    bool materialize_value = false;
+    // For generic steps with a narrow bits result which feeds a kernel step:
+    // copy the result into the word array.
+    bool extract_word = false;
+  };
+
+  explicit EvaluationPlan(Function* function) : function_(function) {}
+
+  Function* function_;
+
+  // The function's nodes in topological order.
+  std::vector<Step> steps_;
+
+  // Maps a node id to the node's dense slot index in slots_. Indexed by
+  // Node::id(); ids not belonging to the function hold -1.
+  std::vector<int64_t> slot_of_node_id_;
+
+  // Preallocated result storage, one slot per node, reused across runs.
+  std::vector<Value> slots_;
+
+  // Preallocated uint64 result storage for kernel steps, indexed by the same
+  // slot numbers as slots_. Narrow values are stored zero-extended to 64 bits.
+  std::vector<uint64_t> word_slots_;
+
+  // Epoch tag per slot. A slot holds a value for the current run iff its tag
+  // equals current_epoch_; bumping the epoch invalidates all slots without
+  // touching them.
+  std::vector<int64_t> slot_epochs_;
+  int64_t current_epoch_ = 0;
+};
+
+}  // namespace xls
+
+#endif  // XLS_INTERPRETER_EVALUATION_PLAN_H_
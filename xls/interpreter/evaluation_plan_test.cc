@@ -0,0 +1,300 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/interpreter/evaluation_plan.h"
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/interpreter/function_interpreter.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+namespace {
+
+using status_testing::StatusIs;
+using ::testing::HasSubstr;
+
+class EvaluationPlanTest : public IrTestBase {};
+
+TEST_F(EvaluationPlanTest, RepeatedRuns) {
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           ParseFunction(R"(
+  fn muladd(a: bits[32], b: bits[32], c: bits[32]) -> bits[32] {
+    umul.4: bits[32] = umul(a, b)
+    ret add.5: bits[32] = add(umul.4, c)
+  }
+  )",
+                                         package.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluationPlan> plan,
+                           EvaluationPlan::Create(function));
+
+  // The preallocated storage is reused across runs; each run must see only
+  // its own values.
+  for (int64_t i = 0; i < 10; ++i) {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        InterpreterResult<Value> result,
+        plan->Run({Value(UBits(i, 32)), Value(UBits(3, 32)),
+                   Value(UBits(7, 32))}));
+    EXPECT_EQ(result.value, Value(UBits(3 * i + 7, 32)));
+    EXPECT_TRUE(result.events.trace_msgs.empty());
+  }
+}
+
+TEST_F(EvaluationPlanTest, CompoundTypes) {
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           ParseFunction(R"(
+  fn f(t: (bits[8], bits[8]), a: bits[8][2]) -> (bits[8], bits[8]) {
+    tuple_index.3: bits[8] = tuple_index(t, index=0)
+    literal.4: bits[1] = literal(value=1)
+    array_index.5: bits[8] = array_index(a, indices=[literal.4])
+    add.6: bits[8] = add(tuple_index.3, array_index.5)
+    ret tuple.7: (bits[8], bits[8]) = tuple(add.6, tuple_index.3)
+  }
+  )",
+                                         package.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluationPlan> plan,
+                           EvaluationPlan::Create(function));
+
+  Value t = Value::Tuple({Value(UBits(10, 8)), Value(UBits(20, 8))});
+  XLS_ASSERT_OK_AND_ASSIGN(Value a, Value::UBitsArray({1, 2}, 8));
+  XLS_ASSERT_OK_AND_ASSIGN(InterpreterResult<Value> result,
+                           plan->Run({t, a}));
+  EXPECT_EQ(result.value,
+            Value::Tuple({Value(UBits(12, 8)), Value(UBits(10, 8))}));
+}
+
+TEST_F(EvaluationPlanTest, ConstantTableLookup) {
+  // The literal table is evaluated once at plan build time into a permanently
+  // valid slot; repeated runs index the pooled value without re-evaluating
+  // (or copying) the literal.
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           ParseFunction(R"(
+  fn lut(i: bits[2]) -> bits[8] {
+    literal.2: bits[8][4] = literal(value=[11, 22, 33, 44])
+    ret array_index.3: bits[8] = array_index(literal.2, indices=[i])
+  }
+  )",
+                                         package.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluationPlan> plan,
+                           EvaluationPlan::Create(function));
+
+  const uint64_t kTable[] = {11, 22, 33, 44};
+  for (int64_t run = 0; run < 3; ++run) {
+    for (uint64_t i = 0; i < 4; ++i) {
+      XLS_ASSERT_OK_AND_ASSIGN(InterpreterResult<Value> result,
+                               plan->Run({Value(UBits(i, 2))}));
+      EXPECT_EQ(result.value, Value(UBits(kTable[i], 8)));
+    }
+  }
+}
+
+TEST_F(EvaluationPlanTest, LiteralReturnValue) {
+  // A literal return value leaves no evaluation steps besides the unused
+  // parameter; the pre-evaluated slot must survive across runs.
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           ParseFunction(R"(
+  fn f(x: bits[8]) -> bits[8] {
+    ret literal.2: bits[8] = literal(value=77)
+  }
+  )",
+                                         package.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluationPlan> plan,
+                           EvaluationPlan::Create(function));
+  for (int64_t run = 0; run < 2; ++run) {
+    XLS_ASSERT_OK_AND_ASSIGN(InterpreterResult<Value> result,
+                             plan->Run({Value(UBits(run, 8))}));
+    EXPECT_EQ(result.value, Value(UBits(77, 8)));
+  }
+}
+
+TEST_F(EvaluationPlanTest, MatchesInterpretFunction) {
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           ParseFunction(R"(
+  fn f(x: bits[16]) -> bits[16] {
+    literal.2: bits[16] = literal(value=21845)
+    xor.3: bits[16] = xor(x, literal.2)
+    reverse.4: bits[16] = reverse(xor.3)
+    ret sub.5: bits[16] = sub(reverse.4, x)
+  }
+  )",
+                                         package.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluationPlan> plan,
+                           EvaluationPlan::Create(function));
+
+  for (uint64_t x : {uint64_t{0}, uint64_t{1}, uint64_t{0xffff},
+                     uint64_t{0x1234}}) {
+    std::vector<Value> args = {Value(UBits(x, 16))};
+    XLS_ASSERT_OK_AND_ASSIGN(InterpreterResult<Value> plan_result,
+                             plan->Run(args));
+    XLS_ASSERT_OK_AND_ASSIGN(InterpreterResult<Value> interpreter_result,
+                             InterpretFunction(function, args));
+    EXPECT_EQ(plan_result.value, interpreter_result.value);
+  }
+}
+
+TEST_F(EvaluationPlanTest, KernelOpsMatchInterpreter) {
+  // Exercises the uint64 kernels across the supported op set at mixed widths,
+  // with the generic tuple return materializing every kernel result.
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           ParseFunction(R"(
+  fn f(a: bits[17], b: bits[17], s: bits[8]) -> (bits[17], bits[1], bits[17], bits[34], bits[3]) {
+    add.4: bits[17] = add(a, b)
+    sub.5: bits[17] = sub(a, b)
+    umul.6: bits[17] = umul(a, b)
+    smul.7: bits[34] = smul(a, b)
+    and.8: bits[17] = and(a, b, add.4)
+    nor.9: bits[17] = nor(a, sub.5)
+    not.10: bits[17] = not(and.8)
+    neg.11: bits[17] = neg(b)
+    slt.12: bits[1] = slt(a, b)
+    uge.13: bits[1] = uge(a, b)
+    eq.14: bits[1] = eq(not.10, neg.11)
+    shll.15: bits[17] = shll(a, s)
+    shra.16: bits[17] = shra(b, s)
+    bit_slice.17: bits[3] = bit_slice(a, start=5, width=3)
+    concat.18: bits[34] = concat(add.4, sub.5)
+    sign_ext.19: bits[34] = sign_ext(sub.5, new_bit_count=34)
+    zero_ext.20: bits[34] = zero_ext(neg.11, new_bit_count=34)
+    xor.21: bits[34] = xor(concat.18, sign_ext.19, zero_ext.20, smul.7)
+    and_reduce.22: bits[1] = and_reduce(nor.9)
+    xor_reduce.23: bits[1] = xor_reduce(umul.6)
+    or.24: bits[1] = or(slt.12, uge.13, eq.14, and_reduce.22)
+    xor.25: bits[1] = xor(or.24, xor_reduce.23)
+    ret tuple.26: (bits[17], bits[1], bits[17], bits[34], bits[3]) = tuple(shll.15, xor.25, shra.16, xor.21, bit_slice.17)
+  }
+  )",
+                                         package.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluationPlan> plan,
+                           EvaluationPlan::Create(function));
+
+  struct TestCase {
+    uint64_t a;
+    uint64_t b;
+    uint64_t s;
+  };
+  // Includes all-zeros, all-ones, sign bits set, and shift amounts both
+  // within and beyond the shifted width.
+  for (const TestCase& tc :
+       {TestCase{0, 0, 0}, TestCase{0x1ffff, 0x1ffff, 16},
+        TestCase{0x10000, 0x0ffff, 17}, TestCase{0x12345, 0x1cdef, 200},
+        TestCase{1, 0x1fffe, 3}}) {
+    std::vector<Value> args = {Value(UBits(tc.a, 17)), Value(UBits(tc.b, 17)),
+                               Value(UBits(tc.s, 8))};
+    XLS_ASSERT_OK_AND_ASSIGN(InterpreterResult<Value> plan_result,
+                             plan->Run(args));
+    XLS_ASSERT_OK_AND_ASSIGN(InterpreterResult<Value> interpreter_result,
+                             InterpretFunction(function, args));
+    EXPECT_EQ(plan_result.value, interpreter_result.value)
+        << "a=" << tc.a << " b=" << tc.b << " s=" << tc.s;
+  }
+}
+
+TEST_F(EvaluationPlanTest, KernelsAtWidth64) {
+  // Width 64 exercises the masking edge cases of the kernels.
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           ParseFunction(R"(
+  fn f(x: bits[64], y: bits[64]) -> bits[64] {
+    add.3: bits[64] = add(x, y)
+    smul.4: bits[64] = smul(x, y)
+    not.5: bits[64] = not(add.3)
+    literal.6: bits[64] = literal(value=0xdeadbeefcafef00d)
+    shra.7: bits[64] = shra(smul.4, y)
+    xor.8: bits[64] = xor(not.5, literal.6, shra.7)
+    ret neg.9: bits[64] = neg(xor.8)
+  }
+  )",
+                                         package.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluationPlan> plan,
+                           EvaluationPlan::Create(function));
+
+  constexpr uint64_t kMax = std::numeric_limits<uint64_t>::max();
+  for (const auto& [x, y] :
+       std::vector<std::pair<uint64_t, uint64_t>>{
+           {0, 0}, {kMax, kMax}, {kMax, 1}, {uint64_t{1} << 63, 63},
+           {0x123456789abcdef0, 64}}) {
+    std::vector<Value> args = {Value(UBits(x, 64)), Value(UBits(y, 64))};
+    XLS_ASSERT_OK_AND_ASSIGN(InterpreterResult<Value> plan_result,
+                             plan->Run(args));
+    XLS_ASSERT_OK_AND_ASSIGN(InterpreterResult<Value> interpreter_result,
+                             InterpretFunction(function, args));
+    EXPECT_EQ(plan_result.value, interpreter_result.value)
+        << "x=" << x << " y=" << y;
+  }
+}
+
+TEST_F(EvaluationPlanTest, WideAndNarrowBoundary) {
+  // Wide (generic) and narrow (kernel) nodes feed each other: the bit_slice
+  // of the wide input must be copied into the word array, and the kernel add
+  // result must be materialized as a Value for the wide zero_ext.
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           ParseFunction(R"(
+  fn f(x: bits[100], y: bits[32]) -> bits[100] {
+    bit_slice.3: bits[32] = bit_slice(x, start=10, width=32)
+    add.4: bits[32] = add(bit_slice.3, y)
+    zero_ext.5: bits[100] = zero_ext(add.4, new_bit_count=100)
+    ret add.6: bits[100] = add(zero_ext.5, x)
+  }
+  )",
+                                         package.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluationPlan> plan,
+                           EvaluationPlan::Create(function));
+
+  for (const Bits& x : {Bits(100), Bits::AllOnes(100)}) {
+    std::vector<Value> args = {Value(x), Value(UBits(0x12345678, 32))};
+    XLS_ASSERT_OK_AND_ASSIGN(InterpreterResult<Value> plan_result,
+                             plan->Run(args));
+    XLS_ASSERT_OK_AND_ASSIGN(InterpreterResult<Value> interpreter_result,
+                             InterpretFunction(function, args));
+    EXPECT_EQ(plan_result.value, interpreter_result.value);
+  }
+}
+
+TEST_F(EvaluationPlanTest, ArgumentErrors) {
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           ParseFunction(R"(
+  fn f(x: bits[8]) -> bits[8] {
+    ret neg.2: bits[8] = neg(x)
+  }
+  )",
+                                         package.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluationPlan> plan,
+                           EvaluationPlan::Create(function));
+
+  EXPECT_THAT(plan->Run({}).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("wants 1 arguments, got 0")));
+  EXPECT_THAT(plan->Run({Value(UBits(0, 32))}).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("which is not of type bits[8]")));
+}
+
+}  // namespace
+}  // namespace xls
@@ -807,11 +807,11 @@ absl::Status IrInterpreter::VerifyAllBitsTypes(Node* node) {
 }
 
 const Bits& IrInterpreter::ResolveAsBits(Node* node) {
-  return node_values_.at(node).bits();
+  return ResolveAsValue(node).bits();
 }
 
 bool IrInterpreter::ResolveAsBool(Node* node) {
-  const Bits& bits = node_values_.at(node).bits();
+  const Bits& bits = ResolveAsValue(node).bits();
   XLS_CHECK_EQ(bits.bit_count(), 1);
   return bits.IsAllOnes();
 }
@@ -845,7 +845,7 @@ absl::Status IrInterpreter::SetBitsResult(Node* node, const Bits& result) {
 absl::Status IrInterpreter::SetValueResult(Node* node, Value result) {
   if (XLS_VLOG_IS_ON(4) &&
       std::all_of(node->operands().begin(), node->operands().end(),
-                  [this](Node* o) { return node_values_.contains(o); })) {
+                  [this](Node* o) { return HasResult(o); })) {
     XLS_VLOG(4) << absl::StreamFormat("%s operands:", node->GetName());
     for (int64_t i = 0; i < node->operand_count(); ++i) {
       XLS_VLOG(4) << absl::StreamFormat(
@@ -37,11 +37,12 @@ class IrInterpreter : public DfsVisitor {
   // Sets the evaluated value for 'node' to the given Value. 'value' must be
   // passed in by value (ha!) because a use case is passing in a previously
   // evaluated value and inserting a into flat_hash_map (done below) invalidates
-  // all references to Values in the map.
-  absl::Status SetValueResult(Node* node, Value result);
+  // all references to Values in the map. Virtual so subclasses can substitute
+  // denser storage than the node-keyed hash map (see EvaluationPlan).
+  virtual absl::Status SetValueResult(Node* node, Value result);
 
   // Returns the previously evaluated value of 'node' as a Value.
-  const Value& ResolveAsValue(Node* node) const {
+  virtual const Value& ResolveAsValue(Node* node) const {
     return node_values_.at(node);
   }
 
@@ -50,7 +51,9 @@ class IrInterpreter : public DfsVisitor {
   absl::Status AddInterpreterEvents(const InterpreterEvents& events);
 
   // Returns true if a value has been set for the result of the given node.
-  bool HasResult(Node* node) const { return node_values_.contains(node); }
+  virtual bool HasResult(Node* node) const {
+    return node_values_.contains(node);
+  }
 
   absl::Status HandleAdd(BinOp* add) override;
   absl::Status HandleAfterAll(AfterAll* after_all) override;
@@ -0,0 +1,157 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/interpreter/jit_cross_checker.h"
+
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "xls/common/math_util.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
+#include "xls/interpreter/function_interpreter.h"
+#include "xls/interpreter/random_value.h"
+#include "xls/ir/events.h"
+#include "xls/ir/packed_value.h"
+#include "xls/ir/type.h"
+
+namespace xls {
+
+JitCrossChecker::JitCrossChecker(Function* function,
+                                 std::unique_ptr<FunctionJit> jit)
+    : function_(function), jit_(std::move(jit)) {}
+
+absl::StatusOr<std::unique_ptr<JitCrossChecker>> JitCrossChecker::Create(
+    Function* f) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<FunctionJit> jit,
+                       FunctionJit::Create(f));
+  return absl::WrapUnique(new JitCrossChecker(f, std::move(jit)));
+}
+
+absl::StatusOr<CrossCheckResult> JitCrossChecker::Run(
+    absl::Span<const uint8_t> packed_inputs, int64_t count) {
+  const int64_t input_record_size = jit_->GetPackedArgumentRecordSize();
+  const int64_t output_record_size = jit_->GetPackedResultRecordSize();
+  XLS_RET_CHECK_EQ(static_cast<int64_t>(packed_inputs.size()),
+                   count * input_record_size)
+      << "packed input buffer must hold exactly `count` argument records";
+
+  // Kick off the JIT batch on a worker thread; the oracle walks the same
+  // input buffer concurrently below.
+  std::vector<uint8_t> jit_outputs(count * output_record_size);
+  absl::Status jit_status;
+  Thread jit_thread([&] {
+    jit_status =
+        jit_->RunBatched(packed_inputs, absl::MakeSpan(jit_outputs), count);
+  });
+
+  // Oracle: unpack each record's arguments, interpret, and re-pack the result
+  // so the comparison below is bytewise. Like RunBatched, an assertion
+  // failure in any sample turns into an error for the whole batch.
+  Type* return_type = function_->return_value()->GetType();
+  std::vector<uint8_t> oracle_outputs(count * output_record_size);
+  absl::Status oracle_status = absl::OkStatus();
+  for (int64_t i = 0; i < count && oracle_status.ok(); ++i) {
+    absl::Span<const uint8_t> record =
+        packed_inputs.subspan(i * input_record_size, input_record_size);
+    std::vector<Value> args;
+    args.reserve(function_->params().size());
+    int64_t offset = 0;
+    for (Param* param : function_->params()) {
+      Type* type = param->GetType();
+      int64_t arg_size = CeilOfRatio(type->GetFlatBitCount(), int64_t{8});
+      absl::StatusOr<PackedValue> arg =
+          PackedValue::FromBuffer(record.subspan(offset, arg_size), type);
+      if (!arg.ok()) {
+        oracle_status = arg.status();
+        break;
+      }
+      args.push_back(arg->ToValue());
+      offset += arg_size;
+    }
+    if (!oracle_status.ok()) {
+      break;
+    }
+    absl::StatusOr<Value> result =
+        InterpreterResultToStatusOrValue(InterpretFunction(function_, args));
+    if (!result.ok()) {
+      oracle_status = result.status();
+      break;
+    }
+    absl::StatusOr<PackedValue> packed =
+        PackedValue::FromValue(result.value(), return_type);
+    if (!packed.ok()) {
+      oracle_status = packed.status();
+      break;
+    }
+    std::memcpy(oracle_outputs.data() + i * output_record_size,
+                packed->buffer(), output_record_size);
+  }
+
+  jit_thread.Join();
+  XLS_RETURN_IF_ERROR(jit_status);
+  XLS_RETURN_IF_ERROR(oracle_status);
+
+  CrossCheckResult result;
+  result.samples_compared = count;
+  for (int64_t i = 0; i < count; ++i) {
+    if (std::memcmp(oracle_outputs.data() + i * output_record_size,
+                    jit_outputs.data() + i * output_record_size,
+                    output_record_size) == 0) {
+      continue;
+    }
+    // Decode the differing records for the report; this only happens for
+    // failing samples.
+    XLS_ASSIGN_OR_RETURN(
+        PackedValue oracle_value,
+        PackedValue::FromBuffer(
+            absl::MakeConstSpan(oracle_outputs)
+                .subspan(i * output_record_size, output_record_size),
+            return_type));
+    XLS_ASSIGN_OR_RETURN(
+        PackedValue jit_value,
+        PackedValue::FromBuffer(
+            absl::MakeConstSpan(jit_outputs)
+                .subspan(i * output_record_size, output_record_size),
+            return_type));
+    result.mismatches.push_back(
+        CrossCheckMismatch{i, oracle_value.ToValue(), jit_value.ToValue()});
+  }
+  return result;
+}
+
+absl::StatusOr<CrossCheckResult> JitCrossChecker::RunRandomSamples(
+    uint64_t seed, uint64_t first_sample, int64_t count) {
+  const int64_t input_record_size = jit_->GetPackedArgumentRecordSize();
+  XLS_ASSIGN_OR_RETURN(
+      std::vector<std::vector<PackedValue>> args,
+      RandomPackedFunctionArguments(function_, seed, first_sample, count));
+  std::vector<uint8_t> packed_inputs(count * input_record_size);
+  for (int64_t i = 0; i < count; ++i) {
+    int64_t offset = i * input_record_size;
+    for (const PackedValue& arg : args[i]) {
+      std::memcpy(packed_inputs.data() + offset, arg.buffer(),
+                  arg.size_in_bytes());
+      offset += arg.size_in_bytes();
+    }
+  }
+  return Run(packed_inputs, count);
+}
+
+}  // namespace xls
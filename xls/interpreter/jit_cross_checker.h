@@ -0,0 +1,83 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_INTERPRETER_JIT_CROSS_CHECKER_H_
+#define XLS_INTERPRETER_JIT_CROSS_CHECKER_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/ir/function.h"
+#include "xls/ir/value.h"
+#include "xls/jit/function_jit.h"
+
+namespace xls {
+
+// A sample whose packed outputs differed between the two engines, decoded
+// back to Values for reporting.
+struct CrossCheckMismatch {
+  // Index of the sample within the checked batch.
+  int64_t sample_index;
+  Value interpreter_value;
+  Value jit_value;
+};
+
+// Result of cross-checking one batch of samples.
+struct CrossCheckResult {
+  int64_t samples_compared = 0;
+  std::vector<CrossCheckMismatch> mismatches;
+
+  bool Passed() const { return mismatches.empty(); }
+};
+
+// Harness that runs FunctionJit and the IR interpreter (as the oracle) over
+// one shared buffer of packed argument records (the layout consumed by
+// FunctionJit::RunBatched) and compares the packed outputs bytewise. The
+// comparison path builds no per-sample Value trees: the oracle's results are
+// packed once and only the (rare) differing samples are decoded back to
+// Values. The JIT batch runs on a worker thread while the oracle walks the
+// same input buffer on the calling thread, so the two engines overlap on
+// different cores.
+class JitCrossChecker {
+ public:
+  static absl::StatusOr<std::unique_ptr<JitCrossChecker>> Create(Function* f);
+
+  // Cross-checks `count` packed argument records stored contiguously in
+  // `packed_inputs`, which must hold exactly `count` records of
+  // FunctionJit::GetPackedArgumentRecordSize() bytes each.
+  absl::StatusOr<CrossCheckResult> Run(absl::Span<const uint8_t> packed_inputs,
+                                       int64_t count);
+
+  // As Run, over `count` random samples for sample indices [first_sample,
+  // first_sample + count), drawn as by RandomPackedFunctionArguments so
+  // fuzzer shards can partition the sample space by index.
+  absl::StatusOr<CrossCheckResult> RunRandomSamples(uint64_t seed,
+                                                    uint64_t first_sample,
+                                                    int64_t count);
+
+  Function* function() const { return function_; }
+
+ private:
+  JitCrossChecker(Function* function, std::unique_ptr<FunctionJit> jit);
+
+  Function* function_;
+  std::unique_ptr<FunctionJit> jit_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_INTERPRETER_JIT_CROSS_CHECKER_H_
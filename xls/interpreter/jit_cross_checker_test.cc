@@ -0,0 +1,82 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/interpreter/jit_cross_checker.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/package.h"
+
+namespace xls {
+namespace {
+
+TEST(JitCrossCheckerTest, RandomSamplesAgreeOnBitsFunction) {
+  Package package("test_package");
+  FunctionBuilder fb("adder", &package);
+  BValue x = fb.Param("x", package.GetBitsType(37));
+  BValue y = fb.Param("y", package.GetBitsType(37));
+  fb.Add(x, y);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<JitCrossChecker> checker,
+                           JitCrossChecker::Create(f));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      CrossCheckResult result,
+      checker->RunRandomSamples(/*seed=*/42, /*first_sample=*/0,
+                                /*count=*/64));
+  EXPECT_TRUE(result.Passed());
+  EXPECT_EQ(result.samples_compared, 64);
+}
+
+TEST(JitCrossCheckerTest, RandomSamplesAgreeOnCompoundTypes) {
+  Package package("test_package");
+  FunctionBuilder fb("compound", &package);
+  Type* element_type = package.GetBitsType(13);
+  BValue a = fb.Param("a", package.GetArrayType(4, element_type));
+  BValue index = fb.Param("index", package.GetBitsType(2));
+  BValue element = fb.ArrayIndex(a, {index});
+  fb.Tuple({element, fb.Not(element)});
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<JitCrossChecker> checker,
+                           JitCrossChecker::Create(f));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      CrossCheckResult result,
+      checker->RunRandomSamples(/*seed=*/7, /*first_sample=*/100,
+                                /*count=*/32));
+  EXPECT_TRUE(result.Passed());
+  EXPECT_EQ(result.samples_compared, 32);
+}
+
+TEST(JitCrossCheckerTest, RejectsMisSizedInputBuffer) {
+  Package package("test_package");
+  FunctionBuilder fb("identity", &package);
+  fb.Param("x", package.GetBitsType(32));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<JitCrossChecker> checker,
+                           JitCrossChecker::Create(f));
+  // Two 32-bit samples need eight bytes, not seven.
+  std::vector<uint8_t> packed_inputs(7);
+  EXPECT_FALSE(checker->Run(packed_inputs, /*count=*/2).ok());
+}
+
+}  // namespace
+}  // namespace xls
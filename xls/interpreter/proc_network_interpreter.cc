@@ -14,10 +14,65 @@
 
 #include "xls/interpreter/proc_network_interpreter.h"
 
+#include <atomic>
+#include <thread>  // NOLINT(build/c++11)
+
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_join.h"
+#include "absl/types/span.h"
+#include "xls/common/thread.h"
+#include "xls/data_structures/union_find.h"
+#include "xls/ir/node_util.h"
 
 namespace xls {
+namespace {
+
+// Runs the procs of a single partition in a round-robin fashion until no
+// further progress can be made. Returns whether any progress was made. If no
+// progress was made then `blocked_channels` contains the channels on which
+// receives are blocked, sorted by channel id.
+absl::StatusOr<bool> TickPartition(
+    absl::Span<ProcInterpreter* const> interpreters,
+    std::vector<Channel*>* blocked_channels) {
+  absl::flat_hash_set<ProcInterpreter*> completed_procs;
+  absl::flat_hash_set<Channel*> blocked_channel_set;
+  bool global_progress_made = false;
+  bool progress_made_this_loop = true;
+  while (progress_made_this_loop) {
+    progress_made_this_loop = false;
+    blocked_channel_set.clear();
+    for (ProcInterpreter* interpreter : interpreters) {
+      if (completed_procs.contains(interpreter)) {
+        continue;
+      }
+      XLS_ASSIGN_OR_RETURN(ProcInterpreter::RunResult result,
+                           interpreter->RunIterationUntilCompleteOrBlocked());
+
+      progress_made_this_loop |= result.progress_made;
+      if (result.iteration_complete) {
+        completed_procs.insert(interpreter);
+      }
+      blocked_channel_set.insert(result.blocked_channels.begin(),
+                                 result.blocked_channels.end());
+    }
+    global_progress_made |= progress_made_this_loop;
+  }
+  if (!global_progress_made) {
+    // Sort blocked channels by channel id so the channels order is
+    // deterministic.
+    blocked_channels->clear();
+    blocked_channels->insert(blocked_channels->begin(),
+                             blocked_channel_set.begin(),
+                             blocked_channel_set.end());
+    std::sort(blocked_channels->begin(), blocked_channels->end(),
+              [](Channel* a, Channel* b) { return a->id() < b->id(); });
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
 
 /* static */
 absl::StatusOr<std::unique_ptr<ProcNetworkInterpreter>>
@@ -47,7 +102,40 @@ ProcNetworkInterpreter::Create(
     }
   }
 
-  // Create a ProcInterpreter for each Proc.
+  // Partition the procs by channel connectivity for ParallelTick. Two procs
+  // are in the same partition if they are transitively connected by channels;
+  // procs in different partitions share no channel queues.
+  UnionFind<Proc*> connectivity;
+  for (auto& proc : package->procs()) {
+    connectivity.Insert(proc.get());
+  }
+  absl::flat_hash_map<Channel*, Proc*> channel_user;
+  for (auto& proc : package->procs()) {
+    for (Node* node : proc->nodes()) {
+      if (!IsChannelNode(node)) {
+        continue;
+      }
+      XLS_ASSIGN_OR_RETURN(Channel * channel, GetChannelUsedByNode(node));
+      auto [it, inserted] = channel_user.insert({channel, proc.get()});
+      if (!inserted) {
+        connectivity.Union(it->second, proc.get());
+      }
+    }
+  }
+  // Emit the partitions ordered by the first appearance of one of their procs
+  // in the package so the partitioning is deterministic.
+  absl::flat_hash_map<Proc*, int64_t> partition_index;
+  for (int64_t i = 0; i < package->procs().size(); ++i) {
+    Proc* representative = connectivity.Find(package->procs()[i].get());
+    auto [it, inserted] =
+        partition_index.insert({representative, interpreter->partitions_.size()});
+    if (inserted) {
+      interpreter->partitions_.emplace_back();
+    }
+    interpreter->partitions_[it->second].push_back(
+        interpreter->proc_interpreters_[i].get());
+  }
+
   return std::move(interpreter);
 }
 
@@ -64,6 +152,83 @@ absl::Status ProcNetworkInterpreter::Tick() {
   return absl::OkStatus();
 }
 
+absl::Status ProcNetworkInterpreter::ParallelTick(bool deterministic_replay) {
+  XLS_VLOG(3) << absl::StreamFormat("ParallelTick on package %s (%d partitions)",
+                                    package_->name(), partitions_.size());
+  struct PartitionResult {
+    absl::Status status;
+    bool progress_made = false;
+    std::vector<Channel*> blocked_channels;
+  };
+  std::vector<PartitionResult> results(partitions_.size());
+  auto tick_partition = [&](int64_t index) {
+    PartitionResult& result = results[index];
+    absl::StatusOr<bool> progress =
+        TickPartition(partitions_[index], &result.blocked_channels);
+    if (progress.ok()) {
+      result.progress_made = progress.value();
+    } else {
+      result.status = progress.status();
+    }
+  };
+
+  if (deterministic_replay || partitions_.size() <= 1) {
+    // Run the partitions one after another on the calling thread. The
+    // partitions are independent so this reaches exactly the state a parallel
+    // run would, with a reproducible execution order for debugging.
+    for (int64_t i = 0; i < partitions_.size(); ++i) {
+      tick_partition(i);
+    }
+  } else {
+    // Spread the partitions over a pool of worker threads. Each partition is
+    // claimed by exactly one worker so its results slot needs no locking.
+    int64_t num_workers = std::min<int64_t>(
+        partitions_.size(),
+        std::max<int64_t>(1, std::thread::hardware_concurrency()));
+    std::atomic<int64_t> next_task(0);
+    std::vector<std::unique_ptr<Thread>> workers;
+    workers.reserve(num_workers);
+    for (int64_t w = 0; w < num_workers; ++w) {
+      workers.push_back(
+          std::make_unique<Thread>([this, &next_task, &tick_partition]() {
+            while (true) {
+              int64_t task = next_task.fetch_add(1);
+              if (task >= static_cast<int64_t>(partitions_.size())) {
+                return;
+              }
+              tick_partition(task);
+            }
+          }));
+    }
+    for (auto& worker : workers) {
+      worker->Join();
+    }
+  }
+
+  bool progress_made = false;
+  for (const PartitionResult& result : results) {
+    XLS_RETURN_IF_ERROR(result.status);
+    progress_made |= result.progress_made;
+  }
+  if (!progress_made) {
+    // Mirror Tick(): not a single instruction executed on any proc is a
+    // deadlock. Merge and re-sort the per-partition blocked channels so the
+    // message is deterministic regardless of execution order.
+    std::vector<Channel*> blocked_channels;
+    for (const PartitionResult& result : results) {
+      blocked_channels.insert(blocked_channels.end(),
+                              result.blocked_channels.begin(),
+                              result.blocked_channels.end());
+    }
+    std::sort(blocked_channels.begin(), blocked_channels.end(),
+              [](Channel* a, Channel* b) { return a->id() < b->id(); });
+    return absl::InternalError(absl::StrFormat(
+        "Proc network is deadlocked. Blocked channels: %s",
+        absl::StrJoin(blocked_channels, ", ", ChannelFormatter)));
+  }
+  return absl::OkStatus();
+}
+
 absl::StatusOr<int64_t> ProcNetworkInterpreter::TickUntilOutput(
     absl::flat_hash_map<Channel*, int64_t> output_counts,
     std::optional<int64_t> max_ticks) {
@@ -143,39 +308,16 @@ absl::StatusOr<bool> ProcNetworkInterpreter::TickInternal(
     std::vector<Channel*>* blocked_channels) {
   XLS_VLOG(3) << absl::StreamFormat("TickInternal on package %s",
                                     package_->name());
-  absl::flat_hash_set<ProcInterpreter*> completed_procs;
-  absl::flat_hash_set<Channel*> blocked_channel_set;
-  bool global_progress_made = false;
-  bool progress_made_this_loop = true;
-  while (progress_made_this_loop) {
-    progress_made_this_loop = false;
-    blocked_channel_set.clear();
-    for (auto& interpreter : proc_interpreters_) {
-      if (completed_procs.contains(interpreter.get())) {
-        continue;
-      }
-      XLS_ASSIGN_OR_RETURN(ProcInterpreter::RunResult result,
-                           interpreter->RunIterationUntilCompleteOrBlocked());
-
-      progress_made_this_loop |= result.progress_made;
-      if (result.iteration_complete) {
-        completed_procs.insert(interpreter.get());
-      }
-      blocked_channel_set.insert(result.blocked_channels.begin(),
-                                 result.blocked_channels.end());
-    }
-    global_progress_made |= progress_made_this_loop;
+  std::vector<ProcInterpreter*> interpreters;
+  interpreters.reserve(proc_interpreters_.size());
+  for (auto& interpreter : proc_interpreters_) {
+    interpreters.push_back(interpreter.get());
   }
-  if (!global_progress_made) {
+  XLS_ASSIGN_OR_RETURN(bool progress_made,
+                       TickPartition(interpreters, blocked_channels));
+  if (!progress_made) {
     // Not a single instruction executed on any proc. This is necessarily a
-    // deadlock. Sort blocked channels by channel id so the channels order is
-    // deterministic.
-    blocked_channels->clear();
-    blocked_channels->insert(blocked_channels->begin(),
-                             blocked_channel_set.begin(),
-                             blocked_channel_set.end());
-    std::sort(blocked_channels->begin(), blocked_channels->end(),
-              [](Channel* a, Channel* b) { return a->id() < b->id(); });
+    // deadlock.
     XLS_VLOG(3) << absl::StreamFormat(
         "TickInternal: no progress made, blocked channels: %s",
         absl::StrJoin(*blocked_channels, ", ", ChannelFormatter));
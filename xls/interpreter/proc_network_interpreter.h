@@ -49,6 +49,18 @@ class ProcNetworkInterpreter {
   // deadlock.
   absl::Status Tick();
 
+  // As Tick(), but runs the procs concurrently. The procs are partitioned by
+  // channel connectivity (procs transitively connected by channels land in the
+  // same partition) and each partition runs the same round-robin convergence
+  // loop as Tick() on its own worker thread. Procs in different partitions
+  // share no channels, so each channel queue is only ever touched by a single
+  // worker and the queues are the only synchronization points. If
+  // `deterministic_replay` is true the partitions are instead executed one
+  // after another on the calling thread in a fixed order; because the
+  // partitions are independent this produces exactly the state of a parallel
+  // run with a reproducible execution order for debugging.
+  absl::Status ParallelTick(bool deterministic_replay = false);
+
   // Tick the proc network until some output channels have produced at least a
   // specified number of outputs as indicated by `output_counts`.
   // `output_counts` must only contain output channels and need not contain all
@@ -91,6 +103,11 @@ class ProcNetworkInterpreter {
 
   // The vector of interpreters for each proc in the package.
   std::vector<std::unique_ptr<ProcInterpreter>> proc_interpreters_;
+
+  // Pointers into proc_interpreters_ grouped by channel connectivity. Computed
+  // once at Create time and used by ParallelTick. Partitions are ordered by
+  // the first appearance of one of their procs in the package.
+  std::vector<std::vector<ProcInterpreter*>> partitions_;
 };
 
 }  // namespace xls
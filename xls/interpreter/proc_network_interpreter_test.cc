@@ -17,6 +17,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "xls/common/status/matchers.h"
 #include "xls/ir/channel.h"
@@ -499,5 +500,162 @@ TEST_F(ProcNetworkInterpreterTest, IotaWithChannelBackedgeAndTwoInitialValues) {
   EXPECT_THAT(output_queue.Dequeue(), IsOkAndHolds(Value(UBits(102, 32))));
 }
 
+TEST_F(ProcNetworkInterpreterTest, ParallelTickIndependentPipelines) {
+  // An iota-feeding-accumulator pipeline plus an unconnected iota proc. The
+  // two components share no channels so ParallelTick runs them as separate
+  // partitions.
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * iota_accum_channel,
+      package->CreateStreamingChannel("iota_accum", ChannelOps::kSendReceive,
+                                      package->GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * accum_out_channel,
+      package->CreateStreamingChannel("accum_out", ChannelOps::kSendOnly,
+                                      package->GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * lone_iota_channel,
+      package->CreateStreamingChannel("lone_iota_out", ChannelOps::kSendOnly,
+                                      package->GetBitsType(32)));
+  XLS_ASSERT_OK(CreateIotaProc("iota", /*starting_value=*/0, /*step=*/1,
+                               iota_accum_channel, package.get())
+                    .status());
+  XLS_ASSERT_OK(CreateAccumProc("accum", iota_accum_channel, accum_out_channel,
+                                package.get())
+                    .status());
+  XLS_ASSERT_OK(CreateIotaProc("lone_iota", /*starting_value=*/5, /*step=*/10,
+                               lone_iota_channel, package.get())
+                    .status());
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ProcNetworkInterpreter> interpreter,
+                           ProcNetworkInterpreter::Create(
+                               package.get(), /*user_defined_queues*/ {}));
+
+  for (int64_t i = 0; i < 4; ++i) {
+    XLS_ASSERT_OK(interpreter->ParallelTick());
+  }
+
+  ChannelQueue& accum_queue =
+      interpreter->queue_manager().GetQueue(accum_out_channel);
+  EXPECT_EQ(accum_queue.size(), 4);
+  EXPECT_THAT(accum_queue.Dequeue(), IsOkAndHolds(Value(UBits(0, 32))));
+  EXPECT_THAT(accum_queue.Dequeue(), IsOkAndHolds(Value(UBits(1, 32))));
+  EXPECT_THAT(accum_queue.Dequeue(), IsOkAndHolds(Value(UBits(3, 32))));
+  EXPECT_THAT(accum_queue.Dequeue(), IsOkAndHolds(Value(UBits(6, 32))));
+
+  ChannelQueue& iota_queue =
+      interpreter->queue_manager().GetQueue(lone_iota_channel);
+  EXPECT_EQ(iota_queue.size(), 4);
+  EXPECT_THAT(iota_queue.Dequeue(), IsOkAndHolds(Value(UBits(5, 32))));
+  EXPECT_THAT(iota_queue.Dequeue(), IsOkAndHolds(Value(UBits(15, 32))));
+}
+
+TEST_F(ProcNetworkInterpreterTest, ParallelTickManyIndependentProcs) {
+  // More partitions than the worker pool has threads; each iota proc is its
+  // own partition.
+  constexpr int64_t kProcCount = 16;
+  auto package = CreatePackage();
+  std::vector<Channel*> channels;
+  for (int64_t i = 0; i < kProcCount; ++i) {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        Channel * channel,
+        package->CreateStreamingChannel(absl::StrFormat("iota_out_%d", i),
+                                        ChannelOps::kSendOnly,
+                                        package->GetBitsType(32)));
+    channels.push_back(channel);
+    XLS_ASSERT_OK(CreateIotaProc(absl::StrFormat("iota_%d", i),
+                                 /*starting_value=*/i, /*step=*/1, channel,
+                                 package.get())
+                      .status());
+  }
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ProcNetworkInterpreter> interpreter,
+                           ProcNetworkInterpreter::Create(
+                               package.get(), /*user_defined_queues*/ {}));
+
+  for (int64_t tick = 0; tick < 3; ++tick) {
+    XLS_ASSERT_OK(interpreter->ParallelTick());
+  }
+
+  for (int64_t i = 0; i < kProcCount; ++i) {
+    ChannelQueue& queue = interpreter->queue_manager().GetQueue(channels[i]);
+    EXPECT_EQ(queue.size(), 3);
+    for (int64_t tick = 0; tick < 3; ++tick) {
+      EXPECT_THAT(queue.Dequeue(), IsOkAndHolds(Value(UBits(i + tick, 32))));
+    }
+  }
+}
+
+TEST_F(ProcNetworkInterpreterTest, ParallelTickDeterministicReplay) {
+  // In deterministic replay mode the partitions run sequentially in a fixed
+  // order and must reach the same state as a parallel run.
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * iota_accum_channel,
+      package->CreateStreamingChannel("iota_accum", ChannelOps::kSendReceive,
+                                      package->GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * accum_out_channel,
+      package->CreateStreamingChannel("accum_out", ChannelOps::kSendOnly,
+                                      package->GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * lone_iota_channel,
+      package->CreateStreamingChannel("lone_iota_out", ChannelOps::kSendOnly,
+                                      package->GetBitsType(32)));
+  XLS_ASSERT_OK(CreateIotaProc("iota", /*starting_value=*/0, /*step=*/1,
+                               iota_accum_channel, package.get())
+                    .status());
+  XLS_ASSERT_OK(CreateAccumProc("accum", iota_accum_channel, accum_out_channel,
+                                package.get())
+                    .status());
+  XLS_ASSERT_OK(CreateIotaProc("lone_iota", /*starting_value=*/100, /*step=*/1,
+                               lone_iota_channel, package.get())
+                    .status());
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ProcNetworkInterpreter> interpreter,
+                           ProcNetworkInterpreter::Create(
+                               package.get(), /*user_defined_queues*/ {}));
+
+  for (int64_t i = 0; i < 3; ++i) {
+    XLS_ASSERT_OK(interpreter->ParallelTick(/*deterministic_replay=*/true));
+  }
+
+  ChannelQueue& accum_queue =
+      interpreter->queue_manager().GetQueue(accum_out_channel);
+  EXPECT_EQ(accum_queue.size(), 3);
+  EXPECT_THAT(accum_queue.Dequeue(), IsOkAndHolds(Value(UBits(0, 32))));
+  EXPECT_THAT(accum_queue.Dequeue(), IsOkAndHolds(Value(UBits(1, 32))));
+  EXPECT_THAT(accum_queue.Dequeue(), IsOkAndHolds(Value(UBits(3, 32))));
+
+  ChannelQueue& iota_queue =
+      interpreter->queue_manager().GetQueue(lone_iota_channel);
+  EXPECT_EQ(iota_queue.size(), 3);
+  EXPECT_THAT(iota_queue.Dequeue(), IsOkAndHolds(Value(UBits(100, 32))));
+}
+
+TEST_F(ProcNetworkInterpreterTest, ParallelTickDeadlock) {
+  // ParallelTick detects deadlock the same way Tick does.
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package->CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                      package->GetBitsType(32)));
+  XLS_ASSERT_OK(CreatePassThroughProc("feedback", /*in_channel=*/channel,
+                                      /*out_channel=*/channel, package.get())
+                    .status());
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ProcNetworkInterpreter> interpreter,
+                           ProcNetworkInterpreter::Create(
+                               package.get(), /*user_defined_queues*/ {}));
+
+  XLS_ASSERT_OK(interpreter->ParallelTick());
+  EXPECT_THAT(
+      interpreter->ParallelTick(),
+      StatusIs(
+          absl::StatusCode::kInternal,
+          HasSubstr(
+              "Proc network is deadlocked. Blocked channels: my_channel")));
+}
+
 }  // namespace
 }  // namespace xls
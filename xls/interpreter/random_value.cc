@@ -14,7 +14,13 @@
 
 #include "xls/interpreter/random_value.h"
 
+#include <algorithm>
+#include <cstring>
+
+#include "absl/numeric/int128.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/math_util.h"
 #include "xls/interpreter/function_interpreter.h"
 
 namespace xls {
@@ -95,4 +101,86 @@ absl::StatusOr<std::vector<Value>> RandomFunctionArguments(
       "or the limit should be increased."));
 }
 
+/* static */ uint64_t CounterRng::WordAt(uint64_t seed, uint64_t counter) {
+  // Philox-style mixing of a two-word state seeded from the counter with a key
+  // bumped by the golden-ratio constant each round. Six rounds of the
+  // multiply-high/xor structure are plenty for fuzzing-quality randomness and
+  // cost a handful of cycles per word.
+  constexpr uint64_t kMultiplier = 0xd2b74407b1ce6e93ULL;
+  constexpr uint64_t kKeyBump = 0x9e3779b97f4a7c15ULL;
+  uint64_t x0 = counter;
+  uint64_t x1 = 0x85a308d331198a2eULL;
+  uint64_t key = seed;
+  for (int64_t round = 0; round < 6; ++round) {
+    absl::uint128 product = absl::uint128(x0) * kMultiplier;
+    x0 = absl::Uint128High64(product) ^ key ^ x1;
+    x1 = absl::Uint128Low64(product);
+    key += kKeyBump;
+  }
+  return x0 ^ x1;
+}
+
+absl::Status FillRandomPackedBytes(Type* type, uint64_t seed,
+                                   uint64_t sample_index,
+                                   absl::Span<uint8_t> buffer) {
+  int64_t bit_count = type->GetFlatBitCount();
+  int64_t byte_count = CeilOfRatio(bit_count, int64_t{8});
+  if (static_cast<int64_t>(buffer.size()) != byte_count) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Buffer is %d bytes; packed size of type %s is %d bytes",
+        buffer.size(), type->ToString(), byte_count));
+  }
+  // In the packed representation every flat bit of the value is uniformly
+  // random, so filling the buffer with random words and masking off the
+  // padding bits yields a uniformly random value of the type. Each sample
+  // owns a contiguous run of counters so samples can be generated out of
+  // order.
+  int64_t word_count = CeilOfRatio(byte_count, int64_t{8});
+  CounterRng rng(seed, sample_index * static_cast<uint64_t>(word_count));
+  for (int64_t w = 0; w < word_count; ++w) {
+    uint64_t word = rng.Next();
+    int64_t offset = w * 8;
+    memcpy(buffer.data() + offset, &word,
+           std::min(int64_t{8}, byte_count - offset));
+  }
+  if (bit_count % 8 != 0) {
+    buffer[byte_count - 1] &= static_cast<uint8_t>((1 << (bit_count % 8)) - 1);
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::vector<PackedValue>> RandomPackedValues(
+    Type* type, uint64_t seed, uint64_t first_sample, int64_t count) {
+  std::vector<PackedValue> samples;
+  samples.reserve(count);
+  for (int64_t i = 0; i < count; ++i) {
+    PackedValue sample(type);
+    XLS_RETURN_IF_ERROR(FillRandomPackedBytes(
+        type, seed, first_sample + i,
+        absl::MakeSpan(sample.buffer(), sample.size_in_bytes())));
+    samples.push_back(std::move(sample));
+  }
+  return samples;
+}
+
+absl::StatusOr<std::vector<std::vector<PackedValue>>>
+RandomPackedFunctionArguments(Function* f, uint64_t seed,
+                              uint64_t first_sample, int64_t count) {
+  std::vector<std::vector<PackedValue>> arg_sets(count);
+  for (int64_t argno = 0; argno < f->params().size(); ++argno) {
+    // Derive a per-parameter seed so parameters of the same type draw from
+    // distinct streams.
+    uint64_t param_seed =
+        CounterRng::WordAt(seed, ~static_cast<uint64_t>(argno));
+    XLS_ASSIGN_OR_RETURN(
+        std::vector<PackedValue> samples,
+        RandomPackedValues(f->param(argno)->GetType(), param_seed,
+                           first_sample, count));
+    for (int64_t i = 0; i < count; ++i) {
+      arg_sets[i].push_back(std::move(samples[i]));
+    }
+  }
+  return arg_sets;
+}
+
 }  // namespace xls
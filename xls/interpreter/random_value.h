@@ -15,10 +15,15 @@
 #ifndef XLS_INTERPRETER_RANDOM_VALUE_H_
 #define XLS_INTERPRETER_RANDOM_VALUE_H_
 
+#include <cstdint>
 #include <random>
 #include <vector>
 
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "xls/ir/function.h"
+#include "xls/ir/packed_value.h"
 #include "xls/ir/type.h"
 #include "xls/ir/value.h"
 
@@ -37,6 +42,52 @@ absl::StatusOr<std::vector<Value>> RandomFunctionArguments(
     Function* f, std::minstd_rand* engine, Function* validator,
     int64_t max_attempts);
 
+// A counter-based pseudo-random number generator in the style of Philox
+// (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3"). The i'th
+// 64-bit output word is a pure function of (seed, i), so fuzzer shards can
+// generate the words of any sample without generating the preceding samples
+// and bulk fills carry no generator state beyond the counter.
+class CounterRng {
+ public:
+  explicit CounterRng(uint64_t seed, uint64_t counter = 0)
+      : seed_(seed), counter_(counter) {}
+
+  // Returns the output word at the current counter and advances the counter.
+  uint64_t Next() { return WordAt(seed_, counter_++); }
+
+  // Returns the output word for the given (seed, counter) pair.
+  static uint64_t WordAt(uint64_t seed, uint64_t counter);
+
+ private:
+  uint64_t seed_;
+  uint64_t counter_;
+};
+
+// Fills `buffer` with the `sample_index`'th random sample of the given type
+// in the packed data representation (see PackedValue). `buffer` must be
+// exactly the packed byte size of the type. The contents are a pure function
+// of (seed, sample_index): the bits are drawn eight bytes at a time from
+// CounterRng and the padding bits above the type's flat bit count are masked
+// off the final byte, so the buffer feeds the packed-view evaluation path
+// (e.g. FunctionJit::RunWithPackedBuffers) directly.
+absl::Status FillRandomPackedBytes(Type* type, uint64_t seed,
+                                   uint64_t sample_index,
+                                   absl::Span<uint8_t> buffer);
+
+// Returns `count` random packed samples of the given type for sample indices
+// [first_sample, first_sample + count).
+absl::StatusOr<std::vector<PackedValue>> RandomPackedValues(
+    Type* type, uint64_t seed, uint64_t first_sample, int64_t count);
+
+// Returns `count` random argument sets for the given function in packed
+// representation; the result's i'th entry holds one packed value per
+// parameter for sample first_sample + i. Each parameter draws from its own
+// counter stream derived from the seed and the parameter index so parameters
+// of the same type are not correlated.
+absl::StatusOr<std::vector<std::vector<PackedValue>>>
+RandomPackedFunctionArguments(Function* f, uint64_t seed,
+                              uint64_t first_sample, int64_t count);
+
 }  // namespace xls
 
 #endif  // XLS_INTERPRETER_RANDOM_VALUE_H_
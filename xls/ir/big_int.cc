@@ -14,11 +14,25 @@
 
 #include "xls/ir/big_int.h"
 
+#include <memory>
+
 #include "absl/status/statusor.h"
 #include "openssl/bn.h"
 #include "xls/common/logging/logging.h"
 
 namespace xls {
+namespace {
+
+// Returns a thread-local scratch context for the BN_* calls which require one.
+// BN_CTX allocation is a malloc per call; constant folding can perform millions
+// of BigInt operations so the context is created once per thread and reused.
+BN_CTX* GetBnCtx() {
+  thread_local std::unique_ptr<BN_CTX, decltype(&BN_CTX_free)> ctx(
+      BN_CTX_new(), BN_CTX_free);
+  return ctx.get();
+}
+
+}  // namespace
 
 BigInt::BigInt() { BN_init(&bn_); }
 
@@ -52,6 +66,12 @@ bool BigInt::operator==(const BigInt& other) const {
 /* static */
 BigInt BigInt::MakeUnsigned(const Bits& bits) {
   BigInt value;
+  // Values fitting in a single word can be handed to the bignum library
+  // directly without materializing a byte vector.
+  if (bits.bit_count() <= 64) {
+    BN_set_word(&value.bn_, bits.ToUint64().value());
+    return value;
+  }
   std::vector<uint8_t> byte_vector = bits.ToBytes();
   BN_bin2bn(byte_vector.data(), byte_vector.size(), &value.bn_);
   return value;
@@ -63,6 +83,15 @@ BigInt BigInt::MakeSigned(const Bits& bits) {
     return MakeUnsigned(bits);
   }
   BigInt value;
+  if (bits.bit_count() <= 64) {
+    // 'bits' is negative, so the twos-complement magnitude 2^n - x fits in 64
+    // bits (the msb of x is set, so x != 0).
+    uint64_t magnitude =
+        (~bits.ToUint64().value() + 1) & Mask(bits.bit_count());
+    BN_set_word(&value.bn_, magnitude);
+    BN_set_negative(&value.bn_, 1);
+    return value;
+  }
   // 'bits' is a twos-complement negative number, invert the bits and add one to
   // get the magnitude. Then negate it to produce the correct value in the
   // BigInt.
@@ -118,6 +147,9 @@ Bits BigInt::ToSignedBits() const {
 Bits BigInt::ToUnsignedBits() const {
   XLS_CHECK(!BN_is_negative(&bn_));
   int64_t bit_count = BN_num_bits(&bn_);
+  if (bit_count <= 64) {
+    return UBits(BN_get_word(&bn_), bit_count);
+  }
   std::vector<uint8_t> byte_vector;
   byte_vector.resize(BN_num_bytes(&bn_));
 
@@ -204,9 +236,7 @@ int64_t BigInt::UnsignedBitCount() const {
   BigInt value;
   // Note: The documentation about BN_CTX in bn.h indicates that it's possible
   // to pass null to public methods that take a BN_CTX*, but that's not true.
-  BN_CTX* ctx = BN_CTX_new();
-  BN_mul(&value.bn_, &lhs.bn_, &rhs.bn_, ctx);
-  BN_CTX_free(ctx);
+  BN_mul(&value.bn_, &lhs.bn_, &rhs.bn_, GetBnCtx());
   return value;
 }
 
@@ -214,9 +244,7 @@ int64_t BigInt::UnsignedBitCount() const {
   BigInt value;
   // Note: The documentation about BN_CTX in bn.h indicates that it's possible
   // to pass null to public methods that take a BN_CTX*, but that's not true.
-  BN_CTX* ctx = BN_CTX_new();
-  BN_div(&value.bn_, /*rem=*/nullptr, &lhs.bn_, &rhs.bn_, ctx);
-  BN_CTX_free(ctx);
+  BN_div(&value.bn_, /*rem=*/nullptr, &lhs.bn_, &rhs.bn_, GetBnCtx());
   return value;
 }
 
@@ -224,9 +252,8 @@ int64_t BigInt::UnsignedBitCount() const {
   BigInt value;
   // Note: The documentation about BN_CTX in bn.h indicates that it's possible
   // to pass null to public methods that take a BN_CTX*, but that's not true.
-  BN_CTX* ctx = BN_CTX_new();
-  BN_div(/*quotient=*/nullptr, /*rem=*/&value.bn_, &lhs.bn_, &rhs.bn_, ctx);
-  BN_CTX_free(ctx);
+  BN_div(/*quotient=*/nullptr, /*rem=*/&value.bn_, &lhs.bn_, &rhs.bn_,
+         GetBnCtx());
   return value;
 }
 
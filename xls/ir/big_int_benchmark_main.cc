@@ -0,0 +1,105 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Microbenchmark for BigInt construction, conversion, and arithmetic. Constant
+// folding and number parsing lean heavily on BigInt, and the value widths are
+// dominated by narrow constants, so the benchmark reports ops/sec at both
+// single-word and multi-word widths:
+//
+//   bazel run -c opt //xls/ir:big_int_benchmark_main
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+
+#include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "xls/common/init_xls.h"
+#include "xls/ir/big_int.h"
+#include "xls/ir/bits.h"
+
+namespace xls {
+namespace {
+
+Bits RandomBits(int64_t bit_count, std::minstd_rand* rng) {
+  InlineBitmap bitmap(bit_count);
+  for (int64_t i = 0; i < bitmap.word_count(); ++i) {
+    uint64_t word = static_cast<uint64_t>((*rng)()) << 32 |
+                    static_cast<uint64_t>((*rng)());
+    bitmap.SetWord(i, word);
+  }
+  return Bits::FromBitmap(std::move(bitmap));
+}
+
+void RunBenchmark(absl::string_view name,
+                  const std::function<void(const Bits&, const Bits&)>& op,
+                  int64_t bit_count, std::minstd_rand* rng) {
+  const Bits lhs = RandomBits(bit_count, rng);
+  const Bits rhs = RandomBits(bit_count, rng);
+  int64_t iterations = 100000;
+  absl::Time start = absl::Now();
+  for (int64_t i = 0; i < iterations; ++i) {
+    op(lhs, rhs);
+  }
+  absl::Duration elapsed = absl::Now() - start;
+  double ops_per_sec =
+      static_cast<double>(iterations) / absl::ToDoubleSeconds(elapsed);
+  std::cout << absl::StreamFormat("%-12s width=%-6d %15.0f ops/sec\n", name,
+                                  bit_count, ops_per_sec);
+}
+
+void RealMain() {
+  std::minstd_rand rng(42);
+  for (int64_t width : {16, 64, 256, 1024, 4096}) {
+    RunBenchmark(
+        "make",
+        [](const Bits& a, const Bits& b) { BigInt::MakeUnsigned(a); }, width,
+        &rng);
+    RunBenchmark(
+        "round_trip",
+        [](const Bits& a, const Bits& b) {
+          BigInt::MakeUnsigned(a).ToUnsignedBits();
+        },
+        width, &rng);
+    RunBenchmark(
+        "add",
+        [](const Bits& a, const Bits& b) {
+          BigInt::Add(BigInt::MakeUnsigned(a), BigInt::MakeUnsigned(b));
+        },
+        width, &rng);
+    RunBenchmark(
+        "mul",
+        [](const Bits& a, const Bits& b) {
+          BigInt::Mul(BigInt::MakeUnsigned(a), BigInt::MakeUnsigned(b));
+        },
+        width, &rng);
+    RunBenchmark(
+        "mod",
+        [](const Bits& a, const Bits& b) {
+          BigInt::Mod(BigInt::MakeUnsigned(a), BigInt::MakeUnsigned(b));
+        },
+        width, &rng);
+  }
+}
+
+}  // namespace
+}  // namespace xls
+
+int main(int argc, char** argv) {
+  xls::InitXls(argv[0], argc, argv);
+  xls::RealMain();
+  return 0;
+}
@@ -14,6 +14,7 @@
 
 #include "xls/ir/big_int.h"
 
+#include <limits>
 #include <memory>
 
 #include "gmock/gmock.h"
@@ -334,5 +335,24 @@ TEST_F(BigIntTest, LessThan) {
   EXPECT_FALSE(BigInt::LessThan(MakeBigInt(10), MakeBigInt(10)));
   EXPECT_FALSE(BigInt::LessThan(MakeBigInt(12), MakeBigInt(10)));
 }
+
+TEST_F(BigIntTest, WordBoundaryRoundTrips) {
+  // Values at and just above the single-word boundary, where construction and
+  // conversion switch between the word and the byte-vector paths. All of these
+  // have their msb set so the round trip preserves the width.
+  for (const Bits& bits : {UBits(0, 0), UBits(1, 1), Bits::AllOnes(64),
+                           Bits::AllOnes(65), Bits::AllOnes(128)}) {
+    EXPECT_EQ(BigInt::MakeUnsigned(bits).ToUnsignedBits(), bits)
+        << bits.ToString();
+  }
+  // The most negative 64-bit value: the magnitude 2^63 does not fit in a
+  // signed word.
+  BigInt most_negative =
+      BigInt::MakeSigned(SBits(std::numeric_limits<int64_t>::min(), 64));
+  EXPECT_EQ(most_negative.ToSignedBits(),
+            SBits(std::numeric_limits<int64_t>::min(), 64));
+  EXPECT_EQ(BigInt::Negate(most_negative).ToUnsignedBits(),
+            UBits(uint64_t{1} << 63, 64));
+}
 }  // namespace
 }  // namespace xls
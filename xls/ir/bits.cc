@@ -14,6 +14,8 @@
 
 #include "xls/ir/bits.h"
 
+#include <optional>
+
 #include "absl/base/casts.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/escaping.h"
@@ -106,15 +108,7 @@ Bits Bits::PowerOfTwo(int64_t set_bit_index, int64_t bit_count) {
 
 bool Bits::IsOne() const { return PopCount() == 1 && Get(0); }
 
-int64_t Bits::PopCount() const {
-  int64_t count = 0;
-  for (int64_t i = 0; i < bit_count(); ++i) {
-    if (Get(i)) {
-      ++count;
-    }
-  }
-  return count;
-}
+int64_t Bits::PopCount() const { return bitmap_.PopCount(); }
 
 int64_t Bits::CountLeadingZeros() const {
   for (int64_t i = 0; i < bit_count(); ++i) {
@@ -135,10 +129,8 @@ int64_t Bits::CountLeadingOnes() const {
 }
 
 int64_t Bits::CountTrailingZeros() const {
-  for (int64_t i = 0; i < bit_count(); ++i) {
-    if (Get(i)) {
-      return i;
-    }
+  if (std::optional<int64_t> first_set = bitmap_.FindFirstSetBit()) {
+    return *first_set;
   }
   return bit_count();
 }
@@ -22,8 +22,10 @@
 #include <string>
 
 #include "absl/base/casts.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "xls/common/allocation_accounting.h"
 #include "xls/common/bits_util.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/math_util.h"
@@ -52,7 +54,10 @@ class Bits {
 
   // Creates a zero-initialized bits object with the given bit width.
   explicit Bits(int64_t bit_count)
-      : bitmap_(internal::CheckGe(bit_count, int64_t{0})) {}
+      : bitmap_(internal::CheckGe(bit_count, int64_t{0})) {
+    XLS_RECORD_ALLOCATION(AllocationCategory::kBits,
+                          CeilOfRatio(bit_count, int64_t{8}));
+  }
 
   // Creates a bits object with the given bits values. The n-th element of the
   // argument becomes the n-th bit of the Bits object. A std::vector<bool>
@@ -257,11 +262,15 @@ class Bits {
   }
 
  private:
+  friend class BitsBuilder;
   friend class BitsRope;
   friend absl::StatusOr<Bits> UBitsWithStatus(uint64_t, int64_t);
   friend absl::StatusOr<Bits> SBitsWithStatus(int64_t, int64_t);
 
-  explicit Bits(InlineBitmap&& bitmap) : bitmap_(bitmap) {}
+  explicit Bits(InlineBitmap&& bitmap) : bitmap_(bitmap) {
+    XLS_RECORD_ALLOCATION(AllocationCategory::kBits,
+                          CeilOfRatio(bitmap_.bit_count(), int64_t{8}));
+  }
 
   InlineBitmap bitmap_;
 };
@@ -304,6 +313,85 @@ class BitsRope {
   int64_t index_ = 0;
 };
 
+// Incrementally builds a Bits value a word (or sub-word) at a time, without
+// the per-bit Set calls of BitsRope or intermediate Bits copies. Unlike
+// BitsRope the total width need not be known up front; storage grows as bits
+// are appended and Reserve gives the usual amortization guarantee. As with
+// BitsRope, bit 0 of the first append becomes bit 0 (the LSb) of the result.
+class BitsBuilder {
+ public:
+  BitsBuilder() = default;
+  explicit BitsBuilder(int64_t capacity_hint) { Reserve(capacity_hint); }
+
+  // Reserves storage for at least `bit_count` bits.
+  void Reserve(int64_t bit_count) {
+    words_.reserve(CeilOfRatio(bit_count, int64_t{64}));
+  }
+
+  // Appends the low `bit_count` bits of `word`, least-significant bit first.
+  // Bits of `word` at or beyond `bit_count` are ignored.
+  void AppendWord(uint64_t word, int64_t bit_count = 64) {
+    XLS_DCHECK_GE(bit_count, 0);
+    XLS_DCHECK_LE(bit_count, 64);
+    if (bit_count == 0) {
+      return;
+    }
+    if (bit_count < 64) {
+      word &= Mask(bit_count);
+    }
+    const int64_t offset = bit_count_ % 64;
+    if (offset == 0) {
+      words_.push_back(word);
+    } else {
+      // Stitch across the word boundary: low part into the current word, any
+      // overflow into a fresh word.
+      words_.back() |= word << offset;
+      if (offset + bit_count > 64) {
+        words_.push_back(word >> (64 - offset));
+      }
+    }
+    bit_count_ += bit_count;
+  }
+
+  // Appends a single bit.
+  void AppendBit(bool bit) { AppendWord(bit ? 1 : 0, /*bit_count=*/1); }
+
+  // Appends the entire contents of `bits`; bit 0 of `bits` lands at the
+  // current end of the builder, as with BitsRope::push_back.
+  void AppendBits(const Bits& bits) {
+    const InlineBitmap& bitmap = bits.bitmap();
+    const int64_t full_words = bits.bit_count() / 64;
+    for (int64_t i = 0; i < full_words; ++i) {
+      AppendWord(bitmap.GetWord(i));
+    }
+    const int64_t remainder = bits.bit_count() % 64;
+    if (remainder != 0) {
+      AppendWord(bitmap.GetWord(full_words), remainder);
+    }
+  }
+
+  // Appends `bit_count` zero bits.
+  void AppendZeroes(int64_t bit_count) {
+    while (bit_count > 0) {
+      const int64_t chunk = std::min<int64_t>(bit_count, 64);
+      AppendWord(0, chunk);
+      bit_count -= chunk;
+    }
+  }
+
+  int64_t bit_count() const { return bit_count_; }
+
+  // Finalizes the builder, moving the accumulated words into the returned
+  // Bits. The builder must not be used afterwards.
+  Bits Build() {
+    return Bits(InlineBitmap::FromWords(std::move(words_), bit_count_));
+  }
+
+ private:
+  absl::InlinedVector<uint64_t, 1> words_;
+  int64_t bit_count_ = 0;
+};
+
 // Creates an Bits object which holds the given unsigned/signed value. Width
 // must be large enough to hold the value. The bits object itelf has no
 // signedness, but the UBits and SBits factories affect how the minimum bit
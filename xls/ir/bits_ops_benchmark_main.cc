@@ -0,0 +1,97 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Microbenchmark for the bulk logical/arithmetic kernels in bits_ops. Prints
+// ops/sec for each (operation, width) pair so regressions in the wide-Bits
+// paths are easy to spot:
+//
+//   bazel run -c opt //xls/ir:bits_ops_benchmark_main
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "xls/common/init_xls.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/bits_ops.h"
+
+namespace xls {
+namespace {
+
+Bits RandomBits(int64_t bit_count, std::minstd_rand* rng) {
+  InlineBitmap bitmap(bit_count);
+  for (int64_t i = 0; i < bitmap.word_count(); ++i) {
+    uint64_t word = static_cast<uint64_t>((*rng)()) << 32 |
+                    static_cast<uint64_t>((*rng)());
+    bitmap.SetWord(i, word);
+  }
+  return Bits::FromBitmap(std::move(bitmap));
+}
+
+void RunBenchmark(absl::string_view name,
+                  const std::function<Bits(const Bits&, const Bits&)>& op,
+                  int64_t bit_count, std::minstd_rand* rng) {
+  const Bits lhs = RandomBits(bit_count, rng);
+  const Bits rhs = RandomBits(bit_count, rng);
+  // Calibration pass to pick an iteration count of roughly 100ms.
+  int64_t iterations = 1000;
+  absl::Time start = absl::Now();
+  for (int64_t i = 0; i < iterations; ++i) {
+    Bits result = op(lhs, rhs);
+    // Keep the result alive so the call is not optimized away.
+    if (result.bit_count() != bit_count) {
+      std::cerr << "Unexpected result width\n";
+      return;
+    }
+  }
+  absl::Duration elapsed = absl::Now() - start;
+  double ops_per_sec =
+      static_cast<double>(iterations) / absl::ToDoubleSeconds(elapsed);
+  std::cout << absl::StreamFormat("%-8s width=%-6d %15.0f ops/sec\n", name,
+                                  bit_count, ops_per_sec);
+}
+
+void RealMain() {
+  std::minstd_rand rng(42);
+  for (int64_t width : {64, 256, 1024, 4096, 16384}) {
+    RunBenchmark("and", [](const Bits& a, const Bits& b) { return bits_ops::And(a, b); },
+                 width, &rng);
+    RunBenchmark("or", [](const Bits& a, const Bits& b) { return bits_ops::Or(a, b); },
+                 width, &rng);
+    RunBenchmark("xor", [](const Bits& a, const Bits& b) { return bits_ops::Xor(a, b); },
+                 width, &rng);
+    RunBenchmark("not", [](const Bits& a, const Bits& b) { return bits_ops::Not(a); },
+                 width, &rng);
+    RunBenchmark("add", [](const Bits& a, const Bits& b) { return bits_ops::Add(a, b); },
+                 width, &rng);
+    RunBenchmark("sub", [](const Bits& a, const Bits& b) { return bits_ops::Sub(a, b); },
+                 width, &rng);
+    RunBenchmark("umul", [](const Bits& a, const Bits& b) { return bits_ops::UMul(a, b); },
+                 width, &rng);
+  }
+}
+
+}  // namespace
+}  // namespace xls
+
+int main(int argc, char** argv) {
+  xls::InitXls(argv[0], argc, argv);
+  xls::RealMain();
+  return 0;
+}
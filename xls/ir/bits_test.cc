@@ -678,5 +678,49 @@ TEST(BitsTest, ToBitVectorAndBack) {
   EXPECT_EQ(Bits(UBits(0b11001, 1234).ToBitVector()), UBits(0b11001, 1234));
 }
 
+TEST(BitsTest, BitsBuilderAppendWord) {
+  BitsBuilder builder;
+  builder.AppendWord(0xdeadbeef, 32);
+  builder.AppendWord(0x1234567890abcdefULL);
+  builder.AppendBit(true);
+  builder.AppendZeroes(30);
+  Bits result = builder.Build();
+  EXPECT_EQ(result.bit_count(), 32 + 64 + 1 + 30);
+
+  // The result must match per-bit construction of the same sequence.
+  BitsRope rope(result.bit_count());
+  rope.push_back(UBits(0xdeadbeef, 32));
+  rope.push_back(UBits(0x1234567890abcdefULL, 64));
+  rope.push_back(true);
+  rope.push_back(Bits(30));
+  EXPECT_EQ(result, rope.Build());
+}
+
+TEST(BitsTest, BitsBuilderAppendBits) {
+  std::vector<Bits> pieces = {UBits(0x3, 2),
+                              UBits(0xabcd, 16),
+                              UBits(0x1234567890abcdefULL, 64),
+                              Bits(0),
+                              UBits(1, 1),
+                              UBits(0x7fffffff, 31)};
+  int64_t total = 0;
+  for (const Bits& piece : pieces) {
+    total += piece.bit_count();
+  }
+  BitsBuilder builder(total);
+  BitsRope rope(total);
+  for (const Bits& piece : pieces) {
+    builder.AppendBits(piece);
+    rope.push_back(piece);
+  }
+  EXPECT_EQ(builder.Build(), rope.Build());
+}
+
+TEST(BitsTest, BitsBuilderMasksExcessWordBits) {
+  BitsBuilder builder;
+  builder.AppendWord(~uint64_t{0}, 5);
+  EXPECT_EQ(builder.Build(), UBits(31, 5));
+}
+
 }  // namespace
 }  // namespace xls
@@ -15,6 +15,7 @@
 #include "xls/ir/block.h"
 
 #include "absl/container/btree_set.h"
+#include "absl/memory/memory.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
@@ -244,16 +245,20 @@ absl::Status Block::SetPortNameExactly(absl::string_view name, Node* node) {
                             "already exists with this name",
                             name));
       }
-      // Pick a new name for n.
+      // Pick a new name for n. Mark the names materialized so lazy
+      // uniquification cannot rename them later.
       n->name_ = UniquifyNodeName(name);
+      n->name_materialized_ = true;
       XLS_RET_CHECK_NE(n->GetName(), name);
       node->name_ = name;
+      node->name_materialized_ = true;
       return absl::OkStatus();
     }
   }
   // Ensure the name is known by the uniquer.
   UniquifyNodeName(name);
   node->name_ = name;
+  node->name_materialized_ = true;
   return absl::OkStatus();
 }
 
@@ -296,7 +301,8 @@ absl::StatusOr<InputPort*> Block::AddInputPort(absl::string_view name,
     return absl::InvalidArgumentError(absl::StrFormat(
         "Block %s already contains a port named %s", this->name(), name));
   }
-  InputPort* port = AddNode(std::make_unique<InputPort>(loc, name, type, this));
+  InputPort* port = AddNode(absl::WrapUnique(
+      new (package()->node_arena()) InputPort(loc, name, type, this)));
   if (name != port->GetName()) {
     // The name uniquer changed the given name of the input port to preserve
     // name uniqueness which means another node with this name may already
@@ -318,8 +324,8 @@ absl::StatusOr<OutputPort*> Block::AddOutputPort(absl::string_view name,
     return absl::InvalidArgumentError(absl::StrFormat(
         "Block %s already contains a port named %s", this->name(), name));
   }
-  OutputPort* port =
-      AddNode(std::make_unique<OutputPort>(loc, operand, name, this));
+  OutputPort* port = AddNode(absl::WrapUnique(
+      new (package()->node_arena()) OutputPort(loc, operand, name, this)));
 
   if (name != port->GetName()) {
     // The name uniquer changed the given name of the output port to preserve
@@ -15,6 +15,9 @@
 #ifndef XLS_IR_DFS_VISITOR_H_
 #define XLS_IR_DFS_VISITOR_H_
 
+#include <cstdint>
+#include <vector>
+
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "xls/ir/node.h"
@@ -112,6 +115,9 @@ class DfsVisitor {
   // Marks the given node as visited.
   void MarkVisited(Node* node) { visited_.insert(node); }
 
+  // Unmarks the given node as visited so a later Accept() revisits it.
+  void UnmarkVisited(Node* node) { visited_.erase(node); }
+
   // Returns whether the given node is on path from the root of the traversal
   // to the currently visited node. Used to identify cycles in the graph.
   bool IsTraversing(Node* node) const { return traversing_.contains(node); }
@@ -134,12 +140,28 @@ class DfsVisitor {
   // Return the total number of nodes visited.
   int64_t GetVisitedCount() const { return visited_.size(); }
 
+  // A frame of the explicit work stack used by Node::Accept's iterative
+  // traversal: a node and the index of the next operand to descend into.
+  struct AcceptFrame {
+    Node* node;
+    int64_t operand_index;
+  };
+
+  // Returns the work stack used by Node::Accept. The stack lives on the
+  // visitor so its allocation is reused across the many Accept calls made with
+  // the same visitor (e.g. one per root node in FunctionBase::Accept). Empty
+  // between traversals.
+  std::vector<AcceptFrame>& accept_stack() { return accept_stack_; }
+
  private:
   // Set of nodes which have been visited.
   absl::flat_hash_set<Node*> visited_;
 
   // Set of nodes which are being traversed through.
   absl::flat_hash_set<Node*> traversing_;
+
+  // Work stack for iterative traversal; see accept_stack().
+  std::vector<AcceptFrame> accept_stack_;
 };
 
 // Visitor with a default action. If the Handle<Op> method is not overridden
@@ -53,6 +53,13 @@ class Function : public FunctionBase {
     XLS_RET_CHECK_EQ(n->function_base(), this) << absl::StreamFormat(
         "Return value node %s is not in this function %s (is in function %s)",
         n->GetName(), name(), n->function_base()->name());
+    // The return value is an edge of the graph (and is specially ordered by
+    // TopoSort), so changing it is a graph mutation.
+    RecordGraphChange();
+    if (return_value_ != nullptr) {
+      // The old return value loses its implicit use and may now be dead.
+      AddDeadNodeCandidate(return_value_);
+    }
     return_value_ = n;
     return absl::OkStatus();
   }
@@ -23,6 +23,7 @@
 #include "xls/ir/block.h"
 #include "xls/ir/function.h"
 #include "xls/ir/ir_scanner.h"
+#include "xls/ir/node_indexed_vector.h"
 #include "xls/ir/node_iterator.h"
 #include "xls/ir/package.h"
 #include "xls/ir/proc.h"
@@ -80,23 +81,23 @@ absl::StatusOr<Node*> FunctionBase::GetNode(
 }
 
 absl::Status FunctionBase::RemoveNode(Node* node) {
+  RecordGraphChange();
   XLS_RET_CHECK(node->users().empty()) << node->GetName();
   XLS_RET_CHECK(!HasImplicitUse(node)) << node->GetName();
-  std::vector<Node*> unique_operands;
-  for (Node* operand : node->operands()) {
-    if (!absl::c_linear_search(unique_operands, operand)) {
-      unique_operands.push_back(operand);
+  // Unlink the node's use edges from its operands' use chains. Each operand
+  // slot has its own edge, so duplicate operands need no special casing.
+  for (int64_t i = 0; i < node->operand_count(); ++i) {
+    if (node->operands_[i] != nullptr) {
+      node->operands_[i]->UnlinkUse(node->operand_uses_[i]);
     }
   }
-  for (Node* operand : unique_operands) {
-    operand->RemoveUser(node);
-  }
   if (node->Is<Param>()) {
     params_.erase(std::remove(params_.begin(), params_.end(), node),
                   params_.end());
   }
   auto node_it = node_iterators_.find(node);
   XLS_RET_CHECK(node_it != node_iterators_.end());
+  maybe_dead_nodes_.erase(node);
   nodes_.erase(node_it->second);
   node_iterators_.erase(node_it);
   return absl::OkStatus();
@@ -130,6 +131,25 @@ absl::Status FunctionBase::Accept(DfsVisitor* visitor) {
   return absl::OkStatus();
 }
 
+absl::Status FunctionBase::CloneInto(FunctionBase* target,
+                                     NodeIndexedVector<Node*>* node_map) const {
+  std::vector<Node*> new_operands;
+  for (Node* node : TopoSort(const_cast<FunctionBase*>(this))) {
+    if (node_map->contains(node)) {
+      // Already mapped by the caller (e.g. params to their replacements).
+      continue;
+    }
+    new_operands.clear();
+    for (Node* operand : node->operands()) {
+      new_operands.push_back(node_map->at(operand));
+    }
+    XLS_ASSIGN_OR_RETURN(Node * new_node,
+                         node->CloneInNewFunction(new_operands, target));
+    (*node_map)[node] = new_node;
+  }
+  return absl::OkStatus();
+}
+
 bool FunctionBase::IsFunction() const {
   return dynamic_cast<const Function*>(this) != nullptr;
 }
@@ -158,6 +178,7 @@ Block* FunctionBase::AsBlockOrDie() {
 }
 
 Node* FunctionBase::AddNodeInternal(std::unique_ptr<Node> node) {
+  RecordGraphChange();
   XLS_VLOG(4) << absl::StrFormat("Adding node %s to FunctionBase %s",
                                  node->GetName(), name());
   if (node->Is<Param>()) {
@@ -165,6 +186,8 @@ Node* FunctionBase::AddNodeInternal(std::unique_ptr<Node> node) {
   }
   Node* ptr = node.get();
   node_iterators_[ptr] = nodes_.insert(nodes_.end(), std::move(node));
+  // A freshly added node has no users yet.
+  AddDeadNodeCandidate(ptr);
   return ptr;
 }
 
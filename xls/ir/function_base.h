@@ -20,6 +20,8 @@
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "xls/common/iterator_range.h"
@@ -38,6 +40,9 @@ namespace xls {
 class Function;
 class Proc;
 
+template <typename T>
+class NodeIndexedVector;
+
 // Base class for Functions and Procs. A holder of a set of nodes.
 class FunctionBase {
  protected:
@@ -102,20 +107,64 @@ class FunctionBase {
   // to the newly constructed node.
   template <typename NodeT, typename... Args>
   absl::StatusOr<NodeT*> MakeNode(Args&&... args) {
-    NodeT* new_node = AddNode(std::make_unique<NodeT>(
-        std::forward<Args>(args)..., /*name=*/"", this));
+    NodeT* new_node = AddNode(absl::WrapUnique(new (package()->node_arena())
+        NodeT(std::forward<Args>(args)..., /*name=*/"", this)));
     XLS_RETURN_IF_ERROR(VerifyNode(new_node));
     return new_node;
   }
 
   template <typename NodeT, typename... Args>
   absl::StatusOr<NodeT*> MakeNodeWithName(Args&&... args) {
-    NodeT* new_node =
-        AddNode(std::make_unique<NodeT>(std::forward<Args>(args)..., this));
+    NodeT* new_node = AddNode(absl::WrapUnique(
+        new (package()->node_arena()) NodeT(std::forward<Args>(args)..., this)));
     XLS_RETURN_IF_ERROR(VerifyNode(new_node));
     return new_node;
   }
 
+  // Returns the cached (forward) topological order of the nodes, or nullptr
+  // if no valid cached order exists. The cache is populated by TopoSort() in
+  // node_iterator.h and dropped by InvalidateTopoOrderCache().
+  const std::shared_ptr<const std::vector<Node*>>& topo_order_cache() const {
+    return topo_order_cache_;
+  }
+  void SetTopoOrderCache(std::shared_ptr<const std::vector<Node*>> order) {
+    topo_order_cache_ = std::move(order);
+  }
+
+  // Discards any cached topological order. Must be called whenever the node
+  // set or the edges of the graph change.
+  void InvalidateTopoOrderCache() { topo_order_cache_.reset(); }
+
+  // Records a mutation of the node graph: bumps the change journal and drops
+  // any cached derived state. All graph mutation paths funnel through this.
+  void RecordGraphChange() {
+    ++transform_journal_;
+    InvalidateTopoOrderCache();
+  }
+
+  // Monotonically increasing counter bumped on every mutation of the node
+  // graph. Consumers (e.g. the incremental verifier) compare it against a
+  // remembered value to detect whether the function has changed since they
+  // last looked.
+  int64_t transform_journal() const { return transform_journal_; }
+
+  // Marks `node` as a candidate for dead code elimination. Called when the
+  // node's distinct-user count drops to zero, when it is created (a new node
+  // has no users yet), and when it loses an implicit use. Candidates may gain
+  // users again before being inspected; consumers must revalidate.
+  void AddDeadNodeCandidate(Node* node) { maybe_dead_nodes_.insert(node); }
+
+  // Returns the accumulated dead-node candidates and empties the set. The
+  // order of the returned vector is unspecified. Removing a candidate's users
+  // feeds its operands back into the set, so dead code elimination loops
+  // until this returns empty rather than scanning all nodes.
+  std::vector<Node*> TakeDeadNodeCandidates() {
+    std::vector<Node*> candidates(maybe_dead_nodes_.begin(),
+                                  maybe_dead_nodes_.end());
+    maybe_dead_nodes_.clear();
+    return candidates;
+  }
+
   // Find a node by it's name, as generated by DumpIr.
   absl::StatusOr<Node*> GetNode(absl::string_view standard_node_name);
 
@@ -128,6 +177,17 @@ class FunctionBase {
   // function using the given visitor.
   absl::Status Accept(DfsVisitor* visitor);
 
+  // Clones every node of this function into 'target' in a single pass in
+  // topological order, rewiring each clone's operands through 'node_map'.
+  // Nodes already present in 'node_map' (typically this function's params,
+  // mapped to their replacements in 'target') are not cloned; on return the
+  // map additionally holds an entry for every cloned node. The map is indexed
+  // densely by node id so per-operand remapping is an array load rather than a
+  // hash lookup, which matters when callers (inlining) clone whole bodies many
+  // times over.
+  absl::Status CloneInto(FunctionBase* target,
+                         NodeIndexedVector<Node*>* node_map) const;
+
   // Sanitizes and uniquifies the given name using the function's name
   // uniquer. Registers the uniquified name in the uniquer so it is not handed
   // out again.
@@ -173,6 +233,16 @@ class FunctionBase {
 
   NameUniquer node_name_uniquer_ =
       NameUniquer(/*separator=*/"__", GetIrReservedWords());
+
+  // Cached topological order of the nodes; see topo_order_cache().
+  std::shared_ptr<const std::vector<Node*>> topo_order_cache_;
+
+  // Change journal; see transform_journal().
+  int64_t transform_journal_ = 0;
+
+  // Nodes which may have become dead; see AddDeadNodeCandidate(). RemoveNode()
+  // erases entries so the set never holds dangling pointers.
+  absl::flat_hash_set<Node*> maybe_dead_nodes_;
 };
 
 std::ostream& operator<<(std::ostream& os, const FunctionBase& function);
@@ -71,7 +71,7 @@ BValue BValue::operator-() { return builder()->Negate(*this); }
 
 BValue BuilderBase::CreateBValue(Node* node, const SourceInfo& loc) {
   last_node_ = node;
-  if (should_verify_) {
+  if (should_verify_ && !defer_node_verification_) {
     absl::Status verify_status = VerifyNode(last_node_);
     if (!verify_status.ok()) {
       return SetError(verify_status.message(), loc);
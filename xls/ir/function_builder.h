@@ -576,6 +576,19 @@ class BuilderBase {
 
   Package* package() const;
 
+  // Controls whether each node is verified as it is added to the function. By
+  // default every added node is verified immediately which attributes errors
+  // precisely to the operation which created them. Code generators (DSLX IR
+  // conversion, XLScc) which emit very large numbers of nodes from
+  // already-typechecked sources can defer this per-node work; the entire
+  // function is still verified once when Build() is called. Has no effect if
+  // verification is disabled entirely via the 'should_verify' constructor
+  // argument.
+  void SetDeferNodeVerification(bool defer) {
+    defer_node_verification_ = defer;
+  }
+  bool defer_node_verification() const { return defer_node_verification_; }
+
   // Returns the last node enqueued onto this builder -- when Build() is called
   // this is what is used as the return value.
   absl::StatusOr<BValue> GetLastValue() {
@@ -606,6 +619,10 @@ class BuilderBase {
   // tests.
   bool should_verify_;
 
+  // Whether per-node verification is deferred to Build() time. See
+  // SetDeferNodeVerification().
+  bool defer_node_verification_ = false;
+
   std::string error_msg_;
   std::string error_stacktrace_;
   SourceInfo error_loc_;
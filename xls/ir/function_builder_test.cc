@@ -1012,4 +1012,31 @@ TEST(FunctionBuilderTest, Registers) {
   EXPECT_THAT(get_reg_write(x_3)->load_enable().value(), m::InputPort("le"));
 }
 
+TEST(FunctionBuilderTest, DeferredNodeVerificationBuildsWellFormedFunction) {
+  Package p("p");
+  FunctionBuilder b("f", &p);
+  b.SetDeferNodeVerification(true);
+  Type* bits_32 = p.GetBitsType(32);
+  BValue x = b.Param("x", bits_32);
+  BValue y = b.Param("y", bits_32);
+  b.Add(x, y);
+  XLS_ASSERT_OK(b.Build().status());
+}
+
+TEST(FunctionBuilderTest, DeferredNodeVerificationCatchesErrorAtBuild) {
+  Package p("p");
+  FunctionBuilder b("f", &p);
+  b.SetDeferNodeVerification(true);
+  BValue x = b.Param("x", p.GetBitsType(32));
+  BValue y = b.Param("y", p.GetBitsType(8));
+  // With per-node verification deferred the malformed add is not rejected at
+  // construction time...
+  BValue sum = b.Add(x, y);
+  EXPECT_TRUE(sum.valid());
+  // ...but the whole-function verification at Build() time still catches it.
+  EXPECT_THAT(b.Build().status(),
+              StatusIs(absl::StatusCode::kInternal,
+                       HasSubstr("Expected operand 1 of")));
+}
+
 }  // namespace xls
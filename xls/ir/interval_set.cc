@@ -63,30 +63,41 @@ void IntervalSet::SetIntervals(absl::Span<const Interval> intervals) {
 }
 
 void IntervalSet::Normalize() {
+  if (is_normalized_) {
+    return;
+  }
   Bits zero(BitCount());
   Bits max = Bits::AllOnes(BitCount());
-  std::vector<Interval> expand_improper;
-  for (const Interval& interval : intervals_) {
-    if (interval.IsImproper()) {
-      expand_improper.push_back(Interval(zero, interval.UpperBound()));
-      expand_improper.push_back(Interval(interval.LowerBound(), max));
-    } else {
-      expand_improper.push_back(interval);
+
+  // Split any improper intervals in place; the pieces do not need to stay
+  // adjacent since the whole set is sorted below.
+  int64_t original_size = intervals_.size();
+  for (int64_t i = 0; i < original_size; ++i) {
+    if (intervals_[i].IsImproper()) {
+      intervals_.push_back(Interval(zero, intervals_[i].UpperBound()));
+      intervals_[i] = Interval(intervals_[i].LowerBound(), max);
     }
   }
 
-  std::sort(expand_improper.begin(), expand_improper.end());
+  std::sort(intervals_.begin(), intervals_.end());
 
-  intervals_.clear();
-  for (int32_t i = 0; i < expand_improper.size();) {
-    Interval interval = expand_improper[i];
-    while ((i < expand_improper.size()) &&
-           (Interval::Overlaps(interval, expand_improper[i]) ||
-            Interval::Abuts(interval, expand_improper[i]))) {
-      interval = Interval::ConvexHull(interval, expand_improper[i]);
-      ++i;
+  // Merge overlapping or abutting neighbors in place, compacting the vector as
+  // we go.
+  if (!intervals_.empty()) {
+    int64_t merged = 0;
+    for (int64_t i = 1; i < intervals_.size(); ++i) {
+      if (Interval::Overlaps(intervals_[merged], intervals_[i]) ||
+          Interval::Abuts(intervals_[merged], intervals_[i])) {
+        intervals_[merged] =
+            Interval::ConvexHull(intervals_[merged], intervals_[i]);
+      } else {
+        ++merged;
+        if (merged != i) {
+          intervals_[merged] = std::move(intervals_[i]);
+        }
+      }
     }
-    intervals_.push_back(interval);
+    intervals_.resize(merged + 1);
   }
 
   is_normalized_ = true;
@@ -227,6 +238,29 @@ IntervalSet IntervalSet::Intersect(const IntervalSet& lhs,
   return result;
 }
 
+IntervalSet IntervalSet::CombineAll(int64_t bit_count,
+                                    absl::Span<const IntervalSet> sets) {
+  IntervalSet combined(bit_count);
+  for (const IntervalSet& set : sets) {
+    XLS_CHECK_EQ(set.BitCount(), bit_count);
+    for (const Interval& interval : set.intervals_) {
+      combined.AddInterval(interval);
+    }
+  }
+  combined.Normalize();
+  return combined;
+}
+
+IntervalSet IntervalSet::IntersectAll(int64_t bit_count,
+                                      absl::Span<const IntervalSet> sets) {
+  IntervalSet result = Maximal(bit_count);
+  for (const IntervalSet& set : sets) {
+    XLS_CHECK_EQ(set.BitCount(), bit_count);
+    result = Intersect(result, set);
+  }
+  return result;
+}
+
 IntervalSet IntervalSet::Complement(const IntervalSet& set) {
   // The complement of an interval set is the intersection of the complements of
   // the component intervals.
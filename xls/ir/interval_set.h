@@ -20,8 +20,8 @@
 #include <functional>
 #include <iosfwd>
 #include <string>
-#include <vector>
 
+#include "absl/container/inlined_vector.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
@@ -100,6 +100,9 @@ class IntervalSet {
   // 5. The result of a call to `Intervals()` has the smallest possible size
   //    of any set of intervals representing the same set of points that
   //    contains no improper intervals (hence the name "normalization").
+  //
+  // Normalization is performed in place and is a no-op if the set is already
+  // normalized.
   void Normalize();
 
   // Return the smallest single proper interval that contains all points in this
@@ -132,6 +135,19 @@ class IntervalSet {
   // given interval set.
   static IntervalSet Complement(const IntervalSet& set);
 
+  // Returns a normalized set of intervals comprising the union of all the
+  // given interval sets, each of which must have the given bit count. Unlike a
+  // fold over `Combine`, the result is only normalized once at the end. The
+  // union of no sets is the empty set.
+  static IntervalSet CombineAll(int64_t bit_count,
+                                absl::Span<const IntervalSet> sets);
+
+  // Returns a normalized set of intervals comprising the intersection of all
+  // the given interval sets, each of which must have the given bit count. The
+  // intersection of no sets is the maximal set.
+  static IntervalSet IntersectAll(int64_t bit_count,
+                                  absl::Span<const IntervalSet> sets);
+
   // Returns the number of points covered by the intervals in this interval set,
   // if that is expressible as an `int64_t`. Otherwise, returns `absl::nullopt`.
   // CHECK fails if the interval set is not normalized.
@@ -207,13 +223,20 @@ class IntervalSet {
 
   template <typename H>
   friend H AbslHashValue(H h, const IntervalSet& set) {
-    return H::combine(std::move(h), set.bit_count_, set.intervals_);
+    h = H::combine(std::move(h), set.bit_count_, set.intervals_.size());
+    for (const Interval& interval : set.intervals_) {
+      h = H::combine(std::move(h), interval);
+    }
+    return h;
   }
 
  private:
   bool is_normalized_;
   int64_t bit_count_;
-  std::vector<Interval> intervals_;
+  // Most interval sets (e.g. the leaves tracked by the range query engine)
+  // hold one or two intervals after normalization, so store them inline to
+  // avoid a heap allocation per set.
+  absl::InlinedVector<Interval, 2> intervals_;
 };
 
 inline std::ostream& operator<<(std::ostream& os,
@@ -114,6 +114,45 @@ TEST(IntervalTest, Combine) {
                                    MakeInterval(25, 35, 32)}));
 }
 
+TEST(IntervalTest, CombineAll) {
+  IntervalSet x(32);
+  x.AddInterval(MakeInterval(5, 10, 32));
+
+  IntervalSet y(32);
+  y.AddInterval(MakeInterval(11, 15, 32));
+
+  IntervalSet z(32);
+  z.AddInterval(MakeInterval(25, 35, 32));
+
+  EXPECT_EQ(IntervalSet::CombineAll(32, {x, y, z}).Intervals(),
+            (std::vector<Interval>{MakeInterval(5, 15, 32),
+                                   MakeInterval(25, 35, 32)}));
+  EXPECT_EQ(IntervalSet::CombineAll(32, {}).Intervals(),
+            std::vector<Interval>{});
+  EXPECT_EQ(IntervalSet::CombineAll(32, {x, y, z}),
+            IntervalSet::Combine(IntervalSet::Combine(x, y), z));
+}
+
+TEST(IntervalTest, IntersectAll) {
+  IntervalSet x(32);
+  x.AddInterval(MakeInterval(5, 30, 32));
+  x.Normalize();
+
+  IntervalSet y(32);
+  y.AddInterval(MakeInterval(10, 40, 32));
+  y.Normalize();
+
+  IntervalSet z(32);
+  z.AddInterval(MakeInterval(0, 20, 32));
+  z.Normalize();
+
+  EXPECT_EQ(IntervalSet::IntersectAll(32, {x, y, z}).Intervals(),
+            (std::vector<Interval>{MakeInterval(10, 20, 32)}));
+  EXPECT_TRUE(IntervalSet::IntersectAll(32, {}).IsMaximal());
+  EXPECT_EQ(IntervalSet::IntersectAll(32, {x, y, z}),
+            IntervalSet::Intersect(IntervalSet::Intersect(x, y), z));
+}
+
 TEST(IntervalTest, Intersect) {
   // Manually tested with 1,000 random seeds;
   int32_t seed = 815303902;
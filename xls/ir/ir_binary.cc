@@ -0,0 +1,143 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/ir_binary.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/ir_scanner.h"
+
+namespace xls {
+namespace {
+
+// Magic number at the start of every binary package, followed by a one-byte
+// format version.
+constexpr absl::string_view kMagic = "XLSB";
+constexpr uint8_t kVersion = 1;
+
+void AppendVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+absl::StatusOr<uint64_t> ReadVarint(absl::string_view data, int64_t* offset) {
+  uint64_t result = 0;
+  int shift = 0;
+  while (*offset < static_cast<int64_t>(data.size())) {
+    uint8_t byte = static_cast<uint8_t>(data[*offset]);
+    ++*offset;
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return result;
+    }
+    shift += 7;
+    if (shift > 63) {
+      break;
+    }
+  }
+  return absl::InvalidArgumentError(
+      "Corrupt binary package: truncated varint");
+}
+
+}  // namespace
+
+bool IsBinaryPackage(absl::string_view data) {
+  return data.size() > kMagic.size() + 1 &&
+         data.substr(0, kMagic.size()) == kMagic;
+}
+
+absl::StatusOr<std::string> SerializeIrTextToBinary(
+    absl::string_view ir_text) {
+  XLS_ASSIGN_OR_RETURN(std::vector<Token> tokens, TokenizeString(ir_text));
+  std::string out;
+  // Token values are a large fraction of the text; reserve accordingly.
+  out.reserve(ir_text.size() / 2 + 64);
+  out.append(kMagic.data(), kMagic.size());
+  out.push_back(static_cast<char>(kVersion));
+  AppendVarint(tokens.size(), &out);
+  for (const Token& token : tokens) {
+    out.push_back(static_cast<char>(token.type()));
+    AppendVarint(token.pos().lineno, &out);
+    AppendVarint(token.pos().colno, &out);
+    AppendVarint(token.value().size(), &out);
+    out.append(token.value());
+  }
+  return out;
+}
+
+std::string SerializePackageToBinary(const Package& package) {
+  // The canonical text dump always tokenizes, so the error branch is
+  // unreachable in practice.
+  absl::StatusOr<std::string> result = SerializeIrTextToBinary(package.DumpIr());
+  XLS_CHECK_OK(result.status());
+  return std::move(result).value();
+}
+
+absl::StatusOr<std::unique_ptr<Package>> ParseBinaryPackage(
+    absl::string_view data, std::optional<absl::string_view> filename) {
+  XLS_RET_CHECK(IsBinaryPackage(data));
+  int64_t offset = kMagic.size();
+  uint8_t version = static_cast<uint8_t>(data[offset++]);
+  if (version != kVersion) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Binary package has unsupported version %d (expected %d); "
+        "regenerate the artifact",
+        version, kVersion));
+  }
+  XLS_ASSIGN_OR_RETURN(uint64_t token_count, ReadVarint(data, &offset));
+  std::vector<Token> tokens;
+  tokens.reserve(token_count);
+  for (uint64_t i = 0; i < token_count; ++i) {
+    if (offset >= static_cast<int64_t>(data.size())) {
+      return absl::InvalidArgumentError(
+          "Corrupt binary package: truncated token stream");
+    }
+    LexicalTokenType type =
+        static_cast<LexicalTokenType>(static_cast<uint8_t>(data[offset++]));
+    XLS_ASSIGN_OR_RETURN(uint64_t lineno, ReadVarint(data, &offset));
+    XLS_ASSIGN_OR_RETURN(uint64_t colno, ReadVarint(data, &offset));
+    XLS_ASSIGN_OR_RETURN(uint64_t value_size, ReadVarint(data, &offset));
+    if (offset + static_cast<int64_t>(value_size) >
+        static_cast<int64_t>(data.size())) {
+      return absl::InvalidArgumentError(
+          "Corrupt binary package: token value extends past end of data");
+    }
+    tokens.push_back(Token(type, data.substr(offset, value_size),
+                           static_cast<int64_t>(lineno),
+                           static_cast<int64_t>(colno)));
+    offset += value_size;
+  }
+  return Parser::ParsePackageFromTokens(std::move(tokens), filename);
+}
+
+absl::StatusOr<std::unique_ptr<Package>> ParsePackageAnyFormat(
+    absl::string_view data, std::optional<absl::string_view> filename) {
+  if (IsBinaryPackage(data)) {
+    return ParseBinaryPackage(data, filename);
+  }
+  return Parser::ParsePackage(data, filename);
+}
+
+}  // namespace xls
@@ -0,0 +1,61 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_IR_IR_BINARY_H_
+#define XLS_IR_IR_BINARY_H_
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xls/ir/package.h"
+
+namespace xls {
+
+// Support for a binary serialization of XLS IR packages. The format stores
+// the pre-scanned token stream of the canonical text format in a compact
+// length-prefixed encoding, so loading a binary artifact skips the scanner --
+// the dominant per-byte cost when loading very large .ir files -- and feeds
+// tokens straight into the parser. The format is a cache/interchange format
+// between pipeline stages, not a stable archival format; readers reject
+// version mismatches.
+
+// Returns true if `data` begins with the binary-package magic number.
+bool IsBinaryPackage(absl::string_view data);
+
+// Serializes the given package into the binary format.
+std::string SerializePackageToBinary(const Package& package);
+
+// As above, but serializes IR already in text form without constructing a
+// Package. Useful for tools which hold the text output of a previous stage.
+absl::StatusOr<std::string> SerializeIrTextToBinary(absl::string_view ir_text);
+
+// Deserializes a binary-format package. `filename` is used for error messages
+// only.
+absl::StatusOr<std::unique_ptr<Package>> ParseBinaryPackage(
+    absl::string_view data,
+    std::optional<absl::string_view> filename = std::nullopt);
+
+// Parses `data` as a binary package if it carries the binary magic number and
+// as text IR otherwise. Tools which accept intermediate artifacts should load
+// through this entry point.
+absl::StatusOr<std::unique_ptr<Package>> ParsePackageAnyFormat(
+    absl::string_view data,
+    std::optional<absl::string_view> filename = std::nullopt);
+
+}  // namespace xls
+
+#endif  // XLS_IR_IR_BINARY_H_
@@ -0,0 +1,70 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/ir_binary.h"
+
+#include <memory>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/ir_parser.h"
+
+namespace xls {
+namespace {
+
+using status_testing::StatusIs;
+
+constexpr const char kSimplePackage[] = R"(package binary_test
+
+top fn add_wrap(x: bits[8], y: bits[8]) -> bits[8] {
+  ret add.3: bits[8] = add(x, y, id=3)
+}
+)";
+
+TEST(IrBinaryTest, RoundTrip) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> package,
+                           Parser::ParsePackage(kSimplePackage));
+  std::string binary = SerializePackageToBinary(*package);
+  ASSERT_TRUE(IsBinaryPackage(binary));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> reloaded,
+                           ParseBinaryPackage(binary));
+  EXPECT_EQ(reloaded->DumpIr(), package->DumpIr());
+}
+
+TEST(IrBinaryTest, TextIsNotBinary) {
+  EXPECT_FALSE(IsBinaryPackage(kSimplePackage));
+}
+
+TEST(IrBinaryTest, AnyFormatAcceptsBoth) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> package,
+                           ParsePackageAnyFormat(kSimplePackage));
+  std::string binary = SerializePackageToBinary(*package);
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> reloaded,
+                           ParsePackageAnyFormat(binary));
+  EXPECT_EQ(reloaded->DumpIr(), package->DumpIr());
+}
+
+TEST(IrBinaryTest, CorruptPayloadIsRejected) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> package,
+                           Parser::ParsePackage(kSimplePackage));
+  std::string binary = SerializePackageToBinary(*package);
+  binary.resize(binary.size() / 2);
+  EXPECT_THAT(ParseBinaryPackage(binary).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace xls
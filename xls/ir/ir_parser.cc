@@ -43,7 +43,7 @@ absl::Status Parser::ParseKeywordArguments(
     XLS_ASSIGN_OR_RETURN(Token name,
                          scanner_.PopKeywordOrIdentToken("argument"));
     XLS_RETURN_IF_ERROR(scanner_.DropTokenOrError(LexicalTokenType::kEquals));
-    if (!seen_keywords.insert(name.value()).second) {
+    if (!seen_keywords.insert(std::string(name.value())).second) {
       return absl::InvalidArgumentError(
           absl::StrFormat("Duplicate keyword argument `%s` @ %s", name.value(),
                           name.pos().ToHumanString()));
@@ -85,7 +85,7 @@ absl::StatusOr<std::vector<Parser::TypedArgument>> Parser::ParseTypedArguments(
                            scanner_.PopTokenOrError(LexicalTokenType::kIdent));
       XLS_RETURN_IF_ERROR(scanner_.DropTokenOrError(LexicalTokenType::kColon));
       XLS_ASSIGN_OR_RETURN(Type * type, ParseType(package));
-      args.push_back(TypedArgument{name.value(), type, name});
+      args.push_back(TypedArgument{std::string(name.value()), type, name});
     } while (scanner_.TryDropToken(LexicalTokenType::kComma));
   }
   return args;
@@ -352,7 +352,7 @@ absl::StatusOr<std::string> Parser::ParseIdentifier(TokenPos* pos) {
   if (pos != nullptr) {
     *pos = token.pos();
   }
-  return token.value();
+  return std::string(token.value());
 }
 
 absl::StatusOr<std::string> Parser::ParseQuotedString(TokenPos* pos) {
@@ -361,7 +361,7 @@ absl::StatusOr<std::string> Parser::ParseQuotedString(TokenPos* pos) {
   if (pos != nullptr) {
     *pos = token.pos();
   }
-  return token.value();
+  return std::string(token.value());
 }
 
 absl::StatusOr<BValue> Parser::ParseAndResolveIdentifier(
@@ -657,7 +657,9 @@ absl::StatusOr<BValue> Parser::ParseNode(
   // should be given when constructing the node as the name is autogenerated
   // (the node has no meaningful given name). Otherwise, output_name is the
   // name of the node.
-  std::string node_name = split_name.has_value() ? "" : output_name.value();
+  std::string node_name = split_name.has_value()
+                              ? std::string()
+                              : std::string(output_name.value());
 
   std::vector<BValue> operands;
   switch (op) {
@@ -1614,7 +1616,7 @@ absl::StatusOr<Parser::BlockSignature> Parser::ParseBlockSignature(
     if (!scanner_.TryDropKeyword("clock")) {
       XLS_ASSIGN_OR_RETURN(type, ParseType(package));
     }
-    signature.ports.push_back(Port{port_name.value(), type});
+    signature.ports.push_back(Port{std::string(port_name.value()), type});
     must_end = !scanner_.TryDropToken(LexicalTokenType::kComma);
   }
 
@@ -1629,7 +1631,7 @@ absl::StatusOr<std::string> Parser::ParsePackageName() {
   XLS_ASSIGN_OR_RETURN(
       Token package_name,
       scanner_.PopTokenOrError(LexicalTokenType::kIdent, "package name"));
-  return package_name.value();
+  return std::string(package_name.value());
 }
 
 absl::Status Parser::ParseFileNumber(Package* package) {
@@ -1867,7 +1869,8 @@ absl::StatusOr<Channel*> Parser::ParseChannel(Package* package) {
         scanner_.PopTokenOrError(LexicalTokenType::kQuotedString));
     ChannelMetadataProto proto;
     bool success =
-        google::protobuf::TextFormat::ParseFromString(metadata_token.value(), &proto);
+        google::protobuf::TextFormat::ParseFromString(
+            std::string(metadata_token.value()), &proto);
     if (!success) {
       return absl::InvalidArgumentError(
           absl::StrFormat("Invalid channel metadata @ %s",
@@ -2060,6 +2063,17 @@ absl::StatusOr<std::unique_ptr<Package>> Parser::ParsePackageWithEntry(
   return package;
 }
 
+/* static */
+absl::StatusOr<std::unique_ptr<Package>> Parser::ParsePackageFromTokens(
+    std::vector<Token> tokens, std::optional<absl::string_view> filename) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                       ParseDerivedPackageNoVerifyFromScanner<Package>(
+                           Scanner::CreateFromTokens(std::move(tokens)),
+                           filename, /*entry=*/absl::nullopt));
+  XLS_RETURN_IF_ERROR(VerifyAndSwapError(package.get()));
+  return package;
+}
+
 /* static */
 absl::StatusOr<std::unique_ptr<Package>> Parser::ParsePackageNoVerify(
     absl::string_view input_string, std::optional<absl::string_view> filename,
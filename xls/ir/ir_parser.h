@@ -87,6 +87,12 @@ class Parser {
   static absl::StatusOr<Type*> ParseType(absl::string_view input_string,
                                          Package* package);
 
+  // Parses a package from an already-scanned token stream, as produced by
+  // the binary IR deserializer (see ir_binary.h). Bypasses the scanner.
+  static absl::StatusOr<std::unique_ptr<Package>> ParsePackageFromTokens(
+      std::vector<Token> tokens,
+      std::optional<absl::string_view> filename = absl::nullopt);
+
   // Parses the given input string as a package skipping verification. This
   // should only be used in tests when malformed IR is desired.
   static absl::StatusOr<std::unique_ptr<Package>> ParsePackageNoVerify(
@@ -102,6 +108,13 @@ class Parser {
       std::optional<absl::string_view> filename = absl::nullopt,
       std::optional<absl::string_view> entry = absl::nullopt);
 
+  // As above, but parses from the given scanner rather than from text.
+  template <typename PackageT>
+  static absl::StatusOr<std::unique_ptr<PackageT>>
+  ParseDerivedPackageNoVerifyFromScanner(
+      Scanner scanner, std::optional<absl::string_view> filename = absl::nullopt,
+      std::optional<absl::string_view> entry = absl::nullopt);
+
   // Parses a literal value that should be of type "expected_type" and returns
   // it.
   static absl::StatusOr<Value> ParseValue(absl::string_view input_string,
@@ -298,8 +311,17 @@ template <typename PackageT>
 absl::StatusOr<std::unique_ptr<PackageT>> Parser::ParseDerivedPackageNoVerify(
     absl::string_view input_string, std::optional<absl::string_view> filename,
     std::optional<absl::string_view> entry) {
-  std::optional<Token> previous_top_token;
   XLS_ASSIGN_OR_RETURN(auto scanner, Scanner::Create(input_string));
+  return ParseDerivedPackageNoVerifyFromScanner<PackageT>(std::move(scanner),
+                                                          filename, entry);
+}
+
+template <typename PackageT>
+absl::StatusOr<std::unique_ptr<PackageT>>
+Parser::ParseDerivedPackageNoVerifyFromScanner(
+    Scanner scanner, std::optional<absl::string_view> filename,
+    std::optional<absl::string_view> entry) {
+  std::optional<Token> previous_top_token;
   Parser parser(std::move(scanner));
 
   XLS_ASSIGN_OR_RETURN(std::string package_name, parser.ParsePackageName());
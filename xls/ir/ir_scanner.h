@@ -90,7 +90,12 @@ class Token {
       : type_(type), value_(value), pos_({lineno, colno}) {}
 
   LexicalTokenType type() const { return type_; }
-  const std::string& value() const { return value_; }
+
+  // The token's value is a view into the text handed to the tokenizer (or the
+  // buffer backing Scanner::CreateFromTokens); the backing text must outlive
+  // the token. Keeping a view rather than a copy avoids millions of
+  // short-lived string allocations when scanning large packages.
+  absl::string_view value() const { return value_; }
   const TokenPos& pos() const { return pos_; }
 
   // Returns the token as a (u)int64_t value. Token must be a literal. The
@@ -114,7 +119,7 @@ class Token {
 
  private:
   LexicalTokenType type_;
-  std::string value_;
+  absl::string_view value_;
   TokenPos pos_;
 };
 
@@ -133,6 +138,13 @@ class Scanner {
  public:
   static absl::StatusOr<Scanner> Create(absl::string_view text);
 
+  // Creates a scanner over an already-materialized token stream, e.g. one
+  // deserialized from the binary IR format (see ir_binary.h). Skips
+  // tokenization entirely.
+  static Scanner CreateFromTokens(std::vector<Token> tokens) {
+    return Scanner(std::move(tokens));
+  }
+
   // Peeks at the next token in the token stream, or returns an error if we're
   // at EOF and no more tokens are available.
   absl::StatusOr<Token> PeekToken() const;
@@ -32,7 +32,7 @@ using testing::HasSubstr;
 std::vector<std::string> TokensToStrings(absl::Span<const Token> tokens) {
   std::vector<std::string> strs;
   for (const Token& token : tokens) {
-    strs.push_back(token.value());
+    strs.push_back(std::string(token.value()));
   }
   return strs;
 }
@@ -21,6 +21,42 @@
 
 namespace xls {
 
+/* static */ absl::StatusOr<KeywordArgBinding> KeywordArgBinding::Create(
+    const FunctionBase& function, absl::Span<const std::string> keywords) {
+  if (keywords.size() != function.params().size()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Got %d keyword arguments for invocation of function '%s' which has "
+        "%d parameters",
+        keywords.size(), function.name(), function.params().size()));
+  }
+  std::vector<int64_t> param_index_of_keyword;
+  param_index_of_keyword.reserve(keywords.size());
+  std::vector<bool> bound(function.params().size(), false);
+  for (const std::string& keyword : keywords) {
+    XLS_ASSIGN_OR_RETURN(Param * param, function.GetParamByName(keyword));
+    XLS_ASSIGN_OR_RETURN(int64_t param_index, function.GetParamIndex(param));
+    if (bound[param_index]) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Duplicate argument '%s' to invocation of function '%s'", keyword,
+          function.name()));
+    }
+    bound[param_index] = true;
+    param_index_of_keyword.push_back(param_index);
+  }
+  return KeywordArgBinding(std::move(param_index_of_keyword));
+}
+
+std::vector<Value> KeywordArgBinding::Bind(
+    absl::Span<const Value> values) const {
+  XLS_CHECK_EQ(values.size(), param_index_of_keyword_.size());
+  std::vector<Value> positional_args;
+  positional_args.resize(values.size());
+  for (int64_t i = 0; i < values.size(); ++i) {
+    positional_args[param_index_of_keyword_[i]] = values[i];
+  }
+  return positional_args;
+}
+
 absl::StatusOr<std::vector<Value>> KeywordArgsToPositional(
     const FunctionBase& function,
     const absl::flat_hash_map<std::string, Value>& kwargs) {
@@ -37,16 +73,18 @@ absl::StatusOr<std::vector<Value>> KeywordArgsToPositional(
     }
   }
 
-  std::vector<Value> positional_args;
-  positional_args.resize(kwargs.size());
+  std::vector<std::string> keywords;
+  std::vector<Value> values;
+  keywords.reserve(kwargs.size());
+  values.reserve(kwargs.size());
   for (const auto& pair : kwargs) {
     XLS_VLOG(2) << "  " << pair.first << " = " << pair.second;
-    XLS_ASSIGN_OR_RETURN(Param * param, function.GetParamByName(pair.first));
-    XLS_ASSIGN_OR_RETURN(int64_t param_index, function.GetParamIndex(param));
-    positional_args.at(param_index) = pair.second;
+    keywords.push_back(pair.first);
+    values.push_back(pair.second);
   }
-
-  return positional_args;
+  XLS_ASSIGN_OR_RETURN(KeywordArgBinding binding,
+                       KeywordArgBinding::Create(function, keywords));
+  return binding.Bind(values);
 }
 
 }  // namespace xls
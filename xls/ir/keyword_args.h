@@ -19,11 +19,38 @@
 #include <vector>
 
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "xls/ir/function.h"
 #include "xls/ir/value.h"
 
 namespace xls {
 
+// Precompiled binding from a fixed keyword order to the positional parameter
+// order of a function. Create() resolves each keyword to its parameter index
+// once; Bind() then places values by index without touching the parameter
+// names. Interpreters invoking the same call site in a loop should build the
+// binding once and call Bind() per invocation rather than rebuilding a
+// name-to-value map each time.
+class KeywordArgBinding {
+ public:
+  // Creates a binding for the given function. 'keywords' must name each
+  // parameter of 'function' exactly once (in any order).
+  static absl::StatusOr<KeywordArgBinding> Create(
+      const FunctionBase& function, absl::Span<const std::string> keywords);
+
+  // Binds 'values', given in the keyword order passed to Create(), to
+  // positional argument order. CHECK fails if the number of values does not
+  // match the number of keywords.
+  std::vector<Value> Bind(absl::Span<const Value> values) const;
+
+ private:
+  explicit KeywordArgBinding(std::vector<int64_t> param_index_of_keyword)
+      : param_index_of_keyword_(std::move(param_index_of_keyword)) {}
+
+  // The i-th element is the parameter index bound by the i-th keyword.
+  std::vector<int64_t> param_index_of_keyword_;
+};
+
 // Converts the given set of keyword args for the given function into a vector
 // of positional arguments.
 absl::StatusOr<std::vector<Value>> KeywordArgsToPositional(
@@ -0,0 +1,94 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/keyword_args.h"
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+
+namespace xls {
+namespace {
+
+using status_testing::IsOkAndHolds;
+using status_testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+class KeywordArgsTest : public IrTestBase {
+ protected:
+  // Builds a function with 32-bit parameters "x", "y", and "z".
+  absl::StatusOr<Function*> BuildTestFunction(Package* p) {
+    FunctionBuilder fb("f", p);
+    BValue x = fb.Param("x", p->GetBitsType(32));
+    BValue y = fb.Param("y", p->GetBitsType(32));
+    BValue z = fb.Param("z", p->GetBitsType(32));
+    return fb.BuildWithReturnValue(fb.Add(fb.Add(x, y), z));
+  }
+
+  Value V(uint64_t v) { return Value(UBits(v, 32)); }
+};
+
+TEST_F(KeywordArgsTest, BindingResolvesByIndex) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, BuildTestFunction(p.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      KeywordArgBinding binding,
+      KeywordArgBinding::Create(*f,
+                                std::vector<std::string>{"z", "x", "y"}));
+  // Values are given in keyword order and come back in parameter order. The
+  // binding is reusable across calls.
+  EXPECT_THAT(binding.Bind({V(3), V(1), V(2)}),
+              ElementsAre(V(1), V(2), V(3)));
+  EXPECT_THAT(binding.Bind({V(30), V(10), V(20)}),
+              ElementsAre(V(10), V(20), V(30)));
+}
+
+TEST_F(KeywordArgsTest, BindingErrors) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, BuildTestFunction(p.get()));
+  EXPECT_THAT(
+      KeywordArgBinding::Create(*f, std::vector<std::string>{"x", "y"})
+          .status(),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("Got 2 keyword arguments")));
+  EXPECT_THAT(
+      KeywordArgBinding::Create(*f, std::vector<std::string>{"x", "y", "w"})
+          .status(),
+      StatusIs(absl::StatusCode::kNotFound));
+  EXPECT_THAT(
+      KeywordArgBinding::Create(*f, std::vector<std::string>{"x", "y", "y"})
+          .status(),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("Duplicate argument 'y'")));
+}
+
+TEST_F(KeywordArgsTest, KeywordArgsToPositional) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, BuildTestFunction(p.get()));
+  EXPECT_THAT(KeywordArgsToPositional(
+                  *f, {{"y", V(2)}, {"z", V(3)}, {"x", V(1)}}),
+              IsOkAndHolds(ElementsAre(V(1), V(2), V(3))));
+  EXPECT_THAT(KeywordArgsToPositional(*f, {{"x", V(1)}, {"y", V(2)}}).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Missing argument 'z'")));
+}
+
+}  // namespace
+}  // namespace xls
@@ -14,6 +14,9 @@
 
 #include "xls/ir/node.h"
 
+#include <algorithm>
+#include <new>
+
 #include "absl/algorithm/container.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -21,6 +24,7 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "xls/common/allocation_accounting.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
@@ -42,13 +46,29 @@ Node::Node(Op op, Type* type, const SourceInfo& loc, absl::string_view name,
       op_(op),
       type_(type),
       loc_(loc),
-      name_(name.empty() ? "" : function_base_->UniquifyNodeName(name)) {}
+      name_(name) {
+  // Accounts the base object only; operand and name storage is attributed to
+  // the allocator traffic of their own containers.
+  XLS_RECORD_ALLOCATION(AllocationCategory::kNode,
+                        static_cast<int64_t>(sizeof(Node)));
+  // Params and ports expose their name through a raw accessor and are looked
+  // up in name-keyed tables, so their names are materialized eagerly as they
+  // always were. All other nodes materialize lazily in GetName().
+  if (!name_.empty() &&
+      (op_ == Op::kParam || op_ == Op::kInputPort || op_ == Op::kOutputPort)) {
+    name_ = function_base_->UniquifyNodeName(name_);
+    name_materialized_ = true;
+  }
+}
 
 void Node::AddOperand(Node* operand) {
+  function_base()->RecordGraphChange();
   XLS_VLOG(3) << " Adding operand " << operand->GetName() << " as #"
               << operands_.size() << " operand of " << GetName();
   operands_.push_back(operand);
-  operand->AddUser(this);
+  Use* use = NewUse();
+  operand->LinkUse(use);
+  operand_uses_.push_back(use);
   XLS_VLOG(3) << " " << operand->GetName()
               << " user now: " << operand->GetUsersString();
 }
@@ -72,10 +92,71 @@ absl::Status Node::AddNodeToFunctionAndReplace(
   return ReplaceUsesWith(replacement_ptr);
 }
 
-void Node::AddUser(Node* user) { users_.insert(user); }
+Node::Use* Node::NewUse() {
+  // Use records share the node arena: they have the same lifetime as the
+  // nodes whose operand slots they belong to, and arena allocation keeps
+  // their addresses stable for the intrusive links.
+  return new (package()->node_arena().Allocate(sizeof(Use)))
+      Use{/*user=*/this};
+}
 
-void Node::RemoveUser(Node* user) {
-  XLS_CHECK_EQ(users_.erase(user), 1) << GetName();
+void Node::LinkUse(Use* use) {
+  Node* user = use->user;
+  // If the user already refers to this node from another operand slot, splice
+  // next to that edge so all of a user's edges stay adjacent; otherwise push
+  // at the front of the chain and count a new distinct user. The scan is over
+  // the user's (typically few) operands, not over this node's users.
+  Use* sibling = nullptr;
+  for (int64_t i = 0; i < static_cast<int64_t>(user->operand_uses_.size());
+       ++i) {
+    if (user->operands_[i] == this && user->operand_uses_[i] != use) {
+      sibling = user->operand_uses_[i];
+      break;
+    }
+  }
+  if (sibling == nullptr) {
+    use->prev = nullptr;
+    use->next = first_use_;
+    if (first_use_ != nullptr) {
+      first_use_->prev = use;
+    }
+    first_use_ = use;
+    ++user_count_;
+  } else {
+    use->prev = sibling;
+    use->next = sibling->next;
+    if (sibling->next != nullptr) {
+      sibling->next->prev = use;
+    }
+    sibling->next = use;
+  }
+}
+
+void Node::UnlinkUse(Use* use) {
+  // Because same-user edges are adjacent, whether this is the user's last
+  // edge on this node is a purely local test.
+  bool last_edge_of_user =
+      (use->prev == nullptr || use->prev->user != use->user) &&
+      (use->next == nullptr || use->next->user != use->user);
+  if (last_edge_of_user) {
+    --user_count_;
+    if (user_count_ == 0) {
+      // The node may now be dead; let dead code elimination know so it does
+      // not have to scan for garbage.
+      function_base()->AddDeadNodeCandidate(this);
+    }
+  }
+  if (use->prev != nullptr) {
+    use->prev->next = use->next;
+  } else {
+    XLS_DCHECK(first_use_ == use);
+    first_use_ = use->next;
+  }
+  if (use->next != nullptr) {
+    use->next->prev = use->prev;
+  }
+  use->prev = nullptr;
+  use->next = nullptr;
 }
 
 absl::Status Node::VisitSingleNode(DfsVisitor* visitor) {
@@ -327,35 +408,76 @@ absl::Status Node::VisitSingleNode(DfsVisitor* visitor) {
   return absl::OkStatus();
 }
 
+namespace {
+
+// Builds the error for a cycle discovered during traversal. 'start' is a node
+// marked as traversing which was reached again through its operands; the cycle
+// is reconstructed by walking traversing operands until arriving back at
+// 'start'.
+absl::Status CycleDetectedError(Node* start, DfsVisitor* visitor) {
+  std::vector<std::string> cycle_names = {start->GetName()};
+  Node* node = start;
+  do {
+    bool broke = false;
+    for (Node* operand : node->operands()) {
+      if (visitor->IsTraversing(operand)) {
+        node = operand;
+        broke = true;
+        break;
+      }
+    }
+    XLS_CHECK(broke);
+    cycle_names.push_back(node->GetName());
+  } while (node != start);
+  return absl::InternalError(absl::StrFormat(
+      "Cycle detected: [%s]", absl::StrJoin(cycle_names, " -> ")));
+}
+
+}  // namespace
+
 absl::Status Node::Accept(DfsVisitor* visitor) {
   if (visitor->IsVisited(this)) {
     return absl::OkStatus();
   }
   if (visitor->IsTraversing(this)) {
-    std::vector<std::string> cycle_names = {GetName()};
-    Node* node = this;
-    do {
-      bool broke = false;
-      for (Node* operand : node->operands()) {
-        if (visitor->IsTraversing(operand)) {
-          node = operand;
-          broke = true;
-          break;
-        }
-      }
-      XLS_CHECK(broke);
-      cycle_names.push_back(node->GetName());
-    } while (node != this);
-    return absl::InternalError(absl::StrFormat(
-        "Cycle detected: [%s]", absl::StrJoin(cycle_names, " -> ")));
+    return CycleDetectedError(this, visitor);
   }
+  // Iterate with an explicit stack of (node, next operand index) frames rather
+  // than recursing: deep chains (e.g. long concat or select towers) would
+  // otherwise overflow the call stack. The stack storage lives on the visitor
+  // so repeated traversals reuse its allocation.
+  std::vector<DfsVisitor::AcceptFrame>& stack = visitor->accept_stack();
+  XLS_DCHECK(stack.empty());
   visitor->SetTraversing(this);
-  for (Node* operand : operands()) {
-    XLS_RETURN_IF_ERROR(operand->Accept(visitor));
+  stack.push_back({this, 0});
+  while (!stack.empty()) {
+    DfsVisitor::AcceptFrame& frame = stack.back();
+    if (frame.operand_index < frame.node->operand_count()) {
+      Node* operand = frame.node->operand(frame.operand_index++);
+      if (visitor->IsVisited(operand)) {
+        continue;
+      }
+      if (visitor->IsTraversing(operand)) {
+        absl::Status status = CycleDetectedError(operand, visitor);
+        stack.clear();
+        return status;
+      }
+      visitor->SetTraversing(operand);
+      stack.push_back({operand, 0});
+      continue;
+    }
+    // All operands handled; visit the node itself post-order.
+    Node* node = frame.node;
+    stack.pop_back();
+    visitor->UnsetTraversing(node);
+    visitor->MarkVisited(node);
+    absl::Status status = node->VisitSingleNode(visitor);
+    if (!status.ok()) {
+      stack.clear();
+      return status;
+    }
   }
-  visitor->UnsetTraversing(this);
-  visitor->MarkVisited(this);
-  return VisitSingleNode(visitor);
+  return absl::OkStatus();
 }
 
 bool Node::IsDefinitelyEqualTo(const Node* other) const {
@@ -386,20 +508,29 @@ bool Node::IsDefinitelyEqualTo(const Node* other) const {
 }
 
 std::string Node::GetName() const {
-  if (!name_.empty()) {
-    return name_;
+  if (name_.empty()) {
+    // Return a generated name based on the id.
+    return absl::StrFormat("%s.%d", OpToString(op()), id());
   }
-  // Return a generated name based on the id.
-  return absl::StrFormat("%s.%d", OpToString(op()), id());
+  if (!name_materialized_) {
+    // Assigned names are stored as given and materialized on first use;
+    // registering only the names which are actually read keeps name
+    // uniquification off the hot path of clone-heavy passes.
+    name_ = function_base()->UniquifyNodeName(name_);
+    name_materialized_ = true;
+  }
+  return name_;
 }
 
 void Node::SetName(absl::string_view name) {
-  name_ = function_base()->UniquifyNodeName(name);
+  name_ = std::string(name);
+  name_materialized_ = false;
 }
 
 void Node::ClearName() {
   XLS_CHECK(!Is<Param>());
   name_ = "";
+  name_materialized_ = false;
 }
 
 std::string Node::ToStringInternal(bool include_operand_types) const {
@@ -625,11 +756,18 @@ std::string Node::GetOperandsString() const {
 }
 
 std::string Node::GetUsersString() const {
-  return absl::StrFormat("[%s]", absl::StrJoin(users_, ", ", NodeFormatter));
+  // Sort by id for stable debug output; the use chain itself is in link
+  // order.
+  std::vector<Node*> sorted_users(users().begin(), users().end());
+  std::sort(sorted_users.begin(), sorted_users.end(), NodeIdLessThan());
+  return absl::StrFormat("[%s]",
+                         absl::StrJoin(sorted_users, ", ", NodeFormatter));
 }
 
 bool Node::HasUser(const Node* target) const {
-  return users_.contains(const_cast<Node*>(target));
+  // Cheaper than walking this node's use chain: target is a user exactly if
+  // this node appears among target's (typically few) operands.
+  return target->HasOperand(this);
 }
 
 bool Node::IsDead() const {
@@ -657,16 +795,9 @@ int64_t Node::OperandInstanceCount(const Node* target) const {
 }
 
 void Node::SetId(int64_t id) {
-  // The data structure (btree) containing the users of each node is sorted by
-  // node id. To avoid violating invariants of the data structure, remove this
-  // node from all users lists, change id, then read to users list.
-  for (Node* operand : operands()) {
-    operand->users_.erase(this);
-  }
+  // Use chains are keyed by node identity rather than id, so the users of
+  // this node's operands need no updating.
   id_ = id;
-  for (Node* operand : operands()) {
-    operand->users_.insert(this);
-  }
   package()->set_next_node_id(std::max(id + 1, package()->next_node_id()));
 }
 
@@ -683,18 +814,22 @@ bool Node::ReplaceOperand(Node* old_operand, Node* new_operand) {
   if (this == new_operand) {
     return true;
   }
+  function_base()->RecordGraphChange();
   bool did_replace = false;
   for (int64_t i = 0; i < operand_count(); ++i) {
     if (operands_[i] == old_operand) {
-      if (!did_replace && new_operand != nullptr) {
-        // Now we know we're definitely using this new operand.
-        new_operand->AddUser(this);
+      // Move the slot's use edge from the old operand's chain to the new
+      // operand's.
+      if (old_operand != nullptr) {
+        old_operand->UnlinkUse(operand_uses_[i]);
       }
-      did_replace = true;
       operands_[i] = new_operand;
+      if (new_operand != nullptr) {
+        new_operand->LinkUse(operand_uses_[i]);
+      }
+      did_replace = true;
     }
   }
-  old_operand->RemoveUser(this);
   return did_replace;
 }
 
@@ -707,18 +842,13 @@ absl::Status Node::ReplaceOperandNumber(int64_t operand_no, Node* new_operand,
         << " new operand type: " << new_operand->GetType()->ToString();
   }
 
-  // AddUser is idempotent so even if the new operand is already used by this
-  // node in another operand slot, it is safe to call.
-  new_operand->AddUser(this);
+  // Relinking the slot's use edge keeps the distinct-user counts of both the
+  // old and new operand correct even when either is used by this node in
+  // other operand slots.
+  function_base()->RecordGraphChange();
+  old_operand->UnlinkUse(operand_uses_[operand_no]);
   operands_[operand_no] = new_operand;
-
-  for (Node* operand : operands()) {
-    if (operand == old_operand) {
-      return absl::OkStatus();
-    }
-  }
-  // old_operand is no longer an operand of this node.
-  old_operand->RemoveUser(this);
+  new_operand->LinkUse(operand_uses_[operand_no]);
   return absl::OkStatus();
 }
 
@@ -741,8 +871,11 @@ absl::Status Node::ReplaceUsesWith(Node* replacement) {
   // move the name because we cannot clear the name of a parameter node.
   if (!Is<Param>() && HasAssignedName() && !replacement->HasAssignedName()) {
     // Do not use SetName because we do not want the name to be uniqued which
-    // would add a suffix because (clearly) the name already exists.
+    // would add a suffix because (clearly) the name already exists. The
+    // materialized bit moves with the name so an already-uniquified name is
+    // not uniquified a second time.
     replacement->name_ = name_;
+    replacement->name_materialized_ = name_materialized_;
     ClearName();
   }
   return absl::OkStatus();
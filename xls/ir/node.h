@@ -15,12 +15,13 @@
 #ifndef XLS_IR_NODE_H_
 #define XLS_IR_NODE_H_
 
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <string>
 #include <utility>
 #include <vector>
 
-#include "absl/container/btree_set.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -30,6 +31,7 @@
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/bits.h"
+#include "xls/ir/node_arena.h"
 #include "xls/ir/op.h"
 #include "xls/ir/source_location.h"
 #include "xls/ir/type.h"
@@ -51,6 +53,21 @@ class Node {
  public:
   virtual ~Node() = default;
 
+  // Nodes are allocated out of the NodeArena owned by the package they belong
+  // to (see Package::node_arena) via this placement form:
+  //
+  //   new (package->node_arena()) UnOp(...)
+  //
+  // The plain form is deleted to make sure no node is accidentally allocated
+  // off-arena. Ordinary deletion only runs the destructor; the underlying
+  // storage is reclaimed wholesale when the arena is torn down.
+  void* operator new(std::size_t size, NodeArena& arena) {
+    return arena.Allocate(static_cast<int64_t>(size));
+  }
+  void operator delete(void* ptr, NodeArena& arena) {}
+  void operator delete(void* ptr) {}
+  void* operator new(std::size_t size) = delete;
+
   // Accepts the visitor, instructing it to visit this node.
   //
   // The visitor is instructed to visit this node with:
@@ -121,8 +138,10 @@ class Node {
 
   // Swaps the operands at indices 'a' and 'b' in the operands sequence.
   void SwapOperands(int64_t a, int64_t b) {
-    // Operand/user chains already set up properly.
+    // Operand/user chains already set up properly; swap the use edges along
+    // with the operands so each slot stays paired with its edge.
     std::swap(operands_[a], operands_[b]);
+    std::swap(operand_uses_[a], operand_uses_[b]);
   }
 
   // Returns true if analysis indicates that this node always produces the
@@ -156,11 +175,14 @@ class Node {
   bool HasAssignedName() const { return !name_.empty(); }
 
   // Returns name of this node. If not assigned at construction time, the name
-  // is generated from the opcode and unique id (e.g. "add.2");
+  // is generated from the opcode and unique id (e.g. "add.2"). An assigned
+  // name is materialized -- sanitized and uniquified within the function --
+  // by the first call; see the comment on name_.
   std::string GetName() const;
 
   // Sets the name of this node. After this method is called. HasAssignedName
-  // will return true.
+  // will return true. The name is stored as given; it is sanitized and
+  // uniquified lazily by GetName.
   void SetName(absl::string_view name);
 
   // Clears the name of this node. The node will have a generate name based on
@@ -196,8 +218,79 @@ class Node {
     }
   };
 
-  // Returns the unique set of users of this node sorted by id.
-  const absl::btree_set<Node*, NodeIdLessThan>& users() const { return users_; }
+  // An edge of the def-use graph: records that `user` refers to the defining
+  // node in one of its operand slots. Every operand slot owns one Use record
+  // (arena-allocated, so the address is stable), and the uses of a node are
+  // threaded into an intrusive doubly-linked list rooted at the defining
+  // node. Edges belonging to the same user are kept adjacent in the chain so
+  // that iteration can de-duplicate users by looking only at neighbors.
+  struct Use {
+    Node* user = nullptr;
+    Use* prev = nullptr;
+    Use* next = nullptr;
+  };
+
+  // Forward iterator over the distinct users of a node. Walks the use chain
+  // and skips over consecutive edges from the same user (a node which uses
+  // the defining node in several operand slots is yielded once).
+  class UserIterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Node*;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Node* const*;
+    using reference = Node* const&;
+
+    Node* operator*() const { return use_->user; }
+    UserIterator& operator++() {
+      Node* current = use_->user;
+      do {
+        use_ = use_->next;
+      } while (use_ != nullptr && use_->user == current);
+      return *this;
+    }
+    UserIterator operator++(int) {
+      UserIterator copy = *this;
+      ++*this;
+      return copy;
+    }
+    bool operator==(const UserIterator& other) const {
+      return use_ == other.use_;
+    }
+    bool operator!=(const UserIterator& other) const {
+      return use_ != other.use_;
+    }
+
+   private:
+    friend class Node;
+    explicit UserIterator(const Use* use) : use_(use) {}
+    const Use* use_;
+  };
+
+  // Lightweight view over the distinct users of a node; supports range-for,
+  // empty() and (O(1)) size(). Iteration order is the order in which the use
+  // edges were linked (deterministic, but not sorted by id); callers needing
+  // a canonical order must sort explicitly.
+  class UsersView {
+   public:
+    using value_type = Node*;
+    using iterator = UserIterator;
+    using const_iterator = UserIterator;
+
+    UserIterator begin() const { return UserIterator(head_); }
+    UserIterator end() const { return UserIterator(nullptr); }
+    bool empty() const { return head_ == nullptr; }
+    int64_t size() const { return size_; }
+
+   private:
+    friend class Node;
+    UsersView(const Use* head, int64_t size) : head_(head), size_(size) {}
+    const Use* head_;
+    int64_t size_;
+  };
+
+  // Returns a view of the distinct users of this node.
+  UsersView users() const { return UsersView(first_use_, user_count_); }
 
   // Helper for querying whether "target" is a user of this node.
   bool HasUser(const Node* target) const;
@@ -244,7 +337,7 @@ class Node {
       FunctionBase* new_function) const = 0;
 
  protected:
-  // FunctionBase needs to be a friend to access RemoveUser for deleting nodes
+  // FunctionBase needs to be a friend to access UnlinkUse for deleting nodes
   // from the graph.
   friend class FunctionBase;
   // Block needs to be a friend to strongly name ports (guarantee name has no
@@ -273,20 +366,47 @@ class Node {
   absl::Status AddNodeToFunctionAndReplace(std::unique_ptr<Node> replacement);
 
  protected:
-  void AddUser(Node* user);
-  void RemoveUser(Node* user);
+  // Splices `use` (with its user field set) into this node's use list,
+  // keeping edges of the same user adjacent and maintaining the distinct-user
+  // count. The corresponding operand slot of the user must already refer to
+  // this node.
+  void LinkUse(Use* use);
+
+  // Removes `use` from this node's use list, decrementing the distinct-user
+  // count if it was the user's last edge on this node. The record itself is
+  // kept (arena-owned) and may be relinked, possibly into another node.
+  void UnlinkUse(Use* use);
+
+  // Returns a freshly arena-allocated use record naming this node as user.
+  Use* NewUse();
 
   FunctionBase* function_base_;
   int64_t id_;
   Op op_;
   Type* type_;
   SourceInfo loc_;
-  std::string name_;
+
+  // The name assigned to the node, or empty if none was assigned. Assigned
+  // names are stored exactly as given and materialized lazily: the first
+  // GetName() call sanitizes the name and uniquifies it within the function,
+  // caching the result here. Clone-heavy passes (inlining, unrolling) thereby
+  // never pay the uniquer for the many names which are never printed. Mutable
+  // because materialization happens on (const) read.
+  mutable std::string name_;
+  mutable bool name_materialized_ = false;
 
   std::vector<Node*> operands_;
 
-  // Set of users sorted by node_id for stability.
-  absl::btree_set<Node*, NodeIdLessThan> users_;
+  // Use records for this node's operand slots: operand_uses_[i] is the edge
+  // linking this node into operands_[i]'s use list.
+  std::vector<Use*> operand_uses_;
+
+  // Head of the intrusive list of uses of this node.
+  Use* first_use_ = nullptr;
+
+  // Number of distinct users in the use list (a user occupying several
+  // operand slots is counted once).
+  int64_t user_count_ = 0;
 };
 
 inline std::ostream& operator<<(std::ostream& os, const Node& node) {
@@ -0,0 +1,46 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/node_arena.h"
+
+#include <cstddef>
+
+#include "xls/common/logging/logging.h"
+#include "xls/common/math_util.h"
+
+namespace xls {
+
+void* NodeArena::Allocate(int64_t size) {
+  XLS_CHECK_GT(size, 0);
+  // Round each request up so the next bump-allocated object is suitably
+  // aligned for any Node subclass.
+  size = RoundUpToNearest<int64_t>(size, alignof(std::max_align_t));
+  absl::MutexLock lock(&mutex_);
+  if (size > kBlockSize) {
+    oversized_blocks_.push_back(std::make_unique<char[]>(size));
+    oversized_bytes_ += size;
+    return oversized_blocks_.back().get();
+  }
+  if (size > remaining_) {
+    blocks_.push_back(std::make_unique<char[]>(kBlockSize));
+    next_ = blocks_.back().get();
+    remaining_ = kBlockSize;
+  }
+  char* result = next_;
+  next_ += size;
+  remaining_ -= size;
+  return result;
+}
+
+}  // namespace xls
@@ -0,0 +1,64 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/node_arena.h"
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace xls {
+namespace {
+
+TEST(NodeArenaTest, AllocationsAreAlignedAndDistinct) {
+  NodeArena arena;
+  void* a = arena.Allocate(1);
+  void* b = arena.Allocate(17);
+  void* c = arena.Allocate(64);
+  EXPECT_NE(a, b);
+  EXPECT_NE(b, c);
+  for (void* p : {a, b, c}) {
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % alignof(std::max_align_t), 0);
+  }
+}
+
+TEST(NodeArenaTest, SequentialAllocationsAreContiguous) {
+  NodeArena arena;
+  char* a = static_cast<char*>(arena.Allocate(32));
+  char* b = static_cast<char*>(arena.Allocate(32));
+  EXPECT_EQ(b - a, 32);
+}
+
+TEST(NodeArenaTest, OversizedAllocation) {
+  NodeArena arena;
+  // Larger than any block; should be serviced without disturbing the bump
+  // pointer used by subsequent small allocations.
+  char* big = static_cast<char*>(arena.Allocate(1 << 20));
+  char* a = static_cast<char*>(arena.Allocate(16));
+  char* b = static_cast<char*>(arena.Allocate(16));
+  EXPECT_NE(big, nullptr);
+  EXPECT_EQ(b - a, 16);
+}
+
+TEST(NodeArenaTest, ManyAllocationsSpanBlocks) {
+  NodeArena arena;
+  int64_t before = arena.ReservedBytes();
+  for (int64_t i = 0; i < 10000; ++i) {
+    ASSERT_NE(arena.Allocate(128), nullptr);
+  }
+  EXPECT_GT(arena.ReservedBytes(), before);
+}
+
+}  // namespace
+}  // namespace xls
@@ -0,0 +1,130 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_IR_NODE_INDEXED_VECTOR_H_
+#define XLS_IR_NODE_INDEXED_VECTOR_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "xls/common/logging/logging.h"
+#include "xls/ir/function_base.h"
+#include "xls/ir/node.h"
+
+namespace xls {
+
+// A dense side table holding a T per Node, as a drop-in replacement for
+// absl::flat_hash_map<Node*, T> in analyses. Entries are indexed by Node::id(),
+// which is dense-ish within a package, so lookups are a single array index
+// rather than a hash and probe. The table grows on insertion, so nodes created
+// after construction (e.g. by lazily populated analyses) can be added like any
+// other.
+//
+// All nodes in a table must belong to the same FunctionBase; this is
+// DCHECKed, since a node from another function could otherwise silently alias
+// an entry with the same id.
+template <typename T>
+class NodeIndexedVector {
+ public:
+  NodeIndexedVector() = default;
+
+  // Constructs an empty table with capacity reserved for every node currently
+  // in 'f'.
+  explicit NodeIndexedVector(const FunctionBase* f) : func_base_(f) {
+    Reserve(f->package()->next_node_id());
+  }
+
+  // Returns the value for 'node', inserting a default-constructed value if the
+  // node has no entry.
+  T& operator[](const Node* node) {
+    if (func_base_ == nullptr) {
+      func_base_ = node->function_base();
+    }
+    int64_t id = Index(node);
+    if (id >= static_cast<int64_t>(values_.size())) {
+      Reserve(id + 1);
+    }
+    if (!present_[id]) {
+      present_[id] = 1;
+      ++size_;
+    }
+    return values_[id];
+  }
+
+  // A node from a different FunctionBase is never contained; this mirrors the
+  // behavior of a pointer-keyed hash map.
+  bool contains(const Node* node) const {
+    if (func_base_ != nullptr && node->function_base() != func_base_) {
+      return false;
+    }
+    int64_t id = node->id();
+    return id < static_cast<int64_t>(values_.size()) && present_[id] != 0;
+  }
+
+  const T& at(const Node* node) const {
+    XLS_DCHECK(contains(node)) << node->GetName();
+    return values_[Index(node)];
+  }
+  T& at(const Node* node) {
+    XLS_DCHECK(contains(node)) << node->GetName();
+    return values_[Index(node)];
+  }
+
+  // Removes the entry for 'node' if present. The slot keeps its capacity; the
+  // value is reset to a default-constructed T.
+  void erase(const Node* node) {
+    if (contains(node)) {
+      int64_t id = Index(node);
+      present_[id] = 0;
+      values_[id] = T();
+      --size_;
+    }
+  }
+
+  int64_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  void clear() {
+    values_.clear();
+    present_.clear();
+    size_ = 0;
+    func_base_ = nullptr;
+  }
+
+ private:
+  int64_t Index(const Node* node) const {
+    XLS_DCHECK_EQ(node->function_base(), func_base_)
+        << "Node " << node->GetName() << " is from a different FunctionBase";
+    return node->id();
+  }
+
+  void Reserve(int64_t capacity) {
+    values_.resize(capacity);
+    present_.resize(capacity, 0);
+  }
+
+  // The FunctionBase the keys belong to; bound at construction or on first
+  // insertion.
+  const FunctionBase* func_base_ = nullptr;
+
+  // Values and presence flags indexed by node id. A vector<uint8_t> is used
+  // rather than vector<bool> to keep the presence test a plain byte load.
+  std::vector<T> values_;
+  std::vector<uint8_t> present_;
+  int64_t size_ = 0;
+};
+
+}  // namespace xls
+
+#endif  // XLS_IR_NODE_INDEXED_VECTOR_H_
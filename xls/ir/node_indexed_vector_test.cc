@@ -0,0 +1,81 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/node_indexed_vector.h"
+
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+
+namespace xls {
+namespace {
+
+class NodeIndexedVectorTest : public IrTestBase {};
+
+TEST_F(NodeIndexedVectorTest, BasicMapSemantics) {
+  auto p = CreatePackage();
+  FunctionBuilder fb("f", p.get());
+  BValue x = fb.Param("x", p->GetBitsType(32));
+  BValue y = fb.Param("y", p->GetBitsType(32));
+  BValue sum = fb.Add(x, y);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.BuildWithReturnValue(sum));
+
+  NodeIndexedVector<std::string> table(f);
+  EXPECT_TRUE(table.empty());
+  EXPECT_FALSE(table.contains(x.node()));
+
+  table[x.node()] = "x-value";
+  table[sum.node()] = "sum-value";
+  EXPECT_EQ(table.size(), 2);
+  EXPECT_TRUE(table.contains(x.node()));
+  EXPECT_FALSE(table.contains(y.node()));
+  EXPECT_EQ(table.at(x.node()), "x-value");
+  EXPECT_EQ(table.at(sum.node()), "sum-value");
+
+  // operator[] on an existing entry does not change the size.
+  table[x.node()] = "updated";
+  EXPECT_EQ(table.size(), 2);
+  EXPECT_EQ(table.at(x.node()), "updated");
+
+  table.clear();
+  EXPECT_TRUE(table.empty());
+  EXPECT_FALSE(table.contains(x.node()));
+}
+
+TEST_F(NodeIndexedVectorTest, GrowsForNodesCreatedAfterConstruction) {
+  auto p = CreatePackage();
+  FunctionBuilder fb("f", p.get());
+  BValue x = fb.Param("x", p->GetBitsType(32));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.BuildWithReturnValue(x));
+
+  // Default-constructed table bound to the function on first insertion.
+  NodeIndexedVector<int64_t> table;
+  table[x.node()] = 1;
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Node * literal,
+      f->MakeNode<Literal>(SourceInfo(), Value(UBits(0, 32))));
+  EXPECT_FALSE(table.contains(literal));
+  table[literal] = 2;
+  EXPECT_EQ(table.size(), 2);
+  EXPECT_EQ(table.at(literal), 2);
+  EXPECT_EQ(table.at(x.node()), 1);
+}
+
+}  // namespace
+}  // namespace xls
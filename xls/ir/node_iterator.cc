@@ -23,7 +23,7 @@
 
 namespace xls {
 
-void NodeIterator::Initialize() {
+void NodeIterator::Initialize(bool forward) {
   // For topological traversal we only add nodes to the order when all of its
   // users have been scheduled.
   //
@@ -43,8 +43,8 @@ void NodeIterator::Initialize() {
   pending_to_remaining_users.reserve(f_->node_count());
   std::deque<Node*> ready;
 
-  ordered_ = std::make_unique<std::vector<Node*>>();
-  ordered_->reserve(f_->node_count());
+  auto ordered = std::make_shared<std::vector<Node*>>();
+  ordered->reserve(f_->node_count());
 
   auto is_scheduled = [&](Node* n) {
     auto it = pending_to_remaining_users.find(n);
@@ -74,7 +74,7 @@ void NodeIterator::Initialize() {
     XLS_VLOG(5) << "Adding node to order: " << r;
     XLS_DCHECK(all_users_scheduled(r))
         << r << " users size: " << r->users().size();
-    ordered_->push_back(r);
+    ordered->push_back(r);
 
     // We want to be careful to only bump down our operands once, since we're a
     // single user, even though we may refer to them multiple times in our
@@ -127,7 +127,7 @@ void NodeIterator::Initialize() {
     add_to_order(r);
   }
 
-  if (ordered_->size() < f_->node_count()) {
+  if (static_cast<int64_t>(ordered->size()) < f_->node_count()) {
     // Not all nodes have been placed indicating a cycle in the graph. Run a
     // trivial DFS visitor which will emit an error message displaying the
     // cycle.
@@ -140,6 +140,12 @@ void NodeIterator::Initialize() {
     XLS_CHECK_OK(f_->Accept(&cycle_checker));
     XLS_LOG(FATAL) << "Expected to find cycle in function base.";
   }
+
+  if (forward) {
+    // Initialize computes a reverse topological order.
+    std::reverse(ordered->begin(), ordered->end());
+  }
+  ordered_ = std::move(ordered);
 }
 
 }  // namespace xls
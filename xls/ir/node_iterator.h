@@ -15,6 +15,9 @@
 #ifndef XLS_IR_NODE_ITERATOR_H_
 #define XLS_IR_NODE_ITERATOR_H_
 
+#include <memory>
+#include <vector>
+
 #include "xls/ir/function_base.h"
 #include "xls/ir/node.h"
 
@@ -23,37 +26,63 @@ namespace xls {
 // A type that orders the reachable nodes in a function into a usable traversal
 // order. Currently just does a stable topological ordering.
 //
+// The computed (forward) ordering is cached on the FunctionBase and is
+// invalidated whenever the graph is mutated (see
+// FunctionBase::InvalidateTopoOrderCache), so repeated traversals of an
+// unchanged function -- the common case in a pass pipeline -- do not re-sort.
+//
 // Note that this container value must outlive any iterators derived from it
 // (via begin()/end()).
 class NodeIterator {
  public:
   static NodeIterator Create(FunctionBase* f) {
+    if (std::shared_ptr<const std::vector<Node*>> cached =
+            f->topo_order_cache()) {
+      return NodeIterator(f, std::move(cached));
+    }
     NodeIterator it(f);
-    it.Initialize();
-    std::reverse(it.ordered_->begin(), it.ordered_->end());
+    it.Initialize(/*forward=*/true);
+    f->SetTopoOrderCache(it.ordered_);
     return it;
   }
 
   static NodeIterator CreateReverse(FunctionBase* f) {
+    if (std::shared_ptr<const std::vector<Node*>> cached =
+            f->topo_order_cache()) {
+      return NodeIterator(f, std::make_shared<const std::vector<Node*>>(
+                                 cached->rbegin(), cached->rend()));
+    }
     NodeIterator it(f);
-    it.Initialize();
+    it.Initialize(/*forward=*/false);
+    // Populate the forward-order cache while we have the ordering in hand;
+    // subsequent TopoSort/ReverseTopoSort calls become views or copies.
+    f->SetTopoOrderCache(std::make_shared<const std::vector<Node*>>(
+        it.ordered_->rbegin(), it.ordered_->rend()));
     return it;
   }
 
-  std::vector<Node*>::iterator begin() { return ordered_->begin(); }
-  std::vector<Node*>::iterator end() { return ordered_->end(); }
+  std::vector<Node*>::const_iterator begin() const {
+    return ordered_->begin();
+  }
+  std::vector<Node*>::const_iterator end() const { return ordered_->end(); }
 
   const std::vector<Node*>& AsVector() const { return *ordered_; }
 
  private:
   explicit NodeIterator(FunctionBase* f) : f_(f) {}
+  NodeIterator(FunctionBase* f,
+               std::shared_ptr<const std::vector<Node*>> ordered)
+      : ordered_(std::move(ordered)), f_(f) {}
 
-  void Initialize();
+  // Computes the ordering; `forward` selects between topological order and
+  // reverse topological order.
+  void Initialize(bool forward);
 
-  // The vector of nodes is wrapped in a unique_ptr so that the
-  // NodeIterator may be movable but the iterators returned to the
-  // caller of begin()/end() are not invalidated by those moves.
-  std::unique_ptr<std::vector<Node*>> ordered_;
+  // The vector of nodes is shared with the FunctionBase's topo order cache
+  // (and with any other NodeIterators over the same unchanged function), so
+  // iterators returned to the caller of begin()/end() are not invalidated by
+  // moves of this object.
+  std::shared_ptr<const std::vector<Node*>> ordered_;
   FunctionBase* f_;
 };
 
@@ -66,8 +95,8 @@ class NodeIterator {
 // Yields nodes in a stable topological traversal order (dependency ordering is
 // satisfied).
 //
-// Note that the ordering for all nodes is computed up front, *not*
-// incrementally as iteration proceeds.
+// Note that the ordering for all nodes is computed up front (or taken from the
+// function's cache), *not* incrementally as iteration proceeds.
 inline NodeIterator TopoSort(FunctionBase* f) {
   return NodeIterator::Create(f);
 }
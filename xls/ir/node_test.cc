@@ -17,6 +17,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "xls/common/status/matchers.h"
+#include "xls/ir/dfs_visitor.h"
 #include "xls/ir/function.h"
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_test_base.h"
@@ -341,6 +342,37 @@ fn main() -> bits[11] {
   EXPECT_FALSE(nodes_equal("counted_for.13", "counted_for.16"));
 }
 
+TEST_F(NodeTest, DuplicateOperandsCountAsOneUser) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+fn DuplicateOperands(x: bits[8], y: bits[8]) -> bits[8] {
+  ret add.1: bits[8] = add(x, x)
+}
+)",
+                                                       p.get()));
+  Node* x = FindNode("x", f);
+  Node* y = FindNode("y", f);
+  Node* add = FindNode("add.1", f);
+
+  // A node occupying several operand slots is a single distinct user.
+  EXPECT_EQ(x->users().size(), 1);
+  EXPECT_THAT(x->users(), UnorderedElementsAre(add));
+  EXPECT_TRUE(x->HasUser(add));
+  EXPECT_TRUE(y->users().empty());
+
+  // Replacing one of the duplicate slots leaves x with the same single user
+  // and makes the add a user of y as well.
+  XLS_ASSERT_OK(add->ReplaceOperandNumber(1, y));
+  EXPECT_EQ(x->users().size(), 1);
+  EXPECT_EQ(y->users().size(), 1);
+  EXPECT_THAT(y->users(), UnorderedElementsAre(add));
+
+  // Replacing the remaining slot removes the use of x entirely.
+  XLS_ASSERT_OK(add->ReplaceOperandNumber(0, y));
+  EXPECT_TRUE(x->users().empty());
+  EXPECT_EQ(y->users().size(), 1);
+}
+
 TEST_F(NodeTest, ReplaceUses) {
   auto p = CreatePackage();
   XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
@@ -471,6 +503,33 @@ TEST_F(NodeTest, NodeNames) {
   EXPECT_TRUE(f->return_value()->HasAssignedName());
 }
 
+TEST_F(NodeTest, NamesMaterializedLazily) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+fn f(x: bits[8]) -> bits[8] {
+  ret not.2: bits[8] = not(x)
+}
+)",
+                                                       p.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Node * a, f->MakeNodeWithName<UnOp>(SourceInfo(), FindNode("x", f),
+                                          Op::kNot, "dup"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Node * b, f->MakeNodeWithName<UnOp>(SourceInfo(), FindNode("x", f),
+                                          Op::kNot, "dup"));
+  EXPECT_TRUE(a->HasAssignedName());
+  EXPECT_TRUE(b->HasAssignedName());
+
+  // Assigned names are stored as given and uniquified within the function
+  // only when first read, so the node read first keeps the undecorated name.
+  EXPECT_EQ(b->GetName(), "dup");
+  EXPECT_EQ(a->GetName(), "dup__1");
+
+  // Materialized names are stable across reads.
+  EXPECT_EQ(b->GetName(), "dup");
+  EXPECT_EQ(a->GetName(), "dup__1");
+}
+
 TEST_F(NodeTest, IsDead) {
   auto p = CreatePackage();
   XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
@@ -503,5 +562,30 @@ TEST_F(NodeTest, IncorrectOpClass) {
       HasSubstr("Op `assert` is not a valid op for Node class `UnOp`"));
 }
 
+TEST_F(NodeTest, AcceptHandlesDeepGraphs) {
+  // A chain deep enough to overflow the call stack under a recursive
+  // traversal; Accept iterates with an explicit stack so this must succeed.
+  constexpr int64_t kDepth = 100000;
+  auto p = CreatePackage();
+  FunctionBuilder b("deep", p.get());
+  BValue v = b.Param("x", p->GetBitsType(8));
+  for (int64_t i = 0; i < kDepth; ++i) {
+    v = b.Not(v);
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, b.Build());
+
+  class CountingVisitor : public DfsVisitorWithDefault {
+   public:
+    absl::Status DefaultHandler(Node* node) override {
+      ++count;
+      return absl::OkStatus();
+    }
+    int64_t count = 0;
+  };
+  CountingVisitor visitor;
+  XLS_ASSERT_OK(f->return_value()->Accept(&visitor));
+  EXPECT_EQ(visitor.count, kDepth + 1);
+}
+
 }  // namespace
 }  // namespace xls
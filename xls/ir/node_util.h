@@ -100,6 +100,20 @@ inline bool AnyTwoOperandsWhere(Node* node,
   return false;
 }
 
+// Returns true if `nodes` contains the same node more than once. The scan is
+// quadratic but allocation-free; it is intended for guarding
+// duplicate-removal rewrites in the optimization passes, where the common
+// case is that no duplicate exists and no rewrite (and thus no capture
+// vector) is needed.
+inline bool HasDuplicateElement(absl::Span<Node* const> nodes) {
+  for (auto it = nodes.begin(); it != nodes.end(); ++it) {
+    if (std::find(nodes.begin(), it, *it) != it) {
+      return true;
+    }
+  }
+  return false;
+}
+
 inline bool SoleUserSatisfies(Node* node,
                               const std::function<bool(Node*)>& predicate) {
   if (node->users().size() != 1) {
@@ -78,8 +78,16 @@ static absl::StatusOr<Bits> ParseUnsignedNumberHelper(
   // binary symbols) and convert each to a separate Bits value. Then
   // concatenate them all together.
   const int64_t step_size = 64 / base_bits;
-  std::vector<Bits> chunks;
-  for (int64_t i = 0; i < numeric_string.size(); i = i + step_size) {
+  BitsBuilder builder(numeric_string.size() * base_bits);
+  // The builder appends from the least-significant end, so walk the chunks
+  // right to left. The rightmost (possibly partial) chunk covers the symbols
+  // which do not fill a whole 64-bit step.
+  int64_t last_chunk_start =
+      numeric_string.empty()
+          ? -1
+          : ((static_cast<int64_t>(numeric_string.size()) - 1) / step_size) *
+                step_size;
+  for (int64_t i = last_chunk_start; i >= 0; i = i - step_size) {
     int64_t chunk_length =
         std::min<int64_t>(step_size, numeric_string.size() - i);
     absl::StatusOr<uint64_t> chunk_value_or =
@@ -89,21 +97,19 @@ static absl::StatusOr<Bits> ParseUnsignedNumberHelper(
           absl::StrFormat("Could not convert %s to %s number: %s", orig_string,
                           base_name, chunk_value_or.status().message()));
     }
-    chunks.push_back(UBits(*chunk_value_or, chunk_length * base_bits));
+    builder.AppendWord(*chunk_value_or, chunk_length * base_bits);
   }
 
-  Bits unnarrowed = bits_ops::Concat(chunks);
   if (bit_count == kMinimumBitCount) {
+    Bits unnarrowed = builder.Build();
     // Narrow the Bits value to be just wide enough to hold the value.
     int64_t new_width = unnarrowed.bit_count() - unnarrowed.CountLeadingZeros();
     return unnarrowed.Slice(0, new_width);
-  } else if (bit_count > unnarrowed.bit_count()) {
-    BitsRope rope(bit_count);
-    rope.push_back(unnarrowed);
-    rope.push_back(Bits(bit_count - unnarrowed.bit_count()));
-    return rope.Build();
+  } else if (bit_count > builder.bit_count()) {
+    builder.AppendZeroes(bit_count - builder.bit_count());
+    return builder.Build();
   } else {
-    return unnarrowed.Slice(0, bit_count);
+    return builder.Build().Slice(0, bit_count);
   }
 }
 
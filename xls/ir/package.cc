@@ -26,6 +26,7 @@
 #include "xls/ir/block.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/function.h"
+#include "xls/ir/nodes.h"
 #include "xls/ir/proc.h"
 #include "xls/ir/type.h"
 #include "xls/ir/value.h"
@@ -33,8 +34,39 @@
 
 namespace xls {
 
+thread_local ScopedStridedNodeIds* ScopedStridedNodeIds::current_ = nullptr;
+
+ScopedStridedNodeIds::ScopedStridedNodeIds(Package* package, int64_t base,
+                                           int64_t stride)
+    : package_(package), next_id_(base), stride_(stride) {
+  XLS_CHECK_GT(stride, 0);
+  XLS_CHECK(current_ == nullptr)
+      << "ScopedStridedNodeIds scopes may not be nested";
+  current_ = this;
+}
+
+ScopedStridedNodeIds::~ScopedStridedNodeIds() { current_ = nullptr; }
+
+/* static */ std::optional<int64_t> ScopedStridedNodeIds::NextIdForPackage(
+    Package* package) {
+  if (current_ == nullptr || current_->package_ != package) {
+    return std::nullopt;
+  }
+  int64_t id = current_->next_id_;
+  current_->next_id_ += current_->stride_;
+  return id;
+}
+
+int64_t Package::GetNextNodeId() {
+  if (std::optional<int64_t> strided_id =
+          ScopedStridedNodeIds::NextIdForPackage(this)) {
+    return *strided_id;
+  }
+  return next_node_id_++;
+}
+
 Package::Package(absl::string_view name) : name_(name) {
-  owned_types_.insert(&token_type_);
+  AddOwnedType(&token_type_);
 }
 
 Package::~Package() {}
@@ -304,40 +336,66 @@ absl::StatusOr<Type*> Package::MapTypeFromOtherPackage(
 }
 
 BitsType* Package::GetBitsType(int64_t bit_count) {
-  if (bit_count_to_type_.find(bit_count) != bit_count_to_type_.end()) {
-    return &bit_count_to_type_.at(bit_count);
+  {
+    absl::ReaderMutexLock lock(&bits_types_mutex_);
+    auto it = bit_count_to_type_.find(bit_count);
+    if (it != bit_count_to_type_.end()) {
+      return &it->second;
+    }
   }
-  auto it = bit_count_to_type_.emplace(bit_count, BitsType(bit_count));
-  BitsType* new_type = &(it.first->second);
-  owned_types_.insert(new_type);
+  BitsType* new_type;
+  {
+    absl::MutexLock lock(&bits_types_mutex_);
+    // If another thread interned the same type between the locks, emplace
+    // returns the existing entry.
+    auto it = bit_count_to_type_.emplace(bit_count, BitsType(bit_count));
+    new_type = &(it.first->second);
+  }
+  AddOwnedType(new_type);
   return new_type;
 }
 
 ArrayType* Package::GetArrayType(int64_t size, Type* element_type) {
   ArrayKey key{size, element_type};
-  if (array_types_.find(key) != array_types_.end()) {
-    return &array_types_.at(key);
+  {
+    absl::ReaderMutexLock lock(&array_types_mutex_);
+    auto it = array_types_.find(key);
+    if (it != array_types_.end()) {
+      return &it->second;
+    }
   }
   XLS_CHECK(IsOwnedType(element_type))
       << "Type is not owned by package: " << *element_type;
-  auto it = array_types_.emplace(key, ArrayType(size, element_type));
-  ArrayType* new_type = &(it.first->second);
-  owned_types_.insert(new_type);
+  ArrayType* new_type;
+  {
+    absl::MutexLock lock(&array_types_mutex_);
+    auto it = array_types_.emplace(key, ArrayType(size, element_type));
+    new_type = &(it.first->second);
+  }
+  AddOwnedType(new_type);
   return new_type;
 }
 
 TupleType* Package::GetTupleType(absl::Span<Type* const> element_types) {
   TypeVec key(element_types.begin(), element_types.end());
-  if (tuple_types_.find(key) != tuple_types_.end()) {
-    return &tuple_types_.at(key);
+  {
+    absl::ReaderMutexLock lock(&tuple_types_mutex_);
+    auto it = tuple_types_.find(key);
+    if (it != tuple_types_.end()) {
+      return &it->second;
+    }
   }
   for (const Type* element_type : element_types) {
     XLS_CHECK(IsOwnedType(element_type))
         << "Type is not owned by package: " << *element_type;
   }
-  auto it = tuple_types_.emplace(key, TupleType(element_types));
-  TupleType* new_type = &(it.first->second);
-  owned_types_.insert(new_type);
+  TupleType* new_type;
+  {
+    absl::MutexLock lock(&tuple_types_mutex_);
+    auto it = tuple_types_.emplace(key, TupleType(element_types));
+    new_type = &(it.first->second);
+  }
+  AddOwnedType(new_type);
   return new_type;
 }
 
@@ -346,16 +404,25 @@ TokenType* Package::GetTokenType() { return &token_type_; }
 FunctionType* Package::GetFunctionType(absl::Span<Type* const> args_types,
                                        Type* return_type) {
   std::string key = FunctionType(args_types, return_type).ToString();
-  if (function_types_.find(key) != function_types_.end()) {
-    return &function_types_.at(key);
+  {
+    absl::ReaderMutexLock lock(&function_types_mutex_);
+    auto it = function_types_.find(key);
+    if (it != function_types_.end()) {
+      return &it->second;
+    }
   }
   for (Type* t : args_types) {
     XLS_CHECK(IsOwnedType(t))
         << "Parameter type is not owned by package: " << t->ToString();
   }
-  auto it = function_types_.emplace(key, FunctionType(args_types, return_type));
-  FunctionType* new_type = &(it.first->second);
-  owned_function_types_.insert(new_type);
+  FunctionType* new_type;
+  {
+    absl::MutexLock lock(&function_types_mutex_);
+    auto it =
+        function_types_.emplace(key, FunctionType(args_types, return_type));
+    new_type = &(it.first->second);
+  }
+  AddOwnedFunctionType(new_type);
   return new_type;
 }
 
@@ -482,6 +549,95 @@ int64_t Package::GetNodeCount() const {
   return count;
 }
 
+int64_t Package::GetTransformCount() const {
+  int64_t count = 0;
+  for (FunctionBase* f : GetFunctionBases()) {
+    count += f->transform_journal();
+  }
+  return count;
+}
+
+namespace {
+
+// Estimated heap bytes held by the payload of `value` beyond the Value object
+// itself: out-of-line Bits words plus element storage of compound values.
+int64_t ValueHeapBytes(const Value& value) {
+  if (value.IsBits()) {
+    // Bits of up to 64 bits are stored inline in the bitmap.
+    int64_t bit_count = value.bits().bit_count();
+    return bit_count <= 64 ? 0 : ((bit_count + 63) / 64) * 8;
+  }
+  if (value.IsTuple() || value.IsArray()) {
+    int64_t bytes = value.size() * static_cast<int64_t>(sizeof(Value));
+    for (const Value& element : value.elements()) {
+      bytes += ValueHeapBytes(element);
+    }
+    return bytes;
+  }
+  return 0;  // Token.
+}
+
+}  // namespace
+
+Package::MemoryUsage Package::EstimateMemoryUsage() const {
+  MemoryUsage usage;
+  usage.node_bytes = node_arena_.ReservedBytes();
+  usage.name_bytes = name_.size();
+  for (FunctionBase* f : GetFunctionBases()) {
+    usage.name_bytes += f->name().size();
+    for (Node* node : f->nodes()) {
+      // The operand and operand-use vectors of the node.
+      usage.node_bytes +=
+          node->operand_count() * 2 * static_cast<int64_t>(sizeof(void*));
+      usage.name_bytes += node->GetName().size();
+      if (node->Is<Literal>()) {
+        usage.bits_bytes += static_cast<int64_t>(sizeof(Value)) +
+                            ValueHeapBytes(node->As<Literal>()->value());
+      }
+    }
+  }
+  {
+    absl::ReaderMutexLock lock(&bits_types_mutex_);
+    usage.type_bytes +=
+        bit_count_to_type_.size() *
+        static_cast<int64_t>(sizeof(BitsType) + sizeof(int64_t));
+  }
+  {
+    absl::ReaderMutexLock lock(&array_types_mutex_);
+    usage.type_bytes +=
+        array_types_.size() *
+        static_cast<int64_t>(sizeof(ArrayType) + sizeof(ArrayKey));
+  }
+  {
+    absl::ReaderMutexLock lock(&tuple_types_mutex_);
+    for (const auto& [elements, type] : tuple_types_) {
+      usage.type_bytes += static_cast<int64_t>(sizeof(TupleType)) +
+                          elements.size() * static_cast<int64_t>(sizeof(Type*));
+    }
+  }
+  {
+    absl::ReaderMutexLock lock(&function_types_mutex_);
+    for (const auto& [key, type] : function_types_) {
+      usage.type_bytes +=
+          static_cast<int64_t>(sizeof(FunctionType)) + key.size();
+    }
+  }
+  for (const auto& [fileno, filename] : fileno_to_filename_) {
+    // The filename is stored in both directions of the fileno table.
+    usage.name_bytes += 2 * filename.size();
+  }
+  for (Channel* channel : channel_vec_) {
+    usage.name_bytes += channel->name().size();
+  }
+  return usage;
+}
+
+std::string Package::MemoryUsage::ToString() const {
+  return absl::StrFormat(
+      "total: %d bytes (nodes: %d, types: %d, names: %d, bits: %d)",
+      total_bytes(), node_bytes, type_bytes, name_bytes, bits_bytes);
+}
+
 bool Package::IsDefinitelyEqualTo(const Package* other) const {
   auto entry_function_status = GetTopAsFunction();
   if (!entry_function_status.ok()) {
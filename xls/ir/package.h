@@ -17,19 +17,23 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/container/node_hash_map.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/channel.pb.h"
 #include "xls/ir/channel_ops.h"
 #include "xls/ir/fileno.h"
+#include "xls/ir/node_arena.h"
 #include "xls/ir/source_location.h"
 #include "xls/ir/type.h"
 #include "xls/ir/value.h"
@@ -44,6 +48,44 @@ class Proc;
 class SingleValueChannel;
 class StreamingChannel;
 
+// While in scope, nodes created on the *current thread* in `package` draw
+// their ids from the strided sequence base, base + stride, base + 2*stride,
+// ... instead of the package's node id counter. Parallel pass execution gives
+// the worker of the i-th FunctionBase the sequence (next_node_id + i) with
+// stride equal to the number of FunctionBases, making node ids unique and
+// deterministic regardless of thread scheduling. The coordinator is
+// responsible for advancing the package's node id counter to at least the
+// maximum next_id() of all scopes once the workers have finished; the scope
+// itself never touches the (unsynchronized) package counter.
+//
+// Scopes may not be nested on a thread.
+class ScopedStridedNodeIds {
+ public:
+  ScopedStridedNodeIds(Package* package, int64_t base, int64_t stride);
+  ~ScopedStridedNodeIds();
+
+  ScopedStridedNodeIds(const ScopedStridedNodeIds&) = delete;
+  ScopedStridedNodeIds& operator=(const ScopedStridedNodeIds&) = delete;
+
+  // The next id which would be handed out. Advancing the package's node id
+  // counter to the maximum next_id() over all scopes guarantees it is past
+  // every id actually handed out.
+  int64_t next_id() const { return next_id_; }
+
+ private:
+  friend class Package;
+
+  // Returns the next id of the scope active on the calling thread for
+  // `package`, or nullopt if no scope is active.
+  static std::optional<int64_t> NextIdForPackage(Package* package);
+
+  Package* package_;
+  int64_t next_id_;
+  int64_t stride_;
+
+  static thread_local ScopedStridedNodeIds* current_;
+};
+
 class Package {
  public:
   explicit Package(absl::string_view name);
@@ -70,15 +112,24 @@ class Package {
   absl::StatusOr<Proc*> GetTopAsProc() const;
   absl::StatusOr<Block*> GetTopAsBlock() const;
 
+  // Returns the arena out of which all nodes of this package are allocated.
+  NodeArena& node_arena() { return node_arena_; }
+
   // Returns whether the given type is one of the types owned by this package.
   bool IsOwnedType(const Type* type) {
+    absl::ReaderMutexLock lock(&owned_types_mutex_);
     return owned_types_.find(type) != owned_types_.end();
   }
   bool IsOwnedFunctionType(const FunctionType* function_type) {
+    absl::ReaderMutexLock lock(&owned_types_mutex_);
     return owned_function_types_.find(function_type) !=
            owned_function_types_.end();
   }
 
+  // Type interning. The returned types are owned by the package and live as
+  // long as it does. These methods are safe to call concurrently from
+  // multiple threads; each kind of type is interned behind its own mutex so
+  // construction of unrelated types does not serialize.
   BitsType* GetBitsType(int64_t bit_count);
   ArrayType* GetArrayType(int64_t size, Type* element_type);
   TupleType* GetTupleType(absl::Span<Type* const> element_types);
@@ -145,8 +196,10 @@ class Package {
   std::string SourceLocationToString(const SourceLocation loc);
 
   // Retrieves the next node ID to assign to a node in the package and
-  // increments the next node counter. For use in node construction.
-  int64_t GetNextNodeId() { return next_node_id_++; }
+  // increments the next node counter. For use in node construction. If a
+  // ScopedStridedNodeIds is active on the calling thread for this package the
+  // id is drawn from its strided sequence instead of the package counter.
+  int64_t GetNextNodeId();
 
   // Adds a file to the file-number table and returns its corresponding number.
   // If it already exists, returns the existing file-number entry.
@@ -163,6 +216,34 @@ class Package {
   // sums the node counts.
   int64_t GetNodeCount() const;
 
+  // Returns the sum of the transform journals of all FunctionBases in the
+  // package (see FunctionBase::transform_journal). The difference between two
+  // calls counts the IR transformations performed in between.
+  int64_t GetTransformCount() const;
+
+  // Estimated heap memory held by the package, broken down by category. The
+  // numbers are estimates: container slack and allocator overhead are not
+  // counted. Intended for telemetry such as per-pass memory profiles, not for
+  // precise accounting.
+  struct MemoryUsage {
+    // Node storage: the node arena plus per-node operand and use vectors.
+    int64_t node_bytes = 0;
+    // Interned types and the tables holding them.
+    int64_t type_bytes = 0;
+    // Name strings of nodes, FunctionBases, channels and source files.
+    int64_t name_bytes = 0;
+    // Bits payloads of literal values.
+    int64_t bits_bytes = 0;
+
+    int64_t total_bytes() const {
+      return node_bytes + type_bytes + name_bytes + bits_bytes;
+    }
+
+    // Renders the breakdown as a single human-readable line.
+    std::string ToString() const;
+  };
+  MemoryUsage EstimateMemoryUsage() const;
+
   // Returns the functions in this package.
   absl::Span<std::unique_ptr<Function>> functions() {
     return absl::MakeSpan(functions_);
@@ -247,6 +328,11 @@ class Package {
 
   friend class FunctionBuilder;
 
+  // Backing storage for all nodes in the package. Declared before the
+  // FunctionBase containers below so it is destroyed after them; node
+  // destructors run while their storage is still alive.
+  NodeArena node_arena_;
+
   std::optional<FunctionBase*> top_;
 
   // Helper that returns a map from the names of functions inside this package
@@ -263,33 +349,63 @@ class Package {
   std::vector<std::unique_ptr<Proc>> procs_;
   std::vector<std::unique_ptr<Block>> blocks_;
 
+  // Records `type` as owned by this package (idempotent).
+  void AddOwnedType(const Type* type) {
+    absl::MutexLock lock(&owned_types_mutex_);
+    owned_types_.insert(type);
+  }
+  void AddOwnedFunctionType(const FunctionType* function_type) {
+    absl::MutexLock lock(&owned_types_mutex_);
+    owned_function_types_.insert(function_type);
+  }
+
+  // The type-interning tables are sharded behind one mutex per kind of type
+  // so types can be created concurrently from multiple threads (e.g. by a
+  // multithreaded pass manager or parallel IR construction); unrelated kinds
+  // never contend. The owned-type sets have their own mutex which is only
+  // ever acquired while no table mutex is held (or after one, never before),
+  // so there is no lock-ordering hazard. Lookups take the mutexes in reader
+  // mode; node_hash_maps give the interned types stable addresses, so
+  // returned pointers remain valid without any locking.
+  mutable absl::Mutex owned_types_mutex_;
+  mutable absl::Mutex bits_types_mutex_;
+  mutable absl::Mutex array_types_mutex_;
+  mutable absl::Mutex tuple_types_mutex_;
+  mutable absl::Mutex function_types_mutex_;
+
   // Set of owned types in this package.
-  absl::flat_hash_set<const Type*> owned_types_;
+  absl::flat_hash_set<const Type*> owned_types_
+      ABSL_GUARDED_BY(owned_types_mutex_);
 
   // Set of owned function types in this package.
-  absl::flat_hash_set<const FunctionType*> owned_function_types_;
+  absl::flat_hash_set<const FunctionType*> owned_function_types_
+      ABSL_GUARDED_BY(owned_types_mutex_);
 
   // Mapping from bit count to the owned "bits" type with that many bits. Use
   // node_hash_map for pointer stability.
-  absl::node_hash_map<int64_t, BitsType> bit_count_to_type_;
+  absl::node_hash_map<int64_t, BitsType> bit_count_to_type_
+      ABSL_GUARDED_BY(bits_types_mutex_);
 
   // Mapping from the size and element type of an array type to the owned
   // ArrayType. Use node_hash_map for pointer stability.
   using ArrayKey = std::pair<int64_t, const Type*>;
-  absl::node_hash_map<ArrayKey, ArrayType> array_types_;
+  absl::node_hash_map<ArrayKey, ArrayType> array_types_
+      ABSL_GUARDED_BY(array_types_mutex_);
 
   // Mapping from elements to the owned tuple type.
   //
   // Uses node_hash_map for pointer stability.
   using TypeVec = absl::InlinedVector<const Type*, 4>;
-  absl::node_hash_map<TypeVec, TupleType> tuple_types_;
+  absl::node_hash_map<TypeVec, TupleType> tuple_types_
+      ABSL_GUARDED_BY(tuple_types_mutex_);
 
   // Owned token type.
   TokenType token_type_;
 
   // Mapping from Type:ToString to the owned function type. Use
   // node_hash_map for pointer stability.
-  absl::node_hash_map<std::string, FunctionType> function_types_;
+  absl::node_hash_map<std::string, FunctionType> function_types_
+      ABSL_GUARDED_BY(function_types_mutex_);
 
   // The largest `Fileno` used in this `Package`.
   std::optional<Fileno> maximum_fileno_;
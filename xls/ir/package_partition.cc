@@ -0,0 +1,251 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/package_partition.h"
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/data_structures/union_find.h"
+#include "xls/ir/channel.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/proc.h"
+#include "xls/ir/verifier.h"
+
+namespace xls {
+namespace {
+
+// A connected component of the package's call graph: FunctionBases related by
+// invoke/map/counted_for edges or by communicating over a channel, plus the
+// total node count used to balance components across partitions.
+struct CallGraphComponent {
+  std::vector<FunctionBase*> members;
+  int64_t node_count = 0;
+};
+
+// Groups the FunctionBases of `package` into connected components, in a
+// deterministic order following Package::GetFunctionBases.
+std::vector<CallGraphComponent> ComputeCallGraphComponents(
+    const Package& package) {
+  std::vector<FunctionBase*> function_bases = package.GetFunctionBases();
+  UnionFind<FunctionBase*> components;
+  for (FunctionBase* f : function_bases) {
+    components.Insert(f);
+  }
+  // Procs on the two ends of a channel must stay together; collect the users
+  // of each channel and union them below.
+  absl::flat_hash_map<int64_t, std::vector<FunctionBase*>> channel_users;
+  for (FunctionBase* f : function_bases) {
+    for (Node* node : f->nodes()) {
+      switch (node->op()) {
+        case Op::kCountedFor:
+          components.Union(f, node->As<CountedFor>()->body());
+          break;
+        case Op::kDynamicCountedFor:
+          components.Union(f, node->As<DynamicCountedFor>()->body());
+          break;
+        case Op::kInvoke:
+          components.Union(f, node->As<Invoke>()->to_apply());
+          break;
+        case Op::kMap:
+          components.Union(f, node->As<Map>()->to_apply());
+          break;
+        case Op::kReceive:
+          channel_users[node->As<Receive>()->channel_id()].push_back(f);
+          break;
+        case Op::kSend:
+          channel_users[node->As<Send>()->channel_id()].push_back(f);
+          break;
+        default:
+          break;
+      }
+    }
+  }
+  for (const auto& [channel_id, users] : channel_users) {
+    for (FunctionBase* user : users) {
+      components.Union(users.front(), user);
+    }
+  }
+
+  absl::flat_hash_map<FunctionBase*, int64_t> component_index;
+  std::vector<CallGraphComponent> component_list;
+  for (FunctionBase* f : function_bases) {
+    FunctionBase* root = components.Find(f);
+    auto [it, inserted] = component_index.emplace(root, component_list.size());
+    if (inserted) {
+      component_list.emplace_back();
+    }
+    CallGraphComponent& component = component_list[it->second];
+    component.members.push_back(f);
+    component.node_count += f->node_count();
+  }
+  return component_list;
+}
+
+}  // namespace
+
+absl::StatusOr<std::vector<std::unique_ptr<Package>>> PartitionPackage(
+    const Package& package, int64_t num_partitions) {
+  XLS_RET_CHECK_GT(num_partitions, 0);
+  XLS_RET_CHECK(package.blocks().empty())
+      << "cannot partition a package containing blocks";
+
+  std::vector<CallGraphComponent> components =
+      ComputeCallGraphComponents(package);
+
+  // Assign components to partitions largest-first, each to the currently
+  // lightest partition, so partition sizes stay balanced.
+  int64_t partition_count =
+      std::min<int64_t>(num_partitions, components.size());
+  std::vector<int64_t> order(components.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+    return components[a].node_count > components[b].node_count;
+  });
+  std::vector<int64_t> partition_weight(partition_count, 0);
+  std::vector<absl::flat_hash_set<std::string>> partition_members(
+      partition_count);
+  for (int64_t c : order) {
+    int64_t lightest = std::distance(
+        partition_weight.begin(),
+        std::min_element(partition_weight.begin(), partition_weight.end()));
+    partition_weight[lightest] += components[c].node_count;
+    for (FunctionBase* f : components[c].members) {
+      partition_members[lightest].insert(f->name());
+    }
+  }
+
+  // Channels referenced by no proc at all (e.g. declared but as-yet unused
+  // I/O) have no component to follow; keep them in the first partition so a
+  // later merge does not lose them.
+  absl::flat_hash_set<int64_t> referenced_channels;
+  for (FunctionBase* f : package.GetFunctionBases()) {
+    for (Node* node : f->nodes()) {
+      if (node->Is<Receive>()) {
+        referenced_channels.insert(node->As<Receive>()->channel_id());
+      } else if (node->Is<Send>()) {
+        referenced_channels.insert(node->As<Send>()->channel_id());
+      }
+    }
+  }
+
+  // Build each partition by reparsing the package text and pruning the
+  // FunctionBases (and the channels) belonging to the other partitions. The
+  // parser rebuilds the type table, so each partition owns exactly the types
+  // its retained entities need.
+  std::string ir_text = package.DumpIr();
+  std::vector<std::unique_ptr<Package>> partitions;
+  for (int64_t i = 0; i < partition_count; ++i) {
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> partition,
+                         Parser::ParsePackage(ir_text));
+    std::optional<FunctionBase*> top = partition->GetTop();
+    if (top.has_value() && !partition_members[i].contains((*top)->name())) {
+      XLS_RETURN_IF_ERROR(partition->SetTop(std::nullopt));
+    }
+    // Components are closed under references, so whole-component removal
+    // never leaves a dangling callee.
+    for (FunctionBase* f : partition->GetFunctionBases()) {
+      if (!partition_members[i].contains(f->name())) {
+        XLS_RETURN_IF_ERROR(partition->RemoveFunctionBase(f));
+      }
+    }
+    absl::flat_hash_set<int64_t> used_channels;
+    for (FunctionBase* f : partition->GetFunctionBases()) {
+      for (Node* node : f->nodes()) {
+        if (node->Is<Receive>()) {
+          used_channels.insert(node->As<Receive>()->channel_id());
+        } else if (node->Is<Send>()) {
+          used_channels.insert(node->As<Send>()->channel_id());
+        }
+      }
+    }
+    std::vector<Channel*> channels(partition->channels().begin(),
+                                   partition->channels().end());
+    for (Channel* channel : channels) {
+      if (used_channels.contains(channel->id()) ||
+          (i == 0 && !referenced_channels.contains(channel->id()))) {
+        continue;
+      }
+      XLS_RETURN_IF_ERROR(partition->RemoveChannel(channel));
+    }
+    partitions.push_back(std::move(partition));
+  }
+  return partitions;
+}
+
+absl::StatusOr<std::unique_ptr<Package>> MergePackages(
+    absl::Span<Package* const> partitions, absl::string_view name) {
+  auto merged = std::make_unique<Package>(name);
+  std::optional<std::string> top_name;
+  for (Package* partition : partitions) {
+    XLS_RET_CHECK(partition->blocks().empty())
+        << "cannot merge a package containing blocks";
+    std::optional<FunctionBase*> top = partition->GetTop();
+    if (top.has_value()) {
+      if (top_name.has_value()) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "Multiple packages have a top entity: '%s' and '%s'", *top_name,
+            (*top)->name()));
+      }
+      top_name = (*top)->name();
+    }
+    for (Channel* channel : partition->channels()) {
+      if (merged->GetChannel(channel->name()).ok()) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "Channel '%s' is defined in more than one package",
+            channel->name()));
+      }
+      XLS_RETURN_IF_ERROR(
+          Parser::ParseChannel(channel->ToString(), merged.get()).status());
+    }
+    // Within a package functions are dumped with callees before callers, and
+    // no calls cross packages, so parsing in order resolves every callee.
+    for (const std::unique_ptr<Function>& function : partition->functions()) {
+      if (merged->GetFunction(function->name()).ok()) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "Function '%s' is defined in more than one package",
+            function->name()));
+      }
+      XLS_RETURN_IF_ERROR(
+          Parser::ParseFunction(function->DumpIr(), merged.get()).status());
+    }
+    for (const std::unique_ptr<Proc>& proc : partition->procs()) {
+      if (merged->GetProc(proc->name()).ok()) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "Proc '%s' is defined in more than one package", proc->name()));
+      }
+      XLS_RETURN_IF_ERROR(
+          Parser::ParseProc(proc->DumpIr(), merged.get()).status());
+    }
+  }
+  if (top_name.has_value()) {
+    XLS_RETURN_IF_ERROR(merged->SetTopByName(*top_name));
+  }
+  XLS_RETURN_IF_ERROR(VerifyPackage(merged.get()));
+  return merged;
+}
+
+}  // namespace xls
@@ -0,0 +1,59 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_IR_PACKAGE_PARTITION_H_
+#define XLS_IR_PACKAGE_PARTITION_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "xls/ir/package.h"
+
+namespace xls {
+
+// Splits `package` into at most `num_partitions` standalone packages which
+// can be optimized independently (e.g. by separate opt_main invocations on
+// separate machines) and recombined with MergePackages.
+//
+// The unit of partitioning is a connected component of the call graph:
+// functions related by invoke/map/counted_for and procs communicating over a
+// channel always land in the same partition, so every partition is closed
+// under its references and no cross-partition stubs are needed. Components
+// are distributed across partitions largest-first by node count to balance
+// the load; fewer packages than `num_partitions` are returned if the package
+// has fewer components. The partition holding the package's top entity keeps
+// it as its top; the other partitions have no top set (optimize them with an
+// explicit --top or with dead function elimination skipped).
+//
+// Packages containing blocks are not supported; partitioning is intended for
+// the pre-codegen IR.
+absl::StatusOr<std::vector<std::unique_ptr<Package>>> PartitionPackage(
+    const Package& package, int64_t num_partitions);
+
+// Merges the given packages (typically optimized partitions produced by
+// PartitionPackage) into a single package named `name`. Channels, functions
+// and procs are reconstructed in the merged package through the parser, which
+// rebuilds the type table and enforces name and channel-id uniqueness; a
+// collision between partitions is an error. At most one input package may
+// have a top entity, which becomes the top of the merged package.
+absl::StatusOr<std::unique_ptr<Package>> MergePackages(
+    absl::Span<Package* const> partitions, absl::string_view name);
+
+}  // namespace xls
+
+#endif  // XLS_IR_PACKAGE_PARTITION_H_
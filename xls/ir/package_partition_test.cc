@@ -0,0 +1,166 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/package_partition.h"
+
+#include <memory>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/ir_parser.h"
+
+namespace xls {
+namespace {
+
+using status_testing::StatusIs;
+using ::testing::HasSubstr;
+
+// Three call-graph components: {f, helper} (f invokes helper), {g} and {h}.
+// f is top.
+constexpr const char kThreeComponentPackage[] = R"(package three_components
+
+fn helper(x: bits[8]) -> bits[8] {
+  ret neg.1: bits[8] = neg(x, id=1)
+}
+
+top fn f(x: bits[8]) -> bits[8] {
+  ret invoke.2: bits[8] = invoke(x, to_apply=helper, id=2)
+}
+
+fn g(x: bits[8]) -> bits[8] {
+  ret not.3: bits[8] = not(x, id=3)
+}
+
+fn h(x: bits[8], y: bits[8]) -> bits[8] {
+  ret add.4: bits[8] = add(x, y, id=4)
+}
+)";
+
+// Two procs communicating over a channel form a single component.
+constexpr const char kProcPackage[] = R"(package proc_package
+
+chan link(bits[32], id=0, kind=streaming, ops=send_receive, flow_control=none, metadata="""""")
+
+proc sender(tkn: token, st: bits[32], init={0}) {
+  send.1: token = send(tkn, st, channel_id=0, id=1)
+  next (send.1, st)
+}
+
+proc receiver(tkn: token, st: bits[32], init={0}) {
+  receive.2: (token, bits[32]) = receive(tkn, channel_id=0, id=2)
+  tuple_index.3: token = tuple_index(receive.2, index=0, id=3)
+  tuple_index.4: bits[32] = tuple_index(receive.2, index=1, id=4)
+  next (tuple_index.3, tuple_index.4)
+}
+
+fn standalone(x: bits[8]) -> bits[8] {
+  ret not.5: bits[8] = not(x, id=5)
+}
+)";
+
+TEST(PackagePartitionTest, ComponentsStayTogether) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> package,
+                           Parser::ParsePackage(kThreeComponentPackage));
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<std::unique_ptr<Package>> partitions,
+                           PartitionPackage(*package, 3));
+  ASSERT_EQ(partitions.size(), 3);
+
+  // f and its callee land in the same partition and f stays top; exactly one
+  // partition has a top entity.
+  int64_t tops = 0;
+  for (const std::unique_ptr<Package>& partition : partitions) {
+    if (partition->GetTop().has_value()) {
+      ++tops;
+      EXPECT_EQ((*partition->GetTop())->name(), "f");
+      XLS_EXPECT_OK(partition->GetFunction("helper").status());
+    }
+  }
+  EXPECT_EQ(tops, 1);
+
+  // Every function appears in exactly one partition.
+  for (const char* name : {"helper", "f", "g", "h"}) {
+    int64_t occurrences = 0;
+    for (const std::unique_ptr<Package>& partition : partitions) {
+      if (partition->GetFunction(name).ok()) {
+        ++occurrences;
+      }
+    }
+    EXPECT_EQ(occurrences, 1) << name;
+  }
+}
+
+TEST(PackagePartitionTest, FewerComponentsThanPartitions) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> package,
+                           Parser::ParsePackage(kThreeComponentPackage));
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<std::unique_ptr<Package>> partitions,
+                           PartitionPackage(*package, 10));
+  // Three components yield three partitions, not ten.
+  EXPECT_EQ(partitions.size(), 3);
+}
+
+TEST(PackagePartitionTest, ChannelPeersStayTogether) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> package,
+                           Parser::ParsePackage(kProcPackage));
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<std::unique_ptr<Package>> partitions,
+                           PartitionPackage(*package, 2));
+  ASSERT_EQ(partitions.size(), 2);
+
+  // The two procs and their channel are inseparable; `standalone` forms the
+  // other partition and carries no channels.
+  for (const std::unique_ptr<Package>& partition : partitions) {
+    if (partition->GetProc("sender").ok()) {
+      XLS_EXPECT_OK(partition->GetProc("receiver").status());
+      XLS_EXPECT_OK(partition->GetChannel("link").status());
+      EXPECT_FALSE(partition->GetFunction("standalone").ok());
+    } else {
+      XLS_EXPECT_OK(partition->GetFunction("standalone").status());
+      EXPECT_TRUE(partition->channels().empty());
+    }
+  }
+}
+
+TEST(PackagePartitionTest, PartitionThenMergeRoundTrips) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> package,
+                           Parser::ParsePackage(kThreeComponentPackage));
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<std::unique_ptr<Package>> partitions,
+                           PartitionPackage(*package, 2));
+  std::vector<Package*> partition_ptrs;
+  for (const std::unique_ptr<Package>& partition : partitions) {
+    partition_ptrs.push_back(partition.get());
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<Package> merged,
+      MergePackages(partition_ptrs, "three_components"));
+  for (const char* name : {"helper", "f", "g", "h"}) {
+    XLS_EXPECT_OK(merged->GetFunction(name).status());
+  }
+  ASSERT_TRUE(merged->GetTop().has_value());
+  EXPECT_EQ((*merged->GetTop())->name(), "f");
+}
+
+TEST(PackagePartitionTest, MergeRejectsDuplicateFunction) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> a,
+                           Parser::ParsePackage(kThreeComponentPackage));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> b,
+                           Parser::ParsePackage(kThreeComponentPackage));
+  XLS_ASSERT_OK(b->SetTop(std::nullopt));
+  EXPECT_THAT(MergePackages({a.get(), b.get()}, "dup").status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("more than one package")));
+}
+
+}  // namespace
+}  // namespace xls
@@ -14,13 +14,20 @@
 
 #include "xls/ir/package.h"
 
+#include <memory>
+#include <vector>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "xls/common/status/matchers.h"
+#include "xls/common/thread.h"
+#include "xls/ir/bits.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_test_base.h"
+#include "xls/ir/nodes.h"
 #include "xls/ir/type.h"
+#include "xls/ir/value.h"
 #include "xls/ir/xls_type.pb.h"
 
 namespace xls {
@@ -57,6 +64,37 @@ TEST_F(PackageTest, GetBitsTypes) {
   EXPECT_THAT(p.GetTypeFromProto(bits77_proto), IsOkAndHolds(bits77));
 }
 
+
+TEST_F(PackageTest, ConcurrentTypeInterning) {
+  Package p(TestName());
+  // Hammer the interning tables from several threads; every thread must get
+  // the same interned pointer for the same type.
+  constexpr int64_t kNumThreads = 8;
+  constexpr int64_t kNumTypes = 64;
+  std::vector<std::vector<FunctionType*>> results(kNumThreads);
+  {
+    std::vector<std::unique_ptr<Thread>> threads;
+    for (int64_t i = 0; i < kNumThreads; ++i) {
+      threads.push_back(std::make_unique<Thread>([&p, &results, i]() {
+        for (int64_t j = 0; j < kNumTypes; ++j) {
+          BitsType* bits = p.GetBitsType(j);
+          ArrayType* array = p.GetArrayType(j + 1, bits);
+          TupleType* tuple = p.GetTupleType({bits, array});
+          results[i].push_back(p.GetFunctionType({bits, tuple}, array));
+        }
+      }));
+    }
+    for (auto& thread : threads) {
+      thread->Join();
+    }
+  }
+  for (int64_t i = 1; i < kNumThreads; ++i) {
+    EXPECT_EQ(results[i], results[0]);
+  }
+  for (FunctionType* type : results[0]) {
+    EXPECT_TRUE(p.IsOwnedFunctionType(type));
+  }
+}
 TEST_F(PackageTest, GetArrayTypes) {
   Package p(TestName());
   BitsType* bits42 = p.GetBitsType(42);
@@ -587,5 +625,33 @@ block my_block(a: bits[32], b: bits[32], out: bits[32]) {
                        HasSubstr("Top entity not set for package:")));
 }
 
+TEST_F(PackageTest, EstimateMemoryUsage) {
+  std::unique_ptr<Package> p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+fn f(x: bits[32]) -> bits[32] {
+  literal.2: bits[32] = literal(value=42)
+  ret add.3: bits[32] = add(x, literal.2)
+}
+)",
+                                                       p.get()));
+  Package::MemoryUsage usage = p->EstimateMemoryUsage();
+  EXPECT_GT(usage.node_bytes, 0);
+  EXPECT_GT(usage.type_bytes, 0);
+  EXPECT_GT(usage.name_bytes, 0);
+  EXPECT_GT(usage.bits_bytes, 0);
+  EXPECT_EQ(usage.total_bytes(), usage.node_bytes + usage.type_bytes +
+                                     usage.name_bytes + usage.bits_bytes);
+  EXPECT_THAT(usage.ToString(), HasSubstr("nodes:"));
+
+  // A wide literal grows the Bits payload accounting by at least its payload
+  // size.
+  XLS_ASSERT_OK(f->MakeNode<Literal>(SourceInfo(),
+                                     Value(Bits::AllOnes(1024)))
+                    .status());
+  Package::MemoryUsage after = p->EstimateMemoryUsage();
+  EXPECT_GE(after.bits_bytes, usage.bits_bytes + 1024 / 8);
+  EXPECT_GT(after.total_bytes(), usage.total_bytes());
+}
+
 }  // namespace
 }  // namespace xls
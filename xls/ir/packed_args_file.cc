@@ -0,0 +1,221 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/packed_args_file.h"
+
+#include <cstring>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/math_util.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/packed_args_file.pb.h"
+#include "xls/ir/packed_value.h"
+
+namespace xls {
+namespace {
+
+// Size in bytes of the fixed preamble: magic, header proto size, record
+// count and record stride.
+constexpr int64_t kPreambleBytes = 4 * sizeof(uint64_t);
+
+// Packed size of a type in bytes, matching PackedValue and the JIT's batched
+// record layout.
+int64_t PackedByteWidth(Type* type) {
+  return CeilOfRatio(type->GetFlatBitCount(), int64_t{8});
+}
+
+void AppendUint64(uint64_t value, std::string* out) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+uint64_t ReadUint64(absl::string_view data, int64_t offset) {
+  uint64_t value;
+  std::memcpy(&value, data.data() + offset, sizeof(value));
+  return value;
+}
+
+}  // namespace
+
+bool IsPackedArgsFile(absl::string_view file_contents) {
+  return file_contents.size() >= sizeof(uint64_t) &&
+         ReadUint64(file_contents, 0) == kPackedArgsFileMagic;
+}
+
+absl::StatusOr<PackedArgsFileLayout> ParsePackedArgsFileHeader(
+    absl::string_view file_contents, Package* package) {
+  if (file_contents.size() < kPreambleBytes) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "File of %d bytes is too small to be a packed args file",
+        file_contents.size()));
+  }
+  if (ReadUint64(file_contents, 0) != kPackedArgsFileMagic) {
+    return absl::InvalidArgumentError(
+        "Not a packed args file (bad magic in first eight bytes)");
+  }
+  PackedArgsFileLayout layout;
+  int64_t header_size = static_cast<int64_t>(ReadUint64(file_contents, 8));
+  layout.record_count = static_cast<int64_t>(ReadUint64(file_contents, 16));
+  layout.record_stride = static_cast<int64_t>(ReadUint64(file_contents, 24));
+  if (header_size < 0 || layout.record_count < 0 ||
+      layout.record_stride < 0 ||
+      kPreambleBytes + header_size >
+          static_cast<int64_t>(file_contents.size())) {
+    return absl::InvalidArgumentError("Corrupt packed args file preamble");
+  }
+  layout.payload_offset = RoundUpToNearest(kPreambleBytes + header_size,
+                                           int64_t{sizeof(uint64_t)});
+
+  PackedArgsHeaderProto header;
+  if (!header.ParseFromArray(file_contents.data() + kPreambleBytes,
+                             header_size)) {
+    return absl::InvalidArgumentError(
+        "Failed to parse packed args file header proto");
+  }
+  int64_t expected_offset = 0;
+  for (const PackedArgsColumnProto& column : header.columns()) {
+    XLS_ASSIGN_OR_RETURN(Type * type,
+                         package->GetTypeFromProto(column.type()));
+    if (column.byte_offset() != expected_offset ||
+        column.byte_width() != PackedByteWidth(type)) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Column %d of packed args file does not match its type %s: "
+          "offset %d (expected %d), width %d (expected %d)",
+          layout.arg_types.size(), type->ToString(), column.byte_offset(),
+          expected_offset, column.byte_width(), PackedByteWidth(type)));
+    }
+    layout.arg_types.push_back(type);
+    layout.column_offsets.push_back(expected_offset);
+    expected_offset += column.byte_width();
+  }
+  if (layout.record_stride != expected_offset) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Record stride %d does not match the total packed width %d of the "
+        "columns",
+        layout.record_stride, expected_offset));
+  }
+  if (layout.payload_offset +
+          layout.record_count * layout.record_stride >
+      static_cast<int64_t>(file_contents.size())) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "File of %d bytes is too small for %d records of %d bytes",
+        file_contents.size(), layout.record_count, layout.record_stride));
+  }
+  return layout;
+}
+
+PackedArgsFileWriter::PackedArgsFileWriter(absl::Span<Type* const> arg_types)
+    : arg_types_(arg_types.begin(), arg_types.end()) {
+  int64_t offset = 0;
+  for (Type* type : arg_types_) {
+    column_offsets_.push_back(offset);
+    offset += PackedByteWidth(type);
+  }
+  record_stride_ = offset;
+}
+
+absl::Status PackedArgsFileWriter::Append(absl::Span<const Value> args) {
+  XLS_RET_CHECK_EQ(args.size(), arg_types_.size());
+  for (int64_t i = 0; i < static_cast<int64_t>(args.size()); ++i) {
+    XLS_ASSIGN_OR_RETURN(PackedValue packed,
+                         PackedValue::FromValue(args[i], arg_types_[i]));
+    records_.append(reinterpret_cast<const char*>(packed.buffer()),
+                    packed.size_in_bytes());
+  }
+  ++record_count_;
+  return absl::OkStatus();
+}
+
+absl::Status PackedArgsFileWriter::AppendPackedRecord(
+    absl::Span<const uint8_t> record) {
+  XLS_RET_CHECK_EQ(static_cast<int64_t>(record.size()), record_stride_);
+  records_.append(reinterpret_cast<const char*>(record.data()),
+                  record.size());
+  ++record_count_;
+  return absl::OkStatus();
+}
+
+absl::Status PackedArgsFileWriter::Write(
+    const std::filesystem::path& path) const {
+  PackedArgsHeaderProto header;
+  for (int64_t i = 0; i < static_cast<int64_t>(arg_types_.size()); ++i) {
+    PackedArgsColumnProto* column = header.add_columns();
+    *column->mutable_type() = arg_types_[i]->ToProto();
+    column->set_byte_offset(column_offsets_[i]);
+    column->set_byte_width(PackedByteWidth(arg_types_[i]));
+  }
+  std::string header_str = header.SerializeAsString();
+
+  std::string contents;
+  AppendUint64(kPackedArgsFileMagic, &contents);
+  AppendUint64(header_str.size(), &contents);
+  AppendUint64(record_count_, &contents);
+  AppendUint64(record_stride_, &contents);
+  contents.append(header_str);
+  // Pad so the records begin on an eight-byte boundary in the mapping.
+  contents.resize(
+      RoundUpToNearest(static_cast<int64_t>(contents.size()),
+                       int64_t{sizeof(uint64_t)}),
+      '\0');
+  contents.append(records_);
+  return SetFileContents(path, contents);
+}
+
+/* static */ absl::StatusOr<std::unique_ptr<PackedArgsFile>>
+PackedArgsFile::Open(const std::filesystem::path& path, Package* package) {
+  XLS_ASSIGN_OR_RETURN(MemoryMappedFile file, MemoryMappedFile::Open(path));
+  XLS_ASSIGN_OR_RETURN(PackedArgsFileLayout layout,
+                       ParsePackedArgsFileHeader(file.data(), package));
+  return absl::WrapUnique(
+      new PackedArgsFile(std::move(file), std::move(layout)));
+}
+
+absl::Span<const uint8_t> PackedArgsFile::records() const {
+  return absl::MakeConstSpan(
+      reinterpret_cast<const uint8_t*>(file_.data().data()) +
+          layout_.payload_offset,
+      layout_.record_count * layout_.record_stride);
+}
+
+absl::Span<const uint8_t> PackedArgsFile::record(int64_t index) const {
+  return records().subspan(index * layout_.record_stride,
+                           layout_.record_stride);
+}
+
+absl::Span<const uint8_t> PackedArgsFile::argument(int64_t record_index,
+                                                   int64_t arg_index) const {
+  return record(record_index)
+      .subspan(layout_.column_offsets[arg_index],
+               CeilOfRatio(layout_.arg_types[arg_index]->GetFlatBitCount(),
+                           int64_t{8}));
+}
+
+absl::StatusOr<std::vector<Value>> PackedArgsFile::ReadRecord(
+    int64_t record_index) const {
+  std::vector<Value> values;
+  values.reserve(layout_.arg_types.size());
+  for (int64_t i = 0; i < static_cast<int64_t>(layout_.arg_types.size());
+       ++i) {
+    XLS_ASSIGN_OR_RETURN(
+        PackedValue packed,
+        PackedValue::FromBuffer(argument(record_index, i),
+                                layout_.arg_types[i]));
+    values.push_back(packed.ToValue());
+  }
+  return values;
+}
+
+}  // namespace xls
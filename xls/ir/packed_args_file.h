@@ -0,0 +1,146 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A self-describing binary on-disk format for argument sets, replacing
+// one-textual-Value-per-line files which cost a full parse per sample.
+//
+// File layout (integers are host-endian):
+//
+//   offset 0: preamble of four uint64 fields:
+//       magic (kPackedArgsFileMagic, identifies format and version)
+//       size in bytes of the serialized header proto
+//       record count
+//       record stride in bytes
+//   offset 32: serialized PackedArgsHeaderProto describing the type and byte
+//       range of each argument column
+//   then, aligned up to 8 bytes: the records, back to back, each of exactly
+//       record-stride bytes
+//
+// Within a record, argument i is stored in the packed bit representation
+// (see xls/ir/packed_value.h) at the byte offset equal to the sum of the
+// packed sizes of the preceding arguments. This is exactly the record layout
+// consumed by FunctionJit::RunBatched, so a memory-mapped file feeds the
+// JIT's batched entry point directly with no parsing or copying.
+
+#ifndef XLS_IR_PACKED_ARGS_FILE_H_
+#define XLS_IR_PACKED_ARGS_FILE_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "xls/common/file/memory_mapped_file.h"
+#include "xls/ir/package.h"
+#include "xls/ir/type.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+
+// First eight bytes of every packed args file ("XLSARGS1").
+inline constexpr uint64_t kPackedArgsFileMagic = 0x3153475241534c58;
+
+// Returns whether `file_contents` begins with the packed args file magic.
+// Used by consumers which also accept headerless record files to pick the
+// right interpretation.
+bool IsPackedArgsFile(absl::string_view file_contents);
+
+// The decoded header of a packed args file. Types are owned by the Package
+// given to the parsing function.
+struct PackedArgsFileLayout {
+  std::vector<Type*> arg_types;
+  std::vector<int64_t> column_offsets;
+  int64_t record_count;
+  int64_t record_stride;
+  // Byte offset of the first record within the file.
+  int64_t payload_offset;
+};
+
+// Parses and validates the preamble and header of a packed args file given
+// its full (e.g. memory-mapped) contents. Consumers which map the file
+// themselves use this directly; others use PackedArgsFile::Open below.
+absl::StatusOr<PackedArgsFileLayout> ParsePackedArgsFileHeader(
+    absl::string_view file_contents, Package* package);
+
+// Accumulates argument records and writes them out as a packed args file.
+class PackedArgsFileWriter {
+ public:
+  explicit PackedArgsFileWriter(absl::Span<Type* const> arg_types);
+
+  // Packs one argument set and appends it as a record. The values must
+  // conform to the argument types.
+  absl::Status Append(absl::Span<const Value> args);
+
+  // Appends an already-packed record of exactly record_stride() bytes.
+  absl::Status AppendPackedRecord(absl::Span<const uint8_t> record);
+
+  // Writes the file. The writer may continue accumulating records and be
+  // written again.
+  absl::Status Write(const std::filesystem::path& path) const;
+
+  int64_t record_count() const { return record_count_; }
+  int64_t record_stride() const { return record_stride_; }
+
+ private:
+  std::vector<Type*> arg_types_;
+  std::vector<int64_t> column_offsets_;
+  int64_t record_stride_;
+  int64_t record_count_ = 0;
+  std::string records_;
+};
+
+// A memory-mapped packed args file. Records are read in place; nothing is
+// parsed or copied after the header.
+class PackedArgsFile {
+ public:
+  // Maps the file and validates its header. Reconstructed argument types are
+  // owned by `package`, which must outlive the returned object.
+  static absl::StatusOr<std::unique_ptr<PackedArgsFile>> Open(
+      const std::filesystem::path& path, Package* package);
+
+  int64_t record_count() const { return layout_.record_count; }
+  int64_t record_stride() const { return layout_.record_stride; }
+  absl::Span<Type* const> arg_types() const { return layout_.arg_types; }
+
+  // All records, back to back: suitable for FunctionJit::RunBatched.
+  absl::Span<const uint8_t> records() const;
+
+  // The record at the given index.
+  absl::Span<const uint8_t> record(int64_t index) const;
+
+  // The packed bytes of one argument of one record.
+  absl::Span<const uint8_t> argument(int64_t record_index,
+                                     int64_t arg_index) const;
+
+  // Expands one record into Value trees, for consumers which do not operate
+  // on the packed representation.
+  absl::StatusOr<std::vector<Value>> ReadRecord(int64_t record_index) const;
+
+ private:
+  PackedArgsFile(MemoryMappedFile file, PackedArgsFileLayout layout)
+      : file_(std::move(file)), layout_(std::move(layout)) {}
+
+  MemoryMappedFile file_;
+  PackedArgsFileLayout layout_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_IR_PACKED_ARGS_FILE_H_
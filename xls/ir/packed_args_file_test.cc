@@ -0,0 +1,119 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/packed_args_file.h"
+
+#include <memory>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using status_testing::StatusIs;
+
+TEST(PackedArgsFileTest, WriteReadRoundtrip) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  std::filesystem::path path = temp_dir.path() / "args.bin";
+
+  Package package("test_package");
+  Type* u16 = package.GetBitsType(16);
+  Type* tuple = package.GetTupleType({package.GetBitsType(8), u16});
+
+  PackedArgsFileWriter writer({u16, tuple});
+  EXPECT_EQ(writer.record_stride(), 2 + 3);
+  for (int64_t i = 0; i < 10; ++i) {
+    XLS_ASSERT_OK(writer.Append(
+        {Value(UBits(i * 1000, 16)),
+         Value::Tuple({Value(UBits(i, 8)), Value(UBits(i * 2, 16))})}));
+  }
+  XLS_ASSERT_OK(writer.Write(path));
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<PackedArgsFile> file,
+                           PackedArgsFile::Open(path, &package));
+  EXPECT_EQ(file->record_count(), 10);
+  EXPECT_EQ(file->record_stride(), writer.record_stride());
+  EXPECT_THAT(file->arg_types(), ElementsAre(u16, tuple));
+  EXPECT_EQ(file->records().size(), 10 * writer.record_stride());
+  for (int64_t i = 0; i < 10; ++i) {
+    XLS_ASSERT_OK_AND_ASSIGN(std::vector<Value> values, file->ReadRecord(i));
+    EXPECT_THAT(
+        values,
+        ElementsAre(Value(UBits(i * 1000, 16)),
+                    Value::Tuple(
+                        {Value(UBits(i, 8)), Value(UBits(i * 2, 16))})));
+  }
+}
+
+TEST(PackedArgsFileTest, RecordsAreContiguousAndAligned) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  std::filesystem::path path = temp_dir.path() / "args.bin";
+
+  Package package("test_package");
+  Type* u64 = package.GetBitsType(64);
+  PackedArgsFileWriter writer({u64});
+  uint8_t record[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  XLS_ASSERT_OK(writer.AppendPackedRecord(record));
+  XLS_ASSERT_OK(writer.Write(path));
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<PackedArgsFile> file,
+                           PackedArgsFile::Open(path, &package));
+  ASSERT_EQ(file->records().size(), 8);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(file->records().data()) % 8, 0);
+  EXPECT_THAT(file->record(0), ElementsAre(1, 2, 3, 4, 5, 6, 7, 8));
+}
+
+TEST(PackedArgsFileTest, RejectsNonArgsFile) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  std::filesystem::path path = temp_dir.path() / "not_args.bin";
+  XLS_ASSERT_OK(SetFileContents(path, "bits[32]:42\nbits[32]:123\n"));
+
+  Package package("test_package");
+  EXPECT_FALSE(IsPackedArgsFile("bits[32]:42"));
+  EXPECT_THAT(PackedArgsFile::Open(path, &package).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("bad magic")));
+}
+
+TEST(PackedArgsFileTest, RejectsTruncatedPayload) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  std::filesystem::path path = temp_dir.path() / "args.bin";
+
+  Package package("test_package");
+  Type* u32 = package.GetBitsType(32);
+  PackedArgsFileWriter writer({u32});
+  XLS_ASSERT_OK(writer.Append({Value(UBits(7, 32))}));
+  XLS_ASSERT_OK(writer.Append({Value(UBits(8, 32))}));
+  XLS_ASSERT_OK(writer.Write(path));
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::string contents, GetFileContents(path));
+  XLS_ASSERT_OK(SetFileContents(
+      path, absl::string_view(contents).substr(0, contents.size() - 4)));
+  EXPECT_THAT(PackedArgsFile::Open(path, &package).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("too small")));
+}
+
+}  // namespace
+}  // namespace xls
@@ -0,0 +1,148 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/packed_value.h"
+
+#include "absl/container/inlined_vector.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/math_util.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/value_helpers.h"
+
+namespace xls {
+namespace {
+
+// Writes the flat bits of `value` into `buffer` starting at `bit_offset`.
+void PackValueAtOffset(const Value& value, const Type* type,
+                       int64_t bit_offset, absl::Span<uint8_t> buffer) {
+  switch (type->kind()) {
+    case TypeKind::kBits: {
+      const Bits& bits = value.bits();
+      for (int64_t i = 0; i < bits.bit_count(); ++i) {
+        if (bits.Get(i)) {
+          int64_t bit = bit_offset + i;
+          buffer[bit / 8] |= uint8_t{1} << (bit % 8);
+        }
+      }
+      return;
+    }
+    case TypeKind::kArray: {
+      const ArrayType* array_type = type->AsArrayOrDie();
+      Type* element_type = array_type->element_type();
+      for (int64_t i = 0; i < array_type->size(); ++i) {
+        PackValueAtOffset(value.element(i), element_type,
+                          bit_offset + i * element_type->GetFlatBitCount(),
+                          buffer);
+      }
+      return;
+    }
+    case TypeKind::kTuple: {
+      // Tuple elements are packed starting from the last element, mirroring
+      // the flattening order of the packed views.
+      const TupleType* tuple_type = type->AsTupleOrDie();
+      for (int64_t i = tuple_type->size() - 1; i >= 0; --i) {
+        PackValueAtOffset(value.element(i), tuple_type->element_type(i),
+                          bit_offset, buffer);
+        bit_offset += tuple_type->element_type(i)->GetFlatBitCount();
+      }
+      return;
+    }
+    case TypeKind::kToken:
+      // Tokens are zero-bit constructs, so there's nothing to do!
+      return;
+  }
+  XLS_LOG(FATAL) << "Invalid type kind: " << static_cast<int>(type->kind());
+}
+
+// Reads the flat bits starting at `bit_offset` in `buffer` and expands them
+// into a Value of the given type.
+Value UnpackValueAtOffset(const Type* type, int64_t bit_offset,
+                          absl::Span<const uint8_t> buffer) {
+  switch (type->kind()) {
+    case TypeKind::kBits: {
+      int64_t bit_count = type->AsBitsOrDie()->bit_count();
+      absl::InlinedVector<bool, 64> bits(bit_count);
+      for (int64_t i = 0; i < bit_count; ++i) {
+        int64_t bit = bit_offset + i;
+        bits[i] = (buffer[bit / 8] >> (bit % 8)) & 1;
+      }
+      return Value(Bits(bits));
+    }
+    case TypeKind::kArray: {
+      const ArrayType* array_type = type->AsArrayOrDie();
+      Type* element_type = array_type->element_type();
+      std::vector<Value> elements;
+      for (int64_t i = 0; i < array_type->size(); ++i) {
+        elements.push_back(UnpackValueAtOffset(
+            element_type, bit_offset + i * element_type->GetFlatBitCount(),
+            buffer));
+      }
+      return Value::ArrayOrDie(elements);
+    }
+    case TypeKind::kTuple: {
+      const TupleType* tuple_type = type->AsTupleOrDie();
+      std::vector<Value> elements(tuple_type->size());
+      for (int64_t i = tuple_type->size() - 1; i >= 0; --i) {
+        elements[i] =
+            UnpackValueAtOffset(tuple_type->element_type(i), bit_offset,
+                                buffer);
+        bit_offset += tuple_type->element_type(i)->GetFlatBitCount();
+      }
+      return Value::Tuple(elements);
+    }
+    case TypeKind::kToken:
+      return Value::Token();
+  }
+  XLS_LOG(FATAL) << "Invalid type kind: " << static_cast<int>(type->kind());
+}
+
+}  // namespace
+
+PackedValue::PackedValue(Type* type)
+    : data_(CeilOfRatio(type->GetFlatBitCount(), int64_t{8})), type_(type) {}
+
+PackedValue::PackedValue(std::vector<uint8_t> data, Type* type)
+    : data_(std::move(data)), type_(type) {}
+
+/* static */ absl::StatusOr<PackedValue> PackedValue::FromValue(
+    const Value& value, Type* type) {
+  if (!ValueConformsToType(value, type)) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Value %s does not conform to type %s",
+                        value.ToString(), type->ToString()));
+  }
+  PackedValue packed(type);
+  PackValueAtOffset(value, type, /*bit_offset=*/0,
+                    absl::MakeSpan(packed.data_));
+  return packed;
+}
+
+/* static */ absl::StatusOr<PackedValue> PackedValue::FromBuffer(
+    absl::Span<const uint8_t> buffer, Type* type) {
+  int64_t expected_size = CeilOfRatio(type->GetFlatBitCount(), int64_t{8});
+  if (static_cast<int64_t>(buffer.size()) != expected_size) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Buffer of %d bytes cannot hold packed value of type %s (%d bytes)",
+        buffer.size(), type->ToString(), expected_size));
+  }
+  return PackedValue(std::vector<uint8_t>(buffer.begin(), buffer.end()), type);
+}
+
+Value PackedValue::ToValue() const {
+  return UnpackValueAtOffset(type_, /*bit_offset=*/0, data_);
+}
+
+}  // namespace xls
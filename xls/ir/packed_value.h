@@ -0,0 +1,73 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_IR_PACKED_VALUE_H_
+#define XLS_IR_PACKED_VALUE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/ir/type.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+
+// An owning container for an XLS value stored in the packed data
+// representation consumed by the JIT's packed-view entry points (see
+// value_view.h): the flat bits of the value are tightly concatenated with no
+// padding bits or bytes, least-significant bit first within each byte. Array
+// elements are packed in index order starting at the least-significant end;
+// tuple elements are packed starting from the last element, mirroring the
+// flattening order of the packed views.
+//
+// Unlike a Value, a PackedValue is a single contiguous buffer: it can be
+// written to or read from files, copied, and handed to packed-view-consuming
+// interfaces (e.g. FunctionJit::RunWithPackedBuffers) without walking a value
+// tree. Conversion to and from Value happens only at the edges via FromValue
+// and ToValue.
+class PackedValue {
+ public:
+  // Constructs a zero-valued PackedValue of the given type.
+  explicit PackedValue(Type* type);
+
+  // Constructs a PackedValue holding the given value. Returns an error if the
+  // value does not conform to the given type.
+  static absl::StatusOr<PackedValue> FromValue(const Value& value, Type* type);
+
+  // Constructs a PackedValue from an existing packed buffer. The buffer is
+  // copied; it must be exactly the packed size of the type.
+  static absl::StatusOr<PackedValue> FromBuffer(
+      absl::Span<const uint8_t> buffer, Type* type);
+
+  // Expands the packed representation into a Value tree.
+  Value ToValue() const;
+
+  uint8_t* buffer() { return data_.data(); }
+  const uint8_t* buffer() const { return data_.data(); }
+  absl::Span<const uint8_t> bytes() const { return data_; }
+  int64_t size_in_bytes() const { return static_cast<int64_t>(data_.size()); }
+  Type* type() const { return type_; }
+
+ private:
+  PackedValue(std::vector<uint8_t> data, Type* type);
+
+  std::vector<uint8_t> data_;
+  Type* type_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_IR_PACKED_VALUE_H_
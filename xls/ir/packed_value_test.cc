@@ -0,0 +1,103 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/packed_value.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+namespace {
+
+using status_testing::StatusIs;
+using testing::ElementsAre;
+using testing::HasSubstr;
+
+TEST(PackedValueTest, BitsRoundTrip) {
+  Package package("test");
+  Type* u12 = package.GetBitsType(12);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      PackedValue packed,
+      PackedValue::FromValue(Value(UBits(0xabc, 12)), u12));
+  EXPECT_EQ(packed.size_in_bytes(), 2);
+  // Least-significant bit first: low byte, then the remaining four bits.
+  EXPECT_THAT(packed.bytes(), ElementsAre(0xbc, 0x0a));
+  EXPECT_EQ(packed.ToValue(), Value(UBits(0xabc, 12)));
+}
+
+TEST(PackedValueTest, TuplePacksLastElementFirst) {
+  Package package("test");
+  Type* type =
+      package.GetTupleType({package.GetBitsType(4), package.GetBitsType(8)});
+  Value value = Value::Tuple({Value(UBits(0xa, 4)), Value(UBits(0xbc, 8))});
+  XLS_ASSERT_OK_AND_ASSIGN(PackedValue packed,
+                           PackedValue::FromValue(value, type));
+  // The last tuple element occupies the least-significant bits.
+  EXPECT_THAT(packed.bytes(), ElementsAre(0xbc, 0x0a));
+  EXPECT_EQ(packed.ToValue(), value);
+}
+
+TEST(PackedValueTest, ArrayPacksElementZeroFirst) {
+  Package package("test");
+  Type* type = package.GetArrayType(3, package.GetBitsType(4));
+  Value value = Value::ArrayOrDie(
+      {Value(UBits(0x1, 4)), Value(UBits(0x2, 4)), Value(UBits(0x3, 4))});
+  XLS_ASSERT_OK_AND_ASSIGN(PackedValue packed,
+                           PackedValue::FromValue(value, type));
+  EXPECT_THAT(packed.bytes(), ElementsAre(0x21, 0x03));
+  EXPECT_EQ(packed.ToValue(), value);
+}
+
+TEST(PackedValueTest, NestedRoundTrip) {
+  Package package("test");
+  Type* type = package.GetTupleType(
+      {package.GetArrayType(2, package.GetBitsType(7)),
+       package.GetTupleType({package.GetBitsType(1), package.GetBitsType(33)}),
+       package.GetTokenType()});
+  Value value = Value::Tuple(
+      {Value::ArrayOrDie({Value(UBits(0x55, 7)), Value(UBits(0x2a, 7))}),
+       Value::Tuple({Value(UBits(1, 1)), Value(UBits(0x123456789, 33))}),
+       Value::Token()});
+  XLS_ASSERT_OK_AND_ASSIGN(PackedValue packed,
+                           PackedValue::FromValue(value, type));
+  EXPECT_EQ(packed.size_in_bytes(), 6);
+  EXPECT_EQ(packed.ToValue(), value);
+}
+
+TEST(PackedValueTest, FromBufferRoundTrip) {
+  Package package("test");
+  Type* u16 = package.GetBitsType(16);
+  std::vector<uint8_t> buffer = {0x34, 0x12};
+  XLS_ASSERT_OK_AND_ASSIGN(PackedValue packed,
+                           PackedValue::FromBuffer(buffer, u16));
+  EXPECT_EQ(packed.ToValue(), Value(UBits(0x1234, 16)));
+}
+
+TEST(PackedValueTest, Errors) {
+  Package package("test");
+  Type* u16 = package.GetBitsType(16);
+  EXPECT_THAT(PackedValue::FromValue(Value(UBits(0, 8)), u16).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("does not conform")));
+  EXPECT_THAT(PackedValue::FromBuffer({0x12}, u16).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("cannot hold packed value")));
+}
+
+}  // namespace
+}  // namespace xls
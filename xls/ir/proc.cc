@@ -81,6 +81,10 @@ absl::Status Proc::SetNextToken(Node* next) {
         "Cannot set next token to \"%s\", expected token type but has type %s",
         next->GetName(), next->GetType()->ToString()));
   }
+  if (next_token_ != nullptr && next_token_ != next) {
+    // The old next-token loses its implicit use and may now be dead.
+    AddDeadNodeCandidate(next_token_);
+  }
   next_token_ = next;
   return absl::OkStatus();
 }
@@ -115,6 +119,10 @@ absl::Status Proc::SetNextStateElement(int64_t index, Node* next) {
         index, next->GetName(), next->GetType()->ToString(),
         GetStateElementType(index)->ToString()));
   }
+  if (next_state_[index] != nullptr && next_state_[index] != next) {
+    // The old next-state node loses its implicit use and may now be dead.
+    AddDeadNodeCandidate(next_state_[index]);
+  }
   next_state_[index] = next;
   return absl::OkStatus();
 }
@@ -173,6 +181,10 @@ absl::StatusOr<Param*> Proc::ReplaceStateElement(
 
 absl::Status Proc::RemoveStateElement(int64_t index) {
   XLS_RET_CHECK_LT(index, GetStateElementCount());
+  if (next_state_[index] != nullptr) {
+    // The next-state node loses its implicit use and may now be dead.
+    AddDeadNodeCandidate(next_state_[index]);
+  }
   next_state_.erase(next_state_.begin() + index);
   if (!StateParams()[index]->users().empty()) {
     return absl::InvalidArgumentError(
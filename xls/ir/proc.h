@@ -16,6 +16,7 @@
 #define XLS_IR_PROC_H_
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/memory/memory.h"
 #include "absl/strings/string_view.h"
 #include "xls/ir/function_base.h"
 #include "xls/ir/node.h"
@@ -34,8 +35,10 @@ class Proc : public FunctionBase {
   Proc(absl::string_view name, absl::string_view token_param_name,
        Package* package)
       : FunctionBase(name, package),
-        next_token_(AddNode(std::make_unique<Param>(
-            SourceInfo(), token_param_name, package->GetTokenType(), this))) {}
+        next_token_(AddNode(absl::WrapUnique(
+            new (package->node_arena()) Param(SourceInfo(), token_param_name,
+                                              package->GetTokenType(), this)))) {
+  }
 
   virtual ~Proc() = default;
 
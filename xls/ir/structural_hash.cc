@@ -0,0 +1,111 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/structural_hash.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "absl/hash/hash.h"
+#include "absl/types/span.h"
+#include "xls/common/logging/logging.h"
+#include "xls/ir/node_util.h"
+#include "xls/ir/op.h"
+
+namespace xls {
+namespace {
+
+// Returns the operands of the given node in the order used for hashing and
+// equivalence comparison. Commutative operations are agnostic to operand
+// order, so their operands are sorted by id to compare as an unordered set.
+// To avoid constructing a vector in the (common) non-commutative case a span
+// is returned; for commutative ops the sorted vector is built in
+// `span_backing_store`.
+absl::Span<Node* const> OperandsForHashing(
+    Node* node, std::vector<Node*>* span_backing_store) {
+  XLS_CHECK(span_backing_store->empty());
+  if (!OpIsCommutative(node->op())) {
+    return node->operands();
+  }
+  span_backing_store->insert(span_backing_store->begin(),
+                             node->operands().begin(), node->operands().end());
+  SortByNodeId(span_backing_store);
+  return *span_backing_store;
+}
+
+}  // namespace
+
+int64_t StructuralHash(Node* node) {
+  std::vector<int64_t> values_to_hash = {static_cast<int64_t>(node->op())};
+  std::vector<Node*> span_backing_store;
+  for (Node* operand : OperandsForHashing(node, &span_backing_store)) {
+    values_to_hash.push_back(operand->id());
+  }
+  // If this is slow because of many literals, the Literal values could be
+  // combined into the hash. As is, all literals get the same hash value.
+  return static_cast<int64_t>(
+      absl::Hash<std::vector<int64_t>>()(values_to_hash));
+}
+
+/* static */ StructuralHashIndex StructuralHashIndex::ForFunctionBase(
+    FunctionBase* f) {
+  StructuralHashIndex index;
+  index.buckets_.reserve(f->node_count());
+  for (Node* node : f->nodes()) {
+    if (!OpIsSideEffecting(node->op())) {
+      index.Add(node);
+    }
+  }
+  return index;
+}
+
+void StructuralHashIndex::Add(Node* node) {
+  buckets_[StructuralHash(node)].push_back(node);
+}
+
+void StructuralHashIndex::Remove(Node* node) {
+  auto it = buckets_.find(StructuralHash(node));
+  if (it == buckets_.end()) {
+    return;
+  }
+  std::vector<Node*>& bucket = it->second;
+  bucket.erase(std::remove(bucket.begin(), bucket.end(), node), bucket.end());
+  if (bucket.empty()) {
+    buckets_.erase(it);
+  }
+}
+
+Node* StructuralHashIndex::FindEquivalent(Node* node) const {
+  auto it = buckets_.find(StructuralHash(node));
+  if (it == buckets_.end()) {
+    return nullptr;
+  }
+  std::vector<Node*> node_span_backing_store;
+  absl::Span<Node* const> node_operands =
+      OperandsForHashing(node, &node_span_backing_store);
+  for (Node* candidate : it->second) {
+    if (candidate == node) {
+      continue;
+    }
+    std::vector<Node*> candidate_span_backing_store;
+    if (node_operands ==
+            OperandsForHashing(candidate, &candidate_span_backing_store) &&
+        node->IsDefinitelyEqualTo(candidate)) {
+      return candidate;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace xls
@@ -0,0 +1,68 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_IR_STRUCTURAL_HASH_H_
+#define XLS_IR_STRUCTURAL_HASH_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "xls/ir/function_base.h"
+#include "xls/ir/node.h"
+
+namespace xls {
+
+// Returns a structural hash of the given node computed from the node's op and
+// the identities of its operands. Operands of commutative ops are hashed as
+// an unordered collection, so e.g. add(x, y) and add(y, x) collide. The hash
+// is consistent with Node::IsDefinitelyEqualTo combined with operand
+// identity: nodes which are equivalent in that sense hash identically (the
+// converse does not hold -- callers must confirm candidates).
+int64_t StructuralHash(Node* node);
+
+// Index from structural hash to nodes, answering "does an equivalent node
+// already exist?" without each client rebuilding its own hash table. Callers
+// decide which nodes participate (e.g. CSE excludes side-effecting nodes) and
+// keep the index in step with graph mutations via Add/Remove; FindEquivalent
+// only consults nodes added so far, so a topological sweep which adds nodes
+// as it visits them sees canonicalized operands.
+class StructuralHashIndex {
+ public:
+  StructuralHashIndex() = default;
+
+  // Builds an index seeded with all non-side-effecting nodes of `f`.
+  static StructuralHashIndex ForFunctionBase(FunctionBase* f);
+
+  // Adds `node` to the index.
+  void Add(Node* node);
+
+  // Removes `node` from the index; no-op if the node was never added. Call
+  // before mutating a node's operands (the index locates nodes by their
+  // current hash).
+  void Remove(Node* node);
+
+  // Returns a node in the index which always produces the same value as
+  // `node` -- same structural hash, equal operands (unordered for commutative
+  // ops) and Node::IsDefinitelyEqualTo -- or nullptr if there is none. `node`
+  // itself is never returned.
+  Node* FindEquivalent(Node* node) const;
+
+ private:
+  absl::flat_hash_map<int64_t, std::vector<Node*>> buckets_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_IR_STRUCTURAL_HASH_H_
@@ -0,0 +1,86 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/structural_hash.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/function.h"
+#include "xls/ir/ir_test_base.h"
+
+namespace xls {
+namespace {
+
+class StructuralHashTest : public IrTestBase {};
+
+TEST_F(StructuralHashTest, CommutativeOperandsHashEqual) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+fn hash(x: bits[8], y: bits[8]) -> bits[8] {
+  add.1: bits[8] = add(x, y)
+  add.2: bits[8] = add(y, x)
+  ret sub.3: bits[8] = sub(add.1, add.2)
+}
+)",
+                                                       p.get()));
+  EXPECT_EQ(StructuralHash(FindNode("add.1", f)),
+            StructuralHash(FindNode("add.2", f)));
+  // sub is not commutative; swapped operands would hash differently, and a
+  // different op certainly does.
+  EXPECT_NE(StructuralHash(FindNode("add.1", f)),
+            StructuralHash(FindNode("sub.3", f)));
+}
+
+TEST_F(StructuralHashTest, FindEquivalentRespectsOpAndOperands) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+fn hash(x: bits[8], y: bits[8]) -> bits[8] {
+  add.1: bits[8] = add(x, y)
+  add.2: bits[8] = add(y, x)
+  sub.3: bits[8] = sub(x, y)
+  sub.4: bits[8] = sub(y, x)
+  ret or.5: bits[8] = or(add.1, sub.3)
+}
+)",
+                                                       p.get()));
+  StructuralHashIndex index = StructuralHashIndex::ForFunctionBase(f);
+
+  // add(y, x) is equivalent to add(x, y); sub(y, x) is not equivalent to
+  // sub(x, y).
+  EXPECT_EQ(index.FindEquivalent(FindNode("add.2", f)), FindNode("add.1", f));
+  EXPECT_EQ(index.FindEquivalent(FindNode("sub.4", f)), nullptr);
+
+  // A node is never its own equivalent.
+  EXPECT_EQ(index.FindEquivalent(FindNode("or.5", f)), nullptr);
+}
+
+TEST_F(StructuralHashTest, RemoveTakesNodeOutOfTheIndex) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+fn hash(x: bits[8], y: bits[8]) -> bits[8] {
+  add.1: bits[8] = add(x, y)
+  ret add.2: bits[8] = add(y, x)
+}
+)",
+                                                       p.get()));
+  StructuralHashIndex index = StructuralHashIndex::ForFunctionBase(f);
+  ASSERT_EQ(index.FindEquivalent(FindNode("add.2", f)), FindNode("add.1", f));
+
+  index.Remove(FindNode("add.1", f));
+  EXPECT_EQ(index.FindEquivalent(FindNode("add.2", f)), nullptr);
+}
+
+}  // namespace
+}  // namespace xls
@@ -235,12 +235,25 @@ void Value::FlattenTo(BitPushBuffer* buffer) const {
 }
 
 absl::StatusOr<std::vector<Value>> Value::GetElements() const {
-  if (!absl::holds_alternative<std::vector<Value>>(payload_)) {
+  if (!absl::holds_alternative<ElementsRep>(payload_)) {
     return absl::InvalidArgumentError("Value does not hold elements.");
   }
   return std::vector<Value>(elements().begin(), elements().end());
 }
 
+std::vector<Value> Value::ReleaseElements() && {
+  XLS_CHECK(absl::holds_alternative<ElementsRep>(payload_))
+      << "Value does not hold elements.";
+  ElementsRep storage = std::move(absl::get<ElementsRep>(payload_));
+  kind_ = ValueKind::kInvalid;
+  payload_ = nullptr;
+  if (storage.use_count() == 1) {
+    return std::move(*storage);
+  }
+  // The storage is shared with other values; those must not observe the move.
+  return *storage;
+}
+
 absl::StatusOr<Bits> Value::GetBitsWithStatus() const {
   if (!IsBits()) {
     return absl::InvalidArgumentError(
@@ -15,9 +15,13 @@
 #ifndef XLS_IR_VALUE_H_
 #define XLS_IR_VALUE_H_
 
+#include <memory>
+#include <vector>
+
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
 #include "absl/types/variant.h"
+#include "xls/common/allocation_accounting.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/xls_type.pb.h"
 
@@ -59,7 +63,7 @@ class Value {
     return Value(ValueKind::kTuple, elements);
   }
   static Value TupleOwned(std::vector<Value>&& elements) {
-    return Value(ValueKind::kTuple, elements);
+    return Value(ValueKind::kTuple, std::move(elements));
   }
 
   // All members of "elements" must be of the same type, or an error status will
@@ -108,8 +112,14 @@ class Value {
 
   absl::StatusOr<std::vector<Value>> GetElements() const;
 
+  // Moves the elements out of this value, leaving the value invalid. When
+  // this value holds the only reference to its aggregate storage no element
+  // is copied; otherwise this degenerates to a deep copy. Useful for
+  // consuming interpreter/JIT results without duplicating large aggregates.
+  std::vector<Value> ReleaseElements() &&;
+
   absl::Span<const Value> elements() const {
-    return absl::get<std::vector<Value>>(payload_);
+    return *absl::get<ElementsRep>(payload_);
   }
   const Value& element(int64_t i) const { return elements().at(i); }
   int64_t size() const { return elements().size(); }
@@ -147,15 +157,35 @@ class Value {
   bool operator!=(const Value& other) const { return !(*this == other); }
 
  private:
+  // Aggregate (tuple/array) elements are held behind a shared pointer so
+  // copying a Value -- ubiquitous in the interpreters and JIT glue -- shares
+  // rather than deep-copies the element storage. The storage is never
+  // mutated after construction except by ReleaseElements() on a uniquely
+  // owned value.
+  using ElementsRep = std::shared_ptr<std::vector<Value>>;
+
   Value(ValueKind kind, absl::Span<const Value> elements)
       : kind_(kind),
-        payload_(std::vector<Value>(elements.begin(), elements.end())) {}
+        payload_(std::make_shared<std::vector<Value>>(elements.begin(),
+                                                      elements.end())) {
+    // Accounts the fresh element storage; the element Values themselves
+    // record their own payloads.
+    XLS_RECORD_ALLOCATION(
+        AllocationCategory::kValue,
+        static_cast<int64_t>(elements.size() * sizeof(Value)));
+  }
 
   Value(ValueKind kind, std::vector<Value>&& elements)
-      : kind_(kind), payload_(std::move(elements)) {}
+      : kind_(kind),
+        payload_(std::make_shared<std::vector<Value>>(std::move(elements))) {
+    XLS_RECORD_ALLOCATION(
+        AllocationCategory::kValue,
+        static_cast<int64_t>(
+            absl::get<ElementsRep>(payload_)->size() * sizeof(Value)));
+  }
 
   ValueKind kind_;
-  absl::variant<std::nullptr_t, std::vector<Value>, Bits> payload_;
+  absl::variant<std::nullptr_t, ElementsRep, Bits> payload_;
 };
 
 inline std::ostream& operator<<(std::ostream& os, const Value& value) {
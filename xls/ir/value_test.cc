@@ -330,4 +330,23 @@ TEST(ValueTest, XBitsArrayWrongSizes) {
               HasSubstr("elements of arrays should have consistent size."));
 }
 
+TEST(ValueTest, ReleaseElementsMovesUniqueStorage) {
+  Value tuple = Value::Tuple({Value(UBits(1, 8)), Value(UBits(2, 8))});
+  std::vector<Value> elements = std::move(tuple).ReleaseElements();
+  ASSERT_EQ(elements.size(), 2);
+  EXPECT_EQ(elements[0], Value(UBits(1, 8)));
+  EXPECT_EQ(elements[1], Value(UBits(2, 8)));
+  EXPECT_EQ(tuple.kind(), ValueKind::kInvalid);
+}
+
+TEST(ValueTest, ReleaseElementsWithSharedStorageCopies) {
+  Value tuple = Value::Tuple({Value(UBits(1, 8)), Value(UBits(2, 8))});
+  Value copy = tuple;
+  std::vector<Value> elements = std::move(tuple).ReleaseElements();
+  ASSERT_EQ(elements.size(), 2);
+  // The copy shares storage and must be unaffected by the release.
+  EXPECT_EQ(copy.element(0), Value(UBits(1, 8)));
+  EXPECT_EQ(copy.element(1), Value(UBits(2, 8)));
+}
+
 }  // namespace xls
@@ -1689,24 +1689,11 @@ absl::Status VerifyChannels(Package* package, bool codegen) {
   return absl::OkStatus();
 }
 
-}  // namespace
-
-absl::Status VerifyPackage(Package* package, bool codegen) {
-  XLS_VLOG(4) << absl::StreamFormat("Verifying package %s:\n", package->name());
-  XLS_VLOG_LINES(4, package->DumpIr());
-
-  for (auto& function : package->functions()) {
-    XLS_RETURN_IF_ERROR(VerifyFunction(function.get(), codegen));
-  }
-
-  for (auto& proc : package->procs()) {
-    XLS_RETURN_IF_ERROR(VerifyProc(proc.get(), codegen));
-  }
-
-  for (auto& block : package->blocks()) {
-    XLS_RETURN_IF_ERROR(VerifyBlock(block.get(), codegen));
-  }
-
+// Verifies the package-scoped invariants which are not attributable to a
+// single function base: node ID uniqueness, package uplinks, name uniqueness
+// and channel invariants. Shared by VerifyPackage and
+// VerifyPackageIncremental.
+absl::Status VerifyPackageScopedInvariants(Package* package, bool codegen) {
   // Verify node IDs are unique within the package and uplinks point to this
   // package.
   absl::flat_hash_set<int64_t> ids;
@@ -1763,6 +1750,67 @@ absl::Status VerifyPackage(Package* package, bool codegen) {
   return absl::OkStatus();
 }
 
+// Dispatches to the kind-specific verifier for a single function base.
+absl::Status VerifyFunctionBaseDispatch(FunctionBase* function_base,
+                                        bool codegen) {
+  if (function_base->IsFunction()) {
+    return VerifyFunction(function_base->AsFunctionOrDie(), codegen);
+  }
+  if (function_base->IsProc()) {
+    return VerifyProc(function_base->AsProcOrDie(), codegen);
+  }
+  XLS_RET_CHECK(function_base->IsBlock());
+  return VerifyBlock(function_base->AsBlockOrDie(), codegen);
+}
+
+}  // namespace
+
+absl::Status VerifyPackage(Package* package, bool codegen) {
+  XLS_VLOG(4) << absl::StreamFormat("Verifying package %s:\n", package->name());
+  XLS_VLOG_LINES(4, package->DumpIr());
+
+  for (auto& function : package->functions()) {
+    XLS_RETURN_IF_ERROR(VerifyFunction(function.get(), codegen));
+  }
+
+  for (auto& proc : package->procs()) {
+    XLS_RETURN_IF_ERROR(VerifyProc(proc.get(), codegen));
+  }
+
+  for (auto& block : package->blocks()) {
+    XLS_RETURN_IF_ERROR(VerifyBlock(block.get(), codegen));
+  }
+
+  return VerifyPackageScopedInvariants(package, codegen);
+}
+
+absl::Status VerifyPackageIncremental(
+    Package* package,
+    absl::flat_hash_map<FunctionBase*, int64_t>* verified_journals,
+    bool codegen) {
+  XLS_VLOG(4) << absl::StreamFormat("Incrementally verifying package %s:\n",
+                                    package->name());
+
+  // Rebuild the journal map from scratch so entries for function bases which
+  // have since been deleted do not accumulate (and so a recycled address is
+  // never mistaken for an already-verified function).
+  absl::flat_hash_map<FunctionBase*, int64_t> next_journals;
+  next_journals.reserve(package->GetFunctionBases().size());
+  for (FunctionBase* function_base : package->GetFunctionBases()) {
+    int64_t journal = function_base->transform_journal();
+    auto it = verified_journals->find(function_base);
+    if (it == verified_journals->end() || it->second != journal) {
+      XLS_RETURN_IF_ERROR(VerifyFunctionBaseDispatch(function_base, codegen));
+    }
+    next_journals[function_base] = journal;
+  }
+
+  XLS_RETURN_IF_ERROR(VerifyPackageScopedInvariants(package, codegen));
+
+  *verified_journals = std::move(next_journals);
+  return absl::OkStatus();
+}
+
 absl::Status VerifyFunction(Function* function, bool codegen) {
   XLS_VLOG(4) << "Verifying function:\n";
   XLS_VLOG_LINES(4, function->DumpIr());
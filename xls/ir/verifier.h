@@ -15,12 +15,16 @@
 #ifndef XLS_IR_VERIFIER_H_
 #define XLS_IR_VERIFIER_H_
 
+#include <cstdint>
+
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 
 namespace xls {
 
 class Node;
 class Function;
+class FunctionBase;
 class Proc;
 class Block;
 class Package;
@@ -33,6 +37,22 @@ absl::Status VerifyProc(Proc* Proc, bool codegen = false);
 absl::Status VerifyBlock(Block* Block, bool codegen = false);
 absl::Status VerifyNode(Node* Node, bool codegen = false);
 
+// As VerifyPackage, but skips per-node verification of any function base
+// whose transform journal (FunctionBase::transform_journal) matches the value
+// recorded in `verified_journals` -- that is, any function base which has not
+// been mutated since the previous successful call with the same map. Package-
+// scoped invariants (node ID uniqueness, name uniqueness, channels) are
+// cheap and always checked. On success `verified_journals` is updated to the
+// current journal values; stale entries for deleted function bases are
+// dropped. Pass an empty map to verify everything.
+//
+// This is the workhorse behind always-on verification in pass pipelines; see
+// VerifierChecker.
+absl::Status VerifyPackageIncremental(
+    Package* package,
+    absl::flat_hash_map<FunctionBase*, int64_t>* verified_journals,
+    bool codegen = false);
+
 }  // namespace xls
 
 #endif  // XLS_IR_VERIFIER_H_
@@ -14,6 +14,9 @@
 
 #include "xls/ir/verifier.h"
 
+#include <cstdint>
+
+#include "absl/container/flat_hash_map.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "xls/common/status/matchers.h"
@@ -52,6 +55,38 @@ fn graph2(a: bits[16]) -> bits[16] {
   XLS_ASSERT_OK(VerifyFunction(FindFunction("graph2", p.get())));
 }
 
+TEST_F(VerifierTest, IncrementalVerificationTracksJournals) {
+  std::string input = R"(
+package IncrementalVerification
+
+fn graph(p: bits[42], q: bits[42]) -> bits[42] {
+  and.1: bits[42] = and(p, q)
+  add.2: bits[42] = add(and.1, q)
+  ret sub.3: bits[42] = sub(add.2, add.2)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, ParsePackageNoVerify(input));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, p->GetFunction("graph"));
+
+  absl::flat_hash_map<FunctionBase*, int64_t> journals;
+  XLS_ASSERT_OK(VerifyPackageIncremental(p.get(), &journals));
+  ASSERT_TRUE(journals.contains(f));
+  EXPECT_EQ(journals.at(f), f->transform_journal());
+
+  // Unchanged package: the recorded journal stays put.
+  XLS_ASSERT_OK(VerifyPackageIncremental(p.get(), &journals));
+  EXPECT_EQ(journals.at(f), f->transform_journal());
+
+  // A graph mutation bumps the journal; the next incremental verification
+  // re-checks the function and records the new value.
+  int64_t journal_before = f->transform_journal();
+  XLS_ASSERT_OK(
+      f->return_value()->ReplaceOperandNumber(0, f->param(0)));
+  EXPECT_GT(f->transform_journal(), journal_before);
+  XLS_ASSERT_OK(VerifyPackageIncremental(p.get(), &journals));
+  EXPECT_EQ(journals.at(f), f->transform_journal());
+}
+
 TEST_F(VerifierTest, NonUniqueNodeId) {
   std::string input = R"(
 package NonUniqueNodeId
@@ -15,7 +15,9 @@
 // Driver for the XLS AOT compilation process.
 // Uses the JIT to produce and object file, creates a header file and source to
 // wrap (i.e., simplify) execution of the generated code, and writes the trio to
-// disk.
+// disk. Optionally links the object code into a self-contained shared object
+// exporting the function's C ABI entry point, for services that want
+// JIT-grade throughput without an LLVM dependency or startup compilation.
 
 #include "google/protobuf/text_format.h"
 #include "absl/flags/flag.h"
@@ -31,8 +33,10 @@
 #include "xls/common/init_xls.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/subprocess.h"
 #include "xls/ir/function.h"
 #include "xls/ir/ir_parser.h"
+#include "xls/ir/op.h"
 #include "xls/jit/function_jit.h"
 #include "xls/jit/llvm_type_converter.h"
 
@@ -51,29 +55,116 @@ ABSL_FLAG(std::string, output_header, "",
           "Path at which to write the output header file.");
 ABSL_FLAG(std::string, output_source, "",
           "Path at which to write the output object-wrapping source file.");
+ABSL_FLAG(std::string, output_shared_object, "",
+          "Optional path at which to write a shared object (.so) linked from "
+          "the object code. The result exports the function's C ABI entry "
+          "point (declared in the generated header) and has no LLVM "
+          "dependency.");
+ABSL_FLAG(std::string, linker, "/usr/bin/cc",
+          "Host compiler driver used to link the shared object.");
 
 namespace xls {
 
-// Produces a simple header file containing a call with the same name as the
-// target function (with the package name prefix removed).
+// Native data-layout sizes of a function's argument and result buffers.
+// Computed once at AOT-compile time and baked into the generated header so
+// callers of the C ABI entry point need no LLVM dependency at runtime.
+struct BufferSizes {
+  std::vector<int64_t> arg_sizes;
+  int64_t result_size;
+};
+
+absl::StatusOr<BufferSizes> ComputeBufferSizes(Function* f) {
+  llvm::LLVMContext ctx;
+  auto error_or_target_builder =
+      llvm::orc::JITTargetMachineBuilder::detectHost();
+  if (!error_or_target_builder) {
+    return absl::InternalError(
+        absl::StrCat("Unable to detect host: ",
+                     llvm::toString(error_or_target_builder.takeError())));
+  }
+
+  auto error_or_target_machine = error_or_target_builder->createTargetMachine();
+  if (!error_or_target_machine) {
+    return absl::InternalError(
+        absl::StrCat("Unable to create target machine: ",
+                     llvm::toString(error_or_target_machine.takeError())));
+  }
+  std::unique_ptr<llvm::TargetMachine> target_machine =
+      std::move(error_or_target_machine.get());
+  llvm::DataLayout data_layout = target_machine->createDataLayout();
+  LlvmTypeConverter type_converter(&ctx, data_layout);
+
+  BufferSizes sizes;
+  for (Param* param : f->params()) {
+    sizes.arg_sizes.push_back(
+        type_converter.GetTypeByteSize(param->GetType()));
+  }
+  sizes.result_size =
+      type_converter.GetTypeByteSize(f->GetType()->return_type());
+  return sizes;
+}
+
+// Returns true if the function contains operations (asserts, traces, covers)
+// which are lowered to callbacks with in-process addresses baked into the
+// generated code.
+bool HasCallbackOps(Function* f) {
+  for (Node* node : f->nodes()) {
+    if (node->OpIn({Op::kAssert, Op::kTrace, Op::kCover})) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Produces a header file declaring the raw C ABI entry point exported by the
+// object code along with its buffer sizes, and a Value-based call with the
+// same name as the target function (with the package name prefix removed).
 absl::StatusOr<std::string> GenerateHeader(
-    Package* p, Function* f, const std::vector<std::string>& namespaces) {
-  // $0: Opening namespace(s)
-  // $1: Closing namespace(s)
-  // $2: Function name
-  // $3: Function parameters
+    Package* p, Function* f, const std::vector<std::string>& namespaces,
+    const BufferSizes& buffer_sizes) {
   constexpr absl::string_view kTemplate =
       R"(// AUTO-GENERATED FILE! DO NOT EDIT!
+#include <cstdint>
+
 #include "absl/status/statusor.h"
 #include "xls/ir/value.h"
-{{open_ns}}
+
+// Stable C ABI entry point for the AOT-compiled function. The i-th argument
+// buffer and the result buffer hold the native (data layout) representation
+// of the corresponding XLS types and must be at least
+// {{wrapper_fn_name}}_arg_buffer_sizes[i] and
+// {{wrapper_fn_name}}_result_buffer_size bytes respectively. The trailing
+// parameters carry interpreter events, user data, and the JIT runtime used
+// by assert/trace/cover operations; {{callback_comment}}
+extern "C" void {{extern_fn}}(const uint8_t* const* args, uint8_t* result,
+                              void* events, void* user_data,
+                              void* jit_runtime);
+{{open_ns}}{{arg_buffer_sizes_decl}}inline constexpr int64_t {{wrapper_fn_name}}_result_buffer_size = {{result_size}};
+
 absl::StatusOr<xls::Value> {{wrapper_fn_name}}({{wrapper_params}});
 {{close_ns}})";
 
   absl::flat_hash_map<std::string, std::string> substitution_map;
   std::string package_prefix = absl::StrCat("__", p->name(), "__");
-  substitution_map["{{wrapper_fn_name}}"] =
-      absl::StripPrefix(f->name(), package_prefix);
+  std::string wrapper_fn_name = absl::StrCat(
+      absl::StripPrefix(f->name(), package_prefix));
+  substitution_map["{{wrapper_fn_name}}"] = wrapper_fn_name;
+  substitution_map["{{extern_fn}}"] = f->name();
+  substitution_map["{{callback_comment}}"] =
+      HasCallbackOps(f)
+          ? "this function contains such operations, so valid pointers must "
+            "be\n// provided (see the generated wrapper source)."
+          : "this function contains no such\n// operations, so null pointers "
+            "may be passed.";
+
+  if (buffer_sizes.arg_sizes.empty()) {
+    substitution_map["{{arg_buffer_sizes_decl}}"] = "";
+  } else {
+    substitution_map["{{arg_buffer_sizes_decl}}"] = absl::StrFormat(
+        "inline constexpr int64_t %s_arg_buffer_sizes[] = {%s};\n",
+        wrapper_fn_name, absl::StrJoin(buffer_sizes.arg_sizes, ", "));
+  }
+  substitution_map["{{result_size}}"] = absl::StrCat(buffer_sizes.result_size);
 
   std::vector<std::string> params;
   for (const Param* param : f->params()) {
@@ -82,7 +173,7 @@ absl::StatusOr<xls::Value> {{wrapper_fn_name}}({{wrapper_params}});
   substitution_map["{{wrapper_params}}"] = absl::StrJoin(params, ", ");
 
   if (namespaces.empty()) {
-    substitution_map["{{open_ns}}"] = "";
+    substitution_map["{{open_ns}}"] = "\n";
     substitution_map["{{close_ns}}"] = "";
   } else {
     substitution_map["{{open_ns}}"] =
@@ -106,7 +197,8 @@ absl::StatusOr<xls::Value> {{wrapper_fn_name}}({{wrapper_params}});
 // reduce the tax paid during normal execution.
 absl::StatusOr<std::string> GenerateWrapperSource(
     Package* p, Function* f, const std::string& header_path,
-    const std::vector<std::string>& namespaces) {
+    const std::vector<std::string>& namespaces,
+    const BufferSizes& buffer_sizes) {
   constexpr absl::string_view kTemplate =
       R"~(// AUTO-GENERATED FILE! DO NOT EDIT!
 #include "{{header_path}}"
@@ -122,11 +214,6 @@ absl::StatusOr<std::string> GenerateWrapperSource(
 #include "xls/ir/type.h"
 #include "xls/jit/aot_runtime.h"
 #include "xls/jit/jit_runtime.h"
-
-extern "C" {
-void {{extern_fn}}(const uint8_t* const*, uint8_t*, ::xls::InterpreterEvents*,
-                   void*, ::xls::JitRuntime*);
-}
 {{open_ns}}
 constexpr absl::string_view kFnTypeProto = R"({{type_textproto}})";
 
@@ -157,7 +244,8 @@ absl::StatusOr<::xls::Value> {{wrapper_fn_name}}({{wrapper_params}}) {
           {{private_ns}}::global_data->borrowed_param_types,
           absl::MakeSpan(arg_buffers)));
   ::xls::InterpreterEvents events;
-  {{extern_fn}}(arg_buffers, result_buffer, &events, nullptr, &runtime);
+  {{extern_fn}}(arg_buffers, result_buffer, static_cast<void*>(&events),
+                nullptr, static_cast<void*>(&runtime));
 
   ::xls::Value result = runtime.UnpackBuffer(
       result_buffer, {{private_ns}}::global_data->fn_type->return_type());
@@ -181,38 +269,17 @@ absl::StatusOr<::xls::Value> {{wrapper_fn_name}}({{wrapper_params}}) {
         absl::StrFormat("}  // namespace %s", absl::StrJoin(namespaces, "::"));
   }
 
-  llvm::LLVMContext ctx;
-  auto error_or_target_builder =
-      llvm::orc::JITTargetMachineBuilder::detectHost();
-  if (!error_or_target_builder) {
-    return absl::InternalError(
-        absl::StrCat("Unable to detect host: ",
-                     llvm::toString(error_or_target_builder.takeError())));
-  }
-
-  auto error_or_target_machine = error_or_target_builder->createTargetMachine();
-  if (!error_or_target_machine) {
-    return absl::InternalError(
-        absl::StrCat("Unable to create target machine: ",
-                     llvm::toString(error_or_target_machine.takeError())));
-  }
-  std::unique_ptr<llvm::TargetMachine> target_machine =
-      std::move(error_or_target_machine.get());
-  llvm::DataLayout data_layout = target_machine->createDataLayout();
-  LlvmTypeConverter type_converter(&ctx, data_layout);
-  int64_t return_type_bytes =
-      type_converter.GetTypeByteSize(f->GetType()->return_type());
-
   std::vector<std::string> params;
   std::vector<std::string> param_names;
   std::vector<std::string> arg_buffer_decls;
   std::vector<std::string> arg_buffer_names;
-  for (Param* param : f->params()) {
+  for (int64_t i = 0; i < f->params().size(); ++i) {
+    Param* param = f->param(i);
     params.push_back(absl::StrCat("const ::xls::Value& ", param->name()));
     param_names.push_back(std::string(param->name()));
-    arg_buffer_decls.push_back(
-        absl::StrFormat("  uint8_t %s_buffer[%d];", param->name(),
-                        type_converter.GetTypeByteSize(param->GetType())));
+    arg_buffer_decls.push_back(absl::StrFormat("  uint8_t %s_buffer[%d];",
+                                               param->name(),
+                                               buffer_sizes.arg_sizes[i]));
     arg_buffer_names.push_back(absl::StrCat(param->name(), "_buffer"));
   }
   substitution_map["{{wrapper_params}}"] = absl::StrJoin(params, ", ");
@@ -221,7 +288,7 @@ absl::StatusOr<::xls::Value> {{wrapper_fn_name}}({{wrapper_params}}) {
       absl::StrJoin(arg_buffer_decls, "\n");
   substitution_map["{{arg_buffer_collector}}"] =
       absl::StrFormat("{%s}", absl::StrJoin(arg_buffer_names, ", "));
-  substitution_map["{{result_size}}"] = absl::StrCat(return_type_bytes);
+  substitution_map["{{result_size}}"] = absl::StrCat(buffer_sizes.result_size);
 
   std::string type_textproto;
   google::protobuf::TextFormat::PrintToString(f->GetType()->ToProto(), &type_textproto);
@@ -239,6 +306,8 @@ absl::Status RealMain(const std::string& input_ir_path, std::string top,
                       const std::string& output_object_path,
                       const std::string& output_header_path,
                       const std::string& output_source_path,
+                      const std::string& output_shared_object_path,
+                      const std::string& linker,
                       const std::vector<std::string>& namespaces) {
   XLS_ASSIGN_OR_RETURN(std::string input_ir, GetFileContents(input_ir_path));
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
@@ -256,15 +325,29 @@ absl::Status RealMain(const std::string& input_ir_path, std::string top,
   XLS_RETURN_IF_ERROR(SetFileContents(
       output_object_path, std::string(object_code.begin(), object_code.end())));
 
-  XLS_ASSIGN_OR_RETURN(std::string header_text,
-                       GenerateHeader(package.get(), f, namespaces));
+  XLS_ASSIGN_OR_RETURN(BufferSizes buffer_sizes, ComputeBufferSizes(f));
+
+  XLS_ASSIGN_OR_RETURN(
+      std::string header_text,
+      GenerateHeader(package.get(), f, namespaces, buffer_sizes));
   XLS_RETURN_IF_ERROR(SetFileContents(output_header_path, header_text));
 
   XLS_ASSIGN_OR_RETURN(
       std::string source_text,
-      GenerateWrapperSource(package.get(), f, output_header_path, namespaces));
+      GenerateWrapperSource(package.get(), f, output_header_path, namespaces,
+                            buffer_sizes));
   XLS_RETURN_IF_ERROR(SetFileContents(output_source_path, source_text));
 
+  if (!output_shared_object_path.empty()) {
+    // The object code is emitted position-independent (OrcJit sets the PIC
+    // relocation model) and references no LLVM symbols, so the host driver
+    // can link it directly into a self-contained shared object.
+    XLS_RETURN_IF_ERROR(InvokeSubprocess({linker, "-shared", "-o",
+                                          output_shared_object_path,
+                                          output_object_path})
+                            .status());
+  }
+
   return absl::OkStatus();
 }
 
@@ -290,9 +373,10 @@ int main(int argc, char** argv) {
   if (!namespaces_string.empty()) {
     namespaces = absl::StrSplit(namespaces_string, ',');
   }
-  absl::Status status =
-      xls::RealMain(input_ir_path, top, output_object_path, output_header_path,
-                    output_source_path, namespaces);
+  absl::Status status = xls::RealMain(
+      input_ir_path, top, output_object_path, output_header_path,
+      output_source_path, absl::GetFlag(FLAGS_output_shared_object),
+      absl::GetFlag(FLAGS_linker), namespaces);
   if (!status.ok()) {
     std::cout << status.message();
     return 1;
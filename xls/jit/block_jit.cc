@@ -0,0 +1,392 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/block_jit.h"
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "llvm/include/llvm/IR/LLVMContext.h"
+#include "llvm/include/llvm/IR/Module.h"
+#include "xls/common/logging/log_lines.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/math_util.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/register.h"
+#include "xls/ir/type.h"
+#include "xls/ir/value.h"
+#include "xls/ir/value_helpers.h"
+#include "xls/jit/ir_builder_visitor.h"
+#include "xls/jit/jit_runtime.h"
+#include "xls/jit/llvm_type_converter.h"
+
+namespace xls {
+namespace {
+
+// An IR builder visitor which constructs an llvm::Function computing one
+// clock cycle of an XLS block. Input ports and the current register values
+// are read out of arrays of pointers passed as arguments; output port values
+// and the next register values are stored through such arrays. The function
+// signature is described in BlockJit::CycleFunctionType.
+class BlockBuilderVisitor : public IrBuilderVisitor {
+ public:
+  BlockBuilderVisitor(llvm::Function* llvm_fn, Block* block,
+                      LlvmTypeConverter* type_converter)
+      : IrBuilderVisitor(
+            llvm_fn, block, type_converter,
+            [](Function* f) -> absl::StatusOr<llvm::Function*> {
+              return absl::UnimplementedError(
+                  "Blocks cannot contain function-invoking operations.");
+            }),
+        block_(block) {
+    for (int64_t i = 0; i < block->GetRegisters().size(); ++i) {
+      register_index_[block->GetRegisters()[i]] = i;
+    }
+    for (int64_t i = 0; i < block->GetInputPorts().size(); ++i) {
+      input_port_index_[block->GetInputPorts()[i]] = i;
+    }
+    for (int64_t i = 0; i < block->GetOutputPorts().size(); ++i) {
+      output_port_index_[block->GetOutputPorts()[i]] = i;
+    }
+  }
+
+  absl::Status HandleParam(Param* param) override {
+    // The only parameter of a block is the token parameter which carries no
+    // data.
+    return StoreResult(
+        param, CreateTypedZeroValue(
+                   type_converter()->ConvertToLlvmType(param->GetType())));
+  }
+
+  absl::Status HandleInputPort(InputPort* input_port) override {
+    Type* type = input_port->GetType();
+    if (type->GetFlatBitCount() == 0) {
+      return StoreResult(
+          input_port,
+          CreateTypedZeroValue(type_converter()->ConvertToLlvmType(type)));
+    }
+    llvm::Value* loaded = LoadFromPointerArray(
+        input_port_index_.at(input_port),
+        type_converter()->ConvertToLlvmType(type),
+        dispatch_function()->getArg(0), block_->GetInputPorts().size(),
+        dispatch_builder());
+    return StoreResult(input_port, type_converter()->ClearPaddingBits(
+                                       loaded, type, *dispatch_builder()));
+  }
+
+  absl::Status HandleOutputPort(OutputPort* output_port) override {
+    Node* data = output_port->operand(0);
+    if (data->GetType()->GetFlatBitCount() > 0) {
+      llvm::Type* data_type =
+          type_converter()->ConvertToLlvmType(data->GetType());
+      llvm::Value* ptr = LoadPointerFromPointerArray(
+          output_port_index_.at(output_port), data_type,
+          dispatch_function()->getArg(1), block_->GetOutputPorts().size(),
+          dispatch_builder());
+      dispatch_builder()->CreateStore(node_map().at(data), ptr);
+      UnpoisonBuffer(ptr, type_converter()->GetTypeByteSize(data->GetType()),
+                     dispatch_builder());
+    }
+    // Output ports have empty tuple types.
+    return StoreResult(
+        output_port,
+        CreateTypedZeroValue(
+            type_converter()->ConvertToLlvmType(output_port->GetType())));
+  }
+
+  absl::Status HandleRegisterRead(RegisterRead* reg_read) override {
+    Register* reg = reg_read->GetRegister();
+    if (reg->type()->GetFlatBitCount() == 0) {
+      return StoreResult(
+          reg_read, CreateTypedZeroValue(
+                        type_converter()->ConvertToLlvmType(reg->type())));
+    }
+    llvm::Value* loaded = LoadFromPointerArray(
+        register_index_.at(reg),
+        type_converter()->ConvertToLlvmType(reg->type()),
+        dispatch_function()->getArg(2), block_->GetRegisters().size(),
+        dispatch_builder());
+    return StoreResult(reg_read,
+                       type_converter()->ClearPaddingBits(
+                           loaded, reg->type(), *dispatch_builder()));
+  }
+
+  absl::Status HandleRegisterWrite(RegisterWrite* reg_write) override {
+    Register* reg = reg_write->GetRegister();
+    llvm::IRBuilder<>* b = dispatch_builder();
+    if (reg->type()->GetFlatBitCount() > 0) {
+      llvm::Type* data_type =
+          type_converter()->ConvertToLlvmType(reg->type());
+      llvm::Value* next = node_map().at(reg_write->data());
+      if (reg_write->load_enable().has_value()) {
+        // Load enable not asserted: the register holds its value.
+        llvm::Value* load_enable = node_map().at(*reg_write->load_enable());
+        llvm::Value* asserted = b->CreateICmpNE(
+            load_enable, llvm::ConstantInt::get(load_enable->getType(), 0));
+        llvm::Value* current = LoadFromPointerArray(
+            register_index_.at(reg), data_type,
+            dispatch_function()->getArg(2), block_->GetRegisters().size(), b);
+        next = b->CreateSelect(asserted, next, current);
+      }
+      if (reg_write->reset().has_value()) {
+        // Reset overrides load enable: an asserted reset signal loads the
+        // reset value of the register.
+        XLS_RET_CHECK(reg->reset().has_value());
+        XLS_ASSIGN_OR_RETURN(
+            llvm::Constant * reset_value,
+            type_converter()->ToLlvmConstant(reg->type(),
+                                             reg->reset()->reset_value));
+        llvm::Value* reset_signal = node_map().at(*reg_write->reset());
+        llvm::Value* zero =
+            llvm::ConstantInt::get(reset_signal->getType(), 0);
+        llvm::Value* asserted = reg->reset()->active_low
+                                    ? b->CreateICmpEQ(reset_signal, zero)
+                                    : b->CreateICmpNE(reset_signal, zero);
+        next = b->CreateSelect(asserted, reset_value, next);
+      }
+      llvm::Value* ptr = LoadPointerFromPointerArray(
+          register_index_.at(reg), data_type, dispatch_function()->getArg(3),
+          block_->GetRegisters().size(), b);
+      b->CreateStore(next, ptr);
+      UnpoisonBuffer(ptr, type_converter()->GetTypeByteSize(reg->type()), b);
+    }
+    written_registers_.insert(reg);
+    // Register writes have empty tuple types.
+    return StoreResult(
+        reg_write,
+        CreateTypedZeroValue(
+            type_converter()->ConvertToLlvmType(reg_write->GetType())));
+  }
+
+  // Finishes building the function: registers without a write operation hold
+  // their value, then the function returns void (results were stored through
+  // the output pointer arrays).
+  absl::Status Finalize() {
+    llvm::IRBuilder<>* b = dispatch_builder();
+    for (Register* reg : block_->GetRegisters()) {
+      if (written_registers_.contains(reg) ||
+          reg->type()->GetFlatBitCount() == 0) {
+        continue;
+      }
+      llvm::Type* data_type =
+          type_converter()->ConvertToLlvmType(reg->type());
+      llvm::Value* current = LoadFromPointerArray(
+          register_index_.at(reg), data_type, dispatch_function()->getArg(2),
+          block_->GetRegisters().size(), b);
+      llvm::Value* ptr = LoadPointerFromPointerArray(
+          register_index_.at(reg), data_type, dispatch_function()->getArg(3),
+          block_->GetRegisters().size(), b);
+      b->CreateStore(current, ptr);
+      UnpoisonBuffer(ptr, type_converter()->GetTypeByteSize(reg->type()), b);
+    }
+    b->CreateRetVoid();
+    return absl::OkStatus();
+  }
+
+ private:
+  Block* block_;
+  absl::flat_hash_map<Register*, int64_t> register_index_;
+  absl::flat_hash_map<InputPort*, int64_t> input_port_index_;
+  absl::flat_hash_map<OutputPort*, int64_t> output_port_index_;
+  absl::flat_hash_set<Register*> written_registers_;
+};
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<BlockJit>> BlockJit::Create(Block* block,
+                                                           int64_t opt_level) {
+  auto jit = absl::WrapUnique(new BlockJit(block));
+  XLS_ASSIGN_OR_RETURN(jit->orc_jit_,
+                       OrcJit::Create(opt_level, /*emit_object_code=*/false));
+
+  jit->ir_runtime_ = std::make_unique<JitRuntime>(
+      jit->orc_jit_->GetDataLayout(), &jit->orc_jit_->GetTypeConverter());
+  std::unique_ptr<llvm::Module> module =
+      jit->orc_jit_->NewModule(block->name());
+
+  // The cycle function takes the four pointer-array arguments followed by the
+  // usual three environment pointers (events, user data, JIT runtime).
+  llvm::LLVMContext& context = *jit->orc_jit_->GetContext();
+  llvm::Type* ptr_type = llvm::PointerType::get(context, 0);
+  std::vector<llvm::Type*> param_types(7, ptr_type);
+  llvm::FunctionType* function_type = llvm::FunctionType::get(
+      llvm::Type::getVoidTy(context),
+      llvm::ArrayRef<llvm::Type*>(param_types.data(), param_types.size()),
+      /*isVarArg=*/false);
+  std::string function_name = absl::StrCat(block->name(), "_cycle");
+  llvm::Function* llvm_function = llvm::cast<llvm::Function>(
+      module->getOrInsertFunction(function_name, function_type).getCallee());
+  llvm_function->getArg(0)->setName("input_ports");
+  llvm_function->getArg(1)->setName("output_ports");
+  llvm_function->getArg(2)->setName("registers_in");
+  llvm_function->getArg(3)->setName("registers_out");
+  llvm_function->getArg(4)->setName("__events");
+  llvm_function->getArg(5)->setName("__user_data");
+  llvm_function->getArg(6)->setName("__jit_runtime");
+
+  BlockBuilderVisitor visitor(llvm_function, block,
+                              &jit->orc_jit_->GetTypeConverter());
+  XLS_RETURN_IF_ERROR(block->Accept(&visitor));
+  XLS_RETURN_IF_ERROR(visitor.Finalize());
+
+  XLS_VLOG(3) << "Module for block " << block->name() << ":";
+  XLS_VLOG_LINES(3, DumpLlvmModuleToString(*module));
+
+  // Compute buffer sizes and lay out the register file. Each register slot is
+  // rounded up to eight bytes so all slots are suitably aligned for the
+  // native LLVM data layout.
+  const LlvmTypeConverter& type_converter = jit->orc_jit_->GetTypeConverter();
+  for (InputPort* port : block->GetInputPorts()) {
+    jit->input_port_bytes_.push_back(
+        type_converter.GetTypeByteSize(port->GetType()));
+  }
+  for (OutputPort* port : block->GetOutputPorts()) {
+    jit->output_port_bytes_.push_back(
+        type_converter.GetTypeByteSize(port->operand(0)->GetType()));
+  }
+  int64_t register_file_bytes = 0;
+  std::vector<int64_t> register_offsets;
+  for (Register* reg : block->GetRegisters()) {
+    jit->register_bytes_.push_back(type_converter.GetTypeByteSize(reg->type()));
+    register_offsets.push_back(register_file_bytes);
+    register_file_bytes += RoundUpToNearest(jit->register_bytes_.back(),
+                                            int64_t{8});
+  }
+  for (int64_t i = 0; i < 2; ++i) {
+    jit->register_file_[i].resize(register_file_bytes);
+    for (int64_t offset : register_offsets) {
+      jit->register_ptrs_[i].push_back(jit->register_file_[i].data() + offset);
+    }
+  }
+
+  XLS_RETURN_IF_ERROR(jit->orc_jit_->CompileModule(std::move(module)));
+
+  XLS_ASSIGN_OR_RETURN(auto fn_address,
+                       jit->orc_jit_->LoadSymbol(function_name));
+  jit->cycle_fn_ = absl::bit_cast<CycleFunctionType>(fn_address);
+
+  XLS_RETURN_IF_ERROR(jit->Reset());
+  return jit;
+}
+
+BlockJit::BlockJit(Block* block) : block_(block), cycle_fn_(nullptr) {}
+
+absl::StatusOr<absl::flat_hash_map<std::string, Value>> BlockJit::RunCycle(
+    const absl::flat_hash_map<std::string, Value>& inputs) {
+  // Verify each input corresponds to an input port. The reverse check (each
+  // input port has a corresponding value in `inputs`) is done below.
+  for (const auto& [name, value] : inputs) {
+    if (!block_->GetInputPort(name).ok()) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Block has no input port '%s'", name));
+    }
+  }
+
+  std::vector<Value> args;
+  std::vector<Type*> arg_types;
+  for (InputPort* port : block_->GetInputPorts()) {
+    auto port_iter = inputs.find(port->GetName());
+    if (port_iter == inputs.end()) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Missing input for port '%s'", port->GetName()));
+    }
+    args.push_back(port_iter->second);
+    arg_types.push_back(port->GetType());
+  }
+
+  std::vector<std::unique_ptr<uint8_t[]>> unique_input_buffers;
+  std::vector<uint8_t*> input_buffers;
+  for (int64_t i = 0; i < block_->GetInputPorts().size(); ++i) {
+    unique_input_buffers.push_back(
+        std::make_unique<uint8_t[]>(input_port_bytes_[i]));
+    input_buffers.push_back(unique_input_buffers.back().get());
+  }
+  XLS_RETURN_IF_ERROR(
+      ir_runtime_->PackArgs(args, arg_types, absl::MakeSpan(input_buffers)));
+
+  std::vector<std::unique_ptr<uint8_t[]>> unique_output_buffers;
+  std::vector<uint8_t*> output_buffers;
+  for (int64_t i = 0; i < block_->GetOutputPorts().size(); ++i) {
+    unique_output_buffers.push_back(
+        std::make_unique<uint8_t[]>(output_port_bytes_[i]));
+    output_buffers.push_back(unique_output_buffers.back().get());
+  }
+
+  InterpreterEvents events;
+  cycle_fn_(input_buffers.data(), output_buffers.data(),
+            register_ptrs_[current_buffer_].data(),
+            register_ptrs_[1 - current_buffer_].data(), &events,
+            /*user_data=*/nullptr, runtime());
+  current_buffer_ = 1 - current_buffer_;
+
+  XLS_RETURN_IF_ERROR(InterpreterEventsToStatus(events));
+
+  absl::flat_hash_map<std::string, Value> outputs;
+  for (int64_t i = 0; i < block_->GetOutputPorts().size(); ++i) {
+    OutputPort* port = block_->GetOutputPorts()[i];
+    outputs[port->GetName()] = ir_runtime_->UnpackBuffer(
+        output_buffers[i], port->operand(0)->GetType());
+  }
+  return outputs;
+}
+
+absl::Status BlockJit::Reset() {
+  absl::flat_hash_map<std::string, Value> reg_state;
+  for (Register* reg : block_->GetRegisters()) {
+    reg_state[reg->name()] = reg->reset().has_value()
+                                 ? reg->reset()->reset_value
+                                 : ZeroOfType(reg->type());
+  }
+  return SetRegisterState(reg_state);
+}
+
+absl::flat_hash_map<std::string, Value> BlockJit::GetRegisterState() {
+  absl::flat_hash_map<std::string, Value> reg_state;
+  for (int64_t i = 0; i < block_->GetRegisters().size(); ++i) {
+    Register* reg = block_->GetRegisters()[i];
+    reg_state[reg->name()] = ir_runtime_->UnpackBuffer(
+        register_ptrs_[current_buffer_][i], reg->type());
+  }
+  return reg_state;
+}
+
+absl::Status BlockJit::SetRegisterState(
+    const absl::flat_hash_map<std::string, Value>& reg_state) {
+  for (const auto& [name, value] : reg_state) {
+    if (!block_->GetRegister(name).ok()) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Block has no register '%s'", name));
+    }
+  }
+  std::vector<Value> values;
+  std::vector<Type*> types;
+  for (Register* reg : block_->GetRegisters()) {
+    auto reg_iter = reg_state.find(reg->name());
+    if (reg_iter == reg_state.end()) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Missing value for register '%s'", reg->name()));
+    }
+    values.push_back(reg_iter->second);
+    types.push_back(reg->type());
+  }
+  return ir_runtime_->PackArgs(
+      values, types, absl::MakeSpan(register_ptrs_[current_buffer_]));
+}
+
+}  // namespace xls
@@ -0,0 +1,114 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_JIT_BLOCK_JIT_H_
+#define XLS_JIT_BLOCK_JIT_H_
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/block.h"
+#include "xls/ir/events.h"
+#include "xls/ir/value.h"
+#include "xls/jit/jit_runtime.h"
+#include "xls/jit/orc_jit.h"
+
+namespace xls {
+
+// This class provides a facility to execute XLS blocks cycle-accurately (on
+// the host) by converting them to LLVM IR, compiling them, and executing
+// them. The entire per-cycle computation -- combinational logic, register
+// state update including load-enable and reset handling -- is compiled into a
+// single native function, unlike the block interpreter which walks the node
+// graph every cycle. Register state lives in a persistent packed register
+// file owned by the jit so no per-cycle conversion of register values is
+// required.
+class BlockJit {
+ public:
+  // Returns an object containing a host-compiled version of the specified XLS
+  // block. The register file is initialized as by Reset().
+  static absl::StatusOr<std::unique_ptr<BlockJit>> Create(Block* block,
+                                                          int64_t opt_level = 3);
+
+  // Runs a single clock cycle of the compiled block: reads the given input
+  // port values, advances the register state held in the internal register
+  // file, and returns the resulting output port values indexed by port name.
+  // `inputs` must contain a value for exactly the input ports of the block.
+  absl::StatusOr<absl::flat_hash_map<std::string, Value>> RunCycle(
+      const absl::flat_hash_map<std::string, Value>& inputs);
+
+  // Sets each register to its reset value, or to a zero value if the register
+  // has no reset.
+  absl::Status Reset();
+
+  // Returns the current value of each register, indexed by register name.
+  absl::flat_hash_map<std::string, Value> GetRegisterState();
+
+  // Overwrites the register file with the given values. `reg_state` must
+  // contain a value for exactly the registers of the block.
+  absl::Status SetRegisterState(
+      const absl::flat_hash_map<std::string, Value>& reg_state);
+
+  // Returns the block that the JIT executes.
+  Block* block() { return block_; }
+
+  JitRuntime* runtime() { return ir_runtime_.get(); }
+
+ private:
+  explicit BlockJit(Block* block);
+
+  std::unique_ptr<OrcJit> orc_jit_;
+
+  Block* block_;
+
+  std::unique_ptr<JitRuntime> ir_runtime_;
+
+  // Sizes in bytes of the buffers for each input port, output port, and
+  // register in the native LLVM data layout.
+  std::vector<int64_t> input_port_bytes_;
+  std::vector<int64_t> output_port_bytes_;
+  std::vector<int64_t> register_bytes_;
+
+  // The persistent register file: two packed buffers holding the register
+  // values in the native LLVM data layout, with pointers to the individual
+  // register slots. Each cycle reads registers from the buffer selected by
+  // `current_buffer_` and writes the next state into the other one, then the
+  // buffers are swapped.
+  std::vector<uint8_t> register_file_[2];
+  std::vector<uint8_t*> register_ptrs_[2];
+  int64_t current_buffer_ = 0;
+
+  // When initialized, this points to the compiled per-cycle entry point. Its
+  // signature is:
+  //
+  //   void f(uint8_t*[] input_ports, uint8_t*[] output_ports,
+  //          uint8_t*[] registers_in, uint8_t*[] registers_out,
+  //          void* events, void* user_data, void* jit_runtime)
+  //
+  // Each array contains one pointer per input port, output port, or register
+  // (in the order returned by Block::GetInputPorts, GetOutputPorts, and
+  // GetRegisters respectively), pointing to a buffer holding the value in the
+  // native LLVM data layout.
+  using CycleFunctionType = void (*)(const uint8_t* const* input_ports,
+                                     uint8_t* const* output_ports,
+                                     const uint8_t* const* registers_in,
+                                     uint8_t* const* registers_out,
+                                     InterpreterEvents* events, void* user_data,
+                                     JitRuntime* jit_runtime);
+  CycleFunctionType cycle_fn_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_JIT_BLOCK_JIT_H_
@@ -0,0 +1,195 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/block_jit.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+
+namespace xls {
+namespace {
+
+using status_testing::IsOkAndHolds;
+using status_testing::StatusIs;
+using testing::HasSubstr;
+using testing::Pair;
+using testing::UnorderedElementsAre;
+
+class BlockJitTest : public IrTestBase {};
+
+TEST_F(BlockJitTest, CombinationalBlock) {
+  auto package = CreatePackage();
+  BlockBuilder b(TestName(), package.get());
+  BValue x = b.InputPort("x", package->GetBitsType(32));
+  BValue y = b.InputPort("y", package->GetBitsType(32));
+  b.OutputPort("sum", b.Add(x, y));
+  b.OutputPort("diff", b.Subtract(x, y));
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block, b.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, BlockJit::Create(block));
+  EXPECT_THAT(
+      jit->RunCycle({{"x", Value(UBits(42, 32))}, {"y", Value(UBits(10, 32))}}),
+      IsOkAndHolds(UnorderedElementsAre(Pair("sum", Value(UBits(52, 32))),
+                                        Pair("diff", Value(UBits(32, 32))))));
+  EXPECT_THAT(
+      jit->RunCycle({{"x", Value(UBits(7, 32))}, {"y", Value(UBits(3, 32))}}),
+      IsOkAndHolds(UnorderedElementsAre(Pair("sum", Value(UBits(10, 32))),
+                                        Pair("diff", Value(UBits(4, 32))))));
+}
+
+TEST_F(BlockJitTest, PipelinedAdder) {
+  auto package = CreatePackage();
+  BlockBuilder b(TestName(), package.get());
+  XLS_ASSERT_OK(b.block()->AddClockPort("clk"));
+
+  BValue x = b.InputPort("x", package->GetBitsType(32));
+  BValue y = b.InputPort("y", package->GetBitsType(32));
+  BValue x_d = b.InsertRegister("x_d", x);
+  BValue y_d = b.InsertRegister("y_d", y);
+  BValue x_plus_y_d = b.InsertRegister("x_plus_y_d", b.Add(x_d, y_d));
+  b.OutputPort("out", x_plus_y_d);
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block, b.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, BlockJit::Create(block));
+
+  std::vector<std::pair<uint64_t, uint64_t>> inputs = {
+      {1, 2}, {42, 100}, {0, 0}, {0, 0}, {0, 0}};
+  std::vector<uint64_t> expected = {0, 0, 3, 142, 0};
+  for (int64_t i = 0; i < inputs.size(); ++i) {
+    EXPECT_THAT(jit->RunCycle({{"x", Value(UBits(inputs[i].first, 32))},
+                               {"y", Value(UBits(inputs[i].second, 32))}}),
+                IsOkAndHolds(UnorderedElementsAre(
+                    Pair("out", Value(UBits(expected[i], 32))))));
+  }
+}
+
+TEST_F(BlockJitTest, RegisterWithResetAndLoadEnable) {
+  auto package = CreatePackage();
+  BlockBuilder b(TestName(), package.get());
+  XLS_ASSERT_OK(b.block()->AddClockPort("clk"));
+
+  BValue x = b.InputPort("x", package->GetBitsType(32));
+  BValue rst_n = b.InputPort("rst_n", package->GetBitsType(1));
+  BValue le = b.InputPort("le", package->GetBitsType(1));
+  BValue x_d =
+      b.InsertRegister("x_d", x, rst_n,
+                       Reset{Value(UBits(42, 32)), /*asynchronous=*/false,
+                             /*active_low=*/true},
+                       le);
+  b.OutputPort("out", x_d);
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block, b.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, BlockJit::Create(block));
+
+  // The register file is initialized to the reset value of the register.
+  EXPECT_THAT(jit->GetRegisterState(),
+              UnorderedElementsAre(Pair("x_d", Value(UBits(42, 32)))));
+
+  struct CycleInput {
+    uint64_t rst_n;
+    uint64_t le;
+    uint64_t x;
+  };
+  std::vector<CycleInput> inputs = {
+      {1, 0, 1}, {0, 0, 2}, {0, 1, 3}, {1, 1, 4}, {1, 0, 5}};
+  std::vector<uint64_t> expected = {42, 42, 42, 42, 4};
+  for (int64_t i = 0; i < inputs.size(); ++i) {
+    EXPECT_THAT(jit->RunCycle({{"x", Value(UBits(inputs[i].x, 32))},
+                               {"rst_n", Value(UBits(inputs[i].rst_n, 1))},
+                               {"le", Value(UBits(inputs[i].le, 1))}}),
+                IsOkAndHolds(UnorderedElementsAre(
+                    Pair("out", Value(UBits(expected[i], 32))))));
+  }
+}
+
+TEST_F(BlockJitTest, AccumulatorRegister) {
+  auto package = CreatePackage();
+  BlockBuilder b(TestName(), package.get());
+  XLS_ASSERT_OK(b.block()->AddClockPort("clk"));
+
+  BValue x = b.InputPort("x", package->GetBitsType(32));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Register * reg,
+      b.block()->AddRegister("accum", package->GetBitsType(32)));
+  BValue accum = b.RegisterRead(reg);
+  BValue next_accum = b.Add(x, accum);
+  b.RegisterWrite(reg, next_accum);
+  b.OutputPort("out", next_accum);
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block, b.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, BlockJit::Create(block));
+
+  for (int64_t i = 1; i <= 4; ++i) {
+    EXPECT_THAT(jit->RunCycle({{"x", Value(UBits(i, 32))}}),
+                IsOkAndHolds(UnorderedElementsAre(
+                    Pair("out", Value(UBits(i * (i + 1) / 2, 32))))));
+  }
+  EXPECT_THAT(jit->GetRegisterState(),
+              UnorderedElementsAre(Pair("accum", Value(UBits(10, 32)))));
+
+  // The register file can be overwritten from the host between cycles.
+  XLS_ASSERT_OK(jit->SetRegisterState({{"accum", Value(UBits(100, 32))}}));
+  EXPECT_THAT(
+      jit->RunCycle({{"x", Value(UBits(5, 32))}}),
+      IsOkAndHolds(UnorderedElementsAre(Pair("out", Value(UBits(105, 32))))));
+
+  // Reset() returns the register to its initial (zero) value.
+  XLS_ASSERT_OK(jit->Reset());
+  EXPECT_THAT(jit->GetRegisterState(),
+              UnorderedElementsAre(Pair("accum", Value(UBits(0, 32)))));
+}
+
+TEST_F(BlockJitTest, InputErrors) {
+  auto package = CreatePackage();
+  BlockBuilder b(TestName(), package.get());
+  BValue x = b.InputPort("x", package->GetBitsType(32));
+  b.InputPort("y", package->GetBitsType(32));
+  b.OutputPort("out", x);
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block, b.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, BlockJit::Create(block));
+
+  EXPECT_THAT(jit->RunCycle({{"a", Value(UBits(42, 32))},
+                             {"x", Value(UBits(42, 32))},
+                             {"y", Value(UBits(42, 32))}}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Block has no input port 'a'")));
+  EXPECT_THAT(jit->RunCycle({{"x", Value(UBits(42, 32))}}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Missing input for port 'y'")));
+}
+
+TEST_F(BlockJitTest, RegisterStateErrors) {
+  auto package = CreatePackage();
+  BlockBuilder b(TestName(), package.get());
+  XLS_ASSERT_OK(b.block()->AddClockPort("clk"));
+  BValue x = b.InputPort("x", package->GetBitsType(32));
+  b.OutputPort("out", b.InsertRegister("x_d", x));
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block, b.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, BlockJit::Create(block));
+
+  EXPECT_THAT(jit->SetRegisterState({{"bogus", Value(UBits(0, 32))}}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Block has no register 'bogus'")));
+  EXPECT_THAT(jit->SetRegisterState({}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Missing value for register 'x_d'")));
+}
+
+}  // namespace
+}  // namespace xls
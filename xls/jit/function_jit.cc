@@ -14,6 +14,7 @@
 
 #include "xls/jit/function_jit.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -25,10 +26,12 @@
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/logging/vlog_is_on.h"
+#include "xls/common/math_util.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/dfs_visitor.h"
 #include "xls/ir/format_preference.h"
 #include "xls/ir/keyword_args.h"
+#include "xls/ir/nodes.h"
 #include "xls/ir/type.h"
 #include "xls/ir/value.h"
 #include "xls/ir/value_helpers.h"
@@ -39,6 +42,37 @@
 namespace xls {
 namespace {
 
+// Returns whether any node in `function` -- or in a function it transitively
+// invokes -- can record interpreter events. Trace and assert are the only ops
+// which write through the events pointer, so when neither is reachable the
+// run paths can skip the event plumbing entirely.
+bool CanProduceInterpreterEvents(Function* function) {
+  absl::flat_hash_set<Function*> visited;
+  std::vector<Function*> worklist = {function};
+  while (!worklist.empty()) {
+    Function* f = worklist.back();
+    worklist.pop_back();
+    if (!visited.insert(f).second) {
+      continue;
+    }
+    for (Node* node : f->nodes()) {
+      if (node->Is<Trace>() || node->Is<Assert>()) {
+        return true;
+      }
+      if (node->Is<Invoke>()) {
+        worklist.push_back(node->As<Invoke>()->to_apply());
+      } else if (node->Is<Map>()) {
+        worklist.push_back(node->As<Map>()->to_apply());
+      } else if (node->Is<CountedFor>()) {
+        worklist.push_back(node->As<CountedFor>()->body());
+      } else if (node->Is<DynamicCountedFor>()) {
+        worklist.push_back(node->As<DynamicCountedFor>()->body());
+      }
+    }
+  }
+  return false;
+}
+
 // An IR builder visitor which constructs llvm::Functions built from XLS
 // functions.
 class FunctionBuilderVisitor : public IrBuilderVisitor {
@@ -308,6 +342,7 @@ absl::StatusOr<std::vector<char>> FunctionJit::CreateObjectFile(
 absl::StatusOr<std::unique_ptr<FunctionJit>> FunctionJit::CreateInternal(
     Function* xls_function, int64_t opt_level, bool emit_object_code) {
   auto jit = absl::WrapUnique(new FunctionJit(xls_function));
+  jit->can_produce_events_ = CanProduceInterpreterEvents(xls_function);
   XLS_ASSIGN_OR_RETURN(jit->orc_jit_,
                        OrcJit::Create(opt_level, emit_object_code));
 
@@ -323,7 +358,11 @@ absl::StatusOr<std::unique_ptr<FunctionJit>> FunctionJit::CreateInternal(
   for (const Param* param : xls_function->params()) {
     jit->arg_type_bytes_.push_back(
         jit->orc_jit_->GetTypeConverter().GetTypeByteSize(param->GetType()));
+    jit->packed_input_record_bytes_ +=
+        CeilOfRatio(param->GetType()->GetFlatBitCount(), int64_t{8});
   }
+  jit->packed_return_type_bytes_ = CeilOfRatio(
+      xls_function->return_value()->GetType()->GetFlatBitCount(), int64_t{8});
 
   XLS_ASSIGN_OR_RETURN(llvm::Function * wrapper_function,
                        jit->BuildWrapper(llvm_function));
@@ -331,6 +370,9 @@ absl::StatusOr<std::unique_ptr<FunctionJit>> FunctionJit::CreateInternal(
   XLS_ASSIGN_OR_RETURN(llvm::Function * packed_wrapper_function,
                        jit->BuildPackedWrapper(llvm_function));
   std::string packed_wrapper_name = packed_wrapper_function->getName().str();
+  XLS_ASSIGN_OR_RETURN(llvm::Function * batched_wrapper_function,
+                       jit->BuildBatchedWrapper(llvm_function));
+  std::string batched_wrapper_name = batched_wrapper_function->getName().str();
 
   XLS_VLOG(3) << "Module for " << xls_function->name() << ":";
   XLS_VLOG_LINES(3, DumpLlvmModuleToString(*module));
@@ -344,6 +386,10 @@ absl::StatusOr<std::unique_ptr<FunctionJit>> FunctionJit::CreateInternal(
   XLS_ASSIGN_OR_RETURN(fn_address,
                        jit->orc_jit_->LoadSymbol(packed_wrapper_name));
   jit->packed_invoker_ = absl::bit_cast<PackedJitFunctionType>(fn_address);
+
+  XLS_ASSIGN_OR_RETURN(fn_address,
+                       jit->orc_jit_->LoadSymbol(batched_wrapper_name));
+  jit->batched_invoker_ = absl::bit_cast<BatchedJitFunctionType>(fn_address);
   return jit;
 }
 
@@ -385,7 +431,8 @@ absl::StatusOr<InterpreterResult<Value>> FunctionJit::Run(
   InterpreterEvents events;
 
   absl::InlinedVector<uint8_t, 16> result_buffer(return_type_bytes_);
-  invoker_(arg_buffers.data(), result_buffer.data(), &events,
+  invoker_(arg_buffers.data(), result_buffer.data(),
+           can_produce_events_ ? &events : nullptr,
            /*user_data=*/nullptr, runtime());
 
   Value result = ir_runtime_->UnpackBuffer(
@@ -416,6 +463,12 @@ absl::Status FunctionJit::RunWithViews(absl::Span<uint8_t*> args,
                      return_type_bytes_));
   }
 
+  if (!can_produce_events_) {
+    invoker_(args.data(), result_buffer.data(), /*events=*/nullptr,
+             /*user_data=*/nullptr, runtime());
+    return absl::OkStatus();
+  }
+
   InterpreterEvents events;
 
   invoker_(args.data(), result_buffer.data(), &events, /*user_data=*/nullptr,
@@ -424,6 +477,64 @@ absl::Status FunctionJit::RunWithViews(absl::Span<uint8_t*> args,
   return InterpreterEventsToStatus(events);
 }
 
+absl::Status FunctionJit::RunWithPackedBuffers(
+    absl::Span<const uint8_t* const> args, absl::Span<uint8_t> result_buffer) {
+  absl::Span<Param* const> params = xls_function_->params();
+  if (args.size() != params.size()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Arg list to '%s' has the wrong size: %d vs expected %d.",
+        xls_function_->name(), args.size(), params.size()));
+  }
+  if (static_cast<int64_t>(result_buffer.size()) < packed_return_type_bytes_) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Result buffer too small - must be at least %d bytes!",
+                        packed_return_type_bytes_));
+  }
+
+  if (!can_produce_events_) {
+    packed_invoker_(args.data(), result_buffer.data(), /*events=*/nullptr,
+                    /*user_data=*/nullptr, runtime());
+    return absl::OkStatus();
+  }
+
+  InterpreterEvents events;
+
+  packed_invoker_(args.data(), result_buffer.data(), &events,
+                  /*user_data=*/nullptr, runtime());
+
+  return InterpreterEventsToStatus(events);
+}
+
+absl::Status FunctionJit::RunBatched(absl::Span<const uint8_t> packed_inputs,
+                                     absl::Span<uint8_t> packed_outputs,
+                                     int64_t count) {
+  if (static_cast<int64_t>(packed_inputs.size()) <
+      count * packed_input_record_bytes_) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Input buffer too small: %d bytes vs %d records of %d bytes.",
+        packed_inputs.size(), count, packed_input_record_bytes_));
+  }
+  if (static_cast<int64_t>(packed_outputs.size()) <
+      count * packed_return_type_bytes_) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Output buffer too small: %d bytes vs %d records of %d bytes.",
+        packed_outputs.size(), count, packed_return_type_bytes_));
+  }
+
+  if (!can_produce_events_) {
+    batched_invoker_(packed_inputs.data(), packed_outputs.data(), count,
+                     /*events=*/nullptr, /*user_data=*/nullptr, runtime());
+    return absl::OkStatus();
+  }
+
+  InterpreterEvents events;
+
+  batched_invoker_(packed_inputs.data(), packed_outputs.data(), count, &events,
+                   /*user_data=*/nullptr, runtime());
+
+  return InterpreterEventsToStatus(events);
+}
+
 absl::StatusOr<llvm::Function*> FunctionJit::BuildWrapper(
     llvm::Function* callee) {
   llvm::Module* module = callee->getParent();
@@ -553,6 +664,116 @@ absl::StatusOr<llvm::Function*> FunctionJit::BuildPackedWrapper(
   return wrapper_function;
 }
 
+absl::StatusOr<llvm::Function*> FunctionJit::BuildBatchedWrapper(
+    llvm::Function* callee) {
+  llvm::Module* module = callee->getParent();
+  llvm::LLVMContext* bare_context = orc_jit_->GetContext();
+
+  Type* xls_return_type = xls_function_->return_value()->GetType();
+  llvm::Type* ptr_type = llvm::PointerType::get(*bare_context, 0);
+  llvm::Type* i64_type = llvm::Type::getInt64Ty(*bare_context);
+  llvm::Type* i8_type = llvm::Type::getInt8Ty(*bare_context);
+  llvm::FunctionType* function_type = llvm::FunctionType::get(
+      llvm::Type::getVoidTy(*bare_context),
+      {ptr_type, ptr_type, i64_type, ptr_type, ptr_type, ptr_type},
+      /*isVarArg=*/false);
+
+  std::string function_name =
+      absl::StrFormat("%s_batched", xls_function_->name());
+  llvm::Function* wrapper_function = llvm::cast<llvm::Function>(
+      module->getOrInsertFunction(function_name, function_type).getCallee());
+
+  // Give the arguments meaningful names so debugging the LLVM IR is easier.
+  int64_t argc = 0;
+  wrapper_function->getArg(argc++)->setName("packed_inputs");
+  wrapper_function->getArg(argc++)->setName("packed_outputs");
+  wrapper_function->getArg(argc++)->setName("count");
+  wrapper_function->getArg(argc++)->setName("interpreter_events");
+  wrapper_function->getArg(argc++)->setName("user_data");
+  wrapper_function->getArg(argc++)->setName("jit_runtime");
+
+  auto entry_block =
+      llvm::BasicBlock::Create(*bare_context, "entry", wrapper_function);
+  auto loop_block =
+      llvm::BasicBlock::Create(*bare_context, "loop", wrapper_function);
+  auto exit_block =
+      llvm::BasicBlock::Create(*bare_context, "exit", wrapper_function);
+
+  llvm::Value* count = wrapper_function->getArg(2);
+  llvm::IRBuilder<> entry_builder(entry_block);
+  entry_builder.CreateCondBr(
+      entry_builder.CreateICmpSGT(count, llvm::ConstantInt::get(i64_type, 0)),
+      loop_block, exit_block);
+
+  // The loop body unpacks the record of the current sample, invokes the
+  // compiled function, and packs the result into the output record. With the
+  // loop inside the compiled code LLVM is free to inline the callee and unroll
+  // or vectorize across samples.
+  llvm::IRBuilder<> builder(loop_block);
+  llvm::PHINode* index = builder.CreatePHI(i64_type, 2, "index");
+  index->addIncoming(llvm::ConstantInt::get(i64_type, 0), entry_block);
+
+  llvm::Value* input_record = builder.CreateGEP(
+      i8_type, wrapper_function->getArg(0),
+      builder.CreateMul(
+          index, llvm::ConstantInt::get(i64_type, packed_input_record_bytes_)),
+      "input_record");
+  llvm::Value* output_record = builder.CreateGEP(
+      i8_type, wrapper_function->getArg(1),
+      builder.CreateMul(
+          index, llvm::ConstantInt::get(i64_type, packed_return_type_bytes_)),
+      "output_record");
+
+  std::vector<llvm::Value*> args;
+  int64_t byte_offset = 0;
+  for (int64_t i = 0; i < xls_function_->params().size(); ++i) {
+    Param* param = xls_function_->param(i);
+    if (param->GetType()->GetFlatBitCount() == 0) {
+      args.push_back(IrBuilderVisitor::CreateTypedZeroValue(
+          type_converter()->ConvertToLlvmType(param->GetType())));
+      continue;
+    }
+    llvm::Value* arg_ptr = builder.CreateGEP(
+        i8_type, input_record, llvm::ConstantInt::get(i64_type, byte_offset));
+    llvm::Value* packed_value = builder.CreateLoad(
+        type_converter()->ConvertToPackedLlvmType(param->GetType()), arg_ptr);
+    XLS_ASSIGN_OR_RETURN(
+        llvm::Value * unpacked_arg,
+        UnpackValue(param->GetType(), packed_value, *type_converter(),
+                    &builder));
+    args.push_back(unpacked_arg);
+    byte_offset += CeilOfRatio(param->GetType()->GetFlatBitCount(), int64_t{8});
+  }
+
+  // Pass through the final three arguments:
+  //   interpreter events, user data, JIT runtime pointer
+  args.push_back(wrapper_function->getArg(3));
+  args.push_back(wrapper_function->getArg(4));
+  args.push_back(wrapper_function->getArg(5));
+
+  llvm::Value* return_value = builder.CreateCall(callee, args);
+
+  if (xls_return_type->GetFlatBitCount() != 0) {
+    XLS_ASSIGN_OR_RETURN(
+        llvm::Value * packed_return,
+        PackValue(return_value, xls_return_type, *type_converter(), &builder));
+    builder.CreateStore(packed_return, output_record);
+    IrBuilderVisitor::UnpoisonBuffer(output_record, packed_return_type_bytes_,
+                                     &builder);
+  }
+
+  llvm::Value* next_index =
+      builder.CreateAdd(index, llvm::ConstantInt::get(i64_type, 1));
+  index->addIncoming(next_index, builder.GetInsertBlock());
+  builder.CreateCondBr(builder.CreateICmpSLT(next_index, count), loop_block,
+                       exit_block);
+
+  llvm::IRBuilder<> exit_builder(exit_block);
+  exit_builder.CreateRetVoid();
+
+  return wrapper_function;
+}
+
 absl::StatusOr<InterpreterResult<Value>> CreateAndRun(
     Function* xls_function, absl::Span<const Value> args) {
   // No proc support from Python yet.
@@ -92,6 +92,14 @@ class FunctionJit {
     // Walk the type tree to get each arg's data buffer into our view/arg list.
     PackArgBuffers(arg_buffers, &result_buffer, args...);
 
+    if (!can_produce_events_) {
+      // No trace or assert op is reachable from the function, so the compiled
+      // code never touches the events pointer.
+      packed_invoker_(arg_buffers, result_buffer, /*events=*/nullptr,
+                      /*user_data=*/nullptr, runtime());
+      return absl::OkStatus();
+    }
+
     InterpreterEvents events;
     packed_invoker_(arg_buffers, result_buffer, &events,
                     /*user_data=*/nullptr, runtime());
@@ -99,6 +107,40 @@ class FunctionJit {
     return InterpreterEventsToStatus(events);
   }
 
+  // As RunWithPackedViews, but with the packed buffers given directly rather
+  // than wrapped in compile-time-typed views, for callers whose types are only
+  // known at runtime (e.g. tools working with PackedValue, see
+  // xls/ir/packed_value.h). Each element of `args` points to a buffer holding
+  // the respective argument in the packed representation; `result_buffer`
+  // receives the packed result and must be at least
+  // GetPackedResultRecordSize() bytes.
+  // Drops any events collected during evaluation (except assertion failures
+  // which turn into errors), like RunWithViews.
+  absl::Status RunWithPackedBuffers(absl::Span<const uint8_t* const> args,
+                                    absl::Span<uint8_t> result_buffer);
+
+  // Executes the compiled function over a batch of `count` packed argument
+  // records in a single call. `packed_inputs` is a contiguous buffer of
+  // `count` records of GetPackedArgumentRecordSize() bytes each; within a
+  // record argument `i` begins at the byte offset equal to the sum of the
+  // packed sizes of the preceding arguments. `packed_outputs` receives `count`
+  // records of GetPackedResultRecordSize() bytes. The loop over records lives
+  // inside the compiled code, so type conversion is amortized over the batch
+  // and LLVM can unroll or vectorize across samples.
+  // Drops any events collected during evaluation (except assertion failures
+  // which turn into errors), like RunWithViews.
+  absl::Status RunBatched(absl::Span<const uint8_t> packed_inputs,
+                          absl::Span<uint8_t> packed_outputs, int64_t count);
+
+  // Sizes in bytes of one packed argument record and one packed result record
+  // as consumed/produced by RunBatched.
+  int64_t GetPackedArgumentRecordSize() const {
+    return packed_input_record_bytes_;
+  }
+  int64_t GetPackedResultRecordSize() const {
+    return packed_return_type_bytes_;
+  }
+
   // Returns the function that the JIT executes.
   FunctionBase* function() { return xls_function_; }
 
@@ -141,6 +183,13 @@ class FunctionJit {
   // representation.
   absl::StatusOr<llvm::Function*> BuildPackedWrapper(llvm::Function* callee);
 
+  // As BuildPackedWrapper but the wrapper contains a loop invoking `callee`
+  // once per packed argument record. The function signature is:
+  //
+  //   void f(uint8_t* packed_inputs, uint8_t* packed_outputs, int64_t count,
+  //          void* events, void* user_data, void* jit_runtime)
+  absl::StatusOr<llvm::Function*> BuildBatchedWrapper(llvm::Function* callee);
+
   // Simple templates to walk down the arg tree and populate the corresponding
   // arg/buffer pointer.
   template <typename FrontT, typename... RestT>
@@ -165,8 +214,19 @@ class FunctionJit {
   std::vector<int64_t> arg_type_bytes_;
   int64_t return_type_bytes_;
 
+  // Sizes of one packed argument record (all packed args concatenated at byte
+  // granularity) and one packed result record, as used by RunBatched.
+  int64_t packed_input_record_bytes_ = 0;
+  int64_t packed_return_type_bytes_ = 0;
+
   std::unique_ptr<JitRuntime> ir_runtime_;
 
+  // Whether a trace or assert op is reachable from the compiled function
+  // (directly or through invoked functions). Determined once at creation;
+  // when false, the run paths pass a null events pointer and skip event
+  // conversion, as the compiled code cannot record any event.
+  bool can_produce_events_ = false;
+
   // When initialized, this points to the compiled output.
   using JitFunctionType = void (*)(const uint8_t* const* inputs,
                                    uint8_t* output, InterpreterEvents* events,
@@ -180,6 +240,15 @@ class FunctionJit {
                                          void* user_data,
                                          JitRuntime* jit_runtime);
   PackedJitFunctionType packed_invoker_;
+
+  // Batched entry point for the above.
+  using BatchedJitFunctionType = void (*)(const uint8_t* packed_inputs,
+                                          uint8_t* packed_outputs,
+                                          int64_t count,
+                                          InterpreterEvents* events,
+                                          void* user_data,
+                                          JitRuntime* jit_runtime);
+  BatchedJitFunctionType batched_invoker_;
 };
 
 // Builds and returns an LLVM IR function constructed from the given XLS
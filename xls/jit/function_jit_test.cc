@@ -15,6 +15,8 @@
 #include "xls/jit/function_jit.h"
 
 #include <cstdio>
+#include <cstdlib>
+#include <filesystem>
 #include <random>
 
 #include "gmock/gmock.h"
@@ -22,12 +24,15 @@
 #include "absl/random/random.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/substitute.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
 #include "xls/common/status/matchers.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/interpreter/channel_queue.h"
 #include "xls/interpreter/ir_evaluator_test_base.h"
 #include "xls/interpreter/random_value.h"
 #include "xls/ir/function_builder.h"
+#include "xls/ir/packed_value.h"
 #include "re2/re2.h"
 
 namespace xls {
@@ -166,6 +171,114 @@ TEST(FunctionJitTest, TraceFmtBigArgTest) {
 }
 
 // This test verifies that a compiled JIT function can be re-used.
+TEST(FunctionJitTest, RunBatched) {
+  Package package("my_package");
+  std::string ir_text = R"(
+  fn add(a: bits[32], b: bits[32]) -> bits[32] {
+    ret add.3: bits[32] = add(a, b, id=3)
+  }
+  )";
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, FunctionJit::Create(function));
+  EXPECT_EQ(jit->GetPackedArgumentRecordSize(), 8);
+  EXPECT_EQ(jit->GetPackedResultRecordSize(), 4);
+
+  constexpr int64_t kBatchSize = 64;
+  std::vector<uint32_t> inputs(2 * kBatchSize);
+  for (int64_t i = 0; i < kBatchSize; ++i) {
+    inputs[2 * i] = i;
+    inputs[2 * i + 1] = 3 * i + 1;
+  }
+  std::vector<uint32_t> outputs(kBatchSize);
+  XLS_ASSERT_OK(jit->RunBatched(
+      absl::MakeConstSpan(absl::bit_cast<uint8_t*>(inputs.data()),
+                          inputs.size() * sizeof(uint32_t)),
+      absl::MakeSpan(absl::bit_cast<uint8_t*>(outputs.data()),
+                     outputs.size() * sizeof(uint32_t)),
+      kBatchSize));
+  for (int64_t i = 0; i < kBatchSize; ++i) {
+    EXPECT_EQ(outputs[i], 4 * i + 1) << "sample " << i;
+  }
+
+  // An undersized buffer is rejected rather than overrun.
+  EXPECT_THAT(jit->RunBatched(
+                  absl::MakeConstSpan(absl::bit_cast<uint8_t*>(inputs.data()),
+                                      inputs.size() * sizeof(uint32_t)),
+                  absl::MakeSpan(absl::bit_cast<uint8_t*>(outputs.data()),
+                                 (outputs.size() - 1) * sizeof(uint32_t)),
+                  kBatchSize),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(FunctionJitTest, RunWithPackedBuffers) {
+  Package package("my_package");
+  std::string ir_text = R"(
+  fn stitch(a: bits[12], b: bits[12]) -> (bits[12], bits[12]) {
+    ret tuple.3: (bits[12], bits[12]) = tuple(a, b, id=3)
+  }
+  )";
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, FunctionJit::Create(function));
+
+  Type* u12 = package.GetBitsType(12);
+  XLS_ASSERT_OK_AND_ASSIGN(PackedValue a,
+                           PackedValue::FromValue(Value(UBits(0xabc, 12)),
+                                                  u12));
+  XLS_ASSERT_OK_AND_ASSIGN(PackedValue b,
+                           PackedValue::FromValue(Value(UBits(0x123, 12)),
+                                                  u12));
+  std::vector<const uint8_t*> arg_buffers = {a.buffer(), b.buffer()};
+  std::vector<uint8_t> result_buffer(jit->GetPackedResultRecordSize());
+  XLS_ASSERT_OK(
+      jit->RunWithPackedBuffers(arg_buffers, absl::MakeSpan(result_buffer)));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      PackedValue result,
+      PackedValue::FromBuffer(result_buffer,
+                              function->return_value()->GetType()));
+  EXPECT_EQ(result.ToValue(),
+            Value::Tuple({Value(UBits(0xabc, 12)), Value(UBits(0x123, 12))}));
+
+  // An undersized result buffer is rejected rather than overrun.
+  EXPECT_THAT(jit->RunWithPackedBuffers(
+                  arg_buffers,
+                  absl::MakeSpan(result_buffer).subspan(1)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(FunctionJitTest, ObjectCachePersistsAcrossJitInstances) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory cache_dir, TempDirectory::Create());
+  setenv("XLS_JIT_OBJECT_CACHE_DIR", cache_dir.path().c_str(),
+         /*overwrite=*/1);
+
+  Package package("my_package");
+  std::string ir_text = R"(
+  fn add(a: bits[32], b: bits[32]) -> bits[32] {
+    ret add.3: bits[32] = add(a, b, id=3)
+  }
+  )";
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  std::vector<Value> args = {Value(UBits(2, 32)), Value(UBits(3, 32))};
+
+  // The first JIT populates the cache; the second one loads the compiled
+  // object from disk. Both must produce the same result.
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, FunctionJit::Create(function));
+  EXPECT_THAT(RunJitNoEvents(jit.get(), args),
+              IsOkAndHolds(Value(UBits(5, 32))));
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<std::filesystem::path> entries,
+                           GetDirectoryEntries(cache_dir.path()));
+  EXPECT_EQ(entries.size(), 1);
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto cached_jit, FunctionJit::Create(function));
+  EXPECT_THAT(RunJitNoEvents(cached_jit.get(), args),
+              IsOkAndHolds(Value(UBits(5, 32))));
+
+  unsetenv("XLS_JIT_OBJECT_CACHE_DIR");
+}
+
 TEST(FunctionJitTest, ReuseTest) {
   Package package("my_package");
   std::string ir_text = R"(
@@ -551,6 +664,132 @@ TEST(FunctionJitTest, ArrayConcatArrayOfArrays) {
   EXPECT_THAT(RunJitNoEvents(jit.get(), args), IsOkAndHolds(ret));
 }
 
+// Literal indices are lowered to extractvalue without an alloca round-trip;
+// out-of-bounds literal indices must still clamp to the last element.
+TEST(FunctionJitTest, ArrayIndexWithLiteralIndices) {
+  Package package("my_package");
+
+  std::string ir_text = R"(
+  fn f(a: bits[32][3]) -> (bits[32], bits[32]) {
+    literal.2: bits[8] = literal(value=1)
+    literal.3: bits[8] = literal(value=200)
+    array_index.4: bits[32] = array_index(a, indices=[literal.2])
+    array_index.5: bits[32] = array_index(a, indices=[literal.3])
+    ret tuple.6: (bits[32], bits[32]) = tuple(array_index.4, array_index.5)
+  }
+  )";
+
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, FunctionJit::Create(function));
+
+  XLS_ASSERT_OK_AND_ASSIGN(Value a, Value::UBitsArray({10, 20, 30}, 32));
+  Value ret = Value::Tuple({Value(UBits(20, 32)), Value(UBits(30, 32))});
+
+  std::vector args{a};
+  EXPECT_THAT(RunJitNoEvents(jit.get(), args), IsOkAndHolds(ret));
+}
+
+// A large constant table is kept in the module literal pool and indexed in
+// place rather than materialized per evaluation. Covers in-bounds and clamped
+// out-of-bounds dynamic indices.
+TEST(FunctionJitTest, PooledLiteralTableLookup) {
+  Package package("my_package");
+  FunctionBuilder b("table_lookup", &package);
+  std::vector<uint64_t> table(1024);
+  for (int64_t i = 0; i < 1024; ++i) {
+    table[i] = (i * 7 + 3) % 256;
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(Value table_value, Value::UBitsArray(table, 8));
+  BValue index = b.Param("i", package.GetBitsType(16));
+  b.ArrayIndex(b.Literal(table_value), {index});
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function, b.Build());
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, FunctionJit::Create(function));
+
+  for (uint64_t i : {uint64_t{0}, uint64_t{1}, uint64_t{511}, uint64_t{1023}}) {
+    std::vector<Value> args = {Value(UBits(i, 16))};
+    EXPECT_THAT(RunJitNoEvents(jit.get(), args),
+                IsOkAndHolds(Value(UBits((i * 7 + 3) % 256, 8))));
+  }
+  // An out-of-bounds index clamps to the last element.
+  std::vector<Value> args = {Value(UBits(5000, 16))};
+  EXPECT_THAT(RunJitNoEvents(jit.get(), args),
+              IsOkAndHolds(Value(UBits((1023 * 7 + 3) % 256, 8))));
+}
+
+// Literal-index updates become a single insertvalue; an out-of-bounds literal
+// index leaves the array unchanged.
+TEST(FunctionJitTest, ArrayUpdateWithLiteralIndices) {
+  Package package("my_package");
+
+  std::string ir_text = R"(
+  fn f(a: bits[32][3], v: bits[32]) -> bits[32][3] {
+    literal.3: bits[8] = literal(value=1)
+    literal.4: bits[8] = literal(value=200)
+    array_update.5: bits[32][3] = array_update(a, v, indices=[literal.3])
+    ret array_update.6: bits[32][3] = array_update(array_update.5, v, indices=[literal.4])
+  }
+  )";
+
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, FunctionJit::Create(function));
+
+  XLS_ASSERT_OK_AND_ASSIGN(Value a, Value::UBitsArray({10, 20, 30}, 32));
+  Value v = Value(UBits(99, 32));
+  XLS_ASSERT_OK_AND_ASSIGN(Value ret, Value::UBitsArray({10, 99, 30}, 32));
+
+  std::vector args{a, v};
+  EXPECT_THAT(RunJitNoEvents(jit.get(), args), IsOkAndHolds(ret));
+}
+
+TEST(FunctionJitTest, ArrayUpdateWithLiteralMultidimensionalIndices) {
+  Package package("my_package");
+
+  std::string ir_text = R"(
+  fn f(a: bits[32][2][2], v: bits[32]) -> bits[32][2][2] {
+    literal.3: bits[8] = literal(value=1)
+    literal.4: bits[8] = literal(value=0)
+    ret array_update.5: bits[32][2][2] = array_update(a, v, indices=[literal.3, literal.4])
+  }
+  )";
+
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, FunctionJit::Create(function));
+
+  XLS_ASSERT_OK_AND_ASSIGN(Value a, Value::UBits2DArray({{1, 2}, {3, 4}}, 32));
+  Value v = Value(UBits(99, 32));
+  XLS_ASSERT_OK_AND_ASSIGN(Value ret,
+                           Value::UBits2DArray({{1, 2}, {99, 4}}, 32));
+
+  std::vector args{a, v};
+  EXPECT_THAT(RunJitNoEvents(jit.get(), args), IsOkAndHolds(ret));
+}
+
+// Slices are now assembled with insertvalue chains; a slice running off the
+// end of the array replicates the last element.
+TEST(FunctionJitTest, ArraySliceWithLiteralStart) {
+  Package package("my_package");
+
+  std::string ir_text = R"(
+  fn f(a: bits[32][4]) -> bits[32][3] {
+    literal.2: bits[8] = literal(value=2)
+    ret array_slice.3: bits[32][3] = array_slice(a, literal.2, width=3)
+  }
+  )";
+
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, FunctionJit::Create(function));
+
+  XLS_ASSERT_OK_AND_ASSIGN(Value a, Value::UBitsArray({10, 20, 30, 40}, 32));
+  XLS_ASSERT_OK_AND_ASSIGN(Value ret, Value::UBitsArray({30, 40, 40}, 32));
+
+  std::vector args{a};
+  EXPECT_THAT(RunJitNoEvents(jit.get(), args), IsOkAndHolds(ret));
+}
+
 // The assert tests below are duplicates of the ones in
 // xls/interpereter/ir_evaluator_test_base.cc because those recompile
 // the test function each time they run it. These tests check that
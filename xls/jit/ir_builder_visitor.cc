@@ -27,6 +27,7 @@
 #endif
 
 #include "llvm/include/llvm/IR/Constants.h"
+#include "llvm/include/llvm/IR/GlobalVariable.h"
 #include "xls/codegen/vast.h"
 #include "xls/ir/function.h"
 #include "xls/ir/proc.h"
@@ -260,19 +261,22 @@ absl::StatusOr<std::vector<CompareTerm>> ExpandTerms(
   return terms;
 }
 
-// Returns the result of indexing into 'array' using the scalar index value
-// 'index'. 'array_size' is the number of elements in the array.
-absl::StatusOr<llvm::Value*> IndexIntoArray(llvm::Value* array,
-                                            llvm::Value* index,
-                                            int64_t array_size,
-                                            LlvmTypeConverter* type_converter,
-                                            llvm::IRBuilder<>* builder) {
+// Array literals whose flattened width is at least this many bits are kept in
+// the module literal pool (one constant global per table) and indexed in
+// place instead of being materialized as SSA aggregate values. Covers the
+// lookup tables TableSwitchPass produces while leaving small literals to
+// LLVM's constant folding.
+constexpr int64_t kLiteralPoolBitThreshold = 4096;
+
+// Returns 'index' clamped to [0, array_size - 1] and zero-extended by one bit
+// (our IR does not use negative indices, so the extra zero MSb prevents LLVM
+// from interpreting the index as such). An out-of-bounds index is set to the
+// maximum index value, matching XLS array-index semantics.
+llvm::Value* ClampArrayIndex(llvm::Value* index, int64_t array_size,
+                             LlvmTypeConverter* type_converter,
+                             llvm::IRBuilder<>* builder) {
   int64_t index_width = index->getType()->getIntegerBitWidth();
-
-  // Check for out-of-bounds access. If the index is out of bounds it is set to
-  // the maximum index value.
-  int64_t index_bitwidth = index->getType()->getIntegerBitWidth();
-  int64_t comparison_bitwidth = std::max(index_bitwidth, int64_t{64});
+  int64_t comparison_bitwidth = std::max(index_width, int64_t{64});
   llvm::Value* array_size_comparison_bitwidth = llvm::ConstantInt::get(
       llvm::Type::getIntNTy(builder->getContext(), comparison_bitwidth),
       array_size);
@@ -283,13 +287,33 @@ absl::StatusOr<llvm::Value*> IndexIntoArray(llvm::Value* array,
   llvm::Value* inbounds_index = builder->CreateSelect(
       is_index_inbounds, index,
       llvm::ConstantInt::get(index->getType(), array_size - 1));
+  return builder->CreateZExt(inbounds_index,
+                             type_converter->GetLlvmBitsType(index_width + 1));
+}
+
+// Returns the result of indexing into 'array' using the scalar index value
+// 'index'. 'array_size' is the number of elements in the array.
+absl::StatusOr<llvm::Value*> IndexIntoArray(llvm::Value* array,
+                                            llvm::Value* index,
+                                            int64_t array_size,
+                                            LlvmTypeConverter* type_converter,
+                                            llvm::IRBuilder<>* builder) {
+  // A constant index can be clamped at compile time and extracted directly
+  // from the aggregate. This keeps the array value in SSA form (no alloca
+  // round-trip through memory), producing the straight-line element accesses
+  // LLVM's SLP and loop vectorizers can turn into SIMD code.
+  if (auto* constant_index = llvm::dyn_cast<llvm::ConstantInt>(index)) {
+    const llvm::APInt& index_value = constant_index->getValue();
+    uint64_t inbounds_index = index_value.ugt(array_size - 1)
+                                  ? array_size - 1
+                                  : index_value.getZExtValue();
+    return builder->CreateExtractValue(
+        array, {static_cast<uint32_t>(inbounds_index)});
+  }
 
-  // Our IR does not use negative indices, so we add a
-  // zero MSb to prevent LLVM from interpreting this as such.
   std::vector<llvm::Value*> gep_indices = {
       llvm::ConstantInt::get(llvm::Type::getInt64Ty(builder->getContext()), 0),
-      builder->CreateZExt(inbounds_index,
-                          type_converter->GetLlvmBitsType(index_width + 1))};
+      ClampArrayIndex(index, array_size, type_converter, builder)};
 
   llvm::Type* array_type = array->getType();
   // Ideally, we'd use IRBuilder::CreateExtractValue here, but that requires
@@ -721,6 +745,29 @@ absl::Status IrBuilderVisitor::HandleArrayIndex(ArrayIndex* index) {
                         NumberedStrings("index", index->indices().size()))));
   llvm::IRBuilder<>& b = node_context.builder();
 
+  // Index pooled constant tables in place: loading one element from the
+  // constant global replaces materializing the whole table as an SSA
+  // aggregate, which a dynamic index would copy through an alloca on every
+  // evaluation. The unused table argument -- and with it the literal's node
+  // function -- is deleted once LLVM inlines the module.
+  if (ShouldPoolLiteral(index->array())) {
+    XLS_ASSIGN_OR_RETURN(
+        llvm::GlobalVariable * table,
+        GetOrCreatePooledLiteral(index->array()->As<Literal>()));
+    Type* element_type = index->array()->GetType();
+    std::vector<llvm::Value*> gep_indices = {b.getInt64(0)};
+    for (int64_t i = 1; i < index->operand_count(); ++i) {
+      gep_indices.push_back(ClampArrayIndex(
+          node_context.operand(i), element_type->AsArrayOrDie()->size(),
+          type_converter(), &b));
+      element_type = element_type->AsArrayOrDie()->element_type();
+    }
+    llvm::Value* gep = b.CreateGEP(table->getValueType(), table, gep_indices);
+    llvm::Value* element =
+        b.CreateLoad(type_converter()->ConvertToLlvmType(element_type), gep);
+    return FinalizeNodeIrContext(node_context, element);
+  }
+
   Type* element_type = index->array()->GetType();
   llvm::Value* element = node_context.operand(0);
   // Index operands start at 1.
@@ -754,11 +801,13 @@ absl::Status IrBuilderVisitor::HandleArraySlice(ArraySlice* slice) {
       slice->package()->GetBitsType(index_bits));
   llvm::Type* result_type =
       type_converter_->ConvertToLlvmType(slice->GetType());
-  llvm::Type* result_element_type = type_converter_->ConvertToLlvmType(
-      slice->GetType()->AsArrayOrDie()->element_type());
-  llvm::Value* alloca = b.CreateAlloca(result_type, 0, "alloca");
   llvm::Value* start_big = b.CreateZExt(start, index_type, "start_big");
 
+  // Assemble the result with an insertvalue chain rather than element stores
+  // into an alloca so the sliced array stays in SSA form. With a constant
+  // start the adds below fold and IndexIntoArray reduces each element to an
+  // extractvalue, leaving a vectorizable shuffle of the source array.
+  llvm::Value* sliced_array = CreateTypedZeroValue(result_type);
   for (int64_t i = 0; i < width; i++) {
     llvm::Value* index =
         b.CreateAdd(start_big, llvm::ConstantInt::get(index_type, i), "index");
@@ -767,14 +816,10 @@ absl::Status IrBuilderVisitor::HandleArraySlice(ArraySlice* slice) {
         IndexIntoArray(array, index,
                        slice->array()->GetType()->AsArrayOrDie()->size(),
                        type_converter(), &b));
-    std::vector<llvm::Value*> gep_indices = {
-        llvm::ConstantInt::get(llvm::Type::getInt64Ty(ctx()), i)};
-    llvm::Value* gep = b.CreateGEP(result_element_type, alloca, gep_indices);
-    b.CreateStore(value, gep);
+    sliced_array =
+        b.CreateInsertValue(sliced_array, value, {static_cast<uint32_t>(i)});
   }
 
-  llvm::Value* sliced_array = b.CreateLoad(result_type, alloca);
-
   return FinalizeNodeIrContext(node_context, sliced_array);
 }
 
@@ -795,6 +840,37 @@ absl::Status IrBuilderVisitor::HandleArrayUpdate(ArrayUpdate* update) {
     return FinalizeNodeIrContext(node_context, update_value);
   }
 
+  // If every index is a compile-time constant the update is a single
+  // insertvalue (or a no-op when out of bounds). This avoids the alloca and
+  // the conditional store below, keeping the array in SSA form where LLVM's
+  // vectorizers can handle chains of such updates.
+  if (std::all_of(indices.begin(), indices.end(), [](llvm::Value* index) {
+        return llvm::isa<llvm::ConstantInt>(index);
+      })) {
+    std::vector<uint32_t> constant_indices;
+    Type* indexed_type = update->array_to_update()->GetType();
+    bool out_of_bounds = false;
+    for (llvm::Value* index : indices) {
+      const llvm::APInt& index_value =
+          llvm::cast<llvm::ConstantInt>(index)->getValue();
+      int64_t array_size = indexed_type->AsArrayOrDie()->size();
+      if (index_value.ugt(array_size - 1)) {
+        out_of_bounds = true;
+        break;
+      }
+      constant_indices.push_back(
+          static_cast<uint32_t>(index_value.getZExtValue()));
+      indexed_type = indexed_type->AsArrayOrDie()->element_type();
+    }
+    if (out_of_bounds) {
+      // Out-of-bounds updates return the original array unchanged.
+      return FinalizeNodeIrContext(node_context, original_array);
+    }
+    llvm::Value* updated_array =
+        b.CreateInsertValue(original_array, update_value, constant_indices);
+    return FinalizeNodeIrContext(node_context, updated_array);
+  }
+
   llvm::Type* array_type = original_array->getType();
   llvm::AllocaInst* alloca = b.CreateAlloca(array_type);
   b.CreateStore(original_array, alloca);
@@ -1057,8 +1133,10 @@ absl::Status IrBuilderVisitor::HandleCountedFor(CountedFor* counted_for) {
           /*include_environment=*/true));
   llvm::IRBuilder<>& b = node_context.builder();
 
-  XLS_ASSIGN_OR_RETURN(llvm::Function * function,
+  XLS_ASSIGN_OR_RETURN(llvm::Function * loop_body_function,
                        GetOrBuildFunction(counted_for->body()));
+  llvm::Type* loop_body_function_type = loop_body_function->getFunctionType();
+
   // Add the loop carry and the index to the invariant arguments.
   std::vector<llvm::Value*> args(counted_for->invariant_args().size() + 2);
   for (int i = 0; i < counted_for->invariant_args().size(); i++) {
@@ -1067,21 +1145,89 @@ absl::Status IrBuilderVisitor::HandleCountedFor(CountedFor* counted_for) {
   }
 
   // Initial value is the zero-th operand of the counted-for.
-  args[1] = node_context.operand(0);
+  llvm::Value* init_loop_carry = node_context.operand(0);
 
   // Pass in the events, user_data, and runtime pointer to the loop body.
   args.push_back(node_context.GetInterpreterEvents());
   args.push_back(node_context.GetUserData());
   args.push_back(node_context.GetJitRuntime());
 
-  llvm::Type* function_type = function->getFunctionType();
-  for (int i = 0; i < counted_for->trip_count(); ++i) {
-    args[0] = llvm::ConstantInt::get(function_type->getFunctionParamType(0),
-                                     i * counted_for->stride());
-    args[1] = b.CreateCall(function, args);
-  }
+  // Emit a native loop with the body compiled once rather than unrolling
+  // trip_count calls into straight-line code: for large trip counts the
+  // unrolled form explodes code size and LLVM compile time, while LLVM is
+  // still free to unroll or vectorize the constant-bound loop if profitable.
+  // The block structure mirrors HandleDynamicCountedFor:
+  // Entry     - the code executed before the loop.
+  // Preheader - checks the loop condition.
+  // Loop      - calls the loop body, updates the loop carry and index.
+  // Exit      - the block we jump to after the loop.
+  // ------------------------------------------------------------------
+  // Entry
+  llvm::BasicBlock* entry_block = b.GetInsertBlock();
+  // Preheader
+  llvm::BasicBlock* preheader_block = llvm::BasicBlock::Create(
+      ctx(), absl::StrCat(counted_for->GetName(), "_preheader"),
+      node_context.llvm_function());
+  std::unique_ptr<llvm::IRBuilder<>> preheader_builder =
+      std::make_unique<llvm::IRBuilder<>>(preheader_block);
+  // Loop
+  llvm::BasicBlock* loop_block = llvm::BasicBlock::Create(
+      ctx(), absl::StrCat(counted_for->GetName(), "_loop_block"),
+      node_context.llvm_function());
+  std::unique_ptr<llvm::IRBuilder<>> loop_builder =
+      std::make_unique<llvm::IRBuilder<>>(loop_block);
+  // Exit
+  llvm::BasicBlock* exit_block = llvm::BasicBlock::Create(
+      ctx(), absl::StrCat(counted_for->GetName(), "_exit_block"),
+      node_context.llvm_function());
+  std::unique_ptr<llvm::IRBuilder<>> exit_builder =
+      std::make_unique<llvm::IRBuilder<>>(exit_block);
+
+  // The index, stride, and limit are all compile-time constants here.
+  llvm::Type* index_type = loop_body_function_type->getFunctionParamType(0);
+  llvm::Value* init_index = llvm::ConstantInt::get(index_type, 0);
+  llvm::Value* stride = llvm::ConstantInt::get(
+      index_type, counted_for->stride(), /*isSigned=*/true);
+  llvm::Value* index_limit = llvm::ConstantInt::get(
+      index_type, counted_for->trip_count() * counted_for->stride(),
+      /*isSigned=*/true);
+  b.CreateBr(preheader_block);
+
+  // Preheader
+  // Check if trip_count iterations completed.
+  // If so, exit loop. Otherwise, keep looping.
+  llvm::PHINode* index_phi = preheader_builder->CreatePHI(index_type, 2);
+  args[0] = index_phi;
+  llvm::PHINode* loop_carry_phi =
+      preheader_builder->CreatePHI(init_loop_carry->getType(), 2);
+  args[1] = loop_carry_phi;
+  llvm::Value* index_limit_reached =
+      preheader_builder->CreateICmpEQ(index_phi, index_limit);
+  preheader_builder->CreateCondBr(index_limit_reached, exit_block, loop_block);
+
+  // Loop
+  // Call the loop body function and increment the index before returning to
+  // the preheader.
+  llvm::Value* loop_carry =
+      loop_builder->CreateCall(loop_body_function, {args});
+  llvm::Value* inc_index = loop_builder->CreateAdd(index_phi, stride);
+  loop_builder->CreateBr(preheader_block);
+
+  // Set preheader Phi node inputs.
+  index_phi->addIncoming(init_index, entry_block);
+  index_phi->addIncoming(inc_index, loop_block);
+  loop_carry_phi->addIncoming(init_loop_carry, entry_block);
+  loop_carry_phi->addIncoming(loop_carry, loop_block);
 
-  return FinalizeNodeIrContext(node_context, args[1]);
+  // Single-input PHI node for the loop carry output so that, under single
+  // static assignment, the loop carry is only used in the loop (see
+  // HandleDynamicCountedFor for why llvm::formLCSSA does not do this for us).
+  llvm::PHINode* loop_carry_out =
+      exit_builder->CreatePHI(init_loop_carry->getType(), 1);
+  loop_carry_out->addIncoming(loop_carry_phi, preheader_block);
+
+  return FinalizeNodeIrContext(node_context, loop_carry_out,
+                               std::move(exit_builder));
 }
 
 absl::Status IrBuilderVisitor::HandleCover(Cover* cover) {
@@ -2039,6 +2185,28 @@ absl::StatusOr<llvm::Function*> IrBuilderVisitor::GetOrBuildFunction(
   return function_builder_(function);
 }
 
+/* static */ bool IrBuilderVisitor::ShouldPoolLiteral(Node* node) {
+  return node->Is<Literal>() && node->GetType()->IsArray() &&
+         node->GetType()->GetFlatBitCount() >= kLiteralPoolBitThreshold;
+}
+
+absl::StatusOr<llvm::GlobalVariable*>
+IrBuilderVisitor::GetOrCreatePooledLiteral(Literal* literal) {
+  XLS_ASSIGN_OR_RETURN(
+      llvm::Constant * constant,
+      type_converter()->ToLlvmConstant(literal->GetType(), literal->value()));
+  auto it = literal_pool_.find(constant);
+  if (it != literal_pool_.end()) {
+    return it->second;
+  }
+  auto* global = new llvm::GlobalVariable(
+      *module(), constant->getType(), /*isConstant=*/true,
+      llvm::GlobalValue::PrivateLinkage, constant,
+      absl::StrCat(literal->GetName(), "_pool"));
+  literal_pool_[constant] = global;
+  return global;
+}
+
 absl::StatusOr<NodeIrContext> IrBuilderVisitor::NewNodeIrContext(
     Node* node, absl::Span<const std::string> operand_names,
     bool include_environment) {
@@ -285,6 +285,17 @@ class IrBuilderVisitor : public DfsVisitorWithDefault {
   // if it has not yet been built.
   absl::StatusOr<llvm::Function*> GetOrBuildFunction(Function* function);
 
+  // Returns whether the given node is a large array literal which should be
+  // kept in the module literal pool and indexed in place rather than
+  // materialized as an SSA aggregate value.
+  static bool ShouldPoolLiteral(Node* node);
+
+  // Returns the module-level constant global holding the value of the given
+  // literal, creating it on first use. Globals are deduplicated by LLVM
+  // constant, so identical tables share one pool entry.
+  absl::StatusOr<llvm::GlobalVariable*> GetOrCreatePooledLiteral(
+      Literal* literal);
+
   // Creates and returns a new NodeIrContext for the given XLS node.
   absl::StatusOr<NodeIrContext> NewNodeIrContext(
       Node* node, absl::Span<const std::string> operand_names,
@@ -314,6 +325,10 @@ class IrBuilderVisitor : public DfsVisitorWithDefault {
 
   // Maps an XLS Node to the resulting LLVM Value.
   absl::flat_hash_map<Node*, llvm::Value*> node_map_;
+
+  // Module literal pool: maps the (uniqued) LLVM constant of a pooled array
+  // literal to the constant global holding it.
+  absl::flat_hash_map<llvm::Constant*, llvm::GlobalVariable*> literal_pool_;
 };
 
 }  // namespace xls
@@ -36,4 +36,25 @@ JitChannelQueueManager::CreateThreadUnsafe(Package* package) {
   return queue_mgr;
 }
 
+absl::StatusOr<std::unique_ptr<JitChannelQueueManager>>
+JitChannelQueueManager::CreateSingleProducerSingleConsumer(Package* package) {
+  auto queue_mgr = absl::WrapUnique(new JitChannelQueueManager(package));
+  XLS_RETURN_IF_ERROR(queue_mgr->Init<SpscJitChannelQueue>());
+  return queue_mgr;
+}
+
+absl::StatusOr<std::unique_ptr<JitChannelQueueManager>>
+JitChannelQueueManager::CreateFromQueues(
+    Package* package,
+    absl::flat_hash_map<int64_t, std::unique_ptr<JitChannelQueue>> queues) {
+  XLS_RET_CHECK_EQ(queues.size(), package->channels().size());
+  for (Channel* chan : package->channels()) {
+    XLS_RET_CHECK(queues.contains(chan->id()))
+        << "No queue provided for channel " << chan->name();
+  }
+  auto queue_mgr = absl::WrapUnique(new JitChannelQueueManager(package));
+  queue_mgr->queues_ = std::move(queues);
+  return queue_mgr;
+}
+
 }  // namespace xls
@@ -15,6 +15,7 @@
 #define XLS_JIT_JIT_CHANNEL_QUEUE_H_
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <string>
@@ -49,6 +50,15 @@ class JitChannelQueue {
   // Called to push data onto this queue/FIFO.
   virtual void Send(uint8_t* data, int64_t num_bytes) = 0;
 
+  // Attempts to push data onto this queue/FIFO without blocking. Returns
+  // false if the queue cannot accept the data right now. The default
+  // implementation suits unbounded queues, where Send always succeeds;
+  // bounded queues override this to fail instead of waiting when full.
+  virtual bool TrySend(uint8_t* data, int64_t num_bytes) {
+    Send(data, num_bytes);
+    return true;
+  }
+
   // Called to pull data off of this queue/FIFO.
   //  Returns
   //   true : The queue is non-empty, and the data at queue front is copied
@@ -317,6 +327,110 @@ class LocklessFifoJitChannelQueue : public JitChannelQueue {
   absl::InlinedVector<uint8_t, kInitBufferSize> circular_buffer_;
 };
 
+// Queue for streaming channels with exactly one producer thread and one
+// consumer thread, which matches how XLS channels are used: each channel is
+// sent on by a single proc and received on by a single proc. The
+// implementation is a lock-free ring buffer: the enqueue index is written only
+// by the producer and the dequeue index only by the consumer, and the two
+// indices are padded onto separate cache lines to avoid false sharing. Unlike
+// the queues above the ring has a fixed capacity: when the queue is full Send
+// spins until the consumer drains a slot, so the consumer must be running
+// concurrently with the producer.
+class SpscJitChannelQueue : public JitChannelQueue {
+ public:
+  explicit SpscJitChannelQueue(int64_t channel_id)
+      : JitChannelQueue(channel_id),
+        channel_element_size_(0),
+        allocated_element_size_(0) {}
+
+  void Send(uint8_t* data, int64_t num_bytes) override {
+    // Spin until the consumer has drained a slot.
+    while (!TrySend(data, num_bytes)) {
+    }
+  }
+
+  bool TrySend(uint8_t* data, int64_t num_bytes) override {
+#ifdef ABSL_HAVE_MEMORY_SANITIZER
+    __msan_unpoison(data, num_bytes);
+#endif
+    // TODO(vmirian): 8-09-2022 Provide the element size at the constructor and
+    // remove the following if statement.
+    if (channel_element_size_ == 0) {
+      channel_element_size_ = num_bytes;
+      allocated_element_size_ =
+          RoundUpToNearest(channel_element_size_,
+                           static_cast<int64_t>(alignof(std::max_align_t)));
+      // All slots are preallocated up front; the ring never grows. The
+      // consumer only touches the buffer after observing the enqueue index
+      // advance, so the allocation is safely published by the release store
+      // below.
+      circular_buffer_.resize(kCapacity * allocated_element_size_);
+    }
+    XLS_CHECK_EQ(num_bytes, channel_element_size_) << absl::StrFormat(
+        "Invalid number of bytes given to Send Function of "
+        "SpscJitChannelQueue: expected (%s), got (%s).",
+        std::to_string(channel_element_size_), std::to_string(num_bytes));
+
+    uint64_t enqueue_index = enqueue_index_.load(std::memory_order_relaxed);
+    if (enqueue_index - dequeue_index_.load(std::memory_order_acquire) >=
+        kCapacity) {
+      return false;
+    }
+    memcpy(circular_buffer_.data() +
+               (enqueue_index % kCapacity) * allocated_element_size_,
+           data, channel_element_size_);
+    enqueue_index_.store(enqueue_index + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool Recv(uint8_t* buffer, int64_t num_bytes) override {
+    uint64_t dequeue_index = dequeue_index_.load(std::memory_order_relaxed);
+    if (dequeue_index == enqueue_index_.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    XLS_CHECK_EQ(num_bytes, channel_element_size_) << absl::StrFormat(
+        "Invalid number of bytes given to Recv Function of "
+        "SpscJitChannelQueue: expected (%s), got (%s).",
+        std::to_string(channel_element_size_), std::to_string(num_bytes));
+
+    memcpy(buffer,
+           circular_buffer_.data() +
+               (dequeue_index % kCapacity) * allocated_element_size_,
+           channel_element_size_);
+    dequeue_index_.store(dequeue_index + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool Empty() override {
+    return dequeue_index_.load(std::memory_order_acquire) ==
+           enqueue_index_.load(std::memory_order_acquire);
+  }
+
+ protected:
+  // Number of preallocated element slots in the ring buffer.
+  static constexpr uint64_t kCapacity = 1024;
+  // Typical cache line size used to pad the indices.
+  static constexpr size_t kCacheLineBytes = 64;
+
+  // Size of an element in the channel in units of bytes. The producers and
+  // consumers must sent buffer length equivalent to this size. It is
+  // initialized on the first call to send.
+  int64_t channel_element_size_;
+  // Allocated size of an element in the circular buffer in units of bytes. The
+  // elements are aligned to the largest scalar type.
+  int64_t allocated_element_size_;
+  // A circular buffer to store the elements. It is preallocated with storage
+  // for kCapacity elements on the first send.
+  std::vector<uint8_t> circular_buffer_;
+  // Monotonically increasing count of dequeued elements; written only by the
+  // consumer. The slot index is the count modulo kCapacity.
+  alignas(kCacheLineBytes) std::atomic<uint64_t> dequeue_index_{0};
+  // Monotonically increasing count of enqueued elements; written only by the
+  // producer.
+  alignas(kCacheLineBytes) std::atomic<uint64_t> enqueue_index_{0};
+};
+
 // Queue for single value channels. Unsurprisingly, this queue holds a single
 // value. The value is read non-destructively with the Recv method and is
 // overwritten via the Send method.
@@ -375,6 +489,23 @@ class JitChannelQueueManager {
   static absl::StatusOr<std::unique_ptr<JitChannelQueueManager>>
   CreateThreadUnsafe(Package* package);
 
+  // Returns a JitChannelQueueManager mapping every streaming channel to a
+  // lock-free xls::SpscJitChannelQueue. Intended for runtimes where each
+  // channel is accessed by exactly one concurrently running producer thread
+  // and one consumer thread.
+  static absl::StatusOr<std::unique_ptr<JitChannelQueueManager>>
+  CreateSingleProducerSingleConsumer(Package* package);
+
+  // Returns a JitChannelQueueManager holding the provided queues, keyed by
+  // channel id. Used by runtimes that construct queue implementations with
+  // per-channel configuration, e.g. shared-memory queues (see
+  // shm_channel_queue.h). Fails unless the map holds exactly one queue for
+  // every channel in the package.
+  static absl::StatusOr<std::unique_ptr<JitChannelQueueManager>>
+  CreateFromQueues(
+      Package* package,
+      absl::flat_hash_map<int64_t, std::unique_ptr<JitChannelQueue>> queues);
+
   absl::StatusOr<JitChannelQueue*> GetQueueById(int64_t channel_id) {
     XLS_RET_CHECK(queues_.contains(channel_id));
     return queues_.at(channel_id).get();
@@ -19,6 +19,8 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/base/casts.h"
+#include "xls/common/thread.h"
 
 namespace xls {
 namespace {
@@ -72,10 +74,33 @@ REGISTER_TYPED_TEST_SUITE_P(FifoJitChannelQueueTypedTest, BasicAccess,
                             Failures);
 
 using FifoTypes =
-    ::testing::Types<FifoJitChannelQueue, LocklessFifoJitChannelQueue>;
+    ::testing::Types<FifoJitChannelQueue, LocklessFifoJitChannelQueue,
+                     SpscJitChannelQueue>;
 INSTANTIATE_TYPED_TEST_SUITE_P(FifoJitChannelQueue,
                                FifoJitChannelQueueTypedTest, FifoTypes);
 
+// Streams enough elements through an SpscJitChannelQueue to wrap the ring
+// buffer many times and force the producer to spin on a full queue, with the
+// producer and consumer on separate threads.
+TEST(JitChannelQueue, SpscConcurrentProducerConsumer) {
+  SpscJitChannelQueue queue(0);
+  constexpr int64_t kNumElements = 100000;
+  Thread producer([&queue]() {
+    for (int64_t i = 0; i < kNumElements; ++i) {
+      int32_t value = i;
+      queue.Send(absl::bit_cast<uint8_t*>(&value), sizeof(value));
+    }
+  });
+  for (int64_t i = 0; i < kNumElements; ++i) {
+    int32_t value;
+    while (!queue.Recv(absl::bit_cast<uint8_t*>(&value), sizeof(value))) {
+    }
+    ASSERT_EQ(value, i);
+  }
+  producer.Join();
+  EXPECT_TRUE(queue.Empty());
+}
+
 TEST(JitChannelQueue, SingleValueJitChannelQueue) {
   SingleValueJitChannelQueue channel(0);
   EXPECT_EQ(channel.channel_id(), 0);
@@ -14,6 +14,9 @@
 
 #include "xls/jit/jit_runtime.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "absl/strings/str_format.h"
 #include "llvm/include/llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
 #include "llvm/include/llvm/Support/TargetSelect.h"
@@ -51,86 +54,95 @@ absl::Status JitRuntime::PackArgs(absl::Span<const Value> args,
 
 Value JitRuntime::UnpackBuffer(const uint8_t* buffer, const Type* result_type,
                                bool unpoison) {
-  switch (result_type->kind()) {
-    case TypeKind::kBits: {
-      const BitsType* bits_type = result_type->AsBitsOrDie();
-      int64_t bit_count = bits_type->bit_count();
-      int64_t byte_count = CeilOfRatio(bit_count, kCharBit);
-      absl::InlinedVector<uint8_t, 8> data;
-      data.reserve(byte_count);
 #ifdef ABSL_HAVE_MEMORY_SANITIZER
-      if (unpoison) {
-        __msan_unpoison(buffer, byte_count);
-      }
+  if (unpoison) {
+    // The leaf table below reads from arbitrary offsets within the buffer, so
+    // unpoison its full extent up front.
+    __msan_unpoison(buffer, type_converter_->GetTypeByteSize(result_type));
+  }
 #endif  // ABSL_HAVE_MEMORY_SANITIZER
-      for (int i = 0; i < byte_count; ++i) {
-        data.push_back(buffer[i]);
-      }
+  const TypeLayout& layout = GetOrCreateTypeLayout(result_type);
+  int64_t next_leaf = 0;
+  return UnpackValue(result_type, layout, &next_leaf, buffer);
+}
 
-      // We could copy the data out of the buffer to avoid a swap, but it's
-      // probably not worth the effort.
-      if (data_layout_.isLittleEndian()) {
-        ByteSwap(absl::MakeSpan(data));
-      }
+void JitRuntime::BlitValueToBuffer(const Value& value, const Type* type,
+                                   absl::Span<uint8_t> buffer) {
+  const TypeLayout& layout = GetOrCreateTypeLayout(type);
+  int64_t next_leaf = 0;
+  BlitValueLeaves(value, layout, &next_leaf, buffer);
+}
 
-      return Value(Bits::FromBytes(absl::MakeSpan(data), bit_count));
-    }
+const JitRuntime::TypeLayout& JitRuntime::GetOrCreateTypeLayout(
+    const Type* type) {
+  auto it = layout_cache_.find(type);
+  if (it == layout_cache_.end()) {
+    TypeLayout layout;
+    AppendTypeLayout(type, /*base_offset=*/0, &layout);
+    it = layout_cache_.emplace(type, std::move(layout)).first;
+  }
+  return it->second;
+}
+
+void JitRuntime::AppendTypeLayout(const Type* type, int64_t base_offset,
+                                  TypeLayout* layout) {
+  switch (type->kind()) {
+    case TypeKind::kBits:
+      layout->push_back(
+          LeafLayout{base_offset, type->AsBitsOrDie()->bit_count()});
+      return;
     case TypeKind::kTuple: {
-      // Just as with arg packing, we need the DataLayout to tell us where each
-      // arg is placed in the output buffer.
-      const TupleType* tuple_type = result_type->AsTupleOrDie();
+      // Due to per-target data packing (esp. as realized by the LLVM IR
+      // load/store instructions), we need the DataLayout to tell us where
+      // each constituent element is placed.
+      const TupleType* tuple_type = type->AsTupleOrDie();
       llvm::Type* llvm_type = type_converter_->ConvertToLlvmType(tuple_type);
-      const llvm::StructLayout* layout =
+      const llvm::StructLayout* struct_layout =
           data_layout_.getStructLayout(llvm::cast<llvm::StructType>(llvm_type));
-
-      std::vector<Value> values;
-      values.reserve(tuple_type->size());
       for (int i = 0; i < tuple_type->size(); ++i) {
-        Value value = UnpackBuffer(buffer + layout->getElementOffset(i),
-                                   tuple_type->element_type(i));
-        values.push_back(value);
+        AppendTypeLayout(tuple_type->element_type(i),
+                         base_offset + struct_layout->getElementOffset(i),
+                         layout);
       }
-      return Value::TupleOwned(std::move(values));
+      return;
     }
     case TypeKind::kArray: {
-      const ArrayType* array_type = result_type->AsArrayOrDie();
+      // Lay out the first element, then stamp out the rest at the element
+      // stride; all elements share the same internal shape.
+      const ArrayType* array_type = type->AsArrayOrDie();
       if (array_type->size() == 0) {
-        return Value::ArrayOrDie({});
+        return;
       }
-
-      const Type* element_type = array_type->element_type();
-      llvm::Type* llvm_element_type =
-          type_converter_->ConvertToLlvmType(array_type->element_type());
-      std::vector<Value> values;
-      values.reserve(array_type->size());
-      // This BitsType is only used inside the ToLlvmConstantCall() (and isn't
-      // stored), so it's safe for it to live on the stack.
-      BitsType bits_type(64);
-      for (int i = 0; i < array_type->size(); ++i) {
-        llvm::Constant* index =
-            type_converter_->ToLlvmConstant(&bits_type, Value(UBits(i, 64)))
-                .value();
-        int64_t offset =
-            data_layout_.getIndexedOffsetInType(llvm_element_type, index);
-        Value value = UnpackBuffer(buffer + offset, element_type);
-        values.push_back(value);
+      int64_t stride =
+          type_converter_->GetTypeByteSize(array_type->element_type());
+      int64_t first = layout->size();
+      AppendTypeLayout(array_type->element_type(), base_offset, layout);
+      int64_t leaves_per_element = layout->size() - first;
+      layout->reserve(first + leaves_per_element * array_type->size());
+      for (int64_t i = 1; i < array_type->size(); ++i) {
+        for (int64_t j = 0; j < leaves_per_element; ++j) {
+          layout->push_back(LeafLayout{(*layout)[first + j].offset + i * stride,
+                                       (*layout)[first + j].bit_count});
+        }
       }
-
-      return Value::ArrayOrDie(values);
+      return;
     }
     case TypeKind::kToken:
-      return Value::Token();
+      // Tokens contain no data.
+      return;
     default:
-      XLS_LOG(FATAL) << "Unsupported XLS Value kind: " << result_type->kind();
+      XLS_LOG(FATAL) << "Unsupported XLS type kind: " << type->kind();
   }
 }
 
-void JitRuntime::BlitValueToBuffer(const Value& value, const Type* type,
-                                   absl::Span<uint8_t> buffer) {
+void JitRuntime::BlitValueLeaves(const Value& value, const TypeLayout& layout,
+                                 int64_t* next_leaf,
+                                 absl::Span<uint8_t> buffer) {
   if (value.IsBits()) {
+    const LeafLayout& leaf = layout[(*next_leaf)++];
     const Bits& bits = value.bits();
     int64_t byte_count = CeilOfRatio(bits.bit_count(), kCharBit);
-    bits.ToBytes(absl::MakeSpan(buffer.data(), byte_count),
+    bits.ToBytes(absl::MakeSpan(buffer.data() + leaf.offset, byte_count),
                  data_layout_.isBigEndian());
 
     // Clear out any bits in storage above that indicated by the data type -
@@ -139,29 +151,14 @@ void JitRuntime::BlitValueToBuffer(const Value& value, const Type* type,
     // Max of 7 bits of remainder on the [little-endian] most-significant byte.
     int remainder_bits = bits.bit_count() % kCharBit;
     if (remainder_bits != 0) {
-      buffer[byte_count - 1] &= static_cast<uint8_t>(Mask(remainder_bits));
-    }
-  } else if (value.IsArray()) {
-    const ArrayType* array_type = type->AsArrayOrDie();
-    int64_t element_size =
-        type_converter_->GetTypeByteSize(array_type->element_type());
-    for (int i = 0; i < value.size(); ++i) {
-      BlitValueToBuffer(value.element(i), array_type->element_type(), buffer);
-      buffer = buffer.subspan(element_size);
+      buffer[leaf.offset + byte_count - 1] &=
+          static_cast<uint8_t>(Mask(remainder_bits));
     }
-  } else if (value.IsTuple()) {
-    // Due to per-target data packing (esp. as realized by the LLVM IR
-    // load/store instructions), we need to make sure we blit args into LLVM
-    // space as the underlying runtime expects, which means we need the
-    // DataLayout to tell us where each constituent element should be placed.
-    llvm::Type* llvm_type = type_converter_->ConvertToLlvmType(type);
-    const llvm::StructLayout* layout =
-        data_layout_.getStructLayout(llvm::cast<llvm::StructType>(llvm_type));
-
-    const TupleType* tuple_type = type->AsTupleOrDie();
+  } else if (value.IsArray() || value.IsTuple()) {
+    // Aggregates contribute no leaves of their own; their elements consume
+    // table entries in depth-first order.
     for (int i = 0; i < value.size(); ++i) {
-      BlitValueToBuffer(value.element(i), tuple_type->element_type(i),
-                        buffer.subspan(layout->getElementOffset(i)));
+      BlitValueLeaves(value.element(i), layout, next_leaf, buffer);
     }
   } else if (value.IsToken()) {
     // Tokens contain no data.
@@ -170,6 +167,68 @@ void JitRuntime::BlitValueToBuffer(const Value& value, const Type* type,
   }
 }
 
+Value JitRuntime::UnpackValue(const Type* type, const TypeLayout& layout,
+                              int64_t* next_leaf, const uint8_t* buffer) {
+  switch (type->kind()) {
+    case TypeKind::kBits: {
+      const LeafLayout& leaf = layout[(*next_leaf)++];
+      int64_t bit_count = leaf.bit_count;
+      int64_t byte_count = CeilOfRatio(bit_count, kCharBit);
+      const uint8_t* data = buffer + leaf.offset;
+      if (data_layout_.isLittleEndian()) {
+        // The buffer already holds the value least-significant byte first;
+        // reconstruct the Bits a word at a time instead of copying the bytes
+        // out and swapping them.
+        BitsBuilder builder(bit_count);
+        for (int64_t offset = 0; offset < byte_count; offset += 8) {
+          int64_t chunk_bytes = std::min<int64_t>(8, byte_count - offset);
+          uint64_t word = 0;
+          memcpy(&word, data + offset, chunk_bytes);
+          builder.AppendWord(word,
+                             std::min<int64_t>(64, bit_count - offset * 8));
+        }
+        return Value(builder.Build());
+      }
+
+      absl::InlinedVector<uint8_t, 8> bytes;
+      bytes.reserve(byte_count);
+      for (int i = 0; i < byte_count; ++i) {
+        bytes.push_back(data[i]);
+      }
+      return Value(Bits::FromBytes(absl::MakeSpan(bytes), bit_count));
+    }
+    case TypeKind::kTuple: {
+      const TupleType* tuple_type = type->AsTupleOrDie();
+      std::vector<Value> values;
+      values.reserve(tuple_type->size());
+      for (int i = 0; i < tuple_type->size(); ++i) {
+        values.push_back(
+            UnpackValue(tuple_type->element_type(i), layout, next_leaf,
+                        buffer));
+      }
+      return Value::TupleOwned(std::move(values));
+    }
+    case TypeKind::kArray: {
+      const ArrayType* array_type = type->AsArrayOrDie();
+      if (array_type->size() == 0) {
+        return Value::ArrayOrDie({});
+      }
+      std::vector<Value> values;
+      values.reserve(array_type->size());
+      for (int i = 0; i < array_type->size(); ++i) {
+        values.push_back(
+            UnpackValue(array_type->element_type(), layout, next_leaf,
+                        buffer));
+      }
+      return Value::ArrayOrDie(values);
+    }
+    case TypeKind::kToken:
+      return Value::Token();
+    default:
+      XLS_LOG(FATAL) << "Unsupported XLS type kind: " << type->kind();
+  }
+}
+
 }  // namespace xls
 
 extern "C" {
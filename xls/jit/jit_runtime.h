@@ -16,7 +16,9 @@
 #define XLS_JIT_JIT_RUNTIME_H_
 
 #include <cstdint>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/types/span.h"
 #include "llvm/include/llvm/IR/DataLayout.h"
@@ -58,8 +60,47 @@ class JitRuntime {
                          absl::Span<uint8_t> buffer);
 
  private:
+  // Where a single Bits-typed leaf of a type lives in the type's native LLVM
+  // buffer: the byte offset of its storage and how many bits of that storage
+  // are meaningful.
+  struct LeafLayout {
+    int64_t offset;
+    int64_t bit_count;
+  };
+
+  // The positions of all Bits leaves of a type in depth-first order. The
+  // DataLayout queries needed to compute these offsets are made once per type;
+  // packing and unpacking then execute the table as a linear sequence of
+  // bounded copies.
+  using TypeLayout = std::vector<LeafLayout>;
+
+  // Returns the (cached) leaf table for the given type, computing it on first
+  // use.
+  const TypeLayout& GetOrCreateTypeLayout(const Type* type);
+
+  // Appends the leaves of `type`, placed at `base_offset`, to `layout`.
+  void AppendTypeLayout(const Type* type, int64_t base_offset,
+                        TypeLayout* layout);
+
+  // Copies the Bits leaves of `value` (visited depth-first, mirroring the
+  // order in which AppendTypeLayout emitted them) into `buffer` at the
+  // offsets given by `layout`. `next_leaf` is the index of the next unused
+  // table entry.
+  void BlitValueLeaves(const Value& value, const TypeLayout& layout,
+                       int64_t* next_leaf, absl::Span<uint8_t> buffer);
+
+  // Inverse of BlitValueLeaves: builds a Value of the given type by reading
+  // each Bits leaf out of `buffer` at the offset given by `layout`.
+  Value UnpackValue(const Type* type, const TypeLayout& layout,
+                    int64_t* next_leaf, const uint8_t* buffer);
+
   llvm::DataLayout data_layout_;
   LlvmTypeConverter* type_converter_;
+
+  // Cache of per-type leaf tables. Keyed by Type pointer; types are interned
+  // by their owning package. Unsynchronized, like the type cache inside
+  // LlvmTypeConverter.
+  absl::flat_hash_map<const Type*, TypeLayout> layout_cache_;
 };
 
 extern "C" {
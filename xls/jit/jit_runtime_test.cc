@@ -0,0 +1,100 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/jit_runtime.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/package.h"
+#include "xls/ir/type.h"
+#include "xls/ir/value.h"
+#include "xls/jit/orc_jit.h"
+
+namespace xls {
+namespace {
+
+class JitRuntimeTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        orc_jit_, OrcJit::Create(/*opt_level=*/0, /*emit_object_code=*/false));
+    runtime_ = std::make_unique<JitRuntime>(orc_jit_->GetDataLayout(),
+                                            &orc_jit_->GetTypeConverter());
+  }
+
+  // Blits the given value into a fresh buffer of the native size for its type
+  // and unpacks it again. The buffer is prefilled with junk so the test
+  // catches reads of padding bytes the blit never wrote.
+  Value RoundTrip(const Value& value) {
+    Type* type = package_.GetTypeForValue(value);
+    std::vector<uint8_t> buffer(
+        orc_jit_->GetTypeConverter().GetTypeByteSize(type), 0xab);
+    runtime_->BlitValueToBuffer(value, type, absl::MakeSpan(buffer));
+    return runtime_->UnpackBuffer(buffer.data(), type);
+  }
+
+  Value ParseValue(absl::string_view s) {
+    return Parser::ParseTypedValue(s).value();
+  }
+
+  Package package_{"jit_runtime_test"};
+  std::unique_ptr<OrcJit> orc_jit_;
+  std::unique_ptr<JitRuntime> runtime_;
+};
+
+TEST_F(JitRuntimeTest, BitsOfVariousWidthsRoundTrip) {
+  for (absl::string_view s :
+       {"bits[1]:1", "bits[3]:0b101", "bits[8]:0xab", "bits[17]:0x1abcd",
+        "bits[64]:0xdead_beef_feed_f00d",
+        "bits[127]:0x5555_5555_5555_5555_5555_5555_5555_5555"}) {
+    Value value = ParseValue(s);
+    EXPECT_EQ(RoundTrip(value), value) << s;
+  }
+}
+
+TEST_F(JitRuntimeTest, NestedTupleRoundTrip) {
+  Value value = ParseValue(
+      "(bits[3]:5, (bits[33]:0x1_0000_0001, bits[1]:0), bits[64]:42)");
+  EXPECT_EQ(RoundTrip(value), value);
+}
+
+TEST_F(JitRuntimeTest, ArrayOfTuplesRoundTrip) {
+  Value value = ParseValue(
+      "[(bits[13]:0x1234, bits[7]:0x7f), (bits[13]:0x0, bits[7]:0x1), "
+      "(bits[13]:0x1fff, bits[7]:0x55)]");
+  // Two trips through the same runtime so the second uses the cached layout
+  // table.
+  EXPECT_EQ(RoundTrip(value), value);
+  EXPECT_EQ(RoundTrip(value), value);
+}
+
+TEST_F(JitRuntimeTest, SingleElementArrayRoundTrip) {
+  Value value = ParseValue("(bits[4]:0xa, [bits[16]:0xbeef], bits[4]:0x5)");
+  EXPECT_EQ(RoundTrip(value), value);
+}
+
+TEST_F(JitRuntimeTest, TokenInTupleRoundTrip) {
+  Value value = Value::Tuple({Value::Token(), ParseValue("bits[9]:0x155")});
+  EXPECT_EQ(RoundTrip(value), value);
+}
+
+}  // namespace
+}  // namespace xls
@@ -14,10 +14,15 @@
 
 #include "xls/jit/orc_jit.h"
 
+#include <unistd.h>
+
 #include <cerrno>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
+#include <filesystem>
 #include <memory>
+#include <string>
 #include <system_error>  // NOLINT
 
 #include "absl/memory/memory.h"
@@ -38,6 +43,9 @@
 #include "llvm/include/llvm/Passes/OptimizationLevel.h"
 #include "llvm/include/llvm/Passes/PassBuilder.h"
 #include "llvm/include/llvm/Support/CodeGen.h"
+#include "llvm/include/llvm/Support/MD5.h"
+#include "llvm/include/llvm/Support/MemoryBuffer.h"
+#include "xls/common/file/filesystem.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/logging/vlog_is_on.h"
@@ -81,6 +89,62 @@ class BadOptLevelError : public llvm::ErrorInfo<BadOptLevelError> {
 
 char BadOptLevelError::ID;
 
+// Environment variable naming the directory of the persistent object cache.
+constexpr char kObjectCacheDirEnv[] = "XLS_JIT_OBJECT_CACHE_DIR";
+
+// Returns the filename of the cache entry for the given (unoptimized) module
+// compiled at the given optimization level.
+std::string CacheEntryFilename(const llvm::Module& module, int64_t opt_level) {
+  llvm::MD5 hasher;
+  hasher.update(DumpLlvmModuleToString(&module));
+  hasher.update(absl::StrCat("-O", opt_level));
+  llvm::MD5::MD5Result result;
+  hasher.final(result);
+  return absl::StrCat(result.digest().str().str(), ".o");
+}
+
+// Writes freshly compiled objects into the persistent cache. Lookups happen up
+// front in OrcJit::CompileModule keyed by the unoptimized IR; by the time the
+// compiler runs the module has been transformed, so the entry path computed at
+// lookup time is carried in via `pending_entry`.
+class CacheWriter : public llvm::ObjectCache {
+ public:
+  explicit CacheWriter(std::filesystem::path* pending_entry)
+      : pending_entry_(pending_entry) {}
+
+  void notifyObjectCompiled(const llvm::Module* module,
+                            llvm::MemoryBufferRef object) override {
+    if (pending_entry_->empty()) {
+      return;
+    }
+    // Write to a temporary file and rename so concurrent processes sharing the
+    // cache never observe a partially written object.
+    std::filesystem::path temp_path = *pending_entry_;
+    temp_path += absl::StrCat(".tmp.", getpid());
+    absl::Status status = SetFileContents(
+        temp_path, absl::string_view(object.getBuffer().data(),
+                                     object.getBuffer().size()));
+    if (status.ok()) {
+      std::error_code ec;
+      std::filesystem::rename(temp_path, *pending_entry_, ec);
+    } else {
+      XLS_LOG(WARNING) << "Unable to write JIT object cache entry "
+                       << pending_entry_->string() << ": " << status;
+    }
+    pending_entry_->clear();
+  }
+
+  std::unique_ptr<llvm::MemoryBuffer> getObject(
+      const llvm::Module* module) override {
+    // Cache hits are handled in OrcJit::CompileModule before the module
+    // reaches the optimization layer.
+    return nullptr;
+  }
+
+ private:
+  std::filesystem::path* pending_entry_;
+};
+
 }  // namespace
 
 OrcJit::OrcJit(int64_t opt_level, bool emit_object_code)
@@ -209,7 +273,23 @@ absl::Status OrcJit::Init() {
             data_layout_.getGlobalPrefix())));
   });
 
-  auto compiler = std::make_unique<llvm::orc::SimpleCompiler>(*target_machine_);
+  // The object-code emission path duplicates compilation outside the compile
+  // layer, so the persistent cache is only used for regular JIT execution.
+  if (const char* cache_dir = std::getenv(kObjectCacheDirEnv);
+      !emit_object_code_ && cache_dir != nullptr && cache_dir[0] != '\0') {
+    object_cache_dir_ = cache_dir;
+    absl::Status created = RecursivelyCreateDir(object_cache_dir_);
+    if (created.ok()) {
+      cache_writer_ = std::make_unique<CacheWriter>(&pending_cache_entry_);
+    } else {
+      XLS_LOG(WARNING) << "Unable to create JIT object cache directory "
+                       << object_cache_dir_.string() << ": " << created;
+      object_cache_dir_.clear();
+    }
+  }
+
+  auto compiler = std::make_unique<llvm::orc::SimpleCompiler>(
+      *target_machine_, cache_writer_.get());
   compile_layer_ = std::make_unique<llvm::orc::IRCompileLayer>(
       execution_session_, object_layer_, std::move(compiler));
 
@@ -297,6 +377,25 @@ absl::Status VerifyModule(const llvm::Module& module) {
 
 absl::Status OrcJit::CompileModule(std::unique_ptr<llvm::Module>&& module) {
   XLS_RETURN_IF_ERROR(VerifyModule(*module));
+  if (!object_cache_dir_.empty()) {
+    std::filesystem::path entry =
+        object_cache_dir_ / CacheEntryFilename(*module, opt_level_);
+    absl::StatusOr<std::string> object = GetFileContents(entry);
+    if (object.ok()) {
+      // Cache hit: link the previously compiled object directly, skipping
+      // LLVM optimization and code generation entirely.
+      XLS_VLOG(2) << "JIT object cache hit: " << entry.string();
+      llvm::Error error = object_layer_.add(
+          dylib_, llvm::MemoryBuffer::getMemBufferCopy(*object));
+      if (error) {
+        return absl::UnknownError(
+            absl::StrFormat("Error loading cached object code: %s",
+                            llvm::toString(std::move(error))));
+      }
+      return absl::OkStatus();
+    }
+    pending_cache_entry_ = entry;
+  }
   llvm::Error error = transform_layer_->add(
       dylib_, llvm::orc::ThreadSafeModule(std::move(module), context_));
   if (error) {
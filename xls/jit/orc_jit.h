@@ -15,8 +15,11 @@
 #ifndef XLS_JIT_ORC_JIT_H_
 #define XLS_JIT_ORC_JIT_H_
 
+#include <filesystem>
+
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "llvm/include/llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/include/llvm/ExecutionEngine/Orc/Core.h"
 #include "llvm/include/llvm/ExecutionEngine/Orc/ExecutorProcessControl.h"
 #include "llvm/include/llvm/ExecutionEngine/Orc/IRCompileLayer.h"
@@ -92,6 +95,23 @@ class OrcJit {
   // When `CompileModule` is called and `emit_object_code` is true, this vector
   // will be allocated and filled with the object code of the compiled module.
   std::vector<char> object_code_;
+
+  // Directory of the persistent on-disk object cache, or empty if the cache is
+  // disabled. Entries are content-addressed by a hash of the unoptimized
+  // module IR and the optimization level, so identical modules compiled by
+  // other processes (e.g., earlier CI shards) are loaded instead of re-running
+  // LLVM optimization and code generation. Enabled by setting the
+  // XLS_JIT_OBJECT_CACHE_DIR environment variable.
+  std::filesystem::path object_cache_dir_;
+
+  // On a cache miss, the path the object produced by the in-flight
+  // `CompileModule` call should be written to. The lookup key is computed from
+  // the unoptimized IR, so it must be carried past the optimization layer.
+  std::filesystem::path pending_cache_entry_;
+
+  // Hooked into the compiler to write freshly compiled objects to
+  // `pending_cache_entry_`.
+  std::unique_ptr<llvm::ObjectCache> cache_writer_;
 };
 
 // Calls the dump method on the given LLVM object and returns the string.
@@ -0,0 +1,436 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "xls/jit/parallel_proc_runtime.h"
+
+#include <algorithm>
+#include <thread>  // NOLINT(build/c++11)
+
+#include "absl/status/status.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/node_util.h"
+#include "xls/ir/op.h"
+#include "xls/ir/proc.h"
+#include "xls/jit/jit_channel_queue.h"
+#include "xls/jit/proc_jit.h"
+
+namespace xls {
+
+void ParallelProcRuntime::AwaitState(
+    ThreadData* thread_data,
+    const absl::flat_hash_set<ThreadData::State>& states) {
+  struct AwaitData {
+    ThreadData* thread_data;
+    const absl::flat_hash_set<ThreadData::State>* states;
+  };
+  AwaitData await_data = {thread_data, &states};
+  thread_data->mutex.AssertHeld();
+  thread_data->mutex.Await(absl::Condition(
+      +[](AwaitData* await_data) {
+        await_data->thread_data->mutex.AssertReaderHeld();
+        return await_data->states->contains(
+            await_data->thread_data->thread_state);
+      },
+      &await_data));
+}
+
+void ParallelProcRuntime::WakeConsumerOf(int64_t channel_id) {
+  auto it = consumer_of_channel_.find(channel_id);
+  if (it != consumer_of_channel_.end()) {
+    // Locking and unlocking the consumer's mutex forces re-evaluation of the
+    // wait condition it is parked on.
+    absl::MutexLock lock(&it->second->mutex);
+  }
+  BumpEpoch();
+}
+
+void ParallelProcRuntime::BumpEpoch() {
+  epoch_.fetch_add(1);
+  // Lock and unlock the monitor so the ticking thread re-examines the
+  // counters.
+  absl::MutexLock lock(&monitor_mutex_);
+}
+
+void ParallelProcRuntime::ThreadFn(ThreadData* thread_data) {
+  absl::flat_hash_set<ThreadData::State> await_states(
+      {ThreadData::State::kRunning, ThreadData::State::kCancelled});
+  {
+    absl::MutexLock lock(&thread_data->mutex);
+    AwaitState(thread_data, await_states);
+    if (thread_data->thread_state == ThreadData::State::kCancelled) {
+      return;
+    }
+  }
+
+  while (true) {
+    absl::StatusOr<InterpreterResult<std::vector<Value>>> next_state_or =
+        thread_data->jit->Run(thread_data->proc_state, thread_data);
+    XLS_CHECK_OK(next_state_or.status());
+    thread_data->proc_state = next_state_or.value().value;
+
+    absl::MutexLock lock(&thread_data->mutex);
+    if (thread_data->thread_state == ThreadData::State::kCancelled) {
+      break;
+    }
+    thread_data->thread_state = ThreadData::State::kDone;
+    thread_data->runtime->num_done_.fetch_add(1);
+    thread_data->runtime->BumpEpoch();
+    AwaitState(thread_data, await_states);
+    if (thread_data->thread_state == ThreadData::State::kCancelled) {
+      break;
+    }
+  }
+}
+
+// To implement Proc blocking receive semantics, RecvFn parks the proc thread
+// on its mutex until the producer of the channel sends data (SendFn wakes the
+// consumer) or the thread is cancelled.
+bool ParallelProcRuntime::RecvFn(JitChannelQueue* queue, Receive* recv,
+                                 uint8_t* data, int64_t data_bytes,
+                                 void* user_data) {
+  if (!recv->is_blocking()) {
+    return queue->Recv(data, data_bytes);
+  }
+
+  ThreadData* thread_data = absl::bit_cast<ThreadData*>(user_data);
+  ParallelProcRuntime* runtime = thread_data->runtime;
+  struct RecvWait {
+    ThreadData* thread_data;
+    JitChannelQueue* queue;
+  };
+
+  absl::MutexLock lock(&thread_data->mutex);
+  while (queue->Empty()) {
+    if (thread_data->thread_state == ThreadData::State::kCancelled) {
+      return false;
+    }
+    // The blocked channel id must be published before the blocked count so
+    // the ticking thread never observes a blocked thread without a channel.
+    thread_data->blocked_channel_id.store(queue->channel_id());
+    runtime->num_blocked_.fetch_add(1);
+    runtime->BumpEpoch();
+    RecvWait wait = {thread_data, queue};
+    thread_data->mutex.Await(absl::Condition(
+        +[](RecvWait* wait) {
+          wait->thread_data->mutex.AssertReaderHeld();
+          return !wait->queue->Empty() ||
+                 wait->thread_data->thread_state ==
+                     ThreadData::State::kCancelled;
+        },
+        &wait));
+    thread_data->blocked_channel_id.store(-1);
+    runtime->num_blocked_.fetch_sub(1);
+    runtime->BumpEpoch();
+  }
+
+  return queue->Recv(data, data_bytes);
+}
+
+void ParallelProcRuntime::SendFn(JitChannelQueue* queue, Send* send,
+                                 uint8_t* data, int64_t data_bytes,
+                                 void* user_data) {
+  ThreadData* thread_data = absl::bit_cast<ThreadData*>(user_data);
+  queue->Send(data, data_bytes);
+  thread_data->runtime->WakeConsumerOf(queue->channel_id());
+}
+
+absl::StatusOr<std::unique_ptr<ParallelProcRuntime>>
+ParallelProcRuntime::Create(Package* package) {
+  auto runtime = absl::WrapUnique(new ParallelProcRuntime(package));
+  XLS_RETURN_IF_ERROR(runtime->Init());
+  return runtime;
+}
+
+ParallelProcRuntime::ParallelProcRuntime(Package* package)
+    : package_(package) {}
+
+ParallelProcRuntime::~ParallelProcRuntime() {
+  for (auto& thread_data : threads_) {
+    {
+      absl::MutexLock lock(&thread_data->mutex);
+      thread_data->thread_state = ThreadData::State::kCancelled;
+    }
+    thread_data->thread->Join();
+  }
+}
+
+absl::Status ParallelProcRuntime::Init() {
+  XLS_ASSIGN_OR_RETURN(
+      queue_mgr_,
+      JitChannelQueueManager::CreateSingleProducerSingleConsumer(package_));
+
+  threads_.reserve(package_->procs().size());
+  for (int i = 0; i < package_->procs().size(); i++) {
+    auto thread = std::make_unique<ThreadData>();
+    thread->proc = package_->procs()[i].get();
+    thread->runtime = this;
+
+    absl::MutexLock lock(&thread->mutex);
+    thread->thread_state = ThreadData::State::kPending;
+    threads_.push_back(std::move(thread));
+  }
+
+  // Each channel has a single receiving proc; record it so SendFn can wake
+  // exactly the thread waiting on the data.
+  for (auto& thread : threads_) {
+    for (Node* node : thread->proc->nodes()) {
+      if (node->op() == Op::kReceive) {
+        XLS_ASSIGN_OR_RETURN(Channel * channel, GetChannelUsedByNode(node));
+        consumer_of_channel_[channel->id()] = thread.get();
+      }
+    }
+  }
+
+  // Compile the procs up front, spreading the work over a pool of threads.
+  int64_t num_workers = std::min<int64_t>(
+      threads_.size(),
+      std::max<int64_t>(1, std::thread::hardware_concurrency()));
+  std::vector<absl::Status> worker_status(num_workers, absl::OkStatus());
+  std::atomic<int64_t> next_task(0);
+  std::vector<std::unique_ptr<Thread>> workers;
+  workers.reserve(num_workers);
+  for (int64_t w = 0; w < num_workers; ++w) {
+    workers.push_back(
+        std::make_unique<Thread>([this, w, &next_task, &worker_status]() {
+          while (true) {
+            int64_t task = next_task.fetch_add(1);
+            if (task >= static_cast<int64_t>(threads_.size())) {
+              return;
+            }
+            ThreadData* thread_data = threads_[task].get();
+            absl::StatusOr<std::unique_ptr<ProcJit>> jit = ProcJit::Create(
+                thread_data->proc, queue_mgr_.get(), &RecvFn, &SendFn);
+            if (!jit.ok()) {
+              worker_status[w] = jit.status();
+              return;
+            }
+            thread_data->jit = std::move(jit).value();
+          }
+        }));
+  }
+  for (auto& worker : workers) {
+    worker->Join();
+  }
+  for (const absl::Status& status : worker_status) {
+    XLS_RETURN_IF_ERROR(status);
+  }
+
+  for (auto& thread : threads_) {
+    // Start the thread - the first thing it does is wait until the state is
+    // either running or cancelled, so it'll be waiting for us when we actually
+    // call Tick().
+    auto thread_ptr = thread.get();
+    thread_ptr->thread =
+        std::make_unique<Thread>([thread_ptr]() { ThreadFn(thread_ptr); });
+  }
+
+  ResetState();
+
+  // Enqueue initial values into channels.
+  for (Channel* channel : package_->channels()) {
+    for (const Value& value : channel->initial_values()) {
+      XLS_RETURN_IF_ERROR(EnqueueValueToChannel(channel, value));
+    }
+  }
+
+  return absl::OkStatus();
+}
+
+absl::Status ParallelProcRuntime::Tick() {
+  num_done_.store(0);
+  for (auto& thread : threads_) {
+    absl::MutexLock lock(&thread->mutex);
+    thread->thread_state = ThreadData::State::kRunning;
+  }
+
+  struct EpochWait {
+    ParallelProcRuntime* runtime;
+    uint64_t seen;
+  };
+  {
+    // The proc threads lock the monitor inside their own mutexes (via
+    // BumpEpoch), so no thread mutex may be acquired below while the monitor
+    // is held.
+    absl::MutexLock lock(&monitor_mutex_);
+    while (true) {
+      uint64_t seen = epoch_.load();
+      int64_t done = num_done_.load();
+      int64_t blocked = num_blocked_.load();
+      if (done == static_cast<int64_t>(threads_.size())) {
+        break;
+      }
+      if (done + blocked == static_cast<int64_t>(threads_.size())) {
+        // Every remaining proc is parked on an empty queue. If no queue can
+        // still be filled - by a parked proc's pending data or from outside
+        // the network - the tick cannot complete.
+        bool progress_possible = false;
+        for (auto& thread : threads_) {
+          int64_t channel_id = thread->blocked_channel_id.load();
+          if (channel_id < 0) {
+            continue;
+          }
+          XLS_ASSIGN_OR_RETURN(JitChannelQueue * queue,
+                               queue_mgr_->GetQueueById(channel_id));
+          if (!queue->Empty()) {
+            progress_possible = true;
+            break;
+          }
+          XLS_ASSIGN_OR_RETURN(Channel * channel,
+                               package_->GetChannel(channel_id));
+          if (channel->supported_ops() == ChannelOps::kReceiveOnly) {
+            // Data may still arrive from outside the proc network; an
+            // external enqueue bumps the epoch.
+            progress_possible = true;
+            break;
+          }
+        }
+        if (!progress_possible) {
+          return absl::AbortedError(
+              "Deadlock detected; some procs were blocked with no data sent.");
+        }
+      }
+      EpochWait wait = {this, seen};
+      monitor_mutex_.Await(absl::Condition(
+          +[](EpochWait* wait) {
+            return wait->runtime->epoch_.load() != wait->seen;
+          },
+          &wait));
+    }
+  }
+
+  for (auto& thread : threads_) {
+    // Reset state for the next Tick().
+    absl::MutexLock lock(&thread->mutex);
+    thread->thread_state = ThreadData::State::kPending;
+  }
+
+  return absl::OkStatus();
+}
+
+absl::Status ParallelProcRuntime::EnqueueValueToChannel(Channel* channel,
+                                                        const Value& value) {
+  XLS_RET_CHECK_EQ(package_->GetTypeForValue(value), channel->type());
+  Type* type = package_->GetTypeForValue(value);
+
+  XLS_RET_CHECK(!threads_.empty());
+  ProcJit* jit = threads_.front()->jit.get();
+  int64_t size = jit->type_converter()->GetTypeByteSize(type);
+  auto buffer = std::make_unique<uint8_t[]>(size);
+  jit->runtime()->BlitValueToBuffer(value, type,
+                                    absl::MakeSpan(buffer.get(), size));
+
+  XLS_ASSIGN_OR_RETURN(JitChannelQueue * queue,
+                       queue_mgr()->GetQueueById(channel->id()));
+  queue->Send(buffer.get(), size);
+  WakeConsumerOf(channel->id());
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::vector<uint8_t>> ParallelProcRuntime::PackValuesForChannel(
+    Channel* channel, absl::Span<const Value> values) const {
+  XLS_RET_CHECK(!threads_.empty());
+  ProcJit* jit = threads_.front()->jit.get();
+  Type* type = channel->type();
+  int64_t size = jit->type_converter()->GetTypeByteSize(type);
+
+  std::vector<uint8_t> packed(size * values.size());
+  for (int64_t i = 0; i < static_cast<int64_t>(values.size()); ++i) {
+    XLS_RET_CHECK_EQ(package_->GetTypeForValue(values[i]), type);
+    jit->runtime()->BlitValueToBuffer(
+        values[i], type, absl::MakeSpan(packed.data() + i * size, size));
+  }
+  return packed;
+}
+
+absl::StatusOr<int64_t> ParallelProcRuntime::GetChannelElementSize(
+    Channel* channel) const {
+  XLS_RET_CHECK(!threads_.empty());
+  ProcJit* jit = threads_.front()->jit.get();
+  return jit->type_converter()->GetTypeByteSize(channel->type());
+}
+
+absl::StatusOr<int64_t> ParallelProcRuntime::EnqueuePackedToChannel(
+    Channel* channel, absl::Span<const uint8_t> packed,
+    std::atomic<bool>* cancel) {
+  // Sends from inside the proc network would race with ours; only channels fed
+  // from outside the network have the single producer the queue requires.
+  XLS_RET_CHECK_EQ(channel->supported_ops(), ChannelOps::kReceiveOnly);
+  XLS_ASSIGN_OR_RETURN(int64_t size, GetChannelElementSize(channel));
+  XLS_RET_CHECK_EQ(packed.size() % size, 0);
+
+  XLS_ASSIGN_OR_RETURN(JitChannelQueue * queue,
+                       queue_mgr()->GetQueueById(channel->id()));
+  int64_t enqueued = 0;
+  for (int64_t offset = 0; offset < static_cast<int64_t>(packed.size());
+       offset += size) {
+    // A full queue drains at the rate the consuming proc ticks; yield rather
+    // than spin hot so the proc threads get the cycles.
+    while (!queue->TrySend(const_cast<uint8_t*>(packed.data() + offset),
+                           size)) {
+      if (cancel != nullptr && cancel->load()) {
+        return enqueued;
+      }
+      std::this_thread::yield();
+    }
+    WakeConsumerOf(channel->id());
+    ++enqueued;
+  }
+  return enqueued;
+}
+
+absl::StatusOr<Value> ParallelProcRuntime::DequeueValueFromChannel(
+    Channel* channel) {
+  Type* type = channel->type();
+
+  XLS_RET_CHECK(!threads_.empty());
+  ProcJit* jit = threads_.front()->jit.get();
+  int64_t size = jit->type_converter()->GetTypeByteSize(type);
+  auto buffer = std::make_unique<uint8_t[]>(size);
+
+  XLS_ASSIGN_OR_RETURN(JitChannelQueue * queue,
+                       queue_mgr()->GetQueueById(channel->id()));
+  queue->Recv(buffer.get(), size);
+
+  return jit->runtime()->UnpackBuffer(buffer.get(), type);
+}
+
+int64_t ParallelProcRuntime::NumProcs() const { return threads_.size(); }
+
+absl::StatusOr<Proc*> ParallelProcRuntime::proc(int64_t index) const {
+  if (index > threads_.size()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Valid indices are 0 - ", threads_.size(), "."));
+  }
+  return threads_[index]->proc;
+}
+
+absl::StatusOr<std::vector<Value>> ParallelProcRuntime::ProcState(
+    int64_t index) const {
+  if (index > threads_.size()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Valid indices are 0 - ", threads_.size(), "."));
+  }
+
+  return threads_[index]->proc_state;
+}
+
+void ParallelProcRuntime::ResetState() {
+  for (int i = 0; i < package_->procs().size(); i++) {
+    Proc* proc = package_->procs()[i].get();
+    auto thread = threads_[i].get();
+    thread->proc_state = std::vector<Value>(proc->InitValues().begin(),
+                                            proc->InitValues().end());
+  }
+}
+
+}  // namespace xls
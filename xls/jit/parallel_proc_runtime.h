@@ -0,0 +1,177 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef XLS_JIT_PARALLEL_PROC_RUNTIME_H_
+#define XLS_JIT_PARALLEL_PROC_RUNTIME_H_
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/common/thread.h"
+#include "xls/ir/package.h"
+#include "xls/jit/jit_channel_queue.h"
+#include "xls/jit/proc_jit.h"
+
+namespace xls {
+
+// ParallelProcRuntime runs every proc of a package on its own thread and,
+// unlike SerialProcRuntime, lets all ready procs execute concurrently within a
+// Tick. Channels are backed by lock-free single-producer/single-consumer
+// queues (each XLS channel has exactly one sending and one receiving proc), so
+// procs connected by independent channels proceed without synchronizing with
+// each other at all. A blocking receive on an empty queue parks the proc
+// thread until the producer sends data or the tick is found to be deadlocked.
+//
+// Quiescence of a tick is detected with atomic counters rather than serialized
+// thread handoffs: threads count themselves done or blocked, and the ticking
+// thread waits until every proc is accounted for. If all remaining procs are
+// blocked on empty queues that no proc can fill, the tick aborts with an
+// error, mirroring SerialProcRuntime's deadlock detection.
+class ParallelProcRuntime {
+ public:
+  // Creates a runtime for the procs of `package`. The proc JITs are compiled
+  // concurrently.
+  static absl::StatusOr<std::unique_ptr<ParallelProcRuntime>> Create(
+      Package* package);
+  ~ParallelProcRuntime();
+
+  // Execute one cycle of every proc in the network. Procs run concurrently;
+  // each completes exactly one activation per tick.
+  absl::Status Tick();
+
+  Package* package() { return package_; }
+  JitChannelQueueManager* queue_mgr() { return queue_mgr_.get(); }
+
+  // Enqueues the given value into the given channel. Must not be called while
+  // a Tick is in flight unless the channel is receive-only.
+  absl::Status EnqueueValueToChannel(Channel* channel, const Value& value);
+
+  // Packs the given values into a contiguous buffer of the channel's
+  // fixed-size element representation, suitable for EnqueuePackedToChannel.
+  // Converting a long input stream once up front keeps Value marshaling off
+  // the ticking fast path.
+  absl::StatusOr<std::vector<uint8_t>> PackValuesForChannel(
+      Channel* channel, absl::Span<const Value> values) const;
+
+  // Returns the size in bytes of one packed element of the given channel.
+  absl::StatusOr<int64_t> GetChannelElementSize(Channel* channel) const;
+
+  // Enqueues pre-packed elements (as produced by PackValuesForChannel) into
+  // the given receive-only channel. The backing queue has a fixed capacity and
+  // this call blocks while it is full, so when enqueueing more elements than
+  // the capacity the caller must run concurrently with ticking. If `cancel`
+  // is non-null and becomes true, the call stops feeding and returns the
+  // number of elements enqueued so far. Each channel queue permits a single
+  // producer; feed any one channel from one thread only.
+  absl::StatusOr<int64_t> EnqueuePackedToChannel(
+      Channel* channel, absl::Span<const uint8_t> packed,
+      std::atomic<bool>* cancel = nullptr);
+
+  // Dequeues a value from the given channel.
+  absl::StatusOr<Value> DequeueValueFromChannel(Channel* channel);
+
+  // Returns the current number of procs in this runtime.
+  int64_t NumProcs() const;
+
+  // Returns the n'th Proc being executed.
+  absl::StatusOr<Proc*> proc(int64_t proc_index) const;
+
+  // Returns the current state values in the given proc.
+  absl::StatusOr<std::vector<Value>> ProcState(int64_t proc_index) const;
+
+  void ResetState();
+
+ private:
+  // Utility structure to hold state needed by each proc thread.
+  struct ThreadData {
+    enum class State {
+      kPending,
+      kRunning,
+      kDone,
+      kCancelled,
+    };
+    std::unique_ptr<Thread> thread;
+    std::unique_ptr<ProcJit> jit;
+
+    // The proc this thread executes and the runtime owning this thread.
+    Proc* proc;
+    ParallelProcRuntime* runtime;
+
+    // The Proc's carried state.
+    std::vector<Value> proc_state;
+
+    // Id of the channel this thread is blocked receiving on, or -1 if the
+    // thread is not blocked. Written by the proc thread and read by the
+    // ticking thread when checking for deadlock, hence atomic rather than
+    // mutex-guarded.
+    std::atomic<int64_t> blocked_channel_id{-1};
+
+    absl::Mutex mutex;
+    State thread_state ABSL_GUARDED_BY(mutex);
+  };
+
+  explicit ParallelProcRuntime(Package* package);
+  absl::Status Init();
+  static void ThreadFn(ThreadData* thread_data);
+
+  // Proc Receive handler function. Blocks until data is available or the
+  // thread is cancelled.
+  static bool RecvFn(JitChannelQueue* queue, Receive* recv, uint8_t* data,
+                     int64_t data_bytes, void* user_data);
+
+  // Proc Send handler function. Wakes the consumer of the channel, if any.
+  static void SendFn(JitChannelQueue* queue, Send* send, uint8_t* data,
+                     int64_t data_bytes, void* user_data);
+
+  // Blocks the running thread until the given ThreadData is in one of the
+  // states specified by "states".
+  static void AwaitState(ThreadData* thread_data,
+                         const absl::flat_hash_set<ThreadData::State>& states);
+
+  // Notifies the thread (if any) blocked receiving on the given channel that
+  // the queue contents may have changed.
+  void WakeConsumerOf(int64_t channel_id);
+
+  // Advances the progress epoch and wakes the ticking thread so it
+  // re-examines the counters. Called on every done/blocked/unblocked
+  // transition and on every send.
+  void BumpEpoch();
+
+  Package* package_;
+  std::vector<std::unique_ptr<ThreadData>> threads_;
+  std::unique_ptr<JitChannelQueueManager> queue_mgr_;
+
+  // Maps a channel id to the thread of the unique proc receiving on it.
+  absl::flat_hash_map<int64_t, ThreadData*> consumer_of_channel_;
+
+  // Number of threads which have finished their activation for the current
+  // tick, and number of threads parked on an empty receive queue.
+  std::atomic<int64_t> num_done_{0};
+  std::atomic<int64_t> num_blocked_{0};
+
+  // Incremented on every thread progress transition. The ticking thread waits
+  // for the epoch to move instead of polling the counters.
+  std::atomic<uint64_t> epoch_{0};
+
+  // Mutex the ticking thread waits on; proc threads lock and unlock it (via
+  // BumpEpoch) to force re-evaluation of the ticking thread's wait condition.
+  absl::Mutex monitor_mutex_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_JIT_PARALLEL_PROC_RUNTIME_H_
@@ -0,0 +1,178 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "xls/jit/parallel_proc_runtime.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "xls/common/status/matchers.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/package.h"
+#include "xls/jit/jit_channel_queue.h"
+
+namespace xls {
+namespace {
+
+template <typename T>
+void EnqueueData(JitChannelQueue* queue, T data) {
+  queue->Send(absl::bit_cast<uint8_t*>(&data), sizeof(T));
+}
+
+template <typename T>
+T DequeueData(JitChannelQueue* queue) {
+  T data;
+  queue->Recv(absl::bit_cast<uint8_t*>(&data), sizeof(T));
+  return data;
+}
+
+// Same X -> A -> B -> Y network as the SerialProcRuntime test: a pipeline of
+// two procs where B blocks on data produced by A within the same tick.
+TEST(ParallelProcRuntimeTest, SimpleNetwork) {
+  constexpr int kNumCycles = 4;
+  const std::string kIrText = R"(
+package p
+
+chan a_in(bits[32], id=0, kind=streaming, ops=receive_only, flow_control=none, metadata="")
+chan a_to_b(bits[32], id=1, kind=streaming, ops=send_receive, flow_control=none, metadata="")
+chan b_out(bits[32], id=2, kind=streaming, ops=send_only, flow_control=none, metadata="")
+
+proc a(my_token: token, state: (), init={()}) {
+  literal.1: bits[32] = literal(value=2)
+  receive.2: (token, bits[32]) = receive(my_token, channel_id=0)
+  tuple_index.3: token = tuple_index(receive.2, index=0)
+  tuple_index.4: bits[32] = tuple_index(receive.2, index=1)
+  umul.5: bits[32] = umul(literal.1, tuple_index.4)
+  send.6: token = send(tuple_index.3, umul.5, channel_id=1)
+  next (send.6, state)
+}
+
+proc b(my_token: token, state: (), init={()}) {
+  literal.100: bits[32] = literal(value=3)
+  receive.200: (token, bits[32]) = receive(my_token, channel_id=1)
+  tuple_index.300: token = tuple_index(receive.200, index=0)
+  tuple_index.400: bits[32] = tuple_index(receive.200, index=1)
+  umul.500: bits[32] = umul(literal.100, tuple_index.400)
+  send.600: token = send(tuple_index.300, umul.500, channel_id=2)
+  next (send.600, state)
+}
+)";
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, Parser::ParsePackage(kIrText));
+  XLS_ASSERT_OK_AND_ASSIGN(auto runtime, ParallelProcRuntime::Create(p.get()));
+  auto queue_mgr = runtime->queue_mgr();
+  XLS_ASSERT_OK_AND_ASSIGN(auto input_queue, queue_mgr->GetQueueById(0));
+  XLS_ASSERT_OK_AND_ASSIGN(auto output_queue, queue_mgr->GetQueueById(2));
+
+  for (int i = 0; i < kNumCycles; i++) {
+    EnqueueData(input_queue, i);
+  }
+
+  for (int i = 0; i < kNumCycles; i++) {
+    XLS_ASSERT_OK(runtime->Tick());
+  }
+
+  // Unlike the serial runtime, proc b blocks until a's data arrives, so every
+  // tick produces an output and no priming value is needed.
+  for (int i = 0; i < kNumCycles; i++) {
+    int result = DequeueData<int>(output_queue);
+    EXPECT_EQ(result, i * 6);
+  }
+}
+
+// A wide network of independent single-proc pipelines; all procs within a
+// tick can run fully concurrently since their channels are disjoint.
+TEST(ParallelProcRuntimeTest, WideIndependentNetwork) {
+  constexpr int kNumProcs = 16;
+  constexpr int kNumCycles = 8;
+  std::vector<std::string> decls;
+  std::vector<std::string> procs;
+  for (int i = 0; i < kNumProcs; i++) {
+    decls.push_back(absl::StrFormat(
+        R"(chan in_%d(bits[32], id=%d, kind=streaming, ops=receive_only, flow_control=none, metadata=""))",
+        i, 2 * i));
+    decls.push_back(absl::StrFormat(
+        R"(chan out_%d(bits[32], id=%d, kind=streaming, ops=send_only, flow_control=none, metadata=""))",
+        i, 2 * i + 1));
+    procs.push_back(absl::StrFormat(
+        R"(proc p_%d(my_token: token, state: (), init={()}) {
+  literal.%d: bits[32] = literal(value=%d)
+  receive.%d: (token, bits[32]) = receive(my_token, channel_id=%d)
+  tuple_index.%d: token = tuple_index(receive.%d, index=0)
+  tuple_index.%d: bits[32] = tuple_index(receive.%d, index=1)
+  add.%d: bits[32] = add(literal.%d, tuple_index.%d)
+  send.%d: token = send(tuple_index.%d, add.%d, channel_id=%d)
+  next (send.%d, state)
+})",
+        i, 100 * i + 1, i + 1, 100 * i + 2, 2 * i, 100 * i + 3, 100 * i + 2,
+        100 * i + 4, 100 * i + 2, 100 * i + 5, 100 * i + 1, 100 * i + 4,
+        100 * i + 6, 100 * i + 3, 100 * i + 5, 2 * i + 1, 100 * i + 6));
+  }
+  std::string ir_text = absl::StrFormat("package p\n\n%s\n\n%s\n",
+                                        absl::StrJoin(decls, "\n"),
+                                        absl::StrJoin(procs, "\n\n"));
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, Parser::ParsePackage(ir_text));
+  XLS_ASSERT_OK_AND_ASSIGN(auto runtime, ParallelProcRuntime::Create(p.get()));
+  EXPECT_EQ(runtime->NumProcs(), kNumProcs);
+
+  for (int i = 0; i < kNumProcs; i++) {
+    XLS_ASSERT_OK_AND_ASSIGN(auto input_queue,
+                             runtime->queue_mgr()->GetQueueById(2 * i));
+    for (int cycle = 0; cycle < kNumCycles; cycle++) {
+      EnqueueData(input_queue, cycle);
+    }
+  }
+
+  for (int cycle = 0; cycle < kNumCycles; cycle++) {
+    XLS_ASSERT_OK(runtime->Tick());
+  }
+
+  for (int i = 0; i < kNumProcs; i++) {
+    XLS_ASSERT_OK_AND_ASSIGN(auto output_queue,
+                             runtime->queue_mgr()->GetQueueById(2 * i + 1));
+    for (int cycle = 0; cycle < kNumCycles; cycle++) {
+      EXPECT_EQ(DequeueData<int>(output_queue), cycle + i + 1);
+    }
+  }
+}
+
+// A tick where a proc blocks on a channel no other proc can fill must abort
+// rather than hang.
+TEST(ParallelProcRuntimeTest, DeadlockDetection) {
+  const std::string kIrText = R"(
+package p
+
+chan a_to_b(bits[32], id=0, kind=streaming, ops=send_receive, flow_control=none, metadata="")
+chan b_out(bits[32], id=1, kind=streaming, ops=send_only, flow_control=none, metadata="")
+
+proc b(my_token: token, state: (), init={()}) {
+  receive.200: (token, bits[32]) = receive(my_token, channel_id=0)
+  tuple_index.300: token = tuple_index(receive.200, index=0)
+  tuple_index.400: bits[32] = tuple_index(receive.200, index=1)
+  send.600: token = send(tuple_index.300, tuple_index.400, channel_id=1)
+  next (send.600, state)
+}
+)";
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, Parser::ParsePackage(kIrText));
+  XLS_ASSERT_OK_AND_ASSIGN(auto runtime, ParallelProcRuntime::Create(p.get()));
+  EXPECT_THAT(runtime->Tick(),
+              status_testing::StatusIs(absl::StatusCode::kAborted));
+}
+
+}  // namespace
+}  // namespace xls
@@ -0,0 +1,157 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/proc_continuation.h"
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+
+namespace xls {
+
+/* static */ absl::StatusOr<std::unique_ptr<ProcContinuation>>
+ProcContinuation::Create(Proc* proc, JitChannelQueueManager* queue_mgr) {
+  auto continuation =
+      absl::WrapUnique(new ProcContinuation(proc, queue_mgr));
+  XLS_ASSIGN_OR_RETURN(continuation->jit_,
+                       ProcJit::Create(proc, queue_mgr, &RecvFn, &SendFn));
+  {
+    absl::MutexLock lock(&continuation->mutex_);
+    continuation->proc_state_ = std::vector<Value>(proc->InitValues().begin(),
+                                                   proc->InitValues().end());
+  }
+  ProcContinuation* continuation_ptr = continuation.get();
+  continuation->thread_ = std::make_unique<Thread>(
+      [continuation_ptr]() { continuation_ptr->ThreadFn(); });
+  return continuation;
+}
+
+ProcContinuation::ProcContinuation(Proc* proc,
+                                   JitChannelQueueManager* queue_mgr)
+    : proc_(proc), queue_mgr_(queue_mgr) {}
+
+ProcContinuation::~ProcContinuation() {
+  if (thread_ != nullptr) {
+    {
+      absl::MutexLock lock(&mutex_);
+      thread_state_ = State::kCancelled;
+    }
+    thread_->Join();
+  }
+}
+
+void ProcContinuation::ThreadFn() {
+  while (true) {
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(absl::Condition(
+          +[](ProcContinuation* self) {
+            self->mutex_.AssertReaderHeld();
+            return self->thread_state_ == State::kRunning ||
+                   self->thread_state_ == State::kCancelled;
+          },
+          this));
+      if (thread_state_ == State::kCancelled) {
+        return;
+      }
+    }
+
+    // A blocking receive on an empty channel parks inside RecvFn; when Tick()
+    // marks the state running again, execution resumes right there with no
+    // re-execution of the preceding tick body.
+    std::vector<Value> state = GetState();
+    absl::StatusOr<InterpreterResult<std::vector<Value>>> next_state_or =
+        jit_->Run(state, this);
+    XLS_CHECK_OK(next_state_or.status());
+
+    absl::MutexLock lock(&mutex_);
+    if (thread_state_ == State::kCancelled) {
+      return;
+    }
+    proc_state_ = std::move(next_state_or.value().value);
+    thread_state_ = State::kDone;
+  }
+}
+
+/* static */ bool ProcContinuation::RecvFn(JitChannelQueue* queue,
+                                           Receive* recv, uint8_t* data,
+                                           int64_t data_bytes,
+                                           void* user_data) {
+  if (!recv->is_blocking()) {
+    return queue->Recv(data, data_bytes);
+  }
+
+  ProcContinuation* self = absl::bit_cast<ProcContinuation*>(user_data);
+  absl::MutexLock lock(&self->mutex_);
+  while (queue->Empty()) {
+    if (self->thread_state_ == State::kCancelled) {
+      return false;
+    }
+    self->thread_state_ = State::kBlocked;
+    self->blocked_channel_id_ = queue->channel_id();
+    self->mutex_.Await(absl::Condition(
+        +[](ProcContinuation* self) {
+          self->mutex_.AssertReaderHeld();
+          return self->thread_state_ == State::kRunning ||
+                 self->thread_state_ == State::kCancelled;
+        },
+        self));
+  }
+  self->blocked_channel_id_ = -1;
+  return queue->Recv(data, data_bytes);
+}
+
+/* static */ void ProcContinuation::SendFn(JitChannelQueue* queue, Send* send,
+                                           uint8_t* data, int64_t data_bytes,
+                                           void* user_data) {
+  queue->Send(data, data_bytes);
+}
+
+absl::StatusOr<ProcContinuation::TickResult> ProcContinuation::Tick() {
+  absl::MutexLock lock(&mutex_);
+  XLS_RET_CHECK(thread_state_ == State::kPending ||
+                thread_state_ == State::kBlocked)
+      << "Tick() called on a cancelled or mid-tick continuation.";
+  thread_state_ = State::kRunning;
+  mutex_.Await(absl::Condition(
+      +[](ProcContinuation* self) {
+        self->mutex_.AssertReaderHeld();
+        return self->thread_state_ == State::kBlocked ||
+               self->thread_state_ == State::kDone;
+      },
+      this));
+  if (thread_state_ == State::kBlocked) {
+    return TickResult{TickState::kBlocked, blocked_channel_id_};
+  }
+  thread_state_ = State::kPending;
+  return TickResult{TickState::kCompleted, std::nullopt};
+}
+
+std::vector<Value> ProcContinuation::GetState() {
+  absl::MutexLock lock(&mutex_);
+  return proc_state_;
+}
+
+absl::Status ProcContinuation::SetState(std::vector<Value> state) {
+  absl::MutexLock lock(&mutex_);
+  XLS_RET_CHECK(thread_state_ == State::kPending)
+      << "SetState() may only be called between completed ticks.";
+  XLS_RET_CHECK_EQ(state.size(), proc_->StateParams().size());
+  proc_state_ = std::move(state);
+  return absl::OkStatus();
+}
+
+}  // namespace xls
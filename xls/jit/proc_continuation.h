@@ -0,0 +1,120 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_JIT_PROC_CONTINUATION_H_
+#define XLS_JIT_PROC_CONTINUATION_H_
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xls/common/thread.h"
+#include "xls/ir/proc.h"
+#include "xls/ir/value.h"
+#include "xls/jit/jit_channel_queue.h"
+#include "xls/jit/proc_jit.h"
+
+namespace xls {
+
+// A resumable tick execution of a single JIT-compiled proc. When a blocking
+// receive finds its channel empty, Tick() returns kBlocked instead of
+// re-executing the tick later from the top: the execution is parked at the
+// receive point (on a dedicated thread, following the SerialProcRuntime
+// mechanism) and the next Tick() call resumes exactly there once data is
+// available. This avoids redoing the computation preceding the receive - in
+// particular, sends performed earlier in the tick are not repeated - which
+// matters in heavily backpressured networks where ticks block routinely.
+class ProcContinuation {
+ public:
+  enum class TickState : uint8_t {
+    // The tick ran to completion and the proc state was advanced.
+    kCompleted,
+    // The tick is parked at a blocking receive on an empty channel. Calling
+    // Tick() again resumes at the receive point.
+    kBlocked,
+  };
+
+  struct TickResult {
+    TickState state;
+    // The id of the channel the proc is blocked on, if blocked.
+    std::optional<int64_t> blocked_channel_id;
+  };
+
+  // Creates a continuation for the given proc, compiling it with a ProcJit.
+  // The proc state is initialized to the proc's initial values. The queue
+  // manager must outlive the continuation.
+  static absl::StatusOr<std::unique_ptr<ProcContinuation>> Create(
+      Proc* proc, JitChannelQueueManager* queue_mgr);
+
+  // Cancels any parked execution and joins the worker thread. A cancelled
+  // mid-tick execution does not advance the proc state.
+  ~ProcContinuation();
+
+  // Runs the proc until its tick completes or it blocks on an empty channel.
+  // If the previous call returned kBlocked, execution resumes at the blocking
+  // receive; computation before the receive point is not re-executed.
+  absl::StatusOr<TickResult> Tick();
+
+  // Returns the current proc state. Only meaningful between ticks; values
+  // observed while a tick is parked at a receive are those from before the
+  // tick began.
+  std::vector<Value> GetState();
+
+  // Overwrites the proc state. May only be called between completed ticks
+  // (returns an error if execution is parked mid-tick).
+  absl::Status SetState(std::vector<Value> state);
+
+  Proc* proc() { return proc_; }
+
+ private:
+  enum class State : uint8_t {
+    kPending,
+    kRunning,
+    kBlocked,
+    kDone,
+    kCancelled,
+  };
+
+  ProcContinuation(Proc* proc, JitChannelQueueManager* queue_mgr);
+
+  // The body of the worker thread hosting the proc execution. The thread
+  // spends its idle time parked either here (between ticks) or inside RecvFn
+  // (mid-tick, at a blocking receive).
+  void ThreadFn();
+
+  // Callbacks invoked by the JIT-compiled proc for receive and send
+  // operations; user_data is the owning ProcContinuation. RecvFn parks the
+  // calling thread while its channel is empty.
+  static bool RecvFn(JitChannelQueue* queue, Receive* recv, uint8_t* data,
+                     int64_t data_bytes, void* user_data);
+  static void SendFn(JitChannelQueue* queue, Send* send, uint8_t* data,
+                     int64_t data_bytes, void* user_data);
+
+  Proc* proc_;
+  JitChannelQueueManager* queue_mgr_;
+  std::unique_ptr<ProcJit> jit_;
+
+  absl::Mutex mutex_;
+  State thread_state_ ABSL_GUARDED_BY(mutex_) = State::kPending;
+  int64_t blocked_channel_id_ ABSL_GUARDED_BY(mutex_) = -1;
+  std::vector<Value> proc_state_ ABSL_GUARDED_BY(mutex_);
+
+  std::unique_ptr<Thread> thread_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_JIT_PROC_CONTINUATION_H_
@@ -0,0 +1,161 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "xls/jit/proc_continuation.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value.h"
+#include "xls/jit/jit_channel_queue.h"
+
+namespace xls {
+namespace {
+
+template <typename T>
+void EnqueueData(JitChannelQueue* queue, T data) {
+  queue->Send(absl::bit_cast<uint8_t*>(&data), sizeof(T));
+}
+
+template <typename T>
+T DequeueData(JitChannelQueue* queue) {
+  T data;
+  queue->Recv(absl::bit_cast<uint8_t*>(&data), sizeof(T));
+  return data;
+}
+
+// A proc which sends an intermediate result before its second receive. If a
+// blocked tick were re-executed from the top instead of resumed, the first
+// send would be repeated.
+constexpr const char kTwoReceiveProcIr[] = R"(
+package p
+
+chan in(bits[32], id=0, kind=streaming, ops=receive_only, flow_control=none, metadata="")
+chan mid(bits[32], id=1, kind=streaming, ops=send_only, flow_control=none, metadata="")
+chan in2(bits[32], id=2, kind=streaming, ops=receive_only, flow_control=none, metadata="")
+chan out(bits[32], id=3, kind=streaming, ops=send_only, flow_control=none, metadata="")
+
+proc p(my_token: token, state: (), init={()}) {
+  receive.2: (token, bits[32]) = receive(my_token, channel_id=0)
+  tuple_index.3: token = tuple_index(receive.2, index=0)
+  tuple_index.4: bits[32] = tuple_index(receive.2, index=1)
+  literal.5: bits[32] = literal(value=2)
+  umul.6: bits[32] = umul(tuple_index.4, literal.5)
+  send.7: token = send(tuple_index.3, umul.6, channel_id=1)
+  receive.8: (token, bits[32]) = receive(send.7, channel_id=2)
+  tuple_index.9: token = tuple_index(receive.8, index=0)
+  tuple_index.10: bits[32] = tuple_index(receive.8, index=1)
+  add.11: bits[32] = add(tuple_index.4, tuple_index.10)
+  send.12: token = send(tuple_index.9, add.11, channel_id=3)
+  next (send.12, state)
+}
+)";
+
+TEST(ProcContinuationTest, ResumesAtBlockingReceive) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, Parser::ParsePackage(kTwoReceiveProcIr));
+  XLS_ASSERT_OK_AND_ASSIGN(auto queue_mgr,
+                           JitChannelQueueManager::Create(p.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * proc, p->GetProc("p"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto continuation, ProcContinuation::Create(proc, queue_mgr.get()));
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto in_queue, queue_mgr->GetQueueById(0));
+  XLS_ASSERT_OK_AND_ASSIGN(auto mid_queue, queue_mgr->GetQueueById(1));
+  XLS_ASSERT_OK_AND_ASSIGN(auto in2_queue, queue_mgr->GetQueueById(2));
+  XLS_ASSERT_OK_AND_ASSIGN(auto out_queue, queue_mgr->GetQueueById(3));
+
+  EnqueueData(in_queue, 7);
+  XLS_ASSERT_OK_AND_ASSIGN(ProcContinuation::TickResult result,
+                           continuation->Tick());
+  EXPECT_EQ(result.state, ProcContinuation::TickState::kBlocked);
+  EXPECT_EQ(result.blocked_channel_id, 2);
+
+  // The send preceding the blocking receive already executed exactly once.
+  EXPECT_EQ(DequeueData<int32_t>(mid_queue), 14);
+  EXPECT_TRUE(mid_queue->Empty());
+
+  // Unblock the parked receive; the resumed tick must not repeat the first
+  // send.
+  EnqueueData(in2_queue, 5);
+  XLS_ASSERT_OK_AND_ASSIGN(result, continuation->Tick());
+  EXPECT_EQ(result.state, ProcContinuation::TickState::kCompleted);
+  EXPECT_TRUE(mid_queue->Empty());
+  EXPECT_EQ(DequeueData<int32_t>(out_queue), 12);
+}
+
+TEST(ProcContinuationTest, StateAdvancesAcrossTicks) {
+  constexpr const char kIrText[] = R"(
+package p
+
+chan in(bits[32], id=0, kind=streaming, ops=receive_only, flow_control=none, metadata="")
+chan out(bits[32], id=1, kind=streaming, ops=send_only, flow_control=none, metadata="")
+
+proc accum(my_token: token, acc: bits[32], init={0}) {
+  receive.2: (token, bits[32]) = receive(my_token, channel_id=0)
+  tuple_index.3: token = tuple_index(receive.2, index=0)
+  tuple_index.4: bits[32] = tuple_index(receive.2, index=1)
+  add.5: bits[32] = add(acc, tuple_index.4)
+  send.6: token = send(tuple_index.3, add.5, channel_id=1)
+  next (send.6, add.5)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, Parser::ParsePackage(kIrText));
+  XLS_ASSERT_OK_AND_ASSIGN(auto queue_mgr,
+                           JitChannelQueueManager::Create(p.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * proc, p->GetProc("accum"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto continuation, ProcContinuation::Create(proc, queue_mgr.get()));
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto in_queue, queue_mgr->GetQueueById(0));
+  XLS_ASSERT_OK_AND_ASSIGN(auto out_queue, queue_mgr->GetQueueById(1));
+
+  for (int32_t i = 1; i <= 3; ++i) {
+    EnqueueData(in_queue, i);
+    XLS_ASSERT_OK_AND_ASSIGN(ProcContinuation::TickResult result,
+                             continuation->Tick());
+    EXPECT_EQ(result.state, ProcContinuation::TickState::kCompleted);
+  }
+  EXPECT_EQ(DequeueData<int32_t>(out_queue), 1);
+  EXPECT_EQ(DequeueData<int32_t>(out_queue), 3);
+  EXPECT_EQ(DequeueData<int32_t>(out_queue), 6);
+  EXPECT_EQ(continuation->GetState(),
+            std::vector<Value>({Value(UBits(6, 32))}));
+
+  XLS_ASSERT_OK(continuation->SetState({Value(UBits(100, 32))}));
+  EnqueueData(in_queue, 1);
+  XLS_ASSERT_OK(continuation->Tick().status());
+  EXPECT_EQ(DequeueData<int32_t>(out_queue), 101);
+}
+
+TEST(ProcContinuationTest, DestructionWhileBlocked) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, Parser::ParsePackage(kTwoReceiveProcIr));
+  XLS_ASSERT_OK_AND_ASSIGN(auto queue_mgr,
+                           JitChannelQueueManager::Create(p.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * proc, p->GetProc("p"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto continuation, ProcContinuation::Create(proc, queue_mgr.get()));
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto in_queue, queue_mgr->GetQueueById(0));
+  EnqueueData(in_queue, 1);
+  XLS_ASSERT_OK_AND_ASSIGN(ProcContinuation::TickResult result,
+                           continuation->Tick());
+  EXPECT_EQ(result.state, ProcContinuation::TickState::kBlocked);
+  // Destroying the continuation mid-tick cancels the parked execution
+  // without hanging.
+}
+
+}  // namespace
+}  // namespace xls
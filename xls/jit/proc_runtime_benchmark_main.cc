@@ -0,0 +1,450 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmark comparing Tick throughput of the JIT-backed SerialProcRuntime
+// against the ProcNetworkInterpreter on synthetic proc networks: linear
+// pipelines, fan-out/fan-in trees and rings of circulating tokens, swept
+// across proc count, payload width and the number of in-flight values.
+// Reports ticks/sec and per-tick latency percentiles for each combination:
+//
+//   bazel run -c opt //xls/jit:proc_runtime_benchmark_main
+//
+// Results can be recorded into and checked against the same textproto
+// baseline format as //xls/tools:benchmark_suite_main:
+//
+//   proc_runtime_benchmark_main --update_baseline --baseline_path=b.textproto
+//   proc_runtime_benchmark_main --baseline_path=b.textproto   # exits nonzero
+//                                                             # on regression
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/flags/flag.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/init_xls.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/interpreter/channel_queue.h"
+#include "xls/interpreter/proc_network_interpreter.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/channel.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value.h"
+#include "xls/jit/serial_proc_runtime.h"
+#include "xls/tools/benchmark_suite.pb.h"
+
+ABSL_FLAG(int64_t, ticks, 1000, "Number of timed ticks per configuration.");
+ABSL_FLAG(int64_t, warmup_ticks, 100,
+          "Number of untimed ticks run before measurement begins.");
+ABSL_FLAG(std::string, baseline_path, "",
+          "Path of the baseline BenchmarkSuiteProto textproto to compare "
+          "against; each network is a sample with one phase per runtime.");
+ABSL_FLAG(bool, update_baseline, false,
+          "Write the measurements of this run to --baseline_path instead of "
+          "comparing against it.");
+ABSL_FLAG(double, regression_factor, 1.5,
+          "Flag a regression when the measured tick time exceeds the baseline "
+          "tick time by more than this factor.");
+ABSL_FLAG(int64_t, min_duration_us, 50000,
+          "Runs where both the measured and the baseline duration are below "
+          "this threshold are too noisy to compare and are skipped.");
+
+namespace xls {
+namespace {
+
+// A synthetic proc network together with the channels the benchmark driver
+// needs to keep it fed.
+struct ProcNetwork {
+  std::string name;
+  std::unique_ptr<Package> package;
+  // External input channel fed one value per tick, or nullptr for closed
+  // networks (rings).
+  Channel* input = nullptr;
+  // Channels seeded with `depth` values before the first tick to put that
+  // many values in flight.
+  std::vector<Channel*> seed_channels;
+  int64_t payload_bits = 0;
+  int64_t depth = 1;
+};
+
+// Builds a proc which receives on `in`, adds `addend` and sends the result on
+// `out`.
+absl::Status BuildAdderProc(absl::string_view name, Channel* in, Channel* out,
+                            int64_t payload_bits, int64_t addend,
+                            Package* package) {
+  ProcBuilder pb(name, "tok", package);
+  BValue rcv = pb.Receive(in, pb.GetTokenParam());
+  BValue data = pb.TupleIndex(rcv, 1);
+  BValue sum = pb.Add(data, pb.Literal(UBits(addend, payload_bits)));
+  BValue send = pb.Send(out, pb.TupleIndex(rcv, 0), sum);
+  return pb.Build(send, {}).status();
+}
+
+// A linear pipeline of `proc_count` adder procs. Each internal channel is
+// seeded so the stages run decoupled rather than in lockstep.
+absl::StatusOr<ProcNetwork> MakePipeline(int64_t proc_count,
+                                         int64_t payload_bits, int64_t depth) {
+  ProcNetwork network;
+  network.name = absl::StrFormat("pipeline/procs=%d/bits=%d/depth=%d",
+                                 proc_count, payload_bits, depth);
+  network.payload_bits = payload_bits;
+  network.depth = depth;
+  network.package = std::make_unique<Package>("pipeline_benchmark");
+  Package* p = network.package.get();
+  Type* payload_type = p->GetBitsType(payload_bits);
+
+  std::vector<Channel*> channels;
+  XLS_ASSIGN_OR_RETURN(
+      Channel * input,
+      p->CreateStreamingChannel("in", ChannelOps::kReceiveOnly, payload_type));
+  channels.push_back(input);
+  network.input = input;
+  for (int64_t i = 1; i < proc_count; ++i) {
+    XLS_ASSIGN_OR_RETURN(Channel * internal,
+                         p->CreateStreamingChannel(
+                             absl::StrFormat("stage_%d", i),
+                             ChannelOps::kSendReceive, payload_type));
+    channels.push_back(internal);
+    network.seed_channels.push_back(internal);
+  }
+  XLS_ASSIGN_OR_RETURN(
+      Channel * output,
+      p->CreateStreamingChannel("out", ChannelOps::kSendOnly, payload_type));
+  channels.push_back(output);
+
+  for (int64_t i = 0; i < proc_count; ++i) {
+    XLS_RETURN_IF_ERROR(BuildAdderProc(absl::StrFormat("stage_proc_%d", i),
+                                       channels[i], channels[i + 1],
+                                       payload_bits, /*addend=*/1, p));
+  }
+  return network;
+}
+
+// One scatter proc feeding `fanout` adder workers whose results are summed by
+// a gather proc.
+absl::StatusOr<ProcNetwork> MakeFanOutFanIn(int64_t fanout,
+                                            int64_t payload_bits) {
+  ProcNetwork network;
+  network.name =
+      absl::StrFormat("tree/fanout=%d/bits=%d", fanout, payload_bits);
+  network.payload_bits = payload_bits;
+  network.package = std::make_unique<Package>("tree_benchmark");
+  Package* p = network.package.get();
+  Type* payload_type = p->GetBitsType(payload_bits);
+
+  XLS_ASSIGN_OR_RETURN(
+      Channel * input,
+      p->CreateStreamingChannel("in", ChannelOps::kReceiveOnly, payload_type));
+  network.input = input;
+  XLS_ASSIGN_OR_RETURN(
+      Channel * output,
+      p->CreateStreamingChannel("out", ChannelOps::kSendOnly, payload_type));
+
+  std::vector<Channel*> to_workers;
+  std::vector<Channel*> from_workers;
+  for (int64_t i = 0; i < fanout; ++i) {
+    XLS_ASSIGN_OR_RETURN(Channel * to_worker,
+                         p->CreateStreamingChannel(
+                             absl::StrFormat("to_worker_%d", i),
+                             ChannelOps::kSendReceive, payload_type));
+    to_workers.push_back(to_worker);
+    XLS_ASSIGN_OR_RETURN(Channel * from_worker,
+                         p->CreateStreamingChannel(
+                             absl::StrFormat("from_worker_%d", i),
+                             ChannelOps::kSendReceive, payload_type));
+    from_workers.push_back(from_worker);
+    XLS_RETURN_IF_ERROR(BuildAdderProc(absl::StrFormat("worker_%d", i),
+                                       to_worker, from_worker, payload_bits,
+                                       /*addend=*/i + 1, p));
+  }
+
+  {
+    ProcBuilder pb("scatter", "tok", p);
+    BValue rcv = pb.Receive(input, pb.GetTokenParam());
+    BValue tok = pb.TupleIndex(rcv, 0);
+    BValue data = pb.TupleIndex(rcv, 1);
+    for (Channel* to_worker : to_workers) {
+      tok = pb.Send(to_worker, tok, data);
+    }
+    XLS_RETURN_IF_ERROR(pb.Build(tok, {}).status());
+  }
+  {
+    ProcBuilder pb("gather", "tok", p);
+    BValue tok = pb.GetTokenParam();
+    BValue sum = pb.Literal(UBits(0, payload_bits));
+    for (Channel* from_worker : from_workers) {
+      BValue rcv = pb.Receive(from_worker, tok);
+      tok = pb.TupleIndex(rcv, 0);
+      sum = pb.Add(sum, pb.TupleIndex(rcv, 1));
+    }
+    BValue send = pb.Send(output, tok, sum);
+    XLS_RETURN_IF_ERROR(pb.Build(send, {}).status());
+  }
+  return network;
+}
+
+// A closed ring of `proc_count` adder procs with `depth` values circulating.
+// Exercises the backpressured case where every proc's progress is gated on
+// its upstream neighbor.
+absl::StatusOr<ProcNetwork> MakeRing(int64_t proc_count, int64_t payload_bits,
+                                     int64_t depth) {
+  ProcNetwork network;
+  network.name = absl::StrFormat("ring/procs=%d/bits=%d/depth=%d", proc_count,
+                                 payload_bits, depth);
+  network.payload_bits = payload_bits;
+  network.depth = depth;
+  network.package = std::make_unique<Package>("ring_benchmark");
+  Package* p = network.package.get();
+  Type* payload_type = p->GetBitsType(payload_bits);
+
+  std::vector<Channel*> channels;
+  for (int64_t i = 0; i < proc_count; ++i) {
+    XLS_ASSIGN_OR_RETURN(
+        Channel * channel,
+        p->CreateStreamingChannel(absl::StrFormat("ring_%d", i),
+                                  ChannelOps::kSendReceive, payload_type));
+    channels.push_back(channel);
+  }
+  network.seed_channels.push_back(channels[0]);
+  for (int64_t i = 0; i < proc_count; ++i) {
+    XLS_RETURN_IF_ERROR(BuildAdderProc(
+        absl::StrFormat("ring_proc_%d", i), channels[i],
+        channels[(i + 1) % proc_count], payload_bits, /*addend=*/1, p));
+  }
+  return network;
+}
+
+// Sorted per-tick latencies of a single run.
+using TickLatencies = std::vector<absl::Duration>;
+
+absl::Duration Percentile(const TickLatencies& latencies, double fraction) {
+  int64_t index = static_cast<int64_t>(fraction * (latencies.size() - 1));
+  return latencies[index];
+}
+
+// Prints the run and records its total duration as a phase named after the
+// runtime in the sample for this network.
+void ReportRun(absl::string_view network_name, absl::string_view runtime_name,
+               TickLatencies latencies, BenchmarkSampleProto* sample) {
+  std::sort(latencies.begin(), latencies.end());
+  absl::Duration total;
+  for (absl::Duration latency : latencies) {
+    total += latency;
+  }
+  double ticks_per_sec = latencies.size() / absl::ToDoubleSeconds(total);
+  absl::PrintF("%-40s %-12s %12.0f ticks/s  p50=%-10s p90=%-10s p99=%s\n",
+               network_name, runtime_name, ticks_per_sec,
+               absl::FormatDuration(Percentile(latencies, 0.5)),
+               absl::FormatDuration(Percentile(latencies, 0.9)),
+               absl::FormatDuration(Percentile(latencies, 0.99)));
+  BenchmarkPhaseProto* phase = sample->add_phases();
+  phase->set_name(std::string{runtime_name});
+  phase->set_duration_us(total / absl::Microseconds(1));
+}
+
+Value SeedValue(const ProcNetwork& network) {
+  return Value(UBits(1, network.payload_bits));
+}
+
+absl::Status RunSerialProcRuntime(const ProcNetwork& network, int64_t warmup,
+                                  int64_t ticks,
+                                  BenchmarkSampleProto* sample) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<SerialProcRuntime> runtime,
+                       SerialProcRuntime::Create(network.package.get()));
+  for (Channel* channel : network.seed_channels) {
+    for (int64_t i = 0; i < network.depth; ++i) {
+      XLS_RETURN_IF_ERROR(
+          runtime->EnqueueValueToChannel(channel, SeedValue(network)));
+    }
+  }
+  if (network.input != nullptr) {
+    for (int64_t i = 0; i < warmup + ticks; ++i) {
+      XLS_RETURN_IF_ERROR(
+          runtime->EnqueueValueToChannel(network.input, SeedValue(network)));
+    }
+  }
+  for (int64_t i = 0; i < warmup; ++i) {
+    XLS_RETURN_IF_ERROR(runtime->Tick());
+  }
+  TickLatencies latencies;
+  latencies.reserve(ticks);
+  for (int64_t i = 0; i < ticks; ++i) {
+    absl::Time start = absl::Now();
+    XLS_RETURN_IF_ERROR(runtime->Tick());
+    latencies.push_back(absl::Now() - start);
+  }
+  ReportRun(network.name, "jit", std::move(latencies), sample);
+  return absl::OkStatus();
+}
+
+absl::Status RunProcNetworkInterpreter(const ProcNetwork& network,
+                                       int64_t warmup, int64_t ticks,
+                                       BenchmarkSampleProto* sample) {
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<ProcNetworkInterpreter> interpreter,
+      ProcNetworkInterpreter::Create(network.package.get(),
+                                     /*user_defined_queues=*/{}));
+  for (Channel* channel : network.seed_channels) {
+    for (int64_t i = 0; i < network.depth; ++i) {
+      XLS_RETURN_IF_ERROR(interpreter->queue_manager()
+                              .GetQueue(channel)
+                              .Enqueue(SeedValue(network)));
+    }
+  }
+  if (network.input != nullptr) {
+    for (int64_t i = 0; i < warmup + ticks; ++i) {
+      XLS_RETURN_IF_ERROR(interpreter->queue_manager()
+                              .GetQueue(network.input)
+                              .Enqueue(SeedValue(network)));
+    }
+  }
+  for (int64_t i = 0; i < warmup; ++i) {
+    XLS_RETURN_IF_ERROR(interpreter->Tick());
+  }
+  TickLatencies latencies;
+  latencies.reserve(ticks);
+  for (int64_t i = 0; i < ticks; ++i) {
+    absl::Time start = absl::Now();
+    XLS_RETURN_IF_ERROR(interpreter->Tick());
+    latencies.push_back(absl::Now() - start);
+  }
+  ReportRun(network.name, "interpreter", std::move(latencies), sample);
+  return absl::OkStatus();
+}
+
+// Returns the phase durations of `suite` keyed by "<network>/<runtime>", the
+// same keying scheme benchmark_suite_main uses for its baselines.
+absl::flat_hash_map<std::string, int64_t> PhaseDurations(
+    const BenchmarkSuiteProto& suite) {
+  absl::flat_hash_map<std::string, int64_t> durations;
+  for (const BenchmarkSampleProto& sample : suite.samples()) {
+    for (const BenchmarkPhaseProto& phase : sample.phases()) {
+      durations[absl::StrFormat("%s/%s", sample.name(), phase.name())] =
+          phase.duration_us();
+    }
+  }
+  return durations;
+}
+
+// Compares the run against the baseline and prints flagged regressions.
+// Returns the number of regressions.
+int64_t CompareAgainstBaseline(const BenchmarkSuiteProto& run,
+                               const BenchmarkSuiteProto& baseline) {
+  const double regression_factor = absl::GetFlag(FLAGS_regression_factor);
+  const int64_t min_duration_us = absl::GetFlag(FLAGS_min_duration_us);
+  absl::flat_hash_map<std::string, int64_t> baseline_durations =
+      PhaseDurations(baseline);
+  int64_t regression_count = 0;
+  for (const auto& [key, duration_us] : PhaseDurations(run)) {
+    auto it = baseline_durations.find(key);
+    if (it == baseline_durations.end()) {
+      std::cout << absl::StreamFormat(
+          "NO BASELINE: %s (%dus); rerun with --update_baseline\n", key,
+          duration_us);
+      continue;
+    }
+    if (std::max(duration_us, it->second) < min_duration_us) {
+      continue;
+    }
+    if (duration_us >
+        static_cast<int64_t>(regression_factor *
+                             static_cast<double>(it->second))) {
+      std::cout << absl::StreamFormat(
+          "REGRESSION: %s: %dus vs baseline %dus (%.2fx > %.2fx)\n", key,
+          duration_us, it->second,
+          static_cast<double>(duration_us) / static_cast<double>(it->second),
+          regression_factor);
+      ++regression_count;
+    }
+  }
+  return regression_count;
+}
+
+absl::Status RunBenchmarks() {
+  int64_t ticks = absl::GetFlag(FLAGS_ticks);
+  int64_t warmup = absl::GetFlag(FLAGS_warmup_ticks);
+
+  std::vector<ProcNetwork> networks;
+  for (int64_t proc_count : {2, 8, 32}) {
+    for (int64_t payload_bits : {32, 256}) {
+      XLS_ASSIGN_OR_RETURN(ProcNetwork network,
+                           MakePipeline(proc_count, payload_bits,
+                                        /*depth=*/1));
+      networks.push_back(std::move(network));
+    }
+  }
+  XLS_ASSIGN_OR_RETURN(ProcNetwork deep_pipeline,
+                       MakePipeline(/*proc_count=*/8, /*payload_bits=*/32,
+                                    /*depth=*/8));
+  networks.push_back(std::move(deep_pipeline));
+  for (int64_t fanout : {4, 16}) {
+    XLS_ASSIGN_OR_RETURN(ProcNetwork network,
+                         MakeFanOutFanIn(fanout, /*payload_bits=*/32));
+    networks.push_back(std::move(network));
+  }
+  for (int64_t depth : {1, 4}) {
+    XLS_ASSIGN_OR_RETURN(ProcNetwork network,
+                         MakeRing(/*proc_count=*/8, /*payload_bits=*/32,
+                                  depth));
+    networks.push_back(std::move(network));
+  }
+
+  BenchmarkSuiteProto run;
+  for (const ProcNetwork& network : networks) {
+    BenchmarkSampleProto* sample = run.add_samples();
+    sample->set_name(network.name);
+    XLS_RETURN_IF_ERROR(
+        RunProcNetworkInterpreter(network, warmup, ticks, sample));
+    XLS_RETURN_IF_ERROR(RunSerialProcRuntime(network, warmup, ticks, sample));
+  }
+
+  const std::string baseline_path = absl::GetFlag(FLAGS_baseline_path);
+  if (baseline_path.empty()) {
+    return absl::OkStatus();
+  }
+  if (absl::GetFlag(FLAGS_update_baseline)) {
+    return SetTextProtoFile(baseline_path, run);
+  }
+  XLS_ASSIGN_OR_RETURN(BenchmarkSuiteProto baseline,
+                       ParseTextProtoFile<BenchmarkSuiteProto>(baseline_path));
+  int64_t regression_count = CompareAgainstBaseline(run, baseline);
+  if (regression_count > 0) {
+    return absl::InternalError(absl::StrFormat(
+        "%d run(s) regressed more than %.2fx against the baseline",
+        regression_count, absl::GetFlag(FLAGS_regression_factor)));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+}  // namespace xls
+
+int main(int argc, char** argv) {
+  xls::InitXls(argv[0], argc, argv);
+  XLS_QCHECK_OK(xls::RunBenchmarks());
+  return 0;
+}
@@ -13,6 +13,10 @@
 // limitations under the License.
 #include "xls/jit/serial_proc_runtime.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>  // NOLINT(build/c++11)
+
 #include "absl/status/status.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/proc.h"
@@ -39,7 +43,28 @@ void SerialProcRuntime::AwaitState(
       &await_data));
 }
 
+ProcJit* SerialProcRuntime::AwaitJit(ThreadData* thread_data) {
+  absl::MutexLock lock(&thread_data->mutex);
+  thread_data->mutex.Await(absl::Condition(
+      +[](ThreadData* thread_data) {
+        thread_data->mutex.AssertReaderHeld();
+        return thread_data->jit != nullptr;
+      },
+      thread_data));
+  return thread_data->jit.get();
+}
+
 void SerialProcRuntime::ThreadFn(ThreadData* thread_data) {
+  if (thread_data->jit == nullptr) {
+    // Background compilation: the JIT is built here on the proc thread, so
+    // Create() returns (and ticking can begin) while compilation of other
+    // procs is still in flight.
+    absl::StatusOr<std::unique_ptr<ProcJit>> jit = ProcJit::Create(
+        thread_data->proc, thread_data->queue_mgr, &RecvFn, &SendFn);
+    XLS_CHECK_OK(jit.status());
+    absl::MutexLock lock(&thread_data->mutex);
+    thread_data->jit = std::move(jit).value();
+  }
   absl::flat_hash_set<ThreadData::State> await_states(
       {ThreadData::State::kRunning, ThreadData::State::kCancelled});
   {
@@ -104,9 +129,9 @@ void SerialProcRuntime::SendFn(JitChannelQueue* queue, Send* send,
 }
 
 absl::StatusOr<std::unique_ptr<SerialProcRuntime>> SerialProcRuntime::Create(
-    Package* package) {
+    Package* package, bool background_compile) {
   auto runtime = absl::WrapUnique(new SerialProcRuntime(std::move(package)));
-  XLS_RETURN_IF_ERROR(runtime->Init());
+  XLS_RETURN_IF_ERROR(runtime->Init(background_compile));
   return runtime;
 }
 
@@ -122,25 +147,66 @@ SerialProcRuntime::~SerialProcRuntime() {
   }
 }
 
-absl::Status SerialProcRuntime::Init() {
+absl::Status SerialProcRuntime::Init(bool background_compile) {
   XLS_ASSIGN_OR_RETURN(queue_mgr_, JitChannelQueueManager::Create(package_));
 
   threads_.reserve(package_->procs().size());
   for (int i = 0; i < package_->procs().size(); i++) {
     auto thread = std::make_unique<ThreadData>();
-    Proc* proc = package_->procs()[i].get();
-    XLS_ASSIGN_OR_RETURN(
-        thread->jit, ProcJit::Create(proc, queue_mgr_.get(), &RecvFn, &SendFn));
+    thread->proc = package_->procs()[i].get();
+    thread->queue_mgr = queue_mgr_.get();
 
     absl::MutexLock lock(&thread->mutex);
     thread->sent_data = false;
     thread->thread_state = ThreadData::State::kPending;
     threads_.push_back(std::move(thread));
+  }
+
+  if (!background_compile) {
+    // Compile the procs up front, spreading the work over a pool of threads so
+    // startup is bounded by the slowest proc rather than the sum over the
+    // package. Each ProcJit owns its own LLVM context so the compilations are
+    // independent.
+    int64_t num_workers = std::min<int64_t>(
+        threads_.size(),
+        std::max<int64_t>(1, std::thread::hardware_concurrency()));
+    std::vector<absl::Status> worker_status(num_workers, absl::OkStatus());
+    std::atomic<int64_t> next_task(0);
+    std::vector<std::unique_ptr<Thread>> workers;
+    workers.reserve(num_workers);
+    for (int64_t w = 0; w < num_workers; ++w) {
+      workers.push_back(std::make_unique<Thread>([this, w, &next_task,
+                                                  &worker_status]() {
+        while (true) {
+          int64_t task = next_task.fetch_add(1);
+          if (task >= static_cast<int64_t>(threads_.size())) {
+            return;
+          }
+          ThreadData* thread_data = threads_[task].get();
+          absl::StatusOr<std::unique_ptr<ProcJit>> jit = ProcJit::Create(
+              thread_data->proc, thread_data->queue_mgr, &RecvFn, &SendFn);
+          if (!jit.ok()) {
+            worker_status[w] = jit.status();
+            return;
+          }
+          thread_data->jit = std::move(jit).value();
+        }
+      }));
+    }
+    for (auto& worker : workers) {
+      worker->Join();
+    }
+    for (const absl::Status& status : worker_status) {
+      XLS_RETURN_IF_ERROR(status);
+    }
+  }
 
-    // Start the thread - the first thing it does is wait until the state is
-    // either running or cancelled, so it'll be waiting for us when we actually
-    // call Tick().
-    auto thread_ptr = threads_.back().get();
+  for (auto& thread : threads_) {
+    // Start the thread - the first thing it does (after compiling its JIT, if
+    // background compilation was requested) is wait until the state is either
+    // running or cancelled, so it'll be waiting for us when we actually call
+    // Tick().
+    auto thread_ptr = thread.get();
     thread_ptr->thread =
         std::make_unique<Thread>([thread_ptr]() { ThreadFn(thread_ptr); });
   }
@@ -216,7 +282,7 @@ absl::Status SerialProcRuntime::EnqueueValueToChannel(Channel* channel,
   Type* type = package_->GetTypeForValue(value);
 
   XLS_RET_CHECK(!threads_.empty());
-  ProcJit* jit = threads_.front()->jit.get();
+  ProcJit* jit = AwaitJit(threads_.front().get());
   int64_t size = jit->type_converter()->GetTypeByteSize(type);
   auto buffer = std::make_unique<uint8_t[]>(size);
   jit->runtime()->BlitValueToBuffer(value, type,
@@ -233,7 +299,7 @@ absl::StatusOr<Value> SerialProcRuntime::DequeueValueFromChannel(
   Type* type = channel->type();
 
   XLS_RET_CHECK(!threads_.empty());
-  ProcJit* jit = threads_.front()->jit.get();
+  ProcJit* jit = AwaitJit(threads_.front().get());
   int64_t size = jit->type_converter()->GetTypeByteSize(type);
   auto buffer = std::make_unique<uint8_t[]>(size);
 
@@ -251,7 +317,7 @@ absl::StatusOr<Proc*> SerialProcRuntime::proc(int64_t index) const {
     return absl::InvalidArgumentError(
         absl::StrCat("Valid indices are 0 - ", threads_.size(), "."));
   }
-  return dynamic_cast<Proc*>(threads_[index]->jit->proc());
+  return threads_[index]->proc;
 }
 
 absl::StatusOr<std::vector<Value>>
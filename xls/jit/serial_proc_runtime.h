@@ -38,8 +38,15 @@ namespace xls {
 // when a deadlock is detected.
 class SerialProcRuntime {
  public:
+  // Creates a runtime for the procs of `package`. The procs are JIT-compiled
+  // concurrently, so startup latency is bounded by the slowest proc rather
+  // than the sum over the package. If `background_compile` is true Create
+  // returns before compilation has finished: each proc thread compiles its
+  // own JIT before its first activation, so ticking can begin while the
+  // compilation of later procs is still in flight (the first Tick blocks on
+  // each proc's compilation only when it reaches that proc).
   static absl::StatusOr<std::unique_ptr<SerialProcRuntime>> Create(
-      Package* package);
+      Package* package, bool background_compile = false);
   ~SerialProcRuntime();
 
   // Execute one cycle of every proc in the network.
@@ -81,6 +88,12 @@ class SerialProcRuntime {
     std::unique_ptr<Thread> thread;
     std::unique_ptr<ProcJit> jit;
 
+    // The proc this thread executes and the queue manager of the runtime.
+    // Used to compile the JIT on the proc thread itself when the runtime was
+    // created with `background_compile`.
+    Proc* proc;
+    JitChannelQueueManager* queue_mgr;
+
     // The Proc's carried state.
     std::vector<Value> proc_state;
 
@@ -97,7 +110,7 @@ class SerialProcRuntime {
   };
 
   SerialProcRuntime(Package* package);
-  absl::Status Init();
+  absl::Status Init(bool background_compile);
   static void ThreadFn(ThreadData* thread_data);
 
   // Proc Receive handler function.
@@ -112,6 +125,10 @@ class SerialProcRuntime {
   static void AwaitState(ThreadData* thread_data,
                          const absl::flat_hash_set<ThreadData::State>& states);
 
+  // Returns the JIT of the given thread, blocking until its (possibly
+  // background) compilation has finished.
+  static ProcJit* AwaitJit(ThreadData* thread_data);
+
   Package* package_;
   std::vector<std::unique_ptr<ThreadData>> threads_;
   std::unique_ptr<JitChannelQueueManager> queue_mgr_;
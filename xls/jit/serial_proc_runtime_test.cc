@@ -101,6 +101,65 @@ proc b(my_token: token, state: (), init={()}) {
   }
 }
 
+// Same network as above, but with the proc JITs compiled in the background:
+// ticking starts before compilation of every proc has necessarily finished.
+TEST(SerialProcRuntimeTest, SimpleNetworkBackgroundCompile) {
+  constexpr int kNumCycles = 4;
+  const std::string kIrText = R"(
+package p
+
+chan a_in(bits[32], id=0, kind=streaming, ops=receive_only, flow_control=none, metadata="")
+chan a_to_b(bits[32], id=1, kind=streaming, ops=send_receive, flow_control=none, metadata="")
+chan b_out(bits[32], id=2, kind=streaming, ops=send_only, flow_control=none, metadata="")
+
+proc a(my_token: token, state: (), init={()}) {
+  literal.1: bits[32] = literal(value=2)
+  receive.2: (token, bits[32]) = receive(my_token, channel_id=0)
+  tuple_index.3: token = tuple_index(receive.2, index=0)
+  tuple_index.4: bits[32] = tuple_index(receive.2, index=1)
+  umul.5: bits[32] = umul(literal.1, tuple_index.4)
+  send.6: token = send(tuple_index.3, umul.5, channel_id=1)
+  next (send.6, state)
+}
+
+proc b(my_token: token, state: (), init={()}) {
+  literal.100: bits[32] = literal(value=3)
+  receive.200: (token, bits[32]) = receive(my_token, channel_id=1)
+  tuple_index.300: token = tuple_index(receive.200, index=0)
+  tuple_index.400: bits[32] = tuple_index(receive.200, index=1)
+  umul.500: bits[32] = umul(literal.100, tuple_index.400)
+  send.600: token = send(tuple_index.300, umul.500, channel_id=2)
+  next (send.600, state)
+}
+)";
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, Parser::ParsePackage(kIrText));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto runtime,
+      SerialProcRuntime::Create(p.get(), /*background_compile=*/true));
+  auto queue_mgr = runtime->queue_mgr();
+  XLS_ASSERT_OK_AND_ASSIGN(auto input_queue, queue_mgr->GetQueueById(0));
+  XLS_ASSERT_OK_AND_ASSIGN(auto internal_queue, queue_mgr->GetQueueById(1));
+  XLS_ASSERT_OK_AND_ASSIGN(auto output_queue, queue_mgr->GetQueueById(2));
+
+  for (int i = 0; i < kNumCycles; i++) {
+    EnqueueData(input_queue, i);
+  }
+
+  int dummy = 0;
+  EnqueueData(internal_queue, dummy);
+
+  for (int i = 0; i < kNumCycles; i++) {
+    XLS_ASSERT_OK(runtime->Tick());
+  }
+
+  DequeueData<int>(output_queue);
+  for (int i = 0; i < kNumCycles - 1; i++) {
+    int result = DequeueData<int>(output_queue);
+    EXPECT_EQ(result, i * 6);
+  }
+}
+
 // Test verifies that an "X"-shaped network can be modeled correctly, i.e.,
 // a network that looks like:
 //  A   B
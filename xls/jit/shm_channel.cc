@@ -0,0 +1,205 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/shm_channel.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/math_util.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+
+namespace xls {
+namespace {
+
+absl::Status ValidateName(absl::string_view name) {
+  if (name.empty() || name[0] != '/' ||
+      name.find('/', 1) != absl::string_view::npos) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Shared memory name must have the form \"/name\"; got \"%s\"", name));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ErrnoStatus(absl::string_view operation, absl::string_view name) {
+  return absl::InternalError(absl::StrFormat("%s failed for \"%s\": %s",
+                                             operation, name,
+                                             std::strerror(errno)));
+}
+
+}  // namespace
+
+/* static */ absl::StatusOr<std::unique_ptr<ShmChannelBuffer>>
+ShmChannelBuffer::Create(absl::string_view name, int64_t element_size,
+                         int64_t capacity) {
+  XLS_RETURN_IF_ERROR(ValidateName(name));
+  XLS_RET_CHECK_GT(element_size, 0);
+  XLS_RET_CHECK_GT(capacity, 0);
+  std::string name_str(name);
+
+  int64_t stride = RoundUpToNearest(
+      element_size, static_cast<int64_t>(alignof(std::max_align_t)));
+  int64_t total_size =
+      static_cast<int64_t>(sizeof(ShmChannelHeader)) + capacity * stride;
+
+  int fd = shm_open(name_str.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd < 0) {
+    if (errno == EEXIST) {
+      return absl::AlreadyExistsError(absl::StrFormat(
+          "Shared memory segment \"%s\" already exists", name));
+    }
+    return ErrnoStatus("shm_open", name);
+  }
+  if (ftruncate(fd, total_size) != 0) {
+    absl::Status status = ErrnoStatus("ftruncate", name);
+    close(fd);
+    shm_unlink(name_str.c_str());
+    return status;
+  }
+  void* base = mmap(nullptr, total_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                    fd, /*offset=*/0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    shm_unlink(name_str.c_str());
+    return ErrnoStatus("mmap", name);
+  }
+
+  // The segment is zero-filled by ftruncate; fill in the header. Openers may
+  // only attach after Create() returns (the name is the rendezvous), so no
+  // ordering beyond that is required here.
+  auto* header = static_cast<ShmChannelHeader*>(base);
+  header->element_size = element_size;
+  header->capacity = capacity;
+  header->element_stride = stride;
+  header->enqueue_count.store(0, std::memory_order_relaxed);
+  header->dequeue_count.store(0, std::memory_order_relaxed);
+  header->magic = ShmChannelHeader::kMagic;
+
+  return absl::WrapUnique(
+      new ShmChannelBuffer(std::move(name_str), header, total_size));
+}
+
+/* static */ absl::StatusOr<std::unique_ptr<ShmChannelBuffer>>
+ShmChannelBuffer::Open(absl::string_view name) {
+  XLS_RETURN_IF_ERROR(ValidateName(name));
+  std::string name_str(name);
+
+  int fd = shm_open(name_str.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    if (errno == ENOENT) {
+      return absl::NotFoundError(absl::StrFormat(
+          "Shared memory segment \"%s\" does not exist", name));
+    }
+    return ErrnoStatus("shm_open", name);
+  }
+  struct stat statbuf;
+  if (fstat(fd, &statbuf) != 0) {
+    absl::Status status = ErrnoStatus("fstat", name);
+    close(fd);
+    return status;
+  }
+  int64_t total_size = statbuf.st_size;
+  if (total_size < static_cast<int64_t>(sizeof(ShmChannelHeader))) {
+    close(fd);
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "\"%s\" is too small (%d bytes) to be an XLS shm channel segment",
+        name, total_size));
+  }
+  void* base = mmap(nullptr, total_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                    fd, /*offset=*/0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    return ErrnoStatus("mmap", name);
+  }
+
+  auto* header = static_cast<ShmChannelHeader*>(base);
+  auto fail = [&](absl::Status status) {
+    munmap(base, total_size);
+    return status;
+  };
+  if (header->magic != ShmChannelHeader::kMagic) {
+    return fail(absl::InvalidArgumentError(absl::StrFormat(
+        "\"%s\" is not an XLS shm channel segment (bad magic)", name)));
+  }
+  if (header->element_size <= 0 || header->capacity <= 0 ||
+      header->element_stride < header->element_size) {
+    return fail(absl::InvalidArgumentError(absl::StrFormat(
+        "\"%s\" has a corrupt header (element size %d, capacity %d, stride "
+        "%d)",
+        name, header->element_size, header->capacity,
+        header->element_stride)));
+  }
+  int64_t expected_size = static_cast<int64_t>(sizeof(ShmChannelHeader)) +
+                          header->capacity * header->element_stride;
+  if (total_size < expected_size) {
+    return fail(absl::InvalidArgumentError(absl::StrFormat(
+        "\"%s\" is %d bytes but its header describes %d bytes", name,
+        total_size, expected_size)));
+  }
+
+  return absl::WrapUnique(
+      new ShmChannelBuffer(std::move(name_str), header, total_size));
+}
+
+ShmChannelBuffer::~ShmChannelBuffer() { munmap(header_, mapped_size_); }
+
+bool ShmChannelBuffer::TrySend(const uint8_t* data) {
+  uint64_t enqueue_count = header_->enqueue_count.load(
+      std::memory_order_relaxed);
+  if (enqueue_count - header_->dequeue_count.load(std::memory_order_acquire) >=
+      static_cast<uint64_t>(header_->capacity)) {
+    return false;
+  }
+  std::memcpy(slot(enqueue_count % header_->capacity), data,
+              header_->element_size);
+  header_->enqueue_count.store(enqueue_count + 1, std::memory_order_release);
+  return true;
+}
+
+bool ShmChannelBuffer::TryRecv(uint8_t* buffer) {
+  uint64_t dequeue_count = header_->dequeue_count.load(
+      std::memory_order_relaxed);
+  if (dequeue_count ==
+      header_->enqueue_count.load(std::memory_order_acquire)) {
+    return false;
+  }
+  std::memcpy(buffer, slot(dequeue_count % header_->capacity),
+              header_->element_size);
+  header_->dequeue_count.store(dequeue_count + 1, std::memory_order_release);
+  return true;
+}
+
+bool ShmChannelBuffer::Empty() const {
+  return header_->dequeue_count.load(std::memory_order_acquire) ==
+         header_->enqueue_count.load(std::memory_order_acquire);
+}
+
+/* static */ absl::Status ShmChannelBuffer::Unlink(absl::string_view name) {
+  XLS_RETURN_IF_ERROR(ValidateName(name));
+  if (shm_unlink(std::string(name).c_str()) != 0) {
+    return ErrnoStatus("shm_unlink", name);
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace xls
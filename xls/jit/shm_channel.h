@@ -0,0 +1,131 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef XLS_JIT_SHM_CHANNEL_H_
+#define XLS_JIT_SHM_CHANNEL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+
+namespace xls {
+
+// Header of an XLS shared-memory channel segment. The segment holds a
+// single-producer single-consumer ring buffer with the same protocol as
+// SpscJitChannelQueue (jit_channel_queue.h), but with all shared state inside
+// a POSIX shared-memory object so that the producer and consumer may live in
+// different processes.
+//
+// Segment layout (offsets and sizes in bytes; integers are host-endian):
+//
+//   offset  size  field
+//   0       8     magic: kMagic, identifies the segment and layout version
+//   8       8     element size in bytes
+//   16      8     capacity in elements
+//   24      8     element stride: element size rounded up to
+//                 alignof(std::max_align_t)
+//   32      32    reserved, zero
+//   64      8     enqueue count; written only by the producer
+//   72      56    padding keeping the counts on separate cache lines
+//   128     8     dequeue count; written only by the consumer
+//   136     56    padding
+//   192     n     element slots: capacity * stride bytes
+//
+// The counts increase monotonically; an element's slot index is its count
+// modulo the capacity. The ring is empty when the counts are equal and full
+// when enqueue count - dequeue count equals the capacity. The producer
+// publishes a slot with a release store of the enqueue count; the consumer
+// releases a slot with a release store of the dequeue count.
+struct ShmChannelHeader {
+  static constexpr uint64_t kMagic = 0x584c5353484d5131;  // "XLSSHMQ1"
+  static constexpr int64_t kCacheLineBytes = 64;
+
+  uint64_t magic;
+  int64_t element_size;
+  int64_t capacity;
+  int64_t element_stride;
+  uint8_t reserved[32];
+  alignas(kCacheLineBytes) std::atomic<uint64_t> enqueue_count;
+  alignas(kCacheLineBytes) std::atomic<uint64_t> dequeue_count;
+};
+static_assert(sizeof(ShmChannelHeader) == 192,
+              "ShmChannelHeader layout is part of the shared-memory ABI");
+
+// One endpoint's view of a shared-memory channel segment. A segment is
+// created once (by either side) and then opened by the other side; the
+// element size and capacity are fixed at creation. TrySend may only be called
+// by one thread/process at a time, and likewise TryRecv; this matches how XLS
+// channels are used (one sending proc, one receiving proc).
+//
+// The C API in shm_channel_c_api.h exposes the same operations to non-C++
+// producers and consumers.
+class ShmChannelBuffer {
+ public:
+  // Creates a new shared-memory segment with the given name (which must have
+  // the form "/name", per shm_open) holding a ring of `capacity` elements of
+  // `element_size` bytes. Fails with kAlreadyExists if the name is taken.
+  static absl::StatusOr<std::unique_ptr<ShmChannelBuffer>> Create(
+      absl::string_view name, int64_t element_size, int64_t capacity);
+
+  // Opens an existing segment and validates its magic and layout. The creator
+  // must have finished Create() before the name is shared with the opener.
+  static absl::StatusOr<std::unique_ptr<ShmChannelBuffer>> Open(
+      absl::string_view name);
+
+  // Unmaps the segment. Does not remove the name; see Unlink().
+  ~ShmChannelBuffer();
+
+  ShmChannelBuffer(const ShmChannelBuffer&) = delete;
+  ShmChannelBuffer& operator=(const ShmChannelBuffer&) = delete;
+
+  // Copies element_size() bytes from `data` into the ring. Returns false
+  // without copying if the ring is full.
+  bool TrySend(const uint8_t* data);
+
+  // Copies the element at the front of the ring into `buffer` (element_size()
+  // bytes). Returns false without copying if the ring is empty.
+  bool TryRecv(uint8_t* buffer);
+
+  bool Empty() const;
+
+  int64_t element_size() const { return header_->element_size; }
+  int64_t capacity() const { return header_->capacity; }
+  const std::string& name() const { return name_; }
+
+  // Removes the named segment from the system. Existing mappings stay valid
+  // until their owners are destroyed.
+  static absl::Status Unlink(absl::string_view name);
+
+ private:
+  ShmChannelBuffer(std::string name, ShmChannelHeader* header,
+                   int64_t mapped_size)
+      : name_(std::move(name)), header_(header), mapped_size_(mapped_size) {}
+
+  uint8_t* slot(uint64_t index) {
+    return reinterpret_cast<uint8_t*>(header_) + sizeof(ShmChannelHeader) +
+           static_cast<int64_t>(index) * header_->element_stride;
+  }
+
+  std::string name_;
+  ShmChannelHeader* header_;
+  int64_t mapped_size_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_JIT_SHM_CHANNEL_H_
@@ -0,0 +1,82 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/shm_channel_c_api.h"
+
+#include <memory>
+#include <utility>
+
+#include "absl/status/statusor.h"
+#include "xls/common/logging/logging.h"
+#include "xls/jit/shm_channel.h"
+
+extern "C" {
+
+struct xls_shm_channel {
+  std::unique_ptr<xls::ShmChannelBuffer> impl;
+};
+
+xls_shm_channel* xls_shm_channel_create(const char* name, int64_t element_size,
+                                        int64_t capacity) {
+  absl::StatusOr<std::unique_ptr<xls::ShmChannelBuffer>> buffer =
+      xls::ShmChannelBuffer::Create(name, element_size, capacity);
+  if (!buffer.ok()) {
+    XLS_LOG(WARNING) << "xls_shm_channel_create: " << buffer.status();
+    return nullptr;
+  }
+  return new xls_shm_channel{std::move(buffer).value()};
+}
+
+xls_shm_channel* xls_shm_channel_open(const char* name) {
+  absl::StatusOr<std::unique_ptr<xls::ShmChannelBuffer>> buffer =
+      xls::ShmChannelBuffer::Open(name);
+  if (!buffer.ok()) {
+    XLS_LOG(WARNING) << "xls_shm_channel_open: " << buffer.status();
+    return nullptr;
+  }
+  return new xls_shm_channel{std::move(buffer).value()};
+}
+
+int64_t xls_shm_channel_element_size(const xls_shm_channel* channel) {
+  return channel->impl->element_size();
+}
+
+int64_t xls_shm_channel_capacity(const xls_shm_channel* channel) {
+  return channel->impl->capacity();
+}
+
+int xls_shm_channel_try_send(xls_shm_channel* channel, const uint8_t* data) {
+  return channel->impl->TrySend(data) ? 1 : 0;
+}
+
+int xls_shm_channel_try_recv(xls_shm_channel* channel, uint8_t* buffer) {
+  return channel->impl->TryRecv(buffer) ? 1 : 0;
+}
+
+int xls_shm_channel_empty(const xls_shm_channel* channel) {
+  return channel->impl->Empty() ? 1 : 0;
+}
+
+void xls_shm_channel_close(xls_shm_channel* channel) { delete channel; }
+
+int xls_shm_channel_unlink(const char* name) {
+  absl::Status status = xls::ShmChannelBuffer::Unlink(name);
+  if (!status.ok()) {
+    XLS_LOG(WARNING) << "xls_shm_channel_unlink: " << status;
+    return 0;
+  }
+  return 1;
+}
+
+}  // extern "C"
@@ -0,0 +1,73 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// C interface to XLS shared-memory channel segments (see shm_channel.h for
+// the segment layout). External producer/consumer processes use this API to
+// exchange channel data with a running JIT proc network whose queues are
+// ShmJitChannelQueues (shm_channel_queue.h) without crossing a process
+// boundary per element: both sides map the same ring buffer.
+//
+// Elements are the raw channel element bytes in the JIT's native data layout;
+// the element size is fixed when the segment is created and can be queried
+// with xls_shm_channel_element_size(). Each segment supports one concurrent
+// producer and one concurrent consumer.
+
+#ifndef XLS_JIT_SHM_CHANNEL_C_API_H_
+#define XLS_JIT_SHM_CHANNEL_C_API_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Opaque handle to one endpoint's view of a segment.
+typedef struct xls_shm_channel xls_shm_channel;
+
+// Creates a new segment named `name` (of the form "/name") holding a ring of
+// `capacity` elements of `element_size` bytes. Returns NULL if the name is
+// taken or creation fails.
+xls_shm_channel* xls_shm_channel_create(const char* name, int64_t element_size,
+                                        int64_t capacity);
+
+// Opens an existing segment. Returns NULL if the segment does not exist or
+// is not a valid XLS shm channel segment.
+xls_shm_channel* xls_shm_channel_open(const char* name);
+
+int64_t xls_shm_channel_element_size(const xls_shm_channel* channel);
+int64_t xls_shm_channel_capacity(const xls_shm_channel* channel);
+
+// Copies element_size bytes from `data` into the ring. Returns 1 on success
+// and 0 (without copying) if the ring is full.
+int xls_shm_channel_try_send(xls_shm_channel* channel, const uint8_t* data);
+
+// Copies the front element of the ring into `buffer` (element_size bytes).
+// Returns 1 on success and 0 (without copying) if the ring is empty.
+int xls_shm_channel_try_recv(xls_shm_channel* channel, uint8_t* buffer);
+
+// Returns 1 if the ring is empty, 0 otherwise.
+int xls_shm_channel_empty(const xls_shm_channel* channel);
+
+// Unmaps the segment and frees the handle. Does not remove the name.
+void xls_shm_channel_close(xls_shm_channel* channel);
+
+// Removes the named segment from the system. Open handles stay valid until
+// closed. Returns 1 on success, 0 on failure.
+int xls_shm_channel_unlink(const char* name);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // XLS_JIT_SHM_CHANNEL_C_API_H_
@@ -0,0 +1,71 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/shm_channel_queue.h"
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+
+namespace xls {
+
+/* static */ absl::StatusOr<std::unique_ptr<ShmJitChannelQueue>>
+ShmJitChannelQueue::Create(int64_t channel_id, absl::string_view shm_name,
+                           int64_t element_size, int64_t capacity) {
+  absl::StatusOr<std::unique_ptr<ShmChannelBuffer>> buffer =
+      ShmChannelBuffer::Create(shm_name, element_size, capacity);
+  if (absl::IsAlreadyExists(buffer.status())) {
+    // The other endpoint created the segment first; attach and verify that
+    // both sides agree on the layout.
+    buffer = ShmChannelBuffer::Open(shm_name);
+  }
+  XLS_RETURN_IF_ERROR(buffer.status());
+  if ((*buffer)->element_size() != element_size ||
+      (*buffer)->capacity() != capacity) {
+    return absl::FailedPreconditionError(absl::StrFormat(
+        "Existing segment \"%s\" holds %d elements of %d bytes; channel %d "
+        "requires %d elements of %d bytes",
+        shm_name, (*buffer)->capacity(), (*buffer)->element_size(), channel_id,
+        capacity, element_size));
+  }
+  return absl::WrapUnique(
+      new ShmJitChannelQueue(channel_id, std::move(buffer).value()));
+}
+
+absl::StatusOr<std::unique_ptr<JitChannelQueueManager>>
+CreateShmJitChannelQueueManager(
+    Package* package, absl::string_view shm_prefix,
+    const std::function<int64_t(Channel*)>& element_size_fn,
+    int64_t capacity) {
+  absl::flat_hash_map<int64_t, std::unique_ptr<JitChannelQueue>> queues;
+  for (Channel* chan : package->channels()) {
+    if (chan->kind() == ChannelKind::kStreaming) {
+      XLS_ASSIGN_OR_RETURN(
+          std::unique_ptr<ShmJitChannelQueue> queue,
+          ShmJitChannelQueue::Create(
+              chan->id(), absl::StrFormat("%s_%d", shm_prefix, chan->id()),
+              element_size_fn(chan), capacity));
+      queues.insert({chan->id(), std::move(queue)});
+    } else {
+      XLS_RET_CHECK_EQ(chan->kind(), ChannelKind::kSingleValue);
+      queues.insert({chan->id(),
+                     std::make_unique<SingleValueJitChannelQueue>(chan->id())});
+    }
+  }
+  return JitChannelQueueManager::CreateFromQueues(package, std::move(queues));
+}
+
+}  // namespace xls
@@ -0,0 +1,108 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef XLS_JIT_SHM_CHANNEL_QUEUE_H_
+#define XLS_JIT_SHM_CHANNEL_QUEUE_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xls/ir/channel.h"
+#include "xls/ir/package.h"
+#include "xls/jit/jit_channel_queue.h"
+#include "xls/jit/shm_channel.h"
+
+namespace xls {
+
+// Queue for streaming channels backed by a POSIX shared-memory segment
+// (shm_channel.h) so one endpoint of the channel may live in another process,
+// e.g. an external producer or consumer using the C API in
+// shm_channel_c_api.h. Data moves through the mapped ring buffer directly;
+// there is no per-element process-boundary copy. Like SpscJitChannelQueue the
+// ring has a fixed capacity and supports one concurrent producer and one
+// concurrent consumer, and Send spins when the ring is full.
+//
+// Unlike the in-process queues the element size is fixed when the segment is
+// created rather than discovered on the first send, since the two endpoints
+// must agree on the layout before either sends.
+class ShmJitChannelQueue : public JitChannelQueue {
+ public:
+  // Creates the shared-memory segment `shm_name` (of the form "/name") with
+  // the given element size and capacity, or attaches to it if it already
+  // exists -- whichever of the two communicating processes starts first
+  // creates the segment. Fails if an existing segment disagrees on element
+  // size or capacity.
+  static absl::StatusOr<std::unique_ptr<ShmJitChannelQueue>> Create(
+      int64_t channel_id, absl::string_view shm_name, int64_t element_size,
+      int64_t capacity);
+
+  void Send(uint8_t* data, int64_t num_bytes) override {
+    // Spin until the consumer has drained a slot.
+    while (!TrySend(data, num_bytes)) {
+    }
+  }
+
+  bool TrySend(uint8_t* data, int64_t num_bytes) override {
+#ifdef ABSL_HAVE_MEMORY_SANITIZER
+    __msan_unpoison(data, num_bytes);
+#endif
+    XLS_CHECK_EQ(num_bytes, buffer_->element_size()) << absl::StrFormat(
+        "Invalid number of bytes given to Send Function of "
+        "ShmJitChannelQueue: expected (%s), got (%s).",
+        std::to_string(buffer_->element_size()), std::to_string(num_bytes));
+    return buffer_->TrySend(data);
+  }
+
+  bool Recv(uint8_t* buffer, int64_t num_bytes) override {
+    XLS_CHECK_EQ(num_bytes, buffer_->element_size()) << absl::StrFormat(
+        "Invalid number of bytes given to Recv Function of "
+        "ShmJitChannelQueue: expected (%s), got (%s).",
+        std::to_string(buffer_->element_size()), std::to_string(num_bytes));
+    return buffer_->TryRecv(buffer);
+  }
+
+  bool Empty() override { return buffer_->Empty(); }
+
+  // The underlying segment, e.g. for sharing its name with the other process.
+  ShmChannelBuffer& shm_buffer() { return *buffer_; }
+
+ protected:
+  ShmJitChannelQueue(int64_t channel_id,
+                     std::unique_ptr<ShmChannelBuffer> buffer)
+      : JitChannelQueue(channel_id), buffer_(std::move(buffer)) {}
+
+  std::unique_ptr<ShmChannelBuffer> buffer_;
+};
+
+// Returns a JitChannelQueueManager mapping every streaming channel in
+// `package` to a ShmJitChannelQueue whose segment is named
+// "<shm_prefix>_<channel_id>" (`shm_prefix` must have the form "/name").
+// `element_size_fn` gives the element size in bytes for each channel; the JIT
+// derives buffer sizes from the LLVM data layout (see
+// LlvmTypeConverter::GetTypeByteSize), which is not known at the package
+// level. Single value channels remain process-local
+// SingleValueJitChannelQueues; only streaming channels are shared.
+absl::StatusOr<std::unique_ptr<JitChannelQueueManager>>
+CreateShmJitChannelQueueManager(
+    Package* package, absl::string_view shm_prefix,
+    const std::function<int64_t(Channel*)>& element_size_fn,
+    int64_t capacity);
+
+}  // namespace xls
+
+#endif  // XLS_JIT_SHM_CHANNEL_QUEUE_H_
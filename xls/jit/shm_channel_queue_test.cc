@@ -0,0 +1,220 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/shm_channel_queue.h"
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/channel.h"
+#include "xls/ir/package.h"
+#include "xls/jit/shm_channel.h"
+#include "xls/jit/shm_channel_c_api.h"
+
+namespace xls {
+namespace {
+
+// Returns a shared-memory name unique to this process and test so that
+// concurrently running or crashed test shards do not collide.
+std::string UniqueShmName(absl::string_view test_name) {
+  return absl::StrFormat("/xls_shm_test_%d_%s", getpid(), test_name);
+}
+
+TEST(ShmChannelBufferTest, CreateOpenRoundtrip) {
+  std::string name = UniqueShmName("roundtrip");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ShmChannelBuffer> producer,
+      ShmChannelBuffer::Create(name, /*element_size=*/8, /*capacity=*/4));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ShmChannelBuffer> consumer,
+                           ShmChannelBuffer::Open(name));
+  EXPECT_EQ(consumer->element_size(), 8);
+  EXPECT_EQ(consumer->capacity(), 4);
+  EXPECT_TRUE(consumer->Empty());
+
+  uint64_t value = 42;
+  EXPECT_TRUE(producer->TrySend(reinterpret_cast<uint8_t*>(&value)));
+  EXPECT_FALSE(consumer->Empty());
+  uint64_t read_value = 0;
+  EXPECT_TRUE(consumer->TryRecv(reinterpret_cast<uint8_t*>(&read_value)));
+  EXPECT_EQ(read_value, 42);
+  EXPECT_TRUE(consumer->Empty());
+
+  XLS_EXPECT_OK(ShmChannelBuffer::Unlink(name));
+  EXPECT_FALSE(ShmChannelBuffer::Open(name).ok());
+}
+
+TEST(ShmChannelBufferTest, CreateFailsIfNameTaken) {
+  std::string name = UniqueShmName("name_taken");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ShmChannelBuffer> buffer,
+      ShmChannelBuffer::Create(name, /*element_size=*/8, /*capacity=*/4));
+  EXPECT_TRUE(absl::IsAlreadyExists(
+      ShmChannelBuffer::Create(name, /*element_size=*/8, /*capacity=*/4)
+          .status()));
+  XLS_EXPECT_OK(ShmChannelBuffer::Unlink(name));
+}
+
+TEST(ShmJitChannelQueueTest, BasicAccess) {
+  std::string name = UniqueShmName("basic_access");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ShmJitChannelQueue> queue,
+      ShmJitChannelQueue::Create(/*channel_id=*/0, name,
+                                 /*element_size=*/sizeof(uint64_t),
+                                 /*capacity=*/16));
+  EXPECT_TRUE(queue->Empty());
+  for (uint64_t i = 0; i < 10; i++) {
+    queue->Send(reinterpret_cast<uint8_t*>(&i), sizeof(i));
+  }
+  EXPECT_FALSE(queue->Empty());
+  for (uint64_t i = 0; i < 10; i++) {
+    uint64_t value = 0;
+    EXPECT_TRUE(queue->Recv(reinterpret_cast<uint8_t*>(&value),
+                            sizeof(value)));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_TRUE(queue->Empty());
+  XLS_EXPECT_OK(ShmChannelBuffer::Unlink(name));
+}
+
+TEST(ShmJitChannelQueueTest, TrySendOnFullQueueReturnsFalse) {
+  std::string name = UniqueShmName("full_queue");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ShmJitChannelQueue> queue,
+      ShmJitChannelQueue::Create(/*channel_id=*/0, name,
+                                 /*element_size=*/sizeof(uint64_t),
+                                 /*capacity=*/2));
+  uint64_t value = 7;
+  EXPECT_TRUE(queue->TrySend(reinterpret_cast<uint8_t*>(&value),
+                             sizeof(value)));
+  EXPECT_TRUE(queue->TrySend(reinterpret_cast<uint8_t*>(&value),
+                             sizeof(value)));
+  EXPECT_FALSE(queue->TrySend(reinterpret_cast<uint8_t*>(&value),
+                              sizeof(value)));
+  uint64_t read_value = 0;
+  EXPECT_TRUE(queue->Recv(reinterpret_cast<uint8_t*>(&read_value),
+                          sizeof(read_value)));
+  EXPECT_TRUE(queue->TrySend(reinterpret_cast<uint8_t*>(&value),
+                             sizeof(value)));
+  XLS_EXPECT_OK(ShmChannelBuffer::Unlink(name));
+}
+
+TEST(ShmJitChannelQueueTest, SecondEndpointAttachesToExistingSegment) {
+  std::string name = UniqueShmName("two_endpoints");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ShmJitChannelQueue> producer,
+      ShmJitChannelQueue::Create(/*channel_id=*/0, name,
+                                 /*element_size=*/sizeof(uint64_t),
+                                 /*capacity=*/16));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ShmJitChannelQueue> consumer,
+      ShmJitChannelQueue::Create(/*channel_id=*/0, name,
+                                 /*element_size=*/sizeof(uint64_t),
+                                 /*capacity=*/16));
+  // Attaching with a mismatched layout is an error.
+  EXPECT_FALSE(ShmJitChannelQueue::Create(/*channel_id=*/0, name,
+                                          /*element_size=*/4,
+                                          /*capacity=*/16)
+                   .ok());
+
+  uint64_t value = 123;
+  producer->Send(reinterpret_cast<uint8_t*>(&value), sizeof(value));
+  uint64_t read_value = 0;
+  EXPECT_TRUE(consumer->Recv(reinterpret_cast<uint8_t*>(&read_value),
+                             sizeof(read_value)));
+  EXPECT_EQ(read_value, 123);
+  XLS_EXPECT_OK(ShmChannelBuffer::Unlink(name));
+}
+
+TEST(ShmJitChannelQueueTest, CApiProducerInterop) {
+  std::string name = UniqueShmName("c_api");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ShmJitChannelQueue> queue,
+      ShmJitChannelQueue::Create(/*channel_id=*/0, name,
+                                 /*element_size=*/sizeof(uint64_t),
+                                 /*capacity=*/16));
+  // An external producer opens the same segment through the C API and sends;
+  // the queue sees the data without further copies.
+  xls_shm_channel* channel = xls_shm_channel_open(name.c_str());
+  ASSERT_NE(channel, nullptr);
+  EXPECT_EQ(xls_shm_channel_element_size(channel), sizeof(uint64_t));
+  EXPECT_EQ(xls_shm_channel_capacity(channel), 16);
+  EXPECT_EQ(xls_shm_channel_empty(channel), 1);
+
+  uint64_t value = 55;
+  EXPECT_EQ(
+      xls_shm_channel_try_send(channel, reinterpret_cast<uint8_t*>(&value)),
+      1);
+  uint64_t read_value = 0;
+  EXPECT_TRUE(queue->Recv(reinterpret_cast<uint8_t*>(&read_value),
+                          sizeof(read_value)));
+  EXPECT_EQ(read_value, 55);
+
+  // And in the other direction: the queue sends, the C consumer receives.
+  value = 66;
+  queue->Send(reinterpret_cast<uint8_t*>(&value), sizeof(value));
+  EXPECT_EQ(xls_shm_channel_try_recv(
+                channel, reinterpret_cast<uint8_t*>(&read_value)),
+            1);
+  EXPECT_EQ(read_value, 66);
+
+  xls_shm_channel_close(channel);
+  XLS_EXPECT_OK(ShmChannelBuffer::Unlink(name));
+}
+
+TEST(ShmJitChannelQueueTest, ManagerCreatesQueueForEveryChannel) {
+  Package package("test_package");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * streaming_channel,
+      package.CreateStreamingChannel("streaming", ChannelOps::kSendReceive,
+                                     package.GetBitsType(64)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * single_value_channel,
+      package.CreateSingleValueChannel("single_value",
+                                       ChannelOps::kSendReceive,
+                                       package.GetBitsType(64)));
+  std::string prefix = UniqueShmName("manager");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<JitChannelQueueManager> manager,
+      CreateShmJitChannelQueueManager(
+          &package, prefix,
+          [](Channel* channel) { return int64_t{8}; }, /*capacity=*/16));
+
+  XLS_ASSERT_OK_AND_ASSIGN(JitChannelQueue * streaming_queue,
+                           manager->GetQueueById(streaming_channel->id()));
+  uint64_t value = 99;
+  streaming_queue->Send(reinterpret_cast<uint8_t*>(&value), sizeof(value));
+  uint64_t read_value = 0;
+  EXPECT_TRUE(streaming_queue->Recv(reinterpret_cast<uint8_t*>(&read_value),
+                                    sizeof(read_value)));
+  EXPECT_EQ(read_value, 99);
+
+  // The single value channel gets an ordinary process-local queue.
+  XLS_ASSERT_OK_AND_ASSIGN(JitChannelQueue * single_value_queue,
+                           manager->GetQueueById(single_value_channel->id()));
+  EXPECT_TRUE(single_value_queue->Empty());
+
+  XLS_EXPECT_OK(ShmChannelBuffer::Unlink(
+      absl::StrFormat("%s_%d", prefix, streaming_channel->id())));
+}
+
+}  // namespace
+}  // namespace xls
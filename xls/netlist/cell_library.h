@@ -24,6 +24,7 @@
 #include "absl/status/statusor.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/netlist/function_parser.h"
 #include "xls/netlist/netlist.pb.h"
 
 namespace xls {
@@ -209,6 +210,14 @@ class AbstractCellLibraryEntry {
   }
   std::optional<std::string> clock_name() const { return clock_name_; }
 
+  // Returns the preprocessed parse of the given pin's function, or nullptr if
+  // the library this entry was built from did not carry one (e.g. when parsing
+  // a raw Liberty file). Consumers fall back to parsing the function string.
+  const function::Ast* GetPinFunctionAst(absl::string_view pin_name) const {
+    auto it = output_pin_to_ast_.find(pin_name);
+    return it == output_pin_to_ast_.end() ? nullptr : &it->second;
+  }
+
   absl::StatusOr<CellLibraryEntryProto> ToProto() const;
 
  private:
@@ -216,6 +225,9 @@ class AbstractCellLibraryEntry {
   std::string name_;
   std::vector<std::string> input_names_;
   OutputPinToFunction output_pin_to_function_;
+  // Preprocessed parses of output_pin_to_function_ entries, keyed by pin name.
+  // Populated from OutputPinProto.parsed_function when present.
+  absl::flat_hash_map<std::string, function::Ast> output_pin_to_ast_;
   std::optional<AbstractStateTable<EvalT>> state_table_;
   std::optional<std::string> clock_name_;
 };
@@ -507,8 +519,16 @@ AbstractCellLibraryEntry<EvalT>::FromProto(const CellLibraryEntryProto& proto,
                                           proto.state_table(), zero, one));
   }
 
-  return AbstractCellLibraryEntry(cell_kind, proto.name(), proto.input_names(),
-                                  pins, state_table);
+  AbstractCellLibraryEntry entry(cell_kind, proto.name(), proto.input_names(),
+                                 pins, state_table);
+  for (const auto& pin_proto : output_pin_list.pins()) {
+    if (pin_proto.has_parsed_function()) {
+      XLS_ASSIGN_OR_RETURN(function::Ast ast,
+                           function::AstFromProto(pin_proto.parsed_function()));
+      entry.output_pin_to_ast_.emplace(pin_proto.name(), std::move(ast));
+    }
+  }
+  return entry;
 }
 
 template <typename EvalT>
@@ -555,6 +575,11 @@ absl::StatusOr<CellLibraryEntryProto> AbstractCellLibraryEntry<EvalT>::ToProto()
     OutputPinProto* pin_proto = pin_list->add_pins();
     pin_proto->set_name(kv.first);
     pin_proto->set_function(kv.second);
+    auto ast_it = output_pin_to_ast_.find(kv.first);
+    if (ast_it != output_pin_to_ast_.end()) {
+      *pin_proto->mutable_parsed_function() =
+          function::AstToProto(ast_it->second);
+    }
   }
   return proto;
 }
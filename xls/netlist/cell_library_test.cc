@@ -57,6 +57,46 @@ TEST(CellLibraryTest, SerializeToProto) {
   EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(proto, expected_proto));
 }
 
+// A preprocessed library carries parsed pin functions; FromProto should
+// surface them via GetPinFunctionAst without any parsing.
+TEST(CellLibraryTest, FromProtoCarriesParsedFunctions) {
+  std::string proto_text = R"(entries {
+  kind: OTHER
+  name: "or2"
+  input_names: "A"
+  input_names: "B"
+  output_pin_list {
+    pins {
+      name: "Z"
+      function: "A+B"
+      parsed_function {
+        kind: AST_OR
+        children { kind: AST_IDENTIFIER name: "A" }
+        children { kind: AST_IDENTIFIER name: "B" }
+      }
+    }
+  }
+}
+)";
+  CellLibraryProto proto;
+  ASSERT_TRUE(TextFormat::ParseFromString(proto_text, &proto));
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library,
+                           CellLibrary::FromProto(proto));
+  XLS_ASSERT_OK_AND_ASSIGN(const CellLibraryEntry* entry,
+                           cell_library.GetEntry("or2"));
+  const function::Ast* ast = entry->GetPinFunctionAst("Z");
+  ASSERT_NE(ast, nullptr);
+  EXPECT_EQ(ast->kind(), function::Ast::Kind::kOr);
+  ASSERT_EQ(ast->children().size(), 2);
+  EXPECT_EQ(ast->children()[0].name(), "A");
+  EXPECT_EQ(ast->children()[1].name(), "B");
+
+  // And the parsed form round-trips back out.
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibraryProto round_tripped,
+                           cell_library.ToProto());
+  EXPECT_TRUE(MessageDifferencer::Equals(proto, round_tripped));
+}
+
 TEST(CellLibraryTest, EvaluateStateTable) {
   std::string proto_text = R"(input_names: "i0"
   input_names: "i1"
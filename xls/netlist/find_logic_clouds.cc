@@ -14,10 +14,18 @@
 
 #include "xls/netlist/find_logic_clouds.h"
 
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "xls/common/logging/logging.h"
-#include "xls/data_structures/union_find.h"
+#include "xls/common/thread.h"
+#include "xls/data_structures/concurrent_union_find.h"
 
 namespace xls {
 namespace netlist {
@@ -41,88 +49,117 @@ void Cluster::SortCells() {
 
 std::vector<Cluster> FindLogicClouds(const Module& module,
                                      bool include_vacuous) {
-  UnionFind<Cell*> cell_to_uf;
-
-  // Gets-or-adds the given cell to the UnionFind.
-  auto get_uf = [&cell_to_uf](Cell* c) -> Cell* {
-    cell_to_uf.Insert(c);
-    return cell_to_uf.Find(c);
-  };
-
-  // Helper for debugging that counts the number of equivalence classes in
-  // cell_to_uf.
-  auto count_equivalence_classes = [&cell_to_uf]() -> int64_t {
-    return cell_to_uf.GetRepresentatives().size();
-  };
-
+  // Assign each cell a dense index so the edge scan can run on a concurrent
+  // union-find over a contiguous parent array.
+  std::vector<Cell*> cells;
+  cells.reserve(module.cells().size());
+  absl::flat_hash_map<Cell*, int64_t> cell_index;
+  cell_index.reserve(module.cells().size());
   for (auto& item : module.cells()) {
-    Cell* cell = item.get();
-    XLS_VLOG(4) << "Considering cell: " << cell->name();
-
-    // Flop output connectivity is excluded from the equivalence class, so we
-    // get partitions along flop (output) boundaries.
-    if (cell->kind() == CellKind::kFlop) {
-      // For flops we just make sure an equivalence class is present in the
-      // map, in case it doesn't have any cells on the input side.
-      get_uf(cell);
-      XLS_VLOG(4) << "--- Now " << count_equivalence_classes()
-                  << " equivalence classes for " << cell_to_uf.size()
-                  << " cells.";
-      continue;
-    }
+    cell_index.emplace(item.get(), cells.size());
+    cells.push_back(item.get());
+  }
 
-    for (auto& input : cell->inputs()) {
-      XLS_VLOG(4) << "- Considering input net: " << input.netref->name();
-      for (Cell* connected : input.netref->connected_cells()) {
-        if (cell == connected) {
-          continue;
-        }
-        if (connected->kind() == CellKind::kFlop) {
+  ConcurrentUnionFind cell_to_uf(cells.size());
+
+  // Processes the connectivity of cells [begin, end). Flop output
+  // connectivity is excluded from the equivalence class, so we get partitions
+  // along flop (output) boundaries: flops contribute no edges of their own
+  // (they keep their singleton class unless a driving cell merges them via an
+  // output net below).
+  auto process_cells = [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      Cell* cell = cells[i];
+      XLS_VLOG(4) << "Considering cell: " << cell->name();
+      if (cell->kind() == CellKind::kFlop) {
+        continue;
+      }
+
+      for (auto& input : cell->inputs()) {
+        XLS_VLOG(4) << "- Considering input net: " << input.netref->name();
+        for (Cell* connected : input.netref->connected_cells()) {
+          if (cell == connected) {
+            continue;
+          }
+          if (connected->kind() == CellKind::kFlop) {
+            XLS_VLOG(4) << absl::StreamFormat(
+                "-- Cell is connected to flop cell %s on an input pin; not "
+                "merging equivalence classes.",
+                connected->name());
+            continue;
+          }
           XLS_VLOG(4) << absl::StreamFormat(
-              "-- Cell is connected to flop cell %s on an input pin; not "
-              "merging equivalence classes.",
+              "-- Cell %s is connected to cell %s", cell->name(),
               connected->name());
-          continue;
+          cell_to_uf.Union(i, cell_index.at(connected));
         }
-        XLS_VLOG(4) << absl::StreamFormat("-- Cell %s is connected to cell %s",
-                                          cell->name(), connected->name());
-        cell_to_uf.Union(get_uf(cell), get_uf(connected));
-        XLS_VLOG(4) << "--- Now " << count_equivalence_classes()
-                    << " equivalence classes for " << cell_to_uf.size()
-                    << " cells.";
       }
-    }
 
-    for (const auto& iter : cell->outputs()) {
-      NetRef output = iter.netref;
-      XLS_VLOG(4) << "- Considering output net: " << output->name();
-      for (Cell* connected : output->connected_cells()) {
-        if (cell == connected) {
-          continue;
+      for (const auto& iter : cell->outputs()) {
+        NetRef output = iter.netref;
+        XLS_VLOG(4) << "- Considering output net: " << output->name();
+        for (Cell* connected : output->connected_cells()) {
+          if (cell == connected) {
+            continue;
+          }
+          XLS_VLOG(4) << absl::StreamFormat(
+              "-- Cell %s is connected to cell %s", cell->name(),
+              connected->name());
+          cell_to_uf.Union(i, cell_index.at(connected));
         }
-        XLS_VLOG(4) << absl::StreamFormat("-- Cell %s is connected to cell %s",
-                                          cell->name(), connected->name());
-        cell_to_uf.Union(get_uf(cell), get_uf(connected));
-        XLS_VLOG(4) << "--- Now " << count_equivalence_classes()
-                    << " equivalence classes for " << cell_to_uf.size()
-                    << " cells.";
       }
     }
-  }
+  };
 
-  // Run through the cells and put them into clusters according to their
-  // equivalence classes.
-  absl::flat_hash_map<Cell*, Cluster> equivalence_set_to_cluster;
-  for (auto& item : module.cells()) {
-    Cell* cell = item.get();
-    equivalence_set_to_cluster[get_uf(cell)].Add(cell);
+  // Union-find construction is commutative, so the cell range can be split
+  // across worker threads; the concurrent union-find roots every class at its
+  // smallest cell index regardless of interleaving, keeping results
+  // deterministic.
+  const int64_t num_threads = std::max<int64_t>(
+      1, std::min<int64_t>(std::thread::hardware_concurrency(),
+                           static_cast<int64_t>(cells.size())));
+  if (num_threads <= 1) {
+    process_cells(0, cells.size());
+  } else {
+    std::vector<std::unique_ptr<Thread>> workers;
+    const int64_t chunk_size = (cells.size() + num_threads - 1) / num_threads;
+    for (int64_t begin = 0; begin < static_cast<int64_t>(cells.size());
+         begin += chunk_size) {
+      const int64_t end =
+          std::min<int64_t>(begin + chunk_size, cells.size());
+      workers.push_back(std::make_unique<Thread>(
+          [&process_cells, begin, end] { process_cells(begin, end); }));
+    }
+    for (auto& worker : workers) {
+      worker->Join();
+    }
   }
 
-  // Put them into a vector and sort each cluster's internal cells for
-  // determinism.
+  // Order cells by (equivalence class, index) so each cluster's members
+  // occupy a contiguous run and clusters can be emitted with a single pass.
+  std::vector<std::pair<int64_t, int64_t>> class_and_index(cells.size());
+  for (int64_t i = 0; i < static_cast<int64_t>(cells.size()); ++i) {
+    class_and_index[i] = {cell_to_uf.Find(i), i};
+  }
+  std::sort(class_and_index.begin(), class_and_index.end());
+  XLS_VLOG(4) << "Found "
+              << std::count_if(class_and_index.begin(), class_and_index.end(),
+                               [&](const std::pair<int64_t, int64_t>& ci) {
+                                 return ci.first == ci.second;
+                               })
+              << " equivalence classes for " << cell_to_uf.size() << " cells.";
+
+  // Run through the contiguous runs and put the cells into clusters, sorting
+  // each cluster's internal cells for determinism.
   std::vector<Cluster> clusters;
-  for (auto& item : equivalence_set_to_cluster) {
-    Cluster& cluster = item.second;
+  for (int64_t pos = 0; pos < static_cast<int64_t>(class_and_index.size());) {
+    const int64_t equivalence_class = class_and_index[pos].first;
+    Cluster cluster;
+    for (; pos < static_cast<int64_t>(class_and_index.size()) &&
+           class_and_index[pos].first == equivalence_class;
+         ++pos) {
+      cluster.Add(cells[class_and_index[pos].second]);
+    }
     if (!include_vacuous && (cluster.terminating_flops().size() == 1 &&
                              cluster.other_cells().empty())) {
       // Vacuous 'just a flop' cluster.
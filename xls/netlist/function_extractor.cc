@@ -23,6 +23,7 @@
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/netlist/function_parser.h"
 #include "xls/netlist/lib_parser.h"
 #include "xls/netlist/netlist.pb.h"
 
@@ -208,6 +209,10 @@ absl::Status ExtractFromPin(const cell_lib::Block& pin,
       // Ignore them for now (during baseline dev). If they turn out to be
       // important, I'll circle back.
       output_pin->set_function(function);
+      // Preprocess the function here, once, so library consumers don't have
+      // to re-parse every pin function at load time.
+      XLS_ASSIGN_OR_RETURN(Ast ast, Parser::ParseFunction(function));
+      *output_pin->mutable_parsed_function() = AstToProto(ast);
     }
   } else {
     entry_proto->add_input_names(name);
@@ -230,8 +235,12 @@ absl::Status ExtractFromFf(const cell_lib::Block& ff,
     if (kv_entry && kv_entry->key == kNextStateKey) {
       std::string next_state_function = kv_entry->value;
       XLS_RET_CHECK(entry_proto->output_pin_list().pins_size() == 1);
-      entry_proto->mutable_output_pin_list()->mutable_pins(0)->set_function(
-          next_state_function);
+      OutputPinProto* output_pin =
+          entry_proto->mutable_output_pin_list()->mutable_pins(0);
+      output_pin->set_function(next_state_function);
+      XLS_ASSIGN_OR_RETURN(Ast ast,
+                           Parser::ParseFunction(next_state_function));
+      *output_pin->mutable_parsed_function() = AstToProto(ast);
     }
   }
 
@@ -101,6 +101,16 @@ library (blah) {
   OutputPinProto output_pin = entry.output_pin_list().pins(0);
   ASSERT_EQ(output_pin.name(), "q");
   ASSERT_EQ(output_pin.function(), "i0|i1");
+
+  // The extractor preprocesses pin functions into their parsed form.
+  ASSERT_TRUE(output_pin.has_parsed_function());
+  const FunctionAstProto& ast = output_pin.parsed_function();
+  ASSERT_EQ(ast.kind(), FunctionAstProto::AST_OR);
+  ASSERT_EQ(ast.children_size(), 2);
+  EXPECT_EQ(ast.children(0).kind(), FunctionAstProto::AST_IDENTIFIER);
+  EXPECT_EQ(ast.children(0).name(), "i0");
+  EXPECT_EQ(ast.children(1).kind(), FunctionAstProto::AST_IDENTIFIER);
+  EXPECT_EQ(ast.children(1).name(), "i1");
 }
 
 TEST(FunctionExtractorTest, HandlesStatetables) {
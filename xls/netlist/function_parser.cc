@@ -339,6 +339,71 @@ absl::StatusOr<Ast> Parser::ParseTerm() {
   }
 }
 
+FunctionAstProto AstToProto(const Ast& ast) {
+  FunctionAstProto proto;
+  switch (ast.kind()) {
+    case Ast::Kind::kIdentifier:
+      proto.set_kind(FunctionAstProto::AST_IDENTIFIER);
+      proto.set_name(ast.name());
+      break;
+    case Ast::Kind::kLiteralZero:
+      proto.set_kind(FunctionAstProto::AST_LITERAL_ZERO);
+      break;
+    case Ast::Kind::kLiteralOne:
+      proto.set_kind(FunctionAstProto::AST_LITERAL_ONE);
+      break;
+    case Ast::Kind::kAnd:
+      proto.set_kind(FunctionAstProto::AST_AND);
+      break;
+    case Ast::Kind::kOr:
+      proto.set_kind(FunctionAstProto::AST_OR);
+      break;
+    case Ast::Kind::kXor:
+      proto.set_kind(FunctionAstProto::AST_XOR);
+      break;
+    case Ast::Kind::kNot:
+      proto.set_kind(FunctionAstProto::AST_NOT);
+      break;
+  }
+  for (const Ast& child : ast.children()) {
+    *proto.add_children() = AstToProto(child);
+  }
+  return proto;
+}
+
+absl::StatusOr<Ast> AstFromProto(const FunctionAstProto& proto) {
+  switch (proto.kind()) {
+    case FunctionAstProto::AST_IDENTIFIER:
+      return Ast::Identifier(proto.name(), /*pos=*/0);
+    case FunctionAstProto::AST_LITERAL_ZERO:
+      return Ast::LiteralZero(/*pos=*/0);
+    case FunctionAstProto::AST_LITERAL_ONE:
+      return Ast::LiteralOne(/*pos=*/0);
+    case FunctionAstProto::AST_NOT: {
+      XLS_RET_CHECK_EQ(proto.children_size(), 1);
+      XLS_ASSIGN_OR_RETURN(Ast child, AstFromProto(proto.children(0)));
+      return Ast::Not(std::move(child), /*pos=*/0);
+    }
+    case FunctionAstProto::AST_AND:
+    case FunctionAstProto::AST_OR:
+    case FunctionAstProto::AST_XOR: {
+      XLS_RET_CHECK_EQ(proto.children_size(), 2);
+      XLS_ASSIGN_OR_RETURN(Ast lhs, AstFromProto(proto.children(0)));
+      XLS_ASSIGN_OR_RETURN(Ast rhs, AstFromProto(proto.children(1)));
+      Ast::Kind kind = proto.kind() == FunctionAstProto::AST_AND
+                           ? Ast::Kind::kAnd
+                           : proto.kind() == FunctionAstProto::AST_OR
+                                 ? Ast::Kind::kOr
+                                 : Ast::Kind::kXor;
+      return Ast::BinOp(kind, std::move(lhs), std::move(rhs), /*pos=*/0);
+    }
+    default:
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Invalid function AST proto kind: %d",
+                          static_cast<int>(proto.kind())));
+  }
+}
+
 }  // namespace function
 }  // namespace netlist
 }  // namespace xls
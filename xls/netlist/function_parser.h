@@ -25,6 +25,7 @@
 
 #include "absl/status/statusor.h"
 #include "absl/types/optional.h"
+#include "xls/netlist/netlist.pb.h"
 
 namespace xls {
 namespace netlist {
@@ -170,6 +171,14 @@ class Parser {
   Scanner scanner_;
 };
 
+// Converts "ast" to its protobuf form, for inclusion in a preprocessed
+// library (see OutputPinProto.parsed_function).
+FunctionAstProto AstToProto(const Ast& ast);
+
+// Reconstructs an Ast from its protobuf form. Source positions are not
+// serialized, so reconstructed nodes report position zero.
+absl::StatusOr<Ast> AstFromProto(const FunctionAstProto& proto);
+
 }  // namespace function
 }  // namespace netlist
 }  // namespace xls
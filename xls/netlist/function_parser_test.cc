@@ -14,6 +14,8 @@
 
 #include "xls/netlist/function_parser.h"
 
+#include <functional>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "xls/common/status/matchers.h"
@@ -220,6 +222,25 @@ TEST(FunctionParserTest, LeadingAndTrailingWhitespace) {
   ASSERT_EQ(node.children()[1].kind(), Ast::Kind::kIdentifier);
 }
 
+// Verifies that an AST survives a round trip through its proto form.
+TEST(FunctionParserTest, ProtoRoundTrip) {
+  std::string function = "(A^B')+(C*!D)+1";
+  XLS_ASSERT_OK_AND_ASSIGN(auto node, Parser::ParseFunction(function));
+  XLS_ASSERT_OK_AND_ASSIGN(Ast round_tripped, AstFromProto(AstToProto(node)));
+
+  // Compare the trees structurally; positions aren't serialized.
+  std::function<void(const Ast&, const Ast&)> check_equal =
+      [&](const Ast& lhs, const Ast& rhs) {
+        ASSERT_EQ(lhs.kind(), rhs.kind());
+        ASSERT_EQ(lhs.name(), rhs.name());
+        ASSERT_EQ(lhs.children().size(), rhs.children().size());
+        for (int64_t i = 0; i < lhs.children().size(); i++) {
+          check_equal(lhs.children()[i], rhs.children()[i]);
+        }
+      };
+  check_equal(node, round_tripped);
+}
+
 }  // namespace
 }  // namespace function
 }  // namespace netlist
@@ -14,17 +14,19 @@
 #ifndef XLS_NETLIST_INTERPRETER_H_
 #define XLS_NETLIST_INTERPRETER_H_
 
-#include <deque>
+#include <bitset>
+#include <cstdint>
 #include <memory>
 #include <queue>
 #include <string>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/synchronization/mutex.h"
-#include "absl/synchronization/notification.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/common/thread.h"
@@ -99,22 +101,74 @@ class AbstractInterpreter {
       const AbstractNetRef2Value<EvalT>& inputs);
 
   // A struct to contain the state of a cell as we are processing the netlist.
-  // Initially, all cells are unsatisfied, meaning none of their input wires are
-  // ready.  A cell is satisfied when all of its inputs are marked active.  When
-  // a wire is marked active, its value is added to the relevant cell's entry's
-  // ProcessedCellState::inputs.  When all of a cell's inputs become ready,  the
-  // cell's ProcessedCellState::inputs is sent to InterpretCell.
+  // As the wires feeding a cell become ready their values are added to the
+  // cell's ProcessedCellState::inputs; when the cell's topological level is
+  // reached the accumulated inputs are sent to InterpretCell.
   struct ProcessedCellState {
-    size_t missing_wires = 0;
     AbstractNetRef2Value<EvalT> inputs;
   };
 
+  // Collects the results of the cell evaluations of one topological level.
+  // Result slots are preallocated so worker threads only write their own
+  // entry.
+  struct LevelSink {
+    bool AllDone() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+      return remaining == 0;
+    }
+
+    absl::Mutex mutex;
+    // Number of dispatched cells whose results have not yet been delivered.
+    size_t remaining ABSL_GUARDED_BY(mutex) = 0;
+    std::vector<absl::StatusOr<AbstractNetRef2Value<EvalT>>> results;
+  };
+
+  // Returns the cells of the module grouped by topological level: a cell is
+  // in level N iff the deepest cell driving one of its inputs is in level
+  // N - 1. Cells in the same level are independent and can be evaluated
+  // concurrently once all previous levels are done. The levels are computed
+  // on first use and cached for the lifetime of the interpreter; gate-level
+  // simulations evaluate the same module once per input vector.
+  absl::StatusOr<const std::vector<std::vector<rtl::AbstractCell<EvalT>*>>*>
+  GetTopologicalLevels(const rtl::AbstractModule<EvalT>* module);
+
+  // Functions of at most this many inputs are lowered to truth tables.
+  static constexpr int64_t kMaxTruthTableInputs = 8;
+
+  // A cell library function compiled on first use.  The parsed AST is always
+  // present; functions of at most kMaxTruthTableInputs inputs that reference
+  // only the cell's input pins are additionally lowered to a truth table so
+  // each evaluation of the cell is a single lookup.
+  struct CompiledCellFunction {
+    explicit CompiledCellFunction(function::Ast ast) : ast(std::move(ast)) {}
+
+    function::Ast ast;
+    bool has_table = false;
+    // Indexed by the cell's input values, with input i (in the declaration
+    // order of AbstractCellLibraryEntry::input_names()) contributing bit
+    // (1 << i).
+    std::bitset<1 << kMaxTruthTableInputs> table;
+  };
+
+  // Returns the compiled function for the given output pin of a cell library
+  // entry, parsing (and, where possible, tabulating) it on first use. Cell
+  // functions were previously re-parsed on every evaluation of every cell
+  // instance.
+  absl::StatusOr<const CompiledCellFunction*> GetCellFunction(
+      const AbstractCellLibraryEntry<EvalT>* entry,
+      const std::string& pin_name);
+
+  // Evaluates "ast" over plain booleans, with identifiers resolved against
+  // "env".  Returns an error if the AST references anything not in "env"
+  // (e.g. a state table's internal pin); such functions aren't tabulable.
+  static absl::StatusOr<bool> EvaluateWithBoolInputs(
+      const function::Ast& ast,
+      const absl::flat_hash_map<std::string, bool>& env);
+
   // Called after InterpretCell finishes, to update InterpretModule()'s local
-  // state (map of cells to ProcessedCellState, and active_wires).
+  // state (map of cells to ProcessedCellState, and the module outputs).
   void UpdateProcessedState(
       absl::flat_hash_map<rtl::AbstractCell<EvalT>*,
                           std::unique_ptr<ProcessedCellState>>& processed_cells,
-      std::deque<rtl::AbstractNetRef<EvalT>>& active_wires,
       AbstractNetRef2Value<EvalT>& module_outputs,
       const rtl::AbstractModule<EvalT>* module,
       const absl::flat_hash_set<std::string>& dump_cell_set,
@@ -136,11 +190,14 @@ class AbstractInterpreter {
   EvalT zero_;
   EvalT one_;
 
-  // Queue entries for both the input and output queues.  Going in, wires
-  // holds the inputs.  Going out, wires holds the results of InterpretCell.
+  // Queue entries for the input queue.  "wires" holds the cell's input
+  // values; the result of InterpretCell is delivered to slot "index" of
+  // "sink".
   struct QueueEntry {
     const rtl::AbstractCell<EvalT>* cell;
     AbstractNetRef2Value<EvalT> wires;
+    LevelSink* sink;
+    size_t index;
   };
 
   // The absl::Mutex input_queue_guard is used to both protect the input queue
@@ -150,19 +207,26 @@ class AbstractInterpreter {
   absl::CondVar input_queue_cond_;
   std::queue<QueueEntry> input_queue_ ABSL_GUARDED_BY(input_queue_guard_);
 
-  static bool queue_has_data(std::queue<QueueEntry>* queue) {
-    return !queue->empty();
-  }
-
-  // The absl::Mutex output_queue_guard is used to both protect the output queue
-  // shared by all the worker threads, as well as a conditional variable for the
-  // InterpretModule() to wait on for processed cells.
-  absl::Mutex output_queue_guard_;  // protects output_queue_
-  std::queue<QueueEntry> output_queue_ ABSL_GUARDED_BY(output_queue_guard_);
-
   // Thread pool.
   std::vector<std::unique_ptr<xls::Thread>> threads_;
 
+  // Cache of per-module topological levels, computed on first interpretation
+  // of a module. The level vectors are heap-allocated so that handed-out
+  // pointers survive rehashing of the map.
+  absl::Mutex levels_mutex_;
+  absl::flat_hash_map<const rtl::AbstractModule<EvalT>*,
+                      std::unique_ptr<std::vector<
+                          std::vector<rtl::AbstractCell<EvalT>*>>>>
+      levels_cache_ ABSL_GUARDED_BY(levels_mutex_);
+
+  // Cache of compiled cell functions keyed by cell library entry and output
+  // pin name.
+  absl::Mutex function_cache_mutex_;
+  absl::flat_hash_map<
+      const AbstractCellLibraryEntry<EvalT>*,
+      absl::flat_hash_map<std::string, std::unique_ptr<CompiledCellFunction>>>
+      function_cache_ ABSL_GUARDED_BY(function_cache_mutex_);
+
   // Keeps track of threads blocked on the input_queue_, ready to get a
   // dispatch.  The counter is atomic by itself, but it also needs to be updated
   // in sync with a thread blocking on the input queue, which is why it's also
@@ -178,7 +242,6 @@ template <typename EvalT>
 void AbstractInterpreter<EvalT>::UpdateProcessedState(
     absl::flat_hash_map<rtl::AbstractCell<EvalT>*,
                         std::unique_ptr<ProcessedCellState>>& processed_cells,
-    std::deque<rtl::AbstractNetRef<EvalT>>& active_wires,
     AbstractNetRef2Value<EvalT>& module_outputs,
     const rtl::AbstractModule<EvalT>* module,
     const absl::flat_hash_set<std::string>& dump_cell_set,
@@ -188,7 +251,6 @@ void AbstractInterpreter<EvalT>::UpdateProcessedState(
 
   for (auto wire_val : wires) {
     rtl::AbstractNetRef<EvalT> wire = wire_val.first;
-    active_wires.push_back(wire);
     // Is this wire connected to any cells?  If so, add its value to these cells
     // inputs.  If not connected to any cells, then it's either floating or a
     // module output.
@@ -236,46 +298,30 @@ AbstractInterpreter<EvalT>::InterpretModule(
   AbstractNetRef2Value<EvalT> outputs;
   outputs.reserve(module->outputs().size());
 
-  // Do a topological sort through all cells, evaluating each as its inputs are
-  // fully satisfied, and store those results with each output wire.
+  // Group the module's cells by topological level (computed once per module
+  // and cached), then evaluate the levels in order.  Cells within a level are
+  // independent of one another, so they can be farmed out to the worker
+  // threads wholesale.
+  XLS_ASSIGN_OR_RETURN(
+      const std::vector<std::vector<rtl::AbstractCell<EvalT>*>>* levels,
+      GetTopologicalLevels(module));
 
   absl::flat_hash_map<rtl::AbstractCell<EvalT>*,
                       std::unique_ptr<ProcessedCellState>>
       processed_cells;
-
-  // The set of wires that have been "activated" (whose source cells have been
-  // processed) but not yet processed.
-  std::deque<rtl::AbstractNetRef<EvalT>> active_wires;
-
-  absl::flat_hash_set<std::string> dump_cell_set(dump_cells.begin(),
-                                                 dump_cells.end());
-
-  // First, populate the unsatisfied cell list.
   for (const auto& cell : module->cells()) {
-    // if a cell has no inputs, it's active, so process it now.
-    auto pcs = std::make_unique<ProcessedCellState>();
-    if (cell->inputs().empty()) {
-      XLS_ASSIGN_OR_RETURN(AbstractNetRef2Value<EvalT> results,
-                           InterpretCell(cell.get(), {}));
-      processed_cells[cell.get()] = std::move(pcs);
-      UpdateProcessedState(processed_cells, active_wires, outputs, module,
-                           dump_cell_set, cell.get(), results);
-    } else {
-      pcs->missing_wires = cell->inputs().size();
-      processed_cells[cell.get()] = std::move(pcs);
-    }
+    processed_cells[cell.get()] = std::make_unique<ProcessedCellState>();
   }
 
-  // Set all inputs as "active".
-  for (const rtl::AbstractNetRef<EvalT> ref : module->inputs()) {
-    active_wires.push_back(ref);
-  }
+  absl::flat_hash_set<std::string> dump_cell_set(dump_cells.begin(),
+                                                 dump_cells.end());
 
+  // Feed the module inputs to the cells they're connected to.
   for (const auto& input : inputs) {
     rtl::AbstractNetRef<EvalT> wire = input.first;
     for (const auto cell : wire->connected_cells()) {
       XLS_CHECK(processed_cells.contains(cell));
-      processed_cells[cell]->inputs.insert({wire, std::move(input.second)});
+      processed_cells[cell]->inputs.insert({wire, input.second});
     }
     if constexpr (std::is_convertible<EvalT, int>()) {
       XLS_VLOG(2) << "Input : " << input.first->name() << " : "
@@ -283,77 +329,64 @@ AbstractInterpreter<EvalT>::InterpretModule(
     }
   }
 
-  // Process all active wires : see if this wire satisfies all of a cell's
-  // inputs. If so, interpret the cell, and place its outputs on the active wire
-  // list.  When running multi-threaded, active_wires may be empty, but as long
-  // as num_pending_outputs > 0, it means we expect to get that many
-  // additional wires activated.  Thus we exit the loop only when active_wires
-  // is empty and there are no pending outputs.
-  size_t num_pending_outputs = 0;
-  while (!active_wires.empty() || num_pending_outputs > 0) {
-    // Drain the output queue as much as we can until we get some active wires,
-    // so that we can proceed.
-    while (active_wires.empty()) {
-      output_queue_guard_.LockWhen(
-          absl::Condition(queue_has_data, &output_queue_));
-      while (!output_queue_.empty()) {
-        QueueEntry entry = std::move(output_queue_.front());
-        output_queue_.pop();
-        output_queue_guard_.Unlock();
-        num_pending_outputs--;
-        UpdateProcessedState(processed_cells, active_wires, outputs, module,
-                             dump_cell_set, entry.cell, entry.wires);
-        output_queue_guard_.Lock();
+  for (const std::vector<rtl::AbstractCell<EvalT>*>& level : *levels) {
+    LevelSink sink;
+    sink.results.resize(level.size());
+    for (size_t i = 0; i < level.size(); ++i) {
+      rtl::AbstractCell<EvalT>* cell = level[i];
+      ProcessedCellState* processed_cell_state = processed_cells[cell].get();
+      AbstractNetRef2Value<EvalT> cell_inputs;
+      if (dump_cell_set.contains(cell->name())) {
+        // Keep the accumulated inputs around so they can be dumped after the
+        // cell has been evaluated.
+        cell_inputs = processed_cell_state->inputs;
+      } else {
+        cell_inputs = std::move(processed_cell_state->inputs);
       }
-      output_queue_guard_.Unlock();
-    }
-
-    rtl::AbstractNetRef<EvalT> wire = active_wires.front();
-    active_wires.pop_front();
-    XLS_VLOG(2) << "Processing wire: " << wire->name();
 
-    for (const auto cell : wire->connected_input_cells()) {
-      auto processed_cell_state = processed_cells[cell].get();
-      XLS_CHECK_GT(processed_cell_state->missing_wires, 0);
-      processed_cell_state->missing_wires--;
-      if (processed_cell_state->missing_wires == 0) {
-        // TODO: Only fall back to this thread if no available threads and next
-        // cell is a module.  Right now we fall back to the main thread only
-        // when the workers are all busy, but that may be suboptimal if
-        // InterpretCell() is slow.  Ideally, we want to use this thread to
-        // process InterpretCell only if the cell is itself a Module, there is
-        // only one worker thread left, and all other threads are processing
-        // modules as well.
-        if (!threads_.empty() && num_available_threads_.load() > 0) {
-          input_queue_guard_.Lock();
+      // TODO: Only fall back to this thread if no available threads and next
+      // cell is a module.  Right now we fall back to the main thread only
+      // when the workers are all busy, but that may be suboptimal if
+      // InterpretCell() is slow.  Ideally, we want to use this thread to
+      // process InterpretCell only if the cell is itself a Module, there is
+      // only one worker thread left, and all other threads are processing
+      // modules as well.
+      bool dispatched = false;
+      if (!threads_.empty()) {
+        input_queue_guard_.Lock();
+        if (num_available_threads_.load() > 0) {
+          num_available_threads_--;
+          {
+            absl::MutexLock lock(&sink.mutex);
+            sink.remaining++;
+          }
           QueueEntry entry;
           entry.cell = cell;
-          entry.wires = std::move(processed_cell_state->inputs);
+          entry.wires = std::move(cell_inputs);
+          entry.sink = &sink;
+          entry.index = i;
           input_queue_.push(std::move(entry));
           input_queue_cond_.Signal();
-          num_available_threads_--;
-          num_pending_outputs++;
-          input_queue_guard_.Unlock();
-          XLS_VLOG(2) << "Dispatched cell: " << cell->name();
-        } else {
-          XLS_VLOG(2) << "Processing locally cell: " << cell->name();
-          XLS_ASSIGN_OR_RETURN(
-              auto results, InterpretCell(cell, processed_cell_state->inputs));
-          UpdateProcessedState(processed_cells, active_wires, outputs, module,
-                               dump_cell_set, cell, results);
+          dispatched = true;
         }
+        input_queue_guard_.Unlock();
+      }
+      if (dispatched) {
+        XLS_VLOG(2) << "Dispatched cell: " << cell->name();
+      } else {
+        XLS_VLOG(2) << "Processing locally cell: " << cell->name();
+        sink.results[i] = InterpretCell(cell, cell_inputs);
       }
     }
-  }
 
-  // Soundness check that we've processed all cells (i.e., that there aren't
-  // unsatisfiable cells).
-  for (const auto& cell : module->cells()) {
-    if (processed_cells[cell.get()]->missing_wires > 0) {
-      return absl::InvalidArgumentError(absl::StrFormat(
-          "Netlist contains unconnected subgraphs and cannot be translated. "
-          "Example: cell %s",
-          cell->name()));
+    // Wait for the dispatched cells of this level, then fold all results into
+    // the local state in level order so evaluation stays deterministic.
+    sink.mutex.LockWhen(absl::Condition(&sink, &LevelSink::AllDone));
+    sink.mutex.Unlock();
+    for (size_t i = 0; i < level.size(); ++i) {
+      XLS_RETURN_IF_ERROR(sink.results[i].status());
+      UpdateProcessedState(processed_cells, outputs, module, dump_cell_set,
+                           level[i], sink.results[i].value());
     }
   }
 
@@ -460,7 +493,6 @@ AbstractInterpreter<EvalT>::InterpretCell(
     return results;
   }
 
-  const auto& pins = entry->output_pin_to_function();
   for (int i = 0; i < cell->outputs().size(); i++) {
     if (cell->outputs()[i].eval != nullptr) {
       // The order of values in cell->inputs() is the same as the order of
@@ -473,10 +505,25 @@ AbstractInterpreter<EvalT>::InterpretCell(
       XLS_ASSIGN_OR_RETURN(EvalT value, cell->outputs()[i].eval(args));
       results.insert({cell->outputs()[i].netref, value});
     } else {
-      XLS_ASSIGN_OR_RETURN(
-          function::Ast ast,
-          function::Parser::ParseFunction(pins.at(cell->outputs()[i].name)));
-      XLS_ASSIGN_OR_RETURN(EvalT value, InterpretFunction(*cell, ast, inputs));
+      XLS_ASSIGN_OR_RETURN(const CompiledCellFunction* function,
+                           GetCellFunction(entry, cell->outputs()[i].name));
+      if constexpr (std::is_convertible_v<EvalT, bool>) {
+        if (function->has_table) {
+          // cell->inputs() is in the same order as the entry's input_names(),
+          // which is the order the truth table was built in.
+          uint32_t index = 0;
+          for (int64_t j = 0; j < cell->inputs().size(); ++j) {
+            if (static_cast<bool>(inputs.at(cell->inputs()[j].netref))) {
+              index |= uint32_t{1} << j;
+            }
+          }
+          results.insert({cell->outputs()[i].netref,
+                          function->table[index] ? one_ : zero_});
+          continue;
+        }
+      }
+      XLS_ASSIGN_OR_RETURN(EvalT value,
+                           InterpretFunction(*cell, function->ast, inputs));
       results.insert({cell->outputs()[i].netref, value});
     }
   }
@@ -484,6 +531,185 @@ AbstractInterpreter<EvalT>::InterpretCell(
   return results;
 }
 
+template <typename EvalT>
+absl::StatusOr<const std::vector<std::vector<rtl::AbstractCell<EvalT>*>>*>
+AbstractInterpreter<EvalT>::GetTopologicalLevels(
+    const rtl::AbstractModule<EvalT>* module) {
+  absl::MutexLock lock(&levels_mutex_);
+  auto it = levels_cache_.find(module);
+  if (it != levels_cache_.end()) {
+    return it->second.get();
+  }
+
+  // Kahn's algorithm over the cell graph: a cell is ready once every wire
+  // feeding it has been driven, either by a module input or by a cell placed
+  // in an earlier level.  Note that connected_input_cells() lists a cell once
+  // per input pin the wire is attached to, matching the per-pin counters.
+  std::vector<std::vector<rtl::AbstractCell<EvalT>*>> levels;
+  absl::flat_hash_map<rtl::AbstractCell<EvalT>*, int64_t> missing_wires;
+  std::vector<rtl::AbstractCell<EvalT>*> current;
+  for (const auto& cell : module->cells()) {
+    if (cell->inputs().empty()) {
+      current.push_back(cell.get());
+    } else {
+      missing_wires[cell.get()] = cell->inputs().size();
+    }
+  }
+
+  auto activate_wire = [&](const rtl::AbstractNetRef<EvalT> wire,
+                           std::vector<rtl::AbstractCell<EvalT>*>& ready) {
+    for (const auto cell : wire->connected_input_cells()) {
+      int64_t& missing = missing_wires.at(cell);
+      XLS_CHECK_GT(missing, 0);
+      missing--;
+      if (missing == 0) {
+        ready.push_back(cell);
+      }
+    }
+  };
+
+  // Module inputs are driven before any cell is evaluated, so cells satisfied
+  // by them alone join the no-input cells in level 0.
+  for (const rtl::AbstractNetRef<EvalT> ref : module->inputs()) {
+    activate_wire(ref, current);
+  }
+
+  size_t num_leveled = 0;
+  while (!current.empty()) {
+    std::vector<rtl::AbstractCell<EvalT>*> next;
+    for (rtl::AbstractCell<EvalT>* cell : current) {
+      for (const auto& output : cell->outputs()) {
+        activate_wire(output.netref, next);
+      }
+    }
+    num_leveled += current.size();
+    levels.push_back(std::move(current));
+    current = std::move(next);
+  }
+
+  // Soundness check that we've leveled all cells (i.e., that there aren't
+  // unsatisfiable cells).
+  if (num_leveled != module->cells().size()) {
+    for (const auto& cell : module->cells()) {
+      auto missing_it = missing_wires.find(cell.get());
+      if (missing_it != missing_wires.end() && missing_it->second > 0) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "Netlist contains unconnected subgraphs and cannot be translated. "
+            "Example: cell %s",
+            cell->name()));
+      }
+    }
+  }
+
+  auto inserted = levels_cache_.emplace(
+      module,
+      std::make_unique<std::vector<std::vector<rtl::AbstractCell<EvalT>*>>>(
+          std::move(levels)));
+  return inserted.first->second.get();
+}
+
+template <typename EvalT>
+absl::StatusOr<bool> AbstractInterpreter<EvalT>::EvaluateWithBoolInputs(
+    const function::Ast& ast,
+    const absl::flat_hash_map<std::string, bool>& env) {
+  switch (ast.kind()) {
+    case function::Ast::Kind::kAnd: {
+      XLS_ASSIGN_OR_RETURN(bool lhs,
+                           EvaluateWithBoolInputs(ast.children()[0], env));
+      XLS_ASSIGN_OR_RETURN(bool rhs,
+                           EvaluateWithBoolInputs(ast.children()[1], env));
+      return lhs & rhs;
+    }
+    case function::Ast::Kind::kIdentifier: {
+      auto it = env.find(ast.name());
+      if (it == env.end()) {
+        return absl::NotFoundError(absl::StrFormat(
+            "Identifier \"%s\" is not a cell input pin.", ast.name()));
+      }
+      return it->second;
+    }
+    case function::Ast::Kind::kLiteralOne:
+      return true;
+    case function::Ast::Kind::kLiteralZero:
+      return false;
+    case function::Ast::Kind::kNot: {
+      XLS_ASSIGN_OR_RETURN(bool value,
+                           EvaluateWithBoolInputs(ast.children()[0], env));
+      return !value;
+    }
+    case function::Ast::Kind::kOr: {
+      XLS_ASSIGN_OR_RETURN(bool lhs,
+                           EvaluateWithBoolInputs(ast.children()[0], env));
+      XLS_ASSIGN_OR_RETURN(bool rhs,
+                           EvaluateWithBoolInputs(ast.children()[1], env));
+      return lhs | rhs;
+    }
+    case function::Ast::Kind::kXor: {
+      XLS_ASSIGN_OR_RETURN(bool lhs,
+                           EvaluateWithBoolInputs(ast.children()[0], env));
+      XLS_ASSIGN_OR_RETURN(bool rhs,
+                           EvaluateWithBoolInputs(ast.children()[1], env));
+      return lhs ^ rhs;
+    }
+    default:
+      return absl::InvalidArgumentError(
+          absl::StrCat("Unknown AST element type: ", ast.kind()));
+  }
+}
+
+template <typename EvalT>
+absl::StatusOr<
+    const typename AbstractInterpreter<EvalT>::CompiledCellFunction*>
+AbstractInterpreter<EvalT>::GetCellFunction(
+    const AbstractCellLibraryEntry<EvalT>* entry, const std::string& pin_name) {
+  absl::MutexLock lock(&function_cache_mutex_);
+  auto& pin_map = function_cache_[entry];
+  auto it = pin_map.find(pin_name);
+  if (it == pin_map.end()) {
+    // Preprocessed libraries carry the parsed function; only raw Liberty
+    // libraries require parsing the function string here.
+    std::unique_ptr<CompiledCellFunction> function;
+    if (const function::Ast* preparsed = entry->GetPinFunctionAst(pin_name)) {
+      function = std::make_unique<CompiledCellFunction>(*preparsed);
+    } else {
+      XLS_ASSIGN_OR_RETURN(function::Ast ast,
+                           function::Parser::ParseFunction(
+                               entry->output_pin_to_function().at(pin_name)));
+      function = std::make_unique<CompiledCellFunction>(std::move(ast));
+    }
+
+    // Lower small, purely-combinational functions to a truth table.  The
+    // lookup only pays off when input values can be turned into an index, so
+    // skip tabulation for opaque value types.
+    if constexpr (std::is_convertible_v<EvalT, bool>) {
+      absl::Span<const std::string> input_names = entry->input_names();
+      if (input_names.size() <= kMaxTruthTableInputs) {
+        bool tabulable = true;
+        absl::flat_hash_map<std::string, bool> env;
+        for (uint32_t index = 0; index < (uint32_t{1} << input_names.size());
+             ++index) {
+          for (int64_t i = 0; i < input_names.size(); ++i) {
+            env[input_names[i]] = ((index >> i) & 1) != 0;
+          }
+          absl::StatusOr<bool> value =
+              EvaluateWithBoolInputs(function->ast, env);
+          if (!value.ok()) {
+            // The function references something beyond the cell's input pins
+            // (e.g. a state table signal); keep interpreting its AST.
+            tabulable = false;
+            break;
+          }
+          function->table[index] = *value;
+        }
+        function->has_table = tabulable;
+      }
+    }
+
+    it = pin_map.emplace(pin_name, std::move(function)).first;
+  }
+  return it->second.get();
+}
+
 template <typename EvalT>
 absl::Status AbstractInterpreter<EvalT>::ThreadBody() {
   while (true) {
@@ -496,17 +722,17 @@ absl::Status AbstractInterpreter<EvalT>::ThreadBody() {
       input_queue_guard_.Unlock();
       break;
     }
-    QueueEntry entry = input_queue_.front();
+    QueueEntry entry = std::move(input_queue_.front());
     input_queue_.pop();
     input_queue_guard_.Unlock();
 
-    XLS_ASSIGN_OR_RETURN(auto results,
-                         InterpretCell(entry.cell, std::move(entry.wires)));
+    absl::StatusOr<AbstractNetRef2Value<EvalT>> result =
+        InterpretCell(entry.cell, entry.wires);
 
-    entry.wires = std::move(results);
-    output_queue_guard_.Lock();
-    output_queue_.push(entry);
-    output_queue_guard_.Unlock();
+    // Deliver the result to the level sink slot reserved for this cell.
+    absl::MutexLock lock(&entry.sink->mutex);
+    entry.sink->results[entry.index] = std::move(result);
+    entry.sink->remaining--;
   }
 
   return absl::OkStatus();
@@ -462,6 +462,14 @@ TEST(NetlistParserTest, XorUsingCellFunctions) {
       true);
 }
 
+// Evaluates the same netlist with a thread pool; cells within a topological
+// level are dispatched to worker threads.
+TEST(NetlistParserTest, XorUsingCellFunctionsMultiThreaded) {
+  TestXorUsing<bool>(
+      std::string(liberty_src), [](bool x) -> bool { return x; }, {}, false,
+      true, /*num_threads=*/4);
+}
+
 class OpaqueBoolValue {
  public:
   OpaqueBoolValue(const OpaqueBoolValue& rhs) : value_(rhs.value_) {}
@@ -72,15 +72,20 @@ struct Pos {
 };
 
 // Represents a scanned token (that comes from scanning a character stream).
+// "value" is a view into the text being scanned; it is only valid as long as
+// that underlying buffer is alive.
 struct Token {
   TokenKind kind;
   Pos pos;
-  std::string value;
+  absl::string_view value;
 
   std::string ToString() const;
 };
 
-// Token scanner for netlist files.
+// Token scanner for netlist files. The text is not copied; it must outlive
+// the scanner and any tokens produced from it. This allows scanning directly
+// out of a memory-mapped netlist without materializing token values on the
+// heap.
 class Scanner {
  public:
   explicit Scanner(absl::string_view text) : text_(text) {}
@@ -139,13 +144,29 @@ class AbstractParser {
     return ParseNetlist(cell_library, scanner, EvalT{false}, EvalT{true});
   }
 
- private:
+  // Constructs a parser for pulling modules out of the token stream one at a
+  // time with ParseNextModule. This is the streaming alternative to
+  // ParseNetlist: consumers can start working on a module as soon as it has
+  // been scanned instead of waiting for the whole (possibly multi-gigabyte)
+  // file, and the scanner can read out of a memory-mapped file since no more
+  // of the text than the current token is ever materialized.
   explicit AbstractParser(AbstractCellLibrary<EvalT>* cell_library,
                           Scanner* scanner, EvalT zero, EvalT one)
       : cell_library_(cell_library),
         scanner_(scanner),
         zero_(zero),
         one_(one) {}
+  template <typename = std::is_constructible<EvalT, bool>>
+  explicit AbstractParser(AbstractCellLibrary<EvalT>* cell_library,
+                          Scanner* scanner)
+      : AbstractParser(cell_library, scanner, EvalT{false}, EvalT{true}) {}
+
+  // Parses the next module in the token stream, adds it to "netlist" and
+  // returns it. Returns nullptr when the token stream is exhausted.
+  absl::StatusOr<AbstractModule<EvalT>*> ParseNextModule(
+      AbstractNetlist<EvalT>& netlist);
+
+ private:
 
   // Parses a cell instantiation (e.g. in module scope).
   absl::Status ParseInstance(AbstractModule<EvalT>* module,
@@ -295,7 +316,7 @@ template <typename EvalT>
 absl::StatusOr<std::string> AbstractParser<EvalT>::PopNameOrError() {
   XLS_ASSIGN_OR_RETURN(Token token, scanner_->Pop());
   if (token.kind == TokenKind::kName) {
-    return token.value;
+    return std::string(token.value);
   }
   return absl::InvalidArgumentError("Expected name token; got: " +
                                     token.ToString());
@@ -310,7 +331,8 @@ absl::StatusOr<int64_t> AbstractParser<EvalT>::PopNumberOrError(size_t& width) {
     std::string width_string, signed_string, base_string, value_string;
     // Precompute the regex matcher for Verilog number literals.
     static LazyRE2 number_re_ = {R"(([0-9]+)'([Ss]?)([bodhBODH])([0-9a-f]+))"};
-    if (RE2::FullMatch(token.value, *number_re_, &width_string, &signed_string,
+    std::string token_value(token.value);
+    if (RE2::FullMatch(token_value, *number_re_, &width_string, &signed_string,
                        &base_string, &value_string)) {
       XLS_RET_CHECK(
           absl::SimpleAtoi(width_string, reinterpret_cast<size_t*>(&width)))
@@ -342,9 +364,9 @@ absl::StatusOr<int64_t> AbstractParser<EvalT>::PopNumberOrError(size_t& width) {
 
     int64_t result;
     if (!absl::SimpleAtoi(token.value, &result)) {
-      return absl::InternalError(
-          "Number token's value cannot be parsed as an int64_t: " +
-          token.value);
+      return absl::InternalError(absl::StrCat(
+          "Number token's value cannot be parsed as an int64_t: ",
+          token.value));
     }
     // Size field defaults to 32 when not explicitly specified.
     width = 32;
@@ -366,7 +388,7 @@ AbstractParser<EvalT>::PopNameOrNumberOrError(size_t& width) {
   TokenKind kind = scanner_->Peek()->kind;
   if (kind == TokenKind::kName) {
     XLS_ASSIGN_OR_RETURN(Token token, scanner_->Pop());
-    return token.value;
+    return std::string(token.value);
   } else if (kind == TokenKind::kNumber) {
     return PopNumberOrError(width);
   }
@@ -772,16 +794,31 @@ AbstractParser<EvalT>::ParseModule(AbstractNetlist<EvalT>& netlist) {
   return module;
 }
 
+template <typename EvalT>
+absl::StatusOr<AbstractModule<EvalT>*> AbstractParser<EvalT>::ParseNextModule(
+    AbstractNetlist<EvalT>& netlist) {
+  if (scanner_->AtEof()) {
+    return nullptr;
+  }
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<AbstractModule<EvalT>> module,
+                       ParseModule(netlist));
+  AbstractModule<EvalT>* module_ptr = module.get();
+  netlist.AddModule(std::move(module));
+  return module_ptr;
+}
+
 template <typename EvalT>
 absl::StatusOr<std::unique_ptr<AbstractNetlist<EvalT>>>
 AbstractParser<EvalT>::ParseNetlist(AbstractCellLibrary<EvalT>* cell_library,
                                     Scanner* scanner, EvalT zero, EvalT one) {
   auto netlist = std::make_unique<AbstractNetlist<EvalT>>();
   AbstractParser<EvalT> p(cell_library, scanner, zero, one);
-  while (!scanner->AtEof()) {
-    XLS_ASSIGN_OR_RETURN(std::unique_ptr<AbstractModule<EvalT>> module,
-                         p.ParseModule(*netlist));
-    netlist->AddModule(std::move(module));
+  while (true) {
+    XLS_ASSIGN_OR_RETURN(AbstractModule<EvalT>* module,
+                         p.ParseNextModule(*netlist));
+    if (module == nullptr) {
+      break;
+    }
   }
   return std::move(netlist);
 }
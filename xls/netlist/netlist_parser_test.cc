@@ -441,6 +441,33 @@ endmodule)";
   TestAssignHelper(m);
 }
 
+TEST(NetlistParserTest, StreamingParseYieldsModulesOneAtATime) {
+  std::string netlist = R"(module a(); endmodule
+module b(); endmodule
+module c(); endmodule)";
+  Scanner scanner(netlist);
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library, MakeFakeCellLibrary());
+  Netlist n;
+  Parser parser(&cell_library, &scanner);
+
+  XLS_ASSERT_OK_AND_ASSIGN(Module * a, parser.ParseNextModule(n));
+  ASSERT_NE(a, nullptr);
+  EXPECT_EQ("a", a->name());
+  // The module is already available in the netlist before the rest of the
+  // text has been scanned.
+  XLS_ASSERT_OK(n.GetModule("a").status());
+  EXPECT_FALSE(n.GetModule("b").ok());
+
+  XLS_ASSERT_OK_AND_ASSIGN(Module * b, parser.ParseNextModule(n));
+  EXPECT_EQ("b", b->name());
+  XLS_ASSERT_OK_AND_ASSIGN(Module * c, parser.ParseNextModule(n));
+  EXPECT_EQ("c", c->name());
+
+  // The stream is exhausted.
+  XLS_ASSERT_OK_AND_ASSIGN(Module * eof, parser.ParseNextModule(n));
+  EXPECT_EQ(eof, nullptr);
+}
+
 }  // namespace
 }  // namespace rtl
 }  // namespace netlist
@@ -14,6 +14,7 @@
 
 #include "xls/noc/simulation/global_routing_table.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <queue>
 #include <vector>
@@ -256,6 +257,63 @@ absl::Status DistributedRoutingTable::DumpRouterRoutingTable(
   return absl::OkStatus();
 }
 
+absl::Status DistributedRoutingTable::BuildDenseRoutingTables(
+    NetworkId network_id) {
+  Network& network = network_manager_->GetNetwork(network_id);
+  int64_t destination_count = sink_indices_.NetworkComponentCount();
+
+  for (NetworkComponent& nc : network.GetNetworkComponents()) {
+    if (nc.kind() != NetworkComponentKind::kRouter) {
+      continue;
+    }
+
+    RouterRoutingTable& table = GetRoutingTable(nc.id());
+    if (table.routes.empty()) {
+      continue;
+    }
+
+    // Each input port routes one or more vcs (ports without vcs route via
+    // a single default vc at index 0).
+    int64_t input_port_count = nc.GetInputPortIds().size();
+    int64_t vc_count = 0;
+    for (PortId input_port_id : nc.GetInputPortIds()) {
+      vc_count = std::max(
+          vc_count,
+          static_cast<int64_t>(table.routes.at(input_port_id.id()).size()));
+    }
+
+    DenseRouterRoutingTable& dense_table = dense_routing_tables_[nc.id()];
+    dense_table.vc_count_ = vc_count;
+    dense_table.destination_count_ = destination_count;
+    dense_table.entries_.assign(input_port_count * vc_count * destination_count,
+                                PortIndexAndVCIndex{-1, -1});
+
+    for (PortId input_port_id : nc.GetInputPortIds()) {
+      XLS_ASSIGN_OR_RETURN(
+          int64_t input_port_index,
+          port_indices_.GetPortIndex(input_port_id, PortDirection::kInput));
+
+      std::vector<PortRoutingList>& port_routes =
+          table.routes.at(input_port_id.id());
+      for (int64_t vc = 0; vc < port_routes.size(); ++vc) {
+        for (auto& [destination_index, hop] : port_routes[vc]) {
+          XLS_ASSIGN_OR_RETURN(
+              int64_t output_port_index,
+              port_indices_.GetPortIndex(hop.port_id_, PortDirection::kOutput));
+
+          int64_t entry_index =
+              (input_port_index * vc_count + vc) * destination_count +
+              destination_index;
+          dense_table.entries_.at(entry_index) =
+              PortIndexAndVCIndex{output_port_index, hop.vc_index_};
+        }
+      }
+    }
+  }
+
+  return absl::OkStatus();
+}
+
 void DistributedRoutingTable::AllocateTableForNetwork(NetworkId network_id,
                                                       int64_t component_count) {
   int64_t network_index = network_id.id();
@@ -360,6 +418,7 @@ DistributedRoutingTableBuilderForTrees::BuildNetworkRoutingTables(
   XLS_RET_CHECK_OK(
       BuildPortAndVirtualChannelIndices(network_id, &routing_table));
   XLS_RET_CHECK_OK(BuildRoutingTable(network_id, &routing_table));
+  XLS_RET_CHECK_OK(routing_table.BuildDenseRoutingTables(network_id));
 
   return routing_table;
 }
@@ -489,6 +548,7 @@ DistributedRoutingTableBuilderForMultiplePaths::BuildNetworkRoutingTables(
   XLS_RET_CHECK_OK(
       BuildPortAndVirtualChannelIndices(network_id, &routing_table));
   XLS_RET_CHECK_OK(BuildRoutingTable(network_id, &routing_table));
+  XLS_RET_CHECK_OK(routing_table.BuildDenseRoutingTables(network_id));
 
   return routing_table;
 }
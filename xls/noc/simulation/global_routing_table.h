@@ -19,7 +19,10 @@
 #ifndef XLS_NOC_SIMULATION_GLOBAL_ROUTING_TABLE_H_
 #define XLS_NOC_SIMULATION_GLOBAL_ROUTING_TABLE_H_
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
 #include "xls/noc/simulation/common.h"
 #include "xls/noc/simulation/indexer.h"
 #include "xls/noc/simulation/network_graph.h"
@@ -67,6 +70,49 @@ class DistributedRoutingTable {
     std::vector<std::vector<PortRoutingList>> routes;
   };
 
+  // Precomputed routing table for a single router, flattened into a dense
+  // array indexed by input port index, input vc index, and destination
+  // (sink) index.
+  //
+  // The layered tables above go through id-to-index maps and a linear
+  // scan of a PortRoutingList on every lookup.  Flattening once after the
+  // tables are built turns per-hop routing in simulation hot loops into a
+  // single array load.
+  class DenseRouterRoutingTable {
+   public:
+    // Returns the output port index and vc index for a flit arriving on
+    // input_port_index and vc_index with destination destination_index.
+    absl::StatusOr<PortIndexAndVCIndex> GetOutputPortIndex(
+        int64_t input_port_index, int64_t vc_index,
+        int64_t destination_index) const {
+      int64_t entry_index =
+          (input_port_index * vc_count_ + vc_index) * destination_count_ +
+          destination_index;
+
+      if (input_port_index < 0 || vc_index < 0 || vc_index >= vc_count_ ||
+          destination_index < 0 || destination_index >= destination_count_ ||
+          entry_index >= static_cast<int64_t>(entries_.size()) ||
+          entries_[entry_index].port_index_ < 0) {
+        return absl::NotFoundError(absl::StrFormat(
+            "Unable to find route from input port index %d vc index %d"
+            " to sink index %d",
+            input_port_index, vc_index, destination_index));
+      }
+
+      return entries_[entry_index];
+    }
+
+   private:
+    friend class DistributedRoutingTable;
+
+    int64_t vc_count_ = 0;
+    int64_t destination_count_ = 0;
+
+    // Output port/vc per (input port, vc, destination), with port index -1
+    // marking the absence of a route.
+    std::vector<PortIndexAndVCIndex> entries_;
+  };
+
   // Returns route to destination from a particular source network interface
   // to a sink network interface.
   //
@@ -100,8 +146,13 @@ class DistributedRoutingTable {
   absl::StatusOr<PortAndVCIndex> GetRouterOutputPortByIndex(
       PortAndVCIndex from, int64_t destination_index);
 
-  // TODO(tedhong): 2020-01-25 Add indexer for input/output ports of a router
-  //                          and support routing directly via indices.
+  // Returns the dense table for the given router, or nullptr if none was
+  // built (e.g. the component routes no traffic).
+  const DenseRouterRoutingTable* GetDenseRouterRoutingTable(
+      NetworkComponentId router) const {
+    auto iter = dense_routing_tables_.find(router);
+    return iter == dense_routing_tables_.end() ? nullptr : &iter->second;
+  }
 
   // Returns mapping of vc params to local indicies.
   const VirtualChannelIndexMap& GetVirtualChannelIndices() {
@@ -129,6 +180,11 @@ class DistributedRoutingTable {
   // number of components in a network.
   void AllocateTableForNetwork(NetworkId network_id, int64_t component_count);
 
+  // Flattens the layered routing tables of the network's routers into
+  // dense per-router tables.  Called by the builders once the layered
+  // tables are fully populated.
+  absl::Status BuildDenseRoutingTables(NetworkId network_id);
+
   // Get (and create if necessary) routing table associated for a component.
   RouterRoutingTable& GetRoutingTable(NetworkComponentId nc_id) {
     return routing_tables_[nc_id.network()][nc_id.id()];
@@ -157,6 +213,11 @@ class DistributedRoutingTable {
   // ie. routing table for ComponentId id is
   //  routing_tables_[id.network()][id.id()]
   std::vector<std::vector<RouterRoutingTable>> routing_tables_;
+
+  // Flattened per-router tables, built from routing_tables_ by
+  // BuildDenseRoutingTables().
+  absl::flat_hash_map<NetworkComponentId, DenseRouterRoutingTable>
+      dense_routing_tables_;
 };
 
 // Abstract base class for distributed routing table builder.
@@ -209,6 +209,36 @@ TEST(GlobalRoutingTableTest, Index) {
   EXPECT_EQ(route00[0], sendport0);
   EXPECT_EQ(route00[2], routera_nc);
   EXPECT_EQ(route00[4], recvport0);
+
+  // Dense table lookups match the layered routing table.
+  const DistributedRoutingTable::DenseRouterRoutingTable* dense_table =
+      routing_table.GetDenseRouterRoutingTable(routera_id);
+  ASSERT_NE(dense_table, nullptr);
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      int64_t ain0_index,
+      routing_table.GetPortIndices().GetPortIndex(ain0, PortDirection::kInput));
+
+  for (int64_t dest = 0;
+       dest < routing_table.GetSinkIndices().NetworkComponentCount(); ++dest) {
+    for (int64_t vc = 0; vc < 2; ++vc) {
+      absl::StatusOr<PortAndVCIndex> expected =
+          routing_table.GetRouterOutputPortByIndex(PortAndVCIndex{ain0, vc},
+                                                   dest);
+      absl::StatusOr<PortIndexAndVCIndex> actual =
+          dense_table->GetOutputPortIndex(ain0_index, vc, dest);
+
+      ASSERT_EQ(expected.ok(), actual.ok());
+      if (expected.ok()) {
+        XLS_ASSERT_OK_AND_ASSIGN(int64_t expected_port_index,
+                                 routing_table.GetPortIndices().GetPortIndex(
+                                     expected->port_id_,
+                                     PortDirection::kOutput));
+        EXPECT_EQ(actual->port_index_, expected_port_index);
+        EXPECT_EQ(actual->vc_index_, expected->vc_index_);
+      }
+    }
+  }
 }
 
 TEST(GlobalRoutingTableTest, RouterLoop) {
@@ -14,6 +14,8 @@
 
 #include "xls/noc/simulation/packetizer.h"
 
+#include <utility>
+
 namespace xls::noc {
 
 absl::StatusOr<std::vector<Bits>*>
@@ -45,15 +47,21 @@ Packetizer::AllocateOrRetrievePartialPacketStore(int64_t source_index) {
 
 void Packetizer::DeallocatePartialPacketStore(int64_t source_index) {
   int64_t partial_packet_index = partial_packet_index_map_.at(source_index);
+
+  // Clearing the store returns its slot to the free pool while retaining
+  // the vector's capacity, so steady-state reception reuses the same
+  // storage instead of allocating per packet.
   partial_packets_.at(partial_packet_index).clear();
-  partial_packet_index_map_.erase(partial_packet_index);
+  partial_packet_index_map_.erase(source_index);
 }
 
 absl::Status Packetizer::AcceptNewFlit(DataFlit flit) {
   XLS_ASSIGN_OR_RETURN(std::vector<Bits> * partial_packet_store,
                        AllocateOrRetrievePartialPacketStore(flit.source_index));
 
-  partial_packet_store->push_back(flit.data);
+  // The flit is passed by value and dead after this call, so its payload
+  // can be moved into the store rather than copied.
+  partial_packet_store->push_back(std::move(flit.data));
 
   if (flit.type == FlitType::kTail) {
     // Concat all received flits together.
@@ -83,7 +91,7 @@ absl::Status Packetizer::AcceptNewFlit(DataFlit flit) {
                              .Valid(true)
                              .Build());
 
-    received_packets_.push_back(received_packet);
+    received_packets_.push_back(std::move(received_packet));
   }
 
   return absl::OkStatus();
@@ -129,7 +129,7 @@ class DePacketizer {
       return absl::InternalError("Packetize already handling a packet");
     }
 
-    packet_ = packet;
+    packet_ = std::move(packet);
     bits_left_to_send_ = packet_.data.bit_count();
 
     return absl::OkStatus();
@@ -309,6 +309,10 @@ class Packetizer {
   int64_t max_packet_bit_count_;
 
   // Flit buffer for packets that are in the midst of being received.
+  //
+  // Slots are index-addressed and recycled -- a completed packet's slot is
+  // cleared (retaining its capacity) and reused for a later packet, so in
+  // steady state no new storage is allocated per packet.
   std::vector<std::vector<Bits>> partial_packets_;
 
   // The packetizer uses partial_packet_index_ to index into partial_packets_.
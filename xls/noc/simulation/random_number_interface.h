@@ -16,6 +16,7 @@
 #define XLS_NOC_SIMULATION_RANDOM_NUMBER_INTERFACE_H_
 
 #include <random>
+#include <vector>
 
 // This file contains classes used manage and obtain random numbers
 // from different distributions.
@@ -65,6 +66,26 @@ class RandomNumberInterface {
     return 1 + GeometricDistribution(geo_p);
   }
 
+  // Fills deltas with count consecutive inter-arrival times, drawing the
+  // same sequence as count calls to GeneralizedGeometric().
+  //
+  // Sampling in bulk constructs the distribution objects once and avoids
+  // the per-call overhead, which dominates when many flows each draw a
+  // few samples per cycle.
+  void GeneralizedGeometricBatch(double lambda, double burst_prob,
+                                 int64_t count, std::vector<int64_t>& deltas) {
+    std::bernoulli_distribution burst(burst_prob);
+    std::geometric_distribution<int64_t> geometric(lambda * (1.0 - burst_prob));
+
+    deltas.clear();
+    deltas.reserve(count);
+    for (int64_t i = 0; i < count; ++i) {
+      deltas.push_back(burst(random_engine_)
+                           ? 0
+                           : 1 + geometric(random_engine_));
+    }
+  }
+
  private:
   // Random engine with a single int as state.
   std::minstd_rand random_engine_;
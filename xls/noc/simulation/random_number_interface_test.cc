@@ -78,5 +78,30 @@ TEST(RandomNumberInterfaceTest, SmokeTest) {
   }
 }
 
+TEST(RandomNumberInterfaceTest, BatchMatchesRepeatedCalls) {
+  RandomNumberInterface rnd0;
+  RandomNumberInterface rnd1;
+
+  rnd0.SetSeed(100);
+  rnd1.SetSeed(100);
+
+  std::vector<double> p_samples = {0.5, 0.25, 0.01};
+  std::vector<double> l_samples = {0.5, 0.25, 0.01};
+  int64_t trails = 100;
+
+  std::vector<int64_t> batch;
+
+  for (double p : p_samples) {
+    for (double l : l_samples) {
+      rnd0.GeneralizedGeometricBatch(l, p, trails, batch);
+      ASSERT_EQ(batch.size(), trails);
+
+      for (int64_t i = 0; i < trails; ++i) {
+        EXPECT_EQ(batch[i], rnd1.GeneralizedGeometric(l, p));
+      }
+    }
+  }
+}
+
 }  // namespace
 }  // namespace xls::noc
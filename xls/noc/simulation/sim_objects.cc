@@ -14,6 +14,12 @@
 
 #include "xls/noc/simulation/sim_objects.h"
 
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
@@ -41,7 +47,7 @@ class SimplePipelineImpl {
  public:
   SimplePipelineImpl(int64_t stage_count, DataTimePhitT& from_channel,
                      DataTimePhitT& to_channel,
-                     std::queue<DataTimePhitT>& state,
+                     std::deque<DataTimePhitT>& state,
                      int64_t& internal_propagated_cycle)
       : stage_count_(stage_count),
         from_(from_channel),
@@ -51,12 +57,19 @@ class SimplePipelineImpl {
 
   bool TryPropagation(NocSimulator& simulator);
 
+  // Stamps the output channel for the current cycle using only pipeline
+  // state (popping the head stage or emitting a bubble).  Requires a
+  // non-zero stage count; TryPropagation() uses this for the output half
+  // of its work, and boundary links use it to emit their outputs before
+  // the regions on either side are simulated in parallel.
+  void PropagateOutput(NocSimulator& simulator);
+
  private:
   int64_t stage_count_;
   DataTimePhitT& from_;
   DataTimePhitT& to_;
   // TODO(vmirian) 09-07-21 Optimize to select flit data and its metadata
-  std::queue<DataTimePhitT>& state_;
+  std::deque<DataTimePhitT>& state_;
   int64_t& internal_propagated_cycle_;
 };
 
@@ -89,25 +102,10 @@ bool SimplePipelineImpl<DataTimePhitT>::TryPropagation(
   } else {
     // There is one pipeline stage so output can be updated
     // immediately.
-    if (to_.cycle != current_cycle) {
-      if (state_.size() >= stage_count_) {
-        to_.flit = state_.front().flit;
-        to_.cycle = current_cycle;
-        to_.metadata = state_.front().metadata;
-        state_.pop();
-      } else {
-        to_.flit.type = FlitType::kInvalid;
-        to_.flit.data = Bits(32);
-        to_.cycle = current_cycle;
-      }
-
-      XLS_VLOG(2) << absl::StreamFormat(
-          "... link sending data %s type %d connection",
-          to_.flit.data.ToString(), to_.flit.type);
-    }
+    PropagateOutput(simulator);
 
     if (from_.cycle == current_cycle) {
-      state_.push(from_);
+      state_.push_back(from_);
       XLS_VLOG(2) << absl::StreamFormat("... link received data %s type %d",
                                         from_.flit.data.ToString(),
                                         from_.flit.type);
@@ -122,6 +120,31 @@ bool SimplePipelineImpl<DataTimePhitT>::TryPropagation(
   return internal_propagated_cycle_ == current_cycle;
 }
 
+template <typename DataTimePhitT>
+void SimplePipelineImpl<DataTimePhitT>::PropagateOutput(
+    NocSimulator& simulator) {
+  int64_t current_cycle = simulator.GetCurrentCycle();
+
+  if (to_.cycle != current_cycle) {
+    if (state_.size() >= stage_count_) {
+      // The head stage is popped below, so its flit and metadata can be
+      // moved out rather than copied.
+      to_.flit = std::move(state_.front().flit);
+      to_.cycle = current_cycle;
+      to_.metadata = std::move(state_.front().metadata);
+      state_.pop_front();
+    } else {
+      to_.flit.type = FlitType::kInvalid;
+      to_.flit.data = Bits(32);
+      to_.cycle = current_cycle;
+    }
+
+    XLS_VLOG(2) << absl::StreamFormat(
+        "... link sending data %s type %d connection", to_.flit.data.ToString(),
+        to_.flit.type);
+  }
+}
+
 }  // namespace
 
 absl::Status NocSimulator::CreateSimulationObjects(NetworkId network) {
@@ -228,6 +251,250 @@ absl::Status NocSimulator::CreateRouter(NetworkComponentId nc_id) {
   return absl::OkStatus();
 }
 
+absl::Status NocSimulator::BuildTickKernel() {
+  components_.clear();
+  component_index_map_.clear();
+  pending_wakeups_.clear();
+
+  // Components are evaluated in the order network interface sources, links,
+  // routers, then network interface sinks.
+  for (SimNetworkInterfaceSrc& nc : network_interface_sources_) {
+    component_index_map_[nc.GetId()] = components_.size();
+    components_.push_back(&nc);
+  }
+  for (SimLink& nc : links_) {
+    component_index_map_[nc.GetId()] = components_.size();
+    components_.push_back(&nc);
+  }
+  for (SimInputBufferedVCRouter& nc : routers_) {
+    component_index_map_[nc.GetId()] = components_.size();
+    components_.push_back(&nc);
+  }
+  for (SimNetworkInterfaceSink& nc : network_interface_sinks_) {
+    component_index_map_[nc.GetId()] = components_.size();
+    components_.push_back(&nc);
+  }
+
+  int64_t component_count = components_.size();
+  driven_forward_connections_.assign(component_count, {});
+  driven_reverse_connections_.assign(component_count, {});
+  same_cycle_consumers_.assign(component_count, {});
+  delayed_consumers_.assign(component_count, {});
+  component_active_.assign(component_count, false);
+
+  // Map each connection to the components driving its channels.  The
+  // component driving the forward channel of a connection consumes its
+  // reverse channels and vice-versa.
+  std::vector<int64_t> forward_driver(connections_.size(), -1);
+  std::vector<int64_t> reverse_driver(connections_.size(), -1);
+  std::vector<SimComponentOutputs> outputs(component_count);
+  for (int64_t i = 0; i < component_count; ++i) {
+    outputs[i] = components_[i]->GetOutputs(*this);
+    for (const SimComponentOutput& output : outputs[i].forward) {
+      driven_forward_connections_[i].push_back(output.connection_index);
+      forward_driver.at(output.connection_index) = i;
+    }
+    for (const SimComponentOutput& output : outputs[i].reverse) {
+      driven_reverse_connections_[i].push_back(output.connection_index);
+      reverse_driver.at(output.connection_index) = i;
+    }
+  }
+
+  for (int64_t i = 0; i < connections_.size(); ++i) {
+    XLS_RET_CHECK(forward_driver[i] >= 0 && reverse_driver[i] >= 0)
+        << absl::StreamFormat("Connection %x has no registered driver",
+                              connections_[i].id.AsUInt64());
+  }
+
+  for (int64_t i = 0; i < component_count; ++i) {
+    for (const SimComponentOutput& output : outputs[i].forward) {
+      int64_t consumer = reverse_driver[output.connection_index];
+      if (output.combinational) {
+        same_cycle_consumers_[i].push_back(consumer);
+      } else {
+        delayed_consumers_[i].push_back(consumer);
+      }
+    }
+    for (const SimComponentOutput& output : outputs[i].reverse) {
+      int64_t consumer = forward_driver[output.connection_index];
+      if (output.combinational) {
+        same_cycle_consumers_[i].push_back(consumer);
+      } else {
+        delayed_consumers_[i].push_back(consumer);
+      }
+    }
+  }
+
+  BuildRegions(forward_driver, reverse_driver);
+
+  return absl::OkStatus();
+}
+
+void NocSimulator::BuildRegions(absl::Span<const int64_t> forward_driver,
+                                absl::Span<const int64_t> reverse_driver) {
+  int64_t component_count = components_.size();
+
+  region_items_.clear();
+  boundary_links_.clear();
+
+  std::vector<bool> is_boundary(component_count, false);
+  for (SimLink& link : links_) {
+    if (link.IsPartitionBoundary()) {
+      int64_t index = component_index_map_.at(link.GetId());
+      is_boundary[index] = true;
+      boundary_links_.push_back({&link, index});
+    }
+  }
+
+  // Union components joined by a connection.  A boundary link is merged
+  // with the region upstream of it (via its source connection) but not
+  // with the region downstream -- partitions are cut at the links'
+  // pipeline registers.
+  std::vector<int64_t> parent(component_count);
+  std::iota(parent.begin(), parent.end(), 0);
+  std::function<int64_t(int64_t)> find = [&](int64_t x) -> int64_t {
+    while (parent[x] != x) {
+      parent[x] = parent[parent[x]];
+      x = parent[x];
+    }
+    return x;
+  };
+
+  for (int64_t connection = 0; connection < connections_.size(); ++connection) {
+    if (is_boundary[forward_driver[connection]]) {
+      continue;
+    }
+    parent[find(forward_driver[connection])] = find(reverse_driver[connection]);
+  }
+
+  // Assign dense region ids and place each component within its region.
+  absl::flat_hash_map<int64_t, int64_t> root_to_region;
+  for (int64_t i = 0; i < component_count; ++i) {
+    int64_t root = find(i);
+    auto [iter, inserted] = root_to_region.insert(
+        {root, static_cast<int64_t>(root_to_region.size())});
+    int64_t region = iter->second;
+    if (inserted) {
+      region_items_.push_back({});
+    }
+    if (is_boundary[i]) {
+      // The forward direction of a boundary link runs with the upstream
+      // region; the reverse direction is added to the downstream region
+      // below.
+      region_items_[region].push_back(
+          RegionItem{i, /*forward=*/true, /*reverse=*/false});
+    } else {
+      region_items_[region].push_back(
+          RegionItem{i, /*forward=*/true, /*reverse=*/true});
+    }
+  }
+
+  for (const std::pair<SimLink*, int64_t>& link : boundary_links_) {
+    int64_t downstream =
+        reverse_driver[link.first->GetSinkConnectionIndex()];
+    int64_t region = root_to_region.at(find(downstream));
+    region_items_[region].push_back(
+        RegionItem{link.second, /*forward=*/false, /*reverse=*/true});
+  }
+
+  region_converged_.assign(region_items_.size(), 1);
+
+  XLS_VLOG(2) << absl::StreamFormat(
+      "Partitioned %d components into %d regions (%d boundary links)",
+      component_count, region_items_.size(), boundary_links_.size());
+}
+
+void NocSimulator::ScheduleComponentWake(NetworkComponentId component,
+                                         int64_t cycle) {
+  XLS_CHECK_GT(cycle, cycle_);
+  pending_wakeups_[cycle].push_back(component_index_map_.at(component));
+}
+
+void NocSimulator::ComputeActiveComponents() {
+  int64_t component_count = components_.size();
+
+  // Cycle 0 performs reset-time work (full credit updates are exchanged)
+  // so every component is evaluated.
+  if (cycle_ <= 0) {
+    std::fill(component_active_.begin(), component_active_.end(), true);
+    return;
+  }
+
+  std::fill(component_active_.begin(), component_active_.end(), false);
+  std::vector<bool> is_seed(component_count, false);
+  std::vector<int64_t> worklist;
+
+  auto activate = [this, &worklist](int64_t index) {
+    if (!component_active_[index]) {
+      component_active_[index] = true;
+      worklist.push_back(index);
+    }
+  };
+
+  // Seed with components woken up via the calendar of pending wake-ups.
+  auto wakeups = pending_wakeups_.find(cycle_);
+  if (wakeups != pending_wakeups_.end()) {
+    for (int64_t index : wakeups->second) {
+      is_seed[index] = true;
+      activate(index);
+    }
+    pending_wakeups_.erase(wakeups);
+  }
+
+  // Seed with components whose internal state requires evaluation.
+  for (int64_t i = 0; i < component_count; ++i) {
+    if (components_[i]->HasPendingActivity(*this)) {
+      is_seed[i] = true;
+      activate(i);
+    }
+  }
+
+  // A seed component may produce a valid flit on any of its outputs, so all
+  // of its consumers must be evaluated.  A component woken up by one of its
+  // inputs can only produce new output in the same cycle through a
+  // combinational path.
+  int64_t active_count = worklist.size();
+  while (!worklist.empty()) {
+    int64_t index = worklist.back();
+    worklist.pop_back();
+    int64_t prior_size = worklist.size();
+    for (int64_t consumer : same_cycle_consumers_[index]) {
+      activate(consumer);
+    }
+    if (is_seed[index]) {
+      for (int64_t consumer : delayed_consumers_[index]) {
+        activate(consumer);
+      }
+    }
+    active_count += worklist.size() - prior_size;
+  }
+
+  XLS_VLOG(2) << absl::StreamFormat("Cycle %d active components %d of %d",
+                                    cycle_, active_count, component_count);
+
+  // Stamp the outputs of idle components with invalid flits so that their
+  // consumers observe an idle cycle and can converge.
+  for (int64_t i = 0; i < component_count; ++i) {
+    if (component_active_[i]) {
+      continue;
+    }
+    for (int64_t connection : driven_forward_connections_[i]) {
+      TimedDataFlit& forward = connections_[connection].forward_channels;
+      forward.flit.type = FlitType::kInvalid;
+      forward.flit.data = Bits(32);
+      forward.cycle = cycle_;
+    }
+    for (int64_t connection : driven_reverse_connections_[i]) {
+      for (TimedMetadataFlit& reverse :
+           connections_[connection].reverse_channels) {
+        reverse.flit.type = FlitType::kInvalid;
+        reverse.flit.data = Bits(32);
+        reverse.cycle = cycle_;
+      }
+    }
+  }
+}
+
 void NocSimulator::Dump() {
   Network& network_obj = mgr_->GetNetwork(network_);
   // Create connection simulation objects
@@ -259,16 +526,25 @@ absl::Status NocSimulator::RunCycle(int64_t max_ticks) {
     XLS_RET_CHECK_OK(svc->RunCycle());
   }
 
-  bool converged = false;
-  int64_t nticks = 0;
-  while (!converged) {
-    XLS_VLOG(2) << absl::StreamFormat("Tick %d", nticks);
-    converged = Tick();
-    ++nticks;
-    if (nticks >= max_ticks) {
-      return absl::InternalError(absl::StrFormat(
-          "Simulator unable to converge after %d ticks for cycle %d", nticks,
-          cycle_));
+  // Determine which components have work to do this cycle.  This is done
+  // after the pre-cycle services have run so that any traffic they inject
+  // is accounted for.
+  ComputeActiveComponents();
+
+  if (num_worker_threads_ > 1 && region_items_.size() > 1) {
+    XLS_RETURN_IF_ERROR(RunCycleParallel(max_ticks));
+  } else {
+    bool converged = false;
+    int64_t nticks = 0;
+    while (!converged) {
+      XLS_VLOG(2) << absl::StreamFormat("Tick %d", nticks);
+      converged = Tick();
+      ++nticks;
+      if (nticks >= max_ticks) {
+        return absl::InternalError(absl::StrFormat(
+            "Simulator unable to converge after %d ticks for cycle %d", nticks,
+            cycle_));
+      }
     }
   }
 
@@ -293,62 +569,167 @@ absl::Status NocSimulator::RunCycle(int64_t max_ticks) {
 }
 
 bool NocSimulator::Tick() {
-  // Goes through each simulator object and run atick.
-  // Converges when everyone returns True -- that determines new cycle
+  // Goes through each active simulator object and runs a tick.
+  // Converges when everyone returns True -- that determines new cycle.
+  //
+  // Idle components are skipped -- their outputs were stamped with invalid
+  // flits by ComputeActiveComponents().
 
   bool converged = true;
 
-  XLS_VLOG(2) << " Network Interfaces";
-  for (SimNetworkInterfaceSrc& nc : network_interface_sources_) {
-    NetworkComponentId id = nc.GetId();
-    bool this_converged = nc.Tick(*this);
+  for (int64_t i = 0; i < components_.size(); ++i) {
+    if (!component_active_[i]) {
+      continue;
+    }
+    SimNetworkComponentBase* nc = components_[i];
+    bool this_converged = nc->Tick(*this);
     converged &= this_converged;
-    XLS_VLOG(2) << absl::StreamFormat(" NC %x Converged %d", id.AsUInt64(),
-                                      this_converged);
+    XLS_VLOG(2) << absl::StreamFormat(" NC %x Converged %d",
+                                      nc->GetId().AsUInt64(), this_converged);
   }
 
-  XLS_VLOG(2) << " Links";
-  for (SimLink& nc : links_) {
-    NetworkComponentId id = nc.GetId();
-    bool this_converged = nc.Tick(*this);
-    converged &= this_converged;
-    XLS_VLOG(2) << absl::StreamFormat(" NC %x Converged %d", id.AsUInt64(),
-                                      this_converged);
+  return converged;
+}
+
+absl::Status NocSimulator::SetWorkerThreads(int64_t count) {
+  XLS_RET_CHECK_GE(count, 0);
+  ShutdownWorkerThreads();
+
+  num_worker_threads_ = count;
+  if (count <= 1) {
+    return absl::OkStatus();
   }
 
-  XLS_VLOG(2) << " Routers";
-  for (SimInputBufferedVCRouter& nc : routers_) {
-    NetworkComponentId id = nc.GetId();
-    bool this_converged = nc.Tick(*this);
-    converged &= this_converged;
-    XLS_VLOG(2) << absl::StreamFormat(" NC %x Converged %d", id.AsUInt64(),
-                                      this_converged);
+  for (int64_t i = 0; i < count; ++i) {
+    worker_threads_.push_back(
+        std::make_unique<Thread>([this, i]() { WorkerLoop(i); }));
   }
 
-  XLS_VLOG(2) << " Sinks";
-  for (SimNetworkInterfaceSink& nc : network_interface_sinks_) {
-    NetworkComponentId id = nc.GetId();
-    bool this_converged = nc.Tick(*this);
-    converged &= this_converged;
-    XLS_VLOG(2) << absl::StreamFormat(" NC %x Converged %d", id.AsUInt64(),
-                                      this_converged);
+  return absl::OkStatus();
+}
+
+void NocSimulator::ShutdownWorkerThreads() {
+  if (worker_threads_.empty()) {
+    return;
+  }
+  {
+    absl::MutexLock lock(&parallel_mutex_);
+    shutdown_workers_ = true;
+  }
+  for (std::unique_ptr<Thread>& thread : worker_threads_) {
+    thread->Join();
   }
+  worker_threads_.clear();
+  {
+    absl::MutexLock lock(&parallel_mutex_);
+    shutdown_workers_ = false;
+  }
+}
 
-  return converged;
+absl::Status NocSimulator::RunCycleParallel(int64_t max_ticks) {
+  // Boundary link outputs depend only on their pipeline state, so they are
+  // emitted serially up front -- afterwards the regions on either side of
+  // each boundary link only touch state owned by their own region and can
+  // be simulated concurrently.
+  for (const std::pair<SimLink*, int64_t>& link : boundary_links_) {
+    if (!component_active_[link.second]) {
+      continue;
+    }
+    link.first->EmitBoundaryOutputs(*this);
+  }
+
+  {
+    absl::MutexLock lock(&parallel_mutex_);
+    parallel_max_ticks_ = max_ticks;
+    workers_remaining_ = num_worker_threads_;
+    ++tick_generation_;
+  }
+
+  {
+    absl::MutexLock lock(&parallel_mutex_);
+    parallel_mutex_.Await(absl::Condition(
+        +[](int64_t* remaining) { return *remaining == 0; },
+        &workers_remaining_));
+  }
+
+  for (int64_t region = 0; region < region_items_.size(); ++region) {
+    if (!region_converged_[region]) {
+      return absl::InternalError(absl::StrFormat(
+          "Simulator unable to converge after %d ticks for cycle %d",
+          max_ticks, cycle_));
+    }
+  }
+
+  return absl::OkStatus();
+}
+
+bool NocSimulator::RunRegionToConvergence(int64_t region, int64_t max_ticks) {
+  int64_t nticks = 0;
+  bool converged = false;
+  while (!converged) {
+    converged = true;
+    for (const RegionItem& item : region_items_[region]) {
+      if (!component_active_[item.component_index]) {
+        continue;
+      }
+      converged &= components_[item.component_index]->Tick(*this, item.forward,
+                                                           item.reverse);
+    }
+    ++nticks;
+    if (!converged && nticks >= max_ticks) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void NocSimulator::WorkerLoop(int64_t worker_index) {
+  int64_t last_generation = 0;
+
+  while (true) {
+    struct WakeState {
+      NocSimulator* simulator;
+      int64_t last_generation;
+
+      bool Ready() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(
+          simulator->parallel_mutex_) {
+        return simulator->shutdown_workers_ ||
+               simulator->tick_generation_ != last_generation;
+      }
+    } wake{this, last_generation};
+
+    parallel_mutex_.LockWhen(absl::Condition(&wake, &WakeState::Ready));
+    if (shutdown_workers_) {
+      parallel_mutex_.Unlock();
+      return;
+    }
+    last_generation = tick_generation_;
+    int64_t max_ticks = parallel_max_ticks_;
+    parallel_mutex_.Unlock();
+
+    for (int64_t region = worker_index; region < region_items_.size();
+         region += num_worker_threads_) {
+      region_converged_[region] = RunRegionToConvergence(region, max_ticks);
+    }
+
+    absl::MutexLock lock(&parallel_mutex_);
+    --workers_remaining_;
+  }
 }
 
-bool SimNetworkComponentBase::Tick(NocSimulator& simulator) {
+bool SimNetworkComponentBase::Tick(NocSimulator& simulator, bool do_forward,
+                                   bool do_reverse) {
   int64_t cycle = simulator.GetCurrentCycle();
 
   bool converged = true;
-  if (forward_propagated_cycle_ != cycle) {
+  if (do_forward && forward_propagated_cycle_ != cycle) {
     if (TryForwardPropagation(simulator)) {
       forward_propagated_cycle_ = cycle;
     } else {
       converged = false;
     }
   }
-  if (reverse_propagated_cycle_ != cycle) {
+  if (do_reverse && reverse_propagated_cycle_ != cycle) {
     if (TryReversePropagation(simulator)) {
       reverse_propagated_cycle_ = cycle;
     } else {
@@ -410,6 +791,55 @@ absl::Status SimLink::InitializeImpl(NocSimulator& simulator) {
   return absl::OkStatus();
 }
 
+SimComponentOutputs SimLink::GetOutputs(NocSimulator& simulator) const {
+  SimComponentOutputs outputs;
+  outputs.forward.push_back(
+      SimComponentOutput{sink_connection_index_,
+                         /*combinational=*/forward_pipeline_stages_ == 0});
+  outputs.reverse.push_back(
+      SimComponentOutput{src_connection_index_,
+                         /*combinational=*/reverse_pipeline_stages_ == 0});
+  return outputs;
+}
+
+void SimLink::EmitBoundaryOutputs(NocSimulator& simulator) {
+  XLS_CHECK(IsPartitionBoundary());
+
+  SimConnectionState& src =
+      simulator.GetSimConnectionByIndex(src_connection_index_);
+  SimConnectionState& sink =
+      simulator.GetSimConnectionByIndex(sink_connection_index_);
+
+  SimplePipelineImpl<TimedDataFlit>(
+      forward_pipeline_stages_, src.forward_channels, sink.forward_channels,
+      forward_data_stages_, internal_forward_propagated_cycle_)
+      .PropagateOutput(simulator);
+
+  for (int64_t vc = 0; vc < sink.reverse_channels.size(); ++vc) {
+    SimplePipelineImpl<TimedMetadataFlit>(
+        reverse_pipeline_stages_, sink.reverse_channels.at(vc),
+        src.reverse_channels.at(vc), reverse_credit_stages_.at(vc),
+        internal_reverse_propagated_cycle_.at(vc))
+        .PropagateOutput(simulator);
+  }
+}
+
+bool SimLink::HasPendingActivity(NocSimulator& simulator) {
+  for (const TimedDataFlit& staged : forward_data_stages_) {
+    if (staged.flit.type != FlitType::kInvalid) {
+      return true;
+    }
+  }
+  for (const std::deque<TimedMetadataFlit>& stages : reverse_credit_stages_) {
+    for (const TimedMetadataFlit& staged : stages) {
+      if (staged.flit.type != FlitType::kInvalid) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 absl::Status SimNetworkInterfaceSrc::InitializeImpl(NocSimulator& simulator) {
   XLS_ASSIGN_OR_RETURN(
       NetworkComponentParam nc_param,
@@ -430,15 +860,57 @@ absl::Status SimNetworkInterfaceSrc::InitializeImpl(NocSimulator& simulator) {
       network_manager->GetPort(sink_port).connection();
 
   sink_connection_index_ = simulator.GetConnectionIndex(sink_connection);
+  scheduled_wake_cycle_ = -1;
 
   return absl::OkStatus();
 }
 
+SimComponentOutputs SimNetworkInterfaceSrc::GetOutputs(
+    NocSimulator& simulator) const {
+  SimComponentOutputs outputs;
+  // Flits are only sent when queued ahead of time, so the source never
+  // produces a valid flit in the same cycle one of its credits arrives.
+  outputs.forward.push_back(
+      SimComponentOutput{sink_connection_index_, /*combinational=*/false});
+  return outputs;
+}
+
+bool SimNetworkInterfaceSrc::HasPendingActivity(NocSimulator& simulator) {
+  int64_t current_cycle = simulator.GetCurrentCycle();
+
+  for (int64_t vc = 0; vc < credit_update_.size(); ++vc) {
+    if (credit_update_[vc].credit > 0) {
+      return true;
+    }
+  }
+
+  int64_t next_send_cycle = std::numeric_limits<int64_t>::max();
+  for (const std::queue<TimedDataFlit>& send_queue : data_to_send_) {
+    if (send_queue.empty()) {
+      continue;
+    }
+    if (send_queue.front().cycle <= current_cycle) {
+      return true;
+    }
+    next_send_cycle = std::min(next_send_cycle, send_queue.front().cycle);
+  }
+
+  // All queued flits are to be sent in the future -- schedule a wake-up
+  // instead of evaluating the source every cycle in between.
+  if (next_send_cycle != std::numeric_limits<int64_t>::max() &&
+      next_send_cycle != scheduled_wake_cycle_) {
+    simulator.ScheduleComponentWake(GetId(), next_send_cycle);
+    scheduled_wake_cycle_ = next_send_cycle;
+  }
+
+  return false;
+}
+
 absl::Status SimNetworkInterfaceSrc::SendFlitAtTime(TimedDataFlit flit) {
   int64_t vc_index = flit.flit.vc;
 
   if (vc_index < data_to_send_.size()) {
-    data_to_send_[vc_index].push(flit);
+    data_to_send_[vc_index].push(std::move(flit));
     return absl::OkStatus();
   } else {
     return absl::OutOfRangeError(
@@ -474,6 +946,15 @@ absl::Status SimNetworkInterfaceSink::InitializeImpl(NocSimulator& simulator) {
   return absl::OkStatus();
 }
 
+SimComponentOutputs SimNetworkInterfaceSink::GetOutputs(
+    NocSimulator& simulator) const {
+  SimComponentOutputs outputs;
+  // A credit is sent back upstream in the same cycle a flit is received.
+  outputs.reverse.push_back(
+      SimComponentOutput{src_connection_index_, /*combinational=*/true});
+  return outputs;
+}
+
 int64_t SimInputBufferedVCRouter::GetUtilizationCycleCount() const {
   return utilization_cycle_count_;
 }
@@ -483,6 +964,10 @@ absl::Status SimInputBufferedVCRouter::InitializeImpl(NocSimulator& simulator) {
   const PortIndexMap& port_indexer =
       simulator.GetRoutingTable()->GetPortIndices();
 
+  // Cache the dense routing table, if one was built for this router.
+  dense_routes_ =
+      simulator.GetRoutingTable()->GetDenseRouterRoutingTable(id_);
+
   // Setup structures associated with the inputs.
   //  - input to SimConnectionState (input_connection_index_start_ and count_)
   //  - input_buffers_
@@ -547,6 +1032,49 @@ absl::Status SimInputBufferedVCRouter::InitializeImpl(NocSimulator& simulator) {
   return absl::OkStatus();
 }
 
+SimComponentOutputs SimInputBufferedVCRouter::GetOutputs(
+    NocSimulator& simulator) const {
+  SimComponentOutputs outputs;
+
+  // Input bypass means a flit can be forwarded to an output port and a
+  // credit returned upstream in the same cycle the flit arrives.
+  absl::Span<int64_t> output_connection_index =
+      simulator.GetConnectionIndicesStore(output_connection_index_start_,
+                                          output_connection_count_);
+  for (int64_t i = 0; i < output_connection_count_; ++i) {
+    outputs.forward.push_back(
+        SimComponentOutput{output_connection_index[i], /*combinational=*/true});
+  }
+
+  absl::Span<int64_t> input_connection_index =
+      simulator.GetConnectionIndicesStore(input_connection_index_start_,
+                                          input_connection_count_);
+  for (int64_t i = 0; i < input_connection_count_; ++i) {
+    outputs.reverse.push_back(
+        SimComponentOutput{input_connection_index[i], /*combinational=*/true});
+  }
+
+  return outputs;
+}
+
+bool SimInputBufferedVCRouter::HasPendingActivity(NocSimulator& simulator) {
+  for (const std::vector<DataFlitQueue>& port_buffers : input_buffers_) {
+    for (const DataFlitQueue& buffer : port_buffers) {
+      if (!buffer.queue.empty()) {
+        return true;
+      }
+    }
+  }
+  for (const std::vector<CreditState>& port_credits : credit_update_) {
+    for (const CreditState& credit : port_credits) {
+      if (credit.credit > 0) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 bool SimLink::TryForwardPropagation(NocSimulator& simulator) {
   SimConnectionState& src =
       simulator.GetSimConnectionByIndex(src_connection_index_);
@@ -626,10 +1154,12 @@ bool SimNetworkInterfaceSrc::TryForwardPropagation(NocSimulator& simulator) {
     std::queue<TimedDataFlit>& send_queue = data_to_send_[vc];
     if (!send_queue.empty() && send_queue.front().cycle <= current_cycle) {
       if (credit_[vc] > 0) {
-        sink.forward_channels.flit = send_queue.front().flit;
+        // The queued flit is popped below, so it can be moved onto the
+        // connection rather than copied.
+        sink.forward_channels.flit = std::move(send_queue.front().flit);
         sink.forward_channels.flit.vc = vc;
         sink.forward_channels.cycle = current_cycle;
-        sink.forward_channels.metadata = send_queue.front().metadata;
+        sink.forward_channels.metadata = std::move(send_queue.front().metadata);
         sink.forward_channels.metadata.timed_route_info.route.push_back(
             TimedRouteItem{id_, current_cycle});
 
@@ -713,6 +1243,16 @@ SimInputBufferedVCRouter::GetDestinationPortIndexAndVcIndex(
     int64_t destination_index) {
   DistributedRoutingTable* routes = simulator.GetRoutingTable();
 
+  // Use the dense per-router table when one was built -- a single array
+  // load instead of going through the id-to-index maps on every hop.
+  if (dense_routes_ != nullptr) {
+    XLS_ASSIGN_OR_RETURN(xls::noc::PortIndexAndVCIndex index_to,
+                         dense_routes_->GetOutputPortIndex(
+                             input.port_index, input.vc_index,
+                             destination_index));
+    return PortIndexAndVCIndex{index_to.port_index_, index_to.vc_index_};
+  }
+
   XLS_ASSIGN_OR_RETURN(PortId input_port,
                        routes->GetPortIndices().GetPortByIndex(
                            GetId(), PortDirection::kInput, input.port_index));
@@ -819,9 +1359,8 @@ bool SimInputBufferedVCRouter::TryForwardPropagation(NocSimulator& simulator) {
         continue;
       }
 
-      DataFlit flit = input_buffers_[i][vc].queue.front().flit;
-      TimedDataFlitInfo metadata = input_buffers_[i][vc].queue.front().metadata;
-      int64_t destination_index = flit.destination_index;
+      TimedDataFlit& head = input_buffers_[i][vc].queue.front();
+      int64_t destination_index = head.flit.destination_index;
 
       PortIndexAndVCIndex input{i, vc};
       absl::StatusOr<PortIndexAndVCIndex> output_status =
@@ -835,7 +1374,8 @@ bool SimInputBufferedVCRouter::TryForwardPropagation(NocSimulator& simulator) {
         XLS_VLOG(2) << absl::StreamFormat(
             "... router unable to send data %s vc %d credit now %d"
             " from port index %d to port index %d.",
-            flit, flit.vc, credit_.at(output.port_index).at(output.vc_index), i,
+            head.flit, head.flit.vc,
+            credit_.at(output.port_index).at(output.vc_index), i,
             output.port_index);
         continue;
       }
@@ -848,11 +1388,12 @@ bool SimInputBufferedVCRouter::TryForwardPropagation(NocSimulator& simulator) {
         continue;
       }
 
-      // Now send the flit along.
-      output_state.forward_channels.flit = flit;
+      // Now send the flit along.  The buffered flit is popped below, so
+      // its payload and route metadata can be moved rather than copied.
+      output_state.forward_channels.flit = std::move(head.flit);
       output_state.forward_channels.flit.vc = output.vc_index;
       output_state.forward_channels.cycle = current_cycle;
-      output_state.forward_channels.metadata = metadata;
+      output_state.forward_channels.metadata = std::move(head.metadata);
       output_state.forward_channels.metadata.timed_route_info.route.push_back(
           TimedRouteItem{id_, current_cycle});
 
@@ -999,19 +1540,22 @@ bool SimNetworkInterfaceSink::TryForwardPropagation(NocSimulator& simulator) {
   }
 
   if (src.forward_channels.flit.type != FlitType::kInvalid) {
-    Bits data = src.forward_channels.flit.data;
     int64_t vc = src.forward_channels.flit.vc;
 
     // TODO(tedhong): 2021-01-31 Support blocking traffic at sink.
     // without blocking, the queue never gets empty so we don't
     // emplace into input_buffers_[vc].queue.
+    //
+    // The sink is the sole consumer of the connection, and its driver
+    // fully re-stamps the channel before it is read again, so the flit
+    // and its route metadata can be moved out rather than copied.
     TimedDataFlit received_flit;
     received_flit.cycle = current_cycle;
-    received_flit.flit = src.forward_channels.flit;
-    received_flit.metadata = src.forward_channels.metadata;
+    received_flit.flit = std::move(src.forward_channels.flit);
+    received_flit.metadata = std::move(src.forward_channels.metadata);
     received_flit.metadata.timed_route_info.route.push_back(
         TimedRouteItem{id_, current_cycle});
-    received_traffic_.push_back(received_flit);
+    received_traffic_.push_back(std::move(received_flit));
 
     // Send one credit back
     src.reverse_channels[vc].cycle = current_cycle;
@@ -1021,8 +1565,8 @@ bool SimNetworkInterfaceSink::TryForwardPropagation(NocSimulator& simulator) {
     XLS_VLOG(2) << absl::StreamFormat(
         "... sink %x received data %s on vc %d cycle %d, sending 1 credit on "
         "%x",
-        GetId().AsUInt64(), data.ToString(), vc, current_cycle,
-        src.id.AsUInt64());
+        GetId().AsUInt64(), received_traffic_.back().flit.data.ToString(), vc,
+        current_cycle, src.id.AsUInt64());
   }
 
   // In cycle 0, a full credit update is sent
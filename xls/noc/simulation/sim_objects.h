@@ -16,10 +16,18 @@
 #define XLS_NOC_SIMULATION_SIM_OBJECTS_H_
 
 #include <cstdint>
+#include <deque>
+#include <memory>
 #include <queue>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/noc/simulation/common.h"
 #include "xls/noc/simulation/flit.h"
 #include "xls/noc/simulation/global_routing_table.h"
@@ -67,6 +75,27 @@ struct MetadataFlitQueue {
 
 class NocSimulator;
 
+// Describes a single connection whose channels are driven by a
+// simulation component.  Used by the simulator's activity-tracking kernel
+// to determine which components must be evaluated on a given cycle
+// (see NocSimulator::ComputeActiveComponents).
+struct SimComponentOutput {
+  // Index of the driven connection within the simulator's connection store.
+  int64_t connection_index;
+
+  // True if the driven channel can carry a valid flit in the same cycle
+  // that one of the component's input channels does -- i.e. there is no
+  // pipeline register between the component's inputs and this output.
+  bool combinational;
+};
+
+// All connections driven by a simulation component, split by direction.
+// Forward channels carry data flits, reverse channels carry credits.
+struct SimComponentOutputs {
+  std::vector<SimComponentOutput> forward;
+  std::vector<SimComponentOutput> reverse;
+};
+
 // Common functionality and base class for all simulator objects.
 class SimNetworkComponentBase {
  public:
@@ -78,12 +107,34 @@ class SimNetworkComponentBase {
   // attached to this component have state associated with the current.
   // cycle.
   //
+  // When simulating regions of the network in parallel, do_forward and
+  // do_reverse restrict the tick to a single propagation direction of a
+  // boundary link -- each direction is then owned by the region reading
+  // the corresponding input channels.
+  //
   // See NocSimulator::Tick.
-  bool Tick(NocSimulator& simulator);
+  bool Tick(NocSimulator& simulator, bool do_forward = true,
+            bool do_reverse = true);
 
   // Returns the associated NetworkComponentId.
   NetworkComponentId GetId() const { return id_; }
 
+  // Returns the connections whose channels this component drives.
+  //
+  // The simulator uses this to stamp the outputs of idle components with
+  // invalid flits and to wake up the consumers of an active component.
+  virtual SimComponentOutputs GetOutputs(NocSimulator& simulator) const {
+    return SimComponentOutputs();
+  }
+
+  // Returns true if internal state requires this component to be evaluated
+  // on the current cycle, independent of any flit or credit arriving on its
+  // inputs (ex. buffered flits or a pending credit update).
+  //
+  // Components with work scheduled for a later cycle should instead register
+  // a wake-up via NocSimulator::ScheduleComponentWake().
+  virtual bool HasPendingActivity(NocSimulator& simulator) { return false; }
+
   virtual ~SimNetworkComponentBase() = default;
 
  protected:
@@ -156,6 +207,25 @@ class SimLink : public SimNetworkComponentBase {
   // Get the sink connection index that in used in the simulator.
   int64_t GetSinkConnectionIndex() const;
 
+  // Returns true if the link can serve as a boundary between two
+  // independently simulated regions -- i.e. it is pipelined in both
+  // directions so neither side can observe the other within a cycle.
+  bool IsPartitionBoundary() const {
+    return forward_pipeline_stages_ > 0 && reverse_pipeline_stages_ > 0;
+  }
+
+  // Stamps this cycle's output channels of a boundary link using only the
+  // link's pipeline state.  Called serially before the regions on either
+  // side of the link are simulated in parallel.  Requires
+  // IsPartitionBoundary().
+  void EmitBoundaryOutputs(NocSimulator& simulator);
+
+  SimComponentOutputs GetOutputs(NocSimulator& simulator) const override;
+
+  // The link is busy while a valid flit or credit remains within its
+  // pipeline stages.
+  bool HasPendingActivity(NocSimulator& simulator) override;
+
  private:
   SimLink() = default;
 
@@ -173,10 +243,10 @@ class SimLink : public SimNetworkComponentBase {
   int64_t src_connection_index_;
   int64_t sink_connection_index_;
 
-  std::queue<TimedDataFlit> forward_data_stages_;
+  std::deque<TimedDataFlit> forward_data_stages_;
   int64_t internal_forward_propagated_cycle_;
 
-  std::vector<std::queue<TimedMetadataFlit>> reverse_credit_stages_;
+  std::vector<std::deque<TimedMetadataFlit>> reverse_credit_stages_;
   std::vector<int64_t> internal_reverse_propagated_cycle_;
 };
 
@@ -193,6 +263,13 @@ class SimNetworkInterfaceSrc : public SimNetworkComponentBase {
   // Register a flit to be sent at a specific time.
   absl::Status SendFlitAtTime(TimedDataFlit flit);
 
+  SimComponentOutputs GetOutputs(NocSimulator& simulator) const override;
+
+  // The source is busy while a flit is due to be sent or a credit update
+  // remains to be applied.  Flits to be sent in the future instead schedule
+  // a wake-up with the simulator.
+  bool HasPendingActivity(NocSimulator& simulator) override;
+
  private:
   SimNetworkInterfaceSrc() = default;
 
@@ -204,6 +281,10 @@ class SimNetworkInterfaceSrc : public SimNetworkComponentBase {
   std::vector<int64_t> credit_;
   std::vector<CreditState> credit_update_;
   std::vector<std::queue<TimedDataFlit>> data_to_send_;
+
+  // Cycle of the last wake-up scheduled with the simulator, used to avoid
+  // scheduling duplicate wake-ups for the same flit.
+  int64_t scheduled_wake_cycle_;
 };
 
 // Sink - traffic leaves the network via a sink.
@@ -251,6 +332,8 @@ class SimNetworkInterfaceSink : public SimNetworkComponentBase {
     return bits_per_sec / 1024.0 / 1024.0 / 8.0;
   }
 
+  SimComponentOutputs GetOutputs(NocSimulator& simulator) const override;
+
  private:
   SimNetworkInterfaceSink() = default;
 
@@ -296,6 +379,12 @@ class SimInputBufferedVCRouter : public SimNetworkComponentBase {
 
   int64_t GetUtilizationCycleCount() const;
 
+  SimComponentOutputs GetOutputs(NocSimulator& simulator) const override;
+
+  // The router is busy while a flit is buffered at an input or a credit
+  // update remains to be applied.
+  bool HasPendingActivity(NocSimulator& simulator) override;
+
  private:
   SimInputBufferedVCRouter() = default;
 
@@ -361,6 +450,11 @@ class SimInputBufferedVCRouter : public SimNetworkComponentBase {
 
   // The number of cycles that a transfer from input to output occurred.
   int64_t utilization_cycle_count_;
+
+  // Dense routing table for this router, cached at initialization, or
+  // nullptr if none was built.
+  const DistributedRoutingTable::DenseRouterRoutingTable* dense_routes_ =
+      nullptr;
 };
 
 // Main simulator class that drives the simulation and stores simulation
@@ -370,6 +464,8 @@ class NocSimulator {
   NocSimulator()
       : mgr_(nullptr), params_(nullptr), routing_(nullptr), cycle_(-1) {}
 
+  ~NocSimulator() { ShutdownWorkerThreads(); }
+
   // Creates all simulation objects for a given network.
   // NetworkManager, NocParameters, and DistributedRoutingTable should
   // have aleady been setup.
@@ -381,7 +477,8 @@ class NocSimulator {
     network_ = network;
     cycle_ = -1;
 
-    return CreateSimulationObjects(network);
+    XLS_RETURN_IF_ERROR(CreateSimulationObjects(network));
+    return BuildTickKernel();
   }
 
   NetworkManager* GetNetworkManager() { return mgr_; }
@@ -446,8 +543,25 @@ class NocSimulator {
   absl::Status RunCycle(int64_t max_ticks = 9999);
 
   // Runs a single tick of the simulator.
+  //
+  // Only components marked active for the current cycle are evaluated
+  // (see ComputeActiveComponents).
   bool Tick();
 
+  // Schedules a component to be evaluated on a future cycle, ex. when a
+  // source has a flit to send at a specific time.  Wake-ups are kept in a
+  // calendar of pending events popped at the start of each cycle.
+  void ScheduleComponentWake(NetworkComponentId component, int64_t cycle);
+
+  // Sets the number of worker threads used to simulate regions of the
+  // network in parallel.  The network is partitioned into regions connected
+  // only by links pipelined in both directions; each region is simulated on
+  // a worker thread with synchronization at cycle boundaries.
+  //
+  // A count less than two reverts to single-threaded simulation.  Must be
+  // called after Initialize() and not while a cycle is in progress.
+  absl::Status SetWorkerThreads(int64_t count);
+
   // Register a service to run once at the beginning of each cycle.
   // TODO(tedhong): 2021-07-27 Add a scheme to provide a total order
   //                of services.
@@ -483,6 +597,44 @@ class NocSimulator {
   absl::Status CreateLink(NetworkComponentId nc_id);
   absl::Status CreateRouter(NetworkComponentId nc_id);
 
+  // Builds the structures used by the event-driven tick kernel -- the
+  // component evaluation order and, per component, the connections it
+  // drives and the components observing those connections.
+  absl::Status BuildTickKernel();
+
+  // Computes the set of components that must be evaluated on the current
+  // cycle and stamps the outputs of all idle components with invalid flits
+  // so that their consumers observe an idle cycle and can converge.
+  void ComputeActiveComponents();
+
+  // A component's membership within a region, possibly restricted to a
+  // single propagation direction (for boundary links shared between two
+  // regions).
+  struct RegionItem {
+    int64_t component_index;
+    bool forward;
+    bool reverse;
+  };
+
+  // Partitions the components into regions connected only by boundary
+  // links.  Called from BuildTickKernel().
+  void BuildRegions(absl::Span<const int64_t> forward_driver,
+                    absl::Span<const int64_t> reverse_driver);
+
+  // Runs the convergence loop for the current cycle with regions simulated
+  // on worker threads.
+  absl::Status RunCycleParallel(int64_t max_ticks);
+
+  // Ticks the (active) components of a region until they converge.
+  // Returns false if convergence is not reached within max_ticks.
+  bool RunRegionToConvergence(int64_t region, int64_t max_ticks);
+
+  // Main loop of a parallel simulation worker thread.
+  void WorkerLoop(int64_t worker_index);
+
+  // Stops and joins the worker threads, if any.
+  void ShutdownWorkerThreads();
+
   NetworkManager* mgr_;
   NocParameters* params_;
   DistributedRoutingTable* routing_;
@@ -519,6 +671,49 @@ class NocSimulator {
   std::vector<SimNetworkInterfaceSink> network_interface_sinks_;
   std::vector<SimInputBufferedVCRouter> routers_;
 
+  // All components in evaluation order, along with a map from
+  // NetworkComponentId to an index within components_.
+  std::vector<SimNetworkComponentBase*> components_;
+  absl::flat_hash_map<NetworkComponentId, int64_t> component_index_map_;
+
+  // Per component, the connections whose forward/reverse channels it drives.
+  std::vector<std::vector<int64_t>> driven_forward_connections_;
+  std::vector<std::vector<int64_t>> driven_reverse_connections_;
+
+  // Per component, the components that can observe one of its outputs in the
+  // same cycle (combinational path) vs. only on a later cycle.
+  std::vector<std::vector<int64_t>> same_cycle_consumers_;
+  std::vector<std::vector<int64_t>> delayed_consumers_;
+
+  // Whether each component must be evaluated on the current cycle.
+  std::vector<bool> component_active_;
+
+  // Calendar of pending wake-ups: cycle to component indices.
+  absl::flat_hash_map<int64_t, std::vector<int64_t>> pending_wakeups_;
+
+  // Per region, the components (and directions) it simulates.
+  std::vector<std::vector<RegionItem>> region_items_;
+
+  // Boundary links along with their component indices.  Their output
+  // channels are stamped serially before the regions run in parallel.
+  std::vector<std::pair<SimLink*, int64_t>> boundary_links_;
+
+  // Per region, whether the last parallel cycle converged.  Each entry is
+  // written only by the worker thread owning the region (char rather than
+  // bool so adjacent entries do not share an object).
+  std::vector<char> region_converged_;
+
+  // Worker threads used for parallel simulation and their synchronization
+  // state.  Workers wake when tick_generation_ is incremented and decrement
+  // workers_remaining_ when their regions have converged.
+  int64_t num_worker_threads_ = 0;
+  std::vector<std::unique_ptr<Thread>> worker_threads_;
+  absl::Mutex parallel_mutex_;
+  int64_t tick_generation_ ABSL_GUARDED_BY(parallel_mutex_) = 0;
+  int64_t workers_remaining_ ABSL_GUARDED_BY(parallel_mutex_) = 0;
+  int64_t parallel_max_ticks_ ABSL_GUARDED_BY(parallel_mutex_) = 0;
+  bool shutdown_workers_ ABSL_GUARDED_BY(parallel_mutex_) = false;
+
   // Shims to services to run at the beginning of each cycle.
   std::vector<NocSimulatorServiceShim*> pre_cycle_services_;
 
@@ -16,6 +16,16 @@
 
 namespace xls::noc {
 
+int64_t GeneralizedGeometricTrafficModel::NextInterArrivalDelta() {
+  if (next_delta_index_ >= pregenerated_deltas_.size()) {
+    random_interface_->GeneralizedGeometricBatch(
+        lambda_, burst_prob_, kArrivalBatchSize, pregenerated_deltas_);
+    next_delta_index_ = 0;
+  }
+
+  return pregenerated_deltas_[next_delta_index_++];
+}
+
 std::vector<DataPacket> GeneralizedGeometricTrafficModel::GetNewCyclePackets(
     int64_t cycle) {
   if (next_packet_cycle_ > cycle) {
@@ -37,8 +47,7 @@ std::vector<DataPacket> GeneralizedGeometricTrafficModel::GetNewCyclePackets(
   }
 
   // See if we have a burst of packets.
-  int64_t next_packet_delta =
-      random_interface_->GeneralizedGeometric(lambda_, burst_prob_);
+  int64_t next_packet_delta = NextInterArrivalDelta();
   while (next_packet_delta == 0) {
     // New burst packet.  Rest of the packet fields other than size
     // will be filled later.
@@ -53,8 +62,7 @@ std::vector<DataPacket> GeneralizedGeometricTrafficModel::GetNewCyclePackets(
     XLS_CHECK(burst_packet.ok());
     packets.push_back(burst_packet.value());
 
-    next_packet_delta =
-        random_interface_->GeneralizedGeometric(lambda_, burst_prob_);
+    next_packet_delta = NextInterArrivalDelta();
   }
 
   absl::StatusOr<DataPacket> future_packet =
@@ -151,21 +151,48 @@ class GeneralizedGeometricTrafficModel : public TrafficModel {
   }
 
   double GetLambda() const { return lambda_; }
-  void SetLambda(double lambda) { lambda_ = lambda; }
+  void SetLambda(double lambda) {
+    lambda_ = lambda;
+    DiscardPregeneratedDeltas();
+  }
 
   double GetBurstProb() const { return burst_prob_; }
-  void SetBurstProb(double burst_prob) { burst_prob_ = burst_prob; }
+  void SetBurstProb(double burst_prob) {
+    burst_prob_ = burst_prob;
+    DiscardPregeneratedDeltas();
+  }
 
   RandomNumberInterface* GetRandomNumberInterface() const {
     return random_interface_;
   }
   void SetRandomNumberInterface(RandomNumberInterface& rnd) {
     random_interface_ = &rnd;
+    DiscardPregeneratedDeltas();
   }
 
  private:
+  // Number of inter-arrival times drawn from the random number interface
+  // per batch.
+  static constexpr int64_t kArrivalBatchSize = 1024;
+
+  // Returns the next inter-arrival time, refilling the pre-generated
+  // batch from the random number interface when it runs dry.
+  int64_t NextInterArrivalDelta();
+
+  // Drops pre-generated inter-arrival times, so that the next packet is
+  // drawn with the current distribution parameters.
+  void DiscardPregeneratedDeltas() {
+    pregenerated_deltas_.clear();
+    next_delta_index_ = 0;
+  }
+
   DataPacket next_packet_;
 
+  // Batch of pre-generated inter-arrival times and the index of the next
+  // unconsumed entry.
+  std::vector<int64_t> pregenerated_deltas_;
+  int64_t next_delta_index_ = 0;
+
   double lambda_;      // Lambda of the distribution (unit 1/cycle)
   double burst_prob_;  // Probability of a burst
 
@@ -82,12 +82,42 @@ std::optional<ClampExpr> MatchClampUpperLimit(Node* n) {
   return absl::nullopt;
 }
 
-// MatchArithPatterns matches simple tree patterns to find opportunities
-// for simplification, such as adding a zero, multiplying by 1, etc.
-//
-// Return 'true' if the IR was modified (uses of node was replaced with a
-// different expression).
+}  // namespace
+
 absl::StatusOr<bool> MatchArithPatterns(int64_t opt_level, Node* n) {
+  // Every pattern below is keyed on one of these ops, so any other node can
+  // be rejected on the op alone without evaluating the match chain. This
+  // function runs to fixed point over every node in the graph; most nodes
+  // take this early out. Keep in sync with the patterns below.
+  switch (n->op()) {
+    case Op::kAdd:
+    case Op::kSub:
+    case Op::kNeg:
+    case Op::kNot:
+    case Op::kShll:
+    case Op::kShrl:
+    case Op::kShra:
+    case Op::kAnd:
+    case Op::kOr:
+    case Op::kNand:
+    case Op::kNor:
+    case Op::kXor:
+    case Op::kSMul:
+    case Op::kUMul:
+    case Op::kSMulp:
+    case Op::kUMulp:
+    case Op::kSDiv:
+    case Op::kUDiv:
+    case Op::kUMod:
+    case Op::kSignExt:
+      break;
+    default:
+      if (!OpIsCompare(n->op())) {
+        return false;
+      }
+      break;
+  }
+
   // Pattern: Add/Sub/Or/Xor/Shift a value with 0 on the RHS.
   if ((n->op() == Op::kAdd || n->op() == Op::kSub || n->op() == Op::kShll ||
        n->op() == Op::kShrl || n->op() == Op::kShra) &&
@@ -108,23 +138,24 @@ absl::StatusOr<bool> MatchArithPatterns(int64_t opt_level, Node* n) {
   //
   //   Op(x, y, y, x)  =>  Op(x, y)
   if (n->Is<NaryOp>() && (n->op() == Op::kAnd || n->op() == Op::kOr ||
-                          n->op() == Op::kNand || n->op() == Op::kNor)) {
+                          n->op() == Op::kNand || n->op() == Op::kNor) &&
+      HasDuplicateElement(n->operands())) {
+    // Only build the deduplicated operand list once a duplicate is known to
+    // exist; this match is attempted for every logical op on every pass
+    // invocation and in the common case finds nothing. The scan is quadratic
+    // in the number of operands, but shouldn't cause problems unless we have
+    // at least hundreds of thousands of operands which seems unlikely.
     std::vector<Node*> unique_operands;
     for (Node* operand : n->operands()) {
-      // This is quadratic in the number of operands, but shouldn't cause
-      // problems unless we have at least hundreds of thousands of operands
-      // which seems unlikely.
       if (std::find(unique_operands.begin(), unique_operands.end(), operand) ==
           unique_operands.end()) {
         unique_operands.push_back(operand);
       }
     }
-    if (unique_operands.size() != n->operand_count()) {
-      XLS_VLOG(2) << "FOUND: remove duplicate operands in and/or/nand/nor";
-      XLS_RETURN_IF_ERROR(
-          n->ReplaceUsesWithNew<NaryOp>(unique_operands, n->op()).status());
-      return true;
-    }
+    XLS_VLOG(2) << "FOUND: remove duplicate operands in and/or/nand/nor";
+    XLS_RETURN_IF_ERROR(
+        n->ReplaceUsesWithNew<NaryOp>(unique_operands, n->op()).status());
+    return true;
   }
 
   // Single operand forms of non-inverting logical ops (AND, OR) can be
@@ -174,15 +205,17 @@ absl::StatusOr<bool> MatchArithPatterns(int64_t opt_level, Node* n) {
   auto eliminate_operands_where =
       [n](std::function<bool(Node*)> predicate) -> absl::StatusOr<bool> {
     XLS_RET_CHECK(n->Is<NaryOp>());
+    // Check for an eliminable operand before building the replacement operand
+    // list so the (common) no-match case performs no allocation.
+    if (!AnyOperandWhere(n, predicate)) {
+      return false;
+    }
     std::vector<Node*> new_operands;
     for (Node* operand : n->operands()) {
       if (!predicate(operand)) {
         new_operands.push_back(operand);
       }
     }
-    if (new_operands.size() == n->operand_count()) {
-      return false;
-    }
     if (new_operands.empty()) {
       XLS_RETURN_IF_ERROR(
           n
@@ -692,8 +725,6 @@ absl::StatusOr<bool> MatchArithPatterns(int64_t opt_level, Node* n) {
   return false;
 }
 
-}  // namespace
-
 absl::StatusOr<bool> ArithSimplificationPass::RunOnFunctionBaseInternal(
     FunctionBase* f, const PassOptions& options, PassResults* results) const {
   return TransformNodesToFixedPoint(
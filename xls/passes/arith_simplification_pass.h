@@ -21,6 +21,13 @@
 
 namespace xls {
 
+// MatchArithPatterns matches simple tree patterns rooted at the given node to
+// find opportunities for simplification, such as adding a zero, multiplying
+// by 1, etc. Returns 'true' if the IR was modified (uses of node were
+// replaced with a different expression). Exposed so the unified peephole
+// simplification pass can run the same rules from its worklist.
+absl::StatusOr<bool> MatchArithPatterns(int64_t opt_level, Node* n);
+
 // class ArithSimplificationPass analyzes the IR and finds some
 // simple patterns it can simplify, e.g., things like mul by 1,
 // add of 0, etc.
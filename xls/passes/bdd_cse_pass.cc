@@ -94,8 +94,15 @@ absl::StatusOr<std::vector<Node*>> GetNodeOrder(FunctionBase* f) {
 
 absl::StatusOr<bool> BddCsePass::RunOnFunctionBaseInternal(
     FunctionBase* f, const PassOptions& options, PassResults* results) const {
-  XLS_ASSIGN_OR_RETURN(std::unique_ptr<BddFunction> bdd_function,
-                       BddFunction::Run(f, BddFunction::kDefaultPathLimit));
+  // Reuse the BDD computed by an earlier pass if `f` is unchanged since then.
+  BddFunction* bdd_function = results->analysis_cache.Get<BddFunction>(f);
+  if (bdd_function == nullptr) {
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<BddFunction> owned_bdd,
+                         BddFunction::Run(f, BddFunction::kDefaultPathLimit,
+                                          /*node_filter=*/absl::nullopt,
+                                          BddFunction::kDefaultOpBudget));
+    bdd_function = results->analysis_cache.Put(f, std::move(owned_bdd));
+  }
 
   // To improve efficiency, bucket potentially common nodes together. The
   // bucketing is done via a int64_t hash value of the BDD node indices of each
@@ -17,14 +17,19 @@
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"
+#include "absl/hash/hash.h"
 #include "absl/memory/memory.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/tracing.h"
 #include "xls/interpreter/ir_interpreter.h"
 #include "xls/ir/abstract_evaluator.h"
 #include "xls/ir/abstract_node_evaluator.h"
@@ -81,8 +86,9 @@ BddNodeVector ToBddNodeVector(const SaturatingBddNodeVector& input) {
 class SaturatingBddEvaluator
     : public AbstractEvaluator<SaturatingBddNodeIndex, SaturatingBddEvaluator> {
  public:
-  SaturatingBddEvaluator(int64_t path_limit, BinaryDecisionDiagram* bdd)
-      : path_limit_(path_limit), bdd_(bdd) {}
+  SaturatingBddEvaluator(int64_t path_limit, int64_t op_budget,
+                         BinaryDecisionDiagram* bdd)
+      : path_limit_(path_limit), op_budget_(op_budget), bdd_(bdd) {}
 
   SaturatingBddNodeIndex One() const { return bdd_->one(); }
 
@@ -92,6 +98,8 @@ class SaturatingBddEvaluator
     if (absl::holds_alternative<TooManyPaths>(input)) {
       return TooManyPaths();
     }
+    // Negation is constant time (a complement edge) so it is not counted
+    // against the operation budget.
     BddNodeIndex result = bdd_->Not(absl::get<BddNodeIndex>(input));
     if (path_limit_ > 0 && bdd_->path_count(result) > path_limit_) {
       return TooManyPaths();
@@ -102,9 +110,10 @@ class SaturatingBddEvaluator
   SaturatingBddNodeIndex And(const SaturatingBddNodeIndex& a,
                              const SaturatingBddNodeIndex& b) const {
     if (absl::holds_alternative<TooManyPaths>(a) ||
-        absl::holds_alternative<TooManyPaths>(b)) {
+        absl::holds_alternative<TooManyPaths>(b) || OverOpBudget()) {
       return TooManyPaths();
     }
+    ++ops_used_;
     BddNodeIndex result =
         bdd_->And(absl::get<BddNodeIndex>(a), absl::get<BddNodeIndex>(b));
     if (path_limit_ > 0 && bdd_->path_count(result) > path_limit_) {
@@ -116,9 +125,10 @@ class SaturatingBddEvaluator
   SaturatingBddNodeIndex Or(const SaturatingBddNodeIndex& a,
                             const SaturatingBddNodeIndex& b) const {
     if (absl::holds_alternative<TooManyPaths>(a) ||
-        absl::holds_alternative<TooManyPaths>(b)) {
+        absl::holds_alternative<TooManyPaths>(b) || OverOpBudget()) {
       return TooManyPaths();
     }
+    ++ops_used_;
     BddNodeIndex result =
         bdd_->Or(absl::get<BddNodeIndex>(a), absl::get<BddNodeIndex>(b));
     if (path_limit_ > 0 && bdd_->path_count(result) > path_limit_) {
@@ -127,8 +137,19 @@ class SaturatingBddEvaluator
     return result;
   }
 
+  // Resets the operation counter. Called before evaluating each XLS node so
+  // the budget bounds per-node (not cumulative) construction work.
+  void ResetOpCount() { ops_used_ = 0; }
+  int64_t ops_used() const { return ops_used_; }
+
  private:
+  bool OverOpBudget() const {
+    return op_budget_ > 0 && ops_used_ >= op_budget_;
+  }
+
   int64_t path_limit_;
+  int64_t op_budget_;
+  mutable int64_t ops_used_ = 0;
   BinaryDecisionDiagram* bdd_;
 };
 
@@ -254,29 +275,199 @@ bool ShouldEvaluate(Node* node) {
   XLS_LOG(FATAL) << "Invalid op: " << static_cast<int64_t>(node->op());
 }
 
+// Returns `order` with the bits within each run of consecutive labels
+// belonging to the same node reversed, so most significant bits come first.
+// Expressions which mostly depend on high bits (sign tests, range checks
+// against round constants) shrink when the deciding bits sit at the top of the
+// BDD.
+BddVariableOrder MsbFirstOrder(const BddVariableOrder& order) {
+  BddVariableOrder result;
+  result.reserve(order.size());
+  int64_t i = 0;
+  while (i < static_cast<int64_t>(order.size())) {
+    int64_t j = i;
+    while (j < static_cast<int64_t>(order.size()) &&
+           order[j].node_name == order[i].node_name) {
+      ++j;
+    }
+    for (int64_t k = j - 1; k >= i; --k) {
+      result.push_back(order[k]);
+    }
+    i = j;
+  }
+  return result;
+}
+
+// Returns `order` with the bits of paired nodes interleaved at equal
+// significance, or an empty order if no pairs were found. Nodes are paired if
+// they are the two operands of a bitwise or comparison operation and both are
+// modeled as BDD variables (e.g. parameters). Comparator-like structures --
+// equality networks, reductions of a bitwise difference -- have exponentially
+// sized BDDs when all of one operand's bits precede the other's, but linearly
+// sized ones when the bits are interleaved.
+BddVariableOrder InterleavedOrder(FunctionBase* f,
+                                  const BddVariableOrder& order) {
+  absl::flat_hash_map<std::string, std::string> partner;
+  for (Node* node : f->nodes()) {
+    if (node->operand_count() != 2) {
+      continue;
+    }
+    switch (node->op()) {
+      case Op::kAnd:
+      case Op::kNand:
+      case Op::kNor:
+      case Op::kOr:
+      case Op::kXor:
+      case Op::kEq:
+      case Op::kNe:
+      case Op::kUGe:
+      case Op::kUGt:
+      case Op::kULe:
+      case Op::kULt:
+        break;
+      default:
+        continue;
+    }
+    Node* a = node->operand(0);
+    Node* b = node->operand(1);
+    if (a == b || !a->GetType()->IsBits() || !b->GetType()->IsBits() ||
+        a->BitCountOrDie() != b->BitCountOrDie() || a->BitCountOrDie() < 2 ||
+        ShouldEvaluate(a) || ShouldEvaluate(b)) {
+      continue;
+    }
+    std::string a_name = a->GetName();
+    std::string b_name = b->GetName();
+    if (partner.contains(a_name) || partner.contains(b_name)) {
+      continue;
+    }
+    partner[a_name] = b_name;
+    partner[b_name] = a_name;
+  }
+  if (partner.empty()) {
+    return {};
+  }
+
+  // Gather each node's bits, preserving their existing relative order and the
+  // order in which nodes first appear.
+  std::vector<std::string> name_sequence;
+  absl::flat_hash_map<std::string, std::vector<int64_t>> bits_by_name;
+  for (const BddBitLabel& label : order) {
+    auto [it, inserted] = bits_by_name.try_emplace(label.node_name);
+    if (inserted) {
+      name_sequence.push_back(label.node_name);
+    }
+    it->second.push_back(label.bit_index);
+  }
+
+  BddVariableOrder result;
+  result.reserve(order.size());
+  absl::flat_hash_set<std::string> emitted;
+  for (const std::string& name : name_sequence) {
+    if (emitted.contains(name)) {
+      continue;
+    }
+    emitted.insert(name);
+    auto partner_it = partner.find(name);
+    if (partner_it == partner.end() ||
+        !bits_by_name.contains(partner_it->second)) {
+      for (int64_t bit : bits_by_name.at(name)) {
+        result.push_back(BddBitLabel{name, bit});
+      }
+      continue;
+    }
+    const std::string& partner_name = partner_it->second;
+    emitted.insert(partner_name);
+    const std::vector<int64_t>& a_bits = bits_by_name.at(name);
+    const std::vector<int64_t>& b_bits = bits_by_name.at(partner_name);
+    int64_t count =
+        static_cast<int64_t>(std::max(a_bits.size(), b_bits.size()));
+    for (int64_t i = 0; i < count; ++i) {
+      if (i < static_cast<int64_t>(a_bits.size())) {
+        result.push_back(BddBitLabel{name, a_bits[i]});
+      }
+      if (i < static_cast<int64_t>(b_bits.size())) {
+        result.push_back(BddBitLabel{partner_name, b_bits[i]});
+      }
+    }
+  }
+  return result;
+}
+
+// In-process cache of variable orders discovered by RunWithReordering, keyed
+// by a hash of the function's IR text. A colliding or stale entry can only
+// yield a suboptimal order -- orders never affect the functions the BDD
+// represents -- so a bare hash key is safe.
+ABSL_CONST_INIT absl::Mutex variable_order_cache_mutex(absl::kConstInit);
+absl::flat_hash_map<uint64_t, BddVariableOrder>& VariableOrderCache()
+    ABSL_EXCLUSIVE_LOCKS_REQUIRED(variable_order_cache_mutex) {
+  static auto* cache = new absl::flat_hash_map<uint64_t, BddVariableOrder>;
+  return *cache;
+}
+
 }  // namespace
 
 /* static */ absl::StatusOr<std::unique_ptr<BddFunction>> BddFunction::Run(
     FunctionBase* f, int64_t path_limit,
-    std::optional<std::function<bool(const Node*)>> node_filter) {
+    std::optional<std::function<bool(const Node*)>> node_filter,
+    int64_t op_budget, const BddVariableOrder& variable_order) {
   XLS_VLOG(1) << absl::StreamFormat("BddFunction::Run(%s):", f->name());
+  ScopedTraceEvent trace_event("BddFunction::Run");
   XLS_VLOG_LINES(5, f->DumpIr());
 
   auto bdd_function = absl::WrapUnique(new BddFunction(f));
-  SaturatingBddEvaluator evaluator(path_limit, &bdd_function->bdd());
+  SaturatingBddEvaluator evaluator(path_limit, op_budget,
+                                   &bdd_function->bdd());
+
+  // Create BDD variables up front for the bits listed in the explicit variable
+  // order (if any). Entries naming unknown nodes or out-of-range bits are
+  // ignored so a stale order is harmless.
+  absl::flat_hash_map<std::pair<Node*, int64_t>, BddNodeIndex>
+      preassigned_variables;
+  if (!variable_order.empty()) {
+    absl::flat_hash_map<std::string, Node*> nodes_by_name;
+    for (Node* node : f->nodes()) {
+      nodes_by_name[node->GetName()] = node;
+    }
+    for (const BddBitLabel& label : variable_order) {
+      auto it = nodes_by_name.find(label.node_name);
+      if (it == nodes_by_name.end() || !it->second->GetType()->IsBits() ||
+          label.bit_index < 0 ||
+          label.bit_index >= it->second->BitCountOrDie()) {
+        continue;
+      }
+      auto key = std::make_pair(it->second, label.bit_index);
+      if (!preassigned_variables.contains(key)) {
+        preassigned_variables[key] = bdd_function->bdd().NewVariable();
+        bdd_function->variable_order_.push_back(label);
+      }
+    }
+  }
+
+  // Returns the BDD variable for the given bit of the given node, creating it
+  // (and recording its label) if it was not preassigned by the explicit order.
+  auto new_variable = [&](Node* n, int64_t bit_index) -> BddNodeIndex {
+    auto it = preassigned_variables.find(std::make_pair(n, bit_index));
+    if (it != preassigned_variables.end()) {
+      return it->second;
+    }
+    BddNodeIndex variable = bdd_function->bdd().NewVariable();
+    bdd_function->variable_order_.push_back(
+        BddBitLabel{n->GetName(), bit_index});
+    return variable;
+  };
 
   // Create and return a vector containing newly defined BDD variables.
   auto create_new_node_vector = [&](Node* n) {
     SaturatingBddNodeVector v;
     for (int64_t i = 0; i < n->BitCountOrDie(); ++i) {
-      v.push_back(bdd_function->bdd().NewVariable());
+      v.push_back(new_variable(n, i));
     }
     bdd_function->saturated_expressions_.insert(n);
     return v;
   };
 
   XLS_VLOG(3) << "BDD expressions:";
-  absl::flat_hash_map<Node*, SaturatingBddNodeVector> values;
+  NodeIndexedVector<SaturatingBddNodeVector> values(f);
   for (Node* node : TopoSort(f)) {
     if (!node->GetType()->IsBits()) {
       continue;
@@ -294,17 +485,24 @@ bool ShouldEvaluate(Node* node) {
       for (Node* operand : node->operands()) {
         operand_values.push_back(values.at(operand));
       }
+      evaluator.ResetOpCount();
       XLS_ASSIGN_OR_RETURN(
           values[node],
           AbstractEvaluate(node, operand_values, &evaluator,
                            /*default_handler=*/create_new_node_vector));
+      if (op_budget > 0 && evaluator.ops_used() >= op_budget) {
+        XLS_VLOG(3) << absl::StreamFormat(
+            "Node %s exhausted the BDD operation budget (%d ops)",
+            node->GetName(), op_budget);
+      }
 
       // Associate a new BDD variable with each bit that exceeded the path
       // limit.
-      for (SaturatingBddNodeIndex& value : values.at(node)) {
-        if (absl::holds_alternative<TooManyPaths>(value)) {
+      SaturatingBddNodeVector& node_values = values.at(node);
+      for (int64_t i = 0; i < static_cast<int64_t>(node_values.size()); ++i) {
+        if (absl::holds_alternative<TooManyPaths>(node_values[i])) {
           bdd_function->saturated_expressions_.insert(node);
-          value = bdd_function->bdd().NewVariable();
+          node_values[i] = new_variable(node, i);
         }
       }
     }
@@ -321,12 +519,85 @@ bool ShouldEvaluate(Node* node) {
   // Copy over the vector and BDD variables into the node map which is exposed
   // via the BddFunction interface. At this point any TooManyPaths sentinel
   // values have been replaced with new Bdd variables.
-  for (const auto& pair : values) {
-    bdd_function->node_map_[pair.first] = ToBddNodeVector(pair.second);
+  for (Node* node : f->nodes()) {
+    if (values.contains(node)) {
+      bdd_function->node_map_[node] = ToBddNodeVector(values.at(node));
+    }
+  }
+
+  // Evaluation builds up many intermediate expressions which are no longer
+  // referenced once the per-bit expressions have been extracted. Reclaim them
+  // before the BddFunction is used, remapping the node map to the compacted
+  // handles.
+  std::vector<BddNodeIndex*> root_ptrs;
+  std::vector<BddNodeIndex> roots;
+  for (Node* node : f->nodes()) {
+    if (!bdd_function->node_map_.contains(node)) {
+      continue;
+    }
+    for (BddNodeIndex& bdd_node : bdd_function->node_map_.at(node)) {
+      root_ptrs.push_back(&bdd_node);
+      roots.push_back(bdd_node);
+    }
+  }
+  std::vector<BddNodeIndex> remapped_roots =
+      bdd_function->bdd().GarbageCollect(roots);
+  for (int64_t i = 0; i < static_cast<int64_t>(root_ptrs.size()); ++i) {
+    *root_ptrs[i] = remapped_roots[i];
   }
   return std::move(bdd_function);
 }
 
+/* static */ absl::StatusOr<std::unique_ptr<BddFunction>>
+BddFunction::RunWithReordering(
+    FunctionBase* f, int64_t path_limit,
+    std::optional<std::function<bool(const Node*)>> node_filter,
+    int64_t op_budget, absl::Duration reorder_budget) {
+  uint64_t cache_key = absl::Hash<std::string>()(f->DumpIr());
+  {
+    absl::MutexLock lock(&variable_order_cache_mutex);
+    auto it = VariableOrderCache().find(cache_key);
+    if (it != VariableOrderCache().end()) {
+      XLS_VLOG(1) << absl::StreamFormat(
+          "BddFunction::RunWithReordering(%s): using cached variable order",
+          f->name());
+      return Run(f, path_limit, node_filter, op_budget, it->second);
+    }
+  }
+
+  absl::Time deadline = absl::Now() + reorder_budget;
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<BddFunction> best,
+                       Run(f, path_limit, node_filter, op_budget));
+
+  std::vector<BddVariableOrder> candidates;
+  BddVariableOrder interleaved = InterleavedOrder(f, best->variable_order());
+  if (!interleaved.empty()) {
+    candidates.push_back(std::move(interleaved));
+  }
+  candidates.push_back(MsbFirstOrder(best->variable_order()));
+
+  for (const BddVariableOrder& candidate : candidates) {
+    if (absl::Now() >= deadline) {
+      break;
+    }
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<BddFunction> trial,
+                         Run(f, path_limit, node_filter, op_budget, candidate));
+    XLS_VLOG(2) << absl::StreamFormat(
+        "RunWithReordering(%s): candidate order yields %d BDD nodes (best so "
+        "far %d)",
+        f->name(), trial->bdd().size(), best->bdd().size());
+    if (trial->bdd().size() < best->bdd().size()) {
+      best = std::move(trial);
+    }
+  }
+
+  {
+    absl::MutexLock lock(&variable_order_cache_mutex);
+    VariableOrderCache()[cache_key] = best->variable_order();
+  }
+  return std::move(best);
+}
+
 absl::StatusOr<Value> BddFunction::Evaluate(
     absl::Span<const Value> args) const {
   if (!func_base_->IsFunction()) {
@@ -17,16 +17,29 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
+#include "absl/time/time.h"
 #include "xls/common/logging/logging.h"
 #include "xls/data_structures/binary_decision_diagram.h"
 #include "xls/data_structures/leaf_type_tree.h"
 #include "xls/ir/function.h"
+#include "xls/ir/node_indexed_vector.h"
 #include "xls/ir/op.h"
 
 namespace xls {
 
 using BddNodeVector = std::vector<BddNodeIndex>;
-using NodeMap = absl::flat_hash_map<const Node*, BddNodeVector>;
+using NodeMap = NodeIndexedVector<BddNodeVector>;
+
+// Identifies a single BDD input bit: an XLS node which is modeled as BDD
+// variables and a bit offset within it. Variable orders are expressed as
+// sequences of these labels. Node names (rather than pointers) make an order
+// reusable across rebuilds of the same function and across structurally
+// identical functions in later compiles.
+struct BddBitLabel {
+  std::string node_name;
+  int64_t bit_index;
+};
+using BddVariableOrder = std::vector<BddBitLabel>;
 
 // A class which represents an XLS function using a binary decision diagram
 // (BDD). The BDD is constructed by an abstract evaluation of the operations in
@@ -48,6 +61,14 @@ class BddFunction {
   // variable. This provides a mechanism for limiting the growth of the BDD.
   static constexpr int64_t kDefaultPathLimit = 16 * 1024;
 
+  // The default limit on the number of BDD operations (And/Or calls) spent
+  // constructing the expressions of a single XLS node. The path limit bounds
+  // the size of the final expression but a pathological node can still burn
+  // arbitrary time building large intermediate expressions before saturating;
+  // the operation budget bounds the construction work itself. When the budget
+  // is exhausted the remaining bits of the node saturate to new variables.
+  static constexpr int64_t kDefaultOpBudget = 256 * 1024;
+
   // Construct a BDD representing the given function/proc.
   // `node_filter` is an optional function which filters the nodes to be
   // evaluated. If this function returns false for a node then the node will not
@@ -55,10 +76,34 @@ class BddFunction {
   // for which no information is known. If `node_filter` returns true, the node
   // still might *not* be evaluated because some kinds of nodes are never
   // evaluated for various reasons including computation expense.
+  // `op_budget` is the maximum number of BDD operations to spend on any
+  // single XLS node; zero means no limit.
+  // `variable_order` optionally fixes the BDD variable order: the listed bits
+  // are assigned BDD variables in the given sequence before evaluation begins,
+  // and any bits not listed are assigned variables in traversal order as
+  // usual. Entries naming nodes or bits which do not exist are ignored, so a
+  // stale order is harmless. The order affects only the size of the BDD, never
+  // the functions it represents.
   static absl::StatusOr<std::unique_ptr<BddFunction>> Run(
       FunctionBase* f, int64_t path_limit = 0,
       std::optional<std::function<bool(const Node*)>> node_filter =
-          absl::nullopt);
+          absl::nullopt,
+      int64_t op_budget = 0, const BddVariableOrder& variable_order = {});
+
+  // As Run(), but additionally searches for a variable order which keeps the
+  // BDD small. A process-wide cache of orders discovered by earlier calls,
+  // keyed by the function's IR text, is consulted first so later compiles of
+  // the same design start from a known-good order. On a cache miss the
+  // function is built with the default order and then with candidate orders
+  // (comparator operand bits interleaved at equal significance, most
+  // significant bits first) until `reorder_budget` of wall time is spent; the
+  // order yielding the smallest BDD wins and is cached.
+  static absl::StatusOr<std::unique_ptr<BddFunction>> RunWithReordering(
+      FunctionBase* f, int64_t path_limit = 0,
+      std::optional<std::function<bool(const Node*)>> node_filter =
+          absl::nullopt,
+      int64_t op_budget = 0,
+      absl::Duration reorder_budget = absl::Seconds(1));
 
   // Returns the underlying BDD.
   const BinaryDecisionDiagram& bdd() const { return bdd_; }
@@ -70,6 +115,11 @@ class BddFunction {
     return node_map_.at(node).at(bit_index);
   }
 
+  // Returns the order in which BDD variables were created, one label per
+  // variable. Passing this (or a permutation of it) as `variable_order` to a
+  // later Run() reproduces (or changes) the variable order.
+  const BddVariableOrder& variable_order() const { return variable_order_; }
+
   // Evaluates the function using the BDD with the given argument values.
   // Operations such as arithmetic operations which are not expressed in the BDD
   // are evaluated using the IR interpreter. This method is for testing purposes
@@ -87,6 +137,9 @@ class BddFunction {
   // expression.
   NodeMap node_map_;
 
+  // Labels of the BDD variables in creation order.
+  BddVariableOrder variable_order_;
+
   // Set containing the Nodes which have exceeded the maximum number of paths
   // from the XLS node's BDD node to the terminal nodes 0 and 1 in the
   // BDD. These are the XLS Nodes for which it was determined the precisely
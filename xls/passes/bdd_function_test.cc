@@ -17,6 +17,7 @@
 #include <memory>
 #include <random>
 
+#include "absl/time/time.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "xls/common/status/matchers.h"
@@ -80,6 +81,25 @@ TEST_F(BddFunctionTest, AndNot) {
               IsOkAndHolds(Value(UBits(0, 8))));
 }
 
+TEST_F(BddFunctionTest, OpBudgetSaturates) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  Type* t = p->GetBitsType(8);
+  BValue x = fb.Param("x", t);
+  BValue y = fb.Param("y", t);
+  fb.Or(fb.And(x, y), fb.Xor(x, y));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+  // With a one-operation budget the nodes saturate to variables, but
+  // evaluation still produces correct results via the interpreter fallback.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<BddFunction> bdd_function,
+      BddFunction::Run(f, /*path_limit=*/0, /*node_filter=*/absl::nullopt,
+                       /*op_budget=*/1));
+  EXPECT_THAT(bdd_function->Evaluate(
+                  {Value(UBits(0b11110000, 8)), Value(UBits(0b10101010, 8))}),
+              IsOkAndHolds(Value(UBits(0b11111010, 8))));
+}
+
 TEST_F(BddFunctionTest, Parity) {
   auto p = CreatePackage();
   FunctionBuilder fb(TestName(), p.get());
@@ -112,6 +132,40 @@ TEST_F(BddFunctionTest, Parity) {
   }
 }
 
+TEST_F(BddFunctionTest, ReorderingShrinksComparatorBdd) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  Type* t = p->GetBitsType(8);
+  BValue x = fb.Param("x", t);
+  BValue y = fb.Param("y", t);
+  // A structural equality comparator: all bits of x and y pairwise equal.
+  fb.AndReduce(fb.Not(fb.Xor(x, y)));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BddFunction> default_order,
+                           BddFunction::Run(f));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<BddFunction> reordered,
+      BddFunction::RunWithReordering(f, /*path_limit=*/0,
+                                     /*node_filter=*/absl::nullopt,
+                                     /*op_budget=*/0,
+                                     /*reorder_budget=*/absl::Seconds(10)));
+  // With the default order all of x's bits precede all of y's and the
+  // comparator BDD is exponentially sized; interleaving the operand bits at
+  // equal significance makes it linear.
+  EXPECT_LT(reordered->bdd().size(), default_order->bdd().size());
+  EXPECT_THAT(reordered->Evaluate({Value(UBits(42, 8)), Value(UBits(42, 8))}),
+              IsOkAndHolds(Value(UBits(1, 1))));
+  EXPECT_THAT(reordered->Evaluate({Value(UBits(42, 8)), Value(UBits(43, 8))}),
+              IsOkAndHolds(Value(UBits(0, 1))));
+
+  // A second call hits the in-process order cache and reproduces the same
+  // sized BDD without searching.
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BddFunction> cached,
+                           BddFunction::RunWithReordering(f));
+  EXPECT_EQ(cached->bdd().size(), reordered->bdd().size());
+}
+
 TEST_F(BddFunctionTest, BenchmarkTest) {
   // Run samples through various bechmarks and verify against the interpreter.
   //
@@ -14,6 +14,7 @@
 
 #include "xls/passes/bdd_query_engine.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
@@ -25,10 +26,56 @@
 #include "xls/passes/query_engine.h"
 
 namespace xls {
+namespace {
+
+// Returns the nodes worth spending BDD construction effort on in targeted
+// mode: single-bit values (comparison outputs among them), the selectors of
+// select-like operations, and the transitive fan-in cones of all of these.
+absl::flat_hash_set<const Node*> PriorityNodeCone(FunctionBase* f) {
+  std::vector<Node*> worklist;
+  for (Node* node : f->nodes()) {
+    if (node->GetType()->IsBits() && node->BitCountOrDie() == 1) {
+      worklist.push_back(node);
+    }
+    if (node->Is<Select>()) {
+      worklist.push_back(node->As<Select>()->selector());
+    } else if (node->Is<OneHotSelect>()) {
+      worklist.push_back(node->As<OneHotSelect>()->selector());
+    } else if (node->Is<PrioritySelect>()) {
+      worklist.push_back(node->As<PrioritySelect>()->selector());
+    } else if (node->Is<OneHot>()) {
+      worklist.push_back(node->operand(0));
+    }
+  }
+  absl::flat_hash_set<const Node*> cone;
+  while (!worklist.empty()) {
+    Node* node = worklist.back();
+    worklist.pop_back();
+    if (!cone.insert(node).second) {
+      continue;
+    }
+    for (Node* operand : node->operands()) {
+      worklist.push_back(operand);
+    }
+  }
+  return cone;
+}
+
+}  // namespace
 
 absl::StatusOr<ReachedFixpoint> BddQueryEngine::Populate(FunctionBase* f) {
-  XLS_ASSIGN_OR_RETURN(bdd_function_,
-                       BddFunction::Run(f, path_limit_, node_filter_));
+  std::optional<std::function<bool(const Node*)>> node_filter = node_filter_;
+  absl::flat_hash_set<const Node*> priority_nodes;
+  if (targeted_) {
+    priority_nodes = PriorityNodeCone(f);
+    node_filter = [this, &priority_nodes](const Node* n) {
+      return priority_nodes.contains(n) &&
+             (!node_filter_.has_value() || (*node_filter_)(n));
+    };
+  }
+  XLS_ASSIGN_OR_RETURN(
+      bdd_function_,
+      BddFunction::Run(f, path_limit_, node_filter, op_budget_));
   // Construct the Bits objects indication which bit values are statically known
   // for each node and what those values are (0 or 1) if known.
   BinaryDecisionDiagram& bdd = this->bdd();
@@ -40,11 +40,25 @@ class BddQueryEngine : public QueryEngine {
   // terminals 0 and 1 to allow for a BDD expression before truncating it.
   // `node_filter` is an optional function which can be used to limit the nodes
   // which the BDD evaluates (returning false means the node will node be
-  // evaluated). See BddFunction for details.
+  // evaluated). `op_budget` is the maximum number of BDD operations spent
+  // constructing the expressions of a single node (zero means no limit). See
+  // BddFunction for details.
+  //
+  // If `targeted` is true, only a prioritized subset of nodes is evaluated:
+  // single-bit values (which includes comparison outputs), the selectors of
+  // select-like operations, and the transitive fan-in cones of all of these.
+  // Nodes outside the subset are modeled as free variables: still tracked, but
+  // with no bits known. This captures nearly all of the value the BDD provides
+  // to the simplification passes while skipping the expensive expressions of
+  // wide arithmetic nodes that no single-bit query ever looks at.
   explicit BddQueryEngine(int64_t path_limit = 0,
                           std::optional<std::function<bool(const Node*)>>
-                              node_filter = absl::nullopt)
-      : path_limit_(path_limit), node_filter_(node_filter) {}
+                              node_filter = absl::nullopt,
+                          int64_t op_budget = 0, bool targeted = false)
+      : path_limit_(path_limit),
+        node_filter_(node_filter),
+        op_budget_(op_budget),
+        targeted_(targeted) {}
 
   absl::StatusOr<ReachedFixpoint> Populate(FunctionBase* f) override;
 
@@ -107,6 +121,13 @@ class BddQueryEngine : public QueryEngine {
 
   std::optional<std::function<bool(const Node*)>> node_filter_;
 
+  // Maximum BDD operations spent constructing any single node's expressions.
+  int64_t op_budget_;
+
+  // Whether to restrict evaluation to the prioritized node subset; see the
+  // constructor comment.
+  bool targeted_;
+
   // Indicates the bits at the output of each node which have known values.
   absl::flat_hash_map<Node*, Bits> known_bits_;
 
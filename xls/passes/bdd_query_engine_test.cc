@@ -291,5 +291,32 @@ TEST_F(BddQueryEngineTest, BitValuesImplyNodeValuePredicateAlwaysFalse) {
   EXPECT_FALSE(result.has_value());
 }
 
+TEST_F(BddQueryEngineTest, TargetedModeEvaluatesOnlyPriorityCones) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(32));
+  BValue y = fb.Param("y", p->GetBitsType(32));
+  // A wide value feeding no single-bit logic or selector; its known high bit
+  // is not visible in targeted mode.
+  BValue wide = fb.Concat({fb.Literal(UBits(0, 1)), fb.Add(x, y)});
+  // Single-bit logic whose cone includes a comparison; fully analyzed in
+  // targeted mode.
+  BValue cmp = fb.Eq(x, y);
+  BValue contradiction = fb.And(cmp, fb.Not(cmp));
+  fb.Tuple({wide, contradiction});
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  BddQueryEngine targeted(/*path_limit=*/0, /*node_filter=*/absl::nullopt,
+                          /*op_budget=*/0, /*targeted=*/true);
+  XLS_ASSERT_OK(targeted.Populate(f).status());
+  EXPECT_TRUE(targeted.IsZero(TreeBitLocation(contradiction.node(), 0)));
+  EXPECT_FALSE(targeted.IsKnown(TreeBitLocation(wide.node(), 32)));
+
+  // The untargeted engine does see the wide node's known bit.
+  BddQueryEngine full;
+  XLS_ASSERT_OK(full.Populate(f).status());
+  EXPECT_TRUE(full.IsZero(TreeBitLocation(wide.node(), 32)));
+}
+
 }  // namespace
 }  // namespace xls
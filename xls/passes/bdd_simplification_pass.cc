@@ -327,18 +327,26 @@ absl::StatusOr<bool> SimplifyNode(Node* node, const QueryEngine& query_engine,
 
 absl::StatusOr<bool> BddSimplificationPass::RunOnFunctionBaseInternal(
     FunctionBase* f, const PassOptions& options, PassResults* results) const {
-  BddQueryEngine query_engine(BddFunction::kDefaultPathLimit);
-  XLS_RETURN_IF_ERROR(query_engine.Populate(f).status());
+  // Reuse the query engine computed by an earlier pass if `f` is unchanged
+  // since then.
+  BddQueryEngine* query_engine = results->analysis_cache.Get<BddQueryEngine>(f);
+  if (query_engine == nullptr) {
+    auto owned_query_engine = std::make_unique<BddQueryEngine>(
+        BddFunction::kDefaultPathLimit, /*node_filter=*/absl::nullopt,
+        BddFunction::kDefaultOpBudget);
+    XLS_RETURN_IF_ERROR(owned_query_engine->Populate(f).status());
+    query_engine = results->analysis_cache.Put(f, std::move(owned_query_engine));
+  }
 
   bool modified = false;
   for (Node* node : TopoSort(f)) {
     XLS_ASSIGN_OR_RETURN(bool node_modified,
-                         SimplifyNode(node, query_engine, opt_level_));
+                         SimplifyNode(node, *query_engine, opt_level_));
     modified |= node_modified;
   }
 
   XLS_ASSIGN_OR_RETURN(bool selects_collapsed,
-                       CollapseSelectChains(f, query_engine));
+                       CollapseSelectChains(f, *query_engine));
 
   return modified || selects_collapsed;
 }
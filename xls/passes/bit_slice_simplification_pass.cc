@@ -311,8 +311,151 @@ absl::StatusOr<bool> SimplifyBitSlice(BitSlice* bit_slice, int64_t opt_level,
   return false;
 }
 
+// Replaces a dynamic bit slice with a literal start index with a static bit
+// slice. Returns true if the node was replaced.
+absl::StatusOr<bool> SimplifyLiteralDynamicBitSlice(Node* node) {
+  if (!node->Is<DynamicBitSlice>() || !node->operand(1)->Is<Literal>()) {
+    return false;
+  }
+  int64_t result_width = node->BitCountOrDie();
+  int64_t operand_width = node->operand(0)->BitCountOrDie();
+  const Bits& start_bits = node->operand(1)->As<Literal>()->value().bits();
+  // TODO(meheff): Handle OOB case.
+  if (!bits_ops::ULessThanOrEqual(start_bits, operand_width - result_width)) {
+    return false;
+  }
+  XLS_ASSIGN_OR_RETURN(uint64_t start, start_bits.ToUint64());
+  XLS_VLOG(3) << absl::StreamFormat(
+      "Replacing dynamic bitslice %s with static bitslice", node->GetName());
+  XLS_RETURN_IF_ERROR(
+      node->ReplaceUsesWithNew<BitSlice>(node->operand(0),
+                                         /*start=*/start,
+                                         /*width=*/node->BitCountOrDie())
+          .status());
+  return true;
+}
+
+// Replaces a bit_slice_update operation with a literal start index with an
+// expression of bit slices and concats. Returns true if the node was
+// replaced.
+absl::StatusOr<bool> SimplifyLiteralBitSliceUpdate(Node* node) {
+  if (!node->Is<BitSliceUpdate>() ||
+      !node->As<BitSliceUpdate>()->start()->Is<Literal>()) {
+    return false;
+  }
+  FunctionBase* f = node->function_base();
+  BitSliceUpdate* update = node->As<BitSliceUpdate>();
+  const Bits start = update->start()->As<Literal>()->value().bits();
+  if (bits_ops::UGreaterThanOrEqual(start, update->BitCountOrDie())) {
+    // Bit slice update is entirely out of bounds. This is a noop. Replace
+    // the update operation with the operand which is being updated.
+    XLS_RETURN_IF_ERROR(update->ReplaceUsesWith(update->to_update()));
+    return true;
+  }
+  int64_t start_int64 = start.ToUint64().value();
+  int64_t orig_width = update->BitCountOrDie();
+  int64_t update_width = update->update_value()->BitCountOrDie();
+
+  // Replace bitslice update with expression of slices of the update value
+  // and the original vector.
+  std::vector<Node*> concat_operands;
+  if (start_int64 + update_width < orig_width) {
+    // Bit slice update is entirely in bounds and the most-significant
+    // bit(s) of the original vector are not updated.
+    //
+    //            0                              N
+    //  original: |==============================|
+    //  update  :      |=============|
+    //
+    //
+    //  concat(bitslice(original, start=0), update, bitslice(original, ...)
+    XLS_ASSIGN_OR_RETURN(
+        Node * slice,
+        f->MakeNode<BitSlice>(
+            node->loc(), update->to_update(),
+            /*start=*/start_int64 + update_width,
+            /*width=*/orig_width - (start_int64 + update_width)));
+    concat_operands.push_back(slice);
+    concat_operands.push_back(update->update_value());
+  } else if (start_int64 + update_width == orig_width) {
+    // Bit slice update extends right up to end of updated vector.
+    //
+    //            0                              N
+    //  original: |==============================|
+    //  update  :                  |=============|
+    //
+    //
+    //  concat(bitslice(original, start=0), update)
+    concat_operands.push_back(update->update_value());
+  } else {
+    // The update value is partially out of bounds.
+    //
+    //            0                              N
+    //  original: |==============================|
+    //  update  :                       |=============|
+    //
+    //
+    //  concat(bitslice(original, start=0), bitslice(update))
+    XLS_RET_CHECK_GT(start_int64 + update_width, orig_width);
+    int64_t excess = start_int64 + update_width - orig_width;
+    XLS_ASSIGN_OR_RETURN(
+        Node * slice,
+        f->MakeNode<BitSlice>(node->loc(), update->update_value(),
+                              /*start=*/0,
+                              /*width=*/update_width - excess));
+    concat_operands.push_back(slice);
+  }
+  if (start_int64 > 0) {
+    XLS_ASSIGN_OR_RETURN(Node * slice, f->MakeNode<BitSlice>(
+                                           node->loc(), update->to_update(),
+                                           /*start=*/0,
+                                           /*width=*/start_int64));
+    concat_operands.push_back(slice);
+  }
+  XLS_VLOG(3) << absl::StreamFormat(
+      "Replacing bitslice update %s with constant start index with concat "
+      "and bitslice operations",
+      node->GetName());
+  if (concat_operands.size() == 1) {
+    XLS_RETURN_IF_ERROR(update->ReplaceUsesWith(concat_operands.front()));
+  } else {
+    XLS_RETURN_IF_ERROR(
+        update->ReplaceUsesWithNew<Concat>(concat_operands).status());
+  }
+  return true;
+}
+
 }  // namespace
 
+absl::StatusOr<bool> SimplifyBitSliceNode(Node* node, int64_t opt_level) {
+  XLS_ASSIGN_OR_RETURN(bool dynamic_changed,
+                       SimplifyLiteralDynamicBitSlice(node));
+  if (dynamic_changed) {
+    return true;
+  }
+  XLS_ASSIGN_OR_RETURN(bool update_changed,
+                       SimplifyLiteralBitSliceUpdate(node));
+  if (update_changed) {
+    return true;
+  }
+  if (!node->Is<BitSlice>()) {
+    return false;
+  }
+  // Drain a local worklist so bit slices created while simplifying this slice
+  // are themselves simplified before returning.
+  bool changed = false;
+  std::deque<BitSlice*> worklist;
+  worklist.push_back(node->As<BitSlice>());
+  while (!worklist.empty()) {
+    BitSlice* bit_slice = worklist.front();
+    worklist.pop_front();
+    XLS_ASSIGN_OR_RETURN(bool node_changed,
+                         SimplifyBitSlice(bit_slice, opt_level, &worklist));
+    changed = changed || node_changed;
+  }
+  return changed;
+}
+
 absl::StatusOr<bool> BitSliceSimplificationPass::RunOnFunctionBaseInternal(
     FunctionBase* f, const PassOptions& options, PassResults* results) const {
   bool changed = false;
@@ -320,114 +463,17 @@ absl::StatusOr<bool> BitSliceSimplificationPass::RunOnFunctionBaseInternal(
   // Replace dynamic bit slices with literal indices with a non-dynamic bit
   // slice.
   for (Node* node : f->nodes()) {
-    if (node->Is<DynamicBitSlice>() && node->operand(1)->Is<Literal>()) {
-      int64_t result_width = node->BitCountOrDie();
-      int64_t operand_width = node->operand(0)->BitCountOrDie();
-      const Bits& start_bits = node->operand(1)->As<Literal>()->value().bits();
-      // TODO(meheff): Handle OOB case.
-      if (bits_ops::ULessThanOrEqual(start_bits,
-                                     operand_width - result_width)) {
-        XLS_ASSIGN_OR_RETURN(uint64_t start, start_bits.ToUint64());
-        XLS_VLOG(3) << absl::StreamFormat(
-            "Replacing dynamic bitslice %s with static bitslice",
-            node->GetName());
-        XLS_RETURN_IF_ERROR(
-            node->ReplaceUsesWithNew<BitSlice>(node->operand(0),
-                                               /*start=*/start,
-                                               /*width=*/node->BitCountOrDie())
-                .status());
-        changed = true;
-      }
-    }
+    XLS_ASSIGN_OR_RETURN(bool node_changed,
+                         SimplifyLiteralDynamicBitSlice(node));
+    changed |= node_changed;
   }
 
   // Replace bit_slice_update operations where the start index is constant with
   // bit slices and concats.
   for (Node* node : f->nodes()) {
-    if (node->Is<BitSliceUpdate>() &&
-        node->As<BitSliceUpdate>()->start()->Is<Literal>()) {
-      BitSliceUpdate* update = node->As<BitSliceUpdate>();
-      const Bits start = update->start()->As<Literal>()->value().bits();
-      if (bits_ops::UGreaterThanOrEqual(start, update->BitCountOrDie())) {
-        // Bit slice update is entirely out of bounds. This is a noop. Replace
-        // the update operation with the operand which is being updated.
-        XLS_RETURN_IF_ERROR(update->ReplaceUsesWith(update->to_update()));
-        changed = true;
-        continue;
-      }
-      int64_t start_int64 = start.ToUint64().value();
-      int64_t orig_width = update->BitCountOrDie();
-      int64_t update_width = update->update_value()->BitCountOrDie();
-
-      // Replace bitslice update with expression of slices of the update value
-      // and the original vector.
-      std::vector<Node*> concat_operands;
-      if (start_int64 + update_width < orig_width) {
-        // Bit slice update is entirely in bounds and the most-significant
-        // bit(s) of the original vector are not updated.
-        //
-        //            0                              N
-        //  original: |==============================|
-        //  update  :      |=============|
-        //
-        //
-        //  concat(bitslice(original, start=0), update, bitslice(original, ...)
-        XLS_ASSIGN_OR_RETURN(
-            Node * slice,
-            f->MakeNode<BitSlice>(
-                node->loc(), update->to_update(),
-                /*start=*/start_int64 + update_width,
-                /*width=*/orig_width - (start_int64 + update_width)));
-        concat_operands.push_back(slice);
-        concat_operands.push_back(update->update_value());
-      } else if (start_int64 + update_width == orig_width) {
-        // Bit slice update extends right up to end of updated vector.
-        //
-        //            0                              N
-        //  original: |==============================|
-        //  update  :                  |=============|
-        //
-        //
-        //  concat(bitslice(original, start=0), update)
-        concat_operands.push_back(update->update_value());
-      } else {
-        // The update value is partially out of bounds.
-        //
-        //            0                              N
-        //  original: |==============================|
-        //  update  :                       |=============|
-        //
-        //
-        //  concat(bitslice(original, start=0), bitslice(update))
-        XLS_RET_CHECK_GT(start_int64 + update_width, orig_width);
-        int64_t excess = start_int64 + update_width - orig_width;
-        XLS_ASSIGN_OR_RETURN(
-            Node * slice,
-            f->MakeNode<BitSlice>(node->loc(), update->update_value(),
-                                  /*start=*/0,
-                                  /*width=*/update_width - excess));
-        concat_operands.push_back(slice);
-      }
-      if (start_int64 > 0) {
-        XLS_ASSIGN_OR_RETURN(Node * slice, f->MakeNode<BitSlice>(
-                                               node->loc(), update->to_update(),
-                                               /*start=*/0,
-                                               /*width=*/start_int64));
-        concat_operands.push_back(slice);
-      }
-      XLS_VLOG(3) << absl::StreamFormat(
-          "Replacing bitslice update %s with constant start index with concat "
-          "and bitslice operations",
-          node->GetName());
-      if (concat_operands.size() == 1) {
-        XLS_RETURN_IF_ERROR(update->ReplaceUsesWith(concat_operands.front()));
-      } else {
-        XLS_RETURN_IF_ERROR(
-            update->ReplaceUsesWithNew<Concat>(concat_operands).status());
-      }
-
-      changed = true;
-    }
+    XLS_ASSIGN_OR_RETURN(bool node_changed,
+                         SimplifyLiteralBitSliceUpdate(node));
+    changed |= node_changed;
   }
 
   std::deque<BitSlice*> worklist;
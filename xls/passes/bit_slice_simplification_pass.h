@@ -21,6 +21,13 @@
 
 namespace xls {
 
+// Applies the bit-slice simplification rules to the single node `node`:
+// dynamic bit slices and bit_slice_update operations with literal start
+// indices are lowered to static slices/concats, and bit slices are collapsed
+// or hoisted. Returns true if the IR was modified. Exposed so the unified
+// peephole simplification pass can run the same rules from its worklist.
+absl::StatusOr<bool> SimplifyBitSliceNode(Node* node, int64_t opt_level);
+
 // Pass which simplifies bit-slices. This includes collapsing sequential
 // bit-slices, eliminating degenerate full-width slices, and others.
 class BitSliceSimplificationPass : public FunctionBasePass {
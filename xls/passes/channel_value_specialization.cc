@@ -0,0 +1,122 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/channel_value_specialization.h"
+
+#include <memory>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/channel.h"
+#include "xls/ir/channel_ops.h"
+#include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/proc.h"
+#include "xls/ir/value_helpers.h"
+
+namespace xls {
+namespace {
+
+// Replaces `receive` (which must be a receive on a bound channel) with a
+// tuple of its token operand and a literal of the bound value. The receive
+// node is removed from the proc.
+absl::Status ReplaceReceiveWithValue(Receive* receive, const Value& value) {
+  Proc* proc = receive->function_base()->AsProcOrDie();
+  XLS_ASSIGN_OR_RETURN(Node * data,
+                       proc->MakeNode<Literal>(receive->loc(), value));
+  if (receive->predicate().has_value()) {
+    // A predicated receive yields a zero value when the predicate is false;
+    // preserve that behavior under specialization.
+    XLS_ASSIGN_OR_RETURN(
+        Node * zero,
+        proc->MakeNode<Literal>(receive->loc(),
+                                ZeroOfType(data->GetType())));
+    XLS_ASSIGN_OR_RETURN(
+        data, proc->MakeNode<Select>(receive->loc(),
+                                     receive->predicate().value(),
+                                     std::vector<Node*>{zero, data},
+                                     /*default_value=*/absl::nullopt));
+  }
+  std::vector<Node*> elements = {receive->token(), data};
+  if (!receive->is_blocking()) {
+    // The bound value is always available, so a non-blocking receive is
+    // valid whenever it executes (i.e. whenever its predicate holds).
+    Node* valid;
+    if (receive->predicate().has_value()) {
+      valid = receive->predicate().value();
+    } else {
+      XLS_ASSIGN_OR_RETURN(
+          valid, proc->MakeNode<Literal>(receive->loc(),
+                                         Value(UBits(1, 1))));
+    }
+    elements.push_back(valid);
+  }
+  XLS_ASSIGN_OR_RETURN(Node * replacement,
+                       proc->MakeNode<Tuple>(receive->loc(), elements));
+  XLS_RETURN_IF_ERROR(receive->ReplaceUsesWith(replacement));
+  return proc->RemoveNode(receive);
+}
+
+}  // namespace
+
+absl::StatusOr<bool> SpecializeChannelValues(
+    Package* package, absl::Span<const ChannelValueBinding> bindings) {
+  bool changed = false;
+  for (const ChannelValueBinding& binding : bindings) {
+    XLS_ASSIGN_OR_RETURN(Channel * channel,
+                         package->GetChannel(binding.channel_name));
+    if (channel->supported_ops() != ChannelOps::kReceiveOnly) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Cannot bind channel '%s' to a value: only receive-only (input) "
+          "channels can be bound, and '%s' supports sends",
+          channel->name(), channel->name()));
+    }
+    if (!ValueConformsToType(binding.value, channel->type())) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Value bound to channel '%s' does not conform to the channel type "
+          "%s: %s",
+          channel->name(), channel->type()->ToString(),
+          binding.value.ToString()));
+    }
+    for (const std::unique_ptr<Proc>& proc : package->procs()) {
+      // Gather the receives up front as the replacement mutates the node
+      // list.
+      std::vector<Receive*> receives;
+      for (Node* node : proc->nodes()) {
+        if (node->Is<Receive>() &&
+            node->As<Receive>()->channel_id() == channel->id()) {
+          receives.push_back(node->As<Receive>());
+        }
+      }
+      for (Receive* receive : receives) {
+        XLS_VLOG(2) << absl::StreamFormat(
+            "Specializing receive %s on channel '%s' to value %s",
+            receive->GetName(), channel->name(), binding.value.ToString());
+        XLS_RETURN_IF_ERROR(ReplaceReceiveWithValue(receive, binding.value));
+        changed = true;
+      }
+    }
+    // The channel no longer has any associated operations; remove it so the
+    // package does not advertise an input that is never consumed.
+    XLS_RETURN_IF_ERROR(package->RemoveChannel(channel));
+    changed = true;
+  }
+  return changed;
+}
+
+}  // namespace xls
@@ -0,0 +1,51 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_PASSES_CHANNEL_VALUE_SPECIALIZATION_H_
+#define XLS_PASSES_CHANNEL_VALUE_SPECIALIZATION_H_
+
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+
+// A binding of a receive-only channel to a value known at build time.
+struct ChannelValueBinding {
+  std::string channel_name;
+  Value value;
+};
+
+// Partially evaluates the procs in `package` under the assumption that every
+// receive on a bound channel always and immediately yields the bound value.
+// Each such receive is replaced with a literal of the bound value (guarded by
+// the receive's predicate, if any) and the channel is removed from the
+// package. The standard optimization pipeline then folds the resulting
+// constants through the proc, collapsing control logic that only depended on
+// the bound configuration values.
+//
+// Only channels with ChannelOps::kReceiveOnly may be bound; binding a channel
+// the package can send on would discard the sent data. Returns an error if a
+// binding names a nonexistent channel, a non-receive-only channel, or a value
+// which does not conform to the channel's type. Returns true if the package
+// was changed.
+absl::StatusOr<bool> SpecializeChannelValues(
+    Package* package, absl::Span<const ChannelValueBinding> bindings);
+
+}  // namespace xls
+
+#endif  // XLS_PASSES_CHANNEL_VALUE_SPECIALIZATION_H_
@@ -0,0 +1,139 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/channel_value_specialization.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/statusor.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/channel.h"
+#include "xls/ir/channel_ops.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_matcher.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/proc.h"
+#include "xls/ir/value.h"
+
+namespace m = ::xls::op_matchers;
+
+namespace xls {
+namespace {
+
+using status_testing::IsOkAndHolds;
+using status_testing::StatusIs;
+using ::testing::HasSubstr;
+
+class ChannelValueSpecializationTest : public IrTestBase {};
+
+TEST_F(ChannelValueSpecializationTest, SpecializeSimpleReceive) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * config,
+      p->CreateStreamingChannel("config", ChannelOps::kReceiveOnly,
+                                p->GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * out, p->CreateStreamingChannel("out", ChannelOps::kSendOnly,
+                                               p->GetBitsType(32)));
+  TokenlessProcBuilder pb("p", "tkn", p.get());
+  BValue data = pb.Receive(config);
+  pb.Send(out, data);
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * proc,
+                           pb.Build(std::vector<BValue>()));
+
+  EXPECT_THAT(SpecializeChannelValues(
+                  p.get(), {ChannelValueBinding{"config",
+                                                Value(UBits(42, 32))}}),
+              IsOkAndHolds(true));
+
+  // The receive is gone, the send's data operand is (a tuple-index of) the
+  // bound literal, and the channel has been removed from the package.
+  for (Node* node : proc->nodes()) {
+    EXPECT_FALSE(node->Is<Receive>());
+    if (node->Is<Send>()) {
+      EXPECT_THAT(
+          node->As<Send>()->data(),
+          m::TupleIndex(m::Tuple(m::Param("tkn"),
+                                 m::Literal(Value(UBits(42, 32)))),
+                        /*index=*/1));
+    }
+  }
+  EXPECT_FALSE(p->GetChannel("config").ok());
+  XLS_ASSERT_OK(p->GetChannel("out").status());
+}
+
+TEST_F(ChannelValueSpecializationTest, SpecializedValueFeedsUses) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * config,
+      p->CreateStreamingChannel("config", ChannelOps::kReceiveOnly,
+                                p->GetBitsType(16)));
+  TokenlessProcBuilder pb("p", "tkn", p.get());
+  BValue st = pb.StateElement("st", Value(UBits(0, 16)));
+  BValue data = pb.Receive(config);
+  BValue next_state = pb.Add(data, st);
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * proc,
+                           pb.Build(std::vector<BValue>{next_state}));
+
+  EXPECT_THAT(SpecializeChannelValues(
+                  p.get(), {ChannelValueBinding{"config",
+                                                Value(UBits(7, 16))}}),
+              IsOkAndHolds(true));
+
+  EXPECT_THAT(proc->GetNextStateElement(0),
+              m::Add(m::TupleIndex(m::Tuple(), 1), m::Param("st")));
+}
+
+TEST_F(ChannelValueSpecializationTest, BindingSendableChannelFails) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK(p->CreateStreamingChannel("out", ChannelOps::kSendOnly,
+                                          p->GetBitsType(8))
+                    .status());
+  TokenlessProcBuilder pb("p", "tkn", p.get());
+  XLS_ASSERT_OK(pb.Build(std::vector<BValue>()).status());
+
+  EXPECT_THAT(
+      SpecializeChannelValues(
+          p.get(), {ChannelValueBinding{"out", Value(UBits(0, 8))}}),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("only receive-only")));
+}
+
+TEST_F(ChannelValueSpecializationTest, MistypedValueFails) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK(p->CreateStreamingChannel("config", ChannelOps::kReceiveOnly,
+                                          p->GetBitsType(8))
+                    .status());
+  TokenlessProcBuilder pb("p", "tkn", p.get());
+  XLS_ASSERT_OK(pb.Build(std::vector<BValue>()).status());
+
+  EXPECT_THAT(
+      SpecializeChannelValues(
+          p.get(), {ChannelValueBinding{"config", Value(UBits(0, 16))}}),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("does not conform")));
+}
+
+TEST_F(ChannelValueSpecializationTest, UnknownChannelFails) {
+  auto p = CreatePackage();
+  EXPECT_THAT(SpecializeChannelValues(
+                  p.get(), {ChannelValueBinding{"nonexistent",
+                                                Value(UBits(0, 8))}}),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
+}  // namespace
+}  // namespace xls
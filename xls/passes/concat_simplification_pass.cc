@@ -462,6 +462,35 @@ absl::StatusOr<bool> TryDistributeReducibleOperation(Node* node) {
 
 }  // namespace
 
+absl::StatusOr<bool> SimplifyConcatNode(Node* node, int64_t opt_level) {
+  if (node->Is<Concat>()) {
+    // Drain a local worklist so concats created while simplifying this concat
+    // are themselves simplified before returning.
+    bool changed = false;
+    std::deque<Concat*> worklist;
+    worklist.push_back(node->As<Concat>());
+    while (!worklist.empty()) {
+      Concat* concat = worklist.front();
+      worklist.pop_front();
+      XLS_ASSIGN_OR_RETURN(bool concat_changed,
+                           SimplifyConcat(concat, opt_level, &worklist));
+      changed = changed || concat_changed;
+    }
+    return changed;
+  }
+  if (!NarrowingEnabled(opt_level)) {
+    return false;
+  }
+  if (OpIsBitWise(node->op())) {
+    return TryHoistBitWiseOperation(node);
+  }
+  XLS_ASSIGN_OR_RETURN(bool distribute_changed,
+                       TryDistributeReducibleOperation(node));
+  XLS_ASSIGN_OR_RETURN(bool reduction_changed,
+                       TryBypassReductionOfConcatenation(node));
+  return distribute_changed || reduction_changed;
+}
+
 absl::StatusOr<bool> ConcatSimplificationPass::RunOnFunctionBaseInternal(
     FunctionBase* f, const PassOptions& options, PassResults* results) const {
   // For optimizations which replace concats with other concats use a worklist
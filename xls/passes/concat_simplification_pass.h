@@ -21,6 +21,13 @@
 
 namespace xls {
 
+// Applies the concat simplification rules to the single node `node`: concats
+// are flattened/canonicalized, and bit-wise or reduction operations over
+// concats are hoisted or bypassed. Returns true if the IR was modified.
+// Exposed so the unified peephole simplification pass can run the same rules
+// from its worklist.
+absl::StatusOr<bool> SimplifyConcatNode(Node* node, int64_t opt_level);
+
 // Pass which simplifies concats. This includes removing single-operand concats,
 // flattening trees of dependent concats, and others.
 class ConcatSimplificationPass : public FunctionBasePass {
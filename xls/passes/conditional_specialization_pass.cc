@@ -256,15 +256,47 @@ Node* GetSelectedCase(Select* select, const Bits& selector_value) {
   return select->get_case(selector_value.ToUint64().value());
 }
 
+// A BddQueryEngine restricted to nodes which are cheap to represent as BDDs.
+// Cached in the analysis cache under its own type so it cannot be confused
+// with the unrestricted engine cached by the other BDD-based passes.
+class CheapBddQueryEngine : public BddQueryEngine {
+ public:
+  CheapBddQueryEngine()
+      : BddQueryEngine(BddFunction::kDefaultPathLimit, IsCheapForBdds) {}
+};
+
+// Marker recording that a previous run of this pass over the (since
+// unchanged) function made no changes. `with_bdd` records whether that run
+// used BDD analysis; a no-op run with BDDs implies a no-op without them, but
+// not vice versa.
+struct NoSpecializationPossible {
+  bool with_bdd;
+};
+
 }  // namespace
 
 absl::StatusOr<bool> ConditionalSpecializationPass::RunOnFunctionBaseInternal(
     FunctionBase* f, const PassOptions& options, PassResults* results) const {
-  std::unique_ptr<BddQueryEngine> query_engine;
+  // If the function is unchanged since a run of this pass which found nothing
+  // to specialize, the condition sets recomputed below would be identical and
+  // the whole sweep is guaranteed to be a no-op.
+  if (NoSpecializationPossible* no_op =
+          results->analysis_cache.Get<NoSpecializationPossible>(f);
+      no_op != nullptr && (no_op->with_bdd || !use_bdd_)) {
+    return false;
+  }
+
+  BddQueryEngine* query_engine = nullptr;
   if (use_bdd_) {
-    query_engine = std::make_unique<BddQueryEngine>(
-        BddFunction::kDefaultPathLimit, IsCheapForBdds);
-    XLS_RETURN_IF_ERROR(query_engine->Populate(f).status());
+    // Reuse the engine computed by an earlier run if `f` is unchanged since
+    // then.
+    query_engine = results->analysis_cache.Get<CheapBddQueryEngine>(f);
+    if (query_engine == nullptr) {
+      auto owned_query_engine = std::make_unique<CheapBddQueryEngine>();
+      XLS_RETURN_IF_ERROR(owned_query_engine->Populate(f).status());
+      query_engine =
+          results->analysis_cache.Put(f, std::move(owned_query_engine));
+    }
   }
 
   ConditionMap condition_map(f);
@@ -331,7 +363,7 @@ absl::StatusOr<bool> ConditionalSpecializationPass::RunOnFunctionBaseInternal(
       // First check to see if the condition set directly implies a value for
       // the operand. If so replace with the implied value.
       if (std::optional<Bits> implied_value =
-              ImpliedNodeValue(edge_set, operand, query_engine.get());
+              ImpliedNodeValue(edge_set, operand, query_engine);
           implied_value.has_value()) {
         XLS_VLOG(3) << absl::StreamFormat("Replacing operand %d of %s with %s",
                                           operand_no, node->GetName(),
@@ -372,7 +404,7 @@ absl::StatusOr<bool> ConditionalSpecializationPass::RunOnFunctionBaseInternal(
             break;
           }
           std::optional<Bits> implied_selector = ImpliedNodeValue(
-              edge_set, select->selector(), query_engine.get());
+              edge_set, select->selector(), query_engine);
           if (!implied_selector.has_value()) {
             break;
           }
@@ -400,6 +432,11 @@ absl::StatusOr<bool> ConditionalSpecializationPass::RunOnFunctionBaseInternal(
     }
   }
 
+  if (!changed) {
+    results->analysis_cache.Put(
+        f, std::make_unique<NoSpecializationPossible>(
+               NoSpecializationPossible{use_bdd_}));
+  }
   return changed;
 }
 
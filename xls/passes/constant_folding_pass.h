@@ -28,6 +28,10 @@ class ConstantFoldingPass : public FunctionBasePass {
   ConstantFoldingPass() : FunctionBasePass("const_fold", "Constant folding") {}
   ~ConstantFoldingPass() override {}
 
+  // Folding invoke/map/counted_for nodes interprets the invoked function,
+  // which may be concurrently transformed by the worker processing it.
+  bool SupportsParallelExecution() const override { return false; }
+
  protected:
   absl::StatusOr<bool> RunOnFunctionBaseInternal(
       FunctionBase* f, const PassOptions& options,
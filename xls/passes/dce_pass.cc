@@ -14,13 +14,14 @@
 
 #include "xls/passes/dce_pass.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "absl/status/statusor.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
-#include "xls/ir/dfs_visitor.h"
-#include "xls/ir/node_iterator.h"
+#include "xls/ir/node.h"
 #include "xls/ir/op.h"
-#include "xls/ir/type.h"
 
 namespace xls {
 
@@ -31,31 +32,30 @@ absl::StatusOr<bool> DeadCodeEliminationPass::RunOnFunctionBaseInternal(
            !OpIsSideEffecting(n->op());
   };
 
-  std::deque<Node*> worklist;
-  for (Node* n : f->nodes()) {
-    if (n->users().empty() && is_deletable(n)) {
-      worklist.push_back(n);
-    }
-  }
+  // Rather than scanning every node, drain the candidate set the FunctionBase
+  // accumulates as user counts drop, so the cost of a DCE run is proportional
+  // to the amount of garbage created since the last run. Removing a node
+  // feeds its newly userless operands back into the set, so loop until the
+  // set comes back empty.
   int64_t removed_count = 0;
-  absl::flat_hash_set<Node*> unique_operands;
-  while (!worklist.empty()) {
-    Node* node = worklist.front();
-    worklist.pop_front();
-
-    // A node may appear more than once as an operand of 'node'. Keep track of
-    // which operands have been handled in a set.
-    unique_operands.clear();
-    for (Node* operand : node->operands()) {
-      if (unique_operands.insert(operand).second) {
-        if (operand->users().size() == 1 && is_deletable(operand)) {
-          worklist.push_back(operand);
-        }
+  while (true) {
+    std::vector<Node*> candidates = f->TakeDeadNodeCandidates();
+    if (candidates.empty()) {
+      break;
+    }
+    // The candidate set is unordered; sort by id so removal order is
+    // deterministic.
+    std::sort(candidates.begin(), candidates.end(),
+              [](Node* a, Node* b) { return a->id() < b->id(); });
+    for (Node* node : candidates) {
+      // Candidates may have gained users since they were recorded.
+      if (!node->users().empty() || !is_deletable(node)) {
+        continue;
       }
+      XLS_VLOG(3) << "DCE removing " << node->ToString();
+      XLS_RETURN_IF_ERROR(f->RemoveNode(node));
+      removed_count++;
     }
-    XLS_VLOG(3) << "DCE removing " << node->ToString();
-    XLS_RETURN_IF_ERROR(f->RemoveNode(node));
-    removed_count++;
   }
 
   XLS_VLOG(2) << "Removed " << removed_count << " dead nodes";
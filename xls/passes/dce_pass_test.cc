@@ -117,6 +117,27 @@ TEST_F(DeadCodeEliminationPassTest, AvoidsSideEffecting) {
               StatusIs(absl::StatusCode::kNotFound));
 }
 
+// Nodes which become dead after a DCE run must be found by a later run via
+// the FunctionBase's dead-node candidate set; DCE no longer scans all nodes.
+TEST_F(DeadCodeEliminationPassTest, CollectsNodesKilledAfterEarlierRun) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+     fn func(x: bits[42], y: bits[42]) -> bits[42] {
+       neg.1: bits[42] = neg(x)
+       ret add.2: bits[42] = add(neg.1, y)
+     }
+  )",
+                                                       p.get()));
+  EXPECT_THAT(Run(f), IsOkAndHolds(false));
+  EXPECT_EQ(f->node_count(), 4);
+
+  // Bypass the add; the whole neg/add chain becomes garbage.
+  XLS_ASSERT_OK_AND_ASSIGN(Param * y, f->GetParamByName("y"));
+  XLS_ASSERT_OK(f->return_value()->ReplaceUsesWith(y));
+  EXPECT_THAT(Run(f), IsOkAndHolds(true));
+  EXPECT_EQ(f->node_count(), 2);
+}
+
 TEST_F(DeadCodeEliminationPassTest, Block) {
   auto p = CreatePackage();
   BlockBuilder b(TestName(), p.get());
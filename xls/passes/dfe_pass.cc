@@ -141,6 +141,9 @@ absl::StatusOr<bool> DeadFunctionEliminationPass::RunInternal(
     if (f->IsProc()) {
       removed_procs.push_back(f->AsProcOrDie());
     }
+    // Drop any cached analyses so a later FunctionBase allocated at the same
+    // address cannot alias them.
+    results->analysis_cache.Forget(f);
     XLS_RETURN_IF_ERROR(p->RemoveFunctionBase(f));
   }
 
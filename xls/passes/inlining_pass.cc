@@ -19,7 +19,7 @@
 #include "absl/strings/match.h"
 #include "absl/strings/str_replace.h"
 #include "xls/common/status/status_macros.h"
-#include "xls/ir/node_iterator.h"
+#include "xls/ir/node_indexed_vector.h"
 
 namespace xls {
 namespace {
@@ -77,29 +77,19 @@ std::string GetPrefixedLabel(Invoke* invoke, absl::string_view label,
 // function.
 absl::Status InlineInvoke(Invoke* invoke, int inline_count) {
   Function* invoked = invoke->to_apply();
-  absl::flat_hash_map<Node*, Node*> invoked_node_to_replacement;
+  NodeIndexedVector<Node*> invoked_node_to_replacement(invoked);
   for (int64_t i = 0; i < invoked->params().size(); ++i) {
     Node* param = invoked->param(i);
     invoked_node_to_replacement[param] = invoke->operand(i);
   }
 
-  for (Node* node : TopoSort(invoked)) {
-    if (invoked_node_to_replacement.contains(node)) {
-      // Already taken care of (e.g. parameters above).
-      continue;
-    }
+  for (Node* node : invoked->nodes()) {
     XLS_RET_CHECK(!node->Is<Invoke>())
         << "No invokes should remain in function to inline: "
         << node->GetName();
-    std::vector<Node*> new_operands;
-    for (Node* operand : node->operands()) {
-      new_operands.push_back(invoked_node_to_replacement.at(operand));
-    }
-    XLS_ASSIGN_OR_RETURN(
-        Node * new_node,
-        node->CloneInNewFunction(new_operands, invoke->function_base()));
-    invoked_node_to_replacement[node] = new_node;
   }
+  XLS_RETURN_IF_ERROR(invoked->CloneInto(invoke->function_base(),
+                                         &invoked_node_to_replacement));
 
   // Update names for each of the newly inlined nodes. For example,
   // if the callsite looks like:
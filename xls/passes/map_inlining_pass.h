@@ -27,6 +27,10 @@ class MapInliningPass : public FunctionBasePass {
  public:
   MapInliningPass();
 
+  // Inlining reads the body of the mapped function, which may be concurrently
+  // transformed by the worker processing that function.
+  bool SupportsParallelExecution() const override { return false; }
+
  protected:
   absl::StatusOr<bool> RunOnFunctionBaseInternal(
       FunctionBase* function, const PassOptions& options,
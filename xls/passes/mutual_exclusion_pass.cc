@@ -14,15 +14,20 @@
 
 #include "xls/passes/mutual_exclusion_pass.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <random>
 
 #include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/time/time.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/data_structures/graph_coloring.h"
 #include "xls/data_structures/transitive_closure.h"
 #include "xls/data_structures/union_find_map.h"
@@ -241,8 +246,21 @@ bool HasIntersection(const absl::flat_hash_set<T>& lhs,
   return false;
 }
 
-Z3_lbool RunSolver(Z3_context c, Z3_ast asserted) {
+// Wall-clock budget for a single satisfiability query in milliseconds. Z3
+// returns "unknown" for queries which exceed the budget; those pairs are
+// conservatively treated as not provably mutually exclusive.
+constexpr int64_t kPairTimeoutMs = 5000;
+
+Z3_lbool RunSolver(Z3_context c, Z3_ast asserted, int64_t timeout_ms = 0) {
   Z3_solver solver = solvers::z3::CreateSolver(c, 1);
+  if (timeout_ms > 0) {
+    Z3_params params = Z3_mk_params(c);
+    Z3_params_inc_ref(c, params);
+    Z3_params_set_uint(c, params, Z3_mk_string_symbol(c, "timeout"),
+                       timeout_ms);
+    Z3_solver_set_params(c, solver, params);
+    Z3_params_dec_ref(c, params);
+  }
   Z3_solver_assert(c, solver, asserted);
   Z3_lbool satisfiable = Z3_solver_check(c, solver);
   Z3_solver_dec_ref(c, solver);
@@ -271,7 +289,8 @@ bool IsHeavyOp(Op op) {
          op == Op::kReceive;
 }
 
-absl::Status ComputeMutualExclusion(Predicates* p, FunctionBase* f) {
+absl::Status ComputeMutualExclusion(Predicates* p, FunctionBase* f,
+                                    int64_t parallelism) {
   if (f->IsBlock()) {
     return absl::OkStatus();
   }
@@ -293,8 +312,8 @@ absl::Status ComputeMutualExclusion(Predicates* p, FunctionBase* f) {
   // quadratically many Z3 calls.
   for (const auto& [node, index] : predicate_nodes) {
     Z3_ast translated = translator->GetTranslation(node);
-    if (RunSolver(ctx, solvers::z3::BitVectorToBoolean(ctx, translated)) ==
-        Z3_L_FALSE) {
+    if (RunSolver(ctx, solvers::z3::BitVectorToBoolean(ctx, translated),
+                  kPairTimeoutMs) == Z3_L_FALSE) {
       XLS_VLOG(3) << "Proved that " << node << " is always false";
       // A constant false node is mutually exclusive with all other nodes.
       for (const auto& [other, other_index] : predicate_nodes) {
@@ -334,6 +353,11 @@ absl::Status ComputeMutualExclusion(Predicates* p, FunctionBase* f) {
     }
   }
 
+  // Collect the candidate pairs in a deterministic order. Pairs whose status
+  // is already known (e.g. from the always-false analysis above) are filtered
+  // out here, which doubles as the early-out cache of proven facts for the
+  // worker pool below.
+  std::vector<std::pair<Node*, Node*>> pairs;
   for (const auto& [node_a, index_a] : predicate_nodes) {
     for (const auto& [node_b, index_b] : predicate_nodes) {
       // This prevents checking `a NAND b` and then later checking `b NAND a`.
@@ -351,27 +375,83 @@ absl::Status ComputeMutualExclusion(Predicates* p, FunctionBase* f) {
         continue;
       }
 
-      Z3_ast z3_a = translator->GetTranslation(node_a);
-      Z3_ast z3_b = translator->GetTranslation(node_b);
-
-      // We try to find out if `a ∧ b` is satisfiable, which is true iff
-      // `a NAND b` is not valid.
-      Z3_ast a_and_b =
-          solvers::z3::BitVectorToBoolean(ctx, Z3_mk_bvand(ctx, z3_a, z3_b));
-
-      Z3_lbool satisfiable = RunSolver(ctx, a_and_b);
-
-      if (satisfiable == Z3_L_FALSE) {
-        known_true += 1;
-        XLS_RETURN_IF_ERROR(p->MarkMutuallyExclusive(node_a, node_b));
-      } else if (satisfiable == Z3_L_TRUE) {
-        known_false += 1;
-        XLS_RETURN_IF_ERROR(p->MarkNotMutuallyExclusive(node_a, node_b));
-      } else {
-        unknown += 1;
-        XLS_VLOG(3) << "Z3 ran out of time checking mutual exclusion of "
-                    << node_a->GetName() << " and " << node_b->GetName();
+      pairs.push_back({node_a, node_b});
+    }
+  }
+
+  // Verdict for each pair, filled in either serially or by the worker pool.
+  std::vector<Z3_lbool> verdicts(pairs.size(), Z3_L_UNDEF);
+  auto check_pair = [&](solvers::z3::IrTranslator* t, int64_t i) {
+    Z3_context c = t->ctx();
+    Z3_ast z3_a = t->GetTranslation(pairs[i].first);
+    Z3_ast z3_b = t->GetTranslation(pairs[i].second);
+
+    // We try to find out if `a ∧ b` is satisfiable, which is true iff
+    // `a NAND b` is not valid.
+    Z3_ast a_and_b =
+        solvers::z3::BitVectorToBoolean(c, Z3_mk_bvand(c, z3_a, z3_b));
+    verdicts[i] = RunSolver(c, a_and_b, kPairTimeoutMs);
+  };
+
+  if (parallelism > 1 && pairs.size() > 1) {
+    // The queries are independent, so dispatch them to a pool of worker
+    // threads. Z3 contexts are not thread safe; each worker translates the
+    // function into a context of its own and pulls pair indices off a shared
+    // counter. Verdicts are recorded into `verdicts` (each slot is written by
+    // exactly one worker) and merged in pair order below so the outcome is
+    // the same as a serial run.
+    const int64_t num_threads =
+        std::min(parallelism, static_cast<int64_t>(pairs.size()));
+    std::atomic<int64_t> next_pair(0);
+    std::vector<absl::Status> worker_status(num_threads);
+    auto worker = [&](int64_t worker_index) {
+      absl::StatusOr<std::unique_ptr<solvers::z3::IrTranslator>>
+          worker_translator =
+              solvers::z3::IrTranslator::CreateAndTranslate(f, true);
+      if (!worker_translator.ok()) {
+        worker_status[worker_index] = worker_translator.status();
+        return;
       }
+      solvers::z3::ScopedErrorHandler worker_seh(
+          worker_translator.value()->ctx());
+      while (true) {
+        int64_t i = next_pair.fetch_add(1, std::memory_order_relaxed);
+        if (i >= static_cast<int64_t>(pairs.size())) {
+          break;
+        }
+        check_pair(worker_translator.value().get(), i);
+      }
+      worker_status[worker_index] = worker_seh.status();
+    };
+    std::vector<std::unique_ptr<Thread>> threads;
+    threads.reserve(num_threads);
+    for (int64_t i = 0; i < num_threads; ++i) {
+      threads.push_back(std::make_unique<Thread>([&worker, i]() { worker(i); }));
+    }
+    for (std::unique_ptr<Thread>& thread : threads) {
+      thread->Join();
+    }
+    for (const absl::Status& status : worker_status) {
+      XLS_RETURN_IF_ERROR(status);
+    }
+  } else {
+    for (int64_t i = 0; i < static_cast<int64_t>(pairs.size()); ++i) {
+      check_pair(translator.get(), i);
+    }
+  }
+
+  for (int64_t i = 0; i < static_cast<int64_t>(pairs.size()); ++i) {
+    const auto& [node_a, node_b] = pairs[i];
+    if (verdicts[i] == Z3_L_FALSE) {
+      known_true += 1;
+      XLS_RETURN_IF_ERROR(p->MarkMutuallyExclusive(node_a, node_b));
+    } else if (verdicts[i] == Z3_L_TRUE) {
+      known_false += 1;
+      XLS_RETURN_IF_ERROR(p->MarkNotMutuallyExclusive(node_a, node_b));
+    } else {
+      unknown += 1;
+      XLS_VLOG(3) << "Z3 ran out of time checking mutual exclusion of "
+                  << node_a->GetName() << " and " << node_b->GetName();
     }
   }
 
@@ -784,7 +864,7 @@ absl::StatusOr<bool> MutualExclusionPass::RunOnFunctionBaseInternal(
     FunctionBase* f, const PassOptions& options, PassResults* results) const {
   Predicates p;
   XLS_RETURN_IF_ERROR(AddSendReceivePredicates(&p, f));
-  XLS_RETURN_IF_ERROR(ComputeMutualExclusion(&p, f));
+  XLS_RETURN_IF_ERROR(ComputeMutualExclusion(&p, f, options.parallelism));
   XLS_ASSIGN_OR_RETURN(std::vector<absl::flat_hash_set<Node*>> merge_classes,
                        ComputeMergeClasses(&p, f));
 
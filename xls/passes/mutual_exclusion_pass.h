@@ -31,6 +31,11 @@ class MutualExclusionPass : public FunctionBasePass {
             "Merge mutually exclusively used nodes using SMT solver") {}
   ~MutualExclusionPass() override {}
 
+  // The pass sets Z3 global parameters and, with PassOptions::parallelism
+  // greater than one, runs its own pool of solver threads; it must not be run
+  // on multiple FunctionBases concurrently.
+  bool SupportsParallelExecution() const override { return false; }
+
  protected:
   absl::StatusOr<bool> RunOnFunctionBaseInternal(
       FunctionBase* f, const PassOptions& options,
@@ -904,12 +904,32 @@ absl::StatusOr<bool> MaybeReplacePreciseWithLiteral(
   return true;
 }
 
-static absl::StatusOr<std::unique_ptr<QueryEngine>> GetQueryEngine(
-    FunctionBase* f, bool use_range_analysis) {
-  std::unique_ptr<QueryEngine> query_engine;
-  if (use_range_analysis) {
+// Returns the query engine to use for narrowing `f`, reusing the engine cached
+// by an earlier pass if `f` is unchanged since the engine was computed. The
+// returned engine is owned by the analysis cache.
+static absl::StatusOr<QueryEngine*> GetQueryEngine(FunctionBase* f,
+                                                   bool use_range_analysis,
+                                                   PassResults* results) {
+  if (!use_range_analysis) {
+    TernaryQueryEngine* ternary =
+        results->analysis_cache.Get<TernaryQueryEngine>(f);
+    if (ternary == nullptr) {
+      auto owned_ternary = std::make_unique<TernaryQueryEngine>();
+      XLS_RETURN_IF_ERROR(owned_ternary->PopulateLazily(f).status());
+      ternary = results->analysis_cache.Put(f, std::move(owned_ternary));
+    }
+    return ternary;
+  }
+
+  UnionQueryEngine* union_engine =
+      results->analysis_cache.Get<UnionQueryEngine>(f);
+  if (union_engine == nullptr) {
     auto ternary_query_engine = std::make_unique<TernaryQueryEngine>();
     auto range_query_engine = std::make_unique<RangeQueryEngine>();
+    // Both analyses are demand driven: the cone of a node is only analyzed
+    // (and then memoized) once the node is queried below.
+    XLS_RETURN_IF_ERROR(ternary_query_engine->PopulateLazily(f).status());
+    XLS_RETURN_IF_ERROR(range_query_engine->PopulateLazily(f).status());
 
     if (XLS_VLOG_IS_ON(3)) {
       RangeAnalysisLog(f, *ternary_query_engine, *range_query_engine);
@@ -918,18 +938,16 @@ static absl::StatusOr<std::unique_ptr<QueryEngine>> GetQueryEngine(
     std::vector<std::unique_ptr<QueryEngine>> engines;
     engines.push_back(std::move(ternary_query_engine));
     engines.push_back(std::move(range_query_engine));
-    query_engine = std::make_unique<UnionQueryEngine>(std::move(engines));
-  } else {
-    query_engine = std::make_unique<TernaryQueryEngine>();
+    union_engine = results->analysis_cache.Put(
+        f, std::make_unique<UnionQueryEngine>(std::move(engines)));
   }
-  XLS_RETURN_IF_ERROR(query_engine->Populate(f).status());
-  return std::move(query_engine);
+  return union_engine;
 }
 
 absl::StatusOr<bool> NarrowingPass::RunOnFunctionBaseInternal(
     FunctionBase* f, const PassOptions& options, PassResults* results) const {
-  XLS_ASSIGN_OR_RETURN(std::unique_ptr<QueryEngine> query_engine,
-                       GetQueryEngine(f, use_range_analysis_));
+  XLS_ASSIGN_OR_RETURN(QueryEngine * query_engine,
+                       GetQueryEngine(f, use_range_analysis_, results));
 
   bool modified = false;
 
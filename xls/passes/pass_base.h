@@ -17,22 +17,34 @@
 
 #include <stdio.h>
 
+#include <cstdint>
 #include <filesystem>
 #include <memory>
 #include <set>
 #include <string>
+#include <system_error>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "xls/common/allocation_accounting.h"
+#include "xls/common/cancellation.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/process_memory.h"
+#include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/tracing.h"
+#include "xls/ir/ir_binary.h"
 #include "xls/ir/function.h"
 #include "xls/ir/package.h"
 
@@ -70,6 +82,49 @@ struct PassOptions {
   // chains of selects. Otherwise, this optimization is skipped, since it can
   // sometimes reduce output quality.
   std::optional<int64_t> convert_array_index_to_select = std::nullopt;
+
+  // Number of worker threads function-level passes may use to process the
+  // FunctionBases of the package in parallel. With the default of one all
+  // passes run serially. See FunctionBasePass::RunInternal for the
+  // requirements parallel execution places on passes.
+  int64_t parallelism = 1;
+
+  // If set, the pipeline returns a ResourceExhaustedError -- including a
+  // breakdown of the package's estimated memory usage -- when the process's
+  // peak resident set size exceeds this many bytes after a pass. Aborting with
+  // a diagnosable error is preferable to being OOM-killed without one.
+  std::optional<int64_t> memory_limit_bytes = std::nullopt;
+
+  // If non-empty, the directory compound passes periodically write pipeline
+  // checkpoints to: the IR in binary serialized form plus the pipeline
+  // position (see CompoundPassBase::WriteCheckpoint). A compile killed
+  // mid-pipeline can be restarted from the last checkpoint via
+  // PassResults::checkpoint_replay.
+  std::filesystem::path checkpoint_dir;
+
+  // Minimum wall time between checkpoint writes. Serializing a large package
+  // is not free, so checkpoints are only taken at pass boundaries after this
+  // much time has elapsed since the previous one.
+  absl::Duration checkpoint_interval = absl::Minutes(5);
+
+  // If set, compound passes stop starting new passes once this time is
+  // reached. The pipeline stops at a pass boundary, so the IR reflects every
+  // pass completed so far and the instrumentation profile is intact;
+  // PassResults::interrupted records that the run was cut short. This gives a
+  // best-effort result with diagnostics where a CI timeout would otherwise
+  // SIGKILL the compile and lose both.
+  absl::Time deadline = absl::InfiniteFuture();
+
+  // If non-null, a cooperative cancellation token checked at the same points
+  // as the deadline. Not owned; must outlive the pass invocation.
+  CancellationScope* cancellation = nullptr;
+
+  // Returns true if the deadline has passed or the cancellation token has
+  // fired; compound passes check this before starting each pass.
+  bool stop_requested() const {
+    return (cancellation != nullptr && cancellation->cancelled()) ||
+           (deadline != absl::InfiniteFuture() && absl::Now() >= deadline);
+  }
 };
 
 // An object containing information about the invocation of a pass (single call
@@ -83,6 +138,174 @@ struct PassInvocation {
 
   // The run duration of the pass.
   absl::Duration run_duration;
+
+  // The number of nodes in the IR after the pass minus the number before.
+  int64_t node_count_delta = 0;
+
+  // The number of IR transformations performed by the pass, measured as the
+  // advance of the transform journals of the IR (see
+  // FunctionBase::transform_journal).
+  int64_t transform_count = 0;
+
+  // How much the pass grew the peak resident set size of the process, in
+  // bytes. Zero for passes which fit within the existing high-water mark.
+  int64_t peak_rss_delta_bytes = 0;
+
+  // Estimated memory held by the package after the pass, by category (see
+  // Package::EstimateMemoryUsage).
+  Package::MemoryUsage memory_usage;
+
+  // Allocations recorded against each accounted subsystem during the pass.
+  // All zero unless the binary was built with allocation accounting enabled
+  // (see xls/common/allocation_accounting.h).
+  AllocationSnapshot allocation_delta;
+};
+
+// File names of the two components of a pipeline checkpoint directory: the
+// IR in binary serialized form (see xls/ir/ir_binary.h) and the invocation
+// log recording the pipeline position.
+inline constexpr char kCheckpointIrFile[] = "package.bin";
+inline constexpr char kCheckpointInvocationsFile[] = "invocations.txt";
+
+// One entry of the invocation log of a pipeline checkpoint: a pass which had
+// already run when the checkpoint was taken and whether it changed the IR.
+// When resuming, the recorded entries are consumed in order instead of
+// re-running the passes; the changed bits drive the compound passes' control
+// flow (in particular fixed-point termination) exactly as in the original
+// run, so replay ends with the pipeline in the same position it checkpointed
+// at. See PassResults::checkpoint_replay.
+struct CheckpointInvocation {
+  std::string pass_name;
+  bool ir_changed;
+};
+
+// Parses the invocation log of a pipeline checkpoint (one
+// "<pass short name> <changed>" line per invocation, as written by
+// CompoundPassBase::WriteCheckpoint) into replay entries.
+inline absl::StatusOr<std::vector<CheckpointInvocation>>
+ParseCheckpointInvocations(absl::string_view contents) {
+  std::vector<CheckpointInvocation> invocations;
+  for (absl::string_view line :
+       absl::StrSplit(contents, '\n', absl::SkipEmpty())) {
+    std::vector<absl::string_view> fields = absl::StrSplit(line, ' ');
+    if (fields.size() != 2 || (fields[1] != "0" && fields[1] != "1")) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Malformed checkpoint invocation entry: ", line));
+    }
+    invocations.push_back(
+        CheckpointInvocation{std::string(fields[0]), fields[1] == "1"});
+  }
+  return invocations;
+}
+
+// A cache of analysis results (query engines, BDDs, etc.) shared across the
+// passes of a pipeline. Rebuilding these analyses from scratch in every pass
+// which needs them dominates optimization time for large designs; with the
+// cache a pass reuses the analysis computed by an earlier pass if the function
+// has not changed in between.
+//
+// Entries are keyed by the FunctionBase the analysis was computed for and by
+// the C++ type of the analysis, and are stamped with the function's transform
+// journal (FunctionBase::transform_journal) at the time of insertion. A lookup
+// after any mutation of the function misses because the journal has advanced,
+// so passes which mutate the IR require no explicit invalidation calls.
+// Callers which delete a FunctionBase outright should call Forget first so a
+// later FunctionBase allocated at the same address cannot alias the entry.
+//
+// Typical usage in a pass:
+//
+//   BddFunction* bdd = results->analysis_cache.Get<BddFunction>(f);
+//   if (bdd == nullptr) {
+//     XLS_ASSIGN_OR_RETURN(std::unique_ptr<BddFunction> owned, ...compute...);
+//     bdd = results->analysis_cache.Put(f, std::move(owned));
+//   }
+class AnalysisCache {
+ public:
+  // Returns the cached analysis of type AnalysisT for `f`, or nullptr if no
+  // analysis is cached or `f` has changed since the analysis was stored.
+  template <typename AnalysisT>
+  AnalysisT* Get(FunctionBase* f) const {
+    auto it = entries_.find(Key{f, TypeKey<AnalysisT>()});
+    if (it == entries_.end() || it->second.journal != f->transform_journal()) {
+      return nullptr;
+    }
+    return static_cast<AnalysisT*>(it->second.analysis.get());
+  }
+
+  // Returns the cached analysis of type AnalysisT for `f` even if `f` has
+  // changed since the analysis was stored, or nullptr if no entry exists. For
+  // analyses which are snapshots of a pass's previous run kept specifically
+  // to diff the current state against, staleness is the point, so the journal
+  // stamp is ignored.
+  template <typename AnalysisT>
+  AnalysisT* GetStale(FunctionBase* f) const {
+    auto it = entries_.find(Key{f, TypeKey<AnalysisT>()});
+    if (it == entries_.end()) {
+      return nullptr;
+    }
+    return static_cast<AnalysisT*>(it->second.analysis.get());
+  }
+
+  // Stores `analysis` as the analysis of type AnalysisT for `f` in its current
+  // state, replacing any existing entry. Returns a pointer to the stored
+  // analysis which remains valid until the entry is replaced or forgotten.
+  template <typename AnalysisT>
+  AnalysisT* Put(FunctionBase* f, std::unique_ptr<AnalysisT> analysis) {
+    AnalysisT* ptr = analysis.get();
+    entries_[Key{f, TypeKey<AnalysisT>()}] =
+        Entry{f->transform_journal(), std::move(analysis)};
+    return ptr;
+  }
+
+  // Re-stamps the cached analysis of type AnalysisT for `f` with the
+  // function's current transform journal. For use by passes which update an
+  // analysis in place to reflect their own IR edits: after the call the
+  // entry hits again even though the journal has advanced. No-op if no entry
+  // exists.
+  template <typename AnalysisT>
+  void Refresh(FunctionBase* f) {
+    auto it = entries_.find(Key{f, TypeKey<AnalysisT>()});
+    if (it != entries_.end()) {
+      it->second.journal = f->transform_journal();
+    }
+  }
+
+  // Drops all entries for `f`.
+  void Forget(FunctionBase* f) {
+    absl::erase_if(entries_,
+                   [f](const auto& entry) { return entry.first.first == f; });
+  }
+
+  // Moves all entries for `f` from this cache into `to`, replacing any
+  // entries for `f` already there. Parallel pass execution uses this to hand
+  // a function's analyses to the worker-local cache of the worker processing
+  // the function and to collect them again afterwards.
+  void MoveEntriesFor(FunctionBase* f, AnalysisCache* to) {
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      if (it->first.first == f) {
+        to->entries_[it->first] = std::move(it->second);
+        entries_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+ private:
+  // Returns a value uniquely identifying AnalysisT, used as the type half of
+  // the cache key. Each instantiation has its own `type_key` static.
+  template <typename AnalysisT>
+  static const void* TypeKey() {
+    static const char type_key = 0;
+    return &type_key;
+  }
+
+  using Key = std::pair<FunctionBase*, const void*>;
+  struct Entry {
+    int64_t journal;
+    std::shared_ptr<void> analysis;
+  };
+  absl::flat_hash_map<Key, Entry> entries_;
 };
 
 // A object to which metadata may be written in each pass invocation. This data
@@ -90,13 +313,56 @@ struct PassInvocation {
 struct PassResults {
   // This vector contains and entry for each invocation of each pass.
   std::vector<PassInvocation> invocations;
+
+  // The cumulative number of iterations run by each fixed-point compound
+  // pass, keyed by the pass's short name. Multiple runs of the same compound
+  // pass accumulate into one entry.
+  absl::flat_hash_map<std::string, int64_t> fixed_point_iterations;
+
+  // If non-null, the names of the FunctionBases which were changed by the
+  // previous iteration of the enclosing fixed-point compound pass (see
+  // FixedPointCompoundPassBase). Function-scoped passes whose result depends
+  // only on the FunctionBase they run on skip functions not in the set; a
+  // null pointer means no change information is available and every function
+  // must be processed. Keyed by name rather than pointer so a FunctionBase
+  // allocated at the address of a deleted one cannot alias its entry.
+  const absl::flat_hash_set<std::string>* dirty_functions = nullptr;
+
+  // Analyses computed by earlier passes in the pipeline, available for reuse
+  // by later passes if the respective function has not changed in between.
+  AnalysisCache analysis_cache;
+
+  // Invocation log loaded from a pipeline checkpoint. While
+  // `checkpoint_replay_position` has not reached the end of this vector,
+  // compound passes consume entries instead of running passes: the IR was
+  // loaded from the checkpoint with those passes already applied, and the
+  // recorded changed bits reconstruct the pipeline's control flow. Empty for
+  // a run which is not resuming.
+  std::vector<CheckpointInvocation> checkpoint_replay;
+
+  // Index of the next `checkpoint_replay` entry to consume.
+  int64_t checkpoint_replay_position = 0;
+
+  // When the last checkpoint was written (or, initially, when the run
+  // started). Used to rate-limit checkpoint writes to
+  // PassOptions::checkpoint_interval.
+  absl::Time last_checkpoint_time = absl::Now();
+
+  // Set when the pipeline stopped early because PassOptions::deadline passed
+  // or PassOptions::cancellation fired. The IR reflects every pass completed
+  // up to the stop point and `invocations` holds the profile collected so
+  // far; the result is valid but not fully optimized.
+  bool interrupted = false;
 };
 
 // Base class for all compiler passes. Template parameters:
 //
 //   IrT : The data type that the pass operates on (e.g., xls::Package). The
 //     type should define 'DumpIr' and 'name' methods used for dumping and
-//     logging in compound passes. A pass which strictly operate on the XLS IR
+//     logging in compound passes, and 'GetNodeCount', 'GetTransformCount',
+//     'EstimateMemoryUsage' and 'GetFunctionBases' methods used for per-pass
+//     instrumentation and fixed-point dirty tracking. A pass which strictly
+//     operate on the XLS IR
 //     may use the xls::Package type as the IrT template argument. Passes which
 //     operate on the IR and a schedule may be instantiated on a data structure
 //     containing both an xls::Package and a schedule. Roughly, IrT should
@@ -249,6 +515,49 @@ class CompoundPassBase : public PassBase<IrT, OptionsT, ResultsT> {
     return SetFileContents(path, ir->DumpIr());
   }
 
+  // Writes a pipeline checkpoint to `checkpoint_dir`: the IR in binary
+  // serialized form plus a log of the pass invocations run so far (the
+  // pipeline position). Both files are written to a temporary name and
+  // renamed into place, IR first: a checkpoint torn by a crash then replays
+  // too few invocations -- the affected passes harmlessly re-run -- rather
+  // than too many. Failures are logged and swallowed; a missed checkpoint
+  // must not fail the compile it is meant to protect.
+  void WriteCheckpoint(const std::filesystem::path& checkpoint_dir, IrT* ir,
+                       const ResultsT& results) const {
+    absl::StatusOr<std::string> binary = SerializeIrTextToBinary(ir->DumpIr());
+    if (!binary.ok()) {
+      XLS_LOG(WARNING) << "Failed to serialize IR for checkpoint: "
+                       << binary.status();
+      return;
+    }
+    std::string log;
+    for (const PassInvocation& invocation : results.invocations) {
+      absl::StrAppendFormat(&log, "%s %d\n", invocation.pass_name,
+                            invocation.ir_changed ? 1 : 0);
+    }
+    auto write_file = [&](absl::string_view filename,
+                          const std::string& contents) -> absl::Status {
+      std::filesystem::path tmp_path =
+          checkpoint_dir / absl::StrCat(filename, ".tmp");
+      XLS_RETURN_IF_ERROR(SetFileContents(tmp_path, contents));
+      std::error_code ec;
+      std::filesystem::rename(tmp_path,
+                              checkpoint_dir / std::string(filename), ec);
+      if (ec) {
+        return absl::InternalError(ec.message());
+      }
+      return absl::OkStatus();
+    };
+    absl::Status status = write_file(kCheckpointIrFile, *binary);
+    if (status.ok()) {
+      status = write_file(kCheckpointInvocationsFile, log);
+    }
+    if (!status.ok()) {
+      XLS_LOG(WARNING) << "Failed to write checkpoint to "
+                       << checkpoint_dir.string() << ": " << status;
+    }
+  }
+
   std::vector<std::unique_ptr<Pass>> passes_;
   std::vector<Pass*> pass_ptrs_;
 
@@ -274,13 +583,50 @@ class FixedPointCompoundPassBase
           invariant_checkers) const override {
     bool local_changed = true;
     bool global_changed = false;
-    while (local_changed) {
+    int64_t iterations = 0;
+    // Transform journal values of the FunctionBases at the start of the
+    // current iteration. Functions whose journal does not advance during an
+    // iteration were left unchanged by every pass, so function-scoped passes
+    // need not revisit them in the next iteration (see
+    // PassResults::dirty_functions).
+    absl::flat_hash_map<std::string, int64_t> journals;
+    absl::flat_hash_set<std::string> dirty_functions;
+    const absl::flat_hash_set<std::string>* saved_dirty_functions =
+        results->dirty_functions;
+    while (local_changed && !results->interrupted) {
+      ++iterations;
+      journals.clear();
+      for (FunctionBase* f : ir->GetFunctionBases()) {
+        journals[f->name()] = f->transform_journal();
+      }
+      int64_t replay_position_before = results->checkpoint_replay_position;
       XLS_ASSIGN_OR_RETURN(
           local_changed,
           (CompoundPassBase<IrT, OptionsT, ResultsT>::RunNested(
               ir, options, results, top_level_name, invariant_checkers)));
+      if (replay_position_before <
+          static_cast<int64_t>(results->checkpoint_replay.size())) {
+        // At least part of this iteration was replayed from a checkpoint.
+        // Replayed passes do not advance the transform journals even when
+        // their recorded outcome is "changed", so the journal diff
+        // understates which functions the original iteration touched; pass
+        // no change information so the next iteration processes everything.
+        results->dirty_functions = nullptr;
+      } else {
+        dirty_functions.clear();
+        for (FunctionBase* f : ir->GetFunctionBases()) {
+          auto it = journals.find(f->name());
+          if (it == journals.end() || it->second != f->transform_journal()) {
+            dirty_functions.insert(f->name());
+          }
+        }
+        results->dirty_functions = &dirty_functions;
+      }
       global_changed = global_changed || local_changed;
     }
+    // Restore the dirty set of the enclosing fixed-point pass (if any).
+    results->dirty_functions = saved_dirty_functions;
+    results->fixed_point_iterations[this->short_name()] += iterations;
     return global_changed;
   }
 };
@@ -294,6 +640,7 @@ absl::StatusOr<bool> CompoundPassBase<IrT, OptionsT, ResultsT>::RunNested(
               << " compound pass on package " << ir->name();
   XLS_VLOG(2) << "Start of compound pass " << this->short_name() << ":";
   XLS_VLOG_LINES(5, ir->DumpIr());
+  ScopedTraceEvent trace_event(this->short_name());
 
   // Invariant checkers may be passed in from parent compound passes or
   // contained by this pass itself. Merge them together.
@@ -317,6 +664,24 @@ absl::StatusOr<bool> CompoundPassBase<IrT, OptionsT, ResultsT>::RunNested(
 
   bool changed = false;
   for (const auto& pass : passes_) {
+    // Stop at the pass boundary once the deadline has passed or cancellation
+    // was requested (or a nested compound pass already stopped). The IR is in
+    // a consistent state between passes, so everything run so far -- and the
+    // instrumentation in `results` -- is kept as a best-effort result.
+    if (results->interrupted) {
+      break;
+    }
+    if (options.stop_requested()) {
+      XLS_LOG(WARNING) << absl::StreamFormat(
+          "Stopping pass pipeline before pass '%s': %s. Returning the IR "
+          "optimized so far.",
+          pass->short_name(),
+          options.cancellation != nullptr && options.cancellation->cancelled()
+              ? "cancellation requested"
+              : "deadline exceeded");
+      results->interrupted = true;
+      break;
+    }
     XLS_VLOG(1) << absl::StreamFormat("Running %s (%s) pass on package %s",
                                       pass->long_name(), pass->short_name(),
                                       ir->name());
@@ -345,19 +710,41 @@ absl::StatusOr<bool> CompoundPassBase<IrT, OptionsT, ResultsT>::RunNested(
     std::string ir_before = ir->DumpIr();
 #endif
     absl::Time start = absl::Now();
+    int64_t node_count_before = ir->GetNodeCount();
+    int64_t transform_count_before = ir->GetTransformCount();
+    int64_t peak_rss_before = GetPeakResidentSetSizeBytes();
+    AllocationSnapshot allocations_before = SnapshotAllocationCounters();
     bool pass_changed;
+    bool replayed = false;
     if (pass->IsCompound()) {
       XLS_ASSIGN_OR_RETURN(
           pass_changed,
           (down_cast<CompoundPassBase<IrT, OptionsT, ResultsT>*>(pass.get())
                ->RunNested(ir, options, results, top_level_name, checkers)));
+    } else if (results->checkpoint_replay_position <
+               static_cast<int64_t>(results->checkpoint_replay.size())) {
+      // Resuming from a checkpoint: this pass had already run when the
+      // checkpoint was taken and its effect is baked into the loaded IR.
+      // Consume its recorded outcome instead of re-running it.
+      const CheckpointInvocation& replay =
+          results->checkpoint_replay[results->checkpoint_replay_position];
+      XLS_RET_CHECK_EQ(replay.pass_name, pass->short_name())
+          << "checkpoint invocation log does not match the pass pipeline; "
+             "refusing to resume";
+      pass_changed = replay.ir_changed;
+      replayed = true;
+      ++results->checkpoint_replay_position;
+      XLS_VLOG(1) << "Replaying checkpointed invocation of "
+                  << pass->short_name();
     } else {
       XLS_ASSIGN_OR_RETURN(pass_changed, pass->Run(ir, options, results));
     }
     absl::Duration duration = absl::Now() - start;
 #ifdef DEBUG
     std::string ir_after = ir->DumpIr();
-    if (pass_changed) {
+    if (replayed) {
+      // The IR does not change during replay regardless of the recorded bit.
+    } else if (pass_changed) {
       if (ir_before == ir_after) {
         return absl::InternalError(absl::StrFormat(
             "Pass %s indicated IR changed, but IR is unchanged:\n\n%s",
@@ -379,16 +766,39 @@ absl::StatusOr<bool> CompoundPassBase<IrT, OptionsT, ResultsT>::RunNested(
         (pass_changed ? "changed IR" : "did not change IR"));
     if (!pass->IsCompound()) {
       results->invocations.push_back(
-          {pass->short_name(), pass_changed, duration});
+          {pass->short_name(), pass_changed, duration,
+           /*node_count_delta=*/ir->GetNodeCount() - node_count_before,
+           /*transform_count=*/ir->GetTransformCount() - transform_count_before,
+           /*peak_rss_delta_bytes=*/GetPeakResidentSetSizeBytes() -
+               peak_rss_before,
+           /*memory_usage=*/ir->EstimateMemoryUsage(),
+           /*allocation_delta=*/
+           AllocationDelta(allocations_before, SnapshotAllocationCounters())});
+      if (options.memory_limit_bytes.has_value() &&
+          GetPeakResidentSetSizeBytes() > *options.memory_limit_bytes) {
+        return absl::ResourceExhaustedError(absl::StrFormat(
+            "Memory limit of %d bytes exceeded after pass '%s': peak resident "
+            "set size is %d bytes; package memory %s",
+            *options.memory_limit_bytes, pass->short_name(),
+            GetPeakResidentSetSizeBytes(),
+            results->invocations.back().memory_usage.ToString()));
+      }
+      if (!options.checkpoint_dir.empty() && !replayed &&
+          absl::Now() - results->last_checkpoint_time >=
+              options.checkpoint_interval) {
+        WriteCheckpoint(options.checkpoint_dir, ir, *results);
+        results->last_checkpoint_time = absl::Now();
+      }
     }
-    if (!options.ir_dump_path.empty()) {
+    if (!options.ir_dump_path.empty() && !replayed) {
       XLS_RETURN_IF_ERROR(DumpIr(options.ir_dump_path, ir, top_level_name,
                                  absl::StrCat("after_", pass->short_name()),
                                  /*ordinal=*/results->invocations.size(),
                                  /*changed=*/pass_changed));
     }
-    // Only run the verifiers if the pass changed.
-    if (pass_changed) {
+    // Only run the verifiers if the pass changed. Replayed invocations do not
+    // touch the IR so there is nothing new to verify.
+    if (pass_changed && !replayed) {
       absl::Time checker_start = absl::Now();
       XLS_RETURN_IF_ERROR(run_invariant_checkers(
           absl::StrFormat("after '%s' pass, dynamic pass #%d",
@@ -0,0 +1,233 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/pass_base.h"
+
+#include <memory>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/function.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+namespace {
+
+class PassBaseTest : public IrTestBase {};
+
+// Stand-ins for real analyses (BDDs, query engines, ...).
+struct FakeAnalysis {
+  int64_t value;
+};
+struct OtherAnalysis {
+  int64_t value;
+};
+
+TEST_F(PassBaseTest, AnalysisCacheHitsUntilFunctionChanges) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+fn id(x: bits[8]) -> bits[8] {
+  ret not.1: bits[8] = not(x)
+}
+)",
+                                                       p.get()));
+  AnalysisCache cache;
+  EXPECT_EQ(cache.Get<FakeAnalysis>(f), nullptr);
+
+  FakeAnalysis* analysis =
+      cache.Put(f, std::make_unique<FakeAnalysis>(FakeAnalysis{42}));
+  ASSERT_NE(analysis, nullptr);
+  EXPECT_EQ(analysis->value, 42);
+  EXPECT_EQ(cache.Get<FakeAnalysis>(f), analysis);
+
+  // Entries are keyed by analysis type; a different type misses.
+  EXPECT_EQ(cache.Get<OtherAnalysis>(f), nullptr);
+
+  // Any graph change invalidates the entry.
+  XLS_ASSERT_OK(f->MakeNode<Literal>(SourceInfo(), Value(UBits(0, 8))));
+  EXPECT_EQ(cache.Get<FakeAnalysis>(f), nullptr);
+}
+
+TEST_F(PassBaseTest, AnalysisCachePutReplacesAndForgetDrops) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+fn id(x: bits[8]) -> bits[8] {
+  ret not.1: bits[8] = not(x)
+}
+)",
+                                                       p.get()));
+  AnalysisCache cache;
+  cache.Put(f, std::make_unique<FakeAnalysis>(FakeAnalysis{1}));
+  FakeAnalysis* replacement =
+      cache.Put(f, std::make_unique<FakeAnalysis>(FakeAnalysis{2}));
+  EXPECT_EQ(cache.Get<FakeAnalysis>(f), replacement);
+  EXPECT_EQ(cache.Get<FakeAnalysis>(f)->value, 2);
+
+  cache.Put(f, std::make_unique<OtherAnalysis>(OtherAnalysis{3}));
+  cache.Forget(f);
+  EXPECT_EQ(cache.Get<FakeAnalysis>(f), nullptr);
+  EXPECT_EQ(cache.Get<OtherAnalysis>(f), nullptr);
+}
+
+// A pass which adds a single literal node to the given function the first
+// `change_count` times it is run and is a no-op thereafter.
+class AddLiteralPass : public PassBase<Package> {
+ public:
+  AddLiteralPass(Function* f, int64_t change_count)
+      : PassBase<Package>("add_literal", "Add literal"),
+        f_(f),
+        remaining_changes_(change_count) {}
+
+ protected:
+  absl::StatusOr<bool> RunInternal(Package* p, const PassOptions& options,
+                                   PassResults* results) const override {
+    if (remaining_changes_ == 0) {
+      return false;
+    }
+    --remaining_changes_;
+    XLS_RETURN_IF_ERROR(
+        f_->MakeNode<Literal>(SourceInfo(), Value(UBits(0, 8))).status());
+    return true;
+  }
+
+ private:
+  Function* f_;
+  mutable int64_t remaining_changes_;
+};
+
+TEST_F(PassBaseTest, InvocationRecordsMetrics) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+fn id(x: bits[8]) -> bits[8] {
+  ret not.1: bits[8] = not(x)
+}
+)",
+                                                       p.get()));
+  CompoundPassBase<Package> compound("top", "Top level pass");
+  compound.Add<AddLiteralPass>(f, /*change_count=*/1);
+  PassResults results;
+  XLS_ASSERT_OK(compound.Run(p.get(), PassOptions(), &results).status());
+  ASSERT_EQ(results.invocations.size(), 1);
+  EXPECT_EQ(results.invocations[0].pass_name, "add_literal");
+  EXPECT_TRUE(results.invocations[0].ir_changed);
+  EXPECT_EQ(results.invocations[0].node_count_delta, 1);
+  EXPECT_GT(results.invocations[0].transform_count, 0);
+  EXPECT_GT(results.invocations[0].memory_usage.node_bytes, 0);
+  EXPECT_GT(results.invocations[0].memory_usage.total_bytes(), 0);
+}
+
+TEST_F(PassBaseTest, MemoryLimitAborts) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+fn id(x: bits[8]) -> bits[8] {
+  ret not.1: bits[8] = not(x)
+}
+)",
+                                                       p.get()));
+  CompoundPassBase<Package> compound("top", "Top level pass");
+  compound.Add<AddLiteralPass>(f, /*change_count=*/1);
+  PassOptions options;
+  // Any live process exceeds a one-byte limit, so the first pass must abort
+  // with the breakdown rather than continuing.
+  options.memory_limit_bytes = 1;
+  PassResults results;
+  EXPECT_THAT(compound.Run(p.get(), options, &results).status(),
+              status_testing::StatusIs(absl::StatusCode::kResourceExhausted,
+                                       testing::HasSubstr("Memory limit")));
+}
+
+TEST_F(PassBaseTest, FixedPointIterationsRecorded) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+fn id(x: bits[8]) -> bits[8] {
+  ret not.1: bits[8] = not(x)
+}
+)",
+                                                       p.get()));
+  FixedPointCompoundPassBase<Package> fixed_point("fp", "Fixed point pass");
+  fixed_point.Add<AddLiteralPass>(f, /*change_count=*/2);
+  PassResults results;
+  XLS_ASSERT_OK(fixed_point.Run(p.get(), PassOptions(), &results).status());
+  // Two iterations change the IR plus a final one which reaches the fixed
+  // point.
+  EXPECT_EQ(results.fixed_point_iterations.at("fp"), 3);
+  EXPECT_EQ(results.invocations.size(), 3);
+}
+
+TEST_F(PassBaseTest, ExpiredDeadlineStopsBeforeFirstPass) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+fn id(x: bits[8]) -> bits[8] {
+  ret not.1: bits[8] = not(x)
+}
+)",
+                                                       p.get()));
+  CompoundPassBase<Package> compound("top", "Top level pass");
+  compound.Add<AddLiteralPass>(f, /*change_count=*/1);
+  PassOptions options;
+  options.deadline = absl::Now() - absl::Seconds(1);
+  PassResults results;
+  int64_t node_count_before = p->GetNodeCount();
+  XLS_ASSERT_OK(compound.Run(p.get(), options, &results).status());
+  EXPECT_TRUE(results.interrupted);
+  EXPECT_TRUE(results.invocations.empty());
+  EXPECT_EQ(p->GetNodeCount(), node_count_before);
+}
+
+// A pass which fires the given cancellation token and leaves the IR alone.
+class CancelPass : public PassBase<Package> {
+ public:
+  explicit CancelPass(CancellationScope* scope)
+      : PassBase<Package>("cancel", "Cancel"), scope_(scope) {}
+
+ protected:
+  absl::StatusOr<bool> RunInternal(Package* p, const PassOptions& options,
+                                   PassResults* results) const override {
+    scope_->Cancel();
+    return false;
+  }
+
+ private:
+  CancellationScope* scope_;
+};
+
+TEST_F(PassBaseTest, CancellationStopsAtPassBoundary) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+fn id(x: bits[8]) -> bits[8] {
+  ret not.1: bits[8] = not(x)
+}
+)",
+                                                       p.get()));
+  CancellationScope scope;
+  CompoundPassBase<Package> compound("top", "Top level pass");
+  compound.Add<CancelPass>(&scope);
+  compound.Add<AddLiteralPass>(f, /*change_count=*/1);
+  PassOptions options;
+  options.cancellation = &scope;
+  PassResults results;
+  XLS_ASSERT_OK(compound.Run(p.get(), options, &results).status());
+  // The cancelling pass completes and is recorded; the pass behind it never
+  // starts.
+  EXPECT_TRUE(results.interrupted);
+  ASSERT_EQ(results.invocations.size(), 1);
+  EXPECT_EQ(results.invocations[0].pass_name, "cancel");
+}
+
+}  // namespace
+}  // namespace xls
@@ -14,11 +14,17 @@
 
 #include "xls/passes/passes.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 
 namespace xls {
 
@@ -41,8 +47,27 @@ absl::StatusOr<bool> FunctionBasePass::RunOnFunctionBase(
 absl::StatusOr<bool> FunctionBasePass::RunInternal(Package* p,
                                                    const PassOptions& options,
                                                    PassResults* results) const {
+  std::vector<FunctionBase*> function_bases = p->GetFunctionBases();
+  if (results->dirty_functions != nullptr && SupportsParallelExecution()) {
+    // Inside a fixed-point pipeline only the functions changed by the
+    // previous iteration can yield new simplifications; every pass already
+    // ran to completion on the others. This shortcut is only valid for passes
+    // whose result depends solely on the FunctionBase they run on, which is
+    // exactly the guarantee made by SupportsParallelExecution(); passes which
+    // examine other FunctionBases always process everything.
+    function_bases.erase(
+        std::remove_if(function_bases.begin(), function_bases.end(),
+                       [&](FunctionBase* f) {
+                         return !results->dirty_functions->contains(f->name());
+                       }),
+        function_bases.end());
+  }
+  if (options.parallelism > 1 && function_bases.size() > 1 &&
+      SupportsParallelExecution()) {
+    return RunOnFunctionBasesInParallel(p, function_bases, options, results);
+  }
   bool changed = false;
-  for (FunctionBase* f : p->GetFunctionBases()) {
+  for (FunctionBase* f : function_bases) {
     XLS_ASSIGN_OR_RETURN(bool function_changed,
                          RunOnFunctionBaseInternal(f, options, results));
     changed |= function_changed;
@@ -50,6 +75,74 @@ absl::StatusOr<bool> FunctionBasePass::RunInternal(Package* p,
   return changed;
 }
 
+absl::StatusOr<bool> FunctionBasePass::RunOnFunctionBasesInParallel(
+    Package* p, absl::Span<FunctionBase* const> function_bases,
+    const PassOptions& options, PassResults* results) const {
+  const int64_t num_tasks = function_bases.size();
+  const int64_t num_threads = std::min(options.parallelism, num_tasks);
+
+  // Each FunctionBase is one task with its own result slot and its own
+  // PassResults so workers never touch shared state. Each task allocates node
+  // ids from the strided sequence determined by the task index, so ids are
+  // unique and deterministic regardless of which thread runs which task.
+  struct Task {
+    absl::StatusOr<bool> changed = false;
+    PassResults results;
+    int64_t next_node_id = 0;
+  };
+  const int64_t id_base = p->next_node_id();
+  std::vector<Task> tasks(num_tasks);
+  // Hand each task the analyses cached for its FunctionBase so work done by
+  // earlier passes is still reused.
+  for (int64_t i = 0; i < num_tasks; ++i) {
+    results->analysis_cache.MoveEntriesFor(function_bases[i],
+                                           &tasks[i].results.analysis_cache);
+  }
+
+  std::atomic<int64_t> next_task(0);
+  auto worker = [&]() {
+    while (true) {
+      int64_t task_index = next_task.fetch_add(1, std::memory_order_relaxed);
+      if (task_index >= num_tasks) {
+        return;
+      }
+      Task& task = tasks[task_index];
+      ScopedStridedNodeIds strided_ids(p, id_base + task_index,
+                                       /*stride=*/num_tasks);
+      task.changed = RunOnFunctionBaseInternal(function_bases[task_index],
+                                               options, &task.results);
+      task.next_node_id = strided_ids.next_id();
+    }
+  };
+  std::vector<std::unique_ptr<Thread>> threads;
+  threads.reserve(num_threads);
+  for (int64_t i = 0; i < num_threads; ++i) {
+    threads.push_back(std::make_unique<Thread>(worker));
+  }
+  for (std::unique_ptr<Thread>& thread : threads) {
+    thread->Join();
+  }
+
+  // Merge per-task results in package order (not completion order) so errors
+  // and cache contents are deterministic. Advance the node id counter past
+  // all strided ids before any error return; nodes may have been created even
+  // by tasks which ultimately failed.
+  int64_t next_node_id = p->next_node_id();
+  for (int64_t i = 0; i < num_tasks; ++i) {
+    tasks[i].results.analysis_cache.MoveEntriesFor(function_bases[i],
+                                                   &results->analysis_cache);
+    next_node_id = std::max(next_node_id, tasks[i].next_node_id);
+  }
+  p->set_next_node_id(next_node_id);
+
+  bool changed = false;
+  for (int64_t i = 0; i < num_tasks; ++i) {
+    XLS_ASSIGN_OR_RETURN(bool task_changed, std::move(tasks[i].changed));
+    changed |= task_changed;
+  }
+  return changed;
+}
+
 absl::StatusOr<bool> FunctionBasePass::TransformNodesToFixedPoint(
     FunctionBase* f,
     std::function<absl::StatusOr<bool>(Node*)> simplify_f) const {
@@ -26,6 +26,7 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "xls/ir/function.h"
 #include "xls/ir/package.h"
 #include "xls/ir/proc.h"
@@ -59,9 +60,22 @@ class FunctionBasePass : public Pass {
                                          const PassOptions& options,
                                          PassResults* results) const;
 
+  // Returns true if RunOnFunctionBaseInternal reads and mutates only the
+  // FunctionBase passed to it (plus package-wide state with thread-safe
+  // access: type interning, node ids and the node arena). Passes for which
+  // this holds may be run on the FunctionBases of a package in parallel when
+  // PassOptions::parallelism is greater than one. Passes which examine other
+  // FunctionBases -- e.g. inline or unroll the body of an invoked function --
+  // must override this to return false; they always run serially.
+  virtual bool SupportsParallelExecution() const { return true; }
+
  protected:
   // Iterates over each function and proc in the package calling
-  // RunOnFunctionBase.
+  // RunOnFunctionBase. If `options.parallelism` is greater than one and the
+  // pass supports it, the FunctionBases are processed by a pool of worker
+  // threads instead; results (changed bits, cached analyses, node id counter)
+  // are merged in package order so the outcome is deterministic and identical
+  // to a serial run except for the numbering of newly created nodes.
   absl::StatusOr<bool> RunInternal(Package* p, const PassOptions& options,
                                    PassResults* results) const override;
 
@@ -69,6 +83,13 @@ class FunctionBasePass : public Pass {
       FunctionBase* f, const PassOptions& options,
       PassResults* results) const = 0;
 
+  // Implements RunInternal's parallel mode: dispatches the RunOnFunctionBase
+  // calls for `function_bases` to a pool of at most `options.parallelism`
+  // worker threads.
+  absl::StatusOr<bool> RunOnFunctionBasesInParallel(
+      Package* p, absl::Span<FunctionBase* const> function_bases,
+      const PassOptions& options, PassResults* results) const;
+
   // Calls the given function for every node in the graph in a loop until no
   // further simplifications are possible.  simplify_f should return true if the
   // IR was modified. simplify_f can add or remove nodes including the node
@@ -27,8 +27,10 @@
 #include "xls/ir/function.h"
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_parser.h"
+#include "xls/ir/nodes.h"
 #include "xls/ir/package.h"
 #include "xls/ir/type.h"
+#include "xls/ir/value.h"
 
 namespace xls {
 namespace {
@@ -477,5 +479,109 @@ TEST(PassesTest, TestTransformNodesToFixedPointWhileRemovingNodes) {
               IsOkAndHolds(false));
 }
 
+// Trivial function-level pass which adds one new node to each function. Used
+// to exercise parallel execution including node id assignment.
+class AddLiteralPass : public FunctionBasePass {
+ public:
+  AddLiteralPass() : FunctionBasePass("add_literal", "Add a literal") {}
+
+ protected:
+  absl::StatusOr<bool> RunOnFunctionBaseInternal(
+      FunctionBase* f, const PassOptions& options,
+      PassResults* results) const override {
+    XLS_RETURN_IF_ERROR(
+        f->MakeNode<Literal>(SourceInfo(), Value(UBits(0, 32))).status());
+    return true;
+  }
+};
+
+// Builds a package with `n` identical single-node functions.
+std::unique_ptr<Package> BuildMultiFunctionPackage(int64_t n) {
+  auto p = std::make_unique<Package>("m");
+  for (int64_t i = 0; i < n; ++i) {
+    FunctionBuilder fb(absl::StrFormat("f%d", i), p.get());
+    BValue x = fb.Param("x", p->GetBitsType(32));
+    fb.Not(x);
+    XLS_CHECK_OK(fb.Build().status());
+  }
+  return p;
+}
+
+TEST(PassesTest, FunctionBasePassRunsFunctionBasesInParallel) {
+  constexpr int64_t kNumFunctions = 7;
+  auto run = [&](int64_t parallelism) -> std::vector<int64_t> {
+    std::unique_ptr<Package> p = BuildMultiFunctionPackage(kNumFunctions);
+    PassOptions options;
+    options.parallelism = parallelism;
+    PassResults results;
+    EXPECT_THAT(AddLiteralPass().Run(p.get(), options, &results),
+                IsOkAndHolds(true));
+    // Collect all node ids in package order; they must be unique and below
+    // the package's node id counter.
+    std::vector<int64_t> ids;
+    for (FunctionBase* f : p->GetFunctionBases()) {
+      EXPECT_EQ(f->node_count(), 3);
+      for (Node* node : f->nodes()) {
+        EXPECT_LT(node->id(), p->next_node_id());
+        ids.push_back(node->id());
+      }
+    }
+    absl::flat_hash_set<int64_t> unique_ids(ids.begin(), ids.end());
+    EXPECT_EQ(unique_ids.size(), ids.size());
+    return ids;
+  };
+
+  std::vector<int64_t> serial_ids = run(1);
+  // Parallel runs produce the same ids regardless of thread count.
+  EXPECT_EQ(run(2), run(4));
+  EXPECT_EQ(run(4), run(kNumFunctions + 3));
+  // The serial run differs only in the numbering of the new literals, not in
+  // the number or uniqueness of nodes.
+  EXPECT_EQ(serial_ids.size(), run(2).size());
+}
+
+// Function-scoped pass which records the names of the functions it runs on
+// and adds a node to `to_change` the first time it sees it.
+class RecordingPass : public FunctionBasePass {
+ public:
+  RecordingPass(FunctionBase* to_change, std::vector<std::string>* visited)
+      : FunctionBasePass("record", "Recording pass"),
+        to_change_(to_change),
+        visited_(visited) {}
+
+ protected:
+  absl::StatusOr<bool> RunOnFunctionBaseInternal(
+      FunctionBase* f, const PassOptions& options,
+      PassResults* results) const override {
+    visited_->push_back(f->name());
+    if (f == to_change_ && !changed_) {
+      changed_ = true;
+      XLS_RETURN_IF_ERROR(
+          f->MakeNode<Literal>(SourceInfo(), Value(UBits(0, 32))).status());
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  FunctionBase* to_change_;
+  std::vector<std::string>* visited_;
+  mutable bool changed_ = false;
+};
+
+TEST(PassesTest, FixedPointSkipsCleanFunctions) {
+  std::unique_ptr<Package> p = BuildMultiFunctionPackage(2);
+  std::vector<FunctionBase*> function_bases = p->GetFunctionBases();
+  std::vector<std::string> visited;
+  FixedPointCompoundPass fixed_point("fp", "Fixed point pass");
+  fixed_point.Add<RecordingPass>(function_bases[0], &visited);
+  PassResults results;
+  EXPECT_THAT(fixed_point.Run(p.get(), PassOptions(), &results),
+              IsOkAndHolds(true));
+  // The first iteration visits both functions and changes f0; the second
+  // iteration revisits only f0 and reaches the fixed point.
+  EXPECT_THAT(visited, ElementsAre("f0", "f1", "f0"));
+}
+
 }  // namespace
 }  // namespace xls
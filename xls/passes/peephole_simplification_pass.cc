@@ -0,0 +1,131 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/peephole_simplification_pass.h"
+
+#include <deque>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/node.h"
+#include "xls/ir/node_iterator.h"
+#include "xls/ir/proc.h"
+#include "xls/passes/arith_simplification_pass.h"
+#include "xls/passes/bit_slice_simplification_pass.h"
+#include "xls/passes/concat_simplification_pass.h"
+#include "xls/passes/tuple_simplification_pass.h"
+
+namespace xls {
+namespace {
+
+// Applies the registered rewrite rules to `node`, stopping at the first rule
+// which modifies the IR. Returns true iff a rule fired. After a rule fires
+// `node` has typically been cut out of the graph, so the remaining rules are
+// not tried; the engine revisits the neighborhood instead.
+absl::StatusOr<bool> ApplyRules(Node* node, int64_t opt_level) {
+  XLS_ASSIGN_OR_RETURN(bool arith_changed, MatchArithPatterns(opt_level, node));
+  if (arith_changed) {
+    return true;
+  }
+  XLS_ASSIGN_OR_RETURN(bool slice_changed,
+                       SimplifyBitSliceNode(node, opt_level));
+  if (slice_changed) {
+    return true;
+  }
+  XLS_ASSIGN_OR_RETURN(bool concat_changed,
+                       SimplifyConcatNode(node, opt_level));
+  if (concat_changed) {
+    return true;
+  }
+  return SimplifyTupleNode(node);
+}
+
+}  // namespace
+
+absl::StatusOr<bool> PeepholeSimplificationPass::RunOnFunctionBaseInternal(
+    FunctionBase* f, const PassOptions& options, PassResults* results) const {
+  // Seed the worklist with every node, defs before uses so most nodes see
+  // already-simplified operands on their first visit.
+  std::deque<Node*> worklist;
+  absl::flat_hash_set<Node*> in_worklist;
+  for (Node* node : TopoSort(f)) {
+    worklist.push_back(node);
+    in_worklist.insert(node);
+  }
+  auto enqueue = [&](Node* node) {
+    if (in_worklist.insert(node).second) {
+      worklist.push_back(node);
+    }
+  };
+
+  bool changed = false;
+  while (!worklist.empty()) {
+    Node* node = worklist.front();
+    worklist.pop_front();
+    in_worklist.erase(node);
+    // The rules never remove nodes, only disconnect them (DCE cleans up
+    // afterwards), so node pointers in the worklist stay valid and dead nodes
+    // can simply be skipped.
+    if (node->IsDead()) {
+      continue;
+    }
+
+    // Snapshot the users before rewriting: a successful rewrite redirects
+    // them to the replacement expression.
+    std::vector<Node*> prior_users(node->users().begin(), node->users().end());
+    const bool had_implicit_use = f->HasImplicitUse(node);
+    XLS_ASSIGN_OR_RETURN(bool node_changed, ApplyRules(node, opt_level_));
+    if (!node_changed) {
+      continue;
+    }
+    changed = true;
+    XLS_VLOG(3) << "Peephole rule fired on: " << node->GetName();
+
+    // Mark the neighborhood of the rewrite dirty. The prior users now use the
+    // replacement and may simplify further; their operands include the
+    // replacement expression itself plus any nodes whose use counts changed.
+    for (Node* user : prior_users) {
+      enqueue(user);
+      for (Node* operand : user->operands()) {
+        enqueue(operand);
+      }
+    }
+    // An implicitly used node (e.g. the return value) has no user node
+    // through which the replacement can be found, so enqueue the current
+    // implicit-use roots directly.
+    if (had_implicit_use) {
+      if (f->IsFunction()) {
+        enqueue(f->AsFunctionOrDie()->return_value());
+      } else if (f->IsProc()) {
+        Proc* proc = f->AsProcOrDie();
+        enqueue(proc->NextToken());
+        for (Node* next_state : proc->NextState()) {
+          enqueue(next_state);
+        }
+      }
+    }
+    // The node itself may still be live (e.g. only some uses were rewritten)
+    // and its operands may have become single-use or dead.
+    enqueue(node);
+    for (Node* operand : node->operands()) {
+      enqueue(operand);
+    }
+  }
+  return changed;
+}
+
+}  // namespace xls
@@ -0,0 +1,47 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_PASSES_PEEPHOLE_SIMPLIFICATION_PASS_H_
+#define XLS_PASSES_PEEPHOLE_SIMPLIFICATION_PASS_H_
+
+#include "absl/status/statusor.h"
+#include "xls/ir/function.h"
+#include "xls/passes/passes.h"
+
+namespace xls {
+
+// Worklist-driven pass which runs the node-local rewrite rules of the
+// arithmetic, bit-slice, concat and tuple simplification passes to a combined
+// fixed point. Where running those passes back to back costs one full
+// traversal per pass per fixed-point iteration, this pass visits every node
+// once in topological order and afterwards revisits only nodes in the
+// neighborhood of a rewrite, so unchanged regions of the graph are never
+// touched again.
+class PeepholeSimplificationPass : public FunctionBasePass {
+ public:
+  explicit PeepholeSimplificationPass(int64_t opt_level = kMaxOptLevel)
+      : FunctionBasePass("peephole_simp", "Peephole simplification"),
+        opt_level_(opt_level) {}
+  ~PeepholeSimplificationPass() override {}
+
+ protected:
+  int64_t opt_level_;
+  absl::StatusOr<bool> RunOnFunctionBaseInternal(
+      FunctionBase* f, const PassOptions& options,
+      PassResults* results) const override;
+};
+
+}  // namespace xls
+
+#endif  // XLS_PASSES_PEEPHOLE_SIMPLIFICATION_PASS_H_
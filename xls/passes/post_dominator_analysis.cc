@@ -14,140 +14,140 @@
 
 #include "xls/passes/post_dominator_analysis.h"
 
-#include <algorithm>
-#include <cstdio>
-#include <queue>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
 
-#include "absl/algorithm/container.h"
-#include "absl/container/flat_hash_map.h"
-#include "absl/container/flat_hash_set.h"
-#include "absl/memory/memory.h"
-#include "absl/meta/type_traits.h"
-#include "absl/status/status.h"
 #include "absl/status/statusor.h"
-#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
 #include "xls/ir/function.h"
+#include "xls/ir/node_indexed_vector.h"
 #include "xls/ir/node_iterator.h"
 #include "xls/ir/node_util.h"
-#include "xls/ir/proc.h"
+#include "xls/passes/pass_base.h"
 
 namespace xls {
-namespace {
 
-using NodeIndex = int64_t;
+/* static */ absl::StatusOr<std::unique_ptr<PostDominatorAnalysis>>
+PostDominatorAnalysis::Run(FunctionBase* f) {
+  auto analysis = std::make_unique<PostDominatorAnalysis>();
+
+  // A reverse topological sort of the function nodes: every node's users
+  // precede it, so each node's immediate post-dominator is computed after
+  // those of all its users.
+  NodeIterator r = ReverseTopoSort(f);
+  analysis->nodes_ = std::vector<Node*>(r.begin(), r.end());
+  const std::vector<Node*>& nodes = analysis->nodes_;
+  const int64_t node_count = nodes.size();
 
-// Returns the intersection of the given sorted lists. Lists should be sorted in
-// ascending order.
-std::vector<NodeIndex> IntersectSortedLists(
-    absl::Span<const absl::Span<const NodeIndex>> lists) {
-  std::vector<NodeIndex> intersection;
-  if (lists.empty()) {
-    return intersection;
+  NodeIndexedVector<int64_t>& node_index = analysis->node_index_;
+  for (int64_t i = 0; i < node_count; ++i) {
+    node_index[nodes[i]] = i;
   }
-  std::vector<int64_t> indices(lists.size(), 0);
 
-  // Returns true if any of the indices are at the end of their respective
-  // lists.
-  auto at_end_of_a_list = [&]() {
-    for (int64_t i = 0; i < indices.size(); ++i) {
-      if (indices[i] == lists[i].size()) {
-        return true;
+  // Compute the immediate post-dominator of each node with the iterative
+  // dominator algorithm of Cooper, Harvey & Kennedy run on the reversed graph:
+  // ipdom(n) is the nearest common ancestor of n's users in the tree built so
+  // far. Nodes without users hang off a virtual exit node. A single pass
+  // suffices since the graph is acyclic and users are processed first.
+  std::vector<int64_t>& ipdom = analysis->ipdom_;
+  ipdom.resize(node_count);
+  // Walks the two tree paths to their nearest common ancestor. Parents always
+  // have smaller indices, so the deeper-indexed side is advanced.
+  auto intersect = [&ipdom](int64_t a, int64_t b) {
+    while (a != b) {
+      if (a == kVirtualExit || b == kVirtualExit) {
+        return kVirtualExit;
+      }
+      if (a > b) {
+        a = ipdom[a];
+      } else {
+        b = ipdom[b];
       }
     }
-    return false;
+    return a;
   };
-  while (!at_end_of_a_list()) {
-    // Find the minimum value among the list elements at their respective
-    // indices.
-    NodeIndex min_value = lists[0][indices[0]];
-    for (int64_t i = 1; i < lists.size(); ++i) {
-      NodeIndex value = lists[i][indices[i]];
-      if (value < min_value) {
-        min_value = value;
-      }
+  for (int64_t i = 0; i < node_count; ++i) {
+    Node* node = nodes[i];
+    int64_t pd = kVirtualExit;
+    bool first = true;
+    for (Node* user : node->users()) {
+      int64_t user_index = node_index.at(user);
+      pd = first ? user_index : intersect(pd, user_index);
+      first = false;
     }
+    ipdom[i] = pd;
+  }
 
-    // Advance all list indices which hold the minimum value.
-    int64_t match_count = 0;
-    for (int64_t i = 0; i < lists.size(); ++i) {
-      if (lists[i][indices[i]] == min_value) {
-        indices[i]++;
-        match_count++;
-      }
+  // Build the child lists and assign each node a preorder interval, iterating
+  // with an explicit stack since post-dominator trees of deep chains are
+  // themselves deep.
+  analysis->children_.resize(node_count);
+  std::vector<int64_t> roots;
+  for (int64_t i = 0; i < node_count; ++i) {
+    if (ipdom[i] == kVirtualExit) {
+      roots.push_back(i);
+    } else {
+      analysis->children_[ipdom[i]].push_back(i);
     }
-
-    // If all lists contained the minimum value then add the value to the
-    // intersection.
-    if (match_count == lists.size()) {
-      intersection.push_back(min_value);
+  }
+  analysis->tree_in_.resize(node_count);
+  analysis->tree_out_.resize(node_count);
+  int64_t timestamp = 0;
+  std::vector<std::pair<int64_t, int64_t>> stack;
+  for (int64_t root : roots) {
+    analysis->tree_in_[root] = timestamp++;
+    stack.push_back({root, 0});
+    while (!stack.empty()) {
+      auto& [index, child_pos] = stack.back();
+      if (child_pos <
+          static_cast<int64_t>(analysis->children_[index].size())) {
+        int64_t child = analysis->children_[index][child_pos++];
+        analysis->tree_in_[child] = timestamp++;
+        stack.push_back({child, 0});
+      } else {
+        analysis->tree_out_[index] = timestamp;
+        stack.pop_back();
+      }
     }
   }
-  return intersection;
-}
-
-}  // namespace
 
-/* static */ absl::StatusOr<std::unique_ptr<PostDominatorAnalysis>>
-PostDominatorAnalysis::Run(FunctionBase* f) {
-  auto analysis = std::make_unique<PostDominatorAnalysis>();
-
-  // A reverse topological sort of the function nodes.
-  NodeIterator r = ReverseTopoSort(f);
-  std::vector<Node*> reverse_toposort(r.begin(), r.end());
+  return std::move(analysis);
+}
 
-  // Map from node to index in a reverse topo sort.
-  absl::flat_hash_map<Node*, NodeIndex> node_index;
-  for (NodeIndex i = 0; i < reverse_toposort.size(); ++i) {
-    node_index[reverse_toposort[i]] = i;
+/* static */ absl::StatusOr<PostDominatorAnalysis*>
+PostDominatorAnalysis::RunCached(FunctionBase* f, AnalysisCache* cache) {
+  PostDominatorAnalysis* analysis = cache->Get<PostDominatorAnalysis>(f);
+  if (analysis == nullptr) {
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<PostDominatorAnalysis> owned, Run(f));
+    analysis = cache->Put(f, std::move(owned));
   }
+  return analysis;
+}
 
-  // Construct the postdominators for each node. Postdominators are gathered as
-  // a sorted vector containing the node indices (in a reverse toposort) of the
-  // post dominator nodes.
-  absl::flat_hash_map<Node*, std::vector<NodeIndex>> postdominators;
-  for (NodeIndex i = 0; i < reverse_toposort.size(); ++i) {
-    Node* node = reverse_toposort[i];
-    std::vector<absl::Span<const NodeIndex>> user_postdominators;
-    for (Node* user : node->users()) {
-      user_postdominators.push_back(postdominators.at(user));
-    }
-    // The postdominators of a node is the intersection of the lists of
-    // postdominators for its users plus the node itself.
-    postdominators[node] = IntersectSortedLists(user_postdominators);
-    postdominators[node].push_back(i);
+std::vector<Node*> PostDominatorAnalysis::GetPostDominatorsOfNode(
+    const Node* node) const {
+  std::vector<Node*> post_dominators;
+  for (int64_t i = node_index_.at(node); i != kVirtualExit; i = ipdom_[i]) {
+    post_dominators.push_back(nodes_[i]);
   }
+  SortByNodeId(&post_dominators);
+  return post_dominators;
+}
 
-  for (Node* node : f->nodes()) {
-    for (NodeIndex postdominator_index : postdominators[node]) {
-      Node* postdominator = reverse_toposort.at(postdominator_index);
-      analysis->dominated_node_to_post_dominators_[node].insert(postdominator);
-      analysis->post_dominator_to_dominated_nodes_[postdominator].insert(node);
-    }
+std::vector<Node*> PostDominatorAnalysis::GetNodesPostDominatedByNode(
+    const Node* node) const {
+  std::vector<Node*> dominated;
+  std::vector<int64_t> worklist = {node_index_.at(node)};
+  while (!worklist.empty()) {
+    int64_t i = worklist.back();
+    worklist.pop_back();
+    dominated.push_back(nodes_[i]);
+    worklist.insert(worklist.end(), children_[i].begin(), children_[i].end());
   }
-
-  // Order nodes.
-  auto generate_ordered_by_id_nodes =
-      [](const absl::flat_hash_map<Node*, absl::flat_hash_set<Node*>>&
-             node_to_node_set,
-         absl::flat_hash_map<Node*, std::vector<Node*>>* node_to_node_vect) {
-        for (auto& [base_node, node_set] : node_to_node_set) {
-          auto& node_vect = (*node_to_node_vect)[base_node];
-          node_vect.insert(node_vect.begin(), node_set.begin(), node_set.end());
-          SortByNodeId(&node_vect);
-        }
-      };
-  XLS_RET_CHECK(
-      analysis->dominated_node_to_post_dominators_ordered_by_id_.empty());
-  XLS_RET_CHECK(
-      analysis->post_dominator_to_dominated_nodes_ordered_by_id_.empty());
-  generate_ordered_by_id_nodes(
-      analysis->dominated_node_to_post_dominators_,
-      &analysis->dominated_node_to_post_dominators_ordered_by_id_);
-  generate_ordered_by_id_nodes(
-      analysis->post_dominator_to_dominated_nodes_,
-      &analysis->post_dominator_to_dominated_nodes_ordered_by_id_);
-
-  return std::move(analysis);
+  SortByNodeId(&dominated);
+  return dominated;
 }
 
 }  // namespace xls
@@ -15,51 +15,87 @@
 #ifndef XLS_PASSES_POSTDOMINATOR_FUNCTION_H_
 #define XLS_PASSES_POSTDOMINATOR_FUNCTION_H_
 
-#include "absl/container/flat_hash_set.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 #include "absl/status/statusor.h"
-#include "absl/types/span.h"
 #include "xls/ir/function.h"
 #include "xls/ir/node.h"
+#include "xls/ir/node_indexed_vector.h"
 
 namespace xls {
 
+class AnalysisCache;
+
 // A class for post-dominator analysis of the IR instructions in a function.
+// The relation is stored as the immediate post-dominator tree with a preorder
+// interval numbering, so memory is linear in the node count (rather than
+// quadratic as with per-node post-dominator sets) and the pairwise queries are
+// O(1).
 class PostDominatorAnalysis {
  public:
   // Performs post-dominator analysis on the function and returns the result.
   static absl::StatusOr<std::unique_ptr<PostDominatorAnalysis>> Run(
       FunctionBase* f);
 
-  // Returns the nodes that post-dominate this node.
-  absl::Span<Node* const> GetPostDominatorsOfNode(const Node* node) const {
-    return dominated_node_to_post_dominators_ordered_by_id_.at(node);
-  }
-  // Returns the nodes that are post-dominated by this node.
-  absl::Span<Node* const> GetNodesPostDominatedByNode(const Node* node) const {
-    return post_dominator_to_dominated_nodes_ordered_by_id_.at(node);
-  }
+  // Returns the analysis for 'f' from 'cache' (see
+  // PassResults::analysis_cache), computing and caching it if absent or stale.
+  // The returned analysis is owned by the cache and valid until 'f' is next
+  // mutated.
+  static absl::StatusOr<PostDominatorAnalysis*> RunCached(FunctionBase* f,
+                                                          AnalysisCache* cache);
+
+  // Returns the nodes that post-dominate this node (including the node
+  // itself), ordered by node id. Materialized per call by walking the tree to
+  // its root; prefer the O(1) predicates below for pairwise queries.
+  std::vector<Node*> GetPostDominatorsOfNode(const Node* node) const;
+
+  // Returns the nodes that are post-dominated by this node (including the node
+  // itself), ordered by node id. Materialized per call from the node's
+  // subtree.
+  std::vector<Node*> GetNodesPostDominatedByNode(const Node* node) const;
+
   // Returns true if 'node' is post-dominated by 'post_dominator'.
   bool NodeIsPostDominatedBy(const Node* node,
                              const Node* post_dominator) const {
-    return dominated_node_to_post_dominators_.at(node).contains(post_dominator);
+    return IsAncestorOrSelf(post_dominator, node);
   }
   // Returns true if 'node' post_dominates 'post_dominated'.
   bool NodePostDominates(const Node* node, const Node* post_dominated) const {
-    return post_dominator_to_dominated_nodes_.at(node).contains(post_dominated);
+    return IsAncestorOrSelf(node, post_dominated);
   }
 
  private:
-  // Maps from a node to all nodes that post-dominate the node.
-  absl::flat_hash_map<Node*, absl::flat_hash_set<Node*>>
-      dominated_node_to_post_dominators_;
-  absl::flat_hash_map<Node*, std::vector<Node*>>
-      dominated_node_to_post_dominators_ordered_by_id_;
-
-  // Maps from a node to all nodes that are post-dominated by the node.
-  absl::flat_hash_map<Node*, absl::flat_hash_set<Node*>>
-      post_dominator_to_dominated_nodes_;
-  absl::flat_hash_map<Node*, std::vector<Node*>>
-      post_dominator_to_dominated_nodes_ordered_by_id_;
+  // Parent index of nodes whose immediate post-dominator is the virtual exit,
+  // i.e. the roots of the post-dominator forest (nodes with no users).
+  static constexpr int64_t kVirtualExit = -1;
+
+  // Returns true if 'ancestor' is 'descendant' or an ancestor of it in the
+  // post-dominator tree: an interval containment test on the preorder
+  // numbering.
+  bool IsAncestorOrSelf(const Node* ancestor, const Node* descendant) const {
+    int64_t a = node_index_.at(ancestor);
+    int64_t d = node_index_.at(descendant);
+    return tree_in_[a] <= tree_in_[d] && tree_in_[d] < tree_out_[a];
+  }
+
+  // The function's nodes in reverse topological order; all indices below refer
+  // into this vector.
+  std::vector<Node*> nodes_;
+  NodeIndexedVector<int64_t> node_index_;
+
+  // Immediate post-dominator (tree parent) of each node, or kVirtualExit.
+  std::vector<int64_t> ipdom_;
+
+  // Children of each node in the post-dominator tree.
+  std::vector<std::vector<int64_t>> children_;
+
+  // Preorder entry number and exclusive exit number of each node; a node's
+  // descendants are exactly the nodes whose entry number falls in
+  // [tree_in_, tree_out_).
+  std::vector<int64_t> tree_in_;
+  std::vector<int64_t> tree_out_;
 };
 
 }  // namespace xls
@@ -19,6 +19,8 @@
 #include "xls/common/status/matchers.h"
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_test_base.h"
+#include "xls/ir/nodes.h"
+#include "xls/passes/pass_base.h"
 
 namespace xls {
 namespace {
@@ -220,5 +222,28 @@ TEST_F(PostDominatorAnalysisTest, DisconnectedNode) {
               ElementsAre(x.node(), z.node()));
 }
 
+TEST_F(PostDominatorAnalysisTest, RunCachedReusesAnalysis) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(1));
+  fb.Not(x);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  AnalysisCache cache;
+  XLS_ASSERT_OK_AND_ASSIGN(PostDominatorAnalysis * first,
+                           PostDominatorAnalysis::RunCached(f, &cache));
+  XLS_ASSERT_OK_AND_ASSIGN(PostDominatorAnalysis * second,
+                           PostDominatorAnalysis::RunCached(f, &cache));
+  EXPECT_EQ(first, second);
+
+  // Mutating the function invalidates the cached analysis; the recomputed one
+  // covers the new node.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Node * fresh, f->MakeNode<UnOp>(SourceInfo(), x.node(), Op::kNot));
+  XLS_ASSERT_OK_AND_ASSIGN(PostDominatorAnalysis * third,
+                           PostDominatorAnalysis::RunCached(f, &cache));
+  EXPECT_THAT(third->GetPostDominatorsOfNode(fresh), ElementsAre(fresh));
+}
+
 }  // namespace
 }  // namespace xls
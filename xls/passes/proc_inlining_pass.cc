@@ -14,9 +14,11 @@
 
 #include "xls/passes/proc_inlining_pass.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "xls/common/logging/logging.h"
+#include "xls/data_structures/union_find.h"
 #include "xls/ir/node_iterator.h"
 #include "xls/ir/node_util.h"
 #include "xls/ir/op.h"
@@ -1563,6 +1565,46 @@ absl::Status SetProcState(Proc* proc, absl::Span<const StateElement> elements) {
   return absl::OkStatus();
 }
 
+// Partitions the procs in `p` into clusters of procs which communicate
+// (transitively) over internal channels. Procs in different clusters share no
+// internal channels, so each cluster's virtual channels and activation
+// network can be constructed and analyzed independently. Clusters (and the
+// procs within them) are returned in the package's proc order.
+absl::StatusOr<std::vector<std::vector<Proc*>>> ClusterProcs(Package* p) {
+  UnionFind<Proc*> uf;
+  for (const std::unique_ptr<Proc>& proc : p->procs()) {
+    uf.Insert(proc.get());
+  }
+  absl::flat_hash_map<Channel*, Proc*> channel_to_proc;
+  for (const std::unique_ptr<Proc>& proc : p->procs()) {
+    for (Node* node : proc->nodes()) {
+      if (!IsChannelNode(node)) {
+        continue;
+      }
+      XLS_ASSIGN_OR_RETURN(Channel * ch, GetChannelUsedByNode(node));
+      if (ch->supported_ops() != ChannelOps::kSendReceive) {
+        continue;
+      }
+      auto [it, inserted] = channel_to_proc.try_emplace(ch, proc.get());
+      if (!inserted) {
+        uf.Union(it->second, proc.get());
+      }
+    }
+  }
+  std::vector<std::vector<Proc*>> clusters;
+  absl::flat_hash_map<Proc*, int64_t> cluster_index;
+  for (const std::unique_ptr<Proc>& proc : p->procs()) {
+    Proc* representative = uf.Find(proc.get());
+    auto [it, inserted] =
+        cluster_index.try_emplace(representative, clusters.size());
+    if (inserted) {
+      clusters.push_back({});
+    }
+    clusters[it->second].push_back(proc.get());
+  }
+  return clusters;
+}
+
 }  // namespace
 
 absl::StatusOr<bool> ProcInliningPass::RunInternal(Package* p,
@@ -1590,16 +1632,52 @@ absl::StatusOr<bool> ProcInliningPass::RunInternal(Package* p,
     procs_to_inline.push_back(proc.get());
   }
 
+  // Partition the procs into clusters which communicate with each other. Each
+  // cluster is self-contained and is inlined and analyzed independently,
+  // which keeps inlining time near-linear in the number of procs: the
+  // (potentially expensive) activation network analysis runs over one
+  // cluster's logic at a time rather than over the whole inlined network.
+  XLS_ASSIGN_OR_RETURN(std::vector<std::vector<Proc*>> clusters,
+                       ClusterProcs(p));
+
   Proc* container_proc =
       p->AddProc(std::make_unique<Proc>("__container", "tkn", p));
 
   // Gather all inlined proc state and proc thread book-keeping bits and add to
-  // the top-level proc state.
+  // the top-level proc state. State is gathered cluster by cluster so the
+  // state bits of communicating procs stay adjacent in the container proc
+  // state.
   std::vector<StateElement> state_elements;
 
   absl::flat_hash_map<Channel*, VirtualChannel> virtual_channels;
-  for (Channel* ch : p->channels()) {
-    if (ch->supported_ops() == ChannelOps::kSendReceive) {
+
+  // Inline each cluster of procs into `container_proc`. Sends/receives are
+  // converted to virtual send/receives.
+  // TODO(meheff): 2022/02/11 Add analysis which determines whether inlining is
+  // a legal transformation.
+  for (const std::vector<Proc*>& cluster : clusters) {
+    const int64_t min_node_id = p->next_node_id();
+
+    // Create the virtual channels for the channels this cluster communicates
+    // over. Any internal channel used by a proc in the cluster connects two
+    // procs in the cluster, by construction of the clusters. Iterate over the
+    // package's channels so the result is deterministic.
+    absl::flat_hash_set<Channel*> cluster_channels;
+    for (Proc* proc : cluster) {
+      for (Node* node : proc->nodes()) {
+        if (!IsChannelNode(node)) {
+          continue;
+        }
+        XLS_ASSIGN_OR_RETURN(Channel * ch, GetChannelUsedByNode(node));
+        if (ch->supported_ops() == ChannelOps::kSendReceive) {
+          cluster_channels.insert(ch);
+        }
+      }
+    }
+    for (Channel* ch : p->channels()) {
+      if (!cluster_channels.contains(ch)) {
+        continue;
+      }
       XLS_ASSIGN_OR_RETURN(virtual_channels[ch],
                            VirtualChannel::Create(ch, container_proc));
       if (virtual_channels[ch].ChannelDataState().has_value()) {
@@ -1609,37 +1687,44 @@ absl::StatusOr<bool> ProcInliningPass::RunInternal(Package* p,
             virtual_channels[ch].ChannelValidState().value());
       }
     }
-  }
-
-  std::vector<ProcThread> proc_threads;
-
-  // Inline each proc into `container_proc`. Sends/receives are converted to
-  // virtual send/receives.
-  // TODO(meheff): 2022/02/11 Add analysis which determines whether inlining is
-  // a legal transformation.
-  for (Proc* proc : procs_to_inline) {
-    XLS_ASSIGN_OR_RETURN(
-        ProcThread proc_thread,
-        InlineProcAsProcThread(proc, container_proc, virtual_channels));
-    proc_threads.push_back(std::move(proc_thread));
-  }
-
-  XLS_VLOG(3) << "After inlining procs:\n" << p->DumpIr();
 
-  BddQueryEngine query_engine(BddFunction::kDefaultPathLimit, IsCheapForBdds);
-  XLS_RETURN_IF_ERROR(query_engine.Populate(container_proc).status());
+    std::vector<ProcThread> cluster_threads;
+    for (Proc* proc : cluster) {
+      XLS_ASSIGN_OR_RETURN(
+          ProcThread proc_thread,
+          InlineProcAsProcThread(proc, container_proc, virtual_channels));
+      cluster_threads.push_back(std::move(proc_thread));
+    }
 
-  for (ProcThread& proc_thread : proc_threads) {
-    XLS_RETURN_IF_ERROR(proc_thread.MaybeSaveReceivedData(query_engine));
-  }
+    const int64_t max_node_id = p->next_node_id();
+
+    // Analyze only the nodes added to the container while inlining this
+    // cluster; nodes from other clusters cannot feed this cluster's
+    // activation network. Restricting the analysis only costs precision,
+    // which at worst saves received data unnecessarily.
+    BddQueryEngine query_engine(
+        BddFunction::kDefaultPathLimit,
+        [min_node_id, max_node_id](const Node* node) {
+          return node->id() >= min_node_id && node->id() < max_node_id &&
+                 IsCheapForBdds(node);
+        },
+        BddFunction::kDefaultOpBudget);
+    XLS_RETURN_IF_ERROR(query_engine.Populate(container_proc).status());
+
+    for (ProcThread& proc_thread : cluster_threads) {
+      XLS_RETURN_IF_ERROR(proc_thread.MaybeSaveReceivedData(query_engine));
+    }
 
-  // Add the inlined (and top) proc state and activation bits.
-  for (const ProcThread& proc_thread : proc_threads) {
-    for (const StateElement& state_element : proc_thread.GetStateElements()) {
-      state_elements.push_back(state_element);
+    // Add the cluster's proc state and activation bits.
+    for (const ProcThread& proc_thread : cluster_threads) {
+      for (const StateElement& state_element : proc_thread.GetStateElements()) {
+        state_elements.push_back(state_element);
+      }
     }
   }
 
+  XLS_VLOG(3) << "After inlining procs:\n" << p->DumpIr();
+
   // For each virtual channel, add an assertion which fires if data is dropped.
   std::vector<Node*> assertion_tokens;
   for (Channel* ch : p->channels()) {
@@ -1662,6 +1747,7 @@ absl::StatusOr<bool> ProcInliningPass::RunInternal(Package* p,
   XLS_RETURN_IF_ERROR(p->SetTop(container_proc));
   std::string top_proc_name = top_func_base->AsProcOrDie()->name();
   for (Proc* proc : procs_to_inline) {
+    results->analysis_cache.Forget(proc);
     XLS_RETURN_IF_ERROR(p->RemoveProc(proc));
   }
   container_proc->SetName(top_proc_name);
@@ -426,6 +426,61 @@ TEST_F(ProcInliningPassTest, NestedProcs) {
                 /*expected_ticks=*/3);
 }
 
+TEST_F(ProcInliningPassTest, IndependentProcClusters) {
+  // Two pairs of procs which communicate within each pair but not across
+  // pairs. Each pair is inlined and analyzed as a separate cluster.
+  auto p = CreatePackage();
+  Type* u32 = p->GetBitsType(32);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * ch_in0,
+      p->CreateStreamingChannel("in0", ChannelOps::kReceiveOnly, u32));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * ch_out0,
+      p->CreateStreamingChannel("out0", ChannelOps::kSendOnly, u32));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * a_to_b,
+      p->CreateStreamingChannel("a_to_b", ChannelOps::kSendReceive, u32,
+                                /*initial_values=*/{}, /*fifo_depth=*/0));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * b_to_a,
+      p->CreateStreamingChannel("b_to_a", ChannelOps::kSendReceive, u32,
+                                /*initial_values=*/{}, /*fifo_depth=*/0));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * ch_in1,
+      p->CreateStreamingChannel("in1", ChannelOps::kReceiveOnly, u32));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * ch_out1,
+      p->CreateStreamingChannel("out1", ChannelOps::kSendOnly, u32));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * c_to_d,
+      p->CreateStreamingChannel("c_to_d", ChannelOps::kSendReceive, u32,
+                                /*initial_values=*/{}, /*fifo_depth=*/0));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * d_to_c,
+      p->CreateStreamingChannel("d_to_c", ChannelOps::kSendReceive, u32,
+                                /*initial_values=*/{}, /*fifo_depth=*/0));
+
+  XLS_ASSERT_OK(
+      MakePassThroughProc("A", ch_in0, a_to_b, b_to_a, ch_out0, p.get())
+          .status());
+  XLS_ASSERT_OK(MakeDoublerProc("B", a_to_b, b_to_a, p.get()).status());
+  XLS_ASSERT_OK(
+      MakePassThroughProc("C", ch_in1, c_to_d, d_to_c, ch_out1, p.get())
+          .status());
+  XLS_ASSERT_OK(MakeDoublerProc("D", c_to_d, d_to_c, p.get()).status());
+
+  EXPECT_EQ(p->procs().size(), 4);
+  EvalAndExpect(p.get(), {{"in0", {1, 2, 3}}, {"in1", {10, 20, 30}}},
+                {{"out0", {2, 4, 6}}, {"out1", {20, 40, 60}}});
+
+  ASSERT_THAT(Run(p.get(), /*top=*/"A"), IsOkAndHolds(true));
+
+  EXPECT_EQ(p->procs().size(), 1);
+  EvalAndExpect(p.get(), {{"in0", {1, 2, 3}}, {"in1", {10, 20, 30}}},
+                {{"out0", {2, 4, 6}}, {"out1", {20, 40, 60}}});
+}
+
 TEST_F(ProcInliningPassTest, NestedProcsFifoDepth1) {
   // Nested procs where the inner proc does a trivial arithmetic operation.
   auto p = CreatePackage();
@@ -14,6 +14,8 @@
 
 #include "xls/passes/proc_state_optimization_pass.h"
 
+#include "absl/container/flat_hash_set.h"
+#include "absl/numeric/bits.h"
 #include "absl/strings/str_join.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
@@ -134,9 +136,31 @@ ComputeStateDependencies(Proc* proc) {
   return std::move(state_dependencies);
 }
 
+// Invokes `f` with the index of each set bit in `bitmap`. Iterates a word at
+// a time rather than a bit at a time so procs with thousands of state elements
+// (e.g., after proc inlining) are not scanned bit by bit for every node.
+template <typename F>
+void ForEachSetBit(const InlineBitmap& bitmap, F f) {
+  constexpr int64_t kWordBits = 64;
+  for (int64_t wordno = 0; wordno < bitmap.word_count(); ++wordno) {
+    uint64_t word = bitmap.GetWord(wordno);
+    while (word != 0) {
+      f(wordno * kWordBits + absl::countr_zero(word));
+      word &= word - 1;
+    }
+  }
+}
+
 // Removes unobservable state elements. A state element X is observable if:
 //   (1) a side-effecting operation depends on X, OR
 //   (2) the next-state value of an observable state element depends on X.
+//
+// The state elements are first partitioned into independent dependence
+// clusters -- X and Y are in the same cluster iff the next-state value of one
+// (transitively) depends on the other -- and each cluster is then analyzed
+// separately: a cluster is observable iff a side-effecting operation depends
+// on one of its elements, and all elements of unobservable clusters are
+// removed.
 absl::StatusOr<bool> RemoveUnobservableStateElements(Proc* proc) {
   absl::flat_hash_map<Node*, InlineBitmap> state_dependencies;
   XLS_ASSIGN_OR_RETURN(state_dependencies, ComputeStateDependencies(proc));
@@ -148,64 +172,55 @@ absl::StatusOr<bool> RemoveUnobservableStateElements(Proc* proc) {
     next_state_indices[proc->GetNextStateElement(i)].push_back(i);
   }
 
-  // The equivalence classes of state element indices. State element X is in the
-  // same class as Y if the next-state value of X depends on Y or vice versa.
-  UnionFind<int64_t> state_components;
+  // The independent dependence clusters of state element indices. State
+  // element X is in the same cluster as Y if the next-state value of X depends
+  // on Y or vice versa.
+  UnionFind<int64_t> state_clusters;
   for (int64_t i = 0; i < proc->GetStateElementCount(); ++i) {
-    state_components.Insert(i);
+    state_clusters.Insert(i);
   }
 
-  // At the end, the union-find data structure will have one equivalence class
-  // corresponding to the set of all observable state indices. This value is
-  // always either `std::nullopt` or an element of that equivalence class. We
-  // won't have a way to represent the equivalence class until it contains at
-  // least one value, so we use `std::optional`.
-  std::optional<int64_t> observable_state_index;
+  // Indices of state elements upon which some side-effecting operation
+  // depends. The clusters containing these elements are observable.
+  std::vector<int64_t> observable_elements;
 
-  // Merge state elements which depend on each other and identify observable
-  // state indices.
+  // Build the clusters and identify observable state indices.
   for (Node* node : proc->nodes()) {
     if (OpIsSideEffecting(node->op()) && !node->Is<Param>()) {
       // `node` is side-effecting. All state elements that `node` is dependent
       // on are observable.
-      for (int64_t i = 0; i < proc->GetStateElementCount(); ++i) {
-        if (state_dependencies.at(node).Get(i)) {
-          XLS_VLOG(4) << absl::StreamFormat(
-              "State element `%s` (%d) is observable because side-effecting "
-              "node `%s` depends on it",
-              proc->GetStateParam(i)->GetName(), i, node->GetName());
-          if (!observable_state_index.has_value()) {
-            observable_state_index = i;
-          } else {
-            state_components.Union(i, observable_state_index.value());
-          }
-        }
-      }
+      ForEachSetBit(state_dependencies.at(node), [&](int64_t i) {
+        XLS_VLOG(4) << absl::StreamFormat(
+            "State element `%s` (%d) is observable because side-effecting "
+            "node `%s` depends on it",
+            proc->GetStateParam(i)->GetName(), i, node->GetName());
+        observable_elements.push_back(i);
+      });
     }
     if (next_state_indices.contains(node)) {
       for (int64_t next_state_index : next_state_indices.at(node)) {
         // `node` is the next state node for state element with index
         // `next_state_index`. Union `next_state_index` with each state index
         // that `node` is dependent on.
-        for (int64_t i = 0; i < proc->GetStateElementCount(); ++i) {
-          if (state_dependencies.at(node).Get(i)) {
-            XLS_VLOG(4) << absl::StreamFormat(
-                "Unioning state elements `%s` (%d) and `%s` (%d) because next "
-                "state of `%s` (node `%s`) depends on `%s`",
-                proc->GetStateParam(next_state_index)->GetName(),
-                next_state_index, proc->GetStateParam(i)->GetName(), i,
-                proc->GetStateParam(next_state_index)->GetName(),
-                node->GetName(), proc->GetStateParam(i)->GetName());
-            state_components.Union(i, next_state_index);
-          }
-        }
+        ForEachSetBit(state_dependencies.at(node), [&](int64_t i) {
+          XLS_VLOG(4) << absl::StreamFormat(
+              "Clustering state elements `%s` (%d) and `%s` (%d) because next "
+              "state of `%s` (node `%s`) depends on `%s`",
+              proc->GetStateParam(next_state_index)->GetName(),
+              next_state_index, proc->GetStateParam(i)->GetName(), i,
+              proc->GetStateParam(next_state_index)->GetName(),
+              node->GetName(), proc->GetStateParam(i)->GetName());
+          state_clusters.Union(i, next_state_index);
+        });
       }
     }
   }
-  if (observable_state_index.has_value()) {
-    // Set to the representative value of the union-find data structure.
-    observable_state_index =
-        state_components.Find(observable_state_index.value());
+
+  // Analyze each cluster separately: a cluster is observable iff it contains
+  // an element some side-effecting operation depends on.
+  absl::flat_hash_set<int64_t> observable_clusters;
+  for (int64_t i : observable_elements) {
+    observable_clusters.insert(state_clusters.Find(i));
   }
 
   // Gather unobservable state element indices into `to_remove`.
@@ -213,8 +228,7 @@ absl::StatusOr<bool> RemoveUnobservableStateElements(Proc* proc) {
   to_remove.reserve(proc->GetStateElementCount());
   XLS_VLOG(3) << "Observability of state elements:";
   for (int64_t i = proc->GetStateElementCount() - 1; i >= 0; --i) {
-    if (!observable_state_index.has_value() ||
-        state_components.Find(i) != observable_state_index.value()) {
+    if (!observable_clusters.contains(state_clusters.Find(i))) {
       to_remove.push_back(i);
       XLS_VLOG(3) << absl::StrFormat("  %s (%d) : NOT observable",
                                      proc->GetStateParam(i)->GetName(), i);
@@ -15,11 +15,16 @@
 #include "xls/passes/range_query_engine.h"
 
 #include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "xls/common/math_util.h"
+#include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/data_structures/leaf_type_tree.h"
 #include "xls/ir/abstract_node_evaluator.h"
@@ -40,6 +45,9 @@ class RangeQueryVisitor : public DfsVisitor {
 
   ReachedFixpoint GetReachedFixpoint() const { return rf_; }
 
+  // Re-points the visitor at `engine`; used when the owning engine is moved.
+  void set_engine(RangeQueryEngine* engine) { engine_ = engine; }
+
  private:
   // The maximum size of an interval set that can be resident in memory at any
   // one time. When accumulating a result interval set, if the set exceeds this
@@ -366,13 +374,79 @@ IntervalSet MinimizeIntervals(IntervalSet intervals, int64_t size) {
   return result;
 }
 
+// Defined here because `RangeQueryVisitor` is incomplete where the
+// `lazy_visitor_` member is declared.
+RangeQueryEngine::~RangeQueryEngine() = default;
+
+RangeQueryEngine::RangeQueryEngine(RangeQueryEngine&& other) noexcept
+    : known_bits_(std::move(other.known_bits_)),
+      known_bit_values_(std::move(other.known_bit_values_)),
+      interval_sets_(std::move(other.interval_sets_)),
+      lazy_visitor_(std::move(other.lazy_visitor_)) {
+  if (lazy_visitor_ != nullptr) {
+    lazy_visitor_->set_engine(this);
+  }
+}
+
+RangeQueryEngine& RangeQueryEngine::operator=(
+    RangeQueryEngine&& other) noexcept {
+  known_bits_ = std::move(other.known_bits_);
+  known_bit_values_ = std::move(other.known_bit_values_);
+  interval_sets_ = std::move(other.interval_sets_);
+  lazy_visitor_ = std::move(other.lazy_visitor_);
+  if (lazy_visitor_ != nullptr) {
+    lazy_visitor_->set_engine(this);
+  }
+  return *this;
+}
+
 absl::StatusOr<ReachedFixpoint> RangeQueryEngine::Populate(FunctionBase* f) {
   RangeQueryVisitor visitor(this);
   XLS_RETURN_IF_ERROR(f->Accept(&visitor));
   return visitor.GetReachedFixpoint();
 }
 
+absl::StatusOr<ReachedFixpoint> RangeQueryEngine::PopulateLazily(
+    FunctionBase* f) {
+  XLS_RET_CHECK(f != nullptr);
+  // The visitor's visited set persists across queries so each node's cone is
+  // analyzed at most once. Nothing is computed until a node is queried.
+  lazy_visitor_ = std::make_unique<RangeQueryVisitor>(this);
+  return ReachedFixpoint::Unchanged;
+}
+
+void RangeQueryEngine::InvalidateCone(Node* node) {
+  std::vector<Node*> worklist = {node};
+  absl::flat_hash_set<Node*> discarded;
+  while (!worklist.empty()) {
+    Node* n = worklist.back();
+    worklist.pop_back();
+    if (!discarded.insert(n).second) {
+      continue;
+    }
+    known_bits_.erase(n);
+    known_bit_values_.erase(n);
+    interval_sets_.erase(n);
+    if (lazy_visitor_ != nullptr) {
+      lazy_visitor_->UnmarkVisited(n);
+    }
+    for (Node* user : n->users()) {
+      worklist.push_back(user);
+    }
+  }
+}
+
+void RangeQueryEngine::EnsureAnalyzed(Node* node) const {
+  if (lazy_visitor_ == nullptr || lazy_visitor_->IsVisited(node)) {
+    return;
+  }
+  // Accept() only descends into the not-yet-visited part of the cone;
+  // previously queried operands keep their memoized results.
+  XLS_CHECK_OK(node->Accept(lazy_visitor_.get()));
+}
+
 IntervalSetTree RangeQueryEngine::GetIntervalSetTree(Node* node) const {
+  EnsureAnalyzed(node);
   if (interval_sets_.contains(node)) {
     return interval_sets_.at(node);
   }
@@ -1162,27 +1236,27 @@ absl::Status RangeQueryVisitor::HandleSel(Select* sel) {
   // TODO(taktoa): check if sel->cases().size() is greater than the number of
   // representable values in the type of the selector, and set default_possible
   // false in that case.
-  LeafTypeTree<IntervalSet> result(sel->GetType());
-  for (int64_t i = 0; i < result.elements().size(); ++i) {
-    // Initialize all interval sets to empty
-    result.elements()[i] =
-        IntervalSet(result.leaf_types()[i]->GetFlatBitCount());
-  }
-  auto combine = [&](Node* node) {
-    LeafTypeTree<IntervalSet> tree = GetIntervalSetTree(node);
-    result = LeafTypeTree<IntervalSet>::Zip<IntervalSet, IntervalSet>(
-        IntervalSet::Combine, result, tree);
-  };
+  std::vector<IntervalSetTree> selected_trees;
   for (int64_t i = 0; i < sel->cases().size(); ++i) {
     if (selector_values.contains(i)) {
-      combine(sel->cases()[i]);
+      selected_trees.push_back(GetIntervalSetTree(sel->cases()[i]));
     }
   }
   if (default_possible && sel->default_value().has_value()) {
-    combine(sel->default_value().value());
+    selected_trees.push_back(GetIntervalSetTree(sel->default_value().value()));
   }
-  for (IntervalSet& intervals : result.elements()) {
-    intervals = MinimizeIntervals(intervals);
+  // Union the selected cases leaf by leaf; the batch union normalizes each
+  // leaf's result only once.
+  LeafTypeTree<IntervalSet> result(sel->GetType());
+  std::vector<IntervalSet> leaf_sets;
+  leaf_sets.reserve(selected_trees.size());
+  for (int64_t i = 0; i < result.elements().size(); ++i) {
+    leaf_sets.clear();
+    for (const IntervalSetTree& tree : selected_trees) {
+      leaf_sets.push_back(tree.elements()[i]);
+    }
+    result.elements()[i] = MinimizeIntervals(IntervalSet::CombineAll(
+        result.leaf_types()[i]->GetFlatBitCount(), leaf_sets));
   }
   SetIntervalSetTree(sel, result);
   return absl::OkStatus();
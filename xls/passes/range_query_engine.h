@@ -16,6 +16,7 @@
 #define XLS_PASSES_RANGE_QUERY_ENGINE_H_
 
 #include <iosfwd>
+#include <memory>
 
 #include "absl/container/btree_set.h"
 #include "absl/container/flat_hash_map.h"
@@ -30,6 +31,7 @@
 #include "xls/ir/function.h"
 #include "xls/ir/interval.h"
 #include "xls/ir/interval_set.h"
+#include "xls/ir/node_indexed_vector.h"
 #include "xls/ir/nodes.h"
 #include "xls/passes/query_engine.h"
 
@@ -45,16 +47,38 @@ class RangeQueryEngine : public QueryEngine {
   // Create a `RangeQueryEngine` that contains no data.
   RangeQueryEngine() {}
 
+  ~RangeQueryEngine() override;
+
+  // Movable but not copyable; moving re-points the lazy visitor (if any) at
+  // the new engine.
+  RangeQueryEngine(RangeQueryEngine&& other) noexcept;
+  RangeQueryEngine& operator=(RangeQueryEngine&& other) noexcept;
+
   // Populate the data in this `RangeQueryEngine` using the
   // given `FunctionBase*`;
   absl::StatusOr<ReachedFixpoint> Populate(FunctionBase* f) override;
 
+  // Like `Populate` but defers all analysis: interval sets are computed and
+  // memoized on demand from the cone of each queried node, so callers which
+  // only query a subset of the nodes in `f` do not pay for a whole-function
+  // traversal. After mutating the IR, call `InvalidateCone` on the changed
+  // nodes to discard the memoized results they fed into.
+  absl::StatusOr<ReachedFixpoint> PopulateLazily(FunctionBase* f);
+
+  // Discards the memoized analysis results of `node` and of everything
+  // transitively computed from it (its users' cones), so that later queries
+  // recompute them against the current IR. Results for unaffected cones are
+  // retained. Only meaningful for engines populated with `PopulateLazily`.
+  void InvalidateCone(Node* node);
+
   bool IsTracked(Node* node) const override {
+    EnsureAnalyzed(node);
     return known_bits_.contains(node);
   }
 
   LeafTypeTree<TernaryVector> GetTernary(Node* node) const override {
     XLS_CHECK(node->GetType()->IsBits());
+    EnsureAnalyzed(node);
     TernaryVector tvec = ternary_ops::FromKnownBits(known_bits_.at(node),
                                                     known_bit_values_.at(node));
     LeafTypeTree<TernaryVector> tree(node->GetType());
@@ -124,9 +148,17 @@ class RangeQueryEngine : public QueryEngine {
  private:
   friend class RangeQueryVisitor;
 
-  absl::flat_hash_map<Node*, Bits> known_bits_;
-  absl::flat_hash_map<Node*, Bits> known_bit_values_;
-  absl::flat_hash_map<Node*, IntervalSetTree> interval_sets_;
+  // If this engine was populated lazily, computes and memoizes the analysis
+  // results for any not-yet-visited nodes in `node`'s cone. No-op otherwise.
+  void EnsureAnalyzed(Node* node) const;
+
+  NodeIndexedVector<Bits> known_bits_;
+  NodeIndexedVector<Bits> known_bit_values_;
+  NodeIndexedVector<IntervalSetTree> interval_sets_;
+
+  // Persistent visitor used by the lazy mode; its visited set records which
+  // nodes already have memoized results. Null if the engine is eager.
+  std::unique_ptr<RangeQueryVisitor> lazy_visitor_;
 };
 
 // Reduce the size of the given `IntervalSet` to the given size.
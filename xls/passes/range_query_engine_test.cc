@@ -36,6 +36,7 @@
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_test_base.h"
 #include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
 #include "xls/ir/package.h"
 #include "xls/ir/type.h"
 #include "xls/passes/query_engine.h"
@@ -1294,5 +1295,56 @@ TEST_F(RangeQueryEngineTest, ZeroExtend) {
             BitsLTT(expr.node(), {Interval(UBits(500, 40), UBits(700, 40))}));
 }
 
+TEST_F(RangeQueryEngineTest, LazyPopulationMatchesEager) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+
+  BValue x = fb.Param("x", p->GetBitsType(16));
+  BValue zext = fb.ZeroExtend(x, 20);
+  BValue expr = fb.Add(zext, fb.Literal(UBits(10, 20)));
+
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  RangeQueryEngine eager;
+  XLS_ASSERT_OK(eager.Populate(f));
+
+  // The lazy engine computes the queried node's cone on demand and memoizes
+  // it, with results identical to eager population.
+  RangeQueryEngine lazy;
+  XLS_ASSERT_OK(lazy.PopulateLazily(f));
+  EXPECT_EQ(eager.GetIntervalSetTree(expr.node()),
+            lazy.GetIntervalSetTree(expr.node()));
+  EXPECT_EQ(eager.GetIntervalSetTree(zext.node()),
+            lazy.GetIntervalSetTree(zext.node()));
+  EXPECT_TRUE(lazy.IsTracked(expr.node()));
+  EXPECT_EQ(eager.ToString(expr.node()), lazy.ToString(expr.node()));
+}
+
+TEST_F(RangeQueryEngineTest, LazyInvalidationRecomputesCone) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+
+  BValue x = fb.Param("x", p->GetBitsType(16));
+  BValue zext = fb.ZeroExtend(x, 20);
+  BValue expr = fb.Add(zext, fb.Literal(UBits(10, 20)));
+
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  RangeQueryEngine engine;
+  XLS_ASSERT_OK(engine.PopulateLazily(f));
+  EXPECT_EQ(IntervalSetTreeToString(engine.GetIntervalSetTree(expr.node())),
+            "[[10, 65545]]");
+
+  // Swap the added literal and invalidate the cone fed by the addition; the
+  // next query must recompute against the mutated IR.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Node * new_literal,
+      f->MakeNode<Literal>(SourceInfo(), Value(UBits(20, 20))));
+  XLS_ASSERT_OK(expr.node()->ReplaceOperandNumber(1, new_literal));
+  engine.InvalidateCone(expr.node());
+  EXPECT_EQ(IntervalSetTreeToString(engine.GetIntervalSetTree(expr.node())),
+            "[[20, 65555]]");
+}
+
 }  // namespace
 }  // namespace xls
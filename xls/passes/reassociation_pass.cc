@@ -14,17 +14,22 @@
 
 #include "xls/passes/reassociation_pass.h"
 
+#include <algorithm>
+#include <functional>
+#include <queue>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/logging/logging.h"
-#include "xls/common/math_util.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/delay_model/delay_estimator.h"
+#include "xls/delay_model/delay_estimators.h"
 #include "xls/ir/bits_ops.h"
 #include "xls/ir/node_iterator.h"
 #include "xls/ir/node_util.h"
@@ -243,7 +248,7 @@ absl::StatusOr<bool> ReassociateSubtracts(FunctionBase* f) {
 // Walks an expression tree of operations with the given op and bit
 // width. 'node' is the node currently being visited.  The leaves of the
 // expression tree are added to 'leaves', and the interior nodes of the tree are
-// added to 'interior_nodes'. Returns the height of the tree.
+// added to 'interior_nodes'.
 //
 // For example, if called at the root of the following expression:
 //
@@ -257,32 +262,25 @@ absl::StatusOr<bool> ReassociateSubtracts(FunctionBase* f) {
 //
 //   leaves = {a, b, c, d}
 //   interior_nodes = {add.1, add.2, add.3}
-//
-// And the function would return 2, the depth of the tree (not counting the
-// leaves).
-int64_t GatherExpressionLeaves(Op op, Node* node, std::vector<Node*>* leaves,
-                               std::vector<Node*>* interior_nodes) {
+void GatherExpressionLeaves(Op op, Node* node, std::vector<Node*>* leaves,
+                            std::vector<Node*>* interior_nodes) {
   if (node->op() != op || !NodeAndOperandsSameType(node)) {
     // 'node' does not match the other nodes of the tree and is thus a leaf.
     leaves->push_back(node);
-    return 0;
+    return;
   }
   // 'node' is an interior node in the tree of identical operations. Traverse
   // into the operands if the operand has a single use, otherwise the operand is
   // a leaf.
   interior_nodes->push_back(node);
-  int64_t max_depth = 1;
   for (Node* operand : node->operands()) {
     // TODO(meheff): 2021-01-27 Consider handling cases with more than one user.
     if (operand->users().size() == 1) {
-      max_depth = std::max(
-          max_depth,
-          GatherExpressionLeaves(op, operand, leaves, interior_nodes) + 1);
+      GatherExpressionLeaves(op, operand, leaves, interior_nodes);
     } else {
       leaves->push_back(operand);
     }
   }
-  return max_depth;
 }
 
 // Reassociate associative and commutative operations to minimize delay and
@@ -293,6 +291,33 @@ absl::StatusOr<bool> Reassociate(FunctionBase* f) {
   // don't revisit subexpressions multiple times.
   absl::flat_hash_set<Node*> visited_nodes;
 
+  // The delay model is queried at most twice per node; the cache keeps the
+  // second query from re-evaluating the model's regression curves.
+  CachingDelayEstimator delay_estimator("reassociation",
+                                        GetStandardDelayEstimator());
+
+  // Returns the estimated delay of 'n' clamped to at least one picosecond.
+  // Some nodes have no delay model entry (the estimator returns an error);
+  // the clamp makes the policy degenerate to depth-balancing when no delay
+  // information is available at all.
+  auto node_delay = [&](Node* n) -> int64_t {
+    absl::StatusOr<int64_t> delay = delay_estimator.GetOperationDelayInPs(n);
+    return std::max<int64_t>(1, delay.ok() ? delay.value() : 0);
+  };
+
+  // Arrival time (critical-path delay from the function's inputs) of every
+  // node, computed in a single traversal up front. Nodes created while
+  // rebuilding expressions below are added to the map as they are made, so no
+  // re-traversal is ever needed.
+  absl::flat_hash_map<Node*, int64_t> arrival;
+  for (Node* n : TopoSort(f)) {
+    int64_t start = 0;
+    for (Node* operand : n->operands()) {
+      start = std::max(start, arrival.at(operand));
+    }
+    arrival[n] = start + node_delay(n);
+  }
+
   // Traverse the nodes in reverse order because we construct expressions for
   // reassociation starting from the roots.
   for (Node* node : ReverseTopoSort(f)) {
@@ -309,8 +334,7 @@ absl::StatusOr<bool> Reassociate(FunctionBase* f) {
     }
     std::vector<Node*> leaves;
     std::vector<Node*> interior_nodes;
-    int64_t expression_depth =
-        GatherExpressionLeaves(node->op(), node, &leaves, &interior_nodes);
+    GatherExpressionLeaves(node->op(), node, &leaves, &interior_nodes);
 
     // Interior nodes in the expression will be reassociated so add them
     // to the set of associated nodes. This will prevent future
@@ -318,8 +342,10 @@ absl::StatusOr<bool> Reassociate(FunctionBase* f) {
 
     // We want to reassociate under two conditions:
     //
-    // (1) Reduce the height (delay) of the expression. An
-    //     example is reassociating the following:
+    // (1) Reduce the arrival time (critical-path delay) of the expression by
+    //     rebuilding it Huffman-style: the two earliest-arriving operands are
+    //     combined first and late-arriving operands enter the tree later. For
+    //     example, with equal-delay leaves this reassociates the following:
     //
     //              c   d
     //               \ /
@@ -337,6 +363,17 @@ absl::StatusOr<bool> Reassociate(FunctionBase* f) {
     //            \   /
     //              +
     //
+    //     but if 'd' arrives much later than the other leaves the rebuilt
+    //     tree is deliberately skewed so 'd' enters last:
+    //
+    //        a   b
+    //         \ /
+    //          +   c
+    //           \ /
+    //            +   d
+    //             \ /
+    //              +
+    //
     // (2) The expression includes more than one literal. This enables some
     //     folding and canonicalization by putting the literals on the right.
     //     For example, reassociating the following:
@@ -369,22 +406,51 @@ absl::StatusOr<bool> Reassociate(FunctionBase* f) {
       }
     }
 
-    // We only want to transform for one of the two cases above.
-    if (interior_nodes.size() <= 1 ||
-        (expression_depth == CeilOfLog2(leaves.size()) &&
-         literals.size() <= 1)) {
+    if (interior_nodes.size() <= 1) {
       continue;
     }
 
+    // Predict the arrival time of the rebuilt tree without constructing it.
+    // Every interior node of the rebuilt tree is a clone of 'node', so each
+    // combining step costs the delay of 'node'. Only rebuild if the result
+    // arrives strictly earlier than the existing expression (case 1) or
+    // multiple literals can be folded together (case 2).
+    if (literals.size() <= 1) {
+      int64_t op_delay = node_delay(node);
+      std::priority_queue<int64_t, std::vector<int64_t>, std::greater<int64_t>>
+          predicted;
+      for (Node* input : inputs) {
+        predicted.push(arrival.at(input));
+      }
+      if (literals.size() == 1) {
+        predicted.push(arrival.at(literals.front()));
+      }
+      while (predicted.size() > 1) {
+        int64_t first = predicted.top();
+        predicted.pop();
+        int64_t second = predicted.top();
+        predicted.pop();
+        predicted.push(std::max(first, second) + op_delay);
+      }
+      if (predicted.top() >= arrival.at(node)) {
+        continue;
+      }
+    }
+
     XLS_VLOG(4) << "Reassociated expression rooted at: "
                 << inputs[0]->GetName();
     XLS_VLOG(4) << "  operations to reassociate:  "
                 << absl::StrJoin(interior_nodes, ", ", NodeFormatter);
     XLS_VLOG(4) << "  leaves:  " << absl::StrJoin(leaves, ", ", NodeFormatter);
 
-    // Create a clone of 'node' for construcing a reassociated expression.
+    // Create a clone of 'node' for constructing a reassociated expression and
+    // record its arrival time so the expression can be rebuilt without
+    // re-traversing the function.
     auto new_node = [&](Node* lhs, Node* rhs) -> absl::StatusOr<Node*> {
-      return node->Clone({lhs, rhs});
+      XLS_ASSIGN_OR_RETURN(Node * new_op, node->Clone({lhs, rhs}));
+      arrival[new_op] =
+          std::max(arrival.at(lhs), arrival.at(rhs)) + node_delay(new_op);
+      return new_op;
     };
 
     if (literals.size() == 1) {
@@ -403,38 +469,34 @@ absl::StatusOr<bool> Reassociate(FunctionBase* f) {
       inputs.push_back(literal_expr);
     }
 
-    // Reassociate the expressions into a balanced tree. First, reduce the
-    // number of inputs to a power of two. Then build a balanced tree.
-    if (!IsPowerOfTwo(inputs.size())) {
-      // Number of operations to apply to the inputs to reduce operand count to
-      // a power of two. These ops will be the ragged top layer of the
-      // expression tree.
-      int64_t op_count = inputs.size() - (1ULL << FloorOfLog2(inputs.size()));
-      std::vector<Node*> next_inputs;
-      for (int64_t i = 0; i < op_count; ++i) {
-        XLS_ASSIGN_OR_RETURN(Node * new_op,
-                             new_node(inputs[2 * i], inputs[2 * i + 1]));
-        next_inputs.push_back(new_op);
-      }
-      for (int64_t i = op_count * 2; i < inputs.size(); ++i) {
-        next_inputs.push_back(inputs[i]);
-      }
-      inputs = std::move(next_inputs);
+    // Rebuild the expression Huffman-style: repeatedly pop the two
+    // earliest-arriving operands from a min-queue and combine them, so
+    // late-arriving (deep) operands enter the tree as late as possible. Ties
+    // pop in insertion order which keeps the construction deterministic.
+    struct QueueEntry {
+      int64_t arrival;
+      int64_t sequence;
+      Node* node;
+    };
+    auto later = [](const QueueEntry& a, const QueueEntry& b) {
+      return a.arrival > b.arrival ||
+             (a.arrival == b.arrival && a.sequence > b.sequence);
+    };
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, decltype(later)>
+        queue(later);
+    int64_t sequence = 0;
+    for (Node* input : inputs) {
+      queue.push(QueueEntry{arrival.at(input), sequence++, input});
     }
-
-    XLS_RET_CHECK(IsPowerOfTwo(inputs.size()));
-    while (inputs.size() != 1) {
-      // Inputs for the next layer in the tree. Will contain half as many
-      // elements as 'inputs'.
-      std::vector<Node*> next_inputs;
-      for (int64_t i = 0; i < inputs.size() / 2; ++i) {
-        XLS_ASSIGN_OR_RETURN(Node * new_op,
-                             new_node(inputs[2 * i], inputs[2 * i + 1]));
-        next_inputs.push_back(new_op);
-      }
-      inputs = std::move(next_inputs);
+    while (queue.size() > 1) {
+      QueueEntry lhs = queue.top();
+      queue.pop();
+      QueueEntry rhs = queue.top();
+      queue.pop();
+      XLS_ASSIGN_OR_RETURN(Node * new_op, new_node(lhs.node, rhs.node));
+      queue.push(QueueEntry{arrival.at(new_op), sequence++, new_op});
     }
-    XLS_RETURN_IF_ERROR(node->ReplaceUsesWith(inputs[0]));
+    XLS_RETURN_IF_ERROR(node->ReplaceUsesWith(queue.top().node));
     changed = true;
   }
 
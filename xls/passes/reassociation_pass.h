@@ -23,8 +23,9 @@
 namespace xls {
 
 // Reassociates associative operations to reduce delay by transforming chains of
-// operations to a balanced tree of operations, and gathering together constants
-// in the expression for folding.
+// operations into delay-balanced trees (combining earlier-arriving operands
+// first, as estimated by the delay model), and gathering together constants in
+// the expression for folding.
 class ReassociationPass : public FunctionBasePass {
  public:
   ReassociationPass() : FunctionBasePass("reassociation", "Reassociation") {}
@@ -94,10 +94,12 @@ TEST_F(ReassociationPassTest, ChainOfFourUMulRight) {
                           fb.UMul(fb.Param("d", u32), fb.Param("e", u32)))));
   XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
   ASSERT_THAT(Run(p.get()), IsOkAndHolds(true));
+  // With five equally-arriving leaves the Huffman-style construction combines
+  // pairs in leaf order, then folds in the odd leaf, then joins the results.
   EXPECT_THAT(
       f->return_value(),
-      m::UMul(m::UMul(m::UMul(m::Param("a"), m::Param("b")), m::Param("c")),
-              m::UMul(m::Param("d"), m::Param("e"))));
+      m::UMul(m::UMul(m::Param("c"), m::Param("d")),
+              m::UMul(m::Param("e"), m::UMul(m::Param("a"), m::Param("b")))));
 }
 
 TEST_F(ReassociationPassTest, ChainOfMixedOperations) {
@@ -170,8 +172,8 @@ TEST_F(ReassociationPassTest, BalancedTreeOfFiveAdds) {
 }
 
 TEST_F(ReassociationPassTest, ReassociateMultipleLiterals) {
-  // Multiple Literals should be reassociated to the right even if the tree is
-  // balanced.
+  // Multiple Literals should be gathered into their own subexpression (which
+  // constant folding can then collapse) even if the tree is balanced.
   auto p = CreatePackage();
   FunctionBuilder fb(TestName(), p.get());
   Type* u32 = p->GetBitsType(32);
@@ -180,8 +182,8 @@ TEST_F(ReassociationPassTest, ReassociateMultipleLiterals) {
   XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
   ASSERT_THAT(Run(p.get()), IsOkAndHolds(true));
   EXPECT_THAT(f->return_value(),
-              m::Add(m::Add(m::Param("a"), m::Param("b")),
-                     m::Add(m::Literal(42), m::Literal(123))));
+              m::Add(m::Add(m::Literal(42), m::Literal(123)),
+                     m::Add(m::Param("a"), m::Param("b"))));
 }
 
 TEST_F(ReassociationPassTest, SingleLiteralNoReassociate) {
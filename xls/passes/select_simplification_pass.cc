@@ -17,7 +17,6 @@
 #include <vector>
 
 #include "absl/algorithm/container.h"
-#include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "xls/common/logging/log_lines.h"
@@ -282,6 +281,13 @@ absl::StatusOr<std::vector<OneHotSelect*>> MaybeSplitOneHotSelect(
 
 absl::StatusOr<bool> SimplifyNode(Node* node, const QueryEngine& query_engine,
                                   int64_t opt_level) {
+  // Every pattern below matches a select, one-hot-select or one-hot; all
+  // other nodes can be rejected on the op alone without evaluating the match
+  // chain.
+  if (!node->Is<Select>() && !node->Is<OneHotSelect>() && !node->Is<OneHot>()) {
+    return false;
+  }
+
   // Select with a constant selector can be replaced with the respective
   // case.
   if (node->Is<Select>() && node->As<Select>()->selector()->Is<Literal>()) {
@@ -454,9 +460,10 @@ absl::StatusOr<bool> SimplifyNode(Node* node, const QueryEngine& query_engine,
   if (NarrowingEnabled(opt_level) && node->Is<OneHotSelect>()) {
     FunctionBase* f = node->function_base();
     OneHotSelect* sel = node->As<OneHotSelect>();
-    if (!sel->cases().empty() &&
-        absl::flat_hash_set<Node*>(sel->cases().begin(), sel->cases().end())
-                .size() != sel->cases().size()) {
+    // HasDuplicateElement is allocation-free, unlike gathering the cases into
+    // a set; this check runs for every one-hot-select on every pass
+    // invocation and nearly always finds nothing.
+    if (HasDuplicateElement(sel->cases())) {
       // For any case that's equal to another case, we or together the one hot
       // selectors and common out the value to squeeze the width of the one hot
       // select.
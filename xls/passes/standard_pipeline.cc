@@ -22,11 +22,9 @@
 #include "xls/passes/array_simplification_pass.h"
 #include "xls/passes/bdd_cse_pass.h"
 #include "xls/passes/bdd_simplification_pass.h"
-#include "xls/passes/bit_slice_simplification_pass.h"
 #include "xls/passes/boolean_simplification_pass.h"
 #include "xls/passes/canonicalization_pass.h"
 #include "xls/passes/comparison_simplification_pass.h"
-#include "xls/passes/concat_simplification_pass.h"
 #include "xls/passes/conditional_specialization_pass.h"
 #include "xls/passes/constant_folding_pass.h"
 #include "xls/passes/cse_pass.h"
@@ -38,6 +36,7 @@
 #include "xls/passes/map_inlining_pass.h"
 #include "xls/passes/mutual_exclusion_pass.h"
 #include "xls/passes/narrowing_pass.h"
+#include "xls/passes/peephole_simplification_pass.h"
 #include "xls/passes/proc_inlining_pass.h"
 #include "xls/passes/proc_state_flattening_pass.h"
 #include "xls/passes/proc_state_optimization_pass.h"
@@ -64,7 +63,7 @@ class SimplificationPass : public FixedPointCompoundPass {
     Add<DeadCodeEliminationPass>();
     Add<CanonicalizationPass>();
     Add<DeadCodeEliminationPass>();
-    Add<ArithSimplificationPass>(opt_level);
+    Add<PeepholeSimplificationPass>(opt_level);
     Add<DeadCodeEliminationPass>();
     Add<ComparisonSimplificationPass>();
     Add<DeadCodeEliminationPass>();
@@ -78,11 +77,9 @@ class SimplificationPass : public FixedPointCompoundPass {
     Add<DeadCodeEliminationPass>();
     Add<ConstantFoldingPass>();
     Add<DeadCodeEliminationPass>();
-    Add<BitSliceSimplificationPass>(opt_level);
-    Add<DeadCodeEliminationPass>();
-    Add<ConcatSimplificationPass>(opt_level);
-    Add<DeadCodeEliminationPass>();
-    Add<TupleSimplificationPass>();
+    // The peephole pass covers the arithmetic, bit-slice, concat and tuple
+    // simplification rules in one worklist traversal.
+    Add<PeepholeSimplificationPass>(opt_level);
     Add<DeadCodeEliminationPass>();
     Add<StrengthReductionPass>(opt_level);
     Add<DeadCodeEliminationPass>();
@@ -90,7 +87,7 @@ class SimplificationPass : public FixedPointCompoundPass {
     Add<DeadCodeEliminationPass>();
     Add<NarrowingPass>(/*use_range_analysis=*/false, opt_level);
     Add<DeadCodeEliminationPass>();
-    Add<ArithSimplificationPass>(opt_level);
+    Add<PeepholeSimplificationPass>(opt_level);
     Add<DeadCodeEliminationPass>();
     Add<BooleanSimplificationPass>();
     Add<DeadCodeEliminationPass>();
@@ -98,7 +95,8 @@ class SimplificationPass : public FixedPointCompoundPass {
   }
 };
 
-std::unique_ptr<CompoundPass> CreateStandardPassPipeline(int64_t opt_level) {
+std::unique_ptr<CompoundPass> CreateStandardPassPipeline(int64_t opt_level,
+                                                         bool unroll_loops) {
   auto top = std::make_unique<CompoundPass>("ir", "Top level pass pipeline");
   top->AddInvariantChecker<VerifierChecker>();
 
@@ -109,7 +107,9 @@ std::unique_ptr<CompoundPass> CreateStandardPassPipeline(int64_t opt_level) {
   // in the entire pipeline so set the level of the simplification pass to the
   // minimum of the two values. Same below.
   top->Add<SimplificationPass>(std::min(int64_t{2}, opt_level));
-  top->Add<UnrollPass>();
+  if (unroll_loops) {
+    top->Add<UnrollPass>();
+  }
   top->Add<MapInliningPass>();
   top->Add<InliningPass>();
   top->Add<DeadFunctionEliminationPass>();
@@ -174,10 +174,13 @@ std::unique_ptr<CompoundPass> CreateStandardPassPipeline(int64_t opt_level) {
 }
 
 absl::StatusOr<bool> RunStandardPassPipeline(Package* package,
-                                             int64_t opt_level) {
+                                             int64_t opt_level,
+                                             int64_t parallelism) {
   std::unique_ptr<CompoundPass> pipeline = CreateStandardPassPipeline();
   PassResults results;
-  return pipeline->Run(package, PassOptions(), &results);
+  PassOptions options;
+  options.parallelism = parallelism;
+  return pipeline->Run(package, options, &results);
 }
 
 }  // namespace xls
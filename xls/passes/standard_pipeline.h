@@ -22,13 +22,22 @@ namespace xls {
 
 // CreateStandardPassPipeline connects together the various optimization
 // and analysis passes in the order of execution.
+//
+// When `unroll_loops` is false, UnrollPass is left out of the pipeline so
+// CountedFor nodes survive optimization. Code generation requires unrolled
+// loops, but JIT-bound users can keep loops rolled: the JIT lowers CountedFor
+// to a native loop with the body compiled once, which compiles much faster
+// than the fully unrolled form for large trip counts.
 std::unique_ptr<CompoundPass> CreateStandardPassPipeline(
-    int64_t opt_level = kMaxOptLevel);
+    int64_t opt_level = kMaxOptLevel, bool unroll_loops = true);
 
 // Creates and runs the standard pipeline on the given package with default
-// options.
+// options. If `parallelism` is greater than one, function-level passes
+// process the FunctionBases of the package with that many worker threads (see
+// FunctionBasePass::RunInternal).
 absl::StatusOr<bool> RunStandardPassPipeline(Package* package,
-                                             int64_t opt_level = kMaxOptLevel);
+                                             int64_t opt_level = kMaxOptLevel,
+                                             int64_t parallelism = 1);
 
 }  // namespace xls
 
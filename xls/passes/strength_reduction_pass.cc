@@ -14,6 +14,8 @@
 
 #include "xls/passes/strength_reduction_pass.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
@@ -24,19 +26,108 @@
 #include "xls/ir/node_iterator.h"
 #include "xls/ir/node_util.h"
 #include "xls/ir/nodes.h"
+#include "xls/ir/ternary.h"
 #include "xls/passes/query_engine.h"
 #include "xls/passes/ternary_query_engine.h"
 
 namespace xls {
 namespace {
 
+// Snapshot of the inputs to the previous strength reduction of a function:
+// for each node (keyed by id), its operand ids and its ternary value at the
+// end of the run. Diffing a fresh analysis against the snapshot yields the
+// set of nodes whose strength reduction inputs changed -- everything else was
+// already examined with identical inputs and cannot newly reduce. The
+// snapshot lives in the analysis cache and is deliberately read back stale
+// (AnalysisCache::GetStale); it exists precisely to describe the previous
+// iteration of the fixed-point pipeline.
+struct StrengthReductionSnapshot {
+  struct NodeRecord {
+    std::vector<int64_t> operand_ids;
+    TernaryVector ternary;
+  };
+  int64_t opt_level;
+  absl::flat_hash_map<int64_t, NodeRecord> nodes;
+};
+
+// Returns the ternary value of `node` if the query engine tracks it, or an
+// empty vector otherwise (e.g. for non-bits-typed nodes and nodes created
+// after the engine was populated).
+TernaryVector TernaryOf(Node* node, const QueryEngine& query_engine) {
+  if (!node->GetType()->IsBits() || !query_engine.IsTracked(node)) {
+    return TernaryVector();
+  }
+  return query_engine.GetTernary(node).Get({});
+}
+
+// Returns the set of nodes whose strength reduction inputs -- their operands,
+// their own ternary value, or an operand's ternary value -- changed since the
+// snapshot was taken.
+absl::flat_hash_set<Node*> ChangedNodes(
+    FunctionBase* f, const StrengthReductionSnapshot& snapshot,
+    const QueryEngine& query_engine) {
+  // Nodes which are new or whose own ternary value changed.
+  absl::flat_hash_set<Node*> ternary_changed;
+  for (Node* node : f->nodes()) {
+    auto it = snapshot.nodes.find(node->id());
+    if (it == snapshot.nodes.end() ||
+        it->second.ternary != TernaryOf(node, query_engine)) {
+      ternary_changed.insert(node);
+    }
+  }
+  absl::flat_hash_set<Node*> changed;
+  for (Node* node : f->nodes()) {
+    if (ternary_changed.contains(node)) {
+      changed.insert(node);
+      continue;
+    }
+    const StrengthReductionSnapshot::NodeRecord& record =
+        snapshot.nodes.at(node->id());
+    bool operands_changed =
+        static_cast<int64_t>(record.operand_ids.size()) !=
+        node->operand_count();
+    for (int64_t i = 0; !operands_changed && i < node->operand_count(); ++i) {
+      operands_changed = record.operand_ids[i] != node->operand(i)->id() ||
+                         ternary_changed.contains(node->operand(i));
+    }
+    if (operands_changed) {
+      changed.insert(node);
+    }
+  }
+  return changed;
+}
+
+// Records the current operands and ternary values of every node of `f` for
+// the next run to diff against.
+std::unique_ptr<StrengthReductionSnapshot> TakeSnapshot(
+    FunctionBase* f, const QueryEngine& query_engine, int64_t opt_level) {
+  auto snapshot = std::make_unique<StrengthReductionSnapshot>();
+  snapshot->opt_level = opt_level;
+  for (Node* node : f->nodes()) {
+    StrengthReductionSnapshot::NodeRecord record;
+    record.operand_ids.reserve(node->operand_count());
+    for (Node* operand : node->operands()) {
+      record.operand_ids.push_back(operand->id());
+    }
+    record.ternary = TernaryOf(node, query_engine);
+    snapshot->nodes.emplace(node->id(), std::move(record));
+  }
+  return snapshot;
+}
+
 // Finds and returns the set of adds which may be safely strength-reduced to
 // ORs. These are determined ahead of time rather than being transformed inline
-// to avoid problems with stale information in QueryEngine.
+// to avoid problems with stale information in QueryEngine. If `changed_nodes`
+// is non-null only adds in the set are considered; the rest were rejected by
+// the previous run with identical inputs.
 absl::StatusOr<absl::flat_hash_set<Node*>> FindReducibleAdds(
-    FunctionBase* f, const QueryEngine& query_engine) {
+    FunctionBase* f, const QueryEngine& query_engine,
+    const absl::flat_hash_set<Node*>* changed_nodes) {
   absl::flat_hash_set<Node*> reducible_adds;
   for (Node* node : f->nodes()) {
+    if (changed_nodes != nullptr && !changed_nodes->contains(node)) {
+      continue;
+    }
     // An add can be reduced to an OR if there is at least one zero in every bit
     // position amongst the operands of the add.
     if (node->op() == Op::kAdd) {
@@ -330,10 +421,31 @@ absl::StatusOr<bool> StrengthReduceNode(
 
 absl::StatusOr<bool> StrengthReductionPass::RunOnFunctionBaseInternal(
     FunctionBase* f, const PassOptions& options, PassResults* results) const {
-  TernaryQueryEngine query_engine;
-  XLS_RETURN_IF_ERROR(query_engine.Populate(f).status());
-  XLS_ASSIGN_OR_RETURN(absl::flat_hash_set<Node*> reducible_adds,
-                       FindReducibleAdds(f, query_engine));
+  TernaryQueryEngine* query_engine =
+      results->analysis_cache.Get<TernaryQueryEngine>(f);
+  if (query_engine == nullptr) {
+    auto owned_query_engine = std::make_unique<TernaryQueryEngine>();
+    XLS_RETURN_IF_ERROR(owned_query_engine->Populate(f).status());
+    query_engine =
+        results->analysis_cache.Put(f, std::move(owned_query_engine));
+  }
+
+  // Diff the analysis against the snapshot taken at the end of the previous
+  // run (if any) and limit this run to the nodes whose inputs changed. In the
+  // fixed-point pipeline this makes repeat iterations near-free on converged
+  // regions of the graph.
+  const StrengthReductionSnapshot* snapshot =
+      results->analysis_cache.GetStale<StrengthReductionSnapshot>(f);
+  std::optional<absl::flat_hash_set<Node*>> changed_nodes;
+  if (snapshot != nullptr && snapshot->opt_level == opt_level_) {
+    changed_nodes = ChangedNodes(f, *snapshot, *query_engine);
+  }
+
+  XLS_ASSIGN_OR_RETURN(
+      absl::flat_hash_set<Node*> reducible_adds,
+      FindReducibleAdds(
+          f, *query_engine,
+          changed_nodes.has_value() ? &changed_nodes.value() : nullptr));
   // Note: because we introduce new nodes into the graph that were not present
   // for the original QueryEngine analysis, we must be careful to guard our
   // bit value tests with "IsKnown" sorts of calls.
@@ -343,11 +455,16 @@ absl::StatusOr<bool> StrengthReductionPass::RunOnFunctionBaseInternal(
   // information is always fresh and precise.
   bool modified = false;
   for (Node* node : TopoSort(f)) {
+    if (changed_nodes.has_value() && !changed_nodes->contains(node)) {
+      continue;
+    }
     XLS_ASSIGN_OR_RETURN(
         bool node_modified,
-        StrengthReduceNode(node, reducible_adds, query_engine, opt_level_));
+        StrengthReduceNode(node, reducible_adds, *query_engine, opt_level_));
     modified |= node_modified;
   }
+
+  results->analysis_cache.Put(f, TakeSnapshot(f, *query_engine, opt_level_));
   return modified;
 }
 
@@ -20,7 +20,9 @@
 #include "xls/common/status/matchers.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/function.h"
+#include "xls/ir/function_builder.h"
 #include "xls/ir/ir_matcher.h"
+#include "xls/ir/nodes.h"
 #include "xls/ir/ir_test_base.h"
 #include "xls/ir/package.h"
 #include "xls/passes/dce_pass.h"
@@ -295,5 +297,35 @@ TEST_F(StrengthReductionPassTest, SignExtMuxNegated) {
   EXPECT_THAT(f->return_value(), m::SignExt(m::Not(m::Param("s"))));
 }
 
+TEST_F(StrengthReductionPassTest, RepeatRunsWithSharedResults) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(1));
+  BValue y = fb.Param("y", p->GetBitsType(1));
+  fb.Ne(x, y);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  // Share PassResults across runs as the fixed-point pipeline does so the
+  // second run is driven by the change set against the first run's snapshot.
+  PassResults results;
+  StrengthReductionPass pass;
+  auto run = [&]() {
+    return pass.RunOnFunctionBase(f, PassOptions(), &results);
+  };
+
+  EXPECT_THAT(run(), IsOkAndHolds(true));
+  EXPECT_THAT(f->return_value(), m::Xor(m::Param("x"), m::Param("y")));
+  // The function has converged; a repeat run changes nothing.
+  EXPECT_THAT(run(), IsOkAndHolds(false));
+
+  // New work created after convergence is still found.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Node * ne, f->MakeNode<CompareOp>(SourceInfo(), x.node(), y.node(),
+                                        Op::kNe));
+  XLS_ASSERT_OK(f->set_return_value(ne));
+  EXPECT_THAT(run(), IsOkAndHolds(true));
+  EXPECT_THAT(f->return_value(), m::Xor(m::Param("x"), m::Param("y")));
+}
+
 }  // namespace
 }  // namespace xls
@@ -0,0 +1,187 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/ternary_evaluator.h"
+
+#include <vector>
+
+#include "xls/ir/bits_ops.h"
+
+namespace xls {
+namespace packed_ternary_ops {
+namespace {
+
+// Mask of bits known to be zero.
+Bits KnownZero(const TernaryPlanes& a) {
+  return bits_ops::And(a.known, bits_ops::Not(a.value));
+}
+
+// The largest (smallest) value consistent with the planes, obtained by
+// setting every unknown bit to one (zero). The smallest value is simply the
+// value plane because unknown bits are zero there.
+Bits MaxValue(const TernaryPlanes& a) {
+  return bits_ops::Or(a.value, bits_ops::Not(a.known));
+}
+
+// Addition of `a`, `b`, and a constant carry-in. The carry into each bit
+// position is recovered from sum = a ^ b ^ carry. Carries are monotone in
+// the unknown operand bits, so a carry bit is known exactly when the
+// all-unknowns-zero and all-unknowns-one scenarios agree on it.
+TernaryPlanes AddWithCarry(const TernaryPlanes& a, const TernaryPlanes& b,
+                           bool carry_in) {
+  int64_t width = a.bit_count();
+  if (width == 0) {
+    return TernaryPlanes{Bits(), Bits()};
+  }
+  Bits carry = carry_in ? UBits(1, width) : Bits(width);
+  Bits max_a = MaxValue(a);
+  Bits max_b = MaxValue(b);
+  Bits max_sum = bits_ops::Add(bits_ops::Add(max_a, max_b), carry);
+  Bits min_sum = bits_ops::Add(bits_ops::Add(a.value, b.value), carry);
+  Bits carry_max = bits_ops::Xor(bits_ops::Xor(max_sum, max_a), max_b);
+  Bits carry_min = bits_ops::Xor(bits_ops::Xor(min_sum, a.value), b.value);
+  Bits known =
+      bits_ops::And(bits_ops::And(a.known, b.known),
+                    bits_ops::Not(bits_ops::Xor(carry_max, carry_min)));
+  return TernaryPlanes{known, bits_ops::And(min_sum, known)};
+}
+
+std::vector<Bits> GatherKnown(absl::Span<const TernaryPlanes> operands) {
+  std::vector<Bits> result;
+  result.reserve(operands.size());
+  for (const TernaryPlanes& operand : operands) {
+    result.push_back(operand.known);
+  }
+  return result;
+}
+
+std::vector<Bits> GatherValue(absl::Span<const TernaryPlanes> operands) {
+  std::vector<Bits> result;
+  result.reserve(operands.size());
+  for (const TernaryPlanes& operand : operands) {
+    result.push_back(operand.value);
+  }
+  return result;
+}
+
+std::vector<Bits> GatherKnownZero(absl::Span<const TernaryPlanes> operands) {
+  std::vector<Bits> result;
+  result.reserve(operands.size());
+  for (const TernaryPlanes& operand : operands) {
+    result.push_back(KnownZero(operand));
+  }
+  return result;
+}
+
+}  // namespace
+
+TernaryPlanes FromTernaryVector(const TernaryVector& vector) {
+  InlineBitmap known(vector.size());
+  InlineBitmap value(vector.size());
+  for (int64_t i = 0; i < static_cast<int64_t>(vector.size()); ++i) {
+    known.Set(i, vector[i] != TernaryValue::kUnknown);
+    value.Set(i, vector[i] == TernaryValue::kKnownOne);
+  }
+  return TernaryPlanes{Bits::FromBitmap(std::move(known)),
+                       Bits::FromBitmap(std::move(value))};
+}
+
+TernaryVector ToTernaryVector(const TernaryPlanes& planes) {
+  return ternary_ops::FromKnownBits(planes.known, planes.value);
+}
+
+TernaryPlanes AllUnknown(int64_t bit_count) {
+  return TernaryPlanes{Bits(bit_count), Bits(bit_count)};
+}
+
+TernaryPlanes FromLiteral(const Bits& bits) {
+  return TernaryPlanes{Bits::AllOnes(bits.bit_count()), bits};
+}
+
+TernaryPlanes Not(const TernaryPlanes& a) {
+  return TernaryPlanes{a.known, KnownZero(a)};
+}
+
+TernaryPlanes And(absl::Span<const TernaryPlanes> operands) {
+  // A result bit is known one iff every operand bit is known one, and known
+  // zero iff any operand bit is known zero.
+  Bits ones = bits_ops::NaryAnd(GatherValue(operands));
+  Bits zeros = bits_ops::NaryOr(GatherKnownZero(operands));
+  return TernaryPlanes{bits_ops::Or(ones, zeros), ones};
+}
+
+TernaryPlanes Or(absl::Span<const TernaryPlanes> operands) {
+  // A result bit is known one iff any operand bit is known one, and known
+  // zero iff every operand bit is known zero.
+  Bits ones = bits_ops::NaryOr(GatherValue(operands));
+  Bits zeros = bits_ops::NaryAnd(GatherKnownZero(operands));
+  return TernaryPlanes{bits_ops::Or(ones, zeros), ones};
+}
+
+TernaryPlanes Xor(absl::Span<const TernaryPlanes> operands) {
+  // A result bit is known iff every operand bit is known.
+  Bits known = bits_ops::NaryAnd(GatherKnown(operands));
+  return TernaryPlanes{
+      known, bits_ops::And(bits_ops::NaryXor(GatherValue(operands)), known)};
+}
+
+TernaryPlanes Nand(absl::Span<const TernaryPlanes> operands) {
+  return Not(And(operands));
+}
+
+TernaryPlanes Nor(absl::Span<const TernaryPlanes> operands) {
+  return Not(Or(operands));
+}
+
+TernaryPlanes Add(const TernaryPlanes& a, const TernaryPlanes& b) {
+  return AddWithCarry(a, b, /*carry_in=*/false);
+}
+
+TernaryPlanes Sub(const TernaryPlanes& a, const TernaryPlanes& b) {
+  // a - b == a + ~b + 1.
+  return AddWithCarry(a, Not(b), /*carry_in=*/true);
+}
+
+TernaryPlanes Neg(const TernaryPlanes& a) {
+  return Sub(FromLiteral(Bits(a.bit_count())), a);
+}
+
+TernaryPlanes Concat(absl::Span<const TernaryPlanes> operands) {
+  return TernaryPlanes{bits_ops::Concat(GatherKnown(operands)),
+                       bits_ops::Concat(GatherValue(operands))};
+}
+
+TernaryPlanes BitSlice(const TernaryPlanes& a, int64_t start, int64_t width) {
+  return TernaryPlanes{a.known.Slice(start, width),
+                       a.value.Slice(start, width)};
+}
+
+TernaryPlanes ZeroExtend(const TernaryPlanes& a, int64_t new_bit_count) {
+  // The extension bits are known zero: known one, value zero.
+  return TernaryPlanes{
+      bits_ops::Not(bits_ops::ZeroExtend(bits_ops::Not(a.known),
+                                         new_bit_count)),
+      bits_ops::ZeroExtend(a.value, new_bit_count)};
+}
+
+TernaryPlanes SignExtend(const TernaryPlanes& a, int64_t new_bit_count) {
+  // The extension bits replicate the sign bit and are known exactly when it
+  // is known, which is sign extension of both planes: an unknown sign bit is
+  // zero in both.
+  return TernaryPlanes{bits_ops::SignExtend(a.known, new_bit_count),
+                       bits_ops::SignExtend(a.value, new_bit_count)};
+}
+
+}  // namespace packed_ternary_ops
+}  // namespace xls
@@ -16,6 +16,7 @@
 #define XLS_PASSES_TERNARY_EVALUATOR_H_
 
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "xls/common/logging/logging.h"
 #include "xls/ir/abstract_evaluator.h"
 #include "xls/ir/bits.h"
@@ -51,6 +52,65 @@ class TernaryEvaluator
   }
 };
 
+// Packed representation of a TernaryVector as two parallel bit planes backed
+// by the word-level bitmap inside Bits: `known` has a one for every bit whose
+// value is determined and `value` holds those determined bits. Unknown bits
+// are zero in both planes, so `value` is always a subset of `known`.
+// Operating on whole planes lets known-bits propagation over wide datapaths
+// run at word speed rather than one enum element at a time.
+struct TernaryPlanes {
+  Bits known;
+  Bits value;
+
+  int64_t bit_count() const { return known.bit_count(); }
+
+  bool operator==(const TernaryPlanes& other) const {
+    return known == other.known && value == other.value;
+  }
+  bool operator!=(const TernaryPlanes& other) const {
+    return !(*this == other);
+  }
+};
+
+namespace packed_ternary_ops {
+
+// Conversions between the packed and enum-vector representations.
+TernaryPlanes FromTernaryVector(const TernaryVector& vector);
+TernaryVector ToTernaryVector(const TernaryPlanes& planes);
+
+// Returns planes of the given width with every bit unknown.
+TernaryPlanes AllUnknown(int64_t bit_count);
+
+// Returns fully-known planes holding the given constant.
+TernaryPlanes FromLiteral(const Bits& bits);
+
+// Word-parallel combinators for the bitwise operations. Results are
+// identical to applying the corresponding ternary_ops elementwise.
+TernaryPlanes Not(const TernaryPlanes& a);
+TernaryPlanes And(absl::Span<const TernaryPlanes> operands);
+TernaryPlanes Or(absl::Span<const TernaryPlanes> operands);
+TernaryPlanes Xor(absl::Span<const TernaryPlanes> operands);
+TernaryPlanes Nand(absl::Span<const TernaryPlanes> operands);
+TernaryPlanes Nor(absl::Span<const TernaryPlanes> operands);
+
+// Carry-aware arithmetic kernels. A result bit is known exactly when both
+// operand bits and the carry into the position are known; carries are
+// recovered at word speed by adding the all-unknowns-zero and
+// all-unknowns-one extremes of the operands.
+TernaryPlanes Add(const TernaryPlanes& a, const TernaryPlanes& b);
+TernaryPlanes Sub(const TernaryPlanes& a, const TernaryPlanes& b);
+TernaryPlanes Neg(const TernaryPlanes& a);
+
+// Bit rearrangements, applied to both planes. For Concat the zero-th element
+// of the span becomes the most significant bits of the result, matching
+// bits_ops::Concat and the IR Op::kConcat operand order.
+TernaryPlanes Concat(absl::Span<const TernaryPlanes> operands);
+TernaryPlanes BitSlice(const TernaryPlanes& a, int64_t start, int64_t width);
+TernaryPlanes ZeroExtend(const TernaryPlanes& a, int64_t new_bit_count);
+TernaryPlanes SignExtend(const TernaryPlanes& a, int64_t new_bit_count);
+
+}  // namespace packed_ternary_ops
+
 }  // namespace xls
 
 #endif  // XLS_PASSES_TERNARY_EVALUATOR_H_
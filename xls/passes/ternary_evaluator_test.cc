@@ -663,5 +663,118 @@ TEST_F(TernaryLogicTest, TestTheTestStuff) {
             FromString("0bX10X"));
 }
 
+TEST_F(TernaryLogicTest, PackedRoundTrip) {
+  for (const TernaryVector& vector : EnumerateTernaryVectors(/*width=*/3)) {
+    EXPECT_EQ(packed_ternary_ops::ToTernaryVector(
+                  packed_ternary_ops::FromTernaryVector(vector)),
+              vector)
+        << ToString(vector);
+  }
+  EXPECT_EQ(packed_ternary_ops::AllUnknown(3),
+            packed_ternary_ops::FromTernaryVector(FromString("0bXXX")));
+  EXPECT_EQ(packed_ternary_ops::FromLiteral(UBits(0b101, 3)),
+            packed_ternary_ops::FromTernaryVector(FromString("0b101")));
+}
+
+TEST_F(TernaryLogicTest, PackedBitwiseOpsMatchElementwise) {
+  for (const TernaryVector& a : EnumerateTernaryVectors(/*width=*/2)) {
+    TernaryPlanes a_packed = packed_ternary_ops::FromTernaryVector(a);
+    EXPECT_EQ(packed_ternary_ops::ToTernaryVector(
+                  packed_ternary_ops::Not(a_packed)),
+              evaluator_.BitwiseNot(a))
+        << ToString(a);
+    for (const TernaryVector& b : EnumerateTernaryVectors(/*width=*/2)) {
+      std::vector<TernaryPlanes> operands = {
+          a_packed, packed_ternary_ops::FromTernaryVector(b)};
+      EXPECT_EQ(packed_ternary_ops::ToTernaryVector(
+                    packed_ternary_ops::And(operands)),
+                evaluator_.BitwiseAnd(a, b))
+          << ToString(a) << " & " << ToString(b);
+      EXPECT_EQ(
+          packed_ternary_ops::ToTernaryVector(packed_ternary_ops::Or(operands)),
+          evaluator_.BitwiseOr(a, b))
+          << ToString(a) << " | " << ToString(b);
+      EXPECT_EQ(packed_ternary_ops::ToTernaryVector(
+                    packed_ternary_ops::Xor(operands)),
+                evaluator_.BitwiseXor(a, b))
+          << ToString(a) << " ^ " << ToString(b);
+      EXPECT_EQ(packed_ternary_ops::ToTernaryVector(
+                    packed_ternary_ops::Nand(operands)),
+                evaluator_.BitwiseNot(evaluator_.BitwiseAnd(a, b)))
+          << ToString(a) << " nand " << ToString(b);
+      EXPECT_EQ(packed_ternary_ops::ToTernaryVector(
+                    packed_ternary_ops::Nor(operands)),
+                evaluator_.BitwiseNot(evaluator_.BitwiseOr(a, b)))
+          << ToString(a) << " nor " << ToString(b);
+    }
+  }
+}
+
+TEST_F(TernaryLogicTest, PackedAddIsPrecise) {
+  // The carry-aware kernel must produce exactly the ternary vector matching
+  // the set of all concrete sums of the operand patterns.
+  for (const TernaryVector& a : EnumerateTernaryVectors(/*width=*/3)) {
+    for (const TernaryVector& b : EnumerateTernaryVectors(/*width=*/3)) {
+      std::vector<Bits> sums;
+      for (const Bits& a_bits : ExpandToBits(a)) {
+        for (const Bits& b_bits : ExpandToBits(b)) {
+          sums.push_back(bits_ops::Add(a_bits, b_bits));
+        }
+      }
+      EXPECT_EQ(packed_ternary_ops::ToTernaryVector(packed_ternary_ops::Add(
+                    packed_ternary_ops::FromTernaryVector(a),
+                    packed_ternary_ops::FromTernaryVector(b))),
+                ReduceFromBits(sums))
+          << ToString(a) << " + " << ToString(b);
+    }
+  }
+}
+
+TEST_F(TernaryLogicTest, PackedSubAndNegArePrecise) {
+  for (const TernaryVector& a : EnumerateTernaryVectors(/*width=*/3)) {
+    std::vector<Bits> negations;
+    for (const Bits& a_bits : ExpandToBits(a)) {
+      negations.push_back(bits_ops::Negate(a_bits));
+    }
+    EXPECT_EQ(packed_ternary_ops::ToTernaryVector(packed_ternary_ops::Neg(
+                  packed_ternary_ops::FromTernaryVector(a))),
+              ReduceFromBits(negations))
+        << "-" << ToString(a);
+    for (const TernaryVector& b : EnumerateTernaryVectors(/*width=*/3)) {
+      std::vector<Bits> differences;
+      for (const Bits& a_bits : ExpandToBits(a)) {
+        for (const Bits& b_bits : ExpandToBits(b)) {
+          differences.push_back(bits_ops::Sub(a_bits, b_bits));
+        }
+      }
+      EXPECT_EQ(packed_ternary_ops::ToTernaryVector(packed_ternary_ops::Sub(
+                    packed_ternary_ops::FromTernaryVector(a),
+                    packed_ternary_ops::FromTernaryVector(b))),
+                ReduceFromBits(differences))
+          << ToString(a) << " - " << ToString(b);
+    }
+  }
+}
+
+TEST_F(TernaryLogicTest, PackedBitRearrangements) {
+  TernaryPlanes planes =
+      packed_ternary_ops::FromTernaryVector(FromString("0b1X0X"));
+  EXPECT_EQ(packed_ternary_ops::BitSlice(planes, /*start=*/1, /*width=*/2),
+            packed_ternary_ops::FromTernaryVector(FromString("0bX0")));
+  EXPECT_EQ(packed_ternary_ops::Concat(
+                {planes, packed_ternary_ops::FromTernaryVector(
+                             FromString("0b01"))}),
+            packed_ternary_ops::FromTernaryVector(FromString("0b1X0X01")));
+  EXPECT_EQ(packed_ternary_ops::ZeroExtend(planes, /*new_bit_count=*/6),
+            packed_ternary_ops::FromTernaryVector(FromString("0b001X0X")));
+  EXPECT_EQ(packed_ternary_ops::SignExtend(planes, /*new_bit_count=*/6),
+            packed_ternary_ops::FromTernaryVector(FromString("0b111X0X")));
+  EXPECT_EQ(
+      packed_ternary_ops::SignExtend(
+          packed_ternary_ops::FromTernaryVector(FromString("0bX01")),
+          /*new_bit_count=*/5),
+      packed_ternary_ops::FromTernaryVector(FromString("0bXXX01")));
+}
+
 }  // namespace
 }  // namespace xls
@@ -15,16 +15,19 @@
 #include "xls/passes/ternary_query_engine.h"
 
 #include <limits>
+#include <optional>
 
-#include "absl/container/inlined_vector.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/data_structures/leaf_type_tree.h"
 #include "xls/ir/abstract_node_evaluator.h"
 #include "xls/ir/bits_ops.h"
 #include "xls/ir/dfs_visitor.h"
 #include "xls/ir/node_iterator.h"
+#include "xls/ir/nodes.h"
 #include "xls/passes/ternary_evaluator.h"
 
 namespace xls {
@@ -42,51 +45,96 @@ static bool IsExpensiveToEvaluate(Node* node) {
          node->GetType()->GetFlatBitCount() > 256;
 }
 
-Bits TernaryVectorToKnownBits(const TernaryEvaluator::Vector& ternary_vector) {
-  // Use InlinedVector to avoid std::vector<bool> specialization madness.
-  absl::InlinedVector<bool, 1> bits(ternary_vector.size());
-  for (int64_t i = 0; i < bits.size(); ++i) {
-    bits[i] = (ternary_vector[i] == TernaryValue::kKnownOne ||
-               ternary_vector[i] == TernaryValue::kKnownZero);
+// Evaluates `node` directly on packed known-bit planes when a word-level
+// kernel exists for the operation. Returns std::nullopt for unhandled
+// operations which must go through the elementwise abstract evaluator.
+static std::optional<TernaryPlanes> EvaluatePacked(
+    Node* node, absl::Span<const TernaryPlanes> operands) {
+  switch (node->op()) {
+    case Op::kLiteral:
+      return packed_ternary_ops::FromLiteral(
+          node->As<Literal>()->value().bits());
+    case Op::kNot:
+      return packed_ternary_ops::Not(operands[0]);
+    case Op::kAnd:
+      return packed_ternary_ops::And(operands);
+    case Op::kOr:
+      return packed_ternary_ops::Or(operands);
+    case Op::kXor:
+      return packed_ternary_ops::Xor(operands);
+    case Op::kNand:
+      return packed_ternary_ops::Nand(operands);
+    case Op::kNor:
+      return packed_ternary_ops::Nor(operands);
+    case Op::kAdd:
+      return packed_ternary_ops::Add(operands[0], operands[1]);
+    case Op::kSub:
+      return packed_ternary_ops::Sub(operands[0], operands[1]);
+    case Op::kNeg:
+      return packed_ternary_ops::Neg(operands[0]);
+    case Op::kConcat:
+      return packed_ternary_ops::Concat(operands);
+    case Op::kBitSlice:
+      return packed_ternary_ops::BitSlice(operands[0],
+                                          node->As<BitSlice>()->start(),
+                                          node->As<BitSlice>()->width());
+    case Op::kZeroExt:
+      return packed_ternary_ops::ZeroExtend(
+          operands[0], node->As<ExtendOp>()->new_bit_count());
+    case Op::kSignExt:
+      return packed_ternary_ops::SignExtend(
+          operands[0], node->As<ExtendOp>()->new_bit_count());
+    default:
+      return std::nullopt;
   }
-  return Bits(bits);
 }
 
-Bits TernaryVectorToValueBits(const TernaryEvaluator::Vector& ternary_vector) {
-  // Use InlinedVector to avoid std::vector<bool> specialization madness.
-  absl::InlinedVector<bool, 1> bits(ternary_vector.size());
-  for (int64_t i = 0; i < bits.size(); ++i) {
-    bits[i] = ternary_vector[i] == TernaryValue::kKnownOne;
+// Evaluates `node` given the packed planes of its operands, falling back to
+// the elementwise abstract evaluator for operations without a packed kernel.
+static absl::StatusOr<TernaryPlanes> EvaluateNode(
+    Node* node, absl::Span<const TernaryPlanes> operand_values,
+    TernaryEvaluator* evaluator) {
+  if (std::optional<TernaryPlanes> packed =
+          EvaluatePacked(node, operand_values);
+      packed.has_value()) {
+    return std::move(*packed);
   }
-  return Bits(bits);
+  std::vector<TernaryEvaluator::Vector> operand_vectors;
+  operand_vectors.reserve(operand_values.size());
+  for (const TernaryPlanes& operand : operand_values) {
+    operand_vectors.push_back(packed_ternary_ops::ToTernaryVector(operand));
+  }
+  XLS_ASSIGN_OR_RETURN(
+      TernaryEvaluator::Vector value,
+      AbstractEvaluate(node, operand_vectors, evaluator,
+                       /*default_handler=*/[](Node* n) {
+                         return TernaryEvaluator::Vector(
+                             n->BitCountOrDie(), TernaryValue::kUnknown);
+                       }));
+  return packed_ternary_ops::FromTernaryVector(value);
 }
 
 absl::StatusOr<ReachedFixpoint> TernaryQueryEngine::Populate(FunctionBase* f) {
   TernaryEvaluator evaluator;
-  absl::flat_hash_map<Node*, TernaryEvaluator::Vector> values;
+  absl::flat_hash_map<Node*, TernaryPlanes> values;
   for (Node* node : TopoSort(f)) {
     if (!node->GetType()->IsBits()) {
       continue;
     }
-    auto create_unknown_vector = [](Node* n) {
-      return TernaryEvaluator::Vector(n->BitCountOrDie(),
-                                      TernaryValue::kUnknown);
-    };
     if (IsExpensiveToEvaluate(node) ||
         std::any_of(node->operands().begin(), node->operands().end(),
                     [](Node* o) { return !o->GetType()->IsBits(); })) {
-      values[node] = create_unknown_vector(node);
+      values[node] = packed_ternary_ops::AllUnknown(node->BitCountOrDie());
       continue;
     }
 
-    std::vector<TernaryEvaluator::Vector> operand_values;
+    std::vector<TernaryPlanes> operand_values;
+    operand_values.reserve(node->operand_count());
     for (Node* operand : node->operands()) {
       operand_values.push_back(values.at(operand));
     }
-    XLS_ASSIGN_OR_RETURN(
-        values[node],
-        AbstractEvaluate(node, operand_values, &evaluator,
-                         /*default_handler=*/create_unknown_vector));
+    XLS_ASSIGN_OR_RETURN(values[node],
+                         EvaluateNode(node, operand_values, &evaluator));
   }
 
   ReachedFixpoint rf = ReachedFixpoint::Unchanged;
@@ -94,13 +142,13 @@ absl::StatusOr<ReachedFixpoint> TernaryQueryEngine::Populate(FunctionBase* f) {
     // TODO(meheff): Handle types other than bits.
     if (node->GetType()->IsBits()) {
       if (!known_bits_.contains(node)) {
-        known_bits_[node] = Bits(values.at(node).size());
-        bits_values_[node] = Bits(values.at(node).size());
+        known_bits_[node] = Bits(values.at(node).bit_count());
+        bits_values_[node] = Bits(values.at(node).bit_count());
       }
-      Bits combined_known_bits = bits_ops::Or(
-          known_bits_[node], TernaryVectorToKnownBits(values.at(node)));
-      Bits combined_bits_values = bits_ops::Or(
-          bits_values_[node], TernaryVectorToValueBits(values.at(node)));
+      Bits combined_known_bits =
+          bits_ops::Or(known_bits_[node], values.at(node).known);
+      Bits combined_bits_values =
+          bits_ops::Or(bits_values_[node], values.at(node).value);
       if ((combined_known_bits != known_bits_[node]) ||
           (combined_bits_values != bits_values_[node])) {
         rf = ReachedFixpoint::Changed;
@@ -112,6 +160,68 @@ absl::StatusOr<ReachedFixpoint> TernaryQueryEngine::Populate(FunctionBase* f) {
   return rf;
 }
 
+absl::StatusOr<ReachedFixpoint> TernaryQueryEngine::PopulateLazily(
+    FunctionBase* f) {
+  XLS_RET_CHECK(f != nullptr);
+  // Nothing is evaluated until a node is queried, so the fixpoint status is
+  // unchanged by construction.
+  lazy_ = true;
+  return ReachedFixpoint::Unchanged;
+}
+
+void TernaryQueryEngine::EnsureAnalyzed(Node* node) const {
+  if (!lazy_ || known_bits_.contains(node)) {
+    return;
+  }
+  XLS_CHECK_OK(EvaluateCone(node));
+}
+
+absl::Status TernaryQueryEngine::EvaluateCone(Node* root) const {
+  TernaryEvaluator evaluator;
+  auto set_value = [&](Node* n, const TernaryPlanes& value) {
+    known_bits_[n] = value.known;
+    bits_values_[n] = value.value;
+  };
+  // Iterative post-order walk of the not-yet-evaluated part of the cone of
+  // `root`. The bool marks whether the node's operands have been pushed.
+  std::vector<std::pair<Node*, bool>> stack;
+  stack.push_back({root, false});
+  while (!stack.empty()) {
+    auto [node, operands_pushed] = stack.back();
+    stack.pop_back();
+    if (known_bits_.contains(node) || !node->GetType()->IsBits()) {
+      continue;
+    }
+    if (IsExpensiveToEvaluate(node) ||
+        std::any_of(node->operands().begin(), node->operands().end(),
+                    [](Node* o) { return !o->GetType()->IsBits(); })) {
+      // The node's value does not depend on its operands, so there is no need
+      // to descend into them.
+      set_value(node, packed_ternary_ops::AllUnknown(node->BitCountOrDie()));
+      continue;
+    }
+    if (!operands_pushed) {
+      stack.push_back({node, true});
+      for (Node* operand : node->operands()) {
+        if (!known_bits_.contains(operand)) {
+          stack.push_back({operand, false});
+        }
+      }
+      continue;
+    }
+    std::vector<TernaryPlanes> operand_values;
+    operand_values.reserve(node->operand_count());
+    for (Node* operand : node->operands()) {
+      operand_values.push_back(TernaryPlanes{known_bits_.at(operand),
+                                             bits_values_.at(operand)});
+    }
+    XLS_ASSIGN_OR_RETURN(TernaryPlanes value,
+                         EvaluateNode(node, operand_values, &evaluator));
+    set_value(node, value);
+  }
+  return absl::OkStatus();
+}
+
 bool TernaryQueryEngine::AtMostOneTrue(
     absl::Span<TreeBitLocation const> bits) const {
   int64_t maybe_one_count = 0;
@@ -35,7 +35,14 @@ class TernaryQueryEngine : public QueryEngine {
 
   absl::StatusOr<ReachedFixpoint> Populate(FunctionBase* f) override;
 
+  // Like `Populate` but defers all evaluation: the ternary value of a node is
+  // computed (and memoized) from its transitive cone the first time the node
+  // is queried, so callers which only query a subset of the nodes in `f` do
+  // not pay for a whole-function evaluation.
+  absl::StatusOr<ReachedFixpoint> PopulateLazily(FunctionBase* f);
+
   bool IsTracked(Node* node) const override {
+    EnsureAnalyzed(node);
     return known_bits_.contains(node);
   }
 
@@ -48,6 +55,7 @@ class TernaryQueryEngine : public QueryEngine {
                                  TernaryValue::kUnknown);
           });
     }
+    EnsureAnalyzed(node);
     TernaryVector ternary =
         ternary_ops::FromKnownBits(known_bits_.at(node), bits_values_.at(node));
     LeafTypeTree<TernaryVector> result(node->GetType());
@@ -75,13 +83,27 @@ class TernaryQueryEngine : public QueryEngine {
   }
 
  private:
+  // If this engine was populated lazily, evaluates and memoizes the ternary
+  // values of any not-yet-evaluated nodes in `node`'s cone. No-op otherwise.
+  void EnsureAnalyzed(Node* node) const;
+
+  // Evaluates the cone of `node`, memoizing the result for each evaluated
+  // node in `known_bits_` and `bits_values_`.
+  absl::Status EvaluateCone(Node* node) const;
+
+  // Whether nodes are evaluated on demand (see `PopulateLazily`).
+  bool lazy_ = false;
+
+  // The maps are mutable because the lazy mode memoizes results of the const
+  // query methods.
+
   // Holds which bits values are known for nodes in the function. A one in a bit
   // position indications the respective bit value in the respective node is
   // statically known.
-  absl::flat_hash_map<Node*, Bits> known_bits_;
+  mutable absl::flat_hash_map<Node*, Bits> known_bits_;
 
   // Holds the values of statically known bits of nodes in the function.
-  absl::flat_hash_map<Node*, Bits> bits_values_;
+  mutable absl::flat_hash_map<Node*, Bits> bits_values_;
 };
 
 }  // namespace xls
@@ -130,5 +130,27 @@ TEST_F(TernaryQueryEngineTest, Ne) {
   EXPECT_THAT(RunOnBinaryOp("0b011", "0b011", make_ne), IsOkAndHolds("0b0"));
 }
 
+TEST_F(TernaryQueryEngineTest, LazyPopulationMatchesEager) {
+  Package p("test_package");
+  FunctionBuilder fb("f", &p);
+  BValue lhs = MakeValueWithKnownBits(
+      "lhs", StringToTernaryVector("0bXX10").value(), &fb);
+  BValue rhs = MakeValueWithKnownBits(
+      "rhs", StringToTernaryVector("0b1X0X").value(), &fb);
+  BValue result = fb.Concat({fb.And(lhs, rhs), fb.Or(lhs, rhs)});
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  TernaryQueryEngine eager_engine;
+  XLS_ASSERT_OK(eager_engine.Populate(f).status());
+  TernaryQueryEngine lazy_engine;
+  XLS_ASSERT_OK(lazy_engine.PopulateLazily(f).status());
+
+  // The lazy engine should report the same known bits as the eager one for
+  // any queried node.
+  EXPECT_EQ(lazy_engine.ToString(result.node()),
+            eager_engine.ToString(result.node()));
+  EXPECT_EQ(lazy_engine.ToString(lhs.node()), eager_engine.ToString(lhs.node()));
+}
+
 }  // namespace
 }  // namespace xls
@@ -14,6 +14,8 @@
 
 #include "xls/passes/token_dependency_pass.h"
 
+#include <memory>
+
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
@@ -34,19 +36,20 @@ absl::StatusOr<bool> TokenDependencyPass::RunOnFunctionBaseInternal(
   // the program. If a token consumed by node A was produced by node B (ignoring
   // intervening tuples or identity functions), then there will be an edge from
   // B to A in this relation.
+  IncrementalTokenProvenance* provenance =
+      results->analysis_cache.Get<IncrementalTokenProvenance>(f);
+  if (provenance == nullptr) {
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<IncrementalTokenProvenance> owned,
+                         IncrementalTokenProvenance::Create(f));
+    provenance = results->analysis_cache.Put(f, std::move(owned));
+  }
+
   NodeRelation token_deps;
-  {
-    XLS_ASSIGN_OR_RETURN(TokenProvenance provenance,
-                         TokenProvenanceAnalysis(f));
-    for (const auto& [node, ignore] : provenance) {
-      for (Node* child : node->operands()) {
-        if (!provenance.contains(child)) {
-          continue;
-        }
-        for (Node* element : provenance.at(child).elements()) {
-          if (element != nullptr) {
-            token_deps[element].insert(node);
-          }
+  for (Node* node : f->nodes()) {
+    for (Node* child : node->operands()) {
+      for (Node* element : provenance->Get(child).elements()) {
+        if (element != nullptr) {
+          token_deps[element].insert(node);
         }
       }
     }
@@ -157,11 +160,18 @@ absl::StatusOr<bool> TokenDependencyPass::RunOnFunctionBaseInternal(
               f->MakeNode<AfterAll>(SourceInfo(),
                                     std::vector<Node*>{receive_token, input}));
           changed |= io->ReplaceOperand(input, new_token);
+          // Fold the new nodes (and the rethreaded `io`) into the
+          // incrementally maintained provenance.
+          XLS_RETURN_IF_ERROR(provenance->HandleChange(receive_token));
         }
       }
     }
   }
 
+  // The provenance was kept in sync with the edits above, so re-stamp the
+  // cache entry for reuse by later passes.
+  results->analysis_cache.Refresh<IncrementalTokenProvenance>(f);
+
   return changed;
 }
 
@@ -17,10 +17,13 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
@@ -32,7 +35,6 @@
 #include "xls/passes/dataflow_visitor.h"
 
 namespace xls {
-namespace {
 
 class TokenProvenanceVisitor : public DataFlowVisitor<Node*> {
  public:
@@ -55,8 +57,6 @@ class TokenProvenanceVisitor : public DataFlowVisitor<Node*> {
   }
 };
 
-}  // namespace
-
 absl::StatusOr<TokenProvenance> TokenProvenanceAnalysis(FunctionBase* f) {
   TokenProvenanceVisitor visitor;
   XLS_RETURN_IF_ERROR(f->Accept(&visitor));
@@ -69,4 +69,39 @@ absl::StatusOr<TokenProvenance> TokenProvenanceAnalysis(FunctionBase* f) {
   return result;
 }
 
+IncrementalTokenProvenance::IncrementalTokenProvenance(FunctionBase* f)
+    : f_(f), visitor_(std::make_unique<TokenProvenanceVisitor>()) {}
+
+IncrementalTokenProvenance::~IncrementalTokenProvenance() = default;
+
+absl::StatusOr<std::unique_ptr<IncrementalTokenProvenance>>
+IncrementalTokenProvenance::Create(FunctionBase* f) {
+  auto provenance = absl::WrapUnique(new IncrementalTokenProvenance(f));
+  XLS_RETURN_IF_ERROR(f->Accept(provenance->visitor_.get()));
+  return provenance;
+}
+
+const LeafTypeTree<Node*>& IncrementalTokenProvenance::Get(Node* node) const {
+  return visitor_->GetValue(node);
+}
+
+absl::Status IncrementalTokenProvenance::HandleChange(Node* node) {
+  // Unmark the node and its transitive users so the revisit below recomputes
+  // them; every other node keeps its memoized value.
+  std::vector<Node*> worklist = {node};
+  absl::flat_hash_set<Node*> invalidated;
+  while (!worklist.empty()) {
+    Node* n = worklist.back();
+    worklist.pop_back();
+    if (!invalidated.insert(n).second) {
+      continue;
+    }
+    visitor_->UnmarkVisited(n);
+    for (Node* user : n->users()) {
+      worklist.push_back(user);
+    }
+  }
+  return f_->Accept(visitor_.get());
+}
+
 }  // namespace xls
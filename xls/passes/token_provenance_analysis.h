@@ -15,6 +15,8 @@
 #ifndef XLS_PASSES_TOKEN_PROVENANCE_ANALYSIS_H_
 #define XLS_PASSES_TOKEN_PROVENANCE_ANALYSIS_H_
 
+#include <memory>
+
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
@@ -32,6 +34,38 @@ using TokenProvenance = absl::flat_hash_map<Node*, LeafTypeTree<Node*>>;
 // `LeafTypeTree`s is not a token, the corresponding `Node*` will be `nullptr`.
 absl::StatusOr<TokenProvenance> TokenProvenanceAnalysis(FunctionBase* f);
 
+class TokenProvenanceVisitor;
+
+// Token provenance which is maintained incrementally across IR edits. The
+// full analysis is computed once at construction; a caller which rethreads
+// tokens calls HandleChange on each edited node and only the changed cone is
+// recomputed. Instances are shared across passes through
+// PassResults::analysis_cache; a pass which keeps the analysis in sync with
+// its own edits should call AnalysisCache::Refresh afterwards so the cache
+// entry remains valid.
+class IncrementalTokenProvenance {
+ public:
+  static absl::StatusOr<std::unique_ptr<IncrementalTokenProvenance>> Create(
+      FunctionBase* f);
+  ~IncrementalTokenProvenance();
+
+  // Returns the provenance of `node`. The semantics of the tree are those of
+  // `TokenProvenanceAnalysis`.
+  const LeafTypeTree<Node*>& Get(Node* node) const;
+
+  // Recomputes the provenance of `node` (which may be newly created) and of
+  // its transitive users; all other results are reused as is. Must be called
+  // whenever an edit changes the token threading through `node`, e.g. after
+  // replacing one of its operands.
+  absl::Status HandleChange(Node* node);
+
+ private:
+  explicit IncrementalTokenProvenance(FunctionBase* f);
+
+  FunctionBase* f_;
+  std::unique_ptr<TokenProvenanceVisitor> visitor_;
+};
+
 }  // namespace xls
 
 #endif  // XLS_PASSES_TOKEN_PROVENANCE_ANALYSIS_H_
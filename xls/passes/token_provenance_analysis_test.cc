@@ -32,6 +32,7 @@
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_test_base.h"
 #include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
 #include "xls/ir/proc.h"
 #include "xls/ir/type.h"
 #include "xls/ir/value.h"
@@ -102,6 +103,43 @@ TEST_F(TokenProvenanceAnalysisTest, VeryLongChain) {
   }
 }
 
+TEST_F(TokenProvenanceAnalysisTest, IncrementalUpdateMatchesFromScratch) {
+  auto p = CreatePackage();
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      StreamingChannel * channel,
+      p->CreateStreamingChannel("test_channel", ChannelOps::kSendReceive,
+                                p->GetBitsType(32)));
+
+  ProcBuilder pb(TestName(), "token", p.get());
+  BValue recv = pb.Receive(channel, pb.GetTokenParam());
+  BValue t1 = pb.TupleIndex(recv, 0);
+  BValue send = pb.Send(channel, t1, pb.Literal(UBits(50, 32)));
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * proc,
+                           pb.Build(send, std::vector<BValue>()));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<IncrementalTokenProvenance> provenance,
+      IncrementalTokenProvenance::Create(proc));
+  EXPECT_EQ(provenance->Get(t1.node()).Get({}), recv.node());
+  EXPECT_EQ(provenance->Get(send.node()).Get({}), send.node());
+
+  // Rethread the token input of the send through a new after_all and update
+  // the analysis in place.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Node * after_all,
+      proc->MakeNode<AfterAll>(SourceInfo(), std::vector<Node*>{t1.node()}));
+  XLS_ASSERT_OK(send.node()->ReplaceOperandNumber(0, after_all));
+  XLS_ASSERT_OK(provenance->HandleChange(after_all));
+
+  XLS_ASSERT_OK_AND_ASSIGN(TokenProvenance from_scratch,
+                           TokenProvenanceAnalysis(proc));
+  EXPECT_EQ(provenance->Get(after_all).Get({}), after_all);
+  for (Node* node : proc->nodes()) {
+    EXPECT_EQ(provenance->Get(node), from_scratch.at(node));
+  }
+}
+
 
 }  // namespace
 }  // namespace xls
@@ -61,6 +61,28 @@ Node* FindEquivalentTuple(Tuple* tuple) {
   return common_subject;
 }
 
+absl::StatusOr<bool> SimplifyTupleNode(Node* node) {
+  // Replace TupleIndex(Tuple(i{0}, i{1}, ..., i{N}), index=k) with i{k}.
+  // Note: lhs of tuple index may not be a tuple *instruction*.
+  if (node->Is<TupleIndex>() && node->operand(0)->Is<Tuple>()) {
+    TupleIndex* tuple_index = node->As<TupleIndex>();
+    Node* tuple_element =
+        tuple_index->operand(0)->operand(tuple_index->index());
+    XLS_RETURN_IF_ERROR(tuple_index->ReplaceUsesWith(tuple_element));
+    return true;
+  }
+  // Replace a Tuple reassembled from TupleIndexes of an existing tuple-typed
+  // node with that node.
+  if (node->Is<Tuple>()) {
+    Node* common_subject = FindEquivalentTuple(node->As<Tuple>());
+    if (common_subject != nullptr) {
+      XLS_RETURN_IF_ERROR(node->ReplaceUsesWith(common_subject));
+      return true;
+    }
+  }
+  return false;
+}
+
 absl::StatusOr<bool> TupleSimplificationPass::RunOnFunctionBaseInternal(
     FunctionBase* f, const PassOptions& options, PassResults* results) const {
   // Replace TupleIndex(Tuple(i{0}, i{1}, ..., i{N}), index=k) with i{k}
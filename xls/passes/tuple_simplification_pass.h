@@ -21,6 +21,14 @@
 
 namespace xls {
 
+// Applies the tuple simplification rules to the single node `node`: a
+// tuple_index of a tuple instruction is replaced with the indexed element,
+// and a tuple reassembled from tuple_indexes of an existing tuple-typed node
+// is replaced with that node. Returns true if the IR was modified. Exposed so
+// the unified peephole simplification pass can run the same rules from its
+// worklist.
+absl::StatusOr<bool> SimplifyTupleNode(Node* node);
+
 // Pass which simplifies and eliminates tuples. Replaces a tuple instruction
 // followed by a tuple index instruction with the tuple element itself.
 class TupleSimplificationPass : public FunctionBasePass {
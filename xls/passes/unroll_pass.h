@@ -25,6 +25,10 @@ class UnrollPass : public FunctionBasePass {
  public:
   UnrollPass() : FunctionBasePass("loop_unroll", "Unroll counted loops") {}
 
+  // Unrolling reads the body of the counted_for's loop function, which may be
+  // concurrently transformed by the worker processing that function.
+  bool SupportsParallelExecution() const override { return false; }
+
  protected:
   absl::StatusOr<bool> RunOnFunctionBaseInternal(
       FunctionBase* f, const PassOptions& options,
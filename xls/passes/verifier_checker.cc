@@ -20,7 +20,7 @@ namespace xls {
 
 absl::Status VerifierChecker::Run(Package* p, const PassOptions& options,
                                   PassResults* results) const {
-  return VerifyPackage(p);
+  return VerifyPackageIncremental(p, &verified_journals_);
 }
 
 }  // namespace xls
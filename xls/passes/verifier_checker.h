@@ -15,16 +15,29 @@
 #ifndef XLS_PASSES_VERIFIER_CHECKER_H_
 #define XLS_PASSES_VERIFIER_CHECKER_H_
 
+#include <cstdint>
+
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "xls/passes/passes.h"
 
 namespace xls {
 
-// Invariant checker which just runs xls::Verifier.
+// Invariant checker which just runs xls::Verifier. Verification is
+// incremental: across invocations the checker remembers which function bases
+// it has already verified (keyed by their transform journal) and re-checks
+// only those mutated since the previous pass, so enabling verification after
+// every pass costs time proportional to what the passes actually changed.
 class VerifierChecker : public InvariantChecker {
  public:
   absl::Status Run(Package* p, const PassOptions& options,
                    PassResults* results) const override;
+
+ private:
+  // Journal values of the function bases verified by the previous invocation.
+  // Mutable because Run() is const; invariant checkers are not invoked
+  // concurrently within a pipeline.
+  mutable absl::flat_hash_map<FunctionBase*, int64_t> verified_journals_;
 };
 
 }  // namespace xls
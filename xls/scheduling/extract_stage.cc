@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/memory/memory.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "xls/common/status/status_macros.h"
@@ -44,9 +45,10 @@ absl::StatusOr<Function*> ExtractStage(Function* src,
         if (node_map.contains(operand)) {
           new_operands.push_back(node_map.at(operand));
         } else {
-          Node* new_param = new_f->AddNode(
-              std::make_unique<Param>(operand->loc(), operand->GetName(),
-                                      operand->GetType(), new_f.get()));
+          Node* new_param = new_f->AddNode(absl::WrapUnique(
+              new (package->node_arena())
+                  Param(operand->loc(), operand->GetName(), operand->GetType(),
+                        new_f.get())));
           node_map[operand] = new_param;
           new_operands.push_back(new_param);
         }
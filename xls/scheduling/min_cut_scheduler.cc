@@ -141,7 +141,8 @@ std::vector<std::vector<int64_t>> GetMinCutCycleOrders(int64_t length) {
 absl::StatusOr<ScheduleCycleMap> MinCutScheduler(
     FunctionBase* f, int64_t pipeline_stages, int64_t clock_period_ps,
     const DelayEstimator& delay_estimator, sched::ScheduleBounds* bounds,
-    absl::Span<const SchedulingConstraint> constraints) {
+    absl::Span<const SchedulingConstraint> constraints,
+    const SchedulingOptions* options) {
   XLS_VLOG(3) << "MinCutScheduler()";
   XLS_VLOG(3) << "  pipeline stages = " << pipeline_stages;
   XLS_VLOG_LINES(4, f->DumpIr());
@@ -174,6 +175,11 @@ absl::StatusOr<ScheduleCycleMap> MinCutScheduler(
   std::optional<sched::ScheduleBounds> best_bounds;
   for (const std::vector<int64_t>& cut_order :
        GetMinCutCycleOrders(pipeline_stages - 1)) {
+    // Each cut ordering is a complete, independent scheduling attempt; the
+    // boundary between orderings is a safe point to give up at.
+    if (options != nullptr) {
+      XLS_RETURN_IF_ERROR(options->CheckNotCancelled());
+    }
     XLS_VLOG(3) << absl::StreamFormat("Trying cycle order: {%s}",
                                       absl::StrJoin(cut_order, ", "));
     sched::ScheduleBounds trial_bounds = *bounds;
@@ -30,11 +30,13 @@ namespace xls {
 // Schedules the given function into a pipeline with the given clock
 // period. Attempts to split nodes into stages such that the total number of
 // flops in the pipeline stages is minimized without violating the target clock
-// period.
+// period. If `options` is non-null its deadline/cancellation token is checked
+// between cut orderings (see SchedulingOptions::CheckNotCancelled).
 absl::StatusOr<ScheduleCycleMap> MinCutScheduler(
     FunctionBase* f, int64_t pipeline_stages, int64_t clock_period_ps,
     const DelayEstimator& delay_estimator, sched::ScheduleBounds* bounds,
-    absl::Span<const SchedulingConstraint> constraints);
+    absl::Span<const SchedulingConstraint> constraints,
+    const SchedulingOptions* options = nullptr);
 
 // Returns the list of ordering of cycles (pipeline stages) in which to compute
 // min cut of the graph. Each min cut of the graph computes which XLS node
@@ -18,14 +18,17 @@
 #include <cmath>
 #include <functional>
 #include <random>
+#include <thread>  // NOLINT(build/c++11)
 
 #include "absl/container/btree_map.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/synchronization/mutex.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/thread.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/data_structures/binary_search.h"
 #include "xls/ir/node_iterator.h"
@@ -184,13 +187,17 @@ absl::StatusOr<int64_t> ComputeCriticalPath(
 // schedule the function into a pipeline with the given number of stages.
 absl::StatusOr<int64_t> FindMinimumClockPeriod(
     FunctionBase* f, int64_t pipeline_stages,
-    const DelayEstimator& delay_estimator) {
+    const DelayEstimator& delay_estimator, const SchedulingOptions& options) {
   XLS_VLOG(4) << "FindMinimumClockPeriod()";
   XLS_VLOG(4) << "  pipeline stages = " << pipeline_stages;
   auto topo_sort_it = TopoSort(f);
   std::vector<Node*> topo_sort(topo_sort_it.begin(), topo_sort_it.end());
+  // Every iteration of the binary search re-propagates bounds, querying the
+  // same nodes' delays again; cache them across the whole search.
+  CachingDelayEstimator cached_delay_estimator(
+      absl::StrFormat("%s_cached", delay_estimator.name()), delay_estimator);
   XLS_ASSIGN_OR_RETURN(int64_t function_cp,
-                       ComputeCriticalPath(topo_sort, delay_estimator));
+                       ComputeCriticalPath(topo_sort, cached_delay_estimator));
   // The lower bound of the search is the critical path delay evenly distributed
   // across all stages (rounded up), and the upper bound is simply the critical
   // path of the entire function. It's possible this upper bound is the best you
@@ -205,9 +212,12 @@ absl::StatusOr<int64_t> FindMinimumClockPeriod(
       BinarySearchMinTrueWithStatus(
           search_start, search_end,
           [&](int64_t clk_period_ps) -> absl::StatusOr<bool> {
+            // Each probe of the binary search re-propagates bounds over the
+            // whole function; give up between probes if the budget is spent.
+            XLS_RETURN_IF_ERROR(options.CheckNotCancelled());
             absl::StatusOr<sched::ScheduleBounds> bounds_or = ConstructBounds(
                 f, clk_period_ps, topo_sort,
-                /*schedule_length=*/absl::nullopt, delay_estimator);
+                /*schedule_length=*/absl::nullopt, cached_delay_estimator);
             if (!bounds_or.ok()) {
               return false;
             }
@@ -341,9 +351,10 @@ class DelayEstimatorWithInputDelay : public DelayEstimator {
     // A pipeline length is specified, but no target clock period. Determine
     // the minimum clock period for which the function can be scheduled in the
     // given pipeline length.
-    XLS_ASSIGN_OR_RETURN(clock_period_ps,
-                         FindMinimumClockPeriod(f, *options.pipeline_stages(),
-                                                delay_estimator_with_delay));
+    XLS_ASSIGN_OR_RETURN(
+        clock_period_ps,
+        FindMinimumClockPeriod(f, *options.pipeline_stages(),
+                               delay_estimator_with_delay, options));
 
     if (options.period_relaxation_percent().has_value()) {
       int64_t relaxation_percent = options.period_relaxation_percent().value();
@@ -352,6 +363,7 @@ class DelayEstimatorWithInputDelay : public DelayEstimator {
     }
   }
 
+  XLS_RETURN_IF_ERROR(options.CheckNotCancelled());
   XLS_ASSIGN_OR_RETURN(
       sched::ScheduleBounds bounds,
       ConstructBounds(f, clock_period_ps, TopoSort(f).AsVector(),
@@ -366,14 +378,15 @@ class DelayEstimatorWithInputDelay : public DelayEstimator {
     XLS_ASSIGN_OR_RETURN(cycle_map,
                          MinCutScheduler(f, schedule_length, clock_period_ps,
                                          delay_estimator_with_delay, &bounds,
-                                         options.constraints()));
+                                         options.constraints(), &options));
   } else if (options.strategy() == SchedulingStrategy::SDC) {
     XLS_ASSIGN_OR_RETURN(cycle_map,
                          SDCScheduler(f, schedule_length, clock_period_ps,
                                       delay_estimator_with_delay, &bounds,
-                                      options.constraints()));
+                                      options.constraints(), &options));
   } else if (options.strategy() == SchedulingStrategy::RANDOM) {
     for (Node* node : TopoSort(f)) {
+      XLS_RETURN_IF_ERROR(options.CheckNotCancelled());
       int64_t lower_bound = bounds.lb(node);
       int64_t upper_bound = bounds.ub(node);
       std::mt19937 gen(options.seed().value_or(0));
@@ -584,4 +597,120 @@ int64_t PipelineSchedule::CountFinalInteriorPipelineRegisters() const {
   return reg_count;
 }
 
+namespace {
+
+// Delay estimator backed by a table of per-node delays computed once up
+// front. The table is shared read-only by all sweep workers so each candidate
+// does not re-query the (potentially expensive) underlying model.
+class PrecomputedDelayEstimator : public DelayEstimator {
+ public:
+  PrecomputedDelayEstimator(std::string name,
+                            absl::flat_hash_map<Node*, int64_t> delays)
+      : DelayEstimator(std::move(name)), delays_(std::move(delays)) {}
+
+  absl::StatusOr<int64_t> GetOperationDelayInPs(Node* node) const override {
+    auto it = delays_.find(node);
+    if (it == delays_.end()) {
+      return absl::NotFoundError(absl::StrFormat(
+          "No precomputed delay for node %s", node->GetName()));
+    }
+    return it->second;
+  }
+
+ private:
+  absl::flat_hash_map<Node*, int64_t> delays_;
+};
+
+}  // namespace
+
+absl::StatusOr<std::vector<SchedulingSweepResult>> SweepPipelineSchedules(
+    FunctionBase* f, const DelayEstimator& delay_estimator,
+    const SchedulingOptions& base_options,
+    absl::Span<const SchedulingSweepPoint> candidates) {
+  XLS_RET_CHECK(!candidates.empty());
+
+  // Query the underlying delay model once per node up front; the workers
+  // share the resulting table.
+  absl::flat_hash_map<Node*, int64_t> delays;
+  for (Node* node : f->nodes()) {
+    XLS_ASSIGN_OR_RETURN(delays[node],
+                         delay_estimator.GetOperationDelayInPs(node));
+  }
+  PrecomputedDelayEstimator shared_estimator(delay_estimator.name(),
+                                             std::move(delays));
+
+  // Workers claim candidate indices from a shared counter and write their
+  // result into the slot for that index; slots are disjoint so only the
+  // counter needs a lock.
+  std::vector<std::optional<SchedulingSweepResult>> results(candidates.size());
+  absl::Mutex mutex;
+  int64_t next_candidate = 0;
+  auto worker_fn = [&]() {
+    while (true) {
+      int64_t index;
+      {
+        absl::MutexLock lock(&mutex);
+        if (next_candidate == static_cast<int64_t>(candidates.size())) {
+          return;
+        }
+        index = next_candidate++;
+      }
+      const SchedulingSweepPoint& point = candidates[index];
+      SchedulingOptions options = base_options;
+      options.clock_period_ps(point.clock_period_ps);
+      options.pipeline_stages(point.pipeline_stages);
+      absl::StatusOr<PipelineSchedule> schedule =
+          PipelineSchedule::Run(f, shared_estimator, options);
+      if (!schedule.ok()) {
+        // Infeasible points are expected when sweeping; just drop them.
+        XLS_VLOG(2) << absl::StreamFormat(
+            "Sweep point (clock_period_ps=%d, pipeline_stages=%d) is not "
+            "schedulable: %s",
+            point.clock_period_ps, point.pipeline_stages,
+            schedule.status().message());
+        continue;
+      }
+      int64_t register_bits = schedule->CountFinalInteriorPipelineRegisters();
+      results[index] = SchedulingSweepResult{
+          point, std::move(schedule).value(), register_bits};
+    }
+  };
+
+  int64_t num_workers = std::min(
+      static_cast<int64_t>(candidates.size()),
+      std::max(int64_t{1},
+               static_cast<int64_t>(std::thread::hardware_concurrency())));
+  std::vector<std::unique_ptr<Thread>> workers;
+  for (int64_t i = 0; i < num_workers; ++i) {
+    workers.push_back(std::make_unique<Thread>(worker_fn));
+  }
+  for (std::unique_ptr<Thread>& worker : workers) {
+    worker->Join();
+  }
+
+  std::vector<SchedulingSweepResult> scheduled;
+  for (std::optional<SchedulingSweepResult>& result : results) {
+    if (result.has_value()) {
+      scheduled.push_back(std::move(result).value());
+    }
+  }
+
+  // Pareto-prune: sorted by increasing stage count (then register bits), a
+  // point is on the frontier only if it has strictly fewer register bits than
+  // every shallower point.
+  std::sort(scheduled.begin(), scheduled.end(),
+            [](const SchedulingSweepResult& a, const SchedulingSweepResult& b) {
+              return std::make_pair(a.point.pipeline_stages, a.register_bits) <
+                     std::make_pair(b.point.pipeline_stages, b.register_bits);
+            });
+  std::vector<SchedulingSweepResult> frontier;
+  for (SchedulingSweepResult& result : scheduled) {
+    if (frontier.empty() ||
+        result.register_bits < frontier.back().register_bits) {
+      frontier.push_back(std::move(result));
+    }
+  }
+  return frontier;
+}
+
 }  // namespace xls
@@ -98,6 +98,36 @@ class PipelineSchedule {
   std::vector<std::vector<Node*>> cycle_to_nodes_;
 };
 
+// A (clock period, pipeline stages) candidate for scheduling design-space
+// exploration via SweepPipelineSchedules.
+struct SchedulingSweepPoint {
+  int64_t clock_period_ps;
+  int64_t pipeline_stages;
+};
+
+// The outcome of scheduling one sweep candidate.
+struct SchedulingSweepResult {
+  SchedulingSweepPoint point;
+  PipelineSchedule schedule;
+  // Total bits of interior pipeline registers in the schedule; the cost axis
+  // of the Pareto frontier (the latency axis is point.pipeline_stages).
+  int64_t register_bits;
+};
+
+// Schedules every candidate point for `f` concurrently on a pool of worker
+// threads. Per-node delays are estimated once up front and shared read-only
+// by all candidates. `base_options` supplies the strategy and any
+// sweep-invariant options; each candidate overrides clock_period_ps and
+// pipeline_stages. Candidates which cannot be scheduled are dropped
+// (infeasible points are expected when sweeping).
+//
+// Returns the Pareto frontier of register bits versus pipeline stages among
+// the successfully scheduled candidates, sorted by increasing stage count.
+absl::StatusOr<std::vector<SchedulingSweepResult>> SweepPipelineSchedules(
+    FunctionBase* f, const DelayEstimator& delay_estimator,
+    const SchedulingOptions& base_options,
+    absl::Span<const SchedulingSweepPoint> candidates);
+
 }  // namespace xls
 
 #endif  // XLS_SCHEDULING_PIPELINE_SCHEDULE_H_
@@ -833,5 +833,77 @@ TEST_F(PipelineScheduleTest, RandomSchedule) {
   }
 }
 
+TEST_F(PipelineScheduleTest, SweepReturnsParetoFrontier) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  auto x = fb.Param("x", p->GetBitsType(32));
+  for (int64_t i = 0; i < 8; ++i) {
+    x = fb.Negate(x);
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(Function * func, fb.Build());
+
+  // Sweep stage counts at a couple of clock targets; period 1 with a single
+  // stage is infeasible (the critical path is 8ps) and should be dropped.
+  std::vector<SchedulingSweepPoint> candidates;
+  for (int64_t clock_period_ps : {1, 4}) {
+    for (int64_t pipeline_stages : {1, 2, 4, 8}) {
+      candidates.push_back(
+          SchedulingSweepPoint{clock_period_ps, pipeline_stages});
+    }
+  }
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<SchedulingSweepResult> frontier,
+      SweepPipelineSchedules(func, TestDelayEstimator(), SchedulingOptions(),
+                             candidates));
+
+  // Every stage boundary of this chain carries the live 32-bit value, so
+  // deeper pipelines strictly add register bits and only the shallowest
+  // feasible point -- two stages at period 4 -- is on the frontier.
+  ASSERT_EQ(frontier.size(), 1);
+  const SchedulingSweepResult& result = frontier.front();
+  EXPECT_EQ(result.point.clock_period_ps, 4);
+  EXPECT_EQ(result.point.pipeline_stages, 2);
+  EXPECT_EQ(result.register_bits, 32);
+  EXPECT_EQ(result.schedule.length(), 2);
+  EXPECT_EQ(result.register_bits,
+            result.schedule.CountFinalInteriorPipelineRegisters());
+  XLS_EXPECT_OK(result.schedule.VerifyTiming(result.point.clock_period_ps,
+                                             TestDelayEstimator()));
+}
+
+TEST_F(PipelineScheduleTest, ExpiredDeadlineFailsCleanly) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  auto x = fb.Param("x", p->GetBitsType(32));
+  fb.Not(fb.Negate(x));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * func, fb.Build());
+
+  SchedulingOptions options;
+  options.clock_period_ps(1);
+  options.deadline(absl::Now() - absl::Seconds(1));
+  EXPECT_THAT(
+      PipelineSchedule::Run(func, TestDelayEstimator(), options).status(),
+      StatusIs(absl::StatusCode::kDeadlineExceeded,
+               HasSubstr("deadline exceeded")));
+}
+
+TEST_F(PipelineScheduleTest, CancellationFailsCleanly) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  auto x = fb.Param("x", p->GetBitsType(32));
+  fb.Not(fb.Negate(x));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * func, fb.Build());
+
+  CancellationScope scope;
+  scope.Cancel();
+  SchedulingOptions options;
+  options.clock_period_ps(1);
+  options.cancellation(&scope);
+  EXPECT_THAT(
+      PipelineSchedule::Run(func, TestDelayEstimator(), options).status(),
+      StatusIs(absl::StatusCode::kCancelled, HasSubstr("cancelled")));
+}
+
 }  // namespace
 }  // namespace xls
@@ -14,6 +14,9 @@
 
 #include "xls/scheduling/schedule_bounds.h"
 
+#include <deque>
+
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "xls/common/logging/logging.h"
@@ -44,6 +47,8 @@ ScheduleBounds::ScheduleBounds(FunctionBase* f, std::vector<Node*> topo_sort,
 void ScheduleBounds::Reset() {
   max_lower_bound_ = 0;
   min_upper_bound_ = 0;
+  lb_in_cycle_delay_.clear();
+  ub_in_cycle_delay_.clear();
   for (Node* node : topo_sort_) {
     bounds_[node] = {0, std::numeric_limits<int64_t>::max()};
     max_lower_bound_ = 0;
@@ -53,12 +58,10 @@ void ScheduleBounds::Reset() {
 
 std::string ScheduleBounds::ToString() const {
   std::string out = "Bounds:\n";
-  if (!bounds_.empty()) {
-    for (Node* node : TopoSort(bounds_.begin()->first->function_base())) {
-      if (bounds_.contains(node)) {
-        absl::StrAppendFormat(&out, "  %s : [%d, %d]\n", node->GetName(),
-                              lb(node), ub(node));
-      }
+  for (Node* node : topo_sort_) {
+    if (bounds_.contains(node)) {
+      absl::StrAppendFormat(&out, "  %s : [%d, %d]\n", node->GetName(),
+                            lb(node), ub(node));
     }
   }
   return out;
@@ -66,14 +69,12 @@ std::string ScheduleBounds::ToString() const {
 
 absl::Status ScheduleBounds::PropagateLowerBounds() {
   XLS_VLOG(4) << "PropagateLowerBounds()";
-  // The delay in picoseconds from the beginning of a cycle to the start of the
-  // node.
-  absl::flat_hash_map<Node*, int64_t> in_cycle_delay;
+  lb_in_cycle_delay_.clear();
 
   // Compute the lower bound of each node based on the lower bounds of the
   // operands of the node.
   for (Node* node : topo_sort_) {
-    int64_t& node_in_cycle_delay = in_cycle_delay[node];
+    int64_t& node_in_cycle_delay = lb_in_cycle_delay_[node];
     XLS_VLOG(4) << absl::StreamFormat("  %s : original lb=%d", node->GetName(),
                                       lb(node));
     for (Node* operand : node->operands()) {
@@ -88,11 +89,11 @@ absl::Status ScheduleBounds::PropagateLowerBounds() {
             "    tightened lb to %d because of operand %s", operand_lb,
             operand->GetName());
         XLS_RETURN_IF_ERROR(TightenNodeLb(node, operand_lb));
-        node_in_cycle_delay = in_cycle_delay.at(operand) + operand_delay;
+        node_in_cycle_delay = lb_in_cycle_delay_.at(operand) + operand_delay;
         continue;
       }
       node_in_cycle_delay = std::max(
-          node_in_cycle_delay, in_cycle_delay.at(operand) + operand_delay);
+          node_in_cycle_delay, lb_in_cycle_delay_.at(operand) + operand_delay);
     }
     XLS_ASSIGN_OR_RETURN(int64_t node_delay,
                          delay_estimator_->GetOperationDelayInPs(node));
@@ -114,14 +115,13 @@ absl::Status ScheduleBounds::PropagateLowerBounds() {
 
 absl::Status ScheduleBounds::PropagateUpperBounds() {
   XLS_VLOG(4) << "PropagateUpperBounds()";
-  // The delay in picoseconds from the end of a cycle to the end of the node.
-  absl::flat_hash_map<Node*, int64_t> in_cycle_delay;
+  ub_in_cycle_delay_.clear();
 
   // Compute the upper bound of each node based on the upper bounds of the
   // users of the node.
   for (auto it = topo_sort_.rbegin(); it != topo_sort_.rend(); ++it) {
     Node* node = *it;
-    int64_t& node_in_cycle_delay = in_cycle_delay[node];
+    int64_t& node_in_cycle_delay = ub_in_cycle_delay_[node];
     XLS_VLOG(4) << absl::StreamFormat("  %s : original ub=%d", node->GetName(),
                                       ub(node));
     for (Node* user : node->users()) {
@@ -137,11 +137,11 @@ absl::Status ScheduleBounds::PropagateUpperBounds() {
             "    tightened ub to %d because of user %s", user_ub,
             user->GetName());
         XLS_RETURN_IF_ERROR(TightenNodeUb(node, user_ub));
-        node_in_cycle_delay = in_cycle_delay.at(user) + user_delay;
+        node_in_cycle_delay = ub_in_cycle_delay_.at(user) + user_delay;
         continue;
       }
-      node_in_cycle_delay =
-          std::max(node_in_cycle_delay, in_cycle_delay.at(user) + user_delay);
+      node_in_cycle_delay = std::max(
+          node_in_cycle_delay, ub_in_cycle_delay_.at(user) + user_delay);
     }
     XLS_ASSIGN_OR_RETURN(int64_t node_delay,
                          delay_estimator_->GetOperationDelayInPs(node));
@@ -161,6 +161,137 @@ absl::Status ScheduleBounds::PropagateUpperBounds() {
   return absl::OkStatus();
 }
 
+absl::StatusOr<bool> ScheduleBounds::RecomputeLowerBound(Node* node) {
+  int64_t orig_lb = lb(node);
+  int64_t orig_delay = lb_in_cycle_delay_[node];
+  int64_t node_in_cycle_delay = 0;
+  for (Node* operand : node->operands()) {
+    int64_t operand_lb = lb(operand);
+    if (operand_lb < lb(node)) {
+      continue;
+    }
+    XLS_ASSIGN_OR_RETURN(int64_t operand_delay,
+                         delay_estimator_->GetOperationDelayInPs(operand));
+    if (operand_lb > lb(node)) {
+      XLS_RETURN_IF_ERROR(TightenNodeLb(node, operand_lb));
+      node_in_cycle_delay = lb_in_cycle_delay_[operand] + operand_delay;
+      continue;
+    }
+    node_in_cycle_delay = std::max(
+        node_in_cycle_delay, lb_in_cycle_delay_[operand] + operand_delay);
+  }
+  XLS_ASSIGN_OR_RETURN(int64_t node_delay,
+                       delay_estimator_->GetOperationDelayInPs(node));
+  if (node_delay > clock_period_ps_) {
+    return absl::ResourceExhaustedError(absl::StrFormat(
+        "Node %s has a greater delay (%dps) than the clock period (%dps)",
+        node->GetName(), node_delay, clock_period_ps_));
+  }
+  if (node_in_cycle_delay + node_delay > clock_period_ps_) {
+    // Node does not fit in this cycle. Move to next cycle.
+    XLS_RETURN_IF_ERROR(TightenNodeLb(node, lb(node) + 1));
+    node_in_cycle_delay = 0;
+  }
+  if (lb(node) == orig_lb) {
+    // Within-cycle delays only grow at a fixed bound which keeps worklist
+    // propagation monotonic.
+    node_in_cycle_delay = std::max(node_in_cycle_delay, orig_delay);
+  }
+  lb_in_cycle_delay_[node] = node_in_cycle_delay;
+  return lb(node) != orig_lb || node_in_cycle_delay != orig_delay;
+}
+
+absl::StatusOr<bool> ScheduleBounds::RecomputeUpperBound(Node* node) {
+  int64_t orig_ub = ub(node);
+  int64_t orig_delay = ub_in_cycle_delay_[node];
+  int64_t node_in_cycle_delay = 0;
+  for (Node* user : node->users()) {
+    int64_t user_ub = ub(user);
+    if (user_ub == std::numeric_limits<int64_t>::max() || user_ub > ub(node)) {
+      continue;
+    }
+    XLS_ASSIGN_OR_RETURN(int64_t user_delay,
+                         delay_estimator_->GetOperationDelayInPs(user));
+    if (user_ub < ub(node)) {
+      XLS_RETURN_IF_ERROR(TightenNodeUb(node, user_ub));
+      node_in_cycle_delay = ub_in_cycle_delay_[user] + user_delay;
+      continue;
+    }
+    node_in_cycle_delay =
+        std::max(node_in_cycle_delay, ub_in_cycle_delay_[user] + user_delay);
+  }
+  XLS_ASSIGN_OR_RETURN(int64_t node_delay,
+                       delay_estimator_->GetOperationDelayInPs(node));
+  if (node_delay > clock_period_ps_) {
+    return absl::ResourceExhaustedError(absl::StrFormat(
+        "Node %s has a greater delay (%dps) than the clock period (%dps)",
+        node->GetName(), node_delay, clock_period_ps_));
+  }
+  if (node_in_cycle_delay + node_delay > clock_period_ps_) {
+    // Node does not fit in this cycle. Move to previous cycle.
+    XLS_RETURN_IF_ERROR(TightenNodeUb(node, ub(node) - 1));
+    node_in_cycle_delay = 0;
+  }
+  if (ub(node) == orig_ub) {
+    node_in_cycle_delay = std::max(node_in_cycle_delay, orig_delay);
+  }
+  ub_in_cycle_delay_[node] = node_in_cycle_delay;
+  return ub(node) != orig_ub || node_in_cycle_delay != orig_delay;
+}
+
+absl::Status ScheduleBounds::PropagateLowerBoundsFrom(Node* node) {
+  XLS_VLOG(4) << "PropagateLowerBoundsFrom(" << node->GetName() << ")";
+  std::deque<Node*> worklist;
+  absl::flat_hash_set<Node*> in_worklist;
+  auto enqueue_users = [&](Node* n) {
+    for (Node* user : n->users()) {
+      if (in_worklist.insert(user).second) {
+        worklist.push_back(user);
+      }
+    }
+  };
+  // The caller has just tightened the bound of `node` so its users must be
+  // revisited unconditionally; beyond that a node is only revisited when
+  // recomputation changed its state.
+  XLS_RETURN_IF_ERROR(RecomputeLowerBound(node).status());
+  enqueue_users(node);
+  while (!worklist.empty()) {
+    Node* n = worklist.front();
+    worklist.pop_front();
+    in_worklist.erase(n);
+    XLS_ASSIGN_OR_RETURN(bool changed, RecomputeLowerBound(n));
+    if (changed) {
+      enqueue_users(n);
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ScheduleBounds::PropagateUpperBoundsFrom(Node* node) {
+  XLS_VLOG(4) << "PropagateUpperBoundsFrom(" << node->GetName() << ")";
+  std::deque<Node*> worklist;
+  absl::flat_hash_set<Node*> in_worklist;
+  auto enqueue_operands = [&](Node* n) {
+    for (Node* operand : n->operands()) {
+      if (in_worklist.insert(operand).second) {
+        worklist.push_back(operand);
+      }
+    }
+  };
+  XLS_RETURN_IF_ERROR(RecomputeUpperBound(node).status());
+  enqueue_operands(node);
+  while (!worklist.empty()) {
+    Node* n = worklist.front();
+    worklist.pop_front();
+    in_worklist.erase(n);
+    XLS_ASSIGN_OR_RETURN(bool changed, RecomputeUpperBound(n));
+    if (changed) {
+      enqueue_operands(n);
+    }
+  }
+  return absl::OkStatus();
+}
+
 /* static */
 absl::StatusOr<ScheduleBounds> ScheduleBounds::ComputeAsapAndAlapBounds(
     FunctionBase* f, int64_t clock_period_ps,
@@ -19,7 +19,6 @@
 #include <limits>
 #include <utility>
 
-#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
@@ -28,6 +27,7 @@
 #include "xls/delay_model/delay_estimator.h"
 #include "xls/ir/function.h"
 #include "xls/ir/node.h"
+#include "xls/ir/node_indexed_vector.h"
 
 namespace xls {
 namespace sched {
@@ -117,7 +117,20 @@ class ScheduleBounds {
   absl::Status PropagateLowerBounds();
   absl::Status PropagateUpperBounds();
 
+  // Worklist-driven variants of the above which propagate a just-tightened
+  // bound of the given node only through its affected cone (users for lower
+  // bounds, operands for upper bounds) rather than sweeping the entire
+  // graph. Useful in iterative flows which tighten one node's bound at a time
+  // between reschedulings.
+  absl::Status PropagateLowerBoundsFrom(Node* node);
+  absl::Status PropagateUpperBoundsFrom(Node* node);
+
  private:
+  // Recomputes the lower (upper) bound and within-cycle delay of the given
+  // node from its operands (users). Returns true if either changed.
+  absl::StatusOr<bool> RecomputeLowerBound(Node* node);
+  absl::StatusOr<bool> RecomputeUpperBound(Node* node);
+
   // A topological sort of the nodes in the function.
   std::vector<Node*> topo_sort_;
 
@@ -125,7 +138,14 @@ class ScheduleBounds {
   const DelayEstimator* delay_estimator_;
 
   // The bounds of each node stored as a {lower, upper} pair.
-  absl::flat_hash_map<Node*, std::pair<int64_t, int64_t>> bounds_;
+  NodeIndexedVector<std::pair<int64_t, int64_t>> bounds_;
+
+  // The delay in picoseconds from the beginning (end) of a cycle to the start
+  // (end) of each node as computed by the last lower (upper) bound
+  // propagation. Retained across calls so that worklist-driven propagation
+  // can restart from a single node.
+  NodeIndexedVector<int64_t> lb_in_cycle_delay_;
+  NodeIndexedVector<int64_t> ub_in_cycle_delay_;
 
   int64_t max_lower_bound_;
   int64_t min_upper_bound_;
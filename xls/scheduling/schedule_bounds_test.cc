@@ -162,6 +162,44 @@ TEST_F(ScheduleBoundsTest, SimpleExpressionTightenBounds) {
   EXPECT_EQ(bounds.lb(result.node()), 23);
 }
 
+TEST_F(ScheduleBoundsTest, WorklistPropagationMatchesFullPropagation) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  auto x = fb.Param("x", p->GetBitsType(32));
+  auto y = fb.Param("y", p->GetBitsType(32));
+  auto not_x = fb.Not(x);
+  auto x_plus_y = fb.Add(x, y);
+  auto not_x_plus_y = fb.Not(x_plus_y);
+  auto result = fb.Add(not_x, not_x_plus_y);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  ScheduleBounds bounds(f, /*clock_period_ps=*/1, delay_estimator_);
+  XLS_ASSERT_OK(bounds.PropagateLowerBounds());
+
+  // Tightening one node's lower bound and propagating from it should only
+  // visit the cone of users of that node but produce the same bounds as a
+  // full propagation pass.
+  ScheduleBounds full = bounds;
+  XLS_ASSERT_OK(bounds.TightenNodeLb(not_x.node(), 22));
+  XLS_ASSERT_OK(bounds.PropagateLowerBoundsFrom(not_x.node()));
+  XLS_ASSERT_OK(full.TightenNodeLb(not_x.node(), 22));
+  XLS_ASSERT_OK(full.PropagateLowerBounds());
+  for (Node* node : f->nodes()) {
+    EXPECT_EQ(bounds.lb(node), full.lb(node)) << node->GetName();
+  }
+  EXPECT_EQ(bounds.lb(result.node()), 23);
+
+  // Same for upper bounds, propagating backwards through operands.
+  XLS_ASSERT_OK(bounds.TightenNodeUb(result.node(), 100));
+  XLS_ASSERT_OK(bounds.PropagateUpperBoundsFrom(result.node()));
+  XLS_ASSERT_OK(full.TightenNodeUb(result.node(), 100));
+  XLS_ASSERT_OK(full.PropagateUpperBounds());
+  for (Node* node : f->nodes()) {
+    EXPECT_EQ(bounds.ub(node), full.ub(node)) << node->GetName();
+  }
+  EXPECT_EQ(bounds.ub(not_x.node()), 99);
+}
+
 }  // namespace
 }  // namespace sched
 }  // namespace xls
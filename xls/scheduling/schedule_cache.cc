@@ -0,0 +1,136 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/scheduling/schedule_cache.h"
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/hash/hash.h"
+#include "absl/strings/str_format.h"
+#include "absl/types/span.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/node_iterator.h"
+#include "xls/ir/op.h"
+#include "xls/ir/type.h"
+
+namespace xls {
+namespace {
+
+// Returns a fingerprint of the function's structure computed over its nodes
+// in the given topological order: each node contributes its op, its type's
+// flat bit count, and the topological indices of its operands. Functions
+// with different fingerprints are never structurally identical; equal
+// fingerprints are confirmed by MatchTopoSorts.
+int64_t StructuralFingerprint(absl::Span<Node* const> topo_sort) {
+  absl::flat_hash_map<Node*, int64_t> topo_index;
+  topo_index.reserve(topo_sort.size());
+  std::vector<int64_t> values_to_hash;
+  int64_t next_index = 0;
+  for (Node* node : topo_sort) {
+    topo_index[node] = next_index++;
+    values_to_hash.push_back(static_cast<int64_t>(node->op()));
+    values_to_hash.push_back(node->GetType()->GetFlatBitCount());
+    for (Node* operand : node->operands()) {
+      values_to_hash.push_back(topo_index.at(operand));
+    }
+  }
+  return static_cast<int64_t>(
+      absl::Hash<std::vector<int64_t>>()(values_to_hash));
+}
+
+// Returns a node-by-node correspondence from `from` to `to` (both in
+// topological order) if the two functions are structurally identical:
+// position i of one order corresponds to position i of the other, with
+// matching ops, types, attributes and operand edges. Params match
+// positionally; any other side-effecting node (e.g. channel operations,
+// whose semantics are not captured by structure alone) disqualifies reuse.
+// Returns std::nullopt if the functions do not match.
+std::optional<absl::flat_hash_map<Node*, Node*>> MatchTopoSorts(
+    absl::Span<Node* const> from, absl::Span<Node* const> to) {
+  if (from.size() != to.size()) {
+    return std::nullopt;
+  }
+  absl::flat_hash_map<Node*, Node*> correspondence;
+  correspondence.reserve(from.size());
+  for (int64_t i = 0; i < from.size(); ++i) {
+    Node* a = from[i];
+    Node* b = to[i];
+    if (a->op() != b->op() || !a->GetType()->IsEqualTo(b->GetType())) {
+      return std::nullopt;
+    }
+    if (OpIsSideEffecting(a->op())) {
+      if (a->op() != Op::kParam) {
+        return std::nullopt;
+      }
+    } else if (!a->IsDefinitelyEqualTo(b)) {
+      // Covers op attributes (literal values, slice offsets, ...) beyond the
+      // op and type checked above.
+      return std::nullopt;
+    }
+    if (a->operand_count() != b->operand_count()) {
+      return std::nullopt;
+    }
+    for (int64_t j = 0; j < a->operand_count(); ++j) {
+      // Operands precede their users in a topological order, so they are
+      // already in the correspondence.
+      if (correspondence.at(a->operand(j)) != b->operand(j)) {
+        return std::nullopt;
+      }
+    }
+    if (a->function_base()->HasImplicitUse(a) !=
+        b->function_base()->HasImplicitUse(b)) {
+      return std::nullopt;
+    }
+    correspondence[a] = b;
+  }
+  return correspondence;
+}
+
+}  // namespace
+
+absl::StatusOr<PipelineSchedule> ScheduleCache::Schedule(
+    FunctionBase* f, const DelayEstimator& delay_estimator,
+    const SchedulingOptions& options) {
+  std::vector<Node*> topo_sort = TopoSort(f).AsVector();
+  int64_t fingerprint = StructuralFingerprint(topo_sort);
+  for (const Entry& entry : entries_[fingerprint]) {
+    std::optional<absl::flat_hash_map<Node*, Node*>> correspondence =
+        MatchTopoSorts(entry.topo_sort, topo_sort);
+    if (!correspondence.has_value()) {
+      continue;
+    }
+    XLS_VLOG(2) << absl::StreamFormat(
+        "Reusing schedule of structurally identical function '%s' for '%s'",
+        entry.function_base->name(), f->name());
+    ScheduleCycleMap cycle_map;
+    cycle_map.reserve(correspondence->size());
+    for (const auto& [cached_node, node] : *correspondence) {
+      cycle_map[node] = entry.schedule.cycle(cached_node);
+    }
+    PipelineSchedule schedule(f, std::move(cycle_map),
+                              options.pipeline_stages());
+    XLS_RETURN_IF_ERROR(schedule.Verify());
+    return schedule;
+  }
+  XLS_ASSIGN_OR_RETURN(PipelineSchedule schedule,
+                       PipelineSchedule::Run(f, delay_estimator, options));
+  entries_[fingerprint].push_back(
+      Entry{f, std::move(topo_sort), schedule});
+  return schedule;
+}
+
+}  // namespace xls
@@ -0,0 +1,71 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_SCHEDULING_SCHEDULE_CACHE_H_
+#define XLS_SCHEDULING_SCHEDULE_CACHE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "xls/delay_model/delay_estimator.h"
+#include "xls/ir/function_base.h"
+#include "xls/ir/node.h"
+#include "xls/scheduling/pipeline_schedule.h"
+#include "xls/scheduling/scheduling_options.h"
+
+namespace xls {
+
+// Memoizes PipelineSchedule::Run across structurally identical
+// FunctionBases. Designs which instantiate the same sub-function many times
+// (e.g. SIMD lanes) present the scheduler with the same subproblem once per
+// instance; the cache solves each unique structure once and transfers the
+// schedule to later instances via a node-by-node correspondence, so
+// scheduling time is proportional to the number of unique structures.
+//
+// A cache instance assumes every Schedule() call uses the same delay
+// estimator and scheduling options; use a separate cache per configuration.
+// The cached FunctionBases must outlive the cache.
+class ScheduleCache {
+ public:
+  ScheduleCache() = default;
+
+  // Returns a schedule for `f`. If a previously scheduled function is
+  // structurally identical to `f` its schedule is transferred (and verified)
+  // rather than re-solved; otherwise PipelineSchedule::Run is invoked and the
+  // result cached.
+  absl::StatusOr<PipelineSchedule> Schedule(
+      FunctionBase* f, const DelayEstimator& delay_estimator,
+      const SchedulingOptions& options);
+
+ private:
+  struct Entry {
+    FunctionBase* function_base;
+    // The function's nodes in topological order; used to construct the
+    // node-by-node correspondence with a structurally identical function.
+    std::vector<Node*> topo_sort;
+    PipelineSchedule schedule;
+  };
+
+  // Entries bucketed by a structural fingerprint of the function. Functions
+  // with equal fingerprints are candidates for schedule reuse; candidacy is
+  // confirmed by a full isomorphism walk (see MatchTopoSorts in the .cc
+  // file).
+  absl::flat_hash_map<int64_t, std::vector<Entry>> entries_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_SCHEDULING_SCHEDULE_CACHE_H_
@@ -0,0 +1,137 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/scheduling/schedule_cache.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xls/common/status/matchers.h"
+#include "xls/delay_model/delay_estimator.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/function.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/node.h"
+#include "xls/ir/op.h"
+#include "xls/scheduling/pipeline_schedule.h"
+#include "xls/scheduling/scheduling_options.h"
+
+namespace xls {
+namespace {
+
+class TestDelayEstimator : public DelayEstimator {
+ public:
+  TestDelayEstimator() : DelayEstimator("test") {}
+
+  absl::StatusOr<int64_t> GetOperationDelayInPs(Node* node) const override {
+    switch (node->op()) {
+      case Op::kLiteral:
+      case Op::kParam:
+        return 0;
+      default:
+        return 1;
+    }
+  }
+};
+
+class ScheduleCacheTest : public IrTestBase {
+ protected:
+  // Builds a "lane" function computing (x + y) * x named `name`.
+  absl::StatusOr<Function*> BuildLane(Package* p, absl::string_view name) {
+    FunctionBuilder fb(name, p);
+    BValue x = fb.Param("x", p->GetBitsType(32));
+    BValue y = fb.Param("y", p->GetBitsType(32));
+    return fb.Build(fb.UMul(fb.Add(x, y), x));
+  }
+};
+
+TEST_F(ScheduleCacheTest, IdenticalFunctionsShareSchedule) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * lane0, BuildLane(p.get(), "lane0"));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * lane1, BuildLane(p.get(), "lane1"));
+
+  SchedulingOptions options;
+  options.pipeline_stages(2);
+  TestDelayEstimator delay_estimator;
+  ScheduleCache cache;
+  XLS_ASSERT_OK_AND_ASSIGN(PipelineSchedule schedule0,
+                           cache.Schedule(lane0, delay_estimator, options));
+  XLS_ASSERT_OK_AND_ASSIGN(PipelineSchedule schedule1,
+                           cache.Schedule(lane1, delay_estimator, options));
+
+  // The schedules cover their own function's nodes and place corresponding
+  // nodes in the same cycle.
+  EXPECT_EQ(schedule0.function_base(), lane0);
+  EXPECT_EQ(schedule1.function_base(), lane1);
+  EXPECT_EQ(schedule0.length(), schedule1.length());
+  for (Node* node : lane1->nodes()) {
+    EXPECT_TRUE(schedule1.IsScheduled(node));
+  }
+  EXPECT_EQ(schedule0.cycle(lane0->return_value()),
+            schedule1.cycle(lane1->return_value()));
+}
+
+TEST_F(ScheduleCacheTest, DifferentStructuresScheduledSeparately) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * lane, BuildLane(p.get(), "lane"));
+
+  FunctionBuilder fb("other", p.get());
+  BValue x = fb.Param("x", p->GetBitsType(32));
+  BValue y = fb.Param("y", p->GetBitsType(32));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * other,
+                           fb.Build(fb.Subtract(fb.UMul(x, y), x)));
+
+  SchedulingOptions options;
+  options.pipeline_stages(2);
+  TestDelayEstimator delay_estimator;
+  ScheduleCache cache;
+  XLS_ASSERT_OK_AND_ASSIGN(PipelineSchedule schedule0,
+                           cache.Schedule(lane, delay_estimator, options));
+  XLS_ASSERT_OK_AND_ASSIGN(PipelineSchedule schedule1,
+                           cache.Schedule(other, delay_estimator, options));
+  XLS_ASSERT_OK(schedule0.Verify());
+  XLS_ASSERT_OK(schedule1.Verify());
+}
+
+TEST_F(ScheduleCacheTest, DifferentLiteralValuesAreNotConflated) {
+  auto p = CreatePackage();
+  FunctionBuilder fb0("f0", p.get());
+  BValue x0 = fb0.Param("x", p->GetBitsType(32));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Function * f0, fb0.Build(fb0.Add(x0, fb0.Literal(UBits(1, 32)))));
+
+  FunctionBuilder fb1("f1", p.get());
+  BValue x1 = fb1.Param("x", p->GetBitsType(32));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Function * f1, fb1.Build(fb1.Add(x1, fb1.Literal(UBits(2, 32)))));
+
+  SchedulingOptions options;
+  options.pipeline_stages(1);
+  TestDelayEstimator delay_estimator;
+  ScheduleCache cache;
+  XLS_ASSERT_OK_AND_ASSIGN(PipelineSchedule schedule0,
+                           cache.Schedule(f0, delay_estimator, options));
+  XLS_ASSERT_OK_AND_ASSIGN(PipelineSchedule schedule1,
+                           cache.Schedule(f1, delay_estimator, options));
+  // Both are valid schedules of their own function regardless of whether the
+  // literal mismatch prevented reuse.
+  XLS_ASSERT_OK(schedule0.Verify());
+  XLS_ASSERT_OK(schedule1.Verify());
+  EXPECT_TRUE(schedule1.IsScheduled(f1->return_value()));
+}
+
+}  // namespace
+}  // namespace xls
@@ -18,6 +18,9 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "xls/common/cancellation.h"
 #include "xls/delay_model/delay_estimator.h"
 #include "xls/ir/function.h"
 #include "xls/ir/function_base.h"
@@ -169,6 +172,38 @@ class SchedulingOptions {
   }
   std::optional<int32_t> seed() const { return seed_; }
 
+  // Sets/gets the time after which the scheduler gives up. The schedulers
+  // check the deadline at iteration boundaries of their expensive loops
+  // (clock-period binary search, per-cut-order min-cut, LP solves) and return
+  // a DeadlineExceededError instead of running until killed, so callers keep
+  // their diagnostics when a compile blows its budget.
+  SchedulingOptions& deadline(absl::Time value) {
+    deadline_ = value;
+    return *this;
+  }
+  std::optional<absl::Time> deadline() const { return deadline_; }
+
+  // Sets/gets an optional cooperative cancellation token checked at the same
+  // points as the deadline. Not owned; must outlive the scheduling run.
+  SchedulingOptions& cancellation(CancellationScope* scope) {
+    cancellation_ = scope;
+    return *this;
+  }
+  CancellationScope* cancellation() const { return cancellation_; }
+
+  // Returns a non-OK status if the deadline has passed or the cancellation
+  // token has fired, OkStatus otherwise. Schedulers call this at the top of
+  // their expensive loops and propagate the status out.
+  absl::Status CheckNotCancelled() const {
+    if (cancellation_ != nullptr && cancellation_->cancelled()) {
+      return absl::CancelledError("Scheduling was cancelled");
+    }
+    if (deadline_.has_value() && absl::Now() >= *deadline_) {
+      return absl::DeadlineExceededError("Scheduling deadline exceeded");
+    }
+    return absl::OkStatus();
+  }
+
  private:
   SchedulingStrategy strategy_;
   std::optional<int64_t> clock_period_ps_;
@@ -178,6 +213,8 @@ class SchedulingOptions {
   std::optional<int64_t> additional_input_delay_ps_;
   std::vector<SchedulingConstraint> constraints_;
   std::optional<int32_t> seed_;
+  std::optional<absl::Time> deadline_;
+  CancellationScope* cancellation_ = nullptr;
 };
 
 // A map from node to cycle as a bare-bones representation of a schedule.
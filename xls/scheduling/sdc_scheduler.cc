@@ -20,6 +20,7 @@
 #include <random>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/memory/memory.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
@@ -27,6 +28,7 @@
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
+#include "xls/common/tracing.h"
 #include "xls/ir/node_iterator.h"
 #include "xls/ir/node_util.h"
 #include "xls/scheduling/schedule_bounds.h"
@@ -153,82 +155,73 @@ ComputeCombinationalDelayConstraints(FunctionBase* f, int64_t clock_period_ps,
   return result;
 }
 
-class ConstraintBuilder {
- public:
-  ConstraintBuilder(FunctionBase* func, or_tools::MPSolver* solver,
-                    int64_t pipeline_length, int64_t clock_period_ps,
-                    const sched::ScheduleBounds& bounds,
-                    const DelayMap& delay_map);
-
-  absl::Status AddDefUseConstraints(Node* node, std::optional<Node*> user);
-  absl::Status AddCausalConstraint(Node* node, std::optional<Node*> user);
-  absl::Status AddLifetimeConstraint(Node* node, std::optional<Node*> user);
-  absl::Status AddTimingConstraints();
-  absl::Status AddSchedulingConstraint(const SchedulingConstraint& constraint);
-  absl::Status AddIOConstraint(const IOConstraint& constraint);
-  absl::Status AddRFSLConstraint(
-      const RecvsFirstSendsLastConstraint& constraint);
-
-  absl::Status AddObjective();
-
-  or_tools::MPSolver::ResultStatus Solve() { return solver_->Solve(); }
-
-  absl::StatusOr<ScheduleCycleMap> ExtractResult() const;
-
- private:
-  FunctionBase* func_;
-  or_tools::MPSolver* solver_;
-  int64_t pipeline_length_;
-  int64_t clock_period_ps_;
-  const DelayMap& delay_map_;
-  double infinity_;
-
-  // Node's cycle after scheduling
-  absl::flat_hash_map<Node*, or_tools::MPVariable*> cycle_var_;
-
-  // Node's lifetime, from when it finishes executing until it is consumed by
-  // the last user.
-  absl::flat_hash_map<Node*, or_tools::MPVariable*> lifetime_var_;
-
-  // A dummy node to represent an artificial sink node on the data-dependence
-  // graph.
-  or_tools::MPVariable* cycle_at_sinknode_;
-
-  // A cache of the delay constraints.
-  absl::flat_hash_map<Node*, std::vector<Node*>> delay_constraints_;
-};
-
-ConstraintBuilder::ConstraintBuilder(FunctionBase* func,
-                                     or_tools::MPSolver* solver,
-                                     int64_t pipeline_length,
-                                     int64_t clock_period_ps,
-                                     const sched::ScheduleBounds& bounds,
-                                     const DelayMap& delay_map)
-    : func_(func),
-      solver_(solver),
-      pipeline_length_(pipeline_length),
-      clock_period_ps_(clock_period_ps),
-      delay_map_(delay_map),
-      infinity_(solver->infinity()) {
+}  // namespace
+
+/* static */ absl::StatusOr<std::unique_ptr<IncrementalSDCScheduler>>
+IncrementalSDCScheduler::Create(
+    FunctionBase* f, const DelayEstimator& delay_estimator,
+    absl::Span<const SchedulingConstraint> constraints) {
+  std::unique_ptr<or_tools::MPSolver> solver(
+      or_tools::MPSolver::CreateSolver("GLOP"));
+  if (!solver) {
+    return absl::UnavailableError("GLOP solver unavailable.");
+  }
+  XLS_ASSIGN_OR_RETURN(DelayMap delay_map,
+                       ComputeNodeDelays(f, delay_estimator));
+  // Note: private constructor so not using make_unique.
+  auto scheduler = absl::WrapUnique(
+      new IncrementalSDCScheduler(f, std::move(solver), std::move(delay_map)));
+  XLS_RETURN_IF_ERROR(scheduler->BuildStaticModel(constraints));
+  return scheduler;
+}
+
+IncrementalSDCScheduler::~IncrementalSDCScheduler() = default;
+
+IncrementalSDCScheduler::IncrementalSDCScheduler(
+    FunctionBase* f, std::unique_ptr<or_tools::MPSolver> solver,
+    DelayMap delay_map)
+    : func_(f),
+      solver_(std::move(solver)),
+      delay_map_(std::move(delay_map)),
+      infinity_(solver_->infinity()) {
   for (Node* node : func_->nodes()) {
-    cycle_var_[node] =
-        solver_->MakeNumVar(bounds.lb(node), bounds.ub(node), node->GetName());
+    // The variable bounds are tightened to the attempt's schedule bounds on
+    // every Schedule call.
+    cycle_var_[node] = solver_->MakeNumVar(0.0, infinity_, node->GetName());
     lifetime_var_[node] = solver_->MakeNumVar(
         0.0, infinity_, absl::StrFormat("lifetime_%s", node->GetName()));
   }
   cycle_at_sinknode_ =
-      solver->MakeNumVar(-infinity_, infinity_, "cycle_at_sinknode");
+      solver_->MakeNumVar(-infinity_, infinity_, "cycle_at_sinknode");
+}
+
+absl::Status IncrementalSDCScheduler::BuildStaticModel(
+    absl::Span<const SchedulingConstraint> constraints) {
+  for (const SchedulingConstraint& constraint : constraints) {
+    XLS_RETURN_IF_ERROR(AddSchedulingConstraint(constraint));
+  }
+
+  for (Node* node : func_->nodes()) {
+    for (Node* user : node->users()) {
+      XLS_RETURN_IF_ERROR(AddDefUseConstraints(node, user));
+    }
+    if (func_->HasImplicitUse(node)) {
+      XLS_RETURN_IF_ERROR(AddDefUseConstraints(node, std::nullopt));
+    }
+  }
+
+  return AddObjective();
 }
 
-absl::Status ConstraintBuilder::AddDefUseConstraints(
+absl::Status IncrementalSDCScheduler::AddDefUseConstraints(
     Node* node, std::optional<Node*> user) {
   XLS_RETURN_IF_ERROR(AddCausalConstraint(node, user));
   XLS_RETURN_IF_ERROR(AddLifetimeConstraint(node, user));
   return absl::OkStatus();
 }
 
-absl::Status ConstraintBuilder::AddCausalConstraint(Node* node,
-                                                    std::optional<Node*> user) {
+absl::Status IncrementalSDCScheduler::AddCausalConstraint(
+    Node* node, std::optional<Node*> user) {
   or_tools::MPVariable* cycle_at_node = cycle_var_.at(node);
   or_tools::MPVariable* cycle_at_user =
       user.has_value() ? cycle_var_.at(user.value()) : cycle_at_sinknode_;
@@ -249,7 +242,7 @@ absl::Status ConstraintBuilder::AddCausalConstraint(Node* node,
   return absl::OkStatus();
 }
 
-absl::Status ConstraintBuilder::AddLifetimeConstraint(
+absl::Status IncrementalSDCScheduler::AddLifetimeConstraint(
     Node* node, std::optional<Node*> user) {
   or_tools::MPVariable* cycle_at_node = cycle_var_.at(node);
   or_tools::MPVariable* lifetime_at_node = lifetime_var_.at(node);
@@ -273,30 +266,7 @@ absl::Status ConstraintBuilder::AddLifetimeConstraint(
   return absl::OkStatus();
 }
 
-absl::Status ConstraintBuilder::AddTimingConstraints() {
-  if (delay_constraints_.empty()) {
-    delay_constraints_ = ComputeCombinationalDelayConstraints(
-        func_, clock_period_ps_, delay_map_);
-  }
-
-  for (Node* source : func_->nodes()) {
-    for (Node* target : delay_constraints_.at(source)) {
-      or_tools::MPConstraint* timing = solver_->MakeRowConstraint(
-          1, infinity_,
-          absl::StrFormat("timing_%s_%s", source->GetName(),
-                          target->GetName()));
-      timing->SetCoefficient(cycle_var_.at(target), 1);
-      timing->SetCoefficient(cycle_var_.at(source), -1);
-      XLS_VLOG(2) << "Setting timing constraint: "
-                  << absl::StrFormat("1 ≤ %s - %s", target->GetName(),
-                                     source->GetName());
-    }
-  }
-
-  return absl::OkStatus();
-}
-
-absl::Status ConstraintBuilder::AddSchedulingConstraint(
+absl::Status IncrementalSDCScheduler::AddSchedulingConstraint(
     const SchedulingConstraint& constraint) {
   if (std::holds_alternative<IOConstraint>(constraint)) {
     return AddIOConstraint(std::get<IOConstraint>(constraint));
@@ -308,7 +278,7 @@ absl::Status ConstraintBuilder::AddSchedulingConstraint(
   return absl::InternalError("Unhandled scheduling constraint type");
 }
 
-absl::Status ConstraintBuilder::AddIOConstraint(
+absl::Status IncrementalSDCScheduler::AddIOConstraint(
     const IOConstraint& constraint) {
   // Map from channel name to set of nodes that send/receive on that channel.
   absl::flat_hash_map<std::string, std::vector<Node*>> channel_to_nodes;
@@ -370,7 +340,7 @@ absl::Status ConstraintBuilder::AddIOConstraint(
   return absl::OkStatus();
 }
 
-absl::Status ConstraintBuilder::AddRFSLConstraint(
+absl::Status IncrementalSDCScheduler::AddRFSLConstraint(
     const RecvsFirstSendsLastConstraint& constraint) {
   for (Node* node : func_->nodes()) {
     if (node->Is<Receive>()) {
@@ -382,21 +352,22 @@ absl::Status ConstraintBuilder::AddRFSLConstraint(
                   << absl::StrFormat("cycle[%s] ≤ 0", node->GetName());
     }
     if (node->Is<Send>()) {
+      // The real bound is -(pipeline_length - 1) which isn't known until
+      // Schedule is called, so start unconstrained and tighten per attempt.
       or_tools::MPConstraint* send_constraint = solver_->MakeRowConstraint(
-          -infinity_, -(pipeline_length_ - 1),
-          absl::StrFormat("send_%s", node->GetName()));
+          -infinity_, infinity_, absl::StrFormat("send_%s", node->GetName()));
       send_constraint->SetCoefficient(cycle_var_.at(node), -1);
+      send_last_constraints_.push_back(send_constraint);
 
-      XLS_VLOG(2) << "Setting send-in-last-cycle constraint: "
-                  << absl::StrFormat("%d ≤ cycle[%s]", pipeline_length_ - 1,
-                                     node->GetName());
+      XLS_VLOG(2) << "Adding send-in-last-cycle constraint for: "
+                  << node->GetName();
     }
   }
 
   return absl::OkStatus();
 }
 
-absl::Status ConstraintBuilder::AddObjective() {
+absl::Status IncrementalSDCScheduler::AddObjective() {
   or_tools::MPObjective* objective = solver_->MutableObjective();
   for (Node* node : func_->nodes()) {
     // This acts as a tie-breaker for underconstrained problems.
@@ -411,7 +382,75 @@ absl::Status ConstraintBuilder::AddObjective() {
   return absl::OkStatus();
 }
 
-absl::StatusOr<ScheduleCycleMap> ConstraintBuilder::ExtractResult() const {
+absl::Status IncrementalSDCScheduler::UpdateTimingConstraints(
+    int64_t clock_period_ps) {
+  auto it = delay_constraints_cache_.find(clock_period_ps);
+  if (it == delay_constraints_cache_.end()) {
+    it = delay_constraints_cache_
+             .emplace(clock_period_ps, ComputeCombinationalDelayConstraints(
+                                           func_, clock_period_ps, delay_map_))
+             .first;
+  }
+  const absl::flat_hash_map<Node*, std::vector<Node*>>& delay_constraints =
+      it->second;
+
+  // Constraints from a previous clock period are relaxed into no-ops and
+  // re-tightened below if they are active for this period as well.
+  for (auto& [nodes, constraint] : timing_constraints_) {
+    constraint->SetBounds(-infinity_, infinity_);
+  }
+
+  for (Node* source : func_->nodes()) {
+    for (Node* target : delay_constraints.at(source)) {
+      auto [entry, inserted] =
+          timing_constraints_.emplace(std::make_pair(source, target), nullptr);
+      if (inserted) {
+        entry->second = solver_->MakeRowConstraint(
+            1, infinity_,
+            absl::StrFormat("timing_%s_%s", source->GetName(),
+                            target->GetName()));
+        entry->second->SetCoefficient(cycle_var_.at(target), 1);
+        entry->second->SetCoefficient(cycle_var_.at(source), -1);
+      } else {
+        entry->second->SetBounds(1, infinity_);
+      }
+      XLS_VLOG(2) << "Setting timing constraint: "
+                  << absl::StrFormat("1 ≤ %s - %s", target->GetName(),
+                                     source->GetName());
+    }
+  }
+
+  return absl::OkStatus();
+}
+
+absl::StatusOr<ScheduleCycleMap> IncrementalSDCScheduler::Schedule(
+    int64_t pipeline_stages, int64_t clock_period_ps,
+    const sched::ScheduleBounds& bounds) {
+  for (Node* node : func_->nodes()) {
+    cycle_var_.at(node)->SetBounds(bounds.lb(node), bounds.ub(node));
+  }
+
+  for (or_tools::MPConstraint* send_constraint : send_last_constraints_) {
+    send_constraint->SetBounds(
+        -infinity_, -static_cast<double>(pipeline_stages - 1));
+    XLS_VLOG(2) << "Setting send-in-last-cycle constraint bound: "
+                << pipeline_stages - 1;
+  }
+
+  XLS_RETURN_IF_ERROR(UpdateTimingConstraints(clock_period_ps));
+
+  or_tools::MPSolver::ResultStatus status = solver_->Solve();
+
+  if (status != or_tools::MPSolver::OPTIMAL) {
+    XLS_VLOG(1) << "ScheduleToMinimizeRegistersSDC failed with " << status;
+    return absl::InternalError("The problem does not have an optimal solution");
+  }
+
+  return ExtractResult();
+}
+
+absl::StatusOr<ScheduleCycleMap> IncrementalSDCScheduler::ExtractResult()
+    const {
   ScheduleCycleMap cycle_map;
   for (Node* node : func_->nodes()) {
     double cycle = cycle_var_.at(node)->solution_value();
@@ -424,8 +463,6 @@ absl::StatusOr<ScheduleCycleMap> ConstraintBuilder::ExtractResult() const {
   return cycle_map;
 }
 
-}  // namespace
-
 // Schedule to minimize the total pipeline registers using SDC scheduling
 // the constraint matrix is totally unimodular, this ILP problem can be solved
 // by LP.
@@ -440,51 +477,28 @@ absl::StatusOr<ScheduleCycleMap> ConstraintBuilder::ExtractResult() const {
 absl::StatusOr<ScheduleCycleMap> SDCScheduler(
     FunctionBase* f, int64_t pipeline_stages, int64_t clock_period_ps,
     const DelayEstimator& delay_estimator, sched::ScheduleBounds* bounds,
-    absl::Span<const SchedulingConstraint> constraints) {
+    absl::Span<const SchedulingConstraint> constraints,
+    const SchedulingOptions* options) {
   XLS_VLOG(3) << "SDCScheduler()";
+  ScopedTraceEvent trace_event("SDCScheduler");
   XLS_VLOG(3) << "  pipeline stages = " << pipeline_stages;
   XLS_VLOG_LINES(4, f->DumpIr());
 
   XLS_VLOG(4) << "Initial bounds:";
   XLS_VLOG_LINES(4, bounds->ToString());
 
-  std::unique_ptr<or_tools::MPSolver> solver(
-      or_tools::MPSolver::CreateSolver("GLOP"));
-  if (!solver) {
-    return absl::UnavailableError("GLOP solver unavailable.");
-  }
-
-  XLS_ASSIGN_OR_RETURN(DelayMap delay_map,
-                       ComputeNodeDelays(f, delay_estimator));
-
-  ConstraintBuilder builder(f, solver.get(), pipeline_stages, clock_period_ps,
-                            *bounds, delay_map);
-
-  for (const SchedulingConstraint& constraint : constraints) {
-    XLS_RETURN_IF_ERROR(builder.AddSchedulingConstraint(constraint));
-  }
-
-  for (Node* node : f->nodes()) {
-    for (Node* user : node->users()) {
-      XLS_RETURN_IF_ERROR(builder.AddDefUseConstraints(node, user));
-    }
-    if (f->HasImplicitUse(node)) {
-      XLS_RETURN_IF_ERROR(builder.AddDefUseConstraints(node, std::nullopt));
-    }
+  // The LP build and the solve each dominate for large functions; check the
+  // budget before committing to either.
+  if (options != nullptr) {
+    XLS_RETURN_IF_ERROR(options->CheckNotCancelled());
   }
-
-  XLS_RETURN_IF_ERROR(builder.AddTimingConstraints());
-
-  XLS_RETURN_IF_ERROR(builder.AddObjective());
-
-  or_tools::MPSolver::ResultStatus status = builder.Solve();
-
-  if (status != or_tools::MPSolver::OPTIMAL) {
-    XLS_VLOG(1) << "ScheduleToMinimizeRegistersSDC failed with " << status;
-    return absl::InternalError("The problem does not have an optimal solution");
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<IncrementalSDCScheduler> scheduler,
+      IncrementalSDCScheduler::Create(f, delay_estimator, constraints));
+  if (options != nullptr) {
+    XLS_RETURN_IF_ERROR(options->CheckNotCancelled());
   }
-
-  return builder.ExtractResult();
+  return scheduler->Schedule(pipeline_stages, clock_period_ps, *bounds);
 }
 
 }  // namespace xls
@@ -15,6 +15,11 @@
 #ifndef XLS_SCHEDULING_SDC_SCHEDULER_H_
 #define XLS_SCHEDULING_SDC_SCHEDULER_H_
 
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -25,8 +30,104 @@
 #include "xls/scheduling/schedule_bounds.h"
 #include "xls/scheduling/scheduling_options.h"
 
+namespace operations_research {
+class MPConstraint;
+class MPSolver;
+class MPVariable;
+}  // namespace operations_research
+
 namespace xls {
 
+// Stateful SDC scheduler which keeps the underlying LP solver alive across
+// schedule attempts for a single FunctionBase, so parameter sweeps (e.g. over
+// clock_period_ps or pipeline_stages) re-solve a warm problem instead of
+// rebuilding and re-factorizing the difference-constraint system from scratch
+// for each point.
+//
+// The parameter-independent portion of the LP -- cycle/lifetime variables,
+// def-use causality and lifetime constraints, user-provided scheduling
+// constraints and the register-minimization objective -- is constructed once
+// in Create. Each Schedule call only updates variable bounds and the
+// clock-period-dependent timing constraints in place; since the solver is
+// incremental, each solve starts from the basis of the previous solution.
+class IncrementalSDCScheduler {
+ public:
+  // Builds the parameter-independent portion of the scheduling LP for `f`.
+  // Returns an error if the underlying GLOP solver is unavailable.
+  static absl::StatusOr<std::unique_ptr<IncrementalSDCScheduler>> Create(
+      FunctionBase* f, const DelayEstimator& delay_estimator,
+      absl::Span<const SchedulingConstraint> constraints);
+
+  ~IncrementalSDCScheduler();
+
+  // Schedules the function with the given pipeline length and clock period;
+  // `bounds` supplies the per-node lower/upper cycle bounds for this attempt.
+  // May be called repeatedly with different parameters.
+  absl::StatusOr<ScheduleCycleMap> Schedule(
+      int64_t pipeline_stages, int64_t clock_period_ps,
+      const sched::ScheduleBounds& bounds);
+
+ private:
+  using DelayMap = absl::flat_hash_map<Node*, int64_t>;
+
+  IncrementalSDCScheduler(
+      FunctionBase* f, std::unique_ptr<operations_research::MPSolver> solver,
+      DelayMap delay_map);
+
+  // Adds the parameter-independent constraints and the objective; see class
+  // comment.
+  absl::Status BuildStaticModel(
+      absl::Span<const SchedulingConstraint> constraints);
+
+  absl::Status AddDefUseConstraints(Node* node, std::optional<Node*> user);
+  absl::Status AddCausalConstraint(Node* node, std::optional<Node*> user);
+  absl::Status AddLifetimeConstraint(Node* node, std::optional<Node*> user);
+  absl::Status AddSchedulingConstraint(const SchedulingConstraint& constraint);
+  absl::Status AddIOConstraint(const IOConstraint& constraint);
+  absl::Status AddRFSLConstraint(
+      const RecvsFirstSendsLastConstraint& constraint);
+  absl::Status AddObjective();
+
+  // Activates the timing constraints for `clock_period_ps`, relaxing any
+  // constraints left over from a previous clock period into no-ops (the
+  // solver does not support removing constraints).
+  absl::Status UpdateTimingConstraints(int64_t clock_period_ps);
+
+  absl::StatusOr<ScheduleCycleMap> ExtractResult() const;
+
+  FunctionBase* func_;
+  std::unique_ptr<operations_research::MPSolver> solver_;
+  DelayMap delay_map_;
+  double infinity_;
+
+  // Node's cycle after scheduling
+  absl::flat_hash_map<Node*, operations_research::MPVariable*> cycle_var_;
+
+  // Node's lifetime, from when it finishes executing until it is consumed by
+  // the last user.
+  absl::flat_hash_map<Node*, operations_research::MPVariable*> lifetime_var_;
+
+  // A dummy node to represent an artificial sink node on the data-dependence
+  // graph.
+  operations_research::MPVariable* cycle_at_sinknode_;
+
+  // Send-in-last-cycle constraints whose bound depends on the pipeline
+  // length; updated on every Schedule call.
+  std::vector<operations_research::MPConstraint*> send_last_constraints_;
+
+  // Timing constraints created so far, keyed by (source, target) node pair.
+  // Entries not active for the current clock period are relaxed into no-ops.
+  absl::flat_hash_map<std::pair<Node*, Node*>,
+                      operations_research::MPConstraint*>
+      timing_constraints_;
+
+  // Memoized combinational delay constraints, keyed by clock period, so
+  // sweeps that revisit a period skip the all-pairs distance computation.
+  absl::flat_hash_map<int64_t,
+                      absl::flat_hash_map<Node*, std::vector<Node*>>>
+      delay_constraints_cache_;
+};
+
 // Schedule to minimize the total pipeline registers using SDC scheduling
 // the constraint matrix is totally unimodular, this ILP problem can be solved
 // by LP.
@@ -38,10 +139,15 @@ namespace xls {
 //   - Zhang, Zhiru, and Bin Liu. "SDC-based modulo scheduling for pipeline
 //   synthesis." 2013 IEEE/ACM International Conference on Computer-Aided Design
 //   (ICCAD). IEEE, 2013.
+//
+// If `options` is non-null its deadline/cancellation token is checked before
+// building the LP and before solving it (see
+// SchedulingOptions::CheckNotCancelled).
 absl::StatusOr<ScheduleCycleMap> SDCScheduler(
     FunctionBase* f, int64_t pipeline_stages, int64_t clock_period_ps,
     const DelayEstimator& delay_estimator, sched::ScheduleBounds* bounds,
-    absl::Span<const SchedulingConstraint> constraints);
+    absl::Span<const SchedulingConstraint> constraints,
+    const SchedulingOptions* options = nullptr);
 
 }  // namespace xls
 
@@ -14,12 +14,15 @@
 
 #include "xls/simulation/module_simulator.h"
 
+#include <filesystem>
+
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "xls/codegen/flattening.h"
+#include "xls/common/file/temp_directory.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/logging/vlog_is_on.h"
 #include "xls/common/status/ret_check.h"
@@ -40,6 +43,11 @@ ModuleSimulator::BitsMap ValueMapToBitsMap(
   return outputs;
 }
 
+// Batches at least this large are run by streaming columnar per-port
+// stimulus/response files through the testbench (see RunBatchedStreaming)
+// rather than generating per-sample testbench statements.
+constexpr int64_t kStreamingBatchThreshold = 256;
+
 }  // namespace
 
 absl::Status ModuleSimulator::DeassertControlSignals(
@@ -119,6 +127,20 @@ ModuleSimulator::RunBatched(absl::Span<const BitsMap> inputs) const {
     return absl::InvalidArgumentError("Expected clock in signature");
   }
 
+  // Large batches of pipelined or combinational modules stream their data
+  // through columnar per-port files, keeping testbench size and simulator
+  // output independent of batch size. The scripted path below is kept for
+  // small batches (it additionally checks the output_valid signal each cycle)
+  // and for interfaces with per-sample flow control.
+  if (inputs.size() >= kStreamingBatchThreshold &&
+      (signature_.proto().has_pipeline() ||
+       signature_.proto().has_combinational())) {
+    const int64_t latency = signature_.proto().has_pipeline()
+                                ? signature_.proto().pipeline().latency()
+                                : 0;
+    return RunBatchedStreaming(inputs, latency);
+  }
+
   ModuleTestbench tb(verilog_text_, signature_, simulator_, includes_);
 
   // Drive any control signals to an unasserted state so the all control inputs
@@ -279,6 +301,93 @@ ModuleSimulator::RunBatched(absl::Span<const BitsMap> inputs) const {
   return outputs;
 }
 
+absl::StatusOr<std::vector<ModuleSimulator::BitsMap>>
+ModuleSimulator::RunBatchedStreaming(absl::Span<const BitsMap> inputs,
+                                     int64_t latency) const {
+  const int64_t sample_count = inputs.size();
+  XLS_ASSIGN_OR_RETURN(TempDirectory stream_dir, TempDirectory::Create());
+
+  ModuleTestbench tb(verilog_text_, signature_, simulator_, includes_);
+  XLS_RETURN_IF_ERROR(DeassertControlSignals(&tb));
+  XLS_RETURN_IF_ERROR(ResetModule(&tb));
+
+  std::optional<PipelineControl> pipeline_control;
+  if (signature_.proto().has_pipeline() &&
+      signature_.proto().pipeline().has_pipeline_control()) {
+    pipeline_control = signature_.proto().pipeline().pipeline_control();
+  }
+  if (pipeline_control.has_value() && pipeline_control->has_manual()) {
+    // Drive the pipeline register load-enable signals high.
+    tb.Set(pipeline_control->manual().input_name(),
+           Bits::AllOnes(signature_.proto().pipeline().latency()));
+  }
+
+  // Write one stimulus column per data input and register it as a stream.
+  std::vector<Bits> column(sample_count);
+  for (const PortProto& input : signature_.data_inputs()) {
+    if (input.width() == 0) {
+      continue;
+    }
+    for (int64_t i = 0; i < sample_count; ++i) {
+      column[i] = inputs[i].at(input.name());
+    }
+    std::filesystem::path path =
+        stream_dir.path() / absl::StrCat(input.name(), ".stimulus");
+    XLS_RETURN_IF_ERROR(
+        ModuleTestbench::WriteStimulusFile(path, column, input.width()));
+    tb.StreamInputFromFile(input.name(), path.string(), sample_count);
+  }
+  if (pipeline_control.has_value() && pipeline_control->has_valid()) {
+    // Stream the valid input as a column of ones so it is asserted exactly
+    // while samples are being driven. Unlike the scripted path, the streamed
+    // path does not check the output_valid signal each cycle.
+    std::vector<Bits> valid_column(sample_count, UBits(1, 1));
+    std::filesystem::path path =
+        stream_dir.path() /
+        absl::StrCat(pipeline_control->valid().input_name(), ".stimulus");
+    XLS_RETURN_IF_ERROR(
+        ModuleTestbench::WriteStimulusFile(path, valid_column, /*width=*/1));
+    tb.StreamInputFromFile(pipeline_control->valid().input_name(),
+                           path.string(), sample_count);
+  }
+
+  // Register one response column per data output.
+  std::vector<std::pair<const PortProto*, std::filesystem::path>>
+      response_files;
+  for (const PortProto& output : signature_.data_outputs()) {
+    if (output.width() == 0) {
+      continue;
+    }
+    std::filesystem::path path =
+        stream_dir.path() / absl::StrCat(output.name(), ".response");
+    tb.StreamOutputToFile(output.name(), path.string(), sample_count, latency);
+    response_files.push_back({&output, path});
+  }
+  tb.RunStreams();
+
+  XLS_RETURN_IF_ERROR(tb.Run());
+
+  std::vector<BitsMap> outputs(sample_count);
+  for (const auto& pair : response_files) {
+    XLS_ASSIGN_OR_RETURN(std::vector<Bits> response_column,
+                         ModuleTestbench::ReadResponseFile(
+                             pair.second, pair.first->width(), sample_count));
+    for (int64_t i = 0; i < sample_count; ++i) {
+      outputs[i][pair.first->name()] = std::move(response_column[i]);
+    }
+  }
+  // Zero-width outputs have no actual port to capture; as in the scripted
+  // path they appear in the result as empty Bits values.
+  for (const PortProto& output : signature_.data_outputs()) {
+    if (output.width() == 0) {
+      for (BitsMap& output_map : outputs) {
+        output_map[output.name()] = Bits();
+      }
+    }
+  }
+  return outputs;
+}
+
 absl::StatusOr<Value> ModuleSimulator::Run(
     const absl::flat_hash_map<std::string, Value>& inputs) const {
   absl::flat_hash_map<std::string, Value> input_map(inputs.begin(),
@@ -70,6 +70,14 @@ class ModuleSimulator {
   absl::StatusOr<Value> Run(absl::Span<const Value> inputs) const;
 
  private:
+  // Runs the given batch by streaming columnar per-port stimulus/response
+  // files through the testbench rather than generating per-sample testbench
+  // statements. Used for large batches of modules with pipeline or
+  // combinational interfaces; latency is the cycle offset between driving a
+  // sample and capturing its outputs.
+  absl::StatusOr<std::vector<BitsMap>> RunBatchedStreaming(
+      absl::Span<const BitsMap> inputs, int64_t latency) const;
+
   // Deassert all control inputs on the module.
   absl::Status DeassertControlSignals(ModuleTestbench* tb) const;
 
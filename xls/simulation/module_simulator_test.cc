@@ -174,6 +174,30 @@ TEST_P(ModuleSimulatorTest, CombinationalBatched) {
   EXPECT_THAT(outputs[2], ElementsAre(Pair("out", UBits(100, 8))));
 }
 
+TEST_P(ModuleSimulatorTest, CombinationalLargeBatchStreamed) {
+  // A batch this large is run via the columnar streaming path rather than
+  // per-sample testbench statements.
+  XLS_ASSERT_OK_AND_ASSIGN(auto verilog_signature, MakeCombinationalModule());
+  ModuleSimulator simulator(verilog_signature.second, verilog_signature.first,
+                            GetSimulator());
+
+  std::vector<ModuleSimulator::BitsMap> inputs;
+  for (int64_t i = 0; i < 300; ++i) {
+    inputs.push_back(
+        {{"x", UBits(i % 256, 8)}, {"y", UBits((i / 2) % 256, 8)}});
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<ModuleSimulator::BitsMap> outputs,
+                           simulator.RunBatched(inputs));
+
+  ASSERT_EQ(outputs.size(), inputs.size());
+  for (int64_t i = 0; i < 300; ++i) {
+    EXPECT_THAT(outputs[i],
+                ElementsAre(Pair(
+                    "out", UBits((i % 256 - (i / 2) % 256 + 256) % 256, 8))))
+        << "sample " << i;
+  }
+}
+
 TEST_P(ModuleSimulatorTest, MultipleOutputs) {
   const std::string text = R"(
 module delay_3(
@@ -14,9 +14,13 @@
 
 #include "xls/simulation/module_testbench.h"
 
+#include <algorithm>
 #include <optional>
 
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_replace.h"
+#include "absl/strings/str_split.h"
+#include "xls/common/file/filesystem.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
@@ -230,6 +234,84 @@ ModuleTestbench& ModuleTestbench::Capture(absl::string_view output_port,
   return *this;
 }
 
+ModuleTestbench& ModuleTestbench::StreamInputFromFile(
+    absl::string_view input_port, absl::string_view path,
+    int64_t sample_count) {
+  CheckIsInput(input_port);
+  XLS_CHECK_GT(GetPortWidth(input_port), 0);
+  XLS_CHECK_GT(sample_count, 0);
+  input_streams_.push_back(
+      InputStream{std::string(input_port), std::string(path), sample_count});
+  return *this;
+}
+
+ModuleTestbench& ModuleTestbench::StreamOutputToFile(
+    absl::string_view output_port, absl::string_view path,
+    int64_t sample_count, int64_t latency) {
+  CheckIsOutput(output_port);
+  XLS_CHECK_GT(GetPortWidth(output_port), 0);
+  XLS_CHECK_GT(sample_count, 0);
+  XLS_CHECK_GE(latency, 0);
+  output_streams_.push_back(OutputStream{std::string(output_port),
+                                         std::string(path), sample_count,
+                                         latency});
+  return *this;
+}
+
+ModuleTestbench& ModuleTestbench::RunStreams() {
+  XLS_CHECK(!streams_started_) << "RunStreams may only be called once.";
+  XLS_CHECK(!input_streams_.empty() || !output_streams_.empty())
+      << "RunStreams called without any registered streams.";
+  streams_started_ = true;
+  actions_.push_back(StartStreams{});
+  return *this;
+}
+
+/* static */ absl::Status ModuleTestbench::WriteStimulusFile(
+    const std::filesystem::path& path, absl::Span<const Bits> samples,
+    int64_t width) {
+  XLS_RET_CHECK_GT(width, 0);
+  std::string contents;
+  contents.reserve(samples.size() * ((width + 3) / 4 + 1));
+  for (const Bits& sample : samples) {
+    XLS_RET_CHECK_EQ(sample.bit_count(), width);
+    // Strip the '_' separators ToRawDigits inserts; $readmemh records are
+    // then exactly one hex digit per four bits.
+    absl::StrAppend(
+        &contents,
+        absl::StrReplaceAll(sample.ToRawDigits(FormatPreference::kHex,
+                                               /*emit_leading_zeros=*/true),
+                            {{"_", ""}}),
+        "\n");
+  }
+  return SetFileContents(path, contents);
+}
+
+/* static */ absl::StatusOr<std::vector<Bits>>
+ModuleTestbench::ReadResponseFile(const std::filesystem::path& path,
+                                  int64_t width, int64_t sample_count) {
+  XLS_ASSIGN_OR_RETURN(std::string contents, GetFileContents(path));
+  std::vector<Bits> samples;
+  samples.reserve(sample_count);
+  for (absl::string_view line :
+       absl::StrSplit(contents, '\n', absl::SkipWhitespace())) {
+    if (absl::StrContains(line, "x") || absl::StrContains(line, "X")) {
+      return absl::FailedPreconditionError(
+          absl::StrFormat("Streamed output record %d in %s holds X value: %s",
+                          samples.size(), path.string(), line));
+    }
+    XLS_ASSIGN_OR_RETURN(
+        Bits value,
+        ParseUnsignedNumberWithoutPrefix(line, FormatPreference::kHex));
+    XLS_RET_CHECK_GE(width, value.bit_count());
+    samples.push_back(bits_ops::ZeroExtend(value, width));
+  }
+  XLS_RET_CHECK_EQ(samples.size(), sample_count) << absl::StreamFormat(
+      "Expected %d records in streamed output file %s", sample_count,
+      path.string());
+  return samples;
+}
+
 absl::Status ModuleTestbench::CheckOutput(absl::string_view stdout_str) const {
   // Check for timeout.
   if (absl::StrContains(stdout_str, GetTimeoutMessage())) {
@@ -414,6 +496,109 @@ absl::Status ModuleTestbench::Run() {
                                           file.LogicalNot(clk, SourceInfo()))));
   }
 
+  // Total number of cycles the streams (if any) need to run to completion
+  // once started.
+  int64_t stream_cycle_count = 0;
+  for (const InputStream& stream : input_streams_) {
+    stream_cycle_count = std::max(stream_cycle_count, stream.sample_count);
+  }
+  for (const OutputStream& stream : output_streams_) {
+    stream_cycle_count =
+        std::max(stream_cycle_count, stream.latency + stream.sample_count);
+  }
+
+  // Generate the streaming logic: a go signal and cycle counter, one
+  // $readmemh-loaded memory per input stream and one $fopen'd file per output
+  // stream, and an always block which drives/captures one sample per cycle
+  // while the streams are running. Declare all regs before the blocks which
+  // reference them.
+  LogicRef* stream_go = nullptr;
+  std::vector<LogicRef*> output_stream_fds;
+  if (!input_streams_.empty() || !output_streams_.empty()) {
+    stream_go = m->AddReg("__stream_go", file.ScalarType(SourceInfo()),
+                          SourceInfo(), file.PlainLiteral(0, SourceInfo()));
+    LogicRef* stream_cycle =
+        m->AddReg("__stream_cycle", file.BitVectorType(32, SourceInfo()),
+                  SourceInfo(), file.PlainLiteral(0, SourceInfo()));
+
+    std::vector<LogicRef*> input_stream_mems;
+    for (const InputStream& stream : input_streams_) {
+      LogicRef* mem =
+          m->AddReg(absl::StrCat("__stream_mem_", stream.port),
+                    file.UnpackedArrayType(GetPortWidth(stream.port),
+                                           {stream.sample_count}, SourceInfo()),
+                    SourceInfo());
+      input_stream_mems.push_back(mem);
+      Initial* readmem = m->Add<Initial>(SourceInfo());
+      readmem->statements()->Add<SystemTaskCall>(
+          SourceInfo(), "readmemh",
+          std::vector<Expression*>{
+              file.Make<QuotedString>(SourceInfo(), stream.path), mem});
+    }
+    for (const OutputStream& stream : output_streams_) {
+      LogicRef* fd = m->AddReg(absl::StrCat("__stream_fd_", stream.port),
+                               file.BitVectorType(32, SourceInfo()),
+                               SourceInfo());
+      output_stream_fds.push_back(fd);
+      Initial* fopen = m->Add<Initial>(SourceInfo());
+      fopen->statements()->Add<BlockingAssignment>(
+          SourceInfo(), fd,
+          file.Make<SystemFunctionCall>(
+              SourceInfo(), "fopen",
+              std::vector<Expression*>{
+                  file.Make<QuotedString>(SourceInfo(), stream.path),
+                  file.Make<QuotedString>(SourceInfo(), "w")}));
+    }
+
+    // As with the scripted actions, all stream activity occurs at the falling
+    // edge of the clock.
+    std::vector<SensitivityListElement> sensitivity_list = {
+        file.Make<NegEdge>(SourceInfo(), clk)};
+    Always* always = m->Add<Always>(SourceInfo(), sensitivity_list);
+    Conditional* go_conditional =
+        always->statements()->Add<Conditional>(SourceInfo(), stream_go);
+    StatementBlock* go_block = go_conditional->consequent();
+    go_block->Add<NonblockingAssignment>(
+        SourceInfo(), stream_cycle,
+        file.Add(stream_cycle, file.PlainLiteral(1, SourceInfo()),
+                 SourceInfo()));
+    for (int64_t i = 0; i < input_streams_.size(); ++i) {
+      const InputStream& stream = input_streams_[i];
+      Conditional* conditional = go_block->Add<Conditional>(
+          SourceInfo(),
+          file.LessThan(stream_cycle,
+                        file.PlainLiteral(stream.sample_count, SourceInfo()),
+                        SourceInfo()));
+      conditional->consequent()->Add<NonblockingAssignment>(
+          SourceInfo(), port_refs.at(stream.port),
+          file.Index(input_stream_mems[i], stream_cycle, SourceInfo()));
+    }
+    for (int64_t i = 0; i < output_streams_.size(); ++i) {
+      const OutputStream& stream = output_streams_[i];
+      // Use $fstrobe rather than $fdisplay so the output port is sampled
+      // after all assignments in the simulator time slot, as DisplayOutput
+      // does with $strobe.
+      Conditional* conditional = go_block->Add<Conditional>(
+          SourceInfo(),
+          file.LogicalAnd(
+              file.GreaterThanEquals(
+                  stream_cycle, file.PlainLiteral(stream.latency, SourceInfo()),
+                  SourceInfo()),
+              file.LessThan(stream_cycle,
+                            file.PlainLiteral(
+                                stream.latency + stream.sample_count,
+                                SourceInfo()),
+                            SourceInfo()),
+              SourceInfo()));
+      conditional->consequent()->Add<SystemTaskCall>(
+          SourceInfo(), "fstrobe",
+          std::vector<Expression*>{
+              output_stream_fds[i],
+              file.Make<QuotedString>(SourceInfo(), "%h"),
+              port_refs.at(stream.port)});
+    }
+  }
+
   // Insert statements into statement block which delay the simulation for the
   // given number of cycles. Regardless of delay, simulation resumes on the
   // falling edge of the clock.
@@ -431,17 +616,22 @@ absl::Status ModuleTestbench::Run() {
                                        file.Make<NegEdge>(SourceInfo(), clk));
   };
   {
-    // Add a watchdog which stops the simulation after a long time.
+    // Add a watchdog which stops the simulation after a long time. The limit
+    // is extended by the stream length as streamed batches may legitimately
+    // run for far more cycles than scripted actions do.
     Initial* initial = m->Add<Initial>(SourceInfo());
-    wait_n_cycles(initial->statements(), kSimulationCycleLimit);
+    wait_n_cycles(initial->statements(),
+                  kSimulationCycleLimit + stream_cycle_count);
     initial->statements()->Add<Display>(
         SourceInfo(), std::vector<Expression*>{file.Make<QuotedString>(
                           SourceInfo(), GetTimeoutMessage())});
     initial->statements()->Add<Finish>(SourceInfo());
   }
 
-  {
-    // Add a monitor statement which prints out all the port values.
+  // Add a monitor statement which prints out all the port values. Skip it
+  // when streams are registered: streamed batches can run for very many
+  // cycles and the per-cycle monitor output would dwarf the streamed data.
+  if (input_streams_.empty() && output_streams_.empty()) {
     Initial* initial = m->Add<Initial>(SourceInfo());
     initial->statements()->Add<Display>(
         SourceInfo(),
@@ -524,6 +714,19 @@ absl::Status ModuleTestbench::Run() {
                                           c.instance)),
                       file.Make<SystemFunctionCall>(SourceInfo(), "time"),
                       port_refs.at(c.port)});
+            },
+            [&](const StartStreams&) {
+              // Start the streams at the next falling clock edge and wait for
+              // all of them to complete. Two extra cycles: one for the always
+              // block to observe __stream_go, and one so the final $fstrobe
+              // executes before the files are closed.
+              initial->statements()->Add<NonblockingAssignment>(
+                  SourceInfo(), stream_go, file.PlainLiteral(1, SourceInfo()));
+              wait_n_cycles(initial->statements(), stream_cycle_count + 2);
+              for (LogicRef* fd : output_stream_fds) {
+                initial->statements()->Add<SystemTaskCall>(
+                    SourceInfo(), "fclose", std::vector<Expression*>{fd});
+              }
             }},
         action);
   }
@@ -16,11 +16,13 @@
 #define XLS_CODEGEN_MODULE_TESTBENCH_H_
 
 #include <cstdint>
+#include <filesystem>
 #include <list>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/variant.h"
 #include "xls/codegen/module_signature.h"
@@ -99,6 +101,41 @@ class ModuleTestbench {
       absl::string_view output_port,
       xabsl::SourceLocation loc = xabsl::SourceLocation::current());
 
+  // Streams a column of input samples into the given input port, one sample
+  // per cycle, starting when RunStreams() executes. The samples are read by
+  // the generated testbench from the file at the given path which must hold
+  // sample_count fixed-width hexadecimal records, one per line, as written by
+  // WriteStimulusFile(). Streaming avoids the per-sample testbench statements
+  // generated by Set() which makes large (e.g. 100k sample) batches practical.
+  ModuleTestbench& StreamInputFromFile(absl::string_view input_port,
+                                       absl::string_view path,
+                                       int64_t sample_count);
+
+  // Captures sample_count values of the given output port into the file at
+  // the given path, one fixed-width hexadecimal record per line. Capture of
+  // the first sample begins latency cycles after RunStreams() starts the
+  // streams; one sample is captured per cycle thereafter. The resulting file
+  // can be parsed with ReadResponseFile().
+  ModuleTestbench& StreamOutputToFile(absl::string_view output_port,
+                                      absl::string_view path,
+                                      int64_t sample_count, int64_t latency);
+
+  // Starts all registered streams and advances the simulation until every
+  // stream has completed. May only be called once.
+  ModuleTestbench& RunStreams();
+
+  // Writes the given samples in the fixed-width hexadecimal record format
+  // consumed by StreamInputFromFile(). Each sample must have the given width.
+  static absl::Status WriteStimulusFile(const std::filesystem::path& path,
+                                        absl::Span<const Bits> samples,
+                                        int64_t width);
+
+  // Parses a file written by a StreamOutputToFile() capture into one Bits
+  // value of the given width per record. Returns an error if the file does
+  // not hold exactly sample_count records or any record contains an X value.
+  static absl::StatusOr<std::vector<Bits>> ReadResponseFile(
+      const std::filesystem::path& path, int64_t width, int64_t sample_count);
+
   // Expect to find a particular string in the simulation output,
   // typically generated by a trace in the dut.
   // Trace strings must be found in the order of the ExpectTrace calls.
@@ -172,11 +209,34 @@ class ModuleTestbench {
     int64_t instance;
   };
 
+  // Starts all registered input/output streams (see RunStreams()).
+  struct StartStreams {};
+
   // The list of actions to perform during simulation.
   using Action = absl::variant<AdvanceCycle, SetInput, SetInputX, WaitForOutput,
-                               DisplayOutput>;
+                               DisplayOutput, StartStreams>;
   std::vector<Action> actions_;
 
+  // A column of input samples streamed into an input port from a file.
+  struct InputStream {
+    std::string port;
+    std::string path;
+    int64_t sample_count;
+  };
+  std::vector<InputStream> input_streams_;
+
+  // A column of output samples captured from an output port into a file.
+  struct OutputStream {
+    std::string port;
+    std::string path;
+    int64_t sample_count;
+    int64_t latency;
+  };
+  std::vector<OutputStream> output_streams_;
+
+  // Whether RunStreams() has been called.
+  bool streams_started_ = false;
+
   // A pair of instance number and port name used as a key for associating a
   // output display statement with a particular Capture or ExpectEq.
   using InstancePort = std::pair<int64_t, std::string>;
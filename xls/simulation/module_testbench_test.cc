@@ -14,9 +14,12 @@
 
 #include "xls/simulation/module_testbench.h"
 
+#include <filesystem>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "xls/codegen/vast.h"
+#include "xls/common/file/temp_directory.h"
 #include "xls/common/status/matchers.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/bits_ops.h"
@@ -201,6 +204,33 @@ TEST_P(ModuleTestbenchTest, MultipleOutputsWithCapture) {
   EXPECT_EQ(out1_captured, UBits(134, 8));
 }
 
+TEST_P(ModuleTestbenchTest, StreamedPipeline) {
+  VerilogFile f(UseSystemVerilog());
+  Module* m = MakeTwoStageIdentityPipeline(&f);
+
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  std::filesystem::path stimulus_path = temp_dir.path() / "in.stimulus";
+  std::filesystem::path response_path = temp_dir.path() / "out.response";
+  std::vector<Bits> samples;
+  for (int64_t i = 0; i < 1000; ++i) {
+    samples.push_back(UBits(i, 16));
+  }
+  XLS_ASSERT_OK(
+      ModuleTestbench::WriteStimulusFile(stimulus_path, samples, /*width=*/16));
+
+  ModuleTestbench tb(m, GetSimulator(), "clk");
+  tb.StreamInputFromFile("in", stimulus_path.string(), samples.size());
+  tb.StreamOutputToFile("out", response_path.string(), samples.size(),
+                        /*latency=*/2);
+  tb.RunStreams();
+  XLS_ASSERT_OK(tb.Run());
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Bits> responses,
+                           ModuleTestbench::ReadResponseFile(
+                               response_path, /*width=*/16, samples.size()));
+  EXPECT_EQ(responses, samples);
+}
+
 TEST_P(ModuleTestbenchTest, TestTimeout) {
   VerilogFile f(UseSystemVerilog());
   Module* m = f.AddModule("test_module", SourceInfo());
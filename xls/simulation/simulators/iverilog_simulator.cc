@@ -12,12 +12,17 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <filesystem>
 #include <string>
 #include <utility>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/strip.h"
+#include "absl/synchronization/mutex.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/file/get_runfile_path.h"
 #include "xls/common/file/temp_directory.h"
@@ -73,6 +78,14 @@ class IcarusVerilogSimulator : public VerilogSimulator {
   absl::StatusOr<std::pair<std::string, std::string>> Run(
       absl::string_view text,
       absl::Span<const VerilogInclude> includes) const override {
+    XLS_ASSIGN_OR_RETURN(std::filesystem::path compiled_path,
+                         CompileOrGetCached(text, includes));
+    return InvokeVvp({compiled_path.string()});
+  }
+
+  absl::Status RunSyntaxChecking(
+      absl::string_view text,
+      absl::Span<const VerilogInclude> includes) const override {
     XLS_ASSIGN_OR_RETURN(TempDirectory temp_top, TempDirectory::Create());
     XLS_RETURN_IF_ERROR(RecursivelyCreateDir(temp_top.path()));
     std::filesystem::path temp_dir = temp_top.path();
@@ -88,12 +101,29 @@ class IcarusVerilogSimulator : public VerilogSimulator {
                         temp_dir.string()})
             .status());
 
-    return InvokeVvp({temp_out.path().string()});
+    return absl::OkStatus();
   }
 
-  absl::Status RunSyntaxChecking(
-      absl::string_view text,
-      absl::Span<const VerilogInclude> includes) const override {
+ private:
+  // Returns a vvp binary for the given Verilog text, compiling it only if
+  // an identical text/include combination has not been compiled by this
+  // simulator before.  Repeated simulations of the same testbench within
+  // one process (e.g. across a regression suite) then skip the iverilog
+  // compile and only rerun vvp.
+  absl::StatusOr<std::filesystem::path> CompileOrGetCached(
+      absl::string_view text, absl::Span<const VerilogInclude> includes) const {
+    std::string cache_key(text);
+    for (const VerilogInclude& include : includes) {
+      absl::StrAppend(&cache_key, "\n", include.relative_path, "\n",
+                      include.verilog_text);
+    }
+
+    absl::MutexLock lock(&mutex_);
+    auto iter = compiled_cache_.find(cache_key);
+    if (iter != compiled_cache_.end()) {
+      return iter->second.path();
+    }
+
     XLS_ASSIGN_OR_RETURN(TempDirectory temp_top, TempDirectory::Create());
     XLS_RETURN_IF_ERROR(RecursivelyCreateDir(temp_top.path()));
     std::filesystem::path temp_dir = temp_top.path();
@@ -109,8 +139,17 @@ class IcarusVerilogSimulator : public VerilogSimulator {
                         temp_dir.string()})
             .status());
 
-    return absl::OkStatus();
+    auto [cache_iter, inserted] =
+        compiled_cache_.insert({std::move(cache_key), std::move(temp_out)});
+    return cache_iter->second.path();
   }
+
+  // Compiled vvp binaries keyed by the Verilog text and includes they were
+  // compiled from.  The binaries live as temp files until the simulator is
+  // destroyed.
+  mutable absl::Mutex mutex_;
+  mutable absl::flat_hash_map<std::string, TempFile> compiled_cache_
+      ABSL_GUARDED_BY(mutex_);
 };
 
 XLS_REGISTER_MODULE_INITIALIZER(iverilog_simulator, {
@@ -14,6 +14,9 @@
 
 #include "xls/solvers/z3_lec.h"
 
+#include <algorithm>
+#include <atomic>
+#include <numeric>
 #include <thread>  // NOLINT(build/c++11)
 
 #include "absl/base/internal/sysinfo.h"
@@ -21,9 +24,13 @@
 #include "absl/strings/match.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/strip.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "xls/codegen/vast.h"
+#include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/ir/bits_ops.h"
 #include "xls/ir/node_util.h"
 #include "xls/solvers/z3_utils.h"
@@ -132,6 +139,7 @@ absl::Status Lec::Init() {
     }
   }
 
+  output_eq_bits_ = eq_nodes;
   Z3_ast eval_node = Z3_mk_and(ctx(), eq_nodes.size(), eq_nodes.data());
   eval_node = Z3_mk_not(ctx(), eval_node);
   solver_ = CreateSolver(ctx(), std::thread::hardware_concurrency());
@@ -268,6 +276,133 @@ bool Lec::Run() {
   return !satisfiable_;
 }
 
+bool Lec::RunSliced(const SlicedRunOptions& options) {
+  XLS_CHECK_GT(options.bits_per_slice, 0);
+  XLS_CHECK_GT(options.max_attempts, 0);
+
+  // Build one assertion per group of output bits in the main context. Each
+  // shares the fanin cone translated during Init(); Z3_translate below copies
+  // only the cone reachable from the slice into the worker's context.
+  std::vector<Z3_ast> slice_asserts;
+  for (int64_t start = 0; start < output_eq_bits_.size();
+       start += options.bits_per_slice) {
+    int64_t end = std::min<int64_t>(start + options.bits_per_slice,
+                                    output_eq_bits_.size());
+    std::vector<Z3_ast> eq_bits(output_eq_bits_.begin() + start,
+                                output_eq_bits_.begin() + end);
+    Z3_ast conjunction = Z3_mk_and(ctx(), eq_bits.size(), eq_bits.data());
+    slice_asserts.push_back(Z3_mk_not(ctx(), conjunction));
+  }
+  XLS_LOG(INFO) << "Beginning sliced execution: " << slice_asserts.size()
+                << " slices of " << options.bits_per_slice << " bit(s)";
+
+  int64_t num_workers = options.num_workers > 0
+                            ? options.num_workers
+                            : std::thread::hardware_concurrency();
+
+  std::vector<Z3_lbool> results(slice_asserts.size(), Z3_L_UNDEF);
+  std::vector<int64_t> pending(slice_asserts.size());
+  std::iota(pending.begin(), pending.end(), 0);
+
+  // Z3 contexts aren't thread-safe, so reads of the shared source context
+  // during cross-context translation must be serialized.
+  absl::Mutex translate_mutex;
+  std::atomic<int64_t> sat_slice(-1);
+
+  absl::Duration timeout = options.initial_timeout;
+  for (int64_t attempt = 1;
+       !pending.empty() && sat_slice.load() == -1 &&
+       attempt <= options.max_attempts;
+       ++attempt) {
+    // The last attempt runs without a time limit.
+    const uint64_t timeout_ms = attempt == options.max_attempts
+                                    ? 0
+                                    : absl::ToInt64Milliseconds(timeout);
+    std::atomic<int64_t> next(0);
+    auto worker = [&]() {
+      Z3_config config = Z3_mk_config();
+      Z3_context slice_ctx = Z3_mk_context(config);
+      Z3_del_config(config);
+      while (sat_slice.load() == -1) {
+        int64_t index = next.fetch_add(1);
+        if (index >= static_cast<int64_t>(pending.size())) {
+          break;
+        }
+        int64_t slice = pending[index];
+        Z3_ast assertion;
+        {
+          absl::MutexLock lock(&translate_mutex);
+          assertion = Z3_translate(ctx(), slice_asserts[slice], slice_ctx);
+        }
+        Z3_solver solver = CreateSolver(slice_ctx, 1);
+        if (timeout_ms > 0) {
+          Z3_params params = Z3_mk_params(slice_ctx);
+          Z3_params_inc_ref(slice_ctx, params);
+          Z3_params_set_uint(slice_ctx, params,
+                             Z3_mk_string_symbol(slice_ctx, "timeout"),
+                             timeout_ms);
+          Z3_solver_set_params(slice_ctx, solver, params);
+          Z3_params_dec_ref(slice_ctx, params);
+        }
+        Z3_solver_assert(slice_ctx, solver, assertion);
+        Z3_lbool result = Z3_solver_check(slice_ctx, solver);
+        Z3_solver_dec_ref(slice_ctx, solver);
+        results[slice] = result;
+        if (result == Z3_L_TRUE) {
+          sat_slice.store(slice);
+        }
+      }
+      Z3_del_context(slice_ctx);
+    };
+
+    std::vector<std::unique_ptr<xls::Thread>> workers;
+    int64_t worker_count =
+        std::min<int64_t>(num_workers, static_cast<int64_t>(pending.size()));
+    for (int64_t i = 0; i < worker_count; i++) {
+      workers.push_back(std::make_unique<xls::Thread>(worker));
+    }
+    for (auto& thread : workers) {
+      thread->Join();
+    }
+
+    std::vector<int64_t> still_pending;
+    for (int64_t slice : pending) {
+      if (results[slice] == Z3_L_UNDEF) {
+        still_pending.push_back(slice);
+      }
+    }
+    if (!still_pending.empty() && sat_slice.load() == -1) {
+      XLS_LOG(INFO) << still_pending.size() << " slice(s) timed out after "
+                    << timeout << "; retrying";
+    }
+    pending = std::move(still_pending);
+    timeout *= 2;
+  }
+
+  if (sat_slice.load() != -1) {
+    // Re-prove the offending slice in the main context so the model (and
+    // thus ResultToString()/DumpIrTree()) can be inspected as after Run().
+    XLS_LOG(INFO) << "Slice " << sat_slice.load()
+                  << " disproved equivalence; reconstructing model";
+    if (solver_) {
+      Z3_solver_dec_ref(ctx(), solver_.value());
+    }
+    solver_ = CreateSolver(ctx(), std::thread::hardware_concurrency());
+    Z3_solver_assert(ctx(), solver_.value(), slice_asserts[sat_slice.load()]);
+    return Run();
+  }
+
+  satisfiable_ = false;
+  if (!pending.empty()) {
+    // Undetermined even without a time limit (e.g. the check was
+    // interrupted); the proof is incomplete, so don't claim equivalence.
+    XLS_LOG(WARNING) << "LEC left " << pending.size()
+                     << " slice(s) undetermined.";
+    return false;
+  }
+  return true;
+}
+
 std::string Lec::ResultToString() {
   std::vector<std::string> output;
   output.push_back(SolverResultToString(ctx(), solver_.value(),
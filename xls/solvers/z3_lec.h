@@ -15,11 +15,14 @@
 #ifndef XLS_SOLVERS_Z3_LEC_H_
 #define XLS_SOLVERS_Z3_LEC_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/time/time.h"
 #include "absl/types/optional.h"
 #include "xls/ir/package.h"
 #include "xls/netlist/netlist.h"
@@ -48,6 +51,22 @@ struct LecParams {
   std::string netlist_module_name;
 };
 
+// Options for Lec::RunSliced().
+struct SlicedRunOptions {
+  // Number of output bits proved per independent query.
+  int64_t bits_per_slice = 1;
+
+  // Number of concurrent solver contexts. Zero means one per hardware thread.
+  int64_t num_workers = 0;
+
+  // Time budget for each slice's first attempt. Slices that time out are
+  // deferred and retried with a doubled budget once the rest have finished.
+  absl::Duration initial_timeout = absl::Minutes(1);
+
+  // Total attempts per slice; the final attempt runs without a time limit.
+  int64_t max_attempts = 3;
+};
+
 // Class for performing logical equivalence checks between a function specified
 // in XLS IR (perhaps converted from DSLX) and a netlist.
 class Lec {
@@ -76,6 +95,16 @@ class Lec {
   // Returns true of the netlist and IR are proved to be equivalent.
   bool Run();
 
+  // Like Run(), but proves each group of output bits as an independent query
+  // distributed across a pool of solver contexts. The Z3 translation of the
+  // shared fanin cone is built once (in Init()) and copied into each worker's
+  // context per slice. Slices that exhaust their time budget are retried with
+  // doubled budgets once the remaining slices have finished, so one hard bit
+  // doesn't stall the whole proof. If a slice disproves equivalence it is
+  // re-proved in the main context, so the counterexample can be inspected via
+  // ResultToString()/DumpIrTree() just as after Run().
+  bool RunSliced(const SlicedRunOptions& options);
+
   // Dumps all Z3 values corresponding to IR nodes in the input function.
   void DumpIrTree();
 
@@ -151,6 +180,9 @@ class Lec {
   std::vector<const Node*> ir_output_nodes_;
   std::vector<Z3_ast> ir_outputs_;
   std::vector<Z3_ast> netlist_outputs_;
+  // Per-bit IR-equals-netlist nodes, in output order, skipping bits absent
+  // from the netlist; these are the slicing granules for RunSliced().
+  std::vector<Z3_ast> output_eq_bits_;
 
   std::optional<PipelineSchedule> schedule_;
   int stage_;
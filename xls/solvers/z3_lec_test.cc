@@ -14,6 +14,8 @@
 
 #include "xls/solvers/z3_lec.h"
 
+#include <optional>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/statusor.h"
@@ -31,8 +33,10 @@ namespace {
 
 using netlist::rtl::Netlist;
 
-absl::StatusOr<bool> Match(const std::string& ir_text,
-                           const std::string& netlist_text, bool expect_equal) {
+absl::StatusOr<bool> Match(
+    const std::string& ir_text, const std::string& netlist_text,
+    bool expect_equal,
+    std::optional<SlicedRunOptions> sliced_options = std::nullopt) {
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
                        Parser::ParsePackage(ir_text));
   XLS_ASSIGN_OR_RETURN(Function * entry_function, package->GetTopAsFunction());
@@ -52,6 +56,9 @@ absl::StatusOr<bool> Match(const std::string& ir_text,
   params.netlist_module_name = "main";
 
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<Lec> lec, Lec::Create(params));
+  if (sliced_options.has_value()) {
+    return lec->RunSliced(sliced_options.value());
+  }
   return lec->Run();
 }
 
@@ -93,6 +100,16 @@ endmodule
   XLS_ASSERT_OK_AND_ASSIGN(bool match,
                            Match(ir_text, netlist_text, /*expect_equal=*/true));
   ASSERT_TRUE(match);
+
+  // The same proof, split into one query per output bit across two solver
+  // contexts.
+  SlicedRunOptions sliced_options;
+  sliced_options.bits_per_slice = 1;
+  sliced_options.num_workers = 2;
+  XLS_ASSERT_OK_AND_ASSIGN(
+      match, Match(ir_text, netlist_text, /*expect_equal=*/true,
+                   sliced_options));
+  ASSERT_TRUE(match);
 }
 
 // Test verifies that z3::Lec correctly reports a mismatch in cases where the
@@ -133,6 +150,15 @@ endmodule
   XLS_ASSERT_OK_AND_ASSIGN(
       bool match, Match(ir_text, netlist_text, /*expect_equal=*/false));
   ASSERT_FALSE(match);
+
+  // The sliced mode must find the mismatched bit as well.
+  SlicedRunOptions sliced_options;
+  sliced_options.bits_per_slice = 2;
+  sliced_options.num_workers = 2;
+  XLS_ASSERT_OK_AND_ASSIGN(
+      match, Match(ir_text, netlist_text, /*expect_equal=*/false,
+                   sliced_options));
+  ASSERT_FALSE(match);
 }
 
 // This test verifies that we can do a simple multi-stage LEC.
@@ -14,15 +14,23 @@
 
 #include "xls/solvers/z3_netlist_translator.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
 #include <variant>
+#include <vector>
 
 #include "absl/flags/flag.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_split.h"
+#include "absl/synchronization/mutex.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
+#include "xls/data_structures/union_find.h"
 #include "xls/netlist/cell_library.h"
 #include "xls/netlist/function_parser.h"
 #include "xls/netlist/netlist.h"
@@ -111,7 +119,116 @@ absl::Status NetlistTranslator::Retranslate(
   return Translate();
 }
 
-// General idea: construct an AST by iterating over all the Cells in the module.
+absl::Status NetlistTranslator::Translate() {
+  // Group the cells into independent fanin cones. Cells sharing any net that
+  // isn't already translated (translated_ is pre-populated with the module
+  // inputs, synthesized clk/input_valid, and the constant nets) must be built
+  // together; distinct cones only meet at those shared terminals, so they can
+  // be translated into separate Z3 contexts concurrently.
+  UnionFind<Cell*> cone_uf;
+  for (const auto& cell : module_->cells()) {
+    cone_uf.Insert(cell.get());
+  }
+  for (const auto& net : module_->nets()) {
+    if (translated_.contains(net.get())) {
+      continue;
+    }
+    Cell* first = nullptr;
+    for (Cell* connected : net->connected_cells()) {
+      if (first == nullptr) {
+        first = connected;
+      } else {
+        cone_uf.Union(first, connected);
+      }
+    }
+  }
+
+  // Bucket cells by cone, preserving module cell order within each cone.
+  std::vector<std::vector<Cell*>> cones;
+  absl::flat_hash_map<Cell*, int64_t> cone_index;
+  for (const auto& cell : module_->cells()) {
+    auto result = cone_index.emplace(cone_uf.Find(cell.get()), cones.size());
+    if (result.second) {
+      cones.emplace_back();
+    }
+    cones[result.first->second].push_back(cell.get());
+  }
+
+  const int64_t num_threads = std::min<int64_t>(
+      std::thread::hardware_concurrency(), cones.size());
+  if (num_threads <= 1) {
+    for (const auto& cone : cones) {
+      XLS_RETURN_IF_ERROR(TranslateCells(cone));
+    }
+    return absl::OkStatus();
+  }
+  XLS_VLOG(2) << "Translating " << cones.size() << " fanin cones on "
+              << num_threads << " threads.";
+
+  absl::Mutex ctx_mutex;
+  std::vector<absl::Status> results(cones.size());
+  std::atomic<int64_t> next_cone(0);
+  auto worker = [&] {
+    while (true) {
+      int64_t index = next_cone.fetch_add(1);
+      if (index >= static_cast<int64_t>(cones.size())) {
+        return;
+      }
+      results[index] = TranslateCone(cones[index], &ctx_mutex);
+    }
+  };
+  std::vector<std::unique_ptr<Thread>> workers;
+  workers.reserve(num_threads);
+  for (int64_t i = 0; i < num_threads; ++i) {
+    workers.push_back(std::make_unique<Thread>(worker));
+  }
+  for (auto& thread : workers) {
+    thread->Join();
+  }
+  for (const absl::Status& result : results) {
+    XLS_RETURN_IF_ERROR(result);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status NetlistTranslator::TranslateCone(absl::Span<Cell* const> cone,
+                                              absl::Mutex* ctx_mutex) {
+  Z3_config config = Z3_mk_config();
+  Z3_context cone_ctx = Z3_mk_context(config);
+  Z3_del_config(config);
+
+  NetlistTranslator cone_translator(cone_ctx, module_, module_refs_);
+  // Seed the cone's context with the already-translated terminals it consumes.
+  {
+    absl::MutexLock lock(ctx_mutex);
+    for (Cell* cell : cone) {
+      for (const auto& input : cell->inputs()) {
+        auto it = translated_.find(input.netref);
+        if (it != translated_.end() &&
+            !cone_translator.translated_.contains(input.netref)) {
+          cone_translator.translated_[input.netref] =
+              Z3_translate(ctx_, it->second, cone_ctx);
+        }
+      }
+    }
+  }
+
+  absl::Status status = cone_translator.TranslateCells(cone);
+  if (status.ok()) {
+    // Merge the cone's nets into the primary context. Z3 hash-conses the
+    // translated terms, so structure shared between nets isn't duplicated.
+    absl::MutexLock lock(ctx_mutex);
+    for (const auto& pair : cone_translator.translated_) {
+      if (!translated_.contains(pair.first)) {
+        translated_[pair.first] = Z3_translate(cone_ctx, pair.second, ctx_);
+      }
+    }
+  }
+  Z3_del_context(cone_ctx);
+  return status;
+}
+
+// General idea: construct an AST by iterating over all the given Cells.
 //  1. First, collect all input wires and put them on an "active" list.
 //  2. Iterate through the active wire list and examine all cells they're
 //     connected to, removing each as examined.
@@ -119,12 +236,13 @@ absl::Status NetlistTranslator::Retranslate(
 //     translate that cell into Z3 space, and move its output wires
 //     (the resulting Z3 nodes) onto the back of the active wire list.
 //  4. Repeat until the active wire list is empty.
-absl::Status NetlistTranslator::Translate() {
+absl::Status NetlistTranslator::TranslateCells(absl::Span<Cell* const> cells) {
   // Utility structure so we don't have to iterate through a cell's inputs and
   // outputs every time it's examined.
   absl::flat_hash_map<Cell*, absl::flat_hash_set<NetRef>> cell_inputs;
   std::deque<NetRef> active_wires;
-  for (const auto& cell : module_->cells()) {
+  absl::flat_hash_set<Cell*> to_translate(cells.begin(), cells.end());
+  for (Cell* cell : cells) {
     // If any cells have _no_ inputs, then their outputs should be made
     // immediately available.
     if (cell->inputs().empty()) {
@@ -137,11 +255,11 @@ absl::Status NetlistTranslator::Translate() {
       for (const auto& input : cell->inputs()) {
         inputs.insert(input.netref);
       }
-      cell_inputs[cell.get()] = std::move(inputs);
+      cell_inputs[cell] = std::move(inputs);
     }
   }
 
-  // Remember - we pre-populated translated_ with the set of module inputs.
+  // Remember - translated_ was pre-populated with this cone's terminals.
   for (const auto& pair : translated_) {
     active_wires.push_back(pair.first);
   }
@@ -157,6 +275,11 @@ absl::Status NetlistTranslator::Translate() {
     // Check every connected cell to see if all of its inputs are now
     // available.
     for (auto& cell : ref->connected_cells()) {
+      // Terminal wires may connect to cells outside this cone; those belong
+      // to (and will be translated by) another TranslateCells call.
+      if (!to_translate.contains(cell)) {
+        continue;
+      }
       // Skip if this cell if the wire is its output!
       bool is_output = false;
       for (const auto& output : cell->outputs()) {
@@ -231,8 +354,15 @@ absl::Status NetlistTranslator::TranslateCell(const Cell& cell) {
   const CellLibraryEntry::OutputPinToFunction& pins =
       entry->output_pin_to_function();
   for (const auto& output : cell.outputs()) {
-    XLS_ASSIGN_OR_RETURN(Ast ast, netlist::function::Parser::ParseFunction(
-                                      pins.at(output.name)));
+    // Preprocessed libraries carry the parsed function; fall back to parsing
+    // the function string for raw Liberty libraries.
+    Ast ast = Ast::LiteralZero(/*pos=*/0);
+    if (const Ast* preparsed = entry->GetPinFunctionAst(output.name)) {
+      ast = *preparsed;
+    } else {
+      XLS_ASSIGN_OR_RETURN(ast, netlist::function::Parser::ParseFunction(
+                                    pins.at(output.name)));
+    }
     XLS_ASSIGN_OR_RETURN(Z3_ast result,
                          TranslateFunction(cell, ast, state_table_values));
     translated_[output.netref] = result;
@@ -19,6 +19,8 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "xls/netlist/function_parser.h"
 #include "xls/netlist/netlist.h"
 #include "../z3/src/api/z3.h"
@@ -82,8 +84,25 @@ class NetlistTranslator {
           module_refs);
   absl::Status Init();
 
-  // Translates the module, cell, or cell function, respectively, into Z3-space.
+  // Translates the module into Z3-space. The module's cells are partitioned
+  // into independent fanin cones - cells that share a net other than an
+  // already-translated terminal (module input, synthesized clk/input_valid,
+  // constant) must land in the same cone - and distinct cones are translated
+  // concurrently into per-thread contexts.
   absl::Status Translate();
+
+  // Translates the given cells in dependency order into ctx_. Every net
+  // feeding a cell in the set must either be driven by another cell in the
+  // set or already be present in translated_.
+  absl::Status TranslateCells(absl::Span<netlist::rtl::Cell* const> cells);
+
+  // Translates one independent fanin cone in a private Z3 context and merges
+  // the resulting nets into ctx_ via Z3_translate. Z3 contexts aren't
+  // thread-safe, so all access to ctx_ is serialized on ctx_mutex.
+  absl::Status TranslateCone(absl::Span<netlist::rtl::Cell* const> cone,
+                             absl::Mutex* ctx_mutex);
+
+  // Translates the cell or cell function, respectively, into Z3-space.
   absl::Status TranslateCell(const netlist::rtl::Cell& cell);
   absl::StatusOr<Z3_ast> TranslateFunction(
       const netlist::rtl::Cell& cell, const netlist::function::Ast ast,
@@ -227,6 +227,77 @@ TEST(NetlistTranslatorTest_Standalone, SimpleNet) {
   EXPECT_NE(ast_text.find("bvand A B"), std::string::npos);
 }
 
+// Builds a module of many disjoint single-cell fanin cones - enough that
+// Translate() takes its parallel path - and proves each cone's output against
+// its reference function after the per-cone contexts are merged back.
+TEST(NetlistTranslatorTest_Standalone, IndependentConesTranslateInParallel) {
+  constexpr int kNumCones = 64;
+
+  Z3_config config = Z3_mk_config();
+  Z3_context ctx = Z3_mk_context(config);
+  auto cleanup = absl::MakeCleanup([config, ctx] {
+    Z3_del_context(ctx);
+    Z3_del_config(config);
+  });
+
+  Module module("the_module");
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library,
+                           netlist::MakeFakeCellLibrary());
+  XLS_ASSERT_OK_AND_ASSIGN(const CellLibraryEntry* and_entry,
+                           cell_library.GetEntry("AND"));
+
+  std::vector<NetRef> cone_outputs;
+  for (int i = 0; i < kNumCones; i++) {
+    absl::flat_hash_map<std::string, NetRef> param_assignments;
+    for (const auto& input_name : and_entry->input_names()) {
+      std::string net_name = absl::StrCat(input_name, "_", i);
+      XLS_ASSERT_OK(module.AddNetDecl(NetDeclKind::kInput, net_name));
+      XLS_ASSERT_OK_AND_ASSIGN(NetRef ref, module.ResolveNet(net_name));
+      param_assignments[input_name] = ref;
+    }
+
+    const auto& pins = and_entry->output_pin_to_function();
+    std::string output_name = absl::StrCat(pins.begin()->first, "_", i);
+    XLS_ASSERT_OK(module.AddNetDecl(NetDeclKind::kOutput, output_name));
+    XLS_ASSERT_OK_AND_ASSIGN(NetRef output_ref, module.ResolveNet(output_name));
+    param_assignments[pins.begin()->first] = output_ref;
+    cone_outputs.push_back(output_ref);
+
+    XLS_ASSERT_OK_AND_ASSIGN(
+        Cell tmp_cell,
+        Cell::Create(and_entry, absl::StrCat("and_", i), param_assignments,
+                     absl::nullopt, /*dummy_net=*/nullptr));
+    XLS_ASSERT_OK_AND_ASSIGN(Cell * cell, module.AddCell(tmp_cell));
+    for (auto& pair : param_assignments) {
+      pair.second->NoteConnectedCell(cell);
+    }
+  }
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto translator, NetlistTranslator::CreateAndTranslate(ctx, &module, {}));
+
+  Z3_sort bit_sort = Z3_mk_bv_sort(ctx, 1);
+  for (int i = 0; i < kNumCones; i++) {
+    XLS_ASSERT_OK_AND_ASSIGN(Z3_ast z3_output,
+                             translator->GetTranslation(cone_outputs[i]));
+    // The module inputs were created as same-named symbolic constants, so the
+    // reference function can be built directly in the primary context.
+    std::vector<Z3_ast> z3_inputs;
+    for (const auto& input_name : and_entry->input_names()) {
+      std::string net_name = absl::StrCat(input_name, "_", i);
+      z3_inputs.push_back(Z3_mk_const(
+          ctx, Z3_mk_string_symbol(ctx, net_name.c_str()), bit_sort));
+    }
+    Z3_ast expected = Z3_mk_bvand(ctx, z3_inputs[0], z3_inputs[1]);
+
+    Z3_solver solver = CreateSolver(ctx, 1);
+    Z3_solver_assert(ctx, solver,
+                     Z3_mk_not(ctx, Z3_mk_eq(ctx, z3_output, expected)));
+    EXPECT_EQ(Z3_solver_check(ctx, solver), Z3_L_FALSE) << "cone " << i;
+    Z3_solver_dec_ref(ctx, solver);
+  }
+}
+
 // Create a module that instantiates all child cells and combines them with a
 // cell with the specified name.
 absl::StatusOr<Module> CreateModule(
@@ -0,0 +1,230 @@
+// Copyright 2020 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "xls/solvers/z3_smtlib_emitter.h"
+
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/status/status_macros.h"
+#include "../z3/src/api/z3_api.h"
+
+namespace xls {
+namespace solvers {
+namespace z3 {
+namespace {
+
+// Returns the SMT-LIB name of the declaration of an application, e.g. "bvadd"
+// or "(_ extract 7 0)". Z3's declaration names are already SMT-LIB names for
+// nearly all operations; parameterized declarations are emitted in indexed
+// identifier form.
+absl::Status EmitAppOperator(Z3_context ctx, Z3_func_decl decl,
+                             std::ostream* os) {
+  // A few declaration names predate SMT-LIB2 and need mapping.
+  if (Z3_get_decl_kind(ctx, decl) == Z3_OP_ITE) {
+    *os << "ite";
+    return absl::OkStatus();
+  }
+
+  Z3_symbol symbol = Z3_get_decl_name(ctx, decl);
+  std::string name;
+  if (Z3_get_symbol_kind(ctx, symbol) == Z3_STRING_SYMBOL) {
+    name = Z3_get_symbol_string(ctx, symbol);
+  } else {
+    name = absl::StrCat("k!", Z3_get_symbol_int(ctx, symbol));
+  }
+
+  unsigned num_parameters = Z3_get_decl_num_parameters(ctx, decl);
+  if (num_parameters == 0) {
+    *os << name;
+    return absl::OkStatus();
+  }
+
+  // Parameterized declaration, e.g. (_ extract 7 0) or (_ zero_extend 8).
+  *os << "(_ " << name;
+  for (unsigned i = 0; i < num_parameters; ++i) {
+    if (Z3_get_decl_parameter_kind(ctx, decl, i) != Z3_PARAMETER_INT) {
+      return absl::UnimplementedError(absl::StrFormat(
+          "Non-integer parameter on declaration \"%s\".", name));
+    }
+    *os << ' ' << Z3_get_decl_int_parameter(ctx, decl, i);
+  }
+  *os << ')';
+  return absl::OkStatus();
+}
+
+// Emits a numeral node. Bit-vector numerals are emitted in the sort-carrying
+// (_ bvN width) form, other sorts as their plain decimal representation.
+absl::Status EmitNumeral(Z3_context ctx, Z3_ast node, std::ostream* os) {
+  Z3_sort sort = Z3_get_sort(ctx, node);
+  if (Z3_get_sort_kind(ctx, sort) == Z3_BV_SORT) {
+    *os << "(_ bv" << Z3_get_numeral_string(ctx, node) << ' '
+        << Z3_get_bv_sort_size(ctx, sort) << ')';
+  } else {
+    *os << Z3_get_numeral_string(ctx, node);
+  }
+  return absl::OkStatus();
+}
+
+// Emits "root" as a tree, except that descendants present in "names" are
+// replaced by their binding names. Iterative to keep stack usage flat on the
+// very deep expressions this is meant for.
+absl::Status EmitExpr(
+    Z3_context ctx, Z3_ast root,
+    const absl::flat_hash_map<unsigned, std::string>& names,
+    std::ostream* os) {
+  // A frame either emits literal "text" or expands "node".
+  struct Frame {
+    Z3_ast node;
+    const char* text;
+  };
+  std::vector<Frame> stack;
+  stack.push_back(Frame{root, nullptr});
+  while (!stack.empty()) {
+    Frame frame = stack.back();
+    stack.pop_back();
+    if (frame.text != nullptr) {
+      *os << frame.text;
+      continue;
+    }
+    Z3_ast node = frame.node;
+    if (node != root) {
+      auto it = names.find(Z3_get_ast_id(ctx, node));
+      if (it != names.end()) {
+        *os << it->second;
+        continue;
+      }
+    }
+    switch (Z3_get_ast_kind(ctx, node)) {
+      case Z3_NUMERAL_AST:
+        XLS_RETURN_IF_ERROR(EmitNumeral(ctx, node, os));
+        break;
+      case Z3_APP_AST: {
+        Z3_app app = Z3_to_app(ctx, node);
+        unsigned num_args = Z3_get_app_num_args(ctx, app);
+        if (num_args == 0) {
+          // Constant: either a literal like "true" or an uninterpreted
+          // constant (a parameter of the translated function).
+          XLS_RETURN_IF_ERROR(
+              EmitAppOperator(ctx, Z3_get_app_decl(ctx, app), os));
+          break;
+        }
+        *os << '(';
+        XLS_RETURN_IF_ERROR(
+            EmitAppOperator(ctx, Z3_get_app_decl(ctx, app), os));
+        stack.push_back(Frame{nullptr, ")"});
+        for (int64_t i = num_args - 1; i >= 0; --i) {
+          stack.push_back(Frame{Z3_get_app_arg(ctx, app, i), nullptr});
+          stack.push_back(Frame{nullptr, " "});
+        }
+        break;
+      }
+      default:
+        return absl::UnimplementedError(
+            absl::StrFormat("Unsupported AST kind for SMT-LIB emission: %d",
+                            Z3_get_ast_kind(ctx, node)));
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::Status EmitSmtlibWithLets(Z3_context ctx, Z3_ast ast, std::ostream* os) {
+  // First pass: count how many references each subterm has. Descend into a
+  // node's operands only on the first encounter so each DAG edge is walked
+  // once.
+  absl::flat_hash_map<unsigned, int64_t> use_counts;
+  {
+    std::vector<Z3_ast> stack = {ast};
+    while (!stack.empty()) {
+      Z3_ast node = stack.back();
+      stack.pop_back();
+      if (++use_counts[Z3_get_ast_id(ctx, node)] > 1) {
+        continue;
+      }
+      if (Z3_get_ast_kind(ctx, node) == Z3_APP_AST) {
+        Z3_app app = Z3_to_app(ctx, node);
+        for (unsigned i = 0; i < Z3_get_app_num_args(ctx, app); ++i) {
+          stack.push_back(Z3_get_app_arg(ctx, app, i));
+        }
+      }
+    }
+  }
+
+  // Second pass: gather the shared non-leaf subterms in operand-before-user
+  // (post) order, which is exactly the order their bindings must appear in.
+  std::vector<Z3_ast> shared;
+  {
+    struct Frame {
+      Z3_ast node;
+      bool expanded;
+    };
+    absl::flat_hash_set<unsigned> visited;
+    std::vector<Frame> stack = {Frame{ast, false}};
+    while (!stack.empty()) {
+      Frame frame = stack.back();
+      stack.pop_back();
+      if (frame.expanded) {
+        if (frame.node != ast &&
+            use_counts.at(Z3_get_ast_id(ctx, frame.node)) > 1) {
+          shared.push_back(frame.node);
+        }
+        continue;
+      }
+      if (!visited.insert(Z3_get_ast_id(ctx, frame.node)).second) {
+        continue;
+      }
+      if (Z3_get_ast_kind(ctx, frame.node) != Z3_APP_AST) {
+        continue;
+      }
+      Z3_app app = Z3_to_app(ctx, frame.node);
+      unsigned num_args = Z3_get_app_num_args(ctx, app);
+      if (num_args == 0) {
+        // Leaves are cheap to emit repeatedly; binding them would only add
+        // noise.
+        continue;
+      }
+      stack.push_back(Frame{frame.node, true});
+      for (unsigned i = 0; i < num_args; ++i) {
+        stack.push_back(Frame{Z3_get_app_arg(ctx, app, i), false});
+      }
+    }
+  }
+
+  // Emit one (let ...) per shared subterm. Later bindings may reference
+  // earlier ones, which SMT-LIB2's parallel-let semantics disallow within a
+  // single binding list, so the lets nest.
+  absl::flat_hash_map<unsigned, std::string> names;
+  names.reserve(shared.size());
+  for (Z3_ast node : shared) {
+    std::string name = absl::StrCat("t", names.size());
+    *os << "(let ((" << name << ' ';
+    XLS_RETURN_IF_ERROR(EmitExpr(ctx, node, names, os));
+    *os << "))\n";
+    names.emplace(Z3_get_ast_id(ctx, node), std::move(name));
+  }
+
+  XLS_RETURN_IF_ERROR(EmitExpr(ctx, ast, names, os));
+  for (int64_t i = 0; i < shared.size(); ++i) {
+    *os << ')';
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace z3
+}  // namespace solvers
+}  // namespace xls
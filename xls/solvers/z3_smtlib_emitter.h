@@ -0,0 +1,44 @@
+// Copyright 2020 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Streaming SMT-LIB emission of Z3 ASTs.
+#ifndef XLS_SOLVERS_Z3_SMTLIB_EMITTER_H_
+#define XLS_SOLVERS_Z3_SMTLIB_EMITTER_H_
+
+#include <ostream>
+
+#include "absl/status/status.h"
+#include "../z3/src/api/z3.h"
+
+namespace xls {
+namespace solvers {
+namespace z3 {
+
+// Emits "ast" as an SMT-LIB2 s-expression on "os", binding subterms which are
+// referenced more than once with (let ...) so each distinct subterm is emitted
+// exactly once. Z3 ASTs are DAGs; printing them as trees (as Z3_ast_to_string
+// does) duplicates shared subterms textually, which can blow the emitted text
+// up exponentially. Output is streamed to "os" rather than materialized as a
+// single string, so emission cost is proportional to the DAG size.
+//
+// Only the AST node kinds produced by IrTranslator (applications and
+// numerals) are supported; quantifiers and bound variables return an
+// unimplemented error.
+absl::Status EmitSmtlibWithLets(Z3_context ctx, Z3_ast ast, std::ostream* os);
+
+}  // namespace z3
+}  // namespace solvers
+}  // namespace xls
+
+#endif  // XLS_SOLVERS_Z3_SMTLIB_EMITTER_H_
@@ -16,9 +16,11 @@
 
 #include <cmath>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "grpcpp/grpcpp.h"
 #include "grpcpp/security/server_credentials.h"
@@ -48,6 +50,10 @@ ABSL_FLAG(int32_t, port, 10000, "Port to listen on.");
 ABSL_FLAG(std::string, metrics_command, "bazel run :dummy_metrics_main",
           "Command to run to generate JSON synthesis metrics.");
 ABSL_FLAG(bool, save_temps, false, "Do not delete temporary files.");
+ABSL_FLAG(int32_t, worker_count, 1,
+          "Maximum number of metrics commands run concurrently. Requests "
+          "beyond this count are queued until a worker slot frees up, so "
+          "clients may pipeline many requests at once.");
 
 namespace xls {
 namespace synthesis {
@@ -56,15 +62,20 @@ namespace {
 // Service implementation that dispatches compile requests.
 class JsonMetricsSynthesisServiceImpl : public SynthesisService::Service {
  public:
-  explicit JsonMetricsSynthesisServiceImpl(absl::string_view metrics_command)
-      : metrics_command_(metrics_command) {}
+  JsonMetricsSynthesisServiceImpl(absl::string_view metrics_command,
+                                  int64_t worker_count)
+      : metrics_command_(metrics_command), available_workers_(worker_count) {}
 
   ::grpc::Status Compile(::grpc::ServerContext* server_context,
                          const CompileRequest* request,
                          CompileResponse* result) override {
     auto start = absl::Now();
 
+    // Each RPC arrives on its own thread; requests queue here until one of
+    // the metrics-command worker slots frees up.
+    AcquireWorkerSlot();
     absl::Status metrics_status = RunMetrics(request, result);
+    ReleaseWorkerSlot();
     if (!metrics_status.ok()) {
       return ::grpc::Status(grpc::StatusCode::INTERNAL,
                             std::string(metrics_status.message()));
@@ -88,19 +99,22 @@ class JsonMetricsSynthesisServiceImpl : public SynthesisService::Service {
     XLS_RETURN_IF_ERROR(SetFileContents(verilog_path, request->module_text()));
 
     double clock_period_ps = 1e12 / request->target_frequency_hz();
-    setenv("CONSTANT_CLOCK_PORT", "clk", 1);
-    setenv("CONSTANT_CLOCK_PERIOD_PS", absl::StrCat(clock_period_ps).c_str(),
-           1);
-    setenv("CONSTANT_TOP", request->top_module_name().c_str(), 1);
-    setenv("INPUT_RTL", verilog_path.c_str(), 1);
-
     std::filesystem::path netlist_path = temp_dir_path / "netlist.v";
-    setenv("OUTPUT_NETLIST", netlist_path.c_str(), 1);
-
     std::filesystem::path metrics_path = temp_dir_path / "metrics.json";
-    setenv("OUTPUT_METRICS", metrics_path.c_str(), 1);
 
-    if (EXIT_SUCCESS != system(metrics_command_.c_str())) {
+    // The metrics command's parameters are passed as environment variables on
+    // the command line rather than via setenv() because the process
+    // environment is shared by all worker slots; concurrently handled
+    // requests would clobber each other's values.
+    std::string command = absl::StrCat(
+        "CONSTANT_CLOCK_PORT=clk",
+        " CONSTANT_CLOCK_PERIOD_PS=", clock_period_ps,
+        " CONSTANT_TOP=", request->top_module_name(),
+        " INPUT_RTL=", verilog_path.string(),
+        " OUTPUT_NETLIST=", netlist_path.string(),
+        " OUTPUT_METRICS=", metrics_path.string(), " ", metrics_command_);
+
+    if (EXIT_SUCCESS != system(command.c_str())) {
       return absl::InternalError(absl::StrCat(
           "Metrics command \"", metrics_command_, "\" execution failed"));
     }
@@ -136,14 +150,32 @@ class JsonMetricsSynthesisServiceImpl : public SynthesisService::Service {
   }
 
  private:
+  void AcquireWorkerSlot() {
+    absl::MutexLock lock(&mu_);
+    mu_.Await(absl::Condition(
+        +[](int64_t* available) { return *available > 0; },
+        &available_workers_));
+    --available_workers_;
+  }
+
+  void ReleaseWorkerSlot() {
+    absl::MutexLock lock(&mu_);
+    ++available_workers_;
+  }
+
   std::string metrics_command_;
+
+  absl::Mutex mu_;
+  // Number of metrics commands which may be started before queueing.
+  int64_t available_workers_ ABSL_GUARDED_BY(mu_);
 };
 
 void RealMain() {
   int port = absl::GetFlag(FLAGS_port);
   std::string server_address = absl::StrCat("0.0.0.0:", port);
   std::string metrics_command = absl::GetFlag(FLAGS_metrics_command);
-  JsonMetricsSynthesisServiceImpl service(absl::GetFlag(FLAGS_metrics_command));
+  JsonMetricsSynthesisServiceImpl service(absl::GetFlag(FLAGS_metrics_command),
+                                          absl::GetFlag(FLAGS_worker_count));
 
   ::grpc::ServerBuilder builder;
   std::shared_ptr<::grpc::ServerCredentials> creds = GetServerCredentials();
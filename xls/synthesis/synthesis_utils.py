@@ -14,7 +14,7 @@
 # limitations under the License.
 """Utility functions used in synthesis."""
 
-from typing import Sequence, Callable, TypeVar, Optional
+from typing import List, Sequence, Callable, TypeVar, Optional
 
 from absl import logging
 
@@ -27,6 +27,48 @@ T = TypeVar('T')
 U = TypeVar('U')
 
 
+def compile_concurrently(
+    requests: Sequence[synthesis_pb2.CompileRequest],
+    grpc_channel: grpc.Channel,
+    max_in_flight: int = 8) -> List[synthesis_pb2.CompileResponse]:
+  """Compiles many requests, overlapping their synthesis latencies.
+
+  Issues up to max_in_flight asynchronous Compile RPCs at a time and collects
+  the responses. The server queues jobs across its synthesis worker slots
+  (see the server's --worker_count flag), so a batch of candidate netlists
+  synthesizes concurrently instead of serializing on round-trip latency.
+
+  Args:
+    requests: The compile requests to issue.
+    grpc_channel: A channel to the SynthesisService GRPC service.
+    max_in_flight: Maximum number of outstanding RPCs at any time.
+
+  Returns:
+    The compile responses, in the same order as 'requests'.
+
+  Raises:
+    grpc.RpcError: If any of the requests fails.
+  """
+  grpc.channel_ready_future(grpc_channel).result()
+  stub = synthesis_service_pb2_grpc.SynthesisServiceStub(grpc_channel)
+  responses: List[Optional[synthesis_pb2.CompileResponse]] = (
+      [None] * len(requests))
+  futures = {}
+  next_index = 0
+  while next_index < len(requests) or futures:
+    while next_index < len(requests) and len(futures) < max_in_flight:
+      logging.info('Issuing compile request %d of %d', next_index + 1,
+                   len(requests))
+      futures[next_index] = stub.Compile.future(requests[next_index])
+      next_index += 1
+    # Wait for the oldest outstanding request. Requests may complete on the
+    # server in any order; collecting oldest-first keeps the in-flight window
+    # simple and the result order deterministic.
+    oldest = min(futures)
+    responses[oldest] = futures.pop(oldest).result()
+  return responses
+
+
 def run_bisect(start_index: int, limit_index: int, considered: Sequence[T],
                frun: Callable[[T], U],
                fresult: Callable[[T, U], bool]) -> Optional[int]:
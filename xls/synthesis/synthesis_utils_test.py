@@ -24,6 +24,7 @@ import portpicker
 from absl.testing import absltest
 from xls.common import runfiles
 from xls.synthesis import client_credentials
+from xls.synthesis import synthesis_pb2
 from xls.synthesis import synthesis_utils
 
 SERVER_PATH = runfiles.get_path('xls/synthesis/dummy_synthesis_server_main')
@@ -101,6 +102,29 @@ class SynthesisUtilsTest(absltest.TestCase):
     proc.terminate()
     proc.wait()
 
+  def test_compile_concurrently(self):
+    port, proc = self._start_server(['--max_frequency_ghz=2.0'])
+
+    requests = []
+    for ghz in (1.0, 1.5, 2.5, 3.0):
+      request = synthesis_pb2.CompileRequest()
+      request.module_text = 'verilog'
+      request.top_module_name = 'main'
+      request.target_frequency_hz = int(ghz * 1e9)
+      requests.append(request)
+
+    channel_creds = client_credentials.get_credentials()
+    with grpc.secure_channel(f'localhost:{port}', channel_creds) as channel:
+      responses = synthesis_utils.compile_concurrently(
+          requests, channel, max_in_flight=2)
+    self.assertLen(responses, 4)
+    self.assertGreaterEqual(responses[0].slack_ps, 0)
+    self.assertGreaterEqual(responses[1].slack_ps, 0)
+    self.assertLess(responses[2].slack_ps, 0)
+    self.assertLess(responses[3].slack_ps, 0)
+    proc.terminate()
+    proc.wait()
+
   def test_bisect_frequencies_with_error(self):
     port, proc = self._start_server(
         ['--max_frequency_ghz=2.0', '--serve_errors'])
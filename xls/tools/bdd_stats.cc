@@ -110,6 +110,11 @@ absl::Status RealMain(absl::string_view input_path) {
     std::cout << "BDD node count: " << bdd_function->bdd().size() << "\n";
     std::cout << "BDD variable count: " << bdd_function->bdd().variable_count()
               << "\n";
+    std::cout << "BDD reserved bytes: " << bdd_function->bdd().ReservedBytes()
+              << "\n";
+    std::cout << "BDD GC runs: " << bdd_function->bdd().gc_run_count() << "\n";
+    std::cout << "BDD nodes collected by GC: "
+              << bdd_function->bdd().collected_node_count() << "\n";
 
     int64_t number_bits = 0;
     for (Node* node : top.value()->nodes()) {
@@ -117,11 +122,7 @@ absl::Status RealMain(absl::string_view input_path) {
     }
     std::cout << "Bits in graph: " << number_bits << "\n";
 
-    int64_t max_paths = 0;
-    for (int64_t i = 0; i < bdd_function->bdd().size(); ++i) {
-      max_paths =
-          std::max(max_paths, bdd_function->bdd().path_count(BddNodeIndex(i)));
-    }
+    int64_t max_paths = bdd_function->bdd().max_path_count();
     if (max_paths == std::numeric_limits<int32_t>::max()) {
       std::cout << "Maximum paths of any expression: INT32_MAX\n";
     } else {
@@ -21,6 +21,7 @@
 #include "absl/time/clock.h"
 #include "xls/codegen/module_signature.h"
 #include "xls/codegen/pipeline_generator.h"
+#include "xls/common/allocation_accounting.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/init_xls.h"
 #include "xls/common/logging/logging.h"
@@ -451,6 +452,25 @@ absl::Status RunInterpeterAndJit(FunctionBase* function_base) {
   return absl::OkStatus();
 }
 
+// Prints the process-wide allocation counters. A no-op unless the binary was
+// built with `--define=xls_allocation_accounting=true` (see
+// xls/common/allocation_accounting.h), since the counters are all zero
+// otherwise.
+void PrintAllocationCounters() {
+  if (!AllocationAccountingEnabled()) {
+    return;
+  }
+  AllocationSnapshot snapshot = SnapshotAllocationCounters();
+  std::cout << "Accounted allocations (category: count / bytes):\n";
+  for (int64_t i = 0; i < kNumAllocationCategories; ++i) {
+    const AllocationCounters& counters = snapshot.categories[i];
+    std::cout << absl::StreamFormat(
+        "  %-8s : %10d / %10d\n",
+        AllocationCategoryName(static_cast<AllocationCategory>(i)),
+        counters.count, counters.bytes);
+  }
+}
+
 absl::Status RealMain(absl::string_view path,
                       std::optional<int64_t> clock_period_ps,
                       std::optional<int64_t> pipeline_stages,
@@ -505,6 +525,7 @@ absl::Status RealMain(absl::string_view path,
   }
 
   XLS_RETURN_IF_ERROR(RunInterpeterAndJit(f));
+  PrintAllocationCounters();
   return absl::OkStatus();
 }
 
@@ -0,0 +1,27 @@
+#!/bin/bash -e
+# Copyright 2022 The XLS Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Runs the compile-time benchmark suite over the checked-in example corpus.
+# Flags (--baseline_path, --update_baseline, --regression_factor, ...) are
+# passed through to benchmark_suite_main:
+#
+#   bazel run -c opt //xls/tools:benchmark_suite -- \
+#       --baseline_path=/path/to/baseline.textproto
+
+exec xls/tools/benchmark_suite_main "$@" \
+    xls/examples/adler32.ir \
+    xls/examples/crc32.ir \
+    xls/examples/matmul_4x4.ir \
+    xls/examples/sha256.ir
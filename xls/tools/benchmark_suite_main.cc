@@ -0,0 +1,253 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/flags/flag.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "xls/codegen/module_signature.h"
+#include "xls/codegen/pipeline_generator.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/init_xls.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/delay_model/delay_estimator.h"
+#include "xls/delay_model/delay_estimators.h"
+#include "xls/ir/function_base.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/package.h"
+#include "xls/passes/passes.h"
+#include "xls/passes/standard_pipeline.h"
+#include "xls/scheduling/pipeline_schedule.h"
+#include "xls/tools/benchmark_suite.pb.h"
+
+const char kUsage[] = R"(
+Runs the standard optimization pipeline, scheduling and codegen over a corpus
+of IR files, records per-phase compile times into a machine-readable baseline
+proto, and flags phases which regressed against an earlier baseline.
+
+Record a baseline:
+  benchmark_suite_main --update_baseline --baseline_path=baseline.textproto \
+      a.ir b.ir ...
+
+Check a toolchain against the baseline (exits nonzero on regression):
+  benchmark_suite_main --baseline_path=baseline.textproto a.ir b.ir ...
+)";
+
+ABSL_FLAG(std::string, baseline_path, "",
+          "Path of the baseline BenchmarkSuiteProto textproto to compare "
+          "against and/or update.");
+ABSL_FLAG(bool, update_baseline, false,
+          "Write the measurements of this run to --baseline_path instead of "
+          "comparing against it.");
+ABSL_FLAG(double, regression_factor, 1.5,
+          "A phase is flagged as a regression when its duration exceeds the "
+          "baseline duration by more than this factor.");
+ABSL_FLAG(int64_t, min_duration_us, 50000,
+          "Phases where both the measured and the baseline duration are below "
+          "this many microseconds are never flagged; they are too noisy to "
+          "compare.");
+ABSL_FLAG(int64_t, pipeline_stages, 5,
+          "Number of stages to schedule and generate pipelines with.");
+ABSL_FLAG(std::string, delay_model, "unit",
+          "Delay model name to use from registry.");
+
+namespace xls {
+namespace {
+
+int64_t DurationToUs(absl::Duration duration) {
+  return duration / absl::Microseconds(1);
+}
+
+void AddPhase(BenchmarkSampleProto* sample, absl::string_view name,
+              absl::Duration duration) {
+  BenchmarkPhaseProto* phase = sample->add_phases();
+  phase->set_name(std::string{name});
+  phase->set_duration_us(DurationToUs(duration));
+}
+
+// Compiles one IR file with the standard pipeline and records the phase and
+// per-pass timings.
+absl::StatusOr<BenchmarkSampleProto> RunSample(
+    const std::filesystem::path& path, const DelayEstimator& delay_estimator) {
+  BenchmarkSampleProto sample;
+  sample.set_name(path.filename().string());
+
+  XLS_ASSIGN_OR_RETURN(std::string contents, GetFileContents(path));
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                       Parser::ParsePackage(contents, path.string()));
+
+  std::unique_ptr<CompoundPass> pipeline = CreateStandardPassPipeline();
+  PassOptions pass_options;
+  PassResults pass_results;
+  absl::Time start = absl::Now();
+  XLS_RETURN_IF_ERROR(
+      pipeline->Run(package.get(), pass_options, &pass_results).status());
+  AddPhase(&sample, "optimization", absl::Now() - start);
+  sample.set_node_count(package->GetNodeCount());
+
+  // Aggregate the instrumented per-invocation durations by pass name, largest
+  // first so the baseline diffs are easy to eyeball.
+  absl::flat_hash_map<std::string, absl::Duration> pass_times;
+  for (const PassInvocation& invocation : pass_results.invocations) {
+    pass_times[invocation.pass_name] += invocation.run_duration;
+  }
+  std::vector<std::string> pass_names;
+  for (const auto& [name, duration] : pass_times) {
+    pass_names.push_back(name);
+  }
+  std::sort(pass_names.begin(), pass_names.end(),
+            [&](const std::string& a, const std::string& b) {
+              return pass_times.at(a) > pass_times.at(b);
+            });
+  for (const std::string& name : pass_names) {
+    BenchmarkPhaseProto* pass_duration = sample.add_pass_durations();
+    pass_duration->set_name(name);
+    pass_duration->set_duration_us(DurationToUs(pass_times.at(name)));
+  }
+
+  // Scheduling and codegen only handle function tops; proc samples still
+  // contribute their optimization timings.
+  std::optional<FunctionBase*> top = package->GetTop();
+  if (!top.has_value() || !(*top)->IsFunction()) {
+    return sample;
+  }
+
+  start = absl::Now();
+  XLS_ASSIGN_OR_RETURN(
+      PipelineSchedule schedule,
+      PipelineSchedule::Run(*top, delay_estimator,
+                            SchedulingOptions().pipeline_stages(
+                                absl::GetFlag(FLAGS_pipeline_stages))));
+  AddPhase(&sample, "scheduling", absl::Now() - start);
+
+  start = absl::Now();
+  XLS_RETURN_IF_ERROR(verilog::ToPipelineModuleText(
+                          schedule, *top, verilog::BuildPipelineOptions())
+                          .status());
+  AddPhase(&sample, "codegen", absl::Now() - start);
+
+  return sample;
+}
+
+// Returns the phase durations of `suite` keyed by "<sample>/<phase>".
+absl::flat_hash_map<std::string, int64_t> PhaseDurations(
+    const BenchmarkSuiteProto& suite) {
+  absl::flat_hash_map<std::string, int64_t> durations;
+  for (const BenchmarkSampleProto& sample : suite.samples()) {
+    for (const BenchmarkPhaseProto& phase : sample.phases()) {
+      durations[absl::StrFormat("%s/%s", sample.name(), phase.name())] =
+          phase.duration_us();
+    }
+  }
+  return durations;
+}
+
+// Compares the run against the baseline and prints flagged regressions.
+// Returns the number of regressions.
+int64_t CompareAgainstBaseline(const BenchmarkSuiteProto& run,
+                               const BenchmarkSuiteProto& baseline) {
+  const double regression_factor = absl::GetFlag(FLAGS_regression_factor);
+  const int64_t min_duration_us = absl::GetFlag(FLAGS_min_duration_us);
+  absl::flat_hash_map<std::string, int64_t> baseline_durations =
+      PhaseDurations(baseline);
+  int64_t regression_count = 0;
+  for (const auto& [key, duration_us] : PhaseDurations(run)) {
+    auto it = baseline_durations.find(key);
+    if (it == baseline_durations.end()) {
+      std::cout << absl::StreamFormat(
+          "NO BASELINE: %s (%dus); rerun with --update_baseline\n", key,
+          duration_us);
+      continue;
+    }
+    if (std::max(duration_us, it->second) < min_duration_us) {
+      continue;
+    }
+    if (duration_us >
+        static_cast<int64_t>(regression_factor *
+                             static_cast<double>(it->second))) {
+      std::cout << absl::StreamFormat(
+          "REGRESSION: %s: %dus vs baseline %dus (%.2fx > %.2fx)\n", key,
+          duration_us, it->second,
+          static_cast<double>(duration_us) / static_cast<double>(it->second),
+          regression_factor);
+      ++regression_count;
+    }
+  }
+  return regression_count;
+}
+
+absl::Status RealMain(absl::Span<const absl::string_view> ir_paths) {
+  XLS_ASSIGN_OR_RETURN(
+      DelayEstimator * delay_estimator,
+      GetDelayEstimator(absl::GetFlag(FLAGS_delay_model)));
+
+  BenchmarkSuiteProto run;
+  for (absl::string_view ir_path : ir_paths) {
+    XLS_ASSIGN_OR_RETURN(
+        BenchmarkSampleProto sample,
+        RunSample(std::filesystem::path(std::string{ir_path}),
+                  *delay_estimator));
+    for (const BenchmarkPhaseProto& phase : sample.phases()) {
+      std::cout << absl::StreamFormat("%s/%s: %dus\n", sample.name(),
+                                      phase.name(), phase.duration_us());
+    }
+    *run.add_samples() = std::move(sample);
+  }
+
+  const std::string baseline_path = absl::GetFlag(FLAGS_baseline_path);
+  if (baseline_path.empty()) {
+    return absl::OkStatus();
+  }
+  if (absl::GetFlag(FLAGS_update_baseline)) {
+    return SetTextProtoFile(baseline_path, run);
+  }
+  XLS_ASSIGN_OR_RETURN(BenchmarkSuiteProto baseline,
+                       ParseTextProtoFile<BenchmarkSuiteProto>(baseline_path));
+  int64_t regression_count = CompareAgainstBaseline(run, baseline);
+  if (regression_count > 0) {
+    return absl::InternalError(absl::StrFormat(
+        "%d phase(s) regressed more than %.2fx against the baseline",
+        regression_count, absl::GetFlag(FLAGS_regression_factor)));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+}  // namespace xls
+
+int main(int argc, char** argv) {
+  std::vector<absl::string_view> positional_arguments =
+      xls::InitXls(kUsage, argc, argv);
+
+  if (positional_arguments.empty()) {
+    XLS_LOG(QFATAL) << absl::StreamFormat("Expected invocation: %s <ir_paths>",
+                                          argv[0]);
+  }
+
+  XLS_QCHECK_OK(xls::RealMain(positional_arguments));
+  return 0;
+}
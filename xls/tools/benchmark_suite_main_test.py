@@ -0,0 +1,71 @@
+#
+# Copyright 2022 The XLS Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import subprocess
+
+from xls.common import runfiles
+from absl.testing import absltest
+
+BENCHMARK_SUITE_MAIN_PATH = runfiles.get_path('xls/tools/benchmark_suite_main')
+
+ADD_IR = """package foo
+
+top fn foo(x: bits[32], y: bits[32]) -> bits[32] {
+  not.1: bits[32] = not(x, id=1)
+  add.2: bits[32] = add(not.1, y, id=2)
+  ret not.3: bits[32] = not(add.2, id=3)
+}
+"""
+
+
+class BenchmarkSuiteMainTest(absltest.TestCase):
+
+  def test_records_phases(self):
+    ir_file = self.create_tempfile(content=ADD_IR)
+    output = subprocess.check_output(
+        [BENCHMARK_SUITE_MAIN_PATH, ir_file.full_path]).decode('utf-8')
+    for phase in ('optimization', 'scheduling', 'codegen'):
+      self.assertIn(phase, output)
+
+  def test_baseline_round_trip(self):
+    ir_file = self.create_tempfile(content=ADD_IR)
+    baseline_file = self.create_tempfile()
+    subprocess.check_call([
+        BENCHMARK_SUITE_MAIN_PATH, '--update_baseline',
+        '--baseline_path=' + baseline_file.full_path, ir_file.full_path
+    ])
+    with open(baseline_file.full_path) as f:
+      baseline = f.read()
+    self.assertIn('optimization', baseline)
+    self.assertIn('duration_us', baseline)
+    # A rerun against its own fresh baseline must not flag a regression (phase
+    # durations on this trivial sample are all below --min_duration_us).
+    subprocess.check_call([
+        BENCHMARK_SUITE_MAIN_PATH,
+        '--baseline_path=' + baseline_file.full_path, ir_file.full_path
+    ])
+
+  def test_missing_baseline_sample_is_flagged_but_passes(self):
+    ir_file = self.create_tempfile(content=ADD_IR)
+    baseline_file = self.create_tempfile(content='')
+    output = subprocess.check_output([
+        BENCHMARK_SUITE_MAIN_PATH, '--baseline_path=' + baseline_file.full_path,
+        ir_file.full_path
+    ]).decode('utf-8')
+    self.assertIn('NO BASELINE', output)
+
+
+if __name__ == '__main__':
+  absltest.main()
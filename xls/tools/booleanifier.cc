@@ -17,9 +17,13 @@
 // representation, i.e., consisting of only AND/OR/NOT ops.
 #include "xls/tools/booleanifier.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <filesystem>
+#include <optional>
+#include <vector>
 
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/types/span.h"
 #include "xls/common/logging/logging.h"
@@ -36,6 +40,13 @@ namespace xls {
 
 // Evaluator for converting Nodes representing high-level Ops into
 // single-bit AND/OR/NOT-based ones.
+//
+// Operations which treat every bit position independently (bitwise logic and
+// selects) are word-parallel: they emit one wide op per chunk of up to 64 bit
+// positions instead of one 1-bit op per position, which keeps the node count
+// (and booleanification time) manageable for wide bitwise-heavy functions.
+// Operations with cross-bit dataflow - adder carries, shifts, comparisons -
+// fall back to the per-bit compositions in the base class.
 class BitEvaluator : public AbstractEvaluator<Node*, BitEvaluator> {
  public:
   BitEvaluator(FunctionBuilder* builder)
@@ -55,7 +66,213 @@ class BitEvaluator : public AbstractEvaluator<Node*, BitEvaluator> {
     return builder_->Or(BValue(a, builder_), BValue(b, builder_)).node();
   }
 
+  // Word-parallel shadows of the base class's per-bit implementations. These
+  // are picked up by direct calls on the concrete evaluator type (as
+  // AbstractEvaluate makes); compositions inside the base class - the adder
+  // and shift paths - still use the per-bit versions.
+  Vector BitwiseNot(const Vector& input) {
+    Vector result;
+    result.reserve(input.size());
+    ForEachChunk(input.size(), [&](int64_t start, int64_t width) {
+      Unpack(builder_->Not(Pack(input, start, width)), &result);
+    });
+    return result;
+  }
+
+  Vector BitwiseAnd(absl::Span<const Vector> inputs) {
+    return WordParallelNaryOp(
+        inputs, [&](BValue a, BValue b) { return builder_->And(a, b); });
+  }
+  Vector BitwiseOr(absl::Span<const Vector> inputs) {
+    return WordParallelNaryOp(
+        inputs, [&](BValue a, BValue b) { return builder_->Or(a, b); });
+  }
+  Vector BitwiseXor(absl::Span<const Vector> inputs) {
+    // Composed from wide AND/OR/NOT so the result stays within the
+    // booleanifier's fundamental op set; a native xor node would not.
+    return WordParallelNaryOp(inputs, [&](BValue a, BValue b) {
+      return builder_->And(builder_->Or(a, b),
+                           builder_->Not(builder_->And(a, b)));
+    });
+  }
+  Vector BitwiseAnd(const Vector& a, const Vector& b) {
+    return BitwiseAnd({a, b});
+  }
+  Vector BitwiseOr(const Vector& a, const Vector& b) {
+    return BitwiseOr({a, b});
+  }
+  Vector BitwiseXor(const Vector& a, const Vector& b) {
+    return BitwiseXor({a, b});
+  }
+
+  Vector OneHotSelect(const Vector& selector, absl::Span<const Vector> cases,
+                      bool selector_can_be_zero) {
+    XLS_CHECK_EQ(selector.size(), cases.size());
+    XLS_CHECK_GT(selector.size(), 0);
+    const int64_t width = cases.front().size();
+    Vector result;
+    result.reserve(width);
+    ForEachChunk(width, [&](int64_t start, int64_t chunk_width) {
+      BValue acc = builder_->Literal(UBits(0, chunk_width));
+      for (int64_t i = 0; i < selector.size(); ++i) {
+        acc = builder_->Or(
+            acc, builder_->And(Pack(cases[i], start, chunk_width),
+                               Broadcast(selector[i], chunk_width)));
+      }
+      if (!selector_can_be_zero) {
+        // Mirrors the base class: when the selector cannot be zero a result
+        // bit can only be zero if some case's respective bit is zero.
+        BValue and_reduction = builder_->Literal(Bits::AllOnes(chunk_width));
+        for (int64_t i = 0; i < selector.size(); ++i) {
+          if (selector[i] != Zero()) {
+            and_reduction = builder_->And(and_reduction,
+                                          Pack(cases[i], start, chunk_width));
+          }
+        }
+        acc = builder_->Or(acc, and_reduction);
+      }
+      Unpack(acc, &result);
+    });
+    return result;
+  }
+
+  Vector PrioritySelect(const Vector& selector, absl::Span<const Vector> cases,
+                        bool selector_can_be_zero) {
+    XLS_CHECK_EQ(selector.size(), cases.size());
+    XLS_CHECK_GT(selector.size(), 0);
+    const int64_t width = cases.front().size();
+    Vector result;
+    result.reserve(width);
+    ForEachChunk(width, [&](int64_t start, int64_t chunk_width) {
+      BValue acc = builder_->Literal(UBits(0, chunk_width));
+      for (int64_t i = selector.size() - 1; i >= 0; --i) {
+        BValue sel = Broadcast(selector[i], chunk_width);
+        acc = builder_->Or(
+            builder_->And(Pack(cases[i], start, chunk_width), sel),
+            builder_->And(acc, builder_->Not(sel)));
+      }
+      if (!selector_can_be_zero) {
+        BValue and_reduction = builder_->Literal(Bits::AllOnes(chunk_width));
+        for (int64_t i = 0; i < selector.size(); ++i) {
+          if (selector[i] != Zero()) {
+            and_reduction = builder_->And(and_reduction,
+                                          Pack(cases[i], start, chunk_width));
+          }
+        }
+        acc = builder_->Or(acc, and_reduction);
+      }
+      Unpack(acc, &result);
+    });
+    return result;
+  }
+
+  Vector Select(const Vector& selector, absl::Span<const Vector> cases,
+                std::optional<const Vector> default_value = absl::nullopt) {
+    // Same one-hot reduction as the base class, but feeding the word-parallel
+    // OneHotSelect above. The selector comparisons stay per-bit; they are as
+    // narrow as the selector itself.
+    Vector one_hot_selector;
+    for (int64_t i = 0; i < cases.size(); ++i) {
+      one_hot_selector.push_back(
+          Equals(selector, BitsToVector(UBits(i, selector.size()))));
+    }
+    std::vector<Vector> cases_vec(cases.begin(), cases.end());
+    if (default_value.has_value()) {
+      one_hot_selector.push_back(ULessThan(
+          BitsToVector(UBits(cases.size() - 1, selector.size())), selector));
+      cases_vec.push_back(*default_value);
+    }
+    return OneHotSelect(one_hot_selector, cases_vec,
+                        /*selector_can_be_zero=*/false);
+  }
+
  private:
+  // Number of bit positions processed per emitted wide op.
+  static constexpr int64_t kWordBits = 64;
+
+  // Invokes f(start, width) for each chunk of up to kWordBits bit positions.
+  void ForEachChunk(int64_t width,
+                    absl::FunctionRef<void(int64_t, int64_t)> f) {
+    for (int64_t start = 0; start < width; start += kWordBits) {
+      f(start, std::min(kWordBits, width - start));
+    }
+  }
+
+  // Reassembles a chunk of 1-bit nodes into one wide value. When the bits are
+  // consecutive single-bit slices of the same node - the common case in a
+  // chain of word-parallel ops, whose outputs are unpacked with Unpack below -
+  // the pack is a single slice of that node rather than a concat, so chained
+  // bitwise ops cost one wide op per chunk.
+  BValue Pack(const Vector& bits, int64_t start, int64_t width) {
+    if (width == 1) {
+      return BValue(bits[start], builder_);
+    }
+    Node* source = nullptr;
+    int64_t source_start = 0;
+    bool consecutive = bits[start]->Is<xls::BitSlice>() &&
+                       bits[start]->As<xls::BitSlice>()->width() == 1;
+    if (consecutive) {
+      source = bits[start]->operand(0);
+      source_start = bits[start]->As<xls::BitSlice>()->start();
+      for (int64_t i = 1; i < width; ++i) {
+        Node* bit = bits[start + i];
+        if (!bit->Is<xls::BitSlice>() || bit->operand(0) != source ||
+            bit->As<xls::BitSlice>()->width() != 1 ||
+            bit->As<xls::BitSlice>()->start() != source_start + i) {
+          consecutive = false;
+          break;
+        }
+      }
+    }
+    if (consecutive) {
+      return builder_->BitSlice(BValue(source, builder_), source_start, width);
+    }
+    // Concat operands are given most-significant first.
+    std::vector<BValue> parts;
+    parts.reserve(width);
+    for (int64_t i = width - 1; i >= 0; --i) {
+      parts.push_back(BValue(bits[start + i], builder_));
+    }
+    return builder_->Concat(parts);
+  }
+
+  // Appends the bits of a wide value to 'result' as 1-bit nodes.
+  void Unpack(BValue word, Vector* result) {
+    const int64_t width = word.BitCountOrDie();
+    if (width == 1) {
+      result->push_back(word.node());
+      return;
+    }
+    for (int64_t i = 0; i < width; ++i) {
+      result->push_back(builder_->BitSlice(word, i, 1).node());
+    }
+  }
+
+  // Replicates a single bit across 'width' positions.
+  BValue Broadcast(Node* bit, int64_t width) {
+    if (width == 1) {
+      return BValue(bit, builder_);
+    }
+    std::vector<BValue> parts(width, BValue(bit, builder_));
+    return builder_->Concat(parts);
+  }
+
+  Vector WordParallelNaryOp(absl::Span<const Vector> inputs,
+                            absl::FunctionRef<BValue(BValue, BValue)> f) {
+    XLS_CHECK_GT(inputs.size(), 0);
+    const int64_t width = inputs.front().size();
+    Vector result;
+    result.reserve(width);
+    ForEachChunk(width, [&](int64_t start, int64_t chunk_width) {
+      BValue acc = Pack(inputs.front(), start, chunk_width);
+      for (int64_t i = 1; i < inputs.size(); ++i) {
+        acc = f(acc, Pack(inputs[i], start, chunk_width));
+      }
+      Unpack(acc, &result);
+    });
+    return result;
+  }
+
   FunctionBuilder* builder_;
   BValue one_;
   BValue zero_;
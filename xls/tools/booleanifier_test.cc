@@ -22,6 +22,7 @@
 #include "xls/common/file/get_runfile_path.h"
 #include "xls/common/status/matchers.h"
 #include "xls/interpreter/function_interpreter.h"
+#include "xls/ir/bits_ops.h"
 #include "xls/ir/ir_test_base.h"
 #include "xls/jit/function_jit.h"
 
@@ -91,6 +92,41 @@ TEST_F(BooleanifierTest, Crc32_Jit) {
   }
 }
 
+// Exercises the word-parallel paths in the evaluator - wide bitwise ops and
+// selects - at a width spanning multiple 64-bit chunks.
+TEST_F(BooleanifierTest, WideBitwiseOpsAndSelect) {
+  const std::string kIrText = R"(
+package p
+
+fn main(a: bits[96], b: bits[96], c: bits[96], s: bits[2]) -> bits[96] {
+  anded: bits[96] = and(a, b)
+  ored: bits[96] = or(a, c)
+  xored: bits[96] = xor(anded, ored, c)
+  notted: bits[96] = not(xored)
+  ret out: bits[96] = sel(s, cases=[anded, ored, xored], default=notted)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(FunctionData fd, GetFunctionData(kIrText, "main"));
+  XLS_ASSERT_OK_AND_ASSIGN(auto fancy_jit, FunctionJit::Create(fd.source));
+  XLS_ASSERT_OK_AND_ASSIGN(auto basic_jit, FunctionJit::Create(fd.boolified));
+
+  auto wide_value = [](uint64_t hi, uint64_t lo) {
+    return Value(bits_ops::Concat({UBits(hi, 32), UBits(lo, 64)}));
+  };
+  std::vector<Value> inputs(4);
+  inputs[0] = wide_value(0xdeadbeef, 0x0123456789abcdefull);
+  inputs[1] = wide_value(0x12345678, 0xfedcba9876543210ull);
+  inputs[2] = wide_value(0xa5a5a5a5, 0x5a5a5a5a5a5a5a5aull);
+  for (int s = 0; s < 4; ++s) {
+    inputs[3] = Value(UBits(s, 2));
+    XLS_ASSERT_OK_AND_ASSIGN(Value fancy_value,
+                             DropInterpreterEvents(fancy_jit->Run(inputs)));
+    XLS_ASSERT_OK_AND_ASSIGN(Value basic_value,
+                             DropInterpreterEvents(basic_jit->Run(inputs)));
+    ASSERT_EQ(fancy_value, basic_value);
+  }
+}
+
 // This test verifies that the Boolifier can properly handle extracting from
 // and packing into tuples.
 TEST_F(BooleanifierTest, MarshalsTuples) {
@@ -12,12 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <memory>
+#include <random>
 #include <thread>  // NOLINT(build/c++11)
 
 #include "absl/base/internal/sysinfo.h"
 #include "absl/flags/flag.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/file/get_runfile_path.h"
@@ -25,8 +28,14 @@
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
+#include "xls/interpreter/random_value.h"
+#include "xls/ir/events.h"
+#include "xls/ir/function_builder.h"
 #include "xls/ir/ir_parser.h"
 #include "xls/ir/package.h"
+#include "xls/jit/function_jit.h"
+#include "xls/passes/bdd_function.h"
 #include "xls/passes/dce_pass.h"
 #include "xls/passes/inlining_pass.h"
 #include "xls/passes/map_inlining_pass.h"
@@ -46,6 +55,12 @@ prove that optimizations are safe - that they don't change program outputs.
 Example invocation:
   check_ir_equivalence_main <IR file> <IR file>
 
+If more than two files are given, the first is the baseline and every
+subsequent file is checked against it in turn. The baseline is translated to
+Z3 once and each candidate is checked under a solver push/pop scope, so
+repeated checks against the same baseline (e.g. driven by ir_minimizer_main)
+pay the baseline translation cost only once per invocation.
+
 If there are multiple functions in the specified files, then it's _strongly_
 recommended that you specify --function to ensure that the right functions are
 compared. If the tool picks the wrong one, a crash may result.
@@ -59,6 +74,11 @@ ABSL_FLAG(std::string, top, "",
 ABSL_FLAG(absl::Duration, timeout, absl::InfiniteDuration(),
           "How long to wait for any proof to complete.");
 // LINT.ThenChange(//xls/build_rules/xls_ir_rules.bzl)
+ABSL_FLAG(bool, portfolio, false,
+          "Run quick engines (random JIT simulation, then BDD comparison) "
+          "concurrently with the Z3 proof and report whichever decides "
+          "first. The quick engines interrupt the Z3 query when they reach "
+          "a verdict; Z3 remains the backstop for cases they cannot decide.");
 
 namespace xls {
 
@@ -79,8 +99,137 @@ absl::StatusOr<Z3_ast> CreateComparisonFunction(
   return Z3_mk_eq(ctx, result1, result2);
 }
 
+// Z3 doesn't handle directly-specified (as AST nodes) subroutines - there is
+// some support for recursive functions (with bodies), but it hasn't behaved
+// like we've expected.
+//
+// To work around this, we have to inline such calls.
+// Fortunately, inlining is pretty simple and unlikely to change semantics.
+// TODO(b/154025625): Replace this with a new InliningPass.
+absl::Status InlineEverything(Package* package) {
+  CompoundPass inlining_passes("inlining_passes", "All inlining passes.");
+  inlining_passes.Add<MapInliningPass>();
+  inlining_passes.Add<UnrollPass>();
+  inlining_passes.Add<InliningPass>();
+  inlining_passes.Add<DeadCodeEliminationPass>();
+  PassOptions options;
+  PassResults results;
+  bool keep_going = true;
+  while (keep_going) {
+    XLS_ASSIGN_OR_RETURN(keep_going,
+                         inlining_passes.Run(package, options, &results));
+  }
+  return absl::OkStatus();
+}
+
+// Verdict of one portfolio engine. The quick engines may be unable to decide
+// (simulation can only refute; BDDs saturate on large expressions), in which
+// case the Z3 proof is the backstop.
+enum class EngineVerdict { kUnknown, kEquivalent, kNotEquivalent };
+
+struct PortfolioResult {
+  EngineVerdict verdict = EngineVerdict::kUnknown;
+  std::string message;
+};
+
+// Runs both functions on random argument sets through the JIT; any mismatch
+// refutes equivalence immediately.
+absl::StatusOr<PortfolioResult> RunRandomSimulation(Function* base,
+                                                    Function* candidate) {
+  constexpr int64_t kNumSamples = 1024;
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<FunctionJit> base_jit,
+                       FunctionJit::Create(base));
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<FunctionJit> candidate_jit,
+                       FunctionJit::Create(candidate));
+  std::minstd_rand engine;
+  for (int64_t i = 0; i < kNumSamples; ++i) {
+    std::vector<Value> args = RandomFunctionArguments(base, &engine);
+    XLS_ASSIGN_OR_RETURN(InterpreterResult<Value> base_result,
+                         base_jit->Run(args));
+    XLS_ASSIGN_OR_RETURN(InterpreterResult<Value> candidate_result,
+                         candidate_jit->Run(args));
+    if (base_result.value != candidate_result.value) {
+      PortfolioResult result;
+      result.verdict = EngineVerdict::kNotEquivalent;
+      result.message = absl::StrCat(
+          "Verified NOT equivalent (simulation counterexample)\n  args: ",
+          absl::StrJoin(args, ", ",
+                        [](std::string* out, const Value& value) {
+                          absl::StrAppend(out, value.ToString());
+                        }),
+          "\n  base: ", base_result.value.ToString(),
+          "\n  candidate: ", candidate_result.value.ToString());
+      return result;
+    }
+  }
+  return PortfolioResult();
+}
+
+// Builds eq(base(x), candidate(x)) in a scratch package and evaluates it as a
+// BDD under the default path/op budgets. Can both prove and refute
+// equivalence, but saturates to "unknown" on expressions that exceed the
+// budgets.
+absl::StatusOr<PortfolioResult> RunBddComparison(Function* base,
+                                                 Function* candidate) {
+  if (!base->return_value()->GetType()->IsBits()) {
+    return PortfolioResult();
+  }
+  Package package("bdd_comparison");
+  XLS_ASSIGN_OR_RETURN(Function * base_clone,
+                       base->Clone("portfolio_base", &package));
+  XLS_ASSIGN_OR_RETURN(Function * candidate_clone,
+                       candidate->Clone("portfolio_candidate", &package));
+  FunctionBuilder fb("portfolio_eq", &package);
+  std::vector<BValue> params;
+  for (Param* param : base->params()) {
+    XLS_ASSIGN_OR_RETURN(Type * type,
+                         package.MapTypeFromOtherPackage(param->GetType()));
+    params.push_back(fb.Param(param->name(), type));
+  }
+  BValue eq = fb.Eq(fb.Invoke(params, base_clone),
+                    fb.Invoke(params, candidate_clone));
+  XLS_ASSIGN_OR_RETURN(Function * eq_function, fb.BuildWithReturnValue(eq));
+  XLS_RETURN_IF_ERROR(InlineEverything(&package));
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<BddFunction> bdd_function,
+      BddFunction::Run(eq_function, BddFunction::kDefaultPathLimit,
+                       /*node_filter=*/absl::nullopt,
+                       BddFunction::kDefaultOpBudget));
+  BddNodeIndex result =
+      bdd_function->GetBddNode(eq_function->return_value(), 0);
+  PortfolioResult portfolio_result;
+  if (result == bdd_function->bdd().one()) {
+    portfolio_result.verdict = EngineVerdict::kEquivalent;
+    portfolio_result.message = "Verified equivalent (BDD comparison)";
+  } else if (result == bdd_function->bdd().zero()) {
+    portfolio_result.verdict = EngineVerdict::kNotEquivalent;
+    portfolio_result.message = "Verified NOT equivalent (BDD comparison)";
+  }
+  return portfolio_result;
+}
+
+// Runs the quick engines in order of expected cost; each can be inconclusive.
+PortfolioResult RunPortfolioEngines(Function* base, Function* candidate) {
+  absl::StatusOr<PortfolioResult> simulation =
+      RunRandomSimulation(base, candidate);
+  if (simulation.ok()) {
+    if (simulation->verdict != EngineVerdict::kUnknown) {
+      return *simulation;
+    }
+  } else {
+    XLS_LOG(WARNING) << "Portfolio simulation failed: " << simulation.status();
+  }
+  absl::StatusOr<PortfolioResult> bdd = RunBddComparison(base, candidate);
+  if (bdd.ok()) {
+    return *bdd;
+  }
+  XLS_LOG(WARNING) << "Portfolio BDD comparison failed: " << bdd.status();
+  return PortfolioResult();
+}
+
 absl::Status RealMain(const std::vector<absl::string_view>& ir_paths,
-                      const std::string& entry, absl::Duration timeout) {
+                      const std::string& entry, absl::Duration timeout,
+                      bool portfolio) {
   std::vector<std::unique_ptr<Package>> packages;
   for (const auto ir_path : ir_paths) {
     XLS_ASSIGN_OR_RETURN(std::string ir_text, GetFileContents(ir_path));
@@ -91,26 +240,8 @@ absl::Status RealMain(const std::vector<absl::string_view>& ir_paths,
     packages.push_back(std::move(package));
   }
 
-  // Z3 doesn't handle directly-specified (as AST nodes) subroutines - there is
-  // some support for recursive functions (with bodies), but it hasn't behaved
-  // like we've expected.
-  //
-  // To work around this, we have to inline such calls.
-  // Fortunately, inlining is pretty simple and unlikely to change semantics.
-  // TODO(b/154025625): Replace this with a new InliningPass.
-  CompoundPass inlining_passes("inlining_passes", "All inlining passes.");
-  inlining_passes.Add<MapInliningPass>();
-  inlining_passes.Add<UnrollPass>();
-  inlining_passes.Add<InliningPass>();
-  inlining_passes.Add<DeadCodeEliminationPass>();
-  PassOptions options;
-  PassResults results;
   for (const auto& package : packages) {
-    bool keep_going = true;
-    while (keep_going) {
-      XLS_ASSIGN_OR_RETURN(
-          keep_going, inlining_passes.Run(package.get(), options, &results));
-    }
+    XLS_RETURN_IF_ERROR(InlineEverything(package.get()));
   }
 
   std::vector<Function*> functions;
@@ -119,12 +250,16 @@ absl::Status RealMain(const std::vector<absl::string_view>& ir_paths,
     functions.push_back(func);
   }
 
+  // The baseline (first) function is translated once; every candidate shares
+  // its context (and thus its translated AST) and is checked under a solver
+  // push/pop scope, so back-to-back checks against the same baseline only pay
+  // for the candidate's cone.
   std::vector<std::unique_ptr<IrTranslator>> translators;
-  XLS_ASSIGN_OR_RETURN(std::unique_ptr<IrTranslator> translator,
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<IrTranslator> base_translator,
                        IrTranslator::CreateAndTranslate(functions[0]));
-  translators.push_back(std::move(translator));
+  translators.push_back(std::move(base_translator));
 
-  // Get the params for the first function, so we can map the second function's
+  // Get the params for the first function, so we can map the other functions'
   // parameters to them.
   Z3_context ctx = translators[0]->ctx();
   std::vector<Z3_ast> z3_params;
@@ -132,29 +267,64 @@ absl::Status RealMain(const std::vector<absl::string_view>& ir_paths,
     z3_params.push_back(translators[0]->GetTranslation(param));
   }
 
-  XLS_ASSIGN_OR_RETURN(
-      translator, IrTranslator::CreateAndTranslate(ctx, functions[1],
-                                                   absl::MakeSpan(z3_params)));
-  translators.push_back(std::move(translator));
-
-  XLS_ASSIGN_OR_RETURN(
-      Z3_ast results_equal,
-      CreateComparisonFunction(absl::MakeSpan(translators), functions));
   translators[0]->SetTimeout(timeout);
 
   Z3_solver solver =
       solvers::z3::CreateSolver(ctx, std::thread::hardware_concurrency());
 
-  // Remember: we try to prove the condition by searching for a model that
-  // produces the opposite result. Thus, we want to find a model where the
-  // results are _not_ equal.
-  Z3_ast objective = Z3_mk_eq(ctx, Z3_mk_false(ctx), results_equal);
-  Z3_solver_assert(ctx, solver, objective);
+  for (int i = 1; i < functions.size(); i++) {
+    XLS_ASSIGN_OR_RETURN(
+        std::unique_ptr<IrTranslator> translator,
+        IrTranslator::CreateAndTranslate(ctx, functions[i],
+                                         absl::MakeSpan(z3_params)));
+    translators.resize(1);
+    translators.push_back(std::move(translator));
+
+    XLS_ASSIGN_OR_RETURN(
+        Z3_ast results_equal,
+        CreateComparisonFunction(absl::MakeSpan(translators), functions));
+
+    // Remember: we try to prove the condition by searching for a model that
+    // produces the opposite result. Thus, we want to find a model where the
+    // results are _not_ equal.
+    Z3_ast objective = Z3_mk_eq(ctx, Z3_mk_false(ctx), results_equal);
+    Z3_solver_push(ctx, solver);
+    Z3_solver_assert(ctx, solver, objective);
 
-  // Finally, print the output to the terminal in gorgeous two-color ASCII.
-  Z3_lbool satisfiable = Z3_solver_check(ctx, solver);
-  std::cout << solvers::z3::SolverResultToString(ctx, solver, satisfiable)
-            << std::endl;
+    // Race the quick engines against the Z3 proof; whichever reaches a
+    // verdict first wins, and a quick verdict interrupts the Z3 query.
+    PortfolioResult portfolio_result;
+    std::unique_ptr<Thread> portfolio_thread;
+    if (portfolio) {
+      Function* base = functions[0];
+      Function* candidate = functions[i];
+      portfolio_thread = std::make_unique<Thread>(
+          [&portfolio_result, base, candidate, ctx]() {
+            portfolio_result = RunPortfolioEngines(base, candidate);
+            if (portfolio_result.verdict != EngineVerdict::kUnknown) {
+              Z3_interrupt(ctx);
+            }
+          });
+    }
+
+    // Finally, print the output to the terminal in gorgeous two-color ASCII.
+    Z3_lbool satisfiable = Z3_solver_check(ctx, solver);
+    if (portfolio_thread != nullptr) {
+      portfolio_thread->Join();
+    }
+    if (ir_paths.size() > 2) {
+      std::cout << ir_paths[0] << " vs " << ir_paths[i] << ":" << std::endl;
+    }
+    if (satisfiable == Z3_L_UNDEF &&
+        portfolio_result.verdict != EngineVerdict::kUnknown) {
+      // The quick engines decided first (and interrupted the proof).
+      std::cout << portfolio_result.message << std::endl;
+    } else {
+      std::cout << solvers::z3::SolverResultToString(ctx, solver, satisfiable)
+                << std::endl;
+    }
+    Z3_solver_pop(ctx, solver, 1);
+  }
 
   Z3_solver_dec_ref(ctx, solver);
 
@@ -166,7 +336,9 @@ absl::Status RealMain(const std::vector<absl::string_view>& ir_paths,
 int main(int argc, char** argv) {
   std::vector<absl::string_view> positional_args =
       xls::InitXls(kUsage, argc, argv);
-  XLS_QCHECK_EQ(positional_args.size(), 2) << "Two IR files must be specified!";
+  XLS_QCHECK_GE(positional_args.size(), 2)
+      << "At least two IR files must be specified!";
   XLS_QCHECK_OK(xls::RealMain(positional_args, absl::GetFlag(FLAGS_top),
-                              absl::GetFlag(FLAGS_timeout)));
+                              absl::GetFlag(FLAGS_timeout),
+                              absl::GetFlag(FLAGS_portfolio)));
 }
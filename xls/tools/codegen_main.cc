@@ -28,6 +28,7 @@
 #include "xls/common/status/status_macros.h"
 #include "xls/delay_model/delay_estimator.h"
 #include "xls/delay_model/delay_estimators.h"
+#include "xls/ir/ir_binary.h"
 #include "xls/ir/ir_parser.h"
 #include "xls/ir/verifier.h"
 #include "xls/passes/standard_pipeline.h"
@@ -100,6 +101,11 @@ ABSL_FLAG(std::string, flop_outputs_kind, "flop",
 ABSL_FLAG(bool, flop_single_value_channels, true,
           "If false, flop_inputs() and flop_outputs() will not flop"
           "single value channels");
+ABSL_FLAG(bool, flop_stage_ready, false,
+          "If true, a skid buffer is inserted at each internal pipeline stage "
+          "boundary so the backpressure (ready) signal of each stage is "
+          "registered rather than chaining combinationally through the "
+          "pipeline. Only used with ready/valid flow control.");
 ABSL_FLAG(bool, add_idle_output, false,
           "If true, an additional idle signal tied to valids of input and "
           "flops is added to the block. This output signal is not registered, "
@@ -203,6 +209,7 @@ absl::StatusOr<verilog::CodegenOptions> GetCodegenOptions() {
 
     options.flop_single_value_channels(
         absl::GetFlag(FLAGS_flop_single_value_channels));
+    options.flop_stage_ready(absl::GetFlag(FLAGS_flop_stage_ready));
     options.add_idle_output(absl::GetFlag(FLAGS_add_idle_output));
 
     if (!absl::GetFlag(FLAGS_reset).empty()) {
@@ -291,7 +298,7 @@ absl::Status RealMain(absl::string_view ir_path, absl::string_view verilog_path,
 
   XLS_ASSIGN_OR_RETURN(std::string ir_contents, GetFileContents(ir_path));
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> p,
-                       Parser::ParsePackage(ir_contents, ir_path));
+                       ParsePackageAnyFormat(ir_contents, ir_path));
   verilog::ModuleGeneratorResult result;
 
   XLS_RETURN_IF_ERROR(VerifyPackage(p.get(), /*codegen=*/true));
@@ -299,6 +306,8 @@ absl::Status RealMain(absl::string_view ir_path, absl::string_view verilog_path,
   XLS_ASSIGN_OR_RETURN(FunctionBase * main, FindEntry(p.get()));
   XLS_ASSIGN_OR_RETURN(verilog::CodegenOptions codegen_options,
                        GetCodegenOptions());
+  // Only pay for line-map construction when the map is actually written out.
+  codegen_options.emit_line_maps(!verilog_line_map_path.empty());
 
   if (absl::GetFlag(FLAGS_generator) == "pipeline") {
     XLS_QCHECK(absl::GetFlag(FLAGS_pipeline_stages) != 0 ||
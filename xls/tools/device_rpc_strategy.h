@@ -15,6 +15,8 @@
 #ifndef XLS_TOOLS_DEVICE_RPC_STRATEGY_H_
 #define XLS_TOOLS_DEVICE_RPC_STRATEGY_H_
 
+#include <vector>
+
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
@@ -38,6 +40,26 @@ class DeviceRpcStrategy {
   // Calls an unnamed function on the device.
   virtual absl::StatusOr<Value> CallUnnamed(
       const FunctionType& function_type, absl::Span<const Value> arguments) = 0;
+
+  // Calls an unnamed function on the device once per argument set in
+  // "arguments_batch" and returns one result per set, in order. The default
+  // implementation performs one CallUnnamed round trip per set; strategies
+  // with a high per-call latency may override this to pack many argument
+  // records per transfer.
+  virtual absl::StatusOr<std::vector<Value>> CallUnnamedBatch(
+      const FunctionType& function_type,
+      absl::Span<const std::vector<Value>> arguments_batch) {
+    std::vector<Value> results;
+    results.reserve(arguments_batch.size());
+    for (const std::vector<Value>& arguments : arguments_batch) {
+      absl::StatusOr<Value> result = CallUnnamed(function_type, arguments);
+      if (!result.ok()) {
+        return result.status();
+      }
+      results.push_back(std::move(result).value());
+    }
+    return results;
+  }
 };
 
 }  // namespace xls
@@ -20,8 +20,11 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "xls/common/file/filesystem.h"
+#include "xls/common/file/memory_mapped_file.h"
 #include "xls/common/init_xls.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
@@ -31,10 +34,14 @@
 #include "xls/dslx/ir_converter.h"
 #include "xls/dslx/mangle.h"
 #include "xls/dslx/parse_and_typecheck.h"
+#include "xls/interpreter/evaluation_plan.h"
 #include "xls/interpreter/function_interpreter.h"
 #include "xls/interpreter/ir_interpreter.h"
 #include "xls/interpreter/random_value.h"
+#include "xls/ir/ir_binary.h"
 #include "xls/ir/ir_parser.h"
+#include "xls/ir/packed_args_file.h"
+#include "xls/ir/packed_value.h"
 #include "xls/ir/value_helpers.h"
 #include "xls/jit/function_jit.h"
 #include "xls/passes/passes.h"
@@ -115,6 +122,27 @@ ABSL_FLAG(
     "When specified with --optimize_ir, run evaluation after each pass. "
     "A non-zero error status is returned if any of the results do not match.");
 ABSL_FLAG(bool, use_llvm_jit, true, "Use the LLVM IR JIT for execution.");
+ABSL_FLAG(bool, use_packed_views, false,
+          "Evaluate via the JIT's packed-view entry point: arguments are "
+          "converted to flat packed buffers once and results are unpacked "
+          "only for printing and comparison, avoiding per-evaluation Value "
+          "tree construction. Only used with --use_llvm_jit.");
+ABSL_FLAG(std::string, packed_input_file, "",
+          "Streaming mode: path to a binary file of concatenated packed "
+          "argument records (each record is the packed representations of all "
+          "arguments, back to back), either headerless or a self-describing "
+          "packed args file (see xls/ir/packed_args_file.h) whose header "
+          "types are checked against the function signature. The file is "
+          "memory-mapped and fed to the JIT's batched entry point, so memory "
+          "stays bounded regardless of the sample count. Cannot be combined "
+          "with --input, --input_file, --random_inputs or the expected-value "
+          "flags.");
+ABSL_FLAG(std::string, packed_output_file, "",
+          "Streaming mode: path to append packed result records to. Must be "
+          "specified with --packed_input_file.");
+ABSL_FLAG(int64_t, streaming_batch_size, 4096,
+          "Streaming mode: number of samples evaluated per batched JIT call; "
+          "bounds the size of the in-memory result buffer.");
 ABSL_FLAG(bool, test_llvm_jit, false,
           "If true, then run the JIT and compare the results against the "
           "interpereter.");
@@ -159,6 +187,32 @@ std::string ArgsToString(absl::Span<const Value> args) {
   return absl::StrJoin(args, "; ", ValueFormatterHex);
 }
 
+// Runs the function via the JIT's packed-view entry point. The arguments are
+// converted to flat packed buffers and the packed result buffer is unpacked
+// only to produce the returned Value; no Value trees are materialized during
+// evaluation itself.
+absl::StatusOr<Value> RunPacked(FunctionJit* jit, Function* f,
+                                absl::Span<const Value> args) {
+  XLS_RET_CHECK_EQ(args.size(), f->params().size());
+  std::vector<PackedValue> packed_args;
+  std::vector<const uint8_t*> arg_buffers;
+  packed_args.reserve(args.size());
+  for (int64_t i = 0; i < args.size(); ++i) {
+    XLS_ASSIGN_OR_RETURN(
+        PackedValue packed,
+        PackedValue::FromValue(args[i], f->params()[i]->GetType()));
+    packed_args.push_back(std::move(packed));
+    arg_buffers.push_back(packed_args.back().buffer());
+  }
+  std::vector<uint8_t> result_buffer(jit->GetPackedResultRecordSize());
+  XLS_RETURN_IF_ERROR(
+      jit->RunWithPackedBuffers(arg_buffers, absl::MakeSpan(result_buffer)));
+  XLS_ASSIGN_OR_RETURN(
+      PackedValue packed_result,
+      PackedValue::FromBuffer(result_buffer, f->return_value()->GetType()));
+  return packed_result.ToValue();
+}
+
 // Evaluates the function with the given ArgSets. Returns an error if the result
 // does not match expectations (if any). 'actual_src' and 'expected_src' are
 // string descriptions of the sources of the actual results and expected
@@ -168,10 +222,15 @@ absl::StatusOr<std::vector<Value>> Eval(
     absl::string_view actual_src = "actual",
     absl::string_view expected_src = "expected") {
   std::unique_ptr<FunctionJit> jit;
+  std::unique_ptr<EvaluationPlan> plan;
   if (use_jit) {
     // No support for procs yet.
     XLS_ASSIGN_OR_RETURN(
         jit, FunctionJit::Create(f, absl::GetFlag(FLAGS_llvm_opt_level)));
+  } else {
+    // Compile the interpretation pre-passes (topological order, dense value
+    // slots) once rather than per arg set.
+    XLS_ASSIGN_OR_RETURN(plan, EvaluationPlan::Create(f));
   }
 
   std::vector<Value> results;
@@ -179,8 +238,12 @@ absl::StatusOr<std::vector<Value>> Eval(
     Value result;
     if (use_jit) {
       if (absl::GetFlag(FLAGS_test_only_inject_jit_result).empty()) {
-        XLS_ASSIGN_OR_RETURN(result,
-                             DropInterpreterEvents(jit->Run(arg_set.args)));
+        if (absl::GetFlag(FLAGS_use_packed_views)) {
+          XLS_ASSIGN_OR_RETURN(result, RunPacked(jit.get(), f, arg_set.args));
+        } else {
+          XLS_ASSIGN_OR_RETURN(result,
+                               DropInterpreterEvents(jit->Run(arg_set.args)));
+        }
       } else {
         XLS_ASSIGN_OR_RETURN(result, Parser::ParseTypedValue(absl::GetFlag(
                                          FLAGS_test_only_inject_jit_result)));
@@ -190,8 +253,8 @@ absl::StatusOr<std::vector<Value>> Eval(
       // resulting events once the JIT fully supports events. Note: This will
       // require rethinking some of the control flow because event comparison
       // only makes sense for certain modes (optimize_ir and test_llvm_jit).
-      XLS_ASSIGN_OR_RETURN(
-          result, DropInterpreterEvents(InterpretFunction(f, arg_set.args)));
+      XLS_ASSIGN_OR_RETURN(result,
+                           DropInterpreterEvents(plan->Run(arg_set.args)));
     }
     std::cout << result.ToString(FormatPreference::kHex) << std::endl;
 
@@ -239,6 +302,89 @@ class EvalInvariantChecker : public InvariantChecker {
   bool use_jit_;
 };
 
+// Streaming mode: memory-maps the packed input file, evaluates it through the
+// JIT's batched entry point in bounded-size chunks and appends the packed
+// result records to the output file. Only the mapped working set and one
+// batch of results are ever resident.
+absl::Status RunStreaming(Package* package) {
+  XLS_ASSIGN_OR_RETURN(Function * f, package->GetTopAsFunction());
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<FunctionJit> jit,
+      FunctionJit::Create(f, absl::GetFlag(FLAGS_llvm_opt_level)));
+  XLS_ASSIGN_OR_RETURN(
+      MemoryMappedFile input,
+      MemoryMappedFile::Open(absl::GetFlag(FLAGS_packed_input_file)));
+
+  const int64_t arg_record_size = jit->GetPackedArgumentRecordSize();
+  const int64_t result_record_size = jit->GetPackedResultRecordSize();
+  XLS_RET_CHECK_GT(arg_record_size, 0);
+  const uint8_t* input_records;
+  int64_t sample_count;
+  if (IsPackedArgsFile(input.data())) {
+    // Self-describing packed args file: validate the header types against the
+    // function signature instead of trusting the byte count.
+    XLS_ASSIGN_OR_RETURN(PackedArgsFileLayout layout,
+                         ParsePackedArgsFileHeader(input.data(), package));
+    if (static_cast<int64_t>(layout.arg_types.size()) != f->params().size()) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Packed input file holds %d arguments per record but %s takes %d",
+          layout.arg_types.size(), f->name(), f->params().size()));
+    }
+    for (int64_t i = 0; i < static_cast<int64_t>(f->params().size()); ++i) {
+      if (layout.arg_types[i] != f->params()[i]->GetType()) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "Argument %d of the packed input file has type %s but %s "
+            "expects %s",
+            i, layout.arg_types[i]->ToString(), f->name(),
+            f->params()[i]->GetType()->ToString()));
+      }
+    }
+    XLS_RET_CHECK_EQ(layout.record_stride, arg_record_size);
+    input_records = reinterpret_cast<const uint8_t*>(input.data().data()) +
+                    layout.payload_offset;
+    sample_count = layout.record_count;
+  } else {
+    // Headerless file of raw records; the sample count is implied by the
+    // byte count.
+    if (input.data().size() % arg_record_size != 0) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Size of packed input file %s (%d bytes) is not a multiple of the "
+          "packed argument record size (%d bytes)",
+          absl::GetFlag(FLAGS_packed_input_file), input.data().size(),
+          arg_record_size));
+    }
+    input_records = reinterpret_cast<const uint8_t*>(input.data().data());
+    sample_count = static_cast<int64_t>(input.data().size()) / arg_record_size;
+  }
+  const int64_t batch_size =
+      std::max<int64_t>(int64_t{1}, absl::GetFlag(FLAGS_streaming_batch_size));
+  const std::filesystem::path output_path =
+      absl::GetFlag(FLAGS_packed_output_file);
+
+  const uint8_t* input_base = input_records;
+  std::vector<uint8_t> result_buffer(batch_size * result_record_size);
+  absl::Time start = absl::Now();
+  for (int64_t done = 0; done < sample_count; done += batch_size) {
+    const int64_t count = std::min(batch_size, sample_count - done);
+    XLS_RETURN_IF_ERROR(jit->RunBatched(
+        absl::MakeConstSpan(input_base + done * arg_record_size,
+                            count * arg_record_size),
+        absl::MakeSpan(result_buffer.data(), count * result_record_size),
+        count));
+    XLS_RETURN_IF_ERROR(AppendStringToFile(
+        output_path,
+        absl::string_view(reinterpret_cast<const char*>(result_buffer.data()),
+                          count * result_record_size)));
+  }
+  absl::Duration elapsed = absl::Now() - start;
+  std::cout << absl::StreamFormat(
+      "Evaluated %d samples in %s (%.0f samples/sec)\n", sample_count,
+      absl::FormatDuration(elapsed),
+      static_cast<double>(sample_count) /
+          std::max(absl::ToDoubleSeconds(elapsed), 1e-9));
+  return absl::OkStatus();
+}
+
 // Runs the given ArgSets through the given package. This includes optionally
 // (based on flags) optimizing the IR and evaluating the ArgSets during and
 // after optimizations.
@@ -394,12 +540,26 @@ absl::Status RealMain(absl::string_view input_path,
   }
   XLS_ASSIGN_OR_RETURN(std::string contents, GetFileContents(input_path));
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
-                       Parser::ParsePackage(contents, input_path));
+                       ParsePackageAnyFormat(contents, input_path));
   if (!absl::GetFlag(FLAGS_top).empty()) {
     XLS_RETURN_IF_ERROR(package->SetTopByName(absl::GetFlag(FLAGS_top)));
   }
   XLS_ASSIGN_OR_RETURN(Function * f, package->GetTopAsFunction());
 
+  if (!absl::GetFlag(FLAGS_packed_input_file).empty()) {
+    XLS_QCHECK(!absl::GetFlag(FLAGS_packed_output_file).empty())
+        << "Must specify --packed_output_file with --packed_input_file";
+    XLS_QCHECK(absl::GetFlag(FLAGS_input).empty() &&
+               absl::GetFlag(FLAGS_input_file).empty() &&
+               absl::GetFlag(FLAGS_random_inputs) == 0)
+        << "Cannot specify --input, --input_file or --random_inputs with "
+           "--packed_input_file";
+    XLS_QCHECK(absl::GetFlag(FLAGS_expected).empty() &&
+               absl::GetFlag(FLAGS_expected_file).empty())
+        << "Cannot specify expected values with --packed_input_file";
+    return RunStreaming(package.get());
+  }
+
   std::vector<ArgSet> arg_sets;
   if (!absl::GetFlag(FLAGS_input).empty()) {
     XLS_QCHECK_EQ(absl::GetFlag(FLAGS_random_inputs), 0)
@@ -13,6 +13,7 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import struct
 import subprocess
 
 from xls.common import runfiles
@@ -79,6 +80,25 @@ class EvalMainTest(absltest.TestCase):
     ])
     self.assertEqual(result.decode('utf-8').strip(), 'bits[32]:0x165')
 
+  def test_streaming_packed_files(self):
+    ir_file = self.create_tempfile(content=ADD_IR)
+    samples = [(1, 2), (0x42, 0x123), (0xFFFFFFFF, 1), (7, 0)]
+    # One packed argument record is x (4 bytes, little endian) followed by y.
+    packed_input = b''.join(struct.pack('<II', x, y) for x, y in samples)
+    input_file = self.create_tempfile(mode='wb', content=packed_input)
+    output_file = self.create_tempfile()
+    output = subprocess.check_output([
+        EVAL_IR_MAIN_PATH, '--packed_input_file=' + input_file.full_path,
+        '--packed_output_file=' + output_file.full_path,
+        '--streaming_batch_size=2', ir_file.full_path
+    ]).decode('utf-8')
+    self.assertIn('samples/sec', output)
+    with open(output_file.full_path, 'rb') as f:
+      packed_output = f.read()
+    results = struct.unpack('<%dI' % len(samples), packed_output)
+    self.assertEqual(
+        list(results), [(x + y) % (1 << 32) for x, y in samples])
+
   def test_input_missing_arg(self):
     ir_file = self.create_tempfile(content=ADD_IR)
     comp = subprocess.run(
@@ -14,8 +14,10 @@
 
 // Tool to evaluate the behavior of a Proc network.
 
+#include <atomic>
 #include <cstdint>
 #include <iostream>
+#include <memory>
 #include <queue>
 #include <random>
 #include <vector>
@@ -30,11 +32,14 @@
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "xls/codegen/module_signature.pb.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/init_xls.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/interpreter/block_interpreter.h"
 #include "xls/interpreter/channel_queue.h"
 #include "xls/interpreter/proc_network_interpreter.h"
@@ -42,6 +47,7 @@
 #include "xls/ir/ir_parser.h"
 #include "xls/ir/value_helpers.h"
 #include "xls/jit/jit_channel_queue.h"
+#include "xls/jit/parallel_proc_runtime.h"
 #include "xls/jit/serial_proc_runtime.h"
 
 constexpr const char* kUsage = R"(
@@ -60,6 +66,10 @@ ABSL_FLAG(std::vector<std::string>, ticks, {},
 ABSL_FLAG(std::string, backend, "serial_jit",
           "Backend to use for evaluation. Valid options are:\n"
           " - serial_jit : JIT-backed single-stepping runtime.\n"
+          " - parallel_jit : JIT-backed runtime with one thread per proc; "
+          "channel inputs are bulk-converted to packed form up front and "
+          "outputs are drained concurrently with ticking. Intended for long "
+          "stream-processing simulations.\n"
           " - ir_interpreter     : Interpreter at the IR level."
           " - block_interpreter  : Interpret a block generated from a proc.");
 ABSL_FLAG(std::string, block_signature_proto, "",
@@ -237,6 +247,169 @@ absl::Status RunSerialJit(
   return absl::OkStatus();
 }
 
+absl::Status RunParallelJit(
+    Package* package, const std::vector<int64_t>& ticks,
+    absl::flat_hash_map<std::string, std::vector<Value>> inputs_for_channels,
+    absl::flat_hash_map<std::string, std::vector<Value>>
+        expected_outputs_for_channels) {
+  XLS_VLOG(1) << "Compiling...";
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<ParallelProcRuntime> runtime,
+                       ParallelProcRuntime::Create(package));
+
+  // Convert every input stream to packed queue format once, up front, so that
+  // no Value marshaling happens while the network is ticking.
+  XLS_VLOG(1) << "Packing inputs...";
+  struct PackedInput {
+    Channel* channel;
+    std::vector<uint8_t> packed;
+  };
+  std::vector<PackedInput> packed_inputs;
+  for (const auto& [channel_name, values] : inputs_for_channels) {
+    XLS_ASSIGN_OR_RETURN(Channel * in_ch, package->GetChannel(channel_name));
+    XLS_ASSIGN_OR_RETURN(std::vector<uint8_t> packed,
+                         runtime->PackValuesForChannel(in_ch, values));
+    packed_inputs.push_back(PackedInput{in_ch, std::move(packed)});
+  }
+
+  // One feeder thread per input channel (each queue permits a single producer)
+  // streams packed data in while the network ticks, and one drainer thread per
+  // output channel pulls results out and checks them against the expected
+  // values as they appear. Feeding and draining concurrently with ticking
+  // keeps the bounded channel queues from ever stalling the proc threads.
+  std::atomic<bool> ticking_done(false);
+  std::vector<absl::Status> feeder_status(packed_inputs.size(),
+                                          absl::OkStatus());
+  std::vector<std::unique_ptr<Thread>> feeders;
+  feeders.reserve(packed_inputs.size());
+  for (int64_t i = 0; i < static_cast<int64_t>(packed_inputs.size()); ++i) {
+    feeders.push_back(std::make_unique<Thread>([&, i]() {
+      const PackedInput& input = packed_inputs[i];
+      absl::StatusOr<int64_t> enqueued = runtime->EnqueuePackedToChannel(
+          input.channel, input.packed, &ticking_done);
+      feeder_status[i] = enqueued.status();
+    }));
+  }
+
+  struct ExpectedOutput {
+    Channel* channel;
+    const std::vector<Value>* values;
+    uint64_t processed_count = 0;
+  };
+  std::vector<ExpectedOutput> outputs;
+  for (const auto& [channel_name, values] : expected_outputs_for_channels) {
+    XLS_ASSIGN_OR_RETURN(Channel * out_ch, package->GetChannel(channel_name));
+    outputs.push_back(ExpectedOutput{out_ch, &values});
+  }
+  std::vector<absl::Status> drainer_status(outputs.size(), absl::OkStatus());
+  std::vector<std::unique_ptr<Thread>> drainers;
+  drainers.reserve(outputs.size());
+  for (int64_t i = 0; i < static_cast<int64_t>(outputs.size()); ++i) {
+    drainers.push_back(std::make_unique<Thread>([&, i]() {
+      ExpectedOutput& output = outputs[i];
+      absl::StatusOr<JitChannelQueue*> queue =
+          runtime->queue_mgr()->GetQueueById(output.channel->id());
+      if (!queue.ok()) {
+        drainer_status[i] = queue.status();
+        return;
+      }
+      while (output.processed_count < output.values->size()) {
+        if (!(*queue)->Empty()) {
+          absl::StatusOr<Value> out_val =
+              runtime->DequeueValueFromChannel(output.channel);
+          if (!out_val.ok()) {
+            drainer_status[i] = out_val.status();
+            return;
+          }
+          const Value& expected = (*output.values)[output.processed_count];
+          if (*out_val != expected) {
+            drainer_status[i] = absl::InternalError(absl::StrFormat(
+                "Mismatched (channel=%s) after %d outputs: expected %s, "
+                "got %s",
+                output.channel->name(), output.processed_count,
+                expected.ToString(), out_val->ToString()));
+            return;
+          }
+          ++output.processed_count;
+          continue;
+        }
+        // The done flag is loaded before re-checking emptiness so a value
+        // sent by the final tick is never missed.
+        if (ticking_done.load() && (*queue)->Empty()) {
+          break;
+        }
+        absl::SleepFor(absl::Microseconds(100));
+      }
+    }));
+  }
+
+  XLS_VLOG(1) << "Running...";
+  const absl::Time start = absl::Now();
+  int64_t total_ticks = 0;
+  absl::Status tick_status = absl::OkStatus();
+  for (int64_t this_ticks : ticks) {
+    runtime->ResetState();
+
+    XLS_CHECK_GT(this_ticks, 0);
+    for (int64_t i = 0; i < this_ticks && tick_status.ok(); i++) {
+      tick_status = runtime->Tick();
+      ++total_ticks;
+    }
+    if (!tick_status.ok()) {
+      break;
+    }
+  }
+  const absl::Duration elapsed = absl::Now() - start;
+
+  // The feeders and drainers must be joined even when a tick failed so they
+  // don't outlive the runtime.
+  ticking_done.store(true);
+  for (auto& feeder : feeders) {
+    feeder->Join();
+  }
+  for (auto& drainer : drainers) {
+    drainer->Join();
+  }
+  XLS_RETURN_IF_ERROR(tick_status);
+  for (const absl::Status& status : feeder_status) {
+    XLS_RETURN_IF_ERROR(status);
+  }
+  for (const absl::Status& status : drainer_status) {
+    XLS_RETURN_IF_ERROR(status);
+  }
+
+  for (int64_t i = 0; i < runtime->NumProcs(); i++) {
+    XLS_ASSIGN_OR_RETURN(Proc * p, runtime->proc(i));
+    XLS_ASSIGN_OR_RETURN(std::vector<Value> values, runtime->ProcState(i));
+    XLS_VLOG(1) << absl::StreamFormat(
+        "Proc %s : {%s}", p->name(),
+        absl::StrJoin(values, ", ", ValueFormatter));
+  }
+  XLS_LOG(INFO) << absl::StreamFormat(
+      "Ticked %d times in %s (%.0f ticks/sec)", total_ticks,
+      absl::FormatDuration(elapsed),
+      static_cast<double>(total_ticks) /
+          std::max(absl::ToDoubleSeconds(elapsed), 1e-9));
+
+  bool checked_any_output = false;
+  for (const ExpectedOutput& output : outputs) {
+    if (output.processed_count < output.values->size()) {
+      XLS_LOG(WARNING) << "Warning: Channel " << output.channel->name()
+                       << " didn't consume "
+                       << output.values->size() - output.processed_count
+                       << " expected values" << std::endl;
+    }
+    if (output.processed_count > 0) {
+      checked_any_output = true;
+    }
+  }
+
+  if (!checked_any_output) {
+    return absl::UnknownError("No output verified (empty expected values?)");
+  }
+
+  return absl::OkStatus();
+}
+
 struct ChannelInfo {
   int64_t width = -1;
   bool port_input = false;
@@ -621,6 +794,9 @@ absl::Status RealMain(
   if (backend == "serial_jit") {
     return RunSerialJit(package.get(), ticks, inputs_for_channels,
                         expected_outputs_for_channels);
+  } else if (backend == "parallel_jit") {
+    return RunParallelJit(package.get(), ticks, inputs_for_channels,
+                          expected_outputs_for_channels);
   } else if (backend == "ir_interpreter") {
     return RunIrInterpreter(package.get(), ticks, inputs_for_channels,
                             expected_outputs_for_channels);
@@ -647,8 +823,8 @@ int main(int argc, char* argv[]) {
   }
 
   std::string backend = absl::GetFlag(FLAGS_backend);
-  if (backend != "serial_jit" && backend != "ir_interpreter" &&
-      backend != "block_interpreter") {
+  if (backend != "serial_jit" && backend != "parallel_jit" &&
+      backend != "ir_interpreter" && backend != "block_interpreter") {
     XLS_LOG(QFATAL) << "Unrecognized backend choice.";
   }
 
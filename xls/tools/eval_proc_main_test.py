@@ -368,6 +368,10 @@ bits[64]:55
     output = run_command(shared_args + ["--backend", "serial_jit"])
     self.assertIn("Proc test_proc", output.stderr)
 
+    output = run_command(shared_args + ["--backend", "parallel_jit"])
+    self.assertIn("Proc test_proc", output.stderr)
+    self.assertIn("ticks/sec", output.stderr)
+
   def test_reset_static(self):
     ir_file = self.create_tempfile(content=PROC_IR)
     input_file = self.create_tempfile(content="""
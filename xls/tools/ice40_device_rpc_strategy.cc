@@ -32,6 +32,7 @@
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/common/strerror.h"
+#include "xls/tools/wrap_io.h"
 
 namespace xls {
 namespace {
@@ -254,33 +255,37 @@ absl::Status Ice40DeviceRpcStrategy::Connect(int64_t device_ordinal) {
   return absl::OkStatus();
 }
 
-absl::StatusOr<Value> Ice40DeviceRpcStrategy::CallUnnamed(
-    const FunctionType& function_type, absl::Span<const Value> arguments) {
+/* static */ void Ice40DeviceRpcStrategy::AppendEscapedRecord(
+    absl::Span<const Value> arguments, std::vector<uint8_t>* wire_bytes) {
   BitPushBuffer buffer;
   for (const Value& arg : arguments) {
     arg.FlattenTo(&buffer);
   }
-
-  if (buffer.empty()) {
-    // TODO(leary): 2019-04-07 We probably want this to be possible eventually,
-    // but we'd have to decide whether in this case the device function is
-    // constantly producing output data since there's no input event to trigger
-    // it, so we'd just move on to the read itself.
-    return absl::InvalidArgumentError("Cannot perform an empty-payload RPC.");
+  for (uint8_t byte : buffer.GetUint8Data()) {
+    if (byte == verilog::IoControlCode::kReset) {
+      wire_bytes->push_back(verilog::IoControlCode::kEscape);
+      wire_bytes->push_back(verilog::IoEscapeCode::kResetByte);
+    } else if (byte == verilog::IoControlCode::kEscape) {
+      wire_bytes->push_back(verilog::IoControlCode::kEscape);
+      wire_bytes->push_back(verilog::IoEscapeCode::kEscapeByte);
+    } else {
+      wire_bytes->push_back(byte);
+    }
   }
+}
 
-  std::vector<uint8_t> u8_data = buffer.GetUint8Data();
-
+absl::Status Ice40DeviceRpcStrategy::WriteAndFlush(
+    absl::Span<const uint8_t> bytes) {
   int64_t bytes_written = 0;
-  while (bytes_written < buffer.size_in_bytes()) {
-    int ret = write(tty_fd_.value(), u8_data.data() + bytes_written,
-                    u8_data.size() - bytes_written);
+  while (bytes_written < bytes.size()) {
+    int ret = write(tty_fd_.value(), bytes.data() + bytes_written,
+                    bytes.size() - bytes_written);
     if (ret < 0) {
       return absl::InternalError(
           absl::StrFormat("Could not write partial data of %d remaining bytes "
                           "(originally %d) to ICE40: %s",
-                          buffer.size_in_bytes() - bytes_written,
-                          buffer.size_in_bytes(), Strerror(errno)));
+                          bytes.size() - bytes_written, bytes.size(),
+                          Strerror(errno)));
     }
     bytes_written += ret;
   }
@@ -288,38 +293,116 @@ absl::StatusOr<Value> Ice40DeviceRpcStrategy::CallUnnamed(
   if (tcflush(tty_fd_.value(), TCOFLUSH) != 0) {
     return absl::InternalError("Could not flush write(s) to device.");
   }
+  return absl::OkStatus();
+}
 
-  int64_t output_bits = function_type.return_type()->GetFlatBitCount();
-  std::vector<uint8_t> result(CeilOfRatio(output_bits, int64_t{8}));
-
-  XLS_VLOG(3) << "Reading device response; expecting " << result.size()
-              << " bytes.";
-
+absl::Status Ice40DeviceRpcStrategy::ReadExact(absl::Span<uint8_t> bytes) {
   int64_t bytes_read = 0;
-  while (bytes_read < result.size()) {
-    int ret = read(tty_fd_.value(), result.data() + bytes_read,
-                   result.size() - bytes_read);
+  while (bytes_read < bytes.size()) {
+    int ret = read(tty_fd_.value(), bytes.data() + bytes_read,
+                   bytes.size() - bytes_read);
     if (ret < 0) {
       return absl::InternalError(
           absl::StrFormat("Could not read partial data of %d remaining bytes "
                           "(originally %d) from ICE40: %s",
-                          buffer.size_in_bytes() - bytes_written,
-                          buffer.size_in_bytes(), Strerror(errno)));
+                          bytes.size() - bytes_read, bytes.size(),
+                          Strerror(errno)));
     }
     bytes_read += ret;
   }
+  return absl::OkStatus();
+}
 
+/* static */ absl::StatusOr<Value> Ice40DeviceRpcStrategy::DecodeResult(
+    const FunctionType& function_type, absl::Span<const uint8_t> bytes) {
   if (function_type.return_type()->IsBits() &&
       function_type.return_type()->AsBitsOrDie()->bit_count() == 8) {
-    return Value(UBits(result[0], 8));
+    return Value(UBits(bytes[0], 8));
   }
 
   if (function_type.return_type()->IsBits() &&
       function_type.return_type()->AsBitsOrDie()->bit_count() == 32) {
-    return Value(UBits(*absl::bit_cast<uint32_t*>(result.data()), 32));
+    return Value(UBits(*absl::bit_cast<const uint32_t*>(bytes.data()), 32));
   }
 
   return absl::UnimplementedError("NYI: convert result to Value");
 }
 
+absl::StatusOr<Value> Ice40DeviceRpcStrategy::CallUnnamed(
+    const FunctionType& function_type, absl::Span<const Value> arguments) {
+  std::vector<uint8_t> wire_bytes;
+  AppendEscapedRecord(arguments, &wire_bytes);
+
+  if (wire_bytes.empty()) {
+    // TODO(leary): 2019-04-07 We probably want this to be possible eventually,
+    // but we'd have to decide whether in this case the device function is
+    // constantly producing output data since there's no input event to trigger
+    // it, so we'd just move on to the read itself.
+    return absl::InvalidArgumentError("Cannot perform an empty-payload RPC.");
+  }
+
+  XLS_RETURN_IF_ERROR(WriteAndFlush(wire_bytes));
+
+  int64_t output_bits = function_type.return_type()->GetFlatBitCount();
+  std::vector<uint8_t> result(CeilOfRatio(output_bits, int64_t{8}));
+
+  XLS_VLOG(3) << "Reading device response; expecting " << result.size()
+              << " bytes.";
+
+  XLS_RETURN_IF_ERROR(ReadExact(absl::MakeSpan(result)));
+
+  return DecodeResult(function_type, result);
+}
+
+absl::StatusOr<std::vector<Value>> Ice40DeviceRpcStrategy::CallUnnamedBatch(
+    const FunctionType& function_type,
+    absl::Span<const std::vector<Value>> arguments_batch) {
+  const int64_t response_bytes_per_record =
+      CeilOfRatio(function_type.return_type()->GetFlatBitCount(), int64_t{8});
+
+  std::vector<Value> results;
+  results.reserve(arguments_batch.size());
+
+  // Send argument records back-to-back in windows of at most the device's
+  // receive buffer depth and drain each window's responses before sending the
+  // next, so neither the on-device buffer nor the host tty buffer can
+  // overflow. The serial link has no flow control of its own.
+  int64_t index = 0;
+  while (index < arguments_batch.size()) {
+    std::vector<uint8_t> wire_bytes;
+    int64_t window_end = index;
+    while (window_end < arguments_batch.size()) {
+      std::vector<uint8_t> record_bytes;
+      AppendEscapedRecord(arguments_batch[window_end], &record_bytes);
+      if (record_bytes.empty()) {
+        return absl::InvalidArgumentError(
+            "Cannot perform an empty-payload RPC.");
+      }
+      if (!wire_bytes.empty() &&
+          wire_bytes.size() + record_bytes.size() > verilog::kRxBufferDepth) {
+        break;
+      }
+      wire_bytes.insert(wire_bytes.end(), record_bytes.begin(),
+                        record_bytes.end());
+      ++window_end;
+    }
+
+    XLS_VLOG(3) << "Writing records [" << index << ", " << window_end
+                << ") of " << arguments_batch.size() << " as "
+                << wire_bytes.size() << " bytes.";
+    XLS_RETURN_IF_ERROR(WriteAndFlush(wire_bytes));
+
+    for (int64_t i = index; i < window_end; ++i) {
+      std::vector<uint8_t> response(response_bytes_per_record);
+      XLS_RETURN_IF_ERROR(ReadExact(absl::MakeSpan(response)));
+      XLS_ASSIGN_OR_RETURN(Value result,
+                           DecodeResult(function_type, response));
+      results.push_back(std::move(result));
+    }
+    index = window_end;
+  }
+
+  return results;
+}
+
 }  // namespace xls
@@ -15,6 +15,8 @@
 #ifndef XLS_TOOLS_ICE40_DEVICE_RPC_STRATEGY_H_
 #define XLS_TOOLS_ICE40_DEVICE_RPC_STRATEGY_H_
 
+#include <vector>
+
 #include "absl/status/statusor.h"
 #include "xls/tools/device_rpc_strategy.h"
 
@@ -29,7 +31,33 @@ class Ice40DeviceRpcStrategy : public DeviceRpcStrategy {
   absl::StatusOr<Value> CallUnnamed(const FunctionType& function_type,
                                     absl::Span<const Value> arguments) override;
 
+  // Batched call which packs many argument records back-to-back over the
+  // serial link and streams the responses back, so throughput approaches link
+  // bandwidth rather than being bounded by per-call latency. Records are sent
+  // in windows sized to the on-device receive buffer (see WrapIo's rx_buffer)
+  // so neither side's buffering can overflow.
+  absl::StatusOr<std::vector<Value>> CallUnnamedBatch(
+      const FunctionType& function_type,
+      absl::Span<const std::vector<Value>> arguments_batch) override;
+
  private:
+  // Appends the escaped wire encoding of one flattened argument record to
+  // "wire_bytes". Data bytes which collide with I/O control codes are
+  // prefixed with the escape control code.
+  static void AppendEscapedRecord(absl::Span<const Value> arguments,
+                                  std::vector<uint8_t>* wire_bytes);
+
+  // Writes all of "bytes" to the tty, followed by a flush.
+  absl::Status WriteAndFlush(absl::Span<const uint8_t> bytes);
+
+  // Reads exactly bytes.size() bytes from the tty.
+  absl::Status ReadExact(absl::Span<uint8_t> bytes);
+
+  // Converts the raw response bytes of a single record into a Value of the
+  // function's return type.
+  static absl::StatusOr<Value> DecodeResult(const FunctionType& function_type,
+                                            absl::Span<const uint8_t> bytes);
+
   std::optional<int> tty_fd_;
 };
 
@@ -12,9 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <optional>
 #include <random>
 
 #include "absl/flags/flag.h"
+#include "absl/hash/hash.h"
 #include "absl/random/distributions.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -122,6 +124,13 @@ ABSL_FLAG(
     std::string, top, "",
     "The name of the top entity. Currently, only functions are supported. "
     "Entry function to use during minimization.");
+ABSL_FLAG(
+    int64_t, parallelism, 1,
+    "Number of speculative simplification candidates to generate and test "
+    "concurrently per step; the first (in generation order) candidate which "
+    "still fails wins. Candidates are only tested concurrently when "
+    "--test_executable is used, since each test is a subprocess; the JIT "
+    "oracle is evaluated in process and stays serial.");
 
 namespace xls {
 namespace {
@@ -207,16 +216,25 @@ absl::StatusOr<bool> StillFailsHelper(
   return jit_result.value != interpreter_result.value;
 }
 
+// Cache of test results keyed by a hash of the IR text, so already-tested IR
+// (including duplicates within a speculative batch) is not re-run and the
+// cache does not hold onto every candidate's full text.
+using TestCache = absl::flat_hash_map<uint64_t, bool>;
+
+uint64_t HashIrText(absl::string_view ir_text) {
+  return absl::Hash<absl::string_view>()(ir_text);
+}
+
 // Wrapper around StillFails which memoizes the result. Optional test_cache is
 // used to memoize the results of testing the given IR.
-absl::StatusOr<bool> StillFails(
-    absl::string_view ir_text, std::optional<std::vector<Value>> inputs,
-    absl::flat_hash_map<std::string, bool>* test_cache) {
+absl::StatusOr<bool> StillFails(absl::string_view ir_text,
+                                std::optional<std::vector<Value>> inputs,
+                                TestCache* test_cache) {
   XLS_VLOG(1) << "=== Verifying contents still fails";
   XLS_VLOG_LINES(2, ir_text);
 
   if (test_cache != nullptr) {
-    auto it = test_cache->find(ir_text);
+    auto it = test_cache->find(HashIrText(ir_text));
     if (it != test_cache->end()) {
       XLS_LOG(INFO) << absl::StreamFormat("Found result in cache (failed = %d)",
                                           it->second);
@@ -226,18 +244,71 @@ absl::StatusOr<bool> StillFails(
 
   XLS_ASSIGN_OR_RETURN(bool result, StillFailsHelper(ir_text, inputs));
   if (test_cache != nullptr) {
-    (*test_cache)[ir_text] = result;
+    (*test_cache)[HashIrText(ir_text)] = result;
   }
   return result;
 }
 
+// A speculative simplification candidate awaiting testing.
+struct SimplificationCandidate {
+  std::string ir_text;
+  std::string which_transform;
+  // The IR of just the simplified function, for logging the winner.
+  std::string function_dump;
+  int64_t node_count;
+};
+
+// Tests the given candidates and returns the index of the first (in order) one
+// which still fails, or nullopt if none does. With --test_executable the
+// uncached candidates are tested concurrently in subprocesses; otherwise they
+// are tested serially in process.
+absl::StatusOr<std::optional<int64_t>> FindFirstStillFailing(
+    absl::Span<const SimplificationCandidate> candidates,
+    std::optional<std::vector<Value>> inputs, TestCache* test_cache) {
+  if (candidates.size() > 1 && !absl::GetFlag(FLAGS_test_executable).empty()) {
+    // Write the uncached candidates out and test them concurrently.
+    std::vector<TempFile> temp_files;
+    std::vector<std::vector<std::string>> argvs;
+    std::vector<int64_t> tested_indices;
+    for (int64_t i = 0; i < candidates.size(); ++i) {
+      uint64_t hash = HashIrText(candidates[i].ir_text);
+      if (test_cache->contains(hash)) {
+        continue;
+      }
+      // Mark the hash as seen so a duplicate candidate later in the batch is
+      // not tested twice; the value is overwritten with the real result below.
+      (*test_cache)[hash] = false;
+      XLS_ASSIGN_OR_RETURN(TempFile temp_file,
+                           TempFile::CreateWithContent(candidates[i].ir_text));
+      argvs.push_back({absl::GetFlag(FLAGS_test_executable),
+                       temp_file.path().string()});
+      temp_files.push_back(std::move(temp_file));
+      tested_indices.push_back(i);
+    }
+    std::vector<absl::StatusOr<std::pair<std::string, std::string>>> results =
+        InvokeSubprocessesConcurrently(argvs,
+                                       /*max_concurrency=*/candidates.size());
+    for (int64_t i = 0; i < tested_indices.size(); ++i) {
+      (*test_cache)[HashIrText(candidates[tested_indices[i]].ir_text)] =
+          results[i].ok();
+    }
+  }
+  for (int64_t i = 0; i < candidates.size(); ++i) {
+    XLS_ASSIGN_OR_RETURN(bool still_fails,
+                         StillFails(candidates[i].ir_text, inputs, test_cache));
+    if (still_fails) {
+      return i;
+    }
+  }
+  return std::nullopt;
+}
+
 // Writes the IR out to a temporary file, runs the test executable on it, and
 // returns 'true' if the test (still) fails on that IR text.  Optional test
 // cache is used to memoize the results of testing the given IR.
 absl::Status VerifyStillFails(
     absl::string_view ir_text, std::optional<std::vector<Value>> inputs,
-    absl::string_view description,
-    absl::flat_hash_map<std::string, bool>* test_cache) {
+    absl::string_view description, TestCache* test_cache) {
   XLS_ASSIGN_OR_RETURN(bool still_fails,
                        StillFails(ir_text, inputs, test_cache));
 
@@ -522,7 +593,7 @@ absl::Status RealMain(absl::string_view path,
   XLS_ASSIGN_OR_RETURN(std::string knownf_ir_text, GetFileContents(path));
   // Cache of test results to avoid duplicate invocations of the
   // test_executable.
-  absl::flat_hash_map<std::string, bool> test_cache;
+  TestCache test_cache;
 
   // Parse inputs, if specified.
   std::optional<std::vector<xls::Value>> inputs;
@@ -562,11 +633,15 @@ absl::Status RealMain(absl::string_view path,
   // If so, we start simplifying via this seeded RNG.
   std::mt19937 rng;  // Default constructor uses deterministic seed.
 
+  const int64_t parallelism =
+      std::max<int64_t>(int64_t{1}, absl::GetFlag(FLAGS_parallelism));
+
   // Smallest version of the function that's known to be failing.
   int64_t failed_simplification_attempts = 0;
   int64_t total_attempts = 0;
+  bool cannot_change = false;
 
-  while (true) {
+  while (!cannot_change) {
     if (failed_simplification_attempts >= failed_attempt_limit) {
       XLS_LOG(INFO) << "Hit failed-simplification-attempt-limit: "
                     << failed_simplification_attempts;
@@ -574,75 +649,94 @@ absl::Status RealMain(absl::string_view path,
       break;
     }
 
-    total_attempts++;
     if (total_attempts >= total_attempt_limit) {
       XLS_LOG(INFO) << "Hit total-attempt-limit: " << total_attempts;
       break;
     }
 
-    XLS_VLOG(1) << "=== Simplification attempt " << total_attempts;
+    // Generate a batch of speculative candidates from the current known-bad
+    // text; each gets its own transform draws from the shared RNG so a serial
+    // run (--parallelism=1) follows the same sequence as before.
+    std::vector<SimplificationCandidate> candidates;
+    while (static_cast<int64_t>(candidates.size()) < parallelism &&
+           failed_simplification_attempts + static_cast<int64_t>(
+                                                candidates.size()) <
+               failed_attempt_limit &&
+           total_attempts < total_attempt_limit) {
+      total_attempts++;
+      XLS_VLOG(1) << "=== Simplification attempt " << total_attempts;
+
+      XLS_ASSIGN_OR_RETURN(auto package, ParsePackage(knownf_ir_text));
+      XLS_ASSIGN_OR_RETURN(Function * candidate, package->GetTopAsFunction());
+      XLS_VLOG_LINES(
+          2, "=== Candidate for simplification:\n" + candidate->DumpIr());
+
+      // Simplify the function.
+      std::string which_transform;
+      XLS_ASSIGN_OR_RETURN(SimplificationResult simplification,
+                           Simplify(candidate, inputs, &rng, &which_transform));
+
+      // If we cannot change it, we're done.
+      if (simplification == SimplificationResult::kCannotChange) {
+        XLS_LOG(INFO) << "Cannot simplify any further, done!";
+        cannot_change = true;
+        break;
+      }
 
-    XLS_ASSIGN_OR_RETURN(auto package, ParsePackage(knownf_ir_text));
-    XLS_ASSIGN_OR_RETURN(Function * candidate, package->GetTopAsFunction());
-    XLS_VLOG_LINES(2,
-                   "=== Candidate for simplification:\n" + candidate->DumpIr());
+      // If we happened to not change it (e.g. because the RNG said not to),
+      // keep going until we do. We still bump the counter to make sure we
+      // don't end up wedged in a state where we can't simplify anything.
+      if (simplification == SimplificationResult::kDidNotChange) {
+        XLS_VLOG(1) << "Did not change the sample.";
+        failed_simplification_attempts++;
+        continue;
+      }
+      XLS_LOG(INFO) << "Trying " << which_transform;
 
-    // Simplify the function.
-    std::string which_transform;
-    XLS_ASSIGN_OR_RETURN(SimplificationResult simplification,
-                         Simplify(candidate, inputs, &rng, &which_transform));
+      // When we changed (simplified) it, clean it up then queue it for
+      // testing.
+      XLS_CHECK(simplification == SimplificationResult::kDidChange);
+      XLS_RETURN_IF_ERROR(CleanUp(candidate, can_remove_params));
 
-    // If we cannot change it, we're done.
-    if (simplification == SimplificationResult::kCannotChange) {
-      XLS_LOG(INFO) << "Cannot simplify any further, done!";
-      break;
-    }
+      XLS_VLOG_LINES(2, "=== After simplification [" + which_transform + "]\n" +
+                            candidate->DumpIr());
 
-    // If we happened to not change it (e.g. because the RNG said not to), keep
-    // going until we do. We still bump the counter to make sure we don't end up
-    // wedged in a state where we can't simplify anything.
-    if (simplification == SimplificationResult::kDidNotChange) {
-      XLS_VLOG(1) << "Did not change the sample.";
-      failed_simplification_attempts++;
+      candidates.push_back(SimplificationCandidate{
+          package->DumpIr(), which_transform, candidate->DumpIr(),
+          candidate->node_count()});
+    }
+    if (candidates.empty()) {
       continue;
     }
-    XLS_LOG(INFO) << "Trying " << which_transform;
-
-    // When we changed (simplified) it, clean it up then see if it still fails.
-    XLS_CHECK(simplification == SimplificationResult::kDidChange);
-    XLS_RETURN_IF_ERROR(CleanUp(candidate, can_remove_params));
 
-    XLS_VLOG_LINES(2, "=== After simplification [" + which_transform + "]\n" +
-                          candidate->DumpIr());
-
-    std::string candidate_ir_text = package->DumpIr();
-    XLS_ASSIGN_OR_RETURN(bool still_fails,
-                         StillFails(candidate_ir_text, inputs, &test_cache));
-    if (!still_fails) {
-      failed_simplification_attempts++;
+    // Test the candidates; the first one still failing wins.
+    XLS_ASSIGN_OR_RETURN(std::optional<int64_t> winner,
+                         FindFirstStillFailing(candidates, inputs,
+                                               &test_cache));
+    if (!winner.has_value()) {
+      failed_simplification_attempts += candidates.size();
       XLS_LOG(INFO) << "Sample no longer fails.";
       XLS_LOG(INFO) << "Failed simplification attempts now: "
                     << failed_simplification_attempts;
-      // That simplification caused it to stop failing, but keep going with the
-      // last known failing version and seeing if we can find something else
-      // from there.
+      // Those simplifications caused it to stop failing, but keep going with
+      // the last known failing version and seeing if we can find something
+      // else from there.
       continue;
     }
 
     // We found something that definitely fails, update our "knownf" value and
     // reset our failed simplification attempt count since we see we've made
     // some forward progress.
-    XLS_RETURN_IF_ERROR(CleanUp(candidate, can_remove_params));
-
     XLS_RETURN_IF_ERROR(VerifyStillFails(
         knownf_ir_text, inputs, "Known failure does not fail after cleanup!",
         &test_cache));
 
-    knownf_ir_text = candidate_ir_text;
+    knownf_ir_text = candidates[*winner].ir_text;
 
-    std::cerr << "---\ntransform: " << which_transform << "\n"
-              << candidate->DumpIr() << "(" << candidate->node_count()
-              << " nodes)" << std::endl;
+    std::cerr << "---\ntransform: " << candidates[*winner].which_transform
+              << "\n"
+              << candidates[*winner].function_dump << "("
+              << candidates[*winner].node_count << " nodes)" << std::endl;
 
     failed_simplification_attempts = 0;
   }
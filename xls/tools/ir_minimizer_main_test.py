@@ -75,6 +75,19 @@ top fn foo() -> bits[32] {
 }
 """)
 
+  def test_minimize_add_parallel(self):
+    ir_file = self.create_tempfile(content=ADD_IR)
+    test_sh_file = self.create_tempfile()
+    self._write_sh_script(test_sh_file.full_path, ['/bin/grep add $1'])
+    minimized_ir = subprocess.check_output([
+        IR_MINIMIZER_MAIN_PATH, '--test_executable=' + test_sh_file.full_path,
+        '--can_remove_params', '--parallelism=4', ir_file.full_path
+    ]).decode('utf-8')
+    # The first still-failing candidate of a batch wins, so the exact result
+    # can differ from a serial run; the add must survive and the nots must go.
+    self.assertIn('add', minimized_ir)
+    self.assertNotIn('not', minimized_ir)
+
   def test_no_reduction_possible(self):
     ir_file = self.create_tempfile(content=ADD_IR)
     test_sh_file = self.create_tempfile()
@@ -23,6 +23,7 @@
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 #include "xls/common/file/filesystem.h"
+#include "xls/common/file/memory_mapped_file.h"
 #include "xls/common/file/get_runfile_path.h"
 #include "xls/common/init_xls.h"
 #include "xls/common/status/ret_check.h"
@@ -85,6 +86,14 @@ ABSL_FLAG(int32_t, stage, -1,
           "Pipeline stage to evaluate. Requires --schedule.\n"
           "If \"schedule\" is set, but this is not, then the entire module "
           "will be evaluated.");
+ABSL_FLAG(int32_t, slice_bits, 0,
+          "If positive, prove equivalence as independent per-output-bit-group "
+          "queries with this many bits per query, run across a pool of solver "
+          "contexts, instead of one monolithic query. Useful for wide "
+          "datapaths where the monolithic query times out.");
+ABSL_FLAG(int32_t, slice_workers, 0,
+          "Number of concurrent solver contexts used with --slice_bits. "
+          "Zero means one per hardware thread.");
 
 namespace xls {
 namespace {
@@ -98,10 +107,14 @@ constexpr const char kIrConverterPath[] = "xls/dslx/ir_converter_main";
 absl::StatusOr<netlist::CellLibrary> GetCellLibrary(
     absl::string_view cell_lib_path, absl::string_view cell_proto_path) {
   if (!cell_proto_path.empty()) {
-    XLS_ASSIGN_OR_RETURN(std::string cell_proto_text,
-                         GetFileContents(cell_proto_path));
+    // Map the preprocessed library instead of copying it onto the heap; the
+    // proto parse reads straight out of the page cache.
+    XLS_ASSIGN_OR_RETURN(MemoryMappedFile cell_proto_file,
+                         MemoryMappedFile::Open(std::string(cell_proto_path)));
     netlist::CellLibraryProto cell_proto;
-    XLS_RET_CHECK(cell_proto.ParseFromString(cell_proto_text));
+    XLS_RET_CHECK(cell_proto.ParseFromArray(
+        cell_proto_file.data().data(),
+        static_cast<int>(cell_proto_file.data().size())));
     return netlist::CellLibrary::FromProto(cell_proto);
   } else {
     XLS_ASSIGN_OR_RETURN(std::string lib_text, GetFileContents(cell_lib_path));
@@ -116,8 +129,11 @@ absl::StatusOr<netlist::CellLibrary> GetCellLibrary(
 // Loads and parses a netlist from a file.
 absl::StatusOr<std::unique_ptr<netlist::rtl::Netlist>> GetNetlist(
     absl::string_view netlist_path, netlist::CellLibrary* cell_library) {
-  XLS_ASSIGN_OR_RETURN(std::string netlist_text, GetFileContents(netlist_path));
-  netlist::rtl::Scanner scanner(netlist_text);
+  // Memory-map the netlist rather than reading it onto the heap; post-P&R
+  // netlists can run to multiple gigabytes.
+  XLS_ASSIGN_OR_RETURN(MemoryMappedFile netlist_file,
+                       MemoryMappedFile::Open(std::string(netlist_path)));
+  netlist::rtl::Scanner scanner(netlist_file.data());
   return netlist::rtl::Parser::ParseNetlist(cell_library, &scanner);
 }
 
@@ -226,7 +242,8 @@ absl::Status RealMain(
     absl::string_view netlist_module_name, absl::string_view cell_lib_path,
     absl::string_view cell_proto_path, absl::string_view netlist_path,
     absl::string_view constraints_file, absl::string_view schedule_path,
-    int stage, bool auto_stage, int timeout_sec) {
+    int stage, bool auto_stage, int timeout_sec, int slice_bits,
+    int slice_workers) {
   solvers::z3::LecParams lec_params;
   XLS_ASSIGN_OR_RETURN(std::string ir_text, GetFileContents(ir_path));
   XLS_ASSIGN_OR_RETURN(auto package, Parser::ParsePackage(ir_text));
@@ -282,7 +299,15 @@ absl::Status RealMain(
   if (timeout_sec != -1) {
     old_action = SetAlarm(timeout_sec);
   }
-  bool equal = lec->Run();
+  bool equal;
+  if (slice_bits > 0) {
+    solvers::z3::SlicedRunOptions options;
+    options.bits_per_slice = slice_bits;
+    options.num_workers = slice_workers;
+    equal = lec->RunSliced(options);
+  } else {
+    equal = lec->Run();
+  }
   if (timeout_sec != -1) {
     CancelAlarm(old_action);
   }
@@ -333,6 +358,7 @@ int main(int argc, char* argv[]) {
       ir_path, absl::GetFlag(FLAGS_entry_function_name),
       absl::GetFlag(FLAGS_netlist_module_name), cell_lib_path, cell_proto_path,
       netlist_path, absl::GetFlag(FLAGS_constraints_file), schedule_path, stage,
-      auto_stage, absl::GetFlag(FLAGS_timeout_sec)));
+      auto_stage, absl::GetFlag(FLAGS_timeout_sec),
+      absl::GetFlag(FLAGS_slice_bits), absl::GetFlag(FLAGS_slice_workers)));
   return 0;
 }
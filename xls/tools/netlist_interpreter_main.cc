@@ -21,6 +21,7 @@
 #include "absl/strings/str_split.h"
 #include "xls/codegen/flattening.h"
 #include "xls/common/file/filesystem.h"
+#include "xls/common/file/memory_mapped_file.h"
 #include "xls/common/init_xls.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
@@ -60,10 +61,13 @@ absl::StatusOr<netlist::CellLibrary> GetCellLibrary(
     const std::string& cell_library_path,
     const std::string& cell_library_proto_path) {
   if (!cell_library_proto_path.empty()) {
-    XLS_ASSIGN_OR_RETURN(std::string proto_text,
-                         GetFileContents(cell_library_proto_path));
+    // Map the preprocessed library instead of copying it onto the heap; the
+    // proto parse reads straight out of the page cache.
+    XLS_ASSIGN_OR_RETURN(MemoryMappedFile proto_file,
+                         MemoryMappedFile::Open(cell_library_proto_path));
     netlist::CellLibraryProto lib_proto;
-    XLS_RET_CHECK(lib_proto.ParseFromString(proto_text));
+    XLS_RET_CHECK(lib_proto.ParseFromArray(
+        proto_file.data().data(), static_cast<int>(proto_file.data().size())));
     return netlist::CellLibrary::FromProto(lib_proto);
   } else {
     XLS_ASSIGN_OR_RETURN(std::string cell_library_text,
@@ -88,8 +92,11 @@ absl::Status RealMain(const std::string& netlist_path,
       netlist::CellLibrary cell_library,
       GetCellLibrary(cell_library_path, cell_library_proto_path));
 
-  XLS_ASSIGN_OR_RETURN(std::string netlist_text, GetFileContents(netlist_path));
-  netlist::rtl::Scanner scanner(netlist_text);
+  // Memory-map the netlist rather than reading it onto the heap; post-P&R
+  // netlists can run to multiple gigabytes.
+  XLS_ASSIGN_OR_RETURN(MemoryMappedFile netlist_file,
+                       MemoryMappedFile::Open(netlist_path));
+  netlist::rtl::Scanner scanner(netlist_file.data());
   XLS_ASSIGN_OR_RETURN(auto netlist, netlist::rtl::Parser::ParseNetlist(
                                          &cell_library, &scanner));
   XLS_ASSIGN_OR_RETURN(const auto* module, netlist->GetModule(module_name));
@@ -14,17 +14,157 @@
 
 #include "xls/tools/opt.h"
 
+#include <algorithm>
+#include <filesystem>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "xls/common/allocation_accounting.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/logging/logging.h"
 #include "xls/dslx/ir_converter.h"
 #include "xls/dslx/parse_and_typecheck.h"
+#include "xls/ir/ir_binary.h"
 #include "xls/ir/ir_parser.h"
 #include "xls/ir/verifier.h"
+#include "xls/passes/channel_value_specialization.h"
 #include "xls/passes/passes.h"
 #include "xls/passes/standard_pipeline.h"
 
 namespace xls::tools {
+namespace {
+
+// Renders the per-pass instrumentation collected in `results` as a JSON
+// object. Durations are reported in microseconds.
+std::string PassResultsToJson(const PassResults& results) {
+  std::vector<std::string> pass_entries;
+  for (const PassInvocation& invocation : results.invocations) {
+    const Package::MemoryUsage& memory = invocation.memory_usage;
+    // The allocation counters are all zero unless the binary was built with
+    // allocation accounting; omit the field entirely in ordinary builds so
+    // the profile shape does not suggest measurements that were never taken.
+    std::string allocs;
+    if (AllocationAccountingEnabled()) {
+      std::vector<std::string> categories;
+      for (int64_t i = 0; i < kNumAllocationCategories; ++i) {
+        const AllocationCounters& counters =
+            invocation.allocation_delta.categories[i];
+        categories.push_back(absl::StrFormat(
+            "\"%s\": {\"count\": %d, \"bytes\": %d}",
+            AllocationCategoryName(static_cast<AllocationCategory>(i)),
+            counters.count, counters.bytes));
+      }
+      allocs = absl::StrFormat(", \"allocs\": {%s}",
+                               absl::StrJoin(categories, ", "));
+    }
+    pass_entries.push_back(absl::StrFormat(
+        "{\"name\": \"%s\", \"changed\": %s, \"duration_us\": %d, "
+        "\"node_count_delta\": %d, \"transform_count\": %d, "
+        "\"peak_rss_delta_bytes\": %d, \"memory_bytes\": {\"nodes\": %d, "
+        "\"types\": %d, \"names\": %d, \"bits\": %d, \"total\": %d}%s}",
+        invocation.pass_name, invocation.ir_changed ? "true" : "false",
+        absl::ToInt64Microseconds(invocation.run_duration),
+        invocation.node_count_delta, invocation.transform_count,
+        invocation.peak_rss_delta_bytes, memory.node_bytes, memory.type_bytes,
+        memory.name_bytes, memory.bits_bytes, memory.total_bytes(), allocs));
+  }
+  // Sort the fixed-point entries by pass name so the output is deterministic.
+  std::vector<std::pair<std::string, int64_t>> iterations(
+      results.fixed_point_iterations.begin(),
+      results.fixed_point_iterations.end());
+  std::sort(iterations.begin(), iterations.end());
+  std::vector<std::string> iteration_entries;
+  for (const auto& [name, count] : iterations) {
+    iteration_entries.push_back(absl::StrFormat("\"%s\": %d", name, count));
+  }
+  return absl::StrFormat(
+      "{\"passes\": [%s], \"fixed_point_iterations\": {%s}}\n",
+      absl::StrJoin(pass_entries, ", "),
+      absl::StrJoin(iteration_entries, ", "));
+}
+
+// Stable FNV-1a hash over `data` starting from `hash`. absl::Hash is
+// randomized per process so it cannot key an on-disk cache shared across tool
+// invocations.
+uint64_t Fnv1a64(absl::string_view data, uint64_t hash) {
+  for (char c : data) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= uint64_t{0x100000001b3};
+  }
+  return hash;
+}
+
+// Version component of the optimization cache key. Bump to invalidate
+// existing entries when the optimizer's output changes in ways the options do
+// not capture (e.g. pass changes in a new version of the tool).
+constexpr int64_t kOptimizationCacheVersion = 1;
+
+// Returns the cache file path for optimizing `ir` under `options`: a
+// content-addressed name derived from the input IR text and every option
+// which affects the optimized output.
+std::filesystem::path OptimizationCachePath(absl::string_view ir,
+                                            const OptOptions& options) {
+  std::string config = absl::StrFormat(
+      "version=%d;opt_level=%d;entry=%s;inline_procs=%d;"
+      "convert_array_index_to_select=%s;run_only_passes=%s;skip_passes=%s;"
+      "channel_values=%s",
+      kOptimizationCacheVersion, options.opt_level, options.entry,
+      options.inline_procs,
+      options.convert_array_index_to_select.has_value()
+          ? absl::StrCat(*options.convert_array_index_to_select)
+          : "none",
+      options.run_only_passes.has_value()
+          ? absl::StrJoin(*options.run_only_passes, ",")
+          : "none",
+      absl::StrJoin(options.skip_passes, ","),
+      absl::StrJoin(options.channel_values, ","));
+  constexpr uint64_t kOffsetBasis = uint64_t{0xcbf29ce484222325};
+  uint64_t lo = Fnv1a64(config, Fnv1a64(ir, kOffsetBasis));
+  uint64_t hi = Fnv1a64(ir, Fnv1a64(config, kOffsetBasis));
+  return std::filesystem::path(options.optimization_cache_dir) /
+         absl::StrFormat("%016x%016x.opt.ir", hi, lo);
+}
+
+// Parses "<channel>=<typed value>" binding strings (see
+// OptOptions::channel_values) into ChannelValueBindings.
+absl::StatusOr<std::vector<ChannelValueBinding>> ParseChannelValueBindings(
+    absl::Span<const std::string> binding_strings) {
+  std::vector<ChannelValueBinding> bindings;
+  for (const std::string& binding_string : binding_strings) {
+    std::pair<absl::string_view, absl::string_view> parts =
+        absl::StrSplit(binding_string, absl::MaxSplits('=', 1));
+    if (parts.second.empty()) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Invalid channel value binding \"%s\"; expected "
+          "<channel>=<typed value>, e.g. \"config=bits[32]:42\"",
+          binding_string));
+    }
+    XLS_ASSIGN_OR_RETURN(Value value, Parser::ParseTypedValue(parts.second));
+    bindings.push_back(
+        ChannelValueBinding{std::string(parts.first), std::move(value)});
+  }
+  return bindings;
+}
+
+}  // namespace
 
 absl::StatusOr<std::string> OptimizeIrForEntry(absl::string_view ir,
                                                const OptOptions& options) {
+  std::optional<std::filesystem::path> cache_path;
+  if (!options.optimization_cache_dir.empty()) {
+    cache_path = OptimizationCachePath(ir, options);
+    absl::StatusOr<std::string> cached = GetFileContents(*cache_path);
+    if (cached.ok()) {
+      XLS_VLOG(1) << "Optimization cache hit: " << cache_path->string();
+      return std::move(cached).value();
+    }
+  }
   if (!options.entry.empty()) {
     XLS_VLOG(3) << "OptimizeIrForEntry; entry: '" << options.entry
                 << "'; opt_level: " << options.opt_level;
@@ -32,8 +172,30 @@ absl::StatusOr<std::string> OptimizeIrForEntry(absl::string_view ir,
     XLS_VLOG(3) << "OptimizeIrForEntry; opt_level: " << options.opt_level;
   }
 
-  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
-                       Parser::ParsePackage(ir, options.ir_path));
+  std::unique_ptr<Package> package;
+  PassResults results;
+  if (!options.resume_from.empty()) {
+    // Resume from a checkpoint: optimize the checkpointed package (which has
+    // the already-run passes applied) and hand the recorded invocation log to
+    // the pipeline for replay.
+    std::filesystem::path checkpoint_dir(options.resume_from);
+    XLS_ASSIGN_OR_RETURN(std::string checkpoint_ir,
+                         GetFileContents(checkpoint_dir / kCheckpointIrFile));
+    XLS_ASSIGN_OR_RETURN(
+        package,
+        ParsePackageAnyFormat(checkpoint_ir,
+                              (checkpoint_dir / kCheckpointIrFile).string()));
+    XLS_ASSIGN_OR_RETURN(
+        std::string invocation_log,
+        GetFileContents(checkpoint_dir / kCheckpointInvocationsFile));
+    XLS_ASSIGN_OR_RETURN(results.checkpoint_replay,
+                         ParseCheckpointInvocations(invocation_log));
+    XLS_VLOG(1) << "Resuming from checkpoint " << checkpoint_dir.string()
+                << " with " << results.checkpoint_replay.size()
+                << " completed pass invocations";
+  } else {
+    XLS_ASSIGN_OR_RETURN(package, ParsePackageAnyFormat(ir, options.ir_path));
+  }
   if (!options.entry.empty()) {
     XLS_RETURN_IF_ERROR(package->SetTopByName(options.entry));
   }
@@ -43,6 +205,16 @@ absl::StatusOr<std::string> OptimizeIrForEntry(absl::string_view ir,
         "Top entity not set for package: %s.", package->name()));
   }
   XLS_VLOG(3) << "Top entity: '" << top.value()->name() << "'";
+  if (!options.channel_values.empty() && options.resume_from.empty()) {
+    // Partially evaluate the procs under the given channel-value bindings
+    // before the pipeline runs; the pipeline then folds the bound values
+    // through the procs. A resumed checkpoint was written after this step, so
+    // it is not repeated (the bound channels are already gone).
+    XLS_ASSIGN_OR_RETURN(std::vector<ChannelValueBinding> bindings,
+                         ParseChannelValueBindings(options.channel_values));
+    XLS_RETURN_IF_ERROR(
+        SpecializeChannelValues(package.get(), bindings).status());
+  }
   std::unique_ptr<CompoundPass> pipeline =
       CreateStandardPassPipeline(options.opt_level);
   const PassOptions pass_options = {
@@ -51,14 +223,39 @@ absl::StatusOr<std::string> OptimizeIrForEntry(absl::string_view ir,
       .skip_passes = options.skip_passes,
       .inline_procs = options.inline_procs,
       .convert_array_index_to_select = options.convert_array_index_to_select,
+      .parallelism = options.parallelism,
+      .memory_limit_bytes = options.memory_limit_bytes,
+      .checkpoint_dir = options.checkpoint_dir,
+      .checkpoint_interval = options.checkpoint_interval,
+      .deadline = options.timeout.has_value() ? absl::Now() + *options.timeout
+                                              : absl::InfiniteFuture(),
   };
-  PassResults results;
   XLS_RETURN_IF_ERROR(
       pipeline->Run(package.get(), pass_options, &results).status());
+  if (results.interrupted) {
+    XLS_LOG(WARNING) << "Optimization timed out after "
+                     << results.invocations.size()
+                     << " pass invocations; returning the partially "
+                        "optimized IR.";
+  }
+  if (!options.pass_profile_path.empty()) {
+    XLS_RETURN_IF_ERROR(SetFileContents(options.pass_profile_path,
+                                        PassResultsToJson(results)));
+  }
   // If opt returns something that obviously can't be codegenned, that's a bug
   // in opt, not codegen.
   XLS_RETURN_IF_ERROR(xls::VerifyPackage(package.get(), /*codegen=*/true));
-  return package->DumpIr();
+  std::string optimized_ir = package->DumpIr();
+  // A timed-out run is valid but not fully optimized; caching it would make
+  // the truncation permanent for this input.
+  if (cache_path.has_value() && !results.interrupted) {
+    absl::Status cached = SetFileContents(*cache_path, optimized_ir);
+    if (!cached.ok()) {
+      XLS_LOG(WARNING) << "Failed to write optimization cache entry "
+                       << cache_path->string() << ": " << cached;
+    }
+  }
+  return optimized_ir;
 }
 
 }  // namespace xls::tools
@@ -23,6 +23,7 @@
 
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 
 // TODO(meheff): 2021-10-04 Remove this header.
 #include "xls/passes/passes.h"
@@ -40,6 +41,54 @@ struct OptOptions {
   std::vector<std::string> skip_passes;
   std::optional<int64_t> convert_array_index_to_select = std::nullopt;
   bool inline_procs;
+  int64_t parallelism = 1;
+  // If non-empty, a per-pass profile (wall time, node-count delta, transform
+  // count, peak RSS delta, package memory breakdown and fixed-point iteration
+  // counts) is written to this path as JSON.
+  std::string pass_profile_path = "";
+
+  // If set, optimization aborts with a package memory breakdown when the
+  // process's peak resident set size exceeds this many bytes after a pass.
+  std::optional<int64_t> memory_limit_bytes = std::nullopt;
+
+  // If non-empty, a directory used as a content-addressed cache of optimized
+  // output. The cache key covers the input IR text, every option which
+  // affects the optimized output, and a cache format version; on a hit the
+  // cached output is returned without running any passes (so no pass profile
+  // is written). Entries are written on misses. Cache I/O failures degrade
+  // to a normal uncached run.
+  std::string optimization_cache_dir = "";
+
+  // If non-empty, a directory the pass pipeline periodically writes
+  // checkpoints to: the package in binary serialized form plus the pipeline
+  // position (which pass invocations have run and whether each changed the
+  // IR). A compile killed mid-pipeline can be restarted from the last
+  // checkpoint with `resume_from`.
+  std::string checkpoint_dir = "";
+
+  // Minimum wall time between checkpoint writes.
+  absl::Duration checkpoint_interval = absl::Minutes(5);
+
+  // If non-empty, a checkpoint directory to resume from. The checkpointed
+  // package is optimized in place of the input IR, and the pass invocations
+  // recorded in the checkpoint are replayed (their recorded outcomes drive
+  // fixed-point termination without re-running the passes) before
+  // optimization continues where the checkpoint left off.
+  std::string resume_from = "";
+
+  // If set, the pass pipeline stops starting new passes once this much wall
+  // time has elapsed and the IR optimized so far is returned as a best-effort
+  // result (with the pass profile intact). The partial output is not written
+  // to the optimization cache.
+  std::optional<absl::Duration> timeout = std::nullopt;
+
+  // Bindings of the form "<channel>=<typed value>" (e.g.
+  // "config=bits[32]:42") asserting that the named receive-only channel
+  // always carries the given value. Before the pass pipeline runs, each
+  // receive on a bound channel is replaced with a literal of the value and
+  // the channel is removed, so the pipeline partially evaluates the procs
+  // under the binding (see SpecializeChannelValues).
+  std::vector<std::string> channel_values;
 };
 
 // Helper used in the opt_main tool, optimizes the given IR for a particular
@@ -15,17 +15,34 @@
 // Takes in an IR file and produces an IR file that has been run through the
 // standard optimization pipeline.
 
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
 #include "absl/status/status.h"
 #include "absl/strings/str_format.h"
+#include "absl/types/span.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/init_xls.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/ir/ir_binary.h"
 #include "xls/ir/ir_parser.h"
 #include "xls/ir/package.h"
+#include "xls/ir/package_partition.h"
 #include "xls/passes/passes.h"
 #include "xls/passes/standard_pipeline.h"
 #include "xls/tools/opt.h"
+#include "xls/tools/pass_profile.h"
 
 const char kUsage[] = R"(
 Takes in an IR file and produces an IR file that has been run through the
@@ -40,6 +57,39 @@ where:
 
 Example invocation:
   opt_main path/to/file.ir
+
+Daemon mode: with --server=<SOCKET_PATH> the tool instead listens on a unix
+domain socket and optimizes one request after another in the same process, so
+batch builds invoking the optimizer thousands of times amortize process
+startup and share in-process caches. Each request and response is a 4-byte
+big-endian length followed by that many bytes. A request carries the IR text;
+the options are fixed by the server's own flags. A response carries a status
+byte (0 for success, 1 for error) followed by the optimized output or the
+error message. A zero-length request shuts the server down. --client=<
+SOCKET_PATH> makes opt_main submit its input to such a server instead of
+optimizing in-process:
+
+  opt_main --server=/tmp/opt.sock &
+  opt_main --client=/tmp/opt.sock path/to/file.ir
+
+Distributed mode: --partition_into=<N> splits the input package by
+call-graph component into at most N independently optimizable packages in
+--partition_dir; each can be optimized by a separate opt_main invocation
+(e.g. on separate machines), and --merge_partitions recombines the results:
+
+  opt_main --partition_into=4 --partition_dir=/tmp/parts path/to/file.ir
+  <optimize each /tmp/parts/*.ir with its own opt_main, in place>
+  opt_main --merge_partitions=/tmp/parts > optimized.ir
+
+Profile-guided mode: record pass profiles for representative designs of a
+family with --pass_profile, synthesize a pipeline configuration which skips
+the passes with zero recorded yield, then replay it on other members of the
+family:
+
+  opt_main --pass_profile=/tmp/a.json design_a.ir > /dev/null
+  opt_main --pass_profile=/tmp/b.json design_b.ir > /dev/null
+  opt_main --synthesize_pipeline_config=family.cfg /tmp/a.json /tmp/b.json
+  opt_main --pipeline_config=family.cfg design_c.ir
 )";
 
 // LINT.IfChange
@@ -64,20 +114,115 @@ ABSL_FLAG(int64_t, opt_level, xls::kMaxOptLevel,
                           xls::kMaxOptLevel));
 ABSL_FLAG(bool, inline_procs, false,
           "Whether to inline all procs by calling the proc inlining pass. ");
+ABSL_FLAG(int64_t, parallelism, 1,
+          "Number of worker threads function-level passes may use to process "
+          "the functions/procs of the package in parallel. The default of 1 "
+          "runs everything serially.");
+ABSL_FLAG(std::string, pass_profile, "",
+          "If specified, write a JSON profile of the optimization pipeline to "
+          "the given path: per-pass wall time, node-count delta, transform "
+          "count, peak-RSS delta and package memory breakdown, plus "
+          "cumulative iteration counts of the fixed-point compound passes.");
+ABSL_FLAG(std::string, pipeline_config, "",
+          "If specified, a pipeline configuration file (as written by "
+          "--synthesize_pipeline_config) whose skip directives are applied in "
+          "addition to --skip_passes. Synthesized from recorded pass profiles "
+          "of a design family, this prunes passes with zero historical yield.");
+ABSL_FLAG(std::string, synthesize_pipeline_config, "",
+          "If specified, instead of optimizing, aggregate the pass profile "
+          "JSON files given as positional arguments (as written by "
+          "--pass_profile) and write a pipeline configuration to the given "
+          "path which skips every pass that never changed the IR in any of "
+          "the profiles. Load the result with --pipeline_config.");
+ABSL_FLAG(int64_t, memory_limit, 0,
+          "If positive, abort optimization with a package memory breakdown "
+          "when the process's peak resident set size exceeds this many bytes, "
+          "instead of running until the process is OOM-killed. Zero disables "
+          "the limit.");
+ABSL_FLAG(std::string, opt_cache_dir, "",
+          "If specified, a directory used as a content-addressed cache of "
+          "optimized IR, keyed on the input IR text and the optimization "
+          "flags. When byte-identical IR is re-optimized with the same flags "
+          "the cached output is returned without running any passes. The "
+          "directory must exist; entries are plain IR files and may be "
+          "deleted at any time.");
+ABSL_FLAG(std::string, checkpoint_dir, "",
+          "If specified, a directory the optimization pipeline periodically "
+          "writes checkpoints to: the package in binary serialized form plus "
+          "the pipeline position. A compile killed mid-pipeline can be "
+          "restarted from the last checkpoint with --resume_from. The "
+          "directory must exist.");
+ABSL_FLAG(absl::Duration, checkpoint_interval, absl::Minutes(5),
+          "Minimum wall time between checkpoint writes (see "
+          "--checkpoint_dir).");
+ABSL_FLAG(absl::Duration, timeout, absl::InfiniteDuration(),
+          "If set, stop the pass pipeline once this much wall time has "
+          "elapsed and emit the IR optimized so far as a best-effort result "
+          "(the pass profile reflects the passes which ran). Preferable to an "
+          "external SIGKILL, which loses both the output and the "
+          "diagnostics.");
+ABSL_FLAG(std::string, resume_from, "",
+          "If specified, a checkpoint directory (see --checkpoint_dir) to "
+          "resume optimization from instead of starting over. The input IR "
+          "file is ignored; the run must otherwise use the same flags as the "
+          "one which wrote the checkpoint.");
+ABSL_FLAG(std::vector<std::string>, channel_values, {},
+          "Comma-separated list of <channel>=<typed value> bindings (e.g. "
+          "config=bits[32]:42) asserting that the named receive-only channel "
+          "always carries the given value. Receives on bound channels are "
+          "replaced with the value and the channel is removed before "
+          "optimization, so configuration-dependent logic is evaluated at "
+          "compile time.");
+ABSL_FLAG(std::string, output_format, "text",
+          "Format in which the optimized package is emitted: 'text' for the "
+          "canonical IR text, 'binary' for the binary serialization "
+          "(ir_binary.h) which downstream tools load without re-scanning.");
 // LINT.ThenChange(//xls/build_rules/xls_ir_rules.bzl)
+ABSL_FLAG(std::string, server, "",
+          "If specified, run as a persistent optimization server listening on "
+          "a unix domain socket at the given path (see usage text for the "
+          "protocol). All other flags apply to every request.");
+ABSL_FLAG(std::string, client, "",
+          "If specified, submit the input IR to the optimization server "
+          "listening on the unix domain socket at the given path and print "
+          "its response.");
+ABSL_FLAG(int64_t, partition_into, 0,
+          "If positive, instead of optimizing, split the input package by "
+          "call-graph component into at most this many independently "
+          "optimizable packages and write them to --partition_dir as "
+          "<package>_part<N>.ir (paths are printed to stdout). Partitions "
+          "other than the one holding the package top have no top set; "
+          "optimize those with an explicit --top.");
+ABSL_FLAG(std::string, partition_dir, "",
+          "Directory partition files are written to (see --partition_into).");
+ABSL_FLAG(std::string, merge_partitions, "",
+          "If specified, a directory of optimized partition files (every .ir "
+          "file in it, as written by --partition_into and then optimized in "
+          "place) to merge into a single package printed to stdout. No "
+          "optimization is performed and no input file is read. If more than "
+          "one partition carries a top entity (workers name a scratch top "
+          "with --top), pass --top to select the merged package's top.");
 
 namespace xls::tools {
 namespace {
 
-absl::Status RealMain(absl::string_view input_path) {
-  if (input_path == "-") {
-    input_path = "/dev/stdin";
-  }
-  XLS_ASSIGN_OR_RETURN(std::string ir, GetFileContents(input_path));
+// Optimizes the given IR text according to the tool's flags and returns the
+// output in the format selected by --output_format.
+absl::StatusOr<std::string> OptimizeWithFlags(absl::string_view ir) {
   std::string entry = absl::GetFlag(FLAGS_top);
   std::string ir_dump_path = absl::GetFlag(FLAGS_ir_dump_path);
   std::vector<std::string> run_only_passes =
       absl::GetFlag(FLAGS_run_only_passes);
+  std::vector<std::string> skip_passes = absl::GetFlag(FLAGS_skip_passes);
+  const std::string pipeline_config = absl::GetFlag(FLAGS_pipeline_config);
+  if (!pipeline_config.empty()) {
+    XLS_ASSIGN_OR_RETURN(std::string contents,
+                         GetFileContents(pipeline_config));
+    XLS_ASSIGN_OR_RETURN(std::vector<std::string> config_skips,
+                         ParsePipelineConfigSkips(contents));
+    skip_passes.insert(skip_passes.end(), config_skips.begin(),
+                       config_skips.end());
+  }
   int64_t convert_array_index_to_select =
       absl::GetFlag(FLAGS_convert_array_index_to_select);
   const OptOptions options = {
@@ -87,15 +232,304 @@ absl::Status RealMain(absl::string_view input_path) {
       .run_only_passes = run_only_passes.empty()
                              ? absl::nullopt
                              : absl::make_optional(std::move(run_only_passes)),
-      .skip_passes = absl::GetFlag(FLAGS_skip_passes),
+      .skip_passes = std::move(skip_passes),
       .convert_array_index_to_select =
           (convert_array_index_to_select < 0)
               ? std::nullopt
               : std::make_optional(convert_array_index_to_select),
       .inline_procs = absl::GetFlag(FLAGS_inline_procs),
+      .parallelism = absl::GetFlag(FLAGS_parallelism),
+      .pass_profile_path = absl::GetFlag(FLAGS_pass_profile),
+      .memory_limit_bytes =
+          (absl::GetFlag(FLAGS_memory_limit) > 0)
+              ? std::make_optional(absl::GetFlag(FLAGS_memory_limit))
+              : std::nullopt,
+      .optimization_cache_dir = absl::GetFlag(FLAGS_opt_cache_dir),
+      .checkpoint_dir = absl::GetFlag(FLAGS_checkpoint_dir),
+      .checkpoint_interval = absl::GetFlag(FLAGS_checkpoint_interval),
+      .resume_from = absl::GetFlag(FLAGS_resume_from),
+      .timeout = (absl::GetFlag(FLAGS_timeout) == absl::InfiniteDuration())
+                     ? std::nullopt
+                     : std::make_optional(absl::GetFlag(FLAGS_timeout)),
+      .channel_values = absl::GetFlag(FLAGS_channel_values),
   };
   XLS_ASSIGN_OR_RETURN(std::string opt_ir,
                        tools::OptimizeIrForEntry(ir, options));
+  const std::string output_format = absl::GetFlag(FLAGS_output_format);
+  if (output_format == "binary") {
+    XLS_ASSIGN_OR_RETURN(opt_ir, SerializeIrTextToBinary(opt_ir));
+  } else if (output_format != "text") {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Invalid --output_format value: %s", output_format));
+  }
+  return opt_ir;
+}
+
+// Reads exactly 'size' bytes from 'fd' into 'data'. Returns false on a clean
+// end-of-stream before the first byte; errors otherwise.
+absl::StatusOr<bool> ReadFull(int fd, char* data, size_t size) {
+  size_t total = 0;
+  while (total < size) {
+    ssize_t n = read(fd, data + total, size - total);
+    if (n < 0) {
+      return absl::InternalError(
+          absl::StrFormat("Error reading from socket: %s", strerror(errno)));
+    }
+    if (n == 0) {
+      if (total == 0) {
+        return false;
+      }
+      return absl::InternalError("Socket closed mid-message");
+    }
+    total += n;
+  }
+  return true;
+}
+
+absl::Status WriteFull(int fd, const char* data, size_t size) {
+  size_t total = 0;
+  while (total < size) {
+    ssize_t n = write(fd, data + total, size - total);
+    if (n < 0) {
+      return absl::InternalError(
+          absl::StrFormat("Error writing to socket: %s", strerror(errno)));
+    }
+    total += n;
+  }
+  return absl::OkStatus();
+}
+
+// Reads one length-prefixed message from 'fd'. Returns nullopt on a clean
+// end-of-stream before the length prefix.
+absl::StatusOr<std::optional<std::string>> ReadMessage(int fd) {
+  char prefix[4];
+  XLS_ASSIGN_OR_RETURN(bool got_prefix, ReadFull(fd, prefix, sizeof(prefix)));
+  if (!got_prefix) {
+    return absl::nullopt;
+  }
+  uint32_t size = (static_cast<uint32_t>(static_cast<uint8_t>(prefix[0])) << 24) |
+                  (static_cast<uint32_t>(static_cast<uint8_t>(prefix[1])) << 16) |
+                  (static_cast<uint32_t>(static_cast<uint8_t>(prefix[2])) << 8) |
+                  static_cast<uint32_t>(static_cast<uint8_t>(prefix[3]));
+  std::string payload(size, '\0');
+  if (size > 0) {
+    XLS_ASSIGN_OR_RETURN(bool got_payload,
+                         ReadFull(fd, payload.data(), payload.size()));
+    if (!got_payload) {
+      return absl::InternalError("Socket closed mid-message");
+    }
+  }
+  return payload;
+}
+
+absl::Status WriteMessage(int fd, absl::string_view payload) {
+  uint32_t size = static_cast<uint32_t>(payload.size());
+  char prefix[4] = {static_cast<char>(size >> 24), static_cast<char>(size >> 16),
+                    static_cast<char>(size >> 8), static_cast<char>(size)};
+  XLS_RETURN_IF_ERROR(WriteFull(fd, prefix, sizeof(prefix)));
+  return WriteFull(fd, payload.data(), payload.size());
+}
+
+// Runs the persistent optimization server on a unix domain socket at
+// 'socket_path'. Serves until a client sends a zero-length request.
+absl::Status ServerMain(const std::string& socket_path) {
+  int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd < 0) {
+    return absl::InternalError(
+        absl::StrFormat("Unable to create socket: %s", strerror(errno)));
+  }
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(addr.sun_path)) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Socket path too long: %s", socket_path));
+  }
+  strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+  unlink(socket_path.c_str());
+  if (bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+    return absl::InternalError(absl::StrFormat("Unable to bind %s: %s",
+                                               socket_path, strerror(errno)));
+  }
+  if (listen(listen_fd, SOMAXCONN) < 0) {
+    return absl::InternalError(
+        absl::StrFormat("Unable to listen on %s: %s", socket_path,
+                        strerror(errno)));
+  }
+  XLS_VLOG(1) << "Serving optimization requests on " << socket_path;
+
+  bool shutdown_requested = false;
+  while (!shutdown_requested) {
+    int client_fd = accept(listen_fd, nullptr, nullptr);
+    if (client_fd < 0) {
+      return absl::InternalError(
+          absl::StrFormat("accept() failed: %s", strerror(errno)));
+    }
+    // Serve requests on this connection until the client disconnects.
+    while (true) {
+      absl::StatusOr<std::optional<std::string>> request =
+          ReadMessage(client_fd);
+      if (!request.ok() || !request->has_value()) {
+        break;
+      }
+      if ((*request)->empty()) {
+        shutdown_requested = true;
+        break;
+      }
+      absl::StatusOr<std::string> result = OptimizeWithFlags(**request);
+      std::string response;
+      if (result.ok()) {
+        response.push_back('\0');
+        response.append(*result);
+      } else {
+        response.push_back('\1');
+        response.append(result.status().ToString());
+      }
+      absl::Status write_status = WriteMessage(client_fd, response);
+      if (!write_status.ok()) {
+        XLS_LOG(WARNING) << write_status;
+        break;
+      }
+    }
+    close(client_fd);
+  }
+  close(listen_fd);
+  unlink(socket_path.c_str());
+  return absl::OkStatus();
+}
+
+// Submits the given IR to the server at 'socket_path' and returns the
+// optimized output.
+absl::StatusOr<std::string> ClientMain(const std::string& socket_path,
+                                       absl::string_view ir) {
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return absl::InternalError(
+        absl::StrFormat("Unable to create socket: %s", strerror(errno)));
+  }
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(addr.sun_path)) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Socket path too long: %s", socket_path));
+  }
+  strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+  if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+    return absl::UnavailableError(absl::StrFormat(
+        "Unable to connect to %s: %s", socket_path, strerror(errno)));
+  }
+  absl::Status status = WriteMessage(fd, ir);
+  absl::StatusOr<std::optional<std::string>> response =
+      status.ok() ? ReadMessage(fd)
+                  : absl::StatusOr<std::optional<std::string>>(status);
+  close(fd);
+  XLS_RETURN_IF_ERROR(response.status());
+  if (!response->has_value() || (*response)->empty()) {
+    return absl::InternalError("Server closed the connection without a reply");
+  }
+  std::string& payload = **response;
+  if (payload[0] != '\0') {
+    return absl::InternalError(payload.substr(1));
+  }
+  return payload.substr(1);
+}
+
+// Splits the input package into partitions (see PartitionPackage) and writes
+// one IR file per partition to --partition_dir, printing the paths.
+absl::Status PartitionMain(absl::string_view input_path) {
+  if (input_path == "-") {
+    input_path = "/dev/stdin";
+  }
+  const std::string partition_dir = absl::GetFlag(FLAGS_partition_dir);
+  if (partition_dir.empty()) {
+    return absl::InvalidArgumentError(
+        "--partition_into requires --partition_dir");
+  }
+  XLS_ASSIGN_OR_RETURN(std::string ir, GetFileContents(input_path));
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                       ParsePackageAnyFormat(ir, std::string(input_path)));
+  XLS_ASSIGN_OR_RETURN(
+      std::vector<std::unique_ptr<Package>> partitions,
+      PartitionPackage(*package, absl::GetFlag(FLAGS_partition_into)));
+  for (int64_t i = 0; i < static_cast<int64_t>(partitions.size()); ++i) {
+    std::filesystem::path path =
+        std::filesystem::path(partition_dir) /
+        absl::StrFormat("%s_part%d.ir", package->name(), i);
+    XLS_RETURN_IF_ERROR(SetFileContents(path, partitions[i]->DumpIr()));
+    std::cout << path.string() << "\n";
+  }
+  return absl::OkStatus();
+}
+
+// Merges the optimized partition files (every .ir file) in the given
+// directory and prints the combined package.
+absl::Status MergeMain(const std::string& partition_dir) {
+  XLS_ASSIGN_OR_RETURN(std::vector<std::filesystem::path> entries,
+                       GetDirectoryEntries(partition_dir));
+  std::sort(entries.begin(), entries.end());
+  std::vector<std::unique_ptr<Package>> partitions;
+  std::vector<Package*> partition_ptrs;
+  for (const std::filesystem::path& path : entries) {
+    if (path.extension() != ".ir") {
+      continue;
+    }
+    XLS_ASSIGN_OR_RETURN(std::string contents, GetFileContents(path));
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> partition,
+                         ParsePackageAnyFormat(contents, path.string()));
+    partition_ptrs.push_back(partition.get());
+    partitions.push_back(std::move(partition));
+  }
+  if (partitions.empty()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "No .ir partition files found in '%s'", partition_dir));
+  }
+  // Workers optimizing a top-less partition name a scratch top with --top
+  // which ends up marked in their output; an explicit --top on the merge
+  // picks the real one.
+  const std::string top = absl::GetFlag(FLAGS_top);
+  if (!top.empty()) {
+    for (const std::unique_ptr<Package>& partition : partitions) {
+      XLS_RETURN_IF_ERROR(partition->SetTop(std::nullopt));
+    }
+  }
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<Package> merged,
+      MergePackages(partition_ptrs, partitions.front()->name()));
+  if (!top.empty()) {
+    XLS_RETURN_IF_ERROR(merged->SetTopByName(top));
+  }
+  std::cout << merged->DumpIr();
+  return absl::OkStatus();
+}
+
+// Aggregates the given pass profile JSON files (written by --pass_profile)
+// and writes a pipeline configuration to 'output_path' which skips every
+// pass with zero recorded yield.
+absl::Status SynthesizeConfigMain(
+    absl::Span<const absl::string_view> profile_paths,
+    const std::string& output_path) {
+  std::map<std::string, PassYield> yields;
+  for (absl::string_view path : profile_paths) {
+    XLS_ASSIGN_OR_RETURN(std::string json, GetFileContents(path));
+    XLS_RETURN_IF_ERROR(AccumulatePassProfileJson(json, &yields))
+        << "while reading pass profile " << path;
+  }
+  return SetFileContents(output_path, SynthesizePipelineConfig(yields));
+}
+
+absl::Status RealMain(absl::string_view input_path) {
+  if (input_path == "-") {
+    input_path = "/dev/stdin";
+  }
+  XLS_ASSIGN_OR_RETURN(std::string ir, GetFileContents(input_path));
+  std::string opt_ir;
+  const std::string client_socket = absl::GetFlag(FLAGS_client);
+  if (!client_socket.empty()) {
+    XLS_ASSIGN_OR_RETURN(opt_ir, ClientMain(client_socket, ir));
+  } else {
+    XLS_ASSIGN_OR_RETURN(opt_ir, OptimizeWithFlags(ir));
+  }
   std::cout << opt_ir;
   return absl::OkStatus();
 }
@@ -107,11 +541,36 @@ int main(int argc, char **argv) {
   std::vector<absl::string_view> positional_arguments =
       xls::InitXls(kUsage, argc, argv);
 
+  const std::string server_socket = absl::GetFlag(FLAGS_server);
+  if (!server_socket.empty()) {
+    XLS_QCHECK_OK(xls::tools::ServerMain(server_socket));
+    return EXIT_SUCCESS;
+  }
+
+  const std::string merge_partitions = absl::GetFlag(FLAGS_merge_partitions);
+  if (!merge_partitions.empty()) {
+    XLS_QCHECK_OK(xls::tools::MergeMain(merge_partitions));
+    return EXIT_SUCCESS;
+  }
+
   if (positional_arguments.empty()) {
     XLS_LOG(QFATAL) << absl::StreamFormat("Expected invocation: %s <path>",
                                           argv[0]);
   }
 
+  const std::string synthesize_pipeline_config =
+      absl::GetFlag(FLAGS_synthesize_pipeline_config);
+  if (!synthesize_pipeline_config.empty()) {
+    XLS_QCHECK_OK(xls::tools::SynthesizeConfigMain(
+        positional_arguments, synthesize_pipeline_config));
+    return EXIT_SUCCESS;
+  }
+
+  if (absl::GetFlag(FLAGS_partition_into) > 0) {
+    XLS_QCHECK_OK(xls::tools::PartitionMain(positional_arguments[0]));
+    return EXIT_SUCCESS;
+  }
+
   XLS_QCHECK_OK(xls::tools::RealMain(positional_arguments[0]));
   return EXIT_SUCCESS;
 }
@@ -15,7 +15,11 @@
 
 """Tests for xls.tools.codegen_main."""
 
+import os
+import socket
+import struct
 import subprocess
+import time
 
 from xls.common import runfiles
 from xls.common import test_base
@@ -73,6 +77,83 @@ class OptMainTest(test_base.TestCase):
     # The add with zero should be eliminated.
     self.assertIn('ret x', optimized_ir)
 
+  def test_opt_cache_dir(self):
+    ir_file = self.create_tempfile(content=ADD_ZERO_IR)
+    cache_dir = self.create_tempdir()
+
+    optimized_ir = subprocess.check_output(
+        [OPT_MAIN_PATH, '--opt_cache_dir=' + cache_dir.full_path,
+         ir_file.full_path]).decode('utf-8')
+    self.assertIn('ret x', optimized_ir)
+
+    # The miss should have written exactly one cache entry, and a re-run with
+    # identical input and flags should serve the same output from it.
+    self.assertLen(os.listdir(cache_dir.full_path), 1)
+    cached_ir = subprocess.check_output(
+        [OPT_MAIN_PATH, '--opt_cache_dir=' + cache_dir.full_path,
+         ir_file.full_path]).decode('utf-8')
+    self.assertEqual(optimized_ir, cached_ir)
+    self.assertLen(os.listdir(cache_dir.full_path), 1)
+
+    # Different flags miss and add a second entry.
+    subprocess.check_output(
+        [OPT_MAIN_PATH, '--opt_cache_dir=' + cache_dir.full_path,
+         '--opt_level=1', ir_file.full_path])
+    self.assertLen(os.listdir(cache_dir.full_path), 2)
+
+  def test_checkpoint_and_resume(self):
+    ir_file = self.create_tempfile(content=ADD_LITERAL_IR)
+    checkpoint_dir = self.create_tempdir()
+
+    # A zero interval checkpoints after every pass, so the final checkpoint
+    # holds the fully optimized package and the complete invocation log.
+    optimized_ir = subprocess.check_output(
+        [OPT_MAIN_PATH, '--checkpoint_dir=' + checkpoint_dir.full_path,
+         '--checkpoint_interval=0s', ir_file.full_path]).decode('utf-8')
+    self.assertIn('concat', optimized_ir)
+    self.assertIn('package.bin', os.listdir(checkpoint_dir.full_path))
+    self.assertIn('invocations.txt', os.listdir(checkpoint_dir.full_path))
+
+    # Resuming replays the recorded invocations against the checkpointed
+    # package and produces the same output as the uninterrupted run.
+    resumed_ir = subprocess.check_output(
+        [OPT_MAIN_PATH, '--resume_from=' + checkpoint_dir.full_path,
+         ir_file.full_path]).decode('utf-8')
+    self.assertEqual(optimized_ir, resumed_ir)
+
+  def test_partition_and_merge(self):
+    ir_file = self.create_tempfile(content=DEAD_FUNCTION_IR)
+    partition_dir = self.create_tempdir()
+
+    # main and dead_function are independent call-graph components, so they
+    # split into two partitions; only main's partition keeps the top.
+    paths = subprocess.check_output(
+        [OPT_MAIN_PATH, '--partition_into=2',
+         '--partition_dir=' + partition_dir.full_path,
+         ir_file.full_path]).decode('utf-8').split()
+    self.assertLen(paths, 2)
+
+    # Optimize each partition in place, as distributed workers would. The
+    # partition without a top entity needs one named explicitly.
+    for path in paths:
+      with open(path) as f:
+        contents = f.read()
+      cmd = [OPT_MAIN_PATH, path]
+      if 'top fn' not in contents:
+        cmd.append('--top=dead_function')
+      optimized = subprocess.check_output(cmd).decode('utf-8')
+      with open(path, 'w') as f:
+        f.write(optimized)
+
+    # Both partitions now carry a top (the worker named one explicitly), so
+    # the merge needs --top to pick the real one.
+    merged_ir = subprocess.check_output(
+        [OPT_MAIN_PATH, '--top=main',
+         '--merge_partitions=' + partition_dir.full_path]).decode('utf-8')
+    self.assertIn('top fn main', merged_ir)
+    self.assertIn('dead_function', merged_ir)
+    self.assertIn('ret x', merged_ir)
+
   def test_run_only_arith_simp_and_dce_passes(self):
     ir_file = self.create_tempfile(content=DEAD_FUNCTION_IR)
 
@@ -128,6 +209,71 @@ class OptMainTest(test_base.TestCase):
     self.assertIn('bits[32] = add', optimized_ir)
     self.assertNotIn('concat', optimized_ir)
 
+  def _send_request(self, sock, payload: bytes) -> None:
+    sock.sendall(struct.pack('>I', len(payload)) + payload)
+
+  def _read_response(self, sock) -> bytes:
+    prefix = b''
+    while len(prefix) < 4:
+      prefix += sock.recv(4 - len(prefix))
+    (size,) = struct.unpack('>I', prefix)
+    payload = b''
+    while len(payload) < size:
+      payload += sock.recv(size - len(payload))
+    return payload
+
+  def test_server_mode(self):
+    socket_path = os.path.join(self.create_tempdir().full_path, 'opt.sock')
+    server = subprocess.Popen([OPT_MAIN_PATH, '--server=' + socket_path])
+    try:
+      # Wait for the server to bind its socket.
+      for _ in range(100):
+        if os.path.exists(socket_path):
+          break
+        time.sleep(0.1)
+      sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+      sock.connect(socket_path)
+
+      # Multiple requests on one connection share the server process.
+      self._send_request(sock, ADD_ZERO_IR.encode('utf-8'))
+      response = self._read_response(sock)
+      self.assertEqual(response[0], 0)
+      self.assertIn('ret x', response[1:].decode('utf-8'))
+
+      self._send_request(sock, b'not an ir package')
+      response = self._read_response(sock)
+      self.assertEqual(response[0], 1)
+
+      self._send_request(sock, ADD_ZERO_IR.encode('utf-8'))
+      response = self._read_response(sock)
+      self.assertEqual(response[0], 0)
+
+      # A zero-length request shuts the server down.
+      self._send_request(sock, b'')
+      sock.close()
+      self.assertEqual(server.wait(timeout=60), 0)
+    finally:
+      if server.poll() is None:
+        server.kill()
+        server.wait()
+
+  def test_client_mode(self):
+    socket_path = os.path.join(self.create_tempdir().full_path, 'opt.sock')
+    server = subprocess.Popen([OPT_MAIN_PATH, '--server=' + socket_path])
+    try:
+      for _ in range(100):
+        if os.path.exists(socket_path):
+          break
+        time.sleep(0.1)
+      ir_file = self.create_tempfile(content=ADD_ZERO_IR)
+      optimized_ir = subprocess.check_output(
+          [OPT_MAIN_PATH, '--client=' + socket_path,
+           ir_file.full_path]).decode('utf-8')
+      self.assertIn('ret x', optimized_ir)
+    finally:
+      server.kill()
+      server.wait()
+
 
 if __name__ == '__main__':
   test_base.main()
@@ -0,0 +1,139 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/tools/pass_profile.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
+#include "xls/common/status/status_macros.h"
+
+namespace xls::tools {
+namespace {
+
+// Extracts the integer value of `"<key>": <value>` within `object`. The
+// profiles are written by PassResultsToJson with a fixed shape, so a full
+// JSON parser is not needed.
+absl::StatusOr<int64_t> FindIntField(absl::string_view object,
+                                     absl::string_view key) {
+  std::string needle = absl::StrCat("\"", key, "\": ");
+  size_t pos = object.find(needle);
+  if (pos == absl::string_view::npos) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Pass profile entry has no \"", key, "\" field"));
+  }
+  absl::string_view rest = object.substr(pos + needle.size());
+  size_t end = rest.find_first_not_of("-0123456789");
+  int64_t value;
+  if (!absl::SimpleAtoi(rest.substr(0, end), &value)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Malformed \"", key, "\" field in pass profile"));
+  }
+  return value;
+}
+
+absl::StatusOr<bool> FindBoolField(absl::string_view object,
+                                   absl::string_view key) {
+  std::string needle = absl::StrCat("\"", key, "\": ");
+  size_t pos = object.find(needle);
+  if (pos == absl::string_view::npos) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Pass profile entry has no \"", key, "\" field"));
+  }
+  return absl::StartsWith(object.substr(pos + needle.size()), "true");
+}
+
+}  // namespace
+
+absl::Status AccumulatePassProfileJson(
+    absl::string_view json, std::map<std::string, PassYield>* yields) {
+  constexpr absl::string_view kNameKey = "\"name\": \"";
+  size_t pos = json.find(kNameKey);
+  if (pos == absl::string_view::npos) {
+    return absl::InvalidArgumentError(
+        "Not a pass profile: no pass entries found");
+  }
+  while (pos != absl::string_view::npos) {
+    size_t name_start = pos + kNameKey.size();
+    size_t name_end = json.find('"', name_start);
+    if (name_end == absl::string_view::npos) {
+      return absl::InvalidArgumentError("Truncated pass profile entry");
+    }
+    absl::string_view name = json.substr(name_start, name_end - name_start);
+    // The fields of this invocation lie between its name and the next one.
+    size_t next = json.find(kNameKey, name_end);
+    absl::string_view object = json.substr(
+        name_end,
+        (next == absl::string_view::npos ? json.size() : next) - name_end);
+
+    PassYield& yield = (*yields)[std::string(name)];
+    yield.runs++;
+    XLS_ASSIGN_OR_RETURN(bool changed, FindBoolField(object, "changed"));
+    if (changed) {
+      yield.changed++;
+    }
+    XLS_ASSIGN_OR_RETURN(int64_t transform_count,
+                         FindIntField(object, "transform_count"));
+    yield.transform_count += transform_count;
+    XLS_ASSIGN_OR_RETURN(int64_t duration_us,
+                         FindIntField(object, "duration_us"));
+    yield.duration_us += duration_us;
+    pos = next;
+  }
+  return absl::OkStatus();
+}
+
+std::string SynthesizePipelineConfig(
+    const std::map<std::string, PassYield>& yields) {
+  std::string config =
+      "# Pass pipeline configuration synthesized from recorded pass "
+      "profiles.\n"
+      "# Load with `opt_main --pipeline_config=<this file>`.\n"
+      "#\n"
+      "# pass: runs changed transforms time_us\n";
+  for (const auto& [name, yield] : yields) {
+    absl::StrAppendFormat(&config, "# %s: %d %d %d %d\n", name, yield.runs,
+                          yield.changed, yield.transform_count,
+                          yield.duration_us);
+  }
+  config += "\n";
+  for (const auto& [name, yield] : yields) {
+    if (yield.changed == 0 && yield.transform_count == 0) {
+      absl::StrAppendFormat(&config, "skip %s\n", name);
+    }
+  }
+  return config;
+}
+
+absl::StatusOr<std::vector<std::string>> ParsePipelineConfigSkips(
+    absl::string_view contents) {
+  std::vector<std::string> skips;
+  for (absl::string_view line : absl::StrSplit(contents, '\n')) {
+    line = absl::StripAsciiWhitespace(line);
+    if (line.empty() || absl::StartsWith(line, "#")) {
+      continue;
+    }
+    if (!absl::ConsumePrefix(&line, "skip ")) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Malformed pipeline configuration line: \"", line, "\""));
+    }
+    skips.push_back(std::string(absl::StripAsciiWhitespace(line)));
+  }
+  return skips;
+}
+
+}  // namespace xls::tools
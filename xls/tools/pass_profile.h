@@ -0,0 +1,75 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Profile-guided pass pipeline configuration.
+//
+// Pass profitability varies widely between design families: a pass which
+// dominates the yield on one family may never fire on another yet still be
+// paid for on every compile. The workflow supported here is:
+//
+//   1. Record: run `opt_main --pass_profile=PROFILE.json` on representative
+//      designs of a family.
+//   2. Synthesize: `opt_main --synthesize_pipeline_config=CONFIG PROFILE...`
+//      aggregates the recorded per-pass yields and emits a pipeline
+//      configuration which skips every pass with zero historical yield.
+//   3. Replay: `opt_main --pipeline_config=CONFIG` compiles members of the
+//      family with the pruned pipeline.
+
+#ifndef XLS_TOOLS_PASS_PROFILE_H_
+#define XLS_TOOLS_PASS_PROFILE_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+
+namespace xls::tools {
+
+// Aggregate yield of one pass across recorded profile runs.
+struct PassYield {
+  // Number of recorded invocations.
+  int64_t runs = 0;
+  // Number of invocations which changed the IR.
+  int64_t changed = 0;
+  // Total IR transformations performed.
+  int64_t transform_count = 0;
+  // Total wall time in microseconds.
+  int64_t duration_us = 0;
+};
+
+// Accumulates the per-pass entries of one recorded profile (the JSON written
+// by `opt_main --pass_profile`) into `yields`. May be called once per profile
+// file to aggregate a design family.
+absl::Status AccumulatePassProfileJson(
+    absl::string_view json, std::map<std::string, PassYield>* yields);
+
+// Renders a pipeline configuration from aggregated yields: a comment table of
+// every recorded pass followed by a `skip` directive for each pass which
+// never changed the IR and performed no transforms. Loadable with
+// `opt_main --pipeline_config`.
+std::string SynthesizePipelineConfig(
+    const std::map<std::string, PassYield>& yields);
+
+// Parses a pipeline configuration, returning the pass names to skip. Lines
+// are either blank, `#` comments, or `skip <pass_name>` directives.
+absl::StatusOr<std::vector<std::string>> ParsePipelineConfigSkips(
+    absl::string_view contents);
+
+}  // namespace xls::tools
+
+#endif  // XLS_TOOLS_PASS_PROFILE_H_
@@ -0,0 +1,140 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/tools/pass_profile.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+
+namespace xls::tools {
+namespace {
+
+using status_testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::UnorderedElementsAre;
+
+// A profile in the shape written by `opt_main --pass_profile`.
+constexpr const char kProfileA[] = R"({
+  "passes": [
+    {
+      "name": "dce",
+      "changed": true,
+      "duration_us": 120,
+      "node_count_delta": -4,
+      "transform_count": 4,
+      "peak_rss_delta_bytes": 0
+    },
+    {
+      "name": "cse",
+      "changed": false,
+      "duration_us": 90,
+      "node_count_delta": 0,
+      "transform_count": 0,
+      "peak_rss_delta_bytes": 0
+    },
+    {
+      "name": "dce",
+      "changed": false,
+      "duration_us": 30,
+      "node_count_delta": 0,
+      "transform_count": 0,
+      "peak_rss_delta_bytes": 0
+    }
+  ],
+  "fixed_point_iterations": {
+    "simp": 3
+  }
+})";
+
+constexpr const char kProfileB[] = R"({
+  "passes": [
+    {
+      "name": "cse",
+      "changed": false,
+      "duration_us": 60,
+      "node_count_delta": 0,
+      "transform_count": 0,
+      "peak_rss_delta_bytes": 0
+    },
+    {
+      "name": "arith_simp",
+      "changed": true,
+      "duration_us": 200,
+      "node_count_delta": -2,
+      "transform_count": 7,
+      "peak_rss_delta_bytes": 0
+    }
+  ],
+  "fixed_point_iterations": {}
+})";
+
+TEST(PassProfileTest, AccumulatesAcrossProfiles) {
+  std::map<std::string, PassYield> yields;
+  XLS_ASSERT_OK(AccumulatePassProfileJson(kProfileA, &yields));
+  XLS_ASSERT_OK(AccumulatePassProfileJson(kProfileB, &yields));
+
+  ASSERT_EQ(yields.size(), 3);
+  EXPECT_EQ(yields.at("dce").runs, 2);
+  EXPECT_EQ(yields.at("dce").changed, 1);
+  EXPECT_EQ(yields.at("dce").transform_count, 4);
+  EXPECT_EQ(yields.at("dce").duration_us, 150);
+  EXPECT_EQ(yields.at("cse").runs, 2);
+  EXPECT_EQ(yields.at("cse").changed, 0);
+  EXPECT_EQ(yields.at("cse").duration_us, 150);
+  EXPECT_EQ(yields.at("arith_simp").runs, 1);
+  EXPECT_EQ(yields.at("arith_simp").transform_count, 7);
+}
+
+TEST(PassProfileTest, RejectsNonProfileInput) {
+  std::map<std::string, PassYield> yields;
+  EXPECT_THAT(AccumulatePassProfileJson("not json at all", &yields),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("no pass entries")));
+}
+
+TEST(PassProfileTest, SynthesizeSkipsOnlyZeroYieldPasses) {
+  std::map<std::string, PassYield> yields;
+  XLS_ASSERT_OK(AccumulatePassProfileJson(kProfileA, &yields));
+  XLS_ASSERT_OK(AccumulatePassProfileJson(kProfileB, &yields));
+
+  std::string config = SynthesizePipelineConfig(yields);
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<std::string> skips,
+                           ParsePipelineConfigSkips(config));
+  EXPECT_THAT(skips, ElementsAre("cse"));
+}
+
+TEST(PassProfileTest, ParseHandlesCommentsAndBlankLines) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<std::string> skips,
+                           ParsePipelineConfigSkips(
+                               "# a comment\n"
+                               "\n"
+                               "skip dce\n"
+                               "  skip cse  \n"));
+  EXPECT_THAT(skips, UnorderedElementsAre("dce", "cse"));
+}
+
+TEST(PassProfileTest, ParseRejectsUnknownDirective) {
+  EXPECT_THAT(ParsePipelineConfigSkips("reorder dce\n"),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Malformed pipeline configuration")));
+}
+
+}  // namespace
+}  // namespace xls::tools
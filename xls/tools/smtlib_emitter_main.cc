@@ -19,6 +19,7 @@
 // TODO(rspringer): No array support yet. Should be pretty trivial to add.
 
 #include <filesystem>
+#include <iostream>
 
 #include "absl/flags/flag.h"
 #include "absl/status/status.h"
@@ -29,6 +30,7 @@
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/ir_parser.h"
 #include "xls/solvers/z3_ir_translator.h"
+#include "xls/solvers/z3_smtlib_emitter.h"
 #include "../z3/src/api/z3.h"
 #include "../z3/src/api/z3_api.h"
 
@@ -39,11 +41,16 @@ ABSL_FLAG(
     "will be made to try to find the package's entry function. "
     "If that fails, an error will be returned.");
 ABSL_FLAG(std::string, ir_path, "", "Path to the XLS IR to process.");
+ABSL_FLAG(bool, lettify, true,
+          "Bind shared subexpressions with (let ...) and stream the output, "
+          "emitting each distinct subterm once. If false, Z3's tree-shaped "
+          "printer is used, which duplicates shared subterms textually and "
+          "can produce exponentially larger output.");
 
 namespace xls {
 
 absl::Status RealMain(const std::filesystem::path& ir_path,
-                      std::optional<std::string> top) {
+                      std::optional<std::string> top, bool lettify) {
   XLS_ASSIGN_OR_RETURN(std::string ir_text, GetFileContents(ir_path));
   XLS_ASSIGN_OR_RETURN(auto package, Parser::ParsePackage(ir_text));
   Function* function;
@@ -55,6 +62,12 @@ absl::Status RealMain(const std::filesystem::path& ir_path,
 
   XLS_ASSIGN_OR_RETURN(auto translator,
                        solvers::z3::IrTranslator::CreateAndTranslate(function));
+  if (lettify) {
+    XLS_RETURN_IF_ERROR(solvers::z3::EmitSmtlibWithLets(
+        translator->ctx(), translator->GetReturnNode(), &std::cout));
+    std::cout << std::endl;
+    return absl::OkStatus();
+  }
   Z3_set_ast_print_mode(translator->ctx(), Z3_PRINT_SMTLIB2_COMPLIANT);
   std::cout << Z3_ast_to_string(translator->ctx(), translator->GetReturnNode())
             << std::endl;
@@ -70,6 +83,7 @@ int main(int argc, char* argv[]) {
   if (!absl::GetFlag(FLAGS_top).empty()) {
     top = absl::GetFlag(FLAGS_top);
   }
-  XLS_QCHECK_OK(xls::RealMain(absl::GetFlag(FLAGS_ir_path), top));
+  XLS_QCHECK_OK(xls::RealMain(absl::GetFlag(FLAGS_ir_path), top,
+                              absl::GetFlag(FLAGS_lettify)));
   return 0;
 }
@@ -15,6 +15,8 @@
 #ifndef XLS_TOOLS_TESTBENCH_H_
 #define XLS_TOOLS_TESTBENCH_H_
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <thread>  // NOLINT(build/c++11)
@@ -35,10 +37,11 @@ namespace xls {
 // periodically printed to the terminal, as this class' primary use is for
 // exploring large test spaces.
 //
-// Presently, work is parititioned uniformly across threads at startup. This can
-// lead to work imbalance if certain areas of the input space execute faster
-// than others. More advanced strategies can be explored in the future if this
-// becomes a problem.
+// Work is distributed dynamically: the index space is divided into small
+// chunks which worker threads claim from a shared queue as they go. Threads
+// which land on cheap regions of the input space simply process more chunks,
+// so skewed per-sample costs (e.g. corner-case buckets of a floating-point
+// input space) do not leave cores idle for the tail of a run.
 
 namespace internal {
 // Forward decl of common Testbench base class.
@@ -92,11 +95,12 @@ class Testbench : public internal::TestbenchBase<InputT, ResultT, ShardDataT> {
         create_shard_(create_shard),
         compute_expected_(compute_expected),
         compute_actual_(compute_actual) {
-    this->thread_create_fn_ = [this](uint64_t start, uint64_t end) {
+    this->thread_create_fn_ = [this]() {
       return std::make_unique<TestbenchThread<InputT, ResultT, ShardDataT>>(
-          &this->mutex_, &this->wake_me_, start, end, this->max_failures_,
-          this->index_to_input_, create_shard_, compute_expected_,
-          compute_actual_, this->compare_results_, this->log_errors_);
+          &this->mutex_, &this->wake_me_, &this->next_index_, this->end_,
+          this->chunk_size_, this->max_failures_, this->index_to_input_,
+          create_shard_, compute_expected_, compute_actual_,
+          this->compare_results_, this->log_errors_);
     };
   }
 
@@ -124,11 +128,12 @@ class Testbench<InputT, ResultT, ShardDataT,
             compare_results, log_errors),
         compute_expected_(compute_expected),
         compute_actual_(compute_actual) {
-    this->thread_create_fn_ = [this](uint64_t start, uint64_t end) {
+    this->thread_create_fn_ = [this]() {
       return std::make_unique<TestbenchThread<InputT, ResultT, ShardDataT>>(
-          &this->mutex_, &this->wake_me_, start, end, this->max_failures_,
-          this->index_to_input_, compute_expected_, compute_actual_,
-          this->compare_results_, this->log_errors_);
+          &this->mutex_, &this->wake_me_, &this->next_index_, this->end_,
+          this->chunk_size_, this->max_failures_, this->index_to_input_,
+          compute_expected_, compute_actual_, this->compare_results_,
+          this->log_errors_);
     };
   }
 
@@ -179,24 +184,19 @@ class TestbenchBase {
     started_ = true;
     start_time_ = absl::Now();
 
+    // Size chunks so each thread claims many over a run; this keeps the load
+    // balanced under skewed per-sample costs while the claim itself (a single
+    // fetch-add on the shared queue head) stays insignificant per sample.
+    chunk_size_ = std::max(
+        uint64_t{1},
+        (end_ - start_) / (static_cast<uint64_t>(num_threads_) *
+                           kChunksPerThread));
+    next_index_.store(start_);
+
     // Set up all the workers.
-    uint64_t chunk_size = (end_ - start_) / num_threads_;
-    uint64_t chunk_remainder =
-        chunk_size == 0 ? (end_ - start_) : (end_ - start_) % chunk_size;
-    uint64_t first = 0;
-    uint64_t last;
     for (int i = 0; i < num_threads_; i++) {
-      last = first + chunk_size;
-      // Distribute any remainder evenly amongst the threads.
-      if (chunk_remainder > 0) {
-        last++;
-        chunk_remainder--;
-      }
-
-      threads_.push_back(thread_create_fn_(first, last));
+      threads_.push_back(thread_create_fn_());
       threads_.back()->Run();
-
-      first = last + 1;
     }
 
     // Now monitor them.
@@ -246,34 +246,34 @@ class TestbenchBase {
   // How many seconds to wait before printing status (at most).
   static constexpr absl::Duration kPrintInterval = absl::Seconds(5);
 
-  // Prints the current execution status across all threads.
-  void PrintStatus() {
-    // Get the remainder-adjusted chunk size for this thread.
-    auto thread_chunk_size = [this](int thread_index) {
-      uint64_t total_size = end_ - start_;
-      uint64_t chunk_size = total_size / threads_.size();
-      uint64_t remainder =
-          chunk_size == 0 ? total_size : total_size % chunk_size;
-      if (thread_index < remainder) {
-        chunk_size++;
-      }
-      return chunk_size;
-    };
+  // The target number of chunks each thread claims over a run. Larger values
+  // balance skewed workloads more finely at the cost of more (cheap) claims
+  // on the shared queue head.
+  static constexpr uint64_t kChunksPerThread = 256;
 
-    // Ignore remainder issues here. It shouldn't matter much at all.
+  // Prints the current execution status across all threads. With dynamic
+  // chunking threads do not own fixed slices of the index space, so progress
+  // is reported per thread as samples processed and recent throughput rather
+  // than as a percentage of a static shard.
+  void PrintStatus() {
     absl::Time now = absl::Now();
     auto delta = now - start_time_;
+    if (thread_last_done_.size() != threads_.size()) {
+      thread_last_done_.resize(threads_.size(), 0);
+    }
     uint64_t total_done = 0;
     for (int64_t i = 0; i < threads_.size(); ++i) {
       uint64_t num_passes = threads_[i]->num_passes();
       uint64_t num_failures = threads_[i]->num_failures();
       uint64_t thread_done = num_passes + num_failures;
-      uint64_t chunk_size = thread_chunk_size(i);
+      uint64_t interval_done = thread_done - thread_last_done_[i];
+      thread_last_done_[i] = thread_done;
       total_done += thread_done;
       std::cout << absl::StreamFormat(
-                       "thread %02d: %f%% @ %.1f us/sample :: failures %d", i,
-                       static_cast<double>(thread_done) / chunk_size * 100.0,
-                       absl::ToDoubleMicroseconds(delta) / thread_done,
+                       "thread %02d: %d samples @ %.1f samples/s "
+                       ":: failures %d",
+                       i, thread_done,
+                       interval_done / ToDoubleSeconds(kPrintInterval),
                        num_failures)
                 << "\n";
     }
@@ -310,12 +310,24 @@ class TestbenchBase {
   uint64_t end_;
   uint64_t max_failures_;
   uint64_t num_samples_processed_;
+
+  // The head of the shared chunk queue. Worker threads atomically claim
+  // chunk_size_ indices at a time from here; no lock is involved in either
+  // claiming work or aggregating the pass/failure counters, which are
+  // per-thread atomics read directly by the monitor.
+  std::atomic<uint64_t> next_index_{0};
+  uint64_t chunk_size_ = 1;
+
+  // Per-thread sample counts as of the previous status print; used to compute
+  // recent throughput per thread.
+  std::vector<uint64_t> thread_last_done_;
+
   std::function<InputT(uint64_t)> index_to_input_;
   std::function<bool(ResultT, ResultT)> compare_results_;
   std::function<void(int64_t, InputT, ResultT, ResultT)> log_errors_;
 
   using ThreadT = TestbenchThread<InputT, ResultT, ShardDataT>;
-  std::function<std::unique_ptr<ThreadT>(uint64_t, uint64_t)> thread_create_fn_;
+  std::function<std::unique_ptr<ThreadT>()> thread_create_fn_;
   std::vector<std::unique_ptr<ThreadT>> threads_;
 
   // The main thread sleeps while tests are running. As worker threads finish,
@@ -15,6 +15,8 @@
 #ifndef XLS_TOOLS_TESTBENCH_THREAD_H_
 #define XLS_TOOLS_TESTBENCH_THREAD_H_
 
+#include <algorithm>
+#include <atomic>
 #include <functional>
 
 #include "absl/status/status.h"
@@ -33,8 +35,8 @@ template <typename InputT, typename ResultT, typename ShardDataT>
 class TestbenchThreadBase;
 
 // TestbenchThread handles the work of _actually_ running tests.
-// It simply iterates over its given range of the index space and calls the
-// expected/actual calculators.
+// It repeatedly claims chunks of the index space from the shared chunk queue
+// and calls the expected/actual calculators for each index in the chunk.
 //
 // Just as with Testbench, TestbenchThread supports execution both with and
 // without per-shard data, and uses the same type of construct to expose an API
@@ -48,6 +50,9 @@ class TestbenchThread
   // All specified functions must be thread-safe.
   //  - wake_parent_mutex: A mutex that protects:
   //  - wake_parent: A condvar to kick the parent when this thread has finished.
+  //  - next_index: The parent-owned chunk queue head: threads atomically claim
+  //                [next_index, next_index + chunk_size) chunks until the
+  //                queue passes end_index.
   //  - max_failures: The number of failures that will cause us to bail out.
   //                  If 0, then there will be no limit.
   //  - index_to_input: A function that can convert an index to an input to the
@@ -57,7 +62,8 @@ class TestbenchThread
   //                     under test.
   TestbenchThread(
       absl::Mutex* wake_parent_mutex, absl::CondVar* wake_parent,
-      uint64_t start_index, uint64_t end_index, uint64_t max_failures,
+      std::atomic<uint64_t>* next_index, uint64_t end_index,
+      uint64_t chunk_size, uint64_t max_failures,
       std::function<InputT(uint64_t)> index_to_input,
       std::function<std::unique_ptr<ShardDataT>()> create_shard,
       std::function<ResultT(ShardDataT*, InputT)> generate_expected,
@@ -65,7 +71,7 @@ class TestbenchThread
       std::function<bool(ResultT, ResultT)> compare_results,
       std::function<void(int64_t, InputT, ResultT, ResultT)> log_errors)
       : TestbenchThreadBase<InputT, ResultT, ShardDataT>(
-            wake_parent_mutex, wake_parent, start_index, end_index,
+            wake_parent_mutex, wake_parent, next_index, end_index, chunk_size,
             max_failures, index_to_input, compare_results, log_errors),
         shard_data_(create_shard()),
         generate_expected_(generate_expected),
@@ -94,14 +100,15 @@ class TestbenchThread<
  public:
   TestbenchThread(
       absl::Mutex* wake_parent_mutex, absl::CondVar* wake_parent,
-      uint64_t start_index, uint64_t end_index, uint64_t max_failures,
+      std::atomic<uint64_t>* next_index, uint64_t end_index,
+      uint64_t chunk_size, uint64_t max_failures,
       std::function<InputT(uint64_t)> index_to_input,
       std::function<ResultT(InputT)> generate_expected,
       std::function<ResultT(InputT)> generate_actual,
       std::function<bool(ResultT, ResultT)> compare_results,
       std::function<void(int64_t, InputT, ResultT, ResultT)> log_errors)
       : TestbenchThreadBase<InputT, ResultT, ShardDataT>(
-            wake_parent_mutex, wake_parent, start_index, end_index,
+            wake_parent_mutex, wake_parent, next_index, end_index, chunk_size,
             max_failures, index_to_input, compare_results, log_errors),
         generate_expected_(generate_expected),
         generate_actual_(generate_actual) {
@@ -127,7 +134,8 @@ class TestbenchThreadBase {
  public:
   TestbenchThreadBase(
       absl::Mutex* wake_parent_mutex, absl::CondVar* wake_parent,
-      uint64_t start_index, uint64_t end_index, uint64_t max_failures,
+      std::atomic<uint64_t>* next_index, uint64_t end_index,
+      uint64_t chunk_size, uint64_t max_failures,
       std::function<InputT(uint64_t)> index_to_input,
       std::function<bool(ResultT, ResultT)> compare_results,
       std::function<void(int64_t, InputT, ResultT, ResultT)> log_errors)
@@ -135,8 +143,9 @@ class TestbenchThreadBase {
         wake_parent_(wake_parent),
         cancelled_(false),
         running_(false),
-        start_index_(start_index),
+        next_index_(next_index),
         end_index_(end_index),
+        chunk_size_(chunk_size),
         max_failures_(max_failures),
         num_passes_(0),
         num_failures_(0),
@@ -161,25 +170,39 @@ class TestbenchThreadBase {
     }
 
     running_.store(true);
-    for (uint64_t i = start_index_; i < end_index_; i++) {
-      // Don't check for cancelled on every iteration; it's a touch slow.
-      if (i % 128 == 0 && cancelled_.load()) {
-        return_status = absl::CancelledError("This thread was cancelled.");
+    // Claim chunks of the index space until the queue is exhausted. Threads
+    // which land on cheap regions of the input space simply claim more chunks,
+    // so skewed per-sample costs no longer leave cores idle for the tail of a
+    // run.
+    bool bail = false;
+    while (!bail) {
+      uint64_t chunk_start = next_index_->fetch_add(chunk_size_);
+      if (chunk_start >= end_index_) {
         break;
       }
-
-      InputT input = index_to_input_(i);
-      ResultT expected = generate_expected_fn_(input);
-      ResultT actual = generate_actual_fn_(input);
-      if (!compare_results_(expected, actual)) {
-        num_failures_.store(num_failures_.load() + 1);
-        log_errors_(i, input, expected, actual);
-        if (max_failures_ <= num_failures_.load()) {
-          return_status = absl::UnknownError("Maximum error count reached.");
+      uint64_t chunk_end = std::min(chunk_start + chunk_size_, end_index_);
+      for (uint64_t i = chunk_start; i < chunk_end; i++) {
+        // Don't check for cancelled on every iteration; it's a touch slow.
+        if (i % 128 == 0 && cancelled_.load()) {
+          return_status = absl::CancelledError("This thread was cancelled.");
+          bail = true;
           break;
         }
-      } else {
-        num_passes_.store(num_passes_.load() + 1);
+
+        InputT input = index_to_input_(i);
+        ResultT expected = generate_expected_fn_(input);
+        ResultT actual = generate_actual_fn_(input);
+        if (!compare_results_(expected, actual)) {
+          num_failures_.store(num_failures_.load() + 1);
+          log_errors_(i, input, expected, actual);
+          if (max_failures_ <= num_failures_.load()) {
+            return_status = absl::UnknownError("Maximum error count reached.");
+            bail = true;
+            break;
+          }
+        } else {
+          num_passes_.store(num_passes_.load() + 1);
+        }
       }
     }
 
@@ -231,8 +254,10 @@ class TestbenchThreadBase {
   std::atomic<bool> cancelled_;
   std::atomic<bool> running_;
 
-  uint64_t start_index_;
+  // Parent-owned chunk queue head shared by all worker threads.
+  std::atomic<uint64_t>* next_index_;
   uint64_t end_index_;
+  uint64_t chunk_size_;
 
   // Bookkeeping data.
   uint64_t max_failures_;
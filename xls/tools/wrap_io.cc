@@ -145,6 +145,8 @@ absl::StatusOr<Module*> WrapIo(absl::string_view module_name,
                                absl::string_view instance_name,
                                const ModuleSignature& signature,
                                IoStrategy* io_strategy, VerilogFile* f) {
+  XLS_ASSIGN_OR_RETURN(Module * rx_buffer_m,
+                       RxBufferModule(kRxBufferDepth, f));
   XLS_ASSIGN_OR_RETURN(Module * input_controller_m,
                        InputControllerModule(signature, f));
   XLS_ASSIGN_OR_RETURN(Module * output_controller_m,
@@ -181,6 +183,37 @@ absl::StatusOr<Module*> WrapIo(absl::string_view module_name,
   XLS_RETURN_IF_ERROR(io_strategy->InstantiateIoBlocks(
       input_signals, output_signals, io_wrapper));
 
+  // Buffer received bytes in a FIFO so that bytes of subsequent invocations
+  // can stream in over the (flow-control-less) serial link while the device
+  // function computes and its response drains out.
+  LogicRef* buffered_rx_byte = io_wrapper->AddWire(
+      "buffered_rx_byte", f->BitVectorType(8, SourceInfo()), SourceInfo());
+  LogicRef* buffered_rx_byte_valid = io_wrapper->AddWire(
+      "buffered_rx_byte_valid", f->ScalarType(SourceInfo()), SourceInfo());
+  LogicRef* buffered_rx_byte_ready = io_wrapper->AddWire(
+      "buffered_rx_byte_ready", f->ScalarType(SourceInfo()), SourceInfo());
+  LogicRef* rx_buffer_wr_ready = io_wrapper->AddWire(
+      "rx_buffer_wr_ready", f->ScalarType(SourceInfo()), SourceInfo());
+  {
+    std::vector<Connection> connections;
+    connections.push_back(Connection{"clk", clk});
+    connections.push_back(Connection{"rst_n", rst_n});
+    connections.push_back(Connection{"wr_data", input_signals.rx_byte});
+    connections.push_back(
+        Connection{"wr_valid", input_signals.rx_byte_valid});
+    connections.push_back(Connection{"wr_ready", rx_buffer_wr_ready});
+    connections.push_back(Connection{"rd_data", buffered_rx_byte});
+    connections.push_back(Connection{"rd_valid", buffered_rx_byte_valid});
+    connections.push_back(Connection{"rd_ready", buffered_rx_byte_ready});
+    io_wrapper->Add<Instantiation>(
+        SourceInfo(), rx_buffer_m->name(), "rx_buffer",
+        /*parameters=*/absl::Span<const Connection>(), connections);
+  }
+  io_wrapper->Add<ContinuousAssignment>(
+      SourceInfo(), input_signals.rx_byte_done,
+      f->LogicalAnd(input_signals.rx_byte_valid, rx_buffer_wr_ready,
+                    SourceInfo()));
+
   LogicRef* flat_input = io_wrapper->AddWire(
       "flat_input",
       f->BitVectorType(signature.TotalDataInputBits(), SourceInfo()),
@@ -192,11 +225,11 @@ absl::StatusOr<Module*> WrapIo(absl::string_view module_name,
   {
     std::vector<Connection> connections;
     connections.push_back(Connection{"clk", clk});
-    connections.push_back(Connection{"byte_in", input_signals.rx_byte});
+    connections.push_back(Connection{"byte_in", buffered_rx_byte});
     connections.push_back(
-        Connection{"byte_in_valid", input_signals.rx_byte_valid});
+        Connection{"byte_in_valid", buffered_rx_byte_valid});
     connections.push_back(
-        Connection{"byte_in_ready", input_signals.rx_byte_done});
+        Connection{"byte_in_ready", buffered_rx_byte_ready});
     connections.push_back(Connection{"data_out", flat_input});
     connections.push_back(Connection{"data_out_valid", flat_input_valid});
     connections.push_back(Connection{"data_out_ready", flat_input_ready});
@@ -612,6 +645,110 @@ absl::StatusOr<Module*> InputControllerModule(const ModuleSignature& signature,
   return m;
 }
 
+absl::StatusOr<Module*> RxBufferModule(int64_t depth, VerilogFile* f) {
+  XLS_RET_CHECK_GT(depth, 1);
+  XLS_RET_CHECK(IsPowerOfTwo(static_cast<uint64_t>(depth)));
+  Module* m = f->AddModule("rx_buffer", SourceInfo());
+  LogicRef* clk = m->AddInput("clk", f->ScalarType(SourceInfo()), SourceInfo());
+  LogicRef* rst_n =
+      m->AddInput("rst_n", f->ScalarType(SourceInfo()), SourceInfo());
+
+  // Byte-wide write side with ready/valid flow control.
+  LogicRef* wr_data =
+      m->AddInput("wr_data", f->BitVectorType(8, SourceInfo()), SourceInfo());
+  LogicRef* wr_valid =
+      m->AddInput("wr_valid", f->ScalarType(SourceInfo()), SourceInfo());
+  LogicRef* wr_ready =
+      m->AddOutput("wr_ready", f->ScalarType(SourceInfo()), SourceInfo());
+
+  // Byte-wide read side with ready/valid flow control.
+  LogicRef* rd_data =
+      m->AddOutput("rd_data", f->BitVectorType(8, SourceInfo()), SourceInfo());
+  LogicRef* rd_valid =
+      m->AddOutput("rd_valid", f->ScalarType(SourceInfo()), SourceInfo());
+  LogicRef* rd_ready =
+      m->AddInput("rd_ready", f->ScalarType(SourceInfo()), SourceInfo());
+
+  // Head/tail pointers wrap naturally because the depth is a power of two.
+  // The count register has one extra bit to distinguish full from empty.
+  const int64_t ptr_width = Bits::MinBitCountUnsigned(depth - 1);
+  LogicRef* buffer =
+      m->AddReg("buffer", f->UnpackedArrayType(8, {depth}, SourceInfo()),
+                SourceInfo());
+  LogicRef* head = m->AddReg(
+      "head", f->BitVectorType(ptr_width, SourceInfo()), SourceInfo());
+  LogicRef* tail = m->AddReg(
+      "tail", f->BitVectorType(ptr_width, SourceInfo()), SourceInfo());
+  LogicRef* count = m->AddReg(
+      "count", f->BitVectorType(ptr_width + 1, SourceInfo()), SourceInfo());
+
+  LogicRef* wr_fire =
+      m->AddWire("wr_fire", f->ScalarType(SourceInfo()), SourceInfo());
+  LogicRef* rd_fire =
+      m->AddWire("rd_fire", f->ScalarType(SourceInfo()), SourceInfo());
+
+  m->Add<ContinuousAssignment>(
+      SourceInfo(), wr_ready,
+      f->NotEquals(count, f->PlainLiteral(depth, SourceInfo()), SourceInfo()));
+  m->Add<ContinuousAssignment>(
+      SourceInfo(), rd_valid,
+      f->NotEquals(count, f->PlainLiteral(0, SourceInfo()), SourceInfo()));
+  m->Add<ContinuousAssignment>(SourceInfo(), rd_data,
+                               f->Index(buffer, head, SourceInfo()));
+  m->Add<ContinuousAssignment>(SourceInfo(), wr_fire,
+                               f->LogicalAnd(wr_valid, wr_ready, SourceInfo()));
+  m->Add<ContinuousAssignment>(SourceInfo(), rd_fire,
+                               f->LogicalAnd(rd_valid, rd_ready, SourceInfo()));
+
+  // Sequential logic:
+  //
+  //   if (!rst_n) {
+  //     head <= 0; tail <= 0; count <= 0;
+  //   } else {
+  //     if (wr_fire) { buffer[tail] <= wr_data; tail <= tail + 1; }
+  //     if (rd_fire) { head <= head + 1; }
+  //     if (wr_fire && !rd_fire) { count <= count + 1; }
+  //     else if (rd_fire && !wr_fire) { count <= count - 1; }
+  //   }
+  auto af = m->Add<Always>(
+      SourceInfo(), std::vector<SensitivityListElement>(
+                        {f->Make<PosEdge>(SourceInfo(), clk)}));
+  auto rst_cond = af->statements()->Add<Conditional>(
+      SourceInfo(), f->LogicalNot(rst_n, SourceInfo()));
+  rst_cond->consequent()->Add<NonblockingAssignment>(
+      SourceInfo(), head, f->PlainLiteral(0, SourceInfo()));
+  rst_cond->consequent()->Add<NonblockingAssignment>(
+      SourceInfo(), tail, f->PlainLiteral(0, SourceInfo()));
+  rst_cond->consequent()->Add<NonblockingAssignment>(
+      SourceInfo(), count, f->PlainLiteral(0, SourceInfo()));
+  auto running = rst_cond->AddAlternate();
+  auto wr_cond = running->Add<Conditional>(SourceInfo(), wr_fire);
+  wr_cond->consequent()->Add<NonblockingAssignment>(
+      SourceInfo(), f->Index(buffer, tail, SourceInfo()), wr_data);
+  wr_cond->consequent()->Add<NonblockingAssignment>(
+      SourceInfo(), tail,
+      f->Add(tail, f->PlainLiteral(1, SourceInfo()), SourceInfo()));
+  auto rd_cond = running->Add<Conditional>(SourceInfo(), rd_fire);
+  rd_cond->consequent()->Add<NonblockingAssignment>(
+      SourceInfo(), head,
+      f->Add(head, f->PlainLiteral(1, SourceInfo()), SourceInfo()));
+  auto count_cond = running->Add<Conditional>(
+      SourceInfo(),
+      f->LogicalAnd(wr_fire, f->LogicalNot(rd_fire, SourceInfo()),
+                    SourceInfo()));
+  count_cond->consequent()->Add<NonblockingAssignment>(
+      SourceInfo(), count,
+      f->Add(count, f->PlainLiteral(1, SourceInfo()), SourceInfo()));
+  count_cond
+      ->AddAlternate(f->LogicalAnd(
+          rd_fire, f->LogicalNot(wr_fire, SourceInfo()), SourceInfo()))
+      ->Add<NonblockingAssignment>(
+          SourceInfo(), count,
+          f->Sub(count, f->PlainLiteral(1, SourceInfo()), SourceInfo()));
+
+  return m;
+}
+
 absl::StatusOr<Module*> OutputControllerModule(const ModuleSignature& signature,
                                                VerilogFile* f) {
   const int64_t output_bits = signature.TotalDataOutputBits();
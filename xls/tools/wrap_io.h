@@ -38,6 +38,12 @@ enum IoControlCode : uint8_t {
   kEscape = 0xff,
 };
 
+// Depth in bytes of the receive buffer instantiated between the I/O block and
+// the input controller (see RxBufferModule). Hosts may stream up to this many
+// bytes ahead of the device function consuming them, which lets batched RPCs
+// pack many argument records per transfer. Must be a power of two.
+constexpr int64_t kRxBufferDepth = 256;
+
 // Escape codes of the I/O state machine. These bytes are sent immediately
 // following the escape control code. An unrecognized escaped byte will be
 // interpretted as a data byte of that value.
@@ -103,6 +109,14 @@ absl::StatusOr<Module*> InputResetModule(VerilogFile* f);
 absl::StatusOr<Module*> InputShiftRegisterModule(int64_t bit_count,
                                                  VerilogFile* f);
 
+// Creates and returns a byte-wide FIFO of the given depth (a power of two)
+// with ready/valid flow control on both sides. WrapIo instantiates this
+// between the I/O block and the input controller so bytes of subsequent
+// invocations buffer on-device while the device function computes and its
+// response streams out, instead of stalling the (flow-control-less) serial
+// link. Exposed in the header for testing purposes.
+absl::StatusOr<Module*> RxBufferModule(int64_t depth, VerilogFile* f);
+
 // Creates and returns a module which controls the output side of the I/O state
 // machine. This module has an arbitrary width input to match the output of the
 // device function. The output of the output controller is byte-wide. Both have
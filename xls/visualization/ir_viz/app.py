@@ -243,6 +243,46 @@ def graph_handler():
   return jsonified
 
 
+@webapp.route('/graph_summary', methods=['POST'])
+def graph_summary_handler():
+  """Returns a reduced level-of-detail cluster summary of the posted IR.
+
+  Serves large graphs that are too big to render node-by-node: the client
+  shows the summarized clusters first and expands individual clusters via
+  /graph_cluster.
+  """
+  text = flask.request.form['text']
+  target_cluster_size = int(
+      flask.request.form.get('target_cluster_size', '256'))
+  try:
+    json_text = ir_to_json.ir_to_summary_json(text, target_cluster_size,
+                                              FLAGS.entry)
+  except Exception as e:  # pylint: disable=broad-except
+    return flask.jsonify({'error_code': 'error', 'message': str(e)})
+
+  return flask.jsonify({'error_code': 'ok', 'graph': json.loads(json_text)})
+
+
+@webapp.route('/graph_cluster', methods=['POST'])
+def graph_cluster_handler():
+  """Expands one cluster of a previously served summary to its real nodes.
+
+  The posted target_cluster_size must match the one used for /graph_summary so
+  the deterministic clustering (and thus the cluster id) is reproduced.
+  """
+  text = flask.request.form['text']
+  cluster_id = flask.request.form['cluster_id']
+  target_cluster_size = int(
+      flask.request.form.get('target_cluster_size', '256'))
+  try:
+    json_text = ir_to_json.ir_cluster_to_json(text, FLAGS.delay_model,
+                                              target_cluster_size, cluster_id)
+  except Exception as e:  # pylint: disable=broad-except
+    return flask.jsonify({'error_code': 'error', 'message': str(e)})
+
+  return flask.jsonify({'error_code': 'ok', 'cluster': json.loads(json_text)})
+
+
 def main(argv):
   if len(argv) > 1:
     raise app.UsageError('Too many command-line arguments.')
@@ -14,7 +14,13 @@
 
 #include "xls/visualization/ir_viz/ir_to_json.h"
 
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <utility>
+
 #include "google/protobuf/util/json_util.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
@@ -27,6 +33,7 @@
 #include "xls/delay_model/delay_estimator.h"
 #include "xls/ir/block.h"
 #include "xls/ir/dfs_visitor.h"
+#include "xls/ir/node_iterator.h"
 #include "xls/ir/op.h"
 #include "xls/ir/package.h"
 #include "xls/ir/proc.h"
@@ -222,6 +229,89 @@ absl::StatusOr<viz::FunctionBase> FunctionBaseToVisualizationProto(
   return std::move(proto);
 }
 
+// Serializes the given proto as JSON in the form consumed by the visualizer
+// client.
+absl::StatusOr<std::string> SerializeToJson(const google::protobuf::Message& proto) {
+  std::string serialized_json;
+  google::protobuf::util::JsonPrintOptions print_options;
+  print_options.add_whitespace = true;
+  print_options.preserve_proto_field_names = true;
+  auto status =
+      google::protobuf::util::MessageToJsonString(proto, &serialized_json, print_options);
+  if (!status.ok()) {
+    return absl::InternalError(std::string{status.message()});
+  }
+  return serialized_json;
+}
+
+// Returns a globally unique identifier for the index-th cluster of the
+// function with the given id, e.g. "f0_c3".
+std::string GetClusterUniqueId(absl::string_view function_id, int64_t index) {
+  return absl::StrFormat("%s_c%d", function_id, index);
+}
+
+// Deterministically partitions the nodes of `function` into clusters of at
+// most `target_cluster_size` nodes. Nodes are taken in topological order so a
+// cluster covers a contiguous slice of the dataflow graph (an approximate
+// logic cone) rather than an arbitrary sample, and the same package always
+// yields the same clustering so cluster ids handed to the client stay valid
+// across requests.
+std::vector<std::vector<Node*>> ComputeClusters(FunctionBase* function,
+                                                int64_t target_cluster_size) {
+  std::vector<std::vector<Node*>> clusters;
+  for (Node* node : TopoSort(function)) {
+    if (clusters.empty() ||
+        static_cast<int64_t>(clusters.back().size()) >= target_cluster_size) {
+      clusters.emplace_back();
+    }
+    clusters.back().push_back(node);
+  }
+  return clusters;
+}
+
+// Returns the topological depth (length of the longest operand chain from a
+// source node) of every node in the function.
+absl::flat_hash_map<Node*, int64_t> ComputeNodeDepths(FunctionBase* function) {
+  absl::flat_hash_map<Node*, int64_t> depths;
+  for (Node* node : TopoSort(function)) {
+    int64_t depth = 0;
+    for (Node* operand : node->operands()) {
+      depth = std::max(depth, depths.at(operand) + 1);
+    }
+    depths[node] = depth;
+  }
+  return depths;
+}
+
+// Returns a short description of the dominant opcodes in the cluster, e.g.
+// "add x12, bit_slice x7, ...".
+std::string ClusterLabel(absl::Span<Node* const> nodes) {
+  absl::flat_hash_map<Op, int64_t> histogram;
+  for (Node* node : nodes) {
+    histogram[node->op()]++;
+  }
+  std::vector<std::pair<Op, int64_t>> sorted(histogram.begin(),
+                                             histogram.end());
+  std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+    // Most frequent first; break count ties by opcode name for determinism.
+    if (a.second != b.second) {
+      return a.second > b.second;
+    }
+    return OpToString(a.first) < OpToString(b.first);
+  });
+  constexpr int64_t kMaxOpsInLabel = 3;
+  std::vector<std::string> parts;
+  for (int64_t i = 0;
+       i < std::min<int64_t>(kMaxOpsInLabel, sorted.size()); ++i) {
+    parts.push_back(absl::StrFormat("%s x%d", OpToString(sorted[i].first),
+                                    sorted[i].second));
+  }
+  if (static_cast<int64_t>(sorted.size()) > kMaxOpsInLabel) {
+    parts.push_back("...");
+  }
+  return absl::StrJoin(parts, ", ");
+}
+
 }  // namespace
 
 absl::StatusOr<std::string> IrToJson(
@@ -258,17 +348,185 @@ absl::StatusOr<std::string> IrToJson(
     }
   }
 
-  std::string serialized_json;
-  google::protobuf::util::JsonPrintOptions print_options;
-  print_options.add_whitespace = true;
-  print_options.preserve_proto_field_names = true;
+  return SerializeToJson(proto);
+}
 
-  auto status =
-      google::protobuf::util::MessageToJsonString(proto, &serialized_json, print_options);
-  if (!status.ok()) {
-    return absl::InternalError(std::string{status.message()});
+absl::StatusOr<std::string> IrToSummaryJson(
+    Package* package, int64_t target_cluster_size,
+    std::optional<absl::string_view> entry_name) {
+  XLS_RET_CHECK_GT(target_cluster_size, 0);
+  viz::PackageSummary proto;
+  proto.set_name(package->name());
+
+  absl::flat_hash_map<FunctionBase*, std::string> function_ids =
+      GetFunctionIds(package);
+
+  std::optional<FunctionBase*> entry_function_base;
+  for (FunctionBase* fb : package->GetFunctionBases()) {
+    const std::string& function_id = function_ids.at(fb);
+    viz::FunctionBaseSummary* summary = proto.add_function_bases();
+    summary->set_name(fb->name());
+    summary->set_id(function_id);
+    if (fb->IsFunction()) {
+      summary->set_kind("function");
+    } else if (fb->IsProc()) {
+      summary->set_kind("proc");
+    } else {
+      XLS_RET_CHECK(fb->IsBlock());
+      summary->set_kind("block");
+    }
+    summary->set_node_count(fb->node_count());
+
+    std::vector<std::vector<Node*>> clusters =
+        ComputeClusters(fb, target_cluster_size);
+    absl::flat_hash_map<Node*, int64_t> depths = ComputeNodeDepths(fb);
+    absl::flat_hash_map<Node*, int64_t> cluster_index;
+    for (int64_t i = 0; i < static_cast<int64_t>(clusters.size()); ++i) {
+      for (Node* node : clusters[i]) {
+        cluster_index[node] = i;
+      }
+      viz::Cluster* cluster = summary->add_clusters();
+      cluster->set_id(GetClusterUniqueId(function_id, i));
+      cluster->set_label(ClusterLabel(clusters[i]));
+      cluster->set_node_count(clusters[i].size());
+      int64_t min_depth = std::numeric_limits<int64_t>::max();
+      int64_t max_depth = 0;
+      for (Node* node : clusters[i]) {
+        min_depth = std::min(min_depth, depths.at(node));
+        max_depth = std::max(max_depth, depths.at(node));
+      }
+      cluster->set_min_depth(min_depth);
+      cluster->set_max_depth(max_depth);
+    }
+
+    // Aggregate node-to-node edges which cross a cluster boundary into one
+    // edge per cluster pair. An ordered map keeps the output deterministic.
+    std::map<std::pair<int64_t, int64_t>, int64_t> edge_widths;
+    for (Node* node : fb->nodes()) {
+      for (Node* operand : node->operands()) {
+        int64_t source = cluster_index.at(operand);
+        int64_t target = cluster_index.at(node);
+        if (source != target) {
+          edge_widths[{source, target}] +=
+              operand->GetType()->GetFlatBitCount();
+        }
+      }
+    }
+    for (const auto& [cluster_pair, width] : edge_widths) {
+      viz::Edge* edge = summary->add_edges();
+      std::string source_id =
+          GetClusterUniqueId(function_id, cluster_pair.first);
+      std::string target_id =
+          GetClusterUniqueId(function_id, cluster_pair.second);
+      edge->set_id(absl::StrFormat("%s_to_%s", source_id, target_id));
+      edge->set_source_id(source_id);
+      edge->set_target_id(target_id);
+      edge->set_bit_width(width);
+    }
+
+    if (entry_name.has_value() && fb->name() == entry_name.value()) {
+      entry_function_base = fb;
+    }
   }
-  return serialized_json;
+
+  if (entry_function_base.has_value()) {
+    proto.set_entry_id(function_ids.at(entry_function_base.value()));
+  } else {
+    std::optional<FunctionBase*> top = package->GetTop();
+    if (top.has_value()) {
+      proto.set_entry_id(function_ids.at(top.value()));
+    }
+  }
+  return SerializeToJson(proto);
+}
+
+absl::StatusOr<std::string> IrClusterToJson(
+    Package* package, const DelayEstimator& delay_estimator,
+    int64_t target_cluster_size, absl::string_view cluster_id) {
+  XLS_RET_CHECK_GT(target_cluster_size, 0);
+  std::string function_id;
+  int64_t cluster_number;
+  if (!RE2::FullMatch(cluster_id, R"((f\d+)_c(\d+))", &function_id,
+                      &cluster_number)) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Invalid cluster id: %s", cluster_id));
+  }
+  absl::flat_hash_map<FunctionBase*, std::string> function_ids =
+      GetFunctionIds(package);
+  FunctionBase* function = nullptr;
+  for (FunctionBase* fb : package->GetFunctionBases()) {
+    if (function_ids.at(fb) == function_id) {
+      function = fb;
+      break;
+    }
+  }
+  if (function == nullptr) {
+    return absl::NotFoundError(
+        absl::StrFormat("No function base with id: %s", function_id));
+  }
+  std::vector<std::vector<Node*>> clusters =
+      ComputeClusters(function, target_cluster_size);
+  if (cluster_number >= static_cast<int64_t>(clusters.size())) {
+    return absl::NotFoundError(absl::StrFormat(
+        "Function %s has no cluster %d", function_id, cluster_number));
+  }
+  const std::vector<Node*>& members = clusters[cluster_number];
+  absl::flat_hash_set<Node*> member_set(members.begin(), members.end());
+  absl::flat_hash_map<Node*, int64_t> cluster_index;
+  for (int64_t i = 0; i < static_cast<int64_t>(clusters.size()); ++i) {
+    for (Node* node : clusters[i]) {
+      cluster_index[node] = i;
+    }
+  }
+
+  viz::ClusterExpansion proto;
+  proto.set_function_id(function_id);
+  proto.set_cluster_id(std::string{cluster_id});
+
+  // Whole-function analyses (critical path, full BDD evaluation) are skipped
+  // in the streaming path: the point of serving clusters is to keep per-request
+  // work proportional to the cluster, not the function. The BDD query engine
+  // is restricted to the member nodes for the same reason.
+  absl::flat_hash_map<Node*, CriticalPathEntry*> no_critical_path;
+  BddQueryEngine query_engine(
+      BddFunction::kDefaultPathLimit,
+      [&](const Node* node) { return member_set.contains(node); });
+  XLS_RETURN_IF_ERROR(query_engine.Populate(function).status());
+
+  for (Node* node : members) {
+    viz::Node* graph_node = proto.add_nodes();
+    graph_node->set_name(node->GetName());
+    graph_node->set_id(GetNodeUniqueId(node, function_ids));
+    graph_node->set_opcode(OpToString(node->op()));
+    graph_node->set_ir(node->ToStringWithOperandTypes());
+    XLS_ASSIGN_OR_RETURN(
+        *graph_node->mutable_attributes(),
+        NodeAttributes(node, no_critical_path, query_engine,
+                       /*schedule=*/nullptr, delay_estimator));
+  }
+
+  // Emit edges with at least one endpoint in the cluster. Endpoints outside
+  // the cluster are identified by their containing cluster's id.
+  auto endpoint_id = [&](Node* node) {
+    return member_set.contains(node)
+               ? GetNodeUniqueId(node, function_ids)
+               : GetClusterUniqueId(function_id, cluster_index.at(node));
+  };
+  for (Node* node : function->nodes()) {
+    for (Node* operand : node->operands()) {
+      if (!member_set.contains(node) && !member_set.contains(operand)) {
+        continue;
+      }
+      viz::Edge* edge = proto.add_edges();
+      edge->set_id(absl::StrFormat("%s_to_%s", endpoint_id(operand),
+                                   endpoint_id(node)));
+      edge->set_source_id(endpoint_id(operand));
+      edge->set_target_id(endpoint_id(node));
+      edge->set_type(operand->GetType()->ToString());
+      edge->set_bit_width(operand->GetType()->GetFlatBitCount());
+    }
+  }
+  return SerializeToJson(proto);
 }
 
 // Wraps the given text in a span with the given id, classes, and data. The
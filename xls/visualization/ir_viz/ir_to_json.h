@@ -31,6 +31,26 @@ absl::StatusOr<std::string> IrToJson(
     const PipelineSchedule* schedule = nullptr,
     std::optional<absl::string_view> entry_name = absl::nullopt);
 
+// Returns a reduced level-of-detail JSON representation of the package, based
+// on the xls::viz::PackageSummary proto. Nodes are grouped into deterministic
+// clusters of at most `target_cluster_size` nodes; only the clusters and
+// deduplicated cluster-to-cluster edges are serialized, so the result stays
+// small even for functions with hundreds of thousands of nodes. The client
+// expands individual clusters via IrClusterToJson.
+absl::StatusOr<std::string> IrToSummaryJson(
+    Package* package, int64_t target_cluster_size,
+    std::optional<absl::string_view> entry_name = absl::nullopt);
+
+// Returns the full contents of the cluster with the given id (as produced by
+// IrToSummaryJson, e.g. "f0_c3") as JSON based on the
+// xls::viz::ClusterExpansion proto. The clustering is deterministic for a
+// given package and target size, so ids from a summary remain valid across
+// calls. Edges crossing the cluster boundary refer to the neighboring
+// cluster's id.
+absl::StatusOr<std::string> IrClusterToJson(
+    Package* package, const DelayEstimator& delay_estimator,
+    int64_t target_cluster_size, absl::string_view cluster_id);
+
 // Return the IR text of the given package with HTML mark up. Various IR
 // constructs are wrapped in spans. This function is exposed only for testing as
 // the marked up IR is generally available in the JSON produced by IrToJson.
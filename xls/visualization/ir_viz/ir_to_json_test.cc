@@ -34,6 +34,7 @@ namespace xls {
 namespace {
 
 using ::testing::HasSubstr;
+using ::testing::Not;
 
 constexpr char kTestdataPath[] = "xls/visualization/ir_viz/testdata";
 
@@ -177,5 +178,51 @@ top proc the_proc(tkn: token, x: bits[32], y: bits[64], init={0, 42}) {
   ExpectEqualToGoldenFile(GoldenFilePath("htmltext"), html);
 }
 
+TEST_F(IrToJsonTest, SummaryAndClusterExpansion) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, ParsePackage(R"(
+package test
+
+top fn main(x: bits[32], y: bits[32]) -> bits[32] {
+  add1: bits[32] = add(x, y)
+  add2: bits[32] = add(add1, x)
+  add3: bits[32] = add(add2, y)
+  ret neg1: bits[32] = neg(add3)
+}
+)"));
+  // A target size of two splits the six nodes into three clusters.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::string summary_json,
+      IrToSummaryJson(p.get(), /*target_cluster_size=*/2, "main"));
+  XLS_VLOG(1) << summary_json;
+  EXPECT_THAT(summary_json, HasSubstr(R"("name": "main")"));
+  EXPECT_THAT(summary_json, HasSubstr(R"("entry_id": "f0")"));
+  EXPECT_THAT(summary_json, HasSubstr(R"("id": "f0_c0")"));
+  EXPECT_THAT(summary_json, HasSubstr(R"("id": "f0_c2")"));
+  EXPECT_THAT(summary_json, HasSubstr(R"("clusters": [)"));
+  EXPECT_THAT(summary_json, HasSubstr("add x2"));
+  // The individual nodes must not appear in the summary.
+  EXPECT_THAT(summary_json, Not(HasSubstr("add1")));
+
+  XLS_ASSERT_OK_AND_ASSIGN(DelayEstimator * delay_estimator,
+                           GetDelayEstimator("unit"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::string cluster_json,
+      IrClusterToJson(p.get(), *delay_estimator, /*target_cluster_size=*/2,
+                      "f0_c1"));
+  XLS_VLOG(1) << cluster_json;
+  EXPECT_THAT(cluster_json, HasSubstr(R"("cluster_id": "f0_c1")"));
+  EXPECT_THAT(cluster_json, HasSubstr(R"("function_id": "f0")"));
+  EXPECT_THAT(cluster_json, HasSubstr(R"("nodes": [)"));
+  // Edges crossing the cluster boundary name the neighboring cluster.
+  EXPECT_THAT(cluster_json, HasSubstr("f0_c0"));
+
+  EXPECT_THAT(IrClusterToJson(p.get(), *delay_estimator,
+                              /*target_cluster_size=*/2, "f0_c9"),
+              status_testing::StatusIs(absl::StatusCode::kNotFound));
+  EXPECT_THAT(IrClusterToJson(p.get(), *delay_estimator,
+                              /*target_cluster_size=*/2, "bogus"),
+              status_testing::StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 }  // namespace
 }  // namespace xls
@@ -80,12 +80,45 @@ absl::StatusOr<std::string> IrToJsonWrapper(
   }
 }
 
+// Reduced level-of-detail conversion which takes strings rather than objects.
+absl::StatusOr<std::string> IrToSummaryJsonWrapper(
+    absl::string_view ir_text, int64_t target_cluster_size,
+    std::optional<absl::string_view> entry_name) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                       Parser::ParsePackage(ir_text));
+  FunctionBase* func_base;
+  if (entry_name.has_value()) {
+    XLS_ASSIGN_OR_RETURN(func_base, package->GetFunction(entry_name.value()));
+  } else {
+    XLS_ASSIGN_OR_RETURN(func_base, GetFunctionBaseToView(package.get()));
+  }
+  return IrToSummaryJson(package.get(), target_cluster_size,
+                         func_base->name());
+}
+
+// Cluster expansion function which takes strings rather than objects.
+absl::StatusOr<std::string> IrClusterToJsonWrapper(
+    absl::string_view ir_text, absl::string_view delay_model_name,
+    int64_t target_cluster_size, absl::string_view cluster_id) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                       Parser::ParsePackage(ir_text));
+  XLS_ASSIGN_OR_RETURN(DelayEstimator * delay_estimator,
+                       GetDelayEstimator(delay_model_name));
+  return IrClusterToJson(package.get(), *delay_estimator, target_cluster_size,
+                         cluster_id);
+}
+
 PYBIND11_MODULE(ir_to_json, m) {
   ImportStatusModule();
 
   m.def("ir_to_json", &IrToJsonWrapper, py::arg("ir_text"),
         py::arg("delay_model_name"), py::arg("pipeline_stages") = absl::nullopt,
         py::arg("entry") = absl::nullopt);
+  m.def("ir_to_summary_json", &IrToSummaryJsonWrapper, py::arg("ir_text"),
+        py::arg("target_cluster_size"), py::arg("entry") = absl::nullopt);
+  m.def("ir_cluster_to_json", &IrClusterToJsonWrapper, py::arg("ir_text"),
+        py::arg("delay_model_name"), py::arg("target_cluster_size"),
+        py::arg("cluster_id"));
 }
 
 }  // namespace xls